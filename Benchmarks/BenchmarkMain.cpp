@@ -0,0 +1,123 @@
+#include <Windows.h>
+#include "MicroBenchmark.h"
+#include "../Source/Core/Logger.h"
+#include "../Source/Core/TaskSystem.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cwchar>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+namespace
+{
+    struct FBenchmarkArguments
+    {
+        std::wstring OutputPath = L"Captures/MicroBenchmarks.json";
+        std::string Filter;
+        uint32_t Repetitions = 1;
+    };
+
+    std::string ToUtf8(const std::wstring& Text)
+    {
+        const auto Utf8 = std::filesystem::path(Text).u8string();
+        return std::string(Utf8.begin(), Utf8.end());
+    }
+
+    // Asset paths are relative to the repository root, which holds bin/.
+    void EnsureWorkingDirectory()
+    {
+        namespace fs = std::filesystem;
+
+        wchar_t ExecutablePath[MAX_PATH] = {};
+        if (GetModuleFileNameW(nullptr, ExecutablePath, MAX_PATH) == 0)
+        {
+            return;
+        }
+
+        const fs::path ExecutableDirectory = fs::path(ExecutablePath).parent_path();
+        if (_wcsicmp(ExecutableDirectory.filename().c_str(), L"bin") == 0)
+        {
+            std::error_code Error;
+            fs::current_path(ExecutableDirectory.parent_path(), Error);
+        }
+    }
+
+    // Same -key=value form as the renderer's command line.
+    FBenchmarkArguments ParseArguments(int ArgumentCount, wchar_t** Arguments)
+    {
+        FBenchmarkArguments Result;
+        for (int Index = 1; Index < ArgumentCount; ++Index)
+        {
+            const std::wstring Argument = Arguments[Index];
+            const size_t KeyStart = Argument.find_first_not_of(L"-/");
+            if (KeyStart == 0 || KeyStart == std::wstring::npos)
+            {
+                continue;
+            }
+
+            const size_t DelimiterPos = Argument.find(L'=', KeyStart);
+            const std::wstring Key = Argument.substr(KeyStart, DelimiterPos - KeyStart);
+            const std::wstring Value = DelimiterPos == std::wstring::npos ? std::wstring() : Argument.substr(DelimiterPos + 1);
+
+            if (_wcsicmp(Key.c_str(), L"output") == 0 && !Value.empty())
+            {
+                Result.OutputPath = Value;
+            }
+            else if (_wcsicmp(Key.c_str(), L"filter") == 0)
+            {
+                Result.Filter = ToUtf8(Value);
+            }
+            else if (_wcsicmp(Key.c_str(), L"repetitions") == 0)
+            {
+                try
+                {
+                    Result.Repetitions = static_cast<uint32_t>((std::max)(1, std::stoi(Value)));
+                }
+                catch (...)
+                {
+                    LogWarning("Ignoring invalid repetitions value: " + ToUtf8(Value));
+                }
+            }
+            else
+            {
+                std::printf("Unknown argument: %s\n", ToUtf8(Argument).c_str());
+            }
+        }
+        return Result;
+    }
+}
+
+int wmain(int ArgumentCount, wchar_t** Arguments)
+{
+    EnsureWorkingDirectory();
+    const FBenchmarkArguments Settings = ParseArguments(ArgumentCount, Arguments);
+
+    FTaskScheduler::Get().Initialize();
+
+    FMicroBenchmarkSuite Suite;
+    Suite.SetFilter(Settings.Filter);
+    Suite.SetRepetitions(Settings.Repetitions);
+#if defined(_DEBUG)
+    Suite.AddContext("configuration", "Debug");
+#else
+    Suite.AddContext("configuration", "Release");
+#endif
+    Suite.AddContext("hardwareThreads", std::to_string(std::thread::hardware_concurrency()));
+    Suite.AddContext("workerThreads", std::to_string(FTaskScheduler::Get().GetWorkerThreadCount()));
+    Suite.AddContext("repetitions", std::to_string(Settings.Repetitions));
+    Suite.AddContext("filter", Settings.Filter);
+
+    AddTaskSystemBenchmarks(Suite);
+    AddCullingBenchmarks(Suite);
+    AddSceneBenchmarks(Suite);
+    AddRenderGraphBenchmarks(Suite);
+
+    Suite.RunAll();
+    const int32_t ExitCode = Suite.WriteReport(Settings.OutputPath);
+
+    FTaskScheduler::Get().Shutdown();
+    ShutdownLog();
+    return ExitCode;
+}
@@ -0,0 +1,122 @@
+#include "MicroBenchmark.h"
+#include "../Source/Render/RendererUtils.h"
+#include "../Source/Scene/Camera.h"
+#include "../Source/Scene/SceneBvh.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Camera headings cycled through by successive iterations, so every run culls the same views.
+    constexpr uint32_t CameraHeadingCount = 16;
+
+    struct FCullingScene
+    {
+        std::vector<FSceneModelResource> Models;
+        FSceneBvh SceneBvh;
+        FSceneBoundsSoA SceneBounds;
+        std::vector<uint32_t> ScratchIndices;
+        std::vector<bool> Visibility;
+        FCamera Camera;
+        uint32_t Heading = 0;
+        uint32_t VisibleCount = 0;
+    };
+
+    // Boxes of 0.5 to 8 units scattered through a 1 km cube around the camera, from a fixed seed.
+    std::shared_ptr<FCullingScene> CreateCullingScene(uint32_t ModelCount)
+    {
+        auto Scene = std::make_shared<FCullingScene>();
+        Scene->Models.resize(ModelCount);
+
+        std::mt19937 Random(ModelCount);
+        std::uniform_real_distribution<float> PositionDistribution(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> ExtentDistribution(0.25f, 4.0f);
+
+        std::vector<FBvhBounds> ModelBounds(ModelCount);
+        for (uint32_t ModelIndex = 0; ModelIndex < ModelCount; ++ModelIndex)
+        {
+            const DirectX::XMFLOAT3 Center(PositionDistribution(Random), PositionDistribution(Random), PositionDistribution(Random));
+            const float Extent = ExtentDistribution(Random);
+
+            FSceneModelResource& Model = Scene->Models[ModelIndex];
+            Model.BoundsMin = DirectX::XMFLOAT3(Center.x - Extent, Center.y - Extent, Center.z - Extent);
+            Model.BoundsMax = DirectX::XMFLOAT3(Center.x + Extent, Center.y + Extent, Center.z + Extent);
+            Model.Center = Center;
+            Model.Radius = Extent * std::sqrt(3.0f);
+            ModelBounds[ModelIndex] = { Model.BoundsMin, Model.BoundsMax };
+        }
+
+        Scene->SceneBvh.Build(ModelBounds);
+        RendererUtils::BuildSceneBoundsSoA(Scene->Models, Scene->SceneBounds);
+
+        Scene->Camera.SetPerspective(DirectX::XM_PIDIV4, 16.0f / 9.0f, 0.1f, 1000.0f);
+        Scene->Camera.SetPosition(FFloat3(0.0f, 0.0f, 0.0f));
+        Scene->Camera.SetUp(FFloat3(0.0f, 1.0f, 0.0f));
+        return Scene;
+    }
+
+    void AdvanceCamera(FCullingScene& Scene)
+    {
+        const float Angle = DirectX::XM_2PI * static_cast<float>(Scene.Heading) / static_cast<float>(CameraHeadingCount);
+        Scene.Camera.SetForward(FFloat3(std::sin(Angle), 0.0f, std::cos(Angle)));
+        Scene.Heading = (Scene.Heading + 1) % CameraHeadingCount;
+    }
+
+    void AddSceneCases(FMicroBenchmarkSuite& Suite, uint32_t ModelCount, const char* PathLabel)
+    {
+        const std::string Prefix = "Culling/";
+        const std::string Suffix = "/" + std::to_string(ModelCount) + PathLabel;
+        if (!Suite.IsEnabled(Prefix + "UpdateCullingVisibility" + Suffix) && !Suite.IsEnabled(Prefix + "IsAabbInCameraFrustum" + Suffix))
+        {
+            return;
+        }
+
+        std::shared_ptr<FCullingScene> Scene = CreateCullingScene(ModelCount);
+
+        {
+            FMicroBenchmarkCase Case;
+            Case.Name = Prefix + "UpdateCullingVisibility" + Suffix;
+            Case.Iterations = 100;
+            Case.ItemsPerIteration = ModelCount;
+            Case.Setup = [Scene]() { AdvanceCamera(*Scene); };
+            Case.Run = [Scene]()
+            {
+                RendererUtils::UpdateCullingVisibility(Scene->Camera, Scene->Models, Scene->SceneBvh, Scene->SceneBounds, Scene->ScratchIndices, Scene->Visibility);
+            };
+            Suite.Add(std::move(Case));
+        }
+
+        {
+            // The per-model test that the batched paths replace, over the whole scene.
+            FMicroBenchmarkCase Case;
+            Case.Name = Prefix + "IsAabbInCameraFrustum" + Suffix;
+            Case.Iterations = 100;
+            Case.ItemsPerIteration = ModelCount;
+            Case.Setup = [Scene]() { AdvanceCamera(*Scene); };
+            Case.Run = [Scene]()
+            {
+                DirectX::XMVECTOR Planes[6] = {};
+                RendererUtils::BuildCameraFrustumPlanes(Scene->Camera, Planes);
+
+                uint32_t VisibleCount = 0;
+                for (const FSceneModelResource& Model : Scene->Models)
+                {
+                    VisibleCount += RendererUtils::IsAabbInCameraFrustum(Planes, Model.BoundsMin, Model.BoundsMax) ? 1u : 0u;
+                }
+                Scene->VisibleCount = VisibleCount;
+            };
+            Suite.Add(std::move(Case));
+        }
+    }
+}
+
+void AddCullingBenchmarks(FMicroBenchmarkSuite& Suite)
+{
+    // UpdateCullingVisibility tests the flat bounds up to 4096 models and walks the BVH above that.
+    AddSceneCases(Suite, 4096, "Flat");
+    AddSceneCases(Suite, 65536, "Bvh");
+}
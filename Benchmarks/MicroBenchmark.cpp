@@ -0,0 +1,240 @@
+#include "MicroBenchmark.h"
+
+#include "../Source/Core/Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+    std::string ToUtf8(const std::wstring& Path)
+    {
+        const auto Utf8 = std::filesystem::path(Path).u8string();
+        return std::string(Utf8.begin(), Utf8.end());
+    }
+
+    std::string EscapeJsonString(const std::string& Value)
+    {
+        std::string Result;
+        Result.reserve(Value.size());
+        for (const char Character : Value)
+        {
+            if (Character == '"' || Character == '\\')
+            {
+                Result.push_back('\\');
+            }
+            Result.push_back(Character);
+        }
+        return Result;
+    }
+
+    // Nearest-rank percentile of an ascending series, as FBenchmarkRunner reports frame times.
+    double GetPercentile(const std::vector<double>& Sorted, double Percent)
+    {
+        if (Sorted.empty())
+        {
+            return 0.0;
+        }
+
+        const double Rank = std::ceil(Percent / 100.0 * static_cast<double>(Sorted.size()));
+        const size_t Index = static_cast<size_t>((std::max)(1.0, Rank)) - 1;
+        return Sorted[(std::min)(Index, Sorted.size() - 1)];
+    }
+
+    void RunIteration(const FMicroBenchmarkCase& Case, std::vector<double>* OutSamplesUs)
+    {
+        if (Case.Setup)
+        {
+            Case.Setup();
+        }
+
+        const auto StartTime = std::chrono::steady_clock::now();
+        Case.Run();
+        const auto EndTime = std::chrono::steady_clock::now();
+
+        if (Case.Teardown)
+        {
+            Case.Teardown();
+        }
+
+        if (OutSamplesUs)
+        {
+            OutSamplesUs->push_back(std::chrono::duration<double, std::micro>(EndTime - StartTime).count());
+        }
+    }
+}
+
+bool FMicroBenchmarkSuite::IsEnabled(std::string_view Name) const
+{
+    return Filter.empty() || Name.find(Filter) != std::string_view::npos;
+}
+
+void FMicroBenchmarkSuite::Add(FMicroBenchmarkCase Case)
+{
+    if (IsEnabled(Case.Name) && Case.Run)
+    {
+        Entries.push_back({ std::move(Case), std::string() });
+    }
+}
+
+void FMicroBenchmarkSuite::Skip(std::string Name, std::string Reason)
+{
+    if (IsEnabled(Name))
+    {
+        FEntry Entry;
+        Entry.Case.Name = std::move(Name);
+        Entry.SkipReason = std::move(Reason);
+        Entries.push_back(std::move(Entry));
+    }
+}
+
+void FMicroBenchmarkSuite::AddContext(std::string Key, std::string Value)
+{
+    Context.emplace_back(std::move(Key), std::move(Value));
+}
+
+void FMicroBenchmarkSuite::RunAll()
+{
+    Results.clear();
+    Results.reserve(Entries.size());
+
+    for (const FEntry& Entry : Entries)
+    {
+        const FMicroBenchmarkCase& Case = Entry.Case;
+
+        FResult Result;
+        Result.Name = Case.Name;
+        Result.SkipReason = Entry.SkipReason;
+        Result.WarmupIterations = Case.WarmupIterations;
+        Result.ItemsPerIteration = Case.ItemsPerIteration;
+
+        if (Result.SkipReason.empty())
+        {
+            for (uint32_t Iteration = 0; Iteration < Case.WarmupIterations; ++Iteration)
+            {
+                RunIteration(Case, nullptr);
+            }
+
+            const uint32_t IterationCount = (std::max)(1u, Case.Iterations) * Repetitions;
+            Result.SamplesUs.reserve(IterationCount);
+            for (uint32_t Iteration = 0; Iteration < IterationCount; ++Iteration)
+            {
+                RunIteration(Case, &Result.SamplesUs);
+            }
+
+            std::vector<double> Sorted = Result.SamplesUs;
+            std::sort(Sorted.begin(), Sorted.end());
+            std::printf("%-56s p50 %12.3f us   min %12.3f us   p95 %12.3f us\n",
+                Case.Name.c_str(), GetPercentile(Sorted, 50.0), Sorted.front(), GetPercentile(Sorted, 95.0));
+        }
+        else
+        {
+            std::printf("%-56s skipped: %s\n", Case.Name.c_str(), Result.SkipReason.c_str());
+        }
+
+        Results.push_back(std::move(Result));
+    }
+}
+
+int32_t FMicroBenchmarkSuite::WriteReport(const std::wstring& OutputPath) const
+{
+    if (Results.empty())
+    {
+        LogError("No micro-benchmark ran; check the filter");
+        return 1;
+    }
+
+    const std::filesystem::path ReportPath(OutputPath);
+    if (ReportPath.has_parent_path())
+    {
+        std::error_code Error;
+        std::filesystem::create_directories(ReportPath.parent_path(), Error);
+    }
+
+    std::ofstream Json(ReportPath, std::ios::trunc);
+    if (!Json)
+    {
+        LogError("Failed to write micro-benchmark report: " + ToUtf8(OutputPath));
+        return 1;
+    }
+
+    bool bAnySkipped = false;
+
+    Json << std::fixed << std::setprecision(3);
+    Json << "{\n";
+    Json << "  \"context\": {";
+    for (size_t Index = 0; Index < Context.size(); ++Index)
+    {
+        Json << (Index > 0 ? ", " : " ") << "\"" << EscapeJsonString(Context[Index].first) << "\": \""
+            << EscapeJsonString(Context[Index].second) << "\"";
+    }
+    Json << " },\n";
+
+    Json << "  \"cases\": [\n";
+    for (size_t Index = 0; Index < Results.size(); ++Index)
+    {
+        const FResult& Result = Results[Index];
+        Json << "    { \"name\": \"" << EscapeJsonString(Result.Name) << "\"";
+
+        if (!Result.SkipReason.empty())
+        {
+            bAnySkipped = true;
+            Json << ", \"skipped\": \"" << EscapeJsonString(Result.SkipReason) << "\"";
+        }
+        else
+        {
+            std::vector<double> Sorted = Result.SamplesUs;
+            std::sort(Sorted.begin(), Sorted.end());
+
+            double Sum = 0.0;
+            for (double Value : Sorted)
+            {
+                Sum += Value;
+            }
+            const double Mean = Sum / static_cast<double>(Sorted.size());
+
+            double Variance = 0.0;
+            for (double Value : Sorted)
+            {
+                Variance += (Value - Mean) * (Value - Mean);
+            }
+            Variance /= static_cast<double>(Sorted.size());
+
+            const double MedianUs = GetPercentile(Sorted, 50.0);
+            Json << ", \"iterations\": " << Sorted.size()
+                << ", \"warmupIterations\": " << Result.WarmupIterations
+                << ", \"itemsPerIteration\": " << Result.ItemsPerIteration
+                << ", \"us\": { \"mean\": " << Mean
+                << ", \"stddev\": " << std::sqrt(Variance)
+                << ", \"min\": " << Sorted.front()
+                << ", \"p50\": " << MedianUs
+                << ", \"p95\": " << GetPercentile(Sorted, 95.0)
+                << ", \"p99\": " << GetPercentile(Sorted, 99.0)
+                << ", \"max\": " << Sorted.back() << " }";
+
+            // Rate of the median iteration, which a single slow outlier does not move.
+            if (Result.ItemsPerIteration > 0 && MedianUs > 0.0)
+            {
+                Json << ", \"itemsPerSecond\": " << static_cast<double>(Result.ItemsPerIteration) * 1.0e6 / MedianUs;
+            }
+        }
+
+        Json << " }" << (Index + 1 < Results.size() ? "," : "") << "\n";
+    }
+    Json << "  ]\n}\n";
+
+    if (!Json)
+    {
+        LogError("Failed to write micro-benchmark report: " + ToUtf8(OutputPath));
+        return 1;
+    }
+
+    LogInfo("Micro-benchmark report written: " + ToUtf8(OutputPath));
+    std::printf("Report written: %s\n", ToUtf8(OutputPath).c_str());
+    return bAnySkipped ? 2 : 0;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * One repeatable micro-benchmark. Run is timed once per iteration after WarmupIterations
+ * untimed calls; Setup and Teardown run around every call, warmup included, and are never
+ * timed, so a case can restore its input or submit GPU work between iterations.
+ */
+struct FMicroBenchmarkCase
+{
+    std::string Name;
+    uint32_t WarmupIterations = 3;
+    uint32_t Iterations = 30;
+    // Elements one Run call processes; reported as a rate when non-zero.
+    uint64_t ItemsPerIteration = 0;
+    std::function<void()> Setup;
+    std::function<void()> Run;
+    std::function<void()> Teardown;
+};
+
+/**
+ * Runs the registered cases in order and writes one JSON report with the per-iteration time
+ * statistics of each, so a change to an engine hot path can be compared against a baseline run
+ * of the same build configuration.
+ */
+class FMicroBenchmarkSuite
+{
+public:
+    // Only cases whose name contains Filter run; an empty filter runs all of them.
+    void SetFilter(std::string InFilter) { Filter = std::move(InFilter); }
+    // Multiplies every case's iteration count, for steadier percentiles.
+    void SetRepetitions(uint32_t InRepetitions) { Repetitions = InRepetitions > 0 ? InRepetitions : 1; }
+
+    // Lets a registration function skip expensive state for a group the filter excludes.
+    bool IsEnabled(std::string_view Name) const;
+
+    void Add(FMicroBenchmarkCase Case);
+    // Reported in place of a result, e.g. when a case's input asset or device is unavailable.
+    void Skip(std::string Name, std::string Reason);
+    // Written to the report's "context" object as a string.
+    void AddContext(std::string Key, std::string Value);
+
+    void RunAll();
+
+    // Returns the process exit code: 0 when the report was written and no case was skipped,
+    // 2 when some were skipped, 1 when nothing ran or the report failed.
+    int32_t WriteReport(const std::wstring& OutputPath) const;
+
+private:
+    struct FResult
+    {
+        std::string Name;
+        std::string SkipReason;
+        uint32_t WarmupIterations = 0;
+        uint64_t ItemsPerIteration = 0;
+        std::vector<double> SamplesUs;
+    };
+
+    struct FEntry
+    {
+        FMicroBenchmarkCase Case;
+        std::string SkipReason;
+    };
+
+    std::string Filter;
+    uint32_t Repetitions = 1;
+    std::vector<FEntry> Entries;
+    std::vector<FResult> Results;
+    std::vector<std::pair<std::string, std::string>> Context;
+};
+
+void AddTaskSystemBenchmarks(FMicroBenchmarkSuite& Suite);
+void AddCullingBenchmarks(FMicroBenchmarkSuite& Suite);
+void AddSceneBenchmarks(FMicroBenchmarkSuite& Suite);
+void AddRenderGraphBenchmarks(FMicroBenchmarkSuite& Suite);
@@ -0,0 +1,246 @@
+#include "MicroBenchmark.h"
+#include "../Source/Render/RenderGraph.h"
+#include "../Source/RHI/DX12CommandContext.h"
+#include "../Source/RHI/DX12Device.h"
+
+#include <d3dx12.h>
+#include <memory>
+#include <string>
+
+namespace
+{
+    constexpr uint32 FrameCount = 3;
+    constexpr uint32 Width = 1920;
+    constexpr uint32 Height = 1080;
+    constexpr uint32 BloomMipCount = 5;
+    // More topologies than FRenderGraph keeps compiled, so cycling through them misses every time.
+    constexpr uint32 TopologyVariantCount = 16;
+
+    struct FGraphState
+    {
+        std::unique_ptr<FDX12Device> Device;
+        std::unique_ptr<FDX12CommandContext> CmdContext;
+        ComPtr<ID3D12Resource> BackBuffer;
+        D3D12_RESOURCE_STATES BackBufferState = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        uint32 FrameIndex = 0;
+        uint32 Variant = 0;
+    };
+
+    struct FBenchmarkPassData
+    {
+        FRGResourceHandle Output;
+    };
+
+    // Passes record nothing, so only the graph's own bookkeeping, compilation and barriers are timed.
+    void EmptyExecute(const FBenchmarkPassData&, FDX12CommandContext&)
+    {
+    }
+
+    // A frame shaped like the deferred renderer's: prepass, G-buffer, HZB, shadows, light
+    // clustering, lighting, sky, TAA, a bloom chain, exposure and tonemapping into the back
+    // buffer, plus a debug pass nothing reads so culling has work too.
+    void AddBenchmarkFrame(FRenderGraph& Graph, FGraphState& State, const std::string& Suffix)
+    {
+        const FRGTextureDesc FullResColor{ Width, Height, DXGI_FORMAT_R16G16B16A16_FLOAT };
+        const FRGResourceHandle BackBuffer = Graph.ImportTexture("BackBuffer", State.BackBuffer.Get(), &State.BackBufferState, { Width, Height, DXGI_FORMAT_R8G8B8A8_UNORM });
+
+        FRGResourceHandle Depth;
+        Graph.AddPass<FBenchmarkPassData>("DepthPrepass" + Suffix, [&](FBenchmarkPassData& Data, FRGPassBuilder& Builder)
+        {
+            Depth = Builder.CreateTexture("Depth", { Width, Height, DXGI_FORMAT_D32_FLOAT });
+            Data.Output = Builder.WriteTexture(Depth, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+        }, EmptyExecute);
+
+        FRGResourceHandle GBuffer[3];
+        Graph.AddPass<FBenchmarkPassData>("GBuffer" + Suffix, [&](FBenchmarkPassData& Data, FRGPassBuilder& Builder)
+        {
+            GBuffer[0] = Builder.CreateTexture("GBufferA", { Width, Height, DXGI_FORMAT_R8G8B8A8_UNORM });
+            GBuffer[1] = Builder.CreateTexture("GBufferB", { Width, Height, DXGI_FORMAT_R10G10B10A2_UNORM });
+            GBuffer[2] = Builder.CreateTexture("GBufferC", FullResColor);
+            for (const FRGResourceHandle& Target : GBuffer)
+            {
+                Builder.WriteTexture(Target);
+            }
+            Data.Output = Builder.WriteTexture(Depth, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+        }, EmptyExecute);
+
+        FRGResourceHandle Hzb;
+        Graph.AddPass<FBenchmarkPassData>("BuildHZB" + Suffix, [&](FBenchmarkPassData& Data, FRGPassBuilder& Builder)
+        {
+            Builder.ReadTexture(Depth, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Hzb = Builder.CreateTexture("HZB", { Width / 2, Height / 2, DXGI_FORMAT_R32_FLOAT });
+            Data.Output = Builder.WriteTexture(Hzb, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        }, EmptyExecute);
+
+        FRGResourceHandle ShadowMap;
+        Graph.AddPass<FBenchmarkPassData>("ShadowDepth" + Suffix, [&](FBenchmarkPassData& Data, FRGPassBuilder& Builder)
+        {
+            ShadowMap = Builder.CreateTexture("ShadowMap", { 2048, 2048, DXGI_FORMAT_D32_FLOAT });
+            Data.Output = Builder.WriteTexture(ShadowMap, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+        }, EmptyExecute);
+
+        FRGResourceHandle LightGrid;
+        Graph.AddPass<FBenchmarkPassData>("ClusterLights" + Suffix, [&](FBenchmarkPassData& Data, FRGPassBuilder& Builder)
+        {
+            Builder.ReadTexture(Hzb, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            LightGrid = Builder.CreateBuffer("LightGrid", { 4ull << 20 });
+            Data.Output = Builder.WriteBuffer(LightGrid);
+        }, EmptyExecute);
+
+        FRGResourceHandle SceneColor;
+        Graph.AddPass<FBenchmarkPassData>("Lighting" + Suffix, [&](FBenchmarkPassData& Data, FRGPassBuilder& Builder)
+        {
+            for (const FRGResourceHandle& Target : GBuffer)
+            {
+                Builder.ReadTexture(Target, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            }
+            Builder.ReadTexture(Depth, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Builder.ReadTexture(ShadowMap, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Builder.ReadBuffer(LightGrid);
+            SceneColor = Builder.CreateTexture("SceneColor", FullResColor);
+            Data.Output = Builder.WriteTexture(SceneColor, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        }, EmptyExecute);
+
+        Graph.AddPass<FBenchmarkPassData>("Sky" + Suffix, [&](FBenchmarkPassData& Data, FRGPassBuilder& Builder)
+        {
+            Builder.ReadTexture(Depth, D3D12_RESOURCE_STATE_DEPTH_READ);
+            Data.Output = Builder.WriteTexture(SceneColor);
+        }, EmptyExecute);
+
+        FRGResourceHandle Resolved;
+        Graph.AddPass<FBenchmarkPassData>("TemporalAA" + Suffix, [&](FBenchmarkPassData& Data, FRGPassBuilder& Builder)
+        {
+            Builder.ReadTexture(SceneColor, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Builder.ReadTexture(Depth, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Resolved = Builder.CreateTexture("TAAOutput", FullResColor);
+            Data.Output = Builder.WriteTexture(Resolved, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        }, EmptyExecute);
+
+        FRGResourceHandle Bloom[BloomMipCount];
+        for (uint32 Mip = 0; Mip < BloomMipCount; ++Mip)
+        {
+            Graph.AddPass<FBenchmarkPassData>("BloomDown" + std::to_string(Mip) + Suffix, [&](FBenchmarkPassData& Data, FRGPassBuilder& Builder)
+            {
+                Builder.ReadTexture(Mip == 0 ? Resolved : Bloom[Mip - 1]);
+                Bloom[Mip] = Builder.CreateTexture("BloomDown" + std::to_string(Mip), { Width >> (Mip + 1), Height >> (Mip + 1), DXGI_FORMAT_R11G11B10_FLOAT });
+                Data.Output = Builder.WriteTexture(Bloom[Mip]);
+            }, EmptyExecute);
+        }
+        for (uint32 Mip = BloomMipCount - 1; Mip > 0; --Mip)
+        {
+            Graph.AddPass<FBenchmarkPassData>("BloomUp" + std::to_string(Mip) + Suffix, [&](FBenchmarkPassData& Data, FRGPassBuilder& Builder)
+            {
+                Builder.ReadTexture(Bloom[Mip]);
+                Data.Output = Builder.WriteTexture(Bloom[Mip - 1]);
+            }, EmptyExecute);
+        }
+
+        FRGResourceHandle Exposure;
+        Graph.AddPass<FBenchmarkPassData>("AutoExposure" + Suffix, [&](FBenchmarkPassData& Data, FRGPassBuilder& Builder)
+        {
+            Builder.ReadTexture(Resolved, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Exposure = Builder.CreateBuffer("Exposure", { 1024 });
+            Data.Output = Builder.WriteBuffer(Exposure);
+        }, EmptyExecute);
+
+        Graph.AddPass<FBenchmarkPassData>("DebugView" + Suffix, [&](FBenchmarkPassData& Data, FRGPassBuilder& Builder)
+        {
+            Builder.ReadTexture(GBuffer[1]);
+            const FRGResourceHandle DebugTarget = Builder.CreateTexture("DebugView", { Width, Height, DXGI_FORMAT_R8G8B8A8_UNORM });
+            Data.Output = Builder.WriteTexture(DebugTarget);
+        }, EmptyExecute);
+
+        Graph.AddPass<FBenchmarkPassData>("Tonemap" + Suffix, [&](FBenchmarkPassData& Data, FRGPassBuilder& Builder)
+        {
+            Builder.ReadTexture(Resolved);
+            Builder.ReadTexture(Bloom[0]);
+            Builder.ReadBuffer(Exposure, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+            Data.Output = Builder.WriteTexture(BackBuffer);
+        }, EmptyExecute);
+    }
+
+    bool InitializeGraphState(FGraphState& State)
+    {
+        State.Device = std::make_unique<FDX12Device>();
+        if (!State.Device->Initialize(true))
+        {
+            return false;
+        }
+
+        State.CmdContext = std::make_unique<FDX12CommandContext>();
+        if (!State.CmdContext->Initialize(State.Device.get(), State.Device->GetGraphicsQueue(), FrameCount))
+        {
+            return false;
+        }
+
+        const CD3DX12_HEAP_PROPERTIES HeapProperties(D3D12_HEAP_TYPE_DEFAULT);
+        const CD3DX12_RESOURCE_DESC Desc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, Width, Height, 1, 1, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+        return SUCCEEDED(State.Device->CreateCommittedResource(
+            EGpuMemoryCategory::RenderTarget,
+            &HeapProperties,
+            D3D12_HEAP_FLAG_NONE,
+            &Desc,
+            State.BackBufferState,
+            nullptr,
+            IID_PPV_ARGS(State.BackBuffer.GetAddressOf())));
+    }
+
+    // Submits the frame's barriers and retires its allocator the way the application's frame loop does.
+    void EndGraphFrame(FGraphState& State)
+    {
+        State.CmdContext->CloseAndExecute();
+
+        const uint64 FenceValue = State.Device->GetGraphicsQueue()->Signal();
+        State.CmdContext->SetFrameFenceValue(State.CmdContext->GetCurrentFrameIndex(), FenceValue);
+        FRenderGraph::RetireFrameAllocations(State.CmdContext->GetCurrentFrameIndex(), FenceValue);
+        State.Device->GetUploadRing()->EndFrame(FenceValue);
+        State.Device->GetDescriptorAllocator()->EndFrame(FenceValue);
+        ++State.FrameIndex;
+    }
+
+    FMicroBenchmarkCase MakeGraphCase(const std::shared_ptr<FGraphState>& State, const char* Name, bool bRecompile)
+    {
+        FMicroBenchmarkCase Case;
+        Case.Name = Name;
+        Case.WarmupIterations = TopologyVariantCount;
+        Case.Iterations = 100;
+        Case.ItemsPerIteration = 1;
+        Case.Setup = [State]() { State->CmdContext->BeginFrame(State->FrameIndex % FrameCount); };
+        Case.Run = [State, bRecompile]()
+        {
+            const std::string Suffix = bRecompile ? "#" + std::to_string(State->Variant) : std::string();
+            State->Variant = (State->Variant + 1) % TopologyVariantCount;
+
+            FRenderGraph Graph(*State->CmdContext);
+            Graph.SetDevice(State->Device.get());
+            AddBenchmarkFrame(Graph, *State, Suffix);
+            Graph.Execute(*State->CmdContext);
+        };
+        Case.Teardown = [State]() { EndGraphFrame(*State); };
+        return Case;
+    }
+}
+
+void AddRenderGraphBenchmarks(FMicroBenchmarkSuite& Suite)
+{
+    const char* CachedName = "RenderGraph/Execute/CachedTopology";
+    const char* CompileName = "RenderGraph/Execute/Compile";
+    if (!Suite.IsEnabled(CachedName) && !Suite.IsEnabled(CompileName))
+    {
+        return;
+    }
+
+    // The WARP adapter stands in for the GPU: the graph gets real heaps and command lists, and
+    // the passes record no work, so the timings do not depend on the machine's graphics card.
+    auto State = std::make_shared<FGraphState>();
+    if (!InitializeGraphState(*State))
+    {
+        Suite.Skip(CachedName, "WARP device unavailable");
+        Suite.Skip(CompileName, "WARP device unavailable");
+        return;
+    }
+
+    Suite.Add(MakeGraphCase(State, CachedName, false));
+    // Pass names change every iteration, so the topology hash misses and the graph is compiled again.
+    Suite.Add(MakeGraphCase(State, CompileName, true));
+}
@@ -0,0 +1,159 @@
+#include "MicroBenchmark.h"
+#include "../Source/Core/MappedFile.h"
+#include "../Source/Scene/JsonDocument.h"
+#include "../Source/Scene/Mesh.h"
+#include "../Source/Scene/SceneJsonLoader.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Every .gltf one directory below Assets/, sorted so the case order is stable.
+    std::vector<std::filesystem::path> FindSampleGltfFiles()
+    {
+        namespace fs = std::filesystem;
+
+        std::vector<fs::path> Files;
+        std::error_code Error;
+        for (const fs::directory_entry& Directory : fs::directory_iterator("Assets", Error))
+        {
+            if (!Directory.is_directory())
+            {
+                continue;
+            }
+            for (const fs::directory_entry& Entry : fs::directory_iterator(Directory.path(), Error))
+            {
+                if (Entry.is_regular_file() && Entry.path().extension() == ".gltf")
+                {
+                    Files.push_back(Entry.path());
+                }
+            }
+        }
+        std::sort(Files.begin(), Files.end());
+        return Files;
+    }
+
+    void AddJsonCases(FMicroBenchmarkSuite& Suite)
+    {
+        const std::vector<std::filesystem::path> Files = FindSampleGltfFiles();
+        if (Files.empty())
+        {
+            Suite.Skip("Json/Parse", "no glTF files under Assets/");
+            return;
+        }
+
+        for (const std::filesystem::path& File : Files)
+        {
+            const std::string Name = "Json/Parse/" + File.parent_path().filename().string() + "/" + File.filename().string();
+            if (!Suite.IsEnabled(Name))
+            {
+                continue;
+            }
+
+            auto Mapped = std::make_shared<FMappedFile>();
+            if (!Mapped->Open(File.wstring()))
+            {
+                Suite.Skip(Name, "failed to map " + File.string());
+                continue;
+            }
+
+            // Items are source bytes, so the reported rate is parse bandwidth.
+            FMicroBenchmarkCase Case;
+            Case.Name = Name;
+            Case.Iterations = 100;
+            Case.ItemsPerIteration = Mapped->GetSize();
+            Case.Run = [Mapped]()
+            {
+                FJsonDocument Document;
+                Document.Parse(Mapped->GetText());
+            };
+            Suite.Add(std::move(Case));
+        }
+    }
+
+    void AddTangentCase(FMicroBenchmarkSuite& Suite, const char* Name, uint32_t SliceCount, uint32_t StackCount)
+    {
+        if (!Suite.IsEnabled(Name))
+        {
+            return;
+        }
+
+        struct FTangentState
+        {
+            std::vector<FMesh::FVertex> SourceVertices;
+            FMesh Mesh;
+        };
+
+        auto State = std::make_shared<FTangentState>();
+        State->Mesh = FMesh::CreateSphere(1.0f, SliceCount, StackCount);
+        State->SourceVertices = State->Mesh.GetVertices();
+        for (FMesh::FVertex& Vertex : State->SourceVertices)
+        {
+            Vertex.Tangent = FFloat4(0.0f, 0.0f, 0.0f, 0.0f);
+        }
+
+        FMicroBenchmarkCase Case;
+        Case.Name = Name;
+        Case.ItemsPerIteration = State->Mesh.GetIndices().size() / 3;
+        // Cleared again before every call, otherwise the mesh would already have its tangents.
+        Case.Setup = [State]() { State->Mesh.SetVertices(State->SourceVertices); };
+        Case.Run = [State]() { State->Mesh.GenerateTangentsIfMissing(); };
+        Suite.Add(std::move(Case));
+    }
+
+    void AddSceneLoaderCases(FMicroBenchmarkSuite& Suite)
+    {
+        const std::wstring ScenePaths[2] = { L"Assets/Scenes/Scene.json", L"Assets/Scenes/metal_spheres.json" };
+        for (const std::wstring& Path : ScenePaths)
+        {
+            if (!std::filesystem::exists(Path))
+            {
+                Suite.Skip("SceneJsonLoader/LoadScene", "missing " + std::filesystem::path(Path).string());
+                return;
+            }
+        }
+
+        struct FLoaderState
+        {
+            std::vector<FSceneModelDesc> Models;
+            uint32_t NextPath = 0;
+        };
+        auto State = std::make_shared<FLoaderState>();
+
+        {
+            // Repeated loads of one file are served from the loader's last parsed scene.
+            FMicroBenchmarkCase Case;
+            Case.Name = "SceneJsonLoader/LoadScene/Cached";
+            Case.Iterations = 200;
+            Case.ItemsPerIteration = 1;
+            Case.Run = [State, Path = ScenePaths[0]]() { FSceneJsonLoader::LoadScene(Path, State->Models); };
+            Suite.Add(std::move(Case));
+        }
+
+        {
+            // Alternating files misses that cache on every call, so each one reads and parses.
+            FMicroBenchmarkCase Case;
+            Case.Name = "SceneJsonLoader/LoadScene/Uncached";
+            Case.Iterations = 200;
+            Case.ItemsPerIteration = 1;
+            Case.Run = [State, ScenePaths]()
+            {
+                FSceneJsonLoader::LoadScene(ScenePaths[State->NextPath], State->Models);
+                State->NextPath ^= 1u;
+            };
+            Suite.Add(std::move(Case));
+        }
+    }
+}
+
+void AddSceneBenchmarks(FMicroBenchmarkSuite& Suite)
+{
+    AddJsonCases(Suite);
+    AddTangentCase(Suite, "Mesh/GenerateTangentsIfMissing/Sphere16K", 128, 64);
+    AddTangentCase(Suite, "Mesh/GenerateTangentsIfMissing/Sphere262K", 512, 256);
+    AddSceneLoaderCases(Suite);
+}
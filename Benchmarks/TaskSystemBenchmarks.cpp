@@ -0,0 +1,194 @@
+#include "MicroBenchmark.h"
+#include "../Source/Core/TaskSystem.h"
+
+#include <Windows.h>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t SpawnTaskCount = 64 * 1024;
+    constexpr uint32_t ScheduledTaskCount = 16 * 1024;
+    constexpr uint32_t FanOutWidth = 64;
+
+    // Spins rather than waiting through the scheduler, so the calling thread never runs the task itself.
+    void SpinUntilDone(const FTaskCounter& Counter)
+    {
+        while (!Counter.IsDone())
+        {
+            YieldProcessor();
+        }
+    }
+
+    void AddSchedulerCases(FMicroBenchmarkSuite& Suite)
+    {
+        {
+            FMicroBenchmarkCase Case;
+            Case.Name = "TaskScheduler/Spawn/Throughput";
+            Case.ItemsPerIteration = SpawnTaskCount;
+            Case.Run = []()
+            {
+                FTaskScheduler& Scheduler = FTaskScheduler::Get();
+                FTaskCounter Counter;
+                for (uint32_t Index = 0; Index < SpawnTaskCount; ++Index)
+                {
+                    Scheduler.Spawn(Counter, []() {});
+                }
+                Scheduler.WaitForCounter(Counter);
+            };
+            Suite.Add(std::move(Case));
+        }
+
+        {
+            // Fan-out from inside a task goes through the worker's own deque and stealing, not the injection queue.
+            FMicroBenchmarkCase Case;
+            Case.Name = "TaskScheduler/Spawn/NestedFanOut";
+            Case.ItemsPerIteration = FanOutWidth * FanOutWidth;
+            Case.Run = []()
+            {
+                FTaskScheduler& Scheduler = FTaskScheduler::Get();
+                FTaskCounter Counter;
+                for (uint32_t Outer = 0; Outer < FanOutWidth; ++Outer)
+                {
+                    Scheduler.Spawn(Counter, [&Counter]()
+                    {
+                        FTaskScheduler& InnerScheduler = FTaskScheduler::Get();
+                        for (uint32_t Inner = 0; Inner < FanOutWidth; ++Inner)
+                        {
+                            InnerScheduler.Spawn(Counter, []() {});
+                        }
+                    });
+                }
+                Scheduler.WaitForCounter(Counter);
+            };
+            Suite.Add(std::move(Case));
+        }
+
+        {
+            struct FBatchState
+            {
+                std::vector<FTask::FTaskFunction> Functions;
+            };
+            auto State = std::make_shared<FBatchState>();
+            State->Functions.assign(ScheduledTaskCount, []() {});
+
+            FMicroBenchmarkCase Case;
+            Case.Name = "TaskScheduler/ScheduleTaskBatch/Throughput";
+            Case.ItemsPerIteration = ScheduledTaskCount;
+            Case.Run = [State]()
+            {
+                FTaskScheduler& Scheduler = FTaskScheduler::Get();
+                const std::vector<FTaskRef> Tasks = Scheduler.ScheduleTaskBatch(State->Functions);
+                Scheduler.WaitForTask(Scheduler.ScheduleJoin(Tasks));
+            };
+            Suite.Add(std::move(Case));
+        }
+
+        {
+            // Workers have gone to sleep before every spawn, so this includes their wake-up.
+            FMicroBenchmarkCase Case;
+            Case.Name = "TaskScheduler/Latency/IdleWorkers";
+            Case.WarmupIterations = 10;
+            Case.Iterations = 200;
+            Case.ItemsPerIteration = 1;
+            Case.Setup = []()
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            };
+            Case.Run = []()
+            {
+                FTaskCounter Counter;
+                FTaskScheduler::Get().Spawn(Counter, []() {});
+                SpinUntilDone(Counter);
+            };
+            Suite.Add(std::move(Case));
+        }
+
+        {
+            FMicroBenchmarkCase Case;
+            Case.Name = "TaskScheduler/Latency/BusyWorkers";
+            Case.WarmupIterations = 100;
+            Case.Iterations = 2000;
+            Case.ItemsPerIteration = 1;
+            Case.Run = []()
+            {
+                FTaskCounter Counter;
+                FTaskScheduler::Get().Spawn(Counter, []() {});
+                SpinUntilDone(Counter);
+            };
+            Suite.Add(std::move(Case));
+        }
+    }
+
+    void AddParallelForCases(FMicroBenchmarkSuite& Suite)
+    {
+        struct FArrayState
+        {
+            std::vector<float> Input;
+            std::vector<float> Output;
+        };
+
+        // Fixed seed, so every run sees the same input.
+        auto State = std::make_shared<FArrayState>();
+        std::mt19937 Random(1234u);
+        std::uniform_real_distribution<float> Distribution(0.0f, 1000.0f);
+        State->Input.resize(1u << 20);
+        for (float& Value : State->Input)
+        {
+            Value = Distribution(Random);
+        }
+        State->Output.resize(State->Input.size());
+
+        const auto AddRangeCase = [&Suite, &State](const char* Name, uint32_t Count)
+        {
+            FMicroBenchmarkCase Case;
+            Case.Name = Name;
+            Case.ItemsPerIteration = Count;
+            Case.Run = [State, Count]()
+            {
+                const float* Input = State->Input.data();
+                float* Output = State->Output.data();
+                FParallelFor::ExecuteRange(0, Count, [Input, Output](uint32_t Begin, uint32_t End)
+                {
+                    for (uint32_t Index = Begin; Index < End; ++Index)
+                    {
+                        Output[Index] = std::sqrt(Input[Index]) * 0.5f + 1.0f;
+                    }
+                });
+            };
+            Suite.Add(std::move(Case));
+        };
+
+        AddRangeCase("ParallelFor/ExecuteRange/1M", 1u << 20);
+        // Below the serial threshold; measures the probe and the inline fallback.
+        AddRangeCase("ParallelFor/ExecuteRange/4K", 4096);
+
+        {
+            constexpr uint32_t Count = 256 * 1024;
+
+            FMicroBenchmarkCase Case;
+            Case.Name = "ParallelFor/Execute/256K";
+            Case.ItemsPerIteration = Count;
+            Case.Run = [State]()
+            {
+                const float* Input = State->Input.data();
+                float* Output = State->Output.data();
+                FParallelFor::Execute(0, Count, [Input, Output](uint32_t Index)
+                {
+                    Output[Index] = std::sqrt(Input[Index]) * 0.5f + 1.0f;
+                });
+            };
+            Suite.Add(std::move(Case));
+        }
+    }
+}
+
+void AddTaskSystemBenchmarks(FMicroBenchmarkSuite& Suite)
+{
+    AddSchedulerCases(Suite);
+    AddParallelForCases(Suite);
+}
@@ -0,0 +1,186 @@
+// Builds every HZB mip in one dispatch, in the style of AMD's single-pass downsampler. Each group
+// reduces a 32x32 tile of mip 0 down to one texel of mip 5 in registers and groupshared memory;
+// the last group to finish, found with a global atomic counter, then reduces mip 5 to the tail.
+// Produces the same 2x2 min reduction as BuildHZB.hlsl, which remains the fallback; texels past a
+// mip's edge enter the in-group levels as far depth, which leaves each min unchanged.
+
+#define HZB_SPD_MAX_MIPS 16
+#define HZB_SPD_GROUP_MIPS 6
+
+cbuffer HZBConstants : register(b0)
+{
+    uint SourceWidth;
+    uint SourceHeight;
+    uint DestWidth;
+    uint DestHeight;
+    uint MipCount;
+    uint GroupCount;
+};
+
+Texture2D<float> SourceTexture : register(t0);
+// Unused slots hold null views. Coherent so the last group reads mip 5 as the other groups wrote it.
+globallycoherent RWTexture2D<float> DestMips[HZB_SPD_MAX_MIPS] : register(u0);
+// Groups finished this dispatch; the last group resets it for the next one.
+globallycoherent RWByteAddressBuffer GroupCounter : register(u0, space1);
+
+groupshared float SharedDepthA[16][16];
+groupshared float SharedDepthB[8][8];
+groupshared uint SharedIsLastGroup;
+
+float SampleDepth(uint2 coord)
+{
+    const uint x = min(coord.x, SourceWidth - 1);
+    const uint y = min(coord.y, SourceHeight - 1);
+    return SourceTexture.Load(int3(x, y, 0));
+}
+
+uint2 GetMipSize(uint mip)
+{
+    uint2 size = uint2(DestWidth, DestHeight);
+    for (uint level = 0; level < mip; ++level)
+    {
+        size = max(size / 2, uint2(1, 1));
+    }
+    return size;
+}
+
+// Clamped to the mip's edge like SampleDepth, for the tail levels read back from memory.
+float LoadMip(uint mip, uint2 coord, uint2 size)
+{
+    return DestMips[mip][min(coord, size - 1)];
+}
+
+[numthreads(16, 16, 1)]
+void BuildHZBSinglePass(
+    uint3 groupThreadId : SV_GroupThreadID,
+    uint3 groupId : SV_GroupID,
+    uint groupIndex : SV_GroupIndex)
+{
+    // Mip 0: each thread writes a 2x2 quad of texels and keeps their min as its mip 1 texel.
+    const uint2 size0 = uint2(DestWidth, DestHeight);
+    const uint2 quadBase = groupId.xy * 32 + groupThreadId.xy * 2;
+    float quadMin = 1.0f;
+    [unroll]
+    for (uint i = 0; i < 4; ++i)
+    {
+        const uint2 coord = quadBase + uint2(i & 1, i >> 1);
+        if (coord.x < size0.x && coord.y < size0.y)
+        {
+            const uint2 baseCoord = coord * 2;
+            const float d0 = SampleDepth(baseCoord);
+            const float d1 = SampleDepth(baseCoord + uint2(1, 0));
+            const float d2 = SampleDepth(baseCoord + uint2(0, 1));
+            const float d3 = SampleDepth(baseCoord + uint2(1, 1));
+            const float minDepth = min(min(d0, d1), min(d2, d3));
+            DestMips[0][coord] = minDepth;
+            quadMin = min(quadMin, minDepth);
+        }
+    }
+
+    if (MipCount > 1)
+    {
+        const uint2 size1 = GetMipSize(1);
+        const uint2 coord1 = groupId.xy * 16 + groupThreadId.xy;
+        if (coord1.x < size1.x && coord1.y < size1.y)
+        {
+            DestMips[1][coord1] = quadMin;
+        }
+        else
+        {
+            quadMin = 1.0f;
+        }
+    }
+    SharedDepthA[groupThreadId.y][groupThreadId.x] = quadMin;
+
+    // Mips 2 to 5 alternate between the two groupshared tiles, halving the active threads each level.
+    [unroll]
+    for (uint level = 2; level < HZB_SPD_GROUP_MIPS; ++level)
+    {
+        GroupMemoryBarrierWithGroupSync();
+
+        const uint tileSize = 32 >> level;
+        if (level < MipCount && groupThreadId.x < tileSize && groupThreadId.y < tileSize)
+        {
+            const uint2 base = groupThreadId.xy * 2;
+            float s0, s1, s2, s3;
+            if ((level & 1) == 0)
+            {
+                s0 = SharedDepthA[base.y][base.x];
+                s1 = SharedDepthA[base.y][base.x + 1];
+                s2 = SharedDepthA[base.y + 1][base.x];
+                s3 = SharedDepthA[base.y + 1][base.x + 1];
+            }
+            else
+            {
+                s0 = SharedDepthB[base.y][base.x];
+                s1 = SharedDepthB[base.y][base.x + 1];
+                s2 = SharedDepthB[base.y + 1][base.x];
+                s3 = SharedDepthB[base.y + 1][base.x + 1];
+            }
+
+            float minDepth = min(min(s0, s1), min(s2, s3));
+            const uint2 size = GetMipSize(level);
+            const uint2 coord = groupId.xy * tileSize + groupThreadId.xy;
+            if (coord.x < size.x && coord.y < size.y)
+            {
+                DestMips[level][coord] = minDepth;
+            }
+            else
+            {
+                minDepth = 1.0f;
+            }
+
+            if ((level & 1) == 0)
+            {
+                SharedDepthB[groupThreadId.y][groupThreadId.x] = minDepth;
+            }
+            else
+            {
+                SharedDepthA[groupThreadId.y][groupThreadId.x] = minDepth;
+            }
+        }
+    }
+
+    if (MipCount <= HZB_SPD_GROUP_MIPS)
+    {
+        return;
+    }
+
+    // Thread 0 wrote this group's mip 5 texel; publish it before counting the group as done.
+    if (groupIndex == 0)
+    {
+        DeviceMemoryBarrier();
+        uint finishedGroups = 0;
+        GroupCounter.InterlockedAdd(0, 1, finishedGroups);
+        SharedIsLastGroup = finishedGroups == GroupCount - 1 ? 1u : 0u;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    if (SharedIsLastGroup == 0)
+    {
+        return;
+    }
+
+    if (groupIndex == 0)
+    {
+        GroupCounter.Store(0, 0u);
+    }
+
+    // The tail is small enough for one group: each level strides its threads over the texels.
+    for (uint mip = HZB_SPD_GROUP_MIPS; mip < MipCount; ++mip)
+    {
+        const uint2 sourceSize = GetMipSize(mip - 1);
+        const uint2 size = GetMipSize(mip);
+        for (uint texel = groupIndex; texel < size.x * size.y; texel += 256)
+        {
+            const uint2 coord = uint2(texel % size.x, texel / size.x);
+            const uint2 base = coord * 2;
+            const float s0 = LoadMip(mip - 1, base, sourceSize);
+            const float s1 = LoadMip(mip - 1, base + uint2(1, 0), sourceSize);
+            const float s2 = LoadMip(mip - 1, base + uint2(0, 1), sourceSize);
+            const float s3 = LoadMip(mip - 1, base + uint2(1, 1), sourceSize);
+            DestMips[mip][coord] = min(min(s0, s1), min(s2, s3));
+        }
+        DeviceMemoryBarrierWithGroupSync();
+    }
+}
@@ -20,6 +20,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include "CasCommon.hlsl"
+
 struct VSOutput
 {
     float4 Position : SV_Position;
@@ -51,11 +53,6 @@ cbuffer CasParams : register(b0)
 Texture2D InputTexture : register(t0);
 SamplerState InputSampler : register(s0);
 
-static const float3 LumCoeff = float3(0.2126f, 0.7152f, 0.0722f);
-static const float RcasPeak = 8.0f - 3.0f;
-static const float RcasInvPeak = 1.0f / RcasPeak;
-static const float FsrEps = 0.0001f;
-
 static const float2 CrossOffsets[4] =
 {
     float2(0.0f, -1.0f),
@@ -68,33 +65,10 @@ float4 PSMain(VSOutput Input) : SV_Target
 {
     float2 uv = Input.UV;
     float3 C = InputTexture.Sample(InputSampler, uv).rgb;
-    float CL = dot(C, LumCoeff);
-
     float3 N = InputTexture.Sample(InputSampler, uv + CrossOffsets[0] * TexelDelta).rgb;
     float3 W = InputTexture.Sample(InputSampler, uv + CrossOffsets[1] * TexelDelta).rgb;
     float3 E = InputTexture.Sample(InputSampler, uv + CrossOffsets[2] * TexelDelta).rgb;
     float3 S = InputTexture.Sample(InputSampler, uv + CrossOffsets[3] * TexelDelta).rgb;
 
-    float NL = dot(N, LumCoeff);
-    float WL = dot(W, LumCoeff);
-    float EL = dot(E, LumCoeff);
-    float SL = dot(S, LumCoeff);
-
-    float3 minRGB = min(min(min(N, W), min(E, S)), C);
-    float3 maxRGB = max(max(max(N, W), max(E, S)), C);
-    float3 invMax = 1.0f / (maxRGB + FsrEps);
-    float3 amp = clamp(min(minRGB, 2.0f - maxRGB) * invMax, 0.0f, 1.0f);
-    amp = rsqrt(amp + FsrEps);
-
-    float w = -RcasInvPeak / dot(amp, LumCoeff);
-
-    float sumL = NL + WL + EL + SL;
-    float invDen = 1.0f / (4.0f * w + 1.0f);
-    float sharpL = clamp((sumL * w + CL) * invDen, 0.0f, 1.0f);
-
-    float3 chroma = C - CL;
-    float3 sharpColor = chroma + sharpL;
-    float3 outColor = lerp(C, sharpColor, Sharpness);
-
-    return float4(outColor, 1.0f);
+    return float4(ApplyCas(C, N, W, E, S, Sharpness), 1.0f);
 }
@@ -0,0 +1,66 @@
+// Bins the scene's punctual lights into the cluster grid, one group per cluster. Each group builds
+// its cluster's view-space bounds and strides its threads over the lights, appending every light
+// whose range sphere reaches the bounds; lights past CLUSTER_MAX_LIGHTS are dropped.
+
+#include "PBRCommon.hlsl"
+#include "SceneConstants.hlsl"
+#include "ClusteredLightingCommon.hlsl"
+
+StructuredBuffer<PunctualLight> PunctualLights : register(t0);
+RWStructuredBuffer<uint> ClusterLightGrid : register(u0);
+
+#define CLUSTER_THREADS 64
+
+groupshared uint SharedLightCount;
+
+// View-space x and y per unit of depth along the ray through a pixel corner.
+float2 GetViewRaySlope(float2 pixel)
+{
+    float2 ndc = float2(pixel.x * ClusterInvViewportSize.x * 2.0f - 1.0f, 1.0f - pixel.y * ClusterInvViewportSize.y * 2.0f);
+    return ndc / float2(Projection._11, Projection._22);
+}
+
+[numthreads(CLUSTER_THREADS, 1, 1)]
+void ClusterLights(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    if (groupIndex == 0)
+    {
+        SharedLightCount = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    float2 pixelMin = groupId.xy * ClusterTileSize;
+    float2 pixelMax = pixelMin + ClusterTileSize;
+    float2 slopeMin = GetViewRaySlope(float2(pixelMin.x, pixelMax.y));
+    float2 slopeMax = GetViewRaySlope(float2(pixelMax.x, pixelMin.y));
+    float nearDepth = GetClusterSliceDepth(groupId.z);
+    float farDepth = GetClusterSliceDepth(groupId.z + 1);
+
+    float3 boundsMin = float3(min(slopeMin * nearDepth, slopeMin * farDepth), nearDepth);
+    float3 boundsMax = float3(max(slopeMax * nearDepth, slopeMax * farDepth), farDepth);
+
+    uint clusterIndex = GetClusterIndex(groupId);
+    uint listStart = GetClusterCount() + clusterIndex * CLUSTER_MAX_LIGHTS;
+    for (uint lightIndex = groupIndex; lightIndex < PunctualLightCount; lightIndex += CLUSTER_THREADS)
+    {
+        PunctualLight light = PunctualLights[lightIndex];
+        float3 center = mul(float4(light.Position, 1.0f), View).xyz;
+        float3 closest = clamp(center, boundsMin, boundsMax);
+        float3 delta = center - closest;
+        if (dot(delta, delta) <= light.Range * light.Range)
+        {
+            uint slot;
+            InterlockedAdd(SharedLightCount, 1u, slot);
+            if (slot < CLUSTER_MAX_LIGHTS)
+            {
+                ClusterLightGrid[listStart + slot] = lightIndex;
+            }
+        }
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    if (groupIndex == 0)
+    {
+        ClusterLightGrid[clusterIndex] = min(SharedLightCount, (uint)CLUSTER_MAX_LIGHTS);
+    }
+}
@@ -0,0 +1,80 @@
+// Light cluster grid shared by Shaders/ClusterLights.hlsl and the deferred lighting pass. The view
+// is split into ClusterCountX x ClusterCountY screen tiles and ClusterCountZ slices spaced
+// exponentially in view depth. The grid buffer holds one light count per cluster, then
+// CLUSTER_MAX_LIGHTS light indices per cluster. Include after PBRCommon.hlsl.
+
+// FClusteredLights::MaxLightsPerCluster in Source/Render/ClusteredLights.h.
+#define CLUSTER_MAX_LIGHTS 128
+
+// FClusterConstants in Source/Render/ClusteredLights.h.
+cbuffer ClusterConstants : register(b1)
+{
+    uint ClusterCountX;
+    uint ClusterCountY;
+    uint ClusterCountZ;
+    uint PunctualLightCount;
+    // Pixels per screen tile.
+    float2 ClusterTileSize;
+    // Slice of view depth z is floor(log(z) * ClusterSliceScale + ClusterSliceBias).
+    float ClusterSliceScale;
+    float ClusterSliceBias;
+    float2 ClusterInvViewportSize;
+};
+
+// FPunctualLightData in Source/Render/ClusteredLights.h. Point lights use a spot scale of 0 and
+// an offset of 1, so one falloff covers both types.
+struct PunctualLight
+{
+    float3 Position;
+    float Range;
+    float3 Color;
+    float SpotScale;
+    float3 Direction;
+    float SpotOffset;
+};
+
+uint GetClusterCount()
+{
+    return ClusterCountX * ClusterCountY * ClusterCountZ;
+}
+
+uint GetClusterIndex(uint3 cluster)
+{
+    return (cluster.z * ClusterCountY + cluster.y) * ClusterCountX + cluster.x;
+}
+
+// Cluster holding the pixel at the given positive view depth.
+uint GetClusterIndex(float2 pixel, float viewDepth)
+{
+    uint3 cluster;
+    cluster.xy = min(uint2(pixel / ClusterTileSize), uint2(ClusterCountX - 1, ClusterCountY - 1));
+    float slice = floor(log(max(viewDepth, 1e-4f)) * ClusterSliceScale + ClusterSliceBias);
+    cluster.z = (uint)clamp(slice, 0.0f, (float)(ClusterCountZ - 1));
+    return GetClusterIndex(cluster);
+}
+
+float GetClusterSliceDepth(uint slice)
+{
+    return exp(((float)slice - ClusterSliceBias) / ClusterSliceScale);
+}
+
+// Windowed inverse square falloff reaching zero at the light's range, times the spot cone falloff.
+float3 EvaluatePunctualLight(PunctualLight light, float3 worldPos, float3 albedo, float metallic, float roughness, float3 F0, float3 N, float3 V)
+{
+    float3 toLight = light.Position - worldPos;
+    float distanceSq = max(dot(toLight, toLight), 1e-8f);
+    float3 L = toLight * rsqrt(distanceSq);
+
+    float rangeRatio = distanceSq / (light.Range * light.Range);
+    float window = saturate(1.0f - rangeRatio * rangeRatio);
+    float attenuation = window * window / max(distanceSq, 1e-4f);
+
+    float spot = saturate(dot(-L, light.Direction) * light.SpotScale + light.SpotOffset);
+    attenuation *= spot * spot;
+
+    if (attenuation <= 0.0f)
+    {
+        return 0.0f;
+    }
+    return EvaluatePBR(albedo, metallic, roughness, F0, N, V, L) * light.Color * attenuation;
+}
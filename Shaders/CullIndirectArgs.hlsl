@@ -8,160 +8,228 @@ cbuffer CullingConstants : register(b0)
     uint HZBWidth;
     uint HZBHeight;
     uint DebugPrintEnabled;
+    // A level is used once Error * LodErrorScale <= distance; see RendererUtils::ComputeLodErrorScale.
+    float LodErrorScale;
+    uint CommandCount;
+    float3 LodCameraPosition;
+    // EGpuCullingPhase in Source/Render/Renderer.h.
+    uint CullingPhase;
+    // Byte offset of the range counts in CompactedArgs.
+    uint CompactedCountOffset;
+    // Ranges per command set; 0 when commands are drawn uncompacted.
+    uint RangeCount;
+    // Pixels of the view's render target, which MinScreenCoverage is measured in.
+    float2 TargetSize;
+    // Models whose projected bounds span fewer pixels on their larger side are culled; 0 disables.
+    float MinScreenCoverage;
 };
 
-StructuredBuffer<float4> ModelBounds : register(t0);
+#define MAX_MODEL_LODS 4
+
+struct ModelLod
+{
+    uint IndexStart;
+    uint IndexCount;
+    float Error;
+};
+
+// FModelCullingData in Source/Render/RendererUtils.h, one per scene model.
+struct ModelCullingData
+{
+    float3 BoundsMin;
+    uint LodCount;
+    float3 BoundsMax;
+    // First command of the model's instance group; the group has one command per LOD.
+    uint CommandStart;
+    ModelLod Lods[MAX_MODEL_LODS];
+};
+
+StructuredBuffer<ModelCullingData> ModelBounds : register(t0);
 Texture2D<float> HZBTexture : register(t1);
 RWByteAddressBuffer IndirectArgs : register(u0);
 RWByteAddressBuffer DebugPrintBuffer : register(u1);
 RWByteAddressBuffer DebugPrintStats : register(u2);
+RWStructuredBuffer<uint> VisibleInstances : register(u3);
+// Nonzero for models phase two found visible last frame; only the two-phase kernels touch it.
+RWStructuredBuffer<uint> InstanceVisibility : register(u4);
 
-#include "DebugPrintCommon.hlsl"
+// FIndirectCommandRange in Source/Render/RendererUtils.h, one per command of every command set.
+struct CommandRange
+{
+    uint CounterIndex;
+    uint OutputStart;
+};
 
-static const uint kCommandStride = 64;
-static const uint kInstanceCountOffset = 44;
+StructuredBuffer<CommandRange> CommandRanges : register(t2);
+RWByteAddressBuffer CompactedArgs : register(u5);
 
-bool IsAabbVisible(float3 boundsMin, float3 boundsMax)
+#include "DebugPrintCommon.hlsl"
+#include "CullingCommon.hlsl"
+
+// FIndirectDrawCommand: instance base root constant, D3D12_DRAW_INDEXED_ARGUMENTS.
+static const uint kCommandStride = 24;
+static const uint kInstanceBaseOffset = 0;
+static const uint kInstanceCountOffset = 8;
+
+// Single tests the bound HZB once. First draws the models visible last frame without an occlusion
+// test; Second tests every model against the HZB built from the first phase's depth and appends the
+// ones the first phase skipped to the second command set, CommandCount commands past the first.
+static const uint kCullingPhaseSingle = 0;
+static const uint kCullingPhaseFirst = 1;
+static const uint kCullingPhaseSecond = 2;
+
+// Coarsest level whose error projects to no more than the threshold; mirrored by RendererUtils::SelectModelLod.
+uint SelectLod(ModelCullingData data)
 {
-    [unroll]
-    for (uint i = 0; i < 6; ++i)
-    {
-        float4 plane = FrustumPlanes[i];
-        float3 positiveVertex = float3(
-            plane.x >= 0.0f ? boundsMax.x : boundsMin.x,
-            plane.y >= 0.0f ? boundsMax.y : boundsMin.y,
-            plane.z >= 0.0f ? boundsMax.z : boundsMin.z);
+    float3 delta = max(max(data.BoundsMin - LodCameraPosition, LodCameraPosition - data.BoundsMax), 0.0f);
+    float distance = length(delta);
 
-        if (dot(plane.xyz, positiveVertex) + plane.w < 0.0f)
+    uint lod = 0;
+    for (uint i = 1; i < min(data.LodCount, MAX_MODEL_LODS); ++i)
+    {
+        if (data.Lods[i].Error * LodErrorScale <= distance)
         {
-            return false;
+            lod = i;
         }
     }
-    return true;
+    return lod;
 }
 
-float4 ProjectToClip(float3 position)
+// Dispatched over the commands before CSMain so every group starts the frame empty. The first
+// phase empties the second command set as well, which the second phase only appends to.
+[numthreads(64, 1, 1)]
+void CSResetInstanceCounts(uint3 dispatchThreadId : SV_DispatchThreadID)
 {
-    return mul(float4(position, 1.0f), ViewProjection);
+    uint setCount = CullingPhase == kCullingPhaseFirst ? 2 : 1;
+    if (dispatchThreadId.x < CommandCount * setCount)
+    {
+        IndirectArgs.Store(dispatchThreadId.x * kCommandStride + kInstanceCountOffset, 0u);
+    }
+    // There are never more ranges than commands, so the same dispatch covers the range counts.
+    if (dispatchThreadId.x < RangeCount * setCount)
+    {
+        CompactedArgs.Store(CompactedCountOffset + dispatchThreadId.x * 4, 0u);
+    }
 }
 
-bool IsOccluded(float3 boundsMin, float3 boundsMax)
+// One thread per scene model; visible models append themselves to the command of the LOD they select.
+[numthreads(64, 1, 1)]
+void CSMain(uint3 dispatchThreadId : SV_DispatchThreadID, uint groupIndex : SV_GroupIndex)
 {
-    if (HZBEnabled == 0 || HZBWidth == 0 || HZBHeight == 0 || HZBMipCount == 0)
+    uint index = dispatchThreadId.x;
+    if (index >= ModelCount)
     {
-        return false;
+        return;
     }
 
-    float3 corners[8] =
+    // Models tested; the group's first thread counts the whole group.
+    if (DebugPrintEnabled != 0 && groupIndex == 0 && CullingPhase != kCullingPhaseFirst)
     {
-        float3(boundsMin.x, boundsMin.y, boundsMin.z),
-        float3(boundsMax.x, boundsMin.y, boundsMin.z),
-        float3(boundsMin.x, boundsMax.y, boundsMin.z),
-        float3(boundsMax.x, boundsMax.y, boundsMin.z),
-        float3(boundsMin.x, boundsMin.y, boundsMax.z),
-        float3(boundsMax.x, boundsMin.y, boundsMax.z),
-        float3(boundsMin.x, boundsMax.y, boundsMax.z),
-        float3(boundsMax.x, boundsMax.y, boundsMax.z)
-    };
-
-    float2 minUv = float2(1.0f, 1.0f);
-    float2 maxUv = float2(0.0f, 0.0f);
-    float maxDepth = 0.0f;
-
-    bool anyBehind = false;
+        DebugPrintStats.InterlockedAdd(16, min(64u, ModelCount - index));
+    }
 
-    [unroll]
-    for (uint i = 0; i < 8; ++i)
-    {
-        float4 clip = ProjectToClip(corners[i]);
-        if (clip.w <= 0.0f)
-        {
-            anyBehind = true;
-            break;
-        }
+    ModelCullingData data = ModelBounds[index];
+    float3 boundsMin = data.BoundsMin;
+    float3 boundsMax = data.BoundsMax;
+    bool frustumVisible = IsAabbInFrustum(FrustumPlanes, boundsMin, boundsMax);
 
-        float3 ndc = clip.xyz / clip.w;
-        float2 uv;
-        uv.x = ndc.x * 0.5f + 0.5f;
-        uv.y = 1 - (ndc.y * 0.5f + 0.5f);
+    // One projection serves the coverage test and the HZB test; bounds crossing the near plane pass both.
+    float2 minUv = 0.0f;
+    float2 maxUv = 0.0f;
+    float maxDepth = 0.0f;
+    bool projected = frustumVisible && ProjectAabb(ViewProjection, boundsMin, boundsMax, minUv, maxUv, maxDepth);
+    bool tooSmall = projected && MinScreenCoverage > 0.0f && IsRectBelowScreenCoverage(minUv, maxUv, TargetSize, MinScreenCoverage);
+    // Coverage does not depend on depth, so like the frustum test it applies to every phase.
+    bool inView = frustumVisible && !tooSmall;
 
-        minUv = min(minUv, uv);
-        maxUv = max(maxUv, uv);
-        maxDepth = max(maxDepth, ndc.z);
+    bool visible = inView;
+    bool occluded = false;
+    if (CullingPhase == kCullingPhaseFirst)
+    {
+        visible = inView && InstanceVisibility[index] != 0;
     }
-
-    if (anyBehind)
+    else if (visible && projected && HZBEnabled != 0)
     {
-        return false;
+        occluded = IsRectOccludedByHZB(HZBTexture, uint2(HZBWidth, HZBHeight), HZBMipCount, minUv, maxUv, maxDepth);
+        visible = !occluded;
     }
 
-    if (maxUv.x < 0.0f || maxUv.y < 0.0f || minUv.x > 1.0f || minUv.y > 1.0f)
+    bool draw = visible;
+    uint commandSet = 0;
+    if (CullingPhase == kCullingPhaseSecond)
     {
-        return false;
+        // Models the first phase drew are re-tested too, so one hidden by this frame's depth
+        // leaves the first phase next frame.
+        bool drawnInFirstPhase = inView && InstanceVisibility[index] != 0;
+        InstanceVisibility[index] = visible ? 1u : 0u;
+        draw = visible && !drawnInFirstPhase;
+        commandSet = CommandCount;
     }
 
-    minUv = saturate(minUv);
-    maxUv = saturate(maxUv);
-
-    float2 extent = maxUv - minUv;
-    float2 pixelSize = extent * float2(HZBWidth, HZBHeight);
-    float maxDim = max(pixelSize.x, pixelSize.y);
-    uint mipLevel = 0;
-    if (maxDim > 1.0f)
+    if (draw)
     {
-        mipLevel = (uint)clamp(floor(log2(maxDim)), 0.0f, (float)(HZBMipCount - 1));
+        uint lod = SelectLod(data);
+        uint commandOffset = (commandSet + data.CommandStart + lod) * kCommandStride;
+        uint slot;
+        IndirectArgs.InterlockedAdd(commandOffset + kInstanceCountOffset, 1u, slot);
+        VisibleInstances[IndirectArgs.Load(commandOffset + kInstanceBaseOffset) + slot] = index;
+
+        // Triangles submitted, by every phase that draws.
+        if (DebugPrintEnabled != 0)
+        {
+            DebugPrintStats.InterlockedAdd(20, data.Lods[lod].IndexCount / 3);
+        }
     }
 
-    uint mipWidth = max(1u, HZBWidth >> mipLevel);
-    uint mipHeight = max(1u, HZBHeight >> mipLevel);
-
-    uint2 minCoord = uint2(minUv * float2(mipWidth, mipHeight));
-    uint2 maxCoord = uint2(maxUv * float2(mipWidth, mipHeight));
-    minCoord = min(minCoord, uint2(mipWidth - 1, mipHeight - 1));
-    maxCoord = min(maxCoord, uint2(mipWidth - 1, mipHeight - 1));
-
-    float hzbDepth = 1.0f;
-    hzbDepth = min(hzbDepth, HZBTexture.Load(int3(minCoord, mipLevel)));
-    hzbDepth = min(hzbDepth, HZBTexture.Load(int3(maxCoord.x, minCoord.y, mipLevel)));
-    hzbDepth = min(hzbDepth, HZBTexture.Load(int3(minCoord.x, maxCoord.y, mipLevel)));
-    hzbDepth = min(hzbDepth, HZBTexture.Load(int3(maxCoord, mipLevel)));
-
-    return maxDepth < hzbDepth;
+    // The first phase culls by history alone; the second phase counts every model once.
+    if (DebugPrintEnabled != 0 && !visible && CullingPhase != kCullingPhaseFirst)
+    {
+        if (!frustumVisible)
+        {
+            DebugPrintStats.InterlockedAdd(0, 1);
+        }
+        else if (tooSmall)
+        {
+            DebugPrintStats.InterlockedAdd(12, 1);
+        }
+        else if (occluded)
+        {
+            DebugPrintStats.InterlockedAdd(4, 1);
+        }
+    }
 }
 
+// One thread per command of the phase's command set, after CSMain. Commands that received
+// instances are packed at the start of their range in CompactedArgs, so ExecuteIndirect with the
+// range's count skips the empty ones instead of walking every command the range reserves.
 [numthreads(64, 1, 1)]
-void CSMain(uint3 dispatchThreadId : SV_DispatchThreadID)
+void CSCompactCommands(uint3 dispatchThreadId : SV_DispatchThreadID)
 {
-    uint index = dispatchThreadId.x;
-    if (index >= ModelCount)
+    if (dispatchThreadId.x >= CommandCount)
     {
         return;
     }
 
-    uint boundsIndex = index * 2;
-    float3 boundsMin = ModelBounds[boundsIndex].xyz;
-    float3 boundsMax = ModelBounds[boundsIndex + 1].xyz;
-    bool frustumVisible = IsAabbVisible(boundsMin, boundsMax);
-    bool visible = frustumVisible;
-    bool occluded = false;
-    if (visible && HZBEnabled != 0)
+    uint command = dispatchThreadId.x + (CullingPhase == kCullingPhaseSecond ? CommandCount : 0);
+    uint commandOffset = command * kCommandStride;
+    uint4 args0 = IndirectArgs.Load4(commandOffset);
+    uint2 args1 = IndirectArgs.Load2(commandOffset + 16);
+    // Instance count, the third word.
+    if (args0.z == 0)
     {
-        occluded = IsOccluded(boundsMin, boundsMax);
-        visible = !occluded;
+        return;
     }
 
-    uint baseOffset = index * kCommandStride + kInstanceCountOffset;
-    IndirectArgs.Store(baseOffset, visible ? 1u : 0u);
+    CommandRange range = CommandRanges[command];
+    uint slot;
+    CompactedArgs.InterlockedAdd(CompactedCountOffset + range.CounterIndex * 4, 1u, slot);
+
+    uint outputOffset = (range.OutputStart + slot) * kCommandStride;
+    CompactedArgs.Store4(outputOffset, args0);
+    CompactedArgs.Store2(outputOffset + 16, args1);
 
-    if (DebugPrintEnabled != 0 && !visible)
+    if (DebugPrintEnabled != 0)
     {
-        if (!frustumVisible)
-        {
-            DebugPrintStats.InterlockedAdd(0, 1);
-        }
-        else if (occluded)
-        {
-            DebugPrintStats.InterlockedAdd(4, 1);
-        }
+        DebugPrintStats.InterlockedAdd(8, 1);
     }
 }
@@ -0,0 +1,122 @@
+// Frustum, screen coverage and HZB occlusion tests shared by the GPU culling passes. Bounds and planes are in world
+// space; the HZB holds the farthest reverse-Z depth of each texel footprint.
+
+bool IsAabbInFrustum(float4 frustumPlanes[6], float3 boundsMin, float3 boundsMax)
+{
+    [unroll]
+    for (uint i = 0; i < 6; ++i)
+    {
+        float4 plane = frustumPlanes[i];
+        float3 positiveVertex = float3(
+            plane.x >= 0.0f ? boundsMax.x : boundsMin.x,
+            plane.y >= 0.0f ? boundsMax.y : boundsMin.y,
+            plane.z >= 0.0f ? boundsMax.z : boundsMin.z);
+
+        if (dot(plane.xyz, positiveVertex) + plane.w < 0.0f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Rectangle of the AABB's corners in [0, 1] view UV, unclamped, and their nearest reverse-Z depth.
+// Returns false when a corner is behind the camera, where the rectangle is unbounded.
+bool ProjectAabb(float4x4 viewProjection, float3 boundsMin, float3 boundsMax, out float2 minUv, out float2 maxUv, out float maxDepth)
+{
+    float3 corners[8] =
+    {
+        float3(boundsMin.x, boundsMin.y, boundsMin.z),
+        float3(boundsMax.x, boundsMin.y, boundsMin.z),
+        float3(boundsMin.x, boundsMax.y, boundsMin.z),
+        float3(boundsMax.x, boundsMax.y, boundsMin.z),
+        float3(boundsMin.x, boundsMin.y, boundsMax.z),
+        float3(boundsMax.x, boundsMin.y, boundsMax.z),
+        float3(boundsMin.x, boundsMax.y, boundsMax.z),
+        float3(boundsMax.x, boundsMax.y, boundsMax.z)
+    };
+
+    minUv = float2(1.0f, 1.0f);
+    maxUv = float2(0.0f, 0.0f);
+    maxDepth = 0.0f;
+
+    [unroll]
+    for (uint i = 0; i < 8; ++i)
+    {
+        float4 clip = mul(float4(corners[i], 1.0f), viewProjection);
+        if (clip.w <= 0.0f)
+        {
+            return false;
+        }
+
+        float3 ndc = clip.xyz / clip.w;
+        float2 uv;
+        uv.x = ndc.x * 0.5f + 0.5f;
+        uv.y = 1 - (ndc.y * 0.5f + 0.5f);
+
+        minUv = min(minUv, uv);
+        maxUv = max(maxUv, uv);
+        maxDepth = max(maxDepth, ndc.z);
+    }
+    return true;
+}
+
+// True when the larger side of a projected rectangle covers fewer than minPixels of a target of targetSize.
+bool IsRectBelowScreenCoverage(float2 minUv, float2 maxUv, float2 targetSize, float minPixels)
+{
+    float2 pixelSize = (maxUv - minUv) * targetSize;
+    return max(pixelSize.x, pixelSize.y) < minPixels;
+}
+
+bool IsRectOccludedByHZB(Texture2D<float> hzbTexture, uint2 hzbSize, uint hzbMipCount, float2 minUv, float2 maxUv, float maxDepth)
+{
+    if (hzbSize.x == 0 || hzbSize.y == 0 || hzbMipCount == 0)
+    {
+        return false;
+    }
+
+    if (maxUv.x < 0.0f || maxUv.y < 0.0f || minUv.x > 1.0f || minUv.y > 1.0f)
+    {
+        return false;
+    }
+
+    minUv = saturate(minUv);
+    maxUv = saturate(maxUv);
+
+    float2 extent = maxUv - minUv;
+    float2 pixelSize = extent * float2(hzbSize);
+    float maxDim = max(pixelSize.x, pixelSize.y);
+    uint mipLevel = 0;
+    if (maxDim > 1.0f)
+    {
+        mipLevel = (uint)clamp(floor(log2(maxDim)), 0.0f, (float)(hzbMipCount - 1));
+    }
+
+    uint mipWidth = max(1u, hzbSize.x >> mipLevel);
+    uint mipHeight = max(1u, hzbSize.y >> mipLevel);
+
+    uint2 minCoord = uint2(minUv * float2(mipWidth, mipHeight));
+    uint2 maxCoord = uint2(maxUv * float2(mipWidth, mipHeight));
+    minCoord = min(minCoord, uint2(mipWidth - 1, mipHeight - 1));
+    maxCoord = min(maxCoord, uint2(mipWidth - 1, mipHeight - 1));
+
+    float hzbDepth = 1.0f;
+    hzbDepth = min(hzbDepth, hzbTexture.Load(int3(minCoord, mipLevel)));
+    hzbDepth = min(hzbDepth, hzbTexture.Load(int3(maxCoord.x, minCoord.y, mipLevel)));
+    hzbDepth = min(hzbDepth, hzbTexture.Load(int3(minCoord.x, maxCoord.y, mipLevel)));
+    hzbDepth = min(hzbDepth, hzbTexture.Load(int3(maxCoord, mipLevel)));
+
+    return maxDepth < hzbDepth;
+}
+
+bool IsAabbOccludedByHZB(Texture2D<float> hzbTexture, float4x4 viewProjection, uint2 hzbSize, uint hzbMipCount, float3 boundsMin, float3 boundsMax)
+{
+    float2 minUv;
+    float2 maxUv;
+    float maxDepth;
+    if (!ProjectAabb(viewProjection, boundsMin, boundsMax, minUv, maxUv, maxDepth))
+    {
+        return false;
+    }
+    return IsRectOccludedByHZB(hzbTexture, hzbSize, hzbMipCount, minUv, maxUv, maxDepth);
+}
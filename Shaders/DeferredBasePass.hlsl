@@ -1,13 +1,7 @@
 #include "SceneConstants.hlsl"
-
-struct VSInput
-{
-    float3 Position : POSITION;
-    float3 Normal   : NORMAL;
-    float2 UV       : TEXCOORD0;
-    float4 Tangent  : TANGENT;
-    float4 Color    : COLOR0;
-};
+#include "SceneInstances.hlsl"
+#include "MeshVertex.hlsl"
+#include "GBufferCommon.hlsl"
 
 struct VSOutput
 {
@@ -17,8 +11,21 @@ struct VSOutput
     float3 WorldPos : TEXCOORD1;
     float4 Tangent  : TEXCOORD2;
     float4 Color    : COLOR0;
+    // Unjittered clip positions of this and the previous frame, for the velocity target.
+    float4 CurrentClip : TEXCOORD3;
+    float4 PrevClip    : TEXCOORD4;
+    nointerpolation uint ObjectIndex : OBJECTINDEX;
 };
 
+#if BINDLESS_MATERIALS
+// Texture maps are selected per pixel from the material flags; only USE_ALPHA_MASK remains a
+// permutation. These and the texture macros below expect a SceneMaterial named Material in scope.
+#define USE_NORMAL_MAP ((Material.Flags & MATERIAL_FLAG_NORMAL_MAP) != 0)
+#define USE_METALLIC_ROUGHNESS_MAP ((Material.Flags & MATERIAL_FLAG_METALLIC_ROUGHNESS_MAP) != 0)
+#define USE_BASE_COLOR_MAP ((Material.Flags & MATERIAL_FLAG_BASE_COLOR_MAP) != 0)
+#define USE_EMISSIVE_MAP ((Material.Flags & MATERIAL_FLAG_EMISSIVE_MAP) != 0)
+#endif
+
 #ifndef USE_NORMAL_MAP
 #define USE_NORMAL_MAP 1
 #endif
@@ -36,12 +43,15 @@ struct VSOutput
 #endif
 
 
+#if BINDLESS_MATERIALS
+#define AlbedoTexture LoadMaterialTexture(Material, 0)
+#define MetallicRoughnessTexture LoadMaterialTexture(Material, 1)
+#define NormalTexture LoadMaterialTexture(Material, 2)
+#define EmissiveTexture LoadMaterialTexture(Material, 3)
+#else
 Texture2D AlbedoTexture : register(t0);
-#if USE_METALLIC_ROUGHNESS_MAP
 Texture2D MetallicRoughnessTexture : register(t1);
-#endif
 Texture2D NormalTexture : register(t2);
-#if USE_EMISSIVE_MAP
 Texture2D EmissiveTexture : register(t3);
 #endif
 SamplerState AlbedoSampler : register(s0);
@@ -55,96 +65,162 @@ float2 ApplyTextureTransform(float2 uv, float4 offsetScale, float4 rotation)
     return rotated + offsetScale.xy;
 }
 
-VSOutput VSMain(VSInput Input)
+VSOutput TransformMeshVertex(MeshVertexInput Input, uint ObjectIndex)
 {
+    SceneObject Object = SceneObjects[ObjectIndex];
+    float4x4 WorldMatrix = Object.World;
+
     VSOutput Output;
-    float4 WorldPos = mul(float4(Input.Position, 1.0), World);
+    float4 LocalPos = float4(DecodeMeshPosition(Input.Position, Object.PositionScale, Object.PositionOffset), 1.0);
+    float4 WorldPos = mul(LocalPos, WorldMatrix);
     float4 ViewPos = mul(WorldPos, View);
     Output.Position = mul(ViewPos, Projection);
-    Output.Normal = mul(Input.Normal, (float3x3)World);
+    Output.CurrentClip = mul(WorldPos, UnjitteredViewProjection);
+    Output.PrevClip = mul(mul(LocalPos, Object.PrevWorld), PrevUnjitteredViewProjection);
+    Output.Normal = mul(DecodeOctahedral(Input.Normal), (float3x3)WorldMatrix);
     Output.UV = Input.UV;
     Output.WorldPos = WorldPos.xyz;
-    Output.Tangent = float4(normalize(mul(Input.Tangent.xyz, (float3x3)World)), Input.Tangent.w);
+    float4 Tangent = DecodeMeshTangent(Input.Tangent);
+    Output.Tangent = float4(normalize(mul(Tangent.xyz, (float3x3)WorldMatrix)), Tangent.w);
     Output.Color = Input.Color;
+    Output.ObjectIndex = ObjectIndex;
     return Output;
 }
 
+VSOutput VSMain(MeshVertexInput Input, uint InstanceId : SV_InstanceID)
+{
+    return TransformMeshVertex(Input, LoadObjectIndex(InstanceId));
+}
+
+// Same position math as TransformMeshVertex, so the prepass depth matches the base pass exactly.
+float4 VSDepthOnly(MeshPositionInput Input, uint InstanceId : SV_InstanceID) : SV_Position
+{
+    SceneObject Object = SceneObjects[LoadObjectIndex(InstanceId)];
+    float4 WorldPos = mul(float4(DecodeMeshPosition(Input.Position, Object.PositionScale, Object.PositionOffset), 1.0), Object.World);
+    float4 ViewPos = mul(WorldPos, View);
+    return mul(ViewPos, Projection);
+}
+
+struct VSDepthMaskedOutput
+{
+    float4 Position : SV_Position;
+    float2 UV       : TEXCOORD0;
+    float  Alpha    : COLOR0;
+    nointerpolation uint ObjectIndex : OBJECTINDEX;
+};
+
+// Alpha-masked models in the depth prepass: the same position math again, plus what the cutoff test reads.
+VSDepthMaskedOutput VSDepthMasked(MeshVertexInput Input, uint InstanceId : SV_InstanceID)
+{
+    uint ObjectIndex = LoadObjectIndex(InstanceId);
+    SceneObject Object = SceneObjects[ObjectIndex];
+    float4 WorldPos = mul(float4(DecodeMeshPosition(Input.Position, Object.PositionScale, Object.PositionOffset), 1.0), Object.World);
+    float4 ViewPos = mul(WorldPos, View);
+
+    VSDepthMaskedOutput Output;
+    Output.Position = mul(ViewPos, Projection);
+    Output.UV = Input.UV;
+    Output.Alpha = Input.Color.a;
+    Output.ObjectIndex = ObjectIndex;
+    return Output;
+}
+
+// Discards below the cutoff exactly as PSMain does, so the base pass can test depth EQUAL without clipping.
+void PSDepthMasked(VSDepthMaskedOutput Input)
+{
+    SceneMaterial Material = LoadSceneMaterial(Input.ObjectIndex);
+
+    float alpha = Material.BaseColorAlpha * Input.Alpha;
+    if (USE_BASE_COLOR_MAP)
+    {
+        float2 baseUV = ApplyTextureTransform(Input.UV, Material.BaseColorTransformOffsetScale, Material.BaseColorTransformRotation);
+        alpha *= AlbedoTexture.Sample(AlbedoSampler, baseUV).a;
+    }
+    clip(alpha - Material.AlphaCutoff);
+}
+
 struct PSOutput
 {
-    float4 GBufferA : SV_Target0; // Normal
+    float2 GBufferA : SV_Target0; // Octahedral normal
     float4 GBufferB : SV_Target1; // Specular/Metallic/Roughness
     float4 GBufferC : SV_Target2; // BaseColor
     float4 SceneColor : SV_Target3; // Emissive
+    float2 Velocity : SV_Target4; // Screen UV offset to the previous frame
 };
 
-float3 ComputeViewNormal(VSOutput Input, float2 normalUV)
+float3 ComputeViewNormal(VSOutput Input, SceneMaterial Material, float2 normalUV)
 {
     float3 vertexNormal = normalize(Input.Normal);
 
-#if USE_NORMAL_MAP
-    float3 tangent = normalize(Input.Tangent.xyz - vertexNormal * dot(vertexNormal, Input.Tangent.xyz));
-    float3 bitangent = normalize(cross(vertexNormal, tangent)) * Input.Tangent.w;
+    if (USE_NORMAL_MAP)
+    {
+        float3 tangent = normalize(Input.Tangent.xyz - vertexNormal * dot(vertexNormal, Input.Tangent.xyz));
+        float3 bitangent = normalize(cross(vertexNormal, tangent)) * Input.Tangent.w;
 
-    float2 tangentNormalRG = NormalTexture.Sample(AlbedoSampler, normalUV).rg * 2.0f - 1.0f;
-    float tangentNormalZ = sqrt(saturate(1.0f - dot(tangentNormalRG, tangentNormalRG)));
-    float3 tangentNormal = float3(tangentNormalRG, tangentNormalZ);
-    const float tangentEpsilon = 1e-5f;
-    float tangentNormalLength = length(tangentNormal);
-    tangentNormal = tangentNormalLength < tangentEpsilon ? float3(0.0f, 0.0f, 1.0f) : tangentNormal;
+        float2 tangentNormalRG = NormalTexture.Sample(AlbedoSampler, normalUV).rg * 2.0f - 1.0f;
+        float tangentNormalZ = sqrt(saturate(1.0f - dot(tangentNormalRG, tangentNormalRG)));
+        float3 tangentNormal = float3(tangentNormalRG, tangentNormalZ);
+        const float tangentEpsilon = 1e-5f;
+        float tangentNormalLength = length(tangentNormal);
+        tangentNormal = tangentNormalLength < tangentEpsilon ? float3(0.0f, 0.0f, 1.0f) : tangentNormal;
 
-    float3x3 TBN = float3x3(tangent, bitangent, vertexNormal);
-    float3 worldNormal = mul(tangentNormal, TBN);
+        float3x3 TBN = float3x3(tangent, bitangent, vertexNormal);
+        float3 worldNormal = mul(tangentNormal, TBN);
+
+        return normalize(mul(normalize(worldNormal), (float3x3)View));
+    }
 
-    return normalize(mul(normalize(worldNormal), (float3x3)View));
-#else
     return normalize(mul(vertexNormal, (float3x3)View));
-#endif
 }
 
 PSOutput PSMain(VSOutput Input)
 {
     PSOutput Output;
+    SceneMaterial Material = LoadSceneMaterial(Input.ObjectIndex);
 
-    float2 baseUV = ApplyTextureTransform(Input.UV, BaseColorTransformOffsetScale, BaseColorTransformRotation);
-    float2 mrUV = ApplyTextureTransform(Input.UV, MetallicRoughnessTransformOffsetScale, MetallicRoughnessTransformRotation);
-    float2 normalUV = ApplyTextureTransform(Input.UV, NormalTransformOffsetScale, NormalTransformRotation);
-    float2 emissiveUV = ApplyTextureTransform(Input.UV, EmissiveTransformOffsetScale, EmissiveTransformRotation);
+    float2 baseUV = ApplyTextureTransform(Input.UV, Material.BaseColorTransformOffsetScale, Material.BaseColorTransformRotation);
+    float2 mrUV = ApplyTextureTransform(Input.UV, Material.MetallicRoughnessTransformOffsetScale, Material.MetallicRoughnessTransformRotation);
+    float2 normalUV = ApplyTextureTransform(Input.UV, Material.NormalTransformOffsetScale, Material.NormalTransformRotation);
+    float2 emissiveUV = ApplyTextureTransform(Input.UV, Material.EmissiveTransformOffsetScale, Material.EmissiveTransformRotation);
 
-    float3 viewNormal = ComputeViewNormal(Input, normalUV);
+    float3 viewNormal = ComputeViewNormal(Input, Material, normalUV);
 
-    float3 albedo = BaseColor * Input.Color.rgb;
-    float alpha = BaseColorAlpha * Input.Color.a;
-#if USE_BASE_COLOR_MAP
-    float4 albedoSample = AlbedoTexture.Sample(AlbedoSampler, baseUV);
-    albedo *= albedoSample.rgb;
-    alpha *= albedoSample.a;
-#endif
+    float3 albedo = Material.BaseColor * Input.Color.rgb;
+    float alpha = Material.BaseColorAlpha * Input.Color.a;
+    if (USE_BASE_COLOR_MAP)
+    {
+        float4 albedoSample = AlbedoTexture.Sample(AlbedoSampler, baseUV);
+        albedo *= albedoSample.rgb;
+        alpha *= albedoSample.a;
+    }
 #if USE_ALPHA_MASK
-    if (alpha < AlphaCutoff)
+    if (alpha < Material.AlphaCutoff)
     {
-        clip(alpha - AlphaCutoff);
+        clip(alpha - Material.AlphaCutoff);
     }
 #endif
 
-    float viewDepth = -mul(float4(Input.WorldPos, 1.0), View).z;
-    Output.GBufferA = float4(viewNormal, viewDepth);
+    Output.GBufferA = EncodeGBufferNormal(viewNormal);
 
     const float specular = 0.04f;
-    float metallic = MetallicFactor;
-    float roughness = RoughnessFactor;
-#if USE_METALLIC_ROUGHNESS_MAP
-    float2 metallicRoughness = MetallicRoughnessTexture.Sample(AlbedoSampler, mrUV).bg;
-    metallic *= metallicRoughness.x;
-    roughness *= metallicRoughness.y;
-#endif
+    float metallic = Material.MetallicFactor;
+    float roughness = Material.RoughnessFactor;
+    if (USE_METALLIC_ROUGHNESS_MAP)
+    {
+        float2 metallicRoughness = MetallicRoughnessTexture.Sample(AlbedoSampler, mrUV).bg;
+        metallic *= metallicRoughness.x;
+        roughness *= metallicRoughness.y;
+    }
     Output.GBufferB = float4(specular, metallic, roughness, 1.0);
 
     Output.GBufferC = float4(albedo, 1.0);
 
-    float3 emissive = EmissiveFactor;
-#if USE_EMISSIVE_MAP
-    emissive *= EmissiveTexture.Sample(AlbedoSampler, emissiveUV).rgb;
-#endif
+    float3 emissive = Material.EmissiveFactor;
+    if (USE_EMISSIVE_MAP)
+    {
+        emissive *= EmissiveTexture.Sample(AlbedoSampler, emissiveUV).rgb;
+    }
     Output.SceneColor = float4(emissive, 1.0);
+    Output.Velocity = ComputeVelocity(Input.CurrentClip, Input.PrevClip);
     return Output;
 }
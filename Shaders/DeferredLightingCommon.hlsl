@@ -0,0 +1,131 @@
+// Lighting of one G-buffer pixel, shared by the fullscreen pass in Shaders/DeferredLighting.hlsl
+// and the tile kernels of Shaders/TiledDeferredLighting.hlsl, which bind the same registers.
+
+#include "PBRCommon.hlsl"
+#include "SceneConstants.hlsl"
+#include "ShadowCommon.hlsl"
+#include "ClusteredLightingCommon.hlsl"
+#include "GBufferCommon.hlsl"
+#include "SphericalHarmonics.hlsl"
+#include "SkyAtmosphereCommon.hlsl"
+
+Texture2D GBufferA : register(t0);
+Texture2D GBufferB : register(t1);
+Texture2D GBufferC : register(t2);
+Texture2DArray ShadowMap : register(t3);
+TextureCube EnvironmentMap : register(t4);
+Texture2D BrdfLut : register(t5);
+SamplerComparisonState ShadowSampler : register(s1);
+SamplerState IblSampler : register(s2);
+StructuredBuffer<PunctualLight> PunctualLights : register(t6);
+StructuredBuffer<uint> ClusterLightGrid : register(t7);
+Texture2D<float> SceneDepth : register(t8);
+Texture2D<float4> SkyTransmittanceLut : register(t10);
+
+// Metal-free pixels at least this rough light as simple materials in the tiled path.
+#define SIMPLE_MATERIAL_MIN_ROUGHNESS 0.9f
+
+// Reverse-Z infinite projection: depth is near / view depth, and only sky keeps the zero clear.
+bool IsGeometryPixel(float depth)
+{
+    return depth > 0.0f;
+}
+
+float GetViewDepth(float depth)
+{
+    return Projection._43 / depth;
+}
+
+bool IsSimpleMaterial(float metallic, float roughness)
+{
+    return metallic <= 0.0f && roughness >= SIMPLE_MATERIAL_MIN_ROUGHNESS;
+}
+
+// Whether the directional light's shadow can change the pixel: with shadows on, facing the light
+// and within the last cascade. SampleCascadedShadow returns 1 everywhere else.
+bool NeedsShadowLookup(float3 normal, float viewDepth)
+{
+    float3 L = mul(float4(LightDirection, 0.0f), View).xyz;
+    return ShadowStrength > 0.0f
+        && viewDepth <= ShadowCascadeSplits[SHADOW_CASCADE_COUNT - 1]
+        && dot(normal, L) > 0.0f;
+}
+
+// Analytic fit of the split-sum BRDF LUT (Karis, "Physically Based Shading on Mobile").
+float2 EnvBrdfApprox(float NdotV, float roughness)
+{
+    const float4 c0 = float4(-1.0f, -0.0275f, -0.572f, 0.022f);
+    const float4 c1 = float4(1.0f, 0.0425f, 1.04f, -0.04f);
+    float4 r = roughness * c0 + c1;
+    float a004 = min(r.x * r.x, exp2(-9.28f * NdotV)) * r.x + r.y;
+    return float2(-1.04f, 1.04f) * a004 + r.zw;
+}
+
+// Direct, punctual and image-based lighting of a geometry pixel, added to its emissive color.
+// Without bSampleShadow the pixel must not need a shadow lookup. Diffuse irradiance comes from
+// the environment's spherical harmonics; bSimpleMaterial lights rough dielectrics with it and the
+// analytic BRDF fit alone, without the environment fetch and the LUT.
+float3 EvaluateDeferredLighting(uint2 pixel, float depth, bool bSampleShadow, bool bSimpleMaterial)
+{
+    float3 normal = DecodeGBufferNormal(GBufferA.Load(int3(pixel, 0)).xy);
+    float4 smr = GBufferB.Load(int3(pixel, 0));
+    float3 albedo = GBufferC.Load(int3(pixel, 0)).rgb;
+
+    float roughness = smr.z;
+    float metallic = smr.y;
+    float3 F0 = lerp(smr.x.xxx, albedo, metallic);
+
+    float2 uv = (float2(pixel) + 0.5f) * ClusterInvViewportSize;
+    float2 ndc = uv * 2.0f - 1.0f;
+    float viewZ = GetViewDepth(depth);
+    float viewX = ndc.x * viewZ / Projection._11;
+    float viewY = -ndc.y * viewZ / Projection._22;
+    float3 viewPos = float3(viewX, viewY, viewZ);
+
+    float3 V = normalize(-viewPos);
+    float3 L = normalize(mul(float4(LightDirection, 0.0f), View).xyz);
+
+    float3 worldPos = mul(float4(viewPos, 1.0f), ViewInverse).xyz;
+    float shadow = bSampleShadow ? SampleCascadedShadow(ShadowMap, ShadowSampler, worldPos, viewPos.z) : 1.0f;
+
+    // The sun reaches the pixel through the same air the sky is drawn with, so it reddens and
+    // dims towards the horizon.
+    float3 sunTransmittance = SampleSkyTransmittance(SkyTransmittanceLut, IblSampler, GetAtmosphereRadius(worldPos), normalize(LightDirection).y);
+    float3 lighting = EvaluatePBR(albedo, metallic, roughness, F0, normal, V, L) * LightIntensity * LightColor * sunTransmittance * shadow;
+
+    float3 worldNormal = normalize(mul(normal, (float3x3)ViewInverse));
+    float3 worldView = normalize(CameraPosition - worldPos);
+
+    // Only the lights binned into this pixel's cluster, so cost follows local light density.
+    if (PunctualLightCount > 0)
+    {
+        uint clusterIndex = GetClusterIndex(float2(pixel) + 0.5f, viewPos.z);
+        uint clusterLightCount = ClusterLightGrid[clusterIndex];
+        uint listStart = GetClusterCount() + clusterIndex * CLUSTER_MAX_LIGHTS;
+        for (uint i = 0; i < clusterLightCount; ++i)
+        {
+            PunctualLight light = PunctualLights[ClusterLightGrid[listStart + i]];
+            lighting += EvaluatePunctualLight(light, worldPos, albedo, metallic, roughness, F0, worldNormal, worldView);
+        }
+    }
+
+    float NdotV = saturate(dot(worldNormal, worldView));
+    float3 irradiance = EvaluateIrradianceSH(IrradianceSH, worldNormal);
+    float3 diffuseIbl = irradiance * albedo * (1.0f - metallic);
+
+    // At this roughness the prefiltered reflection is close to the irradiance around the normal.
+    if (bSimpleMaterial)
+    {
+        float2 envBrdf = EnvBrdfApprox(NdotV, roughness);
+        return lighting + diffuseIbl + irradiance * (F0 * envBrdf.x + envBrdf.y);
+    }
+
+    float3 reflection = reflect(-worldView, worldNormal);
+    float mipLevel = roughness * max(0.0f, EnvMapMipCount - 1.0f);
+    float3 prefilteredColor = EnvironmentMap.SampleLevel(IblSampler, reflection, mipLevel).rgb;
+
+    float2 brdf = BrdfLut.SampleLevel(IblSampler, float2(NdotV, roughness), 0.0f).rg;
+    float3 specularIbl = prefilteredColor * (F0 * brdf.x + brdf.y);
+
+    return lighting + diffuseIbl + specularIbl;
+}
@@ -0,0 +1,181 @@
+// Image-based lighting derived from the environment cube; see FEnvironmentLighting in
+// Source/Render/EnvironmentLighting.h. ProjectIrradianceSH runs one group that integrates a
+// source mip of at most 64 texels a side into L2 spherical harmonics. PrefilterSpecular writes
+// one mip of the specular cube, GGX importance sampled at that mip's roughness.
+
+#include "PBRCommon.hlsl"
+#include "SphericalHarmonics.hlsl"
+
+cbuffer EnvironmentLightingConstants : register(b0)
+{
+    // Texels per face side: integrated by ProjectIrradianceSH, written by PrefilterSpecular.
+    uint FaceSize;
+    // Source mip ProjectIrradianceSH integrates, or PrefilterSpecular copies into the sharpest mip.
+    float SourceMip;
+    // Roughness of the mip PrefilterSpecular writes.
+    float Roughness;
+    uint SampleCount;
+    // Face size and mip count of the whole source cube.
+    float SourceFaceSize;
+    float SourceMipCount;
+    float2 PaddingEnvironment;
+};
+
+TextureCube<float4> SourceCube : register(t0);
+SamplerState LinearSampler : register(s0);
+RWStructuredBuffer<float4> IrradianceSH : register(u0);
+RWTexture2DArray<float4> PrefilteredCube : register(u0);
+
+#define SH_GROUP_SIZE 256
+
+groupshared float4 SharedSum[SH_GROUP_SIZE];
+
+// Direction through the center of a texel of a D3D cube face.
+float3 GetCubeTexelDirection(uint face, uint2 texel, uint faceSize)
+{
+    float2 uv = (float2(texel) + 0.5f) / float(faceSize) * 2.0f - 1.0f;
+    float3 direction;
+    switch (face)
+    {
+    case 0: direction = float3(1.0f, -uv.y, -uv.x); break;
+    case 1: direction = float3(-1.0f, -uv.y, uv.x); break;
+    case 2: direction = float3(uv.x, 1.0f, uv.y); break;
+    case 3: direction = float3(uv.x, -1.0f, -uv.y); break;
+    case 4: direction = float3(uv.x, -uv.y, 1.0f); break;
+    default: direction = float3(-uv.x, -uv.y, -1.0f); break;
+    }
+    return normalize(direction);
+}
+
+// Sums value over the group into SharedSum[0]; every thread must call it.
+float4 GroupSum(uint groupIndex, float4 value)
+{
+    SharedSum[groupIndex] = value;
+    GroupMemoryBarrierWithGroupSync();
+
+    [unroll]
+    for (uint stride = SH_GROUP_SIZE / 2; stride > 0; stride >>= 1)
+    {
+        if (groupIndex < stride)
+        {
+            SharedSum[groupIndex] += SharedSum[groupIndex + stride];
+        }
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    float4 sum = SharedSum[0];
+    GroupMemoryBarrierWithGroupSync();
+    return sum;
+}
+
+[numthreads(SH_GROUP_SIZE, 1, 1)]
+void ProjectIrradianceSH(uint groupIndex : SV_GroupIndex)
+{
+    float3 coefficients[SH_COEFFICIENT_COUNT];
+    [unroll]
+    for (uint i = 0; i < SH_COEFFICIENT_COUNT; ++i)
+    {
+        coefficients[i] = 0.0f;
+    }
+
+    const uint texelsPerFace = FaceSize * FaceSize;
+    float weightSum = 0.0f;
+    for (uint texelIndex = groupIndex; texelIndex < texelsPerFace * 6; texelIndex += SH_GROUP_SIZE)
+    {
+        uint face = texelIndex / texelsPerFace;
+        uint faceTexel = texelIndex - face * texelsPerFace;
+        uint2 texel = uint2(faceTexel % FaceSize, faceTexel / FaceSize);
+
+        // Solid angle of the texel, which shrinks towards the face corners.
+        float2 uv = (float2(texel) + 0.5f) / float(FaceSize) * 2.0f - 1.0f;
+        float distanceSq = 1.0f + dot(uv, uv);
+        float weight = 4.0f / (float(texelsPerFace) * distanceSq * sqrt(distanceSq));
+
+        float3 direction = GetCubeTexelDirection(face, texel, FaceSize);
+        float3 radiance = SourceCube.SampleLevel(LinearSampler, direction, SourceMip).rgb * weight;
+
+        float basis[SH_COEFFICIENT_COUNT];
+        EvaluateSHBasis(direction, basis);
+        [unroll]
+        for (uint i = 0; i < SH_COEFFICIENT_COUNT; ++i)
+        {
+            coefficients[i] += radiance * basis[i];
+        }
+        weightSum += weight;
+    }
+
+    // The texel areas are approximate; normalizing them to the full sphere keeps the result unbiased.
+    float normalization = 4.0f * PI / max(GroupSum(groupIndex, float4(weightSum, 0.0f, 0.0f, 0.0f)).x, 1e-6f);
+
+    // Convolution with the clamped cosine lobe over PI: 1 for band 0, 2/3 for band 1, 1/4 for band 2.
+    static const float bandScale[SH_COEFFICIENT_COUNT] = { 1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+    [unroll]
+    for (uint i = 0; i < SH_COEFFICIENT_COUNT; ++i)
+    {
+        float3 sum = GroupSum(groupIndex, float4(coefficients[i], 0.0f)).rgb;
+        if (groupIndex == 0)
+        {
+            IrradianceSH[i] = float4(sum * normalization * bandScale[i], 0.0f);
+        }
+    }
+}
+
+float2 Hammersley(uint index, uint count)
+{
+    return float2(float(index) / float(count), float(reversebits(index)) * 2.3283064365386963e-10f);
+}
+
+// Split-sum prefilter with N = V = R: the GGX lobe of the mip's roughness around each texel's
+// direction, with each sample read from the source mip whose texels cover the sample's share of
+// the lobe, so few samples do not alias bright spots.
+[numthreads(8, 8, 1)]
+void PrefilterSpecular(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+    if (any(dispatchThreadId.xy >= FaceSize))
+    {
+        return;
+    }
+
+    float3 N = GetCubeTexelDirection(dispatchThreadId.z, dispatchThreadId.xy, FaceSize);
+    if (Roughness <= 0.0f)
+    {
+        PrefilteredCube[dispatchThreadId] = float4(SourceCube.SampleLevel(LinearSampler, N, SourceMip).rgb, 1.0f);
+        return;
+    }
+
+    float3 up = abs(N.z) < 0.999f ? float3(0.0f, 0.0f, 1.0f) : float3(1.0f, 0.0f, 0.0f);
+    float3 tangentX = normalize(cross(up, N));
+    float3 tangentY = cross(N, tangentX);
+
+    float alpha = Roughness * Roughness;
+    float texelSolidAngle = 4.0f * PI / (6.0f * SourceFaceSize * SourceFaceSize);
+    float maxLod = max(SourceMipCount - 1.0f, 0.0f);
+
+    float3 color = 0.0f;
+    float weight = 0.0f;
+    for (uint i = 0; i < SampleCount; ++i)
+    {
+        float2 xi = Hammersley(i, SampleCount);
+        float phi = 2.0f * PI * xi.x;
+        float cosTheta = sqrt((1.0f - xi.y) / (1.0f + (alpha * alpha - 1.0f) * xi.y));
+        float sinTheta = sqrt(1.0f - cosTheta * cosTheta);
+        float3 H = tangentX * (sinTheta * cos(phi)) + tangentY * (sinTheta * sin(phi)) + N * cosTheta;
+        float3 L = 2.0f * dot(N, H) * H - N;
+
+        float NdotL = dot(N, L);
+        if (NdotL <= 0.0f)
+        {
+            continue;
+        }
+
+        // With N = V the sample pdf D * NdotH / (4 * VdotH) reduces to D / 4.
+        float pdf = DistributionGGX(cosTheta, alpha) * 0.25f;
+        float sampleSolidAngle = 1.0f / (float(SampleCount) * pdf + 1e-4f);
+        float lod = clamp(0.5f * log2(sampleSolidAngle / texelSolidAngle) + 1.0f, 0.0f, maxLod);
+
+        color += SourceCube.SampleLevel(LinearSampler, L, lod).rgb * NdotL;
+        weight += NdotL;
+    }
+
+    PrefilteredCube[dispatchThreadId] = float4(color / max(weight, 1e-4f), 1.0f);
+}
@@ -1,5 +1,7 @@
 #include "PBRCommon.hlsl"
 #include "SceneConstants.hlsl"
+#include "ShadowCommon.hlsl"
+#include "SphericalHarmonics.hlsl"
 
 struct VSOutput
 {
@@ -9,8 +11,18 @@ struct VSOutput
     float3 WorldPos : TEXCOORD1;
     float4 Tangent  : TEXCOORD2;
     float4 Color    : COLOR0;
+    nointerpolation uint ObjectIndex : OBJECTINDEX;
 };
 
+#if BINDLESS_MATERIALS
+// Texture maps are selected per pixel from the material flags; only USE_ALPHA_MASK remains a
+// permutation. These and the texture macros below expect a SceneMaterial named Material in scope.
+#define USE_BASE_COLOR_MAP ((Material.Flags & MATERIAL_FLAG_BASE_COLOR_MAP) != 0)
+#define USE_METALLIC_ROUGHNESS_MAP ((Material.Flags & MATERIAL_FLAG_METALLIC_ROUGHNESS_MAP) != 0)
+#define USE_EMISSIVE_MAP ((Material.Flags & MATERIAL_FLAG_EMISSIVE_MAP) != 0)
+#define USE_NORMAL_MAP ((Material.Flags & MATERIAL_FLAG_NORMAL_MAP) != 0)
+#endif
+
 #ifndef USE_BASE_COLOR_MAP
 #define USE_BASE_COLOR_MAP 1
 #endif
@@ -28,13 +40,23 @@ struct VSOutput
 #endif
 
 
+#if BINDLESS_MATERIALS
+#define AlbedoTexture LoadMaterialTexture(Material, 0)
+#define MetallicRoughnessTexture LoadMaterialTexture(Material, 1)
+#define NormalTexture LoadMaterialTexture(Material, 2)
+#define EmissiveTexture LoadMaterialTexture(Material, 3)
+#define ShadowMap LoadMaterialTextureArray(Material, 4)
+#define EnvironmentMap LoadMaterialTextureCube(Material, 5)
+#define BrdfLut LoadMaterialTexture(Material, 6)
+#else
 Texture2D AlbedoTexture : register(t0);
 Texture2D MetallicRoughnessTexture : register(t1);
 Texture2D NormalTexture : register(t2);
 Texture2D EmissiveTexture : register(t3);
-Texture2D ShadowMap : register(t4);
+Texture2DArray ShadowMap : register(t4);
 TextureCube EnvironmentMap : register(t5);
 Texture2D BrdfLut : register(t6);
+#endif
 SamplerState AlbedoSampler : register(s0);
 SamplerComparisonState ShadowSampler : register(s1);
 SamplerState IblSampler : register(s2);
@@ -48,80 +70,75 @@ float2 ApplyTextureTransform(float2 uv, float4 offsetScale, float4 rotation)
     return rotated + offsetScale.xy;
 }
 
-float3 ComputeWorldNormal(VSOutput Input, float2 normalUV)
+float3 ComputeWorldNormal(VSOutput Input, SceneMaterial Material, float2 normalUV)
 {
     float3 vertexNormal = normalize(Input.Normal);
 
-#if USE_NORMAL_MAP
-    float3 tangent = normalize(Input.Tangent.xyz - vertexNormal * dot(vertexNormal, Input.Tangent.xyz));
-    float3 bitangent = normalize(cross(vertexNormal, tangent)) * Input.Tangent.w;
+    if (USE_NORMAL_MAP)
+    {
+        float3 tangent = normalize(Input.Tangent.xyz - vertexNormal * dot(vertexNormal, Input.Tangent.xyz));
+        float3 bitangent = normalize(cross(vertexNormal, tangent)) * Input.Tangent.w;
 
-    float3 tangentNormal = NormalTexture.Sample(AlbedoSampler, normalUV).rgb * 2.0f - 1.0f;
-    const float tangentEpsilon = 1e-5f;
-    float tangentNormalLength = length(tangentNormal);
-    tangentNormal = tangentNormalLength < tangentEpsilon ? float3(0.0f, 0.0f, 1.0f) : tangentNormal;
+        // Z is rebuilt from XY so two-channel BC5 normal maps read like RGB ones.
+        float2 tangentNormalRG = NormalTexture.Sample(AlbedoSampler, normalUV).rg * 2.0f - 1.0f;
+        float tangentNormalZ = sqrt(saturate(1.0f - dot(tangentNormalRG, tangentNormalRG)));
+        float3 tangentNormal = float3(tangentNormalRG, tangentNormalZ);
+        const float tangentEpsilon = 1e-5f;
+        float tangentNormalLength = length(tangentNormal);
+        tangentNormal = tangentNormalLength < tangentEpsilon ? float3(0.0f, 0.0f, 1.0f) : tangentNormal;
 
-    float3x3 TBN = float3x3(tangent, bitangent, vertexNormal);
-    float3 worldNormal = mul(tangentNormal, TBN);
+        float3x3 TBN = float3x3(tangent, bitangent, vertexNormal);
+        float3 worldNormal = mul(tangentNormal, TBN);
+
+        return normalize(worldNormal);
+    }
 
-    return normalize(worldNormal);
-#else
     return vertexNormal;
-#endif
 }
 
 float4 PSMain(VSOutput Input) : SV_Target
 {
-    float2 baseUV = ApplyTextureTransform(Input.UV, BaseColorTransformOffsetScale, BaseColorTransformRotation);
-    float2 normalUV = ApplyTextureTransform(Input.UV, NormalTransformOffsetScale, NormalTransformRotation);
-    float2 emissiveUV = ApplyTextureTransform(Input.UV, EmissiveTransformOffsetScale, EmissiveTransformRotation);
-
-    float3 albedo = BaseColor * Input.Color.rgb;
-    float alpha = BaseColorAlpha * Input.Color.a;
-#if USE_BASE_COLOR_MAP
-    float4 albedoSample = AlbedoTexture.Sample(AlbedoSampler, baseUV);
-    albedo *= albedoSample.rgb;
-    alpha *= albedoSample.a;
-#endif
+    SceneMaterial Material = LoadSceneMaterial(Input.ObjectIndex);
+
+    float2 baseUV = ApplyTextureTransform(Input.UV, Material.BaseColorTransformOffsetScale, Material.BaseColorTransformRotation);
+    float2 normalUV = ApplyTextureTransform(Input.UV, Material.NormalTransformOffsetScale, Material.NormalTransformRotation);
+    float2 emissiveUV = ApplyTextureTransform(Input.UV, Material.EmissiveTransformOffsetScale, Material.EmissiveTransformRotation);
+
+    float3 albedo = Material.BaseColor * Input.Color.rgb;
+    float alpha = Material.BaseColorAlpha * Input.Color.a;
+    if (USE_BASE_COLOR_MAP)
+    {
+        float4 albedoSample = AlbedoTexture.Sample(AlbedoSampler, baseUV);
+        albedo *= albedoSample.rgb;
+        alpha *= albedoSample.a;
+    }
 #if USE_ALPHA_MASK
-    if (alpha < AlphaCutoff)
+    if (alpha < Material.AlphaCutoff)
     {
-        clip(alpha - AlphaCutoff);
+        clip(alpha - Material.AlphaCutoff);
     }
 #endif
-    float3 emissive = EmissiveFactor;
-#if USE_EMISSIVE_MAP
-    emissive *= EmissiveTexture.Sample(AlbedoSampler, emissiveUV).rgb;
-#endif
-    float3 n = ComputeWorldNormal(Input, normalUV);
+    float3 emissive = Material.EmissiveFactor;
+    if (USE_EMISSIVE_MAP)
+    {
+        emissive *= EmissiveTexture.Sample(AlbedoSampler, emissiveUV).rgb;
+    }
+    float3 n = ComputeWorldNormal(Input, Material, normalUV);
     float3 v = normalize(CameraPosition - Input.WorldPos);
     float3 l = normalize(LightDirection);
 
-    float metallic = MetallicFactor;
-    float roughness = RoughnessFactor;
-#if USE_METALLIC_ROUGHNESS_MAP
-    float2 metallicRoughness = MetallicRoughnessTexture.Sample(AlbedoSampler, baseUV).bg;
-    metallic *= metallicRoughness.x;
-    roughness *= metallicRoughness.y;
-#endif
-    float3 F0 = lerp(0.04.xxx, albedo, metallic);
-
-    float4 shadowPosition = mul(float4(Input.WorldPos, 1.0f), LightViewProjection);
-    float3 shadowCoord = shadowPosition.xyz / shadowPosition.w;
-    float2 shadowUV = shadowCoord.xy * float2(0.5f, -0.5f) + 0.5f;
-    float shadowDepth = shadowCoord.z;
-    float shadow = 1.0f;
-    if (ShadowStrength > 0.0f && all(shadowUV >= 0.0f) && all(shadowUV <= 1.0f))
+    float metallic = Material.MetallicFactor;
+    float roughness = Material.RoughnessFactor;
+    if (USE_METALLIC_ROUGHNESS_MAP)
     {
-        float2 halfTexel = 0.5f / ShadowMapSize;
-        float shadowCompare = shadowDepth - ShadowBias;
-        shadow = 0.25f * (
-            ShadowMap.SampleCmpLevelZero(ShadowSampler, shadowUV + float2(halfTexel.x, halfTexel.y), shadowCompare) +
-            ShadowMap.SampleCmpLevelZero(ShadowSampler, shadowUV + float2(-halfTexel.x, halfTexel.y), shadowCompare) +
-            ShadowMap.SampleCmpLevelZero(ShadowSampler, shadowUV + float2(halfTexel.x, -halfTexel.y), shadowCompare) +
-            ShadowMap.SampleCmpLevelZero(ShadowSampler, shadowUV + float2(-halfTexel.x, -halfTexel.y), shadowCompare));
-        shadow = lerp(1.0f, shadow, ShadowStrength);
+        float2 metallicRoughness = MetallicRoughnessTexture.Sample(AlbedoSampler, baseUV).bg;
+        metallic *= metallicRoughness.x;
+        roughness *= metallicRoughness.y;
     }
+    float3 F0 = lerp(0.04.xxx, albedo, metallic);
+
+    float viewDepth = mul(float4(Input.WorldPos, 1.0f), View).z;
+    float shadow = SampleCascadedShadow(ShadowMap, ShadowSampler, Input.WorldPos, viewDepth);
 
     float3 lighting = EvaluatePBR(albedo, metallic, roughness, F0, n, v, l) * LightIntensity * LightColor * shadow;
 
@@ -134,7 +151,7 @@ float4 PSMain(VSOutput Input) : SV_Target
     float2 brdf = BrdfLut.Sample(IblSampler, float2(NdotV, roughness)).rg;
     float3 specularIbl = prefilteredColor * (F0 * brdf.x + brdf.y);
 
-    float3 irradiance = EnvironmentMap.SampleLevel(IblSampler, n, maxMip).rgb;
+    float3 irradiance = EvaluateIrradianceSH(IrradianceSH, n);
     float3 diffuseIbl = irradiance * albedo * (1.0f - metallic);
 
     float3 ambient = diffuseIbl + specularIbl;
@@ -1,13 +1,6 @@
 #include "SceneConstants.hlsl"
-
-struct VSInput
-{
-    float3 Position : POSITION;
-    float3 Normal   : NORMAL;
-    float2 UV       : TEXCOORD0;
-    float4 Tangent  : TANGENT;
-    float4 Color    : COLOR0;
-};
+#include "SceneInstances.hlsl"
+#include "MeshVertex.hlsl"
 
 struct VSOutput
 {
@@ -17,19 +10,35 @@ struct VSOutput
     float3 WorldPos : TEXCOORD1;
     float4 Tangent  : TEXCOORD2;
     float4 Color    : COLOR0;
+    nointerpolation uint ObjectIndex : OBJECTINDEX;
 };
 
 
-VSOutput VSMain(VSInput Input)
+VSOutput VSMain(MeshVertexInput Input, uint InstanceId : SV_InstanceID)
 {
+    uint ObjectIndex = LoadObjectIndex(InstanceId);
+    SceneObject Object = SceneObjects[ObjectIndex];
+    float4x4 WorldMatrix = Object.World;
+
     VSOutput Output;
-    float4 WorldPos = mul(float4(Input.Position, 1.0), World);
+    float4 WorldPos = mul(float4(DecodeMeshPosition(Input.Position, Object.PositionScale, Object.PositionOffset), 1.0), WorldMatrix);
     float4 ViewPos = mul(WorldPos, View);
     Output.Position = mul(ViewPos, Projection);
-    Output.Normal = mul(Input.Normal, (float3x3)World);
+    Output.Normal = mul(DecodeOctahedral(Input.Normal), (float3x3)WorldMatrix);
     Output.UV = Input.UV;
     Output.WorldPos = WorldPos.xyz;
-    Output.Tangent = float4(normalize(mul(Input.Tangent.xyz, (float3x3)World)), Input.Tangent.w);
+    float4 Tangent = DecodeMeshTangent(Input.Tangent);
+    Output.Tangent = float4(normalize(mul(Tangent.xyz, (float3x3)WorldMatrix)), Tangent.w);
     Output.Color = Input.Color;
+    Output.ObjectIndex = ObjectIndex;
     return Output;
 }
+
+// Same position math as VSMain, so the prepass depth matches the base pass exactly.
+float4 VSDepthOnly(MeshPositionInput Input, uint InstanceId : SV_InstanceID) : SV_Position
+{
+    SceneObject Object = SceneObjects[LoadObjectIndex(InstanceId)];
+    float4 WorldPos = mul(float4(DecodeMeshPosition(Input.Position, Object.PositionScale, Object.PositionOffset), 1.0), Object.World);
+    float4 ViewPos = mul(WorldPos, View);
+    return mul(ViewPos, Projection);
+}
@@ -0,0 +1,63 @@
+// Tonemap and CAS of the resolved TAA output in one dispatch, written straight to the back buffer.
+// Each group tonemaps its tile and a one-pixel ring around it into groupshared memory, and CAS
+// reads its neighbors from there instead of from an intermediate target.
+
+#include "TonemapCommon.hlsl"
+#include "CasCommon.hlsl"
+
+#define FUSED_POST_TILE_SIZE 8
+#define FUSED_POST_CACHE_SIZE (FUSED_POST_TILE_SIZE + 2)
+
+cbuffer FusedPostParams : register(b0)
+{
+    uint2 OutputSize;
+    uint EnableTonemap;
+    uint EnableAutoExposure;
+    float Exposure;
+    float Gamma;
+    float Sharpness;
+    float Padding;
+};
+
+Texture2D HDRScene : register(t0);
+Texture2D LogAverageLuminance : register(t1);
+RWTexture2D<float4> Output : register(u0);
+
+groupshared float3 TonemappedCache[FUSED_POST_CACHE_SIZE * FUSED_POST_CACHE_SIZE];
+
+[numthreads(FUSED_POST_TILE_SIZE, FUSED_POST_TILE_SIZE, 1)]
+void CSMain(uint3 GroupId : SV_GroupID, uint3 GroupThreadId : SV_GroupThreadID, uint GroupIndex : SV_GroupIndex)
+{
+    float finalExposure = Exposure;
+    if (EnableAutoExposure != 0)
+    {
+        float exposureEv = LogAverageLuminance.Load(int3(0, 0, 0)).r;
+        finalExposure *= exp2(exposureEv);
+    }
+
+    // Clamping the ring to the screen repeats the edge pixels, as the clamp sampler of Cas.hlsl does.
+    int2 cacheOrigin = int2(GroupId.xy * FUSED_POST_TILE_SIZE) - 1;
+    int2 maxPixel = int2(OutputSize) - 1;
+    for (uint i = GroupIndex; i < FUSED_POST_CACHE_SIZE * FUSED_POST_CACHE_SIZE; i += FUSED_POST_TILE_SIZE * FUSED_POST_TILE_SIZE)
+    {
+        int2 cachePixel = clamp(cacheOrigin + int2(i % FUSED_POST_CACHE_SIZE, i / FUSED_POST_CACHE_SIZE), int2(0, 0), maxPixel);
+        float3 hdrColor = HDRScene.Load(int3(cachePixel, 0)).rgb;
+        TonemappedCache[i] = TonemapColor(hdrColor, finalExposure, EnableTonemap != 0, Gamma);
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    uint2 pixel = GroupId.xy * FUSED_POST_TILE_SIZE + GroupThreadId.xy;
+    if (any(pixel >= OutputSize))
+    {
+        return;
+    }
+
+    uint center = (GroupThreadId.y + 1) * FUSED_POST_CACHE_SIZE + GroupThreadId.x + 1;
+    float3 C = TonemappedCache[center];
+    float3 N = TonemappedCache[center - FUSED_POST_CACHE_SIZE];
+    float3 W = TonemappedCache[center - 1];
+    float3 E = TonemappedCache[center + 1];
+    float3 S = TonemappedCache[center + FUSED_POST_CACHE_SIZE];
+
+    Output[pixel] = float4(ApplyCas(C, N, W, E, S, Sharpness), 1.0f);
+}
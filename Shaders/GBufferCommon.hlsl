@@ -0,0 +1,35 @@
+// Packing of the deferred G-buffer, GBufferFormats in Source/Render/DeferredRenderer.cpp:
+//   A  R16G16_SNORM         octahedral view-space normal
+//   B  R8G8B8A8_UNORM       specular, metallic, roughness, unused
+//   C  R8G8B8A8_UNORM_SRGB  base color
+// Depth is not stored; lighting reconstructs view depth and position from the depth buffer.
+// Next to them the base pass writes VelocityFormat, R16G16_FLOAT, the screen UV offset from each
+// pixel to where its surface was the previous frame; TemporalAA.hlsl reprojects history with it.
+
+float2 EncodeGBufferNormal(float3 normal)
+{
+    float3 n = normal / (abs(normal.x) + abs(normal.y) + abs(normal.z));
+    if (n.z < 0.0f)
+    {
+        float2 signs = float2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+        n.xy = (1.0f - abs(n.yx)) * signs;
+    }
+    return n.xy;
+}
+
+float3 DecodeGBufferNormal(float2 encoded)
+{
+    float3 n = float3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float fold = saturate(-n.z);
+    n.x += n.x >= 0.0f ? -fold : fold;
+    n.y += n.y >= 0.0f ? -fold : fold;
+    return normalize(n);
+}
+
+// Both positions are unjittered, so a surface at rest has no velocity whatever the TAA jitter.
+float2 ComputeVelocity(float4 currentClip, float4 prevClip)
+{
+    float2 currentNdc = currentClip.xy / currentClip.w;
+    float2 prevNdc = prevClip.xy / max(prevClip.w, 1e-5f);
+    return (prevNdc - currentNdc) * float2(0.5f, -0.5f);
+}
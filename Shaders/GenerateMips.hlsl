@@ -0,0 +1,102 @@
+// One mip level of an RGBA8 texture from the level above it, as an exact box filter: each
+// destination texel averages the source area it covers, so odd sizes weight the third texel by
+// its overlap instead of dropping it.
+//  MIP_FILTER 0: linear data (masks, metallic-roughness)
+//  MIP_FILTER 1: sRGB-encoded color, averaged in linear space; alpha stays linear
+//  MIP_FILTER 2: tangent-space normals, averaged and renormalized
+#ifndef MIP_FILTER
+#define MIP_FILTER 0
+#endif
+
+cbuffer MipConstants : register(b0)
+{
+    uint2 SourceSize;
+    uint2 DestSize;
+};
+
+Texture2D<float4> SourceMip : register(t0);
+RWTexture2D<unorm float4> DestMip : register(u0);
+
+float3 SrgbToLinear(float3 Color)
+{
+    return Color <= 0.04045f ? Color / 12.92f : pow((Color + 0.055f) / 1.055f, 2.4f);
+}
+
+float3 LinearToSrgb(float3 Color)
+{
+    return Color <= 0.0031308f ? Color * 12.92f : 1.055f * pow(Color, 1.0f / 2.4f) - 0.055f;
+}
+
+float4 DecodeTexel(float4 Texel)
+{
+#if MIP_FILTER == 1
+    return float4(SrgbToLinear(Texel.rgb), Texel.a);
+#elif MIP_FILTER == 2
+    return float4(Texel.xyz * 2.0f - 1.0f, Texel.a);
+#else
+    return Texel;
+#endif
+}
+
+float4 EncodeTexel(float4 Value)
+{
+#if MIP_FILTER == 1
+    return float4(LinearToSrgb(saturate(Value.rgb)), Value.a);
+#elif MIP_FILTER == 2
+    const float Length = length(Value.xyz);
+    const float3 Normal = Length > 1e-6f ? Value.xyz / Length : float3(0.0f, 0.0f, 1.0f);
+    return float4(Normal * 0.5f + 0.5f, Value.a);
+#else
+    return Value;
+#endif
+}
+
+// Overlap of the destination texel's source span with source texels First, First + 1 and First + 2.
+float3 AxisWeights(uint DestCoord, uint SourceExtent, uint DestExtent, out uint First)
+{
+    const float Scale = float(SourceExtent) / float(DestExtent);
+    const float SpanBegin = DestCoord * Scale;
+    const float SpanEnd = SpanBegin + Scale;
+    First = uint(SpanBegin);
+
+    float3 Weights;
+    [unroll]
+    for (uint Tap = 0; Tap < 3; ++Tap)
+    {
+        const float TexelBegin = float(First + Tap);
+        Weights[Tap] = saturate(min(SpanEnd, TexelBegin + 1.0f) - max(SpanBegin, TexelBegin));
+    }
+    return Weights / Scale;
+}
+
+[numthreads(8, 8, 1)]
+void GenerateMips(uint3 DispatchThreadId : SV_DispatchThreadID)
+{
+    if (any(DispatchThreadId.xy >= DestSize))
+    {
+        return;
+    }
+
+    uint FirstX;
+    uint FirstY;
+    const float3 WeightsX = AxisWeights(DispatchThreadId.x, SourceSize.x, DestSize.x, FirstX);
+    const float3 WeightsY = AxisWeights(DispatchThreadId.y, SourceSize.y, DestSize.y, FirstY);
+
+    float4 Sum = 0.0f;
+    [unroll]
+    for (uint Y = 0; Y < 3; ++Y)
+    {
+        [unroll]
+        for (uint X = 0; X < 3; ++X)
+        {
+            const float Weight = WeightsX[X] * WeightsY[Y];
+            if (Weight > 0.0f)
+            {
+                const uint2 Coord = min(uint2(FirstX + X, FirstY + Y), SourceSize - 1);
+                Sum += DecodeTexel(SourceMip.Load(int3(Coord, 0))) * Weight;
+            }
+        }
+    }
+
+    DestMip[DispatchThreadId.xy] = EncodeTexel(Sum);
+}
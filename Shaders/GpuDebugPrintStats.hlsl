@@ -35,6 +35,8 @@ void CSMain(uint3 dispatchThreadId : SV_DispatchThreadID)
 {
     uint frustum = StatsBuffer.Load(0);
     uint occlusion = StatsBuffer.Load(4);
+    uint commands = StatsBuffer.Load(8);
+    uint tooSmall = StatsBuffer.Load(12);
 
     const uint textColor = 0xffffffffu;
     uint2 pos = uint2(8, 20);
@@ -44,4 +46,12 @@ void CSMain(uint3 dispatchThreadId : SV_DispatchThreadID)
     pos = uint2(8, 36);
     PrintLabel(pos, textColor, 'O', 'C', 'C', 'L', 'U', 'D', 'E', ' ');
     PrintUInt(uint2(8 + 8 * 8, 36), occlusion, textColor);
+
+    pos = uint2(8, 52);
+    PrintLabel(pos, textColor, 'S', 'M', 'A', 'L', 'L', ' ', ' ', ' ');
+    PrintUInt(uint2(8 + 8 * 8, 52), tooSmall, textColor);
+
+    pos = uint2(8, 68);
+    PrintLabel(pos, textColor, 'C', 'O', 'M', 'M', 'A', 'N', 'D', 'S');
+    PrintUInt(uint2(8 + 8 * 8, 68), commands, textColor);
 }
@@ -0,0 +1,54 @@
+// Vertex streams written by RendererUtils::CreateSharedMeshGeometry.
+// Stream 0 holds the quantized position alone so depth-only passes fetch 8 bytes per vertex.
+
+struct MeshPositionInput
+{
+    float4 Position : POSITION; // unorm16 within the mesh bounds, w unused
+};
+
+struct MeshVertexInput
+{
+    float4 Position : POSITION;
+    float2 Normal   : NORMAL;    // snorm16 octahedral
+    float4 Tangent  : TANGENT;   // unorm10 octahedral in xy, bitangent sign in w
+    float2 UV       : TEXCOORD0; // half
+    float4 Color    : COLOR0;    // unorm8
+};
+
+float3 DecodeMeshPosition(float4 Quantized, float3 Scale, float3 Offset)
+{
+    return Quantized.xyz * Scale + Offset;
+}
+
+float3 DecodeOctahedral(float2 Encoded)
+{
+    float3 Vector = float3(Encoded, 1.0 - abs(Encoded.x) - abs(Encoded.y));
+    float Fold = saturate(-Vector.z);
+    Vector.x += Vector.x >= 0.0 ? -Fold : Fold;
+    Vector.y += Vector.y >= 0.0 ? -Fold : Fold;
+    return normalize(Vector);
+}
+
+float4 DecodeMeshTangent(float4 Packed)
+{
+    return float4(DecodeOctahedral(Packed.xy * 2.0 - 1.0), Packed.w > 0.5 ? 1.0 : -1.0);
+}
+
+// Reads one vertex of both streams from the raw vertex buffer for the mesh shader path, applying
+// the same unpacking the input assembler does for MeshVertexInput.
+MeshVertexInput LoadMeshVertex(ByteAddressBuffer VertexBuffer, uint AttributeStreamOffset, uint VertexIndex)
+{
+    uint2 Position = VertexBuffer.Load2(VertexIndex * 8);
+    uint4 Attributes = VertexBuffer.Load4(AttributeStreamOffset + VertexIndex * 16);
+
+    MeshVertexInput Vertex;
+    Vertex.Position = float4(Position.x & 0xFFFF, Position.x >> 16, Position.y & 0xFFFF, Position.y >> 16) / 65535.0;
+    int2 Normal = int2(Attributes.x << 16, Attributes.x) >> 16;
+    Vertex.Normal = max(float2(Normal) / 32767.0, -1.0);
+    Vertex.Tangent = float4(
+        float3(Attributes.y & 0x3FF, (Attributes.y >> 10) & 0x3FF, (Attributes.y >> 20) & 0x3FF) / 1023.0,
+        float(Attributes.y >> 30) / 3.0);
+    Vertex.UV = float2(f16tof32(Attributes.z), f16tof32(Attributes.z >> 16));
+    Vertex.Color = float4(Attributes.w & 0xFF, (Attributes.w >> 8) & 0xFF, (Attributes.w >> 16) & 0xFF, Attributes.w >> 24) / 255.0;
+    return Vertex;
+}
@@ -0,0 +1,178 @@
+// Mesh shader path of the deferred base pass and depth prepass, used when the device supports mesh
+// shaders. The amplification shader culls a model's meshlets against the frustum, their normal cone
+// and the previous frame's HZB; the mesh shader emits the survivors through TransformMeshVertex, so
+// PSMain from DeferredBasePass.hlsl shades them unchanged.
+#include "DeferredBasePass.hlsl"
+#include "CullingCommon.hlsl"
+
+#define MESHLETS_PER_GROUP 32
+#define MESHLET_MAX_VERTICES 64
+#define MESHLET_MAX_TRIANGLES 124
+
+// FMeshlet in Source/Scene/MeshletBuilder.h; bounds are in mesh space.
+struct Meshlet
+{
+    float3 Center;
+    float Radius;
+    float3 ConeApex;
+    float ConeCutoff;
+    float3 ConeAxis;
+    uint VertexOffset;
+    uint TriangleOffset;
+    uint VertexCount;
+    uint TriangleCount;
+    uint Padding;
+};
+
+cbuffer MeshletDrawConstants : register(b1)
+{
+    uint MeshletStart;
+    uint MeshletCount;
+    uint AttributeStreamOffset;
+    uint MeshletObjectIndex;
+};
+
+// Culling camera state, set once per pass.
+cbuffer MeshletCullingConstants : register(b2)
+{
+    float4 CullingFrustumPlanes[6];
+    float4x4 CullingViewProjection;
+    float3 CullingCameraPosition;
+    uint HZBEnabled;
+    uint HZBMipCount;
+    uint HZBWidth;
+    uint HZBHeight;
+};
+
+StructuredBuffer<Meshlet> Meshlets : register(t0, space1);
+StructuredBuffer<uint> MeshletVertices : register(t1, space1);
+StructuredBuffer<uint> MeshletTriangles : register(t2, space1);
+ByteAddressBuffer SceneVertices : register(t3, space1);
+Texture2D<float> HZBTexture : register(t4, space1);
+
+struct MeshletPayload
+{
+    uint MeshletIndices[MESHLETS_PER_GROUP];
+};
+
+groupshared MeshletPayload Payload;
+groupshared uint VisibleMeshletCount;
+
+bool IsMeshletVisible(Meshlet M)
+{
+    float4x4 World = SceneObjects[MeshletObjectIndex].World;
+    float3 axisScaleSq = float3(dot(World[0].xyz, World[0].xyz), dot(World[1].xyz, World[1].xyz), dot(World[2].xyz, World[2].xyz));
+    float maxScale = sqrt(max(max(axisScaleSq.x, axisScaleSq.y), axisScaleSq.z));
+    float minScale = sqrt(min(min(axisScaleSq.x, axisScaleSq.y), axisScaleSq.z));
+
+    float3 center = mul(float4(M.Center, 1.0f), World).xyz;
+    float radius = M.Radius * maxScale;
+
+    [unroll]
+    for (uint i = 0; i < 6; ++i)
+    {
+        if (dot(CullingFrustumPlanes[i].xyz, center) + CullingFrustumPlanes[i].w < -radius)
+        {
+            return false;
+        }
+    }
+
+    // Non-uniform scale bends normals away from the transformed cone, so the test is skipped there.
+    if (M.ConeCutoff < 1.0f && maxScale <= minScale * 1.001f)
+    {
+        float3 apex = mul(float4(M.ConeApex, 1.0f), World).xyz;
+        float3 axis = normalize(mul(M.ConeAxis, (float3x3)World));
+        if (dot(normalize(apex - CullingCameraPosition), axis) >= M.ConeCutoff)
+        {
+            return false;
+        }
+    }
+
+    if (HZBEnabled != 0 && IsAabbOccludedByHZB(HZBTexture, CullingViewProjection, uint2(HZBWidth, HZBHeight), HZBMipCount, center - radius, center + radius))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+[numthreads(MESHLETS_PER_GROUP, 1, 1)]
+void ASMain(uint dispatchThreadId : SV_DispatchThreadID, uint groupIndex : SV_GroupIndex)
+{
+    if (groupIndex == 0)
+    {
+        VisibleMeshletCount = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    if (dispatchThreadId < MeshletCount && IsMeshletVisible(Meshlets[MeshletStart + dispatchThreadId]))
+    {
+        uint slot;
+        InterlockedAdd(VisibleMeshletCount, 1, slot);
+        Payload.MeshletIndices[slot] = MeshletStart + dispatchThreadId;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    DispatchMesh(VisibleMeshletCount, 1, 1, Payload);
+}
+
+uint3 LoadMeshletTriangle(Meshlet M, uint triangleIndex)
+{
+    uint packed = MeshletTriangles[M.TriangleOffset + triangleIndex];
+    return uint3(packed & 0xFF, (packed >> 8) & 0xFF, (packed >> 16) & 0xFF);
+}
+
+VSOutput LoadMeshletVertex(Meshlet M, uint vertexIndex)
+{
+    return TransformMeshVertex(LoadMeshVertex(SceneVertices, AttributeStreamOffset, MeshletVertices[M.VertexOffset + vertexIndex]), MeshletObjectIndex);
+}
+
+[outputtopology("triangle")]
+[numthreads(128, 1, 1)]
+void MSMain(
+    uint groupThreadId : SV_GroupThreadID,
+    uint groupId : SV_GroupID,
+    in payload MeshletPayload InPayload,
+    out vertices VSOutput OutVertices[MESHLET_MAX_VERTICES],
+    out indices uint3 OutTriangles[MESHLET_MAX_TRIANGLES])
+{
+    Meshlet M = Meshlets[InPayload.MeshletIndices[groupId]];
+    SetMeshOutputCounts(M.VertexCount, M.TriangleCount);
+
+    if (groupThreadId < M.VertexCount)
+    {
+        OutVertices[groupThreadId] = LoadMeshletVertex(M, groupThreadId);
+    }
+    if (groupThreadId < M.TriangleCount)
+    {
+        OutTriangles[groupThreadId] = LoadMeshletTriangle(M, groupThreadId);
+    }
+}
+
+struct DepthOnlyVertex
+{
+    float4 Position : SV_Position;
+};
+
+// Same vertex transform as MSMain, so the prepass depth matches the base pass exactly.
+[outputtopology("triangle")]
+[numthreads(128, 1, 1)]
+void MSDepthOnly(
+    uint groupThreadId : SV_GroupThreadID,
+    uint groupId : SV_GroupID,
+    in payload MeshletPayload InPayload,
+    out vertices DepthOnlyVertex OutVertices[MESHLET_MAX_VERTICES],
+    out indices uint3 OutTriangles[MESHLET_MAX_TRIANGLES])
+{
+    Meshlet M = Meshlets[InPayload.MeshletIndices[groupId]];
+    SetMeshOutputCounts(M.VertexCount, M.TriangleCount);
+
+    if (groupThreadId < M.VertexCount)
+    {
+        OutVertices[groupThreadId].Position = LoadMeshletVertex(M, groupThreadId).Position;
+    }
+    if (groupThreadId < M.TriangleCount)
+    {
+        OutTriangles[groupThreadId] = LoadMeshletTriangle(M, groupThreadId);
+    }
+}
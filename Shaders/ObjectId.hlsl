@@ -1,29 +1,26 @@
 #include "SceneConstants.hlsl"
-
-struct VSInput
-{
-    float3 Position : POSITION;
-    float3 Normal : NORMAL;
-    float2 TexCoord : TEXCOORD;
-    float4 Tangent : TANGENT;
-    float4 Color : COLOR;
-};
+#include "SceneInstances.hlsl"
+#include "MeshVertex.hlsl"
 
 struct VSOutput
 {
     float4 Position : SV_POSITION;
+    nointerpolation uint ObjectId : OBJECTID;
 };
 
-VSOutput VSMain(VSInput Input)
+VSOutput VSMain(MeshPositionInput Input, uint InstanceId : SV_InstanceID)
 {
+    SceneObject Object = SceneObjects[LoadObjectIndex(InstanceId)];
+
     VSOutput Output;
-    float4 WorldPosition = mul(float4(Input.Position, 1.0f), World);
+    float4 WorldPosition = mul(float4(DecodeMeshPosition(Input.Position, Object.PositionScale, Object.PositionOffset), 1.0f), Object.World);
     float4 ViewPosition = mul(WorldPosition, View);
     Output.Position = mul(ViewPosition, Projection);
+    Output.ObjectId = Object.ObjectId;
     return Output;
 }
 
 uint PSMain(VSOutput Input) : SV_Target0
 {
-    return ObjectId;
+    return Input.ObjectId;
 }
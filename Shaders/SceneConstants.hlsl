@@ -1,29 +1,62 @@
-cbuffer SceneConstants : register(b0)
+#ifndef BINDLESS_MATERIALS
+#define BINDLESS_MATERIALS 0
+#endif
+
+// FShadowCascades::CascadeCount in Source/Render/ShadowCascades.h.
+#define SHADOW_CASCADE_COUNT 4
+
+// FSceneViewConstants in Source/Render/RendererUtils.h, written once per frame.
+cbuffer ViewConstants : register(b0)
 {
-    row_major float4x4 World;
     row_major float4x4 View;
     row_major float4x4 ViewInverse;
     row_major float4x4 Projection;
-    float3 BaseColor;
-    float LightIntensity;
+    // The cascade being drawn in shadow passes, which bind a copy of these per cascade.
+    row_major float4x4 LightViewProjection;
     float3 LightDirection;
-    float Padding1;
+    float LightIntensity;
     float3 CameraPosition;
-    float Padding2;
+    float EnvMapMipCount;
     float3 LightColor;
-    float Padding3;
-    float3 EmissiveFactor;
-    float Padding4;
-    row_major float4x4 LightViewProjection;
     float ShadowStrength;
-    float ShadowBias;
     float2 ShadowMapSize;
+    float ShadowBias;
+    float PaddingView;
+    row_major float4x4 ShadowCascadeViewProjection[SHADOW_CASCADE_COUNT];
+    // View depth where each cascade ends.
+    float4 ShadowCascadeSplits;
+    // This and the previous frame's view projection without the TAA jitter, for motion vectors.
+    row_major float4x4 UnjitteredViewProjection;
+    row_major float4x4 PrevUnjitteredViewProjection;
+    // L2 spherical harmonics of the environment's irradiance; see Shaders/SphericalHarmonics.hlsl.
+    float4 IrradianceSH[9];
+};
+
+// FSceneObjectData in Source/Render/RendererUtils.h, one per scene model.
+struct SceneObject
+{
+    row_major float4x4 World;
+    // World of the previous frame, equal to World while the model rests.
+    row_major float4x4 PrevWorld;
+    float3 PositionScale;
+    uint ObjectId;
+    float3 PositionOffset;
+    uint MaterialIndex;
+};
+
+// FSceneMaterialData in Source/Render/RendererUtils.h.
+struct SceneMaterial
+{
+    float3 BaseColor;
+    float BaseColorAlpha;
+    float3 EmissiveFactor;
     float MetallicFactor;
     float RoughnessFactor;
-    float BaseColorAlpha;
     float AlphaCutoff;
     uint AlphaMode;
-    uint3 PaddingMaterial;
+    uint Flags;
+    uint DescriptorIndex;
+    uint3 Padding;
     float4 BaseColorTransformOffsetScale;
     float4 BaseColorTransformRotation;
     float4 MetallicRoughnessTransformOffsetScale;
@@ -32,8 +65,39 @@ cbuffer SceneConstants : register(b0)
     float4 NormalTransformRotation;
     float4 EmissiveTransformOffsetScale;
     float4 EmissiveTransformRotation;
-    float EnvMapMipCount;
-    float3 PaddingEnvMap;
-    uint ObjectId;
-    float3 PaddingObjectId;
 };
+
+StructuredBuffer<SceneObject> SceneObjects : register(t1, space2);
+StructuredBuffer<SceneMaterial> SceneMaterials : register(t2, space2);
+
+SceneMaterial LoadSceneMaterial(uint ObjectIndex)
+{
+    return SceneMaterials[SceneObjects[ObjectIndex].MaterialIndex];
+}
+
+#define MATERIAL_FLAG_NORMAL_MAP             0x1
+#define MATERIAL_FLAG_METALLIC_ROUGHNESS_MAP 0x2
+#define MATERIAL_FLAG_BASE_COLOR_MAP         0x4
+#define MATERIAL_FLAG_EMISSIVE_MAP           0x8
+
+#if BINDLESS_MATERIALS
+// SM 6.6: the material's descriptors start at DescriptorIndex in the bound heap. The index comes
+// from the interpolated object index, which the compiler cannot assume uniform across a wave.
+Texture2D LoadMaterialTexture(SceneMaterial Material, uint Slot)
+{
+    Texture2D Texture = ResourceDescriptorHeap[NonUniformResourceIndex(Material.DescriptorIndex + Slot)];
+    return Texture;
+}
+
+TextureCube LoadMaterialTextureCube(SceneMaterial Material, uint Slot)
+{
+    TextureCube Texture = ResourceDescriptorHeap[NonUniformResourceIndex(Material.DescriptorIndex + Slot)];
+    return Texture;
+}
+
+Texture2DArray LoadMaterialTextureArray(SceneMaterial Material, uint Slot)
+{
+    Texture2DArray Texture = ResourceDescriptorHeap[NonUniformResourceIndex(Material.DescriptorIndex + Slot)];
+    return Texture;
+}
+#endif
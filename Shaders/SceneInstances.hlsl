@@ -0,0 +1,22 @@
+// Selects the scene object a vertex belongs to. CPU draws set NO_INSTANCE_BASE and the object index
+// as root constants. GPU culling appends the scene model index of every surviving member of an
+// instance group to VisibleInstances, starting at the InstanceBase its indirect command sets.
+// Include after SceneConstants.hlsl.
+#define NO_INSTANCE_BASE 0xFFFFFFFF
+
+cbuffer InstanceConstants : register(b0, space2)
+{
+    uint InstanceBase;
+    uint DrawObjectIndex;
+};
+
+StructuredBuffer<uint> VisibleInstances : register(t0, space2);
+
+uint LoadObjectIndex(uint InstanceId)
+{
+    if (InstanceBase == NO_INSTANCE_BASE)
+    {
+        return DrawObjectIndex;
+    }
+    return VisibleInstances[InstanceBase + InstanceId];
+}
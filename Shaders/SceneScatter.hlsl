@@ -0,0 +1,28 @@
+// Applies a compact list of changed entries to one of the GPU-resident scene buffers
+// (SceneObjects, SceneMaterials or ModelBounds). Each update is the destination entry index
+// followed by the entry's EntryDwordCount dwords; see FRenderer::ScatterSceneEntries.
+cbuffer ScatterConstants : register(b0)
+{
+    uint UpdateCount;
+    uint EntryDwordCount;
+};
+
+ByteAddressBuffer Updates : register(t0);
+RWByteAddressBuffer Destination : register(u0);
+
+// One thread per dword, so wide entries such as materials spread over a whole group.
+[numthreads(64, 1, 1)]
+void CSMain(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+    uint updateIndex = dispatchThreadId.x / EntryDwordCount;
+    if (updateIndex >= UpdateCount)
+    {
+        return;
+    }
+
+    uint dwordIndex = dispatchThreadId.x - updateIndex * EntryDwordCount;
+    uint updateOffset = updateIndex * (EntryDwordCount + 1u) * 4u;
+    uint destinationIndex = Updates.Load(updateOffset);
+    uint value = Updates.Load(updateOffset + 4u + dwordIndex * 4u);
+    Destination.Store((destinationIndex * EntryDwordCount + dwordIndex) * 4u, value);
+}
@@ -0,0 +1,198 @@
+// Shading rate image of variable rate shading; see FVariableRateShading in
+// Source/Render/VariableRateShading.h. BuildShadingRate runs one group per rate tile over the
+// frame's final scene color and picks, per axis, the coarsest rate whose neighbouring pixels
+// still differ less than the threshold in perceptual luma. OverlayPS tints the screen by rate.
+
+#include "SceneConstants.hlsl"
+
+cbuffer ShadingRateConstants : register(b1)
+{
+    row_major float4x4 PrevViewProjection;
+    uint2 SourceSize;
+    uint TileSize;
+    uint Flags;
+    float Exposure;
+    // Largest luma step between neighbouring pixels a 2x coarse axis may hide.
+    float ContrastThreshold;
+    // Threshold growth per pixel of camera motion.
+    float MotionScale;
+    float PaddingRate;
+};
+
+// FVariableRateShading::Flag* in Source/Render/VariableRateShading.h.
+#define SHADING_RATE_FLAG_EXPOSURE_TEXTURE 0x1
+#define SHADING_RATE_FLAG_DISPLAY_REFERRED 0x2
+#define SHADING_RATE_FLAG_ADDITIONAL_RATES 0x4
+#define SHADING_RATE_FLAG_MOTION_HISTORY   0x8
+
+// D3D12_SHADING_RATE: log2 of the width in bits 2-3, log2 of the height in bits 0-1.
+#define SHADING_RATE_1X1 0x0
+
+// Motion beyond this many pixels no longer raises the threshold.
+#define MAX_MOTION_PIXELS 32.0f
+
+Texture2D SceneColor : register(t0);
+Texture2D<float> SceneDepth : register(t1);
+Texture2D<float> ExposureEv : register(t2);
+Texture2D<uint> ShadingRateImage : register(t3);
+RWTexture2D<uint> ShadingRateOutput : register(u0);
+
+groupshared uint SharedContrastX;
+groupshared uint SharedContrastY;
+groupshared uint SharedMotion;
+
+// Luma as the display shows it: HDR sources go through the exposure and a Reinhard curve, then
+// a square root as a cheap gamma, so equal steps are about equally visible in dark and bright areas.
+float LoadPerceptualLuma(int2 pixel)
+{
+    pixel = clamp(pixel, int2(0, 0), int2(SourceSize) - 1);
+    float luma = dot(max(SceneColor.Load(int3(pixel, 0)).rgb, 0.0f), float3(0.2126f, 0.7152f, 0.0722f));
+    if (Flags & SHADING_RATE_FLAG_DISPLAY_REFERRED)
+    {
+        return saturate(luma);
+    }
+
+    float exposure = Exposure;
+    if (Flags & SHADING_RATE_FLAG_EXPOSURE_TEXTURE)
+    {
+        exposure *= exp2(ExposureEv.Load(int3(0, 0, 0)));
+    }
+    luma *= exposure;
+    return sqrt(luma / (1.0f + luma));
+}
+
+// Pixels the camera moved a geometry pixel since the previous frame; sky pixels do not move.
+float GetCameraMotion(uint2 pixel)
+{
+    float depth = SceneDepth.Load(int3(pixel, 0));
+    if (depth <= 0.0f || (Flags & SHADING_RATE_FLAG_MOTION_HISTORY) == 0)
+    {
+        return 0.0f;
+    }
+
+    float2 uv = (float2(pixel) + 0.5f) / float2(SourceSize);
+    float2 ndc = float2(uv.x * 2.0f - 1.0f, 1.0f - uv.y * 2.0f);
+    float viewZ = Projection._43 / depth;
+    float3 viewPos = float3(ndc.x * viewZ / Projection._11, ndc.y * viewZ / Projection._22, viewZ);
+    float3 worldPos = mul(float4(viewPos, 1.0f), ViewInverse).xyz;
+
+    float4 prevClip = mul(float4(worldPos, 1.0f), PrevViewProjection);
+    if (prevClip.w <= 0.0f)
+    {
+        return MAX_MOTION_PIXELS;
+    }
+    float2 prevNdc = prevClip.xy / prevClip.w;
+    return min(length((prevNdc - ndc) * float2(SourceSize) * 0.5f), MAX_MOTION_PIXELS);
+}
+
+// Log2 of the coarsest step along an axis whose largest luma step stays under the threshold.
+uint SelectAxisRate(float contrast, float threshold)
+{
+    if (contrast >= threshold)
+    {
+        return 0;
+    }
+    return ((Flags & SHADING_RATE_FLAG_ADDITIONAL_RATES) && contrast < threshold * 0.25f) ? 2 : 1;
+}
+
+[numthreads(8, 8, 1)]
+void BuildShadingRate(uint3 groupId : SV_GroupID, uint3 groupThreadId : SV_GroupThreadID, uint groupIndex : SV_GroupIndex)
+{
+    if (groupIndex == 0)
+    {
+        SharedContrastX = 0;
+        SharedContrastY = 0;
+        SharedMotion = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    // Tiles are 8, 16 or 32 pixels wide, so each thread covers a square of the tile's pixels.
+    uint2 tileOrigin = groupId.xy * TileSize;
+    float contrastX = 0.0f;
+    float contrastY = 0.0f;
+    float motion = 0.0f;
+    for (uint y = groupThreadId.y; y < TileSize; y += 8)
+    {
+        for (uint x = groupThreadId.x; x < TileSize; x += 8)
+        {
+            uint2 pixel = tileOrigin + uint2(x, y);
+            if (any(pixel >= SourceSize))
+            {
+                continue;
+            }
+
+            float luma = LoadPerceptualLuma(int2(pixel));
+            contrastX = max(contrastX, abs(LoadPerceptualLuma(int2(pixel) + int2(1, 0)) - luma));
+            contrastY = max(contrastY, abs(LoadPerceptualLuma(int2(pixel) + int2(0, 1)) - luma));
+            motion = max(motion, GetCameraMotion(pixel));
+        }
+    }
+
+    // Non-negative floats order like their bit patterns.
+    InterlockedMax(SharedContrastX, asuint(contrastX));
+    InterlockedMax(SharedContrastY, asuint(contrastY));
+    InterlockedMax(SharedMotion, asuint(motion));
+    GroupMemoryBarrierWithGroupSync();
+
+    if (groupIndex != 0)
+    {
+        return;
+    }
+
+    float threshold = ContrastThreshold * (1.0f + MotionScale * asfloat(SharedMotion));
+    uint rateX = SelectAxisRate(asfloat(SharedContrastX), threshold);
+    uint rateY = SelectAxisRate(asfloat(SharedContrastY), threshold);
+
+    // 1x4 and 4x1 are not shading rates.
+    if (rateX == 2 && rateY == 0)
+    {
+        rateX = 1;
+    }
+    if (rateY == 2 && rateX == 0)
+    {
+        rateY = 1;
+    }
+    ShadingRateOutput[groupId.xy] = (rateX << 2) | rateY;
+}
+
+struct VSOutput
+{
+    float4 Position : SV_Position;
+};
+
+VSOutput OverlayVS(uint VertexId : SV_VertexID)
+{
+    float2 Positions[3] = {
+        float2(-1.0, -1.0),
+        float2(-1.0, 3.0),
+        float2(3.0, -1.0)
+    };
+
+    VSOutput Output;
+    Output.Position = float4(Positions[VertexId], 0.0, 1.0);
+    return Output;
+}
+
+// Full rate stays untinted; one coarse axis is blue, 2x2 green, and the 4x rates yellow to red.
+float4 OverlayPS(VSOutput Input) : SV_Target
+{
+    uint rate = ShadingRateImage.Load(int3(uint2(Input.Position.xy) / TileSize, 0));
+    uint pixelCount = (1u << (rate >> 2)) * (1u << (rate & 0x3));
+    if (rate == SHADING_RATE_1X1)
+    {
+        return float4(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+    if (pixelCount == 2)
+    {
+        return float4(0.1f, 0.3f, 1.0f, 0.35f);
+    }
+    if (pixelCount == 4)
+    {
+        return float4(0.1f, 1.0f, 0.2f, 0.35f);
+    }
+    if (pixelCount == 8)
+    {
+        return float4(1.0f, 0.9f, 0.1f, 0.35f);
+    }
+    return float4(1.0f, 0.1f, 0.1f, 0.35f);
+}
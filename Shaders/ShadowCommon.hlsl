@@ -0,0 +1,40 @@
+// Cascaded shadow lookup shared by the lighting shaders. Include after SceneConstants.hlsl.
+
+// Shadow factor of a world position, from the first cascade whose split contains viewDepth and
+// whose map covers the position, with 2x2 PCF around it. Beyond the last split nothing is shadowed.
+float SampleCascadedShadow(Texture2DArray shadowMap, SamplerComparisonState shadowSampler, float3 worldPos, float viewDepth)
+{
+    if (ShadowStrength <= 0.0f)
+    {
+        return 1.0f;
+    }
+
+    [loop]
+    for (uint cascade = 0; cascade < SHADOW_CASCADE_COUNT; ++cascade)
+    {
+        if (viewDepth > ShadowCascadeSplits[cascade])
+        {
+            continue;
+        }
+
+        float4 shadowPosition = mul(float4(worldPos, 1.0f), ShadowCascadeViewProjection[cascade]);
+        float3 shadowCoord = shadowPosition.xyz / shadowPosition.w;
+        float2 shadowUV = shadowCoord.xy * float2(0.5f, -0.5f) + 0.5f;
+        if (any(shadowUV < 0.0f) || any(shadowUV > 1.0f))
+        {
+            continue;
+        }
+
+        float2 halfTexel = 0.5f / ShadowMapSize;
+        float shadowCompare = shadowCoord.z - ShadowBias;
+        float slice = (float)cascade;
+        float shadow = 0.25f * (
+            shadowMap.SampleCmpLevelZero(shadowSampler, float3(shadowUV + float2(halfTexel.x, halfTexel.y), slice), shadowCompare) +
+            shadowMap.SampleCmpLevelZero(shadowSampler, float3(shadowUV + float2(-halfTexel.x, halfTexel.y), slice), shadowCompare) +
+            shadowMap.SampleCmpLevelZero(shadowSampler, float3(shadowUV + float2(halfTexel.x, -halfTexel.y), slice), shadowCompare) +
+            shadowMap.SampleCmpLevelZero(shadowSampler, float3(shadowUV + float2(-halfTexel.x, -halfTexel.y), slice), shadowCompare));
+        return lerp(1.0f, shadow, ShadowStrength);
+    }
+
+    return 1.0f;
+}
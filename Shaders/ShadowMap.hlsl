@@ -1,20 +1,18 @@
 #include "SceneConstants.hlsl"
-
-struct VSInput
-{
-    float3 Position : POSITION;
-};
-
+#include "SceneInstances.hlsl"
+#include "MeshVertex.hlsl"
 
 struct VSOutput
 {
     float4 Position : SV_Position;
 };
 
-VSOutput VSMain(VSInput Input)
+VSOutput VSMain(MeshPositionInput Input, uint InstanceId : SV_InstanceID)
 {
+    SceneObject Object = SceneObjects[LoadObjectIndex(InstanceId)];
+
     VSOutput Output;
-    float4 WorldPos = mul(float4(Input.Position, 1.0), World);
+    float4 WorldPos = mul(float4(DecodeMeshPosition(Input.Position, Object.PositionScale, Object.PositionOffset), 1.0), Object.World);
     Output.Position = mul(WorldPos, LightViewProjection);
     return Output;
 }
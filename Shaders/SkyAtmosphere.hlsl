@@ -1,41 +1,38 @@
-struct VSInput
-{
-    float3 Position : POSITION;
-    float3 Normal   : NORMAL;
-    float2 UV       : TEXCOORD0;
-    float4 Tangent  : TANGENT;
-};
+// Sky of the atmosphere in Shaders/SkyAtmosphereCommon.hlsl; see FSkyAtmosphere in
+// Source/Render/SkyAtmosphere.h. BuildTransmittanceLut and BuildMultiScatteringLut depend on the
+// atmosphere alone. BuildSkyViewLut integrates the single and multiple scattering seen from
+// ObserverAltitude into a low-resolution map around the sun, rebuilt only when the sun moves.
+// The sky pass draws a fullscreen triangle on the far plane whose pixels read that map and add
+// the sun's disk. The LUTs hold the sky of a unit sun, which SunIlluminance scales.
 
-struct VSOutput
-{
-    float4 Position : SV_Position;
-    float3 WorldPos : TEXCOORD0;
-    float3 Normal   : TEXCOORD1;
-};
+#include "PBRCommon.hlsl"
+#include "SceneConstants.hlsl"
+#include "SkyAtmosphereCommon.hlsl"
 
-cbuffer SkyConstants : register(b0)
+cbuffer SkyAtmosphereConstants : register(b1)
 {
-    row_major float4x4 World;
-    row_major float4x4 View;
-    row_major float4x4 Projection;
-    float3 CameraPosition;
-    float Padding0;
-    float3 LightDirection;
-    float Padding1;
-    float3 LightColor;
-    float Padding2;
+    // Towards the sun, in world space: of the sky-view LUT being built or drawn.
+    float3 SunDirection;
+    // Cosine of the sun disk's angular radius.
+    float SunDiskCosine;
+    float3 SunIlluminance;
+    // Luminance of the disk over the illuminance of the sun.
+    float SunDiskLuminance;
 };
 
-VSOutput VSMain(VSInput Input)
-{
-    VSOutput Output;
-    float4 WorldPosition = mul(float4(Input.Position, 1.0), World);
-    float4 ViewPosition = mul(WorldPosition, View);
-    Output.Position = mul(ViewPosition, Projection);
-    Output.WorldPos = WorldPosition.xyz;
-    Output.Normal = mul(Input.Normal, (float3x3)World);
-    return Output;
-}
+Texture2D<float4> TransmittanceLut : register(t0);
+Texture2D<float4> MultiScatteringLut : register(t1);
+Texture2D<float4> SkyViewLut : register(t2);
+RWTexture2D<float4> LutOutput : register(u0);
+SamplerState LinearClampSampler : register(s0);
+
+#define TRANSMITTANCE_STEP_COUNT 40
+#define MULTI_SCATTERING_STEP_COUNT 20
+#define SKY_VIEW_STEP_COUNT 30
+// Directions each multiple-scattering texel integrates, one per thread of its group.
+#define MULTI_SCATTERING_DIRECTION_COUNT 64
+
+static const float3 GroundAlbedo = 0.3f;
 
 float RayleighPhase(float cosTheta)
 {
@@ -43,59 +40,270 @@ float RayleighPhase(float cosTheta)
     // Derived from the dipole scattering model assuming unpolarized light and
     // small particles relative to the wavelength, resulting in the characteristic
     // blue hue (short wavelengths scattered more strongly).
-    const float k = 3.0 / (16.0 * 3.14159265);
-    return k * (1.0 + cosTheta * cosTheta);
+    return 3.0f / (16.0f * PI) * (1.0f + cosTheta * cosTheta);
 }
 
 float MiePhase(float cosTheta, float g)
 {
-    // Cornette–Shanks approximation of the Henyey–Greenstein phase function:
-    // (1 - g²) / (4π * (1 + g² - 2g cosθ)^(3/2)). The asymmetry factor g controls
-    // how strongly the scattering is pushed forward (g → 1) or backward (g → -1).
+    // Cornette–Shanks phase function: 3(1 - g²)(1 + cos²θ) / (8π(2 + g²)(1 + g² - 2g cosθ)^(3/2)).
+    // The asymmetry factor g controls how strongly the scattering is pushed forward (g → 1)
+    // or backward (g → -1).
     float g2 = g * g;
-    float denom = pow(1.0 + g2 - 2.0 * g * cosTheta, 1.5);
-    return (1.0 - g2) / (4.0 * 3.14159265 * max(denom, 1e-3));
+    float denom = (2.0f + g2) * pow(max(1.0f + g2 - 2.0f * g * cosTheta, 1e-4f), 1.5f);
+    return 3.0f * (1.0f - g2) * (1.0f + cosTheta * cosTheta) / (8.0f * PI * denom);
+}
+
+float3 GetMultipleScattering(float r, float sunZenithCos)
+{
+    float2 uv = float2(sunZenithCos * 0.5f + 0.5f, saturate((r - GroundRadius) / (AtmosphereRadius - GroundRadius)));
+    uv = float2(FromUnitToSubUv(uv.x, MULTI_SCATTERING_LUT_SIZE), FromUnitToSubUv(uv.y, MULTI_SCATTERING_LUT_SIZE));
+    return MultiScatteringLut.SampleLevel(LinearClampSampler, uv, 0.0f).rgb;
+}
+
+// Scattering of a sample over a step it fills with constant media, integrated analytically so
+// long steps through dense air do not add more light than they let through.
+float3 IntegrateStep(float3 scattering, float3 extinction, float3 stepTransmittance)
+{
+    return (scattering - scattering * stepTransmittance) / max(extinction, 1e-6f);
+}
+
+[numthreads(8, 8, 1)]
+void BuildTransmittanceLut(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+    if (any(dispatchThreadId.xy >= uint2(TRANSMITTANCE_LUT_WIDTH, TRANSMITTANCE_LUT_HEIGHT)))
+    {
+        return;
+    }
+
+    float r;
+    float mu;
+    float2 uv = (float2(dispatchThreadId.xy) + 0.5f) / float2(TRANSMITTANCE_LUT_WIDTH, TRANSMITTANCE_LUT_HEIGHT);
+    GetTransmittanceLutParameters(uv, r, mu);
+
+    float stepLength = DistanceToAtmosphereTop(r, mu) / TRANSMITTANCE_STEP_COUNT;
+    float3 opticalDepth = 0.0f;
+    for (uint i = 0; i < TRANSMITTANCE_STEP_COUNT; ++i)
+    {
+        float t = (float(i) + 0.5f) * stepLength;
+        float sampleRadius = sqrt(r * r + t * t + 2.0f * r * mu * t);
+        opticalDepth += SampleAtmosphere(sampleRadius - GroundRadius).extinction * stepLength;
+    }
+
+    LutOutput[dispatchThreadId.xy] = float4(exp(-opticalDepth), 1.0f);
+}
+
+groupshared float3 SharedSecondOrder[MULTI_SCATTERING_DIRECTION_COUNT];
+groupshared float3 SharedTransfer[MULTI_SCATTERING_DIRECTION_COUNT];
+
+// Hillaire's multiple scattering: each texel holds, for its altitude and sun, the light of
+// second-order isotropic scattering from every direction, amplified by the geometric series of
+// the share fms each further order transfers: L2 / (1 - fms).
+[numthreads(1, 1, MULTI_SCATTERING_DIRECTION_COUNT)]
+void BuildMultiScatteringLut(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    float2 uv = (float2(groupId.xy) + 0.5f) / MULTI_SCATTERING_LUT_SIZE;
+    uv = float2(FromSubUvToUnit(uv.x, MULTI_SCATTERING_LUT_SIZE), FromSubUvToUnit(uv.y, MULTI_SCATTERING_LUT_SIZE));
+
+    float sunZenithCos = uv.x * 2.0f - 1.0f;
+    float3 sun = float3(sqrt(saturate(1.0f - sunZenithCos * sunZenithCos)), sunZenithCos, 0.0f);
+    float r = GroundRadius + saturate(uv.y) * (AtmosphereRadius - GroundRadius);
+    float3 origin = float3(0.0f, r, 0.0f);
+
+    // Uniform directions over the sphere, an 8 x 8 grid in azimuth and cosine.
+    float2 cell = (float2(groupIndex % 8, groupIndex / 8) + 0.5f) / 8.0f;
+    float azimuth = 2.0f * PI * cell.x;
+    float cosZenith = 1.0f - 2.0f * cell.y;
+    float sinZenith = sqrt(saturate(1.0f - cosZenith * cosZenith));
+    float3 direction = float3(cos(azimuth) * sinZenith, cosZenith, sin(azimuth) * sinZenith);
+
+    bool bHitsGround = RayHitsGround(r, cosZenith);
+    float distance = bHitsGround ? DistanceToGround(r, cosZenith) : DistanceToAtmosphereTop(r, cosZenith);
+    float stepLength = distance / MULTI_SCATTERING_STEP_COUNT;
+    const float isotropicPhase = 1.0f / (4.0f * PI);
+
+    float3 luminance = 0.0f;
+    float3 transfer = 0.0f;
+    float3 throughput = 1.0f;
+    for (uint i = 0; i < MULTI_SCATTERING_STEP_COUNT; ++i)
+    {
+        float3 position = origin + direction * ((float(i) + 0.5f) * stepLength);
+        float sampleRadius = length(position);
+        AtmosphereSample atmosphere = SampleAtmosphere(sampleRadius - GroundRadius);
+        float3 stepTransmittance = exp(-atmosphere.extinction * stepLength);
+
+        float3 sunTransmittance = SampleSkyTransmittance(TransmittanceLut, LinearClampSampler, sampleRadius, dot(position / sampleRadius, sun));
+        float3 scattering = atmosphere.rayleighScattering + atmosphere.mieScattering;
+
+        luminance += throughput * IntegrateStep(sunTransmittance * scattering * isotropicPhase, atmosphere.extinction, stepTransmittance);
+        transfer += throughput * IntegrateStep(scattering, atmosphere.extinction, stepTransmittance);
+        throughput *= stepTransmittance;
+    }
+
+    // Sunlight the ground reflects back up, as a Lambertian surface.
+    if (bHitsGround)
+    {
+        float3 groundPosition = origin + direction * distance;
+        float3 groundNormal = normalize(groundPosition);
+        float3 sunTransmittance = SampleSkyTransmittance(TransmittanceLut, LinearClampSampler, GroundRadius, dot(groundNormal, sun));
+        luminance += throughput * sunTransmittance * saturate(dot(groundNormal, sun)) * GroundAlbedo / PI;
+    }
+
+    SharedSecondOrder[groupIndex] = luminance;
+    SharedTransfer[groupIndex] = transfer;
+    GroupMemoryBarrierWithGroupSync();
+
+    [unroll]
+    for (uint stride = MULTI_SCATTERING_DIRECTION_COUNT / 2; stride > 0; stride >>= 1)
+    {
+        if (groupIndex < stride)
+        {
+            SharedSecondOrder[groupIndex] += SharedSecondOrder[groupIndex + stride];
+            SharedTransfer[groupIndex] += SharedTransfer[groupIndex + stride];
+        }
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    if (groupIndex == 0)
+    {
+        // The mean over the sphere times its solid angle and the isotropic phase, which cancel.
+        float3 secondOrder = SharedSecondOrder[0] / MULTI_SCATTERING_DIRECTION_COUNT;
+        float3 transferShare = SharedTransfer[0] / MULTI_SCATTERING_DIRECTION_COUNT;
+        LutOutput[groupId.xy] = float4(secondOrder / max(1.0f - transferShare, 1e-4f), 1.0f);
+    }
+}
+
+// Hillaire's sky-view mapping: v by zenith angle, squeezed towards the horizon where the sky
+// changes fastest, with the ground below v = 0.5; u by the azimuth from the sun, also squeezed
+// towards the sun.
+float2 GetSkyViewLutUv(float r, float viewZenithCos, float lightViewCos)
+{
+    float horizonDistance = sqrt(max(r * r - GroundRadius * GroundRadius, 0.0f));
+    float beta = acos(horizonDistance / r);
+    float zenithHorizonAngle = PI - beta;
+    float viewZenithAngle = acos(clamp(viewZenithCos, -1.0f, 1.0f));
+
+    float2 uv;
+    if (viewZenithAngle < zenithHorizonAngle)
+    {
+        float coord = 1.0f - sqrt(saturate(1.0f - viewZenithAngle / zenithHorizonAngle));
+        uv.y = coord * 0.5f;
+    }
+    else
+    {
+        float coord = sqrt(saturate((viewZenithAngle - zenithHorizonAngle) / beta));
+        uv.y = coord * 0.5f + 0.5f;
+    }
+    uv.x = sqrt(saturate(-lightViewCos * 0.5f + 0.5f));
+    return float2(FromUnitToSubUv(uv.x, SKY_VIEW_LUT_WIDTH), FromUnitToSubUv(uv.y, SKY_VIEW_LUT_HEIGHT));
 }
 
-float3 ApplyAtmosphere(float3 viewDir)
+void GetSkyViewLutParameters(float2 uv, float r, out float viewZenithCos, out float lightViewCos)
 {
-    const float horizonFalloff = saturate(pow(1.0 - saturate(viewDir.y * 0.5 + 0.5), 3.0));
-    const float3 zenithColor = float3(0.05, 0.12, 0.22);
-    const float3 horizonColor = float3(0.52, 0.68, 0.86);
-    float3 baseSky = lerp(zenithColor, horizonColor, horizonFalloff);
-
-    float3 up = float3(0.0, 1.0, 0.0);
-    float cosSunView = dot(viewDir, normalize(LightDirection));
-    float cosSunUp = dot(normalize(LightDirection), up);
-
-    // Simple exponential atmosphere: density = exp(-height / H) for both
-    // Rayleigh and Mie components, where H is the scale height controlling the
-    // rate at which particle concentration drops with altitude.
-    const float rayleighScaleHeight = 8000.0;
-    const float mieScaleHeight = 1200.0;
-    float viewHeight = max(0.0, CameraPosition.y);
-    float rayleighDensity = exp(-viewHeight / rayleighScaleHeight);
-    float mieDensity = exp(-viewHeight / mieScaleHeight);
-
-    // Combine phase functions with wavelength-dependent Rayleigh tint and Mie
-    // intensity to approximate single scattering along the view direction.
-    float rayleighPhase = RayleighPhase(cosSunView);
-    float miePhase = MiePhase(cosSunView, 0.76);
-
-    float3 rayleighColor = float3(0.650, 0.570, 0.475);
-    float3 scattered = rayleighColor * rayleighDensity * rayleighPhase;
-    scattered += LightColor * mieDensity * miePhase * 0.8;
-
-    // Attenuate based on sun elevation to reduce contribution near the horizon.
-    float sunAttenuation = saturate(exp(-max(0.0, 1.0 - cosSunUp) * 2.0));
-    float3 atmospheric = scattered * sunAttenuation;
-
-    return baseSky + atmospheric;
+    uv = float2(FromSubUvToUnit(uv.x, SKY_VIEW_LUT_WIDTH), FromSubUvToUnit(uv.y, SKY_VIEW_LUT_HEIGHT));
+
+    float horizonDistance = sqrt(max(r * r - GroundRadius * GroundRadius, 0.0f));
+    float beta = acos(horizonDistance / r);
+    float zenithHorizonAngle = PI - beta;
+
+    float viewZenithAngle;
+    if (uv.y < 0.5f)
+    {
+        float coord = 1.0f - uv.y * 2.0f;
+        viewZenithAngle = zenithHorizonAngle * (1.0f - coord * coord);
+    }
+    else
+    {
+        float coord = uv.y * 2.0f - 1.0f;
+        viewZenithAngle = zenithHorizonAngle + beta * coord * coord;
+    }
+    viewZenithCos = cos(viewZenithAngle);
+    lightViewCos = -(uv.x * uv.x * 2.0f - 1.0f);
 }
 
-float4 PSMain(VSOutput Input) : SV_Target
+[numthreads(8, 8, 1)]
+void BuildSkyViewLut(uint3 dispatchThreadId : SV_DispatchThreadID)
 {
-    float3 viewDir = normalize(Input.WorldPos - CameraPosition);
-    float3 skyColor = ApplyAtmosphere(viewDir);
-    return float4(skyColor, 1.0);
+    if (any(dispatchThreadId.xy >= uint2(SKY_VIEW_LUT_WIDTH, SKY_VIEW_LUT_HEIGHT)))
+    {
+        return;
+    }
+
+    const float r = GroundRadius + ObserverAltitude;
+    float viewZenithCos;
+    float lightViewCos;
+    float2 uv = (float2(dispatchThreadId.xy) + 0.5f) / float2(SKY_VIEW_LUT_WIDTH, SKY_VIEW_LUT_HEIGHT);
+    GetSkyViewLutParameters(uv, r, viewZenithCos, lightViewCos);
+
+    // A frame with the observer on +y and the sun in the xy plane.
+    float3 sun = normalize(SunDirection);
+    sun = float3(sqrt(saturate(1.0f - sun.y * sun.y)), sun.y, 0.0f);
+    float viewZenithSin = sqrt(saturate(1.0f - viewZenithCos * viewZenithCos));
+    float3 direction = float3(viewZenithSin * lightViewCos, viewZenithCos, viewZenithSin * sqrt(saturate(1.0f - lightViewCos * lightViewCos)));
+    float3 origin = float3(0.0f, r, 0.0f);
+
+    float distance = RayHitsGround(r, viewZenithCos) ? DistanceToGround(r, viewZenithCos) : DistanceToAtmosphereTop(r, viewZenithCos);
+    float stepLength = distance / SKY_VIEW_STEP_COUNT;
+
+    float cosTheta = dot(direction, sun);
+    float rayleighPhase = RayleighPhase(cosTheta);
+    float miePhase = MiePhase(cosTheta, MieAnisotropy);
+
+    float3 luminance = 0.0f;
+    float3 throughput = 1.0f;
+    for (uint i = 0; i < SKY_VIEW_STEP_COUNT; ++i)
+    {
+        float3 position = origin + direction * ((float(i) + 0.5f) * stepLength);
+        float sampleRadius = length(position);
+        AtmosphereSample atmosphere = SampleAtmosphere(sampleRadius - GroundRadius);
+        float3 stepTransmittance = exp(-atmosphere.extinction * stepLength);
+
+        float sunZenithCos = dot(position / sampleRadius, sun);
+        float3 sunTransmittance = SampleSkyTransmittance(TransmittanceLut, LinearClampSampler, sampleRadius, sunZenithCos);
+        float3 singleScattering = sunTransmittance * (atmosphere.rayleighScattering * rayleighPhase + atmosphere.mieScattering * miePhase);
+        float3 multipleScattering = GetMultipleScattering(sampleRadius, sunZenithCos) * (atmosphere.rayleighScattering + atmosphere.mieScattering);
+
+        luminance += throughput * IntegrateStep(singleScattering + multipleScattering, atmosphere.extinction, stepTransmittance);
+        throughput *= stepTransmittance;
+    }
+
+    LutOutput[dispatchThreadId.xy] = float4(luminance, 1.0f);
+}
+
+struct SkyVSOutput
+{
+    float4 Position : SV_Position;
+    float2 Ndc : TEXCOORD0;
+};
+
+// Reverse-Z: the triangle lies on the far plane, where only pixels the scene left empty pass.
+SkyVSOutput SkyVS(uint vertexId : SV_VertexID)
+{
+    float2 uv = float2((vertexId << 1) & 2, vertexId & 2);
+    SkyVSOutput output;
+    output.Ndc = uv * float2(2.0f, -2.0f) + float2(-1.0f, 1.0f);
+    output.Position = float4(output.Ndc, 0.0f, 1.0f);
+    return output;
+}
+
+float4 SkyPS(SkyVSOutput input) : SV_Target
+{
+    // The view ray through the pixel under this frame's projection, jitter included.
+    float3 viewRay = float3((input.Ndc.x - Projection._31) / Projection._11, (input.Ndc.y - Projection._32) / Projection._22, 1.0f);
+    float3 direction = normalize(mul(viewRay, (float3x3)ViewInverse));
+    float3 sun = normalize(SunDirection);
+
+    const float r = GroundRadius + ObserverAltitude;
+    float horizontalLength = sqrt(saturate(1.0f - direction.y * direction.y) * saturate(1.0f - sun.y * sun.y));
+    float lightViewCos = horizontalLength > 1e-4f ? dot(direction.xz, sun.xz) / horizontalLength : 1.0f;
+    float3 luminance = SkyViewLut.SampleLevel(LinearClampSampler, GetSkyViewLutUv(r, direction.y, lightViewCos), 0.0f).rgb;
+
+    // The disk, dimmed by the air in front of it and softened at its rim.
+    float sunCos = dot(direction, sun);
+    float disk = smoothstep(SunDiskCosine - (1.0f - SunDiskCosine), SunDiskCosine, sunCos);
+    if (disk > 0.0f)
+    {
+        luminance += disk * SunDiskLuminance * SampleSkyTransmittance(TransmittanceLut, LinearClampSampler, r, direction.y);
+    }
+
+    return float4(luminance * SunIlluminance, 1.0f);
 }
@@ -0,0 +1,129 @@
+// Earth-like atmosphere FSkyAtmosphere in Source/Render/SkyAtmosphere.h renders, in kilometers,
+// after Hillaire, "A Scalable and Production Ready Sky and Atmosphere Rendering Technique" (2020),
+// and the parameterization of its transmittance LUT, which deferred lighting shares to tint the
+// sun by the air in front of it.
+
+#ifndef SKY_ATMOSPHERE_COMMON_HLSL
+#define SKY_ATMOSPHERE_COMMON_HLSL
+
+// LUT sizes of FSkyAtmosphere.
+#define TRANSMITTANCE_LUT_WIDTH 256
+#define TRANSMITTANCE_LUT_HEIGHT 64
+#define MULTI_SCATTERING_LUT_SIZE 32
+#define SKY_VIEW_LUT_WIDTH 192
+#define SKY_VIEW_LUT_HEIGHT 108
+
+static const float GroundRadius = 6360.0f;
+static const float AtmosphereRadius = 6460.0f;
+// Altitude the sky-view LUT sees the sky from, so one LUT serves every camera position.
+static const float ObserverAltitude = 0.2f;
+// Scene units are meters.
+static const float WorldUnitsToKilometers = 0.001f;
+
+static const float3 RayleighScattering = float3(5.802f, 13.558f, 33.1f) * 1e-3f;
+static const float RayleighScaleHeight = 8.0f;
+static const float MieScattering = 3.996e-3f;
+static const float MieExtinction = 4.44e-3f;
+static const float MieScaleHeight = 1.2f;
+static const float MieAnisotropy = 0.8f;
+// Ozone absorbs without scattering, in a layer that peaks at OzoneCenterAltitude.
+static const float3 OzoneAbsorption = float3(0.650f, 1.881f, 0.085f) * 1e-3f;
+static const float OzoneCenterAltitude = 25.0f;
+static const float OzoneHalfWidth = 15.0f;
+
+struct AtmosphereSample
+{
+    float3 rayleighScattering;
+    float mieScattering;
+    float3 extinction;
+};
+
+// Both scattering media thin out exponentially with altitude, over their own scale heights.
+AtmosphereSample SampleAtmosphere(float altitude)
+{
+    float rayleighDensity = exp(-altitude / RayleighScaleHeight);
+    float mieDensity = exp(-altitude / MieScaleHeight);
+    float ozoneDensity = max(0.0f, 1.0f - abs(altitude - OzoneCenterAltitude) / OzoneHalfWidth);
+
+    AtmosphereSample result;
+    result.rayleighScattering = RayleighScattering * rayleighDensity;
+    result.mieScattering = MieScattering * mieDensity;
+    result.extinction = result.rayleighScattering + MieExtinction * mieDensity + OzoneAbsorption * ozoneDensity;
+    return result;
+}
+
+// Whether a ray from radius r whose zenith cosine is mu ends on the ground.
+bool RayHitsGround(float r, float mu)
+{
+    return mu < 0.0f && r * r * (mu * mu - 1.0f) + GroundRadius * GroundRadius >= 0.0f;
+}
+
+float DistanceToGround(float r, float mu)
+{
+    return max(0.0f, -r * mu - sqrt(max(r * r * (mu * mu - 1.0f) + GroundRadius * GroundRadius, 0.0f)));
+}
+
+float DistanceToAtmosphereTop(float r, float mu)
+{
+    return max(0.0f, -r * mu + sqrt(max(r * r * (mu * mu - 1.0f) + AtmosphereRadius * AtmosphereRadius, 0.0f)));
+}
+
+// A texel's center lies half a texel inside [0, 1], so the LUT edges hold the range's ends.
+float FromUnitToSubUv(float u, float size)
+{
+    return u * (size - 1.0f) / size + 0.5f / size;
+}
+
+float FromSubUvToUnit(float u, float size)
+{
+    return (u - 0.5f / size) * size / (size - 1.0f);
+}
+
+// Bruneton's mapping: v by the height above ground, u by the distance to the atmosphere's top
+// between its nearest and the horizon's, which spends the texels where transmittance changes.
+float2 GetTransmittanceLutUv(float r, float mu)
+{
+    float horizonRange = sqrt(AtmosphereRadius * AtmosphereRadius - GroundRadius * GroundRadius);
+    float rho = sqrt(max(r * r - GroundRadius * GroundRadius, 0.0f));
+    float distance = DistanceToAtmosphereTop(r, mu);
+    float minDistance = AtmosphereRadius - r;
+    float maxDistance = rho + horizonRange;
+    float x = (distance - minDistance) / max(maxDistance - minDistance, 1e-4f);
+    float y = rho / horizonRange;
+    return float2(FromUnitToSubUv(x, TRANSMITTANCE_LUT_WIDTH), FromUnitToSubUv(y, TRANSMITTANCE_LUT_HEIGHT));
+}
+
+void GetTransmittanceLutParameters(float2 uv, out float r, out float mu)
+{
+    float x = FromSubUvToUnit(uv.x, TRANSMITTANCE_LUT_WIDTH);
+    float y = FromSubUvToUnit(uv.y, TRANSMITTANCE_LUT_HEIGHT);
+
+    float horizonRange = sqrt(AtmosphereRadius * AtmosphereRadius - GroundRadius * GroundRadius);
+    float rho = horizonRange * y;
+    r = sqrt(rho * rho + GroundRadius * GroundRadius);
+
+    float minDistance = AtmosphereRadius - r;
+    float maxDistance = rho + horizonRange;
+    float distance = minDistance + x * (maxDistance - minDistance);
+    mu = distance <= 0.0f ? 1.0f : (horizonRange * horizonRange - rho * rho - distance * distance) / (2.0f * r * distance);
+    mu = clamp(mu, -1.0f, 1.0f);
+}
+
+// Share of sunlight that reaches radius r from a sun whose zenith cosine is mu; none once the
+// ground is in the way.
+float3 SampleSkyTransmittance(Texture2D<float4> transmittanceLut, SamplerState linearSampler, float r, float mu)
+{
+    if (RayHitsGround(r, mu))
+    {
+        return 0.0f;
+    }
+    return transmittanceLut.SampleLevel(linearSampler, GetTransmittanceLutUv(r, mu), 0.0f).rgb;
+}
+
+// Radius of a world position, seen from ObserverAltitude like the sky is.
+float GetAtmosphereRadius(float3 worldPosition)
+{
+    return GroundRadius + ObserverAltitude + max(worldPosition.y, 0.0f) * WorldUnitsToKilometers;
+}
+
+#endif
@@ -0,0 +1,34 @@
+// Real L2 spherical harmonics, in the order of the nine float4 coefficients
+// FEnvironmentLighting in Source/Render/EnvironmentLighting.h produces: band 0, then band 1 as
+// (y, z, x), then band 2 as (xy, yz, 3z^2 - 1, xz, x^2 - y^2).
+
+#define SH_COEFFICIENT_COUNT 9
+
+void EvaluateSHBasis(float3 n, out float basis[SH_COEFFICIENT_COUNT])
+{
+    basis[0] = 0.282095f;
+    basis[1] = 0.488603f * n.y;
+    basis[2] = 0.488603f * n.z;
+    basis[3] = 0.488603f * n.x;
+    basis[4] = 1.092548f * n.x * n.y;
+    basis[5] = 1.092548f * n.y * n.z;
+    basis[6] = 0.315392f * (3.0f * n.z * n.z - 1.0f);
+    basis[7] = 1.092548f * n.x * n.z;
+    basis[8] = 0.546274f * (n.x * n.x - n.y * n.y);
+}
+
+// Cosine-weighted mean radiance around the unit normal n. The coefficients already hold the
+// clamped cosine lobe divided by PI, so this scales by albedo like the old lowest-mip fetch did.
+float3 EvaluateIrradianceSH(float4 coefficients[SH_COEFFICIENT_COUNT], float3 n)
+{
+    float basis[SH_COEFFICIENT_COUNT];
+    EvaluateSHBasis(n, basis);
+
+    float3 irradiance = 0.0f;
+    [unroll]
+    for (uint i = 0; i < SH_COEFFICIENT_COUNT; ++i)
+    {
+        irradiance += coefficients[i].rgb * basis[i];
+    }
+    return max(irradiance, 0.0f);
+}
@@ -1,12 +1,26 @@
+// Resolves the jittered frame into the output-resolution history. The scene may render to only
+// the top left InputSize pixels of CurrentTexture, which is allocated at the output size; each
+// output pixel then reads the current frame where its center landed under this frame's jitter,
+// so the history accumulates the input's sub-pixel positions at the output resolution.
+// History is fetched where the pixel's surface was the previous frame, from the velocity the base
+// pass wrote; the sky, which the base pass never covers, moves with the camera alone.
 Texture2D<float4> CurrentTexture : register(t0);
 Texture2D<float4> HistoryTexture : register(t1);
+Texture2D<float2> VelocityTexture : register(t2);
+Texture2D<float> DepthTexture : register(t3);
 RWTexture2D<float4> OutputTexture : register(u0);
+SamplerState LinearSampler : register(s0);
 
 cbuffer TemporalAAConstants : register(b0)
 {
     uint2 OutputSize;
     float HistoryWeight;
     uint UseHistory;
+    uint2 InputSize;
+    // Offset of this frame's projection in input pixels, y up as in clip space.
+    float2 Jitter;
+    // This frame's unjittered clip space to the previous frame's, for pixels without velocity.
+    row_major float4x4 ClipToPrevClip;
 };
 
 [numthreads(8, 8, 1)]
@@ -18,7 +32,11 @@ void CSMain(uint3 DispatchThreadId : SV_DispatchThreadID)
     }
 
     const int2 Pixel = int2(DispatchThreadId.xy);
-    float4 Current = CurrentTexture.Load(int3(Pixel, 0));
+    const float2 InputScale = float2(InputSize) / float2(OutputSize);
+    float2 InputPosition = (float2(Pixel) + 0.5f) * InputScale + float2(Jitter.x, -Jitter.y);
+    InputPosition = clamp(InputPosition, 0.5f, float2(InputSize) - 0.5f);
+
+    float4 Current = CurrentTexture.SampleLevel(LinearSampler, InputPosition / float2(OutputSize), 0.0f);
 
     if (UseHistory == 0)
     {
@@ -29,20 +47,54 @@ void CSMain(uint3 DispatchThreadId : SV_DispatchThreadID)
     float3 MinColor = Current.rgb;
     float3 MaxColor = Current.rgb;
 
+    // Motion comes from the nearest surface of the neighbourhood, so the edges of a moving object
+    // follow the object instead of the background behind it. Depth is reversed: larger is nearer.
+    const int2 InputPixel = int2(InputPosition);
+    int2 NearestCoord = clamp(InputPixel, int2(0, 0), int2(InputSize) - 1);
+    float NearestDepth = 0.0f;
     [unroll]
     for (int OffsetY = -1; OffsetY <= 1; ++OffsetY)
     {
         [unroll]
         for (int OffsetX = -1; OffsetX <= 1; ++OffsetX)
         {
-            int2 SampleCoord = clamp(Pixel + int2(OffsetX, OffsetY), int2(0, 0), int2(OutputSize) - 1);
+            int2 SampleCoord = clamp(InputPixel + int2(OffsetX, OffsetY), int2(0, 0), int2(InputSize) - 1);
             float3 SampleColor = CurrentTexture.Load(int3(SampleCoord, 0)).rgb;
             MinColor = min(MinColor, SampleColor);
             MaxColor = max(MaxColor, SampleColor);
+
+            float SampleDepth = DepthTexture.Load(int3(SampleCoord, 0));
+            if (SampleDepth > NearestDepth)
+            {
+                NearestDepth = SampleDepth;
+                NearestCoord = SampleCoord;
+            }
         }
     }
 
-    float3 History = HistoryTexture.Load(int3(Pixel, 0)).rgb;
+    const float2 OutputUV = (float2(Pixel) + 0.5f) / float2(OutputSize);
+    float2 Velocity;
+    if (NearestDepth > 0.0f)
+    {
+        Velocity = VelocityTexture.Load(int3(NearestCoord, 0));
+    }
+    else
+    {
+        // Cleared depth is the plane at infinity, which only the camera's rotation moves.
+        float2 Ndc = float2(OutputUV.x * 2.0f - 1.0f, 1.0f - OutputUV.y * 2.0f);
+        float4 PrevClip = mul(float4(Ndc, 0.0f, 1.0f), ClipToPrevClip);
+        Velocity = (PrevClip.xy / max(PrevClip.w, 1e-5f) - Ndc) * float2(0.5f, -0.5f);
+    }
+
+    // Surfaces that were off screen have no history to reproject.
+    const float2 HistoryUV = OutputUV + Velocity;
+    if (any(HistoryUV < 0.0f) || any(HistoryUV > 1.0f))
+    {
+        OutputTexture[Pixel] = Current;
+        return;
+    }
+
+    float3 History = HistoryTexture.SampleLevel(LinearSampler, HistoryUV, 0.0f).rgb;
     History = clamp(History, MinColor, MaxColor);
 
     float3 Blended = lerp(Current.rgb, History, saturate(HistoryWeight));
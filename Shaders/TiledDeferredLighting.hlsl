@@ -0,0 +1,113 @@
+// Compute path of the deferred lighting pass. ClassifyTiles sorts the screen's 8x8 tiles by the
+// work their pixels need and appends each to its class's tile list and dispatch arguments; sky-only
+// tiles join no list. LightTiles then runs once per class through ExecuteIndirect, compiled with
+// TILE_CLASS so shadowed tiles alone pay for the shadow lookup and simple tiles for nothing more
+// than a rough dielectric needs. Adds to the emissive color the base pass left in the target, as
+// the fullscreen pass's blend does.
+
+#include "DeferredLightingCommon.hlsl"
+
+#define TILE_SIZE 8
+
+// ETiledLightingClass in Source/Render/DeferredRenderer.h.
+#define TILE_CLASS_SHADOWED 0
+#define TILE_CLASS_UNSHADOWED 1
+#define TILE_CLASS_SIMPLE 2
+#define TILE_CLASS_COUNT 3
+
+#ifndef TILE_CLASS
+#define TILE_CLASS TILE_CLASS_SHADOWED
+#endif
+
+cbuffer TileConstants : register(b2)
+{
+    // Capacity of each class's list, the screen's tile count.
+    uint TileListCapacity;
+};
+
+// One D3D12_DISPATCH_ARGUMENTS per class; its group count is the class's tile count.
+RWByteAddressBuffer TileDispatchArgs : register(u0);
+// TileListCapacity entries per class, each a tile's x | y << 16.
+RWStructuredBuffer<uint> TileListsOutput : register(u1);
+StructuredBuffer<uint> TileLists : register(t9);
+RWTexture2D<float4> LightingOutput : register(u2);
+
+#define TILE_FLAG_GEOMETRY 0x1
+#define TILE_FLAG_SHADOW   0x2
+#define TILE_FLAG_COMPLEX  0x4
+
+groupshared uint SharedTileFlags;
+
+[numthreads(TILE_CLASS_COUNT, 1, 1)]
+void ResetTileClasses(uint index : SV_DispatchThreadID)
+{
+    TileDispatchArgs.Store3(index * 12, uint3(0, 1, 1));
+}
+
+[numthreads(TILE_SIZE, TILE_SIZE, 1)]
+void ClassifyTiles(uint3 dispatchId : SV_DispatchThreadID, uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    if (groupIndex == 0)
+    {
+        SharedTileFlags = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    // Loads past the screen's edge return zero, which reads as sky.
+    float depth = SceneDepth.Load(int3(dispatchId.xy, 0));
+    uint flags = 0;
+    if (IsGeometryPixel(depth))
+    {
+        flags |= TILE_FLAG_GEOMETRY;
+        float3 normal = DecodeGBufferNormal(GBufferA.Load(int3(dispatchId.xy, 0)).xy);
+        if (NeedsShadowLookup(normal, GetViewDepth(depth)))
+        {
+            flags |= TILE_FLAG_SHADOW;
+        }
+
+        float2 metallicRoughness = GBufferB.Load(int3(dispatchId.xy, 0)).yz;
+        if (!IsSimpleMaterial(metallicRoughness.x, metallicRoughness.y))
+        {
+            flags |= TILE_FLAG_COMPLEX;
+        }
+    }
+    InterlockedOr(SharedTileFlags, flags);
+    GroupMemoryBarrierWithGroupSync();
+
+    uint tileFlags = SharedTileFlags;
+    if (groupIndex != 0 || (tileFlags & TILE_FLAG_GEOMETRY) == 0)
+    {
+        return;
+    }
+
+    uint tileClass = TILE_CLASS_SIMPLE;
+    if (tileFlags & TILE_FLAG_SHADOW)
+    {
+        tileClass = TILE_CLASS_SHADOWED;
+    }
+    else if (tileFlags & TILE_FLAG_COMPLEX)
+    {
+        tileClass = TILE_CLASS_UNSHADOWED;
+    }
+
+    uint slot = 0;
+    TileDispatchArgs.InterlockedAdd(tileClass * 12, 1, slot);
+    TileListsOutput[tileClass * TileListCapacity + slot] = groupId.x | (groupId.y << 16);
+}
+
+[numthreads(TILE_SIZE, TILE_SIZE, 1)]
+void LightTiles(uint3 groupId : SV_GroupID, uint3 groupThreadId : SV_GroupThreadID)
+{
+    uint tile = TileLists[TILE_CLASS * TileListCapacity + groupId.x];
+    uint2 pixel = uint2(tile & 0xffff, tile >> 16) * TILE_SIZE + groupThreadId.xy;
+
+    // Sky pixels of geometry tiles are left to the sky pass, as are pixels past the screen's edge.
+    float depth = SceneDepth.Load(int3(pixel, 0));
+    if (!IsGeometryPixel(depth))
+    {
+        return;
+    }
+
+    float3 color = EvaluateDeferredLighting(pixel, depth, TILE_CLASS == TILE_CLASS_SHADOWED, TILE_CLASS == TILE_CLASS_SIMPLE);
+    LightingOutput[pixel] += float4(color, 1.0f);
+}
@@ -1,3 +1,5 @@
+#include "TonemapCommon.hlsl"
+
 struct VSOutput
 {
     float4 Position : SV_Position;
@@ -31,29 +33,6 @@ Texture2D HDRScene : register(t0);
 Texture2D LogAverageLuminance : register(t1);
 SamplerState SceneSampler : register(s0);
 
-float3 PBRNeutralToneMapping(float3 color)
-{
-    const float startCompression = 0.8f - 0.04f;
-    const float desaturation = 0.15f;
-
-    float x = min(color.r, min(color.g, color.b));
-    float offset = x < 0.08f ? x - 6.25f * x * x : 0.04f;
-    color -= offset;
-
-    float peak = max(color.r, max(color.g, color.b));
-    if (peak < startCompression)
-    {
-        return color;
-    }
-
-    const float d = 1.0f - startCompression;
-    float newPeak = 1.0f - d * d / (peak + d - startCompression);
-    color *= newPeak / max(peak, 1e-4f);
-
-    float g = 1.0f - 1.0f / (desaturation * (peak - newPeak) + 1.0f);
-    return lerp(color, newPeak * float3(1.0f, 1.0f, 1.0f), g);
-}
-
 float4 PSMain(VSOutput Input) : SV_Target
 {
     float3 hdrColor = HDRScene.Sample(SceneSampler, Input.UV).rgb;
@@ -63,17 +42,7 @@ float4 PSMain(VSOutput Input) : SV_Target
     {
         float exposureEv = LogAverageLuminance.Load(int3(0, 0, 0)).r;
         finalExposure *= exp2(exposureEv);
-	}
-
-	float3 color = hdrColor * finalExposure;
-    
-    if (EnableTonemap != 0)
-    {
-        color = PBRNeutralToneMapping(color);
     }
 
-	color = saturate(color);
-
-    color = pow(color, 1.0f / max(Gamma, 1e-3f));
-    return float4(color, 1.0f);
+    return float4(TonemapColor(hdrColor, finalExposure, EnableTonemap != 0, Gamma), 1.0f);
 }
@@ -0,0 +1,43 @@
+// Exposure, tonemap curve and gamma of Shaders/Tonemap.hlsl, shared with the fused post kernel in
+// Shaders/FusedPost.hlsl.
+
+#ifndef TONEMAP_COMMON_HLSL
+#define TONEMAP_COMMON_HLSL
+
+float3 PBRNeutralToneMapping(float3 color)
+{
+    const float startCompression = 0.8f - 0.04f;
+    const float desaturation = 0.15f;
+
+    float x = min(color.r, min(color.g, color.b));
+    float offset = x < 0.08f ? x - 6.25f * x * x : 0.04f;
+    color -= offset;
+
+    float peak = max(color.r, max(color.g, color.b));
+    if (peak < startCompression)
+    {
+        return color;
+    }
+
+    const float d = 1.0f - startCompression;
+    float newPeak = 1.0f - d * d / (peak + d - startCompression);
+    color *= newPeak / max(peak, 1e-4f);
+
+    float g = 1.0f - 1.0f / (desaturation * (peak - newPeak) + 1.0f);
+    return lerp(color, newPeak * float3(1.0f, 1.0f, 1.0f), g);
+}
+
+float3 TonemapColor(float3 hdrColor, float exposure, bool bTonemap, float gamma)
+{
+    float3 color = hdrColor * exposure;
+
+    if (bTonemap)
+    {
+        color = PBRNeutralToneMapping(color);
+    }
+
+    color = saturate(color);
+    return pow(color, 1.0f / max(gamma, 1e-3f));
+}
+
+#endif
@@ -1,9 +1,12 @@
 #include "Application.h"
+#include "Benchmark.h"
+#include "CpuProfiler.h"
 #include "Window.h"
 #include "EngineTime.h"
 #include "ImGuiSupport.h"
 #include "Logger.h"
 #include "GpuDebugMarkers.h"
+#include "RenderThread.h"
 #include "TaskSystem.h"
 #include "../RHI/DX12Device.h"
 #include "../RHI/DX12SwapChain.h"
@@ -14,6 +17,8 @@
 #include "../Render/ForwardRenderer.h"
 #include "../Render/RenderGraph.h"
 #include "../Render/RendererUtils.h"
+#include "../Render/ShaderCompiler.h"
+#include "../Render/ShaderHotReload.h"
 #include "../Scene/Camera.h"
 #include "../Scene/SceneJsonLoader.h"
 #include "RendererConfig.h"
@@ -30,6 +35,9 @@
 #include <array>
 #include <chrono>
 #include <cwchar>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
 
 extern "C"
 {
@@ -45,7 +53,30 @@ namespace
         return std::string(Utf8.begin(), Utf8.end());
     }
 
+    // Captures/<Prefix>_YYYYMMDD_HHMMSS, so repeated captures never overwrite each other.
+    std::string BuildCaptureStem(const char* Prefix)
+    {
+        const std::time_t Now = std::time(nullptr);
+        std::tm LocalTime = {};
+        localtime_s(&LocalTime, &Now);
+
+        std::ostringstream Stream;
+        Stream << "Captures/" << Prefix << "_" << std::put_time(&LocalTime, "%Y%m%d_%H%M%S");
+        return Stream.str();
+    }
+
 #if WITH_IMGUI
+    // Stable per-name colour, so a zone keeps its colour from frame to frame.
+    ImU32 GetCpuZoneColor(const char* Name)
+    {
+        uint32_t Hash = 2166136261u;
+        for (const char* Character = Name; *Character; ++Character)
+        {
+            Hash = (Hash ^ static_cast<uint8_t>(*Character)) * 16777619u;
+        }
+        return ImColor::HSV(static_cast<float>(Hash % 360u) / 360.0f, 0.55f, 0.75f);
+    }
+
     ImVec2 ProjectAxisToScreen(const DirectX::XMVECTOR& ViewSpaceDir, float Scale)
     {
         const float X = DirectX::XMVectorGetX(ViewSpaceDir);
@@ -132,6 +163,10 @@ FApplication::FApplication()
 FApplication::~FApplication()
 {
     LogInfo("Application shutdown started");
+    if (RenderThread)
+    {
+        RenderThread->Stop();
+    }
     ShutdownImGui();
 
     if (Device)
@@ -139,19 +174,37 @@ FApplication::~FApplication()
         Device->GetGraphicsQueue()->Flush();
     }
 
+    // The watcher may still be recompiling on a worker.
+    ShaderHotReload.reset();
+
     // Shutdown task system
     FTaskScheduler::Get().Shutdown();
 
     LogInfo("Application shutdown complete");
 }
 
-bool FApplication::Initialize(HINSTANCE InstanceHandle)
+bool FApplication::Initialize(HINSTANCE InstanceHandle, const std::wstring& CommandLine)
 {
     LogInfo("Application initialization started");
+    CPU_PROFILE_THREAD_NAME("Main");
 
     const std::filesystem::path ConfigPath = std::filesystem::current_path() / "bin/RendererConfig.ini";
     RendererConfig = FRendererConfigLoader::LoadOrDefault(ConfigPath);
+    if (!CommandLine.empty())
+    {
+        FRendererConfigLoader::ApplyCommandLine(CommandLine, RendererConfig);
+    }
+
+    if (RendererConfig.bBenchmark)
+    {
+        // Every pass is timed, and nothing may change the resolution or the shaders mid-run.
+        RendererConfig.bEnableGpuTiming = true;
+        RendererConfig.bEnableDynamicResolution = false;
+        RendererConfig.bEnableShaderHotReload = false;
+    }
+    FCpuProfiler::SetEnabled(RendererConfig.bEnableCpuProfiler);
     bTaskSystemEnabled = RendererConfig.bEnableTaskSystem;
+    RenderThread = std::make_unique<FRenderThread>();
     bFrameOverlapEnabled = RendererConfig.bEnableFrameOverlap;
     bDepthPrepassEnabled = RendererConfig.bUseDepthPrepass;
     bShadowsEnabled = RendererConfig.bEnableShadows;
@@ -171,6 +224,9 @@ bool FApplication::Initialize(HINSTANCE InstanceHandle)
     AutoExposureSpeedDown = RendererConfig.AutoExposureSpeedDown;
     bTaaEnabled = RendererConfig.bEnableTAA;
     TaaHistoryWeight = RendererConfig.TaaHistoryWeight;
+    DynamicResolution.SetTargetFrameTime(RendererConfig.DynamicResolutionTargetMs);
+    DynamicResolution.SetMinScale(RendererConfig.DynamicResolutionMinScale);
+    DynamicResolution.SetEnabled(RendererConfig.bEnableDynamicResolution);
 
     if (bTaskSystemEnabled)
     {
@@ -186,6 +242,7 @@ bool FApplication::Initialize(HINSTANCE InstanceHandle)
     const int32_t WindowHeight = static_cast<int32_t>(RendererConfig.WindowHeight);
 
     MainWindow = std::make_unique<FWindow>();
+    FDX12MemoryTracker::Get().ApplyCategoryBudgets(RendererConfig.GpuMemoryBudgets);
     Device = std::make_unique<FDX12Device>();
     SwapChain = std::make_unique<FDX12SwapChain>();
     CommandContext = std::make_unique<FDX12CommandContext>();
@@ -199,6 +256,7 @@ bool FApplication::Initialize(HINSTANCE InstanceHandle)
     FRendererOptions RendererOptions{};
     RendererOptions.SceneFilePath = RendererConfig.SceneFile;
     RendererOptions.bUseDepthPrepass = RendererConfig.bUseDepthPrepass;
+    RendererOptions.MaskedDepthPrepassThreshold = RendererConfig.MaskedDepthPrepassThreshold;
     RendererOptions.bEnableShadows = bShadowsEnabled;
     RendererOptions.ShadowBias = ShadowBias;
     RendererOptions.bEnableTonemap = bTonemapEnabled;
@@ -219,8 +277,25 @@ bool FApplication::Initialize(HINSTANCE InstanceHandle)
     RendererOptions.bLogResourceBarriers = RendererConfig.bLogResourceBarriers;
     RendererOptions.bEnableGraphDump = RendererConfig.bEnableGraphDump;
     RendererOptions.bEnableGpuTiming = RendererConfig.bEnableGpuTiming;
+    RendererOptions.bEnablePipelineStatistics = RendererConfig.bEnablePipelineStatistics;
+    RendererOptions.bEnableParallelRecording = RendererConfig.bEnableParallelRecording;
     RendererOptions.bEnableGpuDebugPrint = bGpuDebugPrintEnabled;
     RendererOptions.bEnableIndirectDraw = bIndirectDrawEnabled;
+    RendererOptions.bEnableBindless = RendererConfig.bEnableBindless;
+    RendererOptions.bOptimizeMeshes = RendererConfig.bOptimizeMeshes;
+    RendererOptions.bEnableMeshShaders = RendererConfig.bEnableMeshShaders;
+    RendererOptions.bEnableTiledLighting = RendererConfig.bEnableTiledLighting;
+    RendererOptions.bEnableFusedPost = RendererConfig.bEnableFusedPost;
+    RendererOptions.ShadingRateQuality = RendererConfig.ShadingRateQuality;
+    RendererOptions.bShowShadingRate = RendererConfig.bShowShadingRate;
+    RendererOptions.bGenerateLods = RendererConfig.bGenerateLods;
+    RendererOptions.LodBias = RendererConfig.LodBias;
+    RendererOptions.MinScreenCoverage = RendererConfig.MinScreenCoverage;
+    RendererOptions.ShadowMinScreenCoverage = RendererConfig.ShadowMinScreenCoverage;
+    RendererOptions.bStreamSceneTextures = RendererConfig.bStreamSceneTextures;
+    RendererOptions.bStreamTextureMips = RendererConfig.bStreamTextureMips;
+    RendererOptions.TextureStreamingBudgetMB = RendererConfig.TextureStreamingBudgetMB;
+    RendererOptions.TextureCacheBudgetMB = RendererConfig.TextureCacheBudgetMB;
 
     const std::wstring SceneFilePath = RendererOptions.SceneFilePath.empty() ? L"Assets/Scenes/Scene.json" : RendererOptions.SceneFilePath;
     RendererOptions.SceneFilePath = SceneFilePath;
@@ -259,7 +334,7 @@ bool FApplication::Initialize(HINSTANCE InstanceHandle)
     const uint32 SwapChainBufferCount = (std::max)(2u, RendererConfig.FramesInFlight);
 
     LogInfo("Initializing swap chain...");
-    if (!SwapChain->Initialize(Device.get(), MainWindow->GetHWND(), WindowWidth, WindowHeight, SwapChainBufferCount))
+    if (!SwapChain->Initialize(Device.get(), MainWindow->GetHWND(), WindowWidth, WindowHeight, SwapChainBufferCount, RendererConfig.MaxFrameLatency))
     {
         LogError("Failed to initialize swap chain");
         return false;
@@ -272,6 +347,20 @@ bool FApplication::Initialize(HINSTANCE InstanceHandle)
         return false;
     }
 
+    if (RendererConfig.bEnableAsyncCompute && Device->GetComputeQueue())
+    {
+        AsyncComputeContext = std::make_unique<FDX12CommandContext>();
+        if (AsyncComputeContext->Initialize(Device.get(), Device->GetComputeQueue(), SwapChain->GetBackBufferCount(), EDX12QueueType::Compute))
+        {
+            CommandContext->SetAsyncComputeContext(AsyncComputeContext.get());
+        }
+        else
+        {
+            LogWarning("Failed to initialize async compute context");
+            AsyncComputeContext.reset();
+        }
+    }
+
     RendererOptions.FramesInFlight = SwapChain->GetBackBufferCount();
 
     Camera->SetPerspective(DirectX::XM_PIDIV4, static_cast<float>(WindowWidth) / static_cast<float>(WindowHeight), 0.1f, 1000.0f);
@@ -315,8 +404,39 @@ bool FApplication::Initialize(HINSTANCE InstanceHandle)
         return false;
     }
 
+    // Persist the startup pipelines now rather than only at exit, so a crash still leaves a warm cache.
+    Device->GetPipelineCache()->Save();
+    FShaderCompiler::LogCacheStatistics();
+
+    if (RendererConfig.bEnableShaderHotReload)
+    {
+        ShaderHotReload = std::make_unique<FShaderHotReload>();
+        ShaderHotReload->Initialize(L"Shaders");
+    }
+
     UpdateRendererLighting();
-    ApplySceneCameraFromJson(RendererConfig.SceneFile);
+    QueueSceneCamera(RendererConfig.SceneFile);
+
+    if (RendererConfig.bBenchmark)
+    {
+        std::vector<FSceneCameraKeyframe> CameraPath;
+        if (!FSceneJsonLoader::LoadSceneCameraPath(SceneFilePath, CameraPath))
+        {
+            LogWarning("Scene has no camera_path; benchmarking from the scene camera");
+        }
+
+        FBenchmarkSettings Settings;
+        Settings.ScenePath = SceneFilePath;
+        Settings.RendererName = ActiveRenderer == DeferredRenderer.get() ? "Deferred" : "Forward";
+        Settings.Width = static_cast<uint32_t>(WindowWidth);
+        Settings.Height = static_cast<uint32_t>(WindowHeight);
+        Settings.WarmupFrames = RendererConfig.BenchmarkWarmupFrames;
+        Settings.FrameCount = RendererConfig.BenchmarkFrames;
+        Settings.OutputPath = RendererConfig.BenchmarkOutput;
+
+        Benchmark = std::make_unique<FBenchmarkRunner>();
+        Benchmark->Initialize(Settings, std::move(CameraPath));
+    }
 
     if (!InitializeImGui(WindowWidth, WindowHeight))
     {
@@ -324,6 +444,16 @@ bool FApplication::Initialize(HINSTANCE InstanceHandle)
         return false;
     }
 
+    // One snapshot may wait while the render thread records the previous frame and the GPU works
+    // through the rest, so the game thread stays within FramesInFlight of the GPU.
+    RenderThread->Start(
+        [this](const FFrameSnapshot& Snapshot)
+        {
+            return RenderFrame(Snapshot);
+        },
+        SwapChain->GetBackBufferCount() - 1,
+        RendererConfig.bEnableRenderThread);
+
     bIsRunning = true;
     LogInfo("Application initialization complete");
     return true;
@@ -335,6 +465,14 @@ int32_t FApplication::Run()
 
     while (bIsRunning)
     {
+        // Waiting before the message pump samples input as late as the queued presents allow;
+        // benchmarks read no input and measure throughput instead.
+        if (!Benchmark && SwapChain->HasFrameLatencyWaitable())
+        {
+            CPU_PROFILE_SCOPE("WaitForFrameLatency");
+            SwapChain->WaitForFrameLatency();
+        }
+
         if (!MainWindow->ProcessMessages())
         {
             LogInfo("Detected window message loop exit");
@@ -342,18 +480,63 @@ int32_t FApplication::Run()
             break;
         }
 
-        bIsRunning = RenderFrame();
+        CPU_PROFILE_FRAME();
+
+        FFrameSnapshot Snapshot;
+        UpdateFrame(Snapshot);
+
+        // Fails once the render thread has stopped, which it does when a benchmark completes.
+        bIsRunning = RenderThread->Submit(std::move(Snapshot));
     }
 
     LogInfo("Main loop ended");
+    RenderThread->Stop();
+
+    if (Benchmark)
+    {
+        Device->GetGraphicsQueue()->Flush();
+        return Benchmark->WriteReport();
+    }
     return 0;
 }
 
-bool FApplication::RenderFrame()
+void FApplication::UpdateFrame(FFrameSnapshot& OutSnapshot)
+{
+    CPU_PROFILE_SCOPE("UpdateFrame");
+
+    RenderThread->ExecuteGameThreadTasks();
+
+    Time->Tick();
+    const float DeltaSeconds = static_cast<float>(Time->GetDeltaTimeSeconds());
+
+    OutSnapshot.InputSampleTime = std::chrono::steady_clock::now();
+
+    // Benchmark cameras follow the path on the render thread instead of the input.
+    if (!Benchmark)
+    {
+        HandleCameraInput(DeltaSeconds, OutSnapshot);
+    }
+
+    OutSnapshot.FrameNumber = ++GameFrameNumber;
+    OutSnapshot.DeltaSeconds = DeltaSeconds;
+    OutSnapshot.Fps = static_cast<float>(Time->GetFPS());
+    OutSnapshot.Camera = *Camera;
+    OutSnapshot.ScenePathToLoad = std::move(SelectedScenePath);
+    SelectedScenePath.clear();
+}
+
+bool FApplication::RenderFrame(const FFrameSnapshot& Snapshot)
 {
-    static uint64 FrameIndex = 0;
-    ++FrameIndex;
-    LogVerbose("Frame start: " + std::to_string(FrameIndex));
+    CPU_PROFILE_SCOPE("RenderFrame");
+
+    const uint64 FrameIndex = Snapshot.FrameNumber;
+    LogVerbose("Frame start: ", FrameIndex);
+
+    RenderSnapshot = Snapshot;
+    if (!Snapshot.ScenePathToLoad.empty())
+    {
+        PendingScenePath = Snapshot.ScenePathToLoad;
+    }
 
     // Check if async scene load is complete (atomic read)
     if (bAsyncSceneLoadComplete.load(std::memory_order_acquire))
@@ -361,6 +544,11 @@ bool FApplication::RenderFrame()
         CompleteAsyncSceneReload();
     }
 
+    if (ShaderHotReload)
+    {
+        ShaderHotReload->Tick(Device.get(), ActiveRenderer);
+    }
+
     if (!PendingScenePath.empty())
     {
         const std::wstring SceneToLoad = std::move(PendingScenePath);
@@ -370,10 +558,22 @@ bool FApplication::RenderFrame()
         StartAsyncSceneReload(SceneToLoad);
     }
 
-    Time->Tick();
-    const float DeltaSeconds = static_cast<float>(Time->GetDeltaTimeSeconds());
+    const auto FrameStartTime = std::chrono::steady_clock::now();
+    const uint32 BenchmarkFrame = Benchmark ? Benchmark->BeginFrame() : 0;
 
-    HandleCameraInput(DeltaSeconds);
+    const float DeltaSeconds = Benchmark ?
+        static_cast<float>(FBenchmarkRunner::FixedDeltaSeconds) :
+        Snapshot.DeltaSeconds;
+
+    if (Benchmark)
+    {
+        ApplyBenchmarkCamera(RenderSnapshot.Camera);
+    }
+
+    if (Snapshot.bSelectionClick)
+    {
+        UpdateSelectionFromClick(RenderSnapshot.Camera, Snapshot.SelectionClickX, Snapshot.SelectionClickY);
+    }
 
     const uint32 BackBufferIndex = SwapChain->GetCurrentBackBufferIndex();
     ID3D12Resource* BackBuffer = SwapChain->GetBackBuffer(BackBufferIndex);
@@ -381,7 +581,9 @@ bool FApplication::RenderFrame()
 
     const D3D12_RESOURCE_STATES PreviousState = SwapChain->GetBackBufferState(BackBufferIndex);
 
-    if (bGpuTimingEnabled && Device && Device->GetGraphicsQueue())
+    // Dynamic resolution reads the same frame timestamps, so they are recorded for it too.
+    const bool bFrameTimingEnabled = bGpuTimingEnabled || DynamicResolution.IsEnabled();
+    if (bFrameTimingEnabled && Device && Device->GetGraphicsQueue())
     {
         ID3D12Device* D3DDevice = Device->GetDevice();
         ID3D12CommandQueue* Queue = Device->GetGraphicsQueue()->GetD3DQueue();
@@ -391,6 +593,7 @@ bool FApplication::RenderFrame()
         if (!FrameTimingQueryHeap || !FrameTimingReadback || FrameTimingFenceValues.size() != BufferCount)
         {
             FrameTimingFenceValues.assign(BufferCount, 0);
+            FrameTimingBenchmarkFrames.assign(BufferCount, 0);
 
             D3D12_QUERY_HEAP_DESC HeapDesc = {};
             HeapDesc.Count = QueryCount;
@@ -412,7 +615,8 @@ bool FApplication::RenderFrame()
             BufferDesc.SampleDesc.Count = 1;
             BufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
 
-            HR_CHECK(D3DDevice->CreateCommittedResource(
+            HR_CHECK(Device->CreateCommittedResource(
+                EGpuMemoryCategory::Readback,
                 &HeapProps,
                 D3D12_HEAP_FLAG_NONE,
                 &BufferDesc,
@@ -431,6 +635,11 @@ bool FApplication::RenderFrame()
         if (FrameTimingReadback && FrameTimingFrequency > 0 && BackBufferIndex < FrameTimingFenceValues.size())
         {
             const uint64 FenceValue = FrameTimingFenceValues[BackBufferIndex];
+            if (Benchmark && FenceValue > 0)
+            {
+                // BeginFrame waits for this fence anyway; waiting first keeps every benchmark frame's time.
+                Device->GetGraphicsQueue()->Wait(FenceValue);
+            }
             if (FenceValue > 0 && Device->GetGraphicsQueue()->GetCompletedFenceValue() >= FenceValue)
             {
                 const UINT64 Offset = static_cast<UINT64>(BackBufferIndex * 2) * sizeof(uint64);
@@ -445,7 +654,15 @@ bool FApplication::RenderFrame()
                     {
                         const double Delta = static_cast<double>(End - Start) / static_cast<double>(FrameTimingFrequency);
                         const double Milliseconds = Delta * 1000.0;
-                        FRenderGraph::AddExternalGpuTimingSample("Frame", Milliseconds);
+                        if (bGpuTimingEnabled)
+                        {
+                            FRenderGraph::AddExternalGpuTimingSample("Frame", Milliseconds);
+                        }
+                        DynamicResolution.AddFrameTime(Milliseconds);
+                        if (Benchmark)
+                        {
+                            Benchmark->AddGpuFrameTime(FrameTimingBenchmarkFrames[BackBufferIndex], Milliseconds);
+                        }
                     }
                     FrameTimingReadback->Unmap(0, nullptr);
                 }
@@ -462,7 +679,7 @@ bool FApplication::RenderFrame()
         swprintf_s(FrameLabel, L"Frame %llu", static_cast<unsigned long long>(FrameIndex));
         FScopedPixEvent FrameEvent(CommandContext->GetCommandList(), FrameLabel);
 
-        if (bGpuTimingEnabled && FrameTimingQueryHeap && FrameTimingReadback)
+        if (bFrameTimingEnabled && FrameTimingQueryHeap && FrameTimingReadback)
         {
             const uint32 QueryIndex = BackBufferIndex * 2;
             CommandContext->GetCommandList()->EndQuery(FrameTimingQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, QueryIndex);
@@ -476,6 +693,7 @@ bool FApplication::RenderFrame()
         if (ActiveRenderer)
         {
             ActiveRenderer->SetFrameIndex(BackBufferIndex);
+            ActiveRenderer->SetOutputTarget(BackBuffer);
         }
         const D3D12_CPU_DESCRIPTOR_HANDLE* DsvHandle = ActiveRenderer ? &ActiveRenderer->GetDSVHandle() : nullptr;
 
@@ -484,7 +702,7 @@ bool FApplication::RenderFrame()
         const float ClearColor[4] = { 0.05f, 0.10f, 0.20f, 1.0f };
         CommandContext->ClearRenderTarget(RtvHandle, ClearColor);
 
-        if (ActiveRenderer && Camera)
+        if (ActiveRenderer)
         {
             if (bPendingObjectIdReadback)
             {
@@ -500,10 +718,15 @@ bool FApplication::RenderFrame()
                 ActiveRenderer->SetCullingCameraOverride(nullptr);
             }
 
-            ActiveRenderer->RenderFrame(*CommandContext, RtvHandle, *Camera, DeltaSeconds);
+            ActiveRenderer->SetResolutionScale(DynamicResolution.GetScale());
+            ActiveRenderer->RenderFrame(*CommandContext, RtvHandle, RenderSnapshot.Camera, DeltaSeconds);
         }
 
-        RenderUI();
+        if (!Benchmark)
+        {
+            CPU_PROFILE_SCOPE("RenderUI");
+            RenderUI();
+        }
 
         CommandContext->TransitionResource(
             BackBuffer,
@@ -512,7 +735,7 @@ bool FApplication::RenderFrame()
 
         FScopedPixEvent PresentEvent(CommandContext->GetCommandList(), L"Present");
 
-        if (bGpuTimingEnabled && FrameTimingQueryHeap && FrameTimingReadback)
+        if (bFrameTimingEnabled && FrameTimingQueryHeap && FrameTimingReadback)
         {
             const uint32 QueryIndex = BackBufferIndex * 2;
             CommandContext->GetCommandList()->EndQuery(FrameTimingQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, QueryIndex + 1);
@@ -558,13 +781,20 @@ bool FApplication::RenderFrame()
 
     }
 
-    LogVerbose("Preparing frame end: " + std::to_string(FrameIndex));
+    LogVerbose("Preparing frame end: ", FrameIndex);
 
     SwapChain->SetBackBufferState(BackBufferIndex, D3D12_RESOURCE_STATE_PRESENT);
 
     const UINT PresentFlags = SwapChain->AllowsTearing() ? DXGI_PRESENT_ALLOW_TEARING : 0;
-    LogVerbose("Present called (Flags: " + std::to_string(PresentFlags) + ")");
-    HR_CHECK(SwapChain->GetSwapChain()->Present(0, PresentFlags));
+    LogVerbose("Present called (Flags: ", PresentFlags, ")");
+    {
+        CPU_PROFILE_SCOPE("Present");
+        HR_CHECK(SwapChain->GetSwapChain()->Present(0, PresentFlags));
+    }
+
+    // Smoothed over about ten frames; the queued presents and scanout still follow.
+    const std::chrono::duration<double, std::milli> InputToPresent = std::chrono::steady_clock::now() - Snapshot.InputSampleTime;
+    InputToPresentMs = InputToPresentMs > 0.0 ? InputToPresentMs * 0.9 + InputToPresent.count() * 0.1 : InputToPresent.count();
 
     const uint64 FenceValue = Device->GetGraphicsQueue()->Signal();
     if (!bFrameOverlapEnabled)
@@ -572,6 +802,9 @@ bool FApplication::RenderFrame()
         Device->GetGraphicsQueue()->Wait(FenceValue);
     }
     CommandContext->SetFrameFenceValue(BackBufferIndex, FenceValue);
+    FRenderGraph::RetireFrameAllocations(CommandContext->GetCurrentFrameIndex(), FenceValue);
+    Device->GetUploadRing()->EndFrame(FenceValue);
+    Device->GetDescriptorAllocator()->EndFrame(FenceValue);
     if (ActiveRenderer)
     {
         ActiveRenderer->OnFrameFenceSignaled(BackBufferIndex, FenceValue);
@@ -579,33 +812,37 @@ bool FApplication::RenderFrame()
     if (BackBufferIndex < FrameTimingFenceValues.size())
     {
         FrameTimingFenceValues[BackBufferIndex] = FenceValue;
+        FrameTimingBenchmarkFrames[BackBufferIndex] = BenchmarkFrame;
+    }
+
+    if (Benchmark)
+    {
+        const std::chrono::duration<double, std::milli> CpuTime = std::chrono::steady_clock::now() - FrameStartTime;
+        if (ActiveRenderer)
+        {
+            Benchmark->AddGpuCullingStats(*ActiveRenderer);
+        }
+        Benchmark->EndFrame(CpuTime.count());
     }
 
-    LogVerbose("Frame completed: " + std::to_string(FrameIndex));
+    LogVerbose("Frame completed: ", FrameIndex);
 
-    return true;
+    return !(Benchmark && Benchmark->IsFinished());
 }
 
-void FApplication::HandleCameraInput(float DeltaSeconds)
+void FApplication::HandleCameraInput(float DeltaSeconds, FFrameSnapshot& OutSnapshot)
 {
     if (!Camera)
     {
         return;
     }
 
-#if WITH_IMGUI
-    if (ImGuiCtx)
+    // Published by the render thread from the last UI frame it built.
+    if (bImGuiWantsInput.load(std::memory_order_relaxed))
     {
-        ImGui::SetCurrentContext(ImGuiCtx);
-        const ImGuiIO& Io = ImGui::GetIO();
-
-        if (Io.WantCaptureMouse || Io.WantCaptureKeyboard)
-        {
-            bIsRotatingWithMouse = false;
-            return;
-        }
+        bIsRotatingWithMouse = false;
+        return;
     }
-#endif
 
     auto IsKeyDown = [](int32 VirtualKey) -> bool
     {
@@ -623,7 +860,7 @@ void FApplication::HandleCameraInput(float DeltaSeconds)
 
     using namespace DirectX;
 
-    const float SceneRadius = ActiveRenderer ? ActiveRenderer->GetSceneRadius() : 1.0f;
+    const float SceneRadius = SceneRadiusForCamera.load(std::memory_order_relaxed);
     const float MoveSpeed = (std::max)(5.0f, SceneRadius * 0.5f);
     const float FovSpeed = XMConvertToRadians(45.0f);
     const float MinFov = XMConvertToRadians(20.0f);
@@ -633,7 +870,7 @@ void FApplication::HandleCameraInput(float DeltaSeconds)
     const bool LeftButtonDown = IsKeyDown(VK_LBUTTON);
     if (LeftButtonDown && !bWasLeftMouseDown)
     {
-        UpdateSelectionFromMouseClick();
+        CaptureSelectionClick(OutSnapshot);
     }
     bWasLeftMouseDown = LeftButtonDown;
 
@@ -723,9 +960,9 @@ void FApplication::HandleCameraInput(float DeltaSeconds)
     Camera->SetFovY(FovY);
 }
 
-void FApplication::UpdateSelectionFromMouseClick()
+void FApplication::CaptureSelectionClick(FFrameSnapshot& OutSnapshot) const
 {
-    if (!ActiveRenderer || !MainWindow)
+    if (!MainWindow)
     {
         return;
     }
@@ -746,15 +983,143 @@ void FApplication::UpdateSelectionFromMouseClick()
         return;
     }
 
-    PendingObjectIdX = static_cast<uint32_t>(CursorPos.x);
-    PendingObjectIdY = static_cast<uint32_t>(CursorPos.y);
+    OutSnapshot.bSelectionClick = true;
+    OutSnapshot.SelectionClickX = static_cast<int32_t>(CursorPos.x);
+    OutSnapshot.SelectionClickY = static_cast<int32_t>(CursorPos.y);
+}
+
+void FApplication::UpdateSelectionFromClick(const FCamera& ClickCamera, int32_t ClickX, int32_t ClickY)
+{
+    if (!ActiveRenderer || !MainWindow)
+    {
+        return;
+    }
+
+    // Clicks that miss every model's bounds clear the selection right away, without rendering
+    // ObjectIds and waiting on the GPU for the readback.
+    const float Width = static_cast<float>(MainWindow->GetWidth());
+    const float Height = static_cast<float>(MainWindow->GetHeight());
+    if (Width > 0.0f && Height > 0.0f)
+    {
+        const float NdcX = (static_cast<float>(ClickX) + 0.5f) / Width * 2.0f - 1.0f;
+        const float NdcY = 1.0f - (static_cast<float>(ClickY) + 0.5f) / Height * 2.0f;
+
+        DirectX::XMFLOAT3 RayOrigin;
+        DirectX::XMFLOAT3 RayDirection;
+        RendererUtils::BuildCameraRay(ClickCamera, NdcX, NdcY, RayOrigin, RayDirection);
+
+        std::vector<FBvhRayHit> Hits;
+        ActiveRenderer->RaycastSceneModels(RayOrigin, RayDirection, Hits);
+        if (Hits.empty())
+        {
+            SelectedModelIndex = -1;
+            SelectedModelName.clear();
+            return;
+        }
+    }
+
+    PendingObjectIdX = static_cast<uint32_t>(ClickX);
+    PendingObjectIdY = static_cast<uint32_t>(ClickY);
     bPendingObjectIdReadback = true;
 }
 
+#if WITH_IMGUI
+void FApplication::DrawCpuProfilerWindow(const ImVec2& DisplaySize)
+{
+    if (!bCpuProfilerPaused)
+    {
+        int64_t BeginNs = 0;
+        int64_t EndNs = 0;
+        if (FCpuProfiler::GetFrameRange(0, BeginNs, EndNs))
+        {
+            FCpuProfiler::GetZones(BeginNs, EndNs, CpuProfileThreads);
+            CpuProfileBeginNs = BeginNs;
+            CpuProfileEndNs = EndNs;
+        }
+    }
+
+    ImGui::SetNextWindowPos(ImVec2(10.0f, DisplaySize.y - 10.0f), ImGuiCond_FirstUseEver, ImVec2(0.0f, 1.0f));
+    ImGui::SetNextWindowSize(ImVec2(DisplaySize.x * 0.6f, 240.0f), ImGuiCond_FirstUseEver);
+
+    bool bOpen = true;
+    if (!ImGui::Begin("CPU Profiler", &bOpen))
+    {
+        ImGui::End();
+        return;
+    }
+
+    const double FrameNs = static_cast<double>((std::max)(int64_t(1), CpuProfileEndNs - CpuProfileBeginNs));
+    ImGui::Text("Frame: %.3f ms", FrameNs / 1.0e6);
+    ImGui::SameLine();
+    ImGui::Checkbox("Pause", &bCpuProfilerPaused);
+    ImGui::SameLine();
+    if (ImGui::Button("Export Chrome Trace"))
+    {
+        FCpuProfiler::ExportChromeTrace(BuildCaptureStem("CpuTrace") + ".json");
+    }
+
+    ImGui::BeginChild("Timeline", ImVec2(0.0f, 0.0f), false);
+    ImDrawList* DrawList = ImGui::GetWindowDrawList();
+    const float LabelWidth = 90.0f;
+    const float RowHeight = ImGui::GetTextLineHeight() + 4.0f;
+    const float TrackWidth = (std::max)(1.0f, ImGui::GetContentRegionAvail().x - LabelWidth);
+    const FCpuProfileZone* HoveredZone = nullptr;
+
+    for (const FCpuProfileThreadZones& Thread : CpuProfileThreads)
+    {
+        uint32_t MaxDepth = 0;
+        for (const FCpuProfileZone& Zone : Thread.Zones)
+        {
+            MaxDepth = (std::max)(MaxDepth, Zone.Depth);
+        }
+
+        const ImVec2 Origin = ImGui::GetCursorScreenPos();
+        const float TrackX = Origin.x + LabelWidth;
+        DrawList->AddText(ImVec2(Origin.x, Origin.y + 2.0f), IM_COL32(220, 220, 220, 255), Thread.ThreadName.c_str());
+
+        for (const FCpuProfileZone& Zone : Thread.Zones)
+        {
+            // Worker zones may straddle the frame edges, so they are clipped to the track.
+            const double Start = (std::max)(0.0, static_cast<double>(Zone.StartNs - CpuProfileBeginNs) / FrameNs);
+            const double End = (std::min)(1.0, static_cast<double>(Zone.EndNs - CpuProfileBeginNs) / FrameNs);
+            const ImVec2 Min(TrackX + static_cast<float>(Start) * TrackWidth, Origin.y + static_cast<float>(Zone.Depth) * RowHeight);
+            const ImVec2 Max((std::max)(Min.x + 1.0f, TrackX + static_cast<float>(End) * TrackWidth), Min.y + RowHeight - 1.0f);
+
+            DrawList->AddRectFilled(Min, Max, GetCpuZoneColor(Zone.Name));
+            if (Max.x - Min.x > ImGui::CalcTextSize(Zone.Name).x + 4.0f)
+            {
+                DrawList->AddText(ImVec2(Min.x + 2.0f, Min.y + 2.0f), IM_COL32(255, 255, 255, 255), Zone.Name);
+            }
+
+            if (ImGui::IsMouseHoveringRect(Min, Max))
+            {
+                HoveredZone = &Zone;
+            }
+        }
+
+        ImGui::Dummy(ImVec2(LabelWidth + TrackWidth, static_cast<float>(MaxDepth + 1) * RowHeight + 4.0f));
+    }
+
+    if (HoveredZone)
+    {
+        ImGui::SetTooltip("%s\n%.3f ms", HoveredZone->Name, static_cast<double>(HoveredZone->EndNs - HoveredZone->StartNs) / 1.0e6);
+    }
+    ImGui::EndChild();
+    ImGui::End();
+
+    if (!bOpen)
+    {
+        FCpuProfiler::SetEnabled(false);
+        bCpuProfilerPaused = false;
+    }
+}
+
+#endif
+
 void FApplication::DrawSelectionBounds(float DisplayWidth, float DisplayHeight)
 {
 #if WITH_IMGUI
-    if (!Camera || !ActiveRenderer || SelectedModelIndex < 0)
+    if (!ActiveRenderer || SelectedModelIndex < 0)
     {
         return;
     }
@@ -766,8 +1131,8 @@ void FApplication::DrawSelectionBounds(float DisplayWidth, float DisplayHeight)
     }
 
     const FSceneModelResource& Model = (*Models)[SelectedModelIndex];
-    const DirectX::XMMATRIX View = Camera->GetViewMatrix();
-    const DirectX::XMMATRIX Projection = Camera->GetProjectionMatrix();
+    const DirectX::XMMATRIX View = RenderSnapshot.Camera.GetViewMatrix();
+    const DirectX::XMMATRIX Projection = RenderSnapshot.Camera.GetProjectionMatrix();
     const DirectX::XMMATRIX ViewProjection = DirectX::XMMatrixMultiply(View, Projection);
 
     const DirectX::XMFLOAT3 Min = Model.BoundsMin;
@@ -819,16 +1184,13 @@ void FApplication::DrawSelectionBounds(float DisplayWidth, float DisplayHeight)
 #endif
 }
 
-void FApplication::PositionCameraForScene()
+void FApplication::PositionCameraForScene(const DirectX::XMFLOAT3& SceneCenter, float SceneRadius)
 {
     if (!Camera)
     {
         return;
     }
 
-    const DirectX::XMFLOAT3 SceneCenter = ActiveRenderer ? ActiveRenderer->GetSceneCenter() : DirectX::XMFLOAT3{ 0.0f, 0.0f, 0.0f };
-    const float SceneRadius = ActiveRenderer ? ActiveRenderer->GetSceneRadius() : 1.0f;
-
     const float AngularHalfHeight = Camera->GetFovY() * 0.5f;
     const float Distance = SceneRadius / std::tan(AngularHalfHeight);
 
@@ -865,7 +1227,19 @@ void FApplication::PositionCameraForScene()
     Camera->SetUp(Up);
 }
 
-void FApplication::ApplySceneCameraFromJson(const std::wstring& ScenePath)
+void FApplication::QueueSceneCamera(const std::wstring& ScenePath)
+{
+    const DirectX::XMFLOAT3 SceneCenter = ActiveRenderer ? ActiveRenderer->GetSceneCenter() : DirectX::XMFLOAT3{ 0.0f, 0.0f, 0.0f };
+    const float SceneRadius = ActiveRenderer ? ActiveRenderer->GetSceneRadius() : 1.0f;
+    SceneRadiusForCamera.store(SceneRadius, std::memory_order_relaxed);
+
+    RenderThread->EnqueueGameThreadTask([this, ScenePath, SceneCenter, SceneRadius]()
+    {
+        ApplySceneCameraFromJson(ScenePath, SceneCenter, SceneRadius);
+    });
+}
+
+void FApplication::ApplySceneCameraFromJson(const std::wstring& ScenePath, const DirectX::XMFLOAT3& SceneCenter, float SceneRadius)
 {
     if (!Camera)
     {
@@ -875,7 +1249,7 @@ void FApplication::ApplySceneCameraFromJson(const std::wstring& ScenePath)
     FSceneCameraDesc SceneCamera;
     if (!FSceneJsonLoader::LoadSceneCamera(ScenePath, SceneCamera))
     {
-        PositionCameraForScene();
+        PositionCameraForScene(SceneCenter, SceneRadius);
         return;
     }
 
@@ -883,39 +1257,44 @@ void FApplication::ApplySceneCameraFromJson(const std::wstring& ScenePath)
     Camera->SetPerspective(FovRadians, Camera->GetAspectRatio(), Camera->GetNearClip(), Camera->GetFarClip());
     Camera->SetPosition(SceneCamera.Position);
 
-    const DirectX::XMVECTOR UpVec = DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
-    DirectX::XMVECTOR ForwardVec = DirectX::XMLoadFloat3(&Camera->GetForward());
+    const FFloat3 Forward = GetSceneCameraForward(SceneCamera, Camera->GetForward());
+    Camera->SetForward(Forward);
+    OrientCameraUp(*Camera, CameraYaw, CameraPitch);
+}
 
-    if (SceneCamera.bHasLookAt)
-    {
-        const DirectX::XMVECTOR Eye = DirectX::XMLoadFloat3(&SceneCamera.Position);
-        const DirectX::XMVECTOR Target = DirectX::XMLoadFloat3(&SceneCamera.LookAt);
-        ForwardVec = DirectX::XMVector3Normalize(DirectX::XMVectorSubtract(Target, Eye));
-    }
-    else if (SceneCamera.bHasRotation)
+void FApplication::ApplyBenchmarkCamera(FCamera& TargetCamera) const
+{
+    if (!Benchmark->HasCameraPath())
     {
-        const float Pitch = DirectX::XMConvertToRadians(SceneCamera.RotationEuler.x);
-        const float Yaw = DirectX::XMConvertToRadians(SceneCamera.RotationEuler.y);
-        const float Roll = DirectX::XMConvertToRadians(SceneCamera.RotationEuler.z);
-        const DirectX::XMMATRIX Rotation = DirectX::XMMatrixRotationRollPitchYaw(Pitch, Yaw, Roll);
-        ForwardVec = DirectX::XMVector3Normalize(DirectX::XMVector3TransformNormal(DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), Rotation));
+        return;
     }
 
-    FFloat3 Forward;
-    FFloat3 Up;
-    DirectX::XMStoreFloat3(&Forward, ForwardVec);
-    DirectX::XMStoreFloat3(&Up, UpVec);
-    Camera->SetForward(Forward);
-    Camera->SetUp(Up);
+    FFloat3 Position = TargetCamera.GetPosition();
+    FFloat3 Forward = TargetCamera.GetForward();
+    float FovYDegrees = DirectX::XMConvertToDegrees(TargetCamera.GetFovY());
+    Benchmark->SampleCamera(Position, Forward, FovYDegrees);
 
-    CameraPitch = -asinf(DirectX::XMVectorGetY(ForwardVec));
-    CameraYaw = atan2f(DirectX::XMVectorGetX(ForwardVec), DirectX::XMVectorGetZ(ForwardVec));
+    TargetCamera.SetPosition(Position);
+    TargetCamera.SetForward(Forward);
+    TargetCamera.SetFovY(DirectX::XMConvertToRadians(FovYDegrees));
+
+    float Yaw = 0.0f;
+    float Pitch = 0.0f;
+    OrientCameraUp(TargetCamera, Yaw, Pitch);
+}
+
+void FApplication::OrientCameraUp(FCamera& TargetCamera, float& OutYaw, float& OutPitch)
+{
+    const DirectX::XMVECTOR ForwardVec = DirectX::XMLoadFloat3(&TargetCamera.GetForward());
+    OutPitch = -asinf(DirectX::XMVectorGetY(ForwardVec));
+    OutYaw = atan2f(DirectX::XMVectorGetX(ForwardVec), DirectX::XMVectorGetZ(ForwardVec));
 
     const DirectX::XMVECTOR DefaultUp = DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
-    const DirectX::XMMATRIX Rotation = DirectX::XMMatrixRotationRollPitchYaw(CameraPitch, CameraYaw, 0.0f);
+    const DirectX::XMMATRIX Rotation = DirectX::XMMatrixRotationRollPitchYaw(OutPitch, OutYaw, 0.0f);
     const DirectX::XMVECTOR RecomputedUp = DirectX::XMVector3Normalize(DirectX::XMVector3TransformNormal(DefaultUp, Rotation));
+    FFloat3 Up;
     DirectX::XMStoreFloat3(&Up, RecomputedUp);
-    Camera->SetUp(Up);
+    TargetCamera.SetUp(Up);
 }
 
 bool FApplication::ReloadScene(const std::wstring& ScenePath)
@@ -940,16 +1319,33 @@ bool FApplication::ReloadScene(const std::wstring& ScenePath)
     FRendererOptions RendererOptions{};
     RendererOptions.SceneFilePath = ScenePath;
     RendererOptions.bUseDepthPrepass = bDepthPrepassEnabled;
+    RendererOptions.MaskedDepthPrepassThreshold = RendererConfig.MaskedDepthPrepassThreshold;
     RendererOptions.bEnableShadows = bShadowsEnabled;
     RendererOptions.ShadowBias = ShadowBias;
     RendererOptions.bEnableHZB = bHZBEnabled;
     RendererOptions.bEnableIndirectDraw = bIndirectDrawEnabled;
+    RendererOptions.bEnableBindless = RendererConfig.bEnableBindless;
+    RendererOptions.bOptimizeMeshes = RendererConfig.bOptimizeMeshes;
+    RendererOptions.bEnableMeshShaders = RendererConfig.bEnableMeshShaders;
+    RendererOptions.bEnableTiledLighting = RendererConfig.bEnableTiledLighting;
+    RendererOptions.bEnableFusedPost = RendererConfig.bEnableFusedPost;
+    RendererOptions.ShadingRateQuality = RendererConfig.ShadingRateQuality;
+    RendererOptions.bShowShadingRate = RendererConfig.bShowShadingRate;
+    RendererOptions.bGenerateLods = RendererConfig.bGenerateLods;
+    RendererOptions.LodBias = RendererConfig.LodBias;
+    RendererOptions.MinScreenCoverage = RendererConfig.MinScreenCoverage;
+    RendererOptions.ShadowMinScreenCoverage = RendererConfig.ShadowMinScreenCoverage;
+    RendererOptions.bStreamSceneTextures = RendererConfig.bStreamSceneTextures;
+    RendererOptions.bStreamTextureMips = RendererConfig.bStreamTextureMips;
+    RendererOptions.TextureStreamingBudgetMB = RendererConfig.TextureStreamingBudgetMB;
+    RendererOptions.TextureCacheBudgetMB = RendererConfig.TextureCacheBudgetMB;
     RendererOptions.bEnableGpuDebugPrint = bGpuDebugPrintEnabled;
     RendererOptions.bEnableTAA = bTaaEnabled;
     RendererOptions.TaaHistoryWeight = TaaHistoryWeight;
     RendererOptions.bEnableCas = bCasEnabled;
     RendererOptions.CasSharpness = CasSharpness;
     RendererOptions.FramesInFlight = SwapChain ? SwapChain->GetBackBufferCount() : 2u;
+    RendererOptions.PersistentResources = ActiveRenderer ? ActiveRenderer->CapturePersistentResources() : nullptr;
 
     const uint32_t Width = static_cast<uint32_t>(MainWindow->GetWidth());
     const uint32_t Height = static_cast<uint32_t>(MainWindow->GetHeight());
@@ -991,6 +1387,8 @@ bool FApplication::ReloadScene(const std::wstring& ScenePath)
         return false;
     }
 
+    NewForwardRenderer->CompletePersistentResourceHandoff();
+    NewDeferredRenderer->CompletePersistentResourceHandoff();
     ForwardRenderer = std::move(NewForwardRenderer);
     DeferredRenderer = std::move(NewDeferredRenderer);
     ActiveRenderer = NewActiveRenderer;
@@ -1002,7 +1400,7 @@ bool FApplication::ReloadScene(const std::wstring& ScenePath)
     RendererConfig.SceneFile = ScenePath;
 
     UpdateRendererLighting();
-    ApplySceneCameraFromJson(ScenePath);
+    QueueSceneCamera(ScenePath);
 
     LogInfo("Scene reloaded from: " + PathToUtf8String(ScenePath));
     return true;
@@ -1057,6 +1455,7 @@ void FApplication::StartAsyncSceneReload(const std::wstring& ScenePath)
     FRendererOptions RendererOptions{};
     RendererOptions.SceneFilePath = ScenePath;
     RendererOptions.bUseDepthPrepass = bDepthPrepassEnabled;
+    RendererOptions.MaskedDepthPrepassThreshold = RendererConfig.MaskedDepthPrepassThreshold;
     RendererOptions.bEnableShadows = bShadowsEnabled;
     RendererOptions.ShadowBias = ShadowBias;
     RendererOptions.bEnableTonemap = bTonemapEnabled;
@@ -1068,14 +1467,32 @@ void FApplication::StartAsyncSceneReload(const std::wstring& ScenePath)
     RendererOptions.bEnableTAA = bTaaEnabled;
     RendererOptions.TaaHistoryWeight = TaaHistoryWeight;
     RendererOptions.bEnableGpuTiming = bGpuTimingEnabled;
+    RendererOptions.bEnablePipelineStatistics = RendererConfig.bEnablePipelineStatistics;
     RendererOptions.bEnableGpuDebugPrint = bGpuDebugPrintEnabled;
     RendererOptions.bEnableHZB = bHZBEnabled;
     RendererOptions.bEnableIndirectDraw = bIndirectDrawEnabled;
+    RendererOptions.bEnableBindless = RendererConfig.bEnableBindless;
+    RendererOptions.bOptimizeMeshes = RendererConfig.bOptimizeMeshes;
+    RendererOptions.bEnableMeshShaders = RendererConfig.bEnableMeshShaders;
+    RendererOptions.bEnableTiledLighting = RendererConfig.bEnableTiledLighting;
+    RendererOptions.bEnableFusedPost = RendererConfig.bEnableFusedPost;
+    RendererOptions.ShadingRateQuality = RendererConfig.ShadingRateQuality;
+    RendererOptions.bShowShadingRate = RendererConfig.bShowShadingRate;
+    RendererOptions.bGenerateLods = RendererConfig.bGenerateLods;
+    RendererOptions.LodBias = RendererConfig.LodBias;
+    RendererOptions.MinScreenCoverage = RendererConfig.MinScreenCoverage;
+    RendererOptions.ShadowMinScreenCoverage = RendererConfig.ShadowMinScreenCoverage;
+    RendererOptions.bStreamSceneTextures = RendererConfig.bStreamSceneTextures;
+    RendererOptions.bStreamTextureMips = RendererConfig.bStreamTextureMips;
+    RendererOptions.TextureStreamingBudgetMB = RendererConfig.TextureStreamingBudgetMB;
+    RendererOptions.TextureCacheBudgetMB = RendererConfig.TextureCacheBudgetMB;
     RendererOptions.FramesInFlight = SwapChain ? SwapChain->GetBackBufferCount() : 2u;
+    // The current renderer keeps drawing with these until CompleteAsyncSceneReload swaps them over.
+    RendererOptions.PersistentResources = ActiveRenderer ? ActiveRenderer->CapturePersistentResources() : nullptr;
 
     const bool bPreferDeferred = ActiveRenderer == DeferredRenderer.get() || RendererConfig.RendererType == ERendererType::Deferred;
 
-    // Schedule async task
+    // Schedule async task as background work so it never delays frame-critical tasks
     FTaskScheduler::Get().ScheduleTask([this, ScenePath, Width, Height, BackBufferFormat, RendererOptions, bPreferDeferred, StartTime]()
     {
         AsyncForwardRenderer = std::make_unique<FForwardRenderer>();
@@ -1118,10 +1535,11 @@ void FApplication::StartAsyncSceneReload(const std::wstring& ScenePath)
         const auto EndTime = std::chrono::high_resolution_clock::now();
         const auto Duration = std::chrono::duration_cast<std::chrono::milliseconds>(EndTime - StartTime);
         LogInfo("Async scene reload completed in " + std::to_string(Duration.count()) + " ms");
+        FShaderCompiler::LogCacheStatistics();
 
         // Signal completion with atomic store (this flag will be checked on the main thread)
         bAsyncSceneLoadComplete.store(true, std::memory_order_release);
-    });
+    }, ETaskPriority::Background);
 }
 
 void FApplication::CompleteAsyncSceneReload()
@@ -1149,9 +1567,34 @@ void FApplication::CompleteAsyncSceneReload()
         Device->GetGraphicsQueue()->Flush();
     }
 
+    // The targets the new renderers share with the old ones are in the states the last frame left.
+    if (AsyncForwardRenderer)
+    {
+        AsyncForwardRenderer->CompletePersistentResourceHandoff();
+    }
+    if (AsyncDeferredRenderer)
+    {
+        AsyncDeferredRenderer->CompletePersistentResourceHandoff();
+    }
+
+    const uint32 PreviousOwners[] =
+    {
+        ForwardRenderer ? ForwardRenderer->GetMemoryOwnerId() : FDX12MemoryTracker::SharedOwner,
+        DeferredRenderer ? DeferredRenderer->GetMemoryOwnerId() : FDX12MemoryTracker::SharedOwner,
+    };
+
     // Swap renderers on the main thread
     ForwardRenderer = std::move(AsyncForwardRenderer);
     DeferredRenderer = std::move(AsyncDeferredRenderer);
+
+    // The GPU is idle and the old renderers are gone, so anything they allocated should be too.
+    for (const uint32 Owner : PreviousOwners)
+    {
+        if (Owner != FDX12MemoryTracker::SharedOwner)
+        {
+            FDX12MemoryTracker::Get().ReportLiveAllocations(Owner, "the previous scene's renderer was destroyed");
+        }
+    }
     ActiveRenderer = AsyncActiveRenderer;
     SelectedModelIndex = -1;
     SelectedModelName.clear();
@@ -1161,7 +1604,7 @@ void FApplication::CompleteAsyncSceneReload()
     RendererConfig.SceneFile = AsyncScenePath;
 
     UpdateRendererLighting();
-    ApplySceneCameraFromJson(AsyncScenePath);
+    QueueSceneCamera(AsyncScenePath);
 
     LogInfo("Scene swapped to: " + PathToUtf8String(AsyncScenePath));
     
@@ -1378,6 +1821,7 @@ void FApplication::RenderUI()
         return;
     }
 
+    std::lock_guard<std::mutex> ImGuiLock(GetImGuiMutex());
     if (!EnsureImGuiFontAtlas())
     {
         return;
@@ -1387,6 +1831,7 @@ void FApplication::RenderUI()
     ImGui_ImplDX12_NewFrame();
     ImGui_ImplWin32_NewFrame();
     ImGui::NewFrame();
+    bImGuiWantsInput.store(Io.WantCaptureMouse || Io.WantCaptureKeyboard, std::memory_order_relaxed);
 
     Io.DisplaySize = ImVec2(static_cast<float>(MainWindow->GetWidth()), static_cast<float>(MainWindow->GetHeight()));
     const ImVec2 WindowPos = ImVec2(Io.DisplaySize.x - 10.0f, 10.0f);
@@ -1402,10 +1847,10 @@ void FApplication::RenderUI()
         ImGuiWindowFlags_NoNav;
 
     ImGui::Begin("Performance", nullptr, Flags);
-    ImGui::Text("FPS: %.1f", Time->GetFPS());
+    ImGui::Text("FPS: %.1f", RenderSnapshot.Fps);
 
 	ImGui::SameLine();
-	const double CpuFrameMs = Time->GetDeltaTimeSeconds() * 1000.0;
+	const double CpuFrameMs = static_cast<double>(RenderSnapshot.DeltaSeconds) * 1000.0;
 	double GpuFrameMs = -1.0;
 	for (const FRenderGraph::FGpuPassTimingStats& Stats : FRenderGraph::GetGpuTimingStats())
 	{
@@ -1424,6 +1869,15 @@ void FApplication::RenderUI()
         ImGui::Text("CPU/GPU: %.3f / N/A", CpuFrameMs);
     }
 
+    if (SwapChain->HasFrameLatencyWaitable())
+    {
+        ImGui::Text("Input to present: %.1f ms (latency %u)", InputToPresentMs, SwapChain->GetMaxFrameLatency());
+    }
+    else
+    {
+        ImGui::Text("Input to present: %.1f ms", InputToPresentMs);
+    }
+
     size_t TotalModels = 0;
     size_t CulledModels = 0;
     const bool bHasModelStats = ActiveRenderer && ActiveRenderer->GetSceneModelStats(TotalModels, CulledModels);
@@ -1436,6 +1890,13 @@ void FApplication::RenderUI()
         ImGui::Text("Models (Total/Culled): N/A");
     }
 
+    uint64_t FullDetailTriangles = 0;
+    uint64_t DrawnTriangles = 0;
+    if (ActiveRenderer && ActiveRenderer->GetSceneTriangleStats(RenderSnapshot.Camera, FullDetailTriangles, DrawnTriangles))
+    {
+        ImGui::Text("Triangles (LOD/Full): %llu / %llu", static_cast<unsigned long long>(DrawnTriangles), static_cast<unsigned long long>(FullDetailTriangles));
+    }
+
     if (ImGui::CollapsingHeader("Details", ImGuiTreeNodeFlags_DefaultOpen))
     {
         ImGui::Separator();
@@ -1463,12 +1924,60 @@ void FApplication::RenderUI()
                 break;
 			}
             const FRenderGraph::FGpuPassTimingStats& Stats = TimingStats[Index];
-            ImGui::Text("%s: %.3f / %.3f / %.3f (n=%u)",
+            ImGui::Text("%s%s: %.3f / %.3f / %.3f (n=%u)",
+                Stats.Queue == ERGPassQueue::AsyncCompute ? "[Compute] " : "",
                 Stats.Name.c_str(),
                 Stats.AvgMs,
                 Stats.MinMs,
                 Stats.MaxMs,
                 Stats.SampleCount);
+
+            if (const FRenderGraph::FGpuPassPipelineStats* PipelineStats = FRenderGraph::FindPipelineStats(Stats.Name))
+            {
+                ImGui::Text("    IA prims %.0f, clipped %.0f, VS %.0f, PS %.0f, CS %.0f",
+                    PipelineStats->IAPrimitives,
+                    PipelineStats->ClippedPrimitives,
+                    PipelineStats->VSInvocations,
+                    PipelineStats->PSInvocations,
+                    PipelineStats->CSInvocations);
+            }
+        }
+
+        FRenderer::FGpuCullingStats CullingStats;
+        if (ActiveRenderer && ActiveRenderer->GetGpuCullingStats(CullingStats))
+        {
+            ImGui::Text("GPU Culling: tested %u, frustum %u, occluded %u, small %u",
+                CullingStats.ModelsTested,
+                CullingStats.FrustumCulled,
+                CullingStats.OcclusionCulled,
+                CullingStats.SmallCulled);
+            ImGui::Text("GPU Culling: draws %u, triangles %u", CullingStats.DrawCommands, CullingStats.TrianglesSubmitted);
+        }
+
+        if (FRenderGraph::IsTimingCaptureActive())
+        {
+            ImGui::Text("Capturing timings: %u / %u frames",
+                FRenderGraph::GetTimingCaptureResolvedFrames(),
+                FRenderGraph::GetTimingCaptureFrameCount());
+        }
+        else
+        {
+            ImGui::SliderInt("Capture Frames", &GpuTimingCaptureFrames, 30, 2000);
+            if (ImGui::Button("Capture Timings"))
+            {
+                FRenderGraph::BeginTimingCapture(static_cast<uint32>(GpuTimingCaptureFrames), BuildCaptureStem("GpuTiming"));
+            }
+            if (!FRenderGraph::GetLastTimingCapturePath().empty())
+            {
+                ImGui::TextWrapped("Last capture: %s", FRenderGraph::GetLastTimingCapturePath().c_str());
+            }
+        }
+
+        bool bCpuProfilerEnabled = FCpuProfiler::IsEnabled();
+        if (ImGui::Checkbox("CPU Profiler", &bCpuProfilerEnabled))
+        {
+            FCpuProfiler::SetEnabled(bCpuProfilerEnabled);
+            bCpuProfilerPaused = false;
         }
 
         ImGui::Separator();
@@ -1478,11 +1987,13 @@ void FApplication::RenderUI()
         {
             const std::filesystem::path ScenePath(CurrentScenePath);
             const std::filesystem::path InitialDir = ScenePath.has_parent_path() ? ScenePath.parent_path() : std::filesystem::path();
-            const std::wstring SelectedScene = OpenSceneFileDialog(InitialDir.wstring());
-            if (!SelectedScene.empty())
+
+            // The dialog pumps the window's messages, so it runs on the thread that owns the window;
+            // the chosen path comes back with the next snapshot.
+            RenderThread->EnqueueGameThreadTask([this, InitialDirectory = InitialDir.wstring()]()
             {
-                PendingScenePath = SelectedScene;
-            }
+                SelectedScenePath = OpenSceneFileDialog(InitialDirectory);
+            });
         }
 
         const char* SelectedName = SelectedModelIndex >= 0 ? SelectedModelName.c_str() : "None";
@@ -1500,6 +2011,42 @@ void FApplication::RenderUI()
             ImGui::Text("GPU Memory (Local)");
             ImGui::Text("Usage/Budget: %.1f / %.1f MB", UsageMB, BudgetMB);
             ImGui::Text("Available/Reserved: %.1f / %.1f MB", AvailableMB, ReservedMB);
+
+            const auto CategoryStats = FDX12MemoryTracker::Get().GetCategoryStats();
+            uint64 TrackedBytes = 0;
+            for (const FDX12MemoryTracker::FCategoryStats& Stats : CategoryStats)
+            {
+                TrackedBytes += Stats.Bytes;
+            }
+            const double TrackedMB = static_cast<double>(TrackedBytes) / (1024.0 * 1024.0);
+            ImGui::Text("Tracked: %.1f MB (%.0f%% of budget)", TrackedMB, BudgetMB > 0.0 ? TrackedMB * 100.0 / BudgetMB : 0.0);
+            for (uint32 CategoryIndex = 0; CategoryIndex < GpuMemoryCategoryCount; ++CategoryIndex)
+            {
+                const FDX12MemoryTracker::FCategoryStats& Stats = CategoryStats[CategoryIndex];
+                const double CategoryMB = static_cast<double>(Stats.Bytes) / (1024.0 * 1024.0);
+                const char* CategoryName = GetGpuMemoryCategoryName(static_cast<EGpuMemoryCategory>(CategoryIndex));
+                if (Stats.BudgetBytes > 0)
+                {
+                    const double CategoryBudgetMB = static_cast<double>(Stats.BudgetBytes) / (1024.0 * 1024.0);
+                    const ImVec4 Color = Stats.Bytes > Stats.BudgetBytes ? ImVec4(1.0f, 0.4f, 0.3f, 1.0f) : ImGui::GetStyleColorVec4(ImGuiCol_Text);
+                    ImGui::TextColored(Color, "  %s: %.1f / %.1f MB (%u)", CategoryName, CategoryMB, CategoryBudgetMB, Stats.Count);
+                }
+                else
+                {
+                    ImGui::Text("  %s: %.1f MB (%u)", CategoryName, CategoryMB, Stats.Count);
+                }
+            }
+
+            if (FDX12HeapAllocator* StaticAllocator = Device->GetStaticResourceAllocator())
+            {
+                const FDX12HeapAllocator::FStats HeapStats = StaticAllocator->GetStats();
+                ImGui::Text(
+                    "Static pages: %.1f / %.1f MB, %u resources in %u pages",
+                    static_cast<double>(HeapStats.UsedBytes) / (1024.0 * 1024.0),
+                    static_cast<double>(HeapStats.ReservedBytes) / (1024.0 * 1024.0),
+                    HeapStats.PlacedCount,
+                    HeapStats.PageCount);
+            }
         }
 	    ImGui::Separator();
 
@@ -1541,10 +2088,13 @@ void FApplication::RenderUI()
         if (ImGui::Checkbox("Freeze Camera", &bFreezeCameraValue))
         {
             bFreezeCamera = bFreezeCameraValue;
-            bIsRotatingWithMouse = false;
-            if (bFreezeCamera && Camera)
+            RenderThread->EnqueueGameThreadTask([this]()
+            {
+                bIsRotatingWithMouse = false;
+            });
+            if (bFreezeCamera)
             {
-                FrozenCamera = *Camera;
+                FrozenCamera = RenderSnapshot.Camera;
             }
         }
 
@@ -1578,6 +2128,69 @@ void FApplication::RenderUI()
             }
         }
 
+        bool bTiledLighting = RendererConfig.bEnableTiledLighting;
+        if (ImGui::Checkbox("Tiled Lighting", &bTiledLighting))
+        {
+            RendererConfig.bEnableTiledLighting = bTiledLighting;
+
+            if (DeferredRenderer)
+            {
+                DeferredRenderer->SetTiledLightingEnabled(bTiledLighting);
+            }
+        }
+
+        if (ActiveRenderer && ActiveRenderer->IsVariableRateShadingSupported())
+        {
+            int ShadingRateQuality = static_cast<int>(RendererConfig.ShadingRateQuality);
+            if (ImGui::Combo("Shading Rate", &ShadingRateQuality, "Off\0Quality\0Balanced\0Performance\0"))
+            {
+                RendererConfig.ShadingRateQuality = static_cast<EShadingRateQuality>(ShadingRateQuality);
+
+                if (DeferredRenderer)
+                {
+                    DeferredRenderer->SetShadingRateQuality(RendererConfig.ShadingRateQuality);
+                }
+
+                if (ForwardRenderer)
+                {
+                    ForwardRenderer->SetShadingRateQuality(RendererConfig.ShadingRateQuality);
+                }
+            }
+
+            ImGui::SameLine();
+            bool bShowShadingRate = RendererConfig.bShowShadingRate;
+            if (ImGui::Checkbox("Show Rates", &bShowShadingRate))
+            {
+                RendererConfig.bShowShadingRate = bShowShadingRate;
+
+                if (DeferredRenderer)
+                {
+                    DeferredRenderer->SetShadingRateOverlayEnabled(bShowShadingRate);
+                }
+
+                if (ForwardRenderer)
+                {
+                    ForwardRenderer->SetShadingRateOverlayEnabled(bShowShadingRate);
+                }
+            }
+        }
+
+        float LodBiasValue = RendererConfig.LodBias;
+        if (ImGui::SliderFloat("LOD Bias", &LodBiasValue, -2.0f, 4.0f, "%.2f"))
+        {
+            RendererConfig.LodBias = LodBiasValue;
+
+            if (DeferredRenderer)
+            {
+                DeferredRenderer->SetLodBias(LodBiasValue);
+            }
+
+            if (ForwardRenderer)
+            {
+                ForwardRenderer->SetLodBias(LodBiasValue);
+            }
+        }
+
         ImGui::Separator();
         bool bShadows = bShadowsEnabled;
         if (ImGui::Checkbox("Shadows", &bShadows))
@@ -1667,6 +2280,18 @@ void FApplication::RenderUI()
             }
         }
 
+        ImGui::SameLine();
+        bool bFusedPost = RendererConfig.bEnableFusedPost;
+        if (ImGui::Checkbox("Fused Post", &bFusedPost))
+        {
+            RendererConfig.bEnableFusedPost = bFusedPost;
+
+            if (DeferredRenderer)
+            {
+                DeferredRenderer->SetFusedPostEnabled(bFusedPost);
+            }
+        }
+
         float CasSharpnessValue = CasSharpness;
         if (ImGui::SliderFloat("CAS Sharpness", &CasSharpnessValue, 0.0f, 1.0f, "%.2f"))
         {
@@ -1768,6 +2393,41 @@ void FApplication::RenderUI()
             }
         }
 
+        bool bDynamicResolution = DynamicResolution.IsEnabled();
+        if (ImGui::Checkbox("Dynamic Resolution", &bDynamicResolution))
+        {
+            DynamicResolution.SetEnabled(bDynamicResolution);
+        }
+
+        if (DynamicResolution.IsEnabled())
+        {
+            float TargetMsValue = DynamicResolution.GetTargetFrameTime();
+            if (ImGui::SliderFloat("Target Frame Time", &TargetMsValue, 4.0f, 50.0f, "%.1f ms"))
+            {
+                DynamicResolution.SetTargetFrameTime(TargetMsValue);
+            }
+
+            float MinScaleValue = DynamicResolution.GetMinScale();
+            if (ImGui::SliderFloat("Min Resolution Scale", &MinScaleValue, 0.25f, 1.0f, "%.2f"))
+            {
+                DynamicResolution.SetMinScale(MinScaleValue);
+            }
+
+            if (ActiveRenderer)
+            {
+                ImGui::Text("Render: %u x %u (%.0f%%, %.2f ms)",
+                    ActiveRenderer->GetRenderWidth(),
+                    ActiveRenderer->GetRenderHeight(),
+                    DynamicResolution.GetScale() * 100.0f,
+                    DynamicResolution.GetAverageFrameTime());
+            }
+
+            if (!bTaaEnabled)
+            {
+                ImGui::TextDisabled("Needs TAA to upscale; rendering at full resolution");
+            }
+        }
+
         ImGui::Separator();
         bool bLightingChanged = false;
 
@@ -1798,12 +2458,14 @@ void FApplication::RenderUI()
 
     ImGui::End();
 
-    if (Camera)
+    if (FCpuProfiler::IsEnabled())
     {
-        DrawAxisGizmo(Camera->GetViewMatrix(), Io.DisplaySize);
-        DrawSelectionBounds(Io.DisplaySize.x, Io.DisplaySize.y);
+        DrawCpuProfilerWindow(Io.DisplaySize);
     }
 
+    DrawAxisGizmo(RenderSnapshot.Camera.GetViewMatrix(), Io.DisplaySize);
+    DrawSelectionBounds(Io.DisplaySize.x, Io.DisplaySize.y);
+
     ImGui::Render();
 
     ID3D12DescriptorHeap* Heaps[] = { ImGuiDescriptorHeap.Get() };
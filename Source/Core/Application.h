@@ -13,7 +13,10 @@
 #include <vector>
 #include "../Scene/Camera.h"
 #include "../RHI/DX12Commons.h"
+#include "../Render/DynamicResolution.h"
+#include "CpuProfiler.h"
 #include "RendererConfig.h"
+#include "RenderThread.h"
 
 // ImGui availability is determined in ImGuiSupport.h to avoid build failures
 // when the library is not present locally.
@@ -32,6 +35,8 @@ class FRenderer;
 class FForwardRenderer;
 class FDeferredRenderer;
 class FCamera;
+class FShaderHotReload;
+class FBenchmarkRunner;
 
 class FApplication
 {
@@ -39,15 +44,26 @@ public:
     FApplication();
     ~FApplication();
 
-    bool Initialize(HINSTANCE InstanceHandle);
+    // CommandLine overrides renderer config keys, e.g. "-benchmark -benchmarkoutput=Report.json".
+    bool Initialize(HINSTANCE InstanceHandle, const std::wstring& CommandLine = std::wstring());
+    // 0 after an interactive session; the benchmark's status when one ran.
     int32_t Run();
 
 private:
-    bool RenderFrame();
-    void HandleCameraInput(float DeltaSeconds);
-    void PositionCameraForScene();
-    void ApplySceneCameraFromJson(const std::wstring& ScenePath);
-    void UpdateSelectionFromMouseClick();
+    // Game thread: input and camera, ending in the snapshot the render thread draws.
+    void UpdateFrame(FFrameSnapshot& OutSnapshot);
+    // Render thread; false once the benchmark has completed.
+    bool RenderFrame(const FFrameSnapshot& Snapshot);
+    void HandleCameraInput(float DeltaSeconds, FFrameSnapshot& OutSnapshot);
+    void PositionCameraForScene(const DirectX::XMFLOAT3& SceneCenter, float SceneRadius);
+    // Render thread; the game thread places its camera for the scene before the next update.
+    void QueueSceneCamera(const std::wstring& ScenePath);
+    void ApplySceneCameraFromJson(const std::wstring& ScenePath, const DirectX::XMFLOAT3& SceneCenter, float SceneRadius);
+    // Levels the camera's up vector to its forward and returns the matching mouse-look angles.
+    static void OrientCameraUp(FCamera& TargetCamera, float& OutYaw, float& OutPitch);
+    void ApplyBenchmarkCamera(FCamera& TargetCamera) const;
+    void CaptureSelectionClick(FFrameSnapshot& OutSnapshot) const;
+    void UpdateSelectionFromClick(const FCamera& ClickCamera, int32_t ClickX, int32_t ClickY);
     void DrawSelectionBounds(float DisplayWidth, float DisplayHeight);
     bool ReloadScene(const std::wstring& ScenePath);
     void StartAsyncSceneReload(const std::wstring& ScenePath);
@@ -56,6 +72,10 @@ private:
     bool InitializeImGui(int32_t Width, int32_t Height);
     void ShutdownImGui();
     void RenderUI();
+#if WITH_IMGUI
+    // Timeline of the last complete frame, one track per thread with zones stacked by depth.
+    void DrawCpuProfilerWindow(const ImVec2& DisplaySize);
+#endif
     bool EnsureImGuiFontAtlas();
     void UpdateRendererLighting() const;
     DirectX::XMVECTOR GetLightDirectionVector() const;
@@ -65,12 +85,25 @@ private:
     std::unique_ptr<FDX12Device>       Device;
     std::unique_ptr<FDX12SwapChain>    SwapChain;
     std::unique_ptr<FDX12CommandContext> CommandContext;
+    std::unique_ptr<FDX12CommandContext> AsyncComputeContext;
+    std::unique_ptr<FShaderHotReload>  ShaderHotReload;
     std::unique_ptr<FTime>             Time;
     std::unique_ptr<FForwardRenderer>  ForwardRenderer;
     std::unique_ptr<FDeferredRenderer> DeferredRenderer;
     FRenderer*                         ActiveRenderer = nullptr;
     std::unique_ptr<FCamera>           Camera;
     FRendererConfig                    RendererConfig;
+    std::unique_ptr<FBenchmarkRunner>  Benchmark;
+    std::unique_ptr<FRenderThread>     RenderThread;
+
+    // Game thread state
+    uint64_t                           GameFrameNumber = 0;
+    std::wstring                       SelectedScenePath;
+    // Written by the render thread, read by the camera input
+    std::atomic<bool>                  bImGuiWantsInput{ false };
+    std::atomic<float>                 SceneRadiusForCamera{ 1.0f };
+    // The snapshot of the frame the render thread is drawing; its camera follows the benchmark path
+    FFrameSnapshot                     RenderSnapshot;
 
     ComPtr<ID3D12DescriptorHeap>       ImGuiDescriptorHeap;
 #if WITH_IMGUI
@@ -84,6 +117,11 @@ private:
     bool bShadowsEnabled = true;
     bool bHZBEnabled = true;
     bool bGpuTimingEnabled = false;
+    int GpuTimingCaptureFrames = 300;
+    bool bCpuProfilerPaused = false;
+    std::vector<FCpuProfileThreadZones> CpuProfileThreads;
+    int64_t CpuProfileBeginNs = 0;
+    int64_t CpuProfileEndNs = 0;
     bool bGpuDebugPrintEnabled = false;
     bool bTonemapEnabled = true;
     bool bIndirectDrawEnabled = true;
@@ -101,6 +139,7 @@ private:
     float AutoExposureSpeedDown = 1.0f;
     bool bTaaEnabled = false;
     float TaaHistoryWeight = 0.9f;
+    FDynamicResolution DynamicResolution;
     bool bFreezeCamera = false;
     FCamera FrozenCamera;
     int32_t SelectedModelIndex = -1;
@@ -123,7 +162,11 @@ private:
     ComPtr<ID3D12QueryHeap>            FrameTimingQueryHeap;
     ComPtr<ID3D12Resource>             FrameTimingReadback;
     std::vector<uint64>                FrameTimingFenceValues;
+    // Benchmark frame whose timestamps each back buffer's slot holds.
+    std::vector<uint32>                FrameTimingBenchmarkFrames;
     uint64                             FrameTimingFrequency = 0;
+    // Render thread's smoothed time from input sampling to the return of Present.
+    double                             InputToPresentMs = 0.0;
 
     // Async scene loading
     std::unique_ptr<FForwardRenderer>  AsyncForwardRenderer;
@@ -0,0 +1,355 @@
+#include "Benchmark.h"
+
+#include "Logger.h"
+#include "../Render/RenderGraph.h"
+#include "../Render/Renderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+    std::string ToUtf8(const std::wstring& Path)
+    {
+        const auto Utf8 = std::filesystem::path(Path).u8string();
+        return std::string(Utf8.begin(), Utf8.end());
+    }
+
+    std::string EscapeJsonString(const std::string& Value)
+    {
+        std::string Result;
+        Result.reserve(Value.size());
+        for (const char Character : Value)
+        {
+            if (Character == '"' || Character == '\\')
+            {
+                Result.push_back('\\');
+            }
+            Result.push_back(Character);
+        }
+        return Result;
+    }
+
+    // Nearest-rank percentile of an ascending series, as the render graph's timing capture reports it.
+    double GetPercentile(const std::vector<double>& Sorted, double Percent)
+    {
+        if (Sorted.empty())
+        {
+            return 0.0;
+        }
+
+        const double Rank = std::ceil(Percent / 100.0 * static_cast<double>(Sorted.size()));
+        const size_t Index = static_cast<size_t>((std::max)(1.0, Rank)) - 1;
+        return Sorted[(std::min)(Index, Sorted.size() - 1)];
+    }
+
+    void WriteSeriesStats(std::ofstream& Json, const char* Label, std::vector<double> Values)
+    {
+        std::sort(Values.begin(), Values.end());
+        double Sum = 0.0;
+        for (double Value : Values)
+        {
+            Sum += Value;
+        }
+
+        Json << "  \"" << Label << "\": { \"samples\": " << Values.size();
+        if (!Values.empty())
+        {
+            Json << ", \"mean\": " << Sum / static_cast<double>(Values.size())
+                << ", \"min\": " << Values.front()
+                << ", \"p50\": " << GetPercentile(Values, 50.0)
+                << ", \"p95\": " << GetPercentile(Values, 95.0)
+                << ", \"p99\": " << GetPercentile(Values, 99.0)
+                << ", \"max\": " << Values.back();
+        }
+        Json << " },\n";
+    }
+
+    FFloat3 LerpFloat3(const FFloat3& A, const FFloat3& B, float Alpha)
+    {
+        return FFloat3(A.x + (B.x - A.x) * Alpha, A.y + (B.y - A.y) * Alpha, A.z + (B.z - A.z) * Alpha);
+    }
+
+    std::wstring BuildPassCaptureStem(const std::wstring& OutputPath)
+    {
+        std::filesystem::path Stem(OutputPath);
+        Stem.replace_extension();
+        Stem += L"_Passes";
+        return Stem.wstring();
+    }
+}
+
+void FBenchmarkRunner::Initialize(const FBenchmarkSettings& InSettings, std::vector<FSceneCameraKeyframe> InCameraPath)
+{
+    Settings = InSettings;
+    Settings.FrameCount = (std::max)(1u, Settings.FrameCount);
+    Frames.assign(Settings.FrameCount, {});
+    CurrentFrame = 0;
+    FramesStarted = 0;
+    ResolvedGpuFrames = 0;
+    DrainFrames = 0;
+    bFinished = false;
+
+    CameraPath.clear();
+    CameraPath.reserve(InCameraPath.size());
+    for (const FSceneCameraKeyframe& Keyframe : InCameraPath)
+    {
+        FPathKey& Key = CameraPath.emplace_back();
+        Key.TimeSeconds = Keyframe.TimeSeconds;
+        Key.Position = Keyframe.Camera.Position;
+        Key.Forward = GetSceneCameraForward(Keyframe.Camera, FFloat3(0.0f, 0.0f, 1.0f));
+        Key.FovYDegrees = Keyframe.Camera.FovYDegrees;
+    }
+
+    LogInfo("Benchmark: " + std::to_string(Settings.WarmupFrames) + " warmup and " + std::to_string(Settings.FrameCount)
+        + " measured frames at " + std::to_string(Settings.Width) + "x" + std::to_string(Settings.Height)
+        + ", " + std::to_string(CameraPath.size()) + " camera path keys");
+}
+
+bool FBenchmarkRunner::IsMeasuredFrame(uint32_t FrameIndex) const
+{
+    return FrameIndex >= Settings.WarmupFrames && FrameIndex - Settings.WarmupFrames < Settings.FrameCount;
+}
+
+uint32_t FBenchmarkRunner::BeginFrame()
+{
+    CurrentFrame = FramesStarted++;
+
+    if (CurrentFrame == Settings.WarmupFrames)
+    {
+        // Per-pass statistics cover the measured frames only, so the warmup samples are dropped
+        // and the window is widened past the length of the run.
+        FRenderGraph::ResetGpuTimingStats();
+        FRenderGraph::SetGpuTimingWindowSeconds(static_cast<double>(Settings.FrameCount) * 10.0);
+        FRenderGraph::BeginTimingCapture(Settings.FrameCount, ToUtf8(BuildPassCaptureStem(Settings.OutputPath)));
+        LogInfo("Benchmark: warmup complete, measuring");
+    }
+
+    return CurrentFrame;
+}
+
+void FBenchmarkRunner::SampleCamera(FFloat3& OutPosition, FFloat3& OutForward, float& OutFovYDegrees) const
+{
+    if (CameraPath.empty())
+    {
+        return;
+    }
+
+    const uint32_t MeasuredFrame = CurrentFrame > Settings.WarmupFrames ? CurrentFrame - Settings.WarmupFrames : 0;
+    const double PathTime = CameraPath.front().TimeSeconds + static_cast<double>(MeasuredFrame) * FixedDeltaSeconds;
+
+    const auto Next = std::upper_bound(CameraPath.begin(), CameraPath.end(), PathTime,
+        [](double Time, const FPathKey& Key)
+        {
+            return Time < Key.TimeSeconds;
+        });
+
+    if (Next == CameraPath.begin() || Next == CameraPath.end())
+    {
+        const FPathKey& Key = Next == CameraPath.end() ? CameraPath.back() : CameraPath.front();
+        OutPosition = Key.Position;
+        OutForward = Key.Forward;
+        OutFovYDegrees = Key.FovYDegrees;
+        return;
+    }
+
+    const FPathKey& From = *(Next - 1);
+    const FPathKey& To = *Next;
+    const double Span = To.TimeSeconds - From.TimeSeconds;
+    const float Alpha = Span > 0.0 ? static_cast<float>((PathTime - From.TimeSeconds) / Span) : 1.0f;
+
+    OutPosition = LerpFloat3(From.Position, To.Position, Alpha);
+    OutFovYDegrees = From.FovYDegrees + (To.FovYDegrees - From.FovYDegrees) * Alpha;
+
+    const FFloat3 BlendedForward = LerpFloat3(From.Forward, To.Forward, Alpha);
+    const DirectX::XMVECTOR Forward = DirectX::XMLoadFloat3(&BlendedForward);
+    const float LengthSq = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(Forward));
+    if (LengthSq > 1e-8f)
+    {
+        DirectX::XMStoreFloat3(&OutForward, DirectX::XMVector3Normalize(Forward));
+    }
+    else
+    {
+        OutForward = Alpha < 0.5f ? From.Forward : To.Forward;
+    }
+}
+
+void FBenchmarkRunner::EndFrame(double CpuMilliseconds)
+{
+    if (IsMeasuredFrame(CurrentFrame))
+    {
+        Frames[CurrentFrame - Settings.WarmupFrames].CpuMs = CpuMilliseconds;
+    }
+
+    if (CurrentFrame + 1 < Settings.WarmupFrames + Settings.FrameCount)
+    {
+        return;
+    }
+
+    if (ResolvedGpuFrames >= Settings.FrameCount)
+    {
+        bFinished = true;
+        return;
+    }
+
+    if (DrainFrames++ >= MaxDrainFrames)
+    {
+        LogWarning("Benchmark: " + std::to_string(Settings.FrameCount - ResolvedGpuFrames) + " frames have no GPU time");
+        bFinished = true;
+    }
+}
+
+void FBenchmarkRunner::AddGpuFrameTime(uint32_t FrameIndex, double GpuMilliseconds)
+{
+    if (!IsMeasuredFrame(FrameIndex))
+    {
+        return;
+    }
+
+    FFrameTiming& Frame = Frames[FrameIndex - Settings.WarmupFrames];
+    if (Frame.GpuMs < 0.0)
+    {
+        ++ResolvedGpuFrames;
+    }
+    Frame.GpuMs = GpuMilliseconds;
+}
+
+void FBenchmarkRunner::AddGpuCullingStats(const FRenderer& Renderer)
+{
+    FRenderer::FGpuCullingStats Stats;
+    if (!IsMeasuredFrame(CurrentFrame) || !Renderer.GetGpuCullingStats(Stats))
+    {
+        return;
+    }
+
+    CullingTotals.ModelsTested += Stats.ModelsTested;
+    CullingTotals.FrustumCulled += Stats.FrustumCulled;
+    CullingTotals.OcclusionCulled += Stats.OcclusionCulled;
+    CullingTotals.SmallCulled += Stats.SmallCulled;
+    CullingTotals.DrawCommands += Stats.DrawCommands;
+    CullingTotals.TrianglesSubmitted += Stats.TrianglesSubmitted;
+    ++CullingTotals.SampleCount;
+}
+
+int32_t FBenchmarkRunner::WriteReport() const
+{
+    if (!bFinished)
+    {
+        LogError("Benchmark ended after " + std::to_string(FramesStarted) + " frames, before the run completed");
+        return 1;
+    }
+
+    const std::filesystem::path OutputPath(Settings.OutputPath);
+    if (OutputPath.has_parent_path())
+    {
+        std::error_code Error;
+        std::filesystem::create_directories(OutputPath.parent_path(), Error);
+    }
+
+    std::ofstream Json(OutputPath, std::ios::trunc);
+    if (!Json)
+    {
+        LogError("Failed to write benchmark report: " + ToUtf8(Settings.OutputPath));
+        return 1;
+    }
+
+    std::vector<double> CpuMs;
+    std::vector<double> GpuMs;
+    CpuMs.reserve(Frames.size());
+    GpuMs.reserve(Frames.size());
+    for (const FFrameTiming& Frame : Frames)
+    {
+        if (Frame.CpuMs >= 0.0)
+        {
+            CpuMs.push_back(Frame.CpuMs);
+        }
+        if (Frame.GpuMs >= 0.0)
+        {
+            GpuMs.push_back(Frame.GpuMs);
+        }
+    }
+
+    Json << std::fixed << std::setprecision(4);
+    Json << "{\n";
+    Json << "  \"scene\": \"" << EscapeJsonString(ToUtf8(Settings.ScenePath)) << "\",\n";
+    Json << "  \"renderer\": \"" << EscapeJsonString(Settings.RendererName) << "\",\n";
+    Json << "  \"width\": " << Settings.Width << ",\n  \"height\": " << Settings.Height << ",\n";
+    Json << "  \"warmupFrames\": " << Settings.WarmupFrames << ",\n  \"frameCount\": " << Settings.FrameCount << ",\n";
+    Json << "  \"fixedDeltaSeconds\": " << FixedDeltaSeconds << ",\n";
+    Json << "  \"cameraPathKeys\": " << CameraPath.size() << ",\n";
+    WriteSeriesStats(Json, "cpu", CpuMs);
+    WriteSeriesStats(Json, "gpu", GpuMs);
+
+    const std::vector<FRenderGraph::FGpuPassTimingStats>& PassStats = FRenderGraph::GetGpuTimingStats();
+    Json << "  \"passes\": [\n";
+    for (size_t Index = 0; Index < PassStats.size(); ++Index)
+    {
+        const FRenderGraph::FGpuPassTimingStats& Stats = PassStats[Index];
+        Json << "    { \"name\": \"" << EscapeJsonString(Stats.Name) << "\", \"queue\": \""
+            << (Stats.Queue == ERGPassQueue::AsyncCompute ? "Compute" : "Graphics") << "\""
+            << ", \"samples\": " << Stats.SampleCount
+            << ", \"avg\": " << Stats.AvgMs
+            << ", \"min\": " << Stats.MinMs
+            << ", \"max\": " << Stats.MaxMs << " }"
+            << (Index + 1 < PassStats.size() ? "," : "") << "\n";
+    }
+    Json << "  ],\n";
+
+    const std::vector<FRenderGraph::FGpuPassPipelineStats>& PipelineStats = FRenderGraph::GetPipelineStats();
+    if (!PipelineStats.empty())
+    {
+        Json << "  \"pipelineStatistics\": [\n";
+        for (size_t Index = 0; Index < PipelineStats.size(); ++Index)
+        {
+            const FRenderGraph::FGpuPassPipelineStats& Stats = PipelineStats[Index];
+            Json << "    { \"name\": \"" << EscapeJsonString(Stats.Name) << "\""
+                << ", \"samples\": " << Stats.SampleCount
+                << ", \"iaPrimitives\": " << Stats.IAPrimitives
+                << ", \"vsInvocations\": " << Stats.VSInvocations
+                << ", \"psInvocations\": " << Stats.PSInvocations
+                << ", \"clippedPrimitives\": " << Stats.ClippedPrimitives
+                << ", \"csInvocations\": " << Stats.CSInvocations << " }"
+                << (Index + 1 < PipelineStats.size() ? "," : "") << "\n";
+        }
+        Json << "  ],\n";
+    }
+
+    if (CullingTotals.SampleCount > 0)
+    {
+        const double SampleCount = static_cast<double>(CullingTotals.SampleCount);
+        Json << "  \"gpuCulling\": { \"samples\": " << CullingTotals.SampleCount
+            << ", \"modelsTested\": " << static_cast<double>(CullingTotals.ModelsTested) / SampleCount
+            << ", \"frustumCulled\": " << static_cast<double>(CullingTotals.FrustumCulled) / SampleCount
+            << ", \"occlusionCulled\": " << static_cast<double>(CullingTotals.OcclusionCulled) / SampleCount
+            << ", \"smallCulled\": " << static_cast<double>(CullingTotals.SmallCulled) / SampleCount
+            << ", \"drawCommands\": " << static_cast<double>(CullingTotals.DrawCommands) / SampleCount
+            << ", \"trianglesSubmitted\": " << static_cast<double>(CullingTotals.TrianglesSubmitted) / SampleCount << " },\n";
+    }
+
+    Json << "  \"passCapture\":\"" << EscapeJsonString(FRenderGraph::GetLastTimingCapturePath()) << "\",\n";
+
+    Json << "  \"frames\": [\n";
+    for (size_t Index = 0; Index < Frames.size(); ++Index)
+    {
+        const FFrameTiming& Frame = Frames[Index];
+        Json << "    { \"cpu\": " << Frame.CpuMs;
+        if (Frame.GpuMs >= 0.0)
+        {
+            Json << ", \"gpu\": " << Frame.GpuMs;
+        }
+        Json << " }" << (Index + 1 < Frames.size() ? "," : "") << "\n";
+    }
+    Json << "  ]\n}\n";
+
+    if (!Json)
+    {
+        LogError("Failed to write benchmark report: " + ToUtf8(Settings.OutputPath));
+        return 1;
+    }
+
+    LogInfo("Benchmark report written: " + ToUtf8(Settings.OutputPath));
+    return GpuMs.size() == Frames.size() ? 0 : 2;
+}
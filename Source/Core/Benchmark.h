@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Scene/SceneJsonLoader.h"
+
+class FRenderer;
+
+struct FBenchmarkSettings
+{
+    std::wstring ScenePath;
+    std::string RendererName;
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    uint32_t WarmupFrames = 0;
+    uint32_t FrameCount = 0;
+    std::wstring OutputPath;
+};
+
+/**
+ * Reproducible performance run: WarmupFrames frames hold the first key of the camera path so
+ * caches, streaming and TAA history settle, then FrameCount measured frames play the path at
+ * FixedDeltaSeconds per frame whatever the real frame time. GPU frame times come back a few
+ * frames late, so after the last measured frame the run keeps rendering until all of them have
+ * arrived, and only then writes the report: per-frame CPU and GPU times, their percentiles and
+ * the per-pass GPU statistics of the render graph over the measured frames. With pipeline
+ * statistics enabled the report also carries each pass's averaged statistics and the averaged
+ * GPU culling counters.
+ */
+class FBenchmarkRunner
+{
+public:
+    static constexpr double FixedDeltaSeconds = 1.0 / 60.0;
+    // Frames rendered past the last measured one while waiting for its GPU time.
+    static constexpr uint32_t MaxDrainFrames = 16;
+
+    // An empty path keeps the camera the scene placed.
+    void Initialize(const FBenchmarkSettings& InSettings, std::vector<FSceneCameraKeyframe> InCameraPath);
+
+    bool HasCameraPath() const { return !CameraPath.empty(); }
+    bool IsFinished() const { return bFinished; }
+
+    // Starts the next frame and returns its run-wide index, which AddGpuFrameTime takes back.
+    uint32_t BeginFrame();
+    // Camera of the frame BeginFrame started, interpolated between the keys around its path time.
+    void SampleCamera(FFloat3& OutPosition, FFloat3& OutForward, float& OutFovYDegrees) const;
+    void EndFrame(double CpuMilliseconds);
+    void AddGpuFrameTime(uint32_t FrameIndex, double GpuMilliseconds);
+    // Adds Renderer's latest GPU culling counters to the averages when the current frame is measured.
+    void AddGpuCullingStats(const FRenderer& Renderer);
+
+    // Writes the report and returns the process exit code: 0 when every measured frame has both
+    // times, 2 when some lack a GPU time, 1 when the run did not finish or the report failed.
+    int32_t WriteReport() const;
+
+private:
+    struct FFrameTiming
+    {
+        double CpuMs = -1.0;
+        double GpuMs = -1.0;
+    };
+
+    struct FPathKey
+    {
+        double TimeSeconds = 0.0;
+        FFloat3 Position{ 0.0f, 0.0f, 0.0f };
+        FFloat3 Forward{ 0.0f, 0.0f, 1.0f };
+        float FovYDegrees = 60.0f;
+    };
+
+    struct FCullingTotals
+    {
+        uint64_t ModelsTested = 0;
+        uint64_t FrustumCulled = 0;
+        uint64_t OcclusionCulled = 0;
+        uint64_t SmallCulled = 0;
+        uint64_t DrawCommands = 0;
+        uint64_t TrianglesSubmitted = 0;
+        uint32_t SampleCount = 0;
+    };
+
+    bool IsMeasuredFrame(uint32_t FrameIndex) const;
+
+    FBenchmarkSettings Settings;
+    std::vector<FPathKey> CameraPath;
+    std::vector<FFrameTiming> Frames;
+    FCullingTotals CullingTotals;
+    uint32_t CurrentFrame = 0;
+    uint32_t FramesStarted = 0;
+    uint32_t ResolvedGpuFrames = 0;
+    uint32_t DrainFrames = 0;
+    bool bFinished = false;
+};
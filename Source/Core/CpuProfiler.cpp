@@ -0,0 +1,282 @@
+#include "CpuProfiler.h"
+
+#include "Logger.h"
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+std::atomic<bool> FCpuProfiler::bEnabled{ false };
+
+namespace
+{
+    struct FThreadZoneBuffer
+    {
+        std::string ThreadName;
+        uint32_t ThreadId = 0;
+        // Zones written so far; the ring holds the last ZonesPerThread of them.
+        std::atomic<uint64_t> WriteCount{ 0 };
+        FCpuProfileZone Zones[FCpuProfiler::ZonesPerThread];
+    };
+
+    static_assert((FCpuProfiler::ZonesPerThread & (FCpuProfiler::ZonesPerThread - 1)) == 0, "ZonesPerThread must be a power of two");
+
+    // Buffers outlive their threads, so zones of finished loader tasks stay visible.
+    std::mutex BufferRegistryMutex;
+    std::vector<std::unique_ptr<FThreadZoneBuffer>> BufferRegistry;
+
+    std::mutex InternedNamesMutex;
+    std::unordered_set<std::string> InternedNames;
+
+    int64_t FrameStarts[FCpuProfiler::FrameHistory] = {};
+    std::atomic<uint64_t> FrameMarkCount{ 0 };
+
+    thread_local FThreadZoneBuffer* GThreadBuffer = nullptr;
+    thread_local uint32_t GZoneDepth = 0;
+
+    FThreadZoneBuffer& GetThreadBuffer()
+    {
+        if (!GThreadBuffer)
+        {
+            auto Buffer = std::make_unique<FThreadZoneBuffer>();
+            Buffer->ThreadId = static_cast<uint32_t>(GetCurrentThreadId());
+            Buffer->ThreadName = "Thread " + std::to_string(Buffer->ThreadId);
+
+            std::lock_guard<std::mutex> Lock(BufferRegistryMutex);
+            GThreadBuffer = Buffer.get();
+            BufferRegistry.push_back(std::move(Buffer));
+        }
+        return *GThreadBuffer;
+    }
+
+    // Copies the zones of Buffer that close after MinEndNs, newest first, leaving out those the
+    // writer overwrote while they were copied. Rings hold zones in closing order, so the scan stops
+    // at the first older one.
+    void CopyZones(const FThreadZoneBuffer& Buffer, int64_t MinEndNs, std::vector<FCpuProfileZone>& OutZones)
+    {
+        const uint64_t WriteCount = Buffer.WriteCount.load(std::memory_order_acquire);
+        const uint64_t First = WriteCount > FCpuProfiler::ZonesPerThread ? WriteCount - FCpuProfiler::ZonesPerThread : 0;
+
+        uint64_t Index = WriteCount;
+        while (Index > First)
+        {
+            const FCpuProfileZone& Zone = Buffer.Zones[(Index - 1) & (FCpuProfiler::ZonesPerThread - 1)];
+            if (Zone.EndNs <= MinEndNs)
+            {
+                break;
+            }
+            OutZones.push_back(Zone);
+            --Index;
+        }
+
+        // The writer may have lapped the oldest entries, and be writing the next one, meanwhile.
+        const uint64_t WriteCountAfter = Buffer.WriteCount.load(std::memory_order_acquire);
+        const uint64_t FirstIntact = WriteCountAfter + 1 > FCpuProfiler::ZonesPerThread ? WriteCountAfter + 1 - FCpuProfiler::ZonesPerThread : 0;
+        for (uint64_t Lost = Index; Lost < FirstIntact && !OutZones.empty() && Lost < WriteCount; ++Lost)
+        {
+            OutZones.pop_back();
+        }
+    }
+
+    std::string EscapeJsonString(const std::string& Value)
+    {
+        std::string Result;
+        Result.reserve(Value.size());
+        for (const char Character : Value)
+        {
+            if (Character == '"' || Character == '\\')
+            {
+                Result.push_back('\\');
+            }
+            Result.push_back(Character);
+        }
+        return Result;
+    }
+}
+
+void FCpuProfiler::SetThreadName(const char* Name)
+{
+    FThreadZoneBuffer& Buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> Lock(BufferRegistryMutex);
+    Buffer.ThreadName = Name ? Name : "";
+}
+
+void FCpuProfiler::MarkFrame()
+{
+    if (!IsEnabled())
+    {
+        return;
+    }
+
+    const uint64_t Index = FrameMarkCount.load(std::memory_order_relaxed);
+    FrameStarts[Index % FrameHistory] = GetTimestampNs();
+    FrameMarkCount.store(Index + 1, std::memory_order_release);
+}
+
+int64_t FCpuProfiler::GetTimestampNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* FCpuProfiler::InternName(std::string_view Name)
+{
+    std::lock_guard<std::mutex> Lock(InternedNamesMutex);
+    return InternedNames.emplace(Name).first->c_str();
+}
+
+bool FCpuProfiler::GetFrameRange(uint32_t FramesAgo, int64_t& OutBeginNs, int64_t& OutEndNs)
+{
+    const uint64_t MarkCount = FrameMarkCount.load(std::memory_order_acquire);
+    // The newest mark starts the frame in progress, and the oldest slot is the next to be reused.
+    if (MarkCount < static_cast<uint64_t>(FramesAgo) + 2 || static_cast<uint64_t>(FramesAgo) + 2 >= FrameHistory)
+    {
+        return false;
+    }
+
+    const uint64_t FrameIndex = MarkCount - 2 - FramesAgo;
+    OutBeginNs = FrameStarts[FrameIndex % FrameHistory];
+    OutEndNs = FrameStarts[(FrameIndex + 1) % FrameHistory];
+    return OutEndNs > OutBeginNs;
+}
+
+void FCpuProfiler::GetZones(int64_t BeginNs, int64_t EndNs, std::vector<FCpuProfileThreadZones>& OutThreads)
+{
+    OutThreads.clear();
+
+    std::vector<FCpuProfileZone> Zones;
+    std::lock_guard<std::mutex> Lock(BufferRegistryMutex);
+    OutThreads.reserve(BufferRegistry.size());
+    for (const std::unique_ptr<FThreadZoneBuffer>& Buffer : BufferRegistry)
+    {
+        Zones.clear();
+        CopyZones(*Buffer, BeginNs, Zones);
+
+        FCpuProfileThreadZones Thread;
+        for (const FCpuProfileZone& Zone : Zones)
+        {
+            if (Zone.StartNs < EndNs)
+            {
+                Thread.Zones.push_back(Zone);
+            }
+        }
+
+        if (Thread.Zones.empty())
+        {
+            continue;
+        }
+
+        // Zones are written as they close, so parents follow their children.
+        std::sort(Thread.Zones.begin(), Thread.Zones.end(), [](const FCpuProfileZone& A, const FCpuProfileZone& B)
+        {
+            return A.StartNs != B.StartNs ? A.StartNs < B.StartNs : A.Depth < B.Depth;
+        });
+        Thread.ThreadName = Buffer->ThreadName;
+        Thread.ThreadId = Buffer->ThreadId;
+        OutThreads.push_back(std::move(Thread));
+    }
+}
+
+bool FCpuProfiler::ExportChromeTrace(const std::string& Path)
+{
+    std::vector<FCpuProfileThreadZones> Threads;
+    GetZones((std::numeric_limits<int64_t>::min)(), (std::numeric_limits<int64_t>::max)(), Threads);
+
+    int64_t OriginNs = (std::numeric_limits<int64_t>::max)();
+    for (const FCpuProfileThreadZones& Thread : Threads)
+    {
+        OriginNs = (std::min)(OriginNs, Thread.Zones.front().StartNs);
+    }
+
+    const std::filesystem::path OutputPath(Path);
+    if (OutputPath.has_parent_path())
+    {
+        std::error_code Error;
+        std::filesystem::create_directories(OutputPath.parent_path(), Error);
+    }
+
+    std::ofstream Json(OutputPath, std::ios::trunc);
+    if (!Json)
+    {
+        LogError("Failed to write CPU trace: " + Path);
+        return false;
+    }
+
+    // Trace timestamps are microseconds.
+    auto ToMicroseconds = [OriginNs](int64_t Ns)
+    {
+        return static_cast<double>(Ns - OriginNs) / 1000.0;
+    };
+
+    Json << std::fixed;
+    Json.precision(3);
+    Json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool bFirstEvent = true;
+    auto BeginEvent = [&Json, &bFirstEvent]() -> std::ofstream&
+    {
+        Json << (bFirstEvent ? "" : ",\n");
+        bFirstEvent = false;
+        return Json;
+    };
+
+    for (const FCpuProfileThreadZones& Thread : Threads)
+    {
+        BeginEvent() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << Thread.ThreadId
+            << ",\"args\":{\"name\":\"" << EscapeJsonString(Thread.ThreadName) << "\"}}";
+
+        for (const FCpuProfileZone& Zone : Thread.Zones)
+        {
+            BeginEvent() << "{\"name\":\"" << EscapeJsonString(Zone.Name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << Thread.ThreadId
+                << ",\"ts\":" << ToMicroseconds(Zone.StartNs) << ",\"dur\":" << static_cast<double>(Zone.EndNs - Zone.StartNs) / 1000.0 << "}";
+        }
+    }
+
+    const uint64_t MarkCount = FrameMarkCount.load(std::memory_order_acquire);
+    const uint64_t FirstMark = MarkCount > FrameHistory - 1 ? MarkCount - (FrameHistory - 1) : 0;
+    for (uint64_t Index = FirstMark; Index < MarkCount && !Threads.empty(); ++Index)
+    {
+        const int64_t MarkNs = FrameStarts[Index % FrameHistory];
+        if (MarkNs >= OriginNs)
+        {
+            BeginEvent() << "{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":" << ToMicroseconds(MarkNs) << "}";
+        }
+    }
+
+    Json << "\n]}\n";
+    if (!Json)
+    {
+        LogError("Failed to write CPU trace: " + Path);
+        return false;
+    }
+
+    LogInfo("CPU trace written: " + Path);
+    return true;
+}
+
+uint32_t FCpuProfiler::BeginZone()
+{
+    return GZoneDepth++;
+}
+
+void FCpuProfiler::EndZone(const char* Name, int64_t StartNs, uint32_t Depth)
+{
+    GZoneDepth = Depth;
+
+    FThreadZoneBuffer& Buffer = GetThreadBuffer();
+    const uint64_t Index = Buffer.WriteCount.load(std::memory_order_relaxed);
+    FCpuProfileZone& Zone = Buffer.Zones[Index & (ZonesPerThread - 1)];
+    Zone.Name = Name;
+    Zone.StartNs = StartNs;
+    Zone.EndNs = GetTimestampNs();
+    Zone.Depth = Depth;
+    Buffer.WriteCount.store(Index + 1, std::memory_order_release);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Builds define WITH_CPU_PROFILER=0 to compile every zone out.
+#ifndef WITH_CPU_PROFILER
+#define WITH_CPU_PROFILER 1
+#endif
+
+struct FCpuProfileZone
+{
+    const char* Name = nullptr;
+    int64_t StartNs = 0;
+    int64_t EndNs = 0;
+    uint32_t Depth = 0;
+};
+
+struct FCpuProfileThreadZones
+{
+    std::string ThreadName;
+    uint32_t ThreadId = 0;
+    std::vector<FCpuProfileZone> Zones;
+};
+
+/**
+ * Scoped CPU zones on per-thread timelines. Each thread writes the zones it closes into its own
+ * ring buffer without locking, so recording costs two clock reads and a store; readers copy the
+ * rings and drop the entries the writer may have overwritten meanwhile. Zone names must outlive
+ * the profiler: string literals, or names passed through InternName. The main thread marks
+ * frame starts, which the timeline view and the trace export use to split the rings into frames.
+ */
+class FCpuProfiler
+{
+public:
+    // Zones kept per thread; the oldest are overwritten first.
+    static constexpr uint32_t ZonesPerThread = 8192;
+    static constexpr uint32_t FrameHistory = 256;
+
+    static void SetEnabled(bool bEnable) { bEnabled.store(bEnable, std::memory_order_relaxed); }
+    static bool IsEnabled() { return bEnabled.load(std::memory_order_relaxed); }
+
+    // Names the calling thread's timeline.
+    static void SetThreadName(const char* Name);
+    static void MarkFrame();
+    static int64_t GetTimestampNs();
+    // Stable copy of Name for zones named at runtime, such as render graph passes.
+    static const char* InternName(std::string_view Name);
+
+    // Start and end of the FramesAgo-th most recent complete frame; false when not recorded.
+    static bool GetFrameRange(uint32_t FramesAgo, int64_t& OutBeginNs, int64_t& OutEndNs);
+    // Zones of every thread overlapping [BeginNs, EndNs), each thread's sorted by start time.
+    static void GetZones(int64_t BeginNs, int64_t EndNs, std::vector<FCpuProfileThreadZones>& OutThreads);
+    // Every buffered zone and frame mark in the chrome://tracing JSON format.
+    static bool ExportChromeTrace(const std::string& Path);
+
+    static uint32_t BeginZone();
+    static void EndZone(const char* Name, int64_t StartNs, uint32_t Depth);
+
+private:
+    static std::atomic<bool> bEnabled;
+};
+
+class FCpuProfileScope
+{
+public:
+    explicit FCpuProfileScope(const char* InName)
+        : Name(InName)
+    {
+        if (Name && FCpuProfiler::IsEnabled())
+        {
+            Depth = FCpuProfiler::BeginZone();
+            StartNs = FCpuProfiler::GetTimestampNs();
+            bActive = true;
+        }
+    }
+
+    ~FCpuProfileScope()
+    {
+        if (bActive)
+        {
+            FCpuProfiler::EndZone(Name, StartNs, Depth);
+        }
+    }
+
+    FCpuProfileScope(const FCpuProfileScope&) = delete;
+    FCpuProfileScope& operator=(const FCpuProfileScope&) = delete;
+
+private:
+    const char* Name;
+    int64_t StartNs = 0;
+    uint32_t Depth = 0;
+    bool bActive = false;
+};
+
+#if WITH_CPU_PROFILER
+#define CPU_PROFILE_CONCAT_INNER(A, B) A##B
+#define CPU_PROFILE_CONCAT(A, B) CPU_PROFILE_CONCAT_INNER(A, B)
+#define CPU_PROFILE_SCOPE(Name) FCpuProfileScope CPU_PROFILE_CONCAT(CpuProfileScope, __LINE__)(Name)
+// Interns Name only while profiling, for names that do not outlive the zone.
+#define CPU_PROFILE_SCOPE_DYNAMIC(Name) FCpuProfileScope CPU_PROFILE_CONCAT(CpuProfileScope, __LINE__)(FCpuProfiler::IsEnabled() ? FCpuProfiler::InternName(Name) : nullptr)
+#define CPU_PROFILE_THREAD_NAME(Name) FCpuProfiler::SetThreadName(Name)
+#define CPU_PROFILE_FRAME() FCpuProfiler::MarkFrame()
+#else
+#define CPU_PROFILE_SCOPE(Name) ((void)0)
+#define CPU_PROFILE_SCOPE_DYNAMIC(Name) ((void)0)
+#define CPU_PROFILE_THREAD_NAME(Name) ((void)0)
+#define CPU_PROFILE_FRAME() ((void)0)
+#endif
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Windows.h>
+#include <mutex>
 
 // Helper macro to detect ImGui availability at build time.
 #if defined(__has_include)
@@ -20,9 +21,18 @@
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 #endif
 
+// Window messages arrive on the game thread while the render thread builds the UI, so both
+// hold this around every ImGui call.
+inline std::mutex& GetImGuiMutex()
+{
+    static std::mutex Mutex;
+    return Mutex;
+}
+
 inline bool ImGuiHandleWin32Message(HWND Hwnd, UINT Message, WPARAM WParam, LPARAM LParam)
 {
 #if WITH_IMGUI
+    std::lock_guard<std::mutex> Lock(GetImGuiMutex());
     if (ImGui::GetCurrentContext())
     {
         return ImGui_ImplWin32_WndProcHandler(Hwnd, Message, WParam, LParam);
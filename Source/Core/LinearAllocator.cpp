@@ -0,0 +1,91 @@
+#include "LinearAllocator.h"
+#include <algorithm>
+
+FLinearAllocator::FLinearAllocator(size_t InPageSize)
+    : PageSize((std::max)(InPageSize, static_cast<size_t>(256)))
+{
+}
+
+void* FLinearAllocator::AllocateFromPage(FPage& Page, size_t Size, size_t Alignment)
+{
+    const uintptr_t Base = reinterpret_cast<uintptr_t>(Page.Memory.get());
+    const uintptr_t Aligned = (Base + PageOffset + Alignment - 1) & ~(static_cast<uintptr_t>(Alignment) - 1);
+    const size_t NewOffset = static_cast<size_t>(Aligned - Base) + Size;
+    if (NewOffset > Page.Size)
+    {
+        return nullptr;
+    }
+
+    UsedBytes += NewOffset - PageOffset;
+    PageOffset = NewOffset;
+    return reinterpret_cast<void*>(Aligned);
+}
+
+void* FLinearAllocator::Allocate(size_t Size, size_t Alignment)
+{
+    Alignment = (std::max)(Alignment, static_cast<size_t>(1));
+    Size = (std::max)(Size, static_cast<size_t>(1));
+
+    while (CurrentPage < Pages.size())
+    {
+        if (void* Result = AllocateFromPage(Pages[CurrentPage], Size, Alignment))
+        {
+            return Result;
+        }
+
+        if (CurrentPage + 1 >= Pages.size())
+        {
+            break;
+        }
+        ++CurrentPage;
+        PageOffset = 0;
+    }
+
+    FPage NewPage;
+    NewPage.Size = (std::max)(PageSize, Size + Alignment);
+    NewPage.Memory.reset(new uint8_t[NewPage.Size]);
+    Pages.push_back(std::move(NewPage));
+    CurrentPage = Pages.size() - 1;
+    PageOffset = 0;
+    return AllocateFromPage(Pages[CurrentPage], Size, Alignment);
+}
+
+std::string_view FLinearAllocator::CopyString(std::string_view Value)
+{
+    if (Value.empty())
+    {
+        return {};
+    }
+
+    char* Characters = static_cast<char*>(Allocate(Value.size(), alignof(char)));
+    std::memcpy(Characters, Value.data(), Value.size());
+    return std::string_view(Characters, Value.size());
+}
+
+void FLinearAllocator::Reset()
+{
+    if (Pages.size() > 1)
+    {
+        const size_t Capacity = GetCapacity();
+        Pages.clear();
+
+        FPage MergedPage;
+        MergedPage.Size = Capacity;
+        MergedPage.Memory.reset(new uint8_t[Capacity]);
+        Pages.push_back(std::move(MergedPage));
+    }
+
+    CurrentPage = 0;
+    PageOffset = 0;
+    UsedBytes = 0;
+}
+
+size_t FLinearAllocator::GetCapacity() const
+{
+    size_t Capacity = 0;
+    for (const FPage& Page : Pages)
+    {
+        Capacity += Page.Size;
+    }
+    return Capacity;
+}
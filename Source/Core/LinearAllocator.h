@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Bump allocator for data that dies together, such as everything built for one frame.
+ * Allocations are never freed individually; Reset() recycles all of them at once and keeps
+ * the backing pages, so a warmed-up allocator stops touching the general heap.
+ * Destructors are not run by the allocator; owners destroy non-trivial objects themselves.
+ * Not thread-safe.
+ */
+class FLinearAllocator
+{
+public:
+    static constexpr size_t DefaultPageSize = 64 * 1024;
+
+    FLinearAllocator() : FLinearAllocator(DefaultPageSize) {}
+    explicit FLinearAllocator(size_t InPageSize);
+
+    FLinearAllocator(const FLinearAllocator&) = delete;
+    FLinearAllocator& operator=(const FLinearAllocator&) = delete;
+
+    void* Allocate(size_t Size, size_t Alignment = alignof(std::max_align_t));
+
+    template <typename T, typename... Args>
+    T* New(Args&&... Arguments)
+    {
+        return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(Arguments)...);
+    }
+
+    // Copies the characters into the allocator; the view stays valid until Reset()
+    std::string_view CopyString(std::string_view Value);
+
+    /**
+     * Recycles every allocation. When the last cycle spilled into several pages they are
+     * merged into one page large enough for all of it, so the next cycle bumps through a
+     * single block.
+     */
+    void Reset();
+
+    size_t GetUsedBytes() const { return UsedBytes; }
+    size_t GetCapacity() const;
+
+private:
+    struct FPage
+    {
+        std::unique_ptr<uint8_t[]> Memory;
+        size_t Size = 0;
+    };
+
+    void* AllocateFromPage(FPage& Page, size_t Size, size_t Alignment);
+
+    std::vector<FPage> Pages;
+    size_t PageSize = DefaultPageSize;
+    size_t CurrentPage = 0;
+    size_t PageOffset = 0;
+    size_t UsedBytes = 0;
+};
+
+/**
+ * Standard allocator adapter so containers can live in an FLinearAllocator.
+ * Deallocation is a no-op; memory comes back when the allocator is reset.
+ */
+template <typename T>
+class TLinearAllocatorAdapter
+{
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    TLinearAllocatorAdapter() = default;
+    explicit TLinearAllocatorAdapter(FLinearAllocator* InAllocator) : Allocator(InAllocator) {}
+
+    template <typename U>
+    TLinearAllocatorAdapter(const TLinearAllocatorAdapter<U>& Other) : Allocator(Other.GetAllocator()) {}
+
+    T* allocate(size_t Count)
+    {
+        if (!Allocator)
+        {
+            return static_cast<T*>(::operator new(Count * sizeof(T)));
+        }
+        return static_cast<T*>(Allocator->Allocate(Count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* Pointer, size_t)
+    {
+        if (!Allocator)
+        {
+            ::operator delete(Pointer);
+        }
+    }
+
+    FLinearAllocator* GetAllocator() const { return Allocator; }
+
+    template <typename U>
+    bool operator==(const TLinearAllocatorAdapter<U>& Other) const { return Allocator == Other.GetAllocator(); }
+
+    template <typename U>
+    bool operator!=(const TLinearAllocatorAdapter<U>& Other) const { return Allocator != Other.GetAllocator(); }
+
+private:
+    FLinearAllocator* Allocator = nullptr;
+};
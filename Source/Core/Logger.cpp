@@ -5,39 +5,12 @@
 #include <fstream>
 #include <mutex>
 #include <atomic>
+#include <thread>
 
 namespace
 {
-    std::once_flag GLogInitFlag;
-    std::ofstream GLogFile;
     std::atomic<ELogLevel> GCurrentLogLevel = ELogLevel::Info;
 
-    void InitializeLogFile()
-    {
-        std::call_once(GLogInitFlag, []
-            {
-                char Path[MAX_PATH] = {};
-                if (GetModuleFileNameA(nullptr, Path, MAX_PATH) == 0)
-                {
-                    return;
-                }
-
-                std::filesystem::path LogPath(Path);
-                LogPath = LogPath.parent_path() / "UncleRenderer.log";
-
-                GLogFile.open(LogPath, std::ios::out | std::ios::app);
-                if (GLogFile.is_open())
-                {
-                    SYSTEMTIME SystemTime;
-                    GetLocalTime(&SystemTime);
-                    GLogFile << "\n----- Log Start "
-                             << SystemTime.wYear << "-" << SystemTime.wMonth << "-" << SystemTime.wDay << " "
-                             << SystemTime.wHour << ":" << SystemTime.wMinute << ":" << SystemTime.wSecond
-                             << " -----\n";
-                }
-            });
-    }
-
     const char* GetPrefix(ELogLevel Level)
     {
         switch (Level)
@@ -50,29 +23,279 @@ namespace
         }
     }
 
-    bool ShouldLog(ELogLevel Level)
+    std::string FormatLine(ELogLevel Level, const std::string& Message)
     {
-        return static_cast<int>(Level) >= static_cast<int>(GCurrentLogLevel.load());
+        return std::string("[UncleRenderer] ") + GetPrefix(Level) + Message + "\n";
     }
-}
 
-void LogMessage(ELogLevel Level, const std::string& Message)
-{
-    if (!ShouldLog(Level))
+    /**
+     * Bounded multi-producer queue after Vyukov: each slot carries a sequence number that tells
+     * producers whether it is free for their ticket and the writer whether it has been filled,
+     * so producers only contend on one compare-exchange and never wait for each other.
+     */
+    class FLogQueue
     {
-        return;
-    }
+    public:
+        static constexpr uint64_t Capacity = 8192;
 
-    const std::string Output = std::string("[UncleRenderer] ") + GetPrefix(Level) + Message + "\n";
+        FLogQueue()
+        {
+            for (uint64_t Index = 0; Index < Capacity; ++Index)
+            {
+                Slots[Index].Sequence.store(Index, std::memory_order_relaxed);
+            }
+        }
+
+        bool TryPush(ELogLevel Level, std::string&& Message)
+        {
+            uint64_t Position = EnqueuePosition.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                FSlot& Slot = Slots[Position & IndexMask];
+                const uint64_t Sequence = Slot.Sequence.load(std::memory_order_acquire);
+                const int64_t Difference = static_cast<int64_t>(Sequence) - static_cast<int64_t>(Position);
+                if (Difference == 0)
+                {
+                    if (EnqueuePosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+                    {
+                        Slot.Level = Level;
+                        Slot.Message = std::move(Message);
+                        Slot.Sequence.store(Position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (Difference < 0)
+                {
+                    // The writer has not emptied this slot since the previous lap: the queue is full.
+                    return false;
+                }
+                else
+                {
+                    Position = EnqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
 
-    InitializeLogFile();
-    if (GLogFile.is_open())
+        // Writer thread only.
+        bool TryPop(ELogLevel& OutLevel, std::string& OutMessage)
+        {
+            const uint64_t Position = DequeuePosition.load(std::memory_order_relaxed);
+            FSlot& Slot = Slots[Position & IndexMask];
+            if (Slot.Sequence.load(std::memory_order_acquire) != Position + 1)
+            {
+                return false;
+            }
+
+            OutLevel = Slot.Level;
+            OutMessage = std::move(Slot.Message);
+            Slot.Message.clear();
+            Slot.Sequence.store(Position + Capacity, std::memory_order_release);
+            DequeuePosition.store(Position + 1, std::memory_order_release);
+            return true;
+        }
+
+        uint64_t GetEnqueuePosition() const { return EnqueuePosition.load(std::memory_order_acquire); }
+        uint64_t GetDequeuePosition() const { return DequeuePosition.load(std::memory_order_acquire); }
+
+    private:
+        static constexpr uint64_t IndexMask = Capacity - 1;
+        static_assert((Capacity & IndexMask) == 0, "Capacity must be a power of two");
+
+        struct FSlot
+        {
+            std::atomic<uint64_t> Sequence{ 0 };
+            ELogLevel Level = ELogLevel::Info;
+            std::string Message;
+        };
+
+        FSlot Slots[Capacity];
+        alignas(64) std::atomic<uint64_t> EnqueuePosition{ 0 };
+        alignas(64) std::atomic<uint64_t> DequeuePosition{ 0 };
+    };
+
+    class FLogWriter
     {
-        GLogFile << Output;
-        GLogFile.flush();
+    public:
+        FLogWriter()
+        {
+            OpenLogFile();
+            WakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+            bRunning.store(true, std::memory_order_release);
+            Thread = std::thread(&FLogWriter::ThreadMain, this);
+        }
+
+        ~FLogWriter()
+        {
+            Stop();
+            if (WakeEvent)
+            {
+                CloseHandle(WakeEvent);
+            }
+        }
+
+        void Submit(ELogLevel Level, std::string&& Message)
+        {
+            if (!bRunning.load(std::memory_order_acquire))
+            {
+                std::lock_guard<std::mutex> Lock(SyncWriteMutex);
+                WriteLine(FormatLine(Level, Message));
+                FlushFile();
+                return;
+            }
+
+            if (!Queue.TryPush(Level, std::move(Message)))
+            {
+                DroppedCount.fetch_add(1, std::memory_order_relaxed);
+                SetEvent(WakeEvent);
+                return;
+            }
+
+            if (!bRunning.load(std::memory_order_acquire))
+            {
+                // The writer stopped after the check above and may have missed this message.
+                std::lock_guard<std::mutex> Lock(SyncWriteMutex);
+                Drain();
+                FlushFile();
+                return;
+            }
+
+            // Routine messages wait for the writer's next poll; problems are written right away.
+            if (Level >= ELogLevel::Warning)
+            {
+                SetEvent(WakeEvent);
+            }
+        }
+
+        void Flush()
+        {
+            const uint64_t Target = Queue.GetEnqueuePosition();
+            while (bRunning.load(std::memory_order_acquire) && Queue.GetDequeuePosition() < Target)
+            {
+                SetEvent(WakeEvent);
+                std::this_thread::yield();
+            }
+        }
+
+        void Stop()
+        {
+            if (!Thread.joinable())
+            {
+                return;
+            }
+
+            bStopRequested.store(true, std::memory_order_release);
+            SetEvent(WakeEvent);
+            Thread.join();
+        }
+
+    private:
+        static constexpr DWORD PollIntervalMs = 10;
+
+        void OpenLogFile()
+        {
+            char Path[MAX_PATH] = {};
+            if (GetModuleFileNameA(nullptr, Path, MAX_PATH) == 0)
+            {
+                return;
+            }
+
+            std::filesystem::path LogPath(Path);
+            LogPath = LogPath.parent_path() / "UncleRenderer.log";
+
+            LogFile.open(LogPath, std::ios::out | std::ios::app);
+            if (LogFile.is_open())
+            {
+                SYSTEMTIME SystemTime;
+                GetLocalTime(&SystemTime);
+                LogFile << "\n----- Log Start "
+                        << SystemTime.wYear << "-" << SystemTime.wMonth << "-" << SystemTime.wDay << " "
+                        << SystemTime.wHour << ":" << SystemTime.wMinute << ":" << SystemTime.wSecond
+                        << " -----\n";
+            }
+        }
+
+        void WriteLine(const std::string& Line)
+        {
+            if (LogFile.is_open())
+            {
+                LogFile << Line;
+            }
+            OutputDebugStringA(Line.c_str());
+        }
+
+        void FlushFile()
+        {
+            if (LogFile.is_open())
+            {
+                LogFile.flush();
+            }
+        }
+
+        // Writes everything queued; true when anything was written.
+        bool Drain()
+        {
+            bool bWroteAny = false;
+            ELogLevel Level = ELogLevel::Info;
+            std::string Message;
+            while (Queue.TryPop(Level, Message))
+            {
+                WriteLine(FormatLine(Level, Message));
+                bWroteAny = true;
+            }
+
+            const uint64_t Dropped = DroppedCount.exchange(0, std::memory_order_relaxed);
+            if (Dropped > 0)
+            {
+                WriteLine(FormatLine(ELogLevel::Warning, std::to_string(Dropped) + " log messages dropped, the log queue was full"));
+                bWroteAny = true;
+            }
+            return bWroteAny;
+        }
+
+        void ThreadMain()
+        {
+            while (!bStopRequested.load(std::memory_order_acquire))
+            {
+                WaitForSingleObject(WakeEvent, PollIntervalMs);
+                if (Drain())
+                {
+                    FlushFile();
+                }
+            }
+
+            // Messages pushed after this are written synchronously by Submit.
+            std::lock_guard<std::mutex> Lock(SyncWriteMutex);
+            bRunning.store(false, std::memory_order_release);
+            Drain();
+            FlushFile();
+        }
+
+        FLogQueue Queue;
+        std::ofstream LogFile;
+        HANDLE WakeEvent = nullptr;
+        std::thread Thread;
+        std::atomic<bool> bRunning{ false };
+        std::atomic<bool> bStopRequested{ false };
+        std::atomic<uint64_t> DroppedCount{ 0 };
+        std::mutex SyncWriteMutex;
+    };
+
+    FLogWriter& GetLogWriter()
+    {
+        // Heap-allocated and never destroyed, so messages from static destructors still have a writer.
+        static FLogWriter* Writer = new FLogWriter();
+        return *Writer;
     }
+}
 
-    OutputDebugStringA(Output.c_str());
+void LogMessage(ELogLevel Level, std::string Message)
+{
+    if (!IsLogLevelEnabled(Level))
+    {
+        return;
+    }
+
+    GetLogWriter().Submit(Level, std::move(Message));
 }
 
 void SetLogLevel(ELogLevel Level)
@@ -85,22 +308,37 @@ ELogLevel GetLogLevel()
     return GCurrentLogLevel.load();
 }
 
-void LogVerbose(const std::string& Message)
+bool IsLogLevelEnabled(ELogLevel Level)
+{
+    return static_cast<int>(Level) >= static_cast<int>(GCurrentLogLevel.load(std::memory_order_relaxed));
+}
+
+void FlushLog()
+{
+    GetLogWriter().Flush();
+}
+
+void ShutdownLog()
+{
+    GetLogWriter().Stop();
+}
+
+void LogVerbose(std::string Message)
 {
-    LogMessage(ELogLevel::Verbose, Message);
+    LogMessage(ELogLevel::Verbose, std::move(Message));
 }
 
-void LogInfo(const std::string& Message)
+void LogInfo(std::string Message)
 {
-    LogMessage(ELogLevel::Info, Message);
+    LogMessage(ELogLevel::Info, std::move(Message));
 }
 
-void LogWarning(const std::string& Message)
+void LogWarning(std::string Message)
 {
-    LogMessage(ELogLevel::Warning, Message);
+    LogMessage(ELogLevel::Warning, std::move(Message));
 }
 
-void LogError(const std::string& Message)
+void LogError(std::string Message)
 {
-    LogMessage(ELogLevel::Error, Message);
+    LogMessage(ELogLevel::Error, std::move(Message));
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <sstream>
 #include <string>
+#include <utility>
 
 enum class ELogLevel
 {
@@ -10,10 +12,60 @@ enum class ELogLevel
     Error
 };
 
-void LogMessage(ELogLevel Level, const std::string& Message);
+/**
+ * Messages that pass the level filter go into a fixed-size lock-free queue and a background
+ * thread writes them to the log file and the debugger, so a log call never waits on I/O or on
+ * another thread. When the queue is full the message is dropped and counted instead.
+ * The variadic overloads format their arguments only after the level check, which keeps
+ * filtered-out messages on hot paths free of string building.
+ */
+void LogMessage(ELogLevel Level, std::string Message);
 void SetLogLevel(ELogLevel Level);
 ELogLevel GetLogLevel();
-void LogVerbose(const std::string& Message);
-void LogInfo(const std::string& Message);
-void LogWarning(const std::string& Message);
-void LogError(const std::string& Message);
+bool IsLogLevelEnabled(ELogLevel Level);
+// Blocks until every message queued so far has been written.
+void FlushLog();
+// Writes what is queued and stops the writer thread; later messages are written synchronously.
+void ShutdownLog();
+
+void LogVerbose(std::string Message);
+void LogInfo(std::string Message);
+void LogWarning(std::string Message);
+void LogError(std::string Message);
+
+template <typename... PartTypes>
+void LogFormat(ELogLevel Level, const PartTypes&... Parts)
+{
+    if (!IsLogLevelEnabled(Level))
+    {
+        return;
+    }
+
+    std::ostringstream Stream;
+    (Stream << ... << Parts);
+    LogMessage(Level, Stream.str());
+}
+
+template <typename FirstType, typename SecondType, typename... RestTypes>
+void LogVerbose(const FirstType& First, const SecondType& Second, const RestTypes&... Rest)
+{
+    LogFormat(ELogLevel::Verbose, First, Second, Rest...);
+}
+
+template <typename FirstType, typename SecondType, typename... RestTypes>
+void LogInfo(const FirstType& First, const SecondType& Second, const RestTypes&... Rest)
+{
+    LogFormat(ELogLevel::Info, First, Second, Rest...);
+}
+
+template <typename FirstType, typename SecondType, typename... RestTypes>
+void LogWarning(const FirstType& First, const SecondType& Second, const RestTypes&... Rest)
+{
+    LogFormat(ELogLevel::Warning, First, Second, Rest...);
+}
+
+template <typename FirstType, typename SecondType, typename... RestTypes>
+void LogError(const FirstType& First, const SecondType& Second, const RestTypes&... Rest)
+{
+    LogFormat(ELogLevel::Error, First, Second, Rest...);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * Read-only view of a whole file mapped into the address space. Pages are faulted in by the OS
+ * as they are touched, so large assets can be parsed in place without a heap copy.
+ * The view stays valid until Close() or destruction.
+ */
+class FMappedFile
+{
+public:
+    FMappedFile() = default;
+    ~FMappedFile();
+
+    FMappedFile(const FMappedFile&) = delete;
+    FMappedFile& operator=(const FMappedFile&) = delete;
+
+    bool Open(const std::wstring& FilePath);
+    void Close();
+
+    bool IsOpen() const { return Data != nullptr; }
+    const uint8_t* GetData() const { return Data; }
+    size_t GetSize() const { return Size; }
+    std::string_view GetText() const { return { reinterpret_cast<const char*>(Data), Size }; }
+
+private:
+    // Win32 handles, kept as void* so the header does not pull in Windows.h
+    void* FileHandle = nullptr;
+    void* MappingHandle = nullptr;
+    const uint8_t* Data = nullptr;
+    size_t Size = 0;
+};
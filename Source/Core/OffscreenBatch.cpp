@@ -0,0 +1,549 @@
+#include "OffscreenBatch.h"
+
+#include "Logger.h"
+#include "../RHI/DX12CommandContext.h"
+#include "../RHI/DX12CommandQueue.h"
+#include "../RHI/DX12DescriptorAllocator.h"
+#include "../RHI/DX12Device.h"
+#include "../RHI/DX12PipelineCache.h"
+#include "../RHI/DX12UploadRing.h"
+#include "../Render/DeferredRenderer.h"
+#include "../Render/ForwardRenderer.h"
+#include "../Render/ImageWriter.h"
+#include "../Render/RenderGraph.h"
+#include "../Render/Renderer.h"
+#include "../Scene/Camera.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cwctype>
+#include <DirectXMath.h>
+#include <filesystem>
+#include <limits>
+
+namespace
+{
+    constexpr float FrameDeltaSeconds = 1.0f / 60.0f;
+    constexpr float ClearColor[4] = { 0.05f, 0.10f, 0.20f, 1.0f };
+    // Half-float 1.0, the alpha of every EXR capture.
+    constexpr uint16_t HalfOne = 0x3C00;
+
+    std::string ToUtf8(const std::wstring& Path)
+    {
+        const auto Utf8 = std::filesystem::path(Path).u8string();
+        return std::string(Utf8.begin(), Utf8.end());
+    }
+
+    bool IsExrPath(const std::wstring& Path)
+    {
+        std::wstring Extension = std::filesystem::path(Path).extension().wstring();
+        std::transform(Extension.begin(), Extension.end(), Extension.begin(), [](wchar_t Char)
+        {
+            return static_cast<wchar_t>(std::towlower(Char));
+        });
+        return Extension == L".exr";
+    }
+
+    FRendererOptions BuildRendererOptions(const FRendererConfig& Config, const std::wstring& ScenePath, uint32_t FramesInFlight)
+    {
+        FRendererOptions Options{};
+        Options.SceneFilePath = ScenePath;
+        Options.bUseDepthPrepass = Config.bUseDepthPrepass;
+        Options.MaskedDepthPrepassThreshold = Config.MaskedDepthPrepassThreshold;
+        Options.bEnableShadows = Config.bEnableShadows;
+        Options.ShadowBias = Config.ShadowBias;
+        Options.bEnableTonemap = Config.bEnableTonemap;
+        Options.TonemapExposure = Config.TonemapExposure;
+        Options.TonemapGamma = Config.TonemapGamma;
+        Options.bEnableCas = Config.bEnableCas;
+        Options.CasSharpness = Config.CasSharpness;
+        Options.bEnableAutoExposure = Config.bEnableAutoExposure;
+        Options.AutoExposureKey = Config.AutoExposureKey;
+        Options.AutoExposureMin = Config.AutoExposureMin;
+        Options.AutoExposureMax = Config.AutoExposureMax;
+        Options.AutoExposureSpeedUp = Config.AutoExposureSpeedUp;
+        Options.AutoExposureSpeedDown = Config.AutoExposureSpeedDown;
+        Options.bEnableTAA = Config.bEnableTAA;
+        Options.TaaHistoryWeight = Config.TaaHistoryWeight;
+        Options.bLogResourceBarriers = Config.bLogResourceBarriers;
+        Options.bEnableGraphDump = Config.bEnableGraphDump;
+        Options.bEnableGpuTiming = Config.bEnableGpuTiming;
+        Options.bEnablePipelineStatistics = Config.bEnablePipelineStatistics;
+        Options.bEnableParallelRecording = Config.bEnableParallelRecording;
+        // The on-screen culling statistics would end up in every image.
+        Options.bEnableGpuDebugPrint = false;
+        Options.bEnableIndirectDraw = Config.bEnableIndirectDraw;
+        Options.bEnableBindless = Config.bEnableBindless;
+        Options.bOptimizeMeshes = Config.bOptimizeMeshes;
+        Options.bEnableMeshShaders = Config.bEnableMeshShaders;
+        Options.bEnableTiledLighting = Config.bEnableTiledLighting;
+        Options.bEnableFusedPost = Config.bEnableFusedPost;
+        Options.ShadingRateQuality = Config.ShadingRateQuality;
+        Options.bShowShadingRate = false;
+        Options.bGenerateLods = Config.bGenerateLods;
+        Options.LodBias = Config.LodBias;
+        Options.MinScreenCoverage = Config.MinScreenCoverage;
+        Options.ShadowMinScreenCoverage = Config.ShadowMinScreenCoverage;
+        // Every image must show the final textures, not the placeholders streaming starts with.
+        Options.bStreamSceneTextures = false;
+        Options.bStreamTextureMips = false;
+        Options.TextureStreamingBudgetMB = Config.TextureStreamingBudgetMB;
+        Options.TextureCacheBudgetMB = Config.TextureCacheBudgetMB;
+        Options.FramesInFlight = FramesInFlight;
+        return Options;
+    }
+}
+
+FOffscreenBatch::~FOffscreenBatch()
+{
+    WaitForEncodes(0);
+
+    if (Device && Device->GetGraphicsQueue())
+    {
+        Device->GetGraphicsQueue()->Flush();
+    }
+    Renderer.reset();
+
+    if (bTaskSystemStarted)
+    {
+        FTaskScheduler::Get().Shutdown();
+    }
+}
+
+bool FOffscreenBatch::Initialize(const FRendererConfig& InConfig)
+{
+    LogInfo("Offscreen batch initialization started");
+
+    Config = InConfig;
+
+    if (Config.bEnableTaskSystem)
+    {
+        FTaskScheduler::Get().Initialize();
+        bTaskSystemStarted = true;
+    }
+    else
+    {
+        LogInfo("Task system disabled via renderer config; encoding images on the main thread");
+    }
+
+    Device = std::make_unique<FDX12Device>();
+    if (!Device->Initialize())
+    {
+        LogError("Failed to initialize D3D12 device");
+        return false;
+    }
+
+    const uint32 ReadbackDepth = (std::max)(1u, Config.BatchReadbackDepth);
+    CommandContext = std::make_unique<FDX12CommandContext>();
+    if (!CommandContext->Initialize(Device.get(), Device->GetGraphicsQueue(), ReadbackDepth))
+    {
+        LogError("Failed to initialize command context");
+        return false;
+    }
+    Slots.resize(ReadbackDepth);
+
+    D3D12_DESCRIPTOR_HEAP_DESC HeapDesc = {};
+    HeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+    HeapDesc.NumDescriptors = 1;
+    HeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+    if (FAILED(Device->GetDevice()->CreateDescriptorHeap(&HeapDesc, IID_PPV_ARGS(RtvHeap.GetAddressOf()))))
+    {
+        LogError("Failed to create offscreen RTV heap");
+        return false;
+    }
+
+    LogInfo("Offscreen batch initialization complete");
+    return true;
+}
+
+int32_t FOffscreenBatch::Run(const std::vector<FSceneRenderJobDesc>& Jobs)
+{
+    LogInfo("Offscreen batch started: ", Jobs.size(), " job(s), ", Slots.size(), " readback buffer(s)");
+    const auto StartTime = std::chrono::steady_clock::now();
+
+    for (const FSceneRenderJobDesc& Job : Jobs)
+    {
+        RenderJob(Job);
+    }
+
+    Device->GetGraphicsQueue()->Flush();
+    for (FReadbackSlot& Slot : Slots)
+    {
+        RetireSlot(Slot);
+    }
+    WaitForEncodes(0);
+
+    Device->GetPipelineCache()->Save();
+
+    const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+    const uint32 Written = WrittenImages.load();
+    LogInfo("Offscreen batch finished in ", Seconds, " s: ", Written, " of ", Jobs.size(), " image(s) written");
+    return Written == Jobs.size() ? 0 : 1;
+}
+
+void FOffscreenBatch::RenderJob(const FSceneRenderJobDesc& Job)
+{
+    const uint32 Width = Job.Width > 0 ? Job.Width : Config.WindowWidth;
+    const uint32 Height = Job.Height > 0 ? Job.Height : Config.WindowHeight;
+    const EImageFormat Format = IsExrPath(Job.OutputPath) ? EImageFormat::Exr : EImageFormat::Png;
+
+    if (!PrepareRenderer(Job.ScenePath, Width, Height, Format))
+    {
+        LogError("Skipping render job for: " + ToUtf8(Job.OutputPath));
+        return;
+    }
+
+    FCamera Camera;
+    SetupJobCamera(Job, Width, Height, Camera);
+
+    const uint32 WarmupFrames = Job.WarmupFrames >= 0 ? static_cast<uint32>(Job.WarmupFrames) : Config.BatchWarmupFrames;
+    for (uint32 Frame = 0; Frame < WarmupFrames; ++Frame)
+    {
+        RenderFrame(Camera, nullptr);
+    }
+    RenderFrame(Camera, &Job.OutputPath);
+}
+
+bool FOffscreenBatch::PrepareRenderer(const std::wstring& ScenePath, uint32_t Width, uint32_t Height, EImageFormat Format)
+{
+    if (Renderer && RendererScenePath == ScenePath && RendererWidth == Width && RendererHeight == Height && RendererFormat == Format)
+    {
+        return true;
+    }
+
+    // Frames in flight may still read the previous renderer's resources and target. It is kept
+    // until its successor is ready, which adopts whatever the new scene and size leave valid.
+    Device->GetGraphicsQueue()->Flush();
+    std::unique_ptr<FRenderer> PreviousRenderer = std::move(Renderer);
+    RendererScenePath.clear();
+
+    const DXGI_FORMAT TargetFormat = Format == EImageFormat::Exr ? DXGI_FORMAT_R16G16B16A16_FLOAT : DXGI_FORMAT_R8G8B8A8_UNORM;
+    if (!CreateOutputTarget(Width, Height, TargetFormat))
+    {
+        return false;
+    }
+
+    FRendererOptions Options = BuildRendererOptions(Config, ScenePath, static_cast<uint32>(Slots.size()));
+    Options.PersistentResources = PreviousRenderer ? PreviousRenderer->CapturePersistentResources() : nullptr;
+    auto TryInitializeRenderer = [&](ERendererType Type) -> bool
+    {
+        std::unique_ptr<FRenderer> Candidate;
+        if (Type == ERendererType::Deferred)
+        {
+            Candidate = std::make_unique<FDeferredRenderer>();
+        }
+        else
+        {
+            Candidate = std::make_unique<FForwardRenderer>();
+        }
+
+        if (!Candidate->Initialize(Device.get(), Width, Height, TargetFormat, Options))
+        {
+            LogWarning(Type == ERendererType::Deferred ? "Deferred renderer initialization failed" : "Forward renderer initialization failed");
+            return false;
+        }
+        Candidate->CompletePersistentResourceHandoff();
+        Renderer = std::move(Candidate);
+        return true;
+    };
+
+    const bool bPreferDeferred = Config.RendererType == ERendererType::Deferred;
+    const bool bRendererReady = bPreferDeferred ?
+        (TryInitializeRenderer(ERendererType::Deferred) || TryInitializeRenderer(ERendererType::Forward)) :
+        (TryInitializeRenderer(ERendererType::Forward) || TryInitializeRenderer(ERendererType::Deferred));
+    if (!bRendererReady)
+    {
+        LogError("Failed to initialize renderer for scene: " + ToUtf8(ScenePath));
+        return false;
+    }
+
+    FSceneLightDesc SceneLight;
+    if (FSceneJsonLoader::LoadSceneLighting(ScenePath, SceneLight))
+    {
+        const DirectX::XMFLOAT3 Direction(SceneLight.Direction.x, SceneLight.Direction.y, SceneLight.Direction.z);
+        const DirectX::XMVECTOR DirectionVec = DirectX::XMLoadFloat3(&Direction);
+        if (DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(DirectionVec)) > 0.0f)
+        {
+            DirectX::XMFLOAT3 Normalized;
+            DirectX::XMStoreFloat3(&Normalized, DirectX::XMVector3Normalize(DirectionVec));
+            Renderer->SetLightDirection(Normalized);
+        }
+        Renderer->SetLightIntensity(SceneLight.Intensity);
+        Renderer->SetLightColor(DirectX::XMFLOAT3(SceneLight.Color.x, SceneLight.Color.y, SceneLight.Color.z));
+    }
+
+    RendererScenePath = ScenePath;
+    RendererWidth = Width;
+    RendererHeight = Height;
+    RendererFormat = Format;
+    LogInfo("Batch renderer ready: " + ToUtf8(ScenePath) + " at " + std::to_string(Width) + "x" + std::to_string(Height));
+    return true;
+}
+
+bool FOffscreenBatch::CreateOutputTarget(uint32_t Width, uint32_t Height, DXGI_FORMAT Format)
+{
+    OutputTarget.Reset();
+
+    D3D12_HEAP_PROPERTIES HeapProps = {};
+    HeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+    // Unordered access lets the fused post-processing pass write the target directly, as it
+    // does the swap chain's back buffers.
+    D3D12_RESOURCE_DESC Desc = {};
+    Desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    Desc.Width = Width;
+    Desc.Height = Height;
+    Desc.DepthOrArraySize = 1;
+    Desc.MipLevels = 1;
+    Desc.Format = Format;
+    Desc.SampleDesc.Count = 1;
+    Desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+    Desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+    D3D12_CLEAR_VALUE ClearValue = {};
+    ClearValue.Format = Format;
+    std::memcpy(ClearValue.Color, ClearColor, sizeof(ClearColor));
+
+    if (FAILED(Device->CreateCommittedResource(
+        EGpuMemoryCategory::RenderTarget,
+        &HeapProps,
+        D3D12_HEAP_FLAG_NONE,
+        &Desc,
+        D3D12_RESOURCE_STATE_RENDER_TARGET,
+        &ClearValue,
+        IID_PPV_ARGS(OutputTarget.GetAddressOf()))))
+    {
+        LogError("Failed to create " + std::to_string(Width) + "x" + std::to_string(Height) + " offscreen target");
+        return false;
+    }
+    OutputTarget->SetName(L"OffscreenBatchTarget");
+
+    Device->GetDevice()->CreateRenderTargetView(OutputTarget.Get(), nullptr, RtvHeap->GetCPUDescriptorHandleForHeapStart());
+    return true;
+}
+
+void FOffscreenBatch::SetupJobCamera(const FSceneRenderJobDesc& Job, uint32_t Width, uint32_t Height, FCamera& OutCamera) const
+{
+    const float AspectRatio = static_cast<float>(Width) / static_cast<float>(Height);
+
+    FSceneCameraDesc CameraDesc = Job.Camera;
+    const bool bHasCamera = Job.bHasCamera || FSceneJsonLoader::LoadSceneCamera(Job.ScenePath, CameraDesc);
+    if (bHasCamera)
+    {
+        OutCamera.SetPerspective(DirectX::XMConvertToRadians(CameraDesc.FovYDegrees), AspectRatio, 0.1f, 1000.0f);
+        OutCamera.SetPosition(CameraDesc.Position);
+        OutCamera.SetForward(GetSceneCameraForward(CameraDesc, FFloat3(0.0f, 0.0f, 1.0f)));
+    }
+    else
+    {
+        // Frames the scene bounds from the front, as the application does for scenes without a camera.
+        const float FovY = DirectX::XM_PIDIV4;
+        const DirectX::XMFLOAT3 SceneCenter = Renderer->GetSceneCenter();
+        const float Distance = Renderer->GetSceneRadius() / std::tan(FovY * 0.5f);
+        OutCamera.SetPerspective(FovY, AspectRatio, 0.1f, std::numeric_limits<float>::infinity());
+        OutCamera.SetPosition(FFloat3(SceneCenter.x, SceneCenter.y, SceneCenter.z - Distance));
+        OutCamera.SetForward(FFloat3(0.0f, 0.0f, 1.0f));
+    }
+
+    const DirectX::XMVECTOR ForwardVec = DirectX::XMLoadFloat3(&OutCamera.GetForward());
+    const float Pitch = -asinf(DirectX::XMVectorGetY(ForwardVec));
+    const float Yaw = atan2f(DirectX::XMVectorGetX(ForwardVec), DirectX::XMVectorGetZ(ForwardVec));
+    const DirectX::XMMATRIX Rotation = DirectX::XMMatrixRotationRollPitchYaw(Pitch, Yaw, 0.0f);
+    FFloat3 Up;
+    DirectX::XMStoreFloat3(&Up, DirectX::XMVector3Normalize(DirectX::XMVector3TransformNormal(DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f), Rotation)));
+    OutCamera.SetUp(Up);
+}
+
+void FOffscreenBatch::RenderFrame(const FCamera& Camera, const std::wstring* CapturePath)
+{
+    const uint32 SlotIndex = static_cast<uint32>(FrameCounter % Slots.size());
+    FReadbackSlot& Slot = Slots[SlotIndex];
+
+    // BeginFrame waits for this slot's previous frame as well, so this never waits longer.
+    RetireSlot(Slot);
+    CommandContext->BeginFrame(SlotIndex);
+
+    const D3D12_CPU_DESCRIPTOR_HANDLE RtvHandle = RtvHeap->GetCPUDescriptorHandleForHeapStart();
+    Renderer->SetFrameIndex(SlotIndex);
+    Renderer->SetOutputTarget(OutputTarget.Get());
+    CommandContext->SetRenderTarget(RtvHandle, &Renderer->GetDSVHandle());
+    CommandContext->ClearRenderTarget(RtvHandle, ClearColor);
+    Renderer->RenderFrame(*CommandContext, RtvHandle, Camera, FrameDeltaSeconds);
+
+    bool bCaptured = false;
+    if (CapturePath)
+    {
+        const D3D12_RESOURCE_DESC TargetDesc = OutputTarget->GetDesc();
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT Footprint = {};
+        UINT64 TotalBytes = 0;
+        Device->GetDevice()->GetCopyableFootprints(&TargetDesc, 0, 1, 0, &Footprint, nullptr, nullptr, &TotalBytes);
+
+        if (!Slot.Buffer || Slot.Capacity < TotalBytes)
+        {
+            Slot.Buffer.Reset();
+            Slot.Capacity = 0;
+
+            D3D12_HEAP_PROPERTIES HeapProps = {};
+            HeapProps.Type = D3D12_HEAP_TYPE_READBACK;
+
+            D3D12_RESOURCE_DESC BufferDesc = {};
+            BufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            BufferDesc.Width = TotalBytes;
+            BufferDesc.Height = 1;
+            BufferDesc.DepthOrArraySize = 1;
+            BufferDesc.MipLevels = 1;
+            BufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+            BufferDesc.SampleDesc.Count = 1;
+            BufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+            if (SUCCEEDED(Device->CreateCommittedResource(
+                EGpuMemoryCategory::Readback,
+                &HeapProps,
+                D3D12_HEAP_FLAG_NONE,
+                &BufferDesc,
+                D3D12_RESOURCE_STATE_COPY_DEST,
+                nullptr,
+                IID_PPV_ARGS(Slot.Buffer.GetAddressOf()))))
+            {
+                Slot.Capacity = TotalBytes;
+            }
+        }
+
+        if (Slot.Buffer)
+        {
+            CommandContext->TransitionResource(OutputTarget.Get(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COPY_SOURCE);
+
+            D3D12_TEXTURE_COPY_LOCATION Source = {};
+            Source.pResource = OutputTarget.Get();
+            Source.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+            Source.SubresourceIndex = 0;
+
+            D3D12_TEXTURE_COPY_LOCATION Destination = {};
+            Destination.pResource = Slot.Buffer.Get();
+            Destination.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+            Destination.PlacedFootprint = Footprint;
+
+            CommandContext->GetCommandList()->CopyTextureRegion(&Destination, 0, 0, 0, &Source, nullptr);
+            CommandContext->TransitionResource(OutputTarget.Get(), D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+            Slot.Footprint = Footprint;
+            Slot.Width = RendererWidth;
+            Slot.Height = RendererHeight;
+            Slot.Format = RendererFormat;
+            Slot.OutputPath = *CapturePath;
+            bCaptured = true;
+        }
+        else
+        {
+            LogError("Failed to create readback buffer for: " + ToUtf8(*CapturePath));
+        }
+    }
+
+    CommandContext->CloseAndExecute();
+
+    const uint64 FenceValue = Device->GetGraphicsQueue()->Signal();
+    CommandContext->SetFrameFenceValue(SlotIndex, FenceValue);
+    FRenderGraph::RetireFrameAllocations(CommandContext->GetCurrentFrameIndex(), FenceValue);
+    Device->GetUploadRing()->EndFrame(FenceValue);
+    Device->GetDescriptorAllocator()->EndFrame(FenceValue);
+    Renderer->OnFrameFenceSignaled(SlotIndex, FenceValue);
+
+    if (bCaptured)
+    {
+        Slot.FenceValue = FenceValue;
+        Slot.bPending = true;
+    }
+    ++FrameCounter;
+}
+
+void FOffscreenBatch::RetireSlot(FReadbackSlot& Slot)
+{
+    if (!Slot.bPending)
+    {
+        return;
+    }
+    Slot.bPending = false;
+
+    FDX12CommandQueue* Queue = Device->GetGraphicsQueue();
+    if (Queue->GetCompletedFenceValue() < Slot.FenceValue)
+    {
+        Queue->Wait(Slot.FenceValue);
+    }
+
+    // Rows are tightened to the image width here so the buffer is free again right away.
+    const uint32 BytesPerPixel = Slot.Format == EImageFormat::Exr ? 8u : 4u;
+    const uint32 RowBytes = Slot.Width * BytesPerPixel;
+    const uint32 SourcePitch = Slot.Footprint.Footprint.RowPitch;
+    std::vector<uint8_t> Pixels(static_cast<size_t>(RowBytes) * Slot.Height);
+
+    const D3D12_RANGE ReadRange = { static_cast<SIZE_T>(Slot.Footprint.Offset), static_cast<SIZE_T>(Slot.Footprint.Offset + static_cast<uint64>(SourcePitch) * Slot.Height) };
+    void* Mapped = nullptr;
+    if (FAILED(Slot.Buffer->Map(0, &ReadRange, &Mapped)) || !Mapped)
+    {
+        LogError("Failed to map readback buffer for: " + ToUtf8(Slot.OutputPath));
+        return;
+    }
+
+    const uint8_t* Source = static_cast<const uint8_t*>(Mapped) + Slot.Footprint.Offset;
+    for (uint32 Row = 0; Row < Slot.Height; ++Row)
+    {
+        std::memcpy(Pixels.data() + static_cast<size_t>(Row) * RowBytes, Source + static_cast<size_t>(Row) * SourcePitch, RowBytes);
+    }
+    const D3D12_RANGE WrittenRange = { 0, 0 };
+    Slot.Buffer->Unmap(0, &WrittenRange);
+
+    auto Encode = [this, Pixels = std::move(Pixels), Width = Slot.Width, Height = Slot.Height, Format = Slot.Format, Path = Slot.OutputPath]() mutable
+    {
+        // The post chain does not write coverage, so every capture is stored opaque.
+        bool bWritten = false;
+        if (Format == EImageFormat::Exr)
+        {
+            uint16_t* Halves = reinterpret_cast<uint16_t*>(Pixels.data());
+            for (size_t Index = 3; Index < Pixels.size() / sizeof(uint16_t); Index += 4)
+            {
+                Halves[Index] = HalfOne;
+            }
+            bWritten = FImageWriter::WriteExr(Path, Halves, Width, Height, Width * 8u);
+        }
+        else
+        {
+            for (size_t Index = 3; Index < Pixels.size(); Index += 4)
+            {
+                Pixels[Index] = 255;
+            }
+            bWritten = FImageWriter::WritePng(Path, Pixels.data(), Width, Height, Width * 4u);
+        }
+
+        if (bWritten)
+        {
+            WrittenImages.fetch_add(1);
+            LogInfo("Wrote " + ToUtf8(Path));
+        }
+    };
+
+    if (!bTaskSystemStarted)
+    {
+        Encode();
+        return;
+    }
+
+    // Bounds the images held in memory when encoding falls behind rendering.
+    WaitForEncodes(static_cast<size_t>(FTaskScheduler::Get().GetWorkerThreadCount()) * 2 + 1);
+    PendingEncodes.push_back(FTaskScheduler::Get().ScheduleTask(std::move(Encode)));
+}
+
+void FOffscreenBatch::WaitForEncodes(size_t MaxPending)
+{
+    PendingEncodes.erase(std::remove_if(PendingEncodes.begin(), PendingEncodes.end(), [](const FTaskRef& Task)
+    {
+        return !Task || Task->IsComplete();
+    }), PendingEncodes.end());
+
+    while (PendingEncodes.size() > MaxPending)
+    {
+        FTaskScheduler::Get().WaitForTask(PendingEncodes.front());
+        PendingEncodes.erase(PendingEncodes.begin());
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "RendererConfig.h"
+#include "TaskSystem.h"
+#include "../RHI/DX12Commons.h"
+#include "../Scene/SceneJsonLoader.h"
+
+class FDX12Device;
+class FDX12CommandContext;
+class FRenderer;
+class FCamera;
+
+/**
+ * Windowless rendering of a job list into image files, for thumbnails and turntables of many
+ * assets. Each job renders its warmup frames and one captured frame into an offscreen target,
+ * and the captured frame ends its command list with a copy into one of BatchReadbackDepth
+ * readback buffers. A buffer is mapped only when its frame slot comes round again, after the
+ * command context has waited for that slot anyway, and the pixels go to a task-system worker
+ * that encodes and writes the file: the GPU never waits for the CPU or the disk, and the
+ * recording thread only waits for the GPU. Consecutive jobs with the same scene, size and
+ * format keep their renderer.
+ */
+class FOffscreenBatch
+{
+public:
+    ~FOffscreenBatch();
+
+    bool Initialize(const FRendererConfig& InConfig);
+    // Returns the process exit code: 0 when every image was written, 1 otherwise.
+    int32_t Run(const std::vector<FSceneRenderJobDesc>& Jobs);
+
+private:
+    enum class EImageFormat : uint8_t
+    {
+        Png,
+        Exr
+    };
+
+    struct FReadbackSlot
+    {
+        ComPtr<ID3D12Resource> Buffer;
+        uint64_t Capacity = 0;
+        uint64_t FenceValue = 0;
+        bool bPending = false;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT Footprint = {};
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        EImageFormat Format = EImageFormat::Png;
+        std::wstring OutputPath;
+    };
+
+    void RenderJob(const FSceneRenderJobDesc& Job);
+    bool PrepareRenderer(const std::wstring& ScenePath, uint32_t Width, uint32_t Height, EImageFormat Format);
+    bool CreateOutputTarget(uint32_t Width, uint32_t Height, DXGI_FORMAT Format);
+    void SetupJobCamera(const FSceneRenderJobDesc& Job, uint32_t Width, uint32_t Height, FCamera& OutCamera) const;
+    // Copies the frame into its readback slot when CapturePath is set.
+    void RenderFrame(const FCamera& Camera, const std::wstring* CapturePath);
+    void RetireSlot(FReadbackSlot& Slot);
+    void WaitForEncodes(size_t MaxPending);
+
+    FRendererConfig Config;
+    std::unique_ptr<FDX12Device> Device;
+    std::unique_ptr<FDX12CommandContext> CommandContext;
+    std::unique_ptr<FRenderer> Renderer;
+
+    ComPtr<ID3D12Resource> OutputTarget;
+    ComPtr<ID3D12DescriptorHeap> RtvHeap;
+    std::wstring RendererScenePath;
+    uint32_t RendererWidth = 0;
+    uint32_t RendererHeight = 0;
+    EImageFormat RendererFormat = EImageFormat::Png;
+
+    std::vector<FReadbackSlot> Slots;
+    uint64_t FrameCounter = 0;
+
+    std::vector<FTaskRef> PendingEncodes;
+    std::atomic<uint32_t> WrittenImages{ 0 };
+    bool bTaskSystemStarted = false;
+};
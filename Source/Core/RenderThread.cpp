@@ -0,0 +1,159 @@
+#include "RenderThread.h"
+
+#include "CpuProfiler.h"
+#include "Logger.h"
+
+#include <algorithm>
+
+FRenderThread::~FRenderThread()
+{
+    Stop();
+}
+
+void FRenderThread::Start(FRenderFunction InRenderFunction, uint32_t InMaxQueuedFrames, bool bInThreaded)
+{
+    Stop();
+
+    RenderFunction = std::move(InRenderFunction);
+    MaxQueuedFrames = (std::max)(1u, InMaxQueuedFrames);
+    bThreaded = bInThreaded;
+    bStopRequested = false;
+    bRenderStopped = false;
+
+    if (bThreaded)
+    {
+        Thread = std::thread(&FRenderThread::ThreadMain, this);
+        LogInfo("Render thread started, game thread runs up to " + std::to_string(MaxQueuedFrames) + " frame(s) ahead");
+    }
+}
+
+void FRenderThread::Stop()
+{
+    if (!Thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        bStopRequested = true;
+        Queue.clear();
+    }
+    FrameQueuedCV.notify_all();
+    Thread.join();
+    LogInfo("Render thread stopped");
+}
+
+bool FRenderThread::Submit(FFrameSnapshot&& Snapshot)
+{
+    if (!bThreaded)
+    {
+        if (bRenderStopped)
+        {
+            return false;
+        }
+        bRenderStopped = !RenderFunction(Snapshot);
+        return !bRenderStopped;
+    }
+
+    {
+        CPU_PROFILE_SCOPE("Wait For Render Thread");
+        std::unique_lock<std::mutex> Lock(Mutex);
+        FrameRenderedCV.wait(Lock, [this]()
+        {
+            return bRenderStopped || Queue.size() < MaxQueuedFrames;
+        });
+
+        if (bRenderStopped)
+        {
+            return false;
+        }
+        Queue.push_back(std::move(Snapshot));
+    }
+    FrameQueuedCV.notify_one();
+    return true;
+}
+
+void FRenderThread::Flush()
+{
+    if (!bThreaded)
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> Lock(Mutex);
+    FrameRenderedCV.wait(Lock, [this]()
+    {
+        return bRenderStopped || (Queue.empty() && !bRendering);
+    });
+}
+
+void FRenderThread::EnqueueGameThreadTask(std::function<void()> Task)
+{
+    std::lock_guard<std::mutex> Lock(GameThreadTaskMutex);
+    GameThreadTasks.push_back(std::move(Task));
+}
+
+void FRenderThread::ExecuteGameThreadTasks()
+{
+    std::vector<std::function<void()>> Tasks;
+    {
+        std::lock_guard<std::mutex> Lock(GameThreadTaskMutex);
+        Tasks.swap(GameThreadTasks);
+    }
+
+    for (const std::function<void()>& Task : Tasks)
+    {
+        Task();
+    }
+}
+
+void FRenderThread::ThreadMain()
+{
+    CPU_PROFILE_THREAD_NAME("Render");
+
+    for (;;)
+    {
+        FFrameSnapshot Snapshot;
+        {
+            std::unique_lock<std::mutex> Lock(Mutex);
+            FrameQueuedCV.wait(Lock, [this]()
+            {
+                return bStopRequested || !Queue.empty();
+            });
+
+            if (bStopRequested)
+            {
+                break;
+            }
+
+            Snapshot = std::move(Queue.front());
+            Queue.pop_front();
+            bRendering = true;
+        }
+        // The game thread may start its next update as soon as a queue slot frees up.
+        FrameRenderedCV.notify_all();
+
+        const bool bContinue = RenderFunction(Snapshot);
+
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            bRendering = false;
+            if (!bContinue)
+            {
+                bRenderStopped = true;
+                Queue.clear();
+            }
+        }
+        FrameRenderedCV.notify_all();
+
+        if (!bContinue)
+        {
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    bRenderStopped = true;
+    FrameRenderedCV.notify_all();
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Scene/Camera.h"
+
+/**
+ * Everything the render thread needs from the game thread for one frame, copied when the game
+ * thread finishes its update so neither thread reads state the other is still writing.
+ */
+struct FFrameSnapshot
+{
+    uint64_t FrameNumber = 0;
+    float DeltaSeconds = 0.0f;
+    float Fps = 0.0f;
+    FCamera Camera;
+    // When the game thread read input for this frame; the overlay's input-to-present latency starts here.
+    std::chrono::steady_clock::time_point InputSampleTime;
+
+    // Left click in client coordinates, resolved against this frame's camera.
+    bool bSelectionClick = false;
+    int32_t SelectionClickX = 0;
+    int32_t SelectionClickY = 0;
+
+    // Scene picked in the file dialog, which the game thread runs.
+    std::wstring ScenePathToLoad;
+};
+
+/**
+ * Runs the render half of the frame on its own thread. The game thread submits a snapshot per
+ * frame and goes on with the next update while the render thread records and presents the
+ * previous one; at most MaxQueuedFrames snapshots wait, so the game thread never runs further
+ * ahead than that. Render-side work that changes game-thread state, such as placing the camera
+ * for a newly loaded scene, goes back through EnqueueGameThreadTask.
+ * When not threaded, Submit renders on the calling thread and the frame order is unchanged.
+ */
+class FRenderThread
+{
+public:
+    // Renders one frame; returning false stops the thread and fails every later Submit.
+    using FRenderFunction = std::function<bool(const FFrameSnapshot&)>;
+
+    ~FRenderThread();
+
+    void Start(FRenderFunction InRenderFunction, uint32_t InMaxQueuedFrames, bool bInThreaded);
+    // Frames still queued are dropped; the one being rendered completes.
+    void Stop();
+
+    bool IsThreaded() const { return bThreaded; }
+
+    // Blocks while MaxQueuedFrames snapshots are waiting. False once rendering has stopped.
+    bool Submit(FFrameSnapshot&& Snapshot);
+    // Waits until every submitted snapshot has been rendered.
+    void Flush();
+
+    void EnqueueGameThreadTask(std::function<void()> Task);
+    // Game thread only; runs the tasks queued since the previous call.
+    void ExecuteGameThreadTasks();
+
+private:
+    void ThreadMain();
+
+    FRenderFunction RenderFunction;
+    uint32_t MaxQueuedFrames = 1;
+    bool bThreaded = false;
+
+    std::thread Thread;
+    std::mutex Mutex;
+    std::condition_variable FrameQueuedCV;
+    std::condition_variable FrameRenderedCV;
+    std::deque<FFrameSnapshot> Queue;
+    bool bRendering = false;
+    bool bStopRequested = false;
+    bool bRenderStopped = false;
+
+    std::mutex GameThreadTaskMutex;
+    std::vector<std::function<void()>> GameThreadTasks;
+};
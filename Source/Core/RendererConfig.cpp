@@ -1,6 +1,12 @@
 #include "RendererConfig.h"
 
 #include "Logger.h"
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#include <shellapi.h>
 #include <algorithm>
 #include <cctype>
 #include <fstream>
@@ -13,6 +19,18 @@ namespace
         return std::wstring(Input.begin(), Input.end());
     }
 
+    // Config values are ASCII, as ToWide assumes.
+    std::string ToNarrow(const std::wstring& Input)
+    {
+        std::string Result;
+        Result.reserve(Input.size());
+        for (const wchar_t Ch : Input)
+        {
+            Result.push_back(static_cast<char>(Ch));
+        }
+        return Result;
+    }
+
     std::string ToLowerCopy(const std::string& Input)
     {
         std::string Result(Input);
@@ -70,6 +88,37 @@ FRendererConfig FRendererConfigLoader::LoadOrDefault(const std::filesystem::path
     return Config;
 }
 
+void FRendererConfigLoader::ApplyCommandLine(const std::wstring& CommandLine, FRendererConfig& InOutConfig)
+{
+    int ArgumentCount = 0;
+    LPWSTR* Arguments = CommandLineToArgvW(CommandLine.c_str(), &ArgumentCount);
+    if (!Arguments)
+    {
+        return;
+    }
+
+    for (int Index = 0; Index < ArgumentCount; ++Index)
+    {
+        const std::string Argument = ToNarrow(Arguments[Index]);
+        const size_t KeyStart = Argument.find_first_not_of("-/");
+        if (KeyStart == 0 || KeyStart == std::string::npos)
+        {
+            continue;
+        }
+
+        const size_t DelimiterPos = Argument.find('=', KeyStart);
+        const std::string Key = TrimCopy(Argument.substr(KeyStart, DelimiterPos - KeyStart));
+        const std::string Value = DelimiterPos == std::string::npos ? std::string("1") : TrimCopy(Argument.substr(DelimiterPos + 1));
+        if (!Key.empty())
+        {
+            LogInfo("Renderer config override from command line: " + Key + "=" + Value);
+            ApplyKeyValue(Key, Value, InOutConfig);
+        }
+    }
+
+    LocalFree(Arguments);
+}
+
 void FRendererConfigLoader::ApplyKeyValue(const std::string& Key, const std::string& Value, FRendererConfig& OutConfig)
 {
     const std::string LowerKey = ToLowerCopy(Key);
@@ -99,6 +148,18 @@ void FRendererConfigLoader::ApplyKeyValue(const std::string& Key, const std::str
         OutConfig.bUseDepthPrepass = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
     }
 
+    if (LowerKey == "maskeddepthprepassthreshold" || LowerKey == "maskedprepassthreshold")
+    {
+        try
+        {
+            OutConfig.MaskedDepthPrepassThreshold = static_cast<uint32_t>((std::max)(0, std::stoi(Value)));
+        }
+        catch (...)
+        {
+            LogWarning("Invalid masked depth prepass threshold in renderer config: " + Value);
+        }
+    }
+
     if (LowerKey == "frameoverlap" || LowerKey == "useframeoverlap")
     {
         OutConfig.bEnableFrameOverlap = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
@@ -118,6 +179,20 @@ void FRendererConfigLoader::ApplyKeyValue(const std::string& Key, const std::str
         }
     }
 
+    if (LowerKey == "maxframelatency" || LowerKey == "framelatency")
+    {
+        try
+        {
+            const int32_t ParsedValue = std::stoi(Value);
+            const int32_t ClampedValue = std::clamp(ParsedValue, 0, 16);
+            OutConfig.MaxFrameLatency = static_cast<uint32_t>(ClampedValue);
+        }
+        catch (...)
+        {
+            LogWarning("Invalid max frame latency value in renderer config: " + Value);
+        }
+    }
+
     if (LowerKey == "enableshadows" || LowerKey == "shadows")
     {
         OutConfig.bEnableShadows = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
@@ -169,6 +244,11 @@ void FRendererConfigLoader::ApplyKeyValue(const std::string& Key, const std::str
         OutConfig.bEnableCas = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
     }
 
+    if (LowerKey == "fusedpost" || LowerKey == "enablefusedpost")
+    {
+        OutConfig.bEnableFusedPost = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
     if (LowerKey == "cassharpness")
     {
         try
@@ -263,11 +343,45 @@ void FRendererConfigLoader::ApplyKeyValue(const std::string& Key, const std::str
         }
     }
 
+    if (LowerKey == "enabledynamicresolution" || LowerKey == "dynamicresolution")
+    {
+        OutConfig.bEnableDynamicResolution = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
+    if (LowerKey == "dynamicresolutiontargetms" || LowerKey == "dynamicresolutiontarget")
+    {
+        try
+        {
+            OutConfig.DynamicResolutionTargetMs = std::stof(Value);
+        }
+        catch (...)
+        {
+            LogWarning("Invalid dynamic resolution target value in renderer config: " + Value);
+        }
+    }
+
+    if (LowerKey == "dynamicresolutionminscale")
+    {
+        try
+        {
+            OutConfig.DynamicResolutionMinScale = std::stof(Value);
+        }
+        catch (...)
+        {
+            LogWarning("Invalid dynamic resolution min scale value in renderer config: " + Value);
+        }
+    }
+
     if (LowerKey == "usetasksystem" || LowerKey == "enabletasksystem" || LowerKey == "tasksystem")
     {
         OutConfig.bEnableTaskSystem = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
     }
 
+    if (LowerKey == "renderthread" || LowerKey == "userenderthread" || LowerKey == "enablerenderthread")
+    {
+        OutConfig.bEnableRenderThread = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
     if (LowerKey == "logresourcebarriers" || LowerKey == "logbarriers" || LowerKey == "barrierlogging")
     {
         OutConfig.bLogResourceBarriers = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
@@ -283,6 +397,26 @@ void FRendererConfigLoader::ApplyKeyValue(const std::string& Key, const std::str
         OutConfig.bEnableGpuTiming = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
     }
 
+    if (LowerKey == "pipelinestatistics" || LowerKey == "enablepipelinestatistics" || LowerKey == "pipelinestats")
+    {
+        OutConfig.bEnablePipelineStatistics = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
+    if (LowerKey == "cpuprofiler" || LowerKey == "enablecpuprofiler")
+    {
+        OutConfig.bEnableCpuProfiler = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
+    if (LowerKey == "asynccompute" || LowerKey == "enableasynccompute")
+    {
+        OutConfig.bEnableAsyncCompute = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
+    if (LowerKey == "parallelrecording" || LowerKey == "enableparallelrecording")
+    {
+        OutConfig.bEnableParallelRecording = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
     if (LowerKey == "gpudebugprint" || LowerKey == "enablegpudebugprint")
     {
         OutConfig.bEnableGpuDebugPrint = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
@@ -293,6 +427,142 @@ void FRendererConfigLoader::ApplyKeyValue(const std::string& Key, const std::str
         OutConfig.bEnableIndirectDraw = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
     }
 
+    if (LowerKey == "bindless" || LowerKey == "enablebindless")
+    {
+        OutConfig.bEnableBindless = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
+    if (LowerKey == "shaderhotreload" || LowerKey == "enableshaderhotreload")
+    {
+        OutConfig.bEnableShaderHotReload = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
+    if (LowerKey == "optimizemeshes" || LowerKey == "enablemeshoptimization")
+    {
+        OutConfig.bOptimizeMeshes = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
+    if (LowerKey == "meshshaders" || LowerKey == "enablemeshshaders")
+    {
+        OutConfig.bEnableMeshShaders = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
+    if (LowerKey == "tiledlighting" || LowerKey == "enabletiledlighting")
+    {
+        OutConfig.bEnableTiledLighting = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
+    if (LowerKey == "shadingratequality" || LowerKey == "vrsquality" || LowerKey == "vrs")
+    {
+        if (LowerValue == "off" || LowerValue == "0" || LowerValue == "false" || LowerValue == "no")
+        {
+            OutConfig.ShadingRateQuality = EShadingRateQuality::Off;
+        }
+        else if (LowerValue == "quality")
+        {
+            OutConfig.ShadingRateQuality = EShadingRateQuality::Quality;
+        }
+        else if (LowerValue == "performance")
+        {
+            OutConfig.ShadingRateQuality = EShadingRateQuality::Performance;
+        }
+        else if (LowerValue == "balanced" || LowerValue == "1" || LowerValue == "true" || LowerValue == "yes")
+        {
+            OutConfig.ShadingRateQuality = EShadingRateQuality::Balanced;
+        }
+        else
+        {
+            LogWarning("Invalid shading rate quality in renderer config: " + Value);
+        }
+    }
+
+    if (LowerKey == "showshadingrate" || LowerKey == "shadingrateoverlay")
+    {
+        OutConfig.bShowShadingRate = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
+    if (LowerKey == "lods" || LowerKey == "generatelods")
+    {
+        OutConfig.bGenerateLods = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
+    if (LowerKey == "streamtextures" || LowerKey == "streamscenetextures")
+    {
+        OutConfig.bStreamSceneTextures = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
+    if (LowerKey == "streammips" || LowerKey == "streamtexturemips")
+    {
+        OutConfig.bStreamTextureMips = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
+    if (LowerKey == "texturebudgetmb" || LowerKey == "texturestreamingbudgetmb")
+    {
+        try
+        {
+            const int32_t ParsedValue = std::stoi(Value);
+            OutConfig.TextureStreamingBudgetMB = static_cast<uint32_t>((std::max)(ParsedValue, 0));
+        }
+        catch (...)
+        {
+            LogWarning("Invalid texture streaming budget in renderer config: " + Value);
+        }
+    }
+
+    if (LowerKey == "texturecachemb" || LowerKey == "texturecachebudgetmb")
+    {
+        try
+        {
+            const int32_t ParsedValue = std::stoi(Value);
+            OutConfig.TextureCacheBudgetMB = static_cast<uint32_t>((std::max)(ParsedValue, 0));
+        }
+        catch (...)
+        {
+            LogWarning("Invalid texture cache budget in renderer config: " + Value);
+        }
+    }
+
+    if (LowerKey == "gpumemorybudgets")
+    {
+        OutConfig.GpuMemoryBudgets = Value;
+    }
+
+    if (LowerKey == "lodbias")
+    {
+        try
+        {
+            OutConfig.LodBias = std::stof(Value);
+        }
+        catch (...)
+        {
+            LogWarning("Invalid LOD bias value in renderer config: " + Value);
+        }
+    }
+
+    if (LowerKey == "minscreencoverage")
+    {
+        try
+        {
+            OutConfig.MinScreenCoverage = std::stof(Value);
+        }
+        catch (...)
+        {
+            LogWarning("Invalid minimum screen coverage in renderer config: " + Value);
+        }
+    }
+
+    if (LowerKey == "shadowminscreencoverage")
+    {
+        try
+        {
+            OutConfig.ShadowMinScreenCoverage = std::stof(Value);
+        }
+        catch (...)
+        {
+            LogWarning("Invalid shadow minimum screen coverage in renderer config: " + Value);
+        }
+    }
+
     if (LowerKey == "width" || LowerKey == "windowwidth")
     {
         try
@@ -319,6 +589,69 @@ void FRendererConfigLoader::ApplyKeyValue(const std::string& Key, const std::str
         }
     }
 
+    if (LowerKey == "benchmark")
+    {
+        OutConfig.bBenchmark = (LowerValue == "1" || LowerValue == "true" || LowerValue == "yes");
+    }
+
+    if (LowerKey == "benchmarkwarmupframes")
+    {
+        try
+        {
+            OutConfig.BenchmarkWarmupFrames = static_cast<uint32_t>((std::max)(0, std::stoi(Value)));
+        }
+        catch (...)
+        {
+            LogWarning("Invalid benchmark warmup frame count in renderer config: " + Value);
+        }
+    }
+
+    if (LowerKey == "benchmarkframes")
+    {
+        try
+        {
+            OutConfig.BenchmarkFrames = static_cast<uint32_t>((std::max)(1, std::stoi(Value)));
+        }
+        catch (...)
+        {
+            LogWarning("Invalid benchmark frame count in renderer config: " + Value);
+        }
+    }
+
+    if (LowerKey == "benchmarkoutput")
+    {
+        OutConfig.BenchmarkOutput = ToWide(Value);
+    }
+
+    if (LowerKey == "batchjobs")
+    {
+        OutConfig.BatchJobs = ToWide(Value);
+    }
+
+    if (LowerKey == "batchreadbackdepth")
+    {
+        try
+        {
+            OutConfig.BatchReadbackDepth = static_cast<uint32_t>((std::max)(1, std::stoi(Value)));
+        }
+        catch (...)
+        {
+            LogWarning("Invalid batch readback depth in renderer config: " + Value);
+        }
+    }
+
+    if (LowerKey == "batchwarmupframes")
+    {
+        try
+        {
+            OutConfig.BatchWarmupFrames = static_cast<uint32_t>((std::max)(0, std::stoi(Value)));
+        }
+        catch (...)
+        {
+            LogWarning("Invalid batch warmup frame count in renderer config: " + Value);
+        }
+    }
+
     if (LowerKey == "resolution")
     {
         const size_t Separator = Value.find_first_of("xX");
@@ -4,6 +4,8 @@
 #include <filesystem>
 #include <string>
 
+#include "../Render/VariableRateShading.h"
+
 enum class ERendererType
 {
     Deferred,
@@ -15,7 +17,11 @@ struct FRendererConfig
     ERendererType RendererType = ERendererType::Deferred;
     std::wstring SceneFile = L"Assets/Scenes/Scene.json";
     bool bUseDepthPrepass = true;
+    // Alpha-masked models that turn the depth prepass on regardless of bUseDepthPrepass; 0 never.
+    uint32_t MaskedDepthPrepassThreshold = 16;
     uint32_t FramesInFlight = 3;
+    // Presents the swap chain may queue before the game thread waits to sample input; 0 paces on fences only.
+    uint32_t MaxFrameLatency = 1;
     bool bEnableFrameOverlap = true;
     bool bEnableShadows = true;
     float ShadowBias = 0.0f;
@@ -24,6 +30,7 @@ struct FRendererConfig
     float TonemapGamma = 2.2f;
     bool bEnableCas = true;
     float CasSharpness = 0.5f;
+    bool bEnableFusedPost = true;
     bool bEnableAutoExposure = true;
     float AutoExposureKey = 0.3f;
     float AutoExposureMin = 0.1f;
@@ -32,20 +39,60 @@ struct FRendererConfig
     float AutoExposureSpeedDown = 1.0f;
     bool bEnableTAA = true;
     float TaaHistoryWeight = 0.9f;
+    bool bEnableDynamicResolution = false;
+    float DynamicResolutionTargetMs = 16.6f;
+    float DynamicResolutionMinScale = 0.5f;
     bool bEnableTaskSystem = true;
+    // Records and presents on a render thread while the game thread updates the next frame.
+    bool bEnableRenderThread = true;
     bool bLogResourceBarriers = false;
     bool bEnableGraphDump = false;
     bool bEnableGpuTiming = false;
+    // Pipeline statistics per pass and GPU culling counters in the profiler and benchmark report.
+    bool bEnablePipelineStatistics = false;
+    bool bEnableCpuProfiler = false;
+    bool bEnableAsyncCompute = true;
+    bool bEnableParallelRecording = true;
     bool bEnableIndirectDraw = true;
+    bool bEnableBindless = true;
     bool bEnableGpuDebugPrint = true;
+    bool bEnableShaderHotReload = true;
+    bool bOptimizeMeshes = true;
+    bool bEnableMeshShaders = true;
+    bool bEnableTiledLighting = true;
+    bool bGenerateLods = true;
+    float LodBias = 0.0f;
+    float MinScreenCoverage = 1.0f;
+    float ShadowMinScreenCoverage = 2.0f;
+    bool bStreamSceneTextures = true;
+    bool bStreamTextureMips = true;
+    uint32_t TextureStreamingBudgetMB = 0;
+    uint32_t TextureCacheBudgetMB = 1024;
+    // category:MB pairs for FDX12MemoryTracker, e.g. "texture:1024,rendertarget:512"; empty sets none.
+    std::string GpuMemoryBudgets;
+    EShadingRateQuality ShadingRateQuality = EShadingRateQuality::Balanced;
+    bool bShowShadingRate = false;
     uint32_t WindowWidth = 1280;
     uint32_t WindowHeight = 720;
+    // Plays the scene's camera path at a fixed time step, writes BenchmarkOutput and exits.
+    bool bBenchmark = false;
+    uint32_t BenchmarkWarmupFrames = 60;
+    uint32_t BenchmarkFrames = 600;
+    std::wstring BenchmarkOutput = L"Captures/Benchmark.json";
+    // Job list rendered without a window instead of running the application; see FOffscreenBatch.
+    std::wstring BatchJobs;
+    // Readback buffers, and frames in flight, of a batch run.
+    uint32_t BatchReadbackDepth = 3;
+    // Frames rendered before each captured one, so TAA history and auto exposure settle.
+    uint32_t BatchWarmupFrames = 16;
 };
 
 class FRendererConfigLoader
 {
 public:
     static FRendererConfig LoadOrDefault(const std::filesystem::path& ConfigPath);
+    // Overrides config keys from "-key=value" arguments; a bare "-key" sets it to "1".
+    static void ApplyCommandLine(const std::wstring& CommandLine, FRendererConfig& InOutConfig);
 
 private:
     static void ApplyKeyValue(const std::string& Key, const std::string& Value, FRendererConfig& OutConfig);
@@ -3,9 +3,29 @@
 #endif
 
 #include "TaskSystem.h"
+#include "CpuProfiler.h"
 #include "Logger.h"
 #include <algorithm>
 
+namespace
+{
+    // Tasks share a small set of wait slots instead of each owning a mutex and condition variable
+    struct FTaskWaitSlot
+    {
+        std::mutex Mutex;
+        std::condition_variable CV;
+    };
+
+    constexpr uintptr_t TaskWaitSlotCount = 64;
+    FTaskWaitSlot GTaskWaitSlots[TaskWaitSlotCount];
+
+    FTaskWaitSlot& GetTaskWaitSlot(const FTask* Task)
+    {
+        const uintptr_t Address = reinterpret_cast<uintptr_t>(Task);
+        return GTaskWaitSlots[(Address / alignof(std::max_align_t)) % TaskWaitSlotCount];
+    }
+}
+
 // FTask implementation
 
 FTask::FTask(FTaskFunction InFunction)
@@ -15,26 +35,174 @@ FTask::FTask(FTaskFunction InFunction)
 
 void FTask::Execute()
 {
-    if (Function)
+    if (InlineInvoke)
+    {
+        InlineInvoke(InlineStorage, true);
+        InlineInvoke = nullptr;
+    }
+    else if (Function)
     {
         Function();
     }
 
+    if (bPooled)
+    {
+        // Pooled tasks are tracked through their counter and are never waited on directly
+        bCompleted.store(true, std::memory_order_release);
+        return;
+    }
+
+    FTaskWaitSlot& Slot = GetTaskWaitSlot(this);
     {
-        std::lock_guard<std::mutex> Lock(CompletionMutex);
+        std::lock_guard<std::mutex> Lock(Slot.Mutex);
         bCompleted.store(true, std::memory_order_release);
     }
-    CompletionCV.notify_all();
+    Slot.CV.notify_all();
 }
 
 void FTask::Wait() const
 {
-    std::unique_lock<std::mutex> Lock(CompletionMutex);
-    CompletionCV.wait(Lock, [this]() { return bCompleted.load(std::memory_order_acquire); });
+    FTaskWaitSlot& Slot = GetTaskWaitSlot(this);
+    std::unique_lock<std::mutex> Lock(Slot.Mutex);
+    Slot.CV.wait(Lock, [this]() { return bCompleted.load(std::memory_order_acquire); });
+}
+
+bool FTask::WaitFor(std::chrono::microseconds Timeout) const
+{
+    FTaskWaitSlot& Slot = GetTaskWaitSlot(this);
+    std::unique_lock<std::mutex> Lock(Slot.Mutex);
+    return Slot.CV.wait_for(Lock, Timeout, [this]() { return bCompleted.load(std::memory_order_acquire); });
+}
+
+bool FTask::AddDependent(const std::shared_ptr<FTask>& Dependent)
+{
+    std::lock_guard<std::mutex> Lock(GetTaskWaitSlot(this).Mutex);
+    if (bCompleted.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    Dependents.push_back(Dependent);
+    return true;
+}
+
+std::vector<std::shared_ptr<FTask>> FTask::TakeDependents()
+{
+    // Completion is set under the same lock, so no dependent can be added after this
+    std::lock_guard<std::mutex> Lock(GetTaskWaitSlot(this).Mutex);
+    return std::move(Dependents);
+}
+
+// FWorkStealingQueue implementation
+
+bool FWorkStealingQueue::Push(FTask* Task)
+{
+    const int64_t B = Bottom.load(std::memory_order_relaxed);
+    const int64_t T = Top.load(std::memory_order_acquire);
+    if (B - T >= Capacity)
+    {
+        return false;
+    }
+
+    Buffer[B & IndexMask].store(Task, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Bottom.store(B + 1, std::memory_order_relaxed);
+    return true;
+}
+
+FTask* FWorkStealingQueue::Pop()
+{
+    const int64_t B = Bottom.load(std::memory_order_relaxed) - 1;
+    Bottom.store(B, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t T = Top.load(std::memory_order_relaxed);
+
+    if (T > B)
+    {
+        // Queue was already empty
+        Bottom.store(B + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    FTask* Task = Buffer[B & IndexMask].load(std::memory_order_relaxed);
+    if (T == B)
+    {
+        // Last element, race against thieves for it
+        if (!Top.compare_exchange_strong(T, T + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            Task = nullptr;
+        }
+        Bottom.store(B + 1, std::memory_order_relaxed);
+    }
+
+    return Task;
+}
+
+FTask* FWorkStealingQueue::Steal()
+{
+    int64_t T = Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t B = Bottom.load(std::memory_order_acquire);
+
+    if (T >= B)
+    {
+        return nullptr;
+    }
+
+    FTask* Task = Buffer[T & IndexMask].load(std::memory_order_relaxed);
+    if (!Top.compare_exchange_strong(T, T + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        return nullptr;
+    }
+
+    return Task;
+}
+
+bool FWorkStealingQueue::IsEmpty() const
+{
+    const int64_t T = Top.load(std::memory_order_acquire);
+    const int64_t B = Bottom.load(std::memory_order_acquire);
+    return T >= B;
 }
 
 // FTaskScheduler implementation
 
+namespace
+{
+    constexpr uint32_t InvalidWorkerIndex = ~0u;
+    constexpr uint32_t SpinCountBeforeSleep = 64;
+    constexpr std::chrono::microseconds HelpWaitTimeout(200);
+    constexpr size_t TaskPoolSlabSize = 256;
+    constexpr size_t TaskCacheBatchSize = 32;
+
+    // Index of the worker owning the current thread, InvalidWorkerIndex for non-worker threads
+    thread_local uint32_t GCurrentWorkerIndex = InvalidWorkerIndex;
+
+    // Priority of the task executing on the current thread
+    thread_local ETaskPriority GCurrentTaskPriority = ETaskPriority::Normal;
+}
+
+// Per-thread stash of free pooled tasks so spawning only takes the pool lock once per batch
+struct FThreadTaskCache
+{
+    std::vector<FTask*> Tasks;
+
+    FThreadTaskCache()
+    {
+        Tasks.reserve(TaskCacheBatchSize * 2);
+    }
+
+    ~FThreadTaskCache()
+    {
+        FTaskScheduler::Get().FlushTaskCache(Tasks, 0);
+    }
+};
+
+namespace
+{
+    thread_local FThreadTaskCache GThreadTaskCache;
+}
+
 FTaskScheduler& FTaskScheduler::Get()
 {
     static FTaskScheduler Instance;
@@ -46,7 +214,7 @@ FTaskScheduler::~FTaskScheduler()
     Shutdown();
 }
 
-void FTaskScheduler::Initialize(uint32_t NumThreads)
+void FTaskScheduler::Initialize(uint32_t NumThreads, uint32_t NumIOThreads)
 {
     if (bIsRunning.load(std::memory_order_acquire))
     {
@@ -65,15 +233,29 @@ void FTaskScheduler::Initialize(uint32_t NumThreads)
 
     // Reserve one thread for main thread, use rest for workers
     NumThreads = std::max(1u, NumThreads - 1);
+    MaxBackgroundTaskCount = std::max(1u, NumThreads - 1);
 
-    LogInfo("Initializing TaskScheduler with " + std::to_string(NumThreads) + " worker threads");
+    LogInfo("Initializing TaskScheduler with " + std::to_string(NumThreads) + " worker threads and " + std::to_string(NumIOThreads) + " I/O threads");
 
     bIsRunning.store(true, std::memory_order_release);
 
+    // Queues must exist before any worker starts stealing from them
+    WorkerQueues.reserve(NumThreads);
+    for (uint32_t i = 0; i < NumThreads; ++i)
+    {
+        WorkerQueues.push_back(std::make_unique<FWorkerQueues>());
+    }
+
     WorkerThreads.reserve(NumThreads);
     for (uint32_t i = 0; i < NumThreads; ++i)
     {
-        WorkerThreads.emplace_back(&FTaskScheduler::WorkerThreadFunction, this);
+        WorkerThreads.emplace_back(&FTaskScheduler::WorkerThreadFunction, this, i);
+    }
+
+    IOThreads.reserve(NumIOThreads);
+    for (uint32_t i = 0; i < NumIOThreads; ++i)
+    {
+        IOThreads.emplace_back(&FTaskScheduler::IOThreadFunction, this);
     }
 
     LogInfo("TaskScheduler initialized successfully");
@@ -88,8 +270,16 @@ void FTaskScheduler::Shutdown()
 
     LogInfo("Shutting down TaskScheduler");
 
-    bIsRunning.store(false, std::memory_order_release);
-    QueueCV.notify_all();
+    {
+        std::lock_guard<std::mutex> Lock(SleepMutex);
+        bIsRunning.store(false, std::memory_order_release);
+    }
+    SleepCV.notify_all();
+
+    {
+        std::lock_guard<std::mutex> Lock(IOQueueMutex);
+    }
+    IOQueueCV.notify_all();
 
     for (std::thread& Thread : WorkerThreads)
     {
@@ -99,109 +289,698 @@ void FTaskScheduler::Shutdown()
         }
     }
 
+    for (std::thread& Thread : IOThreads)
+    {
+        if (Thread.joinable())
+        {
+            Thread.join();
+        }
+    }
+
     WorkerThreads.clear();
+    IOThreads.clear();
 
-    // Clear any remaining tasks
+    // Release any remaining tasks; all threads are joined so the queues can be drained from here
+    std::vector<FTask*> UnfinishedTasks;
+    for (std::unique_ptr<FWorkerQueues>& Worker : WorkerQueues)
     {
-        std::lock_guard<std::mutex> Lock(QueueMutex);
-        while (!TaskQueue.empty())
+        for (FWorkStealingQueue& Queue : Worker->Queues)
         {
-            TaskQueue.pop();
+            while (FTask* Task = Queue.Steal())
+            {
+                UnfinishedTasks.push_back(Task);
+            }
         }
     }
+    WorkerQueues.clear();
+
+    {
+        std::lock_guard<std::mutex> Lock(GlobalQueueMutex);
+        for (std::deque<FTask*>& Queue : GlobalQueues)
+        {
+            UnfinishedTasks.insert(UnfinishedTasks.end(), Queue.begin(), Queue.end());
+            Queue.clear();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock(IOQueueMutex);
+        UnfinishedTasks.insert(UnfinishedTasks.end(), IOQueue.begin(), IOQueue.end());
+        IOQueue.clear();
+    }
+
+    for (FTask* Task : UnfinishedTasks)
+    {
+        if (Task->bPooled)
+        {
+            // Destroy the stored lambda without running it and release the counter
+            if (Task->InlineInvoke)
+            {
+                Task->InlineInvoke(Task->InlineStorage, false);
+                Task->InlineInvoke = nullptr;
+            }
+            CompletePooledTask(Task);
+        }
+        else
+        {
+            Task->SelfRef.reset();
+        }
+    }
+
+    for (std::atomic<uint32_t>& Count : PendingTaskCounts)
+    {
+        Count.store(0, std::memory_order_release);
+    }
+    ActiveBackgroundTaskCount.store(0, std::memory_order_release);
 
     LogInfo("TaskScheduler shut down complete");
 }
 
-FTaskRef FTaskScheduler::ScheduleTask(FTask::FTaskFunction Function)
+FTaskRef FTaskScheduler::ScheduleTask(FTask::FTaskFunction Function, ETaskPriority Priority)
 {
     FTaskRef Task = std::make_shared<FTask>(std::move(Function));
+    Task->Priority = Priority;
     EnqueueTask(Task);
     return Task;
 }
 
-std::vector<FTaskRef> FTaskScheduler::ScheduleTaskBatch(const std::vector<FTask::FTaskFunction>& Functions)
+FTaskRef FTaskScheduler::ScheduleTask(FTask::FTaskFunction Function, const std::vector<FTaskRef>& Prerequisites, ETaskPriority Priority)
+{
+    FTaskRef Task = std::make_shared<FTask>(std::move(Function));
+    Task->Priority = Priority;
+    if (AddPrerequisites(Task, Prerequisites))
+    {
+        EnqueueTask(Task);
+    }
+    return Task;
+}
+
+std::vector<FTaskRef> FTaskScheduler::ScheduleTaskBatch(const std::vector<FTask::FTaskFunction>& Functions, ETaskPriority Priority)
+{
+    std::vector<FTaskRef> Tasks;
+    Tasks.reserve(Functions.size());
+
+    for (const auto& Function : Functions)
+    {
+        FTaskRef Task = std::make_shared<FTask>(Function);
+        Task->Priority = Priority;
+        Tasks.push_back(std::move(Task));
+    }
+
+    EnqueueTaskBatch(Tasks, Priority);
+    return Tasks;
+}
+
+std::vector<FTaskRef> FTaskScheduler::ScheduleTaskBatch(const std::vector<FTask::FTaskFunction>& Functions, const std::vector<FTaskRef>& Prerequisites, ETaskPriority Priority)
 {
     std::vector<FTaskRef> Tasks;
     Tasks.reserve(Functions.size());
 
+    std::vector<FTaskRef> ReadyTasks;
     for (const auto& Function : Functions)
     {
-        Tasks.push_back(ScheduleTask(Function));
+        FTaskRef Task = std::make_shared<FTask>(Function);
+        Task->Priority = Priority;
+        if (AddPrerequisites(Task, Prerequisites))
+        {
+            ReadyTasks.push_back(Task);
+        }
+        Tasks.push_back(std::move(Task));
     }
 
+    EnqueueTaskBatch(ReadyTasks, Priority);
     return Tasks;
 }
 
+FTaskRef FTaskScheduler::ScheduleJoin(const std::vector<FTaskRef>& Tasks)
+{
+    // Joins are empty, run them as soon as possible so waiters are released promptly
+    return ScheduleTask(FTask::FTaskFunction(), Tasks, ETaskPriority::High);
+}
+
+bool FTaskScheduler::AddPrerequisites(const FTaskRef& Task, const std::vector<FTaskRef>& Prerequisites)
+{
+    // The guard reference stops a prerequisite that finishes mid-setup from releasing the task early
+    Task->PendingPrerequisiteCount.store(1, std::memory_order_relaxed);
+
+    for (const FTaskRef& Prerequisite : Prerequisites)
+    {
+        if (!Prerequisite)
+        {
+            continue;
+        }
+
+        Task->PendingPrerequisiteCount.fetch_add(1, std::memory_order_acq_rel);
+        if (!Prerequisite->AddDependent(Task))
+        {
+            // Already complete, drop the count we just took
+            Task->PendingPrerequisiteCount.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    // Drop the guard; the caller enqueues the task if nothing is outstanding
+    return Task->PendingPrerequisiteCount.fetch_sub(1, std::memory_order_acq_rel) == 1;
+}
+
+void FTaskScheduler::ReleasePrerequisite(const FTaskRef& Task)
+{
+    if (Task->PendingPrerequisiteCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        EnqueueTask(Task);
+    }
+}
+
+ETaskPriority FTaskScheduler::GetCurrentTaskPriority()
+{
+    return GCurrentTaskPriority;
+}
+
+uint32_t FTaskScheduler::GetTotalPendingTaskCount() const
+{
+    uint32_t Total = 0;
+    for (const std::atomic<uint32_t>& Count : PendingTaskCounts)
+    {
+        Total += Count.load(std::memory_order_acquire);
+    }
+    return Total;
+}
+
 void FTaskScheduler::WaitForAll()
 {
-    // Wait until all tasks are complete
-    while (true)
+    // Wait until all tasks are complete, helping with the queued work meanwhile
+    while (GetTotalPendingTaskCount() != 0 || ActiveTaskCount.load(std::memory_order_acquire) != 0)
     {
+        if (!TryExecuteOneTask())
         {
-            std::lock_guard<std::mutex> Lock(QueueMutex);
-            if (TaskQueue.empty() && ActiveTaskCount.load(std::memory_order_acquire) == 0)
-            {
-                break;
-            }
+            std::this_thread::yield();
         }
-        std::this_thread::yield();
     }
 }
 
 void FTaskScheduler::WaitForTask(const FTaskRef& Task)
 {
-    if (Task)
+    if (!Task)
+    {
+        return;
+    }
+
+    if (!IsRunning())
     {
         Task->Wait();
+        return;
+    }
+
+    uint32_t IdleSpins = 0;
+    while (!Task->IsComplete())
+    {
+        if (TryExecuteOneTask())
+        {
+            IdleSpins = 0;
+            continue;
+        }
+
+        if (++IdleSpins < SpinCountBeforeSleep)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Nothing to help with; the target is running elsewhere. Sleep briefly but keep
+        // polling the queues in case it spawns subtasks we could pick up.
+        IdleSpins = 0;
+        Task->WaitFor(HelpWaitTimeout);
     }
 }
 
-void FTaskScheduler::WorkerThreadFunction()
+bool FTaskScheduler::TryExecuteOneTask()
 {
+    if (!IsRunning())
+    {
+        return false;
+    }
+
+    // Waiters never claim a background slot: frame-time waiters skip background work
+    // entirely, and a background waiter runs its subtasks inside the slot it already holds
+    if (FTask* Task = FindTask(GCurrentWorkerIndex, false))
+    {
+        RunTask(Task);
+        return true;
+    }
+
+    return false;
+}
+
+void FTaskScheduler::WorkerThreadFunction(uint32_t WorkerIndex)
+{
+    GCurrentWorkerIndex = WorkerIndex;
+    CPU_PROFILE_THREAD_NAME(("Worker " + std::to_string(WorkerIndex)).c_str());
+
+    uint32_t IdleSpins = 0;
     while (bIsRunning.load(std::memory_order_acquire))
     {
-        FTaskRef Task = GetNextTask();
+        if (FTask* Task = FindTask(WorkerIndex, true))
+        {
+            const bool bBackground = Task->Priority == ETaskPriority::Background;
+            RunTask(Task);
+            if (bBackground)
+            {
+                ReleaseBackgroundSlot();
+            }
+            IdleSpins = 0;
+            continue;
+        }
+
+        if (++IdleSpins < SpinCountBeforeSleep)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        IdleSpins = 0;
+
+        // Sleeping count is published before the pending counts are re-checked so that
+        // an enqueue racing with us either sees a sleeper or we see its task.
+        std::unique_lock<std::mutex> Lock(SleepMutex);
+        SleepingWorkerCount.fetch_add(1, std::memory_order_seq_cst);
+        SleepCV.wait(Lock, [this]()
+        {
+            return HasRunnableWork() || !bIsRunning.load(std::memory_order_acquire);
+        });
+        SleepingWorkerCount.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    GCurrentWorkerIndex = InvalidWorkerIndex;
+}
 
-        if (Task)
+void FTaskScheduler::IOThreadFunction()
+{
+    CPU_PROFILE_THREAD_NAME("I/O");
+
+    while (true)
+    {
+        FTask* Task = nullptr;
         {
-            ActiveTaskCount.fetch_add(1, std::memory_order_acq_rel);
-            Task->Execute();
-            ActiveTaskCount.fetch_sub(1, std::memory_order_acq_rel);
+            std::unique_lock<std::mutex> Lock(IOQueueMutex);
+            IOQueueCV.wait(Lock, [this]()
+            {
+                return !IOQueue.empty() || !bIsRunning.load(std::memory_order_acquire);
+            });
+
+            if (!bIsRunning.load(std::memory_order_acquire))
+            {
+                break;
+            }
+
+            Task = IOQueue.front();
+            IOQueue.pop_front();
         }
+
+        RunTask(Task);
     }
 }
 
-FTaskRef FTaskScheduler::GetNextTask()
+bool FTaskScheduler::HasRunnableWork() const
 {
-    std::unique_lock<std::mutex> Lock(QueueMutex);
-    QueueCV.wait(Lock, [this]()
+    const auto PendingCount = [this](ETaskPriority Priority)
     {
-        return !TaskQueue.empty() || !bIsRunning.load(std::memory_order_acquire);
-    });
+        return PendingTaskCounts[static_cast<uint32_t>(Priority)].load(std::memory_order_seq_cst);
+    };
 
-    if (!bIsRunning.load(std::memory_order_acquire))
+    if (PendingCount(ETaskPriority::High) != 0 || PendingCount(ETaskPriority::Normal) != 0)
+    {
+        return true;
+    }
+
+    return PendingCount(ETaskPriority::Background) != 0 &&
+        ActiveBackgroundTaskCount.load(std::memory_order_seq_cst) < MaxBackgroundTaskCount;
+}
+
+void FTaskScheduler::ReleaseBackgroundSlot()
+{
+    ActiveBackgroundTaskCount.fetch_sub(1, std::memory_order_seq_cst);
+
+    // A worker may have gone to sleep because the background slots were full
+    if (PendingTaskCounts[static_cast<uint32_t>(ETaskPriority::Background)].load(std::memory_order_seq_cst) != 0)
+    {
+        WakeWorkers(1);
+    }
+}
+
+FTask* FTaskScheduler::FindTask(uint32_t WorkerIndex, bool bClaimBackgroundSlot)
+{
+    const uint32_t HighIndex = static_cast<uint32_t>(ETaskPriority::High);
+    const uint32_t NormalIndex = static_cast<uint32_t>(ETaskPriority::Normal);
+    const uint32_t BackgroundIndex = static_cast<uint32_t>(ETaskPriority::Background);
+
+    if (PendingTaskCounts[HighIndex].load(std::memory_order_acquire) != 0)
+    {
+        if (FTask* Task = FindTaskWithPriority(WorkerIndex, HighIndex))
+        {
+            return Task;
+        }
+    }
+
+    if (PendingTaskCounts[NormalIndex].load(std::memory_order_acquire) != 0)
+    {
+        if (FTask* Task = FindTaskWithPriority(WorkerIndex, NormalIndex))
+        {
+            return Task;
+        }
+    }
+
+    if (PendingTaskCounts[BackgroundIndex].load(std::memory_order_acquire) == 0)
     {
         return nullptr;
     }
 
-    if (TaskQueue.empty())
+    if (!bClaimBackgroundSlot)
+    {
+        return GCurrentTaskPriority == ETaskPriority::Background ? FindTaskWithPriority(WorkerIndex, BackgroundIndex) : nullptr;
+    }
+
+    if (ActiveBackgroundTaskCount.fetch_add(1, std::memory_order_seq_cst) >= MaxBackgroundTaskCount)
+    {
+        ActiveBackgroundTaskCount.fetch_sub(1, std::memory_order_seq_cst);
+        return nullptr;
+    }
+
+    if (FTask* Task = FindTaskWithPriority(WorkerIndex, BackgroundIndex))
+    {
+        return Task;
+    }
+
+    ReleaseBackgroundSlot();
+    return nullptr;
+}
+
+FTask* FTaskScheduler::FindTaskWithPriority(uint32_t WorkerIndex, uint32_t PriorityIndex)
+{
+    const uint32_t WorkerCount = static_cast<uint32_t>(WorkerQueues.size());
+    const bool bIsWorker = WorkerIndex < WorkerCount;
+
+    if (bIsWorker)
+    {
+        if (FTask* Task = WorkerQueues[WorkerIndex]->Queues[PriorityIndex].Pop())
+        {
+            return Task;
+        }
+    }
+
+    if (FTask* Task = TakeFromGlobalQueue(WorkerIndex, PriorityIndex))
+    {
+        return Task;
+    }
+
+    // Steal from the other workers, starting with the next one so victims are spread out.
+    // Non-worker threads that are helping while they wait scan every worker.
+    const uint32_t FirstOffset = bIsWorker ? 1u : 0u;
+    const uint32_t StartIndex = bIsWorker ? WorkerIndex : 0u;
+    for (uint32_t Offset = FirstOffset; Offset < WorkerCount; ++Offset)
+    {
+        const uint32_t VictimIndex = (StartIndex + Offset) % WorkerCount;
+        if (FTask* Task = WorkerQueues[VictimIndex]->Queues[PriorityIndex].Steal())
+        {
+            return Task;
+        }
+    }
+
+    return nullptr;
+}
+
+FTask* FTaskScheduler::TakeFromGlobalQueue(uint32_t WorkerIndex, uint32_t PriorityIndex)
+{
+    std::lock_guard<std::mutex> Lock(GlobalQueueMutex);
+    std::deque<FTask*>& GlobalQueue = GlobalQueues[PriorityIndex];
+    if (GlobalQueue.empty())
     {
         return nullptr;
     }
 
-    FTaskRef Task = TaskQueue.front();
-    TaskQueue.pop();
+    FTask* Task = GlobalQueue.front();
+    GlobalQueue.pop_front();
+
+    // Threads outside the pool have no deque to stash a share in, and background work is
+    // taken one task at a time so the slot limit decides how much of it runs
+    if (WorkerIndex >= WorkerQueues.size() || PriorityIndex == static_cast<uint32_t>(ETaskPriority::Background))
+    {
+        return Task;
+    }
+
+    // Move a fair share of the remaining tasks into our deque so the rest of the
+    // batch is distributed by stealing instead of by this lock
+    const size_t WorkerCount = WorkerQueues.size();
+    const size_t ShareCount = std::min<size_t>(GlobalQueue.size() / WorkerCount, FWorkStealingQueue::Capacity / 2);
+
+    FWorkStealingQueue& LocalQueue = WorkerQueues[WorkerIndex]->Queues[PriorityIndex];
+    for (size_t i = 0; i < ShareCount; ++i)
+    {
+        if (!LocalQueue.Push(GlobalQueue.front()))
+        {
+            break;
+        }
+        GlobalQueue.pop_front();
+    }
+
+    if (ShareCount > 0)
+    {
+        WakeWorkers(static_cast<uint32_t>(ShareCount));
+    }
+
     return Task;
 }
 
+void FTaskScheduler::RunTask(FTask* Task)
+{
+    CPU_PROFILE_SCOPE("Task");
+
+    ActiveTaskCount.fetch_add(1, std::memory_order_acq_rel);
+    PendingTaskCounts[static_cast<uint32_t>(Task->Priority)].fetch_sub(1, std::memory_order_acq_rel);
+
+    // Nested waits inside the task consult this to decide which work they may help with
+    const ETaskPriority PreviousPriority = GCurrentTaskPriority;
+    GCurrentTaskPriority = Task->Priority;
+
+    if (Task->bPooled)
+    {
+        Task->Execute();
+        CompletePooledTask(Task);
+        GCurrentTaskPriority = PreviousPriority;
+        ActiveTaskCount.fetch_sub(1, std::memory_order_acq_rel);
+        return;
+    }
+
+    // Take over the queue's reference so the task is released once it has run
+    FTaskRef TaskRef = std::move(Task->SelfRef);
+    TaskRef->Execute();
+    GCurrentTaskPriority = PreviousPriority;
+
+    // Dependents are released before this task stops counting as active so WaitForAll
+    // never observes a gap between a prerequisite finishing and its dependents queuing
+    for (const FTaskRef& Dependent : TaskRef->TakeDependents())
+    {
+        ReleasePrerequisite(Dependent);
+    }
+
+    ActiveTaskCount.fetch_sub(1, std::memory_order_acq_rel);
+}
+
 void FTaskScheduler::EnqueueTask(FTaskRef Task)
 {
+    FTask* RawTask = Task.get();
+    RawTask->SelfRef = std::move(Task);
+    PushTask(RawTask);
+}
+
+void FTaskScheduler::PushTask(FTask* Task)
+{
+    if (Task->Priority == ETaskPriority::IO && IOThreads.empty())
     {
-        std::lock_guard<std::mutex> Lock(QueueMutex);
-        TaskQueue.push(Task);
+        Task->Priority = ETaskPriority::Background;
+    }
+
+    const uint32_t PriorityIndex = static_cast<uint32_t>(Task->Priority);
+    PendingTaskCounts[PriorityIndex].fetch_add(1, std::memory_order_seq_cst);
+
+    if (Task->Priority == ETaskPriority::IO)
+    {
+        {
+            std::lock_guard<std::mutex> Lock(IOQueueMutex);
+            IOQueue.push_back(Task);
+        }
+        IOQueueCV.notify_one();
+        return;
+    }
+
+    const uint32_t WorkerIndex = GCurrentWorkerIndex;
+    if (WorkerIndex == InvalidWorkerIndex || WorkerIndex >= WorkerQueues.size() || !WorkerQueues[WorkerIndex]->Queues[PriorityIndex].Push(Task))
+    {
+        std::lock_guard<std::mutex> Lock(GlobalQueueMutex);
+        GlobalQueues[PriorityIndex].push_back(Task);
+    }
+
+    WakeWorkers(1);
+}
+
+void FTaskScheduler::EnqueueTaskBatch(const std::vector<FTaskRef>& Tasks, ETaskPriority Priority)
+{
+    if (Tasks.empty())
+    {
+        return;
+    }
+
+    if (Priority == ETaskPriority::IO)
+    {
+        for (const FTaskRef& Task : Tasks)
+        {
+            EnqueueTask(Task);
+        }
+        return;
+    }
+
+    const uint32_t PriorityIndex = static_cast<uint32_t>(Priority);
+    for (const FTaskRef& Task : Tasks)
+    {
+        Task->SelfRef = Task;
+    }
+    PendingTaskCounts[PriorityIndex].fetch_add(static_cast<uint32_t>(Tasks.size()), std::memory_order_seq_cst);
+
+    const uint32_t WorkerIndex = GCurrentWorkerIndex;
+    size_t FirstGlobalIndex = 0;
+    if (WorkerIndex != InvalidWorkerIndex && WorkerIndex < WorkerQueues.size())
+    {
+        FWorkStealingQueue& LocalQueue = WorkerQueues[WorkerIndex]->Queues[PriorityIndex];
+        while (FirstGlobalIndex < Tasks.size() && LocalQueue.Push(Tasks[FirstGlobalIndex].get()))
+        {
+            ++FirstGlobalIndex;
+        }
+    }
+
+    if (FirstGlobalIndex < Tasks.size())
+    {
+        // One lock for the whole batch rather than one per task
+        std::lock_guard<std::mutex> Lock(GlobalQueueMutex);
+        for (size_t i = FirstGlobalIndex; i < Tasks.size(); ++i)
+        {
+            GlobalQueues[PriorityIndex].push_back(Tasks[i].get());
+        }
+    }
+
+    WakeWorkers(static_cast<uint32_t>(Tasks.size()));
+}
+
+void FTaskScheduler::WakeWorkers(uint32_t Count)
+{
+    if (SleepingWorkerCount.load(std::memory_order_seq_cst) == 0)
+    {
+        return;
+    }
+
+    {
+        // Taking the lock orders us after a worker that is between its predicate check and wait
+        std::lock_guard<std::mutex> Lock(SleepMutex);
+    }
+
+    if (Count == 1)
+    {
+        SleepCV.notify_one();
+    }
+    else
+    {
+        SleepCV.notify_all();
     }
-    QueueCV.notify_one();
+}
+
+void FTaskScheduler::WaitForCounter(const FTaskCounter& Counter)
+{
+    uint32_t IdleSpins = 0;
+    while (!Counter.IsDone())
+    {
+        if (TryExecuteOneTask())
+        {
+            IdleSpins = 0;
+            continue;
+        }
+
+        // Spawned tasks are short; back off gently rather than blocking
+        if (++IdleSpins < SpinCountBeforeSleep)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+FTask* FTaskScheduler::AllocatePooledTask()
+{
+    std::vector<FTask*>& Cache = GThreadTaskCache.Tasks;
+    if (Cache.empty())
+    {
+        RefillTaskCache(Cache);
+    }
+
+    FTask* Task = Cache.back();
+    Cache.pop_back();
+
+    Task->bCompleted.store(false, std::memory_order_relaxed);
+    Task->bPooled = true;
+    return Task;
+}
+
+void FTaskScheduler::FreePooledTask(FTask* Task)
+{
+    std::vector<FTask*>& Cache = GThreadTaskCache.Tasks;
+    Cache.push_back(Task);
+
+    if (Cache.size() >= TaskCacheBatchSize * 2)
+    {
+        FlushTaskCache(Cache, TaskCacheBatchSize);
+    }
+}
+
+void FTaskScheduler::CompletePooledTask(FTask* Task)
+{
+    // The counter may live on the waiter's stack, so it is released only after we are done with the task
+    FTaskCounter* Counter = Task->Counter;
+    Task->Counter = nullptr;
+    FreePooledTask(Task);
+
+    if (Counter)
+    {
+        Counter->Count.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+void FTaskScheduler::RefillTaskCache(std::vector<FTask*>& Cache)
+{
+    std::lock_guard<std::mutex> Lock(TaskPoolMutex);
+    if (FreePooledTasks.size() < TaskCacheBatchSize)
+    {
+        std::unique_ptr<FTask[]> Slab(new FTask[TaskPoolSlabSize]);
+        for (size_t i = 0; i < TaskPoolSlabSize; ++i)
+        {
+            FreePooledTasks.push_back(&Slab[i]);
+        }
+        TaskPoolSlabs.push_back(std::move(Slab));
+    }
+
+    const size_t TakeCount = (std::min)(TaskCacheBatchSize, FreePooledTasks.size());
+    Cache.insert(Cache.end(), FreePooledTasks.end() - TakeCount, FreePooledTasks.end());
+    FreePooledTasks.resize(FreePooledTasks.size() - TakeCount);
+}
+
+void FTaskScheduler::FlushTaskCache(std::vector<FTask*>& Cache, size_t KeepCount)
+{
+    if (Cache.size() <= KeepCount)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> Lock(TaskPoolMutex);
+    FreePooledTasks.insert(FreePooledTasks.end(), Cache.begin() + KeepCount, Cache.end());
+    Cache.resize(KeepCount);
 }
 
 // FParallelFor implementation
@@ -224,11 +1003,13 @@ void FParallelFor::Execute(uint32_t Start, uint32_t End, std::function<void(uint
         return;
     }
 
-    const uint32_t WorkerCount = Scheduler.GetWorkerThreadCount();
-    const uint32_t Range = End - Start;
-    const uint32_t BatchSize = std::max(1u, Range / (WorkerCount * 2));
-
-    ExecuteBatched(Start, End, BatchSize, Function);
+    ExecuteRange(Start, End, [&Function](uint32_t Begin, uint32_t RangeEnd)
+    {
+        for (uint32_t Index = Begin; Index < RangeEnd; ++Index)
+        {
+            Function(Index);
+        }
+    }, 8);
 }
 
 void FParallelFor::ExecuteBatched(uint32_t Start, uint32_t End, uint32_t BatchSize, std::function<void(uint32_t)> Function)
@@ -243,25 +1024,24 @@ void FParallelFor::ExecuteBatched(uint32_t Start, uint32_t End, uint32_t BatchSi
         BatchSize = 1;
     }
 
-    std::vector<FTask::FTaskFunction> Tasks;
+    // Batches are spawned from the task pool and reference Function by address, so the
+    // loop itself makes no allocations
+    FTaskScheduler& Scheduler = FTaskScheduler::Get();
+    FTaskCounter Counter;
+    const std::function<void(uint32_t)>* FunctionPtr = &Function;
+    const ETaskPriority Priority = FTaskScheduler::GetCurrentTaskPriority() == ETaskPriority::Background ? ETaskPriority::Background : ETaskPriority::High;
     for (uint32_t i = Start; i < End; i += BatchSize)
     {
-        const uint32_t BatchEnd = std::min(i + BatchSize, End);
-        Tasks.push_back([i, BatchEnd, Function]()
+        const uint32_t BatchEnd = (End - i > BatchSize) ? i + BatchSize : End;
+        Scheduler.Spawn(Counter, [i, BatchEnd, FunctionPtr]()
         {
             for (uint32_t Index = i; Index < BatchEnd; ++Index)
             {
-                Function(Index);
+                (*FunctionPtr)(Index);
             }
-        });
+        }, Priority);
     }
 
-    FTaskScheduler& Scheduler = FTaskScheduler::Get();
-    std::vector<FTaskRef> ScheduledTasks = Scheduler.ScheduleTaskBatch(Tasks);
-
     // Wait for all tasks to complete
-    for (const FTaskRef& Task : ScheduledTasks)
-    {
-        Scheduler.WaitForTask(Task);
-    }
+    Scheduler.WaitForCounter(Counter);
 }
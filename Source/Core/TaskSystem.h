@@ -7,20 +7,58 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
-#include <queue>
+#include <deque>
+#include <chrono>
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 // Forward declarations
 class FTaskScheduler;
 
+/**
+ * Scheduling class of a task. Workers always prefer High over Normal over Background.
+ */
+enum class ETaskPriority : uint8_t
+{
+    High,       // Frame-critical work the current frame is waiting on
+    Normal,
+    Background, // Streaming and reload work; never occupies every worker at once
+    IO          // Blocking file I/O; runs only on the dedicated I/O threads
+};
+
+constexpr uint32_t TaskPriorityCount = 4;
+
+/**
+ * Lightweight completion counter for tasks launched with FTaskScheduler::Spawn.
+ * Raised when a task is spawned and lowered when it finishes; it is done at zero.
+ */
+class FTaskCounter
+{
+public:
+    bool IsDone() const { return Count.load(std::memory_order_acquire) == 0; }
+    uint32_t GetCount() const { return Count.load(std::memory_order_acquire); }
+
+private:
+    friend class FTaskScheduler;
+
+    std::atomic<uint32_t> Count{ 0 };
+};
+
 /**
  * A task represents a unit of work that can be executed asynchronously.
- * Tasks can have dependencies on other tasks.
+ * Tasks can have prerequisites; a task is only queued once all of them have completed.
  */
 class FTask
 {
 public:
     using FTaskFunction = std::function<void()>;
 
+    // Bytes available for a lambda captured in place by FTaskScheduler::Spawn
+    static constexpr size_t InlineStorageSize = 64;
+
     FTask() = default;
     explicit FTask(FTaskFunction InFunction);
 
@@ -28,58 +66,182 @@ public:
     bool IsComplete() const { return bCompleted.load(std::memory_order_acquire); }
     void Wait() const;
 
+    /** Block for at most Timeout. @return true if the task completed. */
+    bool WaitFor(std::chrono::microseconds Timeout) const;
+
 private:
     friend class FTaskScheduler;
-    
+
+    /**
+     * Register Dependent to be released when this task completes.
+     * @return false if this task has already completed
+     */
+    bool AddDependent(const std::shared_ptr<FTask>& Dependent);
+    std::vector<std::shared_ptr<FTask>> TakeDependents();
+
+    using FInlineInvokeFunction = void(*)(void* Storage, bool bInvoke);
+
     FTaskFunction Function;
+    // Keeps the task alive while it sits in a scheduler queue
+    std::shared_ptr<FTask> SelfRef;
+    // Tasks waiting on this one, guarded by the task's wait slot
+    std::vector<std::shared_ptr<FTask>> Dependents;
+    // Unfinished prerequisites plus one guard reference held while the task is being set up
+    std::atomic<uint32_t> PendingPrerequisiteCount{ 0 };
     std::atomic<bool> bCompleted{ false };
-    mutable std::mutex CompletionMutex;
-    mutable std::condition_variable CompletionCV;
+    ETaskPriority Priority = ETaskPriority::Normal;
+
+    // Pooled tasks only: the lambda lives in InlineStorage; InlineInvoke optionally runs it, then destroys it
+    FInlineInvokeFunction InlineInvoke = nullptr;
+    FTaskCounter* Counter = nullptr;
+    bool bPooled = false;
+    alignas(std::max_align_t) unsigned char InlineStorage[InlineStorageSize];
 };
 
 using FTaskRef = std::shared_ptr<FTask>;
 
+/**
+ * Fixed-capacity Chase-Lev deque. The owning worker pushes and pops at the bottom,
+ * other workers steal from the top without taking a lock.
+ */
+class FWorkStealingQueue
+{
+public:
+    static constexpr int64_t Capacity = 4096;
+
+    /** Owner only. Returns false when the queue is full. */
+    bool Push(FTask* Task);
+
+    /** Owner only. Returns the most recently pushed task or nullptr. */
+    FTask* Pop();
+
+    /** Any thread. Returns the oldest task or nullptr if empty or the race was lost. */
+    FTask* Steal();
+
+    bool IsEmpty() const;
+
+private:
+    static constexpr int64_t IndexMask = Capacity - 1;
+    static_assert((Capacity & IndexMask) == 0, "Capacity must be a power of two");
+
+    alignas(64) std::atomic<int64_t> Top{ 0 };
+    alignas(64) std::atomic<int64_t> Bottom{ 0 };
+    std::atomic<FTask*> Buffer[Capacity];
+};
+
 /**
  * Task scheduler manages a pool of worker threads and distributes tasks among them.
- * Supports task dependencies and parallel execution.
+ * Each worker owns a work-stealing deque per priority; tasks scheduled from outside the
+ * pool go through shared injection queues that workers drain in chunks.
+ * A separate small set of I/O threads serves ETaskPriority::IO tasks so blocking reads
+ * never hold a worker.
  */
 class FTaskScheduler
 {
 public:
     static FTaskScheduler& Get();
 
-    void Initialize(uint32_t NumThreads = 0);
+    /**
+     * @param NumThreads Hardware threads to use for workers; one is left for the main thread. 0 = all.
+     * @param NumIOThreads Threads reserved for ETaskPriority::IO tasks. 0 runs I/O tasks as Background.
+     */
+    void Initialize(uint32_t NumThreads = 0, uint32_t NumIOThreads = 2);
     void Shutdown();
 
     /**
      * Schedule a task for asynchronous execution.
      * @param Function The function to execute
+     * @param Priority Scheduling class of the task
+     * @return Shared pointer to the task for tracking completion
+     */
+    FTaskRef ScheduleTask(FTask::FTaskFunction Function, ETaskPriority Priority = ETaskPriority::Normal);
+
+    /**
+     * Schedule a task that starts once every prerequisite has completed.
+     * No thread blocks while the prerequisites are outstanding.
+     * @param Function The function to execute
+     * @param Prerequisites Tasks that must complete first (null entries are ignored)
+     * @param Priority Scheduling class of the task
      * @return Shared pointer to the task for tracking completion
      */
-    FTaskRef ScheduleTask(FTask::FTaskFunction Function);
+    FTaskRef ScheduleTask(FTask::FTaskFunction Function, const std::vector<FTaskRef>& Prerequisites, ETaskPriority Priority = ETaskPriority::Normal);
 
     /**
      * Schedule multiple tasks for parallel execution.
      * @param Functions Array of functions to execute
+     * @param Priority Scheduling class of every task in the batch
      * @return Vector of task references
      */
-    std::vector<FTaskRef> ScheduleTaskBatch(const std::vector<FTask::FTaskFunction>& Functions);
+    std::vector<FTaskRef> ScheduleTaskBatch(const std::vector<FTask::FTaskFunction>& Functions, ETaskPriority Priority = ETaskPriority::Normal);
+
+    /**
+     * Schedule multiple tasks that all share the same prerequisites.
+     * @param Functions Array of functions to execute
+     * @param Prerequisites Tasks that must complete before any of the batch runs
+     * @param Priority Scheduling class of every task in the batch
+     * @return Vector of task references
+     */
+    std::vector<FTaskRef> ScheduleTaskBatch(const std::vector<FTask::FTaskFunction>& Functions, const std::vector<FTaskRef>& Prerequisites, ETaskPriority Priority = ETaskPriority::Normal);
+
+    /**
+     * Schedule an empty task that completes once all Tasks have completed.
+     * Useful to wait on, or depend on, a whole batch through a single reference.
+     */
+    FTaskRef ScheduleJoin(const std::vector<FTaskRef>& Tasks);
 
     /**
      * Wait for all scheduled tasks to complete.
+     * The calling thread executes queued tasks while it waits.
      */
     void WaitForAll();
 
     /**
      * Wait for a specific task to complete.
+     * The calling thread executes queued tasks while it waits, so a task may safely
+     * wait on work it scheduled even when every worker is busy. Background tasks are
+     * only picked up by waiters that are themselves running background work, and I/O
+     * tasks are never run by waiters.
      */
     void WaitForTask(const FTaskRef& Task);
 
+    /**
+     * Launch a fire-and-forget task tracked only by Counter. The task object comes from
+     * a recycled pool and the lambda is stored inline, so spawning does not touch the heap.
+     * Intended for per-frame fan-out; use ScheduleTask when a task handle or prerequisites are needed.
+     * @param Counter Counter raised now and lowered once the task has run; must outlive the task
+     * @param Function Callable of at most FTask::InlineStorageSize bytes
+     * @param Priority Scheduling class of the task
+     */
+    template <typename FunctionType>
+    void Spawn(FTaskCounter& Counter, FunctionType&& Function, ETaskPriority Priority = ETaskPriority::Normal);
+
+    /**
+     * Wait until Counter reaches zero, executing queued tasks meanwhile.
+     */
+    void WaitForCounter(const FTaskCounter& Counter);
+
+    /**
+     * Run a single queued task on the calling thread if one is available.
+     * @return true if a task was executed
+     */
+    bool TryExecuteOneTask();
+
     /**
      * Get the number of worker threads.
      */
     uint32_t GetWorkerThreadCount() const { return static_cast<uint32_t>(WorkerThreads.size()); }
 
+    /**
+     * Get the number of threads reserved for I/O tasks.
+     */
+    uint32_t GetIOThreadCount() const { return static_cast<uint32_t>(IOThreads.size()); }
+
+    /**
+     * Priority of the task running on the calling thread, Normal outside of tasks.
+     * Work that fans out from a task can use this to inherit its scheduling class.
+     */
+    static ETaskPriority GetCurrentTaskPriority();
+
     /**
      * Check if the scheduler is running.
      */
@@ -93,19 +255,97 @@ private:
     FTaskScheduler(const FTaskScheduler&) = delete;
     FTaskScheduler& operator=(const FTaskScheduler&) = delete;
 
-    void WorkerThreadFunction();
-    FTaskRef GetNextTask();
+    // High, Normal and Background live in the worker deques; IO has its own queue
+    static constexpr uint32_t WorkerPriorityCount = 3;
+
+    struct FWorkerQueues
+    {
+        FWorkStealingQueue Queues[WorkerPriorityCount];
+    };
+
+    void WorkerThreadFunction(uint32_t WorkerIndex);
+    void IOThreadFunction();
+    FTask* FindTask(uint32_t WorkerIndex, bool bClaimBackgroundSlot);
+    FTask* FindTaskWithPriority(uint32_t WorkerIndex, uint32_t PriorityIndex);
+    FTask* TakeFromGlobalQueue(uint32_t WorkerIndex, uint32_t PriorityIndex);
+    bool HasRunnableWork() const;
+    void ReleaseBackgroundSlot();
+    void RunTask(FTask* Task);
+    uint32_t GetTotalPendingTaskCount() const;
+    bool AddPrerequisites(const FTaskRef& Task, const std::vector<FTaskRef>& Prerequisites);
+    void ReleasePrerequisite(const FTaskRef& Task);
     void EnqueueTask(FTaskRef Task);
+    void EnqueueTaskBatch(const std::vector<FTaskRef>& Tasks, ETaskPriority Priority);
+    void PushTask(FTask* Task);
+    void WakeWorkers(uint32_t Count);
+
+    FTask* AllocatePooledTask();
+    void FreePooledTask(FTask* Task);
+    void CompletePooledTask(FTask* Task);
+
+    friend struct FThreadTaskCache;
+    void RefillTaskCache(std::vector<FTask*>& Cache);
+    void FlushTaskCache(std::vector<FTask*>& Cache, size_t KeepCount);
 
 private:
     std::vector<std::thread> WorkerThreads;
-    std::queue<FTaskRef> TaskQueue;
-    std::mutex QueueMutex;
-    std::condition_variable QueueCV;
+    std::vector<std::unique_ptr<FWorkerQueues>> WorkerQueues;
+    std::deque<FTask*> GlobalQueues[WorkerPriorityCount];
+    std::mutex GlobalQueueMutex;
+    std::mutex SleepMutex;
+    std::condition_variable SleepCV;
     std::atomic<bool> bIsRunning{ false };
+    std::atomic<uint32_t> PendingTaskCounts[TaskPriorityCount] = {};
     std::atomic<uint32_t> ActiveTaskCount{ 0 };
+    std::atomic<uint32_t> SleepingWorkerCount{ 0 };
+
+    // Background tasks may occupy at most this many workers so frame work always has one free
+    std::atomic<uint32_t> ActiveBackgroundTaskCount{ 0 };
+    uint32_t MaxBackgroundTaskCount = 1;
+
+    std::vector<std::thread> IOThreads;
+    std::deque<FTask*> IOQueue;
+    std::mutex IOQueueMutex;
+    std::condition_variable IOQueueCV;
+
+    // Backing store for pooled tasks; slabs are only released with the scheduler
+    std::mutex TaskPoolMutex;
+    std::vector<std::unique_ptr<FTask[]>> TaskPoolSlabs;
+    std::vector<FTask*> FreePooledTasks;
 };
 
+template <typename FunctionType>
+void FTaskScheduler::Spawn(FTaskCounter& Counter, FunctionType&& Function, ETaskPriority Priority)
+{
+    using FStoredType = std::decay_t<FunctionType>;
+    static_assert(sizeof(FStoredType) <= FTask::InlineStorageSize, "Spawned task captures too much state, use ScheduleTask instead");
+    static_assert(alignof(FStoredType) <= alignof(std::max_align_t), "Spawned task capture is over-aligned");
+
+    Counter.Count.fetch_add(1, std::memory_order_acq_rel);
+
+    if (!IsRunning())
+    {
+        Function();
+        Counter.Count.fetch_sub(1, std::memory_order_acq_rel);
+        return;
+    }
+
+    FTask* Task = AllocatePooledTask();
+    new (Task->InlineStorage) FStoredType(std::forward<FunctionType>(Function));
+    Task->InlineInvoke = [](void* Storage, bool bInvoke)
+    {
+        FStoredType* Stored = static_cast<FStoredType*>(Storage);
+        if (bInvoke)
+        {
+            (*Stored)();
+        }
+        Stored->~FStoredType();
+    };
+    Task->Counter = &Counter;
+    Task->Priority = Priority;
+    PushTask(Task);
+}
+
 /**
  * Helper class for parallel for loops.
  */
@@ -128,4 +368,105 @@ public:
      * @param Function Function to execute for each index
      */
     static void ExecuteBatched(uint32_t Start, uint32_t End, uint32_t BatchSize, std::function<void(uint32_t)> Function);
+
+    /**
+     * Execute a range functor in parallel. Function is called as Function(Begin, End) on
+     * [Begin, End) chunks, so the per-index loop can be inlined and vectorized.
+     * The first chunk is timed on the calling thread: ranges too cheap to be worth splitting
+     * finish inline, otherwise chunks are claimed dynamically with a size that follows the
+     * measured per-item cost and shrinks as the range drains.
+     * @param Start Starting index (inclusive)
+     * @param End Ending index (exclusive)
+     * @param Function Callable taking (uint32_t Begin, uint32_t End)
+     * @param MinChunkSize Smallest chunk handed to Function
+     */
+    template <typename RangeFunctionType>
+    static void ExecuteRange(uint32_t Start, uint32_t End, RangeFunctionType&& Function, uint32_t MinChunkSize = 64);
+
+private:
+    // Below this estimated total cost a range runs on the calling thread
+    static constexpr int64_t SerialThresholdNs = 20000;
+    // Chunks are sized to at least this much work to amortize claiming and stealing
+    static constexpr int64_t TargetChunkNs = 10000;
 };
+
+template <typename RangeFunctionType>
+void FParallelFor::ExecuteRange(uint32_t Start, uint32_t End, RangeFunctionType&& Function, uint32_t MinChunkSize)
+{
+    if (Start >= End)
+    {
+        return;
+    }
+
+    MinChunkSize = (std::max)(1u, MinChunkSize);
+
+    FTaskScheduler& Scheduler = FTaskScheduler::Get();
+    const uint32_t WorkerCount = Scheduler.IsRunning() ? Scheduler.GetWorkerThreadCount() : 0u;
+    if (WorkerCount == 0 || End - Start <= MinChunkSize)
+    {
+        Function(Start, End);
+        return;
+    }
+
+    // Time a probe chunk to estimate the cost of the rest of the range
+    const uint32_t ProbeEnd = Start + MinChunkSize;
+    const auto ProbeStartTime = std::chrono::steady_clock::now();
+    Function(Start, ProbeEnd);
+    const int64_t ProbeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - ProbeStartTime).count();
+
+    const uint32_t Remaining = End - ProbeEnd;
+    const double CostPerItemNs = static_cast<double>(ProbeNs) / static_cast<double>(MinChunkSize);
+    if (CostPerItemNs * static_cast<double>(Remaining) < static_cast<double>(SerialThresholdNs))
+    {
+        Function(ProbeEnd, End);
+        return;
+    }
+
+    const double CostChunkSize = static_cast<double>(TargetChunkNs) / (std::max)(CostPerItemNs, 1.0);
+    const uint32_t ChunkFloor = static_cast<uint32_t>((std::min)(static_cast<double>(Remaining), (std::max)(static_cast<double>(MinChunkSize), CostChunkSize)));
+
+    struct FRangeState
+    {
+        std::atomic<uint32_t> Next{ 0 };
+        uint32_t End = 0;
+        uint32_t ChunkFloor = 1;
+        uint32_t Divisor = 1;
+    };
+
+    FRangeState State;
+    State.Next.store(ProbeEnd, std::memory_order_relaxed);
+    State.End = End;
+    State.ChunkFloor = ChunkFloor;
+    State.Divisor = (WorkerCount + 1) * 2;
+
+    // Guided self-scheduling: each claim takes a share of what is left, never less than the floor
+    auto RunChunks = [&State, &Function]()
+    {
+        uint32_t Begin = State.Next.load(std::memory_order_relaxed);
+        while (Begin < State.End)
+        {
+            const uint32_t Left = State.End - Begin;
+            const uint32_t Size = (std::min)(Left, (std::max)(State.ChunkFloor, Left / State.Divisor));
+            if (State.Next.compare_exchange_weak(Begin, Begin + Size, std::memory_order_relaxed))
+            {
+                Function(Begin, Begin + Size);
+                Begin = State.Next.load(std::memory_order_relaxed);
+            }
+        }
+    };
+
+    const uint32_t ChunkCount = (Remaining + ChunkFloor - 1) / ChunkFloor;
+    const uint32_t HelperCount = (std::min)(WorkerCount, ChunkCount - 1);
+
+    // The caller is blocked on this loop, so it is frame-critical unless it runs on behalf of background work
+    const ETaskPriority Priority = FTaskScheduler::GetCurrentTaskPriority() == ETaskPriority::Background ? ETaskPriority::Background : ETaskPriority::High;
+
+    FTaskCounter Counter;
+    for (uint32_t HelperIndex = 0; HelperIndex < HelperCount; ++HelperIndex)
+    {
+        Scheduler.Spawn(Counter, [&RunChunks]() { RunChunks(); }, Priority);
+    }
+
+    RunChunks();
+    Scheduler.WaitForCounter(Counter);
+}
@@ -1,9 +1,12 @@
 #include <Windows.h>
 #include "Core/Application.h"
 #include "Core/Logger.h"
+#include "Core/OffscreenBatch.h"
+#include "Core/RendererConfig.h"
 
 #include <filesystem>
 #include <string>
+#include <vector>
 #include <cwchar>
 
 namespace
@@ -75,15 +78,38 @@ namespace
     }
 }
 
-int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE, _In_ LPWSTR, _In_ int)
+int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE, _In_ LPWSTR lpCmdLine, _In_ int)
 {
     EnsureWorkingDirectory();
 
-    FApplication App;
-    if (!App.Initialize(hInstance))
+    const std::wstring CommandLine = lpCmdLine ? std::wstring(lpCmdLine) : std::wstring();
+    FRendererConfig Config = FRendererConfigLoader::LoadOrDefault(std::filesystem::current_path() / "bin/RendererConfig.ini");
+    if (!CommandLine.empty())
     {
-        return -1;
+        FRendererConfigLoader::ApplyCommandLine(CommandLine, Config);
     }
 
-    return App.Run();
+    int ExitCode = -1;
+    if (!Config.BatchJobs.empty())
+    {
+        // Renders the job list without a window and exits.
+        std::vector<FSceneRenderJobDesc> Jobs;
+        FOffscreenBatch Batch;
+        if (FSceneJsonLoader::LoadRenderJobs(Config.BatchJobs, Jobs) && Batch.Initialize(Config))
+        {
+            ExitCode = Batch.Run(Jobs);
+        }
+    }
+    else
+    {
+        FApplication App;
+        if (App.Initialize(hInstance, CommandLine))
+        {
+            ExitCode = App.Run();
+        }
+    }
+
+    // Writes out what the application logged while shutting down.
+    ShutdownLog();
+    return ExitCode;
 }
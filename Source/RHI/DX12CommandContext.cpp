@@ -6,6 +6,8 @@
 FDX12CommandContext::FDX12CommandContext()
     : Device(nullptr)
     , Queue(nullptr)
+    , AsyncComputeContext(nullptr)
+    , QueueType(EDX12QueueType::Direct)
     , FrameCount(0)
     , CurrentAllocatorIndex(0)
 {
@@ -15,11 +17,12 @@ FDX12CommandContext::~FDX12CommandContext()
 {
 }
 
-bool FDX12CommandContext::Initialize(FDX12Device* InDevice, FDX12CommandQueue* InQueue, uint32 InFrameCount)
+bool FDX12CommandContext::Initialize(FDX12Device* InDevice, FDX12CommandQueue* InQueue, uint32 InFrameCount, EDX12QueueType InQueueType)
 {
     Device = InDevice;
     Queue = InQueue;
     FrameCount = InFrameCount;
+    QueueType = InQueueType;
 
     if (FrameCount == 0)
     {
@@ -32,22 +35,47 @@ bool FDX12CommandContext::Initialize(FDX12Device* InDevice, FDX12CommandQueue* I
     CommandAllocators.resize(FrameCount);
     FrameFenceValues.assign(FrameCount, 0);
 
+    D3D12_COMMAND_LIST_TYPE ListType = D3D12_COMMAND_LIST_TYPE_DIRECT;
+    switch (QueueType)
+    {
+    case EDX12QueueType::Direct:  ListType = D3D12_COMMAND_LIST_TYPE_DIRECT;  break;
+    case EDX12QueueType::Compute: ListType = D3D12_COMMAND_LIST_TYPE_COMPUTE; break;
+    case EDX12QueueType::Copy:    ListType = D3D12_COMMAND_LIST_TYPE_COPY;    break;
+    }
+
     for (uint32 Index = 0; Index < FrameCount; ++Index)
     {
         HR_CHECK(Device->GetDevice()->CreateCommandAllocator(
-            D3D12_COMMAND_LIST_TYPE_DIRECT,
+            ListType,
             IID_PPV_ARGS(CommandAllocators[Index].GetAddressOf())));
     }
 
     HR_CHECK(Device->GetDevice()->CreateCommandList(
         0,
-        D3D12_COMMAND_LIST_TYPE_DIRECT,
+        ListType,
         CommandAllocators[0].Get(),
         nullptr,
         IID_PPV_ARGS(CommandList.GetAddressOf())));
 
     HR_CHECK(CommandList->Close());
 
+    // Copy lists never record graph barriers, so only direct and compute lists need the newer interface.
+    if (Device->SupportsEnhancedBarriers() && QueueType != EDX12QueueType::Copy)
+    {
+        if (FAILED(CommandList.As(&CommandList7)))
+        {
+            CommandList7.Reset();
+        }
+    }
+
+    if (Device->SupportsMeshShaders() && QueueType == EDX12QueueType::Direct)
+    {
+        if (FAILED(CommandList.As(&CommandList6)))
+        {
+            CommandList6.Reset();
+        }
+    }
+
     LogInfo("Command context initialization complete");
     return true;
 }
@@ -61,6 +89,7 @@ void FDX12CommandContext::BeginFrame(uint32 FrameIndex)
     }
 
     CurrentAllocatorIndex = FrameIndex % FrameCount;
+    ParallelContextsBegun.assign(ParallelContexts.size(), false);
 
     const uint64 FenceValue = FrameFenceValues[CurrentAllocatorIndex];
     if (FenceValue > 0 && Queue->GetCompletedFenceValue() < FenceValue)
@@ -100,6 +129,38 @@ void FDX12CommandContext::TransitionResources(const std::vector<D3D12_RESOURCE_B
     CommandList->ResourceBarrier(static_cast<UINT>(Barriers.size()), Barriers.data());
 }
 
+void FDX12CommandContext::EnhancedBarriers(const std::vector<D3D12_TEXTURE_BARRIER>& TextureBarriers, const std::vector<D3D12_BUFFER_BARRIER>& BufferBarriers)
+{
+    if (!CommandList7)
+    {
+        return;
+    }
+
+    D3D12_BARRIER_GROUP Groups[2] = {};
+    UINT32 GroupCount = 0;
+
+    if (!TextureBarriers.empty())
+    {
+        Groups[GroupCount].Type = D3D12_BARRIER_TYPE_TEXTURE;
+        Groups[GroupCount].NumBarriers = static_cast<UINT32>(TextureBarriers.size());
+        Groups[GroupCount].pTextureBarriers = TextureBarriers.data();
+        ++GroupCount;
+    }
+
+    if (!BufferBarriers.empty())
+    {
+        Groups[GroupCount].Type = D3D12_BARRIER_TYPE_BUFFER;
+        Groups[GroupCount].NumBarriers = static_cast<UINT32>(BufferBarriers.size());
+        Groups[GroupCount].pBufferBarriers = BufferBarriers.data();
+        ++GroupCount;
+    }
+
+    if (GroupCount > 0)
+    {
+        CommandList7->Barrier(GroupCount, Groups);
+    }
+}
+
 void FDX12CommandContext::SetRenderTarget(const D3D12_CPU_DESCRIPTOR_HANDLE& RtvHandle, const D3D12_CPU_DESCRIPTOR_HANDLE* DsvHandle)
 {
     CommandList->OMSetRenderTargets(1, &RtvHandle, FALSE, DsvHandle);
@@ -123,6 +184,73 @@ void FDX12CommandContext::CloseAndExecute()
     Queue->ExecuteCommandLists(1, Lists);
 }
 
+void FDX12CommandContext::ExecuteAndReset()
+{
+    CloseAndExecute();
+    ResetCommandList();
+}
+
+void FDX12CommandContext::ResetCommandList()
+{
+    // Reuses the current frame's allocator; only valid once the list has been closed.
+    HR_CHECK(CommandList->Reset(CommandAllocators[CurrentAllocatorIndex].Get(), nullptr));
+}
+
+FDX12CommandContext* FDX12CommandContext::BeginParallelContext(uint32 Index)
+{
+    while (ParallelContexts.size() <= Index)
+    {
+        std::unique_ptr<FDX12CommandContext> Context = std::make_unique<FDX12CommandContext>();
+        if (!Context->Initialize(Device, Queue, FrameCount, QueueType))
+        {
+            LogError("Failed to initialize parallel command context");
+            return nullptr;
+        }
+
+        ParallelContexts.push_back(std::move(Context));
+        ParallelContextsBegun.push_back(false);
+    }
+
+    FDX12CommandContext* Context = ParallelContexts[Index].get();
+    if (!ParallelContextsBegun[Index])
+    {
+        // Waits on the fence of the last submission that used this frame's allocator.
+        Context->BeginFrame(CurrentAllocatorIndex);
+        ParallelContextsBegun[Index] = true;
+    }
+    else
+    {
+        Context->ResetCommandList();
+    }
+
+    return Context;
+}
+
+void FDX12CommandContext::ExecuteWithParallelContexts(const std::vector<FDX12CommandContext*>& Contexts)
+{
+    std::vector<ID3D12CommandList*> Lists;
+    Lists.reserve(Contexts.size() + 1);
+
+    HR_CHECK(CommandList->Close());
+    Lists.push_back(CommandList.Get());
+
+    for (FDX12CommandContext* Context : Contexts)
+    {
+        HR_CHECK(Context->CommandList->Close());
+        Lists.push_back(Context->CommandList.Get());
+    }
+
+    Queue->ExecuteCommandLists(static_cast<uint32>(Lists.size()), Lists.data());
+
+    const uint64 FenceValue = Queue->Signal();
+    for (FDX12CommandContext* Context : Contexts)
+    {
+        Context->SetFrameFenceValue(CurrentAllocatorIndex, FenceValue);
+    }
+
+    ResetCommandList();
+}
+
 void FDX12CommandContext::SetFrameFenceValue(uint32 FrameIndex, uint64 FenceValue)
 {
     if (FrameIndex < FrameFenceValues.size())
@@ -131,6 +259,16 @@ void FDX12CommandContext::SetFrameFenceValue(uint32 FrameIndex, uint64 FenceValu
     }
 }
 
+FDX12UploadRing* FDX12CommandContext::GetUploadRing() const
+{
+    return Device ? Device->GetUploadRing() : nullptr;
+}
+
+FDX12DescriptorAllocator* FDX12CommandContext::GetDescriptorAllocator() const
+{
+    return Device ? Device->GetDescriptorAllocator() : nullptr;
+}
+
 uint64 FDX12CommandContext::GetFrameFenceValue(uint32 FrameIndex) const
 {
     if (FrameIndex < FrameFenceValues.size())
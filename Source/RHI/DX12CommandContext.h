@@ -1,11 +1,14 @@
 #pragma once
 
 #include "DX12Commons.h"
+#include "DX12CommandQueue.h"
+#include <memory>
 #include <vector>
 
 class FDX12Device;
 class FDX12SwapChain;
-class FDX12CommandQueue;
+class FDX12UploadRing;
+class FDX12DescriptorAllocator;
 
 class FDX12CommandContext
 {
@@ -13,31 +16,59 @@ public:
     FDX12CommandContext();
     ~FDX12CommandContext();
 
-    bool Initialize(FDX12Device* InDevice, FDX12CommandQueue* InQueue, uint32 InFrameCount);
+    bool Initialize(FDX12Device* InDevice, FDX12CommandQueue* InQueue, uint32 InFrameCount, EDX12QueueType InQueueType = EDX12QueueType::Direct);
 
     void BeginFrame(uint32 FrameIndex);
     void TransitionResource(ID3D12Resource* Resource, D3D12_RESOURCE_STATES Before, D3D12_RESOURCE_STATES After);
     void TransitionResources(const std::vector<D3D12_RESOURCE_BARRIER>& Barriers);
+    // Records both arrays in one ID3D12GraphicsCommandList7::Barrier call. Only valid when
+    // SupportsEnhancedBarriers() is true.
+    void EnhancedBarriers(const std::vector<D3D12_TEXTURE_BARRIER>& TextureBarriers, const std::vector<D3D12_BUFFER_BARRIER>& BufferBarriers);
     void SetRenderTarget(const D3D12_CPU_DESCRIPTOR_HANDLE& RtvHandle, const D3D12_CPU_DESCRIPTOR_HANDLE* DsvHandle = nullptr);
     void ClearRenderTarget(const D3D12_CPU_DESCRIPTOR_HANDLE& RtvHandle, const FLOAT Color[4]);
     void ClearDepth(const D3D12_CPU_DESCRIPTOR_HANDLE& DsvHandle, float Depth = 0.0f, uint8 Stencil = 0);
 
     void CloseAndExecute();
+    void ExecuteAndReset();
+    void ResetCommandList();
+
+    // Secondary lists on the same queue, each with its own per-frame allocators, so several
+    // threads can record at once. Opens the list for the current frame; returns null on failure.
+    FDX12CommandContext* BeginParallelContext(uint32 Index);
+    // Closes this list and Contexts, submits them in one call with this list first, then reopens this list.
+    void ExecuteWithParallelContexts(const std::vector<FDX12CommandContext*>& Contexts);
 
     void SetFrameFenceValue(uint32 FrameIndex, uint64 FenceValue);
     uint64 GetFrameFenceValue(uint32 FrameIndex) const;
 
     FDX12CommandQueue* GetQueue() const { return Queue; }
+    EDX12QueueType GetQueueType() const { return QueueType; }
+
+    void SetAsyncComputeContext(FDX12CommandContext* InContext) { AsyncComputeContext = InContext; }
+    FDX12CommandContext* GetAsyncComputeContext() const { return AsyncComputeContext; }
     uint32 GetCurrentFrameIndex() const { return CurrentAllocatorIndex; }
+    // The device's shared upload ring; allocations stay valid until this frame's fence completes.
+    FDX12UploadRing* GetUploadRing() const;
+    // The device's shared descriptor allocator; transient tables stay valid until this frame's fence completes.
+    FDX12DescriptorAllocator* GetDescriptorAllocator() const;
 
     ID3D12GraphicsCommandList* GetCommandList() const { return CommandList.Get(); }
+    bool SupportsEnhancedBarriers() const { return CommandList7 != nullptr; }
+    // Null unless the device supports mesh shaders; records DispatchMesh.
+    ID3D12GraphicsCommandList6* GetCommandList6() const { return CommandList6.Get(); }
 
 private:
     FDX12Device*             Device;
     FDX12CommandQueue*       Queue;
+    FDX12CommandContext*     AsyncComputeContext;
+    EDX12QueueType           QueueType;
     std::vector<ComPtr<ID3D12CommandAllocator>> CommandAllocators;
     std::vector<uint64>               FrameFenceValues;
     uint32                            FrameCount;
     uint32                            CurrentAllocatorIndex;
     ComPtr<ID3D12GraphicsCommandList> CommandList;
+    ComPtr<ID3D12GraphicsCommandList6> CommandList6;
+    ComPtr<ID3D12GraphicsCommandList7> CommandList7;
+    std::vector<std::unique_ptr<FDX12CommandContext>> ParallelContexts;
+    std::vector<bool>                 ParallelContextsBegun;
 };
@@ -58,6 +58,11 @@ void FDX12CommandQueue::Wait(uint64 FenceValue)
     }
 }
 
+void FDX12CommandQueue::GpuWait(const FDX12CommandQueue& OtherQueue, uint64 FenceValue)
+{
+    HR_CHECK(D3DCommandQueue->Wait(OtherQueue.Fence.Get(), FenceValue));
+}
+
 void FDX12CommandQueue::Flush()
 {
     uint64 FenceValueToWait = 0;
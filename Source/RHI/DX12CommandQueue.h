@@ -23,6 +23,7 @@ public:
     void ExecuteCommandLists(uint32 NumCommandLists, ID3D12CommandList* const* CommandLists);
     uint64 Signal();
     void Wait(uint64 FenceValue);
+    void GpuWait(const FDX12CommandQueue& OtherQueue, uint64 FenceValue);
     void Flush();
 
 private:
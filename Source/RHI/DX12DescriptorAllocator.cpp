@@ -0,0 +1,339 @@
+#include "DX12DescriptorAllocator.h"
+#include "DX12CommandQueue.h"
+#include "../Core/Logger.h"
+#include <algorithm>
+#include <string>
+
+void FDX12DescriptorAllocator::FFreeList::Reset(uint32 Offset, uint32 Count)
+{
+    Blocks.clear();
+    if (Count > 0)
+    {
+        Blocks.push_back({ Offset, Count });
+    }
+    FreeCount = Count;
+}
+
+bool FDX12DescriptorAllocator::FFreeList::Allocate(uint32 Count, uint32& OutOffset)
+{
+    for (size_t BlockIndex = 0; BlockIndex < Blocks.size(); ++BlockIndex)
+    {
+        FFreeBlock& Block = Blocks[BlockIndex];
+        if (Block.Count < Count)
+        {
+            continue;
+        }
+
+        OutOffset = Block.Offset;
+        Block.Offset += Count;
+        Block.Count -= Count;
+        if (Block.Count == 0)
+        {
+            Blocks.erase(Blocks.begin() + BlockIndex);
+        }
+        FreeCount -= Count;
+        return true;
+    }
+
+    return false;
+}
+
+void FDX12DescriptorAllocator::FFreeList::Free(uint32 Offset, uint32 Count)
+{
+    auto It = std::lower_bound(Blocks.begin(), Blocks.end(), Offset,
+        [](const FFreeBlock& Block, uint32 Value) { return Block.Offset < Value; });
+
+    It = Blocks.insert(It, { Offset, Count });
+    FreeCount += Count;
+
+    auto Next = It + 1;
+    if (Next != Blocks.end() && It->Offset + It->Count == Next->Offset)
+    {
+        It->Count += Next->Count;
+        Blocks.erase(Next);
+    }
+
+    if (It != Blocks.begin())
+    {
+        auto Prev = It - 1;
+        if (Prev->Offset + Prev->Count == It->Offset)
+        {
+            Prev->Count += It->Count;
+            Blocks.erase(It);
+        }
+    }
+}
+
+bool FDX12DescriptorAllocator::Initialize(
+    ID3D12Device* InDevice,
+    FDX12CommandQueue* InFenceQueue,
+    uint32 PersistentCount,
+    uint32 TransientCount,
+    uint32 StagingCount)
+{
+    Device = InDevice;
+    FenceQueue = InFenceQueue;
+    if (!Device || !FenceQueue)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    D3D12_DESCRIPTOR_HEAP_DESC HeapDesc = {};
+    HeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    HeapDesc.NumDescriptors = PersistentCount + TransientCount;
+    HeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    if (!ShaderVisibleHeap.Initialize(Device, HeapDesc) || !ShaderVisibleHeap.GetHeap())
+    {
+        LogError("Failed to create shader-visible descriptor heap (" + std::to_string(HeapDesc.NumDescriptors) + " descriptors)");
+        return false;
+    }
+    ShaderVisibleHeap.GetHeap()->SetName(L"SharedDescriptorHeap");
+
+    HeapDesc.NumDescriptors = StagingCount;
+    HeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+    if (!StagingHeap.Initialize(Device, HeapDesc) || !StagingHeap.GetHeap())
+    {
+        LogError("Failed to create staging descriptor heap (" + std::to_string(StagingCount) + " descriptors)");
+        return false;
+    }
+    StagingHeap.GetHeap()->SetName(L"StagingDescriptorHeap");
+
+    DescriptorSize = ShaderVisibleHeap.GetDescriptorSize();
+
+    PersistentFreeList.Reset(0, PersistentCount);
+    StagingFreeList.Reset(0, StagingCount);
+    UnfencedFrees.clear();
+    PendingFrees.clear();
+
+    TransientBase = PersistentCount;
+    TransientCapacity = TransientCount;
+    TransientHead = 0;
+    TransientTail = 0;
+    TransientMarkers.clear();
+    return true;
+}
+
+FDX12DescriptorRange FDX12DescriptorAllocator::MakeShaderVisibleRange(uint32 Offset, uint32 Count) const
+{
+    FDX12DescriptorRange Range;
+    ID3D12DescriptorHeap* Heap = ShaderVisibleHeap.GetHeap();
+    Range.CpuStart.ptr = Heap->GetCPUDescriptorHandleForHeapStart().ptr + static_cast<SIZE_T>(Offset) * DescriptorSize;
+    Range.GpuStart.ptr = Heap->GetGPUDescriptorHandleForHeapStart().ptr + static_cast<UINT64>(Offset) * DescriptorSize;
+    Range.Offset = Offset;
+    Range.Count = Count;
+    Range.DescriptorSize = DescriptorSize;
+    return Range;
+}
+
+FDX12DescriptorRange FDX12DescriptorAllocator::AllocatePersistent(uint32 Count)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (!ShaderVisibleHeap.GetHeap() || Count == 0)
+    {
+        return {};
+    }
+
+    uint32 Offset = 0;
+    bool bAllocated = PersistentFreeList.Allocate(Count, Offset);
+    if (!bAllocated)
+    {
+        Reclaim(FenceQueue->GetCompletedFenceValue());
+        bAllocated = PersistentFreeList.Allocate(Count, Offset);
+    }
+
+    if (!bAllocated)
+    {
+        LogError("Persistent descriptor region exhausted: requested " + std::to_string(Count)
+            + ", free " + std::to_string(PersistentFreeList.FreeCount));
+        return {};
+    }
+
+    return MakeShaderVisibleRange(Offset, Count);
+}
+
+void FDX12DescriptorAllocator::FreePersistent(const FDX12DescriptorRange& Range)
+{
+    if (!Range.IsValid())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    UnfencedFrees.push_back({ Range.Offset, Range.Count });
+}
+
+FDX12DescriptorRange FDX12DescriptorAllocator::AllocateStaging(uint32 Count)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (!StagingHeap.GetHeap() || Count == 0)
+    {
+        return {};
+    }
+
+    uint32 Offset = 0;
+    if (!StagingFreeList.Allocate(Count, Offset))
+    {
+        LogError("Staging descriptor heap exhausted: requested " + std::to_string(Count)
+            + ", free " + std::to_string(StagingFreeList.FreeCount));
+        return {};
+    }
+
+    FDX12DescriptorRange Range;
+    Range.CpuStart.ptr = StagingHeap.GetHeap()->GetCPUDescriptorHandleForHeapStart().ptr + static_cast<SIZE_T>(Offset) * DescriptorSize;
+    Range.Offset = Offset;
+    Range.Count = Count;
+    Range.DescriptorSize = DescriptorSize;
+    return Range;
+}
+
+void FDX12DescriptorAllocator::FreeStaging(const FDX12DescriptorRange& Range)
+{
+    if (!Range.IsValid())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    StagingFreeList.Free(Range.Offset, Range.Count);
+}
+
+bool FDX12DescriptorAllocator::TryAllocateTransient(uint32 Count, uint32& OutOffset)
+{
+    if (Count > TransientCapacity)
+    {
+        return false;
+    }
+
+    uint64 Position = TransientHead;
+    uint32 PhysicalOffset = static_cast<uint32>(Position % TransientCapacity);
+    if (PhysicalOffset + Count > TransientCapacity)
+    {
+        // Descriptor tables must be contiguous, so skip the tail of the ring.
+        Position += TransientCapacity - PhysicalOffset;
+        PhysicalOffset = 0;
+    }
+
+    if (Position + Count - TransientTail > TransientCapacity)
+    {
+        return false;
+    }
+
+    TransientHead = Position + Count;
+    OutOffset = TransientBase + PhysicalOffset;
+    return true;
+}
+
+FDX12DescriptorRange FDX12DescriptorAllocator::AllocateTransient(uint32 Count)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (!ShaderVisibleHeap.GetHeap() || Count == 0)
+    {
+        return {};
+    }
+
+    uint32 Offset = 0;
+    bool bAllocated = TryAllocateTransient(Count, Offset);
+    if (!bAllocated)
+    {
+        Reclaim(FenceQueue->GetCompletedFenceValue());
+        bAllocated = TryAllocateTransient(Count, Offset);
+    }
+
+    // The shader-visible heap cannot be swapped mid-frame, so wait for the oldest frames instead of growing.
+    while (!bAllocated && !TransientMarkers.empty())
+    {
+        LogWarning("Transient descriptor ring full, waiting for frame fence " + std::to_string(TransientMarkers.front().FenceValue));
+        FenceQueue->Wait(TransientMarkers.front().FenceValue);
+        Reclaim(FenceQueue->GetCompletedFenceValue());
+        bAllocated = TryAllocateTransient(Count, Offset);
+    }
+
+    if (!bAllocated)
+    {
+        LogError("Transient descriptor ring too small for " + std::to_string(Count) + " descriptors in one frame");
+        return {};
+    }
+
+    return MakeShaderVisibleRange(Offset, Count);
+}
+
+FDX12DescriptorRange FDX12DescriptorAllocator::CopyToTransient(const D3D12_CPU_DESCRIPTOR_HANDLE* SourceHandles, uint32 Count)
+{
+    FDX12DescriptorRange Table = AllocateTransient(Count);
+    if (!Table.IsValid())
+    {
+        return Table;
+    }
+
+    std::vector<UINT> SourceRangeSizes(Count, 1);
+    const UINT DestinationRangeSize = Count;
+    Device->CopyDescriptors(
+        1, &Table.CpuStart, &DestinationRangeSize,
+        Count, SourceHandles, SourceRangeSizes.data(),
+        D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    return Table;
+}
+
+void FDX12DescriptorAllocator::CopyRange(const FDX12DescriptorRange& Destination, uint32 DestinationIndex, const FDX12DescriptorRange& Source)
+{
+    if (!Source.IsValid() || DestinationIndex + Source.Count > Destination.Count)
+    {
+        return;
+    }
+
+    Device->CopyDescriptorsSimple(
+        Source.Count,
+        Destination.GetCpuHandle(DestinationIndex),
+        Source.CpuStart,
+        D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+}
+
+void FDX12DescriptorAllocator::EndFrame(uint64 FenceValue)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    FFrameMarker Marker;
+    Marker.FenceValue = FenceValue;
+    Marker.EndPosition = TransientHead;
+    TransientMarkers.push_back(Marker);
+
+    for (const FFreeBlock& Block : UnfencedFrees)
+    {
+        PendingFrees.push_back({ Block.Offset, Block.Count, FenceValue });
+    }
+    UnfencedFrees.clear();
+
+    if (FenceQueue)
+    {
+        Reclaim(FenceQueue->GetCompletedFenceValue());
+    }
+}
+
+void FDX12DescriptorAllocator::Reclaim(uint64 CompletedFenceValue)
+{
+    while (!TransientMarkers.empty() && TransientMarkers.front().FenceValue <= CompletedFenceValue)
+    {
+        TransientTail = TransientMarkers.front().EndPosition;
+        TransientMarkers.pop_front();
+    }
+
+    while (!PendingFrees.empty() && PendingFrees.front().FenceValue <= CompletedFenceValue)
+    {
+        PersistentFreeList.Free(PendingFrees.front().Offset, PendingFrees.front().Count);
+        PendingFrees.pop_front();
+    }
+}
+
+uint32 FDX12DescriptorAllocator::GetPersistentFreeCount() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return PersistentFreeList.FreeCount;
+}
+
+uint32 FDX12DescriptorAllocator::GetTransientUsedCount() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return static_cast<uint32>(TransientHead - TransientTail);
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "DX12Commons.h"
+#include "DX12DescriptorHeap.h"
+#include <deque>
+#include <mutex>
+
+class FDX12CommandQueue;
+
+struct FDX12DescriptorRange
+{
+    D3D12_CPU_DESCRIPTOR_HANDLE CpuStart{};
+    // Zero for staging ranges, which are not shader visible.
+    D3D12_GPU_DESCRIPTOR_HANDLE GpuStart{};
+    uint32 Offset = 0;
+    uint32 Count = 0;
+    uint32 DescriptorSize = 0;
+
+    bool IsValid() const { return Count > 0; }
+
+    D3D12_CPU_DESCRIPTOR_HANDLE GetCpuHandle(uint32 Index) const
+    {
+        return { CpuStart.ptr + static_cast<SIZE_T>(Index) * DescriptorSize };
+    }
+
+    D3D12_GPU_DESCRIPTOR_HANDLE GetGpuHandle(uint32 Index) const
+    {
+        return { GpuStart.ptr + static_cast<UINT64>(Index) * DescriptorSize };
+    }
+};
+
+// CBV/SRV/UAV descriptor allocation on top of one shader-visible FDX12DescriptorHeap and one
+// CPU-only staging heap, so every renderer and pass shares a single bound heap.
+//  - Persistent region: free-list ranges for long-lived views. Frees wait until the frames that may
+//    still reference the range have retired, so textures can be streamed without a heap rebuild.
+//  - Transient region: a ring of per-frame tables, reclaimed by the fence passed to EndFrame.
+//  - Staging heap: free-list ranges whose views are gathered into the shader-visible heap with
+//    CopyDescriptors.
+// All methods are thread-safe.
+class FDX12DescriptorAllocator
+{
+public:
+    static constexpr uint32 DefaultPersistentCount = 16384;
+    static constexpr uint32 DefaultTransientCount = 8192;
+    static constexpr uint32 DefaultStagingCount = 4096;
+
+    FDX12DescriptorAllocator() = default;
+    FDX12DescriptorAllocator(const FDX12DescriptorAllocator&) = delete;
+    FDX12DescriptorAllocator& operator=(const FDX12DescriptorAllocator&) = delete;
+
+    bool Initialize(
+        ID3D12Device* InDevice,
+        FDX12CommandQueue* InFenceQueue,
+        uint32 PersistentCount = DefaultPersistentCount,
+        uint32 TransientCount = DefaultTransientCount,
+        uint32 StagingCount = DefaultStagingCount);
+
+    ID3D12DescriptorHeap* GetHeap() const { return ShaderVisibleHeap.GetHeap(); }
+    uint32 GetDescriptorSize() const { return DescriptorSize; }
+
+    FDX12DescriptorRange AllocatePersistent(uint32 Count);
+    void FreePersistent(const FDX12DescriptorRange& Range);
+
+    FDX12DescriptorRange AllocateStaging(uint32 Count);
+    // Staging descriptors are only read on the CPU timeline by CopyDescriptors, so they are reused immediately.
+    void FreeStaging(const FDX12DescriptorRange& Range);
+
+    // Contiguous table valid until the current frame retires.
+    FDX12DescriptorRange AllocateTransient(uint32 Count);
+    // Gathers one descriptor from each source handle (staging heap) into a new transient table.
+    FDX12DescriptorRange CopyToTransient(const D3D12_CPU_DESCRIPTOR_HANDLE* SourceHandles, uint32 Count);
+    // Copies a staging range into a shader-visible range starting at DestinationIndex.
+    void CopyRange(const FDX12DescriptorRange& Destination, uint32 DestinationIndex, const FDX12DescriptorRange& Source);
+
+    // Tags transient tables and pending frees since the previous call with the frame's fence.
+    void EndFrame(uint64 FenceValue);
+
+    uint32 GetPersistentFreeCount() const;
+    uint32 GetTransientUsedCount() const;
+
+private:
+    struct FFreeBlock
+    {
+        uint32 Offset = 0;
+        uint32 Count = 0;
+    };
+
+    // Address-ordered first-fit free list that merges neighbours on free.
+    struct FFreeList
+    {
+        std::vector<FFreeBlock> Blocks;
+        uint32 FreeCount = 0;
+
+        void Reset(uint32 Offset, uint32 Count);
+        bool Allocate(uint32 Count, uint32& OutOffset);
+        void Free(uint32 Offset, uint32 Count);
+    };
+
+    struct FPendingFree
+    {
+        uint32 Offset = 0;
+        uint32 Count = 0;
+        uint64 FenceValue = 0;
+    };
+
+    struct FFrameMarker
+    {
+        uint64 FenceValue = 0;
+        uint64 EndPosition = 0;
+    };
+
+    FDX12DescriptorRange MakeShaderVisibleRange(uint32 Offset, uint32 Count) const;
+    void Reclaim(uint64 CompletedFenceValue);
+    bool TryAllocateTransient(uint32 Count, uint32& OutOffset);
+
+    mutable std::mutex Mutex;
+    ID3D12Device*       Device = nullptr;
+    FDX12CommandQueue*  FenceQueue = nullptr;
+    FDX12DescriptorHeap ShaderVisibleHeap;
+    FDX12DescriptorHeap StagingHeap;
+    uint32              DescriptorSize = 0;
+
+    FFreeList PersistentFreeList;
+    FFreeList StagingFreeList;
+    // Frees recorded since the last EndFrame have no fence yet.
+    std::vector<FFreeBlock> UnfencedFrees;
+    std::deque<FPendingFree> PendingFrees;
+
+    // The transient region follows the persistent one; positions are monotonic, wrapped by TransientCapacity.
+    uint32 TransientBase = 0;
+    uint32 TransientCapacity = 0;
+    uint64 TransientHead = 0;
+    uint64 TransientTail = 0;
+    std::deque<FFrameMarker> TransientMarkers;
+};
@@ -57,21 +57,53 @@ FDX12Device::FDX12Device()
 
 FDX12Device::~FDX12Device()
 {
+    if (PipelineCache)
+    {
+        PipelineCache->Save();
+    }
+    if (UploadQueue)
+    {
+        UploadQueue->Flush();
+    }
     if (GraphicsQueue)
     {
         GraphicsQueue->Flush();
     }
 }
 
-bool FDX12Device::Initialize()
+bool FDX12Device::Initialize(bool bUseWarpAdapter)
 {
     LogInfo("DX12 device initialization started");
     if (!CreateFactory()) { LogError("Failed to create DXGI factory"); return false; }
-    if (!PickAdapter())   { LogError("No suitable adapter found"); return false; }
+    if (!PickAdapter(bUseWarpAdapter)) { LogError("No suitable adapter found"); return false; }
     if (!CreateDevice())  { LogError("Failed to create D3D12 device"); return false; }
     if (!DetermineShaderModel()) { LogError("Failed to determine shader model"); return false; }
+    CheckEnhancedBarrierSupport();
+    CheckBindlessSupport();
+    CheckMeshShaderSupport();
+    CheckVariableRateShadingSupport();
     if (!CreateCommandQueues()) { LogError("Failed to create command queues"); return false; }
 
+    UploadRing = std::make_unique<FDX12UploadRing>();
+    if (!UploadRing->Initialize(Device.Get(), GraphicsQueue.get())) { LogError("Failed to create upload ring"); return false; }
+
+    DescriptorAllocator = std::make_unique<FDX12DescriptorAllocator>();
+    if (!DescriptorAllocator->Initialize(Device.Get(), GraphicsQueue.get())) { LogError("Failed to create descriptor allocator"); return false; }
+
+    StaticResourceAllocator = std::make_unique<FDX12HeapAllocator>();
+    if (!StaticResourceAllocator->Initialize(Device.Get())) { LogError("Failed to create static resource allocator"); return false; }
+
+    // Without pipeline library support the cache forwards every call to the device.
+    PipelineCache = std::make_unique<FDX12PipelineCache>();
+    PipelineCache->Initialize(Device.Get(), Adapter.Get(), GetExecutableDirectory() / L"PipelineCache.bin");
+
+    // Optional; loaders fall back to mapped files without it.
+    DirectStorage = std::make_unique<FDX12DirectStorage>();
+    if (!DirectStorage->Initialize(Device.Get()))
+    {
+        DirectStorage.reset();
+    }
+
     LogInfo("DX12 device initialization complete");
     return true;
 }
@@ -95,8 +127,18 @@ bool FDX12Device::CreateFactory()
     return true;
 }
 
-bool FDX12Device::PickAdapter()
+bool FDX12Device::PickAdapter(bool bUseWarpAdapter)
 {
+    if (bUseWarpAdapter)
+    {
+        if (FAILED(Factory->EnumWarpAdapter(IID_PPV_ARGS(Adapter.GetAddressOf()))))
+        {
+            LogError("Could not create the WARP adapter");
+            return false;
+        }
+        return true;
+    }
+
     ComPtr<IDXGIAdapter1> TempAdapter;
     SIZE_T MaxVRAM = 0;
 
@@ -179,10 +221,78 @@ bool FDX12Device::DetermineShaderModel()
     return true;
 }
 
+void FDX12Device::CheckEnhancedBarrierSupport()
+{
+    D3D12_FEATURE_DATA_D3D12_OPTIONS12 Options12 = {};
+    bEnhancedBarriersSupported =
+        SUCCEEDED(Device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS12, &Options12, sizeof(Options12))) &&
+        Options12.EnhancedBarriersSupported;
+
+    LogInfo(std::string("Enhanced barriers: ") + (bEnhancedBarriersSupported ? "supported" : "not supported, using legacy resource barriers"));
+}
+
+void FDX12Device::CheckBindlessSupport()
+{
+    D3D12_FEATURE_DATA_D3D12_OPTIONS Options = {};
+    const bool bBindingTier3 =
+        SUCCEEDED(Device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &Options, sizeof(Options))) &&
+        Options.ResourceBindingTier >= D3D12_RESOURCE_BINDING_TIER_3;
+    bBindlessResourcesSupported = bBindingTier3 && ShaderModel >= D3D_SHADER_MODEL_6_6;
+
+    LogInfo(std::string("Bindless resources: ") + (bBindlessResourcesSupported ? "supported" : "not supported, using descriptor tables"));
+}
+
+void FDX12Device::CheckMeshShaderSupport()
+{
+    D3D12_FEATURE_DATA_D3D12_OPTIONS7 Options7 = {};
+    const bool bMeshShaderTier1 =
+        SUCCEEDED(Device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS7, &Options7, sizeof(Options7))) &&
+        Options7.MeshShaderTier >= D3D12_MESH_SHADER_TIER_1;
+    bMeshShadersSupported = bMeshShaderTier1 && ShaderModel >= D3D_SHADER_MODEL_6_5;
+
+    LogInfo(std::string("Mesh shaders: ") + (bMeshShadersSupported ? "supported" : "not supported, using the vertex shader path"));
+}
+
+void FDX12Device::CheckVariableRateShadingSupport()
+{
+    D3D12_FEATURE_DATA_D3D12_OPTIONS6 Options6 = {};
+    if (SUCCEEDED(Device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS6, &Options6, sizeof(Options6)))
+        && Options6.VariableShadingRateTier >= D3D12_VARIABLE_SHADING_RATE_TIER_2)
+    {
+        ShadingRateImageTileSize = Options6.ShadingRateImageTileSize;
+        bAdditionalShadingRatesSupported = Options6.AdditionalShadingRatesSupported != FALSE;
+    }
+
+    LogInfo(std::string("Variable rate shading tier 2: ")
+        + (SupportsShadingRateImage() ? "supported, " + std::to_string(ShadingRateImageTileSize) + " pixel tiles" : "not supported, shading every pixel"));
+}
+
 bool FDX12Device::CreateCommandQueues()
 {
     GraphicsQueue = std::make_unique<FDX12CommandQueue>();
-    return GraphicsQueue->Initialize(Device.Get(), EDX12QueueType::Direct);
+    if (!GraphicsQueue->Initialize(Device.Get(), EDX12QueueType::Direct))
+    {
+        return false;
+    }
+
+    // Async compute is optional; the render graph runs compute passes on the graphics queue without it.
+    ComputeQueue = std::make_unique<FDX12CommandQueue>();
+    if (!ComputeQueue->Initialize(Device.Get(), EDX12QueueType::Compute))
+    {
+        LogWarning("Failed to create compute queue, async compute disabled");
+        ComputeQueue.reset();
+    }
+
+    // Without a copy queue uploads are submitted on the graphics queue instead.
+    CopyQueue = std::make_unique<FDX12CommandQueue>();
+    if (!CopyQueue->Initialize(Device.Get(), EDX12QueueType::Copy))
+    {
+        LogWarning("Failed to create copy queue, uploads will use the graphics queue");
+        CopyQueue.reset();
+    }
+
+    UploadQueue = std::make_unique<FDX12UploadQueue>();
+    return UploadQueue->Initialize(Device.Get(), CopyQueue ? CopyQueue.get() : GraphicsQueue.get(), CopyQueue != nullptr);
 }
 
 bool FDX12Device::CheckTearingSupport()
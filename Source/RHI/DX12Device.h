@@ -1,6 +1,13 @@
 #pragma once
 #include "DX12Commons.h"
 #include "DX12CommandQueue.h"
+#include "DX12DescriptorAllocator.h"
+#include "DX12DirectStorage.h"
+#include "DX12HeapAllocator.h"
+#include "DX12MemoryTracker.h"
+#include "DX12PipelineCache.h"
+#include "DX12UploadQueue.h"
+#include "DX12UploadRing.h"
 #include <memory>
 
 class FDX12Device
@@ -9,25 +16,79 @@ public:
     FDX12Device();
     ~FDX12Device();
 
-    bool Initialize();
+    // The WARP software adapter stands in for the GPU in tools that need a device but no hardware.
+    bool Initialize(bool bUseWarpAdapter = false);
 
     D3D_SHADER_MODEL    GetShaderModel() const { return ShaderModel; }
 
     ID3D12Device*        GetDevice() const { return Device.Get(); }
     FDX12CommandQueue*   GetGraphicsQueue() { return GraphicsQueue.get(); }
+    FDX12CommandQueue*   GetComputeQueue() { return ComputeQueue.get(); }
+    FDX12CommandQueue*   GetCopyQueue() { return CopyQueue.get(); }
+    // Asset uploads; runs on the copy queue when one was created, otherwise on the graphics queue.
+    FDX12UploadQueue*    GetUploadQueue() { return UploadQueue.get(); }
+    // Transient upload memory for per-frame constants, reclaimed by graphics queue fence values.
+    FDX12UploadRing*     GetUploadRing() { return UploadRing.get(); }
+    // Shared shader-visible CBV/SRV/UAV heap plus staging descriptors, reclaimed by graphics queue fence values.
+    FDX12DescriptorAllocator* GetDescriptorAllocator() { return DescriptorAllocator.get(); }
+    // Root signatures and PSOs are created through this so they persist in the on-disk pipeline library.
+    FDX12PipelineCache*  GetPipelineCache() { return PipelineCache.get(); }
+    // Asset reads straight into resources and memory; null when the DirectStorage runtime is unavailable.
+    FDX12DirectStorage*  GetDirectStorage() { return DirectStorage.get(); }
+    // Default-heap pages that static textures and geometry are placed in.
+    FDX12HeapAllocator*  GetStaticResourceAllocator() { return StaticResourceAllocator.get(); }
 
     IDXGIFactory6*       GetFactory() const { return Factory.Get(); }
     IDXGIAdapter4*       GetAdapter() const { return Adapter.Get(); }
     bool                 IsTearingSupported() const { return bAllowTearing; }
+    // True when the runtime and driver support ID3D12GraphicsCommandList7::Barrier.
+    bool                 SupportsEnhancedBarriers() const { return bEnhancedBarriersSupported; }
+    // True for shader model 6.6 and resource binding tier 3, which shaders need to index ResourceDescriptorHeap.
+    bool                 SupportsBindlessResources() const { return bBindlessResourcesSupported; }
+    // True for mesh shader tier 1 and shader model 6.5, needed for amplification and mesh shaders.
+    bool                 SupportsMeshShaders() const { return bMeshShadersSupported; }
+    // True for variable rate shading tier 2, which adds the screen-space shading rate image.
+    bool                 SupportsShadingRateImage() const { return ShadingRateImageTileSize > 0; }
+    // Pixels per side of a shading rate image texel; 0 without tier 2.
+    uint32               GetShadingRateImageTileSize() const { return ShadingRateImageTileSize; }
+    // True when the 2x4, 4x2 and 4x4 coarse rates are available.
+    bool                 SupportsAdditionalShadingRates() const { return bAdditionalShadingRatesSupported; }
     bool                 QueryLocalVideoMemory(DXGI_QUERY_VIDEO_MEMORY_INFO& OutInfo) const;
 
+    // ID3D12Device::CreateCommittedResource and CreateHeap, counted by FDX12MemoryTracker under Category.
+    HRESULT CreateCommittedResource(
+        EGpuMemoryCategory Category,
+        const D3D12_HEAP_PROPERTIES* HeapProperties,
+        D3D12_HEAP_FLAGS HeapFlags,
+        const D3D12_RESOURCE_DESC* Desc,
+        D3D12_RESOURCE_STATES InitialState,
+        const D3D12_CLEAR_VALUE* ClearValue,
+        REFIID Riid,
+        void** OutResource) const
+    {
+        return FDX12MemoryTracker::Get().CreateCommittedResource(Device.Get(), Category, HeapProperties, HeapFlags, Desc, InitialState, ClearValue, Riid, OutResource);
+    }
+    HRESULT CreateHeap(EGpuMemoryCategory Category, const D3D12_HEAP_DESC* Desc, REFIID Riid, void** OutHeap) const
+    {
+        return FDX12MemoryTracker::Get().CreateHeap(Device.Get(), Category, Desc, Riid, OutHeap);
+    }
+    // Default-heap resource that is never a render or depth target, through FDX12HeapAllocator.
+    HRESULT CreateStaticResource(EGpuMemoryCategory Category, const D3D12_RESOURCE_DESC* Desc, D3D12_RESOURCE_STATES InitialState, REFIID Riid, void** OutResource) const
+    {
+        return StaticResourceAllocator->CreateResource(Category, *Desc, InitialState, Riid, OutResource);
+    }
+
 private:
     bool CreateFactory();
-    bool PickAdapter();
+    bool PickAdapter(bool bUseWarpAdapter);
     bool CreateDevice();
     bool CreateCommandQueues();
     bool CheckTearingSupport();
     bool DetermineShaderModel();
+    void CheckEnhancedBarrierSupport();
+    void CheckBindlessSupport();
+    void CheckMeshShaderSupport();
+    void CheckVariableRateShadingSupport();
 
 private:
     ComPtr<IDXGIFactory6> Factory;
@@ -35,7 +96,20 @@ private:
     ComPtr<ID3D12Device>  Device;
 
     std::unique_ptr<FDX12CommandQueue> GraphicsQueue;
+    std::unique_ptr<FDX12CommandQueue> ComputeQueue;
+    std::unique_ptr<FDX12CommandQueue> CopyQueue;
+    std::unique_ptr<FDX12UploadQueue>  UploadQueue;
+    std::unique_ptr<FDX12UploadRing>   UploadRing;
+    std::unique_ptr<FDX12DescriptorAllocator> DescriptorAllocator;
+    std::unique_ptr<FDX12PipelineCache> PipelineCache;
+    std::unique_ptr<FDX12DirectStorage> DirectStorage;
+    std::unique_ptr<FDX12HeapAllocator> StaticResourceAllocator;
 
     bool bAllowTearing = false;
+    bool bEnhancedBarriersSupported = false;
+    bool bBindlessResourcesSupported = false;
+    bool bMeshShadersSupported = false;
+    uint32 ShadingRateImageTileSize = 0;
+    bool bAdditionalShadingRatesSupported = false;
     D3D_SHADER_MODEL ShaderModel = D3D_SHADER_MODEL_6_0;
 };
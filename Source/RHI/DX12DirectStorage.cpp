@@ -0,0 +1,242 @@
+#include "DX12DirectStorage.h"
+#include "../Core/Logger.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#if WITH_DIRECTSTORAGE
+#pragma comment(lib, "dstorage.lib")
+#endif
+
+FDX12DirectStorage::FReadCounters FDX12DirectStorage::Counters[2];
+
+FDX12DirectStorage::~FDX12DirectStorage()
+{
+#if WITH_DIRECTSTORAGE
+    // Every read waits for its own fence, so nothing is in flight once the callers are gone.
+    Queue.Reset();
+    Factory.Reset();
+#endif
+}
+
+bool FDX12DirectStorage::Initialize(ID3D12Device* InDevice)
+{
+#if WITH_DIRECTSTORAGE
+    if (InDevice == nullptr)
+    {
+        return false;
+    }
+
+    if (FAILED(DStorageGetFactory(IID_PPV_ARGS(Factory.GetAddressOf()))))
+    {
+        LogInfo("DirectStorage runtime not found, assets load through mapped files");
+        return false;
+    }
+
+#if defined(_DEBUG)
+    Factory->SetDebugFlags(DSTORAGE_DEBUG_SHOW_ERRORS);
+#endif
+    if (FAILED(Factory->SetStagingBufferSize(StagingBufferSize)))
+    {
+        LogWarning("DirectStorage rejected the staging buffer size, keeping its default");
+    }
+
+    DSTORAGE_QUEUE_DESC QueueDesc = {};
+    QueueDesc.SourceType = DSTORAGE_REQUEST_SOURCE_FILE;
+    QueueDesc.Capacity = DSTORAGE_MAX_QUEUE_CAPACITY;
+    QueueDesc.Priority = DSTORAGE_PRIORITY_NORMAL;
+    QueueDesc.Name = "Asset file queue";
+    QueueDesc.Device = InDevice;
+    if (FAILED(Factory->CreateQueue(&QueueDesc, IID_PPV_ARGS(Queue.GetAddressOf()))))
+    {
+        LogWarning("Failed to create DirectStorage queue, assets load through mapped files");
+        Factory.Reset();
+        return false;
+    }
+
+    if (FAILED(InDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(Fence.GetAddressOf()))))
+    {
+        Queue.Reset();
+        Factory.Reset();
+        return false;
+    }
+
+    LogInfo("DirectStorage file queue created");
+    return true;
+#else
+    (void)InDevice;
+    return false;
+#endif
+}
+
+bool FDX12DirectStorage::ReadTexture(const std::wstring& Path, ID3D12Resource* Texture, const FDX12DirectStorageTextureRead* Reads, uint32 Count)
+{
+#if WITH_DIRECTSTORAGE
+    if (Texture == nullptr || Count == 0)
+    {
+        return Count == 0;
+    }
+
+    ComPtr<IDStorageFile> File;
+    if (FAILED(Factory->OpenFile(Path.c_str(), IID_PPV_ARGS(File.GetAddressOf()))))
+    {
+        return false;
+    }
+
+    std::vector<DSTORAGE_REQUEST> Requests(Count);
+    for (uint32 Index = 0; Index < Count; ++Index)
+    {
+        const FDX12DirectStorageTextureRead& Read = Reads[Index];
+        if (Read.Size > StagingBufferSize)
+        {
+            return false;
+        }
+
+        DSTORAGE_REQUEST& Request = Requests[Index];
+        Request.Options.SourceType = DSTORAGE_REQUEST_SOURCE_FILE;
+        Request.Options.DestinationType = DSTORAGE_REQUEST_DESTINATION_TEXTURE_REGION;
+        Request.Options.CompressionFormat = DSTORAGE_COMPRESSION_FORMAT_NONE;
+        Request.Source.File.Source = File.Get();
+        Request.Source.File.Offset = Read.FileOffset;
+        Request.Source.File.Size = Read.Size;
+        Request.UncompressedSize = Read.Size;
+        Request.Destination.Texture.Resource = Texture;
+        Request.Destination.Texture.SubresourceIndex = Read.Subresource;
+        Request.Destination.Texture.Region = { 0, 0, 0, Read.Width, Read.Height, 1 };
+    }
+
+    const bool bSucceeded = SubmitAndWait(Requests.data(), Count);
+    File->Close();
+    return bSucceeded;
+#else
+    (void)Path;
+    (void)Texture;
+    (void)Reads;
+    (void)Count;
+    return false;
+#endif
+}
+
+bool FDX12DirectStorage::ReadToMemory(const std::wstring& Path, uint64 FileOffset, uint64 Size, void* Destination)
+{
+#if WITH_DIRECTSTORAGE
+    if (Destination == nullptr || Size == 0)
+    {
+        return Size == 0;
+    }
+
+    ComPtr<IDStorageFile> File;
+    if (FAILED(Factory->OpenFile(Path.c_str(), IID_PPV_ARGS(File.GetAddressOf()))))
+    {
+        return false;
+    }
+
+    std::vector<DSTORAGE_REQUEST> Requests;
+    Requests.reserve(static_cast<size_t>((Size + StagingBufferSize - 1) / StagingBufferSize));
+    for (uint64 Offset = 0; Offset < Size; Offset += StagingBufferSize)
+    {
+        const uint32 ChunkSize = static_cast<uint32>((std::min)(static_cast<uint64>(StagingBufferSize), Size - Offset));
+
+        DSTORAGE_REQUEST Request = {};
+        Request.Options.SourceType = DSTORAGE_REQUEST_SOURCE_FILE;
+        Request.Options.DestinationType = DSTORAGE_REQUEST_DESTINATION_MEMORY;
+        Request.Options.CompressionFormat = DSTORAGE_COMPRESSION_FORMAT_NONE;
+        Request.Source.File.Source = File.Get();
+        Request.Source.File.Offset = FileOffset + Offset;
+        Request.Source.File.Size = ChunkSize;
+        Request.UncompressedSize = ChunkSize;
+        Request.Destination.Memory.Buffer = static_cast<uint8*>(Destination) + Offset;
+        Request.Destination.Memory.Size = ChunkSize;
+        Requests.push_back(Request);
+    }
+
+    const bool bSucceeded = SubmitAndWait(Requests.data(), static_cast<uint32>(Requests.size()));
+    File->Close();
+    return bSucceeded;
+#else
+    (void)Path;
+    (void)FileOffset;
+    (void)Size;
+    (void)Destination;
+    return false;
+#endif
+}
+
+#if WITH_DIRECTSTORAGE
+bool FDX12DirectStorage::SubmitAndWait(const DSTORAGE_REQUEST* Requests, uint32 Count)
+{
+    // One status entry per call reports the first failing request of this call only.
+    ComPtr<IDStorageStatusArray> StatusArray;
+    if (FAILED(Factory->CreateStatusArray(1, nullptr, IID_PPV_ARGS(StatusArray.GetAddressOf()))))
+    {
+        return false;
+    }
+
+    HANDLE FenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (FenceEvent == nullptr)
+    {
+        return false;
+    }
+
+    uint64 FenceValue = 0;
+    {
+        std::lock_guard<std::mutex> Lock(SubmitMutex);
+        for (uint32 Index = 0; Index < Count; ++Index)
+        {
+            Queue->EnqueueRequest(&Requests[Index]);
+        }
+        Queue->EnqueueStatus(StatusArray.Get(), 0);
+        FenceValue = NextFenceValue++;
+        Queue->EnqueueSignal(Fence.Get(), FenceValue);
+        Queue->Submit();
+    }
+
+    if (Fence->GetCompletedValue() < FenceValue)
+    {
+        Fence->SetEventOnCompletion(FenceValue, FenceEvent);
+        WaitForSingleObject(FenceEvent, INFINITE);
+    }
+    CloseHandle(FenceEvent);
+
+    return StatusArray->IsComplete(0) && SUCCEEDED(StatusArray->GetHResult(0));
+}
+#endif
+
+void FDX12DirectStorage::RecordRead(EAssetReadPath Path, uint64 Bytes, double Seconds)
+{
+    FReadCounters& Counter = Counters[static_cast<uint32>(Path)];
+    Counter.Bytes.fetch_add(Bytes, std::memory_order_relaxed);
+    Counter.Reads.fetch_add(1, std::memory_order_relaxed);
+    Counter.Microseconds.fetch_add(static_cast<uint64>(Seconds * 1000000.0), std::memory_order_relaxed);
+}
+
+void FDX12DirectStorage::LogThroughput(const char* Label)
+{
+    static const char* const PathNames[] = { "DirectStorage", "mapped file" };
+
+    std::ostringstream Message;
+    Message << std::fixed << std::setprecision(1) << Label << " I/O:";
+    bool bAnyReads = false;
+    for (uint32 Index = 0; Index < 2; ++Index)
+    {
+        const uint64 Bytes = Counters[Index].Bytes.exchange(0, std::memory_order_relaxed);
+        const uint64 Reads = Counters[Index].Reads.exchange(0, std::memory_order_relaxed);
+        const uint64 Microseconds = Counters[Index].Microseconds.exchange(0, std::memory_order_relaxed);
+        if (Reads == 0)
+        {
+            continue;
+        }
+
+        // Reads overlap on loading tasks, so this is per-read throughput rather than wall-clock bandwidth.
+        const double MegaBytes = static_cast<double>(Bytes) / (1024.0 * 1024.0);
+        const double Seconds = (std::max)(static_cast<double>(Microseconds) / 1000000.0, 1e-6);
+        Message << (bAnyReads ? "," : "") << " " << PathNames[Index] << " " << MegaBytes << " MB in " << Reads << " reads, " << MegaBytes / Seconds << " MB/s";
+        bAnyReads = true;
+    }
+
+    if (bAnyReads)
+    {
+        LogInfo(Message.str());
+    }
+}
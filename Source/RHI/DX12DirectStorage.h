@@ -0,0 +1,86 @@
+#pragma once
+
+#include "DX12Commons.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#if __has_include(<dstorage.h>)
+#define WITH_DIRECTSTORAGE 1
+#include <dstorage.h>
+#else
+#define WITH_DIRECTSTORAGE 0
+#endif
+
+// Which backend an asset read went through, for the throughput log.
+enum class EAssetReadPath : uint8
+{
+    DirectStorage,
+    MappedFile,
+};
+
+// A file range holding one texture subresource, already laid out like its copyable footprint:
+// rows padded to D3D12_TEXTURE_DATA_PITCH_ALIGNMENT, nothing else between them.
+struct FDX12DirectStorageTextureRead
+{
+    uint64 FileOffset = 0;
+    uint32 Size = 0;
+    uint32 Subresource = 0;
+    uint32 Width = 0;
+    uint32 Height = 0;
+};
+
+// Asset reads through a DirectStorage file queue, which moves file ranges into GPU resources or
+// memory without a stdio read or a CPU copy into an upload buffer.
+//  - Each call enqueues its requests with a fence signal and blocks until the fence passes; it is
+//    meant for loading tasks, which run many reads at once on the shared queue.
+//  - Requests are uncompressed; no asset in the tree is stored in a GPU decompression format.
+//  - A single request is at most StagingBufferSize bytes; callers read larger ranges another way.
+// Only built when dstorage.h is on the include path (the Microsoft.Direct3D.DirectStorage
+// package). Initialize fails without its runtime, and callers keep their file-mapping path.
+// All methods are thread-safe.
+class FDX12DirectStorage
+{
+public:
+    static constexpr uint32 StagingBufferSize = 64u << 20;
+
+    FDX12DirectStorage() = default;
+    FDX12DirectStorage(const FDX12DirectStorage&) = delete;
+    FDX12DirectStorage& operator=(const FDX12DirectStorage&) = delete;
+    ~FDX12DirectStorage();
+
+    bool Initialize(ID3D12Device* InDevice);
+
+    // Texture must be in COMMON and unused by every queue until the call returns; it is left in COMMON.
+    bool ReadTexture(const std::wstring& Path, ID3D12Resource* Texture, const FDX12DirectStorageTextureRead* Reads, uint32 Count);
+    // Splits the range into requests of at most StagingBufferSize bytes.
+    bool ReadToMemory(const std::wstring& Path, uint64 FileOffset, uint64 Size, void* Destination);
+
+    // Both backends feed these so the log compares them over the same session.
+    static void RecordRead(EAssetReadPath Path, uint64 Bytes, double Seconds);
+    // Logs bytes, reads and MB/s per backend since the previous call, then resets the counters.
+    static void LogThroughput(const char* Label);
+
+private:
+    struct FReadCounters
+    {
+        std::atomic<uint64> Bytes{ 0 };
+        std::atomic<uint64> Reads{ 0 };
+        std::atomic<uint64> Microseconds{ 0 };
+    };
+
+    static FReadCounters Counters[2];
+
+#if WITH_DIRECTSTORAGE
+    // Enqueues Requests followed by a status and fence signal, submits, and waits for the fence.
+    bool SubmitAndWait(const DSTORAGE_REQUEST* Requests, uint32 Count);
+
+    ComPtr<IDStorageFactory> Factory;
+    ComPtr<IDStorageQueue> Queue;
+#endif
+    ComPtr<ID3D12Fence> Fence;
+
+    // Keeps each caller's requests and its fence signal together on the queue.
+    std::mutex SubmitMutex;
+    uint64 NextFenceValue = 1;
+};
@@ -0,0 +1,527 @@
+#include "DX12HeapAllocator.h"
+#include "../Core/Logger.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <intrin.h>
+
+namespace
+{
+    // {3C8E5A17-9B42-4F6D-8E21-A7D4C0B95F38}
+    const GUID HeapRangeTokenGuid = { 0x3c8e5a17, 0x9b42, 0x4f6d, { 0x8e, 0x21, 0xa7, 0xd4, 0xc0, 0xb9, 0x5f, 0x38 } };
+
+    constexpr uint64 UnitSize = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+
+    uint32 LowestBit(uint32 Mask)
+    {
+        unsigned long Index = 0;
+        _BitScanForward(&Index, Mask);
+        return static_cast<uint32>(Index);
+    }
+
+    uint32 HighestBit(uint32 Mask)
+    {
+        unsigned long Index = 0;
+        _BitScanReverse(&Index, Mask);
+        return static_cast<uint32>(Index);
+    }
+
+    /**
+     * Two-level segregated fit over a range of units. Free blocks are kept in lists by size class:
+     * the first level is the power of two, the second splits it into SecondLevelCount linear steps,
+     * and a bitmap per level finds the smallest non-empty list that fits with two bit scans.
+     */
+    class FTlsfRange
+    {
+    public:
+        static constexpr uint32 InvalidBlock = UINT32_MAX;
+
+        explicit FTlsfRange(uint32 InUnitCount)
+        {
+            for (std::array<uint32, SecondLevelCount>& Heads : FreeHeads)
+            {
+                Heads.fill(InvalidBlock);
+            }
+            InsertFree(NewBlock(0, InUnitCount));
+        }
+
+        // Returns InvalidBlock when no free block fits; Alignment is a power of two.
+        uint32 Allocate(uint32 Size, uint32 Alignment)
+        {
+            if (Size == 0)
+            {
+                return InvalidBlock;
+            }
+
+            const uint32 Found = FindFree(Size + Alignment - 1);
+            if (Found == InvalidBlock)
+            {
+                return InvalidBlock;
+            }
+            RemoveFree(Found);
+
+            uint32 Block = Found;
+            const uint32 AlignedOffset = (Blocks[Found].Offset + Alignment - 1) & ~(Alignment - 1);
+            if (AlignedOffset > Blocks[Found].Offset)
+            {
+                Block = Split(Found, AlignedOffset - Blocks[Found].Offset);
+                InsertFree(Found);
+            }
+            if (Blocks[Block].Size > Size)
+            {
+                InsertFree(Split(Block, Size));
+            }
+
+            UsedUnits += Size;
+            return Block;
+        }
+
+        void Free(uint32 Block)
+        {
+            UsedUnits -= Blocks[Block].Size;
+
+            const uint32 Next = Blocks[Block].NextPhysical;
+            if (Next != InvalidBlock && Blocks[Next].bFree)
+            {
+                RemoveFree(Next);
+                Merge(Block, Next);
+            }
+            const uint32 Previous = Blocks[Block].PreviousPhysical;
+            if (Previous != InvalidBlock && Blocks[Previous].bFree)
+            {
+                RemoveFree(Previous);
+                Merge(Previous, Block);
+                Block = Previous;
+            }
+            InsertFree(Block);
+        }
+
+        uint32 GetOffset(uint32 Block) const { return Blocks[Block].Offset; }
+        uint32 GetUsedUnits() const { return UsedUnits; }
+        bool IsEmpty() const { return UsedUnits == 0; }
+
+    private:
+        static constexpr uint32 SecondLevelBits = 4;
+        static constexpr uint32 SecondLevelCount = 1u << SecondLevelBits;
+        static constexpr uint32 FirstLevelCount = 32;
+
+        struct FBlock
+        {
+            uint32 Offset = 0;
+            uint32 Size = 0;
+            uint32 PreviousPhysical = InvalidBlock;
+            uint32 NextPhysical = InvalidBlock;
+            uint32 PreviousFree = InvalidBlock;
+            uint32 NextFree = InvalidBlock;
+            bool bFree = false;
+        };
+
+        static void MapInsert(uint32 Size, uint32& OutFirst, uint32& OutSecond)
+        {
+            if (Size < SecondLevelCount)
+            {
+                OutFirst = 0;
+                OutSecond = Size;
+                return;
+            }
+            const uint32 Msb = HighestBit(Size);
+            OutFirst = Msb - SecondLevelBits + 1;
+            OutSecond = (Size >> (Msb - SecondLevelBits)) - SecondLevelCount;
+        }
+
+        // Rounds Size up to the next list boundary so every block of the mapped list fits it.
+        static void MapSearch(uint32 Size, uint32& OutFirst, uint32& OutSecond)
+        {
+            if (Size >= SecondLevelCount)
+            {
+                Size += (1u << (HighestBit(Size) - SecondLevelBits)) - 1;
+            }
+            MapInsert(Size, OutFirst, OutSecond);
+        }
+
+        uint32 FindFree(uint32 Size) const
+        {
+            uint32 First = 0;
+            uint32 Second = 0;
+            MapSearch(Size, First, Second);
+            if (First >= FirstLevelCount)
+            {
+                return InvalidBlock;
+            }
+
+            uint32 SecondMask = SecondLevelBitmaps[First] & (~0u << Second);
+            if (SecondMask == 0)
+            {
+                const uint32 FirstMask = First + 1 < FirstLevelCount ? FirstLevelBitmap & (~0u << (First + 1)) : 0;
+                if (FirstMask == 0)
+                {
+                    return InvalidBlock;
+                }
+                First = LowestBit(FirstMask);
+                SecondMask = SecondLevelBitmaps[First];
+            }
+            return FreeHeads[First][LowestBit(SecondMask)];
+        }
+
+        uint32 NewBlock(uint32 Offset, uint32 Size)
+        {
+            FBlock Block;
+            Block.Offset = Offset;
+            Block.Size = Size;
+            if (!UnusedBlocks.empty())
+            {
+                const uint32 Index = UnusedBlocks.back();
+                UnusedBlocks.pop_back();
+                Blocks[Index] = Block;
+                return Index;
+            }
+            Blocks.push_back(Block);
+            return static_cast<uint32>(Blocks.size() - 1);
+        }
+
+        // Cuts Block after Size units and returns the new block that follows it.
+        uint32 Split(uint32 Block, uint32 Size)
+        {
+            const uint32 Tail = NewBlock(Blocks[Block].Offset + Size, Blocks[Block].Size - Size);
+            Blocks[Tail].PreviousPhysical = Block;
+            Blocks[Tail].NextPhysical = Blocks[Block].NextPhysical;
+            if (Blocks[Tail].NextPhysical != InvalidBlock)
+            {
+                Blocks[Blocks[Tail].NextPhysical].PreviousPhysical = Tail;
+            }
+            Blocks[Block].NextPhysical = Tail;
+            Blocks[Block].Size = Size;
+            return Tail;
+        }
+
+        // Folds Next, which must directly follow Block, into Block.
+        void Merge(uint32 Block, uint32 Next)
+        {
+            Blocks[Block].Size += Blocks[Next].Size;
+            Blocks[Block].NextPhysical = Blocks[Next].NextPhysical;
+            if (Blocks[Block].NextPhysical != InvalidBlock)
+            {
+                Blocks[Blocks[Block].NextPhysical].PreviousPhysical = Block;
+            }
+            UnusedBlocks.push_back(Next);
+        }
+
+        void InsertFree(uint32 Index)
+        {
+            uint32 First = 0;
+            uint32 Second = 0;
+            MapInsert(Blocks[Index].Size, First, Second);
+
+            FBlock& Block = Blocks[Index];
+            Block.bFree = true;
+            Block.PreviousFree = InvalidBlock;
+            Block.NextFree = FreeHeads[First][Second];
+            if (Block.NextFree != InvalidBlock)
+            {
+                Blocks[Block.NextFree].PreviousFree = Index;
+            }
+            FreeHeads[First][Second] = Index;
+            FirstLevelBitmap |= 1u << First;
+            SecondLevelBitmaps[First] |= 1u << Second;
+        }
+
+        void RemoveFree(uint32 Index)
+        {
+            uint32 First = 0;
+            uint32 Second = 0;
+            MapInsert(Blocks[Index].Size, First, Second);
+
+            FBlock& Block = Blocks[Index];
+            if (Block.NextFree != InvalidBlock)
+            {
+                Blocks[Block.NextFree].PreviousFree = Block.PreviousFree;
+            }
+            if (Block.PreviousFree != InvalidBlock)
+            {
+                Blocks[Block.PreviousFree].NextFree = Block.NextFree;
+            }
+            else
+            {
+                FreeHeads[First][Second] = Block.NextFree;
+                if (Block.NextFree == InvalidBlock)
+                {
+                    SecondLevelBitmaps[First] &= ~(1u << Second);
+                    if (SecondLevelBitmaps[First] == 0)
+                    {
+                        FirstLevelBitmap &= ~(1u << First);
+                    }
+                }
+            }
+            Block.bFree = false;
+            Block.PreviousFree = InvalidBlock;
+            Block.NextFree = InvalidBlock;
+        }
+
+        std::vector<FBlock> Blocks;
+        std::vector<uint32> UnusedBlocks;
+        std::array<std::array<uint32, SecondLevelCount>, FirstLevelCount> FreeHeads;
+        std::array<uint32, FirstLevelCount> SecondLevelBitmaps{};
+        uint32 FirstLevelBitmap = 0;
+        uint32 UsedUnits = 0;
+    };
+}
+
+class FDX12HeapAllocator::FPage
+{
+public:
+    FPage(ComPtr<ID3D12Heap> InHeap, EGpuMemoryCategory InCategory, bool bInTextures, uint32 UnitCount)
+        : Heap(std::move(InHeap))
+        , Category(InCategory)
+        , bTextures(bInTextures)
+        , Range(UnitCount)
+    {
+    }
+
+    ComPtr<ID3D12Heap> Heap;
+    const EGpuMemoryCategory Category;
+    const bool bTextures;
+
+    std::mutex Mutex;
+    FTlsfRange Range;
+    uint32 PlacedCount = 0;
+};
+
+// Lives in the placed resource's private data; D3D releases it when the resource is destroyed.
+class FDX12HeapAllocator::FRangeToken final : public IUnknown
+{
+public:
+    FRangeToken(std::shared_ptr<FPage> InPage, uint32 InBlock)
+        : Page(std::move(InPage))
+        , Block(InBlock)
+    {
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID Riid, void** OutObject) override
+    {
+        if (!OutObject)
+        {
+            return E_POINTER;
+        }
+        if (Riid == __uuidof(IUnknown))
+        {
+            *OutObject = static_cast<IUnknown*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *OutObject = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return RefCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        const ULONG Remaining = RefCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        if (Remaining == 0)
+        {
+            {
+                std::lock_guard<std::mutex> Lock(Page->Mutex);
+                Page->Range.Free(Block);
+                --Page->PlacedCount;
+            }
+            delete this;
+        }
+        return Remaining;
+    }
+
+private:
+    std::shared_ptr<FPage> Page;
+    uint32 Block;
+    std::atomic<ULONG> RefCount{ 1 };
+};
+
+FDX12HeapAllocator::~FDX12HeapAllocator() = default;
+
+bool FDX12HeapAllocator::Initialize(ID3D12Device* InDevice, uint64 InPageSize)
+{
+    if (!InDevice || InPageSize < D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT)
+    {
+        return false;
+    }
+
+    Device = InDevice;
+    // Whole 64 KB steps, so page offsets can satisfy either placement alignment.
+    PageSize = InPageSize & ~(static_cast<uint64>(D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT) - 1);
+    return true;
+}
+
+HRESULT FDX12HeapAllocator::CreateResource(EGpuMemoryCategory Category, const D3D12_RESOURCE_DESC& Desc, D3D12_RESOURCE_STATES InitialState, REFIID Riid, void** OutResource)
+{
+    if (!Device || !OutResource)
+    {
+        return E_INVALIDARG;
+    }
+
+    const bool bTexture = Desc.Dimension != D3D12_RESOURCE_DIMENSION_BUFFER;
+    const D3D12_RESOURCE_FLAGS TargetFlags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+    bool bPlaceable = (Desc.Flags & TargetFlags) == 0 && Desc.SampleDesc.Count <= 1;
+
+    D3D12_RESOURCE_DESC PlacedDesc = Desc;
+    D3D12_RESOURCE_ALLOCATION_INFO Info = {};
+    if (bPlaceable)
+    {
+        // The runtime answers with the 64 KB alignment when the texture is too large for small placement.
+        if (bTexture)
+        {
+            PlacedDesc.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+            Info = Device->GetResourceAllocationInfo(0, 1, &PlacedDesc);
+        }
+        if (!bTexture || Info.Alignment != D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT)
+        {
+            PlacedDesc.Alignment = 0;
+            Info = Device->GetResourceAllocationInfo(0, 1, &PlacedDesc);
+        }
+        bPlaceable = Info.SizeInBytes != UINT64_MAX && Info.SizeInBytes <= PageSize / 4;
+    }
+
+    if (bPlaceable)
+    {
+        const uint32 SizeUnits = static_cast<uint32>((Info.SizeInBytes + UnitSize - 1) / UnitSize);
+        const uint32 AlignmentUnits = static_cast<uint32>((std::max)(Info.Alignment, UnitSize) / UnitSize);
+
+        std::shared_ptr<FPage> Page;
+        uint32 Block = FTlsfRange::InvalidBlock;
+        uint64 Offset = 0;
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            ReleaseEmptyPages();
+
+            for (const std::shared_ptr<FPage>& Candidate : Pages)
+            {
+                if (Candidate->Category != Category || Candidate->bTextures != bTexture)
+                {
+                    continue;
+                }
+                std::lock_guard<std::mutex> PageLock(Candidate->Mutex);
+                Block = Candidate->Range.Allocate(SizeUnits, AlignmentUnits);
+                if (Block != FTlsfRange::InvalidBlock)
+                {
+                    Offset = static_cast<uint64>(Candidate->Range.GetOffset(Block)) * UnitSize;
+                    ++Candidate->PlacedCount;
+                    Page = Candidate;
+                    break;
+                }
+            }
+
+            if (!Page)
+            {
+                Page = CreatePage(Category, bTexture);
+                if (Page)
+                {
+                    std::lock_guard<std::mutex> PageLock(Page->Mutex);
+                    Block = Page->Range.Allocate(SizeUnits, AlignmentUnits);
+                    Offset = static_cast<uint64>(Page->Range.GetOffset(Block)) * UnitSize;
+                    ++Page->PlacedCount;
+                }
+            }
+        }
+
+        if (Page)
+        {
+            ComPtr<ID3D12Resource> Resource;
+            const HRESULT Result = Device->CreatePlacedResource(Page->Heap.Get(), Offset, &PlacedDesc, InitialState, nullptr, IID_PPV_ARGS(Resource.GetAddressOf()));
+
+            // Releasing the token returns the range, right away when placement failed.
+            FRangeToken* Token = new FRangeToken(Page, Block);
+            if (SUCCEEDED(Result) && FAILED(Resource->SetPrivateDataInterface(HeapRangeTokenGuid, Token)))
+            {
+                // The range stays reserved for good rather than being handed out under a live resource.
+                LogWarning("Heap allocator could not attach to a placed ", GetGpuMemoryCategoryName(Category), " resource");
+            }
+            else
+            {
+                Token->Release();
+            }
+
+            if (SUCCEEDED(Result))
+            {
+                return Resource->QueryInterface(Riid, OutResource);
+            }
+            LogWarning("Placed ", GetGpuMemoryCategoryName(Category), " resource failed, falling back to a committed one");
+        }
+    }
+
+    D3D12_HEAP_PROPERTIES DefaultHeap = {};
+    DefaultHeap.Type = D3D12_HEAP_TYPE_DEFAULT;
+    DefaultHeap.CreationNodeMask = 1;
+    DefaultHeap.VisibleNodeMask = 1;
+    return FDX12MemoryTracker::Get().CreateCommittedResource(Device, Category, &DefaultHeap, D3D12_HEAP_FLAG_NONE, &Desc, InitialState, nullptr, Riid, OutResource);
+}
+
+FDX12HeapAllocator::FStats FDX12HeapAllocator::GetStats() const
+{
+    FStats Stats;
+    std::lock_guard<std::mutex> Lock(Mutex);
+    for (const std::shared_ptr<FPage>& Page : Pages)
+    {
+        std::lock_guard<std::mutex> PageLock(Page->Mutex);
+        Stats.ReservedBytes += PageSize;
+        Stats.UsedBytes += static_cast<uint64>(Page->Range.GetUsedUnits()) * UnitSize;
+        Stats.PlacedCount += Page->PlacedCount;
+        ++Stats.PageCount;
+    }
+    return Stats;
+}
+
+std::shared_ptr<FDX12HeapAllocator::FPage> FDX12HeapAllocator::CreatePage(EGpuMemoryCategory Category, bool bTextures)
+{
+    D3D12_HEAP_DESC HeapDesc = {};
+    HeapDesc.SizeInBytes = PageSize;
+    HeapDesc.Properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+    HeapDesc.Properties.CreationNodeMask = 1;
+    HeapDesc.Properties.VisibleNodeMask = 1;
+    HeapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+    // Tier 1 heaps hold one resource kind; keeping them apart works on every tier.
+    HeapDesc.Flags = bTextures ? D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES : D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+
+    ComPtr<ID3D12Heap> Heap;
+    FGpuMemoryOwnerScope SharedMemoryScope(FDX12MemoryTracker::SharedOwner);
+    if (FAILED(FDX12MemoryTracker::Get().CreateHeap(Device, Category, &HeapDesc, IID_PPV_ARGS(Heap.GetAddressOf()))))
+    {
+        LogWarning("Heap allocator could not create a ", PageSize >> 20, " MB ", GetGpuMemoryCategoryName(Category), " page");
+        return nullptr;
+    }
+    Heap->SetName(bTextures ? L"StaticTexturePage" : L"StaticBufferPage");
+
+    std::shared_ptr<FPage> Page = std::make_shared<FPage>(std::move(Heap), Category, bTextures, static_cast<uint32>(PageSize / UnitSize));
+    Pages.push_back(Page);
+    return Page;
+}
+
+void FDX12HeapAllocator::ReleaseEmptyPages()
+{
+    std::vector<std::shared_ptr<FPage>> Kept;
+    Kept.reserve(Pages.size());
+    for (std::shared_ptr<FPage>& Page : Pages)
+    {
+        bool bEmpty = false;
+        {
+            std::lock_guard<std::mutex> PageLock(Page->Mutex);
+            bEmpty = Page->Range.IsEmpty();
+        }
+
+        bool bFirstOfKind = true;
+        for (const std::shared_ptr<FPage>& Other : Kept)
+        {
+            if (Other->Category == Page->Category && Other->bTextures == Page->bTextures)
+            {
+                bFirstOfKind = false;
+                break;
+            }
+        }
+
+        if (!bEmpty || bFirstOfKind)
+        {
+            Kept.push_back(std::move(Page));
+        }
+    }
+    Pages = std::move(Kept);
+}
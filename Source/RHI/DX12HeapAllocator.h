@@ -0,0 +1,60 @@
+#pragma once
+
+#include "DX12Commons.h"
+#include "DX12MemoryTracker.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Places static textures and buffers in large default-heap pages instead of giving each its own
+ * committed resource. Every page is suballocated in 4 KB units with a two-level segregated fit
+ * allocator, so allocation and free are constant time and neighbouring free ranges merge at once.
+ * Textures that allow it use the 4 KB small-resource alignment rather than 64 KB.
+ *
+ * A placed resource carries a private-data token that returns its range to the page when D3D
+ * destroys the resource, so callers keep ordinary ComPtr lifetimes and a page outlives the
+ * allocator while any of its resources is alive. Pages are counted by FDX12MemoryTracker under
+ * SharedOwner. Render and depth targets, multisampled textures and anything larger than a
+ * quarter page still get committed resources.
+ */
+class FDX12HeapAllocator
+{
+public:
+    static constexpr uint64 DefaultPageSize = 64ull << 20;
+
+    struct FStats
+    {
+        uint64 ReservedBytes = 0;
+        uint64 UsedBytes = 0;
+        uint32 PageCount = 0;
+        uint32 PlacedCount = 0;
+    };
+
+    FDX12HeapAllocator() = default;
+    ~FDX12HeapAllocator();
+
+    FDX12HeapAllocator(const FDX12HeapAllocator&) = delete;
+    FDX12HeapAllocator& operator=(const FDX12HeapAllocator&) = delete;
+
+    bool Initialize(ID3D12Device* InDevice, uint64 InPageSize = DefaultPageSize);
+
+    // Default-heap resource placed in a page of Category when it qualifies, otherwise committed.
+    HRESULT CreateResource(EGpuMemoryCategory Category, const D3D12_RESOURCE_DESC& Desc, D3D12_RESOURCE_STATES InitialState, REFIID Riid, void** OutResource);
+
+    FStats GetStats() const;
+
+private:
+    class FPage;
+    class FRangeToken;
+
+    std::shared_ptr<FPage> CreatePage(EGpuMemoryCategory Category, bool bTextures);
+    // Drops empty pages, keeping the first of each category and kind for the next allocation.
+    void ReleaseEmptyPages();
+
+    ID3D12Device* Device = nullptr;
+    uint64 PageSize = DefaultPageSize;
+
+    mutable std::mutex Mutex;
+    std::vector<std::shared_ptr<FPage>> Pages;
+};
@@ -0,0 +1,372 @@
+#include "DX12MemoryTracker.h"
+#include "../Core/Logger.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+    // {6F2B1C64-3E0A-4D5B-9A77-51C0D2E8A913}
+    const GUID GpuMemoryTokenGuid = { 0x6f2b1c64, 0x3e0a, 0x4d5b, { 0x9a, 0x77, 0x51, 0xc0, 0xd2, 0xe8, 0xa9, 0x13 } };
+
+    constexpr uint32 MaxReportedAllocations = 32;
+
+    thread_local uint32 GCurrentOwner = FDX12MemoryTracker::SharedOwner;
+
+    double ToMegabytes(uint64 Bytes)
+    {
+        return static_cast<double>(Bytes) / (1024.0 * 1024.0);
+    }
+}
+
+std::atomic<uint32> FDX12MemoryTracker::NextOwnerId{ 1 };
+
+const char* GetGpuMemoryCategoryName(EGpuMemoryCategory Category)
+{
+    switch (Category)
+    {
+    case EGpuMemoryCategory::Texture:        return "Texture";
+    case EGpuMemoryCategory::Geometry:       return "Geometry";
+    case EGpuMemoryCategory::RenderTarget:   return "RenderTarget";
+    case EGpuMemoryCategory::Buffer:         return "Buffer";
+    case EGpuMemoryCategory::Upload:         return "Upload";
+    case EGpuMemoryCategory::Readback:       return "Readback";
+    case EGpuMemoryCategory::GraphTransient: return "GraphTransient";
+    default:                                 return "Unknown";
+    }
+}
+
+// Lives in the object's private data; D3D releases it when the object is destroyed.
+class FDX12MemoryTracker::FAllocationToken final : public IUnknown
+{
+public:
+    FAllocationToken(FDX12MemoryTracker& InTracker, uint64 InAllocationId)
+        : Tracker(InTracker)
+        , AllocationId(InAllocationId)
+    {
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID Riid, void** OutObject) override
+    {
+        if (!OutObject)
+        {
+            return E_POINTER;
+        }
+        if (Riid == __uuidof(IUnknown))
+        {
+            *OutObject = static_cast<IUnknown*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *OutObject = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return RefCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        const ULONG Remaining = RefCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        if (Remaining == 0)
+        {
+            Tracker.Untrack(AllocationId);
+            delete this;
+        }
+        return Remaining;
+    }
+
+    uint64 GetAllocationId() const { return AllocationId; }
+
+private:
+    FDX12MemoryTracker& Tracker;
+    uint64 AllocationId;
+    std::atomic<ULONG> RefCount{ 1 };
+};
+
+FDX12MemoryTracker& FDX12MemoryTracker::Get()
+{
+    // Never destroyed: resources released from static destructors still find it.
+    static FDX12MemoryTracker* Tracker = new FDX12MemoryTracker();
+    return *Tracker;
+}
+
+uint32 FDX12MemoryTracker::AllocateOwnerId()
+{
+    return NextOwnerId.fetch_add(1, std::memory_order_relaxed);
+}
+
+HRESULT FDX12MemoryTracker::CreateCommittedResource(
+    ID3D12Device* Device,
+    EGpuMemoryCategory Category,
+    const D3D12_HEAP_PROPERTIES* HeapProperties,
+    D3D12_HEAP_FLAGS HeapFlags,
+    const D3D12_RESOURCE_DESC* Desc,
+    D3D12_RESOURCE_STATES InitialState,
+    const D3D12_CLEAR_VALUE* ClearValue,
+    REFIID Riid,
+    void** OutResource)
+{
+    if (!Device || !Desc || !OutResource)
+    {
+        return E_INVALIDARG;
+    }
+
+    ComPtr<ID3D12Resource> Resource;
+    const HRESULT Result = Device->CreateCommittedResource(HeapProperties, HeapFlags, Desc, InitialState, ClearValue, IID_PPV_ARGS(Resource.GetAddressOf()));
+    if (FAILED(Result))
+    {
+        return Result;
+    }
+
+    FAllocation Allocation;
+    Allocation.Category = Category;
+    Allocation.Bytes = Device->GetResourceAllocationInfo(0, 1, Desc).SizeInBytes;
+    Allocation.Dimension = Desc->Dimension;
+    Allocation.Width = Desc->Width;
+    Allocation.Height = Desc->Height;
+    Allocation.DepthOrArraySize = Desc->DepthOrArraySize;
+    Allocation.Format = Desc->Format;
+    Track(Resource.Get(), Allocation);
+
+    return Resource->QueryInterface(Riid, OutResource);
+}
+
+HRESULT FDX12MemoryTracker::CreateHeap(ID3D12Device* Device, EGpuMemoryCategory Category, const D3D12_HEAP_DESC* Desc, REFIID Riid, void** OutHeap)
+{
+    if (!Device || !Desc || !OutHeap)
+    {
+        return E_INVALIDARG;
+    }
+
+    ComPtr<ID3D12Heap> Heap;
+    const HRESULT Result = Device->CreateHeap(Desc, IID_PPV_ARGS(Heap.GetAddressOf()));
+    if (FAILED(Result))
+    {
+        return Result;
+    }
+
+    FAllocation Allocation;
+    Allocation.Category = Category;
+    Allocation.Bytes = Desc->SizeInBytes;
+    Allocation.Width = Desc->SizeInBytes;
+    Allocation.bHeap = true;
+    Track(Heap.Get(), Allocation);
+
+    return Heap->QueryInterface(Riid, OutHeap);
+}
+
+void FDX12MemoryTracker::Track(ID3D12Object* Object, const FAllocation& Allocation)
+{
+    FAllocation Tracked = Allocation;
+    Tracked.Owner = FGpuMemoryOwnerScope::GetCurrentOwner();
+
+    uint64 AllocationId = 0;
+    FCategoryStats CategoryStats;
+    bool bCrossedBudget = false;
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        AllocationId = NextAllocationId++;
+        Allocations.emplace(AllocationId, Tracked);
+
+        FCategoryStats& Category = Stats[static_cast<uint32>(Tracked.Category)];
+        bCrossedBudget = Category.BudgetBytes > 0 && Category.Bytes <= Category.BudgetBytes && Category.Bytes + Tracked.Bytes > Category.BudgetBytes;
+        Category.Bytes += Tracked.Bytes;
+        ++Category.Count;
+        CategoryStats = Category;
+    }
+
+    FAllocationToken* Token = new FAllocationToken(*this, AllocationId);
+    if (FAILED(Object->SetPrivateDataInterface(GpuMemoryTokenGuid, Token)))
+    {
+        // Untracked right away rather than counted forever.
+        LogWarning("GPU memory tracker could not attach to a ", GetGpuMemoryCategoryName(Tracked.Category), " allocation");
+    }
+    Token->Release();
+
+    if (bCrossedBudget)
+    {
+        LogWarning(
+            "GPU memory category ", GetGpuMemoryCategoryName(Tracked.Category), " is over budget: ",
+            ToMegabytes(CategoryStats.Bytes), " / ", ToMegabytes(CategoryStats.BudgetBytes), " MB");
+    }
+}
+
+void FDX12MemoryTracker::Untrack(uint64 AllocationId)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    const auto Found = Allocations.find(AllocationId);
+    if (Found == Allocations.end())
+    {
+        return;
+    }
+
+    FCategoryStats& Category = Stats[static_cast<uint32>(Found->second.Category)];
+    Category.Bytes -= (std::min)(Category.Bytes, Found->second.Bytes);
+    Category.Count -= (std::min)(Category.Count, 1u);
+    Allocations.erase(Found);
+}
+
+void FDX12MemoryTracker::TransferOwnership(ID3D12Object* Object, uint32 Owner)
+{
+    IUnknown* Token = nullptr;
+    UINT TokenSize = sizeof(Token);
+    if (!Object || FAILED(Object->GetPrivateData(GpuMemoryTokenGuid, &TokenSize, &Token)) || !Token)
+    {
+        return;
+    }
+
+    const uint64 AllocationId = static_cast<FAllocationToken*>(Token)->GetAllocationId();
+    Token->Release();
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    const auto Found = Allocations.find(AllocationId);
+    if (Found != Allocations.end() && Found->second.Owner != SharedOwner)
+    {
+        Found->second.Owner = Owner;
+    }
+}
+
+void FDX12MemoryTracker::SetCategoryBudget(EGpuMemoryCategory Category, uint64 BudgetBytes)
+{
+    if (Category >= EGpuMemoryCategory::Count)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Stats[static_cast<uint32>(Category)].BudgetBytes = BudgetBytes;
+}
+
+void FDX12MemoryTracker::ApplyCategoryBudgets(const std::string& Budgets)
+{
+    std::stringstream Stream(Budgets);
+    std::string Entry;
+    while (std::getline(Stream, Entry, ','))
+    {
+        Entry.erase(std::remove_if(Entry.begin(), Entry.end(), [](unsigned char Char) { return std::isspace(Char) != 0; }), Entry.end());
+        if (Entry.empty())
+        {
+            continue;
+        }
+
+        const size_t Separator = Entry.find(':');
+        std::string Name = Entry.substr(0, Separator);
+        std::transform(Name.begin(), Name.end(), Name.begin(), [](unsigned char Char) { return static_cast<char>(std::tolower(Char)); });
+
+        uint32 CategoryIndex = 0;
+        for (; CategoryIndex < GpuMemoryCategoryCount; ++CategoryIndex)
+        {
+            std::string CategoryName = GetGpuMemoryCategoryName(static_cast<EGpuMemoryCategory>(CategoryIndex));
+            std::transform(CategoryName.begin(), CategoryName.end(), CategoryName.begin(), [](unsigned char Char) { return static_cast<char>(std::tolower(Char)); });
+            if (CategoryName == Name)
+            {
+                break;
+            }
+        }
+
+        if (Separator == std::string::npos || CategoryIndex == GpuMemoryCategoryCount)
+        {
+            LogWarning("Invalid GPU memory budget entry: ", Entry);
+            continue;
+        }
+
+        try
+        {
+            const uint64 BudgetMB = std::stoull(Entry.substr(Separator + 1));
+            SetCategoryBudget(static_cast<EGpuMemoryCategory>(CategoryIndex), BudgetMB * 1024ull * 1024ull);
+        }
+        catch (...)
+        {
+            LogWarning("Invalid GPU memory budget entry: ", Entry);
+        }
+    }
+}
+
+std::array<FDX12MemoryTracker::FCategoryStats, GpuMemoryCategoryCount> FDX12MemoryTracker::GetCategoryStats() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Stats;
+}
+
+uint64 FDX12MemoryTracker::GetTotalBytes() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    uint64 Total = 0;
+    for (const FCategoryStats& Category : Stats)
+    {
+        Total += Category.Bytes;
+    }
+    return Total;
+}
+
+uint32 FDX12MemoryTracker::ReportLiveAllocations(uint32 Owner, const char* Context) const
+{
+    std::vector<FAllocation> Live;
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        for (const auto& Entry : Allocations)
+        {
+            if (Entry.second.Owner == Owner)
+            {
+                Live.push_back(Entry.second);
+            }
+        }
+    }
+
+    if (Live.empty())
+    {
+        return 0;
+    }
+
+    std::sort(Live.begin(), Live.end(), [](const FAllocation& A, const FAllocation& B) { return A.Bytes > B.Bytes; });
+    uint64 LiveBytes = 0;
+    for (const FAllocation& Allocation : Live)
+    {
+        LiveBytes += Allocation.Bytes;
+    }
+
+    LogWarning(Live.size(), " GPU allocations (", ToMegabytes(LiveBytes), " MB) still alive after ", Context);
+    for (size_t Index = 0; Index < Live.size() && Index < MaxReportedAllocations; ++Index)
+    {
+        const FAllocation& Allocation = Live[Index];
+        if (Allocation.bHeap)
+        {
+            LogWarning("  ", GetGpuMemoryCategoryName(Allocation.Category), " heap, ", Allocation.Bytes, " bytes");
+        }
+        else if (Allocation.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+        {
+            LogWarning("  ", GetGpuMemoryCategoryName(Allocation.Category), " buffer, ", Allocation.Bytes, " bytes");
+        }
+        else
+        {
+            LogWarning(
+                "  ", GetGpuMemoryCategoryName(Allocation.Category), " texture ", Allocation.Width, "x", Allocation.Height, "x", Allocation.DepthOrArraySize,
+                " format ", static_cast<uint32>(Allocation.Format), ", ", Allocation.Bytes, " bytes");
+        }
+    }
+    if (Live.size() > MaxReportedAllocations)
+    {
+        LogWarning("  ... and ", Live.size() - MaxReportedAllocations, " more");
+    }
+    return static_cast<uint32>(Live.size());
+}
+
+FGpuMemoryOwnerScope::FGpuMemoryOwnerScope(uint32 Owner)
+    : PreviousOwner(GCurrentOwner)
+{
+    GCurrentOwner = Owner;
+}
+
+FGpuMemoryOwnerScope::~FGpuMemoryOwnerScope()
+{
+    GCurrentOwner = PreviousOwner;
+}
+
+uint32 FGpuMemoryOwnerScope::GetCurrentOwner()
+{
+    return GCurrentOwner;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "DX12Commons.h"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+enum class EGpuMemoryCategory : uint8
+{
+    Texture,
+    Geometry,
+    RenderTarget,
+    // GPU-written and scene data buffers: culling, indirect arguments, lights, debug output.
+    Buffer,
+    Upload,
+    Readback,
+    GraphTransient,
+    Count
+};
+
+constexpr uint32 GpuMemoryCategoryCount = static_cast<uint32>(EGpuMemoryCategory::Count);
+
+const char* GetGpuMemoryCategoryName(EGpuMemoryCategory Category);
+
+/**
+ * Process-wide account of the video memory the renderer allocates. Resources and heaps created
+ * through it carry a private-data token that D3D releases with the object, so an allocation is
+ * counted exactly as long as the object lives, wherever its last reference goes.
+ *
+ * Each allocation also records the owner of the FGpuMemoryOwnerScope active on the creating
+ * thread. Renderers scope their creation and frames to their own owner, and allocations meant to
+ * outlive them (the texture cache, render graph pools) to SharedOwner, so whatever is still alive
+ * under a renderer's owner after it was destroyed has leaked.
+ */
+class FDX12MemoryTracker
+{
+public:
+    static constexpr uint32 SharedOwner = 0;
+
+    struct FCategoryStats
+    {
+        uint64 Bytes = 0;
+        uint32 Count = 0;
+        // 0 when the category has no budget.
+        uint64 BudgetBytes = 0;
+    };
+
+    static FDX12MemoryTracker& Get();
+    static uint32 AllocateOwnerId();
+
+    HRESULT CreateCommittedResource(
+        ID3D12Device* Device,
+        EGpuMemoryCategory Category,
+        const D3D12_HEAP_PROPERTIES* HeapProperties,
+        D3D12_HEAP_FLAGS HeapFlags,
+        const D3D12_RESOURCE_DESC* Desc,
+        D3D12_RESOURCE_STATES InitialState,
+        const D3D12_CLEAR_VALUE* ClearValue,
+        REFIID Riid,
+        void** OutResource);
+    // Resources placed in a tracked heap are not counted again.
+    HRESULT CreateHeap(ID3D12Device* Device, EGpuMemoryCategory Category, const D3D12_HEAP_DESC* Desc, REFIID Riid, void** OutHeap);
+
+    // Hands an object another renderer keeps using to Owner; shared allocations stay shared.
+    void TransferOwnership(ID3D12Object* Object, uint32 Owner);
+
+    // Warns once each time the category's live total rises past BudgetBytes; 0 removes the budget.
+    void SetCategoryBudget(EGpuMemoryCategory Category, uint64 BudgetBytes);
+    // Applies a comma-separated list of category:megabytes pairs, e.g. "texture:1024,rendertarget:512".
+    void ApplyCategoryBudgets(const std::string& Budgets);
+
+    std::array<FCategoryStats, GpuMemoryCategoryCount> GetCategoryStats() const;
+    uint64 GetTotalBytes() const;
+
+    // Logs the allocations of Owner still alive and returns their count.
+    uint32 ReportLiveAllocations(uint32 Owner, const char* Context) const;
+
+private:
+    struct FAllocation
+    {
+        EGpuMemoryCategory Category = EGpuMemoryCategory::Buffer;
+        uint64 Bytes = 0;
+        uint32 Owner = SharedOwner;
+        D3D12_RESOURCE_DIMENSION Dimension = D3D12_RESOURCE_DIMENSION_UNKNOWN;
+        uint64 Width = 0;
+        uint32 Height = 0;
+        uint16 DepthOrArraySize = 0;
+        DXGI_FORMAT Format = DXGI_FORMAT_UNKNOWN;
+        bool bHeap = false;
+    };
+
+    class FAllocationToken;
+
+    FDX12MemoryTracker() = default;
+
+    void Track(ID3D12Object* Object, const FAllocation& Allocation);
+    void Untrack(uint64 AllocationId);
+
+    mutable std::mutex Mutex;
+    std::unordered_map<uint64, FAllocation> Allocations;
+    std::array<FCategoryStats, GpuMemoryCategoryCount> Stats{};
+    uint64 NextAllocationId = 1;
+
+    static std::atomic<uint32> NextOwnerId;
+};
+
+// Tags the allocations made on this thread while it lives with Owner; scopes nest.
+class FGpuMemoryOwnerScope
+{
+public:
+    explicit FGpuMemoryOwnerScope(uint32 Owner);
+    ~FGpuMemoryOwnerScope();
+
+    FGpuMemoryOwnerScope(const FGpuMemoryOwnerScope&) = delete;
+    FGpuMemoryOwnerScope& operator=(const FGpuMemoryOwnerScope&) = delete;
+
+    static uint32 GetCurrentOwner();
+
+private:
+    uint32 PreviousOwner;
+};
@@ -0,0 +1,574 @@
+#include "DX12PipelineCache.h"
+#include "../Core/Logger.h"
+#include <cstring>
+#include <cwchar>
+#include <fstream>
+#include <type_traits>
+
+namespace
+{
+    constexpr uint32 PipelineCacheMagic = 0x4F535055; // 'UPSO'
+    constexpr uint32 PipelineCacheVersion = 1;
+
+    // FNV-1a over everything that makes two pipeline descriptions produce different PSOs.
+    struct FPipelineHasher
+    {
+        uint64 Value = 14695981039346656037ULL;
+
+        void AddBytes(const void* Data, size_t Size)
+        {
+            const uint8* Bytes = static_cast<const uint8*>(Data);
+            for (size_t Index = 0; Index < Size; ++Index)
+            {
+                Value ^= Bytes[Index];
+                Value *= 1099511628211ULL;
+            }
+        }
+
+        template <typename T>
+        void Add(const T& Field)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Hash fields individually");
+            AddBytes(&Field, sizeof(Field));
+        }
+
+        void AddBytecode(const D3D12_SHADER_BYTECODE& Bytecode)
+        {
+            Add(Bytecode.BytecodeLength);
+            if (Bytecode.pShaderBytecode)
+            {
+                AddBytes(Bytecode.pShaderBytecode, Bytecode.BytecodeLength);
+            }
+        }
+
+        // Blend and depth-stencil descs contain padding, so they are hashed field by field.
+        void AddBlendState(const D3D12_BLEND_DESC& Blend)
+        {
+            Add(Blend.AlphaToCoverageEnable);
+            Add(Blend.IndependentBlendEnable);
+            for (const D3D12_RENDER_TARGET_BLEND_DESC& Target : Blend.RenderTarget)
+            {
+                Add(Target.BlendEnable);
+                Add(Target.LogicOpEnable);
+                Add(Target.SrcBlend);
+                Add(Target.DestBlend);
+                Add(Target.BlendOp);
+                Add(Target.SrcBlendAlpha);
+                Add(Target.DestBlendAlpha);
+                Add(Target.BlendOpAlpha);
+                Add(Target.LogicOp);
+                Add(Target.RenderTargetWriteMask);
+            }
+        }
+
+        void AddStencilOp(const D3D12_DEPTH_STENCILOP_DESC& Op)
+        {
+            Add(Op.StencilFailOp);
+            Add(Op.StencilDepthFailOp);
+            Add(Op.StencilPassOp);
+            Add(Op.StencilFunc);
+        }
+
+        void AddDepthStencilState(const D3D12_DEPTH_STENCIL_DESC& DepthStencil)
+        {
+            Add(DepthStencil.DepthEnable);
+            Add(DepthStencil.DepthWriteMask);
+            Add(DepthStencil.DepthFunc);
+            Add(DepthStencil.StencilEnable);
+            Add(DepthStencil.StencilReadMask);
+            Add(DepthStencil.StencilWriteMask);
+            AddStencilOp(DepthStencil.FrontFace);
+            AddStencilOp(DepthStencil.BackFace);
+        }
+
+        void AddInputLayout(const D3D12_INPUT_LAYOUT_DESC& Layout)
+        {
+            Add(Layout.NumElements);
+            for (UINT Index = 0; Index < Layout.NumElements; ++Index)
+            {
+                const D3D12_INPUT_ELEMENT_DESC& Element = Layout.pInputElementDescs[Index];
+                if (Element.SemanticName)
+                {
+                    AddBytes(Element.SemanticName, std::strlen(Element.SemanticName) + 1);
+                }
+                Add(Element.SemanticIndex);
+                Add(Element.Format);
+                Add(Element.InputSlot);
+                Add(Element.AlignedByteOffset);
+                Add(Element.InputSlotClass);
+                Add(Element.InstanceDataStepRate);
+            }
+        }
+    };
+
+    std::wstring MakePipelineName(wchar_t Prefix, uint64 Hash)
+    {
+        wchar_t Buffer[24] = {};
+        std::swprintf(Buffer, _countof(Buffer), L"%c%016llX", Prefix, static_cast<unsigned long long>(Hash));
+        return Buffer;
+    }
+}
+
+bool FDX12PipelineCache::Initialize(ID3D12Device* InDevice, IDXGIAdapter4* Adapter, const std::filesystem::path& InCachePath)
+{
+    Device = InDevice;
+    CachePath = InCachePath;
+    if (!Device || !Adapter)
+    {
+        return false;
+    }
+
+    if (FAILED(Device->QueryInterface(IID_PPV_ARGS(Device1.GetAddressOf()))))
+    {
+        LogWarning("ID3D12Device1 unavailable, pipeline cache disabled");
+        return false;
+    }
+
+    D3D12_FEATURE_DATA_SHADER_CACHE ShaderCache = {};
+    if (FAILED(Device->CheckFeatureSupport(D3D12_FEATURE_SHADER_CACHE, &ShaderCache, sizeof(ShaderCache)))
+        || (ShaderCache.SupportFlags & D3D12_SHADER_CACHE_SUPPORT_LIBRARY) == 0)
+    {
+        LogInfo("Pipeline libraries not supported by the driver, pipeline cache disabled");
+        return false;
+    }
+
+    DXGI_ADAPTER_DESC1 AdapterDesc = {};
+    Adapter->GetDesc1(&AdapterDesc);
+    AdapterHeader.Magic = PipelineCacheMagic;
+    AdapterHeader.Version = PipelineCacheVersion;
+    AdapterHeader.VendorId = AdapterDesc.VendorId;
+    AdapterHeader.DeviceId = AdapterDesc.DeviceId;
+    AdapterHeader.SubSysId = AdapterDesc.SubSysId;
+    AdapterHeader.Revision = AdapterDesc.Revision;
+
+    LARGE_INTEGER DriverVersion = {};
+    if (SUCCEEDED(Adapter->CheckInterfaceSupport(__uuidof(IDXGIDevice), &DriverVersion)))
+    {
+        AdapterHeader.DriverVersion = static_cast<uint64>(DriverVersion.QuadPart);
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    std::ifstream File(CachePath, std::ios::binary);
+    if (File)
+    {
+        FFileHeader Header;
+        File.read(reinterpret_cast<char*>(&Header), sizeof(Header));
+
+        const bool bMatches = File
+            && Header.Magic == AdapterHeader.Magic
+            && Header.Version == AdapterHeader.Version
+            && Header.VendorId == AdapterHeader.VendorId
+            && Header.DeviceId == AdapterHeader.DeviceId
+            && Header.SubSysId == AdapterHeader.SubSysId
+            && Header.Revision == AdapterHeader.Revision
+            && Header.DriverVersion == AdapterHeader.DriverVersion;
+
+        if (bMatches)
+        {
+            LibraryBlob.resize(static_cast<size_t>(Header.BlobSize));
+            File.read(reinterpret_cast<char*>(LibraryBlob.data()), static_cast<std::streamsize>(LibraryBlob.size()));
+            if (!File || !CreateLibrary(LibraryBlob.data(), LibraryBlob.size()))
+            {
+                LogWarning("Pipeline cache file is unreadable, starting with an empty cache");
+                LibraryBlob.clear();
+            }
+        }
+        else
+        {
+            LogInfo("Pipeline cache was written for a different adapter or driver, discarding it");
+        }
+    }
+
+    if (!Library && !CreateLibrary(nullptr, 0))
+    {
+        LogWarning("Failed to create pipeline library, pipeline cache disabled");
+        return false;
+    }
+
+    LogInfo("Pipeline cache: " + CachePath.u8string() + (LibraryBlob.empty() ? " (empty)" : " (loaded " + std::to_string(LibraryBlob.size() / 1024) + " KB)"));
+    return true;
+}
+
+bool FDX12PipelineCache::CreateLibrary(const void* BlobData, SIZE_T BlobSize)
+{
+    const HRESULT Result = Device1->CreatePipelineLibrary(BlobData, BlobSize, IID_PPV_ARGS(Library.ReleaseAndGetAddressOf()));
+    if (FAILED(Result))
+    {
+        if (Result == D3D12_ERROR_DRIVER_VERSION_MISMATCH || Result == D3D12_ERROR_ADAPTER_NOT_FOUND)
+        {
+            LogInfo("Pipeline cache is stale for this driver, discarding it");
+        }
+        Library.Reset();
+        return false;
+    }
+
+    return true;
+}
+
+HRESULT FDX12PipelineCache::CreateRootSignature(const void* BlobData, SIZE_T BlobSize, ID3D12RootSignature** OutRootSignature)
+{
+    FPipelineHasher Hasher;
+    Hasher.AddBytes(BlobData, BlobSize);
+
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        auto It = SessionRootSignatures.find(Hasher.Value);
+        if (It != SessionRootSignatures.end())
+        {
+            *OutRootSignature = It->second.Get();
+            (*OutRootSignature)->AddRef();
+            return S_OK;
+        }
+    }
+
+    const HRESULT Result = Device->CreateRootSignature(0, BlobData, BlobSize, IID_PPV_ARGS(OutRootSignature));
+    if (SUCCEEDED(Result))
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        RootSignatureHashes[*OutRootSignature] = Hasher.Value;
+        SessionRootSignatures.emplace(Hasher.Value, *OutRootSignature);
+    }
+    return Result;
+}
+
+bool FDX12PipelineCache::FindRootSignatureHash(ID3D12RootSignature* RootSignature, uint64& OutHash) const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto It = RootSignatureHashes.find(RootSignature);
+    if (It == RootSignatureHashes.end())
+    {
+        return false;
+    }
+
+    OutHash = It->second;
+    return true;
+}
+
+HRESULT FDX12PipelineCache::CreateGraphicsPipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& Desc, ID3D12PipelineState** OutPipeline)
+{
+    uint64 RootSignatureHash = 0;
+    if (!FindRootSignatureHash(Desc.pRootSignature, RootSignatureHash))
+    {
+        return Device->CreateGraphicsPipelineState(&Desc, IID_PPV_ARGS(OutPipeline));
+    }
+
+    FPipelineHasher Hasher;
+    Hasher.Add(RootSignatureHash);
+    Hasher.AddBytecode(Desc.VS);
+    Hasher.AddBytecode(Desc.PS);
+    Hasher.AddBytecode(Desc.DS);
+    Hasher.AddBytecode(Desc.HS);
+    Hasher.AddBytecode(Desc.GS);
+    Hasher.Add(Desc.StreamOutput.NumEntries);
+    Hasher.AddBlendState(Desc.BlendState);
+    Hasher.Add(Desc.SampleMask);
+    Hasher.Add(Desc.RasterizerState);
+    Hasher.AddDepthStencilState(Desc.DepthStencilState);
+    Hasher.AddInputLayout(Desc.InputLayout);
+    Hasher.Add(Desc.IBStripCutValue);
+    Hasher.Add(Desc.PrimitiveTopologyType);
+    Hasher.Add(Desc.NumRenderTargets);
+    Hasher.Add(Desc.RTVFormats);
+    Hasher.Add(Desc.DSVFormat);
+    Hasher.Add(Desc.SampleDesc);
+    Hasher.Add(Desc.NodeMask);
+    Hasher.Add(Desc.Flags);
+
+    const std::wstring Name = MakePipelineName(L'G', Hasher.Value);
+    if (SUCCEEDED(FindOrLoad(Name, &Desc, nullptr, OutPipeline)))
+    {
+        return S_OK;
+    }
+
+    const HRESULT Result = Device->CreateGraphicsPipelineState(&Desc, IID_PPV_ARGS(OutPipeline));
+    if (SUCCEEDED(Result))
+    {
+        Store(Name, *OutPipeline, &Desc, nullptr);
+    }
+    return Result;
+}
+
+HRESULT FDX12PipelineCache::CreateComputePipelineState(const D3D12_COMPUTE_PIPELINE_STATE_DESC& Desc, ID3D12PipelineState** OutPipeline)
+{
+    uint64 RootSignatureHash = 0;
+    if (!FindRootSignatureHash(Desc.pRootSignature, RootSignatureHash))
+    {
+        return Device->CreateComputePipelineState(&Desc, IID_PPV_ARGS(OutPipeline));
+    }
+
+    FPipelineHasher Hasher;
+    Hasher.Add(RootSignatureHash);
+    Hasher.AddBytecode(Desc.CS);
+    Hasher.Add(Desc.NodeMask);
+    Hasher.Add(Desc.Flags);
+
+    const std::wstring Name = MakePipelineName(L'C', Hasher.Value);
+    if (SUCCEEDED(FindOrLoad(Name, nullptr, &Desc, OutPipeline)))
+    {
+        return S_OK;
+    }
+
+    const HRESULT Result = Device->CreateComputePipelineState(&Desc, IID_PPV_ARGS(OutPipeline));
+    if (SUCCEEDED(Result))
+    {
+        Store(Name, *OutPipeline, nullptr, &Desc);
+    }
+    return Result;
+}
+
+HRESULT FDX12PipelineCache::FindOrLoad(
+    const std::wstring& Name,
+    const D3D12_GRAPHICS_PIPELINE_STATE_DESC* GraphicsDesc,
+    const D3D12_COMPUTE_PIPELINE_STATE_DESC* ComputeDesc,
+    ID3D12PipelineState** OutPipeline)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    auto It = SessionPipelines.find(Name);
+    if (It != SessionPipelines.end())
+    {
+        return It->second.Pipeline.CopyTo(OutPipeline);
+    }
+
+    if (!Library)
+    {
+        return E_FAIL;
+    }
+
+    ComPtr<ID3D12PipelineState> Pipeline;
+    const HRESULT Result = GraphicsDesc
+        ? Library->LoadGraphicsPipeline(Name.c_str(), GraphicsDesc, IID_PPV_ARGS(Pipeline.GetAddressOf()))
+        : Library->LoadComputePipeline(Name.c_str(), ComputeDesc, IID_PPV_ARGS(Pipeline.GetAddressOf()));
+    if (FAILED(Result))
+    {
+        ++LibraryMisses;
+        return Result;
+    }
+
+    ++LibraryHits;
+    SessionPipelines[Name] = MakeSessionPipeline(Pipeline.Get(), GraphicsDesc, ComputeDesc);
+    return Pipeline.CopyTo(OutPipeline);
+}
+
+FDX12PipelineCache::FSessionPipeline FDX12PipelineCache::MakeSessionPipeline(
+    ID3D12PipelineState* Pipeline,
+    const D3D12_GRAPHICS_PIPELINE_STATE_DESC* GraphicsDesc,
+    const D3D12_COMPUTE_PIPELINE_STATE_DESC* ComputeDesc)
+{
+    FSessionPipeline Entry;
+    Entry.Pipeline = Pipeline;
+    if (GraphicsDesc)
+    {
+        Entry.Graphics = std::make_unique<FGraphicsDescCopy>();
+        Entry.Graphics->Assign(*GraphicsDesc);
+    }
+    else if (ComputeDesc)
+    {
+        Entry.Compute = std::make_unique<FComputeDescCopy>();
+        Entry.Compute->Assign(*ComputeDesc);
+    }
+    return Entry;
+}
+
+void FDX12PipelineCache::Store(
+    const std::wstring& Name,
+    ID3D12PipelineState* Pipeline,
+    const D3D12_GRAPHICS_PIPELINE_STATE_DESC* GraphicsDesc,
+    const D3D12_COMPUTE_PIPELINE_STATE_DESC* ComputeDesc)
+{
+    FSessionPipeline Entry = MakeSessionPipeline(Pipeline, GraphicsDesc, ComputeDesc);
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (!SessionPipelines.emplace(Name, std::move(Entry)).second || !Library)
+    {
+        return;
+    }
+
+    // Fails when the name exists with a description that no longer matches (e.g. a changed root signature).
+    if (FAILED(Library->StorePipeline(Name.c_str(), Pipeline)))
+    {
+        bRebuildOnSave = true;
+    }
+    bDirty = true;
+}
+
+void FDX12PipelineCache::FGraphicsDescCopy::Assign(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& Source)
+{
+    Desc = Source;
+    RootSignature = Source.pRootSignature;
+
+    const D3D12_SHADER_BYTECODE* Stages[] = { &Desc.VS, &Desc.PS, &Desc.DS, &Desc.HS, &Desc.GS };
+    for (size_t Stage = 0; Stage < _countof(Stages); ++Stage)
+    {
+        const uint8* Bytes = static_cast<const uint8*>(Stages[Stage]->pShaderBytecode);
+        ByteCodes[Stage].assign(Bytes, Bytes ? Bytes + Stages[Stage]->BytecodeLength : Bytes);
+    }
+    PointAtByteCodes();
+
+    InputElements.assign(Source.InputLayout.pInputElementDescs, Source.InputLayout.pInputElementDescs + Source.InputLayout.NumElements);
+    SemanticNames.clear();
+    SemanticNames.reserve(InputElements.size());
+    for (const D3D12_INPUT_ELEMENT_DESC& Element : InputElements)
+    {
+        SemanticNames.emplace_back(Element.SemanticName ? Element.SemanticName : "");
+    }
+    for (size_t Index = 0; Index < InputElements.size(); ++Index)
+    {
+        InputElements[Index].SemanticName = SemanticNames[Index].c_str();
+    }
+    Desc.InputLayout = { InputElements.empty() ? nullptr : InputElements.data(), static_cast<UINT>(InputElements.size()) };
+
+    Desc.StreamOutput = {};
+    Desc.CachedPSO = {};
+}
+
+void FDX12PipelineCache::FGraphicsDescCopy::PointAtByteCodes()
+{
+    D3D12_SHADER_BYTECODE* Stages[] = { &Desc.VS, &Desc.PS, &Desc.DS, &Desc.HS, &Desc.GS };
+    for (size_t Stage = 0; Stage < _countof(Stages); ++Stage)
+    {
+        *Stages[Stage] = { ByteCodes[Stage].empty() ? nullptr : ByteCodes[Stage].data(), ByteCodes[Stage].size() };
+    }
+}
+
+void FDX12PipelineCache::FComputeDescCopy::Assign(const D3D12_COMPUTE_PIPELINE_STATE_DESC& Source)
+{
+    Desc = Source;
+    RootSignature = Source.pRootSignature;
+
+    const uint8* Bytes = static_cast<const uint8*>(Source.CS.pShaderBytecode);
+    ByteCode.assign(Bytes, Bytes ? Bytes + Source.CS.BytecodeLength : Bytes);
+    Desc.CS = { ByteCode.empty() ? nullptr : ByteCode.data(), ByteCode.size() };
+    Desc.CachedPSO = {};
+}
+
+uint32 FDX12PipelineCache::PrecreateWithReplacedShaders(const std::vector<FDX12ShaderReplacement>& Replacements)
+{
+    const auto Replace = [&Replacements](std::vector<uint8>& ByteCode)
+    {
+        for (const FDX12ShaderReplacement& Replacement : Replacements)
+        {
+            if (!ByteCode.empty() && ByteCode == Replacement.OldByteCode)
+            {
+                ByteCode = Replacement.NewByteCode;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::vector<std::unique_ptr<FGraphicsDescCopy>> GraphicsDescs;
+    std::vector<std::unique_ptr<FComputeDescCopy>> ComputeDescs;
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        for (const auto& Entry : SessionPipelines)
+        {
+            if (Entry.second.Graphics)
+            {
+                std::unique_ptr<FGraphicsDescCopy> Copy = std::make_unique<FGraphicsDescCopy>();
+                Copy->Assign(Entry.second.Graphics->Desc);
+
+                bool bReplaced = false;
+                for (std::vector<uint8>& ByteCode : Copy->ByteCodes)
+                {
+                    bReplaced |= Replace(ByteCode);
+                }
+                if (bReplaced)
+                {
+                    Copy->PointAtByteCodes();
+                    GraphicsDescs.push_back(std::move(Copy));
+                }
+            }
+            else if (Entry.second.Compute)
+            {
+                std::unique_ptr<FComputeDescCopy> Copy = std::make_unique<FComputeDescCopy>();
+                Copy->Assign(Entry.second.Compute->Desc);
+                if (Replace(Copy->ByteCode))
+                {
+                    Copy->Desc.CS = { Copy->ByteCode.data(), Copy->ByteCode.size() };
+                    ComputeDescs.push_back(std::move(Copy));
+                }
+            }
+        }
+    }
+
+    uint32 CreatedCount = 0;
+    for (const std::unique_ptr<FGraphicsDescCopy>& Copy : GraphicsDescs)
+    {
+        ComPtr<ID3D12PipelineState> Pipeline;
+        CreatedCount += SUCCEEDED(CreateGraphicsPipelineState(Copy->Desc, Pipeline.GetAddressOf())) ? 1u : 0u;
+    }
+    for (const std::unique_ptr<FComputeDescCopy>& Copy : ComputeDescs)
+    {
+        ComPtr<ID3D12PipelineState> Pipeline;
+        CreatedCount += SUCCEEDED(CreateComputePipelineState(Copy->Desc, Pipeline.GetAddressOf())) ? 1u : 0u;
+    }
+    return CreatedCount;
+}
+
+bool FDX12PipelineCache::Save()
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (!Library || !bDirty)
+    {
+        return true;
+    }
+
+    if (bRebuildOnSave)
+    {
+        ComPtr<ID3D12PipelineLibrary> FreshLibrary;
+        if (FAILED(Device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(FreshLibrary.GetAddressOf()))))
+        {
+            LogWarning("Failed to rebuild pipeline library");
+            return false;
+        }
+
+        for (const auto& Entry : SessionPipelines)
+        {
+            FreshLibrary->StorePipeline(Entry.first.c_str(), Entry.second.Pipeline.Get());
+        }
+
+        Library = FreshLibrary;
+        LibraryBlob.clear();
+        bRebuildOnSave = false;
+    }
+
+    std::vector<uint8> Serialized(Library->GetSerializedSize());
+    if (Serialized.empty() || FAILED(Library->Serialize(Serialized.data(), Serialized.size())))
+    {
+        LogWarning("Failed to serialize pipeline library");
+        return false;
+    }
+
+    FFileHeader Header = AdapterHeader;
+    Header.BlobSize = Serialized.size();
+
+    // Write beside the cache and swap it in, so an interrupted save never leaves a truncated file.
+    std::filesystem::path TempPath = CachePath;
+    TempPath += L".tmp";
+    {
+        std::ofstream File(TempPath, std::ios::binary | std::ios::trunc);
+        File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+        File.write(reinterpret_cast<const char*>(Serialized.data()), static_cast<std::streamsize>(Serialized.size()));
+        if (!File)
+        {
+            LogWarning("Failed to write pipeline cache: " + TempPath.u8string());
+            return false;
+        }
+    }
+
+    std::error_code Error;
+    std::filesystem::rename(TempPath, CachePath, Error);
+    if (Error)
+    {
+        LogWarning("Failed to replace pipeline cache: " + Error.message());
+        return false;
+    }
+
+    bDirty = false;
+    LogInfo("Saved pipeline cache: " + std::to_string(SessionPipelines.size()) + " pipelines, "
+        + std::to_string(Serialized.size() / 1024) + " KB (" + std::to_string(LibraryHits) + " loaded, "
+        + std::to_string(LibraryMisses) + " compiled)");
+    return true;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "DX12Commons.h"
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// A shader whose source changed: pipelines built with OldByteCode get a twin built with NewByteCode.
+struct FDX12ShaderReplacement
+{
+    std::vector<uint8> OldByteCode;
+    std::vector<uint8> NewByteCode;
+};
+
+// Pipeline creation through an ID3D12PipelineLibrary that is persisted to disk, so driver PSO
+// compilation only happens once per adapter and driver version.
+//  - Pipelines are keyed by a hash of their shader bytecode, root signature blob and fixed-function
+//    state. Root signatures must be created through CreateRootSignature so their blob hash is known;
+//    pipelines using any other root signature bypass the cache.
+//  - Pipelines created in this session are kept by key, so renderer rebuilds reuse the same objects.
+//    This also keeps replaced pipelines alive for frames still in flight after a shader hot reload.
+//  - Root signatures are kept by blob hash the same way, so a rebuilt renderer gets the objects its
+//    predecessor used and its pipelines find theirs without creating anything.
+//  - The file header records the adapter and driver version; a mismatch discards the file.
+// Without pipeline library support only the session map is used. All methods are thread-safe.
+class FDX12PipelineCache
+{
+public:
+    FDX12PipelineCache() = default;
+    FDX12PipelineCache(const FDX12PipelineCache&) = delete;
+    FDX12PipelineCache& operator=(const FDX12PipelineCache&) = delete;
+
+    bool Initialize(ID3D12Device* InDevice, IDXGIAdapter4* Adapter, const std::filesystem::path& InCachePath);
+
+    HRESULT CreateRootSignature(const void* BlobData, SIZE_T BlobSize, ID3D12RootSignature** OutRootSignature);
+    HRESULT CreateGraphicsPipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& Desc, ID3D12PipelineState** OutPipeline);
+    HRESULT CreateComputePipelineState(const D3D12_COMPUTE_PIPELINE_STATE_DESC& Desc, ID3D12PipelineState** OutPipeline);
+
+    // Creates, for every session pipeline that uses a replaced shader, the same pipeline with the new
+    // bytecode. Meant for a background thread; the renderer's own rebuild then finds them by key.
+    uint32 PrecreateWithReplacedShaders(const std::vector<FDX12ShaderReplacement>& Replacements);
+
+    // Writes the library to disk when pipelines were added since the last save.
+    bool Save();
+
+    bool IsLibraryAvailable() const { return Library != nullptr; }
+
+private:
+    struct FFileHeader
+    {
+        uint32 Magic = 0;
+        uint32 Version = 0;
+        uint32 VendorId = 0;
+        uint32 DeviceId = 0;
+        uint32 SubSysId = 0;
+        uint32 Revision = 0;
+        uint64 DriverVersion = 0;
+        uint64 BlobSize = 0;
+    };
+
+    // Owning copies of a creation desc; the desc's pointers refer into the copy itself.
+    struct FGraphicsDescCopy
+    {
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC Desc = {};
+        ComPtr<ID3D12RootSignature> RootSignature;
+        std::vector<uint8> ByteCodes[5];
+        std::vector<D3D12_INPUT_ELEMENT_DESC> InputElements;
+        std::vector<std::string> SemanticNames;
+
+        void Assign(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& Source);
+        void PointAtByteCodes();
+    };
+
+    struct FComputeDescCopy
+    {
+        D3D12_COMPUTE_PIPELINE_STATE_DESC Desc = {};
+        ComPtr<ID3D12RootSignature> RootSignature;
+        std::vector<uint8> ByteCode;
+
+        void Assign(const D3D12_COMPUTE_PIPELINE_STATE_DESC& Source);
+    };
+
+    struct FSessionPipeline
+    {
+        ComPtr<ID3D12PipelineState> Pipeline;
+        std::unique_ptr<FGraphicsDescCopy> Graphics;
+        std::unique_ptr<FComputeDescCopy> Compute;
+    };
+
+    bool FindRootSignatureHash(ID3D12RootSignature* RootSignature, uint64& OutHash) const;
+    HRESULT FindOrLoad(const std::wstring& Name, const D3D12_GRAPHICS_PIPELINE_STATE_DESC* GraphicsDesc,
+        const D3D12_COMPUTE_PIPELINE_STATE_DESC* ComputeDesc, ID3D12PipelineState** OutPipeline);
+    static FSessionPipeline MakeSessionPipeline(ID3D12PipelineState* Pipeline,
+        const D3D12_GRAPHICS_PIPELINE_STATE_DESC* GraphicsDesc, const D3D12_COMPUTE_PIPELINE_STATE_DESC* ComputeDesc);
+    void Store(const std::wstring& Name, ID3D12PipelineState* Pipeline,
+        const D3D12_GRAPHICS_PIPELINE_STATE_DESC* GraphicsDesc, const D3D12_COMPUTE_PIPELINE_STATE_DESC* ComputeDesc);
+    bool CreateLibrary(const void* BlobData, SIZE_T BlobSize);
+
+    mutable std::mutex Mutex;
+    ID3D12Device* Device = nullptr;
+    ComPtr<ID3D12Device1> Device1;
+    ComPtr<ID3D12PipelineLibrary> Library;
+    std::filesystem::path CachePath;
+    FFileHeader AdapterHeader;
+
+    // The library references this blob for its whole lifetime.
+    std::vector<uint8> LibraryBlob;
+    std::unordered_map<ID3D12RootSignature*, uint64> RootSignatureHashes;
+    std::unordered_map<uint64, ComPtr<ID3D12RootSignature>> SessionRootSignatures;
+    std::unordered_map<std::wstring, FSessionPipeline> SessionPipelines;
+
+    bool bDirty = false;
+    // Set when a stored entry no longer matches its description; Save then writes a fresh library.
+    bool bRebuildOnSave = false;
+    uint32 LibraryHits = 0;
+    uint32 LibraryMisses = 0;
+};
@@ -1,4 +1,5 @@
 #include "DX12Resource.h"
+#include "DX12MemoryTracker.h"
 
 bool FDX12Resource::InitializeBuffer(ID3D12Device* Device, uint64_t Size, D3D12_HEAP_TYPE HeapType, D3D12_RESOURCE_FLAGS Flags, D3D12_RESOURCE_STATES InitialState)
 {
@@ -27,7 +28,10 @@ bool FDX12Resource::InitializeBuffer(ID3D12Device* Device, uint64_t Size, D3D12_
     BufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
     BufferDesc.Flags = Flags;
 
-    HR_CHECK(Device->CreateCommittedResource(&HeapProps, D3D12_HEAP_FLAG_NONE, &BufferDesc, InitialState, nullptr, IID_PPV_ARGS(&Resource)));
+    const EGpuMemoryCategory Category = HeapType == D3D12_HEAP_TYPE_UPLOAD ? EGpuMemoryCategory::Upload
+        : HeapType == D3D12_HEAP_TYPE_READBACK ? EGpuMemoryCategory::Readback
+        : EGpuMemoryCategory::Buffer;
+    HR_CHECK(FDX12MemoryTracker::Get().CreateCommittedResource(Device, Category, &HeapProps, D3D12_HEAP_FLAG_NONE, &BufferDesc, InitialState, nullptr, IID_PPV_ARGS(&Resource)));
     return true;
 }
 
@@ -45,6 +49,6 @@ bool FDX12Resource::InitializeTexture2D(ID3D12Device* Device, const D3D12_RESOUR
     HeapProps.CreationNodeMask = 1;
     HeapProps.VisibleNodeMask = 1;
 
-    HR_CHECK(Device->CreateCommittedResource(&HeapProps, D3D12_HEAP_FLAG_NONE, &Desc, InitialState, nullptr, IID_PPV_ARGS(&Resource)));
+    HR_CHECK(FDX12MemoryTracker::Get().CreateCommittedResource(Device, EGpuMemoryCategory::Texture, &HeapProps, D3D12_HEAP_FLAG_NONE, &Desc, InitialState, nullptr, IID_PPV_ARGS(&Resource)));
     return true;
 }
@@ -2,12 +2,16 @@
 #include "DX12Device.h"
 #include "DX12CommandQueue.h"
 #include "../Core/Logger.h"
+#include <algorithm>
 #include <string>
 
 FDX12SwapChain::FDX12SwapChain()
-    : RTVDescriptorSize(0)
+    : FrameLatencyWaitable(nullptr)
+    , RTVDescriptorSize(0)
     , BackBufferFormat(DXGI_FORMAT_R8G8B8A8_UNORM)
     , BufferCount(3)
+    , MaxFrameLatency(0)
+    , SwapChainFlags(0)
     , bAllowTearing(false)
 {
 }
@@ -15,13 +19,21 @@ FDX12SwapChain::FDX12SwapChain()
 FDX12SwapChain::~FDX12SwapChain()
 {
     ReleaseBuffers();
+    if (FrameLatencyWaitable)
+    {
+        CloseHandle(FrameLatencyWaitable);
+    }
 }
 
-bool FDX12SwapChain::Initialize(FDX12Device* InDevice, HWND WindowHandle, uint32 Width, uint32 Height, uint32 InBufferCount)
+bool FDX12SwapChain::Initialize(FDX12Device* InDevice, HWND WindowHandle, uint32 Width, uint32 Height, uint32 InBufferCount, uint32 InMaxFrameLatency)
 {
     BufferCount = InBufferCount;
+    // More queued presents than back buffers would never be reached.
+    MaxFrameLatency = (std::min)(InMaxFrameLatency, InBufferCount);
     BackBufferFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
     bAllowTearing = InDevice->IsTearingSupported();
+    SwapChainFlags = (bAllowTearing ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0)
+        | (MaxFrameLatency > 0 ? DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT : 0);
 
     if (!CreateSwapChain(InDevice, WindowHandle, Width, Height))
     {
@@ -38,7 +50,6 @@ bool FDX12SwapChain::Resize(FDX12Device* InDevice, uint32 Width, uint32 Height)
 
     if (SwapChain)
     {
-        const UINT SwapChainFlags = bAllowTearing ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0;
         HR_CHECK(SwapChain->ResizeBuffers(BufferCount, Width, Height, BackBufferFormat, SwapChainFlags));
     }
 
@@ -47,6 +58,11 @@ bool FDX12SwapChain::Resize(FDX12Device* InDevice, uint32 Width, uint32 Height)
     return CreateRTVs(InDevice);
 }
 
+bool FDX12SwapChain::WaitForFrameLatency(DWORD TimeoutMs) const
+{
+    return FrameLatencyWaitable && WaitForSingleObjectEx(FrameLatencyWaitable, TimeoutMs, TRUE) == WAIT_OBJECT_0;
+}
+
 bool FDX12SwapChain::CreateSwapChain(FDX12Device* InDevice, HWND WindowHandle, uint32 Width, uint32 Height)
 {
     DXGI_SWAP_CHAIN_DESC1 SwapChainDesc = {};
@@ -54,26 +70,48 @@ bool FDX12SwapChain::CreateSwapChain(FDX12Device* InDevice, HWND WindowHandle, u
     SwapChainDesc.Width = Width;
     SwapChainDesc.Height = Height;
     SwapChainDesc.Format = BackBufferFormat;
-    SwapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+    // Shader input lets the forward renderer build its shading rate image from the finished frame,
+    // and unordered access lets the deferred renderer's fused post kernel write it.
+    SwapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT | DXGI_USAGE_SHADER_INPUT | DXGI_USAGE_UNORDERED_ACCESS;
     SwapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
     SwapChainDesc.SampleDesc.Count = 1;
-    SwapChainDesc.Flags = bAllowTearing ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0;
+    SwapChainDesc.Flags = SwapChainFlags;
 
     ComPtr<IDXGISwapChain1> TempSwapChain;
-    HR_CHECK(InDevice->GetFactory()->CreateSwapChainForHwnd(
+    HRESULT CreateResult = InDevice->GetFactory()->CreateSwapChainForHwnd(
         InDevice->GetGraphicsQueue()->GetD3DQueue(),
         WindowHandle,
         &SwapChainDesc,
         nullptr,
         nullptr,
-        TempSwapChain.GetAddressOf()));
+        TempSwapChain.GetAddressOf());
+    if (FAILED(CreateResult))
+    {
+        // Renderers check the back buffer's flags before writing it from compute.
+        LogWarning("Swap chain without unordered access; fused post-processing is unavailable");
+        SwapChainDesc.BufferUsage &= ~DXGI_USAGE_UNORDERED_ACCESS;
+        HR_CHECK(InDevice->GetFactory()->CreateSwapChainForHwnd(
+            InDevice->GetGraphicsQueue()->GetD3DQueue(),
+            WindowHandle,
+            &SwapChainDesc,
+            nullptr,
+            nullptr,
+            TempSwapChain.GetAddressOf()));
+    }
 
     HR_CHECK(InDevice->GetFactory()->MakeWindowAssociation(WindowHandle, DXGI_MWA_NO_ALT_ENTER));
     HR_CHECK(TempSwapChain.As(&SwapChain));
 
+    if (MaxFrameLatency > 0)
+    {
+        HR_CHECK(SwapChain->SetMaximumFrameLatency(MaxFrameLatency));
+        FrameLatencyWaitable = SwapChain->GetFrameLatencyWaitableObject();
+    }
+
     LogInfo(std::string("SwapChain - BufferCount: ") + std::to_string(BufferCount)
         + ", Format: DXGI_FORMAT_R8G8B8A8_UNORM"
-        + (bAllowTearing ? ", DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING On" : ", TEARING Off"));
+        + (bAllowTearing ? ", DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING On" : ", TEARING Off")
+        + (MaxFrameLatency > 0 ? ", MaxFrameLatency: " + std::to_string(MaxFrameLatency) : std::string(", Latency waitable Off")));
 
     return true;
 }
@@ -10,9 +10,15 @@ public:
     FDX12SwapChain();
     ~FDX12SwapChain();
 
-    bool Initialize(FDX12Device* InDevice, HWND WindowHandle, uint32 Width, uint32 Height, uint32 BufferCount = 3);
+    // MaxFrameLatency > 0 creates the swap chain with a frame latency waitable object allowing that many queued presents.
+    bool Initialize(FDX12Device* InDevice, HWND WindowHandle, uint32 Width, uint32 Height, uint32 BufferCount = 3, uint32 MaxFrameLatency = 0);
     bool Resize(FDX12Device* InDevice, uint32 Width, uint32 Height);
 
+    // Blocks until the swap chain can queue another present; returns false on timeout or without a waitable object.
+    bool WaitForFrameLatency(DWORD TimeoutMs = 1000) const;
+    bool HasFrameLatencyWaitable() const { return FrameLatencyWaitable != nullptr; }
+    uint32 GetMaxFrameLatency() const { return MaxFrameLatency; }
+
     IDXGISwapChain4* GetSwapChain() const { return SwapChain.Get(); }
     uint32 GetCurrentBackBufferIndex() const { return SwapChain ? SwapChain->GetCurrentBackBufferIndex() : 0; }
     uint32 GetBackBufferCount() const { return BufferCount; }
@@ -30,6 +36,7 @@ private:
 
 private:
     ComPtr<IDXGISwapChain4> SwapChain;
+    HANDLE FrameLatencyWaitable;
     std::vector<ComPtr<ID3D12Resource>> BackBuffers;
     std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> RTVHandles;
     std::vector<D3D12_RESOURCE_STATES> BackBufferStates;
@@ -39,6 +46,9 @@ private:
 
     DXGI_FORMAT BackBufferFormat;
     uint32 BufferCount;
+    uint32 MaxFrameLatency;
+    // Creation flags, which ResizeBuffers has to repeat.
+    UINT SwapChainFlags;
     bool bAllowTearing;
 };
 
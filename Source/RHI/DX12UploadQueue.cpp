@@ -0,0 +1,148 @@
+#include "DX12UploadQueue.h"
+#include "DX12CommandQueue.h"
+#include "../Core/Logger.h"
+
+bool FDX12UploadQueue::Initialize(ID3D12Device* InDevice, FDX12CommandQueue* InQueue, bool bInCopyQueue)
+{
+    Device = InDevice;
+    Queue = InQueue;
+    bCopyQueue = bInCopyQueue;
+    return Device != nullptr && Queue != nullptr;
+}
+
+D3D12_COMMAND_LIST_TYPE FDX12UploadQueue::GetCommandListType() const
+{
+    return bCopyQueue ? D3D12_COMMAND_LIST_TYPE_COPY : D3D12_COMMAND_LIST_TYPE_DIRECT;
+}
+
+bool FDX12UploadQueue::CreateCommandList(ComPtr<ID3D12CommandAllocator>& OutAllocator, ComPtr<ID3D12GraphicsCommandList>& OutCommandList) const
+{
+    if (!Device)
+    {
+        return false;
+    }
+
+    const D3D12_COMMAND_LIST_TYPE ListType = GetCommandListType();
+    if (FAILED(Device->CreateCommandAllocator(ListType, IID_PPV_ARGS(OutAllocator.ReleaseAndGetAddressOf()))))
+    {
+        LogError("Failed to create upload command allocator");
+        return false;
+    }
+
+    if (FAILED(Device->CreateCommandList(0, ListType, OutAllocator.Get(), nullptr, IID_PPV_ARGS(OutCommandList.ReleaseAndGetAddressOf()))))
+    {
+        LogError("Failed to create upload command list");
+        return false;
+    }
+
+    return true;
+}
+
+uint64 FDX12UploadQueue::Submit(uint32 NumCommandLists, ID3D12CommandList* const* CommandLists, std::vector<ComPtr<IUnknown>>&& KeepAlive)
+{
+    if (!Queue || NumCommandLists == 0)
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    Queue->ExecuteCommandLists(NumCommandLists, CommandLists);
+    const uint64 FenceValue = Queue->Signal();
+    LastSubmittedFenceValue = FenceValue;
+
+    FInFlightUpload Upload;
+    Upload.FenceValue = FenceValue;
+    Upload.KeepAlive = std::move(KeepAlive);
+    InFlightUploads.push_back(std::move(Upload));
+
+    // Drop staging memory of uploads that finished while this one was being recorded.
+    const uint64 CompletedValue = Queue->GetCompletedFenceValue();
+    while (!InFlightUploads.empty() && InFlightUploads.front().FenceValue <= CompletedValue)
+    {
+        InFlightUploads.pop_front();
+    }
+
+    return FenceValue;
+}
+
+uint64 FDX12UploadQueue::SubmitAfter(const FDX12CommandQueue& Producer, uint64 ProducerFenceValue)
+{
+    if (!Queue)
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    Queue->GpuWait(Producer, ProducerFenceValue);
+    LastSubmittedFenceValue = Queue->Signal();
+    return LastSubmittedFenceValue;
+}
+
+bool FDX12UploadQueue::IsComplete(uint64 FenceValue) const
+{
+    return !Queue || Queue->GetCompletedFenceValue() >= FenceValue;
+}
+
+uint64 FDX12UploadQueue::GetLastSubmittedFenceValue() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return LastSubmittedFenceValue;
+}
+
+bool FDX12UploadQueue::WaitOnGpu(FDX12CommandQueue& Consumer, uint64 FenceValue)
+{
+    // Submissions on a single queue already execute in order.
+    if (!Queue || &Consumer == Queue || FenceValue == 0 || IsComplete(FenceValue))
+    {
+        return false;
+    }
+
+    Consumer.GpuWait(*Queue, FenceValue);
+    return true;
+}
+
+void FDX12UploadQueue::WaitOnCpu(uint64 FenceValue)
+{
+    if (!Queue || FenceValue == 0)
+    {
+        return;
+    }
+
+    {
+        // The queue's fence event is shared, so CPU waits are serialized.
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Queue->Wait(FenceValue);
+    }
+    ReleaseCompleted();
+}
+
+void FDX12UploadQueue::Flush()
+{
+    if (!Queue)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Queue->Flush();
+    }
+    ReleaseCompleted();
+}
+
+void FDX12UploadQueue::ReleaseCompleted()
+{
+    if (!Queue)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    const uint64 CompletedValue = Queue->GetCompletedFenceValue();
+    while (!InFlightUploads.empty() && InFlightUploads.front().FenceValue <= CompletedValue)
+    {
+        InFlightUploads.pop_front();
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "DX12Commons.h"
+#include <deque>
+#include <mutex>
+
+class FDX12CommandQueue;
+
+// Submits asset upload command lists to the copy queue without stalling the graphics queue.
+// Each submission returns a fence value that callers poll, or hand to WaitOnGpu so a consuming
+// queue waits only when it actually needs the uploaded resources. Staging resources and command
+// allocators passed to Submit are kept alive until their fence completes.
+// Without a copy queue uploads fall back to the graphics queue with direct command lists.
+class FDX12UploadQueue
+{
+public:
+    FDX12UploadQueue() = default;
+    FDX12UploadQueue(const FDX12UploadQueue&) = delete;
+    FDX12UploadQueue& operator=(const FDX12UploadQueue&) = delete;
+
+    bool Initialize(ID3D12Device* InDevice, FDX12CommandQueue* InQueue, bool bInCopyQueue);
+
+    // Copy lists cannot transition resources into shader-visible states. Textures written on the
+    // copy queue decay to COMMON and are promoted implicitly on first read, so callers only
+    // record their final transition when this returns false.
+    bool IsCopyQueue() const { return bCopyQueue; }
+    D3D12_COMMAND_LIST_TYPE GetCommandListType() const;
+    FDX12CommandQueue* GetQueue() const { return Queue; }
+
+    // Creates an allocator and an open command list of GetCommandListType(). Thread-safe.
+    bool CreateCommandList(ComPtr<ID3D12CommandAllocator>& OutAllocator, ComPtr<ID3D12GraphicsCommandList>& OutCommandList) const;
+
+    // Executes closed command lists and signals the upload fence. KeepAlive objects are released
+    // once that fence completes.
+    uint64 Submit(uint32 NumCommandLists, ID3D12CommandList* const* CommandLists, std::vector<ComPtr<IUnknown>>&& KeepAlive);
+    // Makes the upload queue wait on the GPU until Producer reaches ProducerFenceValue and signals
+    // an upload fence covering that work, so consumers of uploads keep waiting on one fence.
+    uint64 SubmitAfter(const FDX12CommandQueue& Producer, uint64 ProducerFenceValue);
+
+    bool IsComplete(uint64 FenceValue) const;
+    uint64 GetLastSubmittedFenceValue() const;
+
+    // Makes Consumer wait on the GPU for FenceValue. Returns false without inserting a wait when
+    // the upload already completed or Consumer is the upload queue itself.
+    bool WaitOnGpu(FDX12CommandQueue& Consumer, uint64 FenceValue);
+    void WaitOnCpu(uint64 FenceValue);
+    void Flush();
+
+    void ReleaseCompleted();
+
+private:
+    struct FInFlightUpload
+    {
+        uint64 FenceValue = 0;
+        std::vector<ComPtr<IUnknown>> KeepAlive;
+    };
+
+    mutable std::mutex Mutex;
+    ID3D12Device*      Device = nullptr;
+    FDX12CommandQueue* Queue = nullptr;
+    bool               bCopyQueue = false;
+    uint64             LastSubmittedFenceValue = 0;
+    std::deque<FInFlightUpload> InFlightUploads;
+};
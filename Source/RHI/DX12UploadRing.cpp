@@ -0,0 +1,198 @@
+#include "DX12UploadRing.h"
+#include "DX12CommandQueue.h"
+#include "DX12MemoryTracker.h"
+#include "../Core/Logger.h"
+#include <algorithm>
+#include <string>
+
+namespace
+{
+    constexpr uint64 UploadRingGranularity = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+
+    uint64 AlignUp(uint64 Value, uint64 Alignment)
+    {
+        return (Value + Alignment - 1) & ~(Alignment - 1);
+    }
+}
+
+bool FDX12UploadRing::Initialize(ID3D12Device* InDevice, FDX12CommandQueue* InFenceQueue, uint64 InCapacity)
+{
+    Device = InDevice;
+    FenceQueue = InFenceQueue;
+    if (!Device || !FenceQueue)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return CreateBuffer(AlignUp((std::max)(InCapacity, UploadRingGranularity), UploadRingGranularity));
+}
+
+bool FDX12UploadRing::CreateBuffer(uint64 InCapacity)
+{
+    D3D12_HEAP_PROPERTIES UploadHeap = {};
+    UploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
+    UploadHeap.CreationNodeMask = 1;
+    UploadHeap.VisibleNodeMask = 1;
+
+    D3D12_RESOURCE_DESC BufferDesc = {};
+    BufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    BufferDesc.Width = InCapacity;
+    BufferDesc.Height = 1;
+    BufferDesc.DepthOrArraySize = 1;
+    BufferDesc.MipLevels = 1;
+    BufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+    BufferDesc.SampleDesc.Count = 1;
+    BufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+    ComPtr<ID3D12Resource> NewBuffer;
+    if (FAILED(FDX12MemoryTracker::Get().CreateCommittedResource(
+        Device,
+        EGpuMemoryCategory::Upload,
+        &UploadHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &BufferDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(NewBuffer.GetAddressOf()))))
+    {
+        LogError("Failed to create upload ring buffer (" + std::to_string(InCapacity) + " bytes)");
+        return false;
+    }
+    NewBuffer->SetName(L"UploadRing");
+
+    uint8* NewMappedData = nullptr;
+    D3D12_RANGE EmptyRange = { 0, 0 };
+    if (FAILED(NewBuffer->Map(0, &EmptyRange, reinterpret_cast<void**>(&NewMappedData))) || !NewMappedData)
+    {
+        LogError("Failed to map upload ring buffer");
+        return false;
+    }
+
+    Buffer = NewBuffer;
+    MappedData = NewMappedData;
+    BaseGpuAddress = Buffer->GetGPUVirtualAddress();
+    Capacity = InCapacity;
+    Head = 0;
+    Tail = 0;
+    FrameMarkers.clear();
+    return true;
+}
+
+bool FDX12UploadRing::TryAllocate(uint64 Size, uint64 Alignment, uint64& OutOffset)
+{
+    if (Size > Capacity)
+    {
+        return false;
+    }
+
+    uint64 Position = AlignUp(Head, Alignment);
+    uint64 PhysicalOffset = Position % Capacity;
+    if (PhysicalOffset + Size > Capacity)
+    {
+        // Never split an allocation across the end of the buffer; skip to the start instead.
+        Position += Capacity - PhysicalOffset;
+        PhysicalOffset = 0;
+    }
+
+    if (Position + Size - Tail > Capacity)
+    {
+        return false;
+    }
+
+    Head = Position + Size;
+    OutOffset = PhysicalOffset;
+    return true;
+}
+
+FDX12UploadAllocation FDX12UploadRing::Allocate(uint64 Size, uint64 Alignment)
+{
+    FDX12UploadAllocation Allocation;
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (!Buffer)
+    {
+        return Allocation;
+    }
+
+    Size = (std::max)(Size, static_cast<uint64>(1));
+    Alignment = (std::max)(Alignment, static_cast<uint64>(1));
+
+    uint64 Offset = 0;
+    bool bAllocated = TryAllocate(Size, Alignment, Offset);
+    if (!bAllocated)
+    {
+        Reclaim(FenceQueue->GetCompletedFenceValue());
+        bAllocated = TryAllocate(Size, Alignment, Offset);
+    }
+
+    if (!bAllocated)
+    {
+        const uint64 NewCapacity = AlignUp((std::max)(Capacity * 2, Size + Alignment), UploadRingGranularity);
+        LogWarning("Upload ring full, growing from " + std::to_string(Capacity) + " to " + std::to_string(NewCapacity) + " bytes");
+
+        ComPtr<ID3D12Resource> OldBuffer = Buffer;
+        if (!CreateBuffer(NewCapacity))
+        {
+            return Allocation;
+        }
+        ReplacedBuffers.push_back(OldBuffer);
+        bAllocated = TryAllocate(Size, Alignment, Offset);
+    }
+
+    if (!bAllocated)
+    {
+        return Allocation;
+    }
+
+    Allocation.Resource = Buffer.Get();
+    Allocation.Offset = Offset;
+    Allocation.Size = Size;
+    Allocation.CpuAddress = MappedData + Offset;
+    Allocation.GpuAddress = BaseGpuAddress + Offset;
+    return Allocation;
+}
+
+void FDX12UploadRing::EndFrame(uint64 FenceValue)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    FFrameMarker Marker;
+    Marker.FenceValue = FenceValue;
+    Marker.EndOffset = Head;
+    FrameMarkers.push_back(Marker);
+
+    for (ComPtr<ID3D12Resource>& Replaced : ReplacedBuffers)
+    {
+        FRetiredBuffer Retired;
+        Retired.Resource = Replaced;
+        Retired.FenceValue = FenceValue;
+        RetiredBuffers.push_back(Retired);
+    }
+    ReplacedBuffers.clear();
+
+    if (FenceQueue)
+    {
+        Reclaim(FenceQueue->GetCompletedFenceValue());
+    }
+}
+
+void FDX12UploadRing::Reclaim(uint64 CompletedFenceValue)
+{
+    while (!FrameMarkers.empty() && FrameMarkers.front().FenceValue <= CompletedFenceValue)
+    {
+        Tail = FrameMarkers.front().EndOffset;
+        FrameMarkers.pop_front();
+    }
+
+    while (!RetiredBuffers.empty() && RetiredBuffers.front().FenceValue <= CompletedFenceValue)
+    {
+        RetiredBuffers.pop_front();
+    }
+}
+
+uint64 FDX12UploadRing::GetUsedBytes() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Head - Tail;
+}
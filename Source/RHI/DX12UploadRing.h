@@ -0,0 +1,88 @@
+#pragma once
+
+#include "DX12Commons.h"
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+class FDX12CommandQueue;
+
+struct FDX12UploadAllocation
+{
+    ID3D12Resource*           Resource = nullptr;
+    uint64                    Offset = 0;
+    uint64                    Size = 0;
+    uint8*                    CpuAddress = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS GpuAddress = 0;
+
+    bool IsValid() const { return CpuAddress != nullptr; }
+};
+
+// Persistently mapped upload buffer that hands out transient suballocations for the frame being
+// recorded. Space is reclaimed once the fence passed to EndFrame for that frame has completed.
+// When the ring fills up with in-flight data it is replaced by a larger one; the old buffer is
+// kept alive until the current frame retires. Allocate is safe to call from parallel recording.
+class FDX12UploadRing
+{
+public:
+    static constexpr uint64 DefaultCapacity = 4ULL * 1024ULL * 1024ULL;
+
+    FDX12UploadRing() = default;
+    FDX12UploadRing(const FDX12UploadRing&) = delete;
+    FDX12UploadRing& operator=(const FDX12UploadRing&) = delete;
+
+    bool Initialize(ID3D12Device* InDevice, FDX12CommandQueue* InFenceQueue, uint64 InCapacity = DefaultCapacity);
+
+    FDX12UploadAllocation Allocate(uint64 Size, uint64 Alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+    template <typename T>
+    FDX12UploadAllocation AllocateConstants(const T& Value)
+    {
+        FDX12UploadAllocation Allocation = Allocate(sizeof(T));
+        if (Allocation.IsValid())
+        {
+            std::memcpy(Allocation.CpuAddress, &Value, sizeof(T));
+        }
+        return Allocation;
+    }
+
+    // Marks everything allocated since the previous call as used by the submission that signals FenceValue.
+    void EndFrame(uint64 FenceValue);
+
+    uint64 GetCapacity() const { return Capacity; }
+    uint64 GetUsedBytes() const;
+
+private:
+    struct FFrameMarker
+    {
+        uint64 FenceValue = 0;
+        uint64 EndOffset = 0;
+    };
+
+    struct FRetiredBuffer
+    {
+        ComPtr<ID3D12Resource> Resource;
+        uint64 FenceValue = 0;
+    };
+
+    bool CreateBuffer(uint64 InCapacity);
+    void Reclaim(uint64 CompletedFenceValue);
+    bool TryAllocate(uint64 Size, uint64 Alignment, uint64& OutOffset);
+
+    mutable std::mutex Mutex;
+    ID3D12Device*           Device = nullptr;
+    FDX12CommandQueue*      FenceQueue = nullptr;
+    ComPtr<ID3D12Resource>  Buffer;
+    uint8*                  MappedData = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS BaseGpuAddress = 0;
+    uint64                  Capacity = 0;
+
+    // Monotonic byte positions; the physical offset is Position % Capacity.
+    uint64                  Head = 0;
+    uint64                  Tail = 0;
+
+    std::deque<FFrameMarker> FrameMarkers;
+    // Buffers replaced during the current frame, retired with its fence in EndFrame.
+    std::vector<ComPtr<ID3D12Resource>> ReplacedBuffers;
+    std::deque<FRetiredBuffer> RetiredBuffers;
+};
@@ -0,0 +1,278 @@
+#include "ClusteredLights.h"
+
+#include "RendererUtils.h"
+#include "ShaderCompiler.h"
+#include "../Scene/Camera.h"
+#include "../Scene/SceneJsonLoader.h"
+#include "../RHI/DX12Commons.h"
+#include "../RHI/DX12Device.h"
+#include "../Core/Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+    constexpr float DegToRad = 3.14159265f / 180.0f;
+
+    FPunctualLightData BuildPunctualLightData(const FScenePunctualLightDesc& Light)
+    {
+        FPunctualLightData Data;
+        Data.Position = Light.Position;
+        Data.Range = Light.Range;
+        Data.Color = DirectX::XMFLOAT3(Light.Color.x * Light.Intensity, Light.Color.y * Light.Intensity, Light.Color.z * Light.Intensity);
+
+        if (Light.Type == EScenePunctualLightType::Spot)
+        {
+            DirectX::XMStoreFloat3(&Data.Direction, DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&Light.Direction)));
+
+            // Cone angles are full angles; the falloff runs from the outer to the inner half-angle.
+            const float CosOuter = std::cos(Light.OuterConeDegrees * 0.5f * DegToRad);
+            const float CosInner = std::cos(Light.InnerConeDegrees * 0.5f * DegToRad);
+            Data.SpotScale = 1.0f / (std::max)(CosInner - CosOuter, 1e-3f);
+            Data.SpotOffset = -CosOuter * Data.SpotScale;
+        }
+        return Data;
+    }
+}
+
+bool FClusteredLights::Initialize(FDX12Device* Device, const std::vector<FScenePunctualLightDesc>& Lights)
+{
+    LightCount = 0;
+    LightBuffer.Reset();
+    ClusterGridBuffer.Reset();
+    if (!Device || Lights.empty())
+    {
+        return false;
+    }
+
+    std::vector<FPunctualLightData> LightData;
+    LightData.reserve(Lights.size());
+    for (const FScenePunctualLightDesc& Light : Lights)
+    {
+        LightData.push_back(BuildPunctualLightData(Light));
+    }
+
+    if (!CreateRootSignature(Device) || !CreatePipeline(Device) || !CreateBuffers(Device, LightData))
+    {
+        LightBuffer.Reset();
+        ClusterGridBuffer.Reset();
+        return false;
+    }
+
+    LightCount = static_cast<uint32_t>(LightData.size());
+    LogInfo("Clustered lighting: " + std::to_string(LightCount) + " punctual lights");
+    return true;
+}
+
+bool FClusteredLights::CreateRootSignature(FDX12Device* Device)
+{
+    D3D12_ROOT_PARAMETER1 RootParams[4] = {};
+    // RootParams[0]: View constants (b0)
+    RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    RootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[0].Descriptor.ShaderRegister = 0;
+    RootParams[0].Descriptor.RegisterSpace = 0;
+    RootParams[0].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+
+    // RootParams[1]: Cluster constants (b1)
+    RootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    RootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[1].Constants.Num32BitValues = ConstantCount;
+    RootParams[1].Constants.ShaderRegister = 1;
+    RootParams[1].Constants.RegisterSpace = 0;
+
+    // RootParams[2]: Punctual lights (t0)
+    RootParams[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    RootParams[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[2].Descriptor.ShaderRegister = 0;
+    RootParams[2].Descriptor.RegisterSpace = 0;
+    RootParams[2].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC;
+
+    // RootParams[3]: Cluster light grid (u0)
+    RootParams[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    RootParams[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[3].Descriptor.ShaderRegister = 0;
+    RootParams[3].Descriptor.RegisterSpace = 0;
+    RootParams[3].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+
+    D3D12_VERSIONED_ROOT_SIGNATURE_DESC RootSigDesc = {};
+    RootSigDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
+    RootSigDesc.Desc_1_1.NumParameters = _countof(RootParams);
+    RootSigDesc.Desc_1_1.pParameters = RootParams;
+    RootSigDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
+
+    ComPtr<ID3DBlob> SerializedSig;
+    ComPtr<ID3DBlob> ErrorBlob;
+    if (FAILED(D3D12SerializeVersionedRootSignature(&RootSigDesc, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf())))
+    {
+        if (ErrorBlob)
+        {
+            LogError(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
+        }
+        return false;
+    }
+
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), RootSignature.ReleaseAndGetAddressOf()));
+    return RootSignature != nullptr;
+}
+
+bool FClusteredLights::CreatePipeline(FDX12Device* Device)
+{
+    if (!Device || !RootSignature)
+    {
+        return false;
+    }
+
+    FShaderCompiler Compiler;
+    const std::wstring CSTarget = RendererUtils::BuildShaderTarget(L"cs", Device->GetShaderModel());
+    std::vector<uint8_t> CSByteCode;
+    if (!Compiler.CompileFromFile(L"Shaders/ClusterLights.hlsl", L"ClusterLights", CSTarget, CSByteCode))
+    {
+        LogError("Failed to compile light clustering shader");
+        return false;
+    }
+
+    D3D12_COMPUTE_PIPELINE_STATE_DESC PsoDesc = {};
+    PsoDesc.pRootSignature = RootSignature.Get();
+    PsoDesc.CS = { CSByteCode.data(), CSByteCode.size() };
+
+    HR_CHECK(Device->GetPipelineCache()->CreateComputePipelineState(PsoDesc, Pipeline.ReleaseAndGetAddressOf()));
+    return Pipeline != nullptr;
+}
+
+bool FClusteredLights::CreateBuffers(FDX12Device* Device, const std::vector<FPunctualLightData>& Lights)
+{
+    const uint64_t LightBytes = sizeof(FPunctualLightData) * Lights.size();
+
+    D3D12_HEAP_PROPERTIES DefaultHeap = {};
+    DefaultHeap.Type = D3D12_HEAP_TYPE_DEFAULT;
+    DefaultHeap.CreationNodeMask = 1;
+    DefaultHeap.VisibleNodeMask = 1;
+
+    D3D12_HEAP_PROPERTIES UploadHeap = DefaultHeap;
+    UploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+    D3D12_RESOURCE_DESC BufferDesc = {};
+    BufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    BufferDesc.Width = LightBytes;
+    BufferDesc.Height = 1;
+    BufferDesc.DepthOrArraySize = 1;
+    BufferDesc.MipLevels = 1;
+    BufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+    BufferDesc.SampleDesc.Count = 1;
+    BufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    BufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+    // Binning rewrites every cluster each frame, so the grid needs no initial data.
+    D3D12_RESOURCE_DESC GridDesc = BufferDesc;
+    GridDesc.Width = sizeof(uint32_t) * static_cast<uint64_t>(ClusterCount) * (1 + MaxLightsPerCluster);
+    GridDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Buffer,
+        &DefaultHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &BufferDesc,
+        D3D12_RESOURCE_STATE_COMMON,
+        nullptr,
+        IID_PPV_ARGS(LightBuffer.ReleaseAndGetAddressOf())));
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Buffer,
+        &DefaultHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &GridDesc,
+        D3D12_RESOURCE_STATE_COMMON,
+        nullptr,
+        IID_PPV_ARGS(ClusterGridBuffer.ReleaseAndGetAddressOf())));
+
+    ComPtr<ID3D12Resource> UploadBuffer;
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Upload,
+        &UploadHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &BufferDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(UploadBuffer.GetAddressOf())));
+
+    if (!LightBuffer || !ClusterGridBuffer || !UploadBuffer)
+    {
+        LogError("Failed to create clustered lighting buffers");
+        return false;
+    }
+    LightBuffer->SetName(L"PunctualLightBuffer");
+    ClusterGridBuffer->SetName(L"ClusterLightGrid");
+    ClusterGridState = D3D12_RESOURCE_STATE_COMMON;
+
+    const D3D12_RANGE EmptyRange = { 0, 0 };
+    uint8_t* UploadData = nullptr;
+    HR_CHECK(UploadBuffer->Map(0, &EmptyRange, reinterpret_cast<void**>(&UploadData)));
+    std::memcpy(UploadData, Lights.data(), LightBytes);
+    UploadBuffer->Unmap(0, nullptr);
+
+    ComPtr<ID3D12CommandAllocator> UploadAllocator;
+    ComPtr<ID3D12GraphicsCommandList> UploadList;
+    HR_CHECK(Device->GetDevice()->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(UploadAllocator.GetAddressOf())));
+    HR_CHECK(Device->GetDevice()->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, UploadAllocator.Get(), nullptr, IID_PPV_ARGS(UploadList.GetAddressOf())));
+
+    D3D12_RESOURCE_BARRIER Barrier = {};
+    Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    Barrier.Transition.pResource = LightBuffer.Get();
+    Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COMMON;
+    Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+    UploadList->ResourceBarrier(1, &Barrier);
+
+    UploadList->CopyBufferRegion(LightBuffer.Get(), 0, UploadBuffer.Get(), 0, LightBytes);
+
+    Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+    Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+    UploadList->ResourceBarrier(1, &Barrier);
+
+    HR_CHECK(UploadList->Close());
+    ID3D12CommandList* Lists[] = { UploadList.Get() };
+    Device->GetGraphicsQueue()->ExecuteCommandLists(1, Lists);
+    Device->GetGraphicsQueue()->Flush();
+    return true;
+}
+
+FClusterConstants FClusteredLights::BuildConstants(const FCamera& Camera, const D3D12_VIEWPORT& Viewport) const
+{
+    FClusterConstants Constants;
+    Constants.ClusterCountX = ClusterCountX;
+    Constants.ClusterCountY = ClusterCountY;
+    Constants.ClusterCountZ = ClusterCountZ;
+    Constants.LightCount = HasLights() ? LightCount : 0u;
+
+    const float Width = (std::max)(Viewport.Width, 1.0f);
+    const float Height = (std::max)(Viewport.Height, 1.0f);
+    Constants.TileSize = DirectX::XMFLOAT2(std::ceil(Width / ClusterCountX), std::ceil(Height / ClusterCountY));
+    Constants.InvViewportSize = DirectX::XMFLOAT2(1.0f / Width, 1.0f / Height);
+
+    // The projection has no far plane; the far clip only bounds the slices, deeper pixels use the last.
+    const float NearZ = (std::max)(Camera.GetNearClip(), 1e-3f);
+    const float FarZ = (std::max)(Camera.GetFarClip(), NearZ * 2.0f);
+    Constants.SliceScale = static_cast<float>(ClusterCountZ) / std::log(FarZ / NearZ);
+    Constants.SliceBias = -std::log(NearZ) * Constants.SliceScale;
+    return Constants;
+}
+
+void FClusteredLights::Dispatch(ID3D12GraphicsCommandList* CommandList, D3D12_GPU_VIRTUAL_ADDRESS ViewConstantsAddress, const FClusterConstants& Constants) const
+{
+    if (!HasLights() || !CommandList)
+    {
+        return;
+    }
+
+    CommandList->SetComputeRootSignature(RootSignature.Get());
+    CommandList->SetPipelineState(Pipeline.Get());
+    CommandList->SetComputeRootConstantBufferView(0, ViewConstantsAddress);
+    CommandList->SetComputeRoot32BitConstants(1, ConstantCount, &Constants, 0);
+    CommandList->SetComputeRootShaderResourceView(2, LightBuffer->GetGPUVirtualAddress());
+    CommandList->SetComputeRootUnorderedAccessView(3, ClusterGridBuffer->GetGPUVirtualAddress());
+    CommandList->Dispatch(ClusterCountX, ClusterCountY, ClusterCountZ);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+class FDX12Device;
+class FCamera;
+struct FScenePunctualLightDesc;
+
+// PunctualLight in Shaders/ClusteredLightingCommon.hlsl. Color is premultiplied by intensity;
+// point lights use a spot scale of 0 and an offset of 1.
+struct FPunctualLightData
+{
+    DirectX::XMFLOAT3 Position = { 0.0f, 0.0f, 0.0f };
+    float Range = 0.0f;
+    DirectX::XMFLOAT3 Color = { 0.0f, 0.0f, 0.0f };
+    float SpotScale = 0.0f;
+    DirectX::XMFLOAT3 Direction = { 0.0f, -1.0f, 0.0f };
+    float SpotOffset = 1.0f;
+};
+
+// cbuffer ClusterConstants (b1) in Shaders/ClusteredLightingCommon.hlsl.
+struct FClusterConstants
+{
+    uint32_t ClusterCountX = 0;
+    uint32_t ClusterCountY = 0;
+    uint32_t ClusterCountZ = 0;
+    uint32_t LightCount = 0;
+    DirectX::XMFLOAT2 TileSize = { 1.0f, 1.0f };
+    float SliceScale = 0.0f;
+    float SliceBias = 0.0f;
+    DirectX::XMFLOAT2 InvViewportSize = { 0.0f, 0.0f };
+};
+
+/**
+ * Punctual lights of the scene and the cluster grid they are binned into each frame by
+ * Shaders/ClusterLights.hlsl. The grid divides the view into ClusterCountX x ClusterCountY screen
+ * tiles and ClusterCountZ slices spaced exponentially between the camera's near and far clip, so
+ * its size does not depend on the resolution. Lighting passes read each pixel's cluster list
+ * instead of walking every light.
+ */
+class FClusteredLights
+{
+public:
+    static constexpr uint32_t ClusterCountX = 16;
+    static constexpr uint32_t ClusterCountY = 9;
+    static constexpr uint32_t ClusterCountZ = 24;
+    static constexpr uint32_t ClusterCount = ClusterCountX * ClusterCountY * ClusterCountZ;
+    // CLUSTER_MAX_LIGHTS in the shaders; further lights reaching a cluster are dropped.
+    static constexpr uint32_t MaxLightsPerCluster = 128;
+    static constexpr uint32_t ConstantCount = sizeof(FClusterConstants) / sizeof(uint32_t);
+
+    // Uploads the lights and creates the grid and binning pipeline; nothing is created without lights.
+    bool Initialize(FDX12Device* Device, const std::vector<FScenePunctualLightDesc>& Lights);
+    bool CreatePipeline(FDX12Device* Device);
+
+    bool HasLights() const { return LightCount > 0 && LightBuffer && ClusterGridBuffer && Pipeline; }
+    uint32_t GetLightCount() const { return LightCount; }
+
+    // Constants for the camera; LightCount is 0 without lights, which lighting shaders test.
+    FClusterConstants BuildConstants(const FCamera& Camera, const D3D12_VIEWPORT& Viewport) const;
+
+    // Records the binning dispatch. The grid must be in UNORDERED_ACCESS.
+    void Dispatch(ID3D12GraphicsCommandList* CommandList, D3D12_GPU_VIRTUAL_ADDRESS ViewConstantsAddress, const FClusterConstants& Constants) const;
+
+    ID3D12Resource* GetLightBuffer() const { return LightBuffer.Get(); }
+    ID3D12Resource* GetClusterGridBuffer() const { return ClusterGridBuffer.Get(); }
+    D3D12_RESOURCE_STATES* GetClusterGridState() { return &ClusterGridState; }
+
+private:
+    bool CreateRootSignature(FDX12Device* Device);
+    bool CreateBuffers(FDX12Device* Device, const std::vector<FPunctualLightData>& Lights);
+
+    Microsoft::WRL::ComPtr<ID3D12RootSignature> RootSignature;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> Pipeline;
+    // Read by the binning and lighting shaders only, so it stays in a shader resource state.
+    Microsoft::WRL::ComPtr<ID3D12Resource> LightBuffer;
+    // ClusterCount light counts, then MaxLightsPerCluster light indices per cluster.
+    Microsoft::WRL::ComPtr<ID3D12Resource> ClusterGridBuffer;
+    D3D12_RESOURCE_STATES ClusterGridState = D3D12_RESOURCE_STATE_COMMON;
+    uint32_t LightCount = 0;
+};
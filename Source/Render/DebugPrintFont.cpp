@@ -108,7 +108,8 @@ bool CreateDebugPrintFontResources(
     DefaultHeap.VisibleNodeMask = 1;
 
     ComPtr<ID3D12Resource> FontTexture;
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Texture,
         &DefaultHeap,
         D3D12_HEAP_FLAG_NONE,
         &TextureDesc,
@@ -138,7 +139,8 @@ bool CreateDebugPrintFontResources(
     UploadDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
 
     ComPtr<ID3D12Resource> UploadResource;
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Upload,
         &UploadHeap,
         D3D12_HEAP_FLAG_NONE,
         &UploadDesc,
@@ -168,7 +170,8 @@ bool CreateDebugPrintFontResources(
     GlyphDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
 
     ComPtr<ID3D12Resource> GlyphBuffer;
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Buffer,
         &DefaultHeap,
         D3D12_HEAP_FLAG_NONE,
         &GlyphDesc,
@@ -178,7 +181,8 @@ bool CreateDebugPrintFontResources(
 
     D3D12_RESOURCE_DESC GlyphUploadDesc = GlyphDesc;
     ComPtr<ID3D12Resource> GlyphUpload;
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Upload,
         &UploadHeap,
         D3D12_HEAP_FLAG_NONE,
         &GlyphUploadDesc,
@@ -1,14 +1,18 @@
 #include "DeferredRenderer.h"
 
 #include "ShaderCompiler.h"
+#include "PipelineJobGroup.h"
 #include "RendererUtils.h"
 #include "RenderGraph.h"
+#include "TextureStreamer.h"
 #include "../Scene/GltfLoader.h"
+#include "../Scene/SceneJsonLoader.h"
 #include "../Scene/Camera.h"
 #include "../Scene/Mesh.h"
 #include "../RHI/DX12Device.h"
 #include "../RHI/DX12CommandContext.h"
 #include "../RHI/DX12CommandQueue.h"
+#include "../Core/CpuProfiler.h"
 #include "../Core/GpuDebugMarkers.h"
 #include "../Core/Logger.h"
 #include <d3dx12.h>
@@ -25,24 +29,59 @@ FDeferredRenderer::FDeferredRenderer() = default;
 
 namespace
 {
-    uint32_t BuildPipelineKey(const FSceneModelResource& Model)
-    {
-        const uint32_t UseNormal = Model.bHasNormalMap ? 1u : 0u;
-        const uint32_t UseMr = !Model.MetallicRoughnessTexturePath.empty() ? 1u : 0u;
-        const uint32_t UseBase = !Model.BaseColorTexturePath.empty() ? 1u : 0u;
-        const uint32_t UseEmissive = !Model.EmissiveTexturePath.empty() ? 1u : 0u;
-        const uint32_t UseAlphaMask = (Model.AlphaMode == 1u) ? 1u : 0u;
-        return (UseNormal) | (UseMr << 1) | (UseBase << 2) | (UseEmissive << 3) | (UseAlphaMask << 4);
-    }
-
     constexpr DXGI_FORMAT GBufferFormats[3] =
     {
-        DXGI_FORMAT_R16G16B16A16_FLOAT,
-        DXGI_FORMAT_R16G16B16A16_FLOAT,
+        DXGI_FORMAT_R16G16_SNORM,
+        DXGI_FORMAT_R8G8B8A8_UNORM,
         DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
     };
 
     constexpr DXGI_FORMAT LightingBufferFormat = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    // Screen UV motion; half floats keep sub-pixel precision across the whole screen.
+    constexpr DXGI_FORMAT VelocityFormat = DXGI_FORMAT_R16G16_FLOAT;
+
+    // Gathers the frame's depth SRV into a transient table for the lighting passes (t8).
+    D3D12_GPU_DESCRIPTOR_HANDLE CopyDepthTable(FDX12CommandContext& Cmd, D3D12_CPU_DESCRIPTOR_HANDLE DepthSrv)
+    {
+        FDX12DescriptorAllocator* DescriptorAllocator = Cmd.GetDescriptorAllocator();
+        if (!DescriptorAllocator || DepthSrv.ptr == 0)
+        {
+            return {};
+        }
+
+        const FDX12DescriptorRange Table = DescriptorAllocator->CopyToTransient(&DepthSrv, 1);
+        return Table.IsValid() ? Table.GetGpuHandle(0) : D3D12_GPU_DESCRIPTOR_HANDLE{};
+    }
+
+    // Shadow comparison (s1) and IBL (s2) samplers of Shaders/DeferredLightingCommon.hlsl.
+    void BuildLightingSamplers(D3D12_SHADER_VISIBILITY Visibility, D3D12_STATIC_SAMPLER_DESC (&OutSamplers)[2])
+    {
+        OutSamplers[0] = {};
+        OutSamplers[0].Filter = D3D12_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT;
+        OutSamplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+        OutSamplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+        OutSamplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
+        OutSamplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_OPAQUE_WHITE;
+        OutSamplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
+        OutSamplers[0].MinLOD = 0.0f;
+        OutSamplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+        OutSamplers[0].ShaderRegister = 1;
+        OutSamplers[0].RegisterSpace = 0;
+        OutSamplers[0].ShaderVisibility = Visibility;
+
+        OutSamplers[1] = {};
+        OutSamplers[1].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+        OutSamplers[1].AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+        OutSamplers[1].AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+        OutSamplers[1].AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+        OutSamplers[1].ComparisonFunc = D3D12_COMPARISON_FUNC_ALWAYS;
+        OutSamplers[1].BorderColor = D3D12_STATIC_BORDER_COLOR_OPAQUE_BLACK;
+        OutSamplers[1].MinLOD = 0.0f;
+        OutSamplers[1].MaxLOD = D3D12_FLOAT32_MAX;
+        OutSamplers[1].ShaderRegister = 2;
+        OutSamplers[1].RegisterSpace = 0;
+        OutSamplers[1].ShaderVisibility = Visibility;
+    }
 
     float HaltonSequence(uint32_t Index, uint32_t Base)
     {
@@ -65,10 +104,82 @@ namespace
         const float JitterY = HaltonSequence(Index, 3) - 0.5f;
         return DirectX::XMFLOAT2(JitterX, JitterY);
     }
+
+    // Jitter positions per cycle: 8 at full resolution, and more as the scene renders at a lower
+    // one, so each output pixel still receives about 8 samples per cycle.
+    uint32_t GetTaaJitterPhaseCount(float ResolutionScale)
+    {
+        const float Scale = (std::max)(ResolutionScale, 0.25f);
+        return (std::min)(64u, static_cast<uint32_t>(std::ceil(8.0f / (Scale * Scale))));
+    }
+
+    // Matches MESHLETS_PER_GROUP in MeshletBasePass.hlsl.
+    constexpr uint32_t MeshletsPerAmplificationGroup = 32;
+
+    // Builds an amplification/mesh shader pipeline with the fixed-function state of Desc; its VS and
+    // input layout are ignored. Mesh pipelines need a pipeline state stream, which the pipeline cache
+    // does not handle, so they are created directly.
+    HRESULT CreateMeshPipelineState(
+        ID3D12Device* Device,
+        const D3D12_GRAPHICS_PIPELINE_STATE_DESC& Desc,
+        const std::vector<uint8_t>& ASByteCode,
+        const std::vector<uint8_t>& MSByteCode,
+        ID3D12PipelineState** OutPipeline)
+    {
+        ComPtr<ID3D12Device2> Device2;
+        const HRESULT QueryResult = Device->QueryInterface(IID_PPV_ARGS(Device2.GetAddressOf()));
+        if (FAILED(QueryResult))
+        {
+            return QueryResult;
+        }
+
+        struct FMeshPipelineStream
+        {
+            CD3DX12_PIPELINE_STATE_STREAM_ROOT_SIGNATURE RootSignature;
+            CD3DX12_PIPELINE_STATE_STREAM_AS AS;
+            CD3DX12_PIPELINE_STATE_STREAM_MS MS;
+            CD3DX12_PIPELINE_STATE_STREAM_PS PS;
+            CD3DX12_PIPELINE_STATE_STREAM_BLEND_DESC BlendState;
+            CD3DX12_PIPELINE_STATE_STREAM_SAMPLE_MASK SampleMask;
+            CD3DX12_PIPELINE_STATE_STREAM_RASTERIZER RasterizerState;
+            CD3DX12_PIPELINE_STATE_STREAM_DEPTH_STENCIL DepthStencilState;
+            CD3DX12_PIPELINE_STATE_STREAM_PRIMITIVE_TOPOLOGY PrimitiveTopology;
+            CD3DX12_PIPELINE_STATE_STREAM_RENDER_TARGET_FORMATS RenderTargetFormats;
+            CD3DX12_PIPELINE_STATE_STREAM_DEPTH_STENCIL_FORMAT DepthStencilFormat;
+            CD3DX12_PIPELINE_STATE_STREAM_SAMPLE_DESC SampleDesc;
+        };
+
+        D3D12_RT_FORMAT_ARRAY RenderTargetFormats = {};
+        RenderTargetFormats.NumRenderTargets = Desc.NumRenderTargets;
+        for (UINT Index = 0; Index < Desc.NumRenderTargets; ++Index)
+        {
+            RenderTargetFormats.RTFormats[Index] = Desc.RTVFormats[Index];
+        }
+
+        FMeshPipelineStream Stream;
+        Stream.RootSignature = Desc.pRootSignature;
+        Stream.AS = D3D12_SHADER_BYTECODE{ ASByteCode.data(), ASByteCode.size() };
+        Stream.MS = D3D12_SHADER_BYTECODE{ MSByteCode.data(), MSByteCode.size() };
+        Stream.PS = Desc.PS;
+        Stream.BlendState = CD3DX12_BLEND_DESC(Desc.BlendState);
+        Stream.SampleMask = Desc.SampleMask;
+        Stream.RasterizerState = CD3DX12_RASTERIZER_DESC(Desc.RasterizerState);
+        Stream.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(Desc.DepthStencilState);
+        Stream.PrimitiveTopology = Desc.PrimitiveTopologyType;
+        Stream.RenderTargetFormats = RenderTargetFormats;
+        Stream.DepthStencilFormat = Desc.DSVFormat;
+        Stream.SampleDesc = Desc.SampleDesc;
+
+        D3D12_PIPELINE_STATE_STREAM_DESC StreamDesc = {};
+        StreamDesc.SizeInBytes = sizeof(Stream);
+        StreamDesc.pPipelineStateSubobjectStream = &Stream;
+        return Device2->CreatePipelineState(&StreamDesc, IID_PPV_ARGS(OutPipeline));
+    }
 }
 
 bool FDeferredRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t Height, DXGI_FORMAT BackBufferFormat, const FRendererOptions& Options)
 {
+    FGpuMemoryOwnerScope MemoryScope(GetMemoryOwnerId());
     if (Device == nullptr)
     {
         LogError("Deferred renderer initialization failed: device is null");
@@ -87,6 +198,7 @@ bool FDeferredRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
     TonemapGamma = Options.TonemapGamma;
     bCasEnabled = Options.bEnableCas;
     CasSharpness = Options.CasSharpness;
+    bFusedPostEnabled = Options.bEnableFusedPost;
     bAutoExposureEnabled = Options.bEnableAutoExposure;
     AutoExposureKey = Options.AutoExposureKey;
     AutoExposureMin = Options.AutoExposureMin;
@@ -101,6 +213,8 @@ bool FDeferredRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
     TaaSampleIndex = 0;
     bHZBEnabled = Options.bEnableHZB;
     bHZBReady = false;
+    bTiledLightingEnabled = Options.bEnableTiledLighting;
+    bMeshShadersEnabled = Options.bEnableMeshShaders && Device->SupportsMeshShaders();
 
     InitializeCommonSettings(Width, Height, Options);
 
@@ -111,82 +225,77 @@ bool FDeferredRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
         return false;
     }
 
-    LogInfo("Creating deferred renderer lighting root signature...");
-    if (!CreateLightingRootSignature(Device))
-    {
-        LogError("Deferred renderer initialization failed: lighting root signature creation failed");
-        return false;
-    }
-
-    LogInfo("Creating deferred renderer base pass pipeline...");
-    if (!CreateBasePassPipeline(Device, LightingBufferFormat))
+    if (bMeshShadersEnabled && !CreateMeshletRootSignature(Device))
     {
-        LogError("Deferred renderer initialization failed: base pass pipeline creation failed");
-        return false;
-    }
-
-    LogInfo("Creating deferred renderer object ID pipeline...");
-    if (!CreateObjectIdPipeline(Device))
-    {
-        LogError("Deferred renderer initialization failed: object ID pipeline creation failed");
-        return false;
-    }
-
-    LogInfo("Creating deferred renderer depth prepass pipeline...");
-    if (!CreateDepthPrepassPipeline(Device))
-    {
-        LogError("Deferred renderer initialization failed: depth prepass pipeline creation failed");
-        return false;
+        LogWarning("Meshlet root signature creation failed; using the vertex shader base pass.");
+        bMeshShadersEnabled = false;
     }
 
-    LogInfo("Creating deferred renderer shadow pipeline...");
-    if (!CreateShadowPipeline(Device, BasePassRootSignature.Get(), ShadowPipeline))
+    LogInfo("Creating deferred renderer lighting root signature...");
+    if (!CreateLightingRootSignature(Device))
     {
-        LogError("Deferred renderer initialization failed: shadow pipeline creation failed");
+        LogError("Deferred renderer initialization failed: lighting root signature creation failed");
         return false;
     }
 
-    LogInfo("Creating deferred renderer lighting pipeline...");
-    if (!CreateLightingPipeline(Device, BackBufferFormat))
+    LogInfo("Creating deferred renderer post-processing root signatures...");
+    if (!CreateHZBRootSignature(Device))
     {
-        LogError("Deferred renderer initialization failed: lighting pipeline creation failed");
+        LogError("Deferred renderer initialization failed: HZB root signature creation failed");
         return false;
     }
-
-    LogInfo("Creating deferred renderer hierarchical Z-buffer root signature and pipeline...");
-    if (!CreateHZBRootSignature(Device) || !CreateHZBPipeline(Device))
+    if (!CreateAutoExposureRootSignature(Device))
     {
-        LogError("Deferred renderer initialization failed: HZB pipeline creation failed");
+        LogError("Deferred renderer initialization failed: auto exposure root signature creation failed");
         return false;
     }
-
-    LogInfo("Creating deferred renderer auto exposure root signature and pipeline...");
-    if (!CreateAutoExposureRootSignature(Device) || !CreateAutoExposurePipeline(Device))
+    if (!CreateTaaRootSignature(Device))
     {
-        LogError("Deferred renderer initialization failed: auto exposure pipeline creation failed");
+        LogError("Deferred renderer initialization failed: TAA root signature creation failed");
         return false;
     }
-
-    LogInfo("Creating deferred renderer TAA root signature and pipeline...");
-    if (!CreateTaaRootSignature(Device) || !CreateTaaPipeline(Device))
+    if (!CreateTonemapRootSignature(Device))
     {
-        LogError("Deferred renderer initialization failed: TAA pipeline creation failed");
+        LogError("Deferred renderer initialization failed: tonemap root signature creation failed");
         return false;
     }
-
-    LogInfo("Creating deferred renderer tonemap root signature and pipeline...");
-    if (!CreateTonemapRootSignature(Device) || !CreateTonemapPipeline(Device, BackBufferFormat))
+    if (!CreateCasRootSignature(Device))
     {
-        LogError("Deferred renderer initialization failed: tonemap pipeline creation failed");
+        LogError("Deferred renderer initialization failed: CAS root signature creation failed");
         return false;
     }
 
-    LogInfo("Creating deferred renderer CAS root signature and pipeline...");
-    if (!CreateCasRootSignature(Device) || !CreateCasPipeline(Device, BackBufferFormat))
-    {
-        LogError("Deferred renderer initialization failed: CAS pipeline creation failed");
-        return false;
-    }
+    // Pipelines build on the workers while the scene loads below; each writes only its own PSOs.
+    LogInfo("Creating deferred renderer pipelines...");
+    FPipelineJobGroup PipelineJobs;
+    PipelineJobs.Add([this, Device]() { return CreateBasePassPipeline(Device, LightingBufferFormat); },
+        "Deferred renderer initialization failed: base pass pipeline creation failed");
+    PipelineJobs.Add([this, Device]() { return CreateObjectIdPipeline(Device); },
+        "Deferred renderer initialization failed: object ID pipeline creation failed");
+    PipelineJobs.Add([this, Device]() { return CreateDepthPrepassPipeline(Device); },
+        "Deferred renderer initialization failed: depth prepass pipeline creation failed");
+    PipelineJobs.Add([this, Device]() { return CreateShadowPipeline(Device, BasePassRootSignature.Get(), ShadowPipeline); },
+        "Deferred renderer initialization failed: shadow pipeline creation failed");
+    PipelineJobs.Add([this, Device, BackBufferFormat]() { return CreateLightingPipeline(Device, BackBufferFormat); },
+        "Deferred renderer initialization failed: lighting pipeline creation failed");
+    PipelineJobs.Add([this, Device]() { return CreateTiledLightingPipelines(Device); },
+        "Tiled lighting unavailable, lighting with the fullscreen pass", false);
+    PipelineJobs.Add([this, Device]() { return CreateHZBPipeline(Device); },
+        "Deferred renderer initialization failed: HZB pipeline creation failed");
+    PipelineJobs.Add([this, Device]() { return CreateHZBSinglePassPipeline(Device); },
+        "Single-pass HZB pipeline unavailable, building the HZB with one dispatch per 4 mips", false);
+    PipelineJobs.Add([this, Device]() { return CreateAutoExposurePipeline(Device); },
+        "Deferred renderer initialization failed: auto exposure pipeline creation failed");
+    PipelineJobs.Add([this, Device]() { return CreateTaaPipeline(Device); },
+        "Deferred renderer initialization failed: TAA pipeline creation failed");
+    PipelineJobs.Add([this, Device, BackBufferFormat]() { return CreateTonemapPipeline(Device, BackBufferFormat); },
+        "Deferred renderer initialization failed: tonemap pipeline creation failed");
+    PipelineJobs.Add([this, Device, BackBufferFormat]() { return CreateCasPipeline(Device, BackBufferFormat); },
+        "Deferred renderer initialization failed: CAS pipeline creation failed");
+    PipelineJobs.Add([this, Device]() { return CreateFusedPostPipeline(Device); },
+        "Fused post-processing pipeline unavailable, tonemapping and sharpening in separate passes", false);
+    PipelineJobs.Add([this, Device]() { return CreateSceneScatterPipeline(Device); },
+        "Scene scatter pipeline unavailable, updating scene buffers with one copy per entry", false);
 
     TextureLoader = std::make_unique<FTextureLoader>(Device);
 
@@ -225,7 +334,7 @@ bool FDeferredRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
         ObjectIdReadback->SetName(L"ObjectIdReadback");
     }
 
-    if (!CreateShadowResources(Device, ShadowMapWidth, ShadowMapHeight, ShadowMap, ShadowDSVHeap, ShadowDSVHandle, ShadowMapState))
+    if (!CreateShadowResources(Device, ShadowMapWidth, ShadowMapHeight, ShadowMap, ShadowDSVHeap, ShadowCascadeDSVHandles, ShadowMapState))
     {
         LogError("Deferred renderer initialization failed: shadow resources creation failed");
         return false;
@@ -237,6 +346,12 @@ bool FDeferredRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
         return false;
     }
 
+    if (!CreateTiledLightingResources(Device, Width, Height))
+    {
+        LogError("Deferred renderer initialization failed: tiled lighting resource creation failed");
+        return false;
+    }
+
     if (!CreateLuminanceResources(Device))
     {
         LogError("Deferred renderer initialization failed: luminance resource creation failed");
@@ -255,8 +370,9 @@ bool FDeferredRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
         return false;
     }
 
+    SceneTransforms.Clear();
     const std::wstring SceneFilePath = Options.SceneFilePath.empty() ? L"Assets/Scenes/Scene.json" : Options.SceneFilePath;
-    if (!RendererUtils::CreateSceneModelsFromJson(Device, SceneFilePath, SceneModels, SceneCenter, SceneRadius))
+    if (!RendererUtils::CreateSceneModelsFromJson(Device, SceneFilePath, SceneModels, SceneCenter, SceneRadius, Options.bOptimizeMeshes, bMeshShadersEnabled, Options.bGenerateLods, &SceneTransforms))
     {
         LogWarning("Falling back to default geometry; scene JSON could not be loaded.");
 
@@ -270,6 +386,7 @@ bool FDeferredRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
 
         const DirectX::XMMATRIX DefaultWorld = DirectX::XMMatrixTranslation(-SceneCenter.x, -SceneCenter.y, -SceneCenter.z);
         DirectX::XMStoreFloat4x4(&DefaultModel.WorldMatrix, DefaultWorld);
+        DefaultModel.PrevWorldMatrix = DefaultModel.WorldMatrix;
         DefaultModel.Center = SceneCenter;
         DefaultModel.Name = "DefaultMesh";
         DefaultModel.BoundsMin = DirectX::XMFLOAT3(SceneCenter.x - SceneRadius, SceneCenter.y - SceneRadius, SceneCenter.z - SceneRadius);
@@ -292,41 +409,52 @@ bool FDeferredRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
         SceneModels.push_back(std::move(DefaultModel));
     }
 
+    FinalizeSceneModels();
     SceneWorldMatrix = SceneModels.front().WorldMatrix;
 
-    SceneConstantBufferStride = (sizeof(FSceneConstants) + 255ULL) & ~255ULL;
-    const uint64_t ConstantBufferSize = SceneConstantBufferStride * (std::max<uint64_t>(1, SceneModels.size()));
+    // Initializing without lights releases those of a previously loaded scene.
+    std::vector<FScenePunctualLightDesc> PunctualLights;
+    FSceneJsonLoader::LoadScenePunctualLights(SceneFilePath, PunctualLights);
+    if (!ClusteredLights.Initialize(Device, PunctualLights) && !PunctualLights.empty())
+    {
+        LogWarning("Clustered lighting setup failed; the scene's point and spot lights are ignored.");
+    }
 
-    if (!CreateSceneConstantBuffersPerFrame(Device, ConstantBufferSize))
+    // The mesh shader path reads every model from the shared meshlet buffer; the default geometry has none.
+    // Only ever cleared from here on: a pipeline job that failed its meshlet twin clears it as well.
+    const bool bSceneHasMeshlets = std::all_of(SceneModels.begin(), SceneModels.end(), [](const FSceneModelResource& Model)
     {
-        LogError("Deferred renderer initialization failed: constant buffer creation failed");
-        return false;
+        return Model.Geometry.MeshletBuffer != nullptr;
+    });
+    if (!bSceneHasMeshlets)
+    {
+        bMeshShadersEnabled = false;
     }
 
-    if (!TextureLoader->LoadOrDefault(L"Assets/Textures/output_pmrem.dds", EnvironmentCubeTexture))
+    if (!LoadEnvironment(Device, L"Assets/Textures/output_pmrem.dds"))
     {
         LogError("Deferred renderer initialization failed: environment cube texture loading failed");
         return false;
     }
-    if (EnvironmentCubeTexture)
-    {
-        EnvironmentCubeTexture->SetName(L"EnvironmentCube");
-    }
 
-    if (!TextureLoader->LoadOrDefault(L"Assets/Textures/PreintegratedGF.dds", BrdfLutTexture))
+    if (!LoadBrdfLut(L"Assets/Textures/PreintegratedGF.dds"))
     {
         LogError("Deferred renderer initialization failed: BRDF LUT texture loading failed");
         return false;
     }
-    if (BrdfLutTexture)
-    {
-        BrdfLutTexture->SetName(L"BrdfLut");
-    }
 
-    if (EnvironmentCubeTexture)
+    // The sky's triangle lies on the far plane, so only the pixels the scene left cleared pass.
+    // Lighting reads its transmittance LUT, whose view CreateDescriptorHeap writes.
+    FSkyPipelineConfig SkyPipelineConfig = {};
+    SkyPipelineConfig.DepthEnable = true;
+    SkyPipelineConfig.DepthFunc = D3D12_COMPARISON_FUNC_GREATER_EQUAL;
+    SkyPipelineConfig.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+    SkyPipelineConfig.DsvFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
+
+    if (!InitializeSkyAtmosphere(Device, LightingBufferFormat, SkyPipelineConfig))
     {
-        const D3D12_RESOURCE_DESC EnvDesc = EnvironmentCubeTexture->GetDesc();
-        EnvironmentMipCount = static_cast<float>((std::max)(1u, static_cast<uint32_t>(EnvDesc.MipLevels)));
+        LogError("Deferred renderer initialization failed: sky atmosphere creation failed");
+        return false;
     }
 
     if (!CreateSceneTextures(Device, SceneModels))
@@ -341,43 +469,68 @@ bool FDeferredRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
         return false;
     }
 
-    if (!CreateGpuDrivenResources(Device))
+    // Materials record the descriptor indices of their texture tables, so this follows CreateDescriptorHeap.
+    if (!CreateSceneDataBuffers(Device))
     {
-        LogWarning("Deferred renderer GPU-driven resources creation failed; fallback to CPU-driven draws.");
+        LogError("Deferred renderer initialization failed: scene data buffer creation failed");
+        return false;
     }
 
-    SkySphereRadius = (std::max)(SceneRadius * 5.0f, 100.0f);
-    if (!RendererUtils::CreateSkyAtmosphereResources(Device, SkySphereRadius, SkyGeometry, SkyConstantBuffer, SkyConstantBufferMapped))
+    if (!CreateGpuDrivenResources(Device))
     {
-        LogError("Deferred renderer initialization failed: sky resource creation failed");
-        return false;
+        LogWarning("Deferred renderer GPU-driven resources creation failed; fallback to CPU-driven draws.");
     }
 
-    if (SkyConstantBuffer)
+    if (bEnableGpuDebugPrint)
     {
-        SkyConstantBuffer->SetName(L"SkyConstantBuffer");
+        if (!CreateGpuDebugPrintResources(Device))
+        {
+            LogError("Deferred renderer initialization failed: GPU debug print setup failed");
+            return false;
+        }
+        PipelineJobs.Add([this, Device, BackBufferFormat]() { return CreateGpuDebugPrintPipeline(Device, BackBufferFormat); },
+            "Deferred renderer initialization failed: GPU debug print pipeline creation failed");
+        PipelineJobs.Add([this, Device]() { return CreateGpuDebugPrintStatsPipeline(Device); },
+            "Deferred renderer initialization failed: GPU debug print stats pipeline creation failed");
     }
 
-    FSkyPipelineConfig SkyPipelineConfig = {};
-    SkyPipelineConfig.DepthEnable = true;
-    SkyPipelineConfig.DepthFunc = D3D12_COMPARISON_FUNC_GREATER_EQUAL;
-    SkyPipelineConfig.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
-    SkyPipelineConfig.DsvFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
-
-    if (!RendererUtils::CreateSkyAtmospherePipeline(Device, LightingBufferFormat, SkyPipelineConfig, SkyRootSignature, SkyPipelineState))
+    if (!PipelineJobs.Join())
     {
-        LogError("Deferred renderer initialization failed: sky pipeline state creation failed");
         return false;
     }
+    LogInfo(bMeshShadersEnabled ? "Deferred base pass: mesh shaders with meshlet culling" : "Deferred base pass: vertex shaders");
 
+    // Shader hot reload re-runs these builders when their shader sources change.
+    ShaderPipelineEntries.clear();
+    RegisterShaderPipeline({ L"Shaders/DeferredBasePass.hlsl", L"Shaders/MeshletBasePass.hlsl" }, [this, Device]()
+    {
+        return CreateBasePassPipeline(Device, LightingBufferFormat) && CreateDepthPrepassPipeline(Device);
+    });
+    RegisterShaderPipeline({ L"Shaders/ObjectId.hlsl" }, [this, Device]() { return CreateObjectIdPipeline(Device); });
+    RegisterShaderPipeline({ L"Shaders/ShadowMap.hlsl" }, [this, Device]() { return CreateShadowPipeline(Device, BasePassRootSignature.Get(), ShadowPipeline); });
+    RegisterShaderPipeline({ L"Shaders/DeferredLighting.hlsl" }, [this, Device, BackBufferFormat]() { return CreateLightingPipeline(Device, BackBufferFormat); });
+    RegisterShaderPipeline({ L"Shaders/TiledDeferredLighting.hlsl" }, [this, Device]() { return CreateTiledLightingPipelines(Device); });
+    RegisterShaderPipeline({ L"Shaders/ClusterLights.hlsl" }, [this, Device]()
+    {
+        return ClusteredLights.GetLightCount() == 0 || ClusteredLights.CreatePipeline(Device);
+    });
+    RegisterShaderPipeline({ L"Shaders/BuildHZB.hlsl" }, [this, Device]() { return CreateHZBPipeline(Device); });
+    RegisterShaderPipeline({ L"Shaders/BuildHZBSinglePass.hlsl" }, [this, Device]() { return CreateHZBSinglePassPipeline(Device); });
+    RegisterShaderPipeline({ L"Shaders/AutoExposure.hlsl" }, [this, Device]() { return CreateAutoExposurePipeline(Device); });
+    RegisterShaderPipeline({ L"Shaders/TemporalAA.hlsl" }, [this, Device]() { return CreateTaaPipeline(Device); });
+    RegisterShaderPipeline({ L"Shaders/Tonemap.hlsl" }, [this, Device, BackBufferFormat]() { return CreateTonemapPipeline(Device, BackBufferFormat); });
+    RegisterShaderPipeline({ L"Shaders/Cas.hlsl" }, [this, Device, BackBufferFormat]() { return CreateCasPipeline(Device, BackBufferFormat); });
+    RegisterShaderPipeline({ L"Shaders/FusedPost.hlsl" }, [this, Device]() { return CreateFusedPostPipeline(Device); });
+    RegisterShaderPipeline({ L"Shaders/SkyAtmosphere.hlsl" }, [this, Device]() { return SkyAtmosphere.CreatePipelines(Device); });
+    RegisterShaderPipeline({ L"Shaders/SceneScatter.hlsl" }, [this, Device]() { return CreateSceneScatterPipeline(Device); });
     if (bEnableGpuDebugPrint)
     {
-        if (!CreateGpuDebugPrintResources(Device) || !CreateGpuDebugPrintPipeline(Device, BackBufferFormat) || !CreateGpuDebugPrintStatsPipeline(Device))
-        {
-            LogError("Deferred renderer initialization failed: GPU debug print setup failed");
-            return false;
-        }
+        RegisterShaderPipeline({ L"Shaders/GpuDebugPrint.hlsl" }, [this, Device, BackBufferFormat]() { return CreateGpuDebugPrintPipeline(Device, BackBufferFormat); });
+        RegisterShaderPipeline({ L"Shaders/GpuDebugPrintStats.hlsl" }, [this, Device]() { return CreateGpuDebugPrintStatsPipeline(Device); });
     }
+    InitializeVariableRateShading(Device, Width, Height, BackBufferFormat);
+
+    TrackPendingUploads(Device);
 
     LogInfo("Deferred renderer initialization completed");
     return true;
@@ -385,13 +538,29 @@ bool FDeferredRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
 
 void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_CPU_DESCRIPTOR_HANDLE& RtvHandle, const FCamera& Camera, float DeltaTime)
 {
+    CPU_PROFILE_SCOPE("Deferred Renderer");
+    FGpuMemoryOwnerScope MemoryScope(GetMemoryOwnerId());
     ID3D12GraphicsCommandList* CommandList = CmdContext.GetCommandList();
 
+    if (!IsSecondaryView())
+    {
+        WaitForPendingUploads(CmdContext);
+        ApplyStreamedTextures(CmdContext);
+        UpdateSceneTransforms(CmdContext);
+    }
     PrepareGpuDebugPrint(CmdContext);
 
+    // The scene renders to the top left of its full-size targets and TAA upscales it to the
+    // output, so the resolution only scales while TAA runs. Culling and streaming measure
+    // screen sizes at the render resolution. The views of RenderViews have no history of their own.
+    const bool bTaaActive = bTaaEnabled && TaaPipeline && TaaRootSignature && !TaaHistoryTextures.empty() && !IsRenderingMultipleViews();
+    UpdateRenderViewport(bTaaActive ? ResolutionScale : 1.0f);
+    const bool bFullResolution = RenderViewport.Width == Viewport.Width && RenderViewport.Height == Viewport.Height;
+
     UpdateCullingVisibility(Camera);
+    BuildSceneDrawList(Camera);
+    UpdateTextureMipStreaming(Camera);
 
-    const bool bTaaActive = bTaaEnabled && TaaPipeline && TaaRootSignature && !TaaHistoryTextures.empty();
     const uint32_t TaaFrameIndex = CmdContext.GetCurrentFrameIndex();
     const uint32_t TaaReadIndex = TaaFrameCount > 0 ? (TaaFrameIndex + TaaFrameCount - 1u) % TaaFrameCount : 0u;
     const uint32_t TaaWriteIndex = TaaFrameCount > 0 ? TaaFrameIndex % TaaFrameCount : 0u;
@@ -400,10 +569,12 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
     {
         bTaaHistoryReady = TaaHistoryValid[TaaReadIndex];
     }
+    const uint32_t TaaJitterPhaseCount = GetTaaJitterPhaseCount(RenderViewport.Width / (std::max)(Viewport.Width, 1.0f));
+
     bUseTaaJitter = bTaaActive && bTaaHistoryReady;
     if (bUseTaaJitter)
     {
-        TaaJitter = BuildTaaJitter(TaaSampleIndex);
+        TaaJitter = BuildTaaJitter(TaaSampleIndex % TaaJitterPhaseCount);
     }
     else
     {
@@ -412,27 +583,51 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
 
     DirectX::XMFLOAT4X4 ProjectionMatrix = {};
     DirectX::XMStoreFloat4x4(&ProjectionMatrix, Camera.GetProjectionMatrix());
-    if (bUseTaaJitter && Viewport.Width > 0.0f && Viewport.Height > 0.0f)
+    if (bUseTaaJitter && RenderViewport.Width > 0.0f && RenderViewport.Height > 0.0f)
     {
-        const float JitterX = (2.0f * TaaJitter.x) / Viewport.Width;
-        const float JitterY = (2.0f * TaaJitter.y) / Viewport.Height;
+        const float JitterX = (2.0f * TaaJitter.x) / RenderViewport.Width;
+        const float JitterY = (2.0f * TaaJitter.y) / RenderViewport.Height;
         ProjectionMatrix._31 += JitterX;
         ProjectionMatrix._32 += JitterY;
     }
     TaaProjection = DirectX::XMLoadFloat4x4(&ProjectionMatrix);
 
+    // Every geometry pass reads the same view constants. Writing them once here keeps
+    // pass recording free of shared writes, so those passes can record on task workers.
     const bool bRenderShadows = bShadowsEnabled && ShadowPipeline && ShadowMap;
-    const bool bDoDepthPrepass = bDepthPrepassEnabled && DepthPrepassPipeline;
-    if (!bDoDepthPrepass)
+    const uint32_t ShadowCascadeMask = UpdateShadowCascades(Camera, bRenderShadows);
+    UploadViewConstants(CmdContext, Camera, bUseTaaJitter ? TaaProjection : Camera.GetProjectionMatrix());
+
+    // Casters of every cascade rendered this frame are culled once, against a frustum enclosing them.
+    float ShadowCullingTexelScale = 1.0f;
+    const DirectX::XMMATRIX LightVP = ShadowCascades.BuildEnclosingViewProjection(ShadowCascadeMask, ShadowCullingTexelScale);
+    // Past the threshold of alpha-masked models the prepass runs regardless of the setting: it alpha
+    // tests them once, and the base pass then tests depth EQUAL without clipping, keeping early
+    // depth rejection. The meshlet base pass keeps its GREATER_EQUAL pipelines instead.
+    const bool bMaskedDepthPrepassForced = MaskedDepthPrepassThreshold > 0 && MaskedModelCount >= MaskedDepthPrepassThreshold;
+    const bool bMaskedDepthPrepass = (bDepthPrepassEnabled || bMaskedDepthPrepassForced)
+        && !bMeshShadersEnabled && DepthPrepassPipeline && MaskedDepthPrepassPipelines[0];
+    const bool bDoDepthPrepass = (bDepthPrepassEnabled && DepthPrepassPipeline) || bMaskedDepthPrepass;
+    // The HZB left by the previous view of RenderViews was built from another camera's depth.
+    if (!bDoDepthPrepass || IsRenderingMultipleViews() || bMultiViewHistoryStale)
     {
         bHZBReady = false;
     }
+    bMultiViewHistoryStale = false;
+
+    // The base pass shades at the rates built from the previous frame, then this frame's picture
+    // replaces them for the next one. Rates map tiles of the output, so frames rendered at a
+    // scaled resolution neither use nor rebuild them, and neither do the views of RenderViews.
+    const bool bApplyShadingRate = VariableRateShading.IsRateImageReady() && bFullResolution && !IsRenderingMultipleViews();
+    const bool bBuildShadingRate = VariableRateShading.IsActive() && bFullResolution && !IsRenderingMultipleViews();
 
-    FRenderGraph Graph;
+    FRenderGraph Graph(CmdContext);
     Graph.SetDevice(Device);
     Graph.SetBarrierLoggingEnabled(bLogResourceBarriers);
     Graph.SetGraphDumpEnabled(bEnableGraphDump);
     Graph.SetGpuTimingEnabled(bEnableGpuTiming);
+    Graph.SetPipelineStatisticsEnabled(bEnablePipelineStatistics);
+    Graph.SetParallelRecordingEnabled(bEnableParallelRecording);
 
     FRGResourceHandle ShadowHandle = Graph.ImportTexture(
         "ShadowMap",
@@ -461,6 +656,12 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
         Graph.ImportTexture("GBufferC", GBufferC.Get(), &GBufferStates[2], { static_cast<uint32>(Viewport.Width), static_cast<uint32>(Viewport.Height), GBufferFormats[2] }),
     };
 
+    FRGResourceHandle VelocityHandle = Graph.ImportTexture(
+        "Velocity",
+        VelocityTexture.Get(),
+        &VelocityState,
+        { static_cast<uint32>(Viewport.Width), static_cast<uint32>(Viewport.Height), VelocityFormat });
+
     FRGResourceHandle LightingHandle = Graph.ImportTexture(
         "Lighting",
         LightingBuffer.Get(),
@@ -505,10 +706,24 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
         &HZBState,
         { HZBWidth, HZBHeight, DXGI_FORMAT_R32_FLOAT });
 
+    FRGResourceHandle ShadingRateHandle;
+    if (bBuildShadingRate)
+    {
+        ShadingRateHandle = Graph.ImportTexture(
+            "ShadingRateImage",
+            VariableRateShading.GetRateImage(),
+            VariableRateShading.GetRateImageState(),
+            { VariableRateShading.GetRateImageWidth(), VariableRateShading.GetRateImageHeight(), DXGI_FORMAT_R8_UINT });
+    }
+
+    const FGpuDrivenBuffers GpuBuffers = ImportGpuDrivenBuffers(Graph);
+    const FSkyAtmosphereLuts SkyLuts = AddSkyAtmosphereLutPasses(Graph);
+
     struct FGpuCullingPassData
     {
         bool bEnabled = false;
         const FCamera* Camera = nullptr;
+        EGpuCullingPhase Phase = EGpuCullingPhase::Single;
     };
 
     if (!bHZBEnabled)
@@ -516,48 +731,129 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
         bHZBReady = false;
     }
 
-    const bool bUseHZBOcclusion = bHZBEnabled && bHZBReady && HZBSrvHandle.ptr != 0;
-    ConfigureHZBOcclusion(bUseHZBOcclusion, DescriptorHeap.Get(), HZBSrvHandle, HZBWidth, HZBHeight, HZBMipCount);
+    // Testing against the previous frame's HZB culls models that just came into view for a frame.
+    // With a depth prepass of indirect draws, the first culling phase draws last frame's visible
+    // models into depth, the HZB is rebuilt from it, and the second phase draws the rest that pass.
+    const bool bTwoPhaseOcclusion = bHZBEnabled && bDoDepthPrepass && bEnableIndirectDraw && !bMeshShadersEnabled
+        && IndirectCommandSignature && GetIndirectCommandBuffer() && !IndirectDrawRanges.empty()
+        && InstanceVisibilityBuffer && HZBSrvHandle.ptr != 0;
+    const bool bUseHZBOcclusion = !bTwoPhaseOcclusion && bHZBEnabled && bHZBReady && HZBSrvHandle.ptr != 0;
+    // The HZB is built over the part of the depth buffer the scene rendered to, and culling maps
+    // the screen onto the mip 0 texels that build filled: this frame's with two-phase occlusion,
+    // the previous frame's otherwise.
+    const uint32_t HZBRegionWidth = (std::min)(HZBWidth, (std::max)(1u, (static_cast<uint32_t>(RenderViewport.Width) + 1) / 2));
+    const uint32_t HZBRegionHeight = (std::min)(HZBHeight, (std::max)(1u, (static_cast<uint32_t>(RenderViewport.Height) + 1) / 2));
+    ConfigureHZBOcclusion(
+        bUseHZBOcclusion || bTwoPhaseOcclusion,
+        DescriptorHeap.Get(),
+        HZBSrvHandle,
+        bTwoPhaseOcclusion ? HZBRegionWidth : HZBContentWidth,
+        bTwoPhaseOcclusion ? HZBRegionHeight : HZBContentHeight,
+        HZBMipCount);
+    if (bMeshShadersEnabled)
+    {
+        UpdateMeshletCullingConstants(Camera, bUseHZBOcclusion);
+    }
 
-    Graph.AddPass<FGpuCullingPassData>("GPU Culling", [this, &Camera, DepthHandle, HZBHandle, bUseHZBOcclusion](FGpuCullingPassData& Data, FRGPassBuilder& Builder)
+    auto AddGpuCullingPass = [&](std::string_view PassName, EGpuCullingPhase Phase)
     {
-        Data.bEnabled = bEnableIndirectDraw && CullingPipeline && CullingRootSignature && GetIndirectCommandBuffer() && ModelBoundsBuffer;
-        Data.Camera = &Camera;
-        if (Data.bEnabled)
+        Graph.AddPass<FGpuCullingPassData>(PassName, [this, &Camera, HZBHandle, Phase, bUseHZBOcclusion, GpuBuffers](FGpuCullingPassData& Data, FRGPassBuilder& Builder)
         {
-            if (bUseHZBOcclusion)
+            Data.bEnabled = bEnableIndirectDraw && CullingPipeline && CullingRootSignature && GetIndirectCommandBuffer() && ModelBoundsBuffer;
+            Data.Camera = &Camera;
+            Data.Phase = Phase;
+            if (Data.bEnabled)
             {
-                Builder.ReadTexture(HZBHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+                if (Phase == EGpuCullingPhase::Second || (Phase == EGpuCullingPhase::Single && bUseHZBOcclusion))
+                {
+                    Builder.ReadTexture(HZBHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+                }
+                if (Phase != EGpuCullingPhase::Single)
+                {
+                    Builder.WriteBuffer(GpuBuffers.InstanceVisibility);
+                }
+                Builder.ReadBuffer(GpuBuffers.ModelBounds);
+                Builder.WriteBuffer(GpuBuffers.IndirectCommands);
+                Builder.WriteBuffer(GpuBuffers.CompactedCommands);
+                Builder.WriteBuffer(GpuBuffers.VisibleInstances);
+                Builder.WriteBuffer(GpuBuffers.DebugPrint);
+                Builder.WriteBuffer(GpuBuffers.DebugPrintStats);
+                Builder.KeepAlive();
+            }
+        }, [this](const FGpuCullingPassData& Data, FDX12CommandContext& Cmd)
+        {
+            if (!Data.bEnabled)
+            {
+                return;
             }
+
+            DispatchGpuCulling(Cmd, *Data.Camera, Data.Phase);
+        });
+    };
+
+    AddGpuCullingPass("GPU Culling", bTwoPhaseOcclusion ? EGpuCullingPhase::First : EGpuCullingPhase::Single);
+
+    struct FShadowCullingPassData
+    {
+        bool bEnabled = false;
+        const FCamera* Camera = nullptr;
+        DirectX::XMMATRIX LightViewProjection = DirectX::XMMatrixIdentity();
+        float TexelScale = 1.0f;
+    };
+
+    // Shadow casters are culled against the light's frustum on the GPU, so the shadow pass records
+    // one ExecuteIndirect per range however many models the scene has.
+    const bool bUseShadowIndirect = bRenderShadows && bEnableIndirectDraw && IndirectCommandSignature && !IndirectDrawRanges.empty()
+        && !ShadowCullingBuffers.empty() && CullingPipeline && CullingRootSignature && ModelBoundsBuffer;
+    Graph.AddPass<FShadowCullingPassData>("GPU Shadow Culling", [this, &Camera, LightVP, ShadowCullingTexelScale, bUseShadowIndirect, ShadowCascadeMask, GpuBuffers](FShadowCullingPassData& Data, FRGPassBuilder& Builder)
+    {
+        // Cached cascades and views after the first of RenderViews render no casters.
+        Data.bEnabled = bUseShadowIndirect && ShadowCascadeMask != 0;
+        Data.Camera = &Camera;
+        Data.LightViewProjection = LightVP;
+        Data.TexelScale = ShadowCullingTexelScale;
+        if (Data.bEnabled)
+        {
+            Builder.ReadBuffer(GpuBuffers.ModelBounds);
+            Builder.WriteBuffer(GpuBuffers.ShadowIndirectCommands);
+            Builder.WriteBuffer(GpuBuffers.ShadowCompactedCommands);
+            Builder.WriteBuffer(GpuBuffers.ShadowVisibleInstances);
             Builder.KeepAlive();
         }
-    }, [this](const FGpuCullingPassData& Data, FDX12CommandContext& Cmd)
+    }, [this](const FShadowCullingPassData& Data, FDX12CommandContext& Cmd)
     {
         if (!Data.bEnabled)
         {
             return;
         }
 
-        DispatchGpuCulling(Cmd, *Data.Camera);
+        DispatchGpuShadowCulling(Cmd, *Data.Camera, Data.LightViewProjection, Data.TexelScale);
     });
 
     struct FShadowPassData
     {
         bool bEnabled = false;
-        const FCamera* Camera = nullptr;
-        DirectX::XMMATRIX LightViewProjection = DirectX::XMMatrixIdentity();
+        bool bUseIndirect = false;
+        uint32_t CascadeMask = 0;
     };
 
-    Graph.AddPass<FShadowPassData>("ShadowMap", [&, bRenderShadows](FShadowPassData& Data, FRGPassBuilder& Builder)
+    Graph.AddPass<FShadowPassData>("ShadowMap", [&, bRenderShadows, bUseShadowIndirect, ShadowCascadeMask](FShadowPassData& Data, FRGPassBuilder& Builder)
     {
-        Data.bEnabled = bRenderShadows;
-        Data.Camera = &Camera;
-        Data.LightViewProjection = RendererUtils::BuildDirectionalLightViewProjection(SceneCenter, SceneRadius, LightDirection);
+        Data.bEnabled = bRenderShadows && ShadowCascadeMask != 0;
+        Data.bUseIndirect = bUseShadowIndirect;
+        Data.CascadeMask = ShadowCascadeMask;
 
         if (bRenderShadows)
         {
             Builder.WriteTexture(ShadowHandle, D3D12_RESOURCE_STATE_DEPTH_WRITE);
         }
+        if (bUseShadowIndirect)
+        {
+            Builder.ReadBuffer(GpuBuffers.ShadowIndirectCommands, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+            Builder.ReadBuffer(GpuBuffers.ShadowCompactedCommands, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+            Builder.ReadBuffer(GpuBuffers.ShadowVisibleInstances);
+        }
+        Builder.AllowParallelRecording();
     }, [this](const FShadowPassData& Data, FDX12CommandContext& Cmd)
     {
         if (!Data.bEnabled)
@@ -568,464 +864,176 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
         ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
 
         FScopedPixEvent ShadowEvent(LocalCommandList, L"ShadowMap");
-        Cmd.ClearDepth(ShadowDSVHandle, 1.0f);
 
         ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap.Get() };
         LocalCommandList->SetPipelineState(ShadowPipeline.Get());
         LocalCommandList->SetGraphicsRootSignature(BasePassRootSignature.Get());
+        BindSceneData(LocalCommandList);
         LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
 
         LocalCommandList->RSSetViewports(1, &ShadowViewport);
         LocalCommandList->RSSetScissorRects(1, &ShadowScissor);
         LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        LocalCommandList->OMSetRenderTargets(0, nullptr, FALSE, &ShadowDSVHandle);
-
-        std::vector<bool> ShadowVisibility;
-        ShadowVisibility.resize(SceneModels.size(), true);
-        DirectX::XMVECTOR ShadowPlanes[6] = {};
-        RendererUtils::BuildFrustumPlanesFromMatrix(Data.LightViewProjection, ShadowPlanes);
-        for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
-        {
-            const FSceneModelResource& Model = SceneModels[ModelIndex];
-            ShadowVisibility[ModelIndex] = RendererUtils::IsAabbInCameraFrustum(ShadowPlanes, Model.BoundsMin, Model.BoundsMax);
-        }
-
-        for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+        if (Data.bUseIndirect)
         {
-            const FSceneModelResource& Model = SceneModels[ModelIndex];
-            const uint64_t ConstantBufferOffset = SceneConstantBufferStride * ModelIndex;
-            UpdateSceneConstants(*Data.Camera, Model, ConstantBufferOffset);
+            // The depth-only shader draws masked materials opaque, so every range uses it.
+            BindShadowVisibleInstances(LocalCommandList);
+            RendererUtils::FGeometryBinding().BindPositions(LocalCommandList, SceneModels.front().Geometry);
+            LocalCommandList->SetGraphicsRootDescriptorTable(1, SceneDescriptors.GpuStart);
         }
 
-        for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+        // Cached cascades outside the mask keep last frame's slice. Each cascade binds the copy of
+        // the view constants that holds its matrix.
+        std::vector<bool> ShadowVisibility;
+        std::vector<uint32_t> ShadowModelIndices;
+        RendererUtils::FGeometryBinding GeometryBinding;
+        for (uint32_t CascadeIndex = 0; CascadeIndex < FShadowCascades::CascadeCount; ++CascadeIndex)
         {
-            if (!ShadowVisibility.empty() && !ShadowVisibility[ModelIndex])
+            if ((Data.CascadeMask & (1u << CascadeIndex)) == 0 || ShadowCascadeConstantsAddresses[CascadeIndex] == 0)
             {
                 continue;
             }
 
-            const FSceneModelResource& Model = SceneModels[ModelIndex];
-            const uint64_t ConstantBufferOffset = SceneConstantBufferStride * ModelIndex;
-
-            LocalCommandList->IASetVertexBuffers(0, 1, &Model.Geometry.VertexBufferView);
-            LocalCommandList->IASetIndexBuffer(&Model.Geometry.IndexBufferView);
+            const D3D12_CPU_DESCRIPTOR_HANDLE CascadeDsv = ShadowCascadeDSVHandles[CascadeIndex];
+            Cmd.ClearDepth(CascadeDsv, 1.0f);
+            LocalCommandList->OMSetRenderTargets(0, nullptr, FALSE, &CascadeDsv);
+            LocalCommandList->SetGraphicsRootConstantBufferView(0, ShadowCascadeConstantsAddresses[CascadeIndex]);
 
-            const D3D12_GPU_VIRTUAL_ADDRESS ConstantBufferAddress = GetSceneConstantBufferAddress();
-            LocalCommandList->SetGraphicsRootConstantBufferView(
-                0,
-                ConstantBufferAddress + ConstantBufferOffset);
-            LocalCommandList->SetGraphicsRootDescriptorTable(1, DescriptorHeap->GetGPUDescriptorHandleForHeapStart());
-
-            if (AreModelPixEventsEnabled())
+            if (Data.bUseIndirect)
             {
-                const std::wstring ModelLabel = Model.Name.empty()
-                    ? L"Model"
-                    : std::wstring(Model.Name.begin(), Model.Name.end());
-                FScopedPixEvent ModelEvent(LocalCommandList, ModelLabel.c_str());
-                LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
+                for (uint32_t RangeIndex = 0; RangeIndex < IndirectDrawRanges.size(); ++RangeIndex)
+                {
+                    ExecuteShadowIndirectRange(LocalCommandList, RangeIndex);
+                }
+                continue;
             }
-            else
+
+            RendererUtils::UpdateFrustumVisibility(ShadowCascades.GetViewProjection(CascadeIndex), SceneModels, SceneBvh, SceneBoundsSoA, ShadowModelIndices, ShadowVisibility);
+            for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
             {
-                LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
+                if (!ShadowVisibility.empty() && !ShadowVisibility[ModelIndex])
+                {
+                    continue;
+                }
+
+                const FSceneModelResource& Model = SceneModels[ModelIndex];
+
+                GeometryBinding.BindPositions(LocalCommandList, Model.Geometry);
+
+                BindSceneObject(LocalCommandList, static_cast<uint32_t>(ModelIndex));
+                LocalCommandList->SetGraphicsRootDescriptorTable(1, SceneDescriptors.GpuStart);
+
+                if (AreModelPixEventsEnabled())
+                {
+                    const std::wstring ModelLabel = Model.Name.empty()
+                        ? L"Model"
+                        : std::wstring(Model.Name.begin(), Model.Name.end());
+                    FScopedPixEvent ModelEvent(LocalCommandList, ModelLabel.c_str());
+                    LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
+                }
+                else
+                {
+                    LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
+                }
             }
         }
-
     });
 
-    struct FDepthPrepassData
+    struct FHZBPassData
     {
-        bool bEnabled = false;
-        const FCamera* Camera = nullptr;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t MipCount = 0;
+        uint32_t SourceWidth = 0;
+        uint32_t SourceHeight = 0;
+        D3D12_CPU_DESCRIPTOR_HANDLE DepthSrv{};
+        D3D12_GPU_DESCRIPTOR_HANDLE HZBSrv{};
+        std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> HZBSrvMips;
+        std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> HZBUavs;
+        D3D12_CPU_DESCRIPTOR_HANDLE HZBNullUav{};
     };
 
-    Graph.AddPass<FDepthPrepassData>("DepthPrepass", [&, bDoDepthPrepass](FDepthPrepassData& Data, FRGPassBuilder& Builder)
-    {
-        Data.bEnabled = bDoDepthPrepass;
-        Data.Camera = &Camera;
-
-        if (bDoDepthPrepass)
-        {
-            Builder.WriteTexture(DepthHandle, D3D12_RESOURCE_STATE_DEPTH_WRITE);
-        }
-    }, [this](const FDepthPrepassData& Data, FDX12CommandContext& Cmd)
+    auto AddBuildHZBPass = [&](ERGPassQueue Queue)
     {
-        if (!Data.bEnabled)
-        {
-            return;
-        }
-
-        ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
-
-        FScopedPixEvent DepthEvent(LocalCommandList, L"DepthPrepass");
-
-        Cmd.ClearDepth(GetDSVHandle());
-
-        ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap.Get() };
-        LocalCommandList->SetPipelineState(DepthPrepassPipeline.Get());
-        LocalCommandList->SetGraphicsRootSignature(BasePassRootSignature.Get());
-        LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
-
-        LocalCommandList->RSSetViewports(1, &Viewport);
-        LocalCommandList->RSSetScissorRects(1, &ScissorRect);
-
-        LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        const D3D12_CPU_DESCRIPTOR_HANDLE& DepthHandle = GetDSVHandle();
-        LocalCommandList->OMSetRenderTargets(0, nullptr, FALSE, &DepthHandle);
-
-        for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+        Graph.AddPass<FHZBPassData>("Build HZB", [&](FHZBPassData& Data, FRGPassBuilder& Builder)
         {
-            const FSceneModelResource& Model = SceneModels[ModelIndex];
-            const uint64_t ConstantBufferOffset = SceneConstantBufferStride * ModelIndex;
-            UpdateSceneConstants(*Data.Camera, Model, ConstantBufferOffset);
-        }
+            Data.Width = HZBRegionWidth;
+            Data.Height = HZBRegionHeight;
+            Data.MipCount = HZBMipCount;
+            Data.SourceWidth = static_cast<uint32_t>(RenderViewport.Width);
+            Data.SourceHeight = static_cast<uint32_t>(RenderViewport.Height);
+            HZBContentWidth = HZBRegionWidth;
+            HZBContentHeight = HZBRegionHeight;
+            const uint32_t DepthIndex = GetFrameIndex() % static_cast<uint32_t>(DepthBufferHandles.size());
+            Data.DepthSrv = DepthBufferHandles.empty() ? D3D12_CPU_DESCRIPTOR_HANDLE{} : DepthBufferHandles[DepthIndex];
+            Data.HZBSrv = HZBSrvHandle;
+            Data.HZBSrvMips = HZBSrvMipHandles;
+            Data.HZBUavs = HZBUavHandles;
+            Data.HZBNullUav = HZBNullUavHandle;
 
-        for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+            Builder.ReadTexture(DepthHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Builder.WriteTexture(HZBHandle, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        }, [this](const FHZBPassData& Data, FDX12CommandContext& Cmd)
         {
-            if (!SceneModelVisibility.empty() && !SceneModelVisibility[ModelIndex])
+            FDX12DescriptorAllocator* DescriptorAllocator = Cmd.GetDescriptorAllocator();
+            if (!HZBRootSignature || Data.MipCount == 0 || !DescriptorAllocator)
             {
-                continue;
+                return;
             }
 
-            const FSceneModelResource& Model = SceneModels[ModelIndex];
-            if (Model.AlphaMode == 1u)
-            {
-                continue;
-            }
-            const uint64_t ConstantBufferOffset = SceneConstantBufferStride * ModelIndex;
+            ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
 
-            LocalCommandList->IASetVertexBuffers(0, 1, &Model.Geometry.VertexBufferView);
-            LocalCommandList->IASetIndexBuffer(&Model.Geometry.IndexBufferView);
+            FScopedPixEvent HZBEvent(LocalCommandList, L"BuildHZB");
 
-            const D3D12_GPU_VIRTUAL_ADDRESS ConstantBufferAddress = GetSceneConstantBufferAddress();
-            LocalCommandList->SetGraphicsRootConstantBufferView(
-                0,
-                ConstantBufferAddress + ConstantBufferOffset);
-            LocalCommandList->SetGraphicsRootDescriptorTable(1, DescriptorHeap->GetGPUDescriptorHandleForHeapStart());
+            ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap.Get() };
+            LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
 
-            if (AreModelPixEventsEnabled())
+            // One dispatch for the whole chain avoids a UAV barrier and a drained pipeline per 4 mips.
+            if (HZBSinglePassPipeline && HZBSinglePassRootSignature && HZBGroupCounter && Data.MipCount <= HZBSinglePassMaxMips
+                && Data.DepthSrv.ptr != 0 && Data.HZBUavs.size() >= Data.MipCount && Data.HZBNullUav.ptr != 0)
             {
-                const std::wstring ModelLabel = Model.Name.empty()
-                    ? L"Model"
-                    : std::wstring(Model.Name.begin(), Model.Name.end());
-                FScopedPixEvent ModelEvent(LocalCommandList, ModelLabel.c_str());
-                LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
-            }
-            else
-            {
-                LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
-            }
-        }
-    });
-
-    struct FBasePassData
-    {
-        bool bDoDepthPrepass = false;
-        const FCamera* Camera = nullptr;
-    };
-
-    Graph.AddPass<FBasePassData>("GBuffer", [&](FBasePassData& Data, FRGPassBuilder& Builder)
-    {
-        Data.bDoDepthPrepass = bDoDepthPrepass;
-        Data.Camera = &Camera;
-
-        for (int i = 0; i < 3; ++i)
-        {
-            Builder.WriteTexture(GBufferHandles[i], D3D12_RESOURCE_STATE_RENDER_TARGET);
-        }
-
-        Builder.WriteTexture(LightingHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
-        Builder.WriteTexture(DepthHandle, D3D12_RESOURCE_STATE_DEPTH_WRITE);
-    }, [this](const FBasePassData& Data, FDX12CommandContext& Cmd)
-    {
-        ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
-
-        FScopedPixEvent GBufferEvent(LocalCommandList, L"GBuffer");
-
-        D3D12_CPU_DESCRIPTOR_HANDLE BasePassRTVs[4] =
-        {
-            GBufferRTVHandles[0],
-            GBufferRTVHandles[1],
-            GBufferRTVHandles[2],
-            LightingRTVHandle
-        };
-
-        if (!Data.bDoDepthPrepass)
-        {
-            Cmd.ClearDepth(GetDSVHandle());
-        }
-
-        for (const D3D12_CPU_DESCRIPTOR_HANDLE& Handle : GBufferRTVHandles)
-        {
-            const float ClearValue[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
-            Cmd.ClearRenderTarget(Handle, ClearValue);
-        }
-
-        const float SceneClear[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
-        Cmd.ClearRenderTarget(LightingRTVHandle, SceneClear);
-
-        LocalCommandList->SetGraphicsRootSignature(BasePassRootSignature.Get());
-
-        ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap.Get() };
-        LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
-        LocalCommandList->SetGraphicsRootDescriptorTable(1, DescriptorHeap->GetGPUDescriptorHandleForHeapStart());
-
-        LocalCommandList->RSSetViewports(1, &Viewport);
-        LocalCommandList->RSSetScissorRects(1, &ScissorRect);
-
-        LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        const D3D12_CPU_DESCRIPTOR_HANDLE& DepthHandle = GetDSVHandle();
-        LocalCommandList->OMSetRenderTargets(_countof(BasePassRTVs), BasePassRTVs, FALSE, &DepthHandle);
-
-        for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
-        {
-            const FSceneModelResource& Model = SceneModels[ModelIndex];
-            const uint64_t ConstantBufferOffset = SceneConstantBufferStride * ModelIndex;
-            UpdateSceneConstants(*Data.Camera, Model, ConstantBufferOffset);
-        }
-
-        ID3D12Resource* IndirectBuffer = GetIndirectCommandBuffer();
-        if (bEnableIndirectDraw && IndirectCommandSignature && IndirectBuffer && !IndirectDrawRanges.empty())
-        {
-            LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
-            auto SelectPipelineByKey = [&](uint32_t Key)
-            {
-                return BasePassPipelines[Key].Get();
-            };
-
-            for (const FIndirectDrawRange& Range : IndirectDrawRanges)
-            {
-                ID3D12PipelineState* Pipeline = SelectPipelineByKey(Range.PipelineKey);
-                LocalCommandList->SetPipelineState(Pipeline);
-                LocalCommandList->SetGraphicsRootDescriptorTable(1, Range.TextureHandle);
-
-                const uint64_t Offset = static_cast<uint64_t>(Range.Start) * sizeof(FIndirectDrawCommand);
-                if (AreModelPixEventsEnabled())
-                {
-                    const wchar_t* Label = Range.Name.empty() ? L"IndirectDrawRange" : Range.Name.c_str();
-                    FScopedPixEvent ModelEvent(LocalCommandList, Label);
-                    LocalCommandList->ExecuteIndirect(IndirectCommandSignature.Get(), Range.Count, IndirectBuffer, Offset, nullptr, 0);
-                }
-                else
-                {
-                    LocalCommandList->ExecuteIndirect(IndirectCommandSignature.Get(), Range.Count, IndirectBuffer, Offset, nullptr, 0);
-                }
-            }
-        }
-        else
-        {
-            for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
-            {
-                if (!SceneModelVisibility.empty() && !SceneModelVisibility[ModelIndex])
+                std::array<D3D12_CPU_DESCRIPTOR_HANDLE, 1 + HZBSinglePassMaxMips> TableSources;
+                TableSources[0] = Data.DepthSrv;
+                for (uint32_t Mip = 0; Mip < HZBSinglePassMaxMips; ++Mip)
                 {
-                    continue;
+                    TableSources[1 + Mip] = Mip < Data.MipCount ? Data.HZBUavs[Mip] : Data.HZBNullUav;
                 }
 
-                const FSceneModelResource& Model = SceneModels[ModelIndex];
-                const uint64_t ConstantBufferOffset = SceneConstantBufferStride * ModelIndex;
-
-                LocalCommandList->IASetVertexBuffers(0, 1, &Model.Geometry.VertexBufferView);
-                LocalCommandList->IASetIndexBuffer(&Model.Geometry.IndexBufferView);
-
-                const D3D12_GPU_VIRTUAL_ADDRESS ConstantBufferAddress = GetSceneConstantBufferAddress();
-                LocalCommandList->SetGraphicsRootConstantBufferView(0, ConstantBufferAddress + ConstantBufferOffset);
-                LocalCommandList->SetGraphicsRootDescriptorTable(1, Model.TextureHandle);
-
-                const bool bUseNormalMap = Model.bHasNormalMap;
-                const bool bUseMetallicRoughnessMap = !Model.MetallicRoughnessTexturePath.empty();
-                const bool bUseBaseColorMap = !Model.BaseColorTexturePath.empty();
-                const bool bUseEmissiveMap = !Model.EmissiveTexturePath.empty();
-                const bool bUseAlphaMask = Model.AlphaMode == 1u;
-
-                // Build pipeline key from material properties (bit 0: Normal, bit 1: MR, bit 2: BaseColor, bit 3: Emissive, bit 4: AlphaMask)
-                const uint32_t PipelineKey = 
-                    (bUseNormalMap ? 1u : 0u) |
-                    (bUseMetallicRoughnessMap ? 2u : 0u) |
-                    (bUseBaseColorMap ? 4u : 0u) |
-                    (bUseEmissiveMap ? 8u : 0u) |
-                    (bUseAlphaMask ? 16u : 0u);
-
-                LocalCommandList->SetPipelineState(BasePassPipelines[PipelineKey].Get());
-
-                if (AreModelPixEventsEnabled())
-                {
-                    const std::wstring ModelLabel = Model.Name.empty()
-                        ? L"Model"
-                        : std::wstring(Model.Name.begin(), Model.Name.end());
-                    FScopedPixEvent ModelEvent(LocalCommandList, ModelLabel.c_str());
-                    LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
-                }
-                else
+                const FDX12DescriptorRange Table = DescriptorAllocator->CopyToTransient(TableSources.data(), static_cast<uint32_t>(TableSources.size()));
+                if (Table.IsValid())
                 {
-                    LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
-                }
-            }
-        }
-
-    });
-
-    struct FObjectIdPassData
-    {
-        bool bEnabled = false;
-        const FCamera* Camera = nullptr;
-    };
-
-    Graph.AddPass<FObjectIdPassData>("ObjectId", [this, &Camera, ObjectIdHandle, DepthHandle](FObjectIdPassData& Data, FRGPassBuilder& Builder)
-    {
-        Data.bEnabled = bObjectIdReadbackRequested && ObjectIdPipeline && ObjectIdTexture;
-        Data.Camera = &Camera;
-        if (Data.bEnabled)
-        {
-            Builder.WriteTexture(ObjectIdHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
-            Builder.ReadTexture(DepthHandle, D3D12_RESOURCE_STATE_DEPTH_READ);
-        }
-    }, [this](const FObjectIdPassData& Data, FDX12CommandContext& Cmd)
-    {
-        if (!Data.bEnabled)
-        {
-            return;
-        }
-
-        ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
-
-        FScopedPixEvent ObjectIdEvent(LocalCommandList, L"ObjectIdPass");
-
-        LocalCommandList->SetPipelineState(ObjectIdPipeline.Get());
-        LocalCommandList->SetGraphicsRootSignature(BasePassRootSignature.Get());
-        LocalCommandList->RSSetViewports(1, &Viewport);
-        LocalCommandList->RSSetScissorRects(1, &ScissorRect);
-        LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        const D3D12_CPU_DESCRIPTOR_HANDLE& DepthHandle = GetDSVHandle();
-        LocalCommandList->OMSetRenderTargets(1, &ObjectIdRtvHandle, FALSE, &DepthHandle);
-
-        const UINT ClearValue[4] = { 0, 0, 0, 0 };
-        LocalCommandList->ClearRenderTargetView(ObjectIdRtvHandle, reinterpret_cast<const float*>(ClearValue), 0, nullptr);
-
-        for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
-        {
-            const FSceneModelResource& Model = SceneModels[ModelIndex];
-            const uint64_t ConstantBufferOffset = SceneConstantBufferStride * ModelIndex;
-            UpdateSceneConstants(*Data.Camera, Model, ConstantBufferOffset);
-        }
-
-        for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
-        {
-            if (!SceneModelVisibility.empty() && !SceneModelVisibility[ModelIndex])
-            {
-                continue;
-            }
-
-            const FSceneModelResource& Model = SceneModels[ModelIndex];
-            const uint64_t ConstantBufferOffset = SceneConstantBufferStride * ModelIndex;
-
-            LocalCommandList->IASetVertexBuffers(0, 1, &Model.Geometry.VertexBufferView);
-            LocalCommandList->IASetIndexBuffer(&Model.Geometry.IndexBufferView);
-
-            const D3D12_GPU_VIRTUAL_ADDRESS ConstantBufferAddress = GetSceneConstantBufferAddress();
-            LocalCommandList->SetGraphicsRootConstantBufferView(
-                0,
-                ConstantBufferAddress + ConstantBufferOffset);
-
-            if (AreModelPixEventsEnabled())
-            {
-                const std::wstring ModelLabel = Model.Name.empty()
-                    ? L"Model"
-                    : std::wstring(Model.Name.begin(), Model.Name.end());
-                FScopedPixEvent ModelEvent(LocalCommandList, ModelLabel.c_str());
-                LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
-            }
-            else
-            {
-                LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
-            }
-        }
-
-        const uint32_t Width = static_cast<uint32_t>(Viewport.Width);
-        const uint32_t Height = static_cast<uint32_t>(Viewport.Height);
-        const uint32_t ReadX = (std::min)(ObjectIdReadbackX, Width > 0 ? Width - 1 : 0);
-        const uint32_t ReadY = (std::min)(ObjectIdReadbackY, Height > 0 ? Height - 1 : 0);
-
-        D3D12_RESOURCE_BARRIER Barrier = {};
-        Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-        Barrier.Transition.pResource = ObjectIdTexture.Get();
-        Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-        Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
-        Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
-        LocalCommandList->ResourceBarrier(1, &Barrier);
-
-        D3D12_TEXTURE_COPY_LOCATION Src = {};
-        Src.pResource = ObjectIdTexture.Get();
-        Src.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-        Src.SubresourceIndex = 0;
-
-        D3D12_TEXTURE_COPY_LOCATION Dst = {};
-        Dst.pResource = ObjectIdReadback.Get();
-        Dst.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-        Dst.PlacedFootprint = ObjectIdFootprint;
-
-        D3D12_BOX SourceBox = {};
-        SourceBox.left = ReadX;
-        SourceBox.top = ReadY;
-        SourceBox.front = 0;
-        SourceBox.right = ReadX + 1;
-        SourceBox.bottom = ReadY + 1;
-        SourceBox.back = 1;
-
-        LocalCommandList->CopyTextureRegion(&Dst, 0, 0, 0, &Src, &SourceBox);
-
-        std::swap(Barrier.Transition.StateBefore, Barrier.Transition.StateAfter);
-        LocalCommandList->ResourceBarrier(1, &Barrier);
-
-        bObjectIdReadbackRecorded = true;
-    });
-
-    struct FHZBPassData
-    {
-        uint32_t Width = 0;
-        uint32_t Height = 0;
-        uint32_t MipCount = 0;
-        uint32_t SourceWidth = 0;
-        uint32_t SourceHeight = 0;
-        D3D12_GPU_DESCRIPTOR_HANDLE DepthSrv{};
-        D3D12_GPU_DESCRIPTOR_HANDLE HZBSrv{};
-        std::vector<D3D12_GPU_DESCRIPTOR_HANDLE> HZBSrvMips;
-        std::vector<D3D12_GPU_DESCRIPTOR_HANDLE> HZBUavs;
-        D3D12_GPU_DESCRIPTOR_HANDLE HZBNullUav{};
-    };
+                    const uint32_t GroupX = (Data.Width + 31) / 32;
+                    const uint32_t GroupY = (Data.Height + 31) / 32;
+                    const uint32_t Constants[] = { Data.SourceWidth, Data.SourceHeight, Data.Width, Data.Height, Data.MipCount, GroupX * GroupY };
+
+                    LocalCommandList->SetComputeRootSignature(HZBSinglePassRootSignature.Get());
+                    LocalCommandList->SetPipelineState(HZBSinglePassPipeline.Get());
+                    LocalCommandList->SetComputeRoot32BitConstants(0, _countof(Constants), Constants, 0);
+                    LocalCommandList->SetComputeRootDescriptorTable(1, Table.GetGpuHandle(0));
+                    LocalCommandList->SetComputeRootDescriptorTable(2, Table.GetGpuHandle(1));
+                    LocalCommandList->SetComputeRootUnorderedAccessView(3, HZBGroupCounter->GetGPUVirtualAddress());
+                    LocalCommandList->Dispatch(GroupX, GroupY, 1);
 
-    if (bHZBEnabled && bDoDepthPrepass)
-    {
-        Graph.AddPass<FHZBPassData>("Build HZB", [&](FHZBPassData& Data, FRGPassBuilder& Builder)
-        {
-            Data.Width = HZBWidth;
-            Data.Height = HZBHeight;
-            Data.MipCount = HZBMipCount;
-            ID3D12Resource* DepthBuffer = GetDepthBuffer();
-            const D3D12_RESOURCE_DESC DepthDesc = DepthBuffer ? DepthBuffer->GetDesc() : D3D12_RESOURCE_DESC{};
-            Data.SourceWidth = static_cast<uint32_t>(DepthDesc.Width);
-            Data.SourceHeight = DepthDesc.Height;
-            const uint32_t DepthIndex = GetFrameIndex() % static_cast<uint32_t>(DepthBufferHandles.size());
-            Data.DepthSrv = DepthBufferHandles.empty() ? D3D12_GPU_DESCRIPTOR_HANDLE{} : DepthBufferHandles[DepthIndex];
-            Data.HZBSrv = HZBSrvHandle;
-            Data.HZBSrvMips = HZBSrvMipHandles;
-            Data.HZBUavs = HZBUavHandles;
-            Data.HZBNullUav = HZBNullUavHandle;
+                    D3D12_RESOURCE_BARRIER Barrier = {};
+                    Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+                    Barrier.Transition.pResource = HierarchicalZBuffer.Get();
+                    Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+                    Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+                    Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+                    if (bLogResourceBarriers)
+                    {
+                        LogInfo("HZB Barrier: all mips "
+                            + RendererUtils::ResourceStateToString(Barrier.Transition.StateBefore) + " -> "
+                            + RendererUtils::ResourceStateToString(Barrier.Transition.StateAfter));
+                    }
+                    LocalCommandList->ResourceBarrier(1, &Barrier);
 
-            Builder.ReadTexture(DepthHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-            Builder.WriteTexture(HZBHandle, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-        }, [this](const FHZBPassData& Data, FDX12CommandContext& Cmd)
-        {
-            if (!HZBRootSignature || Data.MipCount == 0)
-            {
-                return;
+                    HZBState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+                    bHZBReady = true;
+                    return;
+                }
             }
 
-            ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
-
-            FScopedPixEvent HZBEvent(LocalCommandList, L"BuildHZB");
-
-            ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap.Get() };
-            LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
             LocalCommandList->SetComputeRootSignature(HZBRootSignature.Get());
 
             struct FHZBConstants
@@ -1081,11 +1089,11 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
                 Constants.DestHeight3 = DestHeight3;
                 Constants.SourceMip = 0u;
 
-                D3D12_GPU_DESCRIPTOR_HANDLE SourceHandle = Data.DepthSrv;
+                D3D12_CPU_DESCRIPTOR_HANDLE SourceHandle = Data.DepthSrv;
                 if (MipIndex > 0)
                 {
                     const uint32_t SourceMipIndex = MipIndex - 1;
-                    SourceHandle = (SourceMipIndex < Data.HZBSrvMips.size()) ? Data.HZBSrvMips[SourceMipIndex] : D3D12_GPU_DESCRIPTOR_HANDLE{};
+                    SourceHandle = (SourceMipIndex < Data.HZBSrvMips.size()) ? Data.HZBSrvMips[SourceMipIndex] : D3D12_CPU_DESCRIPTOR_HANDLE{};
 
                     if (SourceMipIndex < MipStates.size() && MipStates[SourceMipIndex] != D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE)
                     {
@@ -1106,14 +1114,14 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
                         MipStates[SourceMipIndex] = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
                     }
                 }
-                const D3D12_GPU_DESCRIPTOR_HANDLE DestHandle0 = (MipIndex < Data.HZBUavs.size()) ? Data.HZBUavs[MipIndex] : D3D12_GPU_DESCRIPTOR_HANDLE{};
-                const D3D12_GPU_DESCRIPTOR_HANDLE DestHandle1 = (bHasSecondMip && (MipIndex + 1) < Data.HZBUavs.size())
+                const D3D12_CPU_DESCRIPTOR_HANDLE DestHandle0 = (MipIndex < Data.HZBUavs.size()) ? Data.HZBUavs[MipIndex] : D3D12_CPU_DESCRIPTOR_HANDLE{};
+                const D3D12_CPU_DESCRIPTOR_HANDLE DestHandle1 = (bHasSecondMip && (MipIndex + 1) < Data.HZBUavs.size())
                     ? Data.HZBUavs[MipIndex + 1]
                     : Data.HZBNullUav;
-                const D3D12_GPU_DESCRIPTOR_HANDLE DestHandle2 = (bHasThirdMip && (MipIndex + 2) < Data.HZBUavs.size())
+                const D3D12_CPU_DESCRIPTOR_HANDLE DestHandle2 = (bHasThirdMip && (MipIndex + 2) < Data.HZBUavs.size())
                     ? Data.HZBUavs[MipIndex + 2]
                     : Data.HZBNullUav;
-                const D3D12_GPU_DESCRIPTOR_HANDLE DestHandle3 = (bHasFourthMip && (MipIndex + 3) < Data.HZBUavs.size())
+                const D3D12_CPU_DESCRIPTOR_HANDLE DestHandle3 = (bHasFourthMip && (MipIndex + 3) < Data.HZBUavs.size())
                     ? Data.HZBUavs[MipIndex + 3]
                     : Data.HZBNullUav;
 
@@ -1128,13 +1136,19 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
                     break;
                 }
 
+                const D3D12_CPU_DESCRIPTOR_HANDLE TableSources[] = { SourceHandle, DestHandle0, DestHandle1, DestHandle2, DestHandle3 };
+                const FDX12DescriptorRange Table = DescriptorAllocator->CopyToTransient(TableSources, _countof(TableSources));
+                if (!Table.IsValid())
+                {
+                    break;
+                }
+
                 LocalCommandList->SetPipelineState(SelectedPipeline);
                 LocalCommandList->SetComputeRoot32BitConstants(0, sizeof(Constants) / sizeof(uint32_t), &Constants, 0);
-                LocalCommandList->SetComputeRootDescriptorTable(1, SourceHandle);
-                LocalCommandList->SetComputeRootDescriptorTable(2, DestHandle0);
-                LocalCommandList->SetComputeRootDescriptorTable(3, DestHandle1);
-                LocalCommandList->SetComputeRootDescriptorTable(4, DestHandle2);
-                LocalCommandList->SetComputeRootDescriptorTable(5, DestHandle3);
+                for (uint32_t TableIndex = 0; TableIndex < _countof(TableSources); ++TableIndex)
+                {
+                    LocalCommandList->SetComputeRootDescriptorTable(1 + TableIndex, Table.GetGpuHandle(TableIndex));
+                }
 
                 const uint32_t GroupX = (Constants.DestWidth + 7) / 8;
                 const uint32_t GroupY = (Constants.DestHeight + 7) / 8;
@@ -1198,58 +1212,679 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
                     MipStates[TargetMip] = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
                 }
 
-                if (!Barriers.empty())
-                {
-                    LocalCommandList->ResourceBarrier(static_cast<UINT>(Barriers.size()), Barriers.data());
-                }
+                if (!Barriers.empty())
+                {
+                    LocalCommandList->ResourceBarrier(static_cast<UINT>(Barriers.size()), Barriers.data());
+                }
+
+                MipIndex += MipsThisDispatch;
+            }
+
+            HZBState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+            bHZBReady = true;
+        }, Queue);
+    };
+
+    struct FDepthPrepassData
+    {
+        bool bEnabled = false;
+        bool bUseMeshlets = false;
+        bool bUseHZBOcclusion = false;
+        // Alpha-masked models are drawn too, with the alpha-tested pipelines.
+        bool bDrawMasked = false;
+    };
+
+    Graph.AddPass<FDepthPrepassData>("DepthPrepass", [&, bDoDepthPrepass, bMaskedDepthPrepass, bUseHZBOcclusion](FDepthPrepassData& Data, FRGPassBuilder& Builder)
+    {
+        Data.bEnabled = bDoDepthPrepass;
+        Data.bUseMeshlets = bMeshShadersEnabled && MeshletDepthPrepassPipeline;
+        Data.bUseHZBOcclusion = bUseHZBOcclusion;
+        Data.bDrawMasked = bMaskedDepthPrepass && !Data.bUseMeshlets;
+
+        if (bDoDepthPrepass)
+        {
+            Builder.WriteTexture(DepthHandle, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+            if (Data.bUseMeshlets && bUseHZBOcclusion)
+            {
+                Builder.ReadTexture(HZBHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            }
+            if (bEnableIndirectDraw)
+            {
+                Builder.ReadBuffer(GpuBuffers.IndirectCommands, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+                Builder.ReadBuffer(GpuBuffers.CompactedCommands, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+                Builder.ReadBuffer(GpuBuffers.VisibleInstances);
+            }
+        }
+        Builder.AllowParallelRecording();
+    }, [this](const FDepthPrepassData& Data, FDX12CommandContext& Cmd)
+    {
+        if (!Data.bEnabled)
+        {
+            return;
+        }
+
+        ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
+
+        FScopedPixEvent DepthEvent(LocalCommandList, L"DepthPrepass");
+
+        Cmd.ClearDepth(GetDSVHandle());
+
+        ID3D12GraphicsCommandList6* MeshCommandList = Data.bUseMeshlets ? Cmd.GetCommandList6() : nullptr;
+        if (MeshCommandList)
+        {
+            LocalCommandList->SetPipelineState(MeshletDepthPrepassPipeline.Get());
+            BindMeshletPass(LocalCommandList, Data.bUseHZBOcclusion);
+
+            LocalCommandList->RSSetViewports(1, &RenderViewport);
+            LocalCommandList->RSSetScissorRects(1, &RenderScissorRect);
+            const D3D12_CPU_DESCRIPTOR_HANDLE& DepthHandle = GetDSVHandle();
+            LocalCommandList->OMSetRenderTargets(0, nullptr, FALSE, &DepthHandle);
+
+            for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+            {
+                if ((!SceneModelVisibility.empty() && !SceneModelVisibility[ModelIndex]) || SceneModels[ModelIndex].AlphaMode == 1u)
+                {
+                    continue;
+                }
+                DrawModelMeshlets(MeshCommandList, SceneModels[ModelIndex], ModelIndex);
+            }
+            return;
+        }
+
+        ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap.Get() };
+        LocalCommandList->SetPipelineState(DepthPrepassPipeline.Get());
+        LocalCommandList->SetGraphicsRootSignature(BasePassRootSignature.Get());
+        BindSceneData(LocalCommandList);
+        LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
+
+        LocalCommandList->RSSetViewports(1, &RenderViewport);
+        LocalCommandList->RSSetScissorRects(1, &RenderScissorRect);
+
+        LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        const D3D12_CPU_DESCRIPTOR_HANDLE& DepthHandle = GetDSVHandle();
+        LocalCommandList->OMSetRenderTargets(0, nullptr, FALSE, &DepthHandle);
+
+        // The base pass draws the LODs GPU culling picked, so the prepass must draw the same commands.
+        ID3D12Resource* IndirectBuffer = GetIndirectCommandBuffer();
+        if (bEnableIndirectDraw && IndirectCommandSignature && IndirectBuffer && !IndirectDrawRanges.empty())
+        {
+            RendererUtils::FGeometryBinding().BindPositions(LocalCommandList, SceneModels.front().Geometry);
+            LocalCommandList->SetGraphicsRootDescriptorTable(1, SceneDescriptors.GpuStart);
+            for (uint32_t RangeIndex = 0; RangeIndex < IndirectDrawRanges.size(); ++RangeIndex)
+            {
+                if ((IndirectDrawRanges[RangeIndex].PipelineKey & MaterialAlphaMaskKey) != 0)
+                {
+                    continue;
+                }
+
+                ExecuteIndirectRange(LocalCommandList, RangeIndex);
+            }
+            if (Data.bDrawMasked)
+            {
+                DrawMaskedDepthPrepassRanges(LocalCommandList, false);
+            }
+            return;
+        }
+
+        RendererUtils::FGeometryBinding GeometryBinding;
+        ID3D12PipelineState* BoundPipeline = DepthPrepassPipeline.Get();
+        for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+        {
+            if (!SceneModelVisibility.empty() && !SceneModelVisibility[ModelIndex])
+            {
+                continue;
+            }
+
+            const FSceneModelResource& Model = SceneModels[ModelIndex];
+            const bool bMasked = Model.AlphaMode == 1u;
+            if (bMasked && !Data.bDrawMasked)
+            {
+                continue;
+            }
+
+            ID3D12PipelineState* Pipeline = bMasked
+                ? SelectMaskedDepthPrepassPipeline(ResolveMaterialPipelineKey(RendererUtils::BuildMaterialPipelineKey(Model)))
+                : DepthPrepassPipeline.Get();
+            if (Pipeline != BoundPipeline)
+            {
+                LocalCommandList->SetPipelineState(Pipeline);
+                BoundPipeline = Pipeline;
+            }
+
+            // Masked models sample their base color, so they bind both vertex streams and their material table.
+            D3D12_GPU_DESCRIPTOR_HANDLE MaterialTable = SceneDescriptors.GpuStart;
+            if (bMasked)
+            {
+                GeometryBinding.Bind(LocalCommandList, Model.Geometry);
+                const D3D12_GPU_DESCRIPTOR_HANDLE ModelTable = ResolveMaterialTable(Model);
+                if (ModelTable.ptr != 0)
+                {
+                    MaterialTable = ModelTable;
+                }
+            }
+            else
+            {
+                GeometryBinding.BindPositions(LocalCommandList, Model.Geometry);
+            }
+
+            BindSceneObject(LocalCommandList, static_cast<uint32_t>(ModelIndex));
+            LocalCommandList->SetGraphicsRootDescriptorTable(1, MaterialTable);
+
+            if (AreModelPixEventsEnabled())
+            {
+                const std::wstring ModelLabel = Model.Name.empty()
+                    ? L"Model"
+                    : std::wstring(Model.Name.begin(), Model.Name.end());
+                FScopedPixEvent ModelEvent(LocalCommandList, ModelLabel.c_str());
+                LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
+            }
+            else
+            {
+                LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
+            }
+        }
+    });
+
+    if (bTwoPhaseOcclusion)
+    {
+        // The second phase waits on the HZB straight away, so building it on the compute queue
+        // would only add a fence.
+        AddBuildHZBPass(ERGPassQueue::Graphics);
+        AddGpuCullingPass("GPU Culling Phase Two", EGpuCullingPhase::Second);
+
+        Graph.AddPass<FDepthPrepassData>("DepthPrepass Phase Two", [&](FDepthPrepassData& Data, FRGPassBuilder& Builder)
+        {
+            Data.bEnabled = true;
+            Data.bDrawMasked = bMaskedDepthPrepass;
+            Builder.WriteTexture(DepthHandle, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+            Builder.ReadBuffer(GpuBuffers.IndirectCommands, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+            Builder.ReadBuffer(GpuBuffers.CompactedCommands, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+            Builder.ReadBuffer(GpuBuffers.VisibleInstances);
+            Builder.AllowParallelRecording();
+        }, [this](const FDepthPrepassData& Data, FDX12CommandContext& Cmd)
+        {
+            if (!Data.bEnabled)
+            {
+                return;
+            }
+
+            ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
+
+            FScopedPixEvent DepthEvent(LocalCommandList, L"DepthPrepassPhaseTwo");
+
+            ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap.Get() };
+            LocalCommandList->SetPipelineState(DepthPrepassPipeline.Get());
+            LocalCommandList->SetGraphicsRootSignature(BasePassRootSignature.Get());
+            BindSceneData(LocalCommandList);
+            LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
+
+            LocalCommandList->RSSetViewports(1, &RenderViewport);
+            LocalCommandList->RSSetScissorRects(1, &RenderScissorRect);
+
+            LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+            const D3D12_CPU_DESCRIPTOR_HANDLE& DepthHandle = GetDSVHandle();
+            LocalCommandList->OMSetRenderTargets(0, nullptr, FALSE, &DepthHandle);
+
+            RendererUtils::FGeometryBinding().BindPositions(LocalCommandList, SceneModels.front().Geometry);
+            LocalCommandList->SetGraphicsRootDescriptorTable(1, SceneDescriptors.GpuStart);
+            for (uint32_t RangeIndex = 0; RangeIndex < IndirectDrawRanges.size(); ++RangeIndex)
+            {
+                if ((IndirectDrawRanges[RangeIndex].PipelineKey & MaterialAlphaMaskKey) != 0)
+                {
+                    continue;
+                }
+
+                ExecuteIndirectRange(LocalCommandList, RangeIndex, true);
+            }
+            if (Data.bDrawMasked)
+            {
+                DrawMaskedDepthPrepassRanges(LocalCommandList, true);
+            }
+        });
+    }
+
+    // The base pass has the longest draw loop, so its recording is split across workers.
+    constexpr uint32_t BasePassMaxRecordingSlices = 4;
+
+    struct FBasePassData
+    {
+        bool bDoDepthPrepass = false;
+        // The prepass drew masked models too, so the vertex shader path uses BasePassEqualPipelines.
+        bool bDepthEqual = false;
+        bool bUseMeshlets = false;
+        bool bUseHZBOcclusion = false;
+        bool bTwoPhaseOcclusion = false;
+        bool bApplyShadingRate = false;
+    };
+
+    Graph.AddSlicedPass<FBasePassData>("GBuffer", BasePassMaxRecordingSlices, [&](FBasePassData& Data, FRGPassBuilder& Builder)
+    {
+        Data.bDoDepthPrepass = bDoDepthPrepass;
+        Data.bDepthEqual = bMaskedDepthPrepass;
+        Data.bUseMeshlets = bMeshShadersEnabled;
+        Data.bUseHZBOcclusion = bUseHZBOcclusion;
+        Data.bTwoPhaseOcclusion = bTwoPhaseOcclusion;
+        Data.bApplyShadingRate = bApplyShadingRate;
+
+        if (Data.bApplyShadingRate)
+        {
+            Builder.ReadTexture(ShadingRateHandle, D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE);
+        }
+
+        for (int i = 0; i < 3; ++i)
+        {
+            Builder.WriteTexture(GBufferHandles[i], D3D12_RESOURCE_STATE_RENDER_TARGET);
+        }
+
+        Builder.WriteTexture(LightingHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
+        Builder.WriteTexture(VelocityHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
+        Builder.WriteTexture(DepthHandle, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+
+        if (bMeshShadersEnabled && bUseHZBOcclusion)
+        {
+            Builder.ReadTexture(HZBHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        }
+
+        if (bEnableIndirectDraw)
+        {
+            Builder.ReadBuffer(GpuBuffers.IndirectCommands, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+            Builder.ReadBuffer(GpuBuffers.CompactedCommands, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+            Builder.ReadBuffer(GpuBuffers.VisibleInstances);
+        }
+    }, [this](const FBasePassData& Data, FDX12CommandContext& Cmd, uint32_t SliceIndex, uint32_t SliceCount)
+    {
+        ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
+
+        FScopedPixEvent GBufferEvent(LocalCommandList, L"GBuffer");
+
+        D3D12_CPU_DESCRIPTOR_HANDLE BasePassRTVs[5] =
+        {
+            GBufferRTVHandles[0],
+            GBufferRTVHandles[1],
+            GBufferRTVHandles[2],
+            LightingRTVHandle,
+            VelocityRTVHandle
+        };
+
+        // Slices execute in order, so only the first one clears.
+        if (SliceIndex == 0)
+        {
+            if (!Data.bDoDepthPrepass)
+            {
+                Cmd.ClearDepth(GetDSVHandle());
+            }
+
+            // Lighting and TAA tell sky from geometry by the cleared depth, so the G-buffer and
+            // velocity need no clear.
+            const float SceneClear[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+            Cmd.ClearRenderTarget(LightingRTVHandle, SceneClear);
+        }
+
+        LocalCommandList->SetGraphicsRootSignature(BasePassRootSignature.Get());
+        BindSceneData(LocalCommandList);
+
+        ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap.Get() };
+        LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
+        LocalCommandList->SetGraphicsRootDescriptorTable(1, SceneDescriptors.GpuStart);
+
+        LocalCommandList->RSSetViewports(1, &RenderViewport);
+        LocalCommandList->RSSetScissorRects(1, &RenderScissorRect);
+
+        LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        const D3D12_CPU_DESCRIPTOR_HANDLE& DepthHandle = GetDSVHandle();
+        LocalCommandList->OMSetRenderTargets(_countof(BasePassRTVs), BasePassRTVs, FALSE, &DepthHandle);
+
+        // Materials are sampled at the tile's rate; lighting still reads the G-buffer per pixel.
+        ID3D12GraphicsCommandList6* ShadingRateCommandList = Data.bApplyShadingRate ? Cmd.GetCommandList6() : nullptr;
+        VariableRateShading.Apply(ShadingRateCommandList);
+
+        ID3D12GraphicsCommandList6* MeshCommandList = Data.bUseMeshlets ? Cmd.GetCommandList6() : nullptr;
+        ID3D12Resource* IndirectBuffer = GetIndirectCommandBuffer();
+        if (MeshCommandList)
+        {
+            // Amplification shaders cull per meshlet, so the per-model CPU visibility still applies first.
+            BindMeshletPass(LocalCommandList, Data.bUseHZBOcclusion);
+
+            const std::vector<FDrawListEntry>& Draws = SceneDrawList.GetEntries();
+            const size_t DrawBegin = Draws.size() * SliceIndex / SliceCount;
+            const size_t DrawEnd = Draws.size() * (SliceIndex + 1) / SliceCount;
+            ID3D12PipelineState* BoundPipeline = nullptr;
+            UINT64 BoundMaterialTable = 0;
+            for (size_t DrawIndex = DrawBegin; DrawIndex < DrawEnd; ++DrawIndex)
+            {
+                const uint32_t ModelIndex = Draws[DrawIndex].ModelIndex;
+                const FSceneModelResource& Model = SceneModels[ModelIndex];
+                const D3D12_GPU_DESCRIPTOR_HANDLE MaterialTable = ResolveMaterialTable(Model);
+                if (MaterialTable.ptr != 0 && MaterialTable.ptr != BoundMaterialTable)
+                {
+                    LocalCommandList->SetGraphicsRootDescriptorTable(1, MaterialTable);
+                    BoundMaterialTable = MaterialTable.ptr;
+                }
+
+                ID3D12PipelineState* Pipeline = MeshletBasePassPipelines[ResolveMaterialPipelineKey(RendererUtils::BuildMaterialPipelineKey(Model))].Get();
+                if (Pipeline != BoundPipeline)
+                {
+                    LocalCommandList->SetPipelineState(Pipeline);
+                    BoundPipeline = Pipeline;
+                }
+                DrawModelMeshlets(MeshCommandList, Model, ModelIndex);
+            }
+        }
+        else if (bEnableIndirectDraw && IndirectCommandSignature && IndirectBuffer && !IndirectDrawRanges.empty())
+        {
+            LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+            // Indirect commands carry no vertex or index buffer views; every draw reads the shared scene buffers.
+            RendererUtils::FGeometryBinding().Bind(LocalCommandList, SceneModels.front().Geometry);
+
+            auto SelectPipelineByKey = [&](uint32_t Key)
+            {
+                return Data.bDepthEqual ? BasePassEqualPipelines[Key].Get() : BasePassPipelines[Key].Get();
+            };
+
+            const size_t RangeBegin = IndirectDrawRanges.size() * SliceIndex / SliceCount;
+            const size_t RangeEnd = IndirectDrawRanges.size() * (SliceIndex + 1) / SliceCount;
+            for (size_t RangeIndex = RangeBegin; RangeIndex < RangeEnd; ++RangeIndex)
+            {
+                const FIndirectDrawRange& Range = IndirectDrawRanges[RangeIndex];
+                ID3D12PipelineState* Pipeline = SelectPipelineByKey(Range.PipelineKey);
+                LocalCommandList->SetPipelineState(Pipeline);
+                if (Range.TextureHandle.ptr != 0)
+                {
+                    LocalCommandList->SetGraphicsRootDescriptorTable(1, Range.TextureHandle);
+                }
+
+                // The second culling phase fills the same ranges of the second command set.
+                if (AreModelPixEventsEnabled())
+                {
+                    const wchar_t* Label = Range.Name.empty() ? L"IndirectDrawRange" : Range.Name.c_str();
+                    FScopedPixEvent ModelEvent(LocalCommandList, Label);
+                    ExecuteIndirectRange(LocalCommandList, static_cast<uint32_t>(RangeIndex));
+                    if (Data.bTwoPhaseOcclusion)
+                    {
+                        ExecuteIndirectRange(LocalCommandList, static_cast<uint32_t>(RangeIndex), true);
+                    }
+                }
+                else
+                {
+                    ExecuteIndirectRange(LocalCommandList, static_cast<uint32_t>(RangeIndex));
+                    if (Data.bTwoPhaseOcclusion)
+                    {
+                        ExecuteIndirectRange(LocalCommandList, static_cast<uint32_t>(RangeIndex), true);
+                    }
+                }
+            }
+        }
+        else
+        {
+            // Slices split the sorted list, so each recording thread still sees runs of shared state.
+            const std::vector<FDrawListEntry>& Draws = SceneDrawList.GetEntries();
+            const size_t DrawBegin = Draws.size() * SliceIndex / SliceCount;
+            const size_t DrawEnd = Draws.size() * (SliceIndex + 1) / SliceCount;
+            RendererUtils::FGeometryBinding GeometryBinding;
+            ID3D12PipelineState* BoundPipeline = nullptr;
+            UINT64 BoundMaterialTable = 0;
+            for (size_t DrawIndex = DrawBegin; DrawIndex < DrawEnd; ++DrawIndex)
+            {
+                const uint32_t ModelIndex = Draws[DrawIndex].ModelIndex;
+                const FSceneModelResource& Model = SceneModels[ModelIndex];
+
+                GeometryBinding.Bind(LocalCommandList, Model.Geometry);
+
+                BindSceneObject(LocalCommandList, ModelIndex);
+                const D3D12_GPU_DESCRIPTOR_HANDLE MaterialTable = ResolveMaterialTable(Model);
+                if (MaterialTable.ptr != 0 && MaterialTable.ptr != BoundMaterialTable)
+                {
+                    LocalCommandList->SetGraphicsRootDescriptorTable(1, MaterialTable);
+                    BoundMaterialTable = MaterialTable.ptr;
+                }
+
+                const uint32_t PipelineKey = ResolveMaterialPipelineKey(RendererUtils::BuildMaterialPipelineKey(Model));
+                ID3D12PipelineState* Pipeline = Data.bDepthEqual ? BasePassEqualPipelines[PipelineKey].Get() : BasePassPipelines[PipelineKey].Get();
+                if (Pipeline != BoundPipeline)
+                {
+                    LocalCommandList->SetPipelineState(Pipeline);
+                    BoundPipeline = Pipeline;
+                }
+
+                if (AreModelPixEventsEnabled())
+                {
+                    const std::wstring ModelLabel = Model.Name.empty()
+                        ? L"Model"
+                        : std::wstring(Model.Name.begin(), Model.Name.end());
+                    FScopedPixEvent ModelEvent(LocalCommandList, ModelLabel.c_str());
+                    LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
+                }
+                else
+                {
+                    LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
+                }
+            }
+        }
+
+        FVariableRateShading::Reset(ShadingRateCommandList);
+    });
+
+    struct FObjectIdPassData
+    {
+        bool bEnabled = false;
+        const FCamera* Camera = nullptr;
+    };
+
+    // Reads the depth the scene drew and redraws only the models under the requested pixel.
+    Graph.AddPass<FObjectIdPassData>("ObjectId", [this, &Camera, ObjectIdHandle, DepthHandle](FObjectIdPassData& Data, FRGPassBuilder& Builder)
+    {
+        Data.bEnabled = bObjectIdReadbackRequested && ObjectIdPipeline && ObjectIdTexture;
+        Data.Camera = &Camera;
+        if (Data.bEnabled)
+        {
+            Builder.WriteTexture(ObjectIdHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
+            Builder.ReadTexture(DepthHandle, D3D12_RESOURCE_STATE_DEPTH_READ);
+        }
+        Builder.AllowParallelRecording();
+    }, [this](const FObjectIdPassData& Data, FDX12CommandContext& Cmd)
+    {
+        if (!Data.bEnabled)
+        {
+            return;
+        }
+
+        ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
+
+        FScopedPixEvent ObjectIdEvent(LocalCommandList, L"ObjectIdPass");
+
+        LocalCommandList->SetPipelineState(ObjectIdPipeline.Get());
+        LocalCommandList->SetGraphicsRootSignature(BasePassRootSignature.Get());
+        BindSceneData(LocalCommandList);
+        LocalCommandList->RSSetViewports(1, &RenderViewport);
+        LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        const D3D12_CPU_DESCRIPTOR_HANDLE& DepthHandle = GetDSVHandle();
+        LocalCommandList->OMSetRenderTargets(1, &ObjectIdRtvHandle, FALSE, &DepthHandle);
+
+        RecordObjectIdPick(LocalCommandList, *Data.Camera);
+    });
+
+    // Two-phase occlusion culling built this frame's HZB from the first phase's depth already.
+    if (bHZBEnabled && bDoDepthPrepass && !bTwoPhaseOcclusion)
+    {
+        AddBuildHZBPass(ERGPassQueue::AsyncCompute);
+    }
+
+    const FClusterConstants ClusterConstants = ClusteredLights.BuildConstants(Camera, RenderViewport);
+    FRGResourceHandle ClusterGridHandle;
+    if (ClusteredLights.HasLights())
+    {
+        ClusterGridHandle = Graph.ImportBuffer("ClusterLightGrid", ClusteredLights.GetClusterGridBuffer(), ClusteredLights.GetClusterGridState(), { ClusteredLights.GetClusterGridBuffer()->GetDesc().Width });
+
+        struct FLightClusteringPassData
+        {
+        };
+
+        Graph.AddPass<FLightClusteringPassData>("Light Clustering", [&](FLightClusteringPassData&, FRGPassBuilder& Builder)
+        {
+            Builder.WriteBuffer(ClusterGridHandle, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        }, [this, ClusterConstants](const FLightClusteringPassData&, FDX12CommandContext& Cmd)
+        {
+            ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
+            FScopedPixEvent ClusteringEvent(LocalCommandList, L"Light Clustering");
+            ClusteredLights.Dispatch(LocalCommandList, ViewConstantsAddress, ClusterConstants);
+        });
+    }
+
+    // Lighting reconstructs view depth from the depth buffer instead of a G-buffer channel.
+    const uint32_t LightingDepthIndex = DepthBufferHandles.empty() ? 0 : GetFrameIndex() % static_cast<uint32_t>(DepthBufferHandles.size());
+    const D3D12_CPU_DESCRIPTOR_HANDLE LightingDepthSrv = DepthBufferHandles.empty() ? D3D12_CPU_DESCRIPTOR_HANDLE{} : DepthBufferHandles[LightingDepthIndex];
+
+    // The tiled path classifies the screen's tiles first, so each lighting dispatch below only runs
+    // the kernel its tiles need and sky-only tiles are never lit.
+    const bool bUseTiledLighting = bTiledLightingEnabled && IsTiledLightingAvailable();
+    FRGResourceHandle TileDispatchArgsHandle;
+    FRGResourceHandle TileListHandle;
+    if (bUseTiledLighting)
+    {
+        // Only the tiles of the part the scene rendered to.
+        const uint32_t ClassifyCountX = (std::min)(TileCountX, (static_cast<uint32_t>(RenderViewport.Width) + 7u) / 8u);
+        const uint32_t ClassifyCountY = (std::min)(TileCountY, (static_cast<uint32_t>(RenderViewport.Height) + 7u) / 8u);
+
+        TileDispatchArgsHandle = Graph.ImportBuffer("TileDispatchArgs", TileDispatchArgsBuffer.Get(), &TileDispatchArgsState, { TileDispatchArgsBuffer->GetDesc().Width });
+        TileListHandle = Graph.ImportBuffer("TileLists", TileListBuffer.Get(), &TileListState, { TileListBuffer->GetDesc().Width });
+
+        struct FTileClassificationPassData
+        {
+        };
+
+        Graph.AddPass<FTileClassificationPassData>("Tile Classification", [&](FTileClassificationPassData&, FRGPassBuilder& Builder)
+        {
+            Builder.ReadTexture(DepthHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Builder.ReadTexture(GBufferHandles[0], D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Builder.ReadTexture(GBufferHandles[1], D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Builder.WriteBuffer(TileDispatchArgsHandle, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+            Builder.WriteBuffer(TileListHandle, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        }, [this, LightingDepthSrv, ClassifyCountX, ClassifyCountY](const FTileClassificationPassData&, FDX12CommandContext& Cmd)
+        {
+            const D3D12_GPU_DESCRIPTOR_HANDLE DepthTable = CopyDepthTable(Cmd, LightingDepthSrv);
+            if (DepthTable.ptr == 0)
+            {
+                return;
+            }
+
+            ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
+            FScopedPixEvent ClassificationEvent(LocalCommandList, L"Tile Classification");
+
+            ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap.Get() };
+            LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
+            BindTiledLightingRoot(LocalCommandList, DepthTable);
+
+            LocalCommandList->SetPipelineState(TileResetPipeline.Get());
+            LocalCommandList->Dispatch(1, 1, 1);
 
-                MipIndex += MipsThisDispatch;
-            }
+            D3D12_RESOURCE_BARRIER ResetBarrier = {};
+            ResetBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+            ResetBarrier.UAV.pResource = TileDispatchArgsBuffer.Get();
+            LocalCommandList->ResourceBarrier(1, &ResetBarrier);
 
-            HZBState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
-            bHZBReady = true;
+            LocalCommandList->SetPipelineState(TileClassifyPipeline.Get());
+            LocalCommandList->Dispatch(ClassifyCountX, ClassifyCountY, 1);
         });
     }
 
     struct FLightingPassData
     {
         bool bUseShadows = false;
+        bool bUseClusteredLights = false;
+        bool bTiled = false;
     };
 
     Graph.AddPass<FLightingPassData>("Lighting", [&](FLightingPassData& Data, FRGPassBuilder& Builder)
     {
         Data.bUseShadows = bRenderShadows;
+        Data.bUseClusteredLights = ClusteredLights.HasLights();
+        Data.bTiled = bUseTiledLighting;
 
-        Builder.ReadTexture(GBufferHandles[0], D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-        Builder.ReadTexture(GBufferHandles[1], D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-        Builder.ReadTexture(GBufferHandles[2], D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+        const D3D12_RESOURCE_STATES ReadState = Data.bTiled ? D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE : D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+        Builder.ReadTexture(DepthHandle, ReadState);
+        Builder.ReadTexture(GBufferHandles[0], ReadState);
+        Builder.ReadTexture(GBufferHandles[1], ReadState);
+        Builder.ReadTexture(GBufferHandles[2], ReadState);
 
         if (Data.bUseShadows)
         {
-            Builder.ReadTexture(ShadowHandle, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+            Builder.ReadTexture(ShadowHandle, ReadState);
+        }
+        if (Data.bUseClusteredLights)
+        {
+            Builder.ReadBuffer(ClusterGridHandle, ReadState);
+        }
+        if (SkyLuts.Transmittance)
+        {
+            Builder.ReadTexture(SkyLuts.Transmittance, ReadState);
         }
 
-        Builder.WriteTexture(LightingHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
-    }, [this](const FLightingPassData&, FDX12CommandContext& Cmd)
+        if (Data.bTiled)
+        {
+            Builder.ReadBuffer(TileDispatchArgsHandle, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+            Builder.ReadBuffer(TileListHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Builder.WriteTexture(LightingHandle, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        }
+        else
+        {
+            Builder.WriteTexture(LightingHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
+        }
+    }, [this, ClusterConstants, LightingDepthSrv](const FLightingPassData& Data, FDX12CommandContext& Cmd)
     {
+        const D3D12_GPU_DESCRIPTOR_HANDLE DepthTable = CopyDepthTable(Cmd, LightingDepthSrv);
+        if (DepthTable.ptr == 0)
+        {
+            return;
+        }
+
         ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
 
         FScopedPixEvent LightingEvent(LocalCommandList, L"Lighting");
 
         ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap.Get() };
         LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
+
+        // Without lights the shader skips the cluster loop on LightCount, so the SRVs may stay null.
+        const D3D12_GPU_VIRTUAL_ADDRESS LightBufferAddress = Data.bUseClusteredLights ? ClusteredLights.GetLightBuffer()->GetGPUVirtualAddress() : 0;
+        const D3D12_GPU_VIRTUAL_ADDRESS ClusterGridAddress = Data.bUseClusteredLights ? ClusteredLights.GetClusterGridBuffer()->GetGPUVirtualAddress() : 0;
+
+        if (Data.bTiled)
+        {
+            BindTiledLightingRoot(LocalCommandList, DepthTable);
+            LocalCommandList->SetComputeRoot32BitConstants(2, FClusteredLights::ConstantCount, &ClusterConstants, 0);
+            LocalCommandList->SetComputeRootShaderResourceView(3, LightBufferAddress);
+            LocalCommandList->SetComputeRootShaderResourceView(4, ClusterGridAddress);
+
+            for (uint32_t ClassIndex = 0; ClassIndex < TiledLightingPipelines.size(); ++ClassIndex)
+            {
+                LocalCommandList->SetPipelineState(TiledLightingPipelines[ClassIndex].Get());
+                LocalCommandList->ExecuteIndirect(
+                    TileDispatchSignature.Get(),
+                    1,
+                    TileDispatchArgsBuffer.Get(),
+                    sizeof(D3D12_DISPATCH_ARGUMENTS) * ClassIndex,
+                    nullptr,
+                    0);
+            }
+            return;
+        }
+
         Cmd.SetRenderTarget(LightingRTVHandle, nullptr);
 
         LocalCommandList->SetPipelineState(LightingPipeline.Get());
         LocalCommandList->SetGraphicsRootSignature(LightingRootSignature.Get());
         LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
 
-        LocalCommandList->RSSetViewports(1, &Viewport);
-        LocalCommandList->RSSetScissorRects(1, &ScissorRect);
+        LocalCommandList->RSSetViewports(1, &RenderViewport);
+        LocalCommandList->RSSetScissorRects(1, &RenderScissorRect);
 
         LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        LocalCommandList->SetGraphicsRootConstantBufferView(0, GetSceneConstantBufferAddress());
+        LocalCommandList->SetGraphicsRootConstantBufferView(0, ViewConstantsAddress);
         LocalCommandList->SetGraphicsRootDescriptorTable(1, GBufferGpuHandles[0]);
+        LocalCommandList->SetGraphicsRoot32BitConstants(2, FClusteredLights::ConstantCount, &ClusterConstants, 0);
+        LocalCommandList->SetGraphicsRootShaderResourceView(3, LightBufferAddress);
+        LocalCommandList->SetGraphicsRootShaderResourceView(4, ClusterGridAddress);
+        LocalCommandList->SetGraphicsRootDescriptorTable(5, DepthTable);
 
         LocalCommandList->DrawInstanced(3, 1, 0, 0);
     });
@@ -1257,17 +1892,19 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
     struct FSkyPassData
     {
         bool bEnabled = false;
-        const FCamera* Camera = nullptr;
+        DirectX::XMFLOAT3 SunIlluminance{};
     };
 
     Graph.AddPass<FSkyPassData>("Sky", [&](FSkyPassData& Data, FRGPassBuilder& Builder)
     {
-        Data.bEnabled = SkyPipelineState && SkyRootSignature && SkyGeometry.IndexCount > 0;
-        Data.Camera = &Camera;
+        Data.bEnabled = SkyAtmosphere.IsReady();
+        Data.SunIlluminance = { LightColor.x * LightIntensity, LightColor.y * LightIntensity, LightColor.z * LightIntensity };
 
         if (Data.bEnabled)
         {
             Builder.ReadTexture(DepthHandle, D3D12_RESOURCE_STATE_DEPTH_READ);
+            Builder.ReadTexture(SkyLuts.SkyView, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+            Builder.ReadTexture(SkyLuts.Transmittance, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
             Builder.WriteTexture(LightingHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
         }
     }, [this](const FSkyPassData& Data, FDX12CommandContext& Cmd)
@@ -1280,31 +1917,33 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
         ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
 
         FScopedPixEvent SkyEvent(LocalCommandList, L"SkyAtmosphere");
-        LocalCommandList->SetPipelineState(SkyPipelineState.Get());
-        LocalCommandList->SetGraphicsRootSignature(SkyRootSignature.Get());
-        LocalCommandList->RSSetViewports(1, &Viewport);
-        LocalCommandList->RSSetScissorRects(1, &ScissorRect);
-        LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        LocalCommandList->IASetVertexBuffers(0, 1, &SkyGeometry.VertexBufferView);
-        LocalCommandList->IASetIndexBuffer(&SkyGeometry.IndexBufferView);
+        LocalCommandList->RSSetViewports(1, &RenderViewport);
+        LocalCommandList->RSSetScissorRects(1, &RenderScissorRect);
         const D3D12_CPU_DESCRIPTOR_HANDLE& DepthHandle = GetDSVHandle();
         LocalCommandList->OMSetRenderTargets(1, &LightingRTVHandle, FALSE, &DepthHandle);
-
-        UpdateSkyConstants(*Data.Camera);
-        LocalCommandList->SetGraphicsRootConstantBufferView(0, SkyConstantBuffer->GetGPUVirtualAddress());
-        LocalCommandList->DrawIndexedInstanced(SkyGeometry.IndexCount, 1, 0, 0, 0);
+        SkyAtmosphere.Draw(LocalCommandList, ViewConstantsAddress, Data.SunIlluminance);
     });
 
     struct FTemporalAAPassData
     {
         bool bEnabled = false;
         DirectX::XMFLOAT2 OutputSize{};
+        DirectX::XMFLOAT2 InputSize{};
+        DirectX::XMFLOAT2 Jitter{};
+        DirectX::XMFLOAT4X4 ClipToPrevClip{};
         float HistoryWeight = 0.9f;
         uint32_t UseHistory = 0;
         uint32_t ReadIndex = 0;
         uint32_t WriteIndex = 0;
     };
 
+    // Pixels without velocity, the sky, reproject with the camera: this frame's clip space back to
+    // world space, then into the previous frame's.
+    DirectX::XMFLOAT4X4 ClipToPrevClip = {};
+    DirectX::XMStoreFloat4x4(&ClipToPrevClip, DirectX::XMMatrixMultiply(
+        DirectX::XMMatrixInverse(nullptr, DirectX::XMLoadFloat4x4(&CurrentViewProjection)),
+        DirectX::XMLoadFloat4x4(&PrevViewProjection)));
+
     Graph.AddPass<FTemporalAAPassData>("TemporalAA", [&](FTemporalAAPassData& Data, FRGPassBuilder& Builder)
     {
         Data.bEnabled = bTaaActive;
@@ -1313,13 +1952,18 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
             Data.ReadIndex = TaaReadIndex;
             Data.WriteIndex = TaaWriteIndex;
             Data.OutputSize = DirectX::XMFLOAT2(Viewport.Width, Viewport.Height);
+            Data.InputSize = DirectX::XMFLOAT2(RenderViewport.Width, RenderViewport.Height);
+            Data.Jitter = TaaJitter;
+            Data.ClipToPrevClip = ClipToPrevClip;
             Data.HistoryWeight = TaaHistoryWeight;
             Data.UseHistory = bTaaHistoryReady ? 1u : 0u;
             Builder.ReadTexture(LightingHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Builder.ReadTexture(VelocityHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Builder.ReadTexture(DepthHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
             Builder.ReadTexture(TaaHandles[Data.ReadIndex], D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
             Builder.WriteTexture(TaaHandles[Data.WriteIndex], D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
         }
-    }, [this](const FTemporalAAPassData& Data, FDX12CommandContext& Cmd)
+    }, [this, LightingDepthSrv](const FTemporalAAPassData& Data, FDX12CommandContext& Cmd)
     {
         if (!Data.bEnabled)
         {
@@ -1330,12 +1974,26 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
 
         FScopedPixEvent TaaEvent(LocalCommandList, L"TemporalAA");
 
+        FDX12DescriptorAllocator* DescriptorAllocator = Cmd.GetDescriptorAllocator();
+        const D3D12_CPU_DESCRIPTOR_HANDLE MotionSources[2] = { VelocitySrvHandle, LightingDepthSrv };
+        const FDX12DescriptorRange MotionTable = DescriptorAllocator && LightingDepthSrv.ptr != 0
+            ? DescriptorAllocator->CopyToTransient(MotionSources, 2)
+            : FDX12DescriptorRange{};
+        if (!MotionTable.IsValid())
+        {
+            return;
+        }
+
         struct FTemporalAAConstants
         {
             uint32_t OutputWidth;
             uint32_t OutputHeight;
             float HistoryWeight;
             uint32_t UseHistory;
+            uint32_t InputWidth;
+            uint32_t InputHeight;
+            DirectX::XMFLOAT2 Jitter;
+            DirectX::XMFLOAT4X4 ClipToPrevClip;
         };
 
         const FTemporalAAConstants Constants =
@@ -1343,7 +2001,11 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
             static_cast<uint32_t>(Data.OutputSize.x),
             static_cast<uint32_t>(Data.OutputSize.y),
             Data.HistoryWeight,
-            Data.UseHistory
+            Data.UseHistory,
+            static_cast<uint32_t>(Data.InputSize.x),
+            static_cast<uint32_t>(Data.InputSize.y),
+            Data.Jitter,
+            Data.ClipToPrevClip
         };
 
         ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap.Get() };
@@ -1354,6 +2016,7 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
         LocalCommandList->SetComputeRootDescriptorTable(1, LightingBufferHandle);
         LocalCommandList->SetComputeRootDescriptorTable(2, TaaSrvHandles[Data.ReadIndex]);
         LocalCommandList->SetComputeRootDescriptorTable(3, TaaUavHandles[Data.WriteIndex]);
+        LocalCommandList->SetComputeRootDescriptorTable(4, MotionTable.GetGpuHandle(0));
 
         const uint32_t GroupX = (static_cast<uint32_t>(Data.OutputSize.x) + 7u) / 8u;
         const uint32_t GroupY = (static_cast<uint32_t>(Data.OutputSize.y) + 7u) / 8u;
@@ -1363,6 +2026,7 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
     struct FAutoExposurePassData
     {
         bool bEnabled = false;
+        D3D12_GPU_DESCRIPTOR_HANDLE InputTable{};
         DirectX::XMFLOAT2 InputSize{};
         float DeltaTime = 0.0f;
         float AdaptationSpeedUp = 3.0f;
@@ -1372,11 +2036,14 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
         uint32_t WriteIndex = 0;
     };
 
+    // Meters the resolved TAA output when TAA runs, which covers the whole output at any render
+    // resolution.
     Graph.AddPass<FAutoExposurePassData>("AutoExposure", [&](FAutoExposurePassData& Data, FRGPassBuilder& Builder)
     {
         Data.bEnabled = bAutoExposureEnabled && AutoExposurePipeline && AutoExposureRootSignature;
         if (Data.bEnabled)
         {
+            Data.InputTable = bTaaActive ? TaaSrvHandles[TaaWriteIndex] : LightingBufferHandle;
             Data.ReadIndex = 1u - LuminanceWriteIndex;
             Data.WriteIndex = LuminanceWriteIndex;
             Data.InputSize = DirectX::XMFLOAT2(Viewport.Width, Viewport.Height);
@@ -1384,7 +2051,7 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
             Data.AdaptationSpeedUp = AutoExposureSpeedUp;
             Data.AdaptationSpeedDown = AutoExposureSpeedDown;
             Data.UseHistory = bLuminanceHistoryValid ? 1u : 0u;
-            Builder.ReadTexture(LightingHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Builder.ReadTexture(bTaaActive ? TaaHandles[TaaWriteIndex] : LightingHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
             Builder.ReadTexture(LuminanceHandles[Data.ReadIndex], D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
             Builder.WriteTexture(LuminanceHandles[Data.WriteIndex], D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
         }
@@ -1428,16 +2095,177 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
         LocalCommandList->SetComputeRootSignature(AutoExposureRootSignature.Get());
         LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
         LocalCommandList->SetComputeRoot32BitConstants(0, sizeof(Constants) / sizeof(uint32_t), &Constants, 0);
-        LocalCommandList->SetComputeRootDescriptorTable(1, LightingBufferHandle);
+        LocalCommandList->SetComputeRootDescriptorTable(1, Data.InputTable);
         LocalCommandList->SetComputeRootDescriptorTable(2, LuminanceSrvHandles[Data.ReadIndex]);
         LocalCommandList->SetComputeRootDescriptorTable(3, LuminanceUavHandles[Data.WriteIndex]);
         LocalCommandList->Dispatch(1, 1, 1);
     });
 
+    struct FShadingRatePassData
+    {
+        bool bEnabled = false;
+        bool bUseAutoExposure = false;
+        uint32_t LuminanceIndex = 0;
+        D3D12_GPU_DESCRIPTOR_HANDLE ColorTable{};
+        FShadingRateConstants Constants;
+    };
+
+    // Rates come from the picture the tonemapper sees: the resolved TAA history when TAA runs, at
+    // the exposure it applies.
+    Graph.AddPass<FShadingRatePassData>("Shading Rate", [&](FShadingRatePassData& Data, FRGPassBuilder& Builder)
+    {
+        Data.bEnabled = bBuildShadingRate;
+        if (!Data.bEnabled)
+        {
+            return;
+        }
+
+        Data.bUseAutoExposure = bAutoExposureEnabled;
+        Data.LuminanceIndex = LuminanceWriteIndex;
+        Data.ColorTable = bTaaActive ? TaaSrvHandles[TaaWriteIndex] : LightingBufferHandle;
+        const DirectX::XMMATRIX ViewProjection = DirectX::XMMatrixMultiply(Camera.GetViewMatrix(), Camera.GetProjectionMatrix());
+        Data.Constants = VariableRateShading.BuildConstants(ViewProjection, TonemapExposure, Data.bUseAutoExposure, false);
+
+        Builder.ReadTexture(bTaaActive ? TaaHandles[TaaWriteIndex] : LightingHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        Builder.ReadTexture(DepthHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        if (Data.bUseAutoExposure)
+        {
+            Builder.ReadTexture(LuminanceHandles[Data.LuminanceIndex], D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        }
+        Builder.WriteTexture(ShadingRateHandle, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    }, [this, LightingDepthSrv](const FShadingRatePassData& Data, FDX12CommandContext& Cmd)
+    {
+        if (!Data.bEnabled)
+        {
+            return;
+        }
+
+        const D3D12_GPU_DESCRIPTOR_HANDLE DepthTable = CopyDepthTable(Cmd, LightingDepthSrv);
+        if (DepthTable.ptr == 0)
+        {
+            return;
+        }
+
+        ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
+        FScopedPixEvent ShadingRateEvent(LocalCommandList, L"Shading Rate");
+
+        ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap.Get() };
+        LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
+        const D3D12_GPU_DESCRIPTOR_HANDLE ExposureTable = Data.bUseAutoExposure ? LuminanceSrvHandles[Data.LuminanceIndex] : VariableRateShading.GetNullSrv();
+        VariableRateShading.Dispatch(LocalCommandList, ViewConstantsAddress, Data.Constants, Data.ColorTable, DepthTable, ExposureTable);
+    });
+
     const bool bCasActive = bCasEnabled && CasPipeline && CasRootSignature;
 
+    // Tonemap and CAS fold into one compute pass over the resolved TAA output, which writes the
+    // back buffer directly and skips TonemapOutput's write and reread.
+    const bool bFusedPostActive = bFusedPostEnabled && bTaaActive && bCasActive && FusedPostPipeline && FusedPostRootSignature
+        && OutputTarget && (OutputTarget->GetDesc().Flags & D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS) != 0;
+
+    // The back buffer arrives and must leave in RENDER_TARGET; the passes after the fused one draw into it.
+    D3D12_RESOURCE_STATES OutputTargetState = D3D12_RESOURCE_STATE_RENDER_TARGET;
+    FRGResourceHandle OutputTargetHandle;
+    if (bFusedPostActive)
+    {
+        OutputTargetHandle = Graph.ImportTexture(
+            "BackBuffer",
+            OutputTarget,
+            &OutputTargetState,
+            { static_cast<uint32>(Viewport.Width), static_cast<uint32>(Viewport.Height), OutputTarget->GetDesc().Format });
+    }
+
+    struct FFusedPostPassData
+    {
+        bool bEnabled = false;
+        D3D12_GPU_DESCRIPTOR_HANDLE InputHandle{};
+        uint32_t LuminanceIndex = 0;
+    };
+
+    Graph.AddPass<FFusedPostPassData>("Fused Post", [&](FFusedPostPassData& Data, FRGPassBuilder& Builder)
+    {
+        Data.bEnabled = bFusedPostActive;
+        if (!Data.bEnabled)
+        {
+            return;
+        }
+
+        Data.InputHandle = TaaSrvHandles[TaaWriteIndex];
+        Data.LuminanceIndex = LuminanceWriteIndex;
+        Builder.ReadTexture(TaaHandles[TaaWriteIndex], D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        Builder.ReadTexture(LuminanceHandles[Data.LuminanceIndex], D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        Builder.WriteTexture(OutputTargetHandle, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        // The G-buffer returns to RENDER_TARGET for the next frame, as the tonemap pass does.
+        for (int i = 0; i < 3; ++i)
+        {
+            Builder.WriteTexture(GBufferHandles[i], D3D12_RESOURCE_STATE_RENDER_TARGET);
+        }
+    }, [this](const FFusedPostPassData& Data, FDX12CommandContext& Cmd)
+    {
+        if (!Data.bEnabled)
+        {
+            return;
+        }
+
+        FDX12DescriptorAllocator* DescriptorAllocator = Cmd.GetDescriptorAllocator();
+        const FDX12DescriptorRange OutputTable = DescriptorAllocator ? DescriptorAllocator->AllocateTransient(1) : FDX12DescriptorRange{};
+        if (!OutputTable.IsValid())
+        {
+            return;
+        }
+
+        D3D12_UNORDERED_ACCESS_VIEW_DESC UavDesc = {};
+        UavDesc.Format = OutputTarget->GetDesc().Format;
+        UavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+        Device->GetDevice()->CreateUnorderedAccessView(OutputTarget, nullptr, &UavDesc, OutputTable.GetCpuHandle(0));
+
+        ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
+        FScopedPixEvent FusedPostEvent(LocalCommandList, L"Fused Post");
+
+        struct FFusedPostConstants
+        {
+            uint32_t OutputWidth;
+            uint32_t OutputHeight;
+            uint32_t Enabled;
+            uint32_t AutoExposureEnabled;
+            float Exposure;
+            float Gamma;
+            float Sharpness;
+            float Padding;
+        };
+
+        const FFusedPostConstants Constants =
+        {
+            static_cast<uint32_t>(Viewport.Width),
+            static_cast<uint32_t>(Viewport.Height),
+            bTonemapEnabled ? 1u : 0u,
+            bAutoExposureEnabled ? 1u : 0u,
+            TonemapExposure,
+            TonemapGamma,
+            CasSharpness,
+            0.0f
+        };
+
+        ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap.Get() };
+        LocalCommandList->SetPipelineState(FusedPostPipeline.Get());
+        LocalCommandList->SetComputeRootSignature(FusedPostRootSignature.Get());
+        LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
+        LocalCommandList->SetComputeRoot32BitConstants(0, sizeof(Constants) / sizeof(uint32_t), &Constants, 0);
+        LocalCommandList->SetComputeRootDescriptorTable(1, Data.InputHandle);
+        LocalCommandList->SetComputeRootDescriptorTable(2, LuminanceSrvHandles[Data.LuminanceIndex]);
+        LocalCommandList->SetComputeRootDescriptorTable(3, OutputTable.GetGpuHandle(0));
+
+        // 8x8 tiles, FUSED_POST_TILE_SIZE in Shaders/FusedPost.hlsl.
+        const uint32_t GroupX = (Constants.OutputWidth + 7u) / 8u;
+        const uint32_t GroupY = (Constants.OutputHeight + 7u) / 8u;
+        LocalCommandList->Dispatch(GroupX, GroupY, 1);
+
+        Cmd.TransitionResource(LightingBuffer.Get(), LightingBufferState, D3D12_RESOURCE_STATE_RENDER_TARGET);
+        LightingBufferState = D3D12_RESOURCE_STATE_RENDER_TARGET;
+    });
+
     struct FTonemapPassData
     {
+        bool bEnabled = false;
         D3D12_CPU_DESCRIPTOR_HANDLE OutputHandle{};
         D3D12_GPU_DESCRIPTOR_HANDLE InputHandle{};
         bool bUseCas = false;
@@ -1448,6 +2276,12 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
 
     Graph.AddPass<FTonemapPassData>("Tonemap", [&](FTonemapPassData& Data, FRGPassBuilder& Builder)
     {
+        Data.bEnabled = !bFusedPostActive;
+        if (!Data.bEnabled)
+        {
+            return;
+        }
+
         Data.bUseCas = bCasActive;
         Data.OutputHandle = Data.bUseCas ? TonemapOutputRtvHandle : RtvHandle;
         Data.bUseAutoExposure = bAutoExposureEnabled;
@@ -1473,6 +2307,11 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
         }
     }, [this](const FTonemapPassData& Data, FDX12CommandContext& Cmd)
     {
+        if (!Data.bEnabled)
+        {
+            return;
+        }
+
         ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
 
         FScopedPixEvent TonemapEvent(LocalCommandList, L"Tonemap");
@@ -1523,7 +2362,7 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
 
     Graph.AddPass<FCasPassData>("CAS", [&](FCasPassData& Data, FRGPassBuilder& Builder)
     {
-        Data.bEnabled = bCasActive;
+        Data.bEnabled = bCasActive && !bFusedPostActive;
         if (!Data.bEnabled)
         {
             return;
@@ -1572,18 +2411,83 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
         LocalCommandList->DrawInstanced(3, 1, 0, 0);
     });
 
+    struct FShadingRateOverlayPassData
+    {
+        bool bEnabled = false;
+        D3D12_CPU_DESCRIPTOR_HANDLE OutputHandle{};
+    };
+
+    Graph.AddPass<FShadingRateOverlayPassData>("Shading Rate Overlay", [&](FShadingRateOverlayPassData& Data, FRGPassBuilder& Builder)
+    {
+        Data.bEnabled = bBuildShadingRate && VariableRateShading.IsOverlayEnabled();
+        Data.OutputHandle = RtvHandle;
+        if (Data.bEnabled)
+        {
+            Builder.ReadTexture(ShadingRateHandle, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+            if (OutputTargetHandle)
+            {
+                Builder.WriteTexture(OutputTargetHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
+            }
+        }
+    }, [this](const FShadingRateOverlayPassData& Data, FDX12CommandContext& Cmd)
+    {
+        if (!Data.bEnabled)
+        {
+            return;
+        }
+
+        ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
+        FScopedPixEvent OverlayEvent(LocalCommandList, L"Shading Rate Overlay");
+        Cmd.SetRenderTarget(Data.OutputHandle, nullptr);
+
+        ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap.Get() };
+        LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
+        VariableRateShading.DrawOverlay(LocalCommandList, Viewport, ScissorRect);
+    });
+
+    AddGpuCullingStatsReadbackPass(Graph, GpuBuffers);
+
+    struct FDebugPrintStatsPassData
+    {
+        bool bEnabled = false;
+    };
+
+    Graph.AddPass<FDebugPrintStatsPassData>("GpuDebugPrintStats", [this, GpuBuffers](FDebugPrintStatsPassData& Data, FRGPassBuilder& Builder)
+    {
+        Data.bEnabled = bEnableGpuDebugPrint && GpuDebugPrintStatsPipeline && GpuDebugPrintStatsRootSignature && GpuDebugPrintDescriptorHeap;
+        if (Data.bEnabled)
+        {
+            Builder.ReadBuffer(GpuBuffers.DebugPrintStats);
+            Builder.WriteBuffer(GpuBuffers.DebugPrint);
+            Builder.KeepAlive();
+        }
+    }, [this](const FDebugPrintStatsPassData& Data, FDX12CommandContext& Cmd)
+    {
+        if (!Data.bEnabled)
+        {
+            return;
+        }
+
+        DispatchGpuDebugPrintStats(Cmd);
+    });
+
     struct FDebugPrintPassData
     {
         bool bEnabled = false;
         D3D12_CPU_DESCRIPTOR_HANDLE OutputHandle{};
     };
 
-    Graph.AddPass<FDebugPrintPassData>("GpuDebugPrint", [this, RtvHandle](FDebugPrintPassData& Data, FRGPassBuilder& Builder)
+    Graph.AddPass<FDebugPrintPassData>("GpuDebugPrint", [this, RtvHandle, GpuBuffers, OutputTargetHandle](FDebugPrintPassData& Data, FRGPassBuilder& Builder)
     {
         Data.bEnabled = bEnableGpuDebugPrint && GpuDebugPrintPipeline && GpuDebugPrintRootSignature && GpuDebugPrintDescriptorHeap;
         Data.OutputHandle = RtvHandle;
         if (Data.bEnabled)
         {
+            Builder.ReadBuffer(GpuBuffers.DebugPrint);
+            if (OutputTargetHandle)
+            {
+                Builder.WriteTexture(OutputTargetHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
+            }
             Builder.KeepAlive();
         }
     }, [this](const FDebugPrintPassData& Data, FDX12CommandContext& Cmd)
@@ -1593,15 +2497,20 @@ void FDeferredRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12
             return;
         }
 
-        DispatchGpuDebugPrintStats(Cmd);
         RenderGpuDebugPrint(Cmd, Data.OutputHandle);
     });
 
     Graph.Execute(CmdContext);
 
+    // ImGui and Present expect the state Application left the back buffer in.
+    if (OutputTargetState != D3D12_RESOURCE_STATE_RENDER_TARGET)
+    {
+        CmdContext.TransitionResource(OutputTarget, OutputTargetState, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    }
+
     if (bTaaActive)
     {
-        TaaSampleIndex = (TaaSampleIndex + 1u) % 8u;
+        TaaSampleIndex = (TaaSampleIndex + 1u) % TaaJitterPhaseCount;
     }
     else
     {
@@ -1630,8 +2539,106 @@ bool FDeferredRenderer::CreateBasePassRootSignature(FDX12Device* Device)
     DescriptorRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_NONE;
     DescriptorRange.OffsetInDescriptorsFromTableStart = 0;
 
-    D3D12_ROOT_PARAMETER1 RootParams[2] = {};
-    // RootParams[0]: Scene constant buffer (b0)
+    D3D12_ROOT_PARAMETER1 RootParams[6] = {};
+    // RootParams[0]: View constant buffer (b0)
+    RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    RootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[0].Descriptor.ShaderRegister = 0;
+    RootParams[0].Descriptor.RegisterSpace = 0;
+    RootParams[0].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+
+    // RootParams[1]: Base pass material texture SRV table (t0..t3)
+    RootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    RootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+    RootParams[1].DescriptorTable.NumDescriptorRanges = 1;
+    RootParams[1].DescriptorTable.pDescriptorRanges = &DescriptorRange;
+
+    // RootParams[2]: Instance base and draw object constants (b0, space2); indirect commands write the base
+    RootParams[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    RootParams[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+    RootParams[2].Constants.ShaderRegister = 0;
+    RootParams[2].Constants.RegisterSpace = 2;
+    RootParams[2].Constants.Num32BitValues = 2;
+
+    // RootParams[3]: VisibleInstances SRV (t0, space2)
+    RootParams[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    RootParams[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+    RootParams[3].Descriptor.ShaderRegister = 0;
+    RootParams[3].Descriptor.RegisterSpace = 2;
+    RootParams[3].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+
+    // RootParams[4]: SceneObjects SRV (t1, space2), read by the vertex shader and for the pixel's material
+    RootParams[4].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    RootParams[4].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[4].Descriptor.ShaderRegister = 1;
+    RootParams[4].Descriptor.RegisterSpace = 2;
+    RootParams[4].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+
+    // RootParams[5]: SceneMaterials SRV (t2, space2)
+    RootParams[5].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    RootParams[5].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+    RootParams[5].Descriptor.ShaderRegister = 2;
+    RootParams[5].Descriptor.RegisterSpace = 2;
+    RootParams[5].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+
+    D3D12_STATIC_SAMPLER_DESC SamplerDesc = {};
+    SamplerDesc.Filter = D3D12_FILTER_ANISOTROPIC;
+    SamplerDesc.AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+    SamplerDesc.AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+    SamplerDesc.AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+    SamplerDesc.MipLODBias = 0.0f;
+    SamplerDesc.MaxAnisotropy = 4;
+    SamplerDesc.ComparisonFunc = D3D12_COMPARISON_FUNC_ALWAYS;
+    SamplerDesc.BorderColor = D3D12_STATIC_BORDER_COLOR_OPAQUE_WHITE;
+    SamplerDesc.MinLOD = 0.0f;
+    SamplerDesc.MaxLOD = D3D12_FLOAT32_MAX;
+    SamplerDesc.ShaderRegister = 0;
+    SamplerDesc.RegisterSpace = 0;
+    SamplerDesc.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+    D3D12_VERSIONED_ROOT_SIGNATURE_DESC RootSigDesc = {};
+    RootSigDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
+    RootSigDesc.Desc_1_1.NumParameters = _countof(RootParams);
+    RootSigDesc.Desc_1_1.pParameters = RootParams;
+    RootSigDesc.Desc_1_1.NumStaticSamplers = 1;
+    RootSigDesc.Desc_1_1.pStaticSamplers = &SamplerDesc;
+    RootSigDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+    if (bBindlessMaterials)
+    {
+        RootSigDesc.Desc_1_1.Flags |= D3D12_ROOT_SIGNATURE_FLAG_CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED;
+    }
+
+    ComPtr<ID3DBlob> SerializedSig;
+    ComPtr<ID3DBlob> ErrorBlob;
+    HR_CHECK(D3D12SerializeVersionedRootSignature(&RootSigDesc, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf()));
+
+    if (ErrorBlob)
+    {
+        OutputDebugStringA(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
+    }
+
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), BasePassRootSignature.ReleaseAndGetAddressOf()));
+    return true;
+}
+
+bool FDeferredRenderer::CreateMeshletRootSignature(FDX12Device* Device)
+{
+    D3D12_DESCRIPTOR_RANGE1 MaterialRange = {};
+    MaterialRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    MaterialRange.NumDescriptors = 4;
+    MaterialRange.BaseShaderRegister = 0;
+    MaterialRange.RegisterSpace = 0;
+    MaterialRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_NONE;
+    MaterialRange.OffsetInDescriptorsFromTableStart = 0;
+
+    D3D12_DESCRIPTOR_RANGE1 HZBRange = MaterialRange;
+    HZBRange.NumDescriptors = 1;
+    HZBRange.BaseShaderRegister = 4;
+    HZBRange.RegisterSpace = 1;
+
+    // Parameters 0 and 1 match the base pass root signature.
+    D3D12_ROOT_PARAMETER1 RootParams[11] = {};
+    // RootParams[0]: View constant buffer (b0)
     RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
     RootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
     RootParams[0].Descriptor.ShaderRegister = 0;
@@ -1642,7 +2649,52 @@ bool FDeferredRenderer::CreateBasePassRootSignature(FDX12Device* Device)
     RootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
     RootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
     RootParams[1].DescriptorTable.NumDescriptorRanges = 1;
-    RootParams[1].DescriptorTable.pDescriptorRanges = &DescriptorRange;
+    RootParams[1].DescriptorTable.pDescriptorRanges = &MaterialRange;
+
+    // RootParams[2]: Per-model meshlet range, attribute stream offset and scene object index (b1)
+    RootParams[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    RootParams[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[2].Constants.ShaderRegister = 1;
+    RootParams[2].Constants.RegisterSpace = 0;
+    RootParams[2].Constants.Num32BitValues = 4;
+
+    // RootParams[3]: Culling camera and HZB parameters (b2)
+    RootParams[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    RootParams[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_AMPLIFICATION;
+    RootParams[3].Constants.ShaderRegister = 2;
+    RootParams[3].Constants.RegisterSpace = 0;
+    RootParams[3].Constants.Num32BitValues = static_cast<UINT>(MeshletCullingConstants.size());
+
+    // RootParams[4..7]: Meshlets, meshlet vertices, meshlet triangles, scene vertex buffer (t0..t3, space1)
+    for (UINT Index = 0; Index < 4; ++Index)
+    {
+        D3D12_ROOT_PARAMETER1& Param = RootParams[4 + Index];
+        Param.ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+        Param.ShaderVisibility = Index == 0 ? D3D12_SHADER_VISIBILITY_ALL : D3D12_SHADER_VISIBILITY_MESH;
+        Param.Descriptor.ShaderRegister = Index;
+        Param.Descriptor.RegisterSpace = 1;
+        Param.Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC;
+    }
+
+    // RootParams[8]: HZB SRV table (t4, space1)
+    RootParams[8].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    RootParams[8].ShaderVisibility = D3D12_SHADER_VISIBILITY_AMPLIFICATION;
+    RootParams[8].DescriptorTable.NumDescriptorRanges = 1;
+    RootParams[8].DescriptorTable.pDescriptorRanges = &HZBRange;
+
+    // RootParams[9]: SceneObjects SRV (t1, space2)
+    RootParams[9].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    RootParams[9].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[9].Descriptor.ShaderRegister = 1;
+    RootParams[9].Descriptor.RegisterSpace = 2;
+    RootParams[9].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+
+    // RootParams[10]: SceneMaterials SRV (t2, space2)
+    RootParams[10].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    RootParams[10].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+    RootParams[10].Descriptor.ShaderRegister = 2;
+    RootParams[10].Descriptor.RegisterSpace = 2;
+    RootParams[10].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
 
     D3D12_STATIC_SAMPLER_DESC SamplerDesc = {};
     SamplerDesc.Filter = D3D12_FILTER_ANISOTROPIC;
@@ -1665,25 +2717,148 @@ bool FDeferredRenderer::CreateBasePassRootSignature(FDX12Device* Device)
     RootSigDesc.Desc_1_1.pParameters = RootParams;
     RootSigDesc.Desc_1_1.NumStaticSamplers = 1;
     RootSigDesc.Desc_1_1.pStaticSamplers = &SamplerDesc;
-    RootSigDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+    RootSigDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
+    if (bBindlessMaterials)
+    {
+        RootSigDesc.Desc_1_1.Flags |= D3D12_ROOT_SIGNATURE_FLAG_CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED;
+    }
 
     ComPtr<ID3DBlob> SerializedSig;
     ComPtr<ID3DBlob> ErrorBlob;
-    HR_CHECK(D3D12SerializeVersionedRootSignature(&RootSigDesc, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf()));
+    if (FAILED(D3D12SerializeVersionedRootSignature(&RootSigDesc, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf())))
+    {
+        if (ErrorBlob)
+        {
+            OutputDebugStringA(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
+        }
+        return false;
+    }
 
-    if (ErrorBlob)
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), MeshletRootSignature.ReleaseAndGetAddressOf()));
+    return MeshletRootSignature != nullptr;
+}
+
+void FDeferredRenderer::UpdateMeshletCullingConstants(const FCamera& Camera, bool bUseHZBOcclusion)
+{
+    const FCamera* CullingCamera = GetCullingCameraOverride();
+    if (!CullingCamera)
     {
-        OutputDebugStringA(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
+        CullingCamera = &Camera;
     }
 
-    HR_CHECK(Device->GetDevice()->CreateRootSignature(0, SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), IID_PPV_ARGS(BasePassRootSignature.GetAddressOf())));
-    return true;
+    DirectX::XMVECTOR Planes[6] = {};
+    RendererUtils::BuildCameraFrustumPlanes(*CullingCamera, Planes);
+    for (uint32_t PlaneIndex = 0; PlaneIndex < 6; ++PlaneIndex)
+    {
+        DirectX::XMFLOAT4 Plane;
+        DirectX::XMStoreFloat4(&Plane, Planes[PlaneIndex]);
+        std::memcpy(MeshletCullingConstants.data() + PlaneIndex * 4, &Plane, sizeof(DirectX::XMFLOAT4));
+    }
+
+    DirectX::XMFLOAT4X4 ViewProjection = {};
+    DirectX::XMStoreFloat4x4(&ViewProjection, CullingCamera->GetViewMatrix() * CullingCamera->GetProjectionMatrix());
+    std::memcpy(MeshletCullingConstants.data() + 24, &ViewProjection, sizeof(DirectX::XMFLOAT4X4));
+
+    const DirectX::XMFLOAT3 CameraPosition = CullingCamera->GetPosition();
+    std::memcpy(MeshletCullingConstants.data() + 40, &CameraPosition, sizeof(DirectX::XMFLOAT3));
+    MeshletCullingConstants[43] = bUseHZBOcclusion ? 1u : 0u;
+    MeshletCullingConstants[44] = HZBMipCount;
+    MeshletCullingConstants[45] = HZBContentWidth;
+    MeshletCullingConstants[46] = HZBContentHeight;
+}
+
+void FDeferredRenderer::BindMeshletPass(ID3D12GraphicsCommandList* CommandList, bool bUseHZBOcclusion) const
+{
+    const FMeshGeometryBuffers& Geometry = SceneModels.front().Geometry;
+    const D3D12_GPU_VIRTUAL_ADDRESS MeshletAddress = Geometry.MeshletBuffer->GetGPUVirtualAddress();
+
+    CommandList->SetGraphicsRootSignature(MeshletRootSignature.Get());
+    ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap.Get() };
+    CommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
+    CommandList->SetGraphicsRootConstantBufferView(0, ViewConstantsAddress);
+    CommandList->SetGraphicsRootDescriptorTable(1, SceneDescriptors.GpuStart);
+    CommandList->SetGraphicsRoot32BitConstants(3, static_cast<UINT>(MeshletCullingConstants.size()), MeshletCullingConstants.data(), 0);
+    CommandList->SetGraphicsRootShaderResourceView(4, MeshletAddress);
+    CommandList->SetGraphicsRootShaderResourceView(5, MeshletAddress + Geometry.MeshletVertexOffset);
+    CommandList->SetGraphicsRootShaderResourceView(6, MeshletAddress + Geometry.MeshletTriangleOffset);
+    CommandList->SetGraphicsRootShaderResourceView(7, Geometry.VertexBuffer->GetGPUVirtualAddress());
+    if (bUseHZBOcclusion)
+    {
+        CommandList->SetGraphicsRootDescriptorTable(8, HZBSrvHandle);
+    }
+    CommandList->SetGraphicsRootShaderResourceView(9, SceneObjectBuffer->GetGPUVirtualAddress());
+    CommandList->SetGraphicsRootShaderResourceView(10, SceneMaterialBuffer->GetGPUVirtualAddress());
+}
+
+ID3D12PipelineState* FDeferredRenderer::SelectMaskedDepthPrepassPipeline(uint32_t PipelineKey) const
+{
+    // Bit 2 is the base color map; bindless keys never carry it.
+    return MaskedDepthPrepassPipelines[(PipelineKey & 4u) != 0 ? 1 : 0].Get();
+}
+
+void FDeferredRenderer::DrawMaskedDepthPrepassRanges(ID3D12GraphicsCommandList* CommandList, bool bSecondPhase) const
+{
+    RendererUtils::FGeometryBinding().Bind(CommandList, SceneModels.front().Geometry);
+
+    ID3D12PipelineState* BoundPipeline = nullptr;
+    for (uint32_t RangeIndex = 0; RangeIndex < IndirectDrawRanges.size(); ++RangeIndex)
+    {
+        const FIndirectDrawRange& Range = IndirectDrawRanges[RangeIndex];
+        if ((Range.PipelineKey & MaterialAlphaMaskKey) == 0)
+        {
+            continue;
+        }
+
+        ID3D12PipelineState* Pipeline = SelectMaskedDepthPrepassPipeline(Range.PipelineKey);
+        if (Pipeline != BoundPipeline)
+        {
+            CommandList->SetPipelineState(Pipeline);
+            BoundPipeline = Pipeline;
+        }
+        if (Range.TextureHandle.ptr != 0)
+        {
+            CommandList->SetGraphicsRootDescriptorTable(1, Range.TextureHandle);
+        }
+        ExecuteIndirectRange(CommandList, RangeIndex, bSecondPhase);
+    }
+}
+
+void FDeferredRenderer::DrawModelMeshlets(ID3D12GraphicsCommandList6* CommandList, const FSceneModelResource& Model, size_t ModelIndex) const
+{
+    if (Model.MeshletCount == 0)
+    {
+        return;
+    }
+
+    const uint32_t DrawConstants[4] =
+    {
+        Model.MeshletStart,
+        Model.MeshletCount,
+        static_cast<uint32_t>(Model.Geometry.VertexBufferView.BufferLocation - Model.Geometry.PositionBufferView.BufferLocation),
+        static_cast<uint32_t>(ModelIndex)
+    };
+
+    CommandList->SetGraphicsRoot32BitConstants(2, _countof(DrawConstants), DrawConstants, 0);
+
+    const uint32_t GroupCount = (Model.MeshletCount + MeshletsPerAmplificationGroup - 1) / MeshletsPerAmplificationGroup;
+    if (AreModelPixEventsEnabled())
+    {
+        const std::wstring ModelLabel = Model.Name.empty()
+            ? L"Model"
+            : std::wstring(Model.Name.begin(), Model.Name.end());
+        FScopedPixEvent ModelEvent(CommandList, ModelLabel.c_str());
+        CommandList->DispatchMesh(GroupCount, 1, 1);
+    }
+    else
+    {
+        CommandList->DispatchMesh(GroupCount, 1, 1);
+    }
 }
 
 bool FDeferredRenderer::CreateLightingRootSignature(FDX12Device* Device)
 {
-    D3D12_DESCRIPTOR_RANGE1 DescriptorRanges[6] = {};
-    for (int i = 0; i < 6; ++i)
+    D3D12_DESCRIPTOR_RANGE1 DescriptorRanges[7] = {};
+    for (int i = 0; i < 7; ++i)
     {
         DescriptorRanges[i].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
         DescriptorRanges[i].NumDescriptors = 1;
@@ -1692,8 +2867,19 @@ bool FDeferredRenderer::CreateLightingRootSignature(FDX12Device* Device)
         DescriptorRanges[i].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_NONE;
         DescriptorRanges[i].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
     }
+    // The sky's transmittance LUT follows the BRDF LUT in the heap, past the root SRVs' registers.
+    DescriptorRanges[6].BaseShaderRegister = 10;
+    DescriptorRanges[6].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
+
+    D3D12_DESCRIPTOR_RANGE1 DepthRange = {};
+    DepthRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    DepthRange.NumDescriptors = 1;
+    DepthRange.BaseShaderRegister = 8;
+    DepthRange.RegisterSpace = 0;
+    DepthRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
+    DepthRange.OffsetInDescriptorsFromTableStart = 0;
 
-    D3D12_ROOT_PARAMETER1 RootParams[2] = {};
+    D3D12_ROOT_PARAMETER1 RootParams[6] = {};
     // RootParams[0]: Lighting constants (b0)
     RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
     RootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
@@ -1701,48 +2887,38 @@ bool FDeferredRenderer::CreateLightingRootSignature(FDX12Device* Device)
     RootParams[0].Descriptor.RegisterSpace = 0;
     RootParams[0].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
 
-    // RootParams[1]: GBuffer/IBL/shadow SRV table (t0..t5)
+    // RootParams[1]: GBuffer/IBL/shadow/sky transmittance SRV table (t0..t5, t10)
     RootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
     RootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
     RootParams[1].DescriptorTable.NumDescriptorRanges = _countof(DescriptorRanges);
     RootParams[1].DescriptorTable.pDescriptorRanges = DescriptorRanges;
 
-    D3D12_STATIC_SAMPLER_DESC Samplers[3] = {};
-    Samplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
-    Samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-    Samplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-    Samplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-    Samplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_ALWAYS;
-    Samplers[0].BorderColor = D3D12_STATIC_BORDER_COLOR_OPAQUE_BLACK;
-    Samplers[0].MinLOD = 0.0f;
-    Samplers[0].MaxLOD = D3D12_FLOAT32_MAX;
-    Samplers[0].ShaderRegister = 0;
-    Samplers[0].RegisterSpace = 0;
-    Samplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-
-    Samplers[1].Filter = D3D12_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT;
-    Samplers[1].AddressU = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
-    Samplers[1].AddressV = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
-    Samplers[1].AddressW = D3D12_TEXTURE_ADDRESS_MODE_BORDER;
-    Samplers[1].BorderColor = D3D12_STATIC_BORDER_COLOR_OPAQUE_WHITE;
-    Samplers[1].ComparisonFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
-    Samplers[1].MinLOD = 0.0f;
-    Samplers[1].MaxLOD = D3D12_FLOAT32_MAX;
-    Samplers[1].ShaderRegister = 1;
-    Samplers[1].RegisterSpace = 0;
-    Samplers[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-
-    Samplers[2].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
-    Samplers[2].AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-    Samplers[2].AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-    Samplers[2].AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
-    Samplers[2].ComparisonFunc = D3D12_COMPARISON_FUNC_ALWAYS;
-    Samplers[2].BorderColor = D3D12_STATIC_BORDER_COLOR_OPAQUE_BLACK;
-    Samplers[2].MinLOD = 0.0f;
-    Samplers[2].MaxLOD = D3D12_FLOAT32_MAX;
-    Samplers[2].ShaderRegister = 2;
-    Samplers[2].RegisterSpace = 0;
-    Samplers[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+    // RootParams[2]: Cluster constants (b1)
+    RootParams[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    RootParams[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+    RootParams[2].Constants.Num32BitValues = FClusteredLights::ConstantCount;
+    RootParams[2].Constants.ShaderRegister = 1;
+    RootParams[2].Constants.RegisterSpace = 0;
+
+    // RootParams[3]: Punctual lights (t6), RootParams[4]: Cluster light grid (t7)
+    for (uint32_t Index = 3; Index < 5; ++Index)
+    {
+        RootParams[Index].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+        RootParams[Index].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+        RootParams[Index].Descriptor.ShaderRegister = Index + 3;
+        RootParams[Index].Descriptor.RegisterSpace = 0;
+        RootParams[Index].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+    }
+
+    // RootParams[5]: Depth buffer (t8), a transient table since each frame has its own
+    RootParams[5].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    RootParams[5].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+    RootParams[5].DescriptorTable.NumDescriptorRanges = 1;
+    RootParams[5].DescriptorTable.pDescriptorRanges = &DepthRange;
+
+    // The G-buffer is read with Load, so only the shadow (s1) and IBL (s2) samplers remain.
+    D3D12_STATIC_SAMPLER_DESC Samplers[2] = {};
+    BuildLightingSamplers(D3D12_SHADER_VISIBILITY_PIXEL, Samplers);
 
     D3D12_VERSIONED_ROOT_SIGNATURE_DESC RootSigDesc = {};
     RootSigDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
@@ -1761,7 +2937,7 @@ bool FDeferredRenderer::CreateLightingRootSignature(FDX12Device* Device)
         OutputDebugStringA(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
     }
 
-    HR_CHECK(Device->GetDevice()->CreateRootSignature(0, SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), IID_PPV_ARGS(LightingRootSignature.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), LightingRootSignature.ReleaseAndGetAddressOf()));
     return true;
 }
 
@@ -1774,17 +2950,45 @@ bool FDeferredRenderer::CreateBasePassPipeline(FDX12Device* Device, DXGI_FORMAT
     const std::wstring VSTarget = RendererUtils::BuildShaderTarget(L"vs", ShaderModel);
     const std::wstring PSTarget = RendererUtils::BuildShaderTarget(L"ps", ShaderModel);
 
-    if (!Compiler.CompileFromFile(L"Shaders/DeferredBasePass.hlsl", L"VSMain", VSTarget, VSByteCode))
-    {
-        return false;
-    }
-
     // Generate shader defines for all permutations programmatically
     // Permutation key bits: 0=Normal, 1=MR, 2=BaseColor, 3=Emissive, 4=AlphaMask
     std::array<std::vector<uint8_t>, 32> PSByteCodes;
-    
+    std::vector<FShaderCompileRequest> Requests;
+
+    FShaderCompileRequest VSRequest;
+    VSRequest.FilePath = L"Shaders/DeferredBasePass.hlsl";
+    VSRequest.EntryPoint = L"VSMain";
+    VSRequest.Target = VSTarget;
+    VSRequest.OutByteCode = &VSByteCode;
+    Requests.push_back(VSRequest);
+
+    // The mesh shader pipelines share the pixel shader permutations below.
+    std::vector<uint8_t> ASByteCode;
+    std::vector<uint8_t> MSByteCode;
+    if (bMeshShadersEnabled)
+    {
+        FShaderCompileRequest ASRequest;
+        ASRequest.FilePath = L"Shaders/MeshletBasePass.hlsl";
+        ASRequest.EntryPoint = L"ASMain";
+        ASRequest.Target = RendererUtils::BuildShaderTarget(L"as", ShaderModel);
+        ASRequest.OutByteCode = &ASByteCode;
+        Requests.push_back(ASRequest);
+
+        FShaderCompileRequest MSRequest = ASRequest;
+        MSRequest.EntryPoint = L"MSMain";
+        MSRequest.Target = RendererUtils::BuildShaderTarget(L"ms", ShaderModel);
+        MSRequest.OutByteCode = &MSByteCode;
+        Requests.push_back(MSRequest);
+    }
+
     for (uint32_t Permutation = 0; Permutation < 32; ++Permutation)
     {
+        // Bindless shaders branch on the map bits at runtime, so only the alpha-mask keys are built.
+        if (ResolveMaterialPipelineKey(Permutation) != Permutation)
+        {
+            continue;
+        }
+
         const bool bUseNormal = (Permutation & 1) != 0;
         const bool bUseMR = (Permutation & 2) != 0;
         const bool bUseBaseColor = (Permutation & 4) != 0;
@@ -1792,35 +2996,41 @@ bool FDeferredRenderer::CreateBasePassPipeline(FDX12Device* Device, DXGI_FORMAT
         const bool bUseAlphaMask = (Permutation & 16) != 0;
 
         std::vector<std::wstring> Defines;
-        Defines.push_back(bUseNormal ? L"USE_NORMAL_MAP=1" : L"USE_NORMAL_MAP=0");
-        Defines.push_back(bUseMR ? L"USE_METALLIC_ROUGHNESS_MAP=1" : L"USE_METALLIC_ROUGHNESS_MAP=0");
-        Defines.push_back(bUseBaseColor ? L"USE_BASE_COLOR_MAP=1" : L"USE_BASE_COLOR_MAP=0");
-        Defines.push_back(bUseEmissive ? L"USE_EMISSIVE_MAP=1" : L"USE_EMISSIVE_MAP=0");
+        if (bBindlessMaterials)
+        {
+            Defines.push_back(L"BINDLESS_MATERIALS=1");
+        }
+        else
+        {
+            Defines.push_back(bUseNormal ? L"USE_NORMAL_MAP=1" : L"USE_NORMAL_MAP=0");
+            Defines.push_back(bUseMR ? L"USE_METALLIC_ROUGHNESS_MAP=1" : L"USE_METALLIC_ROUGHNESS_MAP=0");
+            Defines.push_back(bUseBaseColor ? L"USE_BASE_COLOR_MAP=1" : L"USE_BASE_COLOR_MAP=0");
+            Defines.push_back(bUseEmissive ? L"USE_EMISSIVE_MAP=1" : L"USE_EMISSIVE_MAP=0");
+        }
         if (bUseAlphaMask)
         {
             Defines.push_back(L"USE_ALPHA_MASK=1");
         }
 
-        if (!Compiler.CompileFromFile(L"Shaders/DeferredBasePass.hlsl", L"PSMain", PSTarget, PSByteCodes[Permutation], Defines))
-        {
-            return false;
-        }
+        FShaderCompileRequest PSRequest;
+        PSRequest.FilePath = L"Shaders/DeferredBasePass.hlsl";
+        PSRequest.EntryPoint = L"PSMain";
+        PSRequest.Target = PSTarget;
+        PSRequest.Defines = std::move(Defines);
+        PSRequest.OutByteCode = &PSByteCodes[Permutation];
+        Requests.push_back(std::move(PSRequest));
     }
 
-    D3D12_INPUT_ELEMENT_DESC InputLayout[] =
+    if (!Compiler.CompileShadersParallel(Requests))
     {
-        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0,   D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 24,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "TANGENT",  0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "COLOR",    0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 48, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-    };
+        return false;
+    }
 
     auto InitializeBasePassDesc = [&](D3D12_GRAPHICS_PIPELINE_STATE_DESC& Desc)
     {
         Desc = {};
         Desc.pRootSignature = BasePassRootSignature.Get();
-        Desc.InputLayout = { InputLayout, _countof(InputLayout) };
+        Desc.InputLayout = RendererUtils::GetMeshInputLayout();
         Desc.VS = { VSByteCode.data(), VSByteCode.size() };
         Desc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
         Desc.SampleDesc.Count = 1;
@@ -1842,7 +3052,7 @@ bool FDeferredRenderer::CreateBasePassPipeline(FDX12Device* Device, DXGI_FORMAT
         Desc.BlendState = {};
         Desc.BlendState.AlphaToCoverageEnable = FALSE;
         Desc.BlendState.IndependentBlendEnable = TRUE;
-        for (int i = 0; i < 4; ++i)
+        for (int i = 0; i < 5; ++i)
         {
             D3D12_RENDER_TARGET_BLEND_DESC RtBlend = {};
             RtBlend.BlendEnable = FALSE;
@@ -1870,22 +3080,59 @@ bool FDeferredRenderer::CreateBasePassPipeline(FDX12Device* Device, DXGI_FORMAT
         Desc.DepthStencilState.FrontFace.StencilPassOp = D3D12_STENCIL_OP_KEEP;
         Desc.DepthStencilState.FrontFace.StencilFunc = D3D12_COMPARISON_FUNC_ALWAYS;
         Desc.DepthStencilState.BackFace = Desc.DepthStencilState.FrontFace;
-        Desc.NumRenderTargets = 4;
+        Desc.NumRenderTargets = 5;
         Desc.RTVFormats[0] = GBufferFormats[0];
         Desc.RTVFormats[1] = GBufferFormats[1];
         Desc.RTVFormats[2] = GBufferFormats[2];
         Desc.RTVFormats[3] = LightingFormat;
+        Desc.RTVFormats[4] = VelocityFormat;
         Desc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
         Desc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
     };
 
-    // Create all pipeline state objects programmatically
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC PsoDesc = {};
+    // One job per permutation; each writes only its own slots of the pipeline arrays.
+    const bool bBuildMeshletPipelines = bMeshShadersEnabled;
+    std::atomic<bool> bMeshletPipelineFailed{ false };
+    FPipelineJobGroup PermutationJobs;
     for (uint32_t Permutation = 0; Permutation < 32; ++Permutation)
     {
-        InitializeBasePassDesc(PsoDesc);
-        PsoDesc.PS = { PSByteCodes[Permutation].data(), PSByteCodes[Permutation].size() };
-        HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(BasePassPipelines[Permutation].GetAddressOf())));
+        if (PSByteCodes[Permutation].empty())
+        {
+            continue;
+        }
+
+        PermutationJobs.Add([&, Permutation]()
+        {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC PsoDesc = {};
+            InitializeBasePassDesc(PsoDesc);
+            PsoDesc.PS = { PSByteCodes[Permutation].data(), PSByteCodes[Permutation].size() };
+            HR_CHECK(Device->GetPipelineCache()->CreateGraphicsPipelineState(PsoDesc, BasePassPipelines[Permutation].ReleaseAndGetAddressOf()));
+
+            // The prepass already discarded masked pixels below the cutoff, so these skip the clip.
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC EqualDesc = PsoDesc;
+            const std::vector<uint8_t>& UnclippedPS = PSByteCodes[Permutation & ~MaterialAlphaMaskKey];
+            EqualDesc.PS = { UnclippedPS.data(), UnclippedPS.size() };
+            EqualDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+            EqualDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_EQUAL;
+            HR_CHECK(Device->GetPipelineCache()->CreateGraphicsPipelineState(EqualDesc, BasePassEqualPipelines[Permutation].ReleaseAndGetAddressOf()));
+
+            if (bBuildMeshletPipelines)
+            {
+                PsoDesc.pRootSignature = MeshletRootSignature.Get();
+                if (FAILED(CreateMeshPipelineState(Device->GetDevice(), PsoDesc, ASByteCode, MSByteCode, MeshletBasePassPipelines[Permutation].ReleaseAndGetAddressOf())))
+                {
+                    bMeshletPipelineFailed = true;
+                }
+            }
+            return true;
+        }, "Base pass pipeline creation failed");
+    }
+    PermutationJobs.Join();
+
+    if (bMeshletPipelineFailed)
+    {
+        LogWarning("Meshlet base pass pipeline creation failed; using the vertex shader base pass.");
+        bMeshShadersEnabled = false;
     }
 
     return true;
@@ -1899,23 +3146,14 @@ bool FDeferredRenderer::CreateDepthPrepassPipeline(FDX12Device* Device)
     const D3D_SHADER_MODEL ShaderModel = Device->GetShaderModel();
     const std::wstring VSTarget = RendererUtils::BuildShaderTarget(L"vs", ShaderModel);
 
-    if (!Compiler.CompileFromFile(L"Shaders/DeferredBasePass.hlsl", L"VSMain", VSTarget, VSByteCode))
+    if (!Compiler.CompileFromFile(L"Shaders/DeferredBasePass.hlsl", L"VSDepthOnly", VSTarget, VSByteCode))
     {
         return false;
     }
 
-    D3D12_INPUT_ELEMENT_DESC InputLayout[] =
-    {
-        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0,   D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 24,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "TANGENT",  0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "COLOR",    0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 48, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-    };
-
     D3D12_GRAPHICS_PIPELINE_STATE_DESC PsoDesc = {};
     PsoDesc.pRootSignature = BasePassRootSignature.Get();
-    PsoDesc.InputLayout = { InputLayout, _countof(InputLayout) };
+    PsoDesc.InputLayout = RendererUtils::GetMeshPositionInputLayout();
     PsoDesc.VS = { VSByteCode.data(), VSByteCode.size() };
     PsoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
     PsoDesc.SampleDesc.Count = 1;
@@ -1956,65 +3194,396 @@ bool FDeferredRenderer::CreateDepthPrepassPipeline(FDX12Device* Device)
     PsoDesc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
     PsoDesc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
 
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(DepthPrepassPipeline.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateGraphicsPipelineState(PsoDesc, DepthPrepassPipeline.ReleaseAndGetAddressOf()));
+
+    // Masked models need their UVs and material, so these read the full vertex layout. Bindless
+    // materials pick the base color map at runtime and only build the first slot.
+    const std::wstring PSTarget = RendererUtils::BuildShaderTarget(L"ps", ShaderModel);
+    const uint32_t MaskedPipelineCount = bBindlessMaterials ? 1u : static_cast<uint32_t>(MaskedDepthPrepassPipelines.size());
+    for (ComPtr<ID3D12PipelineState>& MaskedPipeline : MaskedDepthPrepassPipelines)
+    {
+        MaskedPipeline.Reset();
+    }
+    for (uint32_t MaskedIndex = 0; MaskedIndex < MaskedPipelineCount; ++MaskedIndex)
+    {
+        std::vector<std::wstring> Defines;
+        if (bBindlessMaterials)
+        {
+            Defines.push_back(L"BINDLESS_MATERIALS=1");
+        }
+        else
+        {
+            Defines.push_back(MaskedIndex != 0 ? L"USE_BASE_COLOR_MAP=1" : L"USE_BASE_COLOR_MAP=0");
+        }
+
+        std::vector<uint8_t> MaskedVSByteCode;
+        std::vector<uint8_t> MaskedPSByteCode;
+        if (!Compiler.CompileFromFile(L"Shaders/DeferredBasePass.hlsl", L"VSDepthMasked", VSTarget, MaskedVSByteCode, Defines) ||
+            !Compiler.CompileFromFile(L"Shaders/DeferredBasePass.hlsl", L"PSDepthMasked", PSTarget, MaskedPSByteCode, Defines))
+        {
+            return false;
+        }
+
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC MaskedDesc = PsoDesc;
+        MaskedDesc.InputLayout = RendererUtils::GetMeshInputLayout();
+        MaskedDesc.VS = { MaskedVSByteCode.data(), MaskedVSByteCode.size() };
+        MaskedDesc.PS = { MaskedPSByteCode.data(), MaskedPSByteCode.size() };
+        HR_CHECK(Device->GetPipelineCache()->CreateGraphicsPipelineState(MaskedDesc, MaskedDepthPrepassPipelines[MaskedIndex].ReleaseAndGetAddressOf()));
+    }
+
+    // Mesh shader twin, so prepass and base pass depths come from the same vertex transform.
+    if (bMeshShadersEnabled)
+    {
+        std::vector<uint8_t> ASByteCode;
+        std::vector<uint8_t> MSByteCode;
+        if (!Compiler.CompileFromFile(L"Shaders/MeshletBasePass.hlsl", L"ASMain", RendererUtils::BuildShaderTarget(L"as", ShaderModel), ASByteCode) ||
+            !Compiler.CompileFromFile(L"Shaders/MeshletBasePass.hlsl", L"MSDepthOnly", RendererUtils::BuildShaderTarget(L"ms", ShaderModel), MSByteCode))
+        {
+            return false;
+        }
+
+        PsoDesc.pRootSignature = MeshletRootSignature.Get();
+        if (FAILED(CreateMeshPipelineState(Device->GetDevice(), PsoDesc, ASByteCode, MSByteCode, MeshletDepthPrepassPipeline.ReleaseAndGetAddressOf())))
+        {
+            LogWarning("Meshlet depth prepass pipeline creation failed; using the vertex shader base pass.");
+            bMeshShadersEnabled = false;
+        }
+    }
     return true;
 }
 
 bool FDeferredRenderer::CreateLightingPipeline(FDX12Device* Device, DXGI_FORMAT BackBufferFormat)
 {
     FShaderCompiler Compiler;
-    std::vector<uint8_t> VSByteCode;
-    std::vector<uint8_t> PSByteCode;
+    std::vector<uint8_t> VSByteCode;
+    std::vector<uint8_t> PSByteCode;
+
+    const D3D_SHADER_MODEL ShaderModel = Device->GetShaderModel();
+    const std::wstring VSTarget = RendererUtils::BuildShaderTarget(L"vs", ShaderModel);
+    const std::wstring PSTarget = RendererUtils::BuildShaderTarget(L"ps", ShaderModel);
+
+    if (!Compiler.CompileFromFile(L"Shaders/DeferredLighting.hlsl", L"VSMain", VSTarget, VSByteCode))
+    {
+        return false;
+    }
+
+    if (!Compiler.CompileFromFile(L"Shaders/DeferredLighting.hlsl", L"PSMain", PSTarget, PSByteCode))
+    {
+        return false;
+    }
+
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC PsoDesc = {};
+    PsoDesc.pRootSignature = LightingRootSignature.Get();
+    PsoDesc.VS = { VSByteCode.data(), VSByteCode.size() };
+    PsoDesc.PS = { PSByteCode.data(), PSByteCode.size() };
+    PsoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    PsoDesc.SampleDesc.Count = 1;
+    PsoDesc.SampleMask = UINT_MAX;
+
+    PsoDesc.RasterizerState = {};
+    PsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+    PsoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+    PsoDesc.RasterizerState.FrontCounterClockwise = TRUE;
+    PsoDesc.RasterizerState.DepthClipEnable = TRUE;
+
+    PsoDesc.BlendState = {};
+    PsoDesc.BlendState.RenderTarget[0].BlendEnable = TRUE;
+    PsoDesc.BlendState.RenderTarget[0].SrcBlend = D3D12_BLEND_ONE;
+    PsoDesc.BlendState.RenderTarget[0].DestBlend = D3D12_BLEND_ONE;
+    PsoDesc.BlendState.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
+    PsoDesc.BlendState.RenderTarget[0].SrcBlendAlpha = D3D12_BLEND_ONE;
+    PsoDesc.BlendState.RenderTarget[0].DestBlendAlpha = D3D12_BLEND_ONE;
+    PsoDesc.BlendState.RenderTarget[0].BlendOpAlpha = D3D12_BLEND_OP_ADD;
+    PsoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+    PsoDesc.DepthStencilState = {};
+    PsoDesc.DepthStencilState.DepthEnable = FALSE;
+    PsoDesc.DepthStencilState.StencilEnable = FALSE;
+    PsoDesc.NumRenderTargets = 1;
+    PsoDesc.RTVFormats[0] = LightingBufferFormat;
+    PsoDesc.DSVFormat = DXGI_FORMAT_UNKNOWN;
+
+    HR_CHECK(Device->GetPipelineCache()->CreateGraphicsPipelineState(PsoDesc, LightingPipeline.ReleaseAndGetAddressOf()));
+    return true;
+}
+
+bool FDeferredRenderer::CreateTiledLightingPipelines(FDX12Device* Device)
+{
+    TiledLightingRootSignature.Reset();
+    TileResetPipeline.Reset();
+    TileClassifyPipeline.Reset();
+    for (Microsoft::WRL::ComPtr<ID3D12PipelineState>& Pipeline : TiledLightingPipelines)
+    {
+        Pipeline.Reset();
+    }
+    TileDispatchSignature.Reset();
+
+    // The tile kernels read back the emissive color the base pass wrote, through a typed UAV load.
+    D3D12_FEATURE_DATA_FORMAT_SUPPORT FormatSupport = { LightingBufferFormat };
+    if (FAILED(Device->GetDevice()->CheckFeatureSupport(D3D12_FEATURE_FORMAT_SUPPORT, &FormatSupport, sizeof(FormatSupport)))
+        || (FormatSupport.Support2 & D3D12_FORMAT_SUPPORT2_UAV_TYPED_LOAD) == 0)
+    {
+        return false;
+    }
+
+    D3D12_DESCRIPTOR_RANGE1 DescriptorRanges[7] = {};
+    for (int i = 0; i < 7; ++i)
+    {
+        DescriptorRanges[i].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+        DescriptorRanges[i].NumDescriptors = 1;
+        DescriptorRanges[i].BaseShaderRegister = static_cast<UINT>(i);
+        DescriptorRanges[i].RegisterSpace = 0;
+        DescriptorRanges[i].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_NONE;
+        DescriptorRanges[i].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+    }
+    // The sky's transmittance LUT follows the BRDF LUT in the heap, past the root SRVs' registers.
+    DescriptorRanges[6].BaseShaderRegister = 10;
+    DescriptorRanges[6].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
+
+    D3D12_DESCRIPTOR_RANGE1 OutputRange = {};
+    OutputRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+    OutputRange.NumDescriptors = 1;
+    OutputRange.BaseShaderRegister = 2;
+    OutputRange.RegisterSpace = 0;
+    OutputRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_NONE;
+    OutputRange.OffsetInDescriptorsFromTableStart = 0;
+
+    D3D12_DESCRIPTOR_RANGE1 DepthRange = {};
+    DepthRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    DepthRange.NumDescriptors = 1;
+    DepthRange.BaseShaderRegister = 8;
+    DepthRange.RegisterSpace = 0;
+    DepthRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
+    DepthRange.OffsetInDescriptorsFromTableStart = 0;
+
+    D3D12_ROOT_PARAMETER1 RootParams[11] = {};
+    // RootParams[0]: Lighting constants (b0)
+    RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    RootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[0].Descriptor.ShaderRegister = 0;
+    RootParams[0].Descriptor.RegisterSpace = 0;
+    RootParams[0].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+
+    // RootParams[1]: GBuffer/IBL/shadow/sky transmittance SRV table (t0..t5, t10)
+    RootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    RootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[1].DescriptorTable.NumDescriptorRanges = _countof(DescriptorRanges);
+    RootParams[1].DescriptorTable.pDescriptorRanges = DescriptorRanges;
+
+    // RootParams[2]: Cluster constants (b1)
+    RootParams[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    RootParams[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[2].Constants.Num32BitValues = FClusteredLights::ConstantCount;
+    RootParams[2].Constants.ShaderRegister = 1;
+    RootParams[2].Constants.RegisterSpace = 0;
+
+    // RootParams[3]: Punctual lights (t6), RootParams[4]: Cluster light grid (t7)
+    for (uint32_t Index = 3; Index < 5; ++Index)
+    {
+        RootParams[Index].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+        RootParams[Index].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+        RootParams[Index].Descriptor.ShaderRegister = Index + 3;
+        RootParams[Index].Descriptor.RegisterSpace = 0;
+        RootParams[Index].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+    }
+
+    // RootParams[5]: Tile dispatch arguments (u0), RootParams[6]: Tile lists (u1)
+    for (uint32_t Index = 5; Index < 7; ++Index)
+    {
+        RootParams[Index].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+        RootParams[Index].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+        RootParams[Index].Descriptor.ShaderRegister = Index - 5;
+        RootParams[Index].Descriptor.RegisterSpace = 0;
+        RootParams[Index].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_DATA_VOLATILE;
+    }
+
+    // RootParams[7]: Tile lists (t9)
+    RootParams[7].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    RootParams[7].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[7].Descriptor.ShaderRegister = 9;
+    RootParams[7].Descriptor.RegisterSpace = 0;
+    RootParams[7].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+
+    // RootParams[8]: Lighting buffer UAV (u2)
+    RootParams[8].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    RootParams[8].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[8].DescriptorTable.NumDescriptorRanges = 1;
+    RootParams[8].DescriptorTable.pDescriptorRanges = &OutputRange;
+
+    // RootParams[9]: Tile list capacity (b2)
+    RootParams[9].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    RootParams[9].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[9].Constants.Num32BitValues = 1;
+    RootParams[9].Constants.ShaderRegister = 2;
+    RootParams[9].Constants.RegisterSpace = 0;
+
+    // RootParams[10]: Depth buffer (t8)
+    RootParams[10].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    RootParams[10].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[10].DescriptorTable.NumDescriptorRanges = 1;
+    RootParams[10].DescriptorTable.pDescriptorRanges = &DepthRange;
+
+    D3D12_STATIC_SAMPLER_DESC Samplers[2] = {};
+    BuildLightingSamplers(D3D12_SHADER_VISIBILITY_ALL, Samplers);
+
+    D3D12_VERSIONED_ROOT_SIGNATURE_DESC RootSigDesc = {};
+    RootSigDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
+    RootSigDesc.Desc_1_1.NumParameters = _countof(RootParams);
+    RootSigDesc.Desc_1_1.pParameters = RootParams;
+    RootSigDesc.Desc_1_1.NumStaticSamplers = _countof(Samplers);
+    RootSigDesc.Desc_1_1.pStaticSamplers = Samplers;
+    RootSigDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
+
+    ComPtr<ID3DBlob> SerializedSig;
+    ComPtr<ID3DBlob> ErrorBlob;
+    if (FAILED(D3D12SerializeVersionedRootSignature(&RootSigDesc, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf())))
+    {
+        if (ErrorBlob)
+        {
+            OutputDebugStringA(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
+        }
+        return false;
+    }
+
+    ComPtr<ID3D12RootSignature> RootSignature;
+    if (FAILED(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), RootSignature.GetAddressOf())))
+    {
+        return false;
+    }
+
+    FShaderCompiler Compiler;
+    const std::wstring CSTarget = RendererUtils::BuildShaderTarget(L"cs", Device->GetShaderModel());
+    auto CreatePipeline = [&](const wchar_t* EntryPoint, const std::vector<std::wstring>& Defines, ComPtr<ID3D12PipelineState>& OutPipeline)
+    {
+        std::vector<uint8_t> CSByteCode;
+        if (!Compiler.CompileFromFile(L"Shaders/TiledDeferredLighting.hlsl", EntryPoint, CSTarget, CSByteCode, Defines))
+        {
+            return false;
+        }
 
-    const D3D_SHADER_MODEL ShaderModel = Device->GetShaderModel();
-    const std::wstring VSTarget = RendererUtils::BuildShaderTarget(L"vs", ShaderModel);
-    const std::wstring PSTarget = RendererUtils::BuildShaderTarget(L"ps", ShaderModel);
+        D3D12_COMPUTE_PIPELINE_STATE_DESC PsoDesc = {};
+        PsoDesc.pRootSignature = RootSignature.Get();
+        PsoDesc.CS = { CSByteCode.data(), CSByteCode.size() };
+        return SUCCEEDED(Device->GetPipelineCache()->CreateComputePipelineState(PsoDesc, OutPipeline.ReleaseAndGetAddressOf()));
+    };
 
-    if (!Compiler.CompileFromFile(L"Shaders/DeferredLighting.hlsl", L"VSMain", VSTarget, VSByteCode))
+    std::array<ComPtr<ID3D12PipelineState>, static_cast<size_t>(ETiledLightingClass::Count)> LightingPipelines;
+    ComPtr<ID3D12PipelineState> ResetPipeline;
+    ComPtr<ID3D12PipelineState> ClassifyPipeline;
+    if (!CreatePipeline(L"ResetTileClasses", {}, ResetPipeline) || !CreatePipeline(L"ClassifyTiles", {}, ClassifyPipeline))
     {
         return false;
     }
+    for (size_t ClassIndex = 0; ClassIndex < LightingPipelines.size(); ++ClassIndex)
+    {
+        const std::vector<std::wstring> Defines = { L"TILE_CLASS=" + std::to_wstring(ClassIndex) };
+        if (!CreatePipeline(L"LightTiles", Defines, LightingPipelines[ClassIndex]))
+        {
+            return false;
+        }
+    }
 
-    if (!Compiler.CompileFromFile(L"Shaders/DeferredLighting.hlsl", L"PSMain", PSTarget, PSByteCode))
+    // Each class's arguments are a bare dispatch, so the signature changes no root arguments.
+    D3D12_INDIRECT_ARGUMENT_DESC IndirectArg = {};
+    IndirectArg.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH;
+
+    D3D12_COMMAND_SIGNATURE_DESC CommandDesc = {};
+    CommandDesc.pArgumentDescs = &IndirectArg;
+    CommandDesc.NumArgumentDescs = 1;
+    CommandDesc.ByteStride = sizeof(D3D12_DISPATCH_ARGUMENTS);
+    ComPtr<ID3D12CommandSignature> DispatchSignature;
+    if (FAILED(Device->GetDevice()->CreateCommandSignature(&CommandDesc, nullptr, IID_PPV_ARGS(DispatchSignature.GetAddressOf()))))
     {
         return false;
     }
 
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC PsoDesc = {};
-    PsoDesc.pRootSignature = LightingRootSignature.Get();
-    PsoDesc.VS = { VSByteCode.data(), VSByteCode.size() };
-    PsoDesc.PS = { PSByteCode.data(), PSByteCode.size() };
-    PsoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-    PsoDesc.SampleDesc.Count = 1;
-    PsoDesc.SampleMask = UINT_MAX;
+    TiledLightingRootSignature = RootSignature;
+    TileResetPipeline = ResetPipeline;
+    TileClassifyPipeline = ClassifyPipeline;
+    TiledLightingPipelines = LightingPipelines;
+    TileDispatchSignature = DispatchSignature;
+    return true;
+}
 
-    PsoDesc.RasterizerState = {};
-    PsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
-    PsoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
-    PsoDesc.RasterizerState.FrontCounterClockwise = TRUE;
-    PsoDesc.RasterizerState.DepthClipEnable = TRUE;
+bool FDeferredRenderer::CreateTiledLightingResources(FDX12Device* Device, uint32_t Width, uint32_t Height)
+{
+    constexpr uint32_t TileSize = 8;
+    constexpr uint32_t ClassCount = static_cast<uint32_t>(ETiledLightingClass::Count);
+    TileCountX = (Width + TileSize - 1) / TileSize;
+    TileCountY = (Height + TileSize - 1) / TileSize;
 
-    PsoDesc.BlendState = {};
-    PsoDesc.BlendState.RenderTarget[0].BlendEnable = TRUE;
-    PsoDesc.BlendState.RenderTarget[0].SrcBlend = D3D12_BLEND_ONE;
-    PsoDesc.BlendState.RenderTarget[0].DestBlend = D3D12_BLEND_ONE;
-    PsoDesc.BlendState.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
-    PsoDesc.BlendState.RenderTarget[0].SrcBlendAlpha = D3D12_BLEND_ONE;
-    PsoDesc.BlendState.RenderTarget[0].DestBlendAlpha = D3D12_BLEND_ONE;
-    PsoDesc.BlendState.RenderTarget[0].BlendOpAlpha = D3D12_BLEND_OP_ADD;
-    PsoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+    D3D12_HEAP_PROPERTIES HeapProps = {};
+    HeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+    HeapProps.CreationNodeMask = 1;
+    HeapProps.VisibleNodeMask = 1;
 
-    PsoDesc.DepthStencilState = {};
-    PsoDesc.DepthStencilState.DepthEnable = FALSE;
-    PsoDesc.DepthStencilState.StencilEnable = FALSE;
-    PsoDesc.NumRenderTargets = 1;
-    PsoDesc.RTVFormats[0] = LightingBufferFormat;
-    PsoDesc.DSVFormat = DXGI_FORMAT_UNKNOWN;
+    D3D12_RESOURCE_DESC BufferDesc = {};
+    BufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    BufferDesc.Height = 1;
+    BufferDesc.DepthOrArraySize = 1;
+    BufferDesc.MipLevels = 1;
+    BufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+    BufferDesc.SampleDesc.Count = 1;
+    BufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    BufferDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+    BufferDesc.Width = sizeof(D3D12_DISPATCH_ARGUMENTS) * ClassCount;
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Buffer,
+        &HeapProps,
+        D3D12_HEAP_FLAG_NONE,
+        &BufferDesc,
+        D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+        nullptr,
+        IID_PPV_ARGS(TileDispatchArgsBuffer.ReleaseAndGetAddressOf())));
+    TileDispatchArgsBuffer->SetName(L"TileDispatchArgs");
+    TileDispatchArgsState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+
+    BufferDesc.Width = static_cast<UINT64>(sizeof(uint32_t)) * TileCountX * TileCountY * ClassCount;
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Buffer,
+        &HeapProps,
+        D3D12_HEAP_FLAG_NONE,
+        &BufferDesc,
+        D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+        nullptr,
+        IID_PPV_ARGS(TileListBuffer.ReleaseAndGetAddressOf())));
+    TileListBuffer->SetName(L"TileLists");
+    TileListState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    return true;
+}
 
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(LightingPipeline.GetAddressOf())));
+bool FDeferredRenderer::IsTiledLightingAvailable() const
+{
+    if (!TiledLightingRootSignature || !TileResetPipeline || !TileClassifyPipeline || !TileDispatchSignature
+        || !TileDispatchArgsBuffer || !TileListBuffer || LightingBufferUavHandle.ptr == 0)
+    {
+        return false;
+    }
+    for (const Microsoft::WRL::ComPtr<ID3D12PipelineState>& Pipeline : TiledLightingPipelines)
+    {
+        if (!Pipeline)
+        {
+            return false;
+        }
+    }
     return true;
 }
 
+void FDeferredRenderer::BindTiledLightingRoot(ID3D12GraphicsCommandList* CommandList, D3D12_GPU_DESCRIPTOR_HANDLE DepthTable) const
+{
+    const uint32_t TileListCapacity = TileCountX * TileCountY;
+    CommandList->SetComputeRootSignature(TiledLightingRootSignature.Get());
+    CommandList->SetComputeRootConstantBufferView(0, ViewConstantsAddress);
+    CommandList->SetComputeRootDescriptorTable(1, GBufferGpuHandles[0]);
+    CommandList->SetComputeRootUnorderedAccessView(5, TileDispatchArgsBuffer->GetGPUVirtualAddress());
+    CommandList->SetComputeRootUnorderedAccessView(6, TileListBuffer->GetGPUVirtualAddress());
+    CommandList->SetComputeRootShaderResourceView(7, TileListBuffer->GetGPUVirtualAddress());
+    CommandList->SetComputeRootDescriptorTable(8, LightingBufferUavHandle);
+    CommandList->SetComputeRoot32BitConstants(9, 1, &TileListCapacity, 0);
+    CommandList->SetComputeRootDescriptorTable(10, DepthTable);
+}
+
 bool FDeferredRenderer::CreateHZBRootSignature(FDX12Device* Device)
 {
     D3D12_DESCRIPTOR_RANGE1 DescriptorRanges[5] = {};
@@ -2110,7 +3679,7 @@ bool FDeferredRenderer::CreateHZBRootSignature(FDX12Device* Device)
         OutputDebugStringA(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
     }
 
-    HR_CHECK(Device->GetDevice()->CreateRootSignature(0, SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), IID_PPV_ARGS(HZBRootSignature.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), HZBRootSignature.ReleaseAndGetAddressOf()));
     return true;
 }
 
@@ -2135,11 +3704,99 @@ bool FDeferredRenderer::CreateHZBPipeline(FDX12Device* Device)
         PsoDesc.pRootSignature = HZBRootSignature.Get();
         PsoDesc.CS = { CSByteCode.data(), CSByteCode.size() };
 
-        HR_CHECK(Device->GetDevice()->CreateComputePipelineState(&PsoDesc, IID_PPV_ARGS(HZBPipelines[PipelineIndex].GetAddressOf())));
+        HR_CHECK(Device->GetPipelineCache()->CreateComputePipelineState(PsoDesc, HZBPipelines[PipelineIndex].ReleaseAndGetAddressOf()));
     }
     return true;
 }
 
+bool FDeferredRenderer::CreateHZBSinglePassPipeline(FDX12Device* Device)
+{
+    HZBSinglePassPipeline.Reset();
+
+    D3D12_DESCRIPTOR_RANGE1 SourceRange = {};
+    SourceRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    SourceRange.NumDescriptors = 1;
+    SourceRange.BaseShaderRegister = 0;
+    SourceRange.RegisterSpace = 0;
+    SourceRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_NONE;
+    SourceRange.OffsetInDescriptorsFromTableStart = 0;
+
+    // Slots past the mip count hold the null UAV, so the whole range is always populated.
+    D3D12_DESCRIPTOR_RANGE1 MipRange = {};
+    MipRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+    MipRange.NumDescriptors = HZBSinglePassMaxMips;
+    MipRange.BaseShaderRegister = 0;
+    MipRange.RegisterSpace = 0;
+    MipRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
+    MipRange.OffsetInDescriptorsFromTableStart = 0;
+
+    D3D12_ROOT_PARAMETER1 RootParams[4] = {};
+
+    // RootParams[0]: Source and mip 0 dimensions, mip count, group count
+    RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    RootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[0].Constants.Num32BitValues = 6;
+    RootParams[0].Constants.RegisterSpace = 0;
+    RootParams[0].Constants.ShaderRegister = 0;
+
+    // RootParams[1]: Depth buffer SRV (t0)
+    RootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    RootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[1].DescriptorTable.NumDescriptorRanges = 1;
+    RootParams[1].DescriptorTable.pDescriptorRanges = &SourceRange;
+
+    // RootParams[2]: HZB mip UAVs (u0-u15)
+    RootParams[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    RootParams[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[2].DescriptorTable.NumDescriptorRanges = 1;
+    RootParams[2].DescriptorTable.pDescriptorRanges = &MipRange;
+
+    // RootParams[3]: Finished-group counter (u0, space1)
+    RootParams[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    RootParams[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[3].Descriptor.ShaderRegister = 0;
+    RootParams[3].Descriptor.RegisterSpace = 1;
+    RootParams[3].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_DATA_VOLATILE;
+
+    D3D12_VERSIONED_ROOT_SIGNATURE_DESC RootSigDesc = {};
+    RootSigDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
+    RootSigDesc.Desc_1_1.NumParameters = _countof(RootParams);
+    RootSigDesc.Desc_1_1.pParameters = RootParams;
+    RootSigDesc.Desc_1_1.NumStaticSamplers = 0;
+    RootSigDesc.Desc_1_1.pStaticSamplers = nullptr;
+    RootSigDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
+
+    ComPtr<ID3DBlob> SerializedSig;
+    ComPtr<ID3DBlob> ErrorBlob;
+    if (FAILED(D3D12SerializeVersionedRootSignature(&RootSigDesc, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf())))
+    {
+        if (ErrorBlob)
+        {
+            OutputDebugStringA(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
+        }
+        return false;
+    }
+
+    if (FAILED(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), HZBSinglePassRootSignature.ReleaseAndGetAddressOf())))
+    {
+        return false;
+    }
+
+    FShaderCompiler Compiler;
+    const std::wstring CSTarget = RendererUtils::BuildShaderTarget(L"cs", Device->GetShaderModel());
+    std::vector<uint8_t> CSByteCode;
+    if (!Compiler.CompileFromFile(L"Shaders/BuildHZBSinglePass.hlsl", L"BuildHZBSinglePass", CSTarget, CSByteCode))
+    {
+        return false;
+    }
+
+    D3D12_COMPUTE_PIPELINE_STATE_DESC PsoDesc = {};
+    PsoDesc.pRootSignature = HZBSinglePassRootSignature.Get();
+    PsoDesc.CS = { CSByteCode.data(), CSByteCode.size() };
+
+    return SUCCEEDED(Device->GetPipelineCache()->CreateComputePipelineState(PsoDesc, HZBSinglePassPipeline.ReleaseAndGetAddressOf()));
+}
+
 bool FDeferredRenderer::CreateAutoExposureRootSignature(FDX12Device* Device)
 {
     D3D12_DESCRIPTOR_RANGE1 SceneSrvRange = {};
@@ -2222,7 +3879,7 @@ bool FDeferredRenderer::CreateAutoExposureRootSignature(FDX12Device* Device)
         OutputDebugStringA(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
     }
 
-    HR_CHECK(Device->GetDevice()->CreateRootSignature(0, SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), IID_PPV_ARGS(AutoExposureRootSignature.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), AutoExposureRootSignature.ReleaseAndGetAddressOf()));
     return true;
 }
 
@@ -2241,7 +3898,7 @@ bool FDeferredRenderer::CreateAutoExposurePipeline(FDX12Device* Device)
     D3D12_COMPUTE_PIPELINE_STATE_DESC PsoDesc = {};
     PsoDesc.pRootSignature = AutoExposureRootSignature.Get();
     PsoDesc.CS = { CSByteCode.data(), CSByteCode.size() };
-    HR_CHECK(Device->GetDevice()->CreateComputePipelineState(&PsoDesc, IID_PPV_ARGS(AutoExposurePipeline.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateComputePipelineState(PsoDesc, AutoExposurePipeline.ReleaseAndGetAddressOf()));
     return true;
 }
 
@@ -2271,12 +3928,20 @@ bool FDeferredRenderer::CreateTaaRootSignature(FDX12Device* Device)
     OutputRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_NONE;
     OutputRange.OffsetInDescriptorsFromTableStart = 0;
 
-    D3D12_ROOT_PARAMETER1 RootParams[4] = {};
+    D3D12_DESCRIPTOR_RANGE1 MotionRange = {};
+    MotionRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    MotionRange.NumDescriptors = 2;
+    MotionRange.BaseShaderRegister = 2;
+    MotionRange.RegisterSpace = 0;
+    MotionRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_NONE;
+    MotionRange.OffsetInDescriptorsFromTableStart = 0;
 
-    // RootParams[0]: TAA constants (output size, history weight, history toggle)
+    D3D12_ROOT_PARAMETER1 RootParams[5] = {};
+
+    // RootParams[0]: TAA constants (output size, history weight, history toggle, input size, jitter, clip reprojection)
     RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
     RootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
-    RootParams[0].Constants.Num32BitValues = 4;
+    RootParams[0].Constants.Num32BitValues = 24;
     RootParams[0].Constants.RegisterSpace = 0;
     RootParams[0].Constants.ShaderRegister = 0;
 
@@ -2298,12 +3963,31 @@ bool FDeferredRenderer::CreateTaaRootSignature(FDX12Device* Device)
     RootParams[3].DescriptorTable.NumDescriptorRanges = 1;
     RootParams[3].DescriptorTable.pDescriptorRanges = &OutputRange;
 
+    // RootParams[4]: Velocity and depth SRVs (t2-t3)
+    RootParams[4].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    RootParams[4].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[4].DescriptorTable.NumDescriptorRanges = 1;
+    RootParams[4].DescriptorTable.pDescriptorRanges = &MotionRange;
+
+    D3D12_STATIC_SAMPLER_DESC SamplerDesc = {};
+    SamplerDesc.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+    SamplerDesc.AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    SamplerDesc.AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    SamplerDesc.AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    SamplerDesc.ComparisonFunc = D3D12_COMPARISON_FUNC_ALWAYS;
+    SamplerDesc.BorderColor = D3D12_STATIC_BORDER_COLOR_OPAQUE_WHITE;
+    SamplerDesc.MinLOD = 0.0f;
+    SamplerDesc.MaxLOD = D3D12_FLOAT32_MAX;
+    SamplerDesc.ShaderRegister = 0;
+    SamplerDesc.RegisterSpace = 0;
+    SamplerDesc.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
     D3D12_VERSIONED_ROOT_SIGNATURE_DESC RootSigDesc = {};
     RootSigDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
     RootSigDesc.Desc_1_1.NumParameters = _countof(RootParams);
     RootSigDesc.Desc_1_1.pParameters = RootParams;
-    RootSigDesc.Desc_1_1.NumStaticSamplers = 0;
-    RootSigDesc.Desc_1_1.pStaticSamplers = nullptr;
+    RootSigDesc.Desc_1_1.NumStaticSamplers = 1;
+    RootSigDesc.Desc_1_1.pStaticSamplers = &SamplerDesc;
     RootSigDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
 
     ComPtr<ID3DBlob> SerializedSig;
@@ -2315,7 +3999,7 @@ bool FDeferredRenderer::CreateTaaRootSignature(FDX12Device* Device)
         OutputDebugStringA(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
     }
 
-    HR_CHECK(Device->GetDevice()->CreateRootSignature(0, SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), IID_PPV_ARGS(TaaRootSignature.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), TaaRootSignature.ReleaseAndGetAddressOf()));
     return true;
 }
 
@@ -2334,7 +4018,7 @@ bool FDeferredRenderer::CreateTaaPipeline(FDX12Device* Device)
     D3D12_COMPUTE_PIPELINE_STATE_DESC PsoDesc = {};
     PsoDesc.pRootSignature = TaaRootSignature.Get();
     PsoDesc.CS = { CSByteCode.data(), CSByteCode.size() };
-    HR_CHECK(Device->GetDevice()->CreateComputePipelineState(&PsoDesc, IID_PPV_ARGS(TaaPipeline.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateComputePipelineState(PsoDesc, TaaPipeline.ReleaseAndGetAddressOf()));
     return true;
 }
 
@@ -2407,7 +4091,7 @@ bool FDeferredRenderer::CreateTonemapRootSignature(FDX12Device* Device)
         OutputDebugStringA(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
     }
 
-    HR_CHECK(Device->GetDevice()->CreateRootSignature(0, SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), IID_PPV_ARGS(TonemapRootSignature.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), TonemapRootSignature.ReleaseAndGetAddressOf()));
     return true;
 }
 
@@ -2455,7 +4139,7 @@ bool FDeferredRenderer::CreateTonemapPipeline(FDX12Device* Device, DXGI_FORMAT B
     PsoDesc.RTVFormats[0] = BackBufferFormat;
     PsoDesc.DSVFormat = DXGI_FORMAT_UNKNOWN;
 
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(TonemapPipeline.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateGraphicsPipelineState(PsoDesc, TonemapPipeline.ReleaseAndGetAddressOf()));
     return true;
 }
 
@@ -2512,7 +4196,7 @@ bool FDeferredRenderer::CreateCasRootSignature(FDX12Device* Device)
         OutputDebugStringA(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
     }
 
-    HR_CHECK(Device->GetDevice()->CreateRootSignature(0, SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), IID_PPV_ARGS(CasRootSignature.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), CasRootSignature.ReleaseAndGetAddressOf()));
     return true;
 }
 
@@ -2526,48 +4210,144 @@ bool FDeferredRenderer::CreateCasPipeline(FDX12Device* Device, DXGI_FORMAT BackB
     const std::wstring VSTarget = RendererUtils::BuildShaderTarget(L"vs", ShaderModel);
     const std::wstring PSTarget = RendererUtils::BuildShaderTarget(L"ps", ShaderModel);
 
-    if (!Compiler.CompileFromFile(L"Shaders/Cas.hlsl", L"VSMain", VSTarget, VSByteCode))
+    if (!Compiler.CompileFromFile(L"Shaders/Cas.hlsl", L"VSMain", VSTarget, VSByteCode))
+    {
+        return false;
+    }
+
+    if (!Compiler.CompileFromFile(L"Shaders/Cas.hlsl", L"PSMain", PSTarget, PSByteCode))
+    {
+        return false;
+    }
+
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC PsoDesc = {};
+    PsoDesc.pRootSignature = CasRootSignature.Get();
+    PsoDesc.VS = { VSByteCode.data(), VSByteCode.size() };
+    PsoDesc.PS = { PSByteCode.data(), PSByteCode.size() };
+    PsoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    PsoDesc.SampleDesc.Count = 1;
+    PsoDesc.SampleMask = UINT_MAX;
+
+    PsoDesc.RasterizerState = {};
+    PsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+    PsoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+    PsoDesc.RasterizerState.FrontCounterClockwise = TRUE;
+    PsoDesc.RasterizerState.DepthClipEnable = TRUE;
+
+    PsoDesc.BlendState = {};
+    PsoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+    PsoDesc.DepthStencilState = {};
+    PsoDesc.DepthStencilState.DepthEnable = FALSE;
+    PsoDesc.DepthStencilState.StencilEnable = FALSE;
+    PsoDesc.NumRenderTargets = 1;
+    PsoDesc.RTVFormats[0] = BackBufferFormat;
+    PsoDesc.DSVFormat = DXGI_FORMAT_UNKNOWN;
+
+    HR_CHECK(Device->GetPipelineCache()->CreateGraphicsPipelineState(PsoDesc, CasPipeline.ReleaseAndGetAddressOf()));
+    return true;
+}
+
+bool FDeferredRenderer::CreateFusedPostPipeline(FDX12Device* Device)
+{
+    FusedPostPipeline.Reset();
+
+    D3D12_DESCRIPTOR_RANGE1 SceneRange = {};
+    SceneRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    SceneRange.NumDescriptors = 1;
+    SceneRange.BaseShaderRegister = 0;
+    SceneRange.RegisterSpace = 0;
+    SceneRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_NONE;
+    SceneRange.OffsetInDescriptorsFromTableStart = 0;
+
+    D3D12_DESCRIPTOR_RANGE1 LuminanceRange = {};
+    LuminanceRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    LuminanceRange.NumDescriptors = 1;
+    LuminanceRange.BaseShaderRegister = 1;
+    LuminanceRange.RegisterSpace = 0;
+    LuminanceRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_NONE;
+    LuminanceRange.OffsetInDescriptorsFromTableStart = 0;
+
+    // The back buffer's view is written into a transient table each frame.
+    D3D12_DESCRIPTOR_RANGE1 OutputRange = {};
+    OutputRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+    OutputRange.NumDescriptors = 1;
+    OutputRange.BaseShaderRegister = 0;
+    OutputRange.RegisterSpace = 0;
+    OutputRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
+    OutputRange.OffsetInDescriptorsFromTableStart = 0;
+
+    D3D12_ROOT_PARAMETER1 RootParams[4] = {};
+
+    // RootParams[0]: Output size, tonemap and CAS constants
+    RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    RootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[0].Constants.Num32BitValues = 8;
+    RootParams[0].Constants.RegisterSpace = 0;
+    RootParams[0].Constants.ShaderRegister = 0;
+
+    // RootParams[1]: Resolved TAA output SRV (t0)
+    RootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    RootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[1].DescriptorTable.NumDescriptorRanges = 1;
+    RootParams[1].DescriptorTable.pDescriptorRanges = &SceneRange;
+
+    // RootParams[2]: Luminance SRV (t1)
+    RootParams[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    RootParams[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[2].DescriptorTable.NumDescriptorRanges = 1;
+    RootParams[2].DescriptorTable.pDescriptorRanges = &LuminanceRange;
+
+    // RootParams[3]: Back buffer UAV (u0)
+    RootParams[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    RootParams[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[3].DescriptorTable.NumDescriptorRanges = 1;
+    RootParams[3].DescriptorTable.pDescriptorRanges = &OutputRange;
+
+    D3D12_VERSIONED_ROOT_SIGNATURE_DESC RootSigDesc = {};
+    RootSigDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
+    RootSigDesc.Desc_1_1.NumParameters = _countof(RootParams);
+    RootSigDesc.Desc_1_1.pParameters = RootParams;
+    RootSigDesc.Desc_1_1.NumStaticSamplers = 0;
+    RootSigDesc.Desc_1_1.pStaticSamplers = nullptr;
+    RootSigDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
+
+    ComPtr<ID3DBlob> SerializedSig;
+    ComPtr<ID3DBlob> ErrorBlob;
+    if (FAILED(D3D12SerializeVersionedRootSignature(&RootSigDesc, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf())))
+    {
+        if (ErrorBlob)
+        {
+            OutputDebugStringA(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
+        }
+        return false;
+    }
+
+    if (FAILED(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), FusedPostRootSignature.ReleaseAndGetAddressOf())))
     {
         return false;
     }
 
-    if (!Compiler.CompileFromFile(L"Shaders/Cas.hlsl", L"PSMain", PSTarget, PSByteCode))
+    FShaderCompiler Compiler;
+    const std::wstring CSTarget = RendererUtils::BuildShaderTarget(L"cs", Device->GetShaderModel());
+    std::vector<uint8_t> CSByteCode;
+    if (!Compiler.CompileFromFile(L"Shaders/FusedPost.hlsl", L"CSMain", CSTarget, CSByteCode))
     {
         return false;
     }
 
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC PsoDesc = {};
-    PsoDesc.pRootSignature = CasRootSignature.Get();
-    PsoDesc.VS = { VSByteCode.data(), VSByteCode.size() };
-    PsoDesc.PS = { PSByteCode.data(), PSByteCode.size() };
-    PsoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-    PsoDesc.SampleDesc.Count = 1;
-    PsoDesc.SampleMask = UINT_MAX;
-
-    PsoDesc.RasterizerState = {};
-    PsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
-    PsoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
-    PsoDesc.RasterizerState.FrontCounterClockwise = TRUE;
-    PsoDesc.RasterizerState.DepthClipEnable = TRUE;
-
-    PsoDesc.BlendState = {};
-    PsoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
-
-    PsoDesc.DepthStencilState = {};
-    PsoDesc.DepthStencilState.DepthEnable = FALSE;
-    PsoDesc.DepthStencilState.StencilEnable = FALSE;
-    PsoDesc.NumRenderTargets = 1;
-    PsoDesc.RTVFormats[0] = BackBufferFormat;
-    PsoDesc.DSVFormat = DXGI_FORMAT_UNKNOWN;
+    D3D12_COMPUTE_PIPELINE_STATE_DESC PsoDesc = {};
+    PsoDesc.pRootSignature = FusedPostRootSignature.Get();
+    PsoDesc.CS = { CSByteCode.data(), CSByteCode.size() };
 
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(CasPipeline.GetAddressOf())));
-    return true;
+    return SUCCEEDED(Device->GetPipelineCache()->CreateComputePipelineState(PsoDesc, FusedPostPipeline.ReleaseAndGetAddressOf()));
 }
 
 bool FDeferredRenderer::CreateGBufferResources(FDX12Device* Device, uint32_t Width, uint32_t Height)
 {
     Microsoft::WRL::ComPtr<ID3D12Resource>* Targets[3] = { &GBufferA, &GBufferB, &GBufferC };
     const wchar_t* GBufferNames[3] = { L"GBufferA", L"GBufferB", L"GBufferC" };
+    const char* GBufferTargetNames[3] = { "GBufferA", "GBufferB", "GBufferC" };
 
     D3D12_RESOURCE_DESC Desc = {};
     Desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
@@ -2587,7 +4367,7 @@ bool FDeferredRenderer::CreateGBufferResources(FDX12Device* Device, uint32_t Wid
     RtvHandle.ptr = 0;
 
     D3D12_DESCRIPTOR_HEAP_DESC RtvHeapDesc = {};
-    RtvHeapDesc.NumDescriptors = 5;
+    RtvHeapDesc.NumDescriptors = 6;
     RtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
     RtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
     HR_CHECK(Device->GetDevice()->CreateDescriptorHeap(&RtvHeapDesc, IID_PPV_ARGS(GBufferRTVHeap.GetAddressOf())));
@@ -2611,15 +4391,21 @@ bool FDeferredRenderer::CreateGBufferResources(FDX12Device* Device, uint32_t Wid
         ClearValue.Color[2] = 0.0f;
         ClearValue.Color[3] = 1.0f;
 
-        HR_CHECK(Device->GetDevice()->CreateCommittedResource(
-            &HeapProps,
-            D3D12_HEAP_FLAG_NONE,
-            &Desc,
-            D3D12_RESOURCE_STATE_RENDER_TARGET,
-            &ClearValue,
-            IID_PPV_ARGS(Targets[i]->GetAddressOf())));
-
-        Targets[i]->Get()->SetName(GBufferNames[i]);
+        if (!AdoptPersistentTarget(GBufferTargetNames[i], Desc, *Targets[i], GBufferStates[i]))
+        {
+            HR_CHECK(Device->CreateCommittedResource(
+                EGpuMemoryCategory::RenderTarget,
+                &HeapProps,
+                D3D12_HEAP_FLAG_NONE,
+                &Desc,
+                D3D12_RESOURCE_STATE_RENDER_TARGET,
+                &ClearValue,
+                IID_PPV_ARGS(Targets[i]->GetAddressOf())));
+
+            Targets[i]->Get()->SetName(GBufferNames[i]);
+            GBufferStates[i] = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        }
+        RegisterPersistentTarget(GBufferTargetNames[i], Targets[i]->Get(), GBufferStates[i]);
 
         GBufferRTVHandles[i] = RtvHandle;
         D3D12_RENDER_TARGET_VIEW_DESC RtvDesc = {};
@@ -2627,13 +4413,13 @@ bool FDeferredRenderer::CreateGBufferResources(FDX12Device* Device, uint32_t Wid
         RtvDesc.Format = GBufferFormats[i];
         Device->GetDevice()->CreateRenderTargetView(Targets[i]->Get(), &RtvDesc, RtvHandle);
         RtvHandle.ptr += RtvDescriptorSize;
-
-        GBufferStates[i] = D3D12_RESOURCE_STATE_RENDER_TARGET;
     }
 
+    // The tiled lighting kernels add to the lighting buffer through a UAV.
     Desc.Width = Width;
     Desc.Height = Height;
     Desc.Format = LightingBufferFormat;
+    Desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
 
     D3D12_CLEAR_VALUE LightingClear = {};
     LightingClear.Format = Desc.Format;
@@ -2642,15 +4428,20 @@ bool FDeferredRenderer::CreateGBufferResources(FDX12Device* Device, uint32_t Wid
     LightingClear.Color[2] = 0.0f;
     LightingClear.Color[3] = 1.0f;
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
-        &HeapProps,
-        D3D12_HEAP_FLAG_NONE,
-        &Desc,
-        LightingBufferState,
-        &LightingClear,
-        IID_PPV_ARGS(LightingBuffer.GetAddressOf())));
+    if (!AdoptPersistentTarget("LightingBuffer", Desc, LightingBuffer, LightingBufferState))
+    {
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::RenderTarget,
+            &HeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &Desc,
+            LightingBufferState,
+            &LightingClear,
+            IID_PPV_ARGS(LightingBuffer.GetAddressOf())));
 
-    LightingBuffer->SetName(L"LightingBuffer");
+        LightingBuffer->SetName(L"LightingBuffer");
+    }
+    RegisterPersistentTarget("LightingBuffer", LightingBuffer.Get(), LightingBufferState);
 
     LightingRTVHandle = RtvHandle;
     D3D12_RENDER_TARGET_VIEW_DESC LightingRtvDesc = {};
@@ -2662,6 +4453,7 @@ bool FDeferredRenderer::CreateGBufferResources(FDX12Device* Device, uint32_t Wid
     Desc.Width = Width;
     Desc.Height = Height;
     Desc.Format = BackBufferFormat;
+    Desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
 
     D3D12_CLEAR_VALUE TonemapClear = {};
     TonemapClear.Format = Desc.Format;
@@ -2670,21 +4462,53 @@ bool FDeferredRenderer::CreateGBufferResources(FDX12Device* Device, uint32_t Wid
     TonemapClear.Color[2] = 0.0f;
     TonemapClear.Color[3] = 1.0f;
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
-        &HeapProps,
-        D3D12_HEAP_FLAG_NONE,
-        &Desc,
-        TonemapOutputState,
-        &TonemapClear,
-        IID_PPV_ARGS(TonemapOutput.GetAddressOf())));
+    if (!AdoptPersistentTarget("TonemapOutput", Desc, TonemapOutput, TonemapOutputState))
+    {
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::RenderTarget,
+            &HeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &Desc,
+            TonemapOutputState,
+            &TonemapClear,
+            IID_PPV_ARGS(TonemapOutput.GetAddressOf())));
 
-    TonemapOutput->SetName(L"TonemapOutput");
+        TonemapOutput->SetName(L"TonemapOutput");
+    }
+    RegisterPersistentTarget("TonemapOutput", TonemapOutput.Get(), TonemapOutputState);
 
     TonemapOutputRtvHandle = RtvHandle;
     D3D12_RENDER_TARGET_VIEW_DESC TonemapRtvDesc = {};
     TonemapRtvDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D;
     TonemapRtvDesc.Format = BackBufferFormat;
     Device->GetDevice()->CreateRenderTargetView(TonemapOutput.Get(), &TonemapRtvDesc, RtvHandle);
+    RtvHandle.ptr += RtvDescriptorSize;
+
+    Desc.Format = VelocityFormat;
+
+    D3D12_CLEAR_VALUE VelocityClear = {};
+    VelocityClear.Format = Desc.Format;
+
+    if (!AdoptPersistentTarget("Velocity", Desc, VelocityTexture, VelocityState))
+    {
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::RenderTarget,
+            &HeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &Desc,
+            VelocityState,
+            &VelocityClear,
+            IID_PPV_ARGS(VelocityTexture.GetAddressOf())));
+
+        VelocityTexture->SetName(L"Velocity");
+    }
+    RegisterPersistentTarget("Velocity", VelocityTexture.Get(), VelocityState);
+
+    VelocityRTVHandle = RtvHandle;
+    D3D12_RENDER_TARGET_VIEW_DESC VelocityRtvDesc = {};
+    VelocityRtvDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D;
+    VelocityRtvDesc.Format = VelocityFormat;
+    Device->GetDevice()->CreateRenderTargetView(VelocityTexture.Get(), &VelocityRtvDesc, RtvHandle);
 
     return true;
 }
@@ -2709,7 +4533,8 @@ bool FDeferredRenderer::CreateLuminanceResources(FDX12Device* Device)
     Desc.SampleDesc.Count = 1;
     Desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::RenderTarget,
         &HeapProps,
         D3D12_HEAP_FLAG_NONE,
         &Desc,
@@ -2717,7 +4542,8 @@ bool FDeferredRenderer::CreateLuminanceResources(FDX12Device* Device)
         nullptr,
         IID_PPV_ARGS(LuminanceTextures[0].GetAddressOf())));
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::RenderTarget,
         &HeapProps,
         D3D12_HEAP_FLAG_NONE,
         &Desc,
@@ -2761,31 +4587,40 @@ bool FDeferredRenderer::CreateTaaResources(FDX12Device* Device, uint32_t Width,
 
     TaaHistoryTextures.clear();
     TaaHistoryTextures.resize(EffectiveFrameCount);
+    TaaStates.assign(EffectiveFrameCount, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
     for (uint32_t Index = 0; Index < EffectiveFrameCount; ++Index)
     {
-        HR_CHECK(Device->GetDevice()->CreateCommittedResource(
-            &HeapProps,
-            D3D12_HEAP_FLAG_NONE,
-            &Desc,
-            D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
-            nullptr,
-            IID_PPV_ARGS(TaaHistoryTextures[Index].GetAddressOf())));
-
-        if (TaaHistoryTextures[Index])
+        // History an adopted texture still holds is ignored until TaaHistoryValid says otherwise.
+        const std::string TargetName = "TaaHistory_" + std::to_string(Index);
+        if (!AdoptPersistentTarget(TargetName.c_str(), Desc, TaaHistoryTextures[Index], TaaStates[Index]))
         {
-            const std::wstring ResourceName = L"TaaHistory_" + std::to_wstring(Index);
-            TaaHistoryTextures[Index]->SetName(ResourceName.c_str());
+            HR_CHECK(Device->CreateCommittedResource(
+                EGpuMemoryCategory::RenderTarget,
+                &HeapProps,
+                D3D12_HEAP_FLAG_NONE,
+                &Desc,
+                D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+                nullptr,
+                IID_PPV_ARGS(TaaHistoryTextures[Index].GetAddressOf())));
+
+            if (TaaHistoryTextures[Index])
+            {
+                const std::wstring ResourceName = L"TaaHistory_" + std::to_wstring(Index);
+                TaaHistoryTextures[Index]->SetName(ResourceName.c_str());
+            }
         }
+        RegisterPersistentTarget(TargetName.c_str(), TaaHistoryTextures[Index].Get(), TaaStates[Index]);
     }
 
     TaaFrameCount = EffectiveFrameCount;
-    TaaStates.assign(EffectiveFrameCount, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
     TaaHistoryValid.assign(EffectiveFrameCount, false);
     return true;
 }
 
 void FDeferredRenderer::OnFrameFenceSignaled(uint32_t FrameIndex, uint64_t FenceValue)
 {
+    FRenderer::OnFrameFenceSignaled(FrameIndex, FenceValue);
+
     if (!bTaaEnabled || TaaFrameCount == 0)
     {
         return;
@@ -2810,6 +4645,8 @@ bool FDeferredRenderer::CreateHZBResources(FDX12Device* Device, uint32_t Width,
 
     HZBWidth = BaseWidth;
     HZBHeight = BaseHeight;
+    HZBContentWidth = BaseWidth;
+    HZBContentHeight = BaseHeight;
     HZBMipCount = 1;
 
     uint32_t MipWidth = BaseWidth;
@@ -2839,15 +4676,20 @@ bool FDeferredRenderer::CreateHZBResources(FDX12Device* Device, uint32_t Width,
     HeapProps.CreationNodeMask = 1;
     HeapProps.VisibleNodeMask = 1;
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
-        &HeapProps,
-        D3D12_HEAP_FLAG_NONE,
-        &Desc,
-        HZBState,
-        nullptr,
-        IID_PPV_ARGS(HierarchicalZBuffer.GetAddressOf())));
+    if (!AdoptPersistentTarget("HierarchicalZBuffer", Desc, HierarchicalZBuffer, HZBState))
+    {
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::RenderTarget,
+            &HeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &Desc,
+            HZBState,
+            nullptr,
+            IID_PPV_ARGS(HierarchicalZBuffer.GetAddressOf())));
 
-    HierarchicalZBuffer->SetName(L"HierarchicalZBuffer");
+        HierarchicalZBuffer->SetName(L"HierarchicalZBuffer");
+    }
+    RegisterPersistentTarget("HierarchicalZBuffer", HierarchicalZBuffer.Get(), HZBState);
 
     {
         D3D12_RESOURCE_DESC NullDesc = {};
@@ -2863,7 +4705,8 @@ bool FDeferredRenderer::CreateHZBResources(FDX12Device* Device, uint32_t Width,
         NullDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
         NullDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
 
-        HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::RenderTarget,
             &HeapProps,
             D3D12_HEAP_FLAG_NONE,
             &NullDesc,
@@ -2874,74 +4717,66 @@ bool FDeferredRenderer::CreateHZBResources(FDX12Device* Device, uint32_t Width,
         HZBNullUavResource->SetName(L"HZBNullUavResource");
     }
 
+    if (!HZBGroupCounter)
+    {
+        // Starts zeroed and stays in COMMON; the single-pass build is promoted to UAV on each use.
+        D3D12_RESOURCE_DESC CounterDesc = {};
+        CounterDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        CounterDesc.Width = sizeof(uint32_t);
+        CounterDesc.Height = 1;
+        CounterDesc.DepthOrArraySize = 1;
+        CounterDesc.MipLevels = 1;
+        CounterDesc.Format = DXGI_FORMAT_UNKNOWN;
+        CounterDesc.SampleDesc.Count = 1;
+        CounterDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        CounterDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::Buffer,
+            &HeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &CounterDesc,
+            D3D12_RESOURCE_STATE_COMMON,
+            nullptr,
+            IID_PPV_ARGS(HZBGroupCounter.GetAddressOf())));
+
+        HZBGroupCounter->SetName(L"HZBGroupCounter");
+    }
+
     return true;
 }
 
 bool FDeferredRenderer::CreateDescriptorHeap(FDX12Device* Device)
 {
     const UINT TextureCount = static_cast<UINT>(SceneTextures.size());
-    const UINT MipCount = HZBMipCount == 0 ? 1u : static_cast<UINT>(HZBMipCount);
-    const UINT HZBDescriptorCount = 3 + (MipCount * 2);
     const UINT TaaDescriptorCount = static_cast<UINT>(TaaHistoryTextures.size()) * 2;
     const UINT DepthDescriptorCount = GetFramesInFlight();
 
-    D3D12_DESCRIPTOR_HEAP_DESC HeapDesc = {};
-    HeapDesc.NumDescriptors = TextureCount * 4 + 12 + HZBDescriptorCount + TaaDescriptorCount + DepthDescriptorCount;
-    HeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    HeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-    HR_CHECK(Device->GetDevice()->CreateDescriptorHeap(&HeapDesc, IID_PPV_ARGS(DescriptorHeap.GetAddressOf())));
-    if (DescriptorHeap)
+    // Tables bound by passes live in the shared shader-visible heap. Views the HZB build gathers
+    // per dispatch only need CPU handles, so they live in the staging heap.
+    SceneDescriptors = AllocatePersistentDescriptors(TextureCount * 4 + 14 + 1 + TaaDescriptorCount);
+    const FDX12DescriptorRange StagingDescriptors = AllocateStagingDescriptors(DepthDescriptorCount + 1 + HZBMipCount * 2 + 1);
+    if (!SceneDescriptors.IsValid() || !StagingDescriptors.IsValid())
     {
-        DescriptorHeap->SetName(L"DescriptorHeap");
+        LogError("Failed to allocate deferred renderer descriptors");
+        return false;
     }
+    DescriptorHeap = Device->GetDescriptorAllocator()->GetHeap();
 
-    const UINT DescriptorSize = Device->GetDevice()->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-    D3D12_CPU_DESCRIPTOR_HANDLE CpuHandle = DescriptorHeap->GetCPUDescriptorHandleForHeapStart();
-    D3D12_GPU_DESCRIPTOR_HANDLE GpuHandle = DescriptorHeap->GetGPUDescriptorHandleForHeapStart();
-
-    const auto CreateSceneTextureSrv = [&](ID3D12Resource* Texture)
-    {
-        ID3D12Resource* Resource = Texture ? Texture : NullTexture.Get();
-        if (!Resource)
-        {
-            return;
-        }
-
-        const D3D12_RESOURCE_DESC TextureDesc = Resource->GetDesc();
-
-        D3D12_SHADER_RESOURCE_VIEW_DESC SceneSrvDesc = {};
-        SceneSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-        SceneSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        SceneSrvDesc.Format = TextureDesc.Format;
-        SceneSrvDesc.Texture2D.MipLevels = TextureDesc.MipLevels;
-        SceneSrvDesc.Texture2D.MostDetailedMip = 0;
-        SceneSrvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
-
-        Device->GetDevice()->CreateShaderResourceView(Resource, &SceneSrvDesc, CpuHandle);
-    };
+    const UINT DescriptorSize = SceneDescriptors.DescriptorSize;
+    D3D12_CPU_DESCRIPTOR_HANDLE CpuHandle = SceneDescriptors.CpuStart;
+    D3D12_GPU_DESCRIPTOR_HANDLE GpuHandle = SceneDescriptors.GpuStart;
+    D3D12_CPU_DESCRIPTOR_HANDLE StagingHandle = StagingDescriptors.CpuStart;
 
     for (size_t Index = 0; Index < SceneTextures.size(); ++Index)
     {
-        CreateSceneTextureSrv(SceneTextures[Index].BaseColor.Get());
+        WriteMaterialTable(SceneTextures[Index], CpuHandle);
         SceneModels[Index].TextureHandle = GpuHandle;
+        SceneModels[Index].MaterialDescriptorIndex = SceneDescriptors.Offset
+            + static_cast<uint32_t>((GpuHandle.ptr - SceneDescriptors.GpuStart.ptr) / DescriptorSize);
 
-        CpuHandle.ptr += DescriptorSize;
-        GpuHandle.ptr += DescriptorSize;
-
-        CreateSceneTextureSrv(SceneTextures[Index].MetallicRoughness.Get());
-
-        CpuHandle.ptr += DescriptorSize;
-        GpuHandle.ptr += DescriptorSize;
-
-        CreateSceneTextureSrv(SceneTextures[Index].Normal.Get());
-
-        CpuHandle.ptr += DescriptorSize;
-        GpuHandle.ptr += DescriptorSize;
-
-        CreateSceneTextureSrv(SceneTextures[Index].Emissive.Get());
-
-        CpuHandle.ptr += DescriptorSize;
-        GpuHandle.ptr += DescriptorSize;
+        CpuHandle.ptr += DescriptorSize * 4;
+        GpuHandle.ptr += DescriptorSize * 4;
     }
 
     ID3D12Resource* Buffers[3] = { GBufferA.Get(), GBufferB.Get(), GBufferC.Get() };
@@ -2959,10 +4794,11 @@ bool FDeferredRenderer::CreateDescriptorHeap(FDX12Device* Device)
     }
 
     D3D12_SHADER_RESOURCE_VIEW_DESC ShadowSrvDesc = {};
-    ShadowSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    ShadowSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
     ShadowSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
     ShadowSrvDesc.Format = DXGI_FORMAT_R32_FLOAT;
-    ShadowSrvDesc.Texture2D.MipLevels = 1;
+    ShadowSrvDesc.Texture2DArray.MipLevels = 1;
+    ShadowSrvDesc.Texture2DArray.ArraySize = FShadowCascades::CascadeCount;
     Device->GetDevice()->CreateShaderResourceView(ShadowMap.Get(), &ShadowSrvDesc, CpuHandle);
     ShadowMapHandle = GpuHandle;
 
@@ -2999,6 +4835,18 @@ bool FDeferredRenderer::CreateDescriptorHeap(FDX12Device* Device)
         GpuHandle.ptr += DescriptorSize;
     }
 
+    {
+        D3D12_SHADER_RESOURCE_VIEW_DESC TransmittanceSrvDesc = {};
+        TransmittanceSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        TransmittanceSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        TransmittanceSrvDesc.Format = FSkyAtmosphere::LutFormat;
+        TransmittanceSrvDesc.Texture2D.MipLevels = 1;
+        Device->GetDevice()->CreateShaderResourceView(SkyAtmosphere.GetTransmittanceLut(), &TransmittanceSrvDesc, CpuHandle);
+
+        CpuHandle.ptr += DescriptorSize;
+        GpuHandle.ptr += DescriptorSize;
+    }
+
     {
         D3D12_SHADER_RESOURCE_VIEW_DESC LightingSrvDesc = {};
         LightingSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
@@ -3010,6 +4858,17 @@ bool FDeferredRenderer::CreateDescriptorHeap(FDX12Device* Device)
 
         CpuHandle.ptr += DescriptorSize;
         GpuHandle.ptr += DescriptorSize;
+
+        D3D12_UNORDERED_ACCESS_VIEW_DESC LightingUavDesc = {};
+        LightingUavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+        LightingUavDesc.Format = LightingBufferFormat;
+        LightingUavDesc.Texture2D.MipSlice = 0;
+        LightingUavDesc.Texture2D.PlaneSlice = 0;
+        Device->GetDevice()->CreateUnorderedAccessView(LightingBuffer.Get(), nullptr, &LightingUavDesc, CpuHandle);
+        LightingBufferUavHandle = GpuHandle;
+
+        CpuHandle.ptr += DescriptorSize;
+        GpuHandle.ptr += DescriptorSize;
     }
 
     {
@@ -3092,11 +4951,22 @@ bool FDeferredRenderer::CreateDescriptorHeap(FDX12Device* Device)
         DepthSrvDesc.Texture2D.MostDetailedMip = 0;
         DepthSrvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
         ID3D12Resource* DepthBuffer = DepthResourcesPerFrame.empty() ? nullptr : DepthResourcesPerFrame[Index].DepthBuffer.Get();
-        Device->GetDevice()->CreateShaderResourceView(DepthBuffer, &DepthSrvDesc, CpuHandle);
-        DepthBufferHandles[Index] = GpuHandle;
+        Device->GetDevice()->CreateShaderResourceView(DepthBuffer, &DepthSrvDesc, StagingHandle);
+        DepthBufferHandles[Index] = StagingHandle;
 
-        CpuHandle.ptr += DescriptorSize;
-        GpuHandle.ptr += DescriptorSize;
+        StagingHandle.ptr += DescriptorSize;
+    }
+
+    {
+        D3D12_SHADER_RESOURCE_VIEW_DESC VelocitySrvDesc = {};
+        VelocitySrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        VelocitySrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        VelocitySrvDesc.Format = VelocityFormat;
+        VelocitySrvDesc.Texture2D.MipLevels = 1;
+        Device->GetDevice()->CreateShaderResourceView(VelocityTexture.Get(), &VelocitySrvDesc, StagingHandle);
+        VelocitySrvHandle = StagingHandle;
+
+        StagingHandle.ptr += DescriptorSize;
     }
 
     {
@@ -3126,11 +4996,10 @@ bool FDeferredRenderer::CreateDescriptorHeap(FDX12Device* Device)
         HZBMipSrvDesc.Texture2D.MostDetailedMip = Mip;
         HZBMipSrvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
 
-        Device->GetDevice()->CreateShaderResourceView(HierarchicalZBuffer.Get(), &HZBMipSrvDesc, CpuHandle);
-        HZBSrvMipHandles.push_back(GpuHandle);
+        Device->GetDevice()->CreateShaderResourceView(HierarchicalZBuffer.Get(), &HZBMipSrvDesc, StagingHandle);
+        HZBSrvMipHandles.push_back(StagingHandle);
 
-        CpuHandle.ptr += DescriptorSize;
-        GpuHandle.ptr += DescriptorSize;
+        StagingHandle.ptr += DescriptorSize;
     }
 
     HZBUavHandles.clear();
@@ -3143,11 +5012,10 @@ bool FDeferredRenderer::CreateDescriptorHeap(FDX12Device* Device)
         UavDesc.Texture2D.MipSlice = Mip;
         UavDesc.Texture2D.PlaneSlice = 0;
 
-        Device->GetDevice()->CreateUnorderedAccessView(HierarchicalZBuffer.Get(), nullptr, &UavDesc, CpuHandle);
-        HZBUavHandles.push_back(GpuHandle);
+        Device->GetDevice()->CreateUnorderedAccessView(HierarchicalZBuffer.Get(), nullptr, &UavDesc, StagingHandle);
+        HZBUavHandles.push_back(StagingHandle);
 
-        CpuHandle.ptr += DescriptorSize;
-        GpuHandle.ptr += DescriptorSize;
+        StagingHandle.ptr += DescriptorSize;
     }
 
     {
@@ -3157,11 +5025,10 @@ bool FDeferredRenderer::CreateDescriptorHeap(FDX12Device* Device)
         NullUavDesc.Texture2D.MipSlice = 0;
         NullUavDesc.Texture2D.PlaneSlice = 0;
 
-        Device->GetDevice()->CreateUnorderedAccessView(HZBNullUavResource.Get(), nullptr, &NullUavDesc, CpuHandle);
-        HZBNullUavHandle = GpuHandle;
+        Device->GetDevice()->CreateUnorderedAccessView(HZBNullUavResource.Get(), nullptr, &NullUavDesc, StagingHandle);
+        HZBNullUavHandle = StagingHandle;
 
-        CpuHandle.ptr += DescriptorSize;
-        GpuHandle.ptr += DescriptorSize;
+        StagingHandle.ptr += DescriptorSize;
     }
 
     return true;
@@ -3209,6 +5076,66 @@ namespace
 
 }
 
+void FDeferredRenderer::WriteMaterialTable(const FModelTextureSet& TextureSet, D3D12_CPU_DESCRIPTOR_HANDLE CpuHandle) const
+{
+    const UINT DescriptorSize = Device->GetDescriptorAllocator()->GetDescriptorSize();
+    ID3D12Resource* const Textures[4] =
+    {
+        TextureSet.BaseColor.Get(),
+        TextureSet.MetallicRoughness.Get(),
+        TextureSet.Normal.Get(),
+        TextureSet.Emissive.Get(),
+    };
+
+    for (ID3D12Resource* Texture : Textures)
+    {
+        ID3D12Resource* Resource = Texture ? Texture : NullTexture.Get();
+        if (Resource)
+        {
+            const D3D12_RESOURCE_DESC TextureDesc = Resource->GetDesc();
+
+            D3D12_SHADER_RESOURCE_VIEW_DESC SceneSrvDesc = {};
+            SceneSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+            SceneSrvDesc.Shader4ComponentMapping = RendererUtils::GetTextureComponentMapping(TextureDesc.Format);
+            SceneSrvDesc.Format = TextureDesc.Format;
+            SceneSrvDesc.Texture2D.MipLevels = TextureDesc.MipLevels;
+            SceneSrvDesc.Texture2D.MostDetailedMip = 0;
+            SceneSrvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
+
+            Device->GetDevice()->CreateShaderResourceView(Resource, &SceneSrvDesc, CpuHandle);
+        }
+
+        CpuHandle.ptr += DescriptorSize;
+    }
+}
+
+void FDeferredRenderer::OnSceneTexturesResident(FStreamedModelTextures& Textures)
+{
+    if (Textures.ModelIndex >= SceneTextures.size())
+    {
+        return;
+    }
+
+    const FDX12DescriptorRange Table = AllocateStreamedMaterialTable(Textures.ModelIndex, 4);
+    if (!Table.IsValid())
+    {
+        LogWarning("Failed to allocate a streamed material table for scene model " + std::to_string(Textures.ModelIndex));
+        return;
+    }
+
+    FModelTextureSet& TextureSet = SceneTextures[Textures.ModelIndex];
+    TextureSet.BaseColor = std::move(Textures.BaseColor);
+    TextureSet.MetallicRoughness = std::move(Textures.MetallicRoughness);
+    TextureSet.Normal = Textures.Normal ? std::move(Textures.Normal) : FlatNormalTexture;
+    TextureSet.Emissive = std::move(Textures.Emissive);
+
+    WriteMaterialTable(TextureSet, Table.GetCpuHandle(0));
+
+    FSceneModelResource& Model = SceneModels[Textures.ModelIndex];
+    Model.TextureHandle = Table.GetGpuHandle(0);
+    Model.MaterialDescriptorIndex = Table.Offset;
+}
+
 bool FDeferredRenderer::CreateSceneTextures(FDX12Device* Device, const std::vector<FSceneModelResource>& Models)
 {
     if (!TextureLoader)
@@ -3219,6 +5146,26 @@ bool FDeferredRenderer::CreateSceneTextures(FDX12Device* Device, const std::vect
     SceneTextures.clear();
     SceneTextures.reserve(Models.size());
 
+    if (bStreamSceneTextures)
+    {
+        if (!StartSceneTextureStreaming(Device, Models))
+        {
+            return false;
+        }
+
+        for (const FSceneModelResource& Model : Models)
+        {
+            FModelTextureSet TextureSet;
+            TextureSet.Normal = FlatNormalTexture;
+            if (!Model.EmissiveTexturePath.empty())
+            {
+                TextureSet.Emissive = BlackTexture;
+            }
+            SceneTextures.push_back(TextureSet);
+        }
+        return true;
+    }
+
     // Prepare all texture load requests
     std::vector<FTextureLoadRequest> Requests;
     Requests.reserve(Models.size() * 4); // 4 textures per model
@@ -3262,6 +5209,7 @@ bool FDeferredRenderer::CreateSceneTextures(FDX12Device* Device, const std::vect
         NormalRequest.Path = Model.NormalTexturePath;
         NormalRequest.SolidColor = 0xff8080ff;
         NormalRequest.bUseSolidColor = Model.NormalTexturePath.empty();
+        NormalRequest.bNormalMap = true;
         NormalRequest.OutTexture = &TextureSet.Normal;
         Requests.push_back(NormalRequest);
 
@@ -3291,81 +5239,133 @@ bool FDeferredRenderer::CreateSceneTextures(FDX12Device* Device, const std::vect
 
 bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
 {
-    if (!Device || SceneModels.empty() || !GetSceneConstantBuffer())
+    if (!Device || SceneModels.empty() || !SceneObjectBuffer)
+    {
+        return false;
+    }
+
+    const bool bSharedGeometry = std::all_of(SceneModels.begin(), SceneModels.end(), [this](const FSceneModelResource& Model)
+    {
+        return Model.Geometry.VertexBuffer == SceneModels.front().Geometry.VertexBuffer
+            && Model.Geometry.IndexBuffer == SceneModels.front().Geometry.IndexBuffer;
+    });
+    if (!bSharedGeometry)
     {
+        LogWarning("Scene models do not share one geometry buffer; indirect draws disabled");
         return false;
     }
 
     IndirectDrawRanges.clear();
 
-    std::vector<uint32_t> SortedIndices(SceneModels.size());
-    for (uint32_t Index = 0; Index < SortedIndices.size(); ++Index)
+    // Instances of one mesh section sort next to each other so they fall into one group; the
+    // material field stays empty because instances with equal texture paths still have their own
+    // tables, and the stable sort keeps scene order among equal keys.
+    FDrawList IndirectDrawList;
+    IndirectDrawList.Reserve(SceneModels.size());
+    for (uint32_t Index = 0; Index < SceneModels.size(); ++Index)
     {
-        SortedIndices[Index] = Index;
+        const uint32_t PipelineKey = ResolveMaterialPipelineKey(RendererUtils::BuildMaterialPipelineKey(SceneModels[Index]));
+        IndirectDrawList.Add(FDrawList::BuildSortKey(PipelineKey, 0, 0, SceneModels[Index].DrawIndexStart), Index);
     }
+    IndirectDrawList.Sort();
 
-    std::sort(SortedIndices.begin(), SortedIndices.end(), [&](uint32_t A, uint32_t B)
+    std::vector<uint32_t> SortedIndices;
+    SortedIndices.reserve(SceneModels.size());
+    for (const FDrawListEntry& Entry : IndirectDrawList.GetEntries())
     {
-        const FSceneModelResource& ModelA = SceneModels[A];
-        const FSceneModelResource& ModelB = SceneModels[B];
-        const uint32_t KeyA = BuildPipelineKey(ModelA);
-        const uint32_t KeyB = BuildPipelineKey(ModelB);
-        if (KeyA != KeyB)
-        {
-            return KeyA < KeyB;
-        }
-        return ModelA.TextureHandle.ptr < ModelB.TextureHandle.ptr;
-    });
+        SortedIndices.push_back(Entry.ModelIndex);
+    }
 
     std::vector<FIndirectDrawCommand> Commands;
     Commands.reserve(SceneModels.size());
 
-    std::vector<DirectX::XMFLOAT4> Bounds;
-    Bounds.reserve(SceneModels.size() * 2);
+    std::vector<FModelCullingData> Bounds(SceneModels.size());
+    uint32_t VisibleInstanceSlotCount = 0;
+    IndirectInstanceGroupCount = 0;
 
-    const D3D12_GPU_VIRTUAL_ADDRESS ConstantBufferBase = GetSceneConstantBufferAddress();
-    auto AppendIndirectDrawData = [&](uint32_t SortedIndex)
+    // Models that share a mesh section and material become one instance group drawn by one command
+    // per LOD; culling appends each visible member to the command of the LOD it selects, so every
+    // command reserves a slot for every member.
+    auto AppendIndirectDrawData = [&](size_t GroupBegin, size_t GroupEnd)
     {
+        const uint32_t SortedIndex = SortedIndices[GroupBegin];
         const FSceneModelResource& Model = SceneModels[SortedIndex];
-        const uint32_t PipelineKey = BuildPipelineKey(Model);
+        const uint32_t PipelineKey = ResolveMaterialPipelineKey(RendererUtils::BuildMaterialPipelineKey(Model));
+        const D3D12_GPU_DESCRIPTOR_HANDLE MaterialTable = ResolveMaterialTable(Model);
 
         if (IndirectDrawRanges.empty()
             || IndirectDrawRanges.back().PipelineKey != PipelineKey
-            || IndirectDrawRanges.back().TextureHandle.ptr != Model.TextureHandle.ptr)
+            || IndirectDrawRanges.back().TextureHandle.ptr != MaterialTable.ptr)
         {
             FIndirectDrawRange Range;
             Range.Start = static_cast<uint32_t>(Commands.size());
             Range.Count = 0;
             Range.PipelineKey = PipelineKey;
-            Range.TextureHandle = Model.TextureHandle;
-            if (!Model.Name.empty())
+            Range.TextureHandle = MaterialTable;
+            if (bBindlessMaterials)
+            {
+                Range.Name = (PipelineKey & MaterialAlphaMaskKey) != 0 ? L"BindlessMasked" : L"BindlessOpaque";
+            }
+            else if (!Model.Name.empty())
             {
                 Range.Name.assign(Model.Name.begin(), Model.Name.end());
             }
             IndirectDrawRanges.push_back(Range);
         }
 
-        FIndirectDrawCommand Command = {};
-        Command.VertexBufferView = Model.Geometry.VertexBufferView;
-        Command.IndexBufferView = Model.Geometry.IndexBufferView;
-        Command.ConstantBufferAddress = ConstantBufferBase + SceneConstantBufferStride * SortedIndex;
-        Command.DrawArguments.IndexCountPerInstance = Model.DrawIndexCount;
-        Command.DrawArguments.InstanceCount = 1;
-        Command.DrawArguments.StartIndexLocation = Model.DrawIndexStart;
-        Command.DrawArguments.BaseVertexLocation = 0;
-        Command.DrawArguments.StartInstanceLocation = SortedIndex;
-        Commands.push_back(Command);
-        Bounds.emplace_back(Model.BoundsMin.x, Model.BoundsMin.y, Model.BoundsMin.z, 0.0f);
-        Bounds.emplace_back(Model.BoundsMax.x, Model.BoundsMax.y, Model.BoundsMax.z, 0.0f);
-        IndirectDrawRanges.back().Count += 1;
+        const uint32_t GroupSize = static_cast<uint32_t>(GroupEnd - GroupBegin);
+        const uint32_t CommandStart = static_cast<uint32_t>(Commands.size());
+        const FModelCullingData GroupCulling = RendererUtils::BuildModelCullingData(Model);
+        for (uint32_t LodIndex = 0; LodIndex < GroupCulling.LodCount; ++LodIndex)
+        {
+            FIndirectDrawCommand Command = {};
+            Command.InstanceBase = VisibleInstanceSlotCount;
+            Command.DrawArguments.IndexCountPerInstance = GroupCulling.Lods[LodIndex].IndexCount;
+            Command.DrawArguments.InstanceCount = 0;
+            Command.DrawArguments.StartIndexLocation = GroupCulling.Lods[LodIndex].IndexStart;
+            Command.DrawArguments.BaseVertexLocation = 0;
+            Command.DrawArguments.StartInstanceLocation = 0;
+            Commands.push_back(Command);
+            VisibleInstanceSlotCount += GroupSize;
+        }
+
+        for (size_t MemberIndex = GroupBegin; MemberIndex < GroupEnd; ++MemberIndex)
+        {
+            const uint32_t ModelIndex = SortedIndices[MemberIndex];
+            Bounds[ModelIndex] = RendererUtils::BuildModelCullingData(SceneModels[ModelIndex]);
+            Bounds[ModelIndex].CommandStart = CommandStart;
+        }
+
+        IndirectDrawRanges.back().Count += GroupCulling.LodCount;
+        ++IndirectInstanceGroupCount;
     };
 
-    for (uint32_t SortedIndex : SortedIndices)
+    for (size_t GroupBegin = 0; GroupBegin < SortedIndices.size();)
     {
-        AppendIndirectDrawData(SortedIndex);
+        size_t GroupEnd = GroupBegin + 1;
+        while (GroupEnd < SortedIndices.size()
+            && ResolveMaterialPipelineKey(RendererUtils::BuildMaterialPipelineKey(SceneModels[SortedIndices[GroupEnd]])) == ResolveMaterialPipelineKey(RendererUtils::BuildMaterialPipelineKey(SceneModels[SortedIndices[GroupBegin]]))
+            && RendererUtils::CanShareInstancedDraw(SceneModels[SortedIndices[GroupBegin]], SceneModels[SortedIndices[GroupEnd]]))
+        {
+            ++GroupEnd;
+        }
+        AppendIndirectDrawData(GroupBegin, GroupEnd);
+        GroupBegin = GroupEnd;
     }
 
     IndirectCommandCount = static_cast<uint32_t>(Commands.size());
+    IndirectInstanceCount = static_cast<uint32_t>(SceneModels.size());
+    LogInfo("Indirect draws: " + std::to_string(IndirectInstanceCount) + " models in " + std::to_string(IndirectInstanceGroupCount) + " instance groups, " + std::to_string(IndirectCommandCount) + " commands");
+
+    // The second culling phase appends to a copy of every command with slots of its own, since a
+    // LOD's members may be split across both phases.
+    for (uint32_t CommandIndex = 0; CommandIndex < IndirectCommandCount; ++CommandIndex)
+    {
+        FIndirectDrawCommand Command = Commands[CommandIndex];
+        Command.InstanceBase += VisibleInstanceSlotCount;
+        Commands.push_back(Command);
+    }
+    VisibleInstanceSlotCount *= 2;
 
     const uint64_t CommandBufferSize = sizeof(FIndirectDrawCommand) * Commands.size();
 
@@ -3403,7 +5403,8 @@ bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
 
     for (uint32_t FrameIndex = 0; FrameIndex < GetFramesInFlight(); ++FrameIndex)
     {
-        HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::Buffer,
             &DefaultHeap,
             D3D12_HEAP_FLAG_NONE,
             &BufferDesc,
@@ -3416,7 +5417,8 @@ bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
             IndirectCommandBuffers[FrameIndex]->SetName(Name.c_str());
         }
 
-        HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::Upload,
             &UploadHeap,
             D3D12_HEAP_FLAG_NONE,
             &UploadDesc,
@@ -3428,29 +5430,22 @@ bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
         {
             void* UploadData = nullptr;
             HR_CHECK(IndirectCommandUploads[FrameIndex]->Map(0, &EmptyRange, &UploadData));
-            std::vector<FIndirectDrawCommand> FrameCommands = Commands;
-            const D3D12_GPU_VIRTUAL_ADDRESS ConstantBufferBase = SceneConstantBuffers[FrameIndex]
-                ? SceneConstantBuffers[FrameIndex]->GetGPUVirtualAddress()
-                : 0;
-            for (uint32_t CommandIndex = 0; CommandIndex < FrameCommands.size(); ++CommandIndex)
-            {
-                const uint32_t InstanceIndex = FrameCommands[CommandIndex].DrawArguments.StartInstanceLocation;
-                FrameCommands[CommandIndex].ConstantBufferAddress =
-                    ConstantBufferBase + SceneConstantBufferStride * InstanceIndex;
-            }
-            std::memcpy(UploadData, FrameCommands.data(), CommandBufferSize);
+            std::memcpy(UploadData, Commands.data(), CommandBufferSize);
             IndirectCommandUploads[FrameIndex]->Unmap(0, nullptr);
         }
     }
 
-    const uint64_t BoundsBufferSize = sizeof(DirectX::XMFLOAT4) * Bounds.size();
+    const uint64_t BoundsBufferSize = sizeof(FModelCullingData) * Bounds.size();
     D3D12_RESOURCE_DESC BoundsDesc = BufferDesc;
     BoundsDesc.Width = BoundsBufferSize;
-    BoundsDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+    // Moved models are written by Shaders/SceneScatter.hlsl.
+    BoundsDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
 
     D3D12_RESOURCE_DESC BoundsUploadDesc = BoundsDesc;
+    BoundsUploadDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Buffer,
         &DefaultHeap,
         D3D12_HEAP_FLAG_NONE,
         &BoundsDesc,
@@ -3458,7 +5453,8 @@ bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
         nullptr,
         IID_PPV_ARGS(ModelBoundsBuffer.GetAddressOf())));
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Upload,
         &UploadHeap,
         D3D12_HEAP_FLAG_NONE,
         &BoundsUploadDesc,
@@ -3470,12 +5466,63 @@ bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     HR_CHECK(ModelBoundsUpload->Map(0, &EmptyRange, &UploadData));
     std::memcpy(UploadData, Bounds.data(), BoundsBufferSize);
     ModelBoundsUpload->Unmap(0, nullptr);
+    ModelCullingCpuData = Bounds;
+
+    // Written by culling every frame before any draw reads it, so it needs no initial data.
+    D3D12_RESOURCE_DESC VisibleInstanceDesc = BufferDesc;
+    VisibleInstanceDesc.Width = sizeof(uint32_t) * static_cast<uint64_t>((std::max)(VisibleInstanceSlotCount, 1u));
+    VisibleInstanceBuffers.clear();
+    VisibleInstanceBuffers.resize(GetFramesInFlight());
+    VisibleInstanceStates.assign(GetFramesInFlight(), D3D12_RESOURCE_STATE_COMMON);
+    for (uint32_t FrameIndex = 0; FrameIndex < GetFramesInFlight(); ++FrameIndex)
+    {
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::Buffer,
+            &DefaultHeap,
+            D3D12_HEAP_FLAG_NONE,
+            &VisibleInstanceDesc,
+            D3D12_RESOURCE_STATE_COMMON,
+            nullptr,
+            IID_PPV_ARGS(VisibleInstanceBuffers[FrameIndex].GetAddressOf())));
+        if (VisibleInstanceBuffers[FrameIndex])
+        {
+            const std::wstring Name = L"VisibleInstanceBuffer_Frame" + std::to_wstring(FrameIndex);
+            VisibleInstanceBuffers[FrameIndex]->SetName(Name.c_str());
+        }
+    }
+
+    // Committed resources start zeroed, so the first frame's second phase draws everything.
+    D3D12_RESOURCE_DESC InstanceVisibilityDesc = BufferDesc;
+    InstanceVisibilityDesc.Width = sizeof(uint32_t) * static_cast<uint64_t>((std::max)(IndirectInstanceCount, 1u));
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Buffer,
+        &DefaultHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &InstanceVisibilityDesc,
+        D3D12_RESOURCE_STATE_COMMON,
+        nullptr,
+        IID_PPV_ARGS(InstanceVisibilityBuffer.ReleaseAndGetAddressOf())));
+    if (InstanceVisibilityBuffer)
+    {
+        InstanceVisibilityBuffer->SetName(L"InstanceVisibilityBuffer");
+    }
+    InstanceVisibilityState = D3D12_RESOURCE_STATE_COMMON;
+
+    if (!CreateIndirectCompactionResources(Device, 2))
+    {
+        return false;
+    }
+    if (!CreateShadowCullingResources(Device, Commands.data(), VisibleInstanceSlotCount / 2))
+    {
+        return false;
+    }
 
     D3D12_RESOURCE_DESC DebugDesc = BufferDesc;
     DebugDesc.Width = GpuDebugPrintBufferSize;
     DebugDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Buffer,
         &DefaultHeap,
         D3D12_HEAP_FLAG_NONE,
         &DebugDesc,
@@ -3498,7 +5545,8 @@ bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     DebugUploadDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
     DebugUploadDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Upload,
         &UploadHeap,
         D3D12_HEAP_FLAG_NONE,
         &DebugUploadDesc,
@@ -3519,7 +5567,7 @@ bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
 
     D3D12_RESOURCE_DESC StatsDesc = {};
     StatsDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    StatsDesc.Width = sizeof(uint32_t) * 2;
+    StatsDesc.Width = GpuDebugPrintStatsSize;
     StatsDesc.Height = 1;
     StatsDesc.DepthOrArraySize = 1;
     StatsDesc.MipLevels = 1;
@@ -3528,7 +5576,8 @@ bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     StatsDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
     StatsDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Buffer,
         &DefaultHeap,
         D3D12_HEAP_FLAG_NONE,
         &StatsDesc,
@@ -3542,7 +5591,8 @@ bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
 
     D3D12_RESOURCE_DESC StatsUploadDesc = StatsDesc;
     StatsUploadDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Upload,
         &UploadHeap,
         D3D12_HEAP_FLAG_NONE,
         &StatsUploadDesc,
@@ -3556,7 +5606,7 @@ bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
         HR_CHECK(GpuDebugPrintStatsUpload->Map(0, &EmptyRange, &StatsUploadData));
         if (StatsUploadData)
         {
-            std::memset(StatsUploadData, 0, sizeof(uint32_t) * 2);
+            std::memset(StatsUploadData, 0, GpuDebugPrintStatsSize);
         }
         GpuDebugPrintStatsUpload->Unmap(0, nullptr);
     }
@@ -3626,7 +5676,7 @@ bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     }
     if (GpuDebugPrintStatsBuffer && GpuDebugPrintStatsUpload)
     {
-        UploadList->CopyBufferRegion(GpuDebugPrintStatsBuffer.Get(), 0, GpuDebugPrintStatsUpload.Get(), 0, sizeof(uint32_t) * 2);
+        UploadList->CopyBufferRegion(GpuDebugPrintStatsBuffer.Get(), 0, GpuDebugPrintStatsUpload.Get(), 0, GpuDebugPrintStatsSize);
     }
 
     std::vector<D3D12_RESOURCE_BARRIER> PostCopyBarriers;
@@ -3674,15 +5724,15 @@ bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     Device->GetGraphicsQueue()->Flush();
 
     IndirectCommandStates.assign(GetFramesInFlight(), D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+    ModelBoundsState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
     GpuDebugPrintState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
     GpuDebugPrintStatsState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
 
-    D3D12_ROOT_PARAMETER RootParams[6] = {};
-    // RootParams[0]: cbuffer CullingConstants (frustum planes, view-projection, HZB settings, debug toggle)
-    RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
-    RootParams[0].Constants.ShaderRegister = 0;
-    RootParams[0].Constants.RegisterSpace = 0;
-    RootParams[0].Constants.Num32BitValues = 46;
+    D3D12_ROOT_PARAMETER RootParams[10] = {};
+    // RootParams[0]: cbuffer CullingConstants (frustum planes, view-projection, HZB settings, debug toggle, LOD selection, culling phase, compaction, screen coverage)
+    RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    RootParams[0].Descriptor.ShaderRegister = 0;
+    RootParams[0].Descriptor.RegisterSpace = 0;
     RootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
 
     // RootParams[1]: SRV ModelBounds buffer (t0)
@@ -3722,6 +5772,30 @@ bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     RootParams[5].DescriptorTable.pDescriptorRanges = &HZBRange;
     RootParams[5].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
 
+    // RootParams[6]: UAV VisibleInstances buffer (u3)
+    RootParams[6].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    RootParams[6].Descriptor.ShaderRegister = 3;
+    RootParams[6].Descriptor.RegisterSpace = 0;
+    RootParams[6].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    // RootParams[7]: UAV InstanceVisibility buffer (u4)
+    RootParams[7].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    RootParams[7].Descriptor.ShaderRegister = 4;
+    RootParams[7].Descriptor.RegisterSpace = 0;
+    RootParams[7].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    // RootParams[8]: SRV CommandRanges buffer (t2)
+    RootParams[8].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    RootParams[8].Descriptor.ShaderRegister = 2;
+    RootParams[8].Descriptor.RegisterSpace = 0;
+    RootParams[8].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    // RootParams[9]: UAV CompactedArgs buffer (u5)
+    RootParams[9].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    RootParams[9].Descriptor.ShaderRegister = 5;
+    RootParams[9].Descriptor.RegisterSpace = 0;
+    RootParams[9].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
     D3D12_ROOT_SIGNATURE_DESC RootDesc = {};
     RootDesc.NumParameters = _countof(RootParams);
     RootDesc.pParameters = RootParams;
@@ -3730,7 +5804,7 @@ bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     ComPtr<ID3DBlob> SerializedSig;
     ComPtr<ID3DBlob> ErrorBlob;
     HR_CHECK(D3D12SerializeRootSignature(&RootDesc, D3D_ROOT_SIGNATURE_VERSION_1, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf()));
-    HR_CHECK(Device->GetDevice()->CreateRootSignature(0, SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), IID_PPV_ARGS(CullingRootSignature.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), CullingRootSignature.ReleaseAndGetAddressOf()));
 
     FShaderCompiler Compiler;
     std::vector<uint8_t> CsByteCode;
@@ -3743,15 +5817,34 @@ bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     D3D12_COMPUTE_PIPELINE_STATE_DESC CsDesc = {};
     CsDesc.pRootSignature = CullingRootSignature.Get();
     CsDesc.CS = { CsByteCode.data(), CsByteCode.size() };
-    HR_CHECK(Device->GetDevice()->CreateComputePipelineState(&CsDesc, IID_PPV_ARGS(CullingPipeline.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateComputePipelineState(CsDesc, CullingPipeline.ReleaseAndGetAddressOf()));
+
+    std::vector<uint8_t> ResetByteCode;
+    if (!Compiler.CompileFromFile(L"Shaders/CullIndirectArgs.hlsl", L"CSResetInstanceCounts", L"cs_6_0", ResetByteCode))
+    {
+        LogError("Failed to compile culling reset compute shader");
+        return false;
+    }
+
+    CsDesc.CS = { ResetByteCode.data(), ResetByteCode.size() };
+    HR_CHECK(Device->GetPipelineCache()->CreateComputePipelineState(CsDesc, CullingResetPipeline.ReleaseAndGetAddressOf()));
+
+    std::vector<uint8_t> CompactByteCode;
+    if (!Compiler.CompileFromFile(L"Shaders/CullIndirectArgs.hlsl", L"CSCompactCommands", L"cs_6_0", CompactByteCode))
+    {
+        LogError("Failed to compile culling compaction compute shader");
+        return false;
+    }
+
+    CsDesc.CS = { CompactByteCode.data(), CompactByteCode.size() };
+    HR_CHECK(Device->GetPipelineCache()->CreateComputePipelineState(CsDesc, CullingCompactPipeline.ReleaseAndGetAddressOf()));
 
-    D3D12_INDIRECT_ARGUMENT_DESC IndirectArgs[4] = {};
-    IndirectArgs[0].Type = D3D12_INDIRECT_ARGUMENT_TYPE_VERTEX_BUFFER_VIEW;
-    IndirectArgs[0].VertexBuffer.Slot = 0;
-    IndirectArgs[1].Type = D3D12_INDIRECT_ARGUMENT_TYPE_INDEX_BUFFER_VIEW;
-    IndirectArgs[2].Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT_BUFFER_VIEW;
-    IndirectArgs[2].ConstantBufferView.RootParameterIndex = 0;
-    IndirectArgs[3].Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
+    D3D12_INDIRECT_ARGUMENT_DESC IndirectArgs[2] = {};
+    IndirectArgs[0].Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT;
+    IndirectArgs[0].Constant.RootParameterIndex = SceneInstanceRootParameter;
+    IndirectArgs[0].Constant.DestOffsetIn32BitValues = 0;
+    IndirectArgs[0].Constant.Num32BitValuesToSet = 1;
+    IndirectArgs[1].Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
 
     D3D12_COMMAND_SIGNATURE_DESC CommandDesc = {};
     CommandDesc.pArgumentDescs = IndirectArgs;
@@ -3762,44 +5855,6 @@ bool FDeferredRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     return true;
 }
 
-void FDeferredRenderer::UpdateSceneConstants(const FCamera& Camera, const FSceneModelResource& Model, uint64_t ConstantBufferOffset)
-{
-    const DirectX::XMVECTOR LightDir = DirectX::XMLoadFloat3(&LightDirection);
-    const DirectX::XMMATRIX LightVP = RendererUtils::BuildDirectionalLightViewProjection(SceneCenter, SceneRadius, LightDirection);
-    DirectX::XMStoreFloat4x4(&LightViewProjection, LightVP);
-    const DirectX::XMMATRIX Projection = bUseTaaJitter ? TaaProjection : Camera.GetProjectionMatrix();
-
-    RendererUtils::UpdateSceneConstants(
-        Camera,
-        Model,
-        LightIntensity,
-        LightDir,
-        LightColor,
-        LightVP,
-        Projection,
-        bShadowsEnabled ? ShadowStrength : 0.0f,
-        ShadowBias,
-        static_cast<float>(ShadowMapWidth),
-        static_cast<float>(ShadowMapHeight),
-        EnvironmentMipCount,
-        GetSceneConstantBufferMapped(),
-        ConstantBufferOffset);
-}
-
-void FDeferredRenderer::UpdateSkyConstants(const FCamera& Camera)
-{
-    using namespace DirectX;
-
-    const FFloat3 CameraPosition = Camera.GetPosition();
-    const XMMATRIX Scale = XMMatrixScaling(SkySphereRadius, SkySphereRadius, SkySphereRadius);
-    const XMMATRIX Translation = XMMatrixTranslation(CameraPosition.x, CameraPosition.y, CameraPosition.z);
-    const XMMATRIX World = Scale * Translation;
-
-    const XMVECTOR LightDir = XMLoadFloat3(&LightDirection);
-    const DirectX::XMMATRIX Projection = bUseTaaJitter ? TaaProjection : Camera.GetProjectionMatrix();
-    RendererUtils::UpdateSkyConstants(Camera, World, Projection, LightDir, LightColor, SkyConstantBufferMapped);
-}
-
 void FDeferredRenderer::UpdateCullingVisibility(const FCamera& Camera)
 {
     const FCamera* CullingCamera = GetCullingCameraOverride();
@@ -3808,5 +5863,5 @@ void FDeferredRenderer::UpdateCullingVisibility(const FCamera& Camera)
         CullingCamera = &Camera;
     }
 
-    RendererUtils::UpdateCullingVisibility(*CullingCamera, SceneModels, SceneModelVisibility);
+    RendererUtils::UpdateCullingVisibility(*CullingCamera, SceneModels, SceneBvh, SceneBoundsSoA, CullingScratchIndices, SceneModelVisibility);
 }
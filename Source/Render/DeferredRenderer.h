@@ -2,6 +2,7 @@
 
 #include <array>
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <wrl.h>
@@ -9,6 +10,7 @@
 #include <DirectXMath.h>
 #include <cstdint>
 #include <string>
+#include "ClusteredLights.h"
 #include "Renderer.h"
 #include "RendererUtils.h"
 #include "TextureLoader.h"
@@ -25,6 +27,18 @@ struct FModelTextureSet
     Microsoft::WRL::ComPtr<ID3D12Resource> Emissive;
 };
 
+// Screen tile classes of the tiled lighting path, TILE_CLASS_* in Shaders/TiledDeferredLighting.hlsl.
+// Tiles with only sky pixels belong to none.
+enum class ETiledLightingClass : uint32_t
+{
+    // Some pixel needs a shadow map lookup.
+    Shadowed,
+    Unshadowed,
+    // Unshadowed, and every pixel is a rough dielectric.
+    Simple,
+    Count
+};
+
 class FDeferredRenderer : public FRenderer
 {
 public:
@@ -53,6 +67,10 @@ public:
     void SetCasSharpness(float Sharpness) { CasSharpness = Sharpness; }
     float GetCasSharpness() const { return CasSharpness; }
 
+    // Takes effect when TAA and CAS both run and the back buffer allows unordered access.
+    void SetFusedPostEnabled(bool bEnabled) { bFusedPostEnabled = bEnabled; }
+    bool IsFusedPostEnabled() const { return bFusedPostEnabled; }
+
     void SetAutoExposureEnabled(bool bEnabled) { bAutoExposureEnabled = bEnabled; }
     bool IsAutoExposureEnabled() const { return bAutoExposureEnabled; }
 
@@ -88,6 +106,10 @@ public:
     void SetHZBEnabled(bool bEnabled) { bHZBEnabled = bEnabled; }
     bool IsHZBEnabled() const { return bHZBEnabled; }
 
+    // Takes effect only when the tiled lighting pipelines were created.
+    void SetTiledLightingEnabled(bool bEnabled) { bTiledLightingEnabled = bEnabled; }
+    bool IsTiledLightingEnabled() const { return bTiledLightingEnabled; }
+
     void OnFrameFenceSignaled(uint32_t FrameIndex, uint64_t FenceValue) override;
 
 private:
@@ -95,9 +117,29 @@ private:
     bool CreateLightingRootSignature(FDX12Device* Device);
     bool CreateBasePassPipeline(FDX12Device* Device, DXGI_FORMAT LightingFormat);
     bool CreateDepthPrepassPipeline(FDX12Device* Device);
+    bool CreateMeshletRootSignature(FDX12Device* Device);
+    void UpdateMeshletCullingConstants(const FCamera& Camera, bool bUseHZBOcclusion);
+    // Binds the meshlet root signature and per-pass state; DrawModelMeshlets then records one model.
+    void BindMeshletPass(ID3D12GraphicsCommandList* CommandList, bool bUseHZBOcclusion) const;
+    void DrawModelMeshlets(ID3D12GraphicsCommandList6* CommandList, const FSceneModelResource& Model, size_t ModelIndex) const;
+    // Alpha-tested prepass pipeline of a resolved material pipeline key.
+    ID3D12PipelineState* SelectMaskedDepthPrepassPipeline(uint32_t PipelineKey) const;
+    // Records the masked indirect ranges of a depth prepass that has drawn the opaque ones; binds
+    // the full vertex layout and leaves the last masked pipeline set.
+    void DrawMaskedDepthPrepassRanges(ID3D12GraphicsCommandList* CommandList, bool bSecondPhase) const;
     bool CreateLightingPipeline(FDX12Device* Device, DXGI_FORMAT BackBufferFormat);
+    // Root signature, pipelines and dispatch signature of Shaders/TiledDeferredLighting.hlsl. Failure
+    // leaves the pipelines null, and lighting then uses the fullscreen pass.
+    bool CreateTiledLightingPipelines(FDX12Device* Device);
+    bool CreateTiledLightingResources(FDX12Device* Device, uint32_t Width, uint32_t Height);
+    bool IsTiledLightingAvailable() const;
+    // Root signature and the bindings both tile passes share; the lighting pass adds the light SRVs.
+    void BindTiledLightingRoot(ID3D12GraphicsCommandList* CommandList, D3D12_GPU_DESCRIPTOR_HANDLE DepthTable) const;
     bool CreateHZBRootSignature(FDX12Device* Device);
     bool CreateHZBPipeline(FDX12Device* Device);
+    // Root signature and pipeline of Shaders/BuildHZBSinglePass.hlsl. Failure leaves them null, and
+    // the HZB is then built by the BuildHZB.hlsl dispatches.
+    bool CreateHZBSinglePassPipeline(FDX12Device* Device);
     bool CreateAutoExposureRootSignature(FDX12Device* Device);
     bool CreateAutoExposurePipeline(FDX12Device* Device);
     bool CreateTaaRootSignature(FDX12Device* Device);
@@ -106,6 +148,9 @@ private:
     bool CreateTonemapPipeline(FDX12Device* Device, DXGI_FORMAT BackBufferFormat);
     bool CreateCasRootSignature(FDX12Device* Device);
     bool CreateCasPipeline(FDX12Device* Device, DXGI_FORMAT BackBufferFormat);
+    // Root signature and pipeline of Shaders/FusedPost.hlsl. Failure leaves them null, and the
+    // separate tonemap and CAS passes run instead.
+    bool CreateFusedPostPipeline(FDX12Device* Device);
     bool CreateGBufferResources(FDX12Device* Device, uint32_t Width, uint32_t Height);
     bool CreateHZBResources(FDX12Device* Device, uint32_t Width, uint32_t Height);
     bool CreateLuminanceResources(FDX12Device* Device);
@@ -114,9 +159,10 @@ private:
     bool CreateObjectIdPipeline(FDX12Device* Device);
     bool CreateDescriptorHeap(FDX12Device* Device);
     bool CreateSceneTextures(FDX12Device* Device, const std::vector<FSceneModelResource>& Models);
+    // Writes the four SRVs of a model's material table, using NullTexture for missing maps.
+    void WriteMaterialTable(const FModelTextureSet& TextureSet, D3D12_CPU_DESCRIPTOR_HANDLE CpuHandle) const;
+    void OnSceneTexturesResident(FStreamedModelTextures& Textures) override;
     bool CreateGpuDrivenResources(FDX12Device* Device);
-    void UpdateSceneConstants(const FCamera& Camera, const FSceneModelResource& Model, uint64_t ConstantBufferOffset);
-    void UpdateSkyConstants(const FCamera& Camera);
     void UpdateCullingVisibility(const FCamera& Camera);
 
 private:
@@ -125,21 +171,44 @@ private:
     Microsoft::WRL::ComPtr<ID3D12RootSignature> HZBRootSignature;
     // Base pass pipelines indexed by permutation key (bit 0: Normal, bit 1: MR, bit 2: BaseColor, bit 3: Emissive, bit 4: AlphaMask)
     std::array<Microsoft::WRL::ComPtr<ID3D12PipelineState>, 32> BasePassPipelines;
+    // Same keys, testing depth EQUAL with writes off behind a prepass that drew masked models too;
+    // the alpha-mask keys use the unclipped pixel shader, so early depth rejection stays on.
+    std::array<Microsoft::WRL::ComPtr<ID3D12PipelineState>, 32> BasePassEqualPipelines;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> DepthPrepassPipeline;
+    // Alpha-tested prepass of masked models, indexed by the BaseColor bit of the resolved pipeline key.
+    std::array<Microsoft::WRL::ComPtr<ID3D12PipelineState>, 2> MaskedDepthPrepassPipelines;
+    // Mesh shader path: see Shaders/MeshletBasePass.hlsl. Created only when the device supports mesh
+    // shaders and the scene has meshlets; the pipelines use the same permutation keys as BasePassPipelines.
+    Microsoft::WRL::ComPtr<ID3D12RootSignature> MeshletRootSignature;
+    std::array<Microsoft::WRL::ComPtr<ID3D12PipelineState>, 32> MeshletBasePassPipelines;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> MeshletDepthPrepassPipeline;
+    // Frustum planes, view-projection, camera position and HZB parameters of MeshletCullingConstants.
+    std::array<uint32_t, 47> MeshletCullingConstants{};
+    // Pipeline jobs clear it from workers when a meshlet twin fails to build.
+    std::atomic<bool> bMeshShadersEnabled{ false };
     Microsoft::WRL::ComPtr<ID3D12PipelineState> ShadowPipeline;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> LightingPipeline;
+    Microsoft::WRL::ComPtr<ID3D12RootSignature> TiledLightingRootSignature;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> TileResetPipeline;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> TileClassifyPipeline;
+    std::array<Microsoft::WRL::ComPtr<ID3D12PipelineState>, static_cast<size_t>(ETiledLightingClass::Count)> TiledLightingPipelines;
+    Microsoft::WRL::ComPtr<ID3D12CommandSignature> TileDispatchSignature;
     std::array<Microsoft::WRL::ComPtr<ID3D12PipelineState>, 4> HZBPipelines;
+    // Mip UAVs the single-pass table holds, HZB_SPD_MAX_MIPS in the shader.
+    static constexpr uint32_t HZBSinglePassMaxMips = 16;
+    Microsoft::WRL::ComPtr<ID3D12RootSignature> HZBSinglePassRootSignature;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> HZBSinglePassPipeline;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> AutoExposurePipeline;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> TaaPipeline;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> TonemapPipeline;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> CasPipeline;
-    Microsoft::WRL::ComPtr<ID3D12PipelineState> SkyPipelineState;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> FusedPostPipeline;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> ObjectIdPipeline;
-    Microsoft::WRL::ComPtr<ID3D12RootSignature> SkyRootSignature;
     Microsoft::WRL::ComPtr<ID3D12RootSignature> AutoExposureRootSignature;
     Microsoft::WRL::ComPtr<ID3D12RootSignature> TaaRootSignature;
     Microsoft::WRL::ComPtr<ID3D12RootSignature> TonemapRootSignature;
     Microsoft::WRL::ComPtr<ID3D12RootSignature> CasRootSignature;
+    Microsoft::WRL::ComPtr<ID3D12RootSignature> FusedPostRootSignature;
     std::vector<FModelTextureSet> SceneTextures;
     Microsoft::WRL::ComPtr<ID3D12Resource> SceneTexture;
     Microsoft::WRL::ComPtr<ID3D12Resource> LightingBuffer;
@@ -148,30 +217,44 @@ private:
     std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> TaaHistoryTextures;
     Microsoft::WRL::ComPtr<ID3D12Resource> HierarchicalZBuffer;
     Microsoft::WRL::ComPtr<ID3D12Resource> HZBNullUavResource;
+    // Finished-group counter of the single-pass build; each dispatch leaves it at zero.
+    Microsoft::WRL::ComPtr<ID3D12Resource> HZBGroupCounter;
+    // One D3D12_DISPATCH_ARGUMENTS per tile class, then TileListCapacity tiles per class.
+    Microsoft::WRL::ComPtr<ID3D12Resource> TileDispatchArgsBuffer;
+    Microsoft::WRL::ComPtr<ID3D12Resource> TileListBuffer;
+    // Point and spot lights of the scene, binned into clusters before the lighting pass.
+    FClusteredLights ClusteredLights;
+    // The device's shared heap; SceneDescriptors is this renderer's persistent range in it.
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> DescriptorHeap;
+    FDX12DescriptorRange SceneDescriptors;
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> GBufferRTVHeap;
     Microsoft::WRL::ComPtr<ID3D12Resource> GBufferA;
     Microsoft::WRL::ComPtr<ID3D12Resource> GBufferB;
     Microsoft::WRL::ComPtr<ID3D12Resource> GBufferC;
-    float SkySphereRadius = 100.0f;
+    // Screen UV motion of each pixel since the previous frame, written next to the G-buffer.
+    Microsoft::WRL::ComPtr<ID3D12Resource> VelocityTexture;
 
     DXGI_FORMAT BackBufferFormat = DXGI_FORMAT_UNKNOWN;
 
     D3D12_CPU_DESCRIPTOR_HANDLE GBufferRTVHandles[3]{};
     D3D12_CPU_DESCRIPTOR_HANDLE LightingRTVHandle{};
     D3D12_CPU_DESCRIPTOR_HANDLE TonemapOutputRtvHandle{};
+    D3D12_CPU_DESCRIPTOR_HANDLE VelocityRTVHandle{};
     D3D12_GPU_DESCRIPTOR_HANDLE GBufferGpuHandles[3]{};
     D3D12_GPU_DESCRIPTOR_HANDLE LightingBufferHandle{};
+    D3D12_GPU_DESCRIPTOR_HANDLE LightingBufferUavHandle{};
     D3D12_GPU_DESCRIPTOR_HANDLE TonemapOutputHandle{};
     std::array<D3D12_GPU_DESCRIPTOR_HANDLE, 2> LuminanceSrvHandles{};
     std::array<D3D12_GPU_DESCRIPTOR_HANDLE, 2> LuminanceUavHandles{};
     std::vector<D3D12_GPU_DESCRIPTOR_HANDLE> TaaSrvHandles;
     std::vector<D3D12_GPU_DESCRIPTOR_HANDLE> TaaUavHandles;
-    std::vector<D3D12_GPU_DESCRIPTOR_HANDLE> DepthBufferHandles;
+    // Staging descriptors, copied into a transient table per HZB dispatch.
+    std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> DepthBufferHandles;
+    D3D12_CPU_DESCRIPTOR_HANDLE VelocitySrvHandle{};
     D3D12_GPU_DESCRIPTOR_HANDLE HZBSrvHandle{};
-    std::vector<D3D12_GPU_DESCRIPTOR_HANDLE> HZBSrvMipHandles;
-    std::vector<D3D12_GPU_DESCRIPTOR_HANDLE> HZBUavHandles;
-    D3D12_GPU_DESCRIPTOR_HANDLE HZBNullUavHandle{};
+    std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> HZBSrvMipHandles;
+    std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> HZBUavHandles;
+    D3D12_CPU_DESCRIPTOR_HANDLE HZBNullUavHandle{};
     D3D12_GPU_DESCRIPTOR_HANDLE ShadowMapHandle{};
     D3D12_GPU_DESCRIPTOR_HANDLE EnvironmentCubeHandle{};
     D3D12_GPU_DESCRIPTOR_HANDLE BrdfLutHandle{};
@@ -183,19 +266,21 @@ private:
     };
     D3D12_RESOURCE_STATES HZBState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
     D3D12_RESOURCE_STATES LightingBufferState = D3D12_RESOURCE_STATE_RENDER_TARGET;
+    D3D12_RESOURCE_STATES VelocityState = D3D12_RESOURCE_STATE_RENDER_TARGET;
+    D3D12_RESOURCE_STATES TileDispatchArgsState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    D3D12_RESOURCE_STATES TileListState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
     D3D12_RESOURCE_STATES TonemapOutputState = D3D12_RESOURCE_STATE_RENDER_TARGET;
     std::array<D3D12_RESOURCE_STATES, 2> LuminanceStates = { D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_UNORDERED_ACCESS };
     std::vector<D3D12_RESOURCE_STATES> TaaStates;
-    FMeshGeometryBuffers SkyGeometry;
 
     DirectX::XMFLOAT4X4 SceneWorldMatrix{};
-    DirectX::XMFLOAT4X4 LightViewProjection{};
     bool bTonemapEnabled = true;
     float TonemapExposure = 0.9f;
     float TonemapWhitePoint = 6.0f;
     float TonemapGamma = 2.2f;
     bool bCasEnabled = true;
     float CasSharpness = 0.2f;
+    bool bFusedPostEnabled = true;
     bool bAutoExposureEnabled = false;
     float AutoExposureKey = 0.18f;
     float AutoExposureMin = 0.1f;
@@ -214,8 +299,15 @@ private:
     bool bLuminanceHistoryValid = false;
     bool bHZBEnabled = true;
     bool bHZBReady = false;
+    bool bTiledLightingEnabled = true;
+    uint32_t TileCountX = 0;
+    uint32_t TileCountY = 0;
 
     uint32_t HZBWidth = 0;
     uint32_t HZBHeight = 0;
     uint32_t HZBMipCount = 0;
+    // Mip 0 texels the last HZB build filled, half the size the scene rendered at; less than
+    // HZBWidth x HZBHeight while the resolution is scaled.
+    uint32_t HZBContentWidth = 0;
+    uint32_t HZBContentHeight = 0;
 };
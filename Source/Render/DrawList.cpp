@@ -0,0 +1,83 @@
+#include "DrawList.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace
+{
+    constexpr uint32_t RadixBits = 8;
+    constexpr uint32_t RadixSize = 1u << RadixBits;
+    constexpr uint32_t RadixPassCount = 64 / RadixBits;
+    // Below this many entries the histogram passes cost more than a comparison sort.
+    constexpr size_t MinRadixSortCount = 64;
+}
+
+uint64_t FDrawList::BuildSortKey(uint32_t PipelineKey, uint32_t MaterialSlot, uint32_t GeometrySlot, uint32_t Low)
+{
+    const uint64_t Pipeline = PipelineKey & ((1u << PipelineBits) - 1u);
+    const uint64_t Material = MaterialSlot & ((1u << MaterialBits) - 1u);
+    const uint64_t Geometry = GeometrySlot & ((1u << GeometryBits) - 1u);
+    return (Pipeline << (64 - PipelineBits))
+        | (Material << (64 - PipelineBits - MaterialBits))
+        | (Geometry << 32)
+        | Low;
+}
+
+uint32_t FDrawList::EncodeDepth(float ViewDepth)
+{
+    // Non-negative IEEE floats compare like their bit patterns.
+    const float Depth = ViewDepth > 0.0f ? ViewDepth : 0.0f;
+    uint32_t Bits = 0;
+    std::memcpy(&Bits, &Depth, sizeof(Bits));
+    return Bits;
+}
+
+void FDrawList::Sort()
+{
+    if (Entries.size() < MinRadixSortCount)
+    {
+        std::stable_sort(Entries.begin(), Entries.end(), [](const FDrawListEntry& A, const FDrawListEntry& B)
+        {
+            return A.SortKey < B.SortKey;
+        });
+        return;
+    }
+
+    // All histograms come from one read of the keys; a pass whose digit is the same everywhere
+    // would copy the entries unchanged, which is common for the pipeline and geometry bytes.
+    std::array<std::array<uint32_t, RadixSize>, RadixPassCount> Histograms{};
+    for (const FDrawListEntry& Entry : Entries)
+    {
+        for (uint32_t Pass = 0; Pass < RadixPassCount; ++Pass)
+        {
+            ++Histograms[Pass][(Entry.SortKey >> (Pass * RadixBits)) & (RadixSize - 1u)];
+        }
+    }
+
+    Scratch.resize(Entries.size());
+    const uint32_t EntryCount = static_cast<uint32_t>(Entries.size());
+    for (uint32_t Pass = 0; Pass < RadixPassCount; ++Pass)
+    {
+        std::array<uint32_t, RadixSize>& Histogram = Histograms[Pass];
+        const uint32_t Digit = static_cast<uint32_t>((Entries.front().SortKey >> (Pass * RadixBits)) & (RadixSize - 1u));
+        if (Histogram[Digit] == EntryCount)
+        {
+            continue;
+        }
+
+        uint32_t Offset = 0;
+        for (uint32_t& Count : Histogram)
+        {
+            const uint32_t BucketCount = Count;
+            Count = Offset;
+            Offset += BucketCount;
+        }
+
+        for (const FDrawListEntry& Entry : Entries)
+        {
+            Scratch[Histogram[(Entry.SortKey >> (Pass * RadixBits)) & (RadixSize - 1u)]++] = Entry;
+        }
+        Entries.swap(Scratch);
+    }
+}
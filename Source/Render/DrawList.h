@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct FDrawListEntry
+{
+    uint64_t SortKey = 0;
+    uint32_t ModelIndex = 0;
+};
+
+/**
+ * Draws ordered by a 64-bit key so that consecutive draws share as much state as possible. From
+ * the most significant bits down the key holds the pipeline, the material table, the geometry
+ * buffers and a free 32-bit field, which raster passes fill with view depth to draw front to back.
+ * Sort is a stable LSD radix sort, so draws with equal keys keep the order they were added in.
+ */
+class FDrawList
+{
+public:
+    static constexpr uint32_t PipelineBits = 5;
+    static constexpr uint32_t MaterialBits = 20;
+    static constexpr uint32_t GeometryBits = 7;
+
+    // Fields wider than their bits are truncated, which costs only sort quality, never correctness.
+    static uint64_t BuildSortKey(uint32_t PipelineKey, uint32_t MaterialSlot, uint32_t GeometrySlot, uint32_t Low);
+    // Bits of a view depth that order like the depth itself; depths behind the eye clamp to zero.
+    static uint32_t EncodeDepth(float ViewDepth);
+
+    void Reset() { Entries.clear(); }
+    void Reserve(size_t Count) { Entries.reserve(Count); }
+    void Add(uint64_t SortKey, uint32_t ModelIndex) { Entries.push_back({ SortKey, ModelIndex }); }
+    // Sorts by ascending key, skipping the byte passes in which every key has the same digit.
+    void Sort();
+
+    const std::vector<FDrawListEntry>& GetEntries() const { return Entries; }
+    size_t Size() const { return Entries.size(); }
+    bool IsEmpty() const { return Entries.empty(); }
+
+private:
+    std::vector<FDrawListEntry> Entries;
+    std::vector<FDrawListEntry> Scratch;
+};
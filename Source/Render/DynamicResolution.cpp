@@ -0,0 +1,71 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Frames aim this far under the budget, which leaves room for a slower frame before it is missed.
+    constexpr double BudgetFraction = 0.9;
+    // Weight of the newest frame in the average.
+    constexpr double AverageWeight = 0.1;
+}
+
+void FDynamicResolution::SetEnabled(bool bInEnabled)
+{
+    if (bEnabled == bInEnabled)
+    {
+        return;
+    }
+
+    bEnabled = bInEnabled;
+    Scale = 1.0f;
+    bHasAverage = false;
+    FramesSinceChange = 0;
+}
+
+void FDynamicResolution::SetTargetFrameTime(float Milliseconds)
+{
+    TargetFrameMs = (std::max)(Milliseconds, 1.0f);
+}
+
+void FDynamicResolution::SetMinScale(float InMinScale)
+{
+    MinScale = std::clamp(InMinScale, 0.25f, 1.0f);
+    Scale = std::clamp(Scale, MinScale, 1.0f);
+}
+
+void FDynamicResolution::AddFrameTime(double Milliseconds)
+{
+    if (!bEnabled || Milliseconds <= 0.0)
+    {
+        return;
+    }
+
+    AverageFrameMs = bHasAverage ? AverageFrameMs + (Milliseconds - AverageFrameMs) * AverageWeight : Milliseconds;
+    bHasAverage = true;
+
+    if (++FramesSinceChange < SettleFrames)
+    {
+        return;
+    }
+
+    const double Budget = static_cast<double>(TargetFrameMs) * BudgetFraction;
+    const float Desired = Scale * static_cast<float>(std::sqrt(Budget / AverageFrameMs));
+    const float Limited = std::clamp(Desired, Scale - MaxScaleChange, Scale + MaxScaleChange);
+    const float NewScale = std::clamp(std::round(Limited / ScaleStep) * ScaleStep, MinScale, 1.0f);
+    if (NewScale == Scale)
+    {
+        return;
+    }
+
+    // Frames still in flight ran at the old scale; expect the new one's cost until they arrive.
+    const double Ratio = static_cast<double>(NewScale) / static_cast<double>(Scale);
+    AverageFrameMs *= Ratio * Ratio;
+    Scale = NewScale;
+    FramesSinceChange = 0;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Picks the fraction of the output resolution the scene renders at from measured GPU frame
+ * times, so frames stay within a budget. Pixel cost grows with the square of the scale, so a
+ * frame over budget by a ratio shrinks the scale by its square root; the scale only moves once
+ * the smoothed time leaves a band around the budget, and then waits SettleFrames for the timings
+ * of the new resolution to arrive, since they come back several frames late.
+ */
+class FDynamicResolution
+{
+public:
+    // Scales snap to this step, which keeps small timing noise from resizing every frame.
+    static constexpr float ScaleStep = 1.0f / 32.0f;
+    // Largest change of one update; bigger ones are spread over several.
+    static constexpr float MaxScaleChange = 0.125f;
+    static constexpr uint32_t SettleFrames = 8;
+
+    void SetEnabled(bool bInEnabled);
+    bool IsEnabled() const { return bEnabled; }
+    void SetTargetFrameTime(float Milliseconds);
+    float GetTargetFrameTime() const { return TargetFrameMs; }
+    void SetMinScale(float InMinScale);
+    float GetMinScale() const { return MinScale; }
+
+    // Feeds the GPU time of one finished frame.
+    void AddFrameTime(double Milliseconds);
+
+    // 1 while disabled.
+    float GetScale() const { return bEnabled ? Scale : 1.0f; }
+    float GetAverageFrameTime() const { return static_cast<float>(AverageFrameMs); }
+
+private:
+    double AverageFrameMs = 0.0;
+    float TargetFrameMs = 16.6f;
+    float MinScale = 0.5f;
+    float Scale = 1.0f;
+    uint32_t FramesSinceChange = 0;
+    bool bEnabled = false;
+    bool bHasAverage = false;
+};
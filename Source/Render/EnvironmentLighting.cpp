@@ -0,0 +1,584 @@
+#include "EnvironmentLighting.h"
+
+#include "RendererUtils.h"
+#include "ShaderCompiler.h"
+#include "TextureLoader.h"
+#include "../RHI/DX12Commons.h"
+#include "../RHI/DX12CommandQueue.h"
+#include "../RHI/DX12DescriptorAllocator.h"
+#include "../RHI/DX12Device.h"
+#include "../RHI/DX12UploadQueue.h"
+#include "../Core/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#include "../../ThirdParty/ddspp/ddspp.h"
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+    const std::filesystem::path TextureCacheDirectory = L"TextureCache";
+
+    // "ENSH", then the version and coefficient count ahead of the coefficients.
+    constexpr uint32_t CoefficientFileMagic = 0x48534E45;
+    constexpr uint32_t ConstantCount = 8;
+
+    // cbuffer EnvironmentLightingConstants in Shaders/EnvironmentLighting.hlsl.
+    struct FEnvironmentLightingConstants
+    {
+        uint32_t FaceSize = 0;
+        float SourceMip = 0.0f;
+        float Roughness = 0.0f;
+        uint32_t SampleCount = 0;
+        float SourceFaceSize = 0.0f;
+        float SourceMipCount = 0.0f;
+        float Padding[2] = {};
+    };
+
+    static_assert(sizeof(FEnvironmentLightingConstants) == ConstantCount * sizeof(uint32_t), "Constants must match Shaders/EnvironmentLighting.hlsl.");
+
+    // FNV-1a of the absolute source path, its size and write time and the cook version.
+    std::wstring HashCookKey(const std::wstring& Key, uint64_t FileSize, int64_t WriteTime)
+    {
+        uint64_t Hash = 14695981039346656037ULL;
+        const auto AddBytes = [&Hash](const void* Data, size_t Size)
+        {
+            const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+            for (size_t Index = 0; Index < Size; ++Index)
+            {
+                Hash ^= Bytes[Index];
+                Hash *= 1099511628211ULL;
+            }
+        };
+        AddBytes(Key.c_str(), Key.size() * sizeof(wchar_t));
+        AddBytes(&FileSize, sizeof(FileSize));
+        AddBytes(&WriteTime, sizeof(WriteTime));
+        const uint32_t Version = FEnvironmentLighting::CookVersion;
+        AddBytes(&Version, sizeof(Version));
+
+        static constexpr wchar_t HexDigits[] = L"0123456789ABCDEF";
+        std::wstring Name(16, L'0');
+        for (size_t Digit = 0; Digit < 16; ++Digit)
+        {
+            Name[15 - Digit] = HexDigits[(Hash >> (Digit * 4)) & 0xF];
+        }
+        return Name;
+    }
+
+    // Written to a temporary file first so a concurrent load never sees a partial file.
+    bool WriteCookedFile(const std::filesystem::path& Path, const std::vector<uint8_t>& FileData)
+    {
+        std::error_code Error;
+        std::filesystem::create_directories(Path.parent_path(), Error);
+
+        std::filesystem::path TempPath = Path;
+        TempPath += L".tmp";
+        {
+            std::ofstream File(TempPath, std::ios::binary | std::ios::trunc);
+            File.write(reinterpret_cast<const char*>(FileData.data()), static_cast<std::streamsize>(FileData.size()));
+            if (!File)
+            {
+                return false;
+            }
+        }
+
+        std::filesystem::rename(TempPath, Path, Error);
+        if (Error)
+        {
+            std::filesystem::remove(TempPath, Error);
+            return false;
+        }
+        return true;
+    }
+
+    // The read back cube as a DDS whose faces each hold their tightly packed mip chain.
+    bool WriteCookedCube(const std::filesystem::path& Path, const uint8_t* MappedData, const D3D12_RESOURCE_DESC& Desc, const std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>& Layouts, const std::vector<UINT>& NumRows)
+    {
+        ddspp::Header Header = {};
+        ddspp::HeaderDXT10 Dxt10Header = {};
+        ddspp::encode_header(static_cast<ddspp::DXGIFormat>(Desc.Format), static_cast<uint32_t>(Desc.Width), Desc.Height, 1, ddspp::Cubemap, Desc.MipLevels, 1, Header, Dxt10Header);
+
+        std::vector<uint8_t> FileData;
+        const auto Append = [&FileData](const void* Data, size_t Size)
+        {
+            const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+            FileData.insert(FileData.end(), Bytes, Bytes + Size);
+        };
+        Append(&ddspp::DDS_MAGIC, sizeof(ddspp::DDS_MAGIC));
+        Append(&Header, sizeof(Header));
+        Append(&Dxt10Header, sizeof(Dxt10Header));
+
+        // Subresources are face major, as DDS cubes are.
+        constexpr size_t TexelSize = 8;
+        for (size_t Subresource = 0; Subresource < Layouts.size(); ++Subresource)
+        {
+            const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Layout = Layouts[Subresource];
+            const size_t RowSize = static_cast<size_t>(Layout.Footprint.Width) * TexelSize;
+            for (UINT Row = 0; Row < NumRows[Subresource]; ++Row)
+            {
+                Append(MappedData + Layout.Offset + static_cast<size_t>(Row) * Layout.Footprint.RowPitch, RowSize);
+            }
+        }
+        return WriteCookedFile(Path, FileData);
+    }
+
+    bool WriteCookedCoefficients(const std::filesystem::path& Path, const FEnvironmentLighting::FCoefficients& Coefficients)
+    {
+        const uint32_t Header[3] = { CoefficientFileMagic, FEnvironmentLighting::CookVersion, FEnvironmentLighting::CoefficientCount };
+        std::vector<uint8_t> FileData(sizeof(Header) + sizeof(Coefficients));
+        std::memcpy(FileData.data(), Header, sizeof(Header));
+        std::memcpy(FileData.data() + sizeof(Header), Coefficients.data(), sizeof(Coefficients));
+        return WriteCookedFile(Path, FileData);
+    }
+
+    bool ReadCookedCoefficients(const std::filesystem::path& Path, FEnvironmentLighting::FCoefficients& OutCoefficients)
+    {
+        std::ifstream File(Path, std::ios::binary);
+        uint32_t Header[3] = {};
+        if (!File.read(reinterpret_cast<char*>(Header), sizeof(Header))
+            || Header[0] != CoefficientFileMagic
+            || Header[1] != FEnvironmentLighting::CookVersion
+            || Header[2] != FEnvironmentLighting::CoefficientCount)
+        {
+            return false;
+        }
+        return static_cast<bool>(File.read(reinterpret_cast<char*>(OutCoefficients.data()), sizeof(OutCoefficients)));
+    }
+
+    bool CreateBuffer(FDX12Device* Device, D3D12_HEAP_TYPE HeapType, uint64_t Size, D3D12_RESOURCE_FLAGS Flags, D3D12_RESOURCE_STATES InitialState, ComPtr<ID3D12Resource>& OutBuffer)
+    {
+        D3D12_HEAP_PROPERTIES HeapProps = {};
+        HeapProps.Type = HeapType;
+        HeapProps.CreationNodeMask = 1;
+        HeapProps.VisibleNodeMask = 1;
+
+        D3D12_RESOURCE_DESC BufferDesc = {};
+        BufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        BufferDesc.Width = Size;
+        BufferDesc.Height = 1;
+        BufferDesc.DepthOrArraySize = 1;
+        BufferDesc.MipLevels = 1;
+        BufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+        BufferDesc.SampleDesc.Count = 1;
+        BufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        BufferDesc.Flags = Flags;
+
+        return SUCCEEDED(Device->CreateCommittedResource(
+            HeapType == D3D12_HEAP_TYPE_READBACK ? EGpuMemoryCategory::Readback : EGpuMemoryCategory::Buffer,
+            &HeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &BufferDesc,
+            InitialState,
+            nullptr,
+            IID_PPV_ARGS(OutBuffer.ReleaseAndGetAddressOf())));
+    }
+}
+
+bool FEnvironmentLighting::Build(FDX12Device* Device, FTextureLoader& TextureLoader, const std::wstring& SourcePath, ID3D12Resource* SourceCube)
+{
+    PrefilteredCube.Reset();
+    IrradianceSH = {};
+
+    if (!Device || !SourceCube || SourceCube->GetDesc().DepthOrArraySize != 6)
+    {
+        LogWarning("Environment lighting needs a cube texture; image-based lighting is disabled");
+        return false;
+    }
+
+    const std::wstring CookedPath = GetCookedPath(SourcePath);
+    if (!CookedPath.empty() && LoadCooked(TextureLoader, CookedPath))
+    {
+        LogInfo("Environment lighting loaded from " + std::filesystem::path(CookedPath).string());
+        return true;
+    }
+
+    if (!CreatePipelines(Device) || !Generate(Device, SourceCube, CookedPath))
+    {
+        LogError("Failed to precompute environment lighting");
+        PrefilteredCube.Reset();
+        IrradianceSH = {};
+        return false;
+    }
+    return true;
+}
+
+std::wstring FEnvironmentLighting::GetCookedPath(const std::wstring& SourcePath) const
+{
+    std::error_code Error;
+    const uint64_t FileSize = static_cast<uint64_t>(std::filesystem::file_size(SourcePath, Error));
+    if (Error)
+    {
+        return {};
+    }
+    const int64_t WriteTime = static_cast<int64_t>(std::filesystem::last_write_time(SourcePath, Error).time_since_epoch().count());
+    if (Error)
+    {
+        return {};
+    }
+
+    const std::filesystem::path AbsolutePath = std::filesystem::absolute(SourcePath, Error);
+    const std::wstring Key = (Error ? std::filesystem::path(SourcePath) : AbsolutePath).lexically_normal().wstring();
+    return (TextureCacheDirectory / (HashCookKey(Key, FileSize, WriteTime) + L"_ibl")).wstring();
+}
+
+bool FEnvironmentLighting::LoadCooked(FTextureLoader& TextureLoader, const std::wstring& CookedPath)
+{
+    const std::wstring CubePath = CookedPath + L".dds";
+    std::error_code Error;
+    if (!std::filesystem::exists(CubePath, Error) || !ReadCookedCoefficients(CookedPath + L".sh", IrradianceSH))
+    {
+        return false;
+    }
+
+    if (!TextureLoader.LoadOrDefault(CubePath, PrefilteredCube) || !PrefilteredCube)
+    {
+        return false;
+    }
+
+    const D3D12_RESOURCE_DESC Desc = PrefilteredCube->GetDesc();
+    if (Desc.DepthOrArraySize != 6 || Desc.Format != PrefilteredFormat)
+    {
+        PrefilteredCube.Reset();
+        return false;
+    }
+    PrefilteredCube->SetName(L"EnvironmentPrefiltered");
+    return true;
+}
+
+bool FEnvironmentLighting::CreatePipelines(FDX12Device* Device)
+{
+    if (RootSignature && ProjectPipeline && PrefilterPipeline)
+    {
+        return true;
+    }
+
+    D3D12_DESCRIPTOR_RANGE1 SrvRange = {};
+    SrvRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    SrvRange.NumDescriptors = 1;
+    SrvRange.BaseShaderRegister = 0;
+    SrvRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE;
+    SrvRange.OffsetInDescriptorsFromTableStart = 0;
+
+    D3D12_DESCRIPTOR_RANGE1 UavRange = {};
+    UavRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+    UavRange.NumDescriptors = 1;
+    UavRange.BaseShaderRegister = 0;
+    UavRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_NONE;
+    UavRange.OffsetInDescriptorsFromTableStart = 0;
+
+    D3D12_ROOT_PARAMETER1 RootParams[3] = {};
+    // RootParams[0]: Face sizes, roughness and sample count (b0)
+    RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    RootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[0].Constants.Num32BitValues = ConstantCount;
+    RootParams[0].Constants.ShaderRegister = 0;
+
+    // RootParams[1]: Source cube (t0)
+    RootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    RootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[1].DescriptorTable.NumDescriptorRanges = 1;
+    RootParams[1].DescriptorTable.pDescriptorRanges = &SrvRange;
+
+    // RootParams[2]: Coefficient buffer or the prefiltered mip being written (u0)
+    RootParams[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    RootParams[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[2].DescriptorTable.NumDescriptorRanges = 1;
+    RootParams[2].DescriptorTable.pDescriptorRanges = &UavRange;
+
+    D3D12_STATIC_SAMPLER_DESC SamplerDesc = {};
+    SamplerDesc.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+    SamplerDesc.AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    SamplerDesc.AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    SamplerDesc.AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    SamplerDesc.MaxLOD = D3D12_FLOAT32_MAX;
+    SamplerDesc.ShaderRegister = 0;
+    SamplerDesc.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    D3D12_VERSIONED_ROOT_SIGNATURE_DESC RootSigDesc = {};
+    RootSigDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
+    RootSigDesc.Desc_1_1.NumParameters = _countof(RootParams);
+    RootSigDesc.Desc_1_1.pParameters = RootParams;
+    RootSigDesc.Desc_1_1.NumStaticSamplers = 1;
+    RootSigDesc.Desc_1_1.pStaticSamplers = &SamplerDesc;
+    RootSigDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
+
+    ComPtr<ID3DBlob> SerializedSig;
+    ComPtr<ID3DBlob> ErrorBlob;
+    if (FAILED(D3D12SerializeVersionedRootSignature(&RootSigDesc, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf())))
+    {
+        if (ErrorBlob)
+        {
+            LogError(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
+        }
+        return false;
+    }
+
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), RootSignature.ReleaseAndGetAddressOf()));
+    if (!RootSignature)
+    {
+        return false;
+    }
+
+    FShaderCompiler Compiler;
+    const std::wstring CSTarget = RendererUtils::BuildShaderTarget(L"cs", Device->GetShaderModel());
+    const std::pair<const wchar_t*, ComPtr<ID3D12PipelineState>*> Entries[] =
+    {
+        { L"ProjectIrradianceSH", &ProjectPipeline },
+        { L"PrefilterSpecular", &PrefilterPipeline },
+    };
+
+    for (const auto& [EntryPoint, Pipeline] : Entries)
+    {
+        std::vector<uint8_t> CSByteCode;
+        if (!Compiler.CompileFromFile(L"Shaders/EnvironmentLighting.hlsl", EntryPoint, CSTarget, CSByteCode))
+        {
+            LogError("Failed to compile environment lighting shader");
+            return false;
+        }
+
+        D3D12_COMPUTE_PIPELINE_STATE_DESC PsoDesc = {};
+        PsoDesc.pRootSignature = RootSignature.Get();
+        PsoDesc.CS = { CSByteCode.data(), CSByteCode.size() };
+
+        HR_CHECK(Device->GetPipelineCache()->CreateComputePipelineState(PsoDesc, Pipeline->ReleaseAndGetAddressOf()));
+        if (!*Pipeline)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FEnvironmentLighting::Generate(FDX12Device* Device, ID3D12Resource* SourceCube, const std::wstring& CookedPath)
+{
+    const D3D12_RESOURCE_DESC SourceDesc = SourceCube->GetDesc();
+    const uint32_t SourceSize = static_cast<uint32_t>(SourceDesc.Width);
+    const uint32_t SourceMipCount = (std::max)(1u, static_cast<uint32_t>(SourceDesc.MipLevels));
+
+    // The irradiance only needs the low frequencies, so the projection reads a mip of at most
+    // MaxProjectionSize, which one group covers in a few iterations.
+    uint32_t ProjectionMip = 0;
+    while ((SourceSize >> ProjectionMip) > MaxProjectionSize && ProjectionMip + 1 < SourceMipCount)
+    {
+        ++ProjectionMip;
+    }
+    const uint32_t ProjectionSize = (std::max)(1u, SourceSize >> ProjectionMip);
+
+    const uint32_t PrefilteredSize = (std::max)(1u, (std::min)(SourceSize, MaxPrefilteredSize));
+    uint32_t PrefilteredMipCount = 1;
+    for (uint32_t Size = PrefilteredSize; Size > MinPrefilteredSize; Size >>= 1)
+    {
+        ++PrefilteredMipCount;
+    }
+
+    D3D12_HEAP_PROPERTIES DefaultHeap = {};
+    DefaultHeap.Type = D3D12_HEAP_TYPE_DEFAULT;
+    DefaultHeap.CreationNodeMask = 1;
+    DefaultHeap.VisibleNodeMask = 1;
+
+    D3D12_RESOURCE_DESC CubeDesc = {};
+    CubeDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    CubeDesc.Width = PrefilteredSize;
+    CubeDesc.Height = PrefilteredSize;
+    CubeDesc.DepthOrArraySize = 6;
+    CubeDesc.MipLevels = static_cast<UINT16>(PrefilteredMipCount);
+    CubeDesc.Format = PrefilteredFormat;
+    CubeDesc.SampleDesc.Count = 1;
+    CubeDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+    CubeDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Texture,
+        &DefaultHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &CubeDesc,
+        D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+        nullptr,
+        IID_PPV_ARGS(PrefilteredCube.ReleaseAndGetAddressOf())));
+    if (!PrefilteredCube)
+    {
+        return false;
+    }
+    PrefilteredCube->SetName(L"EnvironmentPrefiltered");
+
+    const UINT SubresourceCount = PrefilteredMipCount * 6;
+    std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> Layouts(SubresourceCount);
+    std::vector<UINT> NumRows(SubresourceCount);
+    UINT64 CubeReadbackSize = 0;
+    Device->GetDevice()->GetCopyableFootprints(&CubeDesc, 0, SubresourceCount, 0, Layouts.data(), NumRows.data(), nullptr, &CubeReadbackSize);
+
+    ComPtr<ID3D12Resource> CoefficientBuffer;
+    ComPtr<ID3D12Resource> CoefficientReadback;
+    ComPtr<ID3D12Resource> CubeReadback;
+    if (!CreateBuffer(Device, D3D12_HEAP_TYPE_DEFAULT, sizeof(FCoefficients), D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON, CoefficientBuffer)
+        || !CreateBuffer(Device, D3D12_HEAP_TYPE_READBACK, sizeof(FCoefficients), D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_DEST, CoefficientReadback)
+        || (!CookedPath.empty() && !CreateBuffer(Device, D3D12_HEAP_TYPE_READBACK, CubeReadbackSize, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_DEST, CubeReadback)))
+    {
+        LogError("Failed to create environment lighting buffers");
+        return false;
+    }
+
+    // Source cube SRV, the coefficient UAV, then one UAV per prefiltered mip.
+    FDX12DescriptorAllocator* DescriptorAllocator = Device->GetDescriptorAllocator();
+    const FDX12DescriptorRange Descriptors = DescriptorAllocator->AllocatePersistent(2 + PrefilteredMipCount);
+    if (!Descriptors.IsValid())
+    {
+        LogError("Out of descriptors for environment lighting");
+        return false;
+    }
+
+    D3D12_SHADER_RESOURCE_VIEW_DESC SrvDesc = {};
+    SrvDesc.Format = SourceDesc.Format;
+    SrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBE;
+    SrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    SrvDesc.TextureCube.MipLevels = SourceMipCount;
+    Device->GetDevice()->CreateShaderResourceView(SourceCube, &SrvDesc, Descriptors.GetCpuHandle(0));
+
+    D3D12_UNORDERED_ACCESS_VIEW_DESC CoefficientUavDesc = {};
+    CoefficientUavDesc.Format = DXGI_FORMAT_UNKNOWN;
+    CoefficientUavDesc.ViewDimension = D3D12_UAV_DIMENSION_BUFFER;
+    CoefficientUavDesc.Buffer.NumElements = CoefficientCount;
+    CoefficientUavDesc.Buffer.StructureByteStride = sizeof(DirectX::XMFLOAT4);
+    Device->GetDevice()->CreateUnorderedAccessView(CoefficientBuffer.Get(), nullptr, &CoefficientUavDesc, Descriptors.GetCpuHandle(1));
+
+    for (uint32_t Mip = 0; Mip < PrefilteredMipCount; ++Mip)
+    {
+        D3D12_UNORDERED_ACCESS_VIEW_DESC CubeUavDesc = {};
+        CubeUavDesc.Format = PrefilteredFormat;
+        CubeUavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2DARRAY;
+        CubeUavDesc.Texture2DArray.MipSlice = Mip;
+        CubeUavDesc.Texture2DArray.FirstArraySlice = 0;
+        CubeUavDesc.Texture2DArray.ArraySize = 6;
+        Device->GetDevice()->CreateUnorderedAccessView(PrefilteredCube.Get(), nullptr, &CubeUavDesc, Descriptors.GetCpuHandle(2 + Mip));
+    }
+
+    FDX12CommandQueue Queue;
+    ComPtr<ID3D12CommandAllocator> Allocator;
+    ComPtr<ID3D12GraphicsCommandList> CommandList;
+    if (!Queue.Initialize(Device->GetDevice(), EDX12QueueType::Compute)
+        || FAILED(Device->GetDevice()->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COMPUTE, IID_PPV_ARGS(Allocator.GetAddressOf())))
+        || FAILED(Device->GetDevice()->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COMPUTE, Allocator.Get(), nullptr, IID_PPV_ARGS(CommandList.GetAddressOf()))))
+    {
+        LogError("Failed to create environment lighting command list");
+        DescriptorAllocator->FreePersistent(Descriptors);
+        return false;
+    }
+
+    ID3D12DescriptorHeap* Heaps[] = { DescriptorAllocator->GetHeap() };
+    CommandList->SetDescriptorHeaps(1, Heaps);
+    CommandList->SetComputeRootSignature(RootSignature.Get());
+    CommandList->SetComputeRootDescriptorTable(1, Descriptors.GetGpuHandle(0));
+
+    D3D12_RESOURCE_BARRIER Barrier = {};
+    Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    Barrier.Transition.pResource = CoefficientBuffer.Get();
+    Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COMMON;
+    Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    CommandList->ResourceBarrier(1, &Barrier);
+
+    FEnvironmentLightingConstants Constants;
+    Constants.FaceSize = ProjectionSize;
+    Constants.SourceMip = static_cast<float>(ProjectionMip);
+    Constants.SourceFaceSize = static_cast<float>(SourceSize);
+    Constants.SourceMipCount = static_cast<float>(SourceMipCount);
+    Constants.SampleCount = PrefilterSampleCount;
+
+    CommandList->SetPipelineState(ProjectPipeline.Get());
+    CommandList->SetComputeRoot32BitConstants(0, ConstantCount, &Constants, 0);
+    CommandList->SetComputeRootDescriptorTable(2, Descriptors.GetGpuHandle(1));
+    CommandList->Dispatch(1, 1, 1);
+
+    // Mips only read the source, so they need no barriers between them. The sharpest mip copies
+    // the source mip of its size.
+    uint32_t CopyMip = 0;
+    while ((SourceSize >> CopyMip) > PrefilteredSize && CopyMip + 1 < SourceMipCount)
+    {
+        ++CopyMip;
+    }
+    Constants.SourceMip = static_cast<float>(CopyMip);
+    CommandList->SetPipelineState(PrefilterPipeline.Get());
+    for (uint32_t Mip = 0; Mip < PrefilteredMipCount; ++Mip)
+    {
+        Constants.FaceSize = (std::max)(1u, PrefilteredSize >> Mip);
+        Constants.Roughness = PrefilteredMipCount > 1 ? static_cast<float>(Mip) / static_cast<float>(PrefilteredMipCount - 1) : 0.0f;
+        CommandList->SetComputeRoot32BitConstants(0, ConstantCount, &Constants, 0);
+        CommandList->SetComputeRootDescriptorTable(2, Descriptors.GetGpuHandle(2 + Mip));
+        CommandList->Dispatch((Constants.FaceSize + 7) / 8, (Constants.FaceSize + 7) / 8, 6);
+    }
+
+    D3D12_RESOURCE_BARRIER Barriers[2] = { Barrier, Barrier };
+    Barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    Barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+    Barriers[1].Transition.pResource = PrefilteredCube.Get();
+    Barriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    Barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+    CommandList->ResourceBarrier(_countof(Barriers), Barriers);
+
+    CommandList->CopyBufferRegion(CoefficientReadback.Get(), 0, CoefficientBuffer.Get(), 0, sizeof(FCoefficients));
+    for (UINT Subresource = 0; CubeReadback && Subresource < SubresourceCount; ++Subresource)
+    {
+        D3D12_TEXTURE_COPY_LOCATION DstLocation = {};
+        DstLocation.pResource = CubeReadback.Get();
+        DstLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        DstLocation.PlacedFootprint = Layouts[Subresource];
+
+        D3D12_TEXTURE_COPY_LOCATION SrcLocation = {};
+        SrcLocation.pResource = PrefilteredCube.Get();
+        SrcLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        SrcLocation.SubresourceIndex = Subresource;
+
+        CommandList->CopyTextureRegion(&DstLocation, 0, 0, 0, &SrcLocation, nullptr);
+    }
+
+    // COMMON lets the graphics queue promote the cube on its first read.
+    Barriers[1].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_SOURCE;
+    Barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_COMMON;
+    CommandList->ResourceBarrier(1, &Barriers[1]);
+
+    HR_CHECK(CommandList->Close());
+
+    // The source cube's upload may still be in flight on the upload queue.
+    FDX12UploadQueue* UploadQueue = Device->GetUploadQueue();
+    Queue.GpuWait(*UploadQueue->GetQueue(), UploadQueue->GetLastSubmittedFenceValue());
+    ID3D12CommandList* Lists[] = { CommandList.Get() };
+    Queue.ExecuteCommandLists(1, Lists);
+    Queue.Wait(Queue.Signal());
+    DescriptorAllocator->FreePersistent(Descriptors);
+
+    const D3D12_RANGE ReadRange = { 0, sizeof(FCoefficients) };
+    const D3D12_RANGE EmptyRange = { 0, 0 };
+    void* MappedCoefficients = nullptr;
+    if (FAILED(CoefficientReadback->Map(0, &ReadRange, &MappedCoefficients)))
+    {
+        return false;
+    }
+    std::memcpy(IrradianceSH.data(), MappedCoefficients, sizeof(FCoefficients));
+    CoefficientReadback->Unmap(0, &EmptyRange);
+
+    LogInfo("Environment lighting precomputed: " + std::to_string(PrefilteredSize) + "px specular cube with " + std::to_string(PrefilteredMipCount) + " mips");
+    if (!CubeReadback)
+    {
+        return true;
+    }
+
+    uint8_t* MappedCube = nullptr;
+    if (SUCCEEDED(CubeReadback->Map(0, nullptr, reinterpret_cast<void**>(&MappedCube))))
+    {
+        // The coefficients go last, since LoadCooked only looks for the cube once they exist.
+        const std::filesystem::path CookedBase(CookedPath);
+        if (!WriteCookedCube(std::filesystem::path(CookedPath + L".dds"), MappedCube, CubeDesc, Layouts, NumRows)
+            || !WriteCookedCoefficients(std::filesystem::path(CookedPath + L".sh"), IrradianceSH))
+        {
+            LogWarning("Failed to write cooked environment lighting " + CookedBase.string());
+        }
+        CubeReadback->Unmap(0, &EmptyRange);
+    }
+    return true;
+}
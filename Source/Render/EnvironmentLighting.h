@@ -0,0 +1,61 @@
+#pragma once
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <DirectXMath.h>
+#include <array>
+#include <cstdint>
+#include <string>
+
+class FDX12Device;
+class FTextureLoader;
+
+/**
+ * Image-based lighting precomputed from the environment cube when it loads, with
+ * Shaders/EnvironmentLighting.hlsl on a compute queue: L2 spherical harmonics of the diffuse
+ * irradiance, which lighting passes evaluate in ALU from the view constants, and a specular cube
+ * whose mip m holds the GGX lobe of roughness m / (mip count - 1). Both are cooked under
+ * TextureCache/, keyed by source path, size and write time, and later loads read the cooked cube
+ * and coefficients instead of recomputing them.
+ */
+class FEnvironmentLighting
+{
+public:
+    // Bump whenever the shaders or the cooked layout change so stale cooked files are no longer found.
+    static constexpr uint32_t CookVersion = 1;
+    static constexpr uint32_t CoefficientCount = 9;
+    static constexpr DXGI_FORMAT PrefilteredFormat = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    // Largest face of the specular cube; the source's is used when smaller.
+    static constexpr uint32_t MaxPrefilteredSize = 256;
+    // Face size of the roughest mip, which ends the specular chain.
+    static constexpr uint32_t MinPrefilteredSize = 8;
+    // Largest source mip face the irradiance projection integrates.
+    static constexpr uint32_t MaxProjectionSize = 64;
+    static constexpr uint32_t PrefilterSampleCount = 128;
+
+    using FCoefficients = std::array<DirectX::XMFLOAT4, CoefficientCount>;
+
+    /**
+     * Loads the cooked lighting of SourceCube, or computes and cooks it, blocking until it is ready.
+     * @param SourcePath File SourceCube was loaded from, which keys the cooked files
+     * @param SourceCube Cube texture readable by compute shaders, with its upload submitted
+     */
+    bool Build(FDX12Device* Device, FTextureLoader& TextureLoader, const std::wstring& SourcePath, ID3D12Resource* SourceCube);
+
+    // Null until Build succeeded; left in COMMON for implicit promotion on first read.
+    ID3D12Resource* GetPrefilteredCube() const { return PrefilteredCube.Get(); }
+    // rgb per coefficient, already convolved with the clamped cosine lobe over PI.
+    const FCoefficients& GetIrradianceSH() const { return IrradianceSH; }
+
+private:
+    std::wstring GetCookedPath(const std::wstring& SourcePath) const;
+    bool LoadCooked(FTextureLoader& TextureLoader, const std::wstring& CookedPath);
+    bool CreatePipelines(FDX12Device* Device);
+    bool Generate(FDX12Device* Device, ID3D12Resource* SourceCube, const std::wstring& CookedPath);
+
+    Microsoft::WRL::ComPtr<ID3D12RootSignature> RootSignature;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> ProjectPipeline;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> PrefilterPipeline;
+    Microsoft::WRL::ComPtr<ID3D12Resource> PrefilteredCube;
+    FCoefficients IrradianceSH{};
+};
@@ -1,13 +1,16 @@
 #include "ForwardRenderer.h"
 
 #include "ShaderCompiler.h"
+#include "PipelineJobGroup.h"
 #include "RendererUtils.h"
 #include "RenderGraph.h"
+#include "TextureStreamer.h"
 #include "../Scene/GltfLoader.h"
 #include "../Scene/Camera.h"
 #include "../Scene/Mesh.h"
 #include "../RHI/DX12Device.h"
 #include "../RHI/DX12CommandContext.h"
+#include "../Core/CpuProfiler.h"
 #include "../Core/GpuDebugMarkers.h"
 #include "../Core/Logger.h"
 #include <cstring>
@@ -19,21 +22,9 @@
 
 FForwardRenderer::FForwardRenderer() = default;
 
-namespace
-{
-    uint32_t BuildPipelineKey(const FSceneModelResource& Model)
-    {
-        const uint32_t UseNormal = Model.bHasNormalMap ? 1u : 0u;
-        const uint32_t UseMr = !Model.MetallicRoughnessTexturePath.empty() ? 1u : 0u;
-        const uint32_t UseBase = !Model.BaseColorTexturePath.empty() ? 1u : 0u;
-        const uint32_t UseEmissive = !Model.EmissiveTexturePath.empty() ? 1u : 0u;
-        const uint32_t UseAlphaMask = (Model.AlphaMode == 1u) ? 1u : 0u;
-        return (UseNormal) | (UseMr << 1) | (UseBase << 2) | (UseEmissive << 3) | (UseAlphaMask << 4);
-    }
-}
-
 bool FForwardRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t Height, DXGI_FORMAT BackBufferFormat, const FRendererOptions& Options)
 {
+    FGpuMemoryOwnerScope MemoryScope(GetMemoryOwnerId());
     if (Device == nullptr)
     {
         LogError("Forward renderer initialization failed: device is null");
@@ -53,26 +44,17 @@ bool FForwardRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
         return false;
     }
 
-    LogInfo("Creating forward renderer pipeline state...");
-    if (!CreatePipelineState(Device, BackBufferFormat))
-    {
-        LogError("Forward renderer initialization failed: pipeline state creation failed");
-        return false;
-    }
-
-    LogInfo("Creating forward renderer object ID pipeline...");
-    if (!CreateObjectIdPipeline(Device))
-    {
-        LogError("Forward renderer initialization failed: object ID pipeline creation failed");
-        return false;
-    }
-
-    LogInfo("Creating forward renderer shadow pipeline...");
-    if (!CreateShadowPipeline(Device, RootSignature.Get(), ShadowPipeline))
-    {
-        LogError("Forward renderer initialization failed: shadow pipeline creation failed");
-        return false;
-    }
+    // Pipelines build on the workers while the scene loads below; each writes only its own PSOs.
+    LogInfo("Creating forward renderer pipelines...");
+    FPipelineJobGroup PipelineJobs;
+    PipelineJobs.Add([this, Device, BackBufferFormat]() { return CreatePipelineState(Device, BackBufferFormat); },
+        "Forward renderer initialization failed: pipeline state creation failed");
+    PipelineJobs.Add([this, Device]() { return CreateObjectIdPipeline(Device); },
+        "Forward renderer initialization failed: object ID pipeline creation failed");
+    PipelineJobs.Add([this, Device]() { return CreateShadowPipeline(Device, RootSignature.Get(), ShadowPipeline); },
+        "Forward renderer initialization failed: shadow pipeline creation failed");
+    PipelineJobs.Add([this, Device]() { return CreateSceneScatterPipeline(Device); },
+        "Scene scatter pipeline unavailable, updating scene buffers with one copy per entry", false);
 
     TextureLoader = std::make_unique<FTextureLoader>(Device);
 
@@ -87,31 +69,17 @@ bool FForwardRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
         NullTexture->SetName(L"NullTexture");
     }
 
-    if (!TextureLoader->LoadOrDefault(L"Assets/Textures/output_pmrem.dds", EnvironmentCubeTexture))
+    if (!LoadEnvironment(Device, L"Assets/Textures/output_pmrem.dds"))
     {
         LogError("Forward renderer initialization failed: environment cube texture loading failed");
         return false;
     }
-    if (EnvironmentCubeTexture)
-    {
-        EnvironmentCubeTexture->SetName(L"EnvironmentCube");
-    }
 
-    if (!TextureLoader->LoadOrDefault(L"Assets/Textures/PreintegratedGF.dds", BrdfLutTexture))
+    if (!LoadBrdfLut(L"Assets/Textures/PreintegratedGF.dds"))
     {
         LogError("Forward renderer initialization failed: BRDF LUT texture loading failed");
         return false;
     }
-    if (BrdfLutTexture)
-    {
-        BrdfLutTexture->SetName(L"BrdfLut");
-    }
-
-    if (EnvironmentCubeTexture)
-    {
-        const D3D12_RESOURCE_DESC EnvDesc = EnvironmentCubeTexture->GetDesc();
-        EnvironmentMipCount = static_cast<float>((std::max)(1u, static_cast<uint32_t>(EnvDesc.MipLevels)));
-    }
 
     if (!CreateDepthResourcesPerFrame(Device, Width, Height, DXGI_FORMAT_D24_UNORM_S8_UINT))
     {
@@ -137,14 +105,15 @@ bool FForwardRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
         ObjectIdReadback->SetName(L"ObjectIdReadback");
     }
 
-    if (!CreateShadowResources(Device, ShadowMapWidth, ShadowMapHeight, ShadowMap, ShadowDSVHeap, ShadowDSVHandle, ShadowMapState))
+    if (!CreateShadowResources(Device, ShadowMapWidth, ShadowMapHeight, ShadowMap, ShadowDSVHeap, ShadowCascadeDSVHandles, ShadowMapState))
     {
         LogError("Forward renderer initialization failed: shadow resources creation failed");
         return false;
     }
 
+    SceneTransforms.Clear();
     const std::wstring SceneFilePath = Options.SceneFilePath.empty() ? L"Assets/Scenes/Scene.json" : Options.SceneFilePath;
-    if (!RendererUtils::CreateSceneModelsFromJson(Device, SceneFilePath, SceneModels, SceneCenter, SceneRadius))
+    if (!RendererUtils::CreateSceneModelsFromJson(Device, SceneFilePath, SceneModels, SceneCenter, SceneRadius, Options.bOptimizeMeshes, false, Options.bGenerateLods, &SceneTransforms))
     {
         LogWarning("Falling back to default geometry; scene JSON could not be loaded.");
 
@@ -158,6 +127,7 @@ bool FForwardRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
 
         const DirectX::XMMATRIX DefaultWorld = DirectX::XMMatrixTranslation(-SceneCenter.x, -SceneCenter.y, -SceneCenter.z);
         DirectX::XMStoreFloat4x4(&DefaultModel.WorldMatrix, DefaultWorld);
+        DefaultModel.PrevWorldMatrix = DefaultModel.WorldMatrix;
         DefaultModel.Center = SceneCenter;
         DefaultModel.Name = "DefaultMesh";
         DefaultModel.BoundsMin = DirectX::XMFLOAT3(SceneCenter.x - SceneRadius, SceneCenter.y - SceneRadius, SceneCenter.z - SceneRadius);
@@ -180,36 +150,18 @@ bool FForwardRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
         SceneModels.push_back(std::move(DefaultModel));
     }
 
-    SceneConstantBufferStride = (sizeof(FSceneConstants) + 255ULL) & ~255ULL;
-
-    const uint64_t ConstantBufferSize = SceneConstantBufferStride * (std::max<uint64_t>(1, SceneModels.size()));
-
-    if (!CreateSceneConstantBuffersPerFrame(Device, ConstantBufferSize))
-    {
-        LogError("Forward renderer initialization failed: constant buffer creation failed");
-        return false;
-    }
-
-    SkySphereRadius = (std::max)(SceneRadius * 5.0f, 100.0f);
-    if (!RendererUtils::CreateSkyAtmosphereResources(Device, SkySphereRadius, SkyGeometry, SkyConstantBuffer, SkyConstantBufferMapped))
-    {
-        LogError("Forward renderer initialization failed: sky resource creation failed");
-        return false;
-    }
-    if (SkyConstantBuffer)
-    {
-        SkyConstantBuffer->SetName(L"SkyConstantBuffer");
-    }
+    FinalizeSceneModels();
 
+    // The sky fills the back buffer before the scene, which then draws over it.
     FSkyPipelineConfig SkyPipelineConfig = {};
     SkyPipelineConfig.DepthEnable = false;
     SkyPipelineConfig.DepthFunc = D3D12_COMPARISON_FUNC_ALWAYS;
     SkyPipelineConfig.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
     SkyPipelineConfig.DsvFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
 
-    if (!RendererUtils::CreateSkyAtmospherePipeline(Device, BackBufferFormat, SkyPipelineConfig, SkyRootSignature, SkyPipelineState))
+    if (!InitializeSkyAtmosphere(Device, BackBufferFormat, SkyPipelineConfig))
     {
-        LogError("Forward renderer initialization failed: sky pipeline state creation failed");
+        LogError("Forward renderer initialization failed: sky atmosphere creation failed");
         return false;
     }
 
@@ -219,6 +171,13 @@ bool FForwardRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
         return false;
     }
 
+    // Materials record the descriptor indices of their texture tables, so this follows CreateSceneTextures.
+    if (!CreateSceneDataBuffers(Device))
+    {
+        LogError("Forward renderer initialization failed: scene data buffer creation failed");
+        return false;
+    }
+
     if (!CreateGpuDrivenResources(Device))
     {
         LogWarning("Forward renderer GPU-driven resources creation failed; fallback to CPU-driven draws.");
@@ -226,12 +185,40 @@ bool FForwardRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
 
     if (bEnableGpuDebugPrint)
     {
-        if (!CreateGpuDebugPrintResources(Device) || !CreateGpuDebugPrintPipeline(Device, BackBufferFormat) || !CreateGpuDebugPrintStatsPipeline(Device))
+        if (!CreateGpuDebugPrintResources(Device))
         {
             LogError("Forward renderer initialization failed: GPU debug print setup failed");
             return false;
         }
+        PipelineJobs.Add([this, Device, BackBufferFormat]() { return CreateGpuDebugPrintPipeline(Device, BackBufferFormat); },
+            "Forward renderer initialization failed: GPU debug print pipeline creation failed");
+        PipelineJobs.Add([this, Device]() { return CreateGpuDebugPrintStatsPipeline(Device); },
+            "Forward renderer initialization failed: GPU debug print stats pipeline creation failed");
+    }
+
+    if (!PipelineJobs.Join())
+    {
+        return false;
+    }
+
+    // Shader hot reload re-runs these builders when their shader sources change.
+    ShaderPipelineEntries.clear();
+    RegisterShaderPipeline({ L"Shaders/ForwardVS.hlsl", L"Shaders/ForwardPS.hlsl" }, [this, Device, BackBufferFormat]()
+    {
+        return CreatePipelineState(Device, BackBufferFormat);
+    });
+    RegisterShaderPipeline({ L"Shaders/ObjectId.hlsl" }, [this, Device]() { return CreateObjectIdPipeline(Device); });
+    RegisterShaderPipeline({ L"Shaders/ShadowMap.hlsl" }, [this, Device]() { return CreateShadowPipeline(Device, RootSignature.Get(), ShadowPipeline); });
+    RegisterShaderPipeline({ L"Shaders/SkyAtmosphere.hlsl" }, [this, Device]() { return SkyAtmosphere.CreatePipelines(Device); });
+    RegisterShaderPipeline({ L"Shaders/SceneScatter.hlsl" }, [this, Device]() { return CreateSceneScatterPipeline(Device); });
+    if (bEnableGpuDebugPrint)
+    {
+        RegisterShaderPipeline({ L"Shaders/GpuDebugPrint.hlsl" }, [this, Device, BackBufferFormat]() { return CreateGpuDebugPrintPipeline(Device, BackBufferFormat); });
+        RegisterShaderPipeline({ L"Shaders/GpuDebugPrintStats.hlsl" }, [this, Device]() { return CreateGpuDebugPrintStatsPipeline(Device); });
     }
+    InitializeVariableRateShading(Device, Width, Height, BackBufferFormat);
+
+    TrackPendingUploads(Device);
 
     LogInfo("Forward renderer initialization completed");
     return true;
@@ -239,27 +226,46 @@ bool FForwardRenderer::Initialize(FDX12Device* Device, uint32_t Width, uint32_t
 
 void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_CPU_DESCRIPTOR_HANDLE& RtvHandle, const FCamera& Camera, float DeltaTime)
 {
+    CPU_PROFILE_SCOPE("Forward Renderer");
+    FGpuMemoryOwnerScope MemoryScope(GetMemoryOwnerId());
     FScopedPixEvent RenderEvent(CmdContext.GetCommandList(), L"ForwardRenderer");
 
     ID3D12GraphicsCommandList* CommandList = CmdContext.GetCommandList();
 
+    if (!IsSecondaryView())
+    {
+        WaitForPendingUploads(CmdContext);
+        ApplyStreamedTextures(CmdContext);
+        UpdateSceneTransforms(CmdContext);
+    }
     PrepareGpuDebugPrint(CmdContext);
 
     UpdateCullingVisibility(Camera);
+    BuildSceneDrawList(Camera);
+    UpdateTextureMipStreaming(Camera);
 
-    const DirectX::XMMATRIX LightViewProjection = RendererUtils::BuildDirectionalLightViewProjection(
-        SceneCenter,
-        SceneRadius,
-        LightDirection);
-
+    // Every pass reads the same view constants, so they are written once per frame.
     const bool bRenderShadows = bShadowsEnabled && ShadowPipeline && ShadowMap;
+    const uint32_t ShadowCascadeMask = UpdateShadowCascades(Camera, bRenderShadows);
+    UploadViewConstants(CmdContext, Camera, Camera.GetProjectionMatrix());
+
+    // Casters of every cascade rendered this frame are culled once, against a frustum enclosing them.
+    float ShadowCullingTexelScale = 1.0f;
+    const DirectX::XMMATRIX LightViewProjection = ShadowCascades.BuildEnclosingViewProjection(ShadowCascadeMask, ShadowCullingTexelScale);
+
     const bool bDoDepthPrepass = bDepthPrepassEnabled && DepthPrepassPipeline;
 
-    FRenderGraph Graph;
+    // Rates are built from the finished back buffer, so the graph needs it imported to read it.
+    // The views of RenderViews would shade at each other's rates, so they neither build nor use them.
+    const bool bBuildShadingRate = VariableRateShading.IsActive() && OutputTarget && !IsRenderingMultipleViews();
+    const bool bApplyShadingRate = bBuildShadingRate && VariableRateShading.IsRateImageReady();
+
+    FRenderGraph Graph(CmdContext);
     Graph.SetDevice(Device);
     Graph.SetBarrierLoggingEnabled(bLogResourceBarriers);
     Graph.SetGraphDumpEnabled(bEnableGraphDump);
     Graph.SetGpuTimingEnabled(bEnableGpuTiming);
+    Graph.SetPipelineStatisticsEnabled(bEnablePipelineStatistics);
 
     FRGResourceHandle ShadowHandle = Graph.ImportTexture(
         "ShadowMap",
@@ -282,6 +288,28 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
         &ObjectIdState,
         { static_cast<uint32>(Viewport.Width), static_cast<uint32>(Viewport.Height), DXGI_FORMAT_R32_UINT });
 
+    // The back buffer arrives and must leave in RENDER_TARGET; the overlay pass writes it last.
+    D3D12_RESOURCE_STATES OutputTargetState = D3D12_RESOURCE_STATE_RENDER_TARGET;
+    FRGResourceHandle OutputTargetHandle;
+    FRGResourceHandle ShadingRateHandle;
+    if (bBuildShadingRate)
+    {
+        OutputTargetHandle = Graph.ImportTexture(
+            "BackBuffer",
+            OutputTarget,
+            &OutputTargetState,
+            { static_cast<uint32>(Viewport.Width), static_cast<uint32>(Viewport.Height), OutputTarget->GetDesc().Format });
+        ShadingRateHandle = Graph.ImportTexture(
+            "ShadingRateImage",
+            VariableRateShading.GetRateImage(),
+            VariableRateShading.GetRateImageState(),
+            { VariableRateShading.GetRateImageWidth(), VariableRateShading.GetRateImageHeight(), DXGI_FORMAT_R8_UINT });
+    }
+
+    const FSkyAtmosphereLuts SkyLuts = AddSkyAtmosphereLutPasses(Graph);
+
+    const FGpuDrivenBuffers GpuBuffers = ImportGpuDrivenBuffers(Graph);
+
     struct FGpuCullingPassData
     {
         bool bEnabled = false;
@@ -290,12 +318,18 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
 
     ConfigureHZBOcclusion(false, TextureDescriptorHeap.Get(), SceneTextureGpuHandle, 0, 0, 0);
 
-    Graph.AddPass<FGpuCullingPassData>("GPU Culling", [this, &Camera, DepthHandle](FGpuCullingPassData& Data, FRGPassBuilder& Builder)
+    Graph.AddPass<FGpuCullingPassData>("GPU Culling", [this, &Camera, DepthHandle, GpuBuffers](FGpuCullingPassData& Data, FRGPassBuilder& Builder)
     {
         Data.bEnabled = bEnableIndirectDraw && CullingPipeline && CullingRootSignature && GetIndirectCommandBuffer() && ModelBoundsBuffer;
         Data.Camera = &Camera;
         if (Data.bEnabled)
         {
+            Builder.ReadBuffer(GpuBuffers.ModelBounds);
+            Builder.WriteBuffer(GpuBuffers.IndirectCommands);
+            Builder.WriteBuffer(GpuBuffers.CompactedCommands);
+            Builder.WriteBuffer(GpuBuffers.VisibleInstances);
+            Builder.WriteBuffer(GpuBuffers.DebugPrint);
+            Builder.WriteBuffer(GpuBuffers.DebugPrintStats);
             Builder.KeepAlive();
         }
     }, [this](const FGpuCullingPassData& Data, FDX12CommandContext& Cmd)
@@ -308,23 +342,68 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
         DispatchGpuCulling(Cmd, *Data.Camera);
     });
 
-    struct FShadowPassData
+    struct FShadowCullingPassData
     {
         bool bEnabled = false;
         const FCamera* Camera = nullptr;
         DirectX::XMMATRIX LightViewProjection = DirectX::XMMatrixIdentity();
+        float TexelScale = 1.0f;
     };
 
-    Graph.AddPass<FShadowPassData>("ShadowMap", [&, bRenderShadows](FShadowPassData& Data, FRGPassBuilder& Builder)
+    // Shadow casters are culled against the light's frustum on the GPU, so the shadow pass records
+    // one ExecuteIndirect per range however many models the scene has.
+    const bool bUseShadowIndirect = bRenderShadows && bEnableIndirectDraw && IndirectCommandSignature && !IndirectDrawRanges.empty()
+        && !ShadowCullingBuffers.empty() && CullingPipeline && CullingRootSignature && ModelBoundsBuffer;
+    Graph.AddPass<FShadowCullingPassData>("GPU Shadow Culling", [this, &Camera, LightViewProjection, ShadowCullingTexelScale, bUseShadowIndirect, ShadowCascadeMask, GpuBuffers](FShadowCullingPassData& Data, FRGPassBuilder& Builder)
     {
-        Data.bEnabled = bRenderShadows;
+        // Cached cascades and views after the first of RenderViews render no casters.
+        Data.bEnabled = bUseShadowIndirect && ShadowCascadeMask != 0;
         Data.Camera = &Camera;
         Data.LightViewProjection = LightViewProjection;
+        Data.TexelScale = ShadowCullingTexelScale;
+        if (Data.bEnabled)
+        {
+            Builder.ReadBuffer(GpuBuffers.ModelBounds);
+            Builder.WriteBuffer(GpuBuffers.ShadowIndirectCommands);
+            Builder.WriteBuffer(GpuBuffers.ShadowCompactedCommands);
+            Builder.WriteBuffer(GpuBuffers.ShadowVisibleInstances);
+            Builder.KeepAlive();
+        }
+    }, [this](const FShadowCullingPassData& Data, FDX12CommandContext& Cmd)
+    {
+        if (!Data.bEnabled)
+        {
+            return;
+        }
+
+        DispatchGpuShadowCulling(Cmd, *Data.Camera, Data.LightViewProjection, Data.TexelScale);
+    });
+
+    struct FShadowPassData
+    {
+        bool bEnabled = false;
+        bool bUseIndirect = false;
+        const FCamera* Camera = nullptr;
+        uint32_t CascadeMask = 0;
+    };
+
+    Graph.AddPass<FShadowPassData>("ShadowMap", [&, bRenderShadows, bUseShadowIndirect, ShadowCascadeMask](FShadowPassData& Data, FRGPassBuilder& Builder)
+    {
+        Data.bEnabled = bRenderShadows && ShadowCascadeMask != 0;
+        Data.bUseIndirect = bUseShadowIndirect;
+        Data.Camera = &Camera;
+        Data.CascadeMask = ShadowCascadeMask;
 
         if (bRenderShadows)
         {
             Builder.WriteTexture(ShadowHandle, D3D12_RESOURCE_STATE_DEPTH_WRITE);
         }
+        if (bUseShadowIndirect)
+        {
+            Builder.ReadBuffer(GpuBuffers.ShadowIndirectCommands, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+            Builder.ReadBuffer(GpuBuffers.ShadowCompactedCommands, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+            Builder.ReadBuffer(GpuBuffers.ShadowVisibleInstances);
+        }
     }, [this](const FShadowPassData& Data, FDX12CommandContext& Cmd)
     {
         if (!Data.bEnabled)
@@ -335,64 +414,74 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
         ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
 
         FScopedPixEvent ShadowEvent(LocalCommandList, L"ShadowMap");
-        Cmd.ClearDepth(ShadowDSVHandle, 1.0f);
 
         LocalCommandList->SetPipelineState(ShadowPipeline.Get());
         LocalCommandList->SetGraphicsRootSignature(RootSignature.Get());
+        BindSceneData(LocalCommandList);
         LocalCommandList->RSSetViewports(1, &ShadowViewport);
         LocalCommandList->RSSetScissorRects(1, &ShadowScissor);
         LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        LocalCommandList->OMSetRenderTargets(0, nullptr, FALSE, &ShadowDSVHandle);
-
-        std::vector<bool> ShadowVisibility;
-        ShadowVisibility.resize(SceneModels.size(), true);
-        DirectX::XMVECTOR ShadowPlanes[6] = {};
-        RendererUtils::BuildFrustumPlanesFromMatrix(Data.LightViewProjection, ShadowPlanes);
-        for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
-        {
-            const FSceneModelResource& Model = SceneModels[ModelIndex];
-            ShadowVisibility[ModelIndex] = RendererUtils::IsAabbInCameraFrustum(ShadowPlanes, Model.BoundsMin, Model.BoundsMax);
-        }
-
-        for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+        if (Data.bUseIndirect)
         {
-            const FSceneModelResource& Model = SceneModels[ModelIndex];
-            const uint64_t ConstantBufferOffset = SceneConstantBufferStride * ModelIndex;
-            UpdateSceneConstants(*Data.Camera, Model, ConstantBufferOffset, Data.LightViewProjection);
+            // The depth-only shader draws masked materials opaque, so every range uses it.
+            BindShadowVisibleInstances(LocalCommandList);
+            RendererUtils::FGeometryBinding().BindPositions(LocalCommandList, SceneModels.front().Geometry);
         }
 
-        for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+        // Cached cascades outside the mask keep last frame's slice. Each cascade binds the copy of
+        // the view constants that holds its matrix.
+        std::vector<bool> ShadowVisibility;
+        std::vector<uint32_t> ShadowModelIndices;
+        RendererUtils::FGeometryBinding GeometryBinding;
+        for (uint32_t CascadeIndex = 0; CascadeIndex < FShadowCascades::CascadeCount; ++CascadeIndex)
         {
-            if (!ShadowVisibility.empty() && !ShadowVisibility[ModelIndex])
+            if ((Data.CascadeMask & (1u << CascadeIndex)) == 0 || ShadowCascadeConstantsAddresses[CascadeIndex] == 0)
             {
                 continue;
             }
 
-            const FSceneModelResource& Model = SceneModels[ModelIndex];
-            const uint64_t ConstantBufferOffset = SceneConstantBufferStride * ModelIndex;
-
-            LocalCommandList->IASetVertexBuffers(0, 1, &Model.Geometry.VertexBufferView);
-            LocalCommandList->IASetIndexBuffer(&Model.Geometry.IndexBufferView);
+            const D3D12_CPU_DESCRIPTOR_HANDLE CascadeDsv = ShadowCascadeDSVHandles[CascadeIndex];
+            Cmd.ClearDepth(CascadeDsv, 1.0f);
+            LocalCommandList->OMSetRenderTargets(0, nullptr, FALSE, &CascadeDsv);
+            LocalCommandList->SetGraphicsRootConstantBufferView(0, ShadowCascadeConstantsAddresses[CascadeIndex]);
 
-            const D3D12_GPU_VIRTUAL_ADDRESS ConstantBufferAddress = GetSceneConstantBufferAddress();
-            LocalCommandList->SetGraphicsRootConstantBufferView(
-                0,
-                ConstantBufferAddress + ConstantBufferOffset);
-
-            if (AreModelPixEventsEnabled())
+            if (Data.bUseIndirect)
             {
-                const std::wstring ModelLabel = Model.Name.empty()
-                    ? L"Model"
-                    : std::wstring(Model.Name.begin(), Model.Name.end());
-                FScopedPixEvent ModelEvent(LocalCommandList, ModelLabel.c_str());
-                LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
+                for (uint32_t RangeIndex = 0; RangeIndex < IndirectDrawRanges.size(); ++RangeIndex)
+                {
+                    ExecuteShadowIndirectRange(LocalCommandList, RangeIndex);
+                }
+                continue;
             }
-            else
+
+            RendererUtils::UpdateFrustumVisibility(ShadowCascades.GetViewProjection(CascadeIndex), SceneModels, SceneBvh, SceneBoundsSoA, ShadowModelIndices, ShadowVisibility);
+            for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
             {
-                LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
+                if (!ShadowVisibility.empty() && !ShadowVisibility[ModelIndex])
+                {
+                    continue;
+                }
+
+                const FSceneModelResource& Model = SceneModels[ModelIndex];
+
+                GeometryBinding.BindPositions(LocalCommandList, Model.Geometry);
+
+                BindSceneObject(LocalCommandList, static_cast<uint32_t>(ModelIndex));
+
+                if (AreModelPixEventsEnabled())
+                {
+                    const std::wstring ModelLabel = Model.Name.empty()
+                        ? L"Model"
+                        : std::wstring(Model.Name.begin(), Model.Name.end());
+                    FScopedPixEvent ModelEvent(LocalCommandList, ModelLabel.c_str());
+                    LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
+                }
+                else
+                {
+                    LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
+                }
             }
         }
-
     });
 
     struct FDepthPrepassData
@@ -415,6 +504,12 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
             {
                 Builder.ReadTexture(ShadowHandle, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
             }
+            if (bEnableIndirectDraw)
+            {
+                Builder.ReadBuffer(GpuBuffers.IndirectCommands, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+                Builder.ReadBuffer(GpuBuffers.CompactedCommands, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+                Builder.ReadBuffer(GpuBuffers.VisibleInstances);
+            }
         }
     }, [this](const FDepthPrepassData& Data, FDX12CommandContext& Cmd)
     {
@@ -431,6 +526,7 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
         ID3D12DescriptorHeap* Heaps[] = { TextureDescriptorHeap.Get() };
         LocalCommandList->SetPipelineState(DepthPrepassPipeline.Get());
         LocalCommandList->SetGraphicsRootSignature(RootSignature.Get());
+        BindSceneData(LocalCommandList);
         LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
         LocalCommandList->RSSetViewports(1, &Viewport);
         LocalCommandList->RSSetScissorRects(1, &ScissorRect);
@@ -438,6 +534,25 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
         const D3D12_CPU_DESCRIPTOR_HANDLE& DepthHandle = GetDSVHandle();
         LocalCommandList->OMSetRenderTargets(0, nullptr, FALSE, &DepthHandle);
 
+        // The forward pass draws the LODs GPU culling picked, so the prepass must draw the same commands.
+        ID3D12Resource* IndirectBuffer = GetIndirectCommandBuffer();
+        if (bEnableIndirectDraw && IndirectCommandSignature && IndirectBuffer && !IndirectDrawRanges.empty())
+        {
+            RendererUtils::FGeometryBinding().BindPositions(LocalCommandList, SceneModels.front().Geometry);
+            LocalCommandList->SetGraphicsRootDescriptorTable(1, SceneTextureGpuHandle);
+            for (uint32_t RangeIndex = 0; RangeIndex < IndirectDrawRanges.size(); ++RangeIndex)
+            {
+                if ((IndirectDrawRanges[RangeIndex].PipelineKey & MaterialAlphaMaskKey) != 0)
+                {
+                    continue;
+                }
+
+                ExecuteIndirectRange(LocalCommandList, RangeIndex);
+            }
+            return;
+        }
+
+        RendererUtils::FGeometryBinding GeometryBinding;
         for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
         {
             if (!SceneModelVisibility.empty() && !SceneModelVisibility[ModelIndex])
@@ -450,17 +565,10 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
             {
                 continue;
             }
-            const uint64_t ConstantBufferOffset = SceneConstantBufferStride * ModelIndex;
-
-            UpdateSceneConstants(*Data.Camera, Model, ConstantBufferOffset, Data.LightViewProjection);
 
-            LocalCommandList->IASetVertexBuffers(0, 1, &Model.Geometry.VertexBufferView);
-            LocalCommandList->IASetIndexBuffer(&Model.Geometry.IndexBufferView);
+            GeometryBinding.BindPositions(LocalCommandList, Model.Geometry);
 
-            const D3D12_GPU_VIRTUAL_ADDRESS ConstantBufferAddress = GetSceneConstantBufferAddress();
-            LocalCommandList->SetGraphicsRootConstantBufferView(
-                0,
-                ConstantBufferAddress + ConstantBufferOffset);
+            BindSceneObject(LocalCommandList, static_cast<uint32_t>(ModelIndex));
             LocalCommandList->SetGraphicsRootDescriptorTable(1, Model.TextureHandle);
 
             if (AreModelPixEventsEnabled())
@@ -481,21 +589,33 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
     struct FSkyPassData
     {
         D3D12_CPU_DESCRIPTOR_HANDLE OutputHandle{};
-        const FCamera* Camera = nullptr;
+        DirectX::XMFLOAT3 SunIlluminance{};
         bool bEnabled = false;
         bool bClearDepth = false;
+        bool bApplyShadingRate = false;
     };
 
     Graph.AddPass<FSkyPassData>("Sky", [&](FSkyPassData& Data, FRGPassBuilder& Builder)
     {
         Data.OutputHandle = RtvHandle;
-        Data.Camera = &Camera;
-        Data.bEnabled = SkyPipelineState && SkyRootSignature && SkyGeometry.IndexCount > 0;
+        Data.SunIlluminance = { LightColor.x * LightIntensity, LightColor.y * LightIntensity, LightColor.z * LightIntensity };
+        Data.bEnabled = SkyAtmosphere.IsReady();
         Data.bClearDepth = !bDoDepthPrepass;
+        Data.bApplyShadingRate = bApplyShadingRate;
 
         if (Data.bEnabled)
         {
             Builder.WriteTexture(DepthHandle, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+            Builder.ReadTexture(SkyLuts.SkyView, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+            Builder.ReadTexture(SkyLuts.Transmittance, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+            if (OutputTargetHandle)
+            {
+                Builder.WriteTexture(OutputTargetHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
+            }
+            if (Data.bApplyShadingRate)
+            {
+                Builder.ReadTexture(ShadingRateHandle, D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE);
+            }
         }
     }, [this](const FSkyPassData& Data, FDX12CommandContext& Cmd)
     {
@@ -515,17 +635,14 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
             Cmd.ClearDepth(GetDSVHandle());
         }
 
-        LocalCommandList->SetPipelineState(SkyPipelineState.Get());
-        LocalCommandList->SetGraphicsRootSignature(SkyRootSignature.Get());
         LocalCommandList->RSSetViewports(1, &Viewport);
         LocalCommandList->RSSetScissorRects(1, &ScissorRect);
-        LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        LocalCommandList->IASetVertexBuffers(0, 1, &SkyGeometry.VertexBufferView);
-        LocalCommandList->IASetIndexBuffer(&SkyGeometry.IndexBufferView);
 
-        UpdateSkyConstants(*Data.Camera);
-        LocalCommandList->SetGraphicsRootConstantBufferView(0, SkyConstantBuffer->GetGPUVirtualAddress());
-        LocalCommandList->DrawIndexedInstanced(SkyGeometry.IndexCount, 1, 0, 0, 0);
+        // The atmosphere varies slowly, so most of its tiles shade coarse.
+        ID3D12GraphicsCommandList6* ShadingRateCommandList = Data.bApplyShadingRate ? Cmd.GetCommandList6() : nullptr;
+        VariableRateShading.Apply(ShadingRateCommandList);
+        SkyAtmosphere.Draw(LocalCommandList, ViewConstantsAddress, Data.SunIlluminance);
+        FVariableRateShading::Reset(ShadingRateCommandList);
     });
 
     struct FForwardPassData
@@ -535,6 +652,7 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
         bool bRenderShadows = false;
         DirectX::XMMATRIX LightViewProjection = DirectX::XMMatrixIdentity();
         bool bClearDepth = false;
+        bool bApplyShadingRate = false;
     };
 
     Graph.AddPass<FForwardPassData>("Forward", [&, bRenderShadows](FForwardPassData& Data, FRGPassBuilder& Builder)
@@ -543,13 +661,28 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
         Data.Camera = &Camera;
         Data.bRenderShadows = bRenderShadows;
         Data.LightViewProjection = LightViewProjection;
-        Data.bClearDepth = !bDoDepthPrepass && !(SkyPipelineState && SkyRootSignature && SkyGeometry.IndexCount > 0);
+        Data.bClearDepth = !bDoDepthPrepass && !SkyAtmosphere.IsReady();
+        Data.bApplyShadingRate = bApplyShadingRate;
 
         Builder.WriteTexture(DepthHandle, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+        if (OutputTargetHandle)
+        {
+            Builder.WriteTexture(OutputTargetHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
+        }
+        if (Data.bApplyShadingRate)
+        {
+            Builder.ReadTexture(ShadingRateHandle, D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE);
+        }
         if (bRenderShadows)
         {
             Builder.ReadTexture(ShadowHandle, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
         }
+        if (bEnableIndirectDraw)
+        {
+            Builder.ReadBuffer(GpuBuffers.IndirectCommands, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+            Builder.ReadBuffer(GpuBuffers.CompactedCommands, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+            Builder.ReadBuffer(GpuBuffers.VisibleInstances);
+        }
     }, [this](const FForwardPassData& Data, FDX12CommandContext& Cmd)
     {
         ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
@@ -565,24 +698,28 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
 
         LocalCommandList->SetPipelineState(PipelineState.Get());
         LocalCommandList->SetGraphicsRootSignature(RootSignature.Get());
+        BindSceneData(LocalCommandList);
 
         ID3D12DescriptorHeap* Heaps[] = { TextureDescriptorHeap.Get() };
         LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
+        if (bBindlessMaterials)
+        {
+            // Bindless draws index the heap directly; the table is bound once so the root signature stays complete.
+            LocalCommandList->SetGraphicsRootDescriptorTable(1, SceneTextureGpuHandle);
+        }
 
         LocalCommandList->RSSetViewports(1, &Viewport);
         LocalCommandList->RSSetScissorRects(1, &ScissorRect);
 
-        for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
-        {
-            const FSceneModelResource& Model = SceneModels[ModelIndex];
-            const uint64_t ConstantBufferOffset = SceneConstantBufferStride * ModelIndex;
-            UpdateSceneConstants(*Data.Camera, Model, ConstantBufferOffset, Data.LightViewProjection);
-        }
+        ID3D12GraphicsCommandList6* ShadingRateCommandList = Data.bApplyShadingRate ? Cmd.GetCommandList6() : nullptr;
+        VariableRateShading.Apply(ShadingRateCommandList);
 
         ID3D12Resource* IndirectBuffer = GetIndirectCommandBuffer();
         if (bEnableIndirectDraw && IndirectCommandSignature && IndirectBuffer && !IndirectDrawRanges.empty())
         {
             LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+            // Indirect commands carry no vertex or index buffer views; every draw reads the shared scene buffers.
+            RendererUtils::FGeometryBinding().Bind(LocalCommandList, SceneModels.front().Geometry);
 
             auto SelectPipelineByKey = [&](uint32_t Key)
             {
@@ -651,45 +788,46 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
                 return SelectPipeline(UseAlphaMask);
             };
 
-            for (const FIndirectDrawRange& Range : IndirectDrawRanges)
+            for (uint32_t RangeIndex = 0; RangeIndex < IndirectDrawRanges.size(); ++RangeIndex)
             {
+                const FIndirectDrawRange& Range = IndirectDrawRanges[RangeIndex];
                 ID3D12PipelineState* Pipeline = SelectPipelineByKey(Range.PipelineKey);
                 LocalCommandList->SetPipelineState(Pipeline);
-                LocalCommandList->SetGraphicsRootDescriptorTable(1, Range.TextureHandle);
+                if (Range.TextureHandle.ptr != 0)
+                {
+                    LocalCommandList->SetGraphicsRootDescriptorTable(1, Range.TextureHandle);
+                }
 
-                const uint64_t Offset = static_cast<uint64_t>(Range.Start) * sizeof(FIndirectDrawCommand);
                 if (AreModelPixEventsEnabled())
                 {
                     const wchar_t* Label = Range.Name.empty() ? L"IndirectDrawRange" : Range.Name.c_str();
                     FScopedPixEvent ModelEvent(LocalCommandList, Label);
-                    LocalCommandList->ExecuteIndirect(IndirectCommandSignature.Get(), Range.Count, IndirectBuffer, Offset, nullptr, 0);
+                    ExecuteIndirectRange(LocalCommandList, RangeIndex);
                 }
                 else
                 {
-                    LocalCommandList->ExecuteIndirect(IndirectCommandSignature.Get(), Range.Count, IndirectBuffer, Offset, nullptr, 0);
+                    ExecuteIndirectRange(LocalCommandList, RangeIndex);
                 }
             }
         }
         else
         {
-            for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+            LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+            RendererUtils::FGeometryBinding GeometryBinding;
+            ID3D12PipelineState* BoundPipeline = nullptr;
+            UINT64 BoundMaterialTable = 0;
+            for (const FDrawListEntry& Draw : SceneDrawList.GetEntries())
             {
-                if (!SceneModelVisibility.empty() && !SceneModelVisibility[ModelIndex])
-                {
-                    continue;
-                }
-
+                const uint32_t ModelIndex = Draw.ModelIndex;
                 const FSceneModelResource& Model = SceneModels[ModelIndex];
-                const uint64_t ConstantBufferOffset = SceneConstantBufferStride * ModelIndex;
 
-                LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-                LocalCommandList->IASetVertexBuffers(0, 1, &Model.Geometry.VertexBufferView);
-                LocalCommandList->IASetIndexBuffer(&Model.Geometry.IndexBufferView);
+                GeometryBinding.Bind(LocalCommandList, Model.Geometry);
 
-                const bool bUseBaseColorMap = !Model.BaseColorTexturePath.empty();
-                const bool bUseMetallicRoughnessMap = !Model.MetallicRoughnessTexturePath.empty();
-                const bool bUseEmissiveMap = !Model.EmissiveTexturePath.empty();
-                const bool bUseNormalMap = Model.bHasNormalMap;
+                // Bindless shaders pick their maps from MaterialFlags, so only the alpha-mask permutation remains.
+                const bool bUseBaseColorMap = !bBindlessMaterials && !Model.BaseColorTexturePath.empty();
+                const bool bUseMetallicRoughnessMap = !bBindlessMaterials && !Model.MetallicRoughnessTexturePath.empty();
+                const bool bUseEmissiveMap = !bBindlessMaterials && !Model.EmissiveTexturePath.empty();
+                const bool bUseNormalMap = !bBindlessMaterials && Model.bHasNormalMap;
                 const bool bUseAlphaMask = Model.AlphaMode == 1u;
 
                 auto SelectPipeline = [&](bool UseNormal, bool UseMr, bool UseBaseColor, bool UseEmissive, bool UseAlphaMask)
@@ -748,13 +886,20 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
                         : (UseMr ? PipelineStateNoBaseColorNoEmissiveNoNormal.Get() : PipelineStateNoMrNoBaseColorNoEmissiveNoNormal.Get());
                 };
 
-                LocalCommandList->SetPipelineState(SelectPipeline(bUseNormalMap, bUseMetallicRoughnessMap, bUseBaseColorMap, bUseEmissiveMap, bUseAlphaMask));
+                ID3D12PipelineState* Pipeline = SelectPipeline(bUseNormalMap, bUseMetallicRoughnessMap, bUseBaseColorMap, bUseEmissiveMap, bUseAlphaMask);
+                if (Pipeline != BoundPipeline)
+                {
+                    LocalCommandList->SetPipelineState(Pipeline);
+                    BoundPipeline = Pipeline;
+                }
 
-                const D3D12_GPU_VIRTUAL_ADDRESS ConstantBufferAddress = GetSceneConstantBufferAddress();
-                LocalCommandList->SetGraphicsRootConstantBufferView(
-                    0,
-                    ConstantBufferAddress + ConstantBufferOffset);
-                LocalCommandList->SetGraphicsRootDescriptorTable(1, Model.TextureHandle);
+                BindSceneObject(LocalCommandList, ModelIndex);
+                const D3D12_GPU_DESCRIPTOR_HANDLE MaterialTable = ResolveMaterialTable(Model);
+                if (MaterialTable.ptr != 0 && MaterialTable.ptr != BoundMaterialTable)
+                {
+                    LocalCommandList->SetGraphicsRootDescriptorTable(1, MaterialTable);
+                    BoundMaterialTable = MaterialTable.ptr;
+                }
 
                 if (AreModelPixEventsEnabled())
                 {
@@ -770,20 +915,21 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
                 }
             }
         }
+
+        FVariableRateShading::Reset(ShadingRateCommandList);
     });
 
     struct FObjectIdPassData
     {
         bool bEnabled = false;
         const FCamera* Camera = nullptr;
-        DirectX::XMMATRIX LightViewProjection = DirectX::XMMatrixIdentity();
     };
 
-    Graph.AddPass<FObjectIdPassData>("ObjectId", [this, &Camera, LightViewProjection, ObjectIdHandle, DepthHandle](FObjectIdPassData& Data, FRGPassBuilder& Builder)
+    // Reads the depth the scene drew and redraws only the models under the requested pixel.
+    Graph.AddPass<FObjectIdPassData>("ObjectId", [this, &Camera, ObjectIdHandle, DepthHandle](FObjectIdPassData& Data, FRGPassBuilder& Builder)
     {
         Data.bEnabled = bObjectIdReadbackRequested && ObjectIdPipeline && ObjectIdTexture;
         Data.Camera = &Camera;
-        Data.LightViewProjection = LightViewProjection;
 
         if (Data.bEnabled)
         {
@@ -803,107 +949,120 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
 
         LocalCommandList->SetPipelineState(ObjectIdPipeline.Get());
         LocalCommandList->SetGraphicsRootSignature(RootSignature.Get());
+        BindSceneData(LocalCommandList);
         LocalCommandList->RSSetViewports(1, &Viewport);
-        LocalCommandList->RSSetScissorRects(1, &ScissorRect);
         LocalCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
         const D3D12_CPU_DESCRIPTOR_HANDLE& DepthHandle = GetDSVHandle();
         LocalCommandList->OMSetRenderTargets(1, &ObjectIdRtvHandle, FALSE, &DepthHandle);
 
-        const UINT ClearValue[4] = { 0, 0, 0, 0 };
-        LocalCommandList->ClearRenderTargetView(ObjectIdRtvHandle, reinterpret_cast<const float*>(ClearValue), 0, nullptr);
+        RecordObjectIdPick(LocalCommandList, *Data.Camera);
+    });
 
-        for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+    struct FShadingRatePassData
+    {
+        bool bEnabled = false;
+        FShadingRateConstants Constants;
+    };
+
+    // The back buffer holds the tonemapped picture, so its values need no exposure.
+    Graph.AddPass<FShadingRatePassData>("Shading Rate", [&](FShadingRatePassData& Data, FRGPassBuilder& Builder)
+    {
+        Data.bEnabled = bBuildShadingRate;
+        if (!Data.bEnabled)
         {
-            const FSceneModelResource& Model = SceneModels[ModelIndex];
-            const uint64_t ConstantBufferOffset = SceneConstantBufferStride * ModelIndex;
-            UpdateSceneConstants(*Data.Camera, Model, ConstantBufferOffset, Data.LightViewProjection);
+            return;
         }
 
-        for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+        const DirectX::XMMATRIX ViewProjection = DirectX::XMMatrixMultiply(Camera.GetViewMatrix(), Camera.GetProjectionMatrix());
+        Data.Constants = VariableRateShading.BuildConstants(ViewProjection, 1.0f, false, true);
+        Builder.ReadTexture(OutputTargetHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        Builder.ReadTexture(DepthHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        Builder.WriteTexture(ShadingRateHandle, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    }, [this](const FShadingRatePassData& Data, FDX12CommandContext& Cmd)
+    {
+        if (!Data.bEnabled)
         {
-            if (!SceneModelVisibility.empty() && !SceneModelVisibility[ModelIndex])
-            {
-                continue;
-            }
+            return;
+        }
 
-            const FSceneModelResource& Model = SceneModels[ModelIndex];
-            const uint64_t ConstantBufferOffset = SceneConstantBufferStride * ModelIndex;
+        FDX12DescriptorAllocator* DescriptorAllocator = Cmd.GetDescriptorAllocator();
+        const FDX12DescriptorRange SourceTables = DescriptorAllocator ? DescriptorAllocator->AllocateTransient(2) : FDX12DescriptorRange{};
+        if (!SourceTables.IsValid())
+        {
+            return;
+        }
 
-            LocalCommandList->IASetVertexBuffers(0, 1, &Model.Geometry.VertexBufferView);
-            LocalCommandList->IASetIndexBuffer(&Model.Geometry.IndexBufferView);
-            const D3D12_GPU_VIRTUAL_ADDRESS ConstantBufferAddress = GetSceneConstantBufferAddress();
-            LocalCommandList->SetGraphicsRootConstantBufferView(
-                0,
-                ConstantBufferAddress + ConstantBufferOffset);
+        D3D12_SHADER_RESOURCE_VIEW_DESC SrvDesc = {};
+        SrvDesc.Format = OutputTarget->GetDesc().Format;
+        SrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        SrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        SrvDesc.Texture2D.MipLevels = 1;
+        Device->GetDevice()->CreateShaderResourceView(OutputTarget, &SrvDesc, SourceTables.GetCpuHandle(0));
+        SrvDesc.Format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+        Device->GetDevice()->CreateShaderResourceView(GetDepthBuffer(), &SrvDesc, SourceTables.GetCpuHandle(1));
 
-            if (AreModelPixEventsEnabled())
-            {
-                const std::wstring ModelLabel = Model.Name.empty()
-                    ? L"Model"
-                    : std::wstring(Model.Name.begin(), Model.Name.end());
-                FScopedPixEvent ModelEvent(LocalCommandList, ModelLabel.c_str());
-                LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
-            }
-            else
-            {
-                LocalCommandList->DrawIndexedInstanced(Model.DrawIndexCount, 1, Model.DrawIndexStart, 0, 0);
-            }
+        ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
+        FScopedPixEvent ShadingRateEvent(LocalCommandList, L"Shading Rate");
+
+        ID3D12DescriptorHeap* Heaps[] = { TextureDescriptorHeap.Get() };
+        LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
+        VariableRateShading.Dispatch(LocalCommandList, ViewConstantsAddress, Data.Constants, SourceTables.GetGpuHandle(0), SourceTables.GetGpuHandle(1), VariableRateShading.GetNullSrv());
+    });
+
+    struct FShadingRateOverlayPassData
+    {
+        bool bDrawOverlay = false;
+        D3D12_CPU_DESCRIPTOR_HANDLE OutputHandle{};
+    };
+
+    // Also returns the back buffer to RENDER_TARGET for the passes after the graph.
+    Graph.AddPass<FShadingRateOverlayPassData>("Shading Rate Overlay", [&](FShadingRateOverlayPassData& Data, FRGPassBuilder& Builder)
+    {
+        if (!bBuildShadingRate)
+        {
+            return;
         }
 
-        const uint32_t Width = static_cast<uint32_t>(Viewport.Width);
-        const uint32_t Height = static_cast<uint32_t>(Viewport.Height);
-        const uint32_t ReadX = (std::min)(ObjectIdReadbackX, Width > 0 ? Width - 1 : 0);
-        const uint32_t ReadY = (std::min)(ObjectIdReadbackY, Height > 0 ? Height - 1 : 0);
+        Data.bDrawOverlay = VariableRateShading.IsOverlayEnabled();
+        Data.OutputHandle = RtvHandle;
+        Builder.WriteTexture(OutputTargetHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
+        if (Data.bDrawOverlay)
+        {
+            Builder.ReadTexture(ShadingRateHandle, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+        }
+    }, [this](const FShadingRateOverlayPassData& Data, FDX12CommandContext& Cmd)
+    {
+        if (!Data.bDrawOverlay)
+        {
+            return;
+        }
 
-        D3D12_RESOURCE_BARRIER Barrier = {};
-        Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-        Barrier.Transition.pResource = ObjectIdTexture.Get();
-        Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-        Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
-        Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
-        LocalCommandList->ResourceBarrier(1, &Barrier);
-
-        D3D12_TEXTURE_COPY_LOCATION Src = {};
-        Src.pResource = ObjectIdTexture.Get();
-        Src.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-        Src.SubresourceIndex = 0;
-
-        D3D12_TEXTURE_COPY_LOCATION Dst = {};
-        Dst.pResource = ObjectIdReadback.Get();
-        Dst.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-        Dst.PlacedFootprint = ObjectIdFootprint;
-
-        D3D12_BOX SourceBox = {};
-        SourceBox.left = ReadX;
-        SourceBox.top = ReadY;
-        SourceBox.front = 0;
-        SourceBox.right = ReadX + 1;
-        SourceBox.bottom = ReadY + 1;
-        SourceBox.back = 1;
-
-        LocalCommandList->CopyTextureRegion(&Dst, 0, 0, 0, &Src, &SourceBox);
-
-        std::swap(Barrier.Transition.StateBefore, Barrier.Transition.StateAfter);
-        LocalCommandList->ResourceBarrier(1, &Barrier);
-
-        bObjectIdReadbackRecorded = true;
+        ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
+        FScopedPixEvent OverlayEvent(LocalCommandList, L"Shading Rate Overlay");
+        Cmd.SetRenderTarget(Data.OutputHandle, nullptr);
+
+        ID3D12DescriptorHeap* Heaps[] = { TextureDescriptorHeap.Get() };
+        LocalCommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
+        VariableRateShading.DrawOverlay(LocalCommandList, Viewport, ScissorRect);
     });
 
-    struct FDebugPrintPassData
+    AddGpuCullingStatsReadbackPass(Graph, GpuBuffers);
+
+    struct FDebugPrintStatsPassData
     {
         bool bEnabled = false;
-        D3D12_CPU_DESCRIPTOR_HANDLE OutputHandle{};
     };
 
-    Graph.AddPass<FDebugPrintPassData>("GpuDebugPrint", [this, RtvHandle](FDebugPrintPassData& Data, FRGPassBuilder& Builder)
+    Graph.AddPass<FDebugPrintStatsPassData>("GpuDebugPrintStats", [this, GpuBuffers](FDebugPrintStatsPassData& Data, FRGPassBuilder& Builder)
     {
-        Data.bEnabled = bEnableGpuDebugPrint && GpuDebugPrintPipeline && GpuDebugPrintRootSignature && GpuDebugPrintDescriptorHeap;
-        Data.OutputHandle = RtvHandle;
+        Data.bEnabled = bEnableGpuDebugPrint && GpuDebugPrintStatsPipeline && GpuDebugPrintStatsRootSignature && GpuDebugPrintDescriptorHeap;
         if (Data.bEnabled)
         {
+            Builder.ReadBuffer(GpuBuffers.DebugPrintStats);
+            Builder.WriteBuffer(GpuBuffers.DebugPrint);
             Builder.KeepAlive();
         }
-    }, [this](const FDebugPrintPassData& Data, FDX12CommandContext& Cmd)
+    }, [this](const FDebugPrintStatsPassData& Data, FDX12CommandContext& Cmd)
     {
         if (!Data.bEnabled)
         {
@@ -911,12 +1070,42 @@ void FForwardRenderer::RenderFrame(FDX12CommandContext& CmdContext, const D3D12_
         }
 
         DispatchGpuDebugPrintStats(Cmd);
-        RenderGpuDebugPrint(Cmd, Data.OutputHandle);
     });
 
-    Graph.Execute(CmdContext);
-}
-
+    struct FDebugPrintPassData
+    {
+        bool bEnabled = false;
+        D3D12_CPU_DESCRIPTOR_HANDLE OutputHandle{};
+    };
+
+    Graph.AddPass<FDebugPrintPassData>("GpuDebugPrint", [this, RtvHandle, GpuBuffers](FDebugPrintPassData& Data, FRGPassBuilder& Builder)
+    {
+        Data.bEnabled = bEnableGpuDebugPrint && GpuDebugPrintPipeline && GpuDebugPrintRootSignature && GpuDebugPrintDescriptorHeap;
+        Data.OutputHandle = RtvHandle;
+        if (Data.bEnabled)
+        {
+            Builder.ReadBuffer(GpuBuffers.DebugPrint);
+            Builder.KeepAlive();
+        }
+    }, [this](const FDebugPrintPassData& Data, FDX12CommandContext& Cmd)
+    {
+        if (!Data.bEnabled)
+        {
+            return;
+        }
+
+        RenderGpuDebugPrint(Cmd, Data.OutputHandle);
+    });
+
+    Graph.Execute(CmdContext);
+
+    // ImGui and Present expect the state Application left the back buffer in.
+    if (OutputTargetState != D3D12_RESOURCE_STATE_RENDER_TARGET)
+    {
+        CmdContext.TransitionResource(OutputTarget, OutputTargetState, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    }
+}
+
 void FForwardRenderer::UpdateCullingVisibility(const FCamera& Camera)
 {
     const FCamera* CullingCamera = GetCullingCameraOverride();
@@ -925,7 +1114,7 @@ void FForwardRenderer::UpdateCullingVisibility(const FCamera& Camera)
         CullingCamera = &Camera;
     }
 
-    RendererUtils::UpdateCullingVisibility(*CullingCamera, SceneModels, SceneModelVisibility);
+    RendererUtils::UpdateCullingVisibility(*CullingCamera, SceneModels, SceneBvh, SceneBoundsSoA, CullingScratchIndices, SceneModelVisibility);
 }
 
 bool FForwardRenderer::CreateRootSignature(FDX12Device* Device)
@@ -938,8 +1127,8 @@ bool FForwardRenderer::CreateRootSignature(FDX12Device* Device)
     DescriptorRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_NONE;
     DescriptorRange.OffsetInDescriptorsFromTableStart = 0;
 
-    D3D12_ROOT_PARAMETER1 RootParams[2] = {};
-    // RootParams[0]: Scene constant buffer (b0)
+    D3D12_ROOT_PARAMETER1 RootParams[6] = {};
+    // RootParams[0]: View constant buffer (b0)
     RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
     RootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
     RootParams[0].Descriptor.ShaderRegister = 0;
@@ -952,6 +1141,34 @@ bool FForwardRenderer::CreateRootSignature(FDX12Device* Device)
     RootParams[1].DescriptorTable.NumDescriptorRanges = 1;
     RootParams[1].DescriptorTable.pDescriptorRanges = &DescriptorRange;
 
+    // RootParams[2]: Instance base and draw object constants (b0, space2); indirect commands write the base
+    RootParams[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    RootParams[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+    RootParams[2].Constants.ShaderRegister = 0;
+    RootParams[2].Constants.RegisterSpace = 2;
+    RootParams[2].Constants.Num32BitValues = 2;
+
+    // RootParams[3]: VisibleInstances SRV (t0, space2)
+    RootParams[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    RootParams[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+    RootParams[3].Descriptor.ShaderRegister = 0;
+    RootParams[3].Descriptor.RegisterSpace = 2;
+    RootParams[3].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+
+    // RootParams[4]: SceneObjects SRV (t1, space2), read by the vertex shader and for the pixel's material
+    RootParams[4].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    RootParams[4].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[4].Descriptor.ShaderRegister = 1;
+    RootParams[4].Descriptor.RegisterSpace = 2;
+    RootParams[4].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+
+    // RootParams[5]: SceneMaterials SRV (t2, space2)
+    RootParams[5].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    RootParams[5].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+    RootParams[5].Descriptor.ShaderRegister = 2;
+    RootParams[5].Descriptor.RegisterSpace = 2;
+    RootParams[5].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+
     D3D12_STATIC_SAMPLER_DESC Samplers[3] = {};
     Samplers[0].Filter = D3D12_FILTER_ANISOTROPIC;
     Samplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
@@ -998,6 +1215,10 @@ bool FForwardRenderer::CreateRootSignature(FDX12Device* Device)
     RootDesc.Desc_1_1.NumStaticSamplers = _countof(Samplers);
     RootDesc.Desc_1_1.pStaticSamplers = Samplers;
     RootDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+    if (bBindlessMaterials)
+    {
+        RootDesc.Desc_1_1.Flags |= D3D12_ROOT_SIGNATURE_FLAG_CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED;
+    }
 
     Microsoft::WRL::ComPtr<ID3DBlob> SerializedSig;
     Microsoft::WRL::ComPtr<ID3DBlob> ErrorBlob;
@@ -1008,7 +1229,7 @@ bool FForwardRenderer::CreateRootSignature(FDX12Device* Device)
         OutputDebugStringA(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
     }
 
-    HR_CHECK(Device->GetDevice()->CreateRootSignature(0, SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), IID_PPV_ARGS(RootSignature.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), RootSignature.ReleaseAndGetAddressOf()));
     return true;
 }
 
@@ -1053,11 +1274,59 @@ bool FForwardRenderer::CreatePipelineState(FDX12Device* Device, DXGI_FORMAT Back
     const std::wstring VSTarget = RendererUtils::BuildShaderTarget(L"vs", ShaderModel);
     const std::wstring PSTarget = RendererUtils::BuildShaderTarget(L"ps", ShaderModel);
 
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardVS.hlsl", L"VSMain", VSTarget, VSByteCode))
+    std::vector<FShaderCompileRequest> Requests;
+
+    FShaderCompileRequest VSRequest;
+    VSRequest.FilePath = L"Shaders/ForwardVS.hlsl";
+    VSRequest.EntryPoint = L"VSMain";
+    VSRequest.Target = VSTarget;
+    VSRequest.OutByteCode = &VSByteCode;
+    Requests.push_back(VSRequest);
+
+    // The depth prepass reads only the position stream, so it needs its own vertex shader.
+    std::vector<uint8_t> DepthOnlyVSByteCode;
+    if (bDepthPrepassEnabled)
     {
-        return false;
+        FShaderCompileRequest DepthOnlyVSRequest = VSRequest;
+        DepthOnlyVSRequest.EntryPoint = L"VSDepthOnly";
+        DepthOnlyVSRequest.OutByteCode = &DepthOnlyVSByteCode;
+        Requests.push_back(DepthOnlyVSRequest);
     }
 
+    // Bindless shaders read the map bits from MaterialFlags, so only the map-less slots (plain and
+    // alpha-masked) are compiled; ResolveMaterialPipelineKey routes every model to them.
+    const auto QueuePixelShader = [&](std::vector<uint8_t>& OutByteCode, const std::vector<std::wstring>& Defines)
+    {
+        FShaderCompileRequest Request;
+        Request.FilePath = L"Shaders/ForwardPS.hlsl";
+        Request.EntryPoint = L"PSMain";
+        Request.Target = PSTarget;
+        Request.OutByteCode = &OutByteCode;
+
+        if (!bBindlessMaterials)
+        {
+            Request.Defines = Defines;
+            Requests.push_back(std::move(Request));
+            return;
+        }
+
+        Request.Defines = { L"BINDLESS_MATERIALS=1" };
+        for (const std::wstring& Define : Defines)
+        {
+            const std::wstring MapEnabledSuffix = L"_MAP=1";
+            if (Define.size() >= MapEnabledSuffix.size()
+                && Define.compare(Define.size() - MapEnabledSuffix.size(), MapEnabledSuffix.size(), MapEnabledSuffix) == 0)
+            {
+                return;
+            }
+            if (Define == L"USE_ALPHA_MASK=1")
+            {
+                Request.Defines.push_back(Define);
+            }
+        }
+        Requests.push_back(std::move(Request));
+    };
+
     const auto MakeAlphaDefines = [](const std::vector<std::wstring>& Defines)
     {
         std::vector<std::wstring> Result = Defines;
@@ -1066,179 +1335,78 @@ bool FForwardRenderer::CreatePipelineState(FDX12Device* Device, DXGI_FORMAT Back
     };
 
     const std::vector<std::wstring> DefaultDefines = { L"USE_BASE_COLOR_MAP=1", L"USE_METALLIC_ROUGHNESS_MAP=1", L"USE_EMISSIVE_MAP=1", L"USE_NORMAL_MAP=1" };
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCode, DefaultDefines))
-    {
-        return false;
-    }
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeAlphaMask, MakeAlphaDefines(DefaultDefines)))
-    {
-        return false;
-    }
+    QueuePixelShader(PSByteCode, DefaultDefines);
+    QueuePixelShader(PSByteCodeAlphaMask, MakeAlphaDefines(DefaultDefines));
 
     const std::vector<std::wstring> NoBaseColorDefines = { L"USE_BASE_COLOR_MAP=0", L"USE_METALLIC_ROUGHNESS_MAP=1", L"USE_EMISSIVE_MAP=1", L"USE_NORMAL_MAP=1" };
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoBaseColor, NoBaseColorDefines))
-    {
-        return false;
-    }
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoBaseColorAlphaMask, MakeAlphaDefines(NoBaseColorDefines)))
-    {
-        return false;
-    }
+    QueuePixelShader(PSByteCodeNoBaseColor, NoBaseColorDefines);
+    QueuePixelShader(PSByteCodeNoBaseColorAlphaMask, MakeAlphaDefines(NoBaseColorDefines));
 
     const std::vector<std::wstring> NoMrDefines = { L"USE_BASE_COLOR_MAP=1", L"USE_METALLIC_ROUGHNESS_MAP=0", L"USE_EMISSIVE_MAP=1", L"USE_NORMAL_MAP=1" };
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoMr, NoMrDefines))
-    {
-        return false;
-    }
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoMrAlphaMask, MakeAlphaDefines(NoMrDefines)))
-    {
-        return false;
-    }
+    QueuePixelShader(PSByteCodeNoMr, NoMrDefines);
+    QueuePixelShader(PSByteCodeNoMrAlphaMask, MakeAlphaDefines(NoMrDefines));
 
     const std::vector<std::wstring> NoMrNoBaseColorDefines = { L"USE_BASE_COLOR_MAP=0", L"USE_METALLIC_ROUGHNESS_MAP=0", L"USE_EMISSIVE_MAP=1", L"USE_NORMAL_MAP=1" };
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoMrNoBaseColor, NoMrNoBaseColorDefines))
-    {
-        return false;
-    }
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoMrNoBaseColorAlphaMask, MakeAlphaDefines(NoMrNoBaseColorDefines)))
-    {
-        return false;
-    }
+    QueuePixelShader(PSByteCodeNoMrNoBaseColor, NoMrNoBaseColorDefines);
+    QueuePixelShader(PSByteCodeNoMrNoBaseColorAlphaMask, MakeAlphaDefines(NoMrNoBaseColorDefines));
 
     const std::vector<std::wstring> NoEmissiveDefines = { L"USE_BASE_COLOR_MAP=1", L"USE_METALLIC_ROUGHNESS_MAP=1", L"USE_EMISSIVE_MAP=0", L"USE_NORMAL_MAP=1" };
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoEmissive, NoEmissiveDefines))
-    {
-        return false;
-    }
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoEmissiveAlphaMask, MakeAlphaDefines(NoEmissiveDefines)))
-    {
-        return false;
-    }
+    QueuePixelShader(PSByteCodeNoEmissive, NoEmissiveDefines);
+    QueuePixelShader(PSByteCodeNoEmissiveAlphaMask, MakeAlphaDefines(NoEmissiveDefines));
 
     const std::vector<std::wstring> NoBaseColorNoEmissiveDefines = { L"USE_BASE_COLOR_MAP=0", L"USE_METALLIC_ROUGHNESS_MAP=1", L"USE_EMISSIVE_MAP=0", L"USE_NORMAL_MAP=1" };
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoBaseColorNoEmissive, NoBaseColorNoEmissiveDefines))
-    {
-        return false;
-    }
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoBaseColorNoEmissiveAlphaMask, MakeAlphaDefines(NoBaseColorNoEmissiveDefines)))
-    {
-        return false;
-    }
+    QueuePixelShader(PSByteCodeNoBaseColorNoEmissive, NoBaseColorNoEmissiveDefines);
+    QueuePixelShader(PSByteCodeNoBaseColorNoEmissiveAlphaMask, MakeAlphaDefines(NoBaseColorNoEmissiveDefines));
 
     const std::vector<std::wstring> NoMrNoEmissiveDefines = { L"USE_BASE_COLOR_MAP=1", L"USE_METALLIC_ROUGHNESS_MAP=0", L"USE_EMISSIVE_MAP=0", L"USE_NORMAL_MAP=1" };
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoMrNoEmissive, NoMrNoEmissiveDefines))
-    {
-        return false;
-    }
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoMrNoEmissiveAlphaMask, MakeAlphaDefines(NoMrNoEmissiveDefines)))
-    {
-        return false;
-    }
+    QueuePixelShader(PSByteCodeNoMrNoEmissive, NoMrNoEmissiveDefines);
+    QueuePixelShader(PSByteCodeNoMrNoEmissiveAlphaMask, MakeAlphaDefines(NoMrNoEmissiveDefines));
 
     const std::vector<std::wstring> NoMrNoBaseColorNoEmissiveDefines = { L"USE_BASE_COLOR_MAP=0", L"USE_METALLIC_ROUGHNESS_MAP=0", L"USE_EMISSIVE_MAP=0", L"USE_NORMAL_MAP=1" };
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoMrNoBaseColorNoEmissive, NoMrNoBaseColorNoEmissiveDefines))
-    {
-        return false;
-    }
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoMrNoBaseColorNoEmissiveAlphaMask, MakeAlphaDefines(NoMrNoBaseColorNoEmissiveDefines)))
-    {
-        return false;
-    }
+    QueuePixelShader(PSByteCodeNoMrNoBaseColorNoEmissive, NoMrNoBaseColorNoEmissiveDefines);
+    QueuePixelShader(PSByteCodeNoMrNoBaseColorNoEmissiveAlphaMask, MakeAlphaDefines(NoMrNoBaseColorNoEmissiveDefines));
 
     const std::vector<std::wstring> NoNormalDefines = { L"USE_BASE_COLOR_MAP=1", L"USE_METALLIC_ROUGHNESS_MAP=1", L"USE_EMISSIVE_MAP=1", L"USE_NORMAL_MAP=0" };
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoNormal, NoNormalDefines))
-    {
-        return false;
-    }
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoNormalAlphaMask, MakeAlphaDefines(NoNormalDefines)))
-    {
-        return false;
-    }
+    QueuePixelShader(PSByteCodeNoNormal, NoNormalDefines);
+    QueuePixelShader(PSByteCodeNoNormalAlphaMask, MakeAlphaDefines(NoNormalDefines));
 
     const std::vector<std::wstring> NoBaseColorNoNormalDefines = { L"USE_BASE_COLOR_MAP=0", L"USE_METALLIC_ROUGHNESS_MAP=1", L"USE_EMISSIVE_MAP=1", L"USE_NORMAL_MAP=0" };
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoBaseColorNoNormal, NoBaseColorNoNormalDefines))
-    {
-        return false;
-    }
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoBaseColorNoNormalAlphaMask, MakeAlphaDefines(NoBaseColorNoNormalDefines)))
-    {
-        return false;
-    }
+    QueuePixelShader(PSByteCodeNoBaseColorNoNormal, NoBaseColorNoNormalDefines);
+    QueuePixelShader(PSByteCodeNoBaseColorNoNormalAlphaMask, MakeAlphaDefines(NoBaseColorNoNormalDefines));
 
     const std::vector<std::wstring> NoMrNoNormalDefines = { L"USE_BASE_COLOR_MAP=1", L"USE_METALLIC_ROUGHNESS_MAP=0", L"USE_EMISSIVE_MAP=1", L"USE_NORMAL_MAP=0" };
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoMrNoNormal, NoMrNoNormalDefines))
-    {
-        return false;
-    }
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoMrNoNormalAlphaMask, MakeAlphaDefines(NoMrNoNormalDefines)))
-    {
-        return false;
-    }
+    QueuePixelShader(PSByteCodeNoMrNoNormal, NoMrNoNormalDefines);
+    QueuePixelShader(PSByteCodeNoMrNoNormalAlphaMask, MakeAlphaDefines(NoMrNoNormalDefines));
 
     const std::vector<std::wstring> NoMrNoBaseColorNoNormalDefines = { L"USE_BASE_COLOR_MAP=0", L"USE_METALLIC_ROUGHNESS_MAP=0", L"USE_EMISSIVE_MAP=1", L"USE_NORMAL_MAP=0" };
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoMrNoBaseColorNoNormal, NoMrNoBaseColorNoNormalDefines))
-    {
-        return false;
-    }
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoMrNoBaseColorNoNormalAlphaMask, MakeAlphaDefines(NoMrNoBaseColorNoNormalDefines)))
-    {
-        return false;
-    }
+    QueuePixelShader(PSByteCodeNoMrNoBaseColorNoNormal, NoMrNoBaseColorNoNormalDefines);
+    QueuePixelShader(PSByteCodeNoMrNoBaseColorNoNormalAlphaMask, MakeAlphaDefines(NoMrNoBaseColorNoNormalDefines));
 
     const std::vector<std::wstring> NoEmissiveNoNormalDefines = { L"USE_BASE_COLOR_MAP=1", L"USE_METALLIC_ROUGHNESS_MAP=1", L"USE_EMISSIVE_MAP=0", L"USE_NORMAL_MAP=0" };
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoEmissiveNoNormal, NoEmissiveNoNormalDefines))
-    {
-        return false;
-    }
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoEmissiveNoNormalAlphaMask, MakeAlphaDefines(NoEmissiveNoNormalDefines)))
-    {
-        return false;
-    }
+    QueuePixelShader(PSByteCodeNoEmissiveNoNormal, NoEmissiveNoNormalDefines);
+    QueuePixelShader(PSByteCodeNoEmissiveNoNormalAlphaMask, MakeAlphaDefines(NoEmissiveNoNormalDefines));
 
     const std::vector<std::wstring> NoBaseColorNoEmissiveNoNormalDefines = { L"USE_BASE_COLOR_MAP=0", L"USE_METALLIC_ROUGHNESS_MAP=1", L"USE_EMISSIVE_MAP=0", L"USE_NORMAL_MAP=0" };
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoBaseColorNoEmissiveNoNormal, NoBaseColorNoEmissiveNoNormalDefines))
-    {
-        return false;
-    }
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoBaseColorNoEmissiveNoNormalAlphaMask, MakeAlphaDefines(NoBaseColorNoEmissiveNoNormalDefines)))
-    {
-        return false;
-    }
+    QueuePixelShader(PSByteCodeNoBaseColorNoEmissiveNoNormal, NoBaseColorNoEmissiveNoNormalDefines);
+    QueuePixelShader(PSByteCodeNoBaseColorNoEmissiveNoNormalAlphaMask, MakeAlphaDefines(NoBaseColorNoEmissiveNoNormalDefines));
 
     const std::vector<std::wstring> NoMrNoEmissiveNoNormalDefines = { L"USE_BASE_COLOR_MAP=1", L"USE_METALLIC_ROUGHNESS_MAP=0", L"USE_EMISSIVE_MAP=0", L"USE_NORMAL_MAP=0" };
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoMrNoEmissiveNoNormal, NoMrNoEmissiveNoNormalDefines))
-    {
-        return false;
-    }
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoMrNoEmissiveNoNormalAlphaMask, MakeAlphaDefines(NoMrNoEmissiveNoNormalDefines)))
-    {
-        return false;
-    }
+    QueuePixelShader(PSByteCodeNoMrNoEmissiveNoNormal, NoMrNoEmissiveNoNormalDefines);
+    QueuePixelShader(PSByteCodeNoMrNoEmissiveNoNormalAlphaMask, MakeAlphaDefines(NoMrNoEmissiveNoNormalDefines));
 
     const std::vector<std::wstring> NoMrNoBaseColorNoEmissiveNoNormalDefines = { L"USE_BASE_COLOR_MAP=0", L"USE_METALLIC_ROUGHNESS_MAP=0", L"USE_EMISSIVE_MAP=0", L"USE_NORMAL_MAP=0" };
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoMrNoBaseColorNoEmissiveNoNormal, NoMrNoBaseColorNoEmissiveNoNormalDefines))
-    {
-        return false;
-    }
-    if (!Compiler.CompileFromFile(L"Shaders/ForwardPS.hlsl", L"PSMain", PSTarget, PSByteCodeNoMrNoBaseColorNoEmissiveNoNormalAlphaMask, MakeAlphaDefines(NoMrNoBaseColorNoEmissiveNoNormalDefines)))
+    QueuePixelShader(PSByteCodeNoMrNoBaseColorNoEmissiveNoNormal, NoMrNoBaseColorNoEmissiveNoNormalDefines);
+    QueuePixelShader(PSByteCodeNoMrNoBaseColorNoEmissiveNoNormalAlphaMask, MakeAlphaDefines(NoMrNoBaseColorNoEmissiveNoNormalDefines));
+
+    if (!Compiler.CompileShadersParallel(Requests))
     {
         return false;
     }
 
-    D3D12_INPUT_ELEMENT_DESC InputLayout[] =
-    {
-        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0,   D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 24,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "TANGENT",  0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "COLOR",    0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 48, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-    };
-
     D3D12_GRAPHICS_PIPELINE_STATE_DESC PsoDesc = {};
     PsoDesc.pRootSignature = RootSignature.Get();
-    PsoDesc.InputLayout = { InputLayout, _countof(InputLayout) };
+    PsoDesc.InputLayout = RendererUtils::GetMeshInputLayout();
     PsoDesc.VS = { VSByteCode.data(), VSByteCode.size() };
-    PsoDesc.PS = { PSByteCode.data(), PSByteCode.size() };
     PsoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
     PsoDesc.SampleDesc.Count = 1;
     PsoDesc.SampleMask = UINT_MAX;
@@ -1289,110 +1457,61 @@ bool FForwardRenderer::CreatePipelineState(FDX12Device* Device, DXGI_FORMAT Back
     PsoDesc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
     PsoDesc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
 
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineState.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoBaseColor.data(), PSByteCodeNoBaseColor.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoBaseColor.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoMr.data(), PSByteCodeNoMr.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoMr.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoMrNoBaseColor.data(), PSByteCodeNoMrNoBaseColor.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoMrNoBaseColor.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoEmissive.data(), PSByteCodeNoEmissive.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoEmissive.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoBaseColorNoEmissive.data(), PSByteCodeNoBaseColorNoEmissive.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoBaseColorNoEmissive.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoMrNoEmissive.data(), PSByteCodeNoMrNoEmissive.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoMrNoEmissive.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoMrNoBaseColorNoEmissive.data(), PSByteCodeNoMrNoBaseColorNoEmissive.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoMrNoBaseColorNoEmissive.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoNormal.data(), PSByteCodeNoNormal.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoNormal.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoBaseColorNoNormal.data(), PSByteCodeNoBaseColorNoNormal.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoBaseColorNoNormal.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoMrNoNormal.data(), PSByteCodeNoMrNoNormal.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoMrNoNormal.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoMrNoBaseColorNoNormal.data(), PSByteCodeNoMrNoBaseColorNoNormal.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoMrNoBaseColorNoNormal.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoEmissiveNoNormal.data(), PSByteCodeNoEmissiveNoNormal.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoEmissiveNoNormal.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoBaseColorNoEmissiveNoNormal.data(), PSByteCodeNoBaseColorNoEmissiveNoNormal.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoBaseColorNoEmissiveNoNormal.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoMrNoEmissiveNoNormal.data(), PSByteCodeNoMrNoEmissiveNoNormal.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoMrNoEmissiveNoNormal.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoMrNoBaseColorNoEmissiveNoNormal.data(), PSByteCodeNoMrNoBaseColorNoEmissiveNoNormal.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoMrNoBaseColorNoEmissiveNoNormal.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeAlphaMask.data(), PSByteCodeAlphaMask.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateAlphaMask.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoBaseColorAlphaMask.data(), PSByteCodeNoBaseColorAlphaMask.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoBaseColorAlphaMask.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoMrAlphaMask.data(), PSByteCodeNoMrAlphaMask.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoMrAlphaMask.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoMrNoBaseColorAlphaMask.data(), PSByteCodeNoMrNoBaseColorAlphaMask.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoMrNoBaseColorAlphaMask.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoEmissiveAlphaMask.data(), PSByteCodeNoEmissiveAlphaMask.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoEmissiveAlphaMask.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoBaseColorNoEmissiveAlphaMask.data(), PSByteCodeNoBaseColorNoEmissiveAlphaMask.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoBaseColorNoEmissiveAlphaMask.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoMrNoEmissiveAlphaMask.data(), PSByteCodeNoMrNoEmissiveAlphaMask.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoMrNoEmissiveAlphaMask.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoMrNoBaseColorNoEmissiveAlphaMask.data(), PSByteCodeNoMrNoBaseColorNoEmissiveAlphaMask.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoMrNoBaseColorNoEmissiveAlphaMask.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoNormalAlphaMask.data(), PSByteCodeNoNormalAlphaMask.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoNormalAlphaMask.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoBaseColorNoNormalAlphaMask.data(), PSByteCodeNoBaseColorNoNormalAlphaMask.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoBaseColorNoNormalAlphaMask.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoMrNoNormalAlphaMask.data(), PSByteCodeNoMrNoNormalAlphaMask.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoMrNoNormalAlphaMask.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoMrNoBaseColorNoNormalAlphaMask.data(), PSByteCodeNoMrNoBaseColorNoNormalAlphaMask.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoMrNoBaseColorNoNormalAlphaMask.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoEmissiveNoNormalAlphaMask.data(), PSByteCodeNoEmissiveNoNormalAlphaMask.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoEmissiveNoNormalAlphaMask.GetAddressOf())));
-
-    PsoDesc.PS = { PSByteCodeNoBaseColorNoEmissiveNoNormalAlphaMask.data(), PSByteCodeNoBaseColorNoEmissiveNoNormalAlphaMask.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoBaseColorNoEmissiveNoNormalAlphaMask.GetAddressOf())));
+    const auto CreatePermutation = [&](const std::vector<uint8_t>& PSByteCodeForPermutation, ComPtr<ID3D12PipelineState>& OutPipeline)
+    {
+        if (PSByteCodeForPermutation.empty())
+        {
+            return;
+        }
 
-    PsoDesc.PS = { PSByteCodeNoMrNoEmissiveNoNormalAlphaMask.data(), PSByteCodeNoMrNoEmissiveNoNormalAlphaMask.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoMrNoEmissiveNoNormalAlphaMask.GetAddressOf())));
+        PsoDesc.PS = { PSByteCodeForPermutation.data(), PSByteCodeForPermutation.size() };
+        HR_CHECK(Device->GetPipelineCache()->CreateGraphicsPipelineState(PsoDesc, OutPipeline.ReleaseAndGetAddressOf()));
+    };
 
-    PsoDesc.PS = { PSByteCodeNoMrNoBaseColorNoEmissiveNoNormalAlphaMask.data(), PSByteCodeNoMrNoBaseColorNoEmissiveNoNormalAlphaMask.size() };
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(PipelineStateNoMrNoBaseColorNoEmissiveNoNormalAlphaMask.GetAddressOf())));
+    CreatePermutation(PSByteCode, PipelineState);
+    CreatePermutation(PSByteCodeNoBaseColor, PipelineStateNoBaseColor);
+    CreatePermutation(PSByteCodeNoMr, PipelineStateNoMr);
+    CreatePermutation(PSByteCodeNoMrNoBaseColor, PipelineStateNoMrNoBaseColor);
+    CreatePermutation(PSByteCodeNoEmissive, PipelineStateNoEmissive);
+    CreatePermutation(PSByteCodeNoBaseColorNoEmissive, PipelineStateNoBaseColorNoEmissive);
+    CreatePermutation(PSByteCodeNoMrNoEmissive, PipelineStateNoMrNoEmissive);
+    CreatePermutation(PSByteCodeNoMrNoBaseColorNoEmissive, PipelineStateNoMrNoBaseColorNoEmissive);
+    CreatePermutation(PSByteCodeNoNormal, PipelineStateNoNormal);
+    CreatePermutation(PSByteCodeNoBaseColorNoNormal, PipelineStateNoBaseColorNoNormal);
+    CreatePermutation(PSByteCodeNoMrNoNormal, PipelineStateNoMrNoNormal);
+    CreatePermutation(PSByteCodeNoMrNoBaseColorNoNormal, PipelineStateNoMrNoBaseColorNoNormal);
+    CreatePermutation(PSByteCodeNoEmissiveNoNormal, PipelineStateNoEmissiveNoNormal);
+    CreatePermutation(PSByteCodeNoBaseColorNoEmissiveNoNormal, PipelineStateNoBaseColorNoEmissiveNoNormal);
+    CreatePermutation(PSByteCodeNoMrNoEmissiveNoNormal, PipelineStateNoMrNoEmissiveNoNormal);
+    CreatePermutation(PSByteCodeNoMrNoBaseColorNoEmissiveNoNormal, PipelineStateNoMrNoBaseColorNoEmissiveNoNormal);
+    CreatePermutation(PSByteCodeAlphaMask, PipelineStateAlphaMask);
+    CreatePermutation(PSByteCodeNoBaseColorAlphaMask, PipelineStateNoBaseColorAlphaMask);
+    CreatePermutation(PSByteCodeNoMrAlphaMask, PipelineStateNoMrAlphaMask);
+    CreatePermutation(PSByteCodeNoMrNoBaseColorAlphaMask, PipelineStateNoMrNoBaseColorAlphaMask);
+    CreatePermutation(PSByteCodeNoEmissiveAlphaMask, PipelineStateNoEmissiveAlphaMask);
+    CreatePermutation(PSByteCodeNoBaseColorNoEmissiveAlphaMask, PipelineStateNoBaseColorNoEmissiveAlphaMask);
+    CreatePermutation(PSByteCodeNoMrNoEmissiveAlphaMask, PipelineStateNoMrNoEmissiveAlphaMask);
+    CreatePermutation(PSByteCodeNoMrNoBaseColorNoEmissiveAlphaMask, PipelineStateNoMrNoBaseColorNoEmissiveAlphaMask);
+    CreatePermutation(PSByteCodeNoNormalAlphaMask, PipelineStateNoNormalAlphaMask);
+    CreatePermutation(PSByteCodeNoBaseColorNoNormalAlphaMask, PipelineStateNoBaseColorNoNormalAlphaMask);
+    CreatePermutation(PSByteCodeNoMrNoNormalAlphaMask, PipelineStateNoMrNoNormalAlphaMask);
+    CreatePermutation(PSByteCodeNoMrNoBaseColorNoNormalAlphaMask, PipelineStateNoMrNoBaseColorNoNormalAlphaMask);
+    CreatePermutation(PSByteCodeNoEmissiveNoNormalAlphaMask, PipelineStateNoEmissiveNoNormalAlphaMask);
+    CreatePermutation(PSByteCodeNoBaseColorNoEmissiveNoNormalAlphaMask, PipelineStateNoBaseColorNoEmissiveNoNormalAlphaMask);
+    CreatePermutation(PSByteCodeNoMrNoEmissiveNoNormalAlphaMask, PipelineStateNoMrNoEmissiveNoNormalAlphaMask);
+    CreatePermutation(PSByteCodeNoMrNoBaseColorNoEmissiveNoNormalAlphaMask, PipelineStateNoMrNoBaseColorNoEmissiveNoNormalAlphaMask);
 
     if (bDepthPrepassEnabled)
     {
         D3D12_GRAPHICS_PIPELINE_STATE_DESC DepthPrepassDesc = PsoDesc;
+        DepthPrepassDesc.InputLayout = RendererUtils::GetMeshPositionInputLayout();
+        DepthPrepassDesc.VS = { DepthOnlyVSByteCode.data(), DepthOnlyVSByteCode.size() };
         DepthPrepassDesc.PS = { nullptr, 0 };
         DepthPrepassDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = 0;
         DepthPrepassDesc.NumRenderTargets = 0;
         DepthPrepassDesc.RTVFormats[0] = DXGI_FORMAT_UNKNOWN;
 
-        HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&DepthPrepassDesc, IID_PPV_ARGS(DepthPrepassPipeline.GetAddressOf())));
+        HR_CHECK(Device->GetPipelineCache()->CreateGraphicsPipelineState(DepthPrepassDesc, DepthPrepassPipeline.ReleaseAndGetAddressOf()));
     }
 
     return true;
@@ -1440,99 +1559,172 @@ bool FForwardRenderer::CreateSceneTextures(FDX12Device* Device, const std::vecto
         return 0xff000000 | (B << 16) | (G << 8) | R;
     };
 
-    // Build load requests for all textures
-    for (size_t Index = 0; Index < Models.size(); ++Index)
+    if (bStreamSceneTextures)
     {
-        if (!Models[Index].BaseColorTexturePath.empty())
+        if (!StartSceneTextureStreaming(Device, Models))
         {
-            FTextureLoadRequest BaseColorRequest;
-            BaseColorRequest.Path = Models[Index].BaseColorTexturePath;
-            BaseColorRequest.bUseSolidColor = false;
-            BaseColorRequest.bUseSRGB = true;
-            BaseColorRequest.OutTexture = &LoadResults[Index].BaseColor;
-            Requests.push_back(BaseColorRequest);
+            return false;
         }
 
-        if (!Models[Index].MetallicRoughnessTexturePath.empty())
+        for (size_t Index = 0; Index < Models.size(); ++Index)
+        {
+            if (!Models[Index].NormalTexturePath.empty())
+            {
+                LoadResults[Index].Normal = FlatNormalTexture;
+            }
+            if (!Models[Index].EmissiveTexturePath.empty())
+            {
+                LoadResults[Index].Emissive = BlackTexture;
+            }
+        }
+    }
+    else
+    {
+        // Build load requests for all textures
+        for (size_t Index = 0; Index < Models.size(); ++Index)
         {
-            FTextureLoadRequest MetallicRoughnessRequest;
-            MetallicRoughnessRequest.Path = Models[Index].MetallicRoughnessTexturePath;
-            MetallicRoughnessRequest.bUseSolidColor = false;
-            MetallicRoughnessRequest.OutTexture = &LoadResults[Index].MetallicRoughness;
-            Requests.push_back(MetallicRoughnessRequest);
+            if (!Models[Index].BaseColorTexturePath.empty())
+            {
+                FTextureLoadRequest BaseColorRequest;
+                BaseColorRequest.Path = Models[Index].BaseColorTexturePath;
+                BaseColorRequest.bUseSolidColor = false;
+                BaseColorRequest.bUseSRGB = true;
+                BaseColorRequest.OutTexture = &LoadResults[Index].BaseColor;
+                Requests.push_back(BaseColorRequest);
+            }
+
+            if (!Models[Index].MetallicRoughnessTexturePath.empty())
+            {
+                FTextureLoadRequest MetallicRoughnessRequest;
+                MetallicRoughnessRequest.Path = Models[Index].MetallicRoughnessTexturePath;
+                MetallicRoughnessRequest.bUseSolidColor = false;
+                MetallicRoughnessRequest.OutTexture = &LoadResults[Index].MetallicRoughness;
+                Requests.push_back(MetallicRoughnessRequest);
+            }
+
+            if (!Models[Index].NormalTexturePath.empty())
+            {
+                FTextureLoadRequest NormalRequest;
+                NormalRequest.Path = Models[Index].NormalTexturePath;
+                NormalRequest.bUseSolidColor = false;
+                NormalRequest.bNormalMap = true;
+                NormalRequest.OutTexture = &LoadResults[Index].Normal;
+                Requests.push_back(NormalRequest);
+            }
+
+            if (!Models[Index].EmissiveTexturePath.empty())
+            {
+                FTextureLoadRequest EmissiveRequest;
+                EmissiveRequest.Path = Models[Index].EmissiveTexturePath;
+                EmissiveRequest.bUseSolidColor = false;
+                EmissiveRequest.bUseSRGB = true;
+                EmissiveRequest.OutTexture = &LoadResults[Index].Emissive;
+                Requests.push_back(EmissiveRequest);
+            }
         }
 
-        if (!Models[Index].NormalTexturePath.empty())
+        // Load all textures in parallel
+        LogInfo("Loading " + std::to_string(Requests.size()) + " textures in parallel for " + std::to_string(Models.size()) + " models");
+        if (!TextureLoader->LoadTexturesParallel(Requests))
         {
-            FTextureLoadRequest NormalRequest;
-            NormalRequest.Path = Models[Index].NormalTexturePath;
-            NormalRequest.bUseSolidColor = false;
-            NormalRequest.OutTexture = &LoadResults[Index].Normal;
-            Requests.push_back(NormalRequest);
+            LogError("Failed to load scene textures");
+            return false;
         }
 
-        if (!Models[Index].EmissiveTexturePath.empty())
+        for (size_t Index = 0; Index < Models.size(); ++Index)
         {
-            FTextureLoadRequest EmissiveRequest;
-            EmissiveRequest.Path = Models[Index].EmissiveTexturePath;
-            EmissiveRequest.bUseSolidColor = false;
-            EmissiveRequest.bUseSRGB = true;
-            EmissiveRequest.OutTexture = &LoadResults[Index].Emissive;
-            Requests.push_back(EmissiveRequest);
+            NameModelTextures(Index, LoadResults[Index].BaseColor.Get(), LoadResults[Index].MetallicRoughness.Get(), LoadResults[Index].Normal.Get(), LoadResults[Index].Emissive.Get());
         }
     }
 
-    // Load all textures in parallel
-    LogInfo("Loading " + std::to_string(Requests.size()) + " textures in parallel for " + std::to_string(Models.size()) + " models");
-    if (!TextureLoader->LoadTexturesParallel(Requests))
+    // Allocate SRVs from the shared descriptor heap
+    const uint32_t DescriptorCount = static_cast<uint32_t>(Models.size() * 7);
+    SceneTextureDescriptors = AllocatePersistentDescriptors(DescriptorCount);
+    if (DescriptorCount > 0 && !SceneTextureDescriptors.IsValid())
     {
-        LogError("Failed to load scene textures");
+        LogError("Failed to allocate scene texture descriptors");
         return false;
     }
+    TextureDescriptorHeap = Device->GetDescriptorAllocator()->GetHeap();
+
+    for (size_t Index = 0; Index < Models.size(); ++Index)
+    {
+        SceneTextures.push_back(LoadResults[Index].BaseColor);
+        SceneTextures.push_back(LoadResults[Index].MetallicRoughness);
+        SceneTextures.push_back(LoadResults[Index].Normal);
+        SceneTextures.push_back(LoadResults[Index].Emissive);
+
+        const uint32_t TableOffset = static_cast<uint32_t>(Index * 7);
+        WriteMaterialTable(Index, SceneTextureDescriptors.GetCpuHandle(TableOffset));
+        SceneModels[Index].TextureHandle = SceneTextureDescriptors.GetGpuHandle(TableOffset);
+        SceneModels[Index].MaterialDescriptorIndex = SceneTextureDescriptors.Offset + TableOffset;
+    }
 
-    // Create descriptor heap and SRVs
-    D3D12_DESCRIPTOR_HEAP_DESC HeapDesc = {};
-    HeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-    HeapDesc.NumDescriptors = static_cast<UINT>(Models.size() * 7);
-    HeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-    HR_CHECK(Device->GetDevice()->CreateDescriptorHeap(&HeapDesc, IID_PPV_ARGS(TextureDescriptorHeap.GetAddressOf())));
-    if (TextureDescriptorHeap)
+    SceneTextureGpuHandle = SceneTextureDescriptors.GpuStart;
+    return true;
+}
+
+void FForwardRenderer::NameModelTextures(size_t ModelIndex, ID3D12Resource* BaseColor, ID3D12Resource* MetallicRoughness, ID3D12Resource* Normal, ID3D12Resource* Emissive)
+{
+    if (BaseColor)
     {
-        TextureDescriptorHeap->SetName(L"TextureDescriptorHeap");
+        const std::wstring Name = L"BaseColorTexture_" + std::to_wstring(ModelIndex);
+        BaseColor->SetName(Name.c_str());
     }
+    if (MetallicRoughness)
+    {
+        const std::wstring Name = L"MetallicRoughnessTexture_" + std::to_wstring(ModelIndex);
+        MetallicRoughness->SetName(Name.c_str());
+    }
+    if (Normal)
+    {
+        const std::wstring Name = L"NormalTexture_" + std::to_wstring(ModelIndex);
+        Normal->SetName(Name.c_str());
+    }
+    if (Emissive)
+    {
+        const std::wstring Name = L"EmissiveTexture_" + std::to_wstring(ModelIndex);
+        Emissive->SetName(Name.c_str());
+    }
+}
 
-    const UINT DescriptorSize = Device->GetDevice()->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-    D3D12_CPU_DESCRIPTOR_HANDLE CpuHandle = TextureDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
-    D3D12_GPU_DESCRIPTOR_HANDLE GpuHandle = TextureDescriptorHeap->GetGPUDescriptorHandleForHeapStart();
+void FForwardRenderer::WriteMaterialTable(size_t ModelIndex, D3D12_CPU_DESCRIPTOR_HANDLE CpuHandle) const
+{
+    const UINT DescriptorSize = Device->GetDescriptorAllocator()->GetDescriptorSize();
 
-    const auto CreateSceneTextureSrv = [&](ID3D12Resource* Texture)
+    for (size_t Slot = 0; Slot < 4; ++Slot)
     {
+        ID3D12Resource* Texture = SceneTextures[ModelIndex * 4 + Slot].Get();
         ID3D12Resource* Resource = Texture ? Texture : NullTexture.Get();
-        if (!Resource)
+        if (Resource)
         {
-            return;
-        }
+            const D3D12_RESOURCE_DESC TextureDesc = Resource->GetDesc();
 
-        const D3D12_RESOURCE_DESC TextureDesc = Resource->GetDesc();
+            D3D12_SHADER_RESOURCE_VIEW_DESC SrvDesc = {};
+            SrvDesc.Format = TextureDesc.Format;
+            SrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+            SrvDesc.Shader4ComponentMapping = RendererUtils::GetTextureComponentMapping(TextureDesc.Format);
+            SrvDesc.Texture2D.MipLevels = TextureDesc.MipLevels;
+            SrvDesc.Texture2D.MostDetailedMip = 0;
+            SrvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
 
-        D3D12_SHADER_RESOURCE_VIEW_DESC SrvDesc = {};
-        SrvDesc.Format = TextureDesc.Format;
-        SrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-        SrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        SrvDesc.Texture2D.MipLevels = TextureDesc.MipLevels;
-        SrvDesc.Texture2D.MostDetailedMip = 0;
-        SrvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
+            Device->GetDevice()->CreateShaderResourceView(Resource, &SrvDesc, CpuHandle);
+        }
 
-        Device->GetDevice()->CreateShaderResourceView(Resource, &SrvDesc, CpuHandle);
-    };
+        CpuHandle.ptr += DescriptorSize;
+    }
 
     D3D12_SHADER_RESOURCE_VIEW_DESC ShadowSrvDesc = {};
     ShadowSrvDesc.Format = DXGI_FORMAT_R32_FLOAT;
-    ShadowSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    ShadowSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
     ShadowSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-    ShadowSrvDesc.Texture2D.MipLevels = 1;
-    ShadowSrvDesc.Texture2D.MostDetailedMip = 0;
-    ShadowSrvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
+    ShadowSrvDesc.Texture2DArray.MipLevels = 1;
+    ShadowSrvDesc.Texture2DArray.MostDetailedMip = 0;
+    ShadowSrvDesc.Texture2DArray.ArraySize = FShadowCascades::CascadeCount;
+    ShadowSrvDesc.Texture2DArray.ResourceMinLODClamp = 0.0f;
+
+    Device->GetDevice()->CreateShaderResourceView(ShadowMap.Get(), &ShadowSrvDesc, CpuHandle);
+    CpuHandle.ptr += DescriptorSize;
 
     D3D12_SHADER_RESOURCE_VIEW_DESC EnvSrvDesc = {};
     EnvSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBE;
@@ -1542,6 +1734,9 @@ bool FForwardRenderer::CreateSceneTextures(FDX12Device* Device, const std::vecto
     EnvSrvDesc.TextureCube.MostDetailedMip = 0;
     EnvSrvDesc.TextureCube.ResourceMinLODClamp = 0.0f;
 
+    Device->GetDevice()->CreateShaderResourceView(EnvironmentCubeTexture.Get(), &EnvSrvDesc, CpuHandle);
+    CpuHandle.ptr += DescriptorSize;
+
     D3D12_SHADER_RESOURCE_VIEW_DESC BrdfSrvDesc = {};
     BrdfSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
     BrdfSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
@@ -1550,150 +1745,154 @@ bool FForwardRenderer::CreateSceneTextures(FDX12Device* Device, const std::vecto
     BrdfSrvDesc.Texture2D.MostDetailedMip = 0;
     BrdfSrvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
 
-    for (size_t Index = 0; Index < Models.size(); ++Index)
-    {
-        SceneTextures.push_back(LoadResults[Index].BaseColor);
-        if (LoadResults[Index].BaseColor)
-        {
-            const std::wstring Name = L"BaseColorTexture_" + std::to_wstring(Index);
-            LoadResults[Index].BaseColor->SetName(Name.c_str());
-        }
-        CreateSceneTextureSrv(LoadResults[Index].BaseColor.Get());
-        SceneModels[Index].TextureHandle = GpuHandle;
-
-        CpuHandle.ptr += DescriptorSize;
-        GpuHandle.ptr += DescriptorSize;
-
-        SceneTextures.push_back(LoadResults[Index].MetallicRoughness);
-        if (LoadResults[Index].MetallicRoughness)
-        {
-            const std::wstring Name = L"MetallicRoughnessTexture_" + std::to_wstring(Index);
-            LoadResults[Index].MetallicRoughness->SetName(Name.c_str());
-        }
-        CreateSceneTextureSrv(LoadResults[Index].MetallicRoughness.Get());
-
-        CpuHandle.ptr += DescriptorSize;
-        GpuHandle.ptr += DescriptorSize;
-
-        SceneTextures.push_back(LoadResults[Index].Normal);
-        if (LoadResults[Index].Normal)
-        {
-            const std::wstring Name = L"NormalTexture_" + std::to_wstring(Index);
-            LoadResults[Index].Normal->SetName(Name.c_str());
-        }
-        CreateSceneTextureSrv(LoadResults[Index].Normal.Get());
-
-        CpuHandle.ptr += DescriptorSize;
-        GpuHandle.ptr += DescriptorSize;
-
-        SceneTextures.push_back(LoadResults[Index].Emissive);
-        if (LoadResults[Index].Emissive)
-        {
-            const std::wstring Name = L"EmissiveTexture_" + std::to_wstring(Index);
-            LoadResults[Index].Emissive->SetName(Name.c_str());
-        }
-        CreateSceneTextureSrv(LoadResults[Index].Emissive.Get());
-
-        CpuHandle.ptr += DescriptorSize;
-        GpuHandle.ptr += DescriptorSize;
-
-        Device->GetDevice()->CreateShaderResourceView(ShadowMap.Get(), &ShadowSrvDesc, CpuHandle);
-
-        CpuHandle.ptr += DescriptorSize;
-        GpuHandle.ptr += DescriptorSize;
-
-        Device->GetDevice()->CreateShaderResourceView(EnvironmentCubeTexture.Get(), &EnvSrvDesc, CpuHandle);
-
-        CpuHandle.ptr += DescriptorSize;
-        GpuHandle.ptr += DescriptorSize;
+    Device->GetDevice()->CreateShaderResourceView(BrdfLutTexture.Get(), &BrdfSrvDesc, CpuHandle);
+}
 
-        Device->GetDevice()->CreateShaderResourceView(BrdfLutTexture.Get(), &BrdfSrvDesc, CpuHandle);
+void FForwardRenderer::OnSceneTexturesResident(FStreamedModelTextures& Textures)
+{
+    const size_t ModelIndex = Textures.ModelIndex;
+    if (ModelIndex * 4 + 3 >= SceneTextures.size())
+    {
+        return;
+    }
 
-        CpuHandle.ptr += DescriptorSize;
-        GpuHandle.ptr += DescriptorSize;
+    const FDX12DescriptorRange Table = AllocateStreamedMaterialTable(Textures.ModelIndex, 7);
+    if (!Table.IsValid())
+    {
+        LogWarning("Failed to allocate a streamed material table for scene model " + std::to_string(ModelIndex));
+        return;
     }
 
-    SceneTextureGpuHandle = TextureDescriptorHeap->GetGPUDescriptorHandleForHeapStart();
-    return true;
+    NameModelTextures(ModelIndex, Textures.BaseColor.Get(), Textures.MetallicRoughness.Get(), Textures.Normal.Get(), Textures.Emissive.Get());
+    SceneTextures[ModelIndex * 4 + 0] = std::move(Textures.BaseColor);
+    SceneTextures[ModelIndex * 4 + 1] = std::move(Textures.MetallicRoughness);
+    SceneTextures[ModelIndex * 4 + 2] = std::move(Textures.Normal);
+    SceneTextures[ModelIndex * 4 + 3] = std::move(Textures.Emissive);
+
+    WriteMaterialTable(ModelIndex, Table.GetCpuHandle(0));
+    SceneModels[ModelIndex].TextureHandle = Table.GetGpuHandle(0);
+    SceneModels[ModelIndex].MaterialDescriptorIndex = Table.Offset;
 }
 
 bool FForwardRenderer::CreateGpuDrivenResources(FDX12Device* Device)
 {
-    if (!Device || SceneModels.empty() || !GetSceneConstantBuffer())
+    if (!Device || SceneModels.empty() || !SceneObjectBuffer)
     {
         return false;
     }
 
+    const bool bSharedGeometry = std::all_of(SceneModels.begin(), SceneModels.end(), [this](const FSceneModelResource& Model)
+    {
+        return Model.Geometry.VertexBuffer == SceneModels.front().Geometry.VertexBuffer
+            && Model.Geometry.IndexBuffer == SceneModels.front().Geometry.IndexBuffer;
+    });
+    if (!bSharedGeometry)
+    {
+        LogWarning("Scene models do not share one geometry buffer; indirect draws disabled");
+        return false;
+    }
+
     IndirectDrawRanges.clear();
 
-    std::vector<uint32_t> SortedIndices(SceneModels.size());
-    for (uint32_t Index = 0; Index < SortedIndices.size(); ++Index)
+    // Instances of one mesh section sort next to each other so they fall into one group; the
+    // material field stays empty because instances with equal texture paths still have their own
+    // tables, and the stable sort keeps scene order among equal keys.
+    FDrawList IndirectDrawList;
+    IndirectDrawList.Reserve(SceneModels.size());
+    for (uint32_t Index = 0; Index < SceneModels.size(); ++Index)
     {
-        SortedIndices[Index] = Index;
+        const uint32_t PipelineKey = ResolveMaterialPipelineKey(RendererUtils::BuildMaterialPipelineKey(SceneModels[Index]));
+        IndirectDrawList.Add(FDrawList::BuildSortKey(PipelineKey, 0, 0, SceneModels[Index].DrawIndexStart), Index);
     }
+    IndirectDrawList.Sort();
 
-    std::sort(SortedIndices.begin(), SortedIndices.end(), [&](uint32_t A, uint32_t B)
+    std::vector<uint32_t> SortedIndices;
+    SortedIndices.reserve(SceneModels.size());
+    for (const FDrawListEntry& Entry : IndirectDrawList.GetEntries())
     {
-        const FSceneModelResource& ModelA = SceneModels[A];
-        const FSceneModelResource& ModelB = SceneModels[B];
-        const uint32_t KeyA = BuildPipelineKey(ModelA);
-        const uint32_t KeyB = BuildPipelineKey(ModelB);
-        if (KeyA != KeyB)
-        {
-            return KeyA < KeyB;
-        }
-        return ModelA.TextureHandle.ptr < ModelB.TextureHandle.ptr;
-    });
+        SortedIndices.push_back(Entry.ModelIndex);
+    }
 
     std::vector<FIndirectDrawCommand> Commands;
     Commands.reserve(SceneModels.size());
 
-    std::vector<DirectX::XMFLOAT4> Bounds;
-    Bounds.reserve(SceneModels.size() * 2);
+    std::vector<FModelCullingData> Bounds(SceneModels.size());
+    uint32_t VisibleInstanceSlotCount = 0;
+    IndirectInstanceGroupCount = 0;
 
-    const D3D12_GPU_VIRTUAL_ADDRESS ConstantBufferBase = GetSceneConstantBufferAddress();
-    auto AppendIndirectDrawData = [&](uint32_t SortedIndex)
+    // Models that share a mesh section and material become one instance group drawn by one command
+    // per LOD; culling appends each visible member to the command of the LOD it selects, so every
+    // command reserves a slot for every member.
+    auto AppendIndirectDrawData = [&](size_t GroupBegin, size_t GroupEnd)
     {
+        const uint32_t SortedIndex = SortedIndices[GroupBegin];
         const FSceneModelResource& Model = SceneModels[SortedIndex];
-        const uint32_t PipelineKey = BuildPipelineKey(Model);
+        const uint32_t PipelineKey = ResolveMaterialPipelineKey(RendererUtils::BuildMaterialPipelineKey(Model));
+        const D3D12_GPU_DESCRIPTOR_HANDLE MaterialTable = ResolveMaterialTable(Model);
 
         if (IndirectDrawRanges.empty()
             || IndirectDrawRanges.back().PipelineKey != PipelineKey
-            || IndirectDrawRanges.back().TextureHandle.ptr != Model.TextureHandle.ptr)
+            || IndirectDrawRanges.back().TextureHandle.ptr != MaterialTable.ptr)
         {
             FIndirectDrawRange Range;
             Range.Start = static_cast<uint32_t>(Commands.size());
             Range.Count = 0;
             Range.PipelineKey = PipelineKey;
-            Range.TextureHandle = Model.TextureHandle;
-            if (!Model.Name.empty())
+            Range.TextureHandle = MaterialTable;
+            if (bBindlessMaterials)
+            {
+                Range.Name = (PipelineKey & MaterialAlphaMaskKey) != 0 ? L"BindlessMasked" : L"BindlessOpaque";
+            }
+            else if (!Model.Name.empty())
             {
                 Range.Name.assign(Model.Name.begin(), Model.Name.end());
             }
             IndirectDrawRanges.push_back(Range);
         }
 
-        FIndirectDrawCommand Command = {};
-        Command.VertexBufferView = Model.Geometry.VertexBufferView;
-        Command.IndexBufferView = Model.Geometry.IndexBufferView;
-        Command.ConstantBufferAddress = ConstantBufferBase + SceneConstantBufferStride * SortedIndex;
-        Command.DrawArguments.IndexCountPerInstance = Model.DrawIndexCount;
-        Command.DrawArguments.InstanceCount = 1;
-        Command.DrawArguments.StartIndexLocation = Model.DrawIndexStart;
-        Command.DrawArguments.BaseVertexLocation = 0;
-        Command.DrawArguments.StartInstanceLocation = SortedIndex;
-        Commands.push_back(Command);
-        Bounds.emplace_back(Model.BoundsMin.x, Model.BoundsMin.y, Model.BoundsMin.z, 0.0f);
-        Bounds.emplace_back(Model.BoundsMax.x, Model.BoundsMax.y, Model.BoundsMax.z, 0.0f);
-        IndirectDrawRanges.back().Count += 1;
+        const uint32_t GroupSize = static_cast<uint32_t>(GroupEnd - GroupBegin);
+        const uint32_t CommandStart = static_cast<uint32_t>(Commands.size());
+        const FModelCullingData GroupCulling = RendererUtils::BuildModelCullingData(Model);
+        for (uint32_t LodIndex = 0; LodIndex < GroupCulling.LodCount; ++LodIndex)
+        {
+            FIndirectDrawCommand Command = {};
+            Command.InstanceBase = VisibleInstanceSlotCount;
+            Command.DrawArguments.IndexCountPerInstance = GroupCulling.Lods[LodIndex].IndexCount;
+            Command.DrawArguments.InstanceCount = 0;
+            Command.DrawArguments.StartIndexLocation = GroupCulling.Lods[LodIndex].IndexStart;
+            Command.DrawArguments.BaseVertexLocation = 0;
+            Command.DrawArguments.StartInstanceLocation = 0;
+            Commands.push_back(Command);
+            VisibleInstanceSlotCount += GroupSize;
+        }
+
+        for (size_t MemberIndex = GroupBegin; MemberIndex < GroupEnd; ++MemberIndex)
+        {
+            const uint32_t ModelIndex = SortedIndices[MemberIndex];
+            Bounds[ModelIndex] = RendererUtils::BuildModelCullingData(SceneModels[ModelIndex]);
+            Bounds[ModelIndex].CommandStart = CommandStart;
+        }
+
+        IndirectDrawRanges.back().Count += GroupCulling.LodCount;
+        ++IndirectInstanceGroupCount;
     };
 
-    for (uint32_t SortedIndex : SortedIndices)
+    for (size_t GroupBegin = 0; GroupBegin < SortedIndices.size();)
     {
-        AppendIndirectDrawData(SortedIndex);
+        size_t GroupEnd = GroupBegin + 1;
+        while (GroupEnd < SortedIndices.size()
+            && ResolveMaterialPipelineKey(RendererUtils::BuildMaterialPipelineKey(SceneModels[SortedIndices[GroupEnd]])) == ResolveMaterialPipelineKey(RendererUtils::BuildMaterialPipelineKey(SceneModels[SortedIndices[GroupBegin]]))
+            && RendererUtils::CanShareInstancedDraw(SceneModels[SortedIndices[GroupBegin]], SceneModels[SortedIndices[GroupEnd]]))
+        {
+            ++GroupEnd;
+        }
+        AppendIndirectDrawData(GroupBegin, GroupEnd);
+        GroupBegin = GroupEnd;
     }
 
     IndirectCommandCount = static_cast<uint32_t>(Commands.size());
+    IndirectInstanceCount = static_cast<uint32_t>(SceneModels.size());
+    LogInfo("Indirect draws: " + std::to_string(IndirectInstanceCount) + " models in " + std::to_string(IndirectInstanceGroupCount) + " instance groups, " + std::to_string(IndirectCommandCount) + " commands");
 
     const uint64_t CommandBufferSize = sizeof(FIndirectDrawCommand) * Commands.size();
 
@@ -1730,7 +1929,8 @@ bool FForwardRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     IndirectCommandUploads.resize(GetFramesInFlight());
     for (uint32_t FrameIndex = 0; FrameIndex < GetFramesInFlight(); ++FrameIndex)
     {
-        HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::Buffer,
             &DefaultHeap,
             D3D12_HEAP_FLAG_NONE,
             &BufferDesc,
@@ -1743,7 +1943,8 @@ bool FForwardRenderer::CreateGpuDrivenResources(FDX12Device* Device)
             IndirectCommandBuffers[FrameIndex]->SetName(Name.c_str());
         }
 
-        HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::Upload,
             &UploadHeap,
             D3D12_HEAP_FLAG_NONE,
             &UploadDesc,
@@ -1755,29 +1956,22 @@ bool FForwardRenderer::CreateGpuDrivenResources(FDX12Device* Device)
         {
             void* UploadData = nullptr;
             HR_CHECK(IndirectCommandUploads[FrameIndex]->Map(0, &EmptyRange, &UploadData));
-            std::vector<FIndirectDrawCommand> FrameCommands = Commands;
-            const D3D12_GPU_VIRTUAL_ADDRESS ConstantBufferBase = SceneConstantBuffers[FrameIndex]
-                ? SceneConstantBuffers[FrameIndex]->GetGPUVirtualAddress()
-                : 0;
-            for (uint32_t CommandIndex = 0; CommandIndex < FrameCommands.size(); ++CommandIndex)
-            {
-                const uint32_t InstanceIndex = FrameCommands[CommandIndex].DrawArguments.StartInstanceLocation;
-                FrameCommands[CommandIndex].ConstantBufferAddress =
-                    ConstantBufferBase + SceneConstantBufferStride * InstanceIndex;
-            }
-            std::memcpy(UploadData, FrameCommands.data(), CommandBufferSize);
+            std::memcpy(UploadData, Commands.data(), CommandBufferSize);
             IndirectCommandUploads[FrameIndex]->Unmap(0, nullptr);
         }
     }
 
-    const uint64_t BoundsBufferSize = sizeof(DirectX::XMFLOAT4) * Bounds.size();
+    const uint64_t BoundsBufferSize = sizeof(FModelCullingData) * Bounds.size();
     D3D12_RESOURCE_DESC BoundsDesc = BufferDesc;
     BoundsDesc.Width = BoundsBufferSize;
-    BoundsDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+    // Moved models are written by Shaders/SceneScatter.hlsl.
+    BoundsDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
 
     D3D12_RESOURCE_DESC BoundsUploadDesc = BoundsDesc;
+    BoundsUploadDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Buffer,
         &DefaultHeap,
         D3D12_HEAP_FLAG_NONE,
         &BoundsDesc,
@@ -1789,7 +1983,8 @@ bool FForwardRenderer::CreateGpuDrivenResources(FDX12Device* Device)
         ModelBoundsBuffer->SetName(L"ModelBoundsBuffer");
     }
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Upload,
         &UploadHeap,
         D3D12_HEAP_FLAG_NONE,
         &BoundsUploadDesc,
@@ -1805,12 +2000,46 @@ bool FForwardRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     HR_CHECK(ModelBoundsUpload->Map(0, &EmptyRange, &UploadData));
     std::memcpy(UploadData, Bounds.data(), BoundsBufferSize);
     ModelBoundsUpload->Unmap(0, nullptr);
+    ModelCullingCpuData = Bounds;
+
+    // Written by culling every frame before any draw reads it, so it needs no initial data.
+    D3D12_RESOURCE_DESC VisibleInstanceDesc = BufferDesc;
+    VisibleInstanceDesc.Width = sizeof(uint32_t) * static_cast<uint64_t>((std::max)(VisibleInstanceSlotCount, 1u));
+    VisibleInstanceBuffers.clear();
+    VisibleInstanceBuffers.resize(GetFramesInFlight());
+    VisibleInstanceStates.assign(GetFramesInFlight(), D3D12_RESOURCE_STATE_COMMON);
+    for (uint32_t FrameIndex = 0; FrameIndex < GetFramesInFlight(); ++FrameIndex)
+    {
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::Buffer,
+            &DefaultHeap,
+            D3D12_HEAP_FLAG_NONE,
+            &VisibleInstanceDesc,
+            D3D12_RESOURCE_STATE_COMMON,
+            nullptr,
+            IID_PPV_ARGS(VisibleInstanceBuffers[FrameIndex].GetAddressOf())));
+        if (VisibleInstanceBuffers[FrameIndex])
+        {
+            const std::wstring Name = L"VisibleInstanceBuffer_Frame" + std::to_wstring(FrameIndex);
+            VisibleInstanceBuffers[FrameIndex]->SetName(Name.c_str());
+        }
+    }
+
+    if (!CreateIndirectCompactionResources(Device, 1))
+    {
+        return false;
+    }
+    if (!CreateShadowCullingResources(Device, Commands.data(), VisibleInstanceSlotCount))
+    {
+        return false;
+    }
 
     D3D12_RESOURCE_DESC DebugDesc = BufferDesc;
     DebugDesc.Width = GpuDebugPrintBufferSize;
     DebugDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Buffer,
         &DefaultHeap,
         D3D12_HEAP_FLAG_NONE,
         &DebugDesc,
@@ -1833,7 +2062,8 @@ bool FForwardRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     DebugUploadDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
     DebugUploadDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Upload,
         &UploadHeap,
         D3D12_HEAP_FLAG_NONE,
         &DebugUploadDesc,
@@ -1854,7 +2084,7 @@ bool FForwardRenderer::CreateGpuDrivenResources(FDX12Device* Device)
 
     D3D12_RESOURCE_DESC StatsDesc = {};
     StatsDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    StatsDesc.Width = sizeof(uint32_t) * 2;
+    StatsDesc.Width = GpuDebugPrintStatsSize;
     StatsDesc.Height = 1;
     StatsDesc.DepthOrArraySize = 1;
     StatsDesc.MipLevels = 1;
@@ -1863,7 +2093,8 @@ bool FForwardRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     StatsDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
     StatsDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Buffer,
         &DefaultHeap,
         D3D12_HEAP_FLAG_NONE,
         &StatsDesc,
@@ -1877,7 +2108,8 @@ bool FForwardRenderer::CreateGpuDrivenResources(FDX12Device* Device)
 
     D3D12_RESOURCE_DESC StatsUploadDesc = StatsDesc;
     StatsUploadDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Upload,
         &UploadHeap,
         D3D12_HEAP_FLAG_NONE,
         &StatsUploadDesc,
@@ -1891,7 +2123,7 @@ bool FForwardRenderer::CreateGpuDrivenResources(FDX12Device* Device)
         HR_CHECK(GpuDebugPrintStatsUpload->Map(0, &EmptyRange, &StatsUploadData));
         if (StatsUploadData)
         {
-            std::memset(StatsUploadData, 0, sizeof(uint32_t) * 2);
+            std::memset(StatsUploadData, 0, GpuDebugPrintStatsSize);
         }
         GpuDebugPrintStatsUpload->Unmap(0, nullptr);
     }
@@ -1961,7 +2193,7 @@ bool FForwardRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     }
     if (GpuDebugPrintStatsBuffer && GpuDebugPrintStatsUpload)
     {
-        UploadList->CopyBufferRegion(GpuDebugPrintStatsBuffer.Get(), 0, GpuDebugPrintStatsUpload.Get(), 0, sizeof(uint32_t) * 2);
+        UploadList->CopyBufferRegion(GpuDebugPrintStatsBuffer.Get(), 0, GpuDebugPrintStatsUpload.Get(), 0, GpuDebugPrintStatsSize);
     }
 
     std::vector<D3D12_RESOURCE_BARRIER> PostCopyBarriers;
@@ -2009,15 +2241,15 @@ bool FForwardRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     Device->GetGraphicsQueue()->Flush();
 
     IndirectCommandStates.assign(GetFramesInFlight(), D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+    ModelBoundsState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
     GpuDebugPrintState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
     GpuDebugPrintStatsState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
 
-    D3D12_ROOT_PARAMETER RootParams[6] = {};
-    // RootParams[0]: cbuffer CullingConstants (frustum planes, view-projection, HZB settings, debug toggle)
-    RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
-    RootParams[0].Constants.ShaderRegister = 0;
-    RootParams[0].Constants.RegisterSpace = 0;
-    RootParams[0].Constants.Num32BitValues = 46;
+    D3D12_ROOT_PARAMETER RootParams[10] = {};
+    // RootParams[0]: cbuffer CullingConstants (frustum planes, view-projection, HZB settings, debug toggle, LOD selection, culling phase, compaction, screen coverage)
+    RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    RootParams[0].Descriptor.ShaderRegister = 0;
+    RootParams[0].Descriptor.RegisterSpace = 0;
     RootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
 
     // RootParams[1]: SRV ModelBounds buffer (t0)
@@ -2057,6 +2289,30 @@ bool FForwardRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     RootParams[5].DescriptorTable.pDescriptorRanges = &HZBRange;
     RootParams[5].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
 
+    // RootParams[6]: UAV VisibleInstances buffer (u3)
+    RootParams[6].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    RootParams[6].Descriptor.ShaderRegister = 3;
+    RootParams[6].Descriptor.RegisterSpace = 0;
+    RootParams[6].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    // RootParams[7]: UAV InstanceVisibility buffer (u4)
+    RootParams[7].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    RootParams[7].Descriptor.ShaderRegister = 4;
+    RootParams[7].Descriptor.RegisterSpace = 0;
+    RootParams[7].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    // RootParams[8]: SRV CommandRanges buffer (t2)
+    RootParams[8].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    RootParams[8].Descriptor.ShaderRegister = 2;
+    RootParams[8].Descriptor.RegisterSpace = 0;
+    RootParams[8].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    // RootParams[9]: UAV CompactedArgs buffer (u5)
+    RootParams[9].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    RootParams[9].Descriptor.ShaderRegister = 5;
+    RootParams[9].Descriptor.RegisterSpace = 0;
+    RootParams[9].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
     D3D12_ROOT_SIGNATURE_DESC RootDesc = {};
     RootDesc.NumParameters = _countof(RootParams);
     RootDesc.pParameters = RootParams;
@@ -2065,7 +2321,7 @@ bool FForwardRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     ComPtr<ID3DBlob> SerializedSig;
     ComPtr<ID3DBlob> ErrorBlob;
     HR_CHECK(D3D12SerializeRootSignature(&RootDesc, D3D_ROOT_SIGNATURE_VERSION_1, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf()));
-    HR_CHECK(Device->GetDevice()->CreateRootSignature(0, SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), IID_PPV_ARGS(CullingRootSignature.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), CullingRootSignature.ReleaseAndGetAddressOf()));
 
     FShaderCompiler Compiler;
     std::vector<uint8_t> CsByteCode;
@@ -2078,15 +2334,34 @@ bool FForwardRenderer::CreateGpuDrivenResources(FDX12Device* Device)
     D3D12_COMPUTE_PIPELINE_STATE_DESC CsDesc = {};
     CsDesc.pRootSignature = CullingRootSignature.Get();
     CsDesc.CS = { CsByteCode.data(), CsByteCode.size() };
-    HR_CHECK(Device->GetDevice()->CreateComputePipelineState(&CsDesc, IID_PPV_ARGS(CullingPipeline.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateComputePipelineState(CsDesc, CullingPipeline.ReleaseAndGetAddressOf()));
+
+    std::vector<uint8_t> ResetByteCode;
+    if (!Compiler.CompileFromFile(L"Shaders/CullIndirectArgs.hlsl", L"CSResetInstanceCounts", L"cs_6_0", ResetByteCode))
+    {
+        LogError("Failed to compile culling reset compute shader");
+        return false;
+    }
+
+    CsDesc.CS = { ResetByteCode.data(), ResetByteCode.size() };
+    HR_CHECK(Device->GetPipelineCache()->CreateComputePipelineState(CsDesc, CullingResetPipeline.ReleaseAndGetAddressOf()));
+
+    std::vector<uint8_t> CompactByteCode;
+    if (!Compiler.CompileFromFile(L"Shaders/CullIndirectArgs.hlsl", L"CSCompactCommands", L"cs_6_0", CompactByteCode))
+    {
+        LogError("Failed to compile culling compaction compute shader");
+        return false;
+    }
+
+    CsDesc.CS = { CompactByteCode.data(), CompactByteCode.size() };
+    HR_CHECK(Device->GetPipelineCache()->CreateComputePipelineState(CsDesc, CullingCompactPipeline.ReleaseAndGetAddressOf()));
 
-    D3D12_INDIRECT_ARGUMENT_DESC IndirectArgs[4] = {};
-    IndirectArgs[0].Type = D3D12_INDIRECT_ARGUMENT_TYPE_VERTEX_BUFFER_VIEW;
-    IndirectArgs[0].VertexBuffer.Slot = 0;
-    IndirectArgs[1].Type = D3D12_INDIRECT_ARGUMENT_TYPE_INDEX_BUFFER_VIEW;
-    IndirectArgs[2].Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT_BUFFER_VIEW;
-    IndirectArgs[2].ConstantBufferView.RootParameterIndex = 0;
-    IndirectArgs[3].Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
+    D3D12_INDIRECT_ARGUMENT_DESC IndirectArgs[2] = {};
+    IndirectArgs[0].Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT;
+    IndirectArgs[0].Constant.RootParameterIndex = SceneInstanceRootParameter;
+    IndirectArgs[0].Constant.DestOffsetIn32BitValues = 0;
+    IndirectArgs[0].Constant.Num32BitValuesToSet = 1;
+    IndirectArgs[1].Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
 
     D3D12_COMMAND_SIGNATURE_DESC CommandDesc = {};
     CommandDesc.pArgumentDescs = IndirectArgs;
@@ -2121,36 +2396,3 @@ bool FForwardRenderer::CreateObjectIdPipeline(FDX12Device* Device)
     return RendererUtils::CreateObjectIdPipeline(Device, RootSignature.Get(), ObjectIdPipeline);
 }
 
-void FForwardRenderer::UpdateSceneConstants(const FCamera& Camera, const FSceneModelResource& Model, uint64_t ConstantBufferOffset, const DirectX::XMMATRIX& LightViewProjection)
-{
-    const DirectX::XMVECTOR LightDir = DirectX::XMLoadFloat3(&LightDirection);
-
-    RendererUtils::UpdateSceneConstants(
-        Camera,
-        Model,
-        LightIntensity,
-        LightDir,
-        LightColor,
-        LightViewProjection,
-        Camera.GetProjectionMatrix(),
-        bShadowsEnabled ? ShadowStrength : 0.0f,
-        ShadowBias,
-        static_cast<float>(ShadowMapWidth),
-        static_cast<float>(ShadowMapHeight),
-        EnvironmentMipCount,
-        GetSceneConstantBufferMapped(),
-        ConstantBufferOffset);
-}
-
-void FForwardRenderer::UpdateSkyConstants(const FCamera& Camera)
-{
-    using namespace DirectX;
-
-    const FFloat3 CameraPosition = Camera.GetPosition();
-    const XMMATRIX Scale = XMMatrixScaling(SkySphereRadius, SkySphereRadius, SkySphereRadius);
-    const XMMATRIX Translation = XMMatrixTranslation(CameraPosition.x, CameraPosition.y, CameraPosition.z);
-    const XMMATRIX World = Scale * Translation;
-
-    const XMVECTOR LightDir = XMLoadFloat3(&LightDirection);
-    RendererUtils::UpdateSkyConstants(Camera, World, Camera.GetProjectionMatrix(), LightDir, LightColor, SkyConstantBufferMapped);
-}
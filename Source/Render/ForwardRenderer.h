@@ -36,14 +36,16 @@ private:
     bool CreateObjectIdResources(FDX12Device* Device, uint32_t Width, uint32_t Height);
     bool CreateObjectIdPipeline(FDX12Device* Device);
     bool CreateSceneTextures(FDX12Device* Device, const std::vector<FSceneModelResource>& Models);
+    // Writes a model's seven-slot table: its four maps from SceneTextures, then shadow map,
+    // environment cube and BRDF LUT.
+    void WriteMaterialTable(size_t ModelIndex, D3D12_CPU_DESCRIPTOR_HANDLE CpuHandle) const;
+    void OnSceneTexturesResident(FStreamedModelTextures& Textures) override;
+    static void NameModelTextures(size_t ModelIndex, ID3D12Resource* BaseColor, ID3D12Resource* MetallicRoughness, ID3D12Resource* Normal, ID3D12Resource* Emissive);
     bool CreateGpuDrivenResources(FDX12Device* Device);
-    void UpdateSceneConstants(const FCamera& Camera, const FSceneModelResource& Model, uint64_t ConstantBufferOffset, const DirectX::XMMATRIX& LightViewProjection);
-    void UpdateSkyConstants(const FCamera& Camera);
     void UpdateCullingVisibility(const FCamera& Camera);
 
 private:
     Microsoft::WRL::ComPtr<ID3D12RootSignature> RootSignature;
-    Microsoft::WRL::ComPtr<ID3D12RootSignature> SkyRootSignature;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> PipelineState;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> PipelineStateNoBaseColor;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> PipelineStateNoMr;
@@ -78,13 +80,12 @@ private:
     Microsoft::WRL::ComPtr<ID3D12PipelineState> PipelineStateNoMrNoBaseColorNoEmissiveNoNormalAlphaMask;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> DepthPrepassPipeline;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> ShadowPipeline;
-    Microsoft::WRL::ComPtr<ID3D12PipelineState> SkyPipelineState;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> ObjectIdPipeline;
     std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> SceneTextures;
     Microsoft::WRL::ComPtr<ID3D12Resource> SceneTexture;
+    // The device's shared heap; SceneTextureDescriptors is this renderer's persistent range in it.
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> TextureDescriptorHeap;
-    FMeshGeometryBuffers SkyGeometry;
-    float SkySphereRadius = 1000.0f;
+    FDX12DescriptorRange SceneTextureDescriptors;
 
     D3D12_GPU_DESCRIPTOR_HANDLE SceneTextureGpuHandle{};
 };
@@ -0,0 +1,220 @@
+#include "ImageWriter.h"
+
+#include "../Core/Logger.h"
+#include "../RHI/DX12Commons.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#include <wincodec.h>
+
+namespace
+{
+    std::string ToUtf8(const std::wstring& Path)
+    {
+        const auto Utf8 = std::filesystem::path(Path).u8string();
+        return std::string(Utf8.begin(), Utf8.end());
+    }
+
+    void CreateParentDirectory(const std::wstring& Path)
+    {
+        const std::filesystem::path Parent = std::filesystem::path(Path).parent_path();
+        if (!Parent.empty())
+        {
+            std::error_code Error;
+            std::filesystem::create_directories(Parent, Error);
+        }
+    }
+
+    // COM is initialized per call because encoders run on whichever worker picks them up.
+    class FScopedComInitialize
+    {
+    public:
+        FScopedComInitialize()
+            : bInitialized(SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED)))
+        {
+        }
+
+        ~FScopedComInitialize()
+        {
+            if (bInitialized)
+            {
+                CoUninitialize();
+            }
+        }
+
+    private:
+        bool bInitialized;
+    };
+
+    template <typename ValueType>
+    void AppendValue(std::vector<uint8_t>& Bytes, const ValueType& Value)
+    {
+        const uint8_t* Data = reinterpret_cast<const uint8_t*>(&Value);
+        Bytes.insert(Bytes.end(), Data, Data + sizeof(ValueType));
+    }
+
+    void AppendString(std::vector<uint8_t>& Bytes, const char* Text)
+    {
+        Bytes.insert(Bytes.end(), Text, Text + std::strlen(Text) + 1);
+    }
+
+    void AppendAttributeHeader(std::vector<uint8_t>& Bytes, const char* Name, const char* Type, int32_t Size)
+    {
+        AppendString(Bytes, Name);
+        AppendString(Bytes, Type);
+        AppendValue(Bytes, Size);
+    }
+
+    void AppendBox(std::vector<uint8_t>& Bytes, const char* Name, uint32_t Width, uint32_t Height)
+    {
+        AppendAttributeHeader(Bytes, Name, "box2i", 16);
+        AppendValue(Bytes, int32_t(0));
+        AppendValue(Bytes, int32_t(0));
+        AppendValue(Bytes, static_cast<int32_t>(Width) - 1);
+        AppendValue(Bytes, static_cast<int32_t>(Height) - 1);
+    }
+}
+
+bool FImageWriter::WritePng(const std::wstring& Path, const uint8_t* Texels, uint32_t Width, uint32_t Height, uint32_t RowPitch)
+{
+    CreateParentDirectory(Path);
+    FScopedComInitialize ComScope;
+
+    ComPtr<IWICImagingFactory> Factory;
+    ComPtr<IWICStream> Stream;
+    ComPtr<IWICBitmapEncoder> Encoder;
+    ComPtr<IWICBitmapFrameEncode> Frame;
+    if (FAILED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(Factory.GetAddressOf())))
+        || FAILED(Factory->CreateStream(Stream.GetAddressOf()))
+        || FAILED(Stream->InitializeFromFilename(Path.c_str(), GENERIC_WRITE))
+        || FAILED(Factory->CreateEncoder(GUID_ContainerFormatPng, nullptr, Encoder.GetAddressOf()))
+        || FAILED(Encoder->Initialize(Stream.Get(), WICBitmapEncoderNoCache))
+        || FAILED(Encoder->CreateNewFrame(Frame.GetAddressOf(), nullptr))
+        || FAILED(Frame->Initialize(nullptr))
+        || FAILED(Frame->SetSize(Width, Height)))
+    {
+        LogError("Failed to create PNG encoder for: " + ToUtf8(Path));
+        return false;
+    }
+
+    WICPixelFormatGUID PixelFormat = GUID_WICPixelFormat32bppRGBA;
+    if (FAILED(Frame->SetPixelFormat(&PixelFormat)))
+    {
+        LogError("PNG encoder rejected the pixel format for: " + ToUtf8(Path));
+        return false;
+    }
+
+    // Encoders that only take BGRA hand back that format instead; swap the channels for them.
+    std::vector<uint8_t> Swizzled;
+    if (PixelFormat != GUID_WICPixelFormat32bppRGBA)
+    {
+        if (PixelFormat != GUID_WICPixelFormat32bppBGRA)
+        {
+            LogError("PNG encoder has no 32-bit RGBA format for: " + ToUtf8(Path));
+            return false;
+        }
+
+        Swizzled.assign(Texels, Texels + static_cast<size_t>(RowPitch) * Height);
+        for (uint32_t Y = 0; Y < Height; ++Y)
+        {
+            uint8_t* Row = Swizzled.data() + static_cast<size_t>(Y) * RowPitch;
+            for (uint32_t X = 0; X < Width; ++X)
+            {
+                std::swap(Row[X * 4 + 0], Row[X * 4 + 2]);
+            }
+        }
+        Texels = Swizzled.data();
+    }
+
+    if (FAILED(Frame->WritePixels(Height, RowPitch, RowPitch * Height, const_cast<BYTE*>(Texels)))
+        || FAILED(Frame->Commit())
+        || FAILED(Encoder->Commit()))
+    {
+        LogError("Failed to encode PNG: " + ToUtf8(Path));
+        return false;
+    }
+    return true;
+}
+
+bool FImageWriter::WriteExr(const std::wstring& Path, const uint16_t* Texels, uint32_t Width, uint32_t Height, uint32_t RowPitch)
+{
+    constexpr uint32_t ChannelCount = 4;
+    constexpr int32_t HalfPixelType = 1;
+    // Source channel of each file channel: A, B, G, R.
+    constexpr uint32_t ChannelOrder[ChannelCount] = { 3, 2, 1, 0 };
+    const char* const ChannelNames[ChannelCount] = { "A", "B", "G", "R" };
+
+    std::vector<uint8_t> Bytes;
+    AppendValue(Bytes, uint32_t(20000630));
+    AppendValue(Bytes, uint32_t(2));
+
+    AppendAttributeHeader(Bytes, "channels", "chlist", static_cast<int32_t>(ChannelCount * 18 + 1));
+    for (const char* Name : ChannelNames)
+    {
+        AppendString(Bytes, Name);
+        AppendValue(Bytes, HalfPixelType);
+        // pLinear and three reserved bytes
+        AppendValue(Bytes, uint32_t(0));
+        AppendValue(Bytes, int32_t(1));
+        AppendValue(Bytes, int32_t(1));
+    }
+    Bytes.push_back(0);
+
+    AppendAttributeHeader(Bytes, "compression", "compression", 1);
+    Bytes.push_back(0);
+    AppendBox(Bytes, "dataWindow", Width, Height);
+    AppendBox(Bytes, "displayWindow", Width, Height);
+    AppendAttributeHeader(Bytes, "lineOrder", "lineOrder", 1);
+    Bytes.push_back(0);
+    AppendAttributeHeader(Bytes, "pixelAspectRatio", "float", 4);
+    AppendValue(Bytes, 1.0f);
+    AppendAttributeHeader(Bytes, "screenWindowCenter", "v2f", 8);
+    AppendValue(Bytes, 0.0f);
+    AppendValue(Bytes, 0.0f);
+    AppendAttributeHeader(Bytes, "screenWindowWidth", "float", 4);
+    AppendValue(Bytes, 1.0f);
+    Bytes.push_back(0);
+
+    const uint32_t LineDataSize = Width * ChannelCount * sizeof(uint16_t);
+    const uint64_t LineBlockSize = sizeof(int32_t) * 2 + LineDataSize;
+    const uint64_t FirstLineOffset = Bytes.size() + sizeof(uint64_t) * static_cast<uint64_t>(Height);
+    for (uint32_t Y = 0; Y < Height; ++Y)
+    {
+        AppendValue(Bytes, FirstLineOffset + LineBlockSize * Y);
+    }
+
+    Bytes.reserve(Bytes.size() + LineBlockSize * Height);
+    for (uint32_t Y = 0; Y < Height; ++Y)
+    {
+        AppendValue(Bytes, static_cast<int32_t>(Y));
+        AppendValue(Bytes, LineDataSize);
+
+        const uint16_t* Row = reinterpret_cast<const uint16_t*>(reinterpret_cast<const uint8_t*>(Texels) + static_cast<size_t>(Y) * RowPitch);
+        for (uint32_t Channel : ChannelOrder)
+        {
+            for (uint32_t X = 0; X < Width; ++X)
+            {
+                AppendValue(Bytes, Row[X * ChannelCount + Channel]);
+            }
+        }
+    }
+
+    CreateParentDirectory(Path);
+    std::ofstream File(std::filesystem::path(Path), std::ios::binary | std::ios::trunc);
+    if (!File.is_open())
+    {
+        LogError("Failed to open EXR for writing: " + ToUtf8(Path));
+        return false;
+    }
+    File.write(reinterpret_cast<const char*>(Bytes.data()), static_cast<std::streamsize>(Bytes.size()));
+    if (!File.good())
+    {
+        LogError("Failed to write EXR: " + ToUtf8(Path));
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Image files for offscreen captures.
+ *  - PNG: RGBA8 through the Windows Imaging Component encoder.
+ *  - EXR: RGBA half-float scanlines, uncompressed, one line per block. Channels are written in
+ *    the A, B, G, R order the format requires, so any OpenEXR reader opens the file.
+ * Both create the parent directory and may run on any thread.
+ */
+class FImageWriter
+{
+public:
+    static bool WritePng(const std::wstring& Path, const uint8_t* Texels, uint32_t Width, uint32_t Height, uint32_t RowPitch);
+    // Texels are R16G16B16A16_FLOAT, as uint16_t halves.
+    static bool WriteExr(const std::wstring& Path, const uint16_t* Texels, uint32_t Width, uint32_t Height, uint32_t RowPitch);
+};
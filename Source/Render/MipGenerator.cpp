@@ -0,0 +1,604 @@
+#include "MipGenerator.h"
+
+#include "RendererUtils.h"
+#include "TextureCompressor.h"
+#include "ShaderCompiler.h"
+#include "../RHI/DX12Commons.h"
+#include "../RHI/DX12Device.h"
+#include "../Core/TaskSystem.h"
+#include "../Core/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+#include "../../ThirdParty/ddspp/ddspp.h"
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+    const std::filesystem::path TextureCacheDirectory = L"TextureCache";
+
+    constexpr DXGI_FORMAT ScratchFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+    constexpr uint32_t MipGroupSize = 8;
+
+    // FNV-1a of the absolute source path, its size and write time, the filter and the cook version.
+    std::wstring HashCookKey(const std::wstring& Key, uint64_t FileSize, int64_t WriteTime, uint32_t Filter)
+    {
+        uint64_t Hash = 14695981039346656037ULL;
+        const auto AddBytes = [&Hash](const void* Data, size_t Size)
+        {
+            const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+            for (size_t Index = 0; Index < Size; ++Index)
+            {
+                Hash ^= Bytes[Index];
+                Hash *= 1099511628211ULL;
+            }
+        };
+        AddBytes(Key.c_str(), Key.size() * sizeof(wchar_t));
+        AddBytes(&FileSize, sizeof(FileSize));
+        AddBytes(&WriteTime, sizeof(WriteTime));
+        AddBytes(&Filter, sizeof(Filter));
+        const uint32_t Version = FMipGenerator::CookVersion;
+        AddBytes(&Version, sizeof(Version));
+
+        static constexpr wchar_t HexDigits[] = L"0123456789ABCDEF";
+        std::wstring Name(16, L'0');
+        for (size_t Digit = 0; Digit < 16; ++Digit)
+        {
+            Name[15 - Digit] = HexDigits[(Hash >> (Digit * 4)) & 0xF];
+        }
+        return Name;
+    }
+
+    // Encodes the read back chain into a DDS, block compressed when the top mip allows it and as
+    // tightly packed RGBA8 rows otherwise; written to a temporary file first so a concurrent load
+    // never sees a partial file.
+    bool WriteCookedDds(const std::wstring& CookedPath, EMipFilter Filter, const uint8_t* MappedData, const std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>& Layouts, const std::vector<UINT>& NumRows)
+    {
+        if (Layouts.empty())
+        {
+            return false;
+        }
+
+        const uint32_t Width = Layouts[0].Footprint.Width;
+        const uint32_t Height = Layouts[0].Footprint.Height;
+        const uint32_t MipCount = static_cast<uint32_t>(Layouts.size());
+        const EBlockFormat BlockFormat = FTextureCompressor::ChooseFormat(Filter, MappedData + Layouts[0].Offset, Width, Height, Layouts[0].Footprint.RowPitch);
+        const DXGI_FORMAT Format = FTextureCompressor::GetDxgiFormat(BlockFormat);
+
+        ddspp::Header Header = {};
+        ddspp::HeaderDXT10 Dxt10Header = {};
+        ddspp::encode_header(static_cast<ddspp::DXGIFormat>(Format), Width, Height, 1, ddspp::Texture2D, MipCount, 1, Header, Dxt10Header);
+
+        std::vector<uint8_t> FileData;
+        const auto Append = [&FileData](const void* Data, size_t Size)
+        {
+            const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+            FileData.insert(FileData.end(), Bytes, Bytes + Size);
+        };
+        Append(&ddspp::DDS_MAGIC, sizeof(ddspp::DDS_MAGIC));
+        Append(&Header, sizeof(Header));
+        Append(&Dxt10Header, sizeof(Dxt10Header));
+
+        std::vector<uint8_t> Blocks;
+        for (uint32_t Mip = 0; Mip < MipCount; ++Mip)
+        {
+            const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Layout = Layouts[Mip];
+            const uint8_t* MipData = MappedData + Layout.Offset;
+            if (BlockFormat != EBlockFormat::None)
+            {
+                FTextureCompressor::Compress(BlockFormat, MipData, Layout.Footprint.Width, Layout.Footprint.Height, Layout.Footprint.RowPitch, Blocks);
+                Append(Blocks.data(), Blocks.size());
+                continue;
+            }
+
+            const size_t RowSize = static_cast<size_t>(Layout.Footprint.Width) * 4;
+            for (UINT Row = 0; Row < NumRows[Mip]; ++Row)
+            {
+                Append(MipData + static_cast<size_t>(Row) * Layout.Footprint.RowPitch, RowSize);
+            }
+        }
+
+        const std::filesystem::path Path(CookedPath);
+        std::error_code Error;
+        std::filesystem::create_directories(Path.parent_path(), Error);
+
+        std::filesystem::path TempPath = Path;
+        TempPath += L"." + std::to_wstring(std::hash<std::thread::id>()(std::this_thread::get_id())) + L".tmp";
+        {
+            std::ofstream File(TempPath, std::ios::binary | std::ios::trunc);
+            File.write(reinterpret_cast<const char*>(FileData.data()), static_cast<std::streamsize>(FileData.size()));
+            if (!File)
+            {
+                return false;
+            }
+        }
+
+        std::filesystem::rename(TempPath, Path, Error);
+        if (Error)
+        {
+            std::filesystem::remove(TempPath, Error);
+            return false;
+        }
+        return true;
+    }
+
+    void WriteCook(const ComPtr<ID3D12Resource>& Readback, const std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>& Layouts, const std::vector<UINT>& NumRows, const std::wstring& CookedPath, EMipFilter Filter)
+    {
+        uint8_t* MappedData = nullptr;
+        if (FAILED(Readback->Map(0, nullptr, reinterpret_cast<void**>(&MappedData))))
+        {
+            return;
+        }
+
+        if (!WriteCookedDds(CookedPath, Filter, MappedData, Layouts, NumRows))
+        {
+            LogWarning("Failed to write cooked texture " + std::filesystem::path(CookedPath).string());
+        }
+
+        const D3D12_RANGE EmptyRange = { 0, 0 };
+        Readback->Unmap(0, &EmptyRange);
+    }
+}
+
+uint32_t FMipGenerator::GetMipCount(uint32_t Width, uint32_t Height)
+{
+    uint32_t MipCount = 1;
+    for (uint32_t Extent = (std::max)(Width, Height); Extent > 1; Extent >>= 1)
+    {
+        ++MipCount;
+    }
+    return MipCount;
+}
+
+std::wstring FMipGenerator::GetCookedPath(const std::wstring& SourcePath, EMipFilter Filter)
+{
+    std::error_code Error;
+    const uint64_t FileSize = static_cast<uint64_t>(std::filesystem::file_size(SourcePath, Error));
+    if (Error)
+    {
+        return {};
+    }
+    const int64_t WriteTime = static_cast<int64_t>(std::filesystem::last_write_time(SourcePath, Error).time_since_epoch().count());
+    if (Error)
+    {
+        return {};
+    }
+
+    const std::filesystem::path AbsolutePath = std::filesystem::absolute(SourcePath, Error);
+    const std::wstring Key = (Error ? std::filesystem::path(SourcePath) : AbsolutePath).lexically_normal().wstring();
+    const std::wstring Name = HashCookKey(Key, FileSize, WriteTime, static_cast<uint32_t>(Filter));
+    return (TextureCacheDirectory / (Name + L".dds")).wstring();
+}
+
+FMipGenerator::~FMipGenerator()
+{
+    if (!Device)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Queue.Flush();
+    ReleaseCompletedLocked(true);
+}
+
+bool FMipGenerator::Initialize(FDX12Device* InDevice)
+{
+    if (!InDevice || !InDevice->GetDescriptorAllocator())
+    {
+        return false;
+    }
+
+    if (!Queue.Initialize(InDevice->GetDevice(), EDX12QueueType::Compute))
+    {
+        LogError("Failed to create the mip generation queue");
+        return false;
+    }
+
+    Device = InDevice;
+    if (!CreateRootSignature() || !CreatePipelines())
+    {
+        Device = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool FMipGenerator::CreateRootSignature()
+{
+    D3D12_DESCRIPTOR_RANGE1 Ranges[2] = {};
+    Ranges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    Ranges[0].NumDescriptors = 1;
+    Ranges[0].BaseShaderRegister = 0;
+    Ranges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE;
+    Ranges[0].OffsetInDescriptorsFromTableStart = 0;
+    Ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+    Ranges[1].NumDescriptors = 1;
+    Ranges[1].BaseShaderRegister = 0;
+    Ranges[1].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_NONE;
+    Ranges[1].OffsetInDescriptorsFromTableStart = 1;
+
+    D3D12_ROOT_PARAMETER1 RootParams[2] = {};
+    // RootParams[0]: Source and destination sizes (b0)
+    RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    RootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[0].Constants.Num32BitValues = 4;
+    RootParams[0].Constants.ShaderRegister = 0;
+
+    // RootParams[1]: Source mip SRV (t0) followed by the destination mip UAV (u0)
+    RootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    RootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[1].DescriptorTable.NumDescriptorRanges = _countof(Ranges);
+    RootParams[1].DescriptorTable.pDescriptorRanges = Ranges;
+
+    D3D12_VERSIONED_ROOT_SIGNATURE_DESC RootSigDesc = {};
+    RootSigDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
+    RootSigDesc.Desc_1_1.NumParameters = _countof(RootParams);
+    RootSigDesc.Desc_1_1.pParameters = RootParams;
+    RootSigDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
+
+    ComPtr<ID3DBlob> SerializedSig;
+    ComPtr<ID3DBlob> ErrorBlob;
+    if (FAILED(D3D12SerializeVersionedRootSignature(&RootSigDesc, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf())))
+    {
+        if (ErrorBlob)
+        {
+            LogError(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
+        }
+        return false;
+    }
+
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), RootSignature.ReleaseAndGetAddressOf()));
+    return RootSignature != nullptr;
+}
+
+bool FMipGenerator::CreatePipelines()
+{
+    FShaderCompiler Compiler;
+    const std::wstring CSTarget = RendererUtils::BuildShaderTarget(L"cs", Device->GetShaderModel());
+
+    for (size_t PipelineIndex = 0; PipelineIndex < Pipelines.size(); ++PipelineIndex)
+    {
+        std::vector<uint8_t> CSByteCode;
+        const std::vector<std::wstring> Defines = { L"MIP_FILTER=" + std::to_wstring(PipelineIndex) };
+        if (!Compiler.CompileFromFile(L"Shaders/GenerateMips.hlsl", L"GenerateMips", CSTarget, CSByteCode, Defines))
+        {
+            LogError("Failed to compile mip generation shader");
+            return false;
+        }
+
+        D3D12_COMPUTE_PIPELINE_STATE_DESC PsoDesc = {};
+        PsoDesc.pRootSignature = RootSignature.Get();
+        PsoDesc.CS = { CSByteCode.data(), CSByteCode.size() };
+
+        HR_CHECK(Device->GetPipelineCache()->CreateComputePipelineState(PsoDesc, Pipelines[PipelineIndex].ReleaseAndGetAddressOf()));
+        if (!Pipelines[PipelineIndex])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FMipGenerator::CreateScratch(const D3D12_RESOURCE_DESC& TargetDesc, ComPtr<ID3D12Resource>& OutScratch) const
+{
+    if (!Device)
+    {
+        return false;
+    }
+
+    D3D12_RESOURCE_DESC ScratchDesc = TargetDesc;
+    ScratchDesc.Format = ScratchFormat;
+    ScratchDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+    D3D12_HEAP_PROPERTIES DefaultHeap = {};
+    DefaultHeap.Type = D3D12_HEAP_TYPE_DEFAULT;
+    DefaultHeap.CreationNodeMask = 1;
+    DefaultHeap.VisibleNodeMask = 1;
+
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Texture,
+        &DefaultHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &ScratchDesc,
+        D3D12_RESOURCE_STATE_COPY_DEST,
+        nullptr,
+        IID_PPV_ARGS(OutScratch.ReleaseAndGetAddressOf())));
+    return OutScratch != nullptr;
+}
+
+bool FMipGenerator::CreateReadback(ID3D12Resource* Scratch, FPendingCook& OutCook) const
+{
+    const D3D12_RESOURCE_DESC ScratchDesc = Scratch->GetDesc();
+    const UINT MipCount = ScratchDesc.MipLevels;
+    OutCook.Layouts.resize(MipCount);
+    OutCook.NumRows.resize(MipCount);
+    UINT64 ReadbackSize = 0;
+    Device->GetDevice()->GetCopyableFootprints(&ScratchDesc, 0, MipCount, 0, OutCook.Layouts.data(), OutCook.NumRows.data(), nullptr, &ReadbackSize);
+
+    D3D12_HEAP_PROPERTIES ReadbackHeap = {};
+    ReadbackHeap.Type = D3D12_HEAP_TYPE_READBACK;
+    ReadbackHeap.CreationNodeMask = 1;
+    ReadbackHeap.VisibleNodeMask = 1;
+
+    D3D12_RESOURCE_DESC ReadbackDesc = {};
+    ReadbackDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    ReadbackDesc.Width = ReadbackSize;
+    ReadbackDesc.Height = 1;
+    ReadbackDesc.DepthOrArraySize = 1;
+    ReadbackDesc.MipLevels = 1;
+    ReadbackDesc.Format = DXGI_FORMAT_UNKNOWN;
+    ReadbackDesc.SampleDesc.Count = 1;
+    ReadbackDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+    return SUCCEEDED(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Readback,
+        &ReadbackHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &ReadbackDesc,
+        D3D12_RESOURCE_STATE_COPY_DEST,
+        nullptr,
+        IID_PPV_ARGS(OutCook.Readback.ReleaseAndGetAddressOf())));
+}
+
+uint64_t FMipGenerator::Submit(const FMipGenerationJob* Jobs, ID3D12Resource* const* Targets, uint32_t Count, uint64_t UploadFenceValue)
+{
+    if (!Device || Count == 0)
+    {
+        return UploadFenceValue;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    ReleaseCompletedLocked(false);
+
+    ComPtr<ID3D12CommandAllocator> Allocator;
+    ComPtr<ID3D12GraphicsCommandList> CommandList;
+    if (FAILED(Device->GetDevice()->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COMPUTE, IID_PPV_ARGS(Allocator.GetAddressOf())))
+        || FAILED(Device->GetDevice()->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COMPUTE, Allocator.Get(), nullptr, IID_PPV_ARGS(CommandList.GetAddressOf()))))
+    {
+        LogError("Failed to create mip generation command list");
+        return UploadFenceValue;
+    }
+
+    FDX12DescriptorAllocator* DescriptorAllocator = Device->GetDescriptorAllocator();
+    ID3D12DescriptorHeap* Heaps[] = { DescriptorAllocator->GetHeap() };
+    CommandList->SetDescriptorHeaps(1, Heaps);
+    CommandList->SetComputeRootSignature(RootSignature.Get());
+
+    FPendingGeneration Pending;
+    Pending.KeepAlive.push_back(Allocator);
+    Pending.KeepAlive.push_back(CommandList);
+
+    // Per job a (source SRV, destination UAV) descriptor pair per generated mip. Mip 0 starts in
+    // NON_PIXEL_SHADER_RESOURCE and every other mip in UNORDERED_ACCESS until it has been written.
+    std::vector<D3D12_RESOURCE_BARRIER> Barriers;
+    uint32_t MaxMipCount = 1;
+    for (uint32_t JobIndex = 0; JobIndex < Count; ++JobIndex)
+    {
+        ID3D12Resource* Scratch = Jobs[JobIndex].Scratch.Get();
+        const D3D12_RESOURCE_DESC ScratchDesc = Scratch->GetDesc();
+        const uint32_t MipCount = ScratchDesc.MipLevels;
+        MaxMipCount = (std::max)(MaxMipCount, MipCount);
+        Pending.KeepAlive.push_back(Jobs[JobIndex].Scratch);
+
+        FDX12DescriptorRange Range;
+        if (MipCount > 1)
+        {
+            Range = DescriptorAllocator->AllocatePersistent((MipCount - 1) * 2);
+            if (!Range.IsValid())
+            {
+                LogError("Out of descriptors for mip generation");
+            }
+        }
+        Pending.DescriptorRanges.push_back(Range);
+
+        for (uint32_t Mip = 1; Mip < MipCount && Range.IsValid(); ++Mip)
+        {
+            D3D12_SHADER_RESOURCE_VIEW_DESC SrvDesc = {};
+            SrvDesc.Format = ScratchFormat;
+            SrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+            SrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+            SrvDesc.Texture2D.MostDetailedMip = Mip - 1;
+            SrvDesc.Texture2D.MipLevels = 1;
+            Device->GetDevice()->CreateShaderResourceView(Scratch, &SrvDesc, Range.GetCpuHandle((Mip - 1) * 2));
+
+            D3D12_UNORDERED_ACCESS_VIEW_DESC UavDesc = {};
+            UavDesc.Format = ScratchFormat;
+            UavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+            UavDesc.Texture2D.MipSlice = Mip;
+            Device->GetDevice()->CreateUnorderedAccessView(Scratch, nullptr, &UavDesc, Range.GetCpuHandle((Mip - 1) * 2 + 1));
+        }
+
+        for (uint32_t Mip = 0; Mip < MipCount; ++Mip)
+        {
+            D3D12_RESOURCE_BARRIER Barrier = {};
+            Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            Barrier.Transition.pResource = Scratch;
+            Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COMMON;
+            Barrier.Transition.StateAfter = Mip == 0 ? D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE : D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+            Barrier.Transition.Subresource = Mip;
+            Barriers.push_back(Barrier);
+        }
+    }
+    CommandList->ResourceBarrier(static_cast<UINT>(Barriers.size()), Barriers.data());
+
+    // Level by level across all jobs, so one barrier batch per level covers every texture.
+    for (uint32_t Mip = 1; Mip < MaxMipCount; ++Mip)
+    {
+        Barriers.clear();
+        for (uint32_t JobIndex = 0; JobIndex < Count; ++JobIndex)
+        {
+            const FDX12DescriptorRange& Range = Pending.DescriptorRanges[JobIndex];
+            ID3D12Resource* Scratch = Jobs[JobIndex].Scratch.Get();
+            const D3D12_RESOURCE_DESC ScratchDesc = Scratch->GetDesc();
+            if (Mip >= ScratchDesc.MipLevels)
+            {
+                continue;
+            }
+
+            if (Range.IsValid())
+            {
+                const uint32_t SourceWidth = (std::max)(1u, static_cast<uint32_t>(ScratchDesc.Width >> (Mip - 1)));
+                const uint32_t SourceHeight = (std::max)(1u, ScratchDesc.Height >> (Mip - 1));
+                const uint32_t Constants[4] =
+                {
+                    SourceWidth,
+                    SourceHeight,
+                    (std::max)(1u, SourceWidth >> 1),
+                    (std::max)(1u, SourceHeight >> 1),
+                };
+
+                CommandList->SetPipelineState(Pipelines[static_cast<size_t>(Jobs[JobIndex].Filter)].Get());
+                CommandList->SetComputeRoot32BitConstants(0, _countof(Constants), Constants, 0);
+                CommandList->SetComputeRootDescriptorTable(1, Range.GetGpuHandle((Mip - 1) * 2));
+                CommandList->Dispatch((Constants[2] + MipGroupSize - 1) / MipGroupSize, (Constants[3] + MipGroupSize - 1) / MipGroupSize, 1);
+            }
+
+            D3D12_RESOURCE_BARRIER Barrier = {};
+            Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            Barrier.Transition.pResource = Scratch;
+            Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+            Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+            Barrier.Transition.Subresource = Mip;
+            Barriers.push_back(Barrier);
+        }
+        CommandList->ResourceBarrier(static_cast<UINT>(Barriers.size()), Barriers.data());
+    }
+
+    Barriers.clear();
+    for (uint32_t JobIndex = 0; JobIndex < Count; ++JobIndex)
+    {
+        D3D12_RESOURCE_BARRIER Barrier = {};
+        Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        Barrier.Transition.pResource = Jobs[JobIndex].Scratch.Get();
+        Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+        Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+        Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        Barriers.push_back(Barrier);
+    }
+    CommandList->ResourceBarrier(static_cast<UINT>(Barriers.size()), Barriers.data());
+
+    Barriers.clear();
+    for (uint32_t JobIndex = 0; JobIndex < Count; ++JobIndex)
+    {
+        const FMipGenerationJob& Job = Jobs[JobIndex];
+        const UINT MipCount = Job.Scratch->GetDesc().MipLevels;
+        for (UINT Mip = 0; Mip < MipCount; ++Mip)
+        {
+            D3D12_TEXTURE_COPY_LOCATION DstLocation = {};
+            DstLocation.pResource = Targets[JobIndex];
+            DstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+            DstLocation.SubresourceIndex = Mip;
+
+            D3D12_TEXTURE_COPY_LOCATION SrcLocation = {};
+            SrcLocation.pResource = Job.Scratch.Get();
+            SrcLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+            SrcLocation.SubresourceIndex = Mip;
+
+            CommandList->CopyTextureRegion(&DstLocation, 0, 0, 0, &SrcLocation, nullptr);
+        }
+
+        FPendingCook Cook;
+        if (!Job.CookedPath.empty() && Pending.DescriptorRanges[JobIndex].IsValid() && CreateReadback(Job.Scratch.Get(), Cook))
+        {
+            for (UINT Mip = 0; Mip < MipCount; ++Mip)
+            {
+                D3D12_TEXTURE_COPY_LOCATION DstLocation = {};
+                DstLocation.pResource = Cook.Readback.Get();
+                DstLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+                DstLocation.PlacedFootprint = Cook.Layouts[Mip];
+
+                D3D12_TEXTURE_COPY_LOCATION SrcLocation = {};
+                SrcLocation.pResource = Job.Scratch.Get();
+                SrcLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+                SrcLocation.SubresourceIndex = Mip;
+
+                CommandList->CopyTextureRegion(&DstLocation, 0, 0, 0, &SrcLocation, nullptr);
+            }
+            Cook.CookedPath = Job.CookedPath;
+            Cook.Filter = Job.Filter;
+            Pending.Cooks.push_back(std::move(Cook));
+        }
+
+        D3D12_RESOURCE_BARRIER Barrier = {};
+        Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        Barrier.Transition.pResource = Targets[JobIndex];
+        Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COMMON;
+        Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        Barriers.push_back(Barrier);
+    }
+    CommandList->ResourceBarrier(static_cast<UINT>(Barriers.size()), Barriers.data());
+
+    HR_CHECK(CommandList->Close());
+
+    FDX12UploadQueue* UploadQueue = Device->GetUploadQueue();
+    Queue.GpuWait(*UploadQueue->GetQueue(), UploadFenceValue);
+    ID3D12CommandList* Lists[] = { CommandList.Get() };
+    Queue.ExecuteCommandLists(1, Lists);
+    Pending.FenceValue = Queue.Signal();
+    PendingGenerations.push_back(std::move(Pending));
+
+    return UploadQueue->SubmitAfter(Queue, PendingGenerations.back().FenceValue);
+}
+
+void FMipGenerator::ReleaseCompleted()
+{
+    if (!Device)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    ReleaseCompletedLocked(false);
+}
+
+void FMipGenerator::ReleaseCompletedLocked(bool bWriteInline)
+{
+    const uint64_t CompletedValue = Queue.GetCompletedFenceValue();
+    FDX12DescriptorAllocator* DescriptorAllocator = Device->GetDescriptorAllocator();
+
+    size_t KeptCount = 0;
+    for (size_t Index = 0; Index < PendingGenerations.size(); ++Index)
+    {
+        FPendingGeneration& Pending = PendingGenerations[Index];
+        if (Pending.FenceValue > CompletedValue)
+        {
+            if (KeptCount != Index)
+            {
+                PendingGenerations[KeptCount] = std::move(Pending);
+            }
+            ++KeptCount;
+            continue;
+        }
+
+        for (const FDX12DescriptorRange& Range : Pending.DescriptorRanges)
+        {
+            if (Range.IsValid())
+            {
+                DescriptorAllocator->FreePersistent(Range);
+            }
+        }
+
+        for (FPendingCook& Cook : Pending.Cooks)
+        {
+            if (bWriteInline || !FTaskScheduler::Get().IsRunning())
+            {
+                WriteCook(Cook.Readback, Cook.Layouts, Cook.NumRows, Cook.CookedPath, Cook.Filter);
+                continue;
+            }
+
+            FTaskScheduler::Get().ScheduleTask([Cook = std::move(Cook)]()
+            {
+                WriteCook(Cook.Readback, Cook.Layouts, Cook.NumRows, Cook.CookedPath, Cook.Filter);
+            }, ETaskPriority::Background);
+        }
+    }
+    PendingGenerations.resize(KeptCount);
+}
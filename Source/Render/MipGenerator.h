@@ -0,0 +1,109 @@
+#pragma once
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../RHI/DX12CommandQueue.h"
+#include "../RHI/DX12DescriptorAllocator.h"
+
+class FDX12Device;
+
+enum class EMipFilter : uint8_t
+{
+    Linear,
+    SRGB,
+    NormalMap,
+};
+
+// Top mip of a texture waiting for FMipGenerator to build the rest of its chain.
+struct FMipGenerationJob
+{
+    // R8G8B8A8_UNORM copy of the target with all of its mips, mip 0 uploaded; see CreateScratch.
+    Microsoft::WRL::ComPtr<ID3D12Resource> Scratch;
+    EMipFilter Filter = EMipFilter::Linear;
+    // Receives a DDS of the generated chain once the GPU is done with it; empty to skip cooking.
+    std::wstring CookedPath;
+
+    bool IsPending() const { return Scratch != nullptr; }
+};
+
+/**
+ * Builds RGBA8 mip chains with a compute shader (Shaders/GenerateMips.hlsl) on a compute queue of
+ * its own, so background loads never share a queue with the frame. Each submission waits on the
+ * GPU for the upload that filled the scratch textures and hands back an upload queue fence that
+ * covers the generation, so callers keep treating the textures like any other upload.
+ * Generated chains are read back, block compressed by FTextureCompressor and cooked to DDS files
+ * under TextureCache/, keyed by source path, size and write time, which later loads read instead
+ * of decoding, filtering and compressing again.
+ */
+class FMipGenerator
+{
+public:
+    // Bump whenever the filter or cook output changes so stale cooked files are no longer found.
+    static constexpr uint32_t CookVersion = 2;
+
+    static uint32_t GetMipCount(uint32_t Width, uint32_t Height);
+    // Cooked DDS for the source image and filter, or an empty path when the source is missing.
+    static std::wstring GetCookedPath(const std::wstring& SourcePath, EMipFilter Filter);
+
+    FMipGenerator() = default;
+    FMipGenerator(const FMipGenerator&) = delete;
+    FMipGenerator& operator=(const FMipGenerator&) = delete;
+    // Waits for outstanding generations and writes their cooked files.
+    ~FMipGenerator();
+
+    bool Initialize(FDX12Device* InDevice);
+
+    // Scratch texture for a 2D RGBA8 target: the target's size and mip count, UAV access, created
+    // in COPY_DEST. Its uploads must leave it in COMMON, which copy queues do implicitly.
+    bool CreateScratch(const D3D12_RESOURCE_DESC& TargetDesc, Microsoft::WRL::ComPtr<ID3D12Resource>& OutScratch) const;
+
+    /**
+     * Filters every job's scratch texture down its chain and copies all mips into the matching
+     * target, which must be in COPY_DEST and is left in COMMON for implicit promotion on first read.
+     * Thread-safe.
+     * @param UploadFenceValue Upload queue fence after which the scratch textures hold mip 0
+     * @return Upload queue fence covering the generation, or UploadFenceValue if nothing was recorded
+     */
+    uint64_t Submit(const FMipGenerationJob* Jobs, ID3D12Resource* const* Targets, uint32_t Count, uint64_t UploadFenceValue);
+
+    // Releases finished generations and writes their cooked files on background tasks.
+    void ReleaseCompleted();
+
+private:
+    struct FPendingCook
+    {
+        Microsoft::WRL::ComPtr<ID3D12Resource> Readback;
+        std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> Layouts;
+        std::vector<UINT> NumRows;
+        std::wstring CookedPath;
+        EMipFilter Filter = EMipFilter::Linear;
+    };
+
+    struct FPendingGeneration
+    {
+        uint64_t FenceValue = 0;
+        std::vector<Microsoft::WRL::ComPtr<IUnknown>> KeepAlive;
+        std::vector<FDX12DescriptorRange> DescriptorRanges;
+        std::vector<FPendingCook> Cooks;
+    };
+
+    bool CreateRootSignature();
+    bool CreatePipelines();
+    bool CreateReadback(ID3D12Resource* Scratch, FPendingCook& OutCook) const;
+    void ReleaseCompletedLocked(bool bWriteInline);
+
+    FDX12Device* Device = nullptr;
+    FDX12CommandQueue Queue;
+    Microsoft::WRL::ComPtr<ID3D12RootSignature> RootSignature;
+    // Indexed by EMipFilter.
+    std::array<Microsoft::WRL::ComPtr<ID3D12PipelineState>, 3> Pipelines;
+
+    std::mutex Mutex;
+    std::vector<FPendingGeneration> PendingGenerations;
+};
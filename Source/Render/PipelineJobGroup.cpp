@@ -0,0 +1,56 @@
+#include "PipelineJobGroup.h"
+
+#include "../Core/Logger.h"
+
+FPipelineJobGroup::~FPipelineJobGroup()
+{
+    FTaskScheduler::Get().WaitForCounter(Counter);
+}
+
+void FPipelineJobGroup::Add(std::function<bool()> Create, std::string FailureMessage, bool bRequired)
+{
+    Jobs.push_back({ std::move(Create), std::move(FailureMessage), bRequired, false });
+    FJob* Job = &Jobs.back();
+
+    FTaskScheduler& Scheduler = FTaskScheduler::Get();
+    if (!Scheduler.IsRunning())
+    {
+        Job->bSucceeded = Job->Create();
+        return;
+    }
+
+    // Reload-time renderers build on background workers, so frame work keeps the rest.
+    const ETaskPriority Priority = FTaskScheduler::GetCurrentTaskPriority() == ETaskPriority::Background
+        ? ETaskPriority::Background
+        : ETaskPriority::Normal;
+    Scheduler.Spawn(Counter, [Job]()
+    {
+        Job->bSucceeded = Job->Create();
+    }, Priority);
+}
+
+bool FPipelineJobGroup::Join()
+{
+    FTaskScheduler::Get().WaitForCounter(Counter);
+
+    bool bSucceeded = true;
+    for (; JoinedCount < Jobs.size(); ++JoinedCount)
+    {
+        const FJob& Job = Jobs[JoinedCount];
+        if (Job.bSucceeded)
+        {
+            continue;
+        }
+
+        if (Job.bRequired)
+        {
+            LogError(Job.FailureMessage);
+            bSucceeded = false;
+        }
+        else
+        {
+            LogWarning(Job.FailureMessage);
+        }
+    }
+    return bSucceeded;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+
+#include "../Core/TaskSystem.h"
+
+/**
+ * Pipeline creators that run on the task scheduler's workers while the code that added them goes
+ * on, since PSO creation is thread-safe and the slowest part of renderer startup. A job may only
+ * write the pipelines it builds. Without a running scheduler each job runs as it is added.
+ * Join waits for every job and reports failures in the order the jobs were added; the destructor
+ * joins too, so early returns never leave a job writing into a renderer being torn down.
+ */
+class FPipelineJobGroup
+{
+public:
+    FPipelineJobGroup() = default;
+    ~FPipelineJobGroup();
+
+    FPipelineJobGroup(const FPipelineJobGroup&) = delete;
+    FPipelineJobGroup& operator=(const FPipelineJobGroup&) = delete;
+
+    // FailureMessage is logged as an error that fails Join, or as a warning when the job is optional.
+    void Add(std::function<bool()> Create, std::string FailureMessage, bool bRequired = true);
+    // False when a required job failed. Jobs added after a Join are joined by the next one.
+    bool Join();
+
+private:
+    struct FJob
+    {
+        std::function<bool()> Create;
+        std::string FailureMessage;
+        bool bRequired = true;
+        bool bSucceeded = false;
+    };
+
+    // A deque keeps the jobs where the running tasks point while more are added.
+    std::deque<FJob> Jobs;
+    size_t JoinedCount = 0;
+    FTaskCounter Counter;
+};
@@ -7,17 +7,93 @@
 #include <sstream>
 #include "../Core/Logger.h"
 #include <filesystem>
-
-std::vector<FRenderGraph::FPooledTexture> FRenderGraph::TexturePool;
+#include <fstream>
+#include <iomanip>
+#include <cmath>
+
+std::vector<FRenderGraph::FPooledResource> FRenderGraph::ResourcePool;
+std::unordered_multimap<uint64, int32> FRenderGraph::ResourcePoolLookup;
+std::vector<int32> FRenderGraph::FreePoolSlots;
+uint64 FRenderGraph::LastRetiredGraphFrame = 0;
+std::unordered_map<uint64, FRenderGraph::FCompiledGraph> FRenderGraph::CompiledGraphs;
+uint64 FRenderGraph::CompiledGraphFrameCounter = 0;
+std::vector<D3D12_RESOURCE_BARRIER> FRenderGraph::BarrierScratch;
+std::vector<D3D12_TEXTURE_BARRIER> FRenderGraph::TextureBarrierScratch;
+std::vector<D3D12_BUFFER_BARRIER> FRenderGraph::BufferBarrierScratch;
+std::unordered_map<uint32, FRenderGraph::FFrameAllocatorSlot> FRenderGraph::FrameAllocators;
+FRenderGraph::FTransientHeap FRenderGraph::TransientHeaps[FRenderGraph::TransientHeapCategoryCount];
+D3D12_RESOURCE_HEAP_TIER FRenderGraph::TransientHeapTier = D3D12_RESOURCE_HEAP_TIER_1;
+bool FRenderGraph::bTransientHeapTierQueried = false;
 std::unordered_map<uint32, FRenderGraph::FGpuTimingData> FRenderGraph::PendingGpuTimings;
 std::unordered_map<uint32, FRenderGraph::FGpuTimingResources> FRenderGraph::GpuTimingResources;
 std::unordered_map<std::string, std::deque<FRenderGraph::FGpuTimingSample>> FRenderGraph::GpuTimingSamples;
+std::unordered_map<std::string, ERGPassQueue> FRenderGraph::GpuTimingPassQueues;
 std::vector<FRenderGraph::FGpuPassTimingStats> FRenderGraph::CachedGpuTimingStats;
+std::unordered_map<std::string, std::deque<FRenderGraph::FPipelineStatsSample>> FRenderGraph::PipelineStatsSamples;
+std::vector<FRenderGraph::FGpuPassPipelineStats> FRenderGraph::CachedPipelineStats;
 double FRenderGraph::GpuTimingWindowSeconds = 1.0;
+FRenderGraph::FTimingCapture FRenderGraph::TimingCapture;
+std::string FRenderGraph::LastTimingCapturePath;
 uint32 FRenderGraph::GpuTimingDisplayCount = 3;
 
-FRenderGraph::FRenderGraph()
+FRenderGraph::FRenderGraph(FDX12CommandContext& CmdContext)
+    : FrameAllocator(&AcquireFrameAllocator(CmdContext))
+    , Resources(TLinearAllocatorAdapter<FRGResource>(FrameAllocator))
+    , Passes(TLinearAllocatorAdapter<PassEntry>(FrameAllocator))
+{
+    // Growing arena-backed vectors abandons the old block, so start at a typical frame's size
+    Resources.reserve(64);
+    Passes.reserve(32);
+}
+
+FRenderGraph::~FRenderGraph()
+{
+    for (PassEntry& Entry : Passes)
+    {
+        if (Entry.DestroyClosure)
+        {
+            Entry.DestroyClosure(Entry.ExecuteClosure);
+        }
+        if (Entry.DestroyData)
+        {
+            Entry.DestroyData(Entry.Data);
+        }
+    }
+}
+
+FLinearAllocator& FRenderGraph::AcquireFrameAllocator(const FDX12CommandContext& CmdContext)
+{
+    FFrameAllocatorSlot& Slot = FrameAllocators[CmdContext.GetCurrentFrameIndex()];
+    const FDX12CommandQueue* Queue = CmdContext.GetQueue();
+    if (Slot.bRetired && Queue && Queue->GetCompletedFenceValue() >= Slot.RetiredFenceValue)
+    {
+        Slot.Allocator.Reset();
+        Slot.bRetired = false;
+    }
+
+    return Slot.Allocator;
+}
+
+void FRenderGraph::RetireFrameAllocations(uint32 FrameIndex, uint64 FenceValue)
 {
+    // Every graph executed since the previous retirement was submitted before FenceValue.
+    for (FPooledResource& Pooled : ResourcePool)
+    {
+        if (Pooled.Resource && Pooled.LastUsedFrame > LastRetiredGraphFrame)
+        {
+            Pooled.LastUsedFenceValue = FenceValue;
+        }
+    }
+    LastRetiredGraphFrame = CompiledGraphFrameCounter;
+
+    auto It = FrameAllocators.find(FrameIndex);
+    if (It == FrameAllocators.end())
+    {
+        return;
+    }
+
+    It->second.RetiredFenceValue = FenceValue;
+    It->second.bRetired = true;
 }
 
 void FRenderGraph::SetGpuTimingWindowSeconds(double Seconds)
@@ -47,12 +123,46 @@ const std::vector<FRenderGraph::FGpuPassTimingStats>& FRenderGraph::GetGpuTiming
 
 void FRenderGraph::AddExternalGpuTimingSample(const std::string& Name, double Milliseconds)
 {
+    if (TimingCapture.bActive && !TimingCapture.Frames.empty())
+    {
+        FCapturedPassTiming Captured;
+        Captured.Name = Name;
+        Captured.GpuMs = Milliseconds;
+        Captured.bExternal = true;
+        TimingCapture.Frames.back().Passes.push_back(std::move(Captured));
+    }
+
     const auto Now = std::chrono::steady_clock::now();
     std::deque<FGpuTimingSample>& Samples = GpuTimingSamples[Name];
     Samples.push_back({ Now, Milliseconds });
     UpdateCachedGpuTimingStats(Now);
 }
 
+const std::vector<FRenderGraph::FGpuPassPipelineStats>& FRenderGraph::GetPipelineStats()
+{
+    return CachedPipelineStats;
+}
+
+const FRenderGraph::FGpuPassPipelineStats* FRenderGraph::FindPipelineStats(const std::string& Name)
+{
+    for (const FGpuPassPipelineStats& Stats : CachedPipelineStats)
+    {
+        if (Stats.Name == Name)
+        {
+            return &Stats;
+        }
+    }
+    return nullptr;
+}
+
+void FRenderGraph::ResetGpuTimingStats()
+{
+    GpuTimingSamples.clear();
+    CachedGpuTimingStats.clear();
+    PipelineStatsSamples.clear();
+    CachedPipelineStats.clear();
+}
+
 void FRenderGraph::UpdateCachedGpuTimingStats(const std::chrono::steady_clock::time_point& Now)
 {
     const double WindowSeconds = (std::max)(0.1, GpuTimingWindowSeconds);
@@ -87,6 +197,8 @@ void FRenderGraph::UpdateCachedGpuTimingStats(const std::chrono::steady_clock::t
 
         FGpuPassTimingStats Stats;
         Stats.Name = MapIt->first;
+        const auto QueueIt = GpuTimingPassQueues.find(MapIt->first);
+        Stats.Queue = QueueIt != GpuTimingPassQueues.end() ? QueueIt->second : ERGPassQueue::Graphics;
         Stats.SampleCount = static_cast<uint32>(Samples.size());
         Stats.AvgMs = Sum / static_cast<double>(Samples.size());
         Stats.MinMs = MinValue;
@@ -103,13 +215,107 @@ void FRenderGraph::UpdateCachedGpuTimingStats(const std::chrono::steady_clock::t
         });
 }
 
+void FRenderGraph::AddPipelineStatsSamples(const FGpuTimingData& Timing, const std::chrono::steady_clock::time_point& Now)
+{
+    if (!Timing.StatsReadbackBuffer || Timing.StatsQueryCount == 0)
+    {
+        return;
+    }
+
+    const UINT64 ReadbackSize = static_cast<UINT64>(Timing.StatsQueryCount) * sizeof(D3D12_QUERY_DATA_PIPELINE_STATISTICS);
+    D3D12_QUERY_DATA_PIPELINE_STATISTICS* StatsData = nullptr;
+    D3D12_RANGE ReadRange{ 0, ReadbackSize };
+    if (FAILED(Timing.StatsReadbackBuffer->Map(0, &ReadRange, reinterpret_cast<void**>(&StatsData))) || !StatsData)
+    {
+        return;
+    }
+
+    for (const FPipelineStatsRange& Range : Timing.StatsPasses)
+    {
+        if (Range.FirstQuery + Range.QueryCount > Timing.StatsQueryCount)
+        {
+            continue;
+        }
+
+        FPipelineStatsSample Sample;
+        Sample.Timestamp = Now;
+        for (uint32 Query = Range.FirstQuery; Query < Range.FirstQuery + Range.QueryCount; ++Query)
+        {
+            const D3D12_QUERY_DATA_PIPELINE_STATISTICS& Slice = StatsData[Query];
+            Sample.Data.IAVertices += Slice.IAVertices;
+            Sample.Data.IAPrimitives += Slice.IAPrimitives;
+            Sample.Data.VSInvocations += Slice.VSInvocations;
+            Sample.Data.GSInvocations += Slice.GSInvocations;
+            Sample.Data.GSPrimitives += Slice.GSPrimitives;
+            Sample.Data.CInvocations += Slice.CInvocations;
+            Sample.Data.CPrimitives += Slice.CPrimitives;
+            Sample.Data.PSInvocations += Slice.PSInvocations;
+            Sample.Data.HSInvocations += Slice.HSInvocations;
+            Sample.Data.DSInvocations += Slice.DSInvocations;
+            Sample.Data.CSInvocations += Slice.CSInvocations;
+        }
+        PipelineStatsSamples[Range.Name].push_back(Sample);
+    }
+
+    const D3D12_RANGE EmptyRange{ 0, 0 };
+    Timing.StatsReadbackBuffer->Unmap(0, &EmptyRange);
+
+    UpdateCachedPipelineStats(Now);
+}
+
+void FRenderGraph::UpdateCachedPipelineStats(const std::chrono::steady_clock::time_point& Now)
+{
+    const double WindowSeconds = (std::max)(0.1, GpuTimingWindowSeconds);
+    const auto Cutoff = Now - std::chrono::duration<double>(WindowSeconds);
+
+    CachedPipelineStats.clear();
+    CachedPipelineStats.reserve(PipelineStatsSamples.size());
+
+    for (auto MapIt = PipelineStatsSamples.begin(); MapIt != PipelineStatsSamples.end();)
+    {
+        std::deque<FPipelineStatsSample>& Samples = MapIt->second;
+        while (!Samples.empty() && Samples.front().Timestamp < Cutoff)
+        {
+            Samples.pop_front();
+        }
+
+        if (Samples.empty())
+        {
+            MapIt = PipelineStatsSamples.erase(MapIt);
+            continue;
+        }
+
+        FGpuPassPipelineStats Stats;
+        Stats.Name = MapIt->first;
+        for (const FPipelineStatsSample& Sample : Samples)
+        {
+            Stats.IAPrimitives += static_cast<double>(Sample.Data.IAPrimitives);
+            Stats.VSInvocations += static_cast<double>(Sample.Data.VSInvocations);
+            Stats.PSInvocations += static_cast<double>(Sample.Data.PSInvocations);
+            Stats.ClippedPrimitives += static_cast<double>(Sample.Data.CPrimitives);
+            Stats.CSInvocations += static_cast<double>(Sample.Data.CSInvocations);
+        }
+
+        const double InvCount = 1.0 / static_cast<double>(Samples.size());
+        Stats.IAPrimitives *= InvCount;
+        Stats.VSInvocations *= InvCount;
+        Stats.PSInvocations *= InvCount;
+        Stats.ClippedPrimitives *= InvCount;
+        Stats.CSInvocations *= InvCount;
+        Stats.SampleCount = static_cast<uint32>(Samples.size());
+        CachedPipelineStats.push_back(std::move(Stats));
+
+        ++MapIt;
+    }
+}
+
 FRGPassBuilder::FRGPassBuilder(FRenderGraph& InGraph, FRenderGraph::PassEntry& InEntry)
     : Graph(&InGraph)
     , Entry(&InEntry)
 {
 }
 
-FRGResourceHandle FRGPassBuilder::CreateTexture(const std::string& Name, const FRGTextureDesc& Desc)
+FRGResourceHandle FRGPassBuilder::CreateTexture(std::string_view Name, const FRGTextureDesc& Desc)
 {
     return Graph->RegisterTexture(Name, Desc);
 }
@@ -126,6 +332,23 @@ FRGResourceHandle FRGPassBuilder::WriteTexture(const FRGResourceHandle& Handle,
     return Handle;
 }
 
+FRGResourceHandle FRGPassBuilder::CreateBuffer(std::string_view Name, const FRGBufferDesc& Desc)
+{
+    return Graph->RegisterBuffer(Name, Desc);
+}
+
+FRGResourceHandle FRGPassBuilder::ReadBuffer(const FRGResourceHandle& Handle, D3D12_RESOURCE_STATES RequiredState)
+{
+    Graph->RegisterUsage(*Entry, Handle, RequiredState, ERGResourceAccess::Read);
+    return Handle;
+}
+
+FRGResourceHandle FRGPassBuilder::WriteBuffer(const FRGResourceHandle& Handle, D3D12_RESOURCE_STATES RequiredState)
+{
+    Graph->RegisterUsage(*Entry, Handle, RequiredState, ERGResourceAccess::Write);
+    return Handle;
+}
+
 void FRGPassBuilder::KeepAlive()
 {
     if (Entry)
@@ -134,14 +357,22 @@ void FRGPassBuilder::KeepAlive()
     }
 }
 
+void FRGPassBuilder::AllowParallelRecording()
+{
+    if (Entry)
+    {
+        Entry->bParallelRecording = true;
+    }
+}
+
 FRGResourceHandle FRenderGraph::ImportTexture(
-    const std::string& Name,
+    std::string_view Name,
     ID3D12Resource* Resource,
     D3D12_RESOURCE_STATES* StatePtr,
     const FRGTextureDesc& Desc)
 {
     FRGResourceHandle Handle = RegisterTexture(Name, Desc);
-    FRGTextureResource& ResourceEntry = Textures[Handle.Id];
+    FRGResource& ResourceEntry = Resources[Handle.Id];
     ResourceEntry.Resource = Resource;
     ResourceEntry.ExternalState = StatePtr;
     ResourceEntry.bExternal = true;
@@ -153,13 +384,43 @@ FRGResourceHandle FRenderGraph::ImportTexture(
     return Handle;
 }
 
-FRGResourceHandle FRenderGraph::RegisterTexture(const std::string& Name, const FRGTextureDesc& Desc)
+FRGResourceHandle FRenderGraph::ImportBuffer(
+    std::string_view Name,
+    ID3D12Resource* Resource,
+    D3D12_RESOURCE_STATES* StatePtr,
+    const FRGBufferDesc& Desc)
+{
+    FRGResourceHandle Handle = RegisterBuffer(Name, Desc);
+    FRGResource& ResourceEntry = Resources[Handle.Id];
+    ResourceEntry.Resource = Resource;
+    ResourceEntry.ExternalState = StatePtr;
+    ResourceEntry.bExternal = true;
+    if (StatePtr)
+    {
+        ResourceEntry.CurrentState = *StatePtr;
+    }
+
+    return Handle;
+}
+
+FRGResourceHandle FRenderGraph::RegisterTexture(std::string_view Name, const FRGTextureDesc& Desc)
 {
-    FRGResourceHandle Handle = { static_cast<uint32>(Textures.size()) };
-    FRGTextureResource Resource = {};
-    Resource.Name = Name;
+    FRGResourceHandle Handle = { static_cast<uint32>(Resources.size()) };
+    FRGResource Resource = {};
+    Resource.Name = FrameAllocator->CopyString(Name);
     Resource.Desc = Desc;
-    Textures.push_back(Resource);
+    Resources.push_back(Resource);
+    return Handle;
+}
+
+FRGResourceHandle FRenderGraph::RegisterBuffer(std::string_view Name, const FRGBufferDesc& Desc)
+{
+    FRGResourceHandle Handle = { static_cast<uint32>(Resources.size()) };
+    FRGResource Resource = {};
+    Resource.Name = FrameAllocator->CopyString(Name);
+    Resource.Type = ERGResourceType::Buffer;
+    Resource.BufferDesc = Desc;
+    Resources.push_back(Resource);
     return Handle;
 }
 
@@ -176,12 +437,21 @@ void FRenderGraph::RegisterUsage(PassEntry& Entry, const FRGResourceHandle& Hand
 
 void FRenderGraph::AccumulateResourceFlags(const FRGResourceHandle& Handle, D3D12_RESOURCE_STATES RequiredState, ERGResourceAccess Access)
 {
-    FRGTextureResource* Resource = ResolveResource(Handle);
+    FRGResource* Resource = ResolveResource(Handle);
     if (!Resource || Resource->bExternal)
     {
         return;
     }
 
+    if (Resource->Type == ERGResourceType::Buffer)
+    {
+        if (RequiredState & D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+        {
+            Resource->Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        }
+        return;
+    }
+
     if (Access == ERGResourceAccess::Write)
     {
         if (RequiredState & D3D12_RESOURCE_STATE_RENDER_TARGET)
@@ -201,186 +471,1186 @@ void FRenderGraph::AccumulateResourceFlags(const FRGResourceHandle& Handle, D3D1
     }
 }
 
-FRenderGraph::FRGTextureResource* FRenderGraph::ResolveResource(const FRGResourceHandle& Handle)
+FRenderGraph::FRGResource* FRenderGraph::ResolveResource(const FRGResourceHandle& Handle)
 {
-    if (!Handle || Handle.Id >= Textures.size())
+    if (!Handle || Handle.Id >= Resources.size())
     {
         return nullptr;
     }
 
-    return &Textures[Handle.Id];
+    return &Resources[Handle.Id];
 }
 
-void FRenderGraph::Execute(FDX12CommandContext& CmdContext)
+namespace
 {
-    if (!Device)
-    {
-        LogError("RenderGraph Execute called without a valid device");
-        return;
-    }
+    constexpr uint64 TopologyHashOffset = 14695981039346656037ull;
+    constexpr uint64 TopologyHashPrime = 1099511628211ull;
 
-    ProcessPendingGpuTimings(CmdContext, CmdContext.GetCurrentFrameIndex());
-
-    const size_t ResourceCount = Textures.size();
-
-    std::vector<int32_t> FirstUse(ResourceCount, -1);
-    std::vector<int32_t> LastUse(ResourceCount, -1);
-    std::vector<bool> ResourceRead(ResourceCount, false);
-
-    for (int32_t PassIndex = 0; PassIndex < static_cast<int32_t>(Passes.size()); ++PassIndex)
+    void HashBytes(uint64& Hash, const void* Data, size_t Size)
     {
-        const PassEntry& Entry = Passes[PassIndex];
-        for (const FRGResourceUsage& Usage : Entry.ResourceUsages)
+        const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+        for (size_t Index = 0; Index < Size; ++Index)
         {
-            if (!Usage.Handle || Usage.Handle.Id >= Textures.size())
-            {
-                continue;
-            }
-
-            if (FirstUse[Usage.Handle.Id] == -1)
-            {
-                FirstUse[Usage.Handle.Id] = PassIndex;
-            }
-            LastUse[Usage.Handle.Id] = PassIndex;
-            if (Usage.Access == ERGResourceAccess::Read)
-            {
-                ResourceRead[Usage.Handle.Id] = true;
-            }
+            Hash ^= Bytes[Index];
+            Hash *= TopologyHashPrime;
         }
     }
 
-    for (uint32_t Index = 0; Index < ResourceCount; ++Index)
+    template <typename T>
+    void HashValue(uint64& Hash, const T& Value)
     {
-        Textures[Index].FirstUsePass = FirstUse[Index];
-        Textures[Index].LastUsePass = LastUse[Index];
+        HashBytes(Hash, &Value, sizeof(T));
     }
 
-    std::vector<bool> ResourceRequired(ResourceCount, false);
-    for (uint32_t Index = 0; Index < ResourceCount; ++Index)
+    void HashString(uint64& Hash, std::string_view Value)
     {
-        if (ResourceRead[Index])
-        {
-            ResourceRequired[Index] = true;
-        }
-        else if (Textures[Index].ExternalState && FirstUse[Index] != -1)
-        {
-            ResourceRequired[Index] = true;
-        }
+        HashValue(Hash, Value.size());
+        HashBytes(Hash, Value.data(), Value.size());
     }
 
-    std::vector<bool> PassRequired(Passes.size(), false);
-    for (int32_t PassIndex = static_cast<int32_t>(Passes.size()) - 1; PassIndex >= 0; --PassIndex)
+    struct FEnhancedBarrierScope
     {
-        const PassEntry& Entry = Passes[PassIndex];
-        bool bTouchesRequiredResource = false;
+        D3D12_BARRIER_SYNC Sync = D3D12_BARRIER_SYNC_NONE;
+        D3D12_BARRIER_ACCESS Access = D3D12_BARRIER_ACCESS_COMMON;
+        D3D12_BARRIER_LAYOUT Layout = D3D12_BARRIER_LAYOUT_COMMON;
+    };
 
-        for (const FRGResourceUsage& Usage : Entry.ResourceUsages)
+    // Enhanced barrier scope equivalent to a legacy state. Layouts follow the legacy
+    // compatibility table, so resources tracked in legacy states elsewhere stay valid.
+    FEnhancedBarrierScope GetEnhancedBarrierScope(D3D12_RESOURCE_STATES State, bool bComputeList)
+    {
+        FEnhancedBarrierScope Scope;
+        if (State == D3D12_RESOURCE_STATE_COMMON)
         {
-            if (!Usage.Handle || Usage.Handle.Id >= Textures.size())
-            {
-                continue;
-            }
+            Scope.Sync = D3D12_BARRIER_SYNC_ALL;
+            return Scope;
+        }
 
-            if (ResourceRequired[Usage.Handle.Id])
+        const D3D12_BARRIER_SYNC ShadingSync = bComputeList ? D3D12_BARRIER_SYNC_COMPUTE_SHADING : D3D12_BARRIER_SYNC_ALL_SHADING;
+
+        struct FStateScope
+        {
+            D3D12_RESOURCE_STATES State;
+            D3D12_BARRIER_SYNC Sync;
+            D3D12_BARRIER_ACCESS Access;
+        };
+
+        const FStateScope StateScopes[] =
+        {
+            { D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, ShadingSync, D3D12_BARRIER_ACCESS_VERTEX_BUFFER | D3D12_BARRIER_ACCESS_CONSTANT_BUFFER },
+            { D3D12_RESOURCE_STATE_INDEX_BUFFER, D3D12_BARRIER_SYNC_INDEX_INPUT, D3D12_BARRIER_ACCESS_INDEX_BUFFER },
+            { D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_BARRIER_SYNC_RENDER_TARGET, D3D12_BARRIER_ACCESS_RENDER_TARGET },
+            { D3D12_RESOURCE_STATE_UNORDERED_ACCESS, ShadingSync, D3D12_BARRIER_ACCESS_UNORDERED_ACCESS },
+            { D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_BARRIER_SYNC_DEPTH_STENCIL, D3D12_BARRIER_ACCESS_DEPTH_STENCIL_WRITE },
+            { D3D12_RESOURCE_STATE_DEPTH_READ, D3D12_BARRIER_SYNC_DEPTH_STENCIL, D3D12_BARRIER_ACCESS_DEPTH_STENCIL_READ },
+            { D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, bComputeList ? D3D12_BARRIER_SYNC_COMPUTE_SHADING : D3D12_BARRIER_SYNC_NON_PIXEL_SHADING, D3D12_BARRIER_ACCESS_SHADER_RESOURCE },
+            { D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_BARRIER_SYNC_PIXEL_SHADING, D3D12_BARRIER_ACCESS_SHADER_RESOURCE },
+            { D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT, D3D12_BARRIER_SYNC_EXECUTE_INDIRECT, D3D12_BARRIER_ACCESS_INDIRECT_ARGUMENT },
+            { D3D12_RESOURCE_STATE_COPY_DEST, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_DEST },
+            { D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_SOURCE },
+            { D3D12_RESOURCE_STATE_RESOLVE_DEST, D3D12_BARRIER_SYNC_RESOLVE, D3D12_BARRIER_ACCESS_RESOLVE_DEST },
+            { D3D12_RESOURCE_STATE_RESOLVE_SOURCE, D3D12_BARRIER_SYNC_RESOLVE, D3D12_BARRIER_ACCESS_RESOLVE_SOURCE },
+            { D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE, D3D12_BARRIER_SYNC_PIXEL_SHADING, D3D12_BARRIER_ACCESS_SHADING_RATE_SOURCE },
+        };
+
+        D3D12_RESOURCE_STATES Remaining = State;
+        for (const FStateScope& Entry : StateScopes)
+        {
+            if ((State & Entry.State) == Entry.State)
             {
-                bTouchesRequiredResource = true;
-                break;
+                Scope.Sync |= Entry.Sync;
+                Scope.Access |= Entry.Access;
+                Remaining &= ~Entry.State;
             }
         }
 
-        if (!bTouchesRequiredResource && !Entry.bForceExecute)
+        // States without a direct equivalent (stream out, acceleration structures) wait on everything.
+        if (Remaining != 0 || Scope.Sync == D3D12_BARRIER_SYNC_NONE)
         {
-            continue;
+            Scope.Sync = D3D12_BARRIER_SYNC_ALL;
+            Scope.Access = D3D12_BARRIER_ACCESS_COMMON;
+            Scope.Layout = D3D12_BARRIER_LAYOUT_COMMON;
+            return Scope;
         }
 
-        PassRequired[PassIndex] = true;
+        constexpr D3D12_RESOURCE_STATES ShaderResourceStates =
+            D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
 
-        for (const FRGResourceUsage& Usage : Entry.ResourceUsages)
+        if (State & D3D12_RESOURCE_STATE_DEPTH_WRITE)
         {
-            if (!Usage.Handle || Usage.Handle.Id >= Textures.size())
-            {
-                continue;
-            }
-
-            ResourceRequired[Usage.Handle.Id] = true;
+            Scope.Layout = D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE;
+        }
+        else if (State & D3D12_RESOURCE_STATE_DEPTH_READ)
+        {
+            Scope.Layout = D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_READ;
+        }
+        else if (State == D3D12_RESOURCE_STATE_RENDER_TARGET)
+        {
+            Scope.Layout = D3D12_BARRIER_LAYOUT_RENDER_TARGET;
+        }
+        else if (State == D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+        {
+            Scope.Layout = D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS;
+        }
+        else if (State == D3D12_RESOURCE_STATE_COPY_DEST)
+        {
+            Scope.Layout = D3D12_BARRIER_LAYOUT_COPY_DEST;
         }
+        else if (State == D3D12_RESOURCE_STATE_COPY_SOURCE)
+        {
+            Scope.Layout = D3D12_BARRIER_LAYOUT_COPY_SOURCE;
+        }
+        else if (State == D3D12_RESOURCE_STATE_RESOLVE_DEST)
+        {
+            Scope.Layout = D3D12_BARRIER_LAYOUT_RESOLVE_DEST;
+        }
+        else if (State == D3D12_RESOURCE_STATE_RESOLVE_SOURCE)
+        {
+            Scope.Layout = D3D12_BARRIER_LAYOUT_RESOLVE_SOURCE;
+        }
+        else if (State == D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE)
+        {
+            Scope.Layout = D3D12_BARRIER_LAYOUT_SHADING_RATE_SOURCE;
+        }
+        else if ((State & ~ShaderResourceStates) == 0)
+        {
+            Scope.Layout = D3D12_BARRIER_LAYOUT_SHADER_RESOURCE;
+        }
+        else
+        {
+            Scope.Layout = D3D12_BARRIER_LAYOUT_GENERIC_READ;
+        }
+
+        return Scope;
     }
 
-    if (bEnableGraphDump)
+    // States a compute queue is allowed to transition into or out of.
+    bool IsComputeQueueState(D3D12_RESOURCE_STATES State)
     {
-        DumpDebugInfo(PassRequired, ResourceRequired);
+        constexpr D3D12_RESOURCE_STATES ComputeStates =
+            D3D12_RESOURCE_STATE_UNORDERED_ACCESS |
+            D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE |
+            D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT |
+            D3D12_RESOURCE_STATE_COPY_DEST |
+            D3D12_RESOURCE_STATE_COPY_SOURCE;
+        return (State & ~ComputeStates) == 0;
     }
 
-    uint32 ActivePassCount = 0;
-    for (int32_t PassIndex = 0; PassIndex < static_cast<int32_t>(Passes.size()); ++PassIndex)
+    uint64 AlignUp(uint64 Value, uint64 Alignment)
     {
-        if (PassRequired[PassIndex])
-        {
-            ActivePassCount++;
-        }
+        return Alignment > 0 ? (Value + Alignment - 1) / Alignment * Alignment : Value;
     }
 
-    const bool bDoGpuTiming = bEnableGpuTiming && ActivePassCount > 0;
-    std::vector<std::string> GpuTimedPassNames;
-    Microsoft::WRL::ComPtr<ID3D12QueryHeap> QueryHeap;
-    Microsoft::WRL::ComPtr<ID3D12Resource> QueryReadback;
-    uint64 TimestampFrequency = 0;
-    uint32 QueryIndex = 0;
+    D3D12_RESOURCE_DESC BuildTransientTextureDesc(const FRGTextureDesc& Desc, D3D12_RESOURCE_FLAGS Flags)
+    {
+        D3D12_RESOURCE_DESC ResourceDesc = {};
+        ResourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        ResourceDesc.Alignment = 0;
+        ResourceDesc.Width = Desc.Width;
+        ResourceDesc.Height = Desc.Height;
+        ResourceDesc.DepthOrArraySize = 1;
+        ResourceDesc.MipLevels = 1;
+        ResourceDesc.Format = Desc.Format;
+        ResourceDesc.SampleDesc.Count = 1;
+        ResourceDesc.SampleDesc.Quality = 0;
+        ResourceDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        ResourceDesc.Flags = Flags;
+        return ResourceDesc;
+    }
 
-    if (bDoGpuTiming)
+    D3D12_CLEAR_VALUE* BuildTransientClearValue(const FRGTextureDesc& Desc, D3D12_RESOURCE_FLAGS Flags, D3D12_CLEAR_VALUE& OutClearValue)
     {
-        const uint32 FrameIndex = CmdContext.GetCurrentFrameIndex();
-        ID3D12CommandQueue* Queue = CmdContext.GetQueue() ? CmdContext.GetQueue()->GetD3DQueue() : nullptr;
-        ID3D12Device* D3DDevice = Device->GetDevice();
+        OutClearValue = {};
+        if (Flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET)
+        {
+            OutClearValue.Format = Desc.Format;
+            OutClearValue.Color[0] = 0.0f;
+            OutClearValue.Color[1] = 0.0f;
+            OutClearValue.Color[2] = 0.0f;
+            OutClearValue.Color[3] = 0.0f;
+            return &OutClearValue;
+        }
 
-        if (Queue && D3DDevice)
+        if (Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)
         {
-            Queue->GetTimestampFrequency(&TimestampFrequency);
+            OutClearValue.Format = Desc.Format;
+            OutClearValue.DepthStencil.Depth = 1.0f;
+            OutClearValue.DepthStencil.Stencil = 0;
+            return &OutClearValue;
+        }
 
-            FGpuTimingResources& Resources = GpuTimingResources[FrameIndex];
-            const uint32 NeededQueryCount = ActivePassCount * 2;
+        return nullptr;
+    }
+}
 
-            if (!Resources.QueryHeap || !Resources.ReadbackBuffer || Resources.QueryCapacity < NeededQueryCount)
-            {
-                D3D12_QUERY_HEAP_DESC HeapDesc = {};
-                HeapDesc.Count = NeededQueryCount;
-                HeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
-                HeapDesc.NodeMask = 0;
+uint64 FRenderGraph::ComputeTopologyHash(bool bAsyncComputeAvailable) const
+{
+    uint64 Hash = TopologyHashOffset;
+    HashValue(Hash, bAsyncComputeAvailable);
 
-                if (SUCCEEDED(D3DDevice->CreateQueryHeap(&HeapDesc, IID_PPV_ARGS(Resources.QueryHeap.ReleaseAndGetAddressOf()))))
-                {
-                    const UINT64 ReadbackSize = static_cast<UINT64>(HeapDesc.Count) * sizeof(uint64);
+    HashValue(Hash, Resources.size());
+    for (const FRGResource& Resource : Resources)
+    {
+        HashString(Hash, Resource.Name);
+        HashValue(Hash, Resource.Type);
+        HashValue(Hash, Resource.BufferDesc.Size);
+        HashValue(Hash, Resource.Desc.Width);
+        HashValue(Hash, Resource.Desc.Height);
+        HashValue(Hash, Resource.Desc.Format);
+        HashValue(Hash, Resource.Flags);
+        HashValue(Hash, Resource.bExternal);
+        HashValue(Hash, Resource.ExternalState != nullptr);
+        HashValue(Hash, Resource.Resource != nullptr);
+    }
+
+    HashValue(Hash, Passes.size());
+    for (const PassEntry& Entry : Passes)
+    {
+        HashString(Hash, Entry.Name);
+        HashValue(Hash, Entry.bForceExecute);
+        HashValue(Hash, Entry.Queue);
+        HashValue(Hash, Entry.ResourceUsages.size());
+        for (const FRGResourceUsage& Usage : Entry.ResourceUsages)
+        {
+            HashValue(Hash, Usage.Handle.Id);
+            HashValue(Hash, Usage.RequiredState);
+            HashValue(Hash, Usage.Access);
+        }
+    }
+
+    return Hash;
+}
+
+D3D12_RESOURCE_STATES FRenderGraph::GetResourceState(const FRGResource& Resource) const
+{
+    return Resource.ExternalState ? *Resource.ExternalState : Resource.CurrentState;
+}
+
+bool FRenderGraph::IsCompiledGraphValid(const FCompiledGraph& Compiled) const
+{
+    if (Compiled.InitialStates.size() != Resources.size() || Compiled.PassRequired.size() != Passes.size())
+    {
+        return false;
+    }
+
+    // The cached barriers assume every imported resource arrives in the state it had when
+    // the graph was compiled, and that pooled textures were left where this topology left them.
+    for (size_t Index = 0; Index < Resources.size(); ++Index)
+    {
+        const FRGResource& Resource = Resources[Index];
+        if (Resource.bExternal && Resource.Resource && GetResourceState(Resource) != Compiled.InitialStates[Index])
+        {
+            return false;
+        }
+    }
+
+    for (const auto& PoolState : Compiled.PoolInitialStates)
+    {
+        if (PoolState.first < 0 || PoolState.first >= static_cast<int32>(ResourcePool.size()))
+        {
+            return false;
+        }
+
+        const FPooledResource& Pooled = ResourcePool[PoolState.first];
+        if (Pooled.bInUse || Pooled.CurrentState != PoolState.second)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void FRenderGraph::CompileGraph(uint64 TopologyHash, bool bAsyncComputeAvailable, FCompiledGraph& OutCompiled)
+{
+    const size_t ResourceCount = Resources.size();
+    const int32 PassCount = static_cast<int32>(Passes.size());
+
+    OutCompiled = FCompiledGraph();
+    OutCompiled.TopologyHash = TopologyHash;
+    OutCompiled.FirstUse.assign(ResourceCount, -1);
+    OutCompiled.LastUse.assign(ResourceCount, -1);
+    OutCompiled.PoolIndices.assign(ResourceCount, -1);
+    OutCompiled.InitialStates.assign(ResourceCount, D3D12_RESOURCE_STATE_COMMON);
+    OutCompiled.CompiledPasses.resize(Passes.size());
+
+    std::vector<int32>& FirstUse = OutCompiled.FirstUse;
+    std::vector<int32>& LastUse = OutCompiled.LastUse;
+    std::vector<bool> ResourceRead(ResourceCount, false);
+
+    for (int32 PassIndex = 0; PassIndex < PassCount; ++PassIndex)
+    {
+        const PassEntry& Entry = Passes[PassIndex];
+        for (const FRGResourceUsage& Usage : Entry.ResourceUsages)
+        {
+            if (!Usage.Handle || Usage.Handle.Id >= ResourceCount)
+            {
+                continue;
+            }
+
+            if (FirstUse[Usage.Handle.Id] == -1)
+            {
+                FirstUse[Usage.Handle.Id] = PassIndex;
+            }
+            LastUse[Usage.Handle.Id] = PassIndex;
+            if (Usage.Access == ERGResourceAccess::Read)
+            {
+                ResourceRead[Usage.Handle.Id] = true;
+            }
+        }
+    }
+
+    std::vector<bool>& ResourceRequired = OutCompiled.ResourceRequired;
+    ResourceRequired.assign(ResourceCount, false);
+    for (uint32_t Index = 0; Index < ResourceCount; ++Index)
+    {
+        if (ResourceRead[Index])
+        {
+            ResourceRequired[Index] = true;
+        }
+        else if (Resources[Index].ExternalState && FirstUse[Index] != -1)
+        {
+            ResourceRequired[Index] = true;
+        }
+    }
+
+    std::vector<bool>& PassRequired = OutCompiled.PassRequired;
+    PassRequired.assign(Passes.size(), false);
+    for (int32 PassIndex = PassCount - 1; PassIndex >= 0; --PassIndex)
+    {
+        const PassEntry& Entry = Passes[PassIndex];
+        bool bTouchesRequiredResource = false;
+
+        for (const FRGResourceUsage& Usage : Entry.ResourceUsages)
+        {
+            if (!Usage.Handle || Usage.Handle.Id >= ResourceCount)
+            {
+                continue;
+            }
+
+            if (ResourceRequired[Usage.Handle.Id])
+            {
+                bTouchesRequiredResource = true;
+                break;
+            }
+        }
+
+        if (!bTouchesRequiredResource && !Entry.bForceExecute)
+        {
+            continue;
+        }
+
+        PassRequired[PassIndex] = true;
+        OutCompiled.ActivePassCount++;
+
+        for (const FRGResourceUsage& Usage : Entry.ResourceUsages)
+        {
+            if (!Usage.Handle || Usage.Handle.Id >= ResourceCount)
+            {
+                continue;
+            }
+
+            ResourceRequired[Usage.Handle.Id] = true;
+        }
+    }
+
+    // Resolve queue affinity. A run of async compute passes forks off the graphics queue
+    // before its first pass and joins back before the first graphics pass that touches any
+    // resource the run used, or before an async pass that needs something graphics touched
+    // since the fork.
+    std::vector<ERGPassQueue> PassQueues(Passes.size(), ERGPassQueue::Graphics);
+    std::vector<uint32> PassEpochs(Passes.size(), 0);
+    std::vector<int32> RunForkPass(Passes.size(), -1);
+    std::vector<int32> RunJoinPass(Passes.size(), -1);
+    int32 LastRequiredPass = -1;
+    {
+        std::vector<bool> AsyncTouched(ResourceCount, false);
+        std::vector<bool> GraphicsTouched(ResourceCount, false);
+        std::vector<int32> OpenRunPasses;
+        bool bAsyncOpen = false;
+        int32 ForkPass = -1;
+        uint32 Epoch = 0;
+
+        const auto CloseRun = [&](int32 JoinPass)
+        {
+            for (int32 RunPass : OpenRunPasses)
+            {
+                RunJoinPass[RunPass] = JoinPass;
+            }
+            OpenRunPasses.clear();
+            AsyncTouched.assign(ResourceCount, false);
+            GraphicsTouched.assign(ResourceCount, false);
+            bAsyncOpen = false;
+            ++Epoch;
+        };
+
+        for (int32 PassIndex = 0; PassIndex < PassCount; ++PassIndex)
+        {
+            if (!PassRequired[PassIndex])
+            {
+                continue;
+            }
+
+            LastRequiredPass = PassIndex;
+            const PassEntry& Entry = Passes[PassIndex];
+            FCompiledPass& CompiledPass = OutCompiled.CompiledPasses[PassIndex];
+
+            bool bComputeCompatible = bAsyncComputeAvailable && Entry.Queue == ERGPassQueue::AsyncCompute;
+            bool bUsesAsyncResource = false;
+            bool bUsesGraphicsResource = false;
+            for (const FRGResourceUsage& Usage : Entry.ResourceUsages)
+            {
+                if (!Usage.Handle || Usage.Handle.Id >= ResourceCount)
+                {
+                    continue;
+                }
+
+                bComputeCompatible = bComputeCompatible && IsComputeQueueState(Usage.RequiredState);
+                bUsesAsyncResource = bUsesAsyncResource || AsyncTouched[Usage.Handle.Id];
+                bUsesGraphicsResource = bUsesGraphicsResource || GraphicsTouched[Usage.Handle.Id];
+            }
+
+            if (bComputeCompatible)
+            {
+                if (bAsyncOpen && bUsesGraphicsResource)
+                {
+                    CompiledPass.bJoinBefore = true;
+                    CloseRun(PassIndex);
+                }
+
+                if (!bAsyncOpen)
+                {
+                    CompiledPass.bForkBefore = true;
+                    bAsyncOpen = true;
+                    ForkPass = PassIndex;
+                    ++Epoch;
+                }
+
+                PassQueues[PassIndex] = ERGPassQueue::AsyncCompute;
+                RunForkPass[PassIndex] = ForkPass;
+                OpenRunPasses.push_back(PassIndex);
+            }
+            else if (bAsyncOpen && bUsesAsyncResource)
+            {
+                CompiledPass.bJoinBefore = true;
+                CloseRun(PassIndex);
+            }
+
+            CompiledPass.Queue = PassQueues[PassIndex];
+            PassEpochs[PassIndex] = Epoch;
+
+            for (const FRGResourceUsage& Usage : Entry.ResourceUsages)
+            {
+                if (!Usage.Handle || Usage.Handle.Id >= ResourceCount || !bAsyncOpen)
+                {
+                    continue;
+                }
+
+                if (PassQueues[PassIndex] == ERGPassQueue::AsyncCompute)
+                {
+                    AsyncTouched[Usage.Handle.Id] = true;
+                }
+                else
+                {
+                    GraphicsTouched[Usage.Handle.Id] = true;
+                }
+            }
+        }
+
+        OutCompiled.bJoinAtEnd = bAsyncOpen;
+        if (bAsyncOpen)
+        {
+            CloseRun(LastRequiredPass);
+        }
+    }
+
+    // Transients are released after the last pass that actually runs, not the last pass
+    // that mentions them, so a culled tail pass cannot leave a pool entry marked in use.
+    // Resources touched on the compute queue stay reserved from the fork to the join,
+    // since graphics work in between runs concurrently with them.
+    std::vector<int32> FirstRequiredUse(ResourceCount, -1);
+    std::vector<int32> LastRequiredUse(ResourceCount, -1);
+    std::vector<D3D12_RESOURCE_STATES> FirstRequiredState(ResourceCount, D3D12_RESOURCE_STATE_COMMON);
+    for (int32 PassIndex = 0; PassIndex < PassCount; ++PassIndex)
+    {
+        if (!PassRequired[PassIndex])
+        {
+            continue;
+        }
+
+        const bool bAsyncPass = PassQueues[PassIndex] == ERGPassQueue::AsyncCompute;
+        const int32 BeginPass = bAsyncPass ? RunForkPass[PassIndex] : PassIndex;
+        const int32 EndPass = bAsyncPass ? RunJoinPass[PassIndex] : PassIndex;
+
+        for (const FRGResourceUsage& Usage : Passes[PassIndex].ResourceUsages)
+        {
+            if (!Usage.Handle || Usage.Handle.Id >= ResourceCount)
+            {
+                continue;
+            }
+
+            const uint32 ResourceId = Usage.Handle.Id;
+            if (FirstRequiredUse[ResourceId] == -1)
+            {
+                FirstRequiredUse[ResourceId] = BeginPass;
+                FirstRequiredState[ResourceId] = Usage.RequiredState;
+            }
+            FirstRequiredUse[ResourceId] = (std::min)(FirstRequiredUse[ResourceId], BeginPass);
+            LastRequiredUse[ResourceId] = (std::max)(LastRequiredUse[ResourceId], EndPass);
+        }
+    }
+
+    std::vector<std::vector<uint32>> ReleasesByPass(Passes.size());
+    for (uint32 Index = 0; Index < ResourceCount; ++Index)
+    {
+        if (!Resources[Index].bExternal && LastRequiredUse[Index] >= 0)
+        {
+            ReleasesByPass[LastRequiredUse[Index]].push_back(Index);
+        }
+    }
+
+    std::vector<int32> PlacedPoolIndices;
+    PlaceTransientResources(FirstRequiredUse, LastRequiredUse, FirstRequiredState, PlacedPoolIndices);
+
+    // Walk the required passes once, assigning pool entries and recording every transition
+    // against a simulated state so later frames can replay the plan without re-deriving it.
+    std::vector<D3D12_RESOURCE_STATES> SimulatedStates(ResourceCount, D3D12_RESOURCE_STATE_COMMON);
+    std::vector<bool> ResourceAvailable(ResourceCount, false);
+    std::unordered_map<int32, D3D12_RESOURCE_STATES> PoolStates;
+    OutCompiled.FinalStates.assign(ResourceCount, D3D12_RESOURCE_STATE_COMMON);
+
+    for (uint32_t Index = 0; Index < ResourceCount; ++Index)
+    {
+        const FRGResource& Resource = Resources[Index];
+        if (Resource.bExternal && Resource.Resource)
+        {
+            SimulatedStates[Index] = GetResourceState(Resource);
+            OutCompiled.InitialStates[Index] = SimulatedStates[Index];
+            ResourceAvailable[Index] = true;
+        }
+    }
+
+    // A transition is split when an executed pass sits between the previous use of a resource
+    // and the pass that needs the new state: it begins at the boundary right after the previous
+    // use and ends just before the consumer, giving the GPU the gap to resolve it. Splits never
+    // cross a queue or a fork/join point.
+    std::vector<std::vector<FCompiledBarrier>> PassBarriers(Passes.size());
+    std::vector<std::vector<FCompiledBarrier>> ForkBarriers(Passes.size());
+    std::vector<int32> PreviousUse(ResourceCount, -1);
+    std::vector<int32> NextRequiredPass(Passes.size(), -1);
+    int32 NextPass = -1;
+    for (int32 PassIndex = PassCount - 1; PassIndex >= 0; --PassIndex)
+    {
+        NextRequiredPass[PassIndex] = NextPass;
+        if (PassRequired[PassIndex])
+        {
+            NextPass = PassIndex;
+        }
+    }
+
+    for (int32 PassIndex = 0; PassIndex < PassCount; ++PassIndex)
+    {
+        if (!PassRequired[PassIndex])
+        {
+            continue;
+        }
+
+        const PassEntry& Entry = Passes[PassIndex];
+        const bool bAsyncPass = PassQueues[PassIndex] == ERGPassQueue::AsyncCompute;
+        FCompiledPass& CompiledPass = OutCompiled.CompiledPasses[PassIndex];
+        CompiledPass.FirstAcquire = static_cast<uint32>(OutCompiled.Acquires.size());
+        CompiledPass.FirstDiscard = static_cast<uint32>(OutCompiled.Discards.size());
+
+        for (const FRGResourceUsage& Usage : Entry.ResourceUsages)
+        {
+            if (!Usage.Handle || Usage.Handle.Id >= ResourceCount)
+            {
+                continue;
+            }
+
+            const uint32 ResourceId = Usage.Handle.Id;
+            const FRGResource& Resource = Resources[ResourceId];
+
+            if (!Resource.bExternal && OutCompiled.PoolIndices[ResourceId] == -1 && FirstUse[ResourceId] != -1)
+            {
+                const bool bPlaced = PlacedPoolIndices[ResourceId] >= 0;
+                const int32 PoolIndex = bPlaced ? PlacedPoolIndices[ResourceId] : AcquireTransientResource(Resource, Usage.RequiredState);
+                if (PoolIndex >= 0)
+                {
+                    ResourcePool[PoolIndex].bInUse = true;
+
+                    auto PoolState = PoolStates.find(PoolIndex);
+                    if (PoolState == PoolStates.end())
+                    {
+                        PoolState = PoolStates.emplace(PoolIndex, ResourcePool[PoolIndex].CurrentState).first;
+                        OutCompiled.PoolInitialStates.emplace_back(PoolIndex, PoolState->second);
+                    }
+
+                    OutCompiled.PoolIndices[ResourceId] = PoolIndex;
+                    OutCompiled.InitialStates[ResourceId] = PoolState->second;
+                    OutCompiled.Acquires.push_back(ResourceId);
+                    SimulatedStates[ResourceId] = PoolState->second;
+                    ResourceAvailable[ResourceId] = true;
+
+                    // Placed memory may have been owned by another transient since this one was
+                    // last used, so activate it and discard stale contents of render targets.
+                    if (bPlaced)
+                    {
+                        FCompiledBarrier AliasingBarrier;
+                        AliasingBarrier.ResourceId = ResourceId;
+                        AliasingBarrier.bAliasing = true;
+                        AliasingBarrier.bDiscard = Usage.Access == ERGResourceAccess::Write &&
+                            (Usage.RequiredState & (D3D12_RESOURCE_STATE_RENDER_TARGET | D3D12_RESOURCE_STATE_DEPTH_WRITE));
+                        (bAsyncPass ? ForkBarriers[RunForkPass[PassIndex]] : PassBarriers[PassIndex]).push_back(AliasingBarrier);
+
+                        if (AliasingBarrier.bDiscard)
+                        {
+                            OutCompiled.Discards.push_back(ResourceId);
+                        }
+                    }
+                }
+            }
+
+            if (!ResourceAvailable[ResourceId])
+            {
+                continue;
+            }
+
+            if (SimulatedStates[ResourceId] != Usage.RequiredState)
+            {
+                FCompiledBarrier Transition;
+                Transition.ResourceId = ResourceId;
+                Transition.StateBefore = SimulatedStates[ResourceId];
+                Transition.StateAfter = Usage.RequiredState;
+
+                const int32 PreviousPass = PreviousUse[ResourceId];
+                const bool bSameRun = PreviousPass >= 0 &&
+                    PassQueues[PreviousPass] == PassQueues[PassIndex] &&
+                    PassEpochs[PreviousPass] == PassEpochs[PassIndex];
+
+                if (bAsyncPass && !bSameRun)
+                {
+                    // The resource arrives from the graphics queue, which owns the handover and
+                    // may be the only queue able to leave the previous state.
+                    ForkBarriers[RunForkPass[PassIndex]].push_back(Transition);
+                }
+                else
+                {
+                    const int32 SplitPass = bSameRun ? NextRequiredPass[PreviousPass] : -1;
+                    if (SplitPass >= 0 && SplitPass < PassIndex &&
+                        PassQueues[SplitPass] == PassQueues[PassIndex] &&
+                        PassEpochs[SplitPass] == PassEpochs[PassIndex])
+                    {
+                        FCompiledBarrier BeginTransition = Transition;
+                        BeginTransition.Flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+                        BeginTransition.PairedPass = PassIndex;
+                        PassBarriers[SplitPass].push_back(BeginTransition);
+
+                        Transition.Flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+                        Transition.PairedPass = PreviousPass;
+                    }
+
+                    PassBarriers[PassIndex].push_back(Transition);
+                }
+
+                SimulatedStates[ResourceId] = Usage.RequiredState;
+            }
+
+            PreviousUse[ResourceId] = PassIndex;
+        }
+
+        CompiledPass.FirstRelease = static_cast<uint32>(OutCompiled.Releases.size());
+        for (uint32 ResourceId : ReleasesByPass[PassIndex])
+        {
+            const int32 PoolIndex = OutCompiled.PoolIndices[ResourceId];
+            if (PoolIndex < 0 || !ResourceAvailable[ResourceId])
+            {
+                continue;
+            }
+
+            ResourcePool[PoolIndex].bInUse = false;
+            PoolStates[PoolIndex] = SimulatedStates[ResourceId];
+            OutCompiled.FinalStates[ResourceId] = SimulatedStates[ResourceId];
+            ResourceAvailable[ResourceId] = false;
+            OutCompiled.Releases.push_back(ResourceId);
+        }
+
+        CompiledPass.AcquireCount = static_cast<uint32>(OutCompiled.Acquires.size()) - CompiledPass.FirstAcquire;
+        CompiledPass.DiscardCount = static_cast<uint32>(OutCompiled.Discards.size()) - CompiledPass.FirstDiscard;
+        CompiledPass.ReleaseCount = static_cast<uint32>(OutCompiled.Releases.size()) - CompiledPass.FirstRelease;
+    }
+
+    for (int32 PassIndex = 0; PassIndex < PassCount; ++PassIndex)
+    {
+        FCompiledPass& CompiledPass = OutCompiled.CompiledPasses[PassIndex];
+        CompiledPass.FirstForkBarrier = static_cast<uint32>(OutCompiled.Barriers.size());
+        CompiledPass.ForkBarrierCount = static_cast<uint32>(ForkBarriers[PassIndex].size());
+        OutCompiled.Barriers.insert(OutCompiled.Barriers.end(), ForkBarriers[PassIndex].begin(), ForkBarriers[PassIndex].end());
+
+        CompiledPass.FirstBarrier = static_cast<uint32>(OutCompiled.Barriers.size());
+        CompiledPass.BarrierCount = static_cast<uint32>(PassBarriers[PassIndex].size());
+        OutCompiled.Barriers.insert(OutCompiled.Barriers.end(), PassBarriers[PassIndex].begin(), PassBarriers[PassIndex].end());
+    }
+}
+
+void FRenderGraph::EmitCompiledBarriers(FDX12CommandContext& Context, const FCompiledGraph& Compiled, uint32 FirstBarrier, uint32 BarrierCount, const PassEntry& Entry)
+{
+    const bool bEnhanced = bUseEnhancedBarriers && Context.SupportsEnhancedBarriers();
+    const bool bComputeList = Context.GetQueueType() == EDX12QueueType::Compute;
+
+    BarrierScratch.clear();
+    TextureBarrierScratch.clear();
+    BufferBarrierScratch.clear();
+
+    for (uint32 Index = 0; Index < BarrierCount; ++Index)
+    {
+        const FCompiledBarrier& Planned = Compiled.Barriers[FirstBarrier + Index];
+        FRGResource& Resource = Resources[Planned.ResourceId];
+
+        if (Planned.bAliasing)
+        {
+            if (bEnhanced)
+            {
+                // Activating placed memory: nothing to preserve, so start from UNDEFINED and
+                // discard in the same barrier instead of a separate DiscardResource.
+                const FEnhancedBarrierScope After = GetEnhancedBarrierScope(Compiled.InitialStates[Planned.ResourceId], bComputeList);
+                if (Resource.Type == ERGResourceType::Buffer)
+                {
+                    D3D12_BUFFER_BARRIER Barrier = {};
+                    Barrier.SyncBefore = D3D12_BARRIER_SYNC_ALL;
+                    Barrier.SyncAfter = After.Sync;
+                    Barrier.AccessBefore = D3D12_BARRIER_ACCESS_NO_ACCESS;
+                    Barrier.AccessAfter = After.Access;
+                    Barrier.pResource = Resource.Resource;
+                    Barrier.Offset = 0;
+                    Barrier.Size = UINT64_MAX;
+                    BufferBarrierScratch.push_back(Barrier);
+                }
+                else
+                {
+                    D3D12_TEXTURE_BARRIER Barrier = {};
+                    Barrier.SyncBefore = D3D12_BARRIER_SYNC_ALL;
+                    Barrier.SyncAfter = After.Sync;
+                    Barrier.AccessBefore = D3D12_BARRIER_ACCESS_NO_ACCESS;
+                    Barrier.AccessAfter = After.Access;
+                    Barrier.LayoutBefore = D3D12_BARRIER_LAYOUT_UNDEFINED;
+                    Barrier.LayoutAfter = After.Layout;
+                    Barrier.pResource = Resource.Resource;
+                    Barrier.Subresources.IndexOrFirstMipLevel = 0xffffffff;
+                    Barrier.Flags = Planned.bDiscard ? D3D12_TEXTURE_BARRIER_FLAG_DISCARD : D3D12_TEXTURE_BARRIER_FLAG_NONE;
+                    TextureBarrierScratch.push_back(Barrier);
+                }
+            }
+            else
+            {
+                D3D12_RESOURCE_BARRIER Barrier = {};
+                Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+                Barrier.Aliasing.pResourceBefore = nullptr;
+                Barrier.Aliasing.pResourceAfter = Resource.Resource;
+                BarrierScratch.push_back(Barrier);
+            }
+
+            if (bEnableBarrierLogs)
+            {
+                LogInfo("[RG] Pass '" + std::string(Entry.Name) + "' aliasing '" + (Resource.Name.empty() ? std::string("<Unnamed>") : std::string(Resource.Name)) + "'" +
+                    (bEnhanced && Planned.bDiscard && Resource.Type == ERGResourceType::Texture ? " (discard)" : ""));
+            }
+            continue;
+        }
+
+        std::string EnhancedLayouts;
+        if (bEnhanced)
+        {
+            const FEnhancedBarrierScope Before = GetEnhancedBarrierScope(Planned.StateBefore, bComputeList);
+            const FEnhancedBarrierScope After = GetEnhancedBarrierScope(Planned.StateAfter, bComputeList);
+            const D3D12_BARRIER_SYNC SyncBefore = Planned.Flags == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY ? D3D12_BARRIER_SYNC_SPLIT : Before.Sync;
+            const D3D12_BARRIER_SYNC SyncAfter = Planned.Flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY ? D3D12_BARRIER_SYNC_SPLIT : After.Sync;
+
+            if (Resource.Type == ERGResourceType::Buffer)
+            {
+                // Fold into the aliasing barrier recorded for this buffer in the same batch.
+                D3D12_BUFFER_BARRIER* Existing = nullptr;
+                for (D3D12_BUFFER_BARRIER& Pending : BufferBarrierScratch)
+                {
+                    if (Pending.pResource == Resource.Resource && Pending.AccessBefore == D3D12_BARRIER_ACCESS_NO_ACCESS)
+                    {
+                        Existing = &Pending;
+                    }
+                }
+
+                if (Existing)
+                {
+                    Existing->SyncAfter = SyncAfter;
+                    Existing->AccessAfter = After.Access;
+                }
+                else
+                {
+                    D3D12_BUFFER_BARRIER Barrier = {};
+                    Barrier.SyncBefore = SyncBefore;
+                    Barrier.SyncAfter = SyncAfter;
+                    Barrier.AccessBefore = Before.Access;
+                    Barrier.AccessAfter = After.Access;
+                    Barrier.pResource = Resource.Resource;
+                    Barrier.Offset = 0;
+                    Barrier.Size = UINT64_MAX;
+                    BufferBarrierScratch.push_back(Barrier);
+                }
+            }
+            else
+            {
+                D3D12_TEXTURE_BARRIER* Existing = nullptr;
+                for (D3D12_TEXTURE_BARRIER& Pending : TextureBarrierScratch)
+                {
+                    if (Pending.pResource == Resource.Resource && Pending.LayoutBefore == D3D12_BARRIER_LAYOUT_UNDEFINED)
+                    {
+                        Existing = &Pending;
+                    }
+                }
+
+                if (Existing)
+                {
+                    Existing->SyncAfter = SyncAfter;
+                    Existing->AccessAfter = After.Access;
+                    Existing->LayoutAfter = After.Layout;
+                }
+                else
+                {
+                    D3D12_TEXTURE_BARRIER Barrier = {};
+                    Barrier.SyncBefore = SyncBefore;
+                    Barrier.SyncAfter = SyncAfter;
+                    Barrier.AccessBefore = Before.Access;
+                    Barrier.AccessAfter = After.Access;
+                    Barrier.LayoutBefore = Before.Layout;
+                    Barrier.LayoutAfter = After.Layout;
+                    Barrier.pResource = Resource.Resource;
+                    Barrier.Subresources.IndexOrFirstMipLevel = 0xffffffff;
+                    TextureBarrierScratch.push_back(Barrier);
+                }
+
+                if (bEnableBarrierLogs)
+                {
+                    EnhancedLayouts = " [layout " + RendererUtils::BarrierLayoutToString(Existing ? D3D12_BARRIER_LAYOUT_UNDEFINED : Before.Layout) +
+                        " -> " + RendererUtils::BarrierLayoutToString(After.Layout) + "]";
+                }
+            }
+        }
+        else
+        {
+            D3D12_RESOURCE_BARRIER Barrier = {};
+            Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            Barrier.Transition.pResource = Resource.Resource;
+            Barrier.Transition.StateBefore = Planned.StateBefore;
+            Barrier.Transition.StateAfter = Planned.StateAfter;
+            Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+            Barrier.Flags = Planned.Flags;
+            BarrierScratch.push_back(Barrier);
+        }
+
+        if (bEnableBarrierLogs)
+        {
+            std::ostringstream Stream;
+            Stream << "[RG] Pass '" << Entry.Name << "' ";
+            if (Planned.Flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
+            {
+                Stream << "begins split transition of '";
+            }
+            else if (Planned.Flags == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY)
+            {
+                Stream << "ends split transition of '";
+            }
+            else
+            {
+                Stream << "transitioning '";
+            }
+            Stream << (Resource.Name.empty() ? "<Unnamed>" : Resource.Name) << "': "
+                << RendererUtils::ResourceStateToString(Planned.StateBefore) << " -> "
+                << RendererUtils::ResourceStateToString(Planned.StateAfter);
+            if (Planned.Flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
+            {
+                Stream << " (ends before '" << Passes[Planned.PairedPass].Name << "')";
+            }
+            else if (Planned.Flags == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY)
+            {
+                Stream << " (began after '" << Passes[Planned.PairedPass].Name << "')";
+            }
+            Stream << EnhancedLayouts;
+            LogInfo(Stream.str());
+        }
+
+        // The state only changes once the split transition has ended.
+        if (Planned.Flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
+        {
+            continue;
+        }
+
+        if (Resource.ExternalState)
+        {
+            *Resource.ExternalState = Planned.StateAfter;
+        }
+        Resource.CurrentState = Planned.StateAfter;
+    }
+
+    if (bEnhanced)
+    {
+        Context.EnhancedBarriers(TextureBarrierScratch, BufferBarrierScratch);
+    }
+    else
+    {
+        Context.TransitionResources(BarrierScratch);
+    }
+}
+
+void FRenderGraph::ForkAsyncCompute(FDX12CommandContext& GraphicsContext, FDX12CommandContext& ComputeContext)
+{
+    GraphicsContext.ExecuteAndReset();
+    const uint64 FenceValue = GraphicsContext.GetQueue()->Signal();
+    ComputeContext.GetQueue()->GpuWait(*GraphicsContext.GetQueue(), FenceValue);
+
+    if (!bAsyncComputeFrameBegun)
+    {
+        ComputeContext.BeginFrame(GraphicsContext.GetCurrentFrameIndex());
+        bAsyncComputeFrameBegun = true;
+    }
+    else
+    {
+        ComputeContext.ResetCommandList();
+    }
+
+    if (bEnableBarrierLogs)
+    {
+        LogInfo("[RG] Fork async compute at fence ", FenceValue);
+    }
+}
+
+void FRenderGraph::JoinAsyncCompute(FDX12CommandContext& GraphicsContext, FDX12CommandContext& ComputeContext)
+{
+    ComputeContext.CloseAndExecute();
+    const uint64 FenceValue = ComputeContext.GetQueue()->Signal();
+    ComputeContext.SetFrameFenceValue(ComputeContext.GetCurrentFrameIndex(), FenceValue);
+
+    // Graphics work recorded since the fork must be submitted ahead of the wait so it can
+    // overlap the compute queue instead of queuing behind it.
+    GraphicsContext.ExecuteAndReset();
+    GraphicsContext.GetQueue()->GpuWait(*ComputeContext.GetQueue(), FenceValue);
+
+    if (bEnableBarrierLogs)
+    {
+        LogInfo("[RG] Join async compute at fence ", FenceValue);
+    }
+}
+
+FDX12CommandContext* FRenderGraph::AcquireParallelContext(FDX12CommandContext& CmdContext)
+{
+    FDX12CommandContext* Context = CmdContext.BeginParallelContext(static_cast<uint32>(ParallelContexts.size()));
+    if (Context)
+    {
+        ParallelContexts.push_back(Context);
+    }
+    return Context;
+}
+
+void FRenderGraph::RecordParallelSlice(FParallelRecord& Record, bool bMeasureElapsed)
+{
+    CPU_PROFILE_SCOPE_DYNAMIC(Record.Entry->Name);
+
+    std::chrono::high_resolution_clock::time_point SliceBegin;
+    if (bMeasureElapsed)
+    {
+        SliceBegin = std::chrono::high_resolution_clock::now();
+    }
+
+    if (Record.StatsQueryIndex != UINT32_MAX)
+    {
+        Record.Context->GetCommandList()->BeginQuery(Record.StatsQueryHeap, D3D12_QUERY_TYPE_PIPELINE_STATISTICS, Record.StatsQueryIndex);
+    }
+
+    if (Record.Entry->HasExecute())
+    {
+        Record.Entry->Execute(*Record.Context, Record.SliceIndex, Record.SliceCount);
+    }
+
+    if (Record.StatsQueryIndex != UINT32_MAX)
+    {
+        Record.Context->GetCommandList()->EndQuery(Record.StatsQueryHeap, D3D12_QUERY_TYPE_PIPELINE_STATISTICS, Record.StatsQueryIndex);
+    }
+
+    if (bMeasureElapsed)
+    {
+        const std::chrono::duration<double, std::milli> Elapsed = std::chrono::high_resolution_clock::now() - SliceBegin;
+        Record.ElapsedMs = Elapsed.count();
+    }
+
+    if (Record.EndQueryIndex != UINT32_MAX)
+    {
+        Record.Context->GetCommandList()->EndQuery(Record.QueryHeap, D3D12_QUERY_TYPE_TIMESTAMP, Record.EndQueryIndex);
+    }
+}
+
+void FRenderGraph::SubmitParallelRecording(FDX12CommandContext& CmdContext)
+{
+    if (ParallelContexts.empty())
+    {
+        return;
+    }
+
+    FTaskScheduler::Get().WaitForCounter(ParallelRecordCounter);
+
+    if (IsCpuTimingActive())
+    {
+        for (const FParallelRecord& Record : ParallelRecords)
+        {
+            Record.Entry->ElapsedMs += Record.ElapsedMs;
+        }
+    }
+
+    CmdContext.ExecuteWithParallelContexts(ParallelContexts);
+
+    if (bEnableBarrierLogs)
+    {
+        LogInfo("[RG] Submitted ", ParallelContexts.size(), " parallel command lists");
+    }
+
+    ParallelContexts.clear();
+    ParallelRecords.clear();
+}
+
+void FRenderGraph::Execute(FDX12CommandContext& CmdContext)
+{
+    if (!Device)
+    {
+        LogError("RenderGraph Execute called without a valid device");
+        return;
+    }
+
+    CPU_PROFILE_SCOPE("RG Execute");
+    ProcessPendingGpuTimings(CmdContext, CmdContext.GetCurrentFrameIndex());
+
+    bUseEnhancedBarriers = Device->SupportsEnhancedBarriers();
+
+    FDX12CommandContext* ComputeContext = CmdContext.GetAsyncComputeContext();
+    const bool bAsyncComputeAvailable = ComputeContext && ComputeContext->GetQueue() && CmdContext.GetQueue();
+
+    const uint64 TopologyHash = ComputeTopologyHash(bAsyncComputeAvailable);
+    ++CompiledGraphFrameCounter;
+    if (const FDX12CommandQueue* Queue = CmdContext.GetQueue())
+    {
+        TrimResourcePool(Queue->GetCompletedFenceValue());
+    }
+
+    auto CachedIt = CompiledGraphs.find(TopologyHash);
+    if (CachedIt == CompiledGraphs.end() || !IsCompiledGraphValid(CachedIt->second))
+    {
+        if (CachedIt == CompiledGraphs.end() && CompiledGraphs.size() >= MaxCompiledGraphs)
+        {
+            auto Oldest = std::min_element(CompiledGraphs.begin(), CompiledGraphs.end(),
+                [](const auto& A, const auto& B)
+                {
+                    return A.second.LastUsedFrame < B.second.LastUsedFrame;
+                });
+            CompiledGraphs.erase(Oldest);
+        }
+
+        CPU_PROFILE_SCOPE("RG Compile");
+        CachedIt = CompiledGraphs.try_emplace(TopologyHash).first;
+        CompileGraph(TopologyHash, bAsyncComputeAvailable, CachedIt->second);
+    }
+
+    FCompiledGraph& Compiled = CachedIt->second;
+    Compiled.LastUsedFrame = CompiledGraphFrameCounter;
+
+    for (size_t Index = 0; Index < Resources.size(); ++Index)
+    {
+        FRGResource& Resource = Resources[Index];
+        Resource.FirstUsePass = Compiled.FirstUse[Index];
+        Resource.LastUsePass = Compiled.LastUse[Index];
+
+        // Bind every transient up front so barriers hoisted to a fork point can reference it.
+        const int32 PoolIndex = Compiled.PoolIndices[Index];
+        if (PoolIndex >= 0)
+        {
+            Resource.Resource = ResourcePool[PoolIndex].Resource.Get();
+            Resource.PoolIndex = PoolIndex;
+            ResourcePool[PoolIndex].LastUsedFrame = CompiledGraphFrameCounter;
+        }
+    }
+
+    if (bEnableGraphDump)
+    {
+        DumpDebugInfo(Compiled.PassRequired, Compiled.ResourceRequired);
+    }
+
+    const uint32 ActivePassCount = Compiled.ActivePassCount;
+
+    const bool bDoGpuTiming = IsGpuTimingActive() && ActivePassCount > 0;
+    std::vector<std::string> GpuTimedPassNames;
+    Microsoft::WRL::ComPtr<ID3D12QueryHeap> QueryHeap;
+    Microsoft::WRL::ComPtr<ID3D12Resource> QueryReadback;
+    uint64 TimestampFrequency = 0;
+    uint64 ComputeTimestampFrequency = 0;
+    std::vector<ERGPassQueue> GpuTimedPassQueues;
+    uint32 QueryIndex = 0;
+
+    if (bDoGpuTiming)
+    {
+        const uint32 FrameIndex = CmdContext.GetCurrentFrameIndex();
+        ID3D12CommandQueue* Queue = CmdContext.GetQueue() ? CmdContext.GetQueue()->GetD3DQueue() : nullptr;
+        ID3D12Device* D3DDevice = Device->GetDevice();
+
+        if (Queue && D3DDevice)
+        {
+            Queue->GetTimestampFrequency(&TimestampFrequency);
+            if (bAsyncComputeAvailable)
+            {
+                ComputeContext->GetQueue()->GetD3DQueue()->GetTimestampFrequency(&ComputeTimestampFrequency);
+            }
+
+            FGpuTimingResources& TimingResources = GpuTimingResources[FrameIndex];
+            const uint32 NeededQueryCount = ActivePassCount * 2;
+
+            if (!TimingResources.QueryHeap || !TimingResources.ReadbackBuffer || TimingResources.QueryCapacity < NeededQueryCount)
+            {
+                D3D12_QUERY_HEAP_DESC HeapDesc = {};
+                HeapDesc.Count = NeededQueryCount;
+                HeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+                HeapDesc.NodeMask = 0;
+
+                if (SUCCEEDED(D3DDevice->CreateQueryHeap(&HeapDesc, IID_PPV_ARGS(TimingResources.QueryHeap.ReleaseAndGetAddressOf()))))
+                {
+                    const UINT64 ReadbackSize = static_cast<UINT64>(HeapDesc.Count) * sizeof(uint64);
 
                     CD3DX12_HEAP_PROPERTIES HeapProps(D3D12_HEAP_TYPE_READBACK);
                     CD3DX12_RESOURCE_DESC BufferDesc = CD3DX12_RESOURCE_DESC::Buffer(ReadbackSize);
 
-                    if (FAILED(D3DDevice->CreateCommittedResource(
+                    // Graph resources are pooled across frames and renderers.
+                    FGpuMemoryOwnerScope SharedMemoryScope(FDX12MemoryTracker::SharedOwner);
+                    if (FAILED(Device->CreateCommittedResource(
+                        EGpuMemoryCategory::Readback,
                         &HeapProps,
                         D3D12_HEAP_FLAG_NONE,
                         &BufferDesc,
                         D3D12_RESOURCE_STATE_COPY_DEST,
                         nullptr,
-                        IID_PPV_ARGS(Resources.ReadbackBuffer.ReleaseAndGetAddressOf()))))
+                        IID_PPV_ARGS(TimingResources.ReadbackBuffer.ReleaseAndGetAddressOf()))))
                     {
-                        Resources.QueryHeap.Reset();
-                        Resources.ReadbackBuffer.Reset();
-                        Resources.QueryCapacity = 0;
+                        TimingResources.QueryHeap.Reset();
+                        TimingResources.ReadbackBuffer.Reset();
+                        TimingResources.QueryCapacity = 0;
                     }
                     else
                     {
-                        Resources.QueryCapacity = HeapDesc.Count;
+                        TimingResources.QueryCapacity = HeapDesc.Count;
                     }
                 }
                 else
                 {
-                    Resources.QueryHeap.Reset();
-                    Resources.ReadbackBuffer.Reset();
-                    Resources.QueryCapacity = 0;
+                    TimingResources.QueryHeap.Reset();
+                    TimingResources.ReadbackBuffer.Reset();
+                    TimingResources.QueryCapacity = 0;
                 }
             }
 
-            QueryHeap = Resources.QueryHeap;
-            QueryReadback = Resources.ReadbackBuffer;
+            QueryHeap = TimingResources.QueryHeap;
+            QueryReadback = TimingResources.ReadbackBuffer;
         }
 
         if (!QueryHeap || !QueryReadback || TimestampFrequency == 0)
@@ -389,194 +1659,681 @@ void FRenderGraph::Execute(FDX12CommandContext& CmdContext)
         }
     }
 
+    FTaskScheduler& Scheduler = FTaskScheduler::Get();
+    const uint32 RecordingWorkerCount = Scheduler.IsRunning() ? Scheduler.GetWorkerThreadCount() : 0u;
+    const bool bParallelRecordingActive = bEnableParallelRecording && RecordingWorkerCount > 0;
+
+    // Pipeline statistics share the timestamps' resolve, so they are only taken on timed frames.
+    // Sliced passes need one query per list they may record into.
+    Microsoft::WRL::ComPtr<ID3D12QueryHeap> StatsQueryHeap;
+    Microsoft::WRL::ComPtr<ID3D12Resource> StatsReadback;
+    std::vector<FPipelineStatsRange> StatsPasses;
+    uint32 StatsQueryIndex = 0;
+
+    if (bEnablePipelineStatistics && QueryHeap && QueryReadback && TimestampFrequency != 0)
+    {
+        uint32 NeededStatsQueryCount = 0;
+        for (size_t PassIndex = 0; PassIndex < Passes.size(); ++PassIndex)
+        {
+            if (!Compiled.PassRequired[PassIndex] || Compiled.CompiledPasses[PassIndex].Queue == ERGPassQueue::AsyncCompute)
+            {
+                continue;
+            }
+
+            const PassEntry& Entry = Passes[PassIndex];
+            NeededStatsQueryCount += bParallelRecordingActive && Entry.bParallelRecording
+                ? (std::min)(Entry.MaxRecordingSlices, RecordingWorkerCount + 1)
+                : 1u;
+        }
+
+        FGpuTimingResources& TimingResources = GpuTimingResources[CmdContext.GetCurrentFrameIndex()];
+        if (NeededStatsQueryCount > 0 && EnsurePipelineStatsResources(TimingResources, NeededStatsQueryCount))
+        {
+            StatsQueryHeap = TimingResources.StatsQueryHeap;
+            StatsReadback = TimingResources.StatsReadbackBuffer;
+        }
+    }
+
+    // Inline graphics passes record here. Null after a parallel pass, so the next inline pass
+    // opens a fresh list that is submitted after the parallel ones.
+    FDX12CommandContext* GraphicsContext = &CmdContext;
+
     for (int32_t PassIndex = 0; PassIndex < static_cast<int32_t>(Passes.size()); ++PassIndex)
     {
         PassEntry& Entry = Passes[PassIndex];
-        Entry.bCulled = !PassRequired[PassIndex];
+        Entry.bCulled = !Compiled.PassRequired[PassIndex];
 
         if (Entry.bCulled)
         {
             continue;
         }
 
-        if (QueryHeap && QueryReadback)
+        const FCompiledPass& CompiledPass = Compiled.CompiledPasses[PassIndex];
+
+        if (CompiledPass.bJoinBefore || CompiledPass.bForkBefore)
         {
-            CmdContext.GetCommandList()->EndQuery(QueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, QueryIndex++);
-            GpuTimedPassNames.push_back(Entry.Name);
+            SubmitParallelRecording(CmdContext);
+            GraphicsContext = &CmdContext;
         }
 
-        std::vector<D3D12_RESOURCE_BARRIER> PendingBarriers;
-        PendingBarriers.reserve(Entry.ResourceUsages.size());
+        if (CompiledPass.bJoinBefore)
+        {
+            JoinAsyncCompute(CmdContext, *ComputeContext);
+        }
 
-        for (const FRGResourceUsage& Usage : Entry.ResourceUsages)
+        if (CompiledPass.bForkBefore)
         {
-            FRGTextureResource* Resource = ResolveResource(Usage.Handle);
-            if (!Resource)
+            EmitCompiledBarriers(CmdContext, Compiled, CompiledPass.FirstForkBarrier, CompiledPass.ForkBarrierCount, Entry);
+            ForkAsyncCompute(CmdContext, *ComputeContext);
+        }
+
+        FDX12CommandContext* PassContext = nullptr;
+        uint32 SliceCount = 0;
+        size_t FirstSliceContext = 0;
+
+        if (CompiledPass.Queue == ERGPassQueue::AsyncCompute)
+        {
+            PassContext = ComputeContext;
+        }
+        else if (bParallelRecordingActive && Entry.bParallelRecording)
+        {
+            // One slice per worker plus one for the calling thread, which helps while waiting to submit.
+            const uint32 MaxSlices = (std::min)(Entry.MaxRecordingSlices, RecordingWorkerCount + 1);
+            FirstSliceContext = ParallelContexts.size();
+            for (uint32 SliceIndex = 0; SliceIndex < MaxSlices; ++SliceIndex)
             {
-                continue;
+                if (!AcquireParallelContext(CmdContext))
+                {
+                    break;
+                }
             }
 
-            if (!Resource->Resource && !Resource->bExternal)
+            SliceCount = static_cast<uint32>(ParallelContexts.size() - FirstSliceContext);
+            if (SliceCount > 0)
             {
-                AcquireTransientTexture(*Resource, Usage.RequiredState);
+                PassContext = ParallelContexts[FirstSliceContext];
+                GraphicsContext = nullptr;
             }
+        }
 
-            if (!Resource->Resource)
+        if (!PassContext)
+        {
+            if (!GraphicsContext)
             {
-                continue;
+                GraphicsContext = AcquireParallelContext(CmdContext);
             }
 
-            D3D12_RESOURCE_STATES& StateRef = Resource->ExternalState ? *Resource->ExternalState : Resource->CurrentState;
-            if (StateRef != Usage.RequiredState)
+            if (!GraphicsContext)
             {
-                D3D12_RESOURCE_BARRIER Barrier = {};
-                Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-                Barrier.Transition.pResource = Resource->Resource;
-                Barrier.Transition.StateBefore = StateRef;
-                Barrier.Transition.StateAfter = Usage.RequiredState;
-                Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-                PendingBarriers.push_back(Barrier);
+                SubmitParallelRecording(CmdContext);
+                GraphicsContext = &CmdContext;
+            }
 
-                if (bEnableBarrierLogs)
+            PassContext = GraphicsContext;
+        }
+
+        if (QueryHeap && QueryReadback)
+        {
+            PassContext->GetCommandList()->EndQuery(QueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, QueryIndex++);
+            GpuTimedPassNames.emplace_back(Entry.Name);
+            GpuTimedPassQueues.push_back(CompiledPass.Queue);
+        }
+
+        for (uint32 Index = 0; Index < CompiledPass.AcquireCount; ++Index)
+        {
+            const uint32 ResourceId = Compiled.Acquires[CompiledPass.FirstAcquire + Index];
+            FPooledResource& Pooled = ResourcePool[Compiled.PoolIndices[ResourceId]];
+            Pooled.bInUse = true;
+        }
+
+        EmitCompiledBarriers(*PassContext, Compiled, CompiledPass.FirstBarrier, CompiledPass.BarrierCount, Entry);
+
+        // Enhanced barriers already discarded these while activating their placed memory.
+        const bool bDiscardedByBarrier = bUseEnhancedBarriers && PassContext->SupportsEnhancedBarriers();
+        for (uint32 Index = 0; Index < CompiledPass.DiscardCount && !bDiscardedByBarrier; ++Index)
+        {
+            PassContext->GetCommandList()->DiscardResource(Resources[Compiled.Discards[CompiledPass.FirstDiscard + Index]].Resource, nullptr);
+        }
+
+        if (SliceCount > 0)
+        {
+            // Barriers and the begin query are already in the first slice's list; the end
+            // query goes at the end of the last one.
+            Entry.ElapsedMs = 0.0;
+            for (uint32 SliceIndex = 0; SliceIndex < SliceCount; ++SliceIndex)
+            {
+                FParallelRecord& Record = ParallelRecords.emplace_back();
+                Record.Entry = &Entry;
+                Record.Context = ParallelContexts[FirstSliceContext + SliceIndex];
+                Record.SliceIndex = SliceIndex;
+                Record.SliceCount = SliceCount;
+                if (QueryHeap && QueryReadback && SliceIndex + 1 == SliceCount)
+                {
+                    Record.QueryHeap = QueryHeap.Get();
+                    Record.EndQueryIndex = QueryIndex++;
+                }
+                if (StatsQueryHeap)
                 {
-                    std::ostringstream Stream;
-                    Stream << "[RG] Pass '" << Entry.Name << "' transitioning '"
-                        << (Resource->Name.empty() ? "<Unnamed>" : Resource->Name) << "': "
-                        << RendererUtils::ResourceStateToString(StateRef) << " -> "
-                        << RendererUtils::ResourceStateToString(Usage.RequiredState);
-                    LogInfo(Stream.str());
+                    Record.StatsQueryHeap = StatsQueryHeap.Get();
+                    Record.StatsQueryIndex = StatsQueryIndex + SliceIndex;
                 }
 
-                StateRef = Usage.RequiredState;
-                Resource->CurrentState = Usage.RequiredState;
+                FParallelRecord* RecordPtr = &Record;
+                const bool bMeasureElapsed = IsCpuTimingActive();
+                Scheduler.Spawn(ParallelRecordCounter, [RecordPtr, bMeasureElapsed]()
+                {
+                    RecordParallelSlice(*RecordPtr, bMeasureElapsed);
+                }, ETaskPriority::High);
+            }
+
+            if (StatsQueryHeap)
+            {
+                StatsPasses.push_back({ Entry.Name, StatsQueryIndex, SliceCount });
+                StatsQueryIndex += SliceCount;
+            }
+        }
+        else
+        {
+            CPU_PROFILE_SCOPE_DYNAMIC(Entry.Name);
+            std::chrono::high_resolution_clock::time_point PassBegin, PassEnd;
+            const bool bMeasureElapsed = IsCpuTimingActive();
+            if (bMeasureElapsed)
+            {
+                PassBegin = std::chrono::high_resolution_clock::now();
+            }
+
+            const bool bQueryPipelineStats = StatsQueryHeap && CompiledPass.Queue != ERGPassQueue::AsyncCompute;
+            if (bQueryPipelineStats)
+            {
+                PassContext->GetCommandList()->BeginQuery(StatsQueryHeap.Get(), D3D12_QUERY_TYPE_PIPELINE_STATISTICS, StatsQueryIndex);
+            }
+
+            if (Entry.HasExecute())
+            {
+                Entry.Execute(*PassContext, 0, 1);
+            }
+
+            if (bQueryPipelineStats)
+            {
+                PassContext->GetCommandList()->EndQuery(StatsQueryHeap.Get(), D3D12_QUERY_TYPE_PIPELINE_STATISTICS, StatsQueryIndex);
+                StatsPasses.push_back({ Entry.Name, StatsQueryIndex, 1 });
+                ++StatsQueryIndex;
+            }
+
+            if (bMeasureElapsed)
+            {
+                PassEnd = std::chrono::high_resolution_clock::now();
+                const std::chrono::duration<double, std::milli> Elapsed = PassEnd - PassBegin;
+                Entry.ElapsedMs = Elapsed.count();
+            }
+
+            if (QueryHeap && QueryReadback)
+            {
+                PassContext->GetCommandList()->EndQuery(QueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, QueryIndex++);
+            }
+        }
+
+        for (uint32 Index = 0; Index < CompiledPass.ReleaseCount; ++Index)
+        {
+            const uint32 ResourceId = Compiled.Releases[CompiledPass.FirstRelease + Index];
+            Resources[ResourceId].CurrentState = Compiled.FinalStates[ResourceId];
+            ReleaseTransientResource(Resources[ResourceId]);
+        }
+    }
+
+    SubmitParallelRecording(CmdContext);
+
+    if (Compiled.bJoinAtEnd)
+    {
+        JoinAsyncCompute(CmdContext, *ComputeContext);
+    }
+
+    if (QueryHeap && QueryReadback && QueryIndex > 0)
+    {
+        CmdContext.GetCommandList()->ResolveQueryData(
+            QueryHeap.Get(),
+            D3D12_QUERY_TYPE_TIMESTAMP,
+            0,
+            QueryIndex,
+            QueryReadback.Get(),
+            0);
+
+        if (StatsQueryHeap && StatsQueryIndex > 0)
+        {
+            CmdContext.GetCommandList()->ResolveQueryData(
+                StatsQueryHeap.Get(),
+                D3D12_QUERY_TYPE_PIPELINE_STATISTICS,
+                0,
+                StatsQueryIndex,
+                StatsReadback.Get(),
+                0);
+        }
+
+        FGpuTimingData& Pending = PendingGpuTimings[CmdContext.GetCurrentFrameIndex()];
+        Pending.ReadbackBuffer = QueryReadback;
+        Pending.QueryCount = QueryIndex;
+        Pending.Frequency = TimestampFrequency;
+        Pending.ComputeFrequency = ComputeTimestampFrequency;
+        Pending.PassNames = std::move(GpuTimedPassNames);
+        Pending.PassQueues = std::move(GpuTimedPassQueues);
+        Pending.StatsReadbackBuffer = StatsReadback;
+        Pending.StatsQueryCount = StatsQueryIndex;
+        Pending.StatsPasses = std::move(StatsPasses);
+        Pending.bPending = true;
+        Pending.CaptureFrameId = CaptureTimingFrame(Compiled, true);
+    }
+    else
+    {
+        CaptureTimingFrame(Compiled, false);
+    }
+
+    if (bEnableDebugRecording)
+    {
+        LogTimingSummary();
+    }
+}
+
+bool FRenderGraph::IsPoolCompatible(const FPooledResource& Pooled, const FRGResource& Resource)
+{
+    if (Pooled.Type != Resource.Type || Pooled.Flags != Resource.Flags)
+    {
+        return false;
+    }
+
+    if (Resource.Type == ERGResourceType::Buffer)
+    {
+        return Pooled.BufferDesc.Size == Resource.BufferDesc.Size;
+    }
+
+    return Pooled.Desc.Width == Resource.Desc.Width &&
+        Pooled.Desc.Height == Resource.Desc.Height &&
+        Pooled.Desc.Format == Resource.Desc.Format;
+}
+
+uint64 FRenderGraph::HashPoolKey(const FRGResource& Resource, const ID3D12Heap* Heap, uint64 HeapOffset)
+{
+    // The fields IsPoolCompatible compares, plus the placement of placed resources.
+    uint64 Hash = TopologyHashOffset;
+    HashValue(Hash, Resource.Type);
+    HashValue(Hash, Resource.Flags);
+    if (Resource.Type == ERGResourceType::Buffer)
+    {
+        HashValue(Hash, Resource.BufferDesc.Size);
+    }
+    else
+    {
+        HashValue(Hash, Resource.Desc.Width);
+        HashValue(Hash, Resource.Desc.Height);
+        HashValue(Hash, Resource.Desc.Format);
+    }
+    HashValue(Hash, reinterpret_cast<uintptr_t>(Heap));
+    HashValue(Hash, HeapOffset);
+    return Hash;
+}
+
+int32 FRenderGraph::AddPooledResource(FPooledResource&& Pooled)
+{
+    Pooled.LastUsedFrame = CompiledGraphFrameCounter;
+
+    int32 PoolIndex = -1;
+    if (!FreePoolSlots.empty())
+    {
+        PoolIndex = FreePoolSlots.back();
+        FreePoolSlots.pop_back();
+        ResourcePool[PoolIndex] = std::move(Pooled);
+    }
+    else
+    {
+        PoolIndex = static_cast<int32>(ResourcePool.size());
+        ResourcePool.push_back(std::move(Pooled));
+    }
+
+    ResourcePoolLookup.emplace(ResourcePool[PoolIndex].LookupKey, PoolIndex);
+    return PoolIndex;
+}
+
+void FRenderGraph::TrimResourcePool(uint64 CompletedFenceValue)
+{
+    std::vector<bool> Evicted;
+    uint32 EvictedCount = 0;
+    for (int32 PoolIndex = 0; PoolIndex < static_cast<int32>(ResourcePool.size()); ++PoolIndex)
+    {
+        FPooledResource& Pooled = ResourcePool[PoolIndex];
+        const bool bAgedOut = Pooled.Resource && !Pooled.bInUse &&
+            Pooled.LastUsedFrame + PoolEvictionFrames < CompiledGraphFrameCounter &&
+            Pooled.LastUsedFrame <= LastRetiredGraphFrame &&
+            Pooled.LastUsedFenceValue <= CompletedFenceValue;
+        if (!bAgedOut)
+        {
+            continue;
+        }
+
+        const auto Range = ResourcePoolLookup.equal_range(Pooled.LookupKey);
+        for (auto It = Range.first; It != Range.second; ++It)
+        {
+            if (It->second == PoolIndex)
+            {
+                ResourcePoolLookup.erase(It);
+                break;
             }
         }
 
-        CmdContext.TransitionResources(PendingBarriers);
+        Pooled = FPooledResource{};
+        FreePoolSlots.push_back(PoolIndex);
+        Evicted.resize(ResourcePool.size(), false);
+        Evicted[PoolIndex] = true;
+        ++EvictedCount;
+    }
+
+    if (EvictedCount == 0)
+    {
+        return;
+    }
+
+    // A cached graph bound to an evicted slot would pick up whatever reuses it.
+    for (auto It = CompiledGraphs.begin(); It != CompiledGraphs.end();)
+    {
+        const std::vector<int32>& PoolIndices = It->second.PoolIndices;
+        const bool bUsesEvicted = std::any_of(PoolIndices.begin(), PoolIndices.end(), [&Evicted](int32 PoolIndex)
+        {
+            return PoolIndex >= 0 && Evicted[PoolIndex];
+        });
+        It = bUsesEvicted ? CompiledGraphs.erase(It) : std::next(It);
+    }
+
+    for (FTransientHeap& TransientHeap : TransientHeaps)
+    {
+        const bool bHeapInUse = TransientHeap.Heap && std::any_of(ResourcePool.begin(), ResourcePool.end(), [&TransientHeap](const FPooledResource& Pooled)
+        {
+            return Pooled.Heap == TransientHeap.Heap;
+        });
+        if (!bHeapInUse)
+        {
+            TransientHeap = FTransientHeap{};
+        }
+    }
+
+    LogVerbose("RenderGraph released ", EvictedCount, " pooled transients unused for ", PoolEvictionFrames, " graph executions");
+}
+
+D3D12_RESOURCE_DESC FRenderGraph::BuildTransientResourceDesc(const FRGResource& Resource)
+{
+    if (Resource.Type == ERGResourceType::Buffer)
+    {
+        return CD3DX12_RESOURCE_DESC::Buffer(Resource.BufferDesc.Size, Resource.Flags);
+    }
+
+    return BuildTransientTextureDesc(Resource.Desc, Resource.Flags);
+}
+
+void FRenderGraph::PlaceTransientResources(
+    const std::vector<int32>& FirstRequiredUse,
+    const std::vector<int32>& LastRequiredUse,
+    const std::vector<D3D12_RESOURCE_STATES>& FirstRequiredState,
+    std::vector<int32>& OutPoolIndices)
+{
+    OutPoolIndices.assign(Resources.size(), -1);
+
+    ID3D12Device* D3DDevice = Device ? Device->GetDevice() : nullptr;
+    if (!D3DDevice)
+    {
+        return;
+    }
+
+    if (!bTransientHeapTierQueried)
+    {
+        D3D12_FEATURE_DATA_D3D12_OPTIONS Options = {};
+        if (SUCCEEDED(D3DDevice->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &Options, sizeof(Options))))
+        {
+            TransientHeapTier = Options.ResourceHeapTier;
+        }
+        bTransientHeapTierQueried = true;
+    }
+
+    struct FPlacement
+    {
+        uint32 ResourceId = 0;
+        uint32 Category = 0;
+        uint64 Size = 0;
+        uint64 Alignment = 0;
+        uint64 Offset = 0;
+        int32 BeginPass = 0;
+        int32 EndPass = 0;
+    };
 
-        std::chrono::high_resolution_clock::time_point PassBegin, PassEnd;
-        if (bEnableDebugRecording)
+    std::vector<FPlacement> Placements;
+    for (uint32 Index = 0; Index < Resources.size(); ++Index)
+    {
+        const FRGResource& Resource = Resources[Index];
+        if (Resource.bExternal || FirstRequiredUse[Index] == -1)
         {
-            PassBegin = std::chrono::high_resolution_clock::now();
+            continue;
         }
 
-        if (Entry.ExecuteFunc)
+        const D3D12_RESOURCE_DESC ResourceDesc = BuildTransientResourceDesc(Resource);
+        const D3D12_RESOURCE_ALLOCATION_INFO AllocationInfo = D3DDevice->GetResourceAllocationInfo(0, 1, &ResourceDesc);
+        if (AllocationInfo.SizeInBytes == 0 || AllocationInfo.SizeInBytes == UINT64_MAX)
         {
-            Entry.ExecuteFunc(Entry.DataStorage, CmdContext);
+            continue;
         }
 
-        if (bEnableDebugRecording)
+        const bool bRenderTargetOrDepth = (Resource.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) != 0;
+
+        FPlacement Placement;
+        Placement.ResourceId = Index;
+        if (TransientHeapTier == D3D12_RESOURCE_HEAP_TIER_1)
         {
-            PassEnd = std::chrono::high_resolution_clock::now();
-            const std::chrono::duration<double, std::milli> Elapsed = PassEnd - PassBegin;
-            Entry.ElapsedMs = Elapsed.count();
+            Placement.Category = Resource.Type == ERGResourceType::Buffer ? 2 : (bRenderTargetOrDepth ? 0 : 1);
         }
+        Placement.Size = AllocationInfo.SizeInBytes;
+        Placement.Alignment = AllocationInfo.Alignment;
+        Placement.BeginPass = FirstRequiredUse[Index];
+        Placement.EndPass = LastRequiredUse[Index];
+        Placements.push_back(Placement);
+    }
 
-        if (QueryHeap && QueryReadback)
+    if (Placements.empty())
+    {
+        return;
+    }
+
+    // Largest first, then bump each allocation past any live neighbour it collides with.
+    // Only allocations whose pass intervals overlap compete for the same bytes.
+    std::stable_sort(Placements.begin(), Placements.end(),
+        [](const FPlacement& A, const FPlacement& B)
         {
-            CmdContext.GetCommandList()->EndQuery(QueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, QueryIndex++);
-        }
+            return A.Size > B.Size;
+        });
 
-        for (const FRGResourceUsage& Usage : Entry.ResourceUsages)
+    uint64 CategorySizes[TransientHeapCategoryCount] = {};
+    for (size_t Index = 0; Index < Placements.size(); ++Index)
+    {
+        FPlacement& Placement = Placements[Index];
+
+        bool bMoved = true;
+        while (bMoved)
         {
-            FRGTextureResource* Resource = ResolveResource(Usage.Handle);
-            if (!Resource || Resource->bExternal)
+            bMoved = false;
+            for (size_t OtherIndex = 0; OtherIndex < Index; ++OtherIndex)
             {
-                continue;
+                const FPlacement& Other = Placements[OtherIndex];
+                const bool bLifetimesOverlap = Other.Category == Placement.Category &&
+                    Other.BeginPass <= Placement.EndPass &&
+                    Placement.BeginPass <= Other.EndPass;
+                const bool bMemoryOverlaps = Placement.Offset < Other.Offset + Other.Size &&
+                    Other.Offset < Placement.Offset + Placement.Size;
+
+                if (bLifetimesOverlap && bMemoryOverlaps)
+                {
+                    Placement.Offset = AlignUp(Other.Offset + Other.Size, Placement.Alignment);
+                    bMoved = true;
+                }
             }
+        }
 
-            if (Resource->LastUsePass == PassIndex)
-            {
-                ReleaseTransientTexture(*Resource);
-            }
+        CategorySizes[Placement.Category] = (std::max)(CategorySizes[Placement.Category], Placement.Offset + Placement.Size);
+    }
+
+    bool bCategoryReady[TransientHeapCategoryCount] = {};
+    for (uint32 Category = 0; Category < TransientHeapCategoryCount; ++Category)
+    {
+        bCategoryReady[Category] = CategorySizes[Category] > 0 && EnsureTransientHeap(Category, CategorySizes[Category]);
+    }
+
+    for (const FPlacement& Placement : Placements)
+    {
+        if (!bCategoryReady[Placement.Category])
+        {
+            continue;
         }
+
+        OutPoolIndices[Placement.ResourceId] = AcquirePlacedResource(
+            Resources[Placement.ResourceId],
+            Placement.Category,
+            Placement.Offset,
+            FirstRequiredState[Placement.ResourceId]);
     }
+}
 
-    if (QueryHeap && QueryReadback && QueryIndex > 0)
+bool FRenderGraph::EnsureTransientHeap(uint32 Category, uint64 Size)
+{
+    FTransientHeap& TransientHeap = TransientHeaps[Category];
+    if (TransientHeap.Heap && TransientHeap.Size >= Size && TransientHeap.Size / 2 <= Size)
     {
-        CmdContext.GetCommandList()->ResolveQueryData(
-            QueryHeap.Get(),
-            D3D12_QUERY_TYPE_TIMESTAMP,
-            0,
-            QueryIndex,
-            QueryReadback.Get(),
-            0);
+        return true;
+    }
 
-        FGpuTimingData& Pending = PendingGpuTimings[CmdContext.GetCurrentFrameIndex()];
-        Pending.ReadbackBuffer = QueryReadback;
-        Pending.QueryCount = QueryIndex;
-        Pending.Frequency = TimestampFrequency;
-        Pending.PassNames = std::move(GpuTimedPassNames);
-        Pending.bPending = true;
+    D3D12_HEAP_DESC HeapDesc = {};
+    HeapDesc.SizeInBytes = AlignUp(Size, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+    HeapDesc.Properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+    HeapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+    if (TransientHeapTier == D3D12_RESOURCE_HEAP_TIER_1)
+    {
+        const D3D12_HEAP_FLAGS CategoryFlags[TransientHeapCategoryCount] =
+        {
+            D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES,
+            D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES,
+            D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,
+        };
+        HeapDesc.Flags = CategoryFlags[Category];
+    }
+    else
+    {
+        HeapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES;
     }
 
-    if (bEnableDebugRecording)
+    // Resources already placed in the old heap keep it alive through their pool entries.
+    Microsoft::WRL::ComPtr<ID3D12Heap> NewHeap;
+    FGpuMemoryOwnerScope SharedMemoryScope(FDX12MemoryTracker::SharedOwner);
+    if (FAILED(Device->CreateHeap(EGpuMemoryCategory::GraphTransient, &HeapDesc, IID_PPV_ARGS(&NewHeap))))
     {
-        LogTimingSummary();
+        LogWarning("RenderGraph failed to create transient heap, falling back to committed resources");
+        return false;
     }
+
+    NewHeap->SetName(L"RenderGraphTransientHeap");
+    TransientHeap.Heap = NewHeap;
+    TransientHeap.Size = HeapDesc.SizeInBytes;
+
+    LogVerbose("RenderGraph transient heap ", Category, " resized to ", HeapDesc.SizeInBytes / (1024 * 1024), " MB");
+    return true;
 }
 
-bool FRenderGraph::AcquireTransientTexture(FRGTextureResource& Texture, D3D12_RESOURCE_STATES InitialState)
+int32 FRenderGraph::AcquirePlacedResource(const FRGResource& Resource, uint32 Category, uint64 HeapOffset, D3D12_RESOURCE_STATES InitialState)
 {
-    if (!Device)
+    ID3D12Heap* Heap = TransientHeaps[Category].Heap.Get();
+
+    // Transients at the same offset never overlap in time, so an existing placed resource
+    // can be shared regardless of whether another transient used it earlier in the frame.
+    const uint64 LookupKey = HashPoolKey(Resource, Heap, HeapOffset);
+    const auto Range = ResourcePoolLookup.equal_range(LookupKey);
+    for (auto It = Range.first; It != Range.second; ++It)
     {
-        return false;
+        const FPooledResource& Candidate = ResourcePool[It->second];
+        if (Candidate.Heap.Get() == Heap && Candidate.HeapOffset == HeapOffset && IsPoolCompatible(Candidate, Resource))
+        {
+            return It->second;
+        }
     }
 
-    const auto Matches = [&](const FPooledTexture& Candidate)
+    const D3D12_RESOURCE_DESC ResourceDesc = BuildTransientResourceDesc(Resource);
+    D3D12_CLEAR_VALUE ClearValue;
+    D3D12_CLEAR_VALUE* ClearPtr = Resource.Type == ERGResourceType::Texture ? BuildTransientClearValue(Resource.Desc, Resource.Flags, ClearValue) : nullptr;
+
+    // Buffers are always created in the common state; the compiled barriers start from there.
+    if (Resource.Type == ERGResourceType::Buffer)
     {
-        return !Candidate.bInUse &&
-            Candidate.Desc.Width == Texture.Desc.Width &&
-            Candidate.Desc.Height == Texture.Desc.Height &&
-            Candidate.Desc.Format == Texture.Desc.Format &&
-            Candidate.Flags == Texture.Flags;
-    };
+        InitialState = D3D12_RESOURCE_STATE_COMMON;
+    }
 
-    auto Found = std::find_if(TexturePool.begin(), TexturePool.end(), Matches);
-    if (Found != TexturePool.end())
+    Microsoft::WRL::ComPtr<ID3D12Resource> NewResource;
+    HRESULT hr = Device->GetDevice()->CreatePlacedResource(
+        Heap,
+        HeapOffset,
+        &ResourceDesc,
+        InitialState,
+        ClearPtr,
+        IID_PPV_ARGS(&NewResource));
+
+    if (FAILED(hr))
     {
-        Found->bInUse = true;
-        Texture.Resource = Found->Resource.Get();
-        Texture.CurrentState = Found->CurrentState;
-        Texture.PoolIndex = static_cast<int32>(Found - TexturePool.begin());
-        return true;
+        return -1;
     }
 
-    D3D12_RESOURCE_DESC ResourceDesc = {};
-    ResourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-    ResourceDesc.Alignment = 0;
-    ResourceDesc.Width = Texture.Desc.Width;
-    ResourceDesc.Height = Texture.Desc.Height;
-    ResourceDesc.DepthOrArraySize = 1;
-    ResourceDesc.MipLevels = 1;
-    ResourceDesc.Format = Texture.Desc.Format;
-    ResourceDesc.SampleDesc.Count = 1;
-    ResourceDesc.SampleDesc.Quality = 0;
-    ResourceDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
-    ResourceDesc.Flags = Texture.Flags;
+    if (!Resource.Name.empty())
+    {
+        std::wstring WName(Resource.Name.begin(), Resource.Name.end());
+        NewResource->SetName(WName.c_str());
+    }
+
+    FPooledResource Pooled = {};
+    Pooled.Type = Resource.Type;
+    Pooled.Desc = Resource.Desc;
+    Pooled.BufferDesc = Resource.BufferDesc;
+    Pooled.Flags = Resource.Flags;
+    Pooled.Resource = NewResource;
+    Pooled.Heap = TransientHeaps[Category].Heap;
+    Pooled.HeapOffset = HeapOffset;
+    Pooled.CurrentState = InitialState;
+    Pooled.LookupKey = LookupKey;
+
+    return AddPooledResource(std::move(Pooled));
+}
+
+int32 FRenderGraph::AcquireTransientResource(const FRGResource& Resource, D3D12_RESOURCE_STATES InitialState)
+{
+    if (!Device)
+    {
+        return -1;
+    }
 
-    D3D12_CLEAR_VALUE ClearValue = {};
-    D3D12_CLEAR_VALUE* ClearPtr = nullptr;
-    if (Texture.Flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET)
+    const uint64 LookupKey = HashPoolKey(Resource, nullptr, 0);
+    const auto Range = ResourcePoolLookup.equal_range(LookupKey);
+    for (auto It = Range.first; It != Range.second; ++It)
     {
-        ClearValue.Format = Texture.Desc.Format;
-        ClearValue.Color[0] = 0.0f;
-        ClearValue.Color[1] = 0.0f;
-        ClearValue.Color[2] = 0.0f;
-        ClearValue.Color[3] = 0.0f;
-        ClearPtr = &ClearValue;
+        FPooledResource& Candidate = ResourcePool[It->second];
+        if (!Candidate.bInUse && !Candidate.Heap && IsPoolCompatible(Candidate, Resource))
+        {
+            Candidate.bInUse = true;
+            return It->second;
+        }
     }
-    else if (Texture.Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)
+
+    const D3D12_RESOURCE_DESC ResourceDesc = BuildTransientResourceDesc(Resource);
+    D3D12_CLEAR_VALUE ClearValue;
+    D3D12_CLEAR_VALUE* ClearPtr = Resource.Type == ERGResourceType::Texture ? BuildTransientClearValue(Resource.Desc, Resource.Flags, ClearValue) : nullptr;
+
+    // Buffers are always created in the common state; the compiled barriers start from there.
+    if (Resource.Type == ERGResourceType::Buffer)
     {
-        ClearValue.Format = Texture.Desc.Format;
-        ClearValue.DepthStencil.Depth = 1.0f;
-        ClearValue.DepthStencil.Stencil = 0;
-        ClearPtr = &ClearValue;
+        InitialState = D3D12_RESOURCE_STATE_COMMON;
     }
 
     Microsoft::WRL::ComPtr<ID3D12Resource> NewResource;
     CD3DX12_HEAP_PROPERTIES HeapProps(D3D12_HEAP_TYPE_DEFAULT);
-    HRESULT hr = Device->GetDevice()->CreateCommittedResource(
+    FGpuMemoryOwnerScope SharedMemoryScope(FDX12MemoryTracker::SharedOwner);
+    HRESULT hr = Device->CreateCommittedResource(
+        EGpuMemoryCategory::GraphTransient,
         &HeapProps,
         D3D12_HEAP_FLAG_NONE,
         &ResourceDesc,
@@ -586,42 +2343,40 @@ bool FRenderGraph::AcquireTransientTexture(FRGTextureResource& Texture, D3D12_RE
 
     if (FAILED(hr))
     {
-        return false;
+        return -1;
     }
 
-    if (!Texture.Name.empty())
+    if (!Resource.Name.empty())
     {
-        std::wstring WName(Texture.Name.begin(), Texture.Name.end());
+        std::wstring WName(Resource.Name.begin(), Resource.Name.end());
         NewResource->SetName(WName.c_str());
     }
 
-    FPooledTexture Pooled = {};
-    Pooled.Desc = Texture.Desc;
-    Pooled.Flags = Texture.Flags;
+    FPooledResource Pooled = {};
+    Pooled.Type = Resource.Type;
+    Pooled.Desc = Resource.Desc;
+    Pooled.BufferDesc = Resource.BufferDesc;
+    Pooled.Flags = Resource.Flags;
     Pooled.Resource = NewResource;
     Pooled.CurrentState = InitialState;
+    Pooled.LookupKey = LookupKey;
     Pooled.bInUse = true;
 
-    TexturePool.push_back(Pooled);
-    Texture.Resource = NewResource.Get();
-    Texture.CurrentState = InitialState;
-    Texture.PoolIndex = static_cast<int32>(TexturePool.size() - 1);
-
-    return true;
+    return AddPooledResource(std::move(Pooled));
 }
 
-void FRenderGraph::ReleaseTransientTexture(FRGTextureResource& Texture)
+void FRenderGraph::ReleaseTransientResource(FRGResource& Resource)
 {
-    if (Texture.PoolIndex < 0 || Texture.PoolIndex >= static_cast<int32>(TexturePool.size()))
+    if (Resource.PoolIndex < 0 || Resource.PoolIndex >= static_cast<int32>(ResourcePool.size()))
     {
         return;
     }
 
-    FPooledTexture& Pooled = TexturePool[Texture.PoolIndex];
-    Pooled.CurrentState = Texture.CurrentState;
+    FPooledResource& Pooled = ResourcePool[Resource.PoolIndex];
+    Pooled.CurrentState = Resource.CurrentState;
     Pooled.bInUse = false;
-    Texture.Resource = nullptr;
-    Texture.PoolIndex = -1;
+    Resource.Resource = nullptr;
+    Resource.PoolIndex = -1;
 }
 
 void FRenderGraph::DumpDebugInfo(const std::vector<bool>& PassRequired, const std::vector<bool>& ResourceRequired)
@@ -631,14 +2386,14 @@ void FRenderGraph::DumpDebugInfo(const std::vector<bool>& PassRequired, const st
     if (bEnableResourceLifetimeLog)
     {
         LogInfo("Resources:");
-        for (size_t Index = 0; Index < Textures.size(); ++Index)
+        for (size_t Index = 0; Index < Resources.size(); ++Index)
         {
             if (!ResourceRequired[Index])
             {
                 continue;
             }
 
-            const FRGTextureResource& Resource = Textures[Index];
+            const FRGResource& Resource = Resources[Index];
 
             std::ostringstream Stream;
             Stream << " - " << Resource.Name
@@ -661,7 +2416,7 @@ void FRenderGraph::DumpDebugInfo(const std::vector<bool>& PassRequired, const st
 
         for (const FRGResourceUsage& Usage : Entry.ResourceUsages)
         {
-            const FRGTextureResource* Resource = ResolveResource(Usage.Handle);
+            const FRGResource* Resource = ResolveResource(Usage.Handle);
             if (!Resource)
             {
                 continue;
@@ -695,6 +2450,55 @@ void FRenderGraph::LogTimingSummary()
     }
 }
 
+bool FRenderGraph::EnsurePipelineStatsResources(FGpuTimingResources& Resources, uint32 QueryCount)
+{
+    if (Resources.StatsQueryHeap && Resources.StatsReadbackBuffer && Resources.StatsQueryCapacity >= QueryCount)
+    {
+        return true;
+    }
+
+    ID3D12Device* D3DDevice = Device ? Device->GetDevice() : nullptr;
+    Resources.StatsQueryHeap.Reset();
+    Resources.StatsReadbackBuffer.Reset();
+    Resources.StatsQueryCapacity = 0;
+    if (!D3DDevice)
+    {
+        return false;
+    }
+
+    D3D12_QUERY_HEAP_DESC HeapDesc = {};
+    HeapDesc.Count = QueryCount;
+    HeapDesc.Type = D3D12_QUERY_HEAP_TYPE_PIPELINE_STATISTICS;
+    HeapDesc.NodeMask = 0;
+    if (FAILED(D3DDevice->CreateQueryHeap(&HeapDesc, IID_PPV_ARGS(Resources.StatsQueryHeap.ReleaseAndGetAddressOf()))))
+    {
+        LogWarning("Failed to create the pipeline statistics query heap");
+        return false;
+    }
+
+    const UINT64 ReadbackSize = static_cast<UINT64>(HeapDesc.Count) * sizeof(D3D12_QUERY_DATA_PIPELINE_STATISTICS);
+    CD3DX12_HEAP_PROPERTIES HeapProps(D3D12_HEAP_TYPE_READBACK);
+    CD3DX12_RESOURCE_DESC BufferDesc = CD3DX12_RESOURCE_DESC::Buffer(ReadbackSize);
+
+    FGpuMemoryOwnerScope SharedMemoryScope(FDX12MemoryTracker::SharedOwner);
+    if (FAILED(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Readback,
+        &HeapProps,
+        D3D12_HEAP_FLAG_NONE,
+        &BufferDesc,
+        D3D12_RESOURCE_STATE_COPY_DEST,
+        nullptr,
+        IID_PPV_ARGS(Resources.StatsReadbackBuffer.ReleaseAndGetAddressOf()))))
+    {
+        LogWarning("Failed to create the pipeline statistics readback buffer");
+        Resources.StatsQueryHeap.Reset();
+        return false;
+    }
+
+    Resources.StatsQueryCapacity = HeapDesc.Count;
+    return true;
+}
+
 void FRenderGraph::ProcessPendingGpuTimings(const FDX12CommandContext& CmdContext, uint32 FrameIndex)
 {
     auto It = PendingGpuTimings.find(FrameIndex);
@@ -703,11 +2507,18 @@ void FRenderGraph::ProcessPendingGpuTimings(const FDX12CommandContext& CmdContex
         return;
     }
 
-	if (!bEnableGpuTiming)
-	{
-		PendingGpuTimings.erase(It);
-		return;
-	}
+    const uint64 CaptureFrameId = It->second.CaptureFrameId;
+    auto DiscardPending = [&]()
+    {
+        CompleteCapturedFrame(CaptureFrameId);
+        PendingGpuTimings.erase(It);
+    };
+
+    if (!IsGpuTimingActive())
+    {
+        DiscardPending();
+        return;
+    }
 
     const FDX12CommandQueue* Queue = Device ? Device->GetGraphicsQueue() : nullptr;
     const uint64 FenceValue = CmdContext.GetFrameFenceValue(FrameIndex);
@@ -719,7 +2530,7 @@ void FRenderGraph::ProcessPendingGpuTimings(const FDX12CommandContext& CmdContex
 	FGpuTimingData& Timing = It->second;
     if (!Timing.bPending || !Timing.ReadbackBuffer || Timing.QueryCount == 0 || Timing.Frequency == 0)
     {
-        PendingGpuTimings.erase(It);
+        DiscardPending();
         return;
     }
 
@@ -730,12 +2541,13 @@ void FRenderGraph::ProcessPendingGpuTimings(const FDX12CommandContext& CmdContex
     HRESULT MapResult = Timing.ReadbackBuffer->Map(0, &ReadRange, reinterpret_cast<void**>(&TimestampData));
     if (FAILED(MapResult) || !TimestampData)
     {
-        PendingGpuTimings.erase(It);
+        DiscardPending();
         return;
     }
 
     const size_t PassCount = Timing.PassNames.size();
     const auto Now = std::chrono::steady_clock::now();
+    FCapturedFrame* CapturedFrame = FindCapturedFrame(CaptureFrameId);
     const double WindowSeconds = (std::max)(0.1, GpuTimingWindowSeconds);
     for (size_t Index = 0; Index < PassCount; ++Index)
     {
@@ -747,15 +2559,31 @@ void FRenderGraph::ProcessPendingGpuTimings(const FDX12CommandContext& CmdContex
             continue;
         }
 
+        const ERGPassQueue PassQueue = Index < Timing.PassQueues.size() ? Timing.PassQueues[Index] : ERGPassQueue::Graphics;
+        const uint64 Frequency = (PassQueue == ERGPassQueue::AsyncCompute && Timing.ComputeFrequency != 0) ? Timing.ComputeFrequency : Timing.Frequency;
+
         const uint64 StartTimestamp = TimestampData[StartIdx];
         const uint64 EndTimestamp = TimestampData[EndIdx];
-        const double Delta = static_cast<double>(EndTimestamp - StartTimestamp) / static_cast<double>(Timing.Frequency);
+        const double Delta = static_cast<double>(EndTimestamp - StartTimestamp) / static_cast<double>(Frequency);
         const double Milliseconds = Delta * 1000.0;
 
         const std::string& PassName = Timing.PassNames[Index];
+        GpuTimingPassQueues[PassName] = PassQueue;
         std::deque<FGpuTimingSample>& Samples = GpuTimingSamples[PassName];
         Samples.push_back({ Now, Milliseconds });
 
+        if (CapturedFrame)
+        {
+            for (FCapturedPassTiming& Captured : CapturedFrame->Passes)
+            {
+                if (Captured.GpuMs < 0.0 && Captured.Name == PassName)
+                {
+                    Captured.GpuMs = Milliseconds;
+                    break;
+                }
+            }
+        }
+
         const auto Cutoff = Now - std::chrono::duration<double>(WindowSeconds);
         while (!Samples.empty() && Samples.front().Timestamp < Cutoff)
         {
@@ -766,6 +2594,268 @@ void FRenderGraph::ProcessPendingGpuTimings(const FDX12CommandContext& CmdContex
     Timing.ReadbackBuffer->Unmap(0, nullptr);
 
     UpdateCachedGpuTimingStats(Now);
+    AddPipelineStatsSamples(Timing, Now);
+
+    DiscardPending();
+}
+
+namespace
+{
+    // Nearest-rank percentile of an ascending series.
+    double GetPercentile(const std::vector<double>& Sorted, double Percent)
+    {
+        if (Sorted.empty())
+        {
+            return 0.0;
+        }
+
+        const double Rank = std::ceil(Percent / 100.0 * static_cast<double>(Sorted.size()));
+        const size_t Index = static_cast<size_t>((std::max)(1.0, Rank)) - 1;
+        return Sorted[(std::min)(Index, Sorted.size() - 1)];
+    }
+
+    std::string EscapeJsonString(const std::string& Value)
+    {
+        std::string Result;
+        Result.reserve(Value.size());
+        for (const char Character : Value)
+        {
+            if (Character == '"' || Character == '\\')
+            {
+                Result.push_back('\\');
+            }
+            Result.push_back(Character);
+        }
+        return Result;
+    }
+
+    const char* GetCaptureQueueName(ERGPassQueue Queue, bool bExternal)
+    {
+        if (bExternal)
+        {
+            return "External";
+        }
+        return Queue == ERGPassQueue::AsyncCompute ? "Compute" : "Graphics";
+    }
+}
+
+bool FRenderGraph::BeginTimingCapture(uint32 FrameCount, const std::string& OutputStem)
+{
+    if (TimingCapture.bActive || FrameCount == 0 || OutputStem.empty())
+    {
+        return false;
+    }
+
+    TimingCapture = {};
+    TimingCapture.bActive = true;
+    TimingCapture.FrameCount = FrameCount;
+    TimingCapture.OutputStem = OutputStem;
+    TimingCapture.Frames.reserve(FrameCount);
+
+    LogInfo("[RG] GPU timing capture started: " + std::to_string(FrameCount) + " frames");
+    return true;
+}
+
+uint64 FRenderGraph::CaptureTimingFrame(const FCompiledGraph& Compiled, bool bGpuResultsPending)
+{
+    if (!TimingCapture.bActive || TimingCapture.Frames.size() >= TimingCapture.FrameCount)
+    {
+        return 0;
+    }
+
+    FCapturedFrame& Frame = TimingCapture.Frames.emplace_back();
+    Frame.FrameId = CompiledGraphFrameCounter;
+    Frame.Passes.reserve(Compiled.ActivePassCount);
+    for (size_t PassIndex = 0; PassIndex < Passes.size(); ++PassIndex)
+    {
+        if (!Compiled.PassRequired[PassIndex])
+        {
+            continue;
+        }
+
+        FCapturedPassTiming& Captured = Frame.Passes.emplace_back();
+        Captured.Name = std::string(Passes[PassIndex].Name);
+        Captured.Queue = Compiled.CompiledPasses[PassIndex].Queue;
+        Captured.CpuMs = Passes[PassIndex].ElapsedMs;
+    }
+
+    if (!bGpuResultsPending)
+    {
+        CompleteCapturedFrame(Frame.FrameId);
+    }
+
+    return Frame.FrameId;
+}
+
+FRenderGraph::FCapturedFrame* FRenderGraph::FindCapturedFrame(uint64 FrameId)
+{
+    if (!TimingCapture.bActive || FrameId == 0)
+    {
+        return nullptr;
+    }
+
+    for (FCapturedFrame& Frame : TimingCapture.Frames)
+    {
+        if (Frame.FrameId == FrameId)
+        {
+            return &Frame;
+        }
+    }
+    return nullptr;
+}
+
+void FRenderGraph::CompleteCapturedFrame(uint64 FrameId)
+{
+    FCapturedFrame* Frame = FindCapturedFrame(FrameId);
+    if (!Frame || Frame->bResolved)
+    {
+        return;
+    }
+
+    Frame->bResolved = true;
+    ++TimingCapture.ResolvedFrames;
+
+    if (TimingCapture.ResolvedFrames >= TimingCapture.FrameCount)
+    {
+        WriteTimingCapture();
+        TimingCapture.bActive = false;
+    }
+}
+
+void FRenderGraph::WriteTimingCapture()
+{
+    const std::filesystem::path Stem(TimingCapture.OutputStem);
+    if (Stem.has_parent_path())
+    {
+        std::error_code Error;
+        std::filesystem::create_directories(Stem.parent_path(), Error);
+    }
+
+    std::filesystem::path CsvPath = Stem;
+    CsvPath += ".csv";
+    std::filesystem::path JsonPath = Stem;
+    JsonPath += ".json";
+
+    // Per-name series in order of first appearance so two captures of the same scene line up.
+    struct FSeries
+    {
+        std::string Name;
+        const char* Queue = "";
+        std::vector<double> CpuMs;
+        std::vector<double> GpuMs;
+    };
+
+    std::vector<FSeries> Series;
+    std::unordered_map<std::string, size_t> SeriesIndices;
+
+    std::ofstream Csv(CsvPath, std::ios::trunc);
+    if (!Csv)
+    {
+        LogError("[RG] Failed to write GPU timing capture: " + CsvPath.string());
+        return;
+    }
+
+    Csv << std::fixed << std::setprecision(4);
+    Csv << "frame,pass,queue,cpu_ms,gpu_ms\n";
+    for (size_t FrameIndex = 0; FrameIndex < TimingCapture.Frames.size(); ++FrameIndex)
+    {
+        for (const FCapturedPassTiming& Captured : TimingCapture.Frames[FrameIndex].Passes)
+        {
+            const char* QueueName = GetCaptureQueueName(Captured.Queue, Captured.bExternal);
+            Csv << FrameIndex << ',' << Captured.Name << ',' << QueueName << ',';
+            if (Captured.CpuMs >= 0.0)
+            {
+                Csv << Captured.CpuMs;
+            }
+            Csv << ',';
+            if (Captured.GpuMs >= 0.0)
+            {
+                Csv << Captured.GpuMs;
+            }
+            Csv << '\n';
+
+            auto [It, bInserted] = SeriesIndices.try_emplace(Captured.Name, Series.size());
+            if (bInserted)
+            {
+                Series.push_back({ Captured.Name, QueueName, {}, {} });
+            }
+
+            FSeries& Entry = Series[It->second];
+            if (Captured.CpuMs >= 0.0)
+            {
+                Entry.CpuMs.push_back(Captured.CpuMs);
+            }
+            if (Captured.GpuMs >= 0.0)
+            {
+                Entry.GpuMs.push_back(Captured.GpuMs);
+            }
+        }
+    }
+
+    std::ofstream Json(JsonPath, std::ios::trunc);
+    if (!Json)
+    {
+        LogError("[RG] Failed to write GPU timing capture: " + JsonPath.string());
+        return;
+    }
+
+    auto WriteStats = [&Json](const char* Label, std::vector<double>& Values)
+    {
+        std::sort(Values.begin(), Values.end());
+        double Sum = 0.0;
+        for (double Value : Values)
+        {
+            Sum += Value;
+        }
+
+        Json << "\"" << Label << "\": { \"samples\": " << Values.size();
+        if (!Values.empty())
+        {
+            Json << ", \"mean\": " << Sum / static_cast<double>(Values.size())
+                << ", \"min\": " << Values.front()
+                << ", \"p50\": " << GetPercentile(Values, 50.0)
+                << ", \"p95\": " << GetPercentile(Values, 95.0)
+                << ", \"p99\": " << GetPercentile(Values, 99.0)
+                << ", \"max\": " << Values.back();
+        }
+        Json << " }";
+    };
+
+    Json << std::fixed << std::setprecision(4);
+    Json << "{\n  \"frameCount\": " << TimingCapture.Frames.size() << ",\n  \"passes\": [\n";
+    for (size_t Index = 0; Index < Series.size(); ++Index)
+    {
+        FSeries& Entry = Series[Index];
+        Json << "    { \"name\": \"" << EscapeJsonString(Entry.Name) << "\", \"queue\": \"" << Entry.Queue << "\", ";
+        WriteStats("cpu", Entry.CpuMs);
+        Json << ", ";
+        WriteStats("gpu", Entry.GpuMs);
+        Json << " }" << (Index + 1 < Series.size() ? "," : "") << "\n";
+    }
+
+    Json << "  ],\n  \"frames\": [\n";
+    for (size_t FrameIndex = 0; FrameIndex < TimingCapture.Frames.size(); ++FrameIndex)
+    {
+        const std::vector<FCapturedPassTiming>& FramePasses = TimingCapture.Frames[FrameIndex].Passes;
+        Json << "    [";
+        for (size_t PassIndex = 0; PassIndex < FramePasses.size(); ++PassIndex)
+        {
+            const FCapturedPassTiming& Captured = FramePasses[PassIndex];
+            Json << (PassIndex > 0 ? ", " : "") << "{ \"name\": \"" << EscapeJsonString(Captured.Name) << "\"";
+            if (Captured.CpuMs >= 0.0)
+            {
+                Json << ", \"cpu\": " << Captured.CpuMs;
+            }
+            if (Captured.GpuMs >= 0.0)
+            {
+                Json << ", \"gpu\": " << Captured.GpuMs;
+            }
+            Json << " }";
+        }
+        Json << "]" << (FrameIndex + 1 < TimingCapture.Frames.size() ? "," : "") << "\n";
+    }
+    Json << "  ]\n}\n";
 
-    PendingGpuTimings.erase(It);
+    LastTimingCapturePath = JsonPath.string();
+    LogInfo("[RG] GPU timing capture written: " + CsvPath.string() + ", " + JsonPath.string());
 }
@@ -2,6 +2,8 @@
 
 #include <functional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 #include <cstdint>
 #include <deque>
@@ -9,6 +11,9 @@
 #include <chrono>
 #include <unordered_map>
 #include "../RHI/DX12Commons.h"
+#include "../Core/TaskSystem.h"
+#include "../Core/LinearAllocator.h"
+#include "../Core/CpuProfiler.h"
 
 class FDX12CommandContext;
 class FDX12Device;
@@ -20,6 +25,17 @@ struct FRGTextureDesc
     DXGI_FORMAT Format = DXGI_FORMAT_UNKNOWN;
 };
 
+struct FRGBufferDesc
+{
+    uint64 Size = 0;
+};
+
+enum class ERGResourceType : uint8
+{
+    Texture,
+    Buffer,
+};
+
 struct FRGResourceHandle
 {
     uint32 Id = UINT32_MAX;
@@ -32,12 +48,26 @@ enum class ERGResourceAccess
     Write,
 };
 
+// Queue a pass prefers. Async compute passes fall back to graphics when no compute queue
+// is available or when they require a state only the graphics queue can use.
+enum class ERGPassQueue : uint8
+{
+    Graphics,
+    AsyncCompute,
+};
+
 class FRGPassBuilder;
 
 class FRenderGraph
 {
 public:
-    FRenderGraph();
+    // Pass and resource bookkeeping comes from the frame allocator of the command context's
+    // current frame, which is recycled once that frame's fence has completed.
+    explicit FRenderGraph(FDX12CommandContext& CmdContext);
+    ~FRenderGraph();
+
+    FRenderGraph(const FRenderGraph&) = delete;
+    FRenderGraph& operator=(const FRenderGraph&) = delete;
 
     struct FGpuPassTimingStats
     {
@@ -46,6 +76,20 @@ public:
         double MinMs = 0.0;
         double MaxMs = 0.0;
         uint32 SampleCount = 0;
+        ERGPassQueue Queue = ERGPassQueue::Graphics;
+    };
+
+    // Pipeline statistics of a graphics pass per execution, averaged like the timings. Sliced
+    // passes sum their slices; async compute passes are not queried.
+    struct FGpuPassPipelineStats
+    {
+        std::string Name;
+        double IAPrimitives = 0.0;
+        double VSInvocations = 0.0;
+        double PSInvocations = 0.0;
+        double ClippedPrimitives = 0.0;
+        double CSInvocations = 0.0;
+        uint32 SampleCount = 0;
     };
 
     void SetDevice(FDX12Device* InDevice) { Device = InDevice; }
@@ -53,28 +97,52 @@ public:
     friend class FRGPassBuilder;
 
     FRGResourceHandle ImportTexture(
-        const std::string& Name,
+        std::string_view Name,
         ID3D12Resource* Resource,
         D3D12_RESOURCE_STATES* StatePtr,
         const FRGTextureDesc& Desc);
 
+    FRGResourceHandle ImportBuffer(
+        std::string_view Name,
+        ID3D12Resource* Resource,
+        D3D12_RESOURCE_STATES* StatePtr,
+        const FRGBufferDesc& Desc);
+
     template <typename PassData, typename SetupFunc, typename ExecuteFunc>
-    void AddPass(const std::string& Name, SetupFunc&& Setup, ExecuteFunc&& Execute)
+    void AddPass(std::string_view Name, SetupFunc&& Setup, ExecuteFunc&& Execute, ERGPassQueue Queue = ERGPassQueue::Graphics)
     {
-        PassEntry Entry;
-        Entry.Name = Name;
-        Entry.DataStorage.resize(sizeof(PassData));
-        new (Entry.DataStorage.data()) PassData();
+        CPU_PROFILE_SCOPE_DYNAMIC(Name);
+        PassEntry Entry = CreatePassEntry<PassData>(Name);
+        Entry.Queue = Queue;
 
-        PassData& Data = *reinterpret_cast<PassData*>(Entry.DataStorage.data());
+        PassData& Data = *static_cast<PassData*>(Entry.Data);
         FRGPassBuilder Builder(*this, Entry);
         Setup(Data, Builder);
 
-        Entry.ExecuteFunc = [Execute = std::forward<ExecuteFunc>(Execute)](const std::vector<uint8_t>& Storage, FDX12CommandContext& Cmd)
+        BindPassExecute<PassData>(Entry, [Execute = std::forward<ExecuteFunc>(Execute)](const PassData& PassStorage, FDX12CommandContext& Cmd, uint32, uint32)
         {
-            const PassData& PassStorage = *reinterpret_cast<const PassData*>(Storage.data());
             Execute(PassStorage, Cmd);
-        };
+        });
+
+        Passes.push_back(std::move(Entry));
+    }
+
+    // Graphics pass whose recording can be split into up to MaxSlices command lists recorded
+    // on task workers. Execute is called as Execute(Data, Cmd, SliceIndex, SliceCount) once per
+    // slice and must set all pipeline state itself; slices run on the GPU in slice order.
+    template <typename PassData, typename SetupFunc, typename ExecuteFunc>
+    void AddSlicedPass(std::string_view Name, uint32 MaxSlices, SetupFunc&& Setup, ExecuteFunc&& Execute)
+    {
+        CPU_PROFILE_SCOPE_DYNAMIC(Name);
+        PassEntry Entry = CreatePassEntry<PassData>(Name);
+        Entry.bParallelRecording = true;
+        Entry.MaxRecordingSlices = MaxSlices > 0 ? MaxSlices : 1;
+
+        PassData& Data = *static_cast<PassData*>(Entry.Data);
+        FRGPassBuilder Builder(*this, Entry);
+        Setup(Data, Builder);
+
+        BindPassExecute<PassData>(Entry, std::forward<ExecuteFunc>(Execute));
 
         Passes.push_back(std::move(Entry));
     }
@@ -86,6 +154,9 @@ public:
     void SetResourceLifetimeLogging(bool bEnable) { bEnableResourceLifetimeLog = bEnable; }
     void SetBarrierLoggingEnabled(bool bEnable) { bEnableBarrierLogs = bEnable; }
     void SetGpuTimingEnabled(bool bEnable) { bEnableGpuTiming = bEnable; }
+    // Queries pipeline statistics around every graphics pass while GPU timing is active.
+    void SetPipelineStatisticsEnabled(bool bEnable) { bEnablePipelineStatistics = bEnable; }
+    void SetParallelRecordingEnabled(bool bEnable) { bEnableParallelRecording = bEnable; }
 
     static void SetGpuTimingWindowSeconds(double Seconds);
     static double GetGpuTimingWindowSeconds();
@@ -93,6 +164,24 @@ public:
     static uint32 GetGpuTimingDisplayCount();
     static const std::vector<FGpuPassTimingStats>& GetGpuTimingStats();
     static void AddExternalGpuTimingSample(const std::string& Name, double Milliseconds);
+    static const std::vector<FGpuPassPipelineStats>& GetPipelineStats();
+    // Entry of GetPipelineStats for the pass Name, or null when it has none.
+    static const FGpuPassPipelineStats* FindPipelineStats(const std::string& Name);
+    // Drops every sample, so the statistics restart from the next resolved frame.
+    static void ResetGpuTimingStats();
+
+    // Records CPU and GPU time of every executed pass, plus external samples, for the next
+    // FrameCount graph executions and writes OutputStem.csv and OutputStem.json once all of
+    // them have resolved. GPU timing is forced on while a capture runs.
+    static bool BeginTimingCapture(uint32 FrameCount, const std::string& OutputStem);
+    static bool IsTimingCaptureActive() { return TimingCapture.bActive; }
+    static uint32 GetTimingCaptureFrameCount() { return TimingCapture.FrameCount; }
+    static uint32 GetTimingCaptureResolvedFrames() { return TimingCapture.ResolvedFrames; }
+    static const std::string& GetLastTimingCapturePath() { return LastTimingCapturePath; }
+
+    // Marks the frame allocator of FrameIndex reusable once FenceValue completes on the graphics queue.
+    // Pooled transients used by graphs executed since the previous call are retired with the same fence.
+    static void RetireFrameAllocations(uint32 FrameIndex, uint64 FenceValue);
 
 private:
     struct FRGResourceUsage
@@ -102,10 +191,12 @@ private:
         ERGResourceAccess Access = ERGResourceAccess::Read;
     };
 
-    struct FRGTextureResource
+    struct FRGResource
     {
-        std::string Name;
+        std::string_view Name;
+        ERGResourceType Type = ERGResourceType::Texture;
         FRGTextureDesc Desc;
+        FRGBufferDesc BufferDesc;
         D3D12_RESOURCE_FLAGS Flags = D3D12_RESOURCE_FLAG_NONE;
         ID3D12Resource* Resource = nullptr;
         D3D12_RESOURCE_STATES* ExternalState = nullptr;
@@ -116,51 +207,275 @@ private:
         bool bExternal = false;
     };
 
+    using FRGUsageList = std::vector<FRGResourceUsage, TLinearAllocatorAdapter<FRGResourceUsage>>;
+
+    // Name, pass data, execute closure and usage list all live in the frame allocator; the
+    // graph runs the destructors of pass data and closures when it is destroyed.
     struct PassEntry
     {
-        std::string Name;
-        std::vector<uint8_t> DataStorage;
-        std::function<void(const std::vector<uint8_t>&, FDX12CommandContext&)> ExecuteFunc;
-        std::vector<FRGResourceUsage> ResourceUsages;
+        using FExecuteThunk = void (*)(const void* Closure, const void* Data, FDX12CommandContext& Cmd, uint32 SliceIndex, uint32 SliceCount);
+        using FDestroyFunc = void (*)(void* Object);
+
+        explicit PassEntry(FLinearAllocator& Allocator)
+            : ResourceUsages(TLinearAllocatorAdapter<FRGResourceUsage>(&Allocator))
+        {
+        }
+
+        bool HasExecute() const { return ExecuteThunk != nullptr; }
+        void Execute(FDX12CommandContext& Cmd, uint32 SliceIndex, uint32 SliceCount) const
+        {
+            ExecuteThunk(ExecuteClosure, Data, Cmd, SliceIndex, SliceCount);
+        }
+
+        std::string_view Name;
+        void* Data = nullptr;
+        void* ExecuteClosure = nullptr;
+        FExecuteThunk ExecuteThunk = nullptr;
+        FDestroyFunc DestroyData = nullptr;
+        FDestroyFunc DestroyClosure = nullptr;
+        FRGUsageList ResourceUsages;
         bool bCulled = false;
         bool bForceExecute = false;
+        bool bParallelRecording = false;
+        uint32 MaxRecordingSlices = 1;
+        ERGPassQueue Queue = ERGPassQueue::Graphics;
         double ElapsedMs = 0.0;
         double GpuElapsedMs = 0.0;
     };
 
-    FRGResourceHandle RegisterTexture(const std::string& Name, const FRGTextureDesc& Desc);
+    template <typename PassData>
+    PassEntry CreatePassEntry(std::string_view Name)
+    {
+        PassEntry Entry(*FrameAllocator);
+        Entry.Name = FrameAllocator->CopyString(Name);
+        Entry.Data = FrameAllocator->New<PassData>();
+        if constexpr (!std::is_trivially_destructible_v<PassData>)
+        {
+            Entry.DestroyData = [](void* Object) { static_cast<PassData*>(Object)->~PassData(); };
+        }
+        return Entry;
+    }
+
+    template <typename PassData, typename ClosureType>
+    void BindPassExecute(PassEntry& Entry, ClosureType&& Closure)
+    {
+        using FClosure = std::decay_t<ClosureType>;
+        Entry.ExecuteClosure = FrameAllocator->New<FClosure>(std::forward<ClosureType>(Closure));
+        Entry.ExecuteThunk = [](const void* ClosurePtr, const void* Data, FDX12CommandContext& Cmd, uint32 SliceIndex, uint32 SliceCount)
+        {
+            (*static_cast<const FClosure*>(ClosurePtr))(*static_cast<const PassData*>(Data), Cmd, SliceIndex, SliceCount);
+        };
+        if constexpr (!std::is_trivially_destructible_v<FClosure>)
+        {
+            Entry.DestroyClosure = [](void* Object) { static_cast<FClosure*>(Object)->~FClosure(); };
+        }
+    }
+
+    FRGResourceHandle RegisterTexture(std::string_view Name, const FRGTextureDesc& Desc);
+    FRGResourceHandle RegisterBuffer(std::string_view Name, const FRGBufferDesc& Desc);
     void RegisterUsage(PassEntry& Entry, const FRGResourceHandle& Handle, D3D12_RESOURCE_STATES RequiredState, ERGResourceAccess Access);
 
+    // Compiled schedule for one graph topology. Reused on later frames whose passes and
+    // usages hash the same, as long as every resource starts in the recorded state.
+    struct FCompiledBarrier
+    {
+        uint32 ResourceId = 0;
+        D3D12_RESOURCE_STATES StateBefore = D3D12_RESOURCE_STATE_COMMON;
+        D3D12_RESOURCE_STATES StateAfter = D3D12_RESOURCE_STATE_COMMON;
+        D3D12_RESOURCE_BARRIER_FLAGS Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+        int32 PairedPass = -1;
+        bool bAliasing = false;
+        bool bDiscard = false;
+    };
+
+    struct FCompiledPass
+    {
+        ERGPassQueue Queue = ERGPassQueue::Graphics;
+        bool bJoinBefore = false;
+        bool bForkBefore = false;
+        uint32 FirstForkBarrier = 0;
+        uint32 ForkBarrierCount = 0;
+        uint32 FirstAcquire = 0;
+        uint32 AcquireCount = 0;
+        uint32 FirstBarrier = 0;
+        uint32 BarrierCount = 0;
+        uint32 FirstDiscard = 0;
+        uint32 DiscardCount = 0;
+        uint32 FirstRelease = 0;
+        uint32 ReleaseCount = 0;
+    };
+
+    struct FCompiledGraph
+    {
+        uint64 TopologyHash = 0;
+        uint64 LastUsedFrame = 0;
+        std::vector<bool> PassRequired;
+        std::vector<bool> ResourceRequired;
+        std::vector<int32> FirstUse;
+        std::vector<int32> LastUse;
+        std::vector<int32> PoolIndices;
+        std::vector<D3D12_RESOURCE_STATES> InitialStates;
+        std::vector<D3D12_RESOURCE_STATES> FinalStates;
+        std::vector<std::pair<int32, D3D12_RESOURCE_STATES>> PoolInitialStates;
+        std::vector<FCompiledPass> CompiledPasses;
+        std::vector<uint32> Acquires;
+        std::vector<FCompiledBarrier> Barriers;
+        std::vector<uint32> Discards;
+        std::vector<uint32> Releases;
+        uint32 ActivePassCount = 0;
+        bool bJoinAtEnd = false;
+    };
+
+    uint64 ComputeTopologyHash(bool bAsyncComputeAvailable) const;
+    bool IsCompiledGraphValid(const FCompiledGraph& Compiled) const;
+    void CompileGraph(uint64 TopologyHash, bool bAsyncComputeAvailable, FCompiledGraph& OutCompiled);
+    // Records the barriers through ID3D12GraphicsCommandList7::Barrier when the device supports
+    // enhanced barriers, translating the planned legacy states to sync/access/layout scopes.
+    void EmitCompiledBarriers(FDX12CommandContext& Context, const FCompiledGraph& Compiled, uint32 FirstBarrier, uint32 BarrierCount, const PassEntry& Entry);
+    void ForkAsyncCompute(FDX12CommandContext& GraphicsContext, FDX12CommandContext& ComputeContext);
+    FDX12CommandContext* AcquireParallelContext(FDX12CommandContext& CmdContext);
+    void SubmitParallelRecording(FDX12CommandContext& CmdContext);
+    void JoinAsyncCompute(FDX12CommandContext& GraphicsContext, FDX12CommandContext& ComputeContext);
+    D3D12_RESOURCE_STATES GetResourceState(const FRGResource& Resource) const;
+
     void AccumulateResourceFlags(const FRGResourceHandle& Handle, D3D12_RESOURCE_STATES RequiredState, ERGResourceAccess Access);
-    bool AcquireTransientTexture(FRGTextureResource& Texture, D3D12_RESOURCE_STATES InitialState);
-    void ReleaseTransientTexture(FRGTextureResource& Texture);
+    void PlaceTransientResources(
+        const std::vector<int32>& FirstRequiredUse,
+        const std::vector<int32>& LastRequiredUse,
+        const std::vector<D3D12_RESOURCE_STATES>& FirstRequiredState,
+        std::vector<int32>& OutPoolIndices);
+    bool EnsureTransientHeap(uint32 Category, uint64 Size);
+    int32 AcquirePlacedResource(const FRGResource& Resource, uint32 Category, uint64 HeapOffset, D3D12_RESOURCE_STATES InitialState);
+    int32 AcquireTransientResource(const FRGResource& Resource, D3D12_RESOURCE_STATES InitialState);
+    void ReleaseTransientResource(FRGResource& Resource);
     void DumpDebugInfo(const std::vector<bool>& PassRequired, const std::vector<bool>& ResourceRequired);
     void LogTimingSummary();
 
-    FRGTextureResource* ResolveResource(const FRGResourceHandle& Handle);
+    FRGResource* ResolveResource(const FRGResourceHandle& Handle);
+
+    // One slice of a pass recorded on a task worker into its own command list.
+    struct FParallelRecord
+    {
+        PassEntry* Entry = nullptr;
+        FDX12CommandContext* Context = nullptr;
+        ID3D12QueryHeap* QueryHeap = nullptr;
+        uint32 EndQueryIndex = UINT32_MAX;
+        // Every slice brackets its own list with a pipeline statistics query.
+        ID3D12QueryHeap* StatsQueryHeap = nullptr;
+        uint32 StatsQueryIndex = UINT32_MAX;
+        uint32 SliceIndex = 0;
+        uint32 SliceCount = 1;
+        double ElapsedMs = 0.0;
+    };
+
+    static void RecordParallelSlice(FParallelRecord& Record, bool bMeasureElapsed);
+
+    static FLinearAllocator& AcquireFrameAllocator(const FDX12CommandContext& CmdContext);
 
     FDX12Device* Device = nullptr;
 
-    std::vector<FRGTextureResource> Textures;
-    std::vector<PassEntry> Passes;
+    FLinearAllocator* FrameAllocator = nullptr;
+    std::vector<FRGResource, TLinearAllocatorAdapter<FRGResource>> Resources;
+    std::vector<PassEntry, TLinearAllocatorAdapter<PassEntry>> Passes;
 
-    struct FPooledTexture
+    // Lists recorded since the last submission, in submission order after the main list.
+    // Records live in a deque so workers keep valid pointers while more are appended.
+    std::vector<FDX12CommandContext*> ParallelContexts;
+    std::deque<FParallelRecord> ParallelRecords;
+    FTaskCounter ParallelRecordCounter;
+
+    struct FPooledResource
     {
+        ERGResourceType Type = ERGResourceType::Texture;
         FRGTextureDesc Desc;
+        FRGBufferDesc BufferDesc;
         D3D12_RESOURCE_FLAGS Flags = D3D12_RESOURCE_FLAG_NONE;
         Microsoft::WRL::ComPtr<ID3D12Resource> Resource;
+        Microsoft::WRL::ComPtr<ID3D12Heap> Heap;
+        uint64 HeapOffset = 0;
         D3D12_RESOURCE_STATES CurrentState = D3D12_RESOURCE_STATE_COMMON;
+        // Graph execution that last bound the entry, and the graphics fence retiring that use.
+        uint64 LastUsedFrame = 0;
+        uint64 LastUsedFenceValue = 0;
+        uint64 LookupKey = 0;
         bool bInUse = false;
     };
 
-    static std::vector<FPooledTexture> TexturePool;
+    // Entries are found through ResourcePoolLookup, keyed by HashPoolKey. Slots of evicted entries
+    // are reused, so the indices cached in compiled graphs stay valid for every live entry.
+    static std::vector<FPooledResource> ResourcePool;
+    static std::unordered_multimap<uint64, int32> ResourcePoolLookup;
+    static std::vector<int32> FreePoolSlots;
+
+    // Pool entries no graph has bound for this many executions are released once the fence of
+    // their last use completes. Transients registered at a new size, e.g. after a resolution
+    // change, get new entries and the stale ones age out without waiting for the GPU.
+    static constexpr uint64 PoolEvictionFrames = 120;
+    static uint64 LastRetiredGraphFrame;
+
+    static bool IsPoolCompatible(const FPooledResource& Pooled, const FRGResource& Resource);
+    static uint64 HashPoolKey(const FRGResource& Resource, const ID3D12Heap* Heap, uint64 HeapOffset);
+    static int32 AddPooledResource(FPooledResource&& Pooled);
+    // Releases aged-out entries and the compiled graphs referring to them, and transient heaps
+    // nothing is placed in any more.
+    static void TrimResourcePool(uint64 CompletedFenceValue);
+    static D3D12_RESOURCE_DESC BuildTransientResourceDesc(const FRGResource& Resource);
+
+    // Transients are placed into shared heaps so resources with disjoint lifetimes overlap in
+    // memory. Tier 1 hardware needs render target/depth textures, other textures and buffers
+    // in separate heaps.
+    // A heap is replaced by a smaller one when a compiled graph needs less than half of it; the
+    // old heap lives on until the entries placed in it age out of the pool.
+    struct FTransientHeap
+    {
+        Microsoft::WRL::ComPtr<ID3D12Heap> Heap;
+        uint64 Size = 0;
+    };
+
+    static constexpr uint32 TransientHeapCategoryCount = 3;
+    static FTransientHeap TransientHeaps[TransientHeapCategoryCount];
+    static D3D12_RESOURCE_HEAP_TIER TransientHeapTier;
+    static bool bTransientHeapTierQueried;
+
+    static constexpr size_t MaxCompiledGraphs = 8;
+    static std::unordered_map<uint64, FCompiledGraph> CompiledGraphs;
+    static uint64 CompiledGraphFrameCounter;
+    static std::vector<D3D12_RESOURCE_BARRIER> BarrierScratch;
+    static std::vector<D3D12_TEXTURE_BARRIER> TextureBarrierScratch;
+    static std::vector<D3D12_BUFFER_BARRIER> BufferBarrierScratch;
+
+    // One allocator per frame in flight. A slot is reset when the next graph for it is built,
+    // provided the fence of the frame that last filled it has completed; otherwise the new
+    // graph keeps appending.
+    struct FFrameAllocatorSlot
+    {
+        FLinearAllocator Allocator;
+        uint64 RetiredFenceValue = 0;
+        bool bRetired = false;
+    };
+
+    static std::unordered_map<uint32, FFrameAllocatorSlot> FrameAllocators;
+
+    // Queries of one pass in the pipeline statistics heap, one per recorded slice.
+    struct FPipelineStatsRange
+    {
+        std::string Name;
+        uint32 FirstQuery = 0;
+        uint32 QueryCount = 0;
+    };
 
     struct FGpuTimingData
     {
         Microsoft::WRL::ComPtr<ID3D12Resource> ReadbackBuffer;
         uint32 QueryCount = 0;
         uint64 Frequency = 0;
+        uint64 ComputeFrequency = 0;
         std::vector<std::string> PassNames;
+        std::vector<ERGPassQueue> PassQueues;
+        Microsoft::WRL::ComPtr<ID3D12Resource> StatsReadbackBuffer;
+        uint32 StatsQueryCount = 0;
+        std::vector<FPipelineStatsRange> StatsPasses;
+        uint64 CaptureFrameId = 0;
         bool bPending = false;
     };
 
@@ -175,25 +490,84 @@ private:
     };
 
     static std::unordered_map<std::string, std::deque<FGpuTimingSample>> GpuTimingSamples;
+    static std::unordered_map<std::string, ERGPassQueue> GpuTimingPassQueues;
     static std::vector<FGpuPassTimingStats> CachedGpuTimingStats;
     static double GpuTimingWindowSeconds;
     static uint32 GpuTimingDisplayCount;
 
     static void UpdateCachedGpuTimingStats(const std::chrono::steady_clock::time_point& Now);
 
+    struct FPipelineStatsSample
+    {
+        std::chrono::steady_clock::time_point Timestamp;
+        D3D12_QUERY_DATA_PIPELINE_STATISTICS Data = {};
+    };
+
+    static std::unordered_map<std::string, std::deque<FPipelineStatsSample>> PipelineStatsSamples;
+    static std::vector<FGpuPassPipelineStats> CachedPipelineStats;
+
+    static void AddPipelineStatsSamples(const FGpuTimingData& Timing, const std::chrono::steady_clock::time_point& Now);
+    static void UpdateCachedPipelineStats(const std::chrono::steady_clock::time_point& Now);
+
+    struct FCapturedPassTiming
+    {
+        std::string Name;
+        ERGPassQueue Queue = ERGPassQueue::Graphics;
+        double CpuMs = -1.0;
+        double GpuMs = -1.0;
+        bool bExternal = false;
+    };
+
+    struct FCapturedFrame
+    {
+        uint64 FrameId = 0;
+        std::vector<FCapturedPassTiming> Passes;
+        bool bResolved = false;
+    };
+
+    struct FTimingCapture
+    {
+        bool bActive = false;
+        uint32 FrameCount = 0;
+        uint32 ResolvedFrames = 0;
+        std::string OutputStem;
+        std::vector<FCapturedFrame> Frames;
+    };
+
+    static FTimingCapture TimingCapture;
+    static std::string LastTimingCapturePath;
+
+    bool IsCpuTimingActive() const { return bEnableDebugRecording || TimingCapture.bActive; }
+    bool IsGpuTimingActive() const { return bEnableGpuTiming || TimingCapture.bActive; }
+    // Adds this execution to an active capture; returns its frame id, or 0 when not captured.
+    uint64 CaptureTimingFrame(const FCompiledGraph& Compiled, bool bGpuResultsPending);
+    static FCapturedFrame* FindCapturedFrame(uint64 FrameId);
+    static void CompleteCapturedFrame(uint64 FrameId);
+    static void WriteTimingCapture();
+
     struct FGpuTimingResources
     {
         Microsoft::WRL::ComPtr<ID3D12QueryHeap> QueryHeap;
         Microsoft::WRL::ComPtr<ID3D12Resource> ReadbackBuffer;
         uint32 QueryCapacity = 0;
+        Microsoft::WRL::ComPtr<ID3D12QueryHeap> StatsQueryHeap;
+        Microsoft::WRL::ComPtr<ID3D12Resource> StatsReadbackBuffer;
+        uint32 StatsQueryCapacity = 0;
     };
     static std::unordered_map<uint32, FGpuTimingResources> GpuTimingResources;
 
+    // Grows the pipeline statistics heap and readback of Resources to QueryCount queries.
+    bool EnsurePipelineStatsResources(FGpuTimingResources& Resources, uint32 QueryCount);
+
     bool bEnableDebugRecording = false;
     bool bEnableGraphDump = false;
     bool bEnableResourceLifetimeLog = false;
     bool bEnableBarrierLogs = false;
     bool bEnableGpuTiming = false;
+    bool bEnablePipelineStatistics = false;
+    bool bEnableParallelRecording = false;
+    bool bUseEnhancedBarriers = false;
+    bool bAsyncComputeFrameBegun = false;
 };
 
 class FRGPassBuilder
@@ -201,10 +575,16 @@ class FRGPassBuilder
 public:
     FRGPassBuilder(FRenderGraph& InGraph, FRenderGraph::PassEntry& InEntry);
 
-    FRGResourceHandle CreateTexture(const std::string& Name, const FRGTextureDesc& Desc);
+    FRGResourceHandle CreateTexture(std::string_view Name, const FRGTextureDesc& Desc);
     FRGResourceHandle ReadTexture(const FRGResourceHandle& Handle, D3D12_RESOURCE_STATES RequiredState = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
     FRGResourceHandle WriteTexture(const FRGResourceHandle& Handle, D3D12_RESOURCE_STATES RequiredState = D3D12_RESOURCE_STATE_RENDER_TARGET);
+    FRGResourceHandle CreateBuffer(std::string_view Name, const FRGBufferDesc& Desc);
+    FRGResourceHandle ReadBuffer(const FRGResourceHandle& Handle, D3D12_RESOURCE_STATES RequiredState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+    FRGResourceHandle WriteBuffer(const FRGResourceHandle& Handle, D3D12_RESOURCE_STATES RequiredState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
     void KeepAlive();
+    // The pass only reads renderer state that is final before the graph executes, so it may be
+    // recorded on a task worker into its own command list.
+    void AllowParallelRecording();
 
 private:
     FRenderGraph* Graph = nullptr;
@@ -3,23 +3,340 @@
 #include "ShaderCompiler.h"
 #include "RendererUtils.h"
 #include "TextureLoader.h"
+#include "TextureStreamer.h"
+#include "TextureMipStreamer.h"
 #include "DebugPrintFont.h"
 #include "../Scene/Camera.h"
 #include "../RHI/DX12CommandContext.h"
 #include "../RHI/DX12Device.h"
+#include "../Core/CpuProfiler.h"
 #include "../Core/GpuDebugMarkers.h"
 #include "../Core/Logger.h"
 #include <array>
 #include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <filesystem>
 
-FRenderer::~FRenderer() = default;
+FRenderer::~FRenderer()
+{
+    // Waits for the streaming tasks, which load through TextureLoader into this renderer's textures.
+    TextureStreamer.reset();
+    TextureMipStreamer.reset();
+
+    // Uploads write into resources this renderer owns; they must finish before those are released.
+    if (UploadQueue && PendingUploadFenceValue > 0)
+    {
+        UploadQueue->WaitOnCpu(PendingUploadFenceValue);
+    }
+
+    // Persistent frees are deferred by the allocator until the frames still using them retire.
+    if (FDX12DescriptorAllocator* Allocator = Device ? Device->GetDescriptorAllocator() : nullptr)
+    {
+        for (const FDX12DescriptorRange& Range : PersistentDescriptorRanges)
+        {
+            Allocator->FreePersistent(Range);
+        }
+        for (const FDX12DescriptorRange& Range : StagingDescriptorRanges)
+        {
+            Allocator->FreeStaging(Range);
+        }
+        for (const FDX12DescriptorRange& Range : StreamedMaterialTables)
+        {
+            if (Range.IsValid())
+            {
+                Allocator->FreePersistent(Range);
+            }
+        }
+    }
+}
+
+void FRenderer::OnFrameFenceSignaled(uint32_t FrameIndex, uint64_t FenceValue)
+{
+    if (TextureMipStreamer)
+    {
+        TextureMipStreamer->OnFrameFenceSignaled(FenceValue);
+    }
+}
+
+void FRenderer::FinalizeSceneModels()
+{
+    BuildSceneBvh();
+
+    TransformNodeModels.assign(SceneTransforms.GetNodeCount(), {});
+    MovedModelIndices.clear();
+    SettlingModelIndices.clear();
+    MaskedModelCount = 0;
+    for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+    {
+        MaskedModelCount += SceneModels[ModelIndex].AlphaMode == 1u ? 1u : 0u;
+        const uint32_t TransformNode = SceneModels[ModelIndex].TransformNode;
+        if (TransformNode < TransformNodeModels.size())
+        {
+            TransformNodeModels[TransformNode].push_back(static_cast<uint32_t>(ModelIndex));
+        }
+    }
+
+    std::vector<ID3D12Resource*> GeometryBuffers;
+    SceneGeometrySlots.resize(SceneModels.size());
+    for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+    {
+        ID3D12Resource* VertexBuffer = SceneModels[ModelIndex].Geometry.VertexBuffer.Get();
+        const auto Found = std::find(GeometryBuffers.begin(), GeometryBuffers.end(), VertexBuffer);
+        SceneGeometrySlots[ModelIndex] = static_cast<uint32_t>(Found - GeometryBuffers.begin());
+        if (Found == GeometryBuffers.end())
+        {
+            GeometryBuffers.push_back(VertexBuffer);
+        }
+    }
+}
+
+uint64_t FRenderer::BuildDrawSortKey(uint32_t ModelIndex, uint32_t Low) const
+{
+    const FSceneModelResource& Model = SceneModels[ModelIndex];
+    const uint32_t PipelineKey = ResolveMaterialPipelineKey(RendererUtils::BuildMaterialPipelineKey(Model));
+    // Each model has its own table, so its heap index names it; bindless draws bind no table.
+    const uint32_t MaterialSlot = ResolveMaterialTable(Model).ptr != 0 ? Model.MaterialDescriptorIndex : 0u;
+    const uint32_t GeometrySlot = ModelIndex < SceneGeometrySlots.size() ? SceneGeometrySlots[ModelIndex] : 0u;
+    return FDrawList::BuildSortKey(PipelineKey, MaterialSlot, GeometrySlot, Low);
+}
+
+void FRenderer::BuildSceneDrawList(const FCamera& Camera)
+{
+    using namespace DirectX;
+    CPU_PROFILE_SCOPE("Build Draw List");
+
+    const XMVECTOR EyePosition = XMLoadFloat3(&Camera.GetPosition());
+    const XMVECTOR Forward = XMVector3Normalize(XMLoadFloat3(&Camera.GetForward()));
+
+    SceneDrawList.Reset();
+    SceneDrawList.Reserve(SceneModels.size());
+    for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+    {
+        if (!SceneModelVisibility.empty() && !SceneModelVisibility[ModelIndex])
+        {
+            continue;
+        }
+
+        // Nearest point of the bounding sphere, so large models close to the eye go first.
+        const FSceneModelResource& Model = SceneModels[ModelIndex];
+        const float CenterDepth = XMVectorGetX(XMVector3Dot(XMVectorSubtract(XMLoadFloat3(&Model.Center), EyePosition), Forward));
+        const uint32_t Depth = FDrawList::EncodeDepth(CenterDepth - Model.Radius);
+        SceneDrawList.Add(BuildDrawSortKey(static_cast<uint32_t>(ModelIndex), Depth), static_cast<uint32_t>(ModelIndex));
+    }
+    SceneDrawList.Sort();
+}
+
+void FRenderer::UpdateTextureMipStreaming(const FCamera& Camera)
+{
+    using namespace DirectX;
+
+    if (!TextureMipStreamer)
+    {
+        return;
+    }
+
+    CPU_PROFILE_SCOPE("Texture Mip Streaming");
+    // Pixels covered by one unit of size at unit distance.
+    const float ProjectionScale = RenderViewport.Height / (2.0f * std::tan(Camera.GetFovY() * 0.5f));
+    const float NearClip = (std::max)(Camera.GetNearClip(), 1e-3f);
+    const XMVECTOR EyePosition = XMLoadFloat3(&Camera.GetPosition());
+
+    SceneModelScreenSizes.assign(SceneModels.size(), 0.0f);
+    for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+    {
+        if (!SceneModelVisibility.empty() && !SceneModelVisibility[ModelIndex])
+        {
+            continue;
+        }
+
+        // Measured from the nearest point of the bounding sphere, so close-up surfaces of large
+        // models get their finest mips.
+        const FSceneModelResource& Model = SceneModels[ModelIndex];
+        const float Distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&Model.Center), EyePosition))) - Model.Radius;
+        SceneModelScreenSizes[ModelIndex] = 2.0f * Model.Radius * ProjectionScale / (std::max)(Distance, NearClip);
+    }
+
+    TextureMipStreamer->Update(SceneModelScreenSizes);
+}
+
+void FRenderer::BuildSceneBvh()
+{
+    std::vector<FBvhBounds> ModelBounds(SceneModels.size());
+    for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+    {
+        ModelBounds[ModelIndex] = { SceneModels[ModelIndex].BoundsMin, SceneModels[ModelIndex].BoundsMax };
+    }
+    SceneBvh.Build(ModelBounds);
+    RendererUtils::BuildSceneBoundsSoA(SceneModels, SceneBoundsSoA);
+}
+
+void FRenderer::UpdateSceneTransforms(FDX12CommandContext& CmdContext)
+{
+    // Models that moved last frame still carry that motion in PrevWorld. They are uploaded once more
+    // with PrevWorld caught up, so their motion vectors drop to zero once they stop.
+    MovedModelIndices.swap(SettlingModelIndices);
+    MovedModelIndices.clear();
+    for (uint32_t ModelIndex : SettlingModelIndices)
+    {
+        FSceneModelResource& Model = SceneModels[ModelIndex];
+        Model.PrevWorldMatrix = Model.WorldMatrix;
+        MovedModelIndices.push_back(ModelIndex);
+    }
+
+    ChangedTransformNodes.clear();
+    SceneTransforms.UpdateWorldMatrices(ChangedTransformNodes);
+    const size_t SettlingCount = MovedModelIndices.size();
+    for (uint32_t TransformNode : ChangedTransformNodes)
+    {
+        if (TransformNode >= TransformNodeModels.size())
+        {
+            continue;
+        }
+
+        const DirectX::XMFLOAT4X4& WorldMatrix = SceneTransforms.GetWorldMatrix(TransformNode);
+        for (uint32_t ModelIndex : TransformNodeModels[TransformNode])
+        {
+            // Cached shadow cascades covering either the old or the new place are out of date.
+            FSceneModelResource& Model = SceneModels[ModelIndex];
+            ShadowCascades.InvalidateBounds(Model.BoundsMin, Model.BoundsMax);
+            Model.PrevWorldMatrix = Model.WorldMatrix;
+            RendererUtils::SetSceneModelWorldMatrix(Model, WorldMatrix);
+            ShadowCascades.InvalidateBounds(Model.BoundsMin, Model.BoundsMax);
+
+            if (ModelIndex < SceneBvh.GetObjectCount())
+            {
+                SceneBvh.RefitObject(ModelIndex, { Model.BoundsMin, Model.BoundsMax });
+            }
+            if (ModelIndex < SceneBoundsSoA.Count)
+            {
+                SceneBoundsSoA.MinX[ModelIndex] = Model.BoundsMin.x;
+                SceneBoundsSoA.MinY[ModelIndex] = Model.BoundsMin.y;
+                SceneBoundsSoA.MinZ[ModelIndex] = Model.BoundsMin.z;
+                SceneBoundsSoA.MaxX[ModelIndex] = Model.BoundsMax.x;
+                SceneBoundsSoA.MaxY[ModelIndex] = Model.BoundsMax.y;
+                SceneBoundsSoA.MaxZ[ModelIndex] = Model.BoundsMax.z;
+            }
+
+            MovedModelIndices.push_back(ModelIndex);
+        }
+    }
+
+    // Models that keep moving are in both lists; each is uploaded once and settles next frame.
+    SettlingModelIndices.assign(MovedModelIndices.begin() + SettlingCount, MovedModelIndices.end());
+    if (SettlingCount > 0 && SettlingCount < MovedModelIndices.size())
+    {
+        std::sort(MovedModelIndices.begin(), MovedModelIndices.end());
+        MovedModelIndices.erase(std::unique(MovedModelIndices.begin(), MovedModelIndices.end()), MovedModelIndices.end());
+    }
+
+    if (MovedModelIndices.empty() || !SceneObjectBuffer)
+    {
+        return;
+    }
+    // Culling data exists only with GPU-driven resources; objects are always uploaded.
+    const bool bUpdateCulling = ModelBoundsBuffer && ModelCullingCpuData.size() == SceneModels.size();
+
+    // Only the moved entries are uploaded; the default-heap buffers keep everything else.
+    FDX12UploadRing* UploadRing = CmdContext.GetUploadRing();
+    constexpr uint64_t ObjectUpdateBytes = sizeof(uint32_t) + sizeof(FSceneObjectData);
+    constexpr uint64_t CullingUpdateBytes = sizeof(uint32_t) + sizeof(FModelCullingData);
+    const uint64_t ObjectBytes = ObjectUpdateBytes * MovedModelIndices.size();
+    const uint64_t CullingBytes = bUpdateCulling ? CullingUpdateBytes * MovedModelIndices.size() : 0;
+    const FDX12UploadAllocation Upload = UploadRing ? UploadRing->Allocate(ObjectBytes + CullingBytes, 16) : FDX12UploadAllocation{};
+    if (!Upload.IsValid())
+    {
+        LogWarning("Failed to allocate upload space for moved scene models");
+        return;
+    }
+
+    uint8_t* ObjectData = Upload.CpuAddress;
+    uint8_t* CullingData = Upload.CpuAddress + ObjectBytes;
+    for (size_t MovedIndex = 0; MovedIndex < MovedModelIndices.size(); ++MovedIndex)
+    {
+        const uint32_t ModelIndex = MovedModelIndices[MovedIndex];
+        const FSceneModelResource& Model = SceneModels[ModelIndex];
+
+        const FSceneObjectData Object = RendererUtils::BuildSceneObjectData(Model, ModelIndex);
+        uint8_t* ObjectUpdate = ObjectData + ObjectUpdateBytes * MovedIndex;
+        std::memcpy(ObjectUpdate, &ModelIndex, sizeof(ModelIndex));
+        std::memcpy(ObjectUpdate + sizeof(ModelIndex), &Object, sizeof(Object));
+
+        if (bUpdateCulling)
+        {
+            FModelCullingData& Culling = ModelCullingCpuData[ModelIndex];
+            Culling.BoundsMin = Model.BoundsMin;
+            Culling.BoundsMax = Model.BoundsMax;
+            uint8_t* CullingUpdate = CullingData + CullingUpdateBytes * MovedIndex;
+            std::memcpy(CullingUpdate, &ModelIndex, sizeof(ModelIndex));
+            std::memcpy(CullingUpdate + sizeof(ModelIndex), &Culling, sizeof(Culling));
+        }
+    }
+
+    ScatterSceneEntries(CmdContext, SceneObjectBuffer.Get(), SceneDataBufferState, SceneDataBufferState,
+        Upload, MovedModelIndices, sizeof(FSceneObjectData));
+    if (bUpdateCulling)
+    {
+        FDX12UploadAllocation CullingUpload = Upload;
+        CullingUpload.Offset += ObjectBytes;
+        CullingUpload.Size = CullingBytes;
+        CullingUpload.CpuAddress += ObjectBytes;
+        CullingUpload.GpuAddress += ObjectBytes;
+        ScatterSceneEntries(CmdContext, ModelBoundsBuffer.Get(), ModelBoundsState, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE,
+            CullingUpload, MovedModelIndices, sizeof(FModelCullingData));
+        ModelBoundsState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+    }
+}
+
+void FRenderer::RaycastSceneModels(const DirectX::XMFLOAT3& Origin, const DirectX::XMFLOAT3& Direction, std::vector<FBvhRayHit>& OutHits) const
+{
+    constexpr float MaxDistance = 3.402823466e+38f;
+    SceneBvh.QueryRay(Origin, Direction, MaxDistance, OutHits);
+}
 
 bool FRenderer::GetSceneModelStats(size_t& OutTotal, size_t& OutCulled) const
 {
     return RendererUtils::ComputeSceneModelStats(SceneModels, SceneModelVisibility, OutTotal, OutCulled);
 }
 
+bool FRenderer::GetSceneTriangleStats(const FCamera& Camera, uint64_t& OutFullDetail, uint64_t& OutDrawn) const
+{
+    OutFullDetail = 0;
+    OutDrawn = 0;
+    if (SceneModels.empty())
+    {
+        return false;
+    }
+
+    const DirectX::XMFLOAT3 CameraPosition = Camera.GetPosition();
+    const float LodErrorScale = RendererUtils::ComputeLodErrorScale(Camera, RenderViewport.Height, LodBias);
+    for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+    {
+        if (!SceneModelVisibility.empty() && !SceneModelVisibility[ModelIndex])
+        {
+            continue;
+        }
+
+        const FSceneModelResource& Model = SceneModels[ModelIndex];
+        OutFullDetail += Model.DrawIndexCount / 3;
+        OutDrawn += bEnableIndirectDraw && IndirectCommandCount > 0
+            ? Model.Lods[RendererUtils::SelectModelLod(Model, CameraPosition, LodErrorScale)].IndexCount / 3
+            : Model.DrawIndexCount / 3;
+    }
+    return true;
+}
+
+bool FRenderer::GetGpuCullingStats(FGpuCullingStats& OutStats) const
+{
+    if (!bHasGpuCullingStats || !IsGpuCullingStatsEnabled())
+    {
+        return false;
+    }
+
+    OutStats = GpuCullingStats;
+    return true;
+}
+
 void FRenderer::RequestObjectIdReadback(uint32_t X, uint32_t Y)
 {
     RendererUtils::RequestObjectIdReadback(
@@ -44,15 +361,31 @@ bool FRenderer::ConsumeObjectIdReadback(uint32_t& OutObjectId)
 void FRenderer::InitializeCommonSettings(uint32_t Width, uint32_t Height, const FRendererOptions& Options)
 {
     bDepthPrepassEnabled = Options.bUseDepthPrepass;
+    MaskedDepthPrepassThreshold = Options.MaskedDepthPrepassThreshold;
     bShadowsEnabled = Options.bEnableShadows;
     ShadowBias = Options.ShadowBias;
     bLogResourceBarriers = Options.bLogResourceBarriers;
     bEnableGraphDump = Options.bEnableGraphDump;
     bEnableGpuTiming = Options.bEnableGpuTiming;
+    bEnablePipelineStatistics = Options.bEnablePipelineStatistics;
+    bEnableParallelRecording = Options.bEnableParallelRecording;
     bEnableIndirectDraw = Options.bEnableIndirectDraw;
     bEnableGpuDebugPrint = Options.bEnableGpuDebugPrint;
+    bBindlessMaterials = Options.bEnableBindless && Device && Device->SupportsBindlessResources();
+    bStreamSceneTextures = Options.bStreamSceneTextures;
+    bStreamTextureMips = Options.bStreamTextureMips;
+    TextureStreamingBudgetMB = Options.TextureStreamingBudgetMB;
+    FTextureLoader::SetCacheBudget(static_cast<uint64_t>(Options.TextureCacheBudgetMB) << 20);
+    LodBias = Options.LodBias;
+    MinScreenCoverage = (std::max)(0.0f, Options.MinScreenCoverage);
+    ShadowMinScreenCoverage = (std::max)(0.0f, Options.ShadowMinScreenCoverage);
+    VariableRateShading.SetQuality(Options.ShadingRateQuality);
+    VariableRateShading.SetOverlayEnabled(Options.bShowShadingRate);
     FramesInFlight = (std::max)(1u, Options.FramesInFlight);
     CurrentFrameIndex = 0;
+    InheritedResources = Options.PersistentResources;
+    PendingStateHandoffs.clear();
+    PersistentTargets.clear();
 
     Viewport.TopLeftX = 0.0f;
     Viewport.TopLeftY = 0.0f;
@@ -65,6 +398,8 @@ void FRenderer::InitializeCommonSettings(uint32_t Width, uint32_t Height, const
     ScissorRect.top = 0;
     ScissorRect.right = static_cast<LONG>(Width);
     ScissorRect.bottom = static_cast<LONG>(Height);
+    RenderViewport = Viewport;
+    RenderScissorRect = ScissorRect;
 
     constexpr uint32_t DefaultShadowMapSize = 2048;
     ShadowMapWidth = DefaultShadowMapSize;
@@ -83,6 +418,22 @@ void FRenderer::InitializeCommonSettings(uint32_t Width, uint32_t Height, const
     ShadowScissor.bottom = static_cast<LONG>(ShadowMapHeight);
 }
 
+void FRenderer::UpdateRenderViewport(float Scale)
+{
+    const float ClampedScale = std::clamp(Scale, 0.25f, 1.0f);
+    const uint32_t Width = (std::max)(1u, static_cast<uint32_t>(Viewport.Width * ClampedScale + 0.5f));
+    const uint32_t Height = (std::max)(1u, static_cast<uint32_t>(Viewport.Height * ClampedScale + 0.5f));
+
+    RenderViewport = Viewport;
+    RenderViewport.Width = static_cast<float>(Width);
+    RenderViewport.Height = static_cast<float>(Height);
+
+    RenderScissorRect.left = 0;
+    RenderScissorRect.top = 0;
+    RenderScissorRect.right = static_cast<LONG>(Width);
+    RenderScissorRect.bottom = static_cast<LONG>(Height);
+}
+
 void FRenderer::SetFrameIndex(uint32_t FrameIndex)
 {
     if (DepthResourcesPerFrame.empty())
@@ -95,6 +446,45 @@ void FRenderer::SetFrameIndex(uint32_t FrameIndex)
     DepthStencilHandle = DepthResourcesPerFrame[CurrentFrameIndex].DepthStencilHandle;
 }
 
+void FRenderer::RenderViews(FDX12CommandContext& CmdContext, const std::vector<FRenderView>& Views, float DeltaTime)
+{
+    CPU_PROFILE_SCOPE("RenderViews");
+
+    MultiViewCameras.clear();
+    for (const FRenderView& View : Views)
+    {
+        if (View.Camera && View.Target)
+        {
+            MultiViewCameras.push_back(View.Camera);
+        }
+    }
+    if (MultiViewCameras.size() > FShadowCascades::MaxSharedViews)
+    {
+        LogWarning("RenderViews: ", MultiViewCameras.size(), " views, the shadow map only covers the first ", FShadowCascades::MaxSharedViews);
+    }
+
+    ID3D12Resource* const FrameOutputTarget = OutputTarget;
+    MultiViewIndex = 0;
+    for (const FRenderView& View : Views)
+    {
+        if (!View.Camera || !View.Target)
+        {
+            continue;
+        }
+
+        SetOutputTarget(View.Target);
+        CmdContext.SetRenderTarget(View.RtvHandle, &GetDSVHandle());
+        // Later views render the same instant, so adaptation and animation do not advance again.
+        RenderFrame(CmdContext, View.RtvHandle, *View.Camera, MultiViewIndex == 0 ? DeltaTime : 0.0f);
+        ++MultiViewIndex;
+    }
+
+    bMultiViewHistoryStale = IsRenderingMultipleViews();
+    MultiViewIndex = 0;
+    MultiViewCameras.clear();
+    SetOutputTarget(FrameOutputTarget);
+}
+
 const D3D12_CPU_DESCRIPTOR_HANDLE& FRenderer::GetDSVHandle() const
 {
     return DepthStencilHandle;
@@ -142,30 +532,46 @@ D3D12_RESOURCE_STATES& FRenderer::GetIndirectCommandState()
     return IndirectCommandStates[CurrentFrameIndex];
 }
 
-ID3D12Resource* FRenderer::GetSceneConstantBuffer() const
+ID3D12Resource* FRenderer::GetVisibleInstanceBuffer() const
 {
-    if (SceneConstantBuffers.empty())
+    if (VisibleInstanceBuffers.empty())
     {
         return nullptr;
     }
 
-    return SceneConstantBuffers[CurrentFrameIndex].Get();
+    return VisibleInstanceBuffers[CurrentFrameIndex].Get();
 }
 
-D3D12_GPU_VIRTUAL_ADDRESS FRenderer::GetSceneConstantBufferAddress() const
+D3D12_RESOURCE_STATES& FRenderer::GetVisibleInstanceState()
 {
-    ID3D12Resource* Buffer = GetSceneConstantBuffer();
-    return Buffer ? Buffer->GetGPUVirtualAddress() : 0;
+    if (VisibleInstanceStates.empty())
+    {
+        static D3D12_RESOURCE_STATES FallbackState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+        return FallbackState;
+    }
+
+    return VisibleInstanceStates[CurrentFrameIndex];
 }
 
-uint8_t* FRenderer::GetSceneConstantBufferMapped() const
+ID3D12Resource* FRenderer::GetCompactedCommandBuffer() const
 {
-    if (SceneConstantBufferMapped.empty())
+    if (CompactedCommandBuffers.empty())
     {
         return nullptr;
     }
 
-    return SceneConstantBufferMapped[CurrentFrameIndex];
+    return CompactedCommandBuffers[CurrentFrameIndex].Get();
+}
+
+D3D12_RESOURCE_STATES& FRenderer::GetCompactedCommandState()
+{
+    if (CompactedCommandStates.empty())
+    {
+        static D3D12_RESOURCE_STATES FallbackState = D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT;
+        return FallbackState;
+    }
+
+    return CompactedCommandStates[CurrentFrameIndex];
 }
 
 bool FRenderer::CreateDepthResourcesPerFrame(FDX12Device* Device, uint32_t Width, uint32_t Height, DXGI_FORMAT Format)
@@ -204,279 +610,1581 @@ bool FRenderer::CreateDepthResourcesPerFrame(FDX12Device* Device, uint32_t Width
     return true;
 }
 
-bool FRenderer::CreateSceneConstantBuffersPerFrame(FDX12Device* Device, uint64_t BufferSize)
+bool FRenderer::CreateSceneDataBuffers(FDX12Device* Device)
+{
+    if (!Device || SceneModels.empty())
+    {
+        return false;
+    }
+
+    // Textures are loaded per model, so every model owns its material and MaterialIndex is the model index.
+    std::vector<FSceneObjectData> Objects(SceneModels.size());
+    std::vector<FSceneMaterialData> Materials(SceneModels.size());
+    for (size_t ModelIndex = 0; ModelIndex < SceneModels.size(); ++ModelIndex)
+    {
+        Objects[ModelIndex] = RendererUtils::BuildSceneObjectData(SceneModels[ModelIndex], static_cast<uint32_t>(ModelIndex));
+        Materials[ModelIndex] = RendererUtils::BuildSceneMaterialData(SceneModels[ModelIndex]);
+    }
+
+    const uint64_t ObjectBufferSize = sizeof(FSceneObjectData) * Objects.size();
+    const uint64_t MaterialBufferSize = sizeof(FSceneMaterialData) * Materials.size();
+
+    D3D12_HEAP_PROPERTIES UploadHeap = {};
+    UploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
+    UploadHeap.CreationNodeMask = 1;
+    UploadHeap.VisibleNodeMask = 1;
+
+    D3D12_HEAP_PROPERTIES DefaultHeap = UploadHeap;
+    DefaultHeap.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+    D3D12_RESOURCE_DESC BufferDesc = {};
+    BufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    BufferDesc.Width = ObjectBufferSize;
+    BufferDesc.Height = 1;
+    BufferDesc.DepthOrArraySize = 1;
+    BufferDesc.MipLevels = 1;
+    BufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+    BufferDesc.SampleDesc.Count = 1;
+    BufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    // Changed entries are written by Shaders/SceneScatter.hlsl.
+    BufferDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+    D3D12_RESOURCE_DESC MaterialDesc = BufferDesc;
+    MaterialDesc.Width = MaterialBufferSize;
+
+    D3D12_RESOURCE_DESC UploadDesc = BufferDesc;
+    UploadDesc.Width = ObjectBufferSize + MaterialBufferSize;
+    UploadDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Buffer,
+        &DefaultHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &BufferDesc,
+        D3D12_RESOURCE_STATE_COMMON,
+        nullptr,
+        IID_PPV_ARGS(SceneObjectBuffer.ReleaseAndGetAddressOf())));
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Buffer,
+        &DefaultHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &MaterialDesc,
+        D3D12_RESOURCE_STATE_COMMON,
+        nullptr,
+        IID_PPV_ARGS(SceneMaterialBuffer.ReleaseAndGetAddressOf())));
+
+    Microsoft::WRL::ComPtr<ID3D12Resource> UploadBuffer;
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Upload,
+        &UploadHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &UploadDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(UploadBuffer.GetAddressOf())));
+
+    if (!SceneObjectBuffer || !SceneMaterialBuffer || !UploadBuffer)
+    {
+        LogError("Failed to create scene object and material buffers");
+        return false;
+    }
+    SceneObjectBuffer->SetName(L"SceneObjectBuffer");
+    SceneMaterialBuffer->SetName(L"SceneMaterialBuffer");
+
+    const D3D12_RANGE EmptyRange = { 0, 0 };
+    uint8_t* UploadData = nullptr;
+    HR_CHECK(UploadBuffer->Map(0, &EmptyRange, reinterpret_cast<void**>(&UploadData)));
+    std::memcpy(UploadData, Objects.data(), ObjectBufferSize);
+    std::memcpy(UploadData + ObjectBufferSize, Materials.data(), MaterialBufferSize);
+    UploadBuffer->Unmap(0, nullptr);
+
+    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> UploadAllocator;
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> UploadList;
+    HR_CHECK(Device->GetDevice()->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(UploadAllocator.GetAddressOf())));
+    HR_CHECK(Device->GetDevice()->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, UploadAllocator.Get(), nullptr, IID_PPV_ARGS(UploadList.GetAddressOf())));
+
+    D3D12_RESOURCE_BARRIER Barriers[2] = {};
+    Barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    Barriers[0].Transition.pResource = SceneObjectBuffer.Get();
+    Barriers[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    Barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_COMMON;
+    Barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+    Barriers[1] = Barriers[0];
+    Barriers[1].Transition.pResource = SceneMaterialBuffer.Get();
+    UploadList->ResourceBarrier(2, Barriers);
+
+    UploadList->CopyBufferRegion(SceneObjectBuffer.Get(), 0, UploadBuffer.Get(), 0, ObjectBufferSize);
+    UploadList->CopyBufferRegion(SceneMaterialBuffer.Get(), 0, UploadBuffer.Get(), ObjectBufferSize, MaterialBufferSize);
+
+    for (D3D12_RESOURCE_BARRIER& Barrier : Barriers)
+    {
+        Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        Barrier.Transition.StateAfter = SceneDataBufferState;
+    }
+    UploadList->ResourceBarrier(2, Barriers);
+
+    HR_CHECK(UploadList->Close());
+    ID3D12CommandList* Lists[] = { UploadList.Get() };
+    Device->GetGraphicsQueue()->ExecuteCommandLists(1, Lists);
+    Device->GetGraphicsQueue()->Flush();
+
+    return true;
+}
+
+bool FRenderer::CreateSceneScatterPipeline(FDX12Device* Device)
 {
     if (!Device)
     {
         return false;
     }
 
-    SceneConstantBuffers.clear();
-    SceneConstantBufferMapped.clear();
-    SceneConstantBuffers.resize(FramesInFlight);
-    SceneConstantBufferMapped.resize(FramesInFlight, nullptr);
-
-    for (uint32_t Index = 0; Index < FramesInFlight; ++Index)
+    D3D12_ROOT_PARAMETER Params[3] = {};
+    // Params[0]: UpdateCount and EntryDwordCount (b0)
+    Params[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    Params[0].Constants.ShaderRegister = 0;
+    Params[0].Constants.RegisterSpace = 0;
+    Params[0].Constants.Num32BitValues = 2;
+    Params[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    // Params[1]: Updates in the upload ring (t0)
+    Params[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    Params[1].Descriptor.ShaderRegister = 0;
+    Params[1].Descriptor.RegisterSpace = 0;
+    Params[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    // Params[2]: Destination scene buffer (u0)
+    Params[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+    Params[2].Descriptor.ShaderRegister = 0;
+    Params[2].Descriptor.RegisterSpace = 0;
+    Params[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    D3D12_ROOT_SIGNATURE_DESC RootDesc = {};
+    RootDesc.NumParameters = _countof(Params);
+    RootDesc.pParameters = Params;
+    RootDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
+
+    ComPtr<ID3DBlob> SerializedSig;
+    ComPtr<ID3DBlob> ErrorBlob;
+    HR_CHECK(D3D12SerializeRootSignature(&RootDesc, D3D_ROOT_SIGNATURE_VERSION_1, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf()));
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), SceneScatterRootSignature.ReleaseAndGetAddressOf()));
+
+    FShaderCompiler Compiler;
+    std::vector<uint8_t> CsByteCode;
+
+    const D3D_SHADER_MODEL ShaderModel = Device->GetShaderModel();
+    const std::wstring CSTarget = RendererUtils::BuildShaderTarget(L"cs", ShaderModel);
+
+    if (!Compiler.CompileFromFile(L"Shaders/SceneScatter.hlsl", L"CSMain", CSTarget, CsByteCode))
+    {
+        return false;
+    }
+
+    D3D12_COMPUTE_PIPELINE_STATE_DESC CsDesc = {};
+    CsDesc.pRootSignature = SceneScatterRootSignature.Get();
+    CsDesc.CS = { CsByteCode.data(), CsByteCode.size() };
+    HR_CHECK(Device->GetPipelineCache()->CreateComputePipelineState(CsDesc, SceneScatterPipeline.ReleaseAndGetAddressOf()));
+    return true;
+}
+
+void FRenderer::ScatterSceneEntries(FDX12CommandContext& CmdContext, ID3D12Resource* Destination, D3D12_RESOURCE_STATES StateBefore,
+    D3D12_RESOURCE_STATES StateAfter, const FDX12UploadAllocation& Updates, const std::vector<uint32_t>& EntryIndices, uint32_t EntryBytes)
+{
+    if (!Destination || !Updates.IsValid() || EntryIndices.empty())
+    {
+        return;
+    }
+
+    ID3D12GraphicsCommandList* CommandList = CmdContext.GetCommandList();
+    FScopedPixEvent ScatterEvent(CommandList, L"SceneScatter");
+
+    const bool bUseCompute = SceneScatterPipeline && SceneScatterRootSignature;
+    const D3D12_RESOURCE_STATES WriteState = bUseCompute ? D3D12_RESOURCE_STATE_UNORDERED_ACCESS : D3D12_RESOURCE_STATE_COPY_DEST;
+
+    D3D12_RESOURCE_BARRIER Barrier = {};
+    Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    Barrier.Transition.pResource = Destination;
+    Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    Barrier.Transition.StateBefore = StateBefore;
+    Barrier.Transition.StateAfter = WriteState;
+    if (StateBefore != WriteState)
+    {
+        CommandList->ResourceBarrier(1, &Barrier);
+    }
+
+    const uint32_t UpdateBytes = static_cast<uint32_t>(sizeof(uint32_t)) + EntryBytes;
+    if (bUseCompute)
+    {
+        const uint32_t UpdateCount = static_cast<uint32_t>(EntryIndices.size());
+        const uint32_t Constants[2] = { UpdateCount, EntryBytes / static_cast<uint32_t>(sizeof(uint32_t)) };
+        CommandList->SetPipelineState(SceneScatterPipeline.Get());
+        CommandList->SetComputeRootSignature(SceneScatterRootSignature.Get());
+        CommandList->SetComputeRoot32BitConstants(0, _countof(Constants), Constants, 0);
+        CommandList->SetComputeRootShaderResourceView(1, Updates.GpuAddress);
+        CommandList->SetComputeRootUnorderedAccessView(2, Destination->GetGPUVirtualAddress());
+        CommandList->Dispatch((UpdateCount * Constants[1] + 63) / 64, 1, 1);
+    }
+    else
+    {
+        for (size_t UpdateIndex = 0; UpdateIndex < EntryIndices.size(); ++UpdateIndex)
+        {
+            CommandList->CopyBufferRegion(
+                Destination,
+                static_cast<uint64_t>(EntryBytes) * EntryIndices[UpdateIndex],
+                Updates.Resource,
+                Updates.Offset + static_cast<uint64_t>(UpdateBytes) * UpdateIndex + sizeof(uint32_t),
+                EntryBytes);
+        }
+    }
+
+    Barrier.Transition.StateBefore = WriteState;
+    Barrier.Transition.StateAfter = StateAfter;
+    if (WriteState != StateAfter)
+    {
+        CommandList->ResourceBarrier(1, &Barrier);
+    }
+}
+
+bool FRenderer::UploadViewConstants(FDX12CommandContext& CmdContext, const FCamera& Camera, const DirectX::XMMATRIX& Projection)
+{
+    ShadowCascadeConstantsAddresses.fill(0);
+
+    FDX12UploadRing* UploadRing = CmdContext.GetUploadRing();
+    const FDX12UploadAllocation Upload = UploadRing
+        ? UploadRing->Allocate(sizeof(FSceneViewConstants), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT)
+        : FDX12UploadAllocation{};
+    if (!Upload.IsValid())
+    {
+        LogWarning("Failed to allocate upload space for view constants");
+        ViewConstantsAddress = 0;
+        return false;
+    }
+
+    // Built on the stack, since the cascade copies would otherwise read back write-combined memory.
+    FSceneViewConstants Constants;
+    RendererUtils::UpdateSceneViewConstants(
+        Camera,
+        LightIntensity,
+        DirectX::XMLoadFloat3(&LightDirection),
+        LightColor,
+        ShadowCascades.GetViewProjection(0),
+        Projection,
+        bShadowsEnabled ? ShadowStrength : 0.0f,
+        ShadowBias,
+        static_cast<float>(ShadowMapWidth),
+        static_cast<float>(ShadowMapHeight),
+        EnvironmentMipCount,
+        reinterpret_cast<uint8_t*>(&Constants));
+    for (uint32_t CascadeIndex = 0; CascadeIndex < FShadowCascades::CascadeCount; ++CascadeIndex)
+    {
+        DirectX::XMStoreFloat4x4(&Constants.ShadowCascadeViewProjection[CascadeIndex], ShadowCascades.GetViewProjection(CascadeIndex));
+    }
+    Constants.ShadowCascadeSplits = ShadowCascades.GetSplitDepths();
+
+    // The first frame has no previous one, so it reports no motion.
+    const DirectX::XMFLOAT4X4 LastViewProjection = CurrentViewProjection;
+    DirectX::XMStoreFloat4x4(&CurrentViewProjection, DirectX::XMMatrixMultiply(Camera.GetViewMatrix(), Camera.GetProjectionMatrix()));
+    PrevViewProjection = bHasViewProjection ? LastViewProjection : CurrentViewProjection;
+    bHasViewProjection = true;
+    Constants.UnjitteredViewProjection = CurrentViewProjection;
+    Constants.PrevUnjitteredViewProjection = PrevViewProjection;
+    std::copy(EnvironmentLighting.GetIrradianceSH().begin(), EnvironmentLighting.GetIrradianceSH().end(), Constants.IrradianceSH);
+    std::memcpy(Upload.CpuAddress, &Constants, sizeof(Constants));
+    ViewConstantsAddress = Upload.GpuAddress;
+
+    for (uint32_t CascadeIndex = 0; CascadeIndex < FShadowCascades::CascadeCount; ++CascadeIndex)
+    {
+        if ((ShadowCascades.GetRenderMask() & (1u << CascadeIndex)) == 0)
+        {
+            continue;
+        }
+
+        const FDX12UploadAllocation CascadeUpload = UploadRing->Allocate(sizeof(FSceneViewConstants), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+        if (!CascadeUpload.IsValid())
+        {
+            LogWarning("Failed to allocate upload space for shadow cascade constants");
+            return false;
+        }
+
+        Constants.LightViewProjection = Constants.ShadowCascadeViewProjection[CascadeIndex];
+        std::memcpy(CascadeUpload.CpuAddress, &Constants, sizeof(Constants));
+        ShadowCascadeConstantsAddresses[CascadeIndex] = CascadeUpload.GpuAddress;
+    }
+    return true;
+}
+
+uint32_t FRenderer::UpdateShadowCascades(const FCamera& Camera, bool bRenderShadows)
+{
+    if (!bRenderShadows)
+    {
+        ShadowCascades.Invalidate();
+        return 0;
+    }
+    if (IsSecondaryView())
+    {
+        // The first view fitted the cascades around every view and rendered them.
+        return 0;
+    }
+    if (IsRenderingMultipleViews())
+    {
+        return ShadowCascades.Update(
+            MultiViewCameras.data(),
+            static_cast<uint32_t>(MultiViewCameras.size()),
+            LightDirection,
+            SceneCenter,
+            SceneRadius,
+            ShadowMapWidth);
+    }
+    return ShadowCascades.Update(Camera, LightDirection, SceneCenter, SceneRadius, ShadowMapWidth);
+}
+
+bool FRenderer::CreateShadowPipeline(FDX12Device* Device, ID3D12RootSignature* RootSignature, Microsoft::WRL::ComPtr<ID3D12PipelineState>& OutPipelineState)
+{
+    if (!Device || !RootSignature)
+    {
+        return false;
+    }
+
+    FShaderCompiler Compiler;
+    std::vector<uint8_t> VSByteCode;
+
+    const D3D_SHADER_MODEL ShaderModel = Device->GetShaderModel();
+    const std::wstring VSTarget = RendererUtils::BuildShaderTarget(L"vs", ShaderModel);
+
+    if (!Compiler.CompileFromFile(L"Shaders/ShadowMap.hlsl", L"VSMain", VSTarget, VSByteCode))
+    {
+        return false;
+    }
+
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC PsoDesc = {};
+    PsoDesc.pRootSignature = RootSignature;
+    PsoDesc.InputLayout = RendererUtils::GetMeshPositionInputLayout();
+    PsoDesc.VS = { VSByteCode.data(), VSByteCode.size() };
+    PsoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    PsoDesc.SampleDesc.Count = 1;
+    PsoDesc.SampleMask = UINT_MAX;
+
+    PsoDesc.RasterizerState = {};
+    PsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+    PsoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_FRONT;
+    PsoDesc.RasterizerState.FrontCounterClockwise = TRUE;
+    PsoDesc.RasterizerState.DepthBias = D3D12_DEFAULT_DEPTH_BIAS;
+    PsoDesc.RasterizerState.DepthBiasClamp = D3D12_DEFAULT_DEPTH_BIAS_CLAMP;
+    PsoDesc.RasterizerState.SlopeScaledDepthBias = D3D12_DEFAULT_SLOPE_SCALED_DEPTH_BIAS;
+    PsoDesc.RasterizerState.DepthClipEnable = TRUE;
+    PsoDesc.RasterizerState.MultisampleEnable = FALSE;
+    PsoDesc.RasterizerState.AntialiasedLineEnable = FALSE;
+    PsoDesc.RasterizerState.ForcedSampleCount = 0;
+    PsoDesc.RasterizerState.ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
+
+    PsoDesc.BlendState = {};
+    PsoDesc.BlendState.AlphaToCoverageEnable = FALSE;
+    PsoDesc.BlendState.IndependentBlendEnable = FALSE;
+    PsoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = 0;
+
+    PsoDesc.DepthStencilState = {};
+    PsoDesc.DepthStencilState.DepthEnable = TRUE;
+    PsoDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+    PsoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
+    PsoDesc.DepthStencilState.StencilEnable = FALSE;
+    PsoDesc.NumRenderTargets = 0;
+    PsoDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+    PsoDesc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
+
+    HR_CHECK(Device->GetPipelineCache()->CreateGraphicsPipelineState(PsoDesc, OutPipelineState.ReleaseAndGetAddressOf()));
+    return true;
+}
+
+bool FRenderer::CreateShadowResources(
+    FDX12Device* Device,
+    uint32_t& InOutWidth,
+    uint32_t& InOutHeight,
+    Microsoft::WRL::ComPtr<ID3D12Resource>& OutShadowMap,
+    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap>& OutShadowDsvHeap,
+    std::array<D3D12_CPU_DESCRIPTOR_HANDLE, FShadowCascades::CascadeCount>& OutShadowDsvHandles,
+    D3D12_RESOURCE_STATES& OutShadowState)
+{
+    if (!Device)
+    {
+        return false;
+    }
+
+    if (InOutWidth == 0 || InOutHeight == 0)
+    {
+        InOutWidth = 4096;
+        InOutHeight = 4096;
+    }
+
+    D3D12_RESOURCE_DESC Desc = {};
+    Desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    Desc.Alignment = 0;
+    Desc.Width = InOutWidth;
+    Desc.Height = InOutHeight;
+    Desc.DepthOrArraySize = static_cast<UINT16>(FShadowCascades::CascadeCount);
+    Desc.MipLevels = 1;
+    Desc.Format = DXGI_FORMAT_R32_TYPELESS;
+    Desc.SampleDesc.Count = 1;
+    Desc.SampleDesc.Quality = 0;
+    Desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+    Desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+
+    D3D12_CLEAR_VALUE ClearValue = {};
+    ClearValue.Format = DXGI_FORMAT_D32_FLOAT;
+    ClearValue.DepthStencil.Depth = 1.0f;
+    ClearValue.DepthStencil.Stencil = 0;
+
+    D3D12_HEAP_PROPERTIES HeapProps = {};
+    HeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
+    HeapProps.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+    HeapProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+    HeapProps.CreationNodeMask = 1;
+    HeapProps.VisibleNodeMask = 1;
+
+    if (!AdoptPersistentTarget("ShadowMap", Desc, OutShadowMap, OutShadowState))
+    {
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::RenderTarget,
+            &HeapProps,
+            D3D12_HEAP_FLAG_NONE,
+            &Desc,
+            D3D12_RESOURCE_STATE_DEPTH_WRITE,
+            &ClearValue,
+            IID_PPV_ARGS(OutShadowMap.ReleaseAndGetAddressOf())));
+
+        if (OutShadowMap)
+        {
+            OutShadowMap->SetName(L"ShadowMap");
+        }
+        OutShadowState = D3D12_RESOURCE_STATE_DEPTH_WRITE;
+    }
+    RegisterPersistentTarget("ShadowMap", OutShadowMap.Get(), OutShadowState);
+
+    D3D12_DESCRIPTOR_HEAP_DESC HeapDesc = {};
+    HeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
+    HeapDesc.NumDescriptors = FShadowCascades::CascadeCount;
+    HeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+    HR_CHECK(Device->GetDevice()->CreateDescriptorHeap(&HeapDesc, IID_PPV_ARGS(OutShadowDsvHeap.ReleaseAndGetAddressOf())));
+
+    if (OutShadowDsvHeap)
+    {
+        OutShadowDsvHeap->SetName(L"ShadowDSVHeap");
+    }
+
+    const UINT DsvDescriptorSize = Device->GetDevice()->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
+    D3D12_CPU_DESCRIPTOR_HANDLE DsvHandle = OutShadowDsvHeap->GetCPUDescriptorHandleForHeapStart();
+    for (uint32_t CascadeIndex = 0; CascadeIndex < FShadowCascades::CascadeCount; ++CascadeIndex)
+    {
+        D3D12_DEPTH_STENCIL_VIEW_DESC DsvDesc = {};
+        DsvDesc.Format = DXGI_FORMAT_D32_FLOAT;
+        DsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2DARRAY;
+        DsvDesc.Flags = D3D12_DSV_FLAG_NONE;
+        DsvDesc.Texture2DArray.MipSlice = 0;
+        DsvDesc.Texture2DArray.FirstArraySlice = CascadeIndex;
+        DsvDesc.Texture2DArray.ArraySize = 1;
+        Device->GetDevice()->CreateDepthStencilView(OutShadowMap.Get(), &DsvDesc, DsvHandle);
+        OutShadowDsvHandles[CascadeIndex] = DsvHandle;
+        DsvHandle.ptr += DsvDescriptorSize;
+    }
+
+    ShadowCascades.Invalidate();
+    return true;
+}
+
+void FRenderer::ConfigureHZBOcclusion(bool bEnabled, ID3D12DescriptorHeap* DescriptorHeap, D3D12_GPU_DESCRIPTOR_HANDLE Handle, uint32_t Width, uint32_t Height, uint32_t MipCount)
+{
+    bHZBOcclusionEnabled = bEnabled;
+    CullingDescriptorHeap = DescriptorHeap;
+    HZBCullingHandle = Handle;
+    HZBCullingWidth = Width;
+    HZBCullingHeight = Height;
+    HZBCullingMipCount = MipCount;
+}
+
+FRenderer::FGpuDrivenBuffers FRenderer::ImportGpuDrivenBuffers(FRenderGraph& Graph)
+{
+    FGpuDrivenBuffers Buffers;
+
+    if (ID3D12Resource* IndirectBuffer = GetIndirectCommandBuffer())
+    {
+        Buffers.IndirectCommands = Graph.ImportBuffer("IndirectCommands", IndirectBuffer, &GetIndirectCommandState(), { IndirectBuffer->GetDesc().Width });
+    }
+
+    if (ID3D12Resource* VisibleInstanceBuffer = GetVisibleInstanceBuffer())
+    {
+        Buffers.VisibleInstances = Graph.ImportBuffer("VisibleInstances", VisibleInstanceBuffer, &GetVisibleInstanceState(), { VisibleInstanceBuffer->GetDesc().Width });
+    }
+
+    if (ModelBoundsBuffer)
+    {
+        Buffers.ModelBounds = Graph.ImportBuffer("ModelBounds", ModelBoundsBuffer.Get(), &ModelBoundsState, { ModelBoundsBuffer->GetDesc().Width });
+    }
+
+    if (GpuDebugPrintBuffer)
+    {
+        Buffers.DebugPrint = Graph.ImportBuffer("GpuDebugPrint", GpuDebugPrintBuffer.Get(), &GpuDebugPrintState, { GpuDebugPrintBuffer->GetDesc().Width });
+    }
+
+    if (GpuDebugPrintStatsBuffer)
+    {
+        Buffers.DebugPrintStats = Graph.ImportBuffer("GpuDebugPrintStats", GpuDebugPrintStatsBuffer.Get(), &GpuDebugPrintStatsState, { GpuDebugPrintStatsBuffer->GetDesc().Width });
+    }
+
+    if (InstanceVisibilityBuffer)
+    {
+        Buffers.InstanceVisibility = Graph.ImportBuffer("InstanceVisibility", InstanceVisibilityBuffer.Get(), &InstanceVisibilityState, { InstanceVisibilityBuffer->GetDesc().Width });
+    }
+
+    if (ID3D12Resource* CompactedBuffer = GetCompactedCommandBuffer())
+    {
+        Buffers.CompactedCommands = Graph.ImportBuffer("CompactedCommands", CompactedBuffer, &GetCompactedCommandState(), { CompactedBuffer->GetDesc().Width });
+    }
+
+    if (!ShadowCullingBuffers.empty())
+    {
+        FShadowCullingBuffers& Shadow = ShadowCullingBuffers[CurrentFrameIndex];
+        Buffers.ShadowIndirectCommands = Graph.ImportBuffer("ShadowIndirectCommands", Shadow.IndirectCommands.Get(), &Shadow.IndirectCommandState, { Shadow.IndirectCommands->GetDesc().Width });
+        Buffers.ShadowVisibleInstances = Graph.ImportBuffer("ShadowVisibleInstances", Shadow.VisibleInstances.Get(), &Shadow.VisibleInstanceState, { Shadow.VisibleInstances->GetDesc().Width });
+        if (Shadow.CompactedCommands)
+        {
+            Buffers.ShadowCompactedCommands = Graph.ImportBuffer("ShadowCompactedCommands", Shadow.CompactedCommands.Get(), &Shadow.CompactedCommandState, { Shadow.CompactedCommands->GetDesc().Width });
+        }
+    }
+
+    return Buffers;
+}
+
+void FRenderer::RegisterShaderPipeline(std::vector<std::wstring> SourceFiles, std::function<bool()> Rebuild)
+{
+    for (std::wstring& SourceFile : SourceFiles)
+    {
+        SourceFile = FShaderCompiler::NormalizeShaderPath(SourceFile);
+    }
+    ShaderPipelineEntries.push_back({ std::move(SourceFiles), std::move(Rebuild) });
+}
+
+uint32_t FRenderer::RebuildShaderPipelines(const std::vector<std::wstring>& AffectedSources)
+{
+    uint32_t RebuiltCount = 0;
+    for (const FShaderPipelineEntry& Entry : ShaderPipelineEntries)
+    {
+        const bool bAffected = std::any_of(Entry.SourceFiles.begin(), Entry.SourceFiles.end(), [&AffectedSources](const std::wstring& SourceFile)
+        {
+            return std::find(AffectedSources.begin(), AffectedSources.end(), SourceFile) != AffectedSources.end();
+        });
+        if (!bAffected)
+        {
+            continue;
+        }
+
+        if (Entry.Rebuild())
+        {
+            ++RebuiltCount;
+        }
+        else
+        {
+            LogWarning("Shader hot reload: pipeline rebuild failed for " + std::filesystem::path(Entry.SourceFiles.front()).u8string());
+        }
+    }
+    return RebuiltCount;
+}
+
+std::shared_ptr<FRendererPersistentResources> FRenderer::CapturePersistentResources() const
+{
+    auto Resources = std::make_shared<FRendererPersistentResources>();
+    Resources->Targets = PersistentTargets;
+    Resources->EnvironmentPath = LoadedEnvironmentPath;
+    Resources->EnvironmentCube = EnvironmentCubeTexture;
+    Resources->EnvironmentLighting = EnvironmentLighting;
+    Resources->EnvironmentMipCount = EnvironmentMipCount;
+    Resources->BrdfLutPath = LoadedBrdfLutPath;
+    Resources->BrdfLut = BrdfLutTexture;
+    if (GpuDebugPrintFontTexture && GpuDebugPrintGlyphBuffer)
+    {
+        FDebugPrintFontResources& Font = Resources->DebugPrintFont;
+        Font.FontTexture = GpuDebugPrintFontTexture;
+        Font.GlyphBuffer = GpuDebugPrintGlyphBuffer;
+        Font.AtlasWidth = GpuDebugPrintAtlasWidth;
+        Font.AtlasHeight = GpuDebugPrintAtlasHeight;
+        Font.FirstChar = GpuDebugPrintFirstChar;
+        Font.CharCount = GpuDebugPrintCharCount;
+        Font.FontSize = GpuDebugPrintFontSize;
+    }
+    return Resources;
+}
+
+void FRenderer::CompletePersistentResourceHandoff()
+{
+    for (const FTargetStateHandoff& Handoff : PendingStateHandoffs)
+    {
+        *Handoff.Target = *Handoff.Source;
+    }
+    PendingStateHandoffs.clear();
+    InheritedResources.reset();
+}
+
+bool FRenderer::AdoptPersistentTarget(const char* Name, const D3D12_RESOURCE_DESC& Desc, Microsoft::WRL::ComPtr<ID3D12Resource>& OutResource, D3D12_RESOURCE_STATES& State)
+{
+    if (!InheritedResources)
+    {
+        return false;
+    }
+
+    for (const FRendererPersistentResources::FTarget& Target : InheritedResources->Targets)
+    {
+        if (Target.Name != Name || !Target.Resource || !Target.State)
+        {
+            continue;
+        }
+
+        const D3D12_RESOURCE_DESC Existing = Target.Resource->GetDesc();
+        if (Existing.Dimension != Desc.Dimension || Existing.Width != Desc.Width || Existing.Height != Desc.Height
+            || Existing.DepthOrArraySize != Desc.DepthOrArraySize || Existing.MipLevels != Desc.MipLevels
+            || Existing.Format != Desc.Format || Existing.SampleDesc.Count != Desc.SampleDesc.Count || Existing.Flags != Desc.Flags)
+        {
+            return false;
+        }
+
+        // The previous renderer may still be rendering with it, so its state is only read at the hand-over.
+        OutResource = Target.Resource;
+        PendingStateHandoffs.push_back({ Target.State, &State });
+        FDX12MemoryTracker::Get().TransferOwnership(OutResource.Get(), GetMemoryOwnerId());
+        return true;
+    }
+    return false;
+}
+
+void FRenderer::RegisterPersistentTarget(const char* Name, ID3D12Resource* Resource, const D3D12_RESOURCE_STATES& State)
+{
+    PersistentTargets.push_back({ Name, Resource, &State });
+}
+
+void FRenderer::BindSceneData(ID3D12GraphicsCommandList* CommandList) const
+{
+    CommandList->SetGraphicsRootConstantBufferView(0, ViewConstantsAddress);
+    CommandList->SetGraphicsRoot32BitConstant(SceneInstanceRootParameter, NoInstanceBase, 0);
+
+    // Only read by indirect commands, which exist only once the buffer does.
+    ID3D12Resource* VisibleInstanceBuffer = GetVisibleInstanceBuffer();
+    CommandList->SetGraphicsRootShaderResourceView(SceneInstanceRootParameter + 1, VisibleInstanceBuffer ? VisibleInstanceBuffer->GetGPUVirtualAddress() : 0);
+    CommandList->SetGraphicsRootShaderResourceView(SceneInstanceRootParameter + 2, SceneObjectBuffer ? SceneObjectBuffer->GetGPUVirtualAddress() : 0);
+    CommandList->SetGraphicsRootShaderResourceView(SceneInstanceRootParameter + 3, SceneMaterialBuffer ? SceneMaterialBuffer->GetGPUVirtualAddress() : 0);
+}
+
+void FRenderer::RecordObjectIdPick(ID3D12GraphicsCommandList* CommandList, const FCamera& Camera)
+{
+    // The requested pixel is in output coordinates; the scene drew at the render resolution.
+    const uint32_t Width = static_cast<uint32_t>(RenderViewport.Width);
+    const uint32_t Height = static_cast<uint32_t>(RenderViewport.Height);
+    if (Width == 0 || Height == 0)
+    {
+        return;
+    }
+    const uint32_t ScaledX = static_cast<uint32_t>(static_cast<uint64_t>(ObjectIdReadbackX) * Width / (std::max)(static_cast<uint32_t>(Viewport.Width), 1u));
+    const uint32_t ScaledY = static_cast<uint32_t>(static_cast<uint64_t>(ObjectIdReadbackY) * Height / (std::max)(static_cast<uint32_t>(Viewport.Height), 1u));
+    const uint32_t ReadX = (std::min)(ScaledX, Width - 1);
+    const uint32_t ReadY = (std::min)(ScaledY, Height - 1);
+
+    // Only the texel the readback copies is cleared and shaded.
+    const D3D12_RECT PickRect = { static_cast<LONG>(ReadX), static_cast<LONG>(ReadY), static_cast<LONG>(ReadX + 1), static_cast<LONG>(ReadY + 1) };
+    CommandList->RSSetScissorRects(1, &PickRect);
+    const UINT ClearValue[4] = { 0, 0, 0, 0 };
+    CommandList->ClearRenderTargetView(ObjectIdRtvHandle, reinterpret_cast<const float*>(ClearValue), 1, &PickRect);
+
+    // Models the ray through the texel's center misses cannot cover it.
+    const float NdcX = (static_cast<float>(ReadX) + 0.5f) / static_cast<float>(Width) * 2.0f - 1.0f;
+    const float NdcY = 1.0f - (static_cast<float>(ReadY) + 0.5f) / static_cast<float>(Height) * 2.0f;
+    DirectX::XMFLOAT3 RayOrigin;
+    DirectX::XMFLOAT3 RayDirection;
+    RendererUtils::BuildCameraRay(Camera, NdcX, NdcY, RayOrigin, RayDirection);
+    std::vector<FBvhRayHit> Hits;
+    RaycastSceneModels(RayOrigin, RayDirection, Hits);
+
+    // Indirect draws picked a LOD per model; matching it keeps the surface equal to the depth it tests against.
+    const bool bUseLods = bEnableIndirectDraw && IndirectCommandCount > 0;
+    const DirectX::XMFLOAT3 CameraPosition = Camera.GetPosition();
+    const float LodErrorScale = RendererUtils::ComputeLodErrorScale(Camera, RenderViewport.Height, LodBias);
+    RendererUtils::FGeometryBinding GeometryBinding;
+    for (const FBvhRayHit& Hit : Hits)
+    {
+        if (Hit.ObjectIndex >= SceneModels.size())
+        {
+            continue;
+        }
+
+        const FSceneModelResource& Model = SceneModels[Hit.ObjectIndex];
+        const FSceneModelLod Lod = bUseLods
+            ? Model.Lods[RendererUtils::SelectModelLod(Model, CameraPosition, LodErrorScale)]
+            : FSceneModelLod{ Model.DrawIndexStart, Model.DrawIndexCount, 0.0f };
+
+        GeometryBinding.BindPositions(CommandList, Model.Geometry);
+        BindSceneObject(CommandList, Hit.ObjectIndex);
+        CommandList->DrawIndexedInstanced(Lod.IndexCount, 1, Lod.IndexStart, 0, 0);
+    }
+
+    D3D12_RESOURCE_BARRIER Barrier = {};
+    Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    Barrier.Transition.pResource = ObjectIdTexture.Get();
+    Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+    Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+    CommandList->ResourceBarrier(1, &Barrier);
+
+    D3D12_TEXTURE_COPY_LOCATION Src = {};
+    Src.pResource = ObjectIdTexture.Get();
+    Src.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+    Src.SubresourceIndex = 0;
+
+    D3D12_TEXTURE_COPY_LOCATION Dst = {};
+    Dst.pResource = ObjectIdReadback.Get();
+    Dst.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+    Dst.PlacedFootprint = ObjectIdFootprint;
+
+    D3D12_BOX SourceBox = {};
+    SourceBox.left = ReadX;
+    SourceBox.top = ReadY;
+    SourceBox.front = 0;
+    SourceBox.right = ReadX + 1;
+    SourceBox.bottom = ReadY + 1;
+    SourceBox.back = 1;
+
+    CommandList->CopyTextureRegion(&Dst, 0, 0, 0, &Src, &SourceBox);
+
+    std::swap(Barrier.Transition.StateBefore, Barrier.Transition.StateAfter);
+    CommandList->ResourceBarrier(1, &Barrier);
+
+    bObjectIdReadbackRecorded = true;
+}
+
+void FRenderer::DispatchGpuCulling(FDX12CommandContext& CmdContext, const FCamera& Camera, EGpuCullingPhase Phase)
+{
+    if (Phase != EGpuCullingPhase::Single && !InstanceVisibilityBuffer)
+    {
+        return;
+    }
+
+    const FCamera* CullingCamera = GetCullingCameraOverride();
+    if (!CullingCamera)
+    {
+        CullingCamera = &Camera;
+    }
+
+    FGpuCullingTargets Targets;
+    Targets.IndirectCommands = GetIndirectCommandBuffer();
+    Targets.VisibleInstances = GetVisibleInstanceBuffer();
+    Targets.CompactedCommands = GetCompactedCommandBuffer();
+
+    const DirectX::XMMATRIX ViewProjection = CullingCamera->GetViewMatrix() * CullingCamera->GetProjectionMatrix();
+    const bool bOcclusion = bHZBOcclusionEnabled && Phase != EGpuCullingPhase::First;
+    const DirectX::XMFLOAT2 TargetSize(RenderViewport.Width, RenderViewport.Height);
+    RecordGpuCulling(CmdContext, Targets, ViewProjection, Camera, Phase, bOcclusion, MinScreenCoverage, TargetSize, IsGpuCullingStatsEnabled(),
+        Phase == EGpuCullingPhase::Second ? L"GpuCullingPhaseTwo" : L"GpuCulling");
+}
+
+void FRenderer::DispatchGpuShadowCulling(FDX12CommandContext& CmdContext, const FCamera& Camera, const DirectX::XMMATRIX& LightViewProjection, float TexelScale)
+{
+    if (ShadowCullingBuffers.empty())
+    {
+        return;
+    }
+
+    const FShadowCullingBuffers& Buffers = ShadowCullingBuffers[CurrentFrameIndex];
+    FGpuCullingTargets Targets;
+    Targets.IndirectCommands = Buffers.IndirectCommands.Get();
+    Targets.VisibleInstances = Buffers.VisibleInstances.Get();
+    Targets.CompactedCommands = Buffers.CompactedCommands.Get();
+
+    // The HZB only holds the camera's depth, and the stats overlay counts the camera view alone.
+    // Coverage is measured in shadow map texels.
+    const DirectX::XMFLOAT2 TargetSize(static_cast<float>(ShadowMapWidth) * TexelScale, static_cast<float>(ShadowMapHeight) * TexelScale);
+    RecordGpuCulling(CmdContext, Targets, LightViewProjection, Camera, EGpuCullingPhase::Single, false, ShadowMinScreenCoverage, TargetSize, false, L"GpuShadowCulling");
+}
+
+void FRenderer::RecordGpuCulling(
+    FDX12CommandContext& CmdContext,
+    const FGpuCullingTargets& Targets,
+    const DirectX::XMMATRIX& ViewProjection,
+    const FCamera& LodCamera,
+    EGpuCullingPhase Phase,
+    bool bOcclusion,
+    float MinScreenCoverage,
+    const DirectX::XMFLOAT2& TargetSize,
+    bool bDebugStats,
+    const wchar_t* EventName)
+{
+    ID3D12Resource* IndirectBuffer = Targets.IndirectCommands;
+    ID3D12Resource* VisibleInstanceBuffer = Targets.VisibleInstances;
+    if (!CullingPipeline || !CullingResetPipeline || !CullingRootSignature || !IndirectBuffer || !VisibleInstanceBuffer || !ModelBoundsBuffer || IndirectCommandCount == 0)
+    {
+        return;
+    }
+
+    DirectX::XMVECTOR Planes[6] = {};
+    RendererUtils::BuildFrustumPlanesFromMatrix(ViewProjection, Planes);
+
+    std::array<uint32_t, 57> Constants = {};
+    for (uint32_t PlaneIndex = 0; PlaneIndex < 6; ++PlaneIndex)
+    {
+        DirectX::XMFLOAT4 Plane;
+        DirectX::XMStoreFloat4(&Plane, Planes[PlaneIndex]);
+        std::memcpy(Constants.data() + PlaneIndex * 4, &Plane, sizeof(DirectX::XMFLOAT4));
+    }
+
+    DirectX::XMFLOAT4X4 ViewProjectionMatrix = {};
+    DirectX::XMStoreFloat4x4(&ViewProjectionMatrix, ViewProjection);
+    std::memcpy(Constants.data() + 24, &ViewProjectionMatrix, sizeof(DirectX::XMFLOAT4X4));
+
+    Constants[40] = IndirectInstanceCount;
+    Constants[41] = bOcclusion ? 1u : 0u;
+    Constants[42] = HZBCullingMipCount;
+    Constants[43] = HZBCullingWidth;
+    Constants[44] = HZBCullingHeight;
+    Constants[45] = bDebugStats ? 1u : 0u;
+
+    // LODs follow the rendering camera even while culling is frozen on an override camera, and
+    // in the shadow view, so casters match the detail the camera sees.
+    const float LodErrorScale = RendererUtils::ComputeLodErrorScale(LodCamera, RenderViewport.Height, LodBias);
+    const DirectX::XMFLOAT3 LodCameraPosition = LodCamera.GetPosition();
+    std::memcpy(Constants.data() + 46, &LodErrorScale, sizeof(float));
+    Constants[47] = IndirectCommandCount;
+    std::memcpy(Constants.data() + 48, &LodCameraPosition, sizeof(DirectX::XMFLOAT3));
+    Constants[51] = static_cast<uint32_t>(Phase);
+    // A range count of 0 leaves compaction off; draws then read the culled commands directly.
+    ID3D12Resource* CompactedBuffer = CullingCompactPipeline && IndirectCommandRangeBuffer ? Targets.CompactedCommands : nullptr;
+    Constants[52] = static_cast<uint32_t>(CompactedCountOffset);
+    Constants[53] = CompactedBuffer ? static_cast<uint32_t>(IndirectDrawRanges.size()) : 0u;
+    std::memcpy(Constants.data() + 54, &TargetSize, sizeof(DirectX::XMFLOAT2));
+    std::memcpy(Constants.data() + 56, &MinScreenCoverage, sizeof(float));
+
+    // Too large for root constants next to the culling buffers' root descriptors.
+    FDX12UploadRing* UploadRing = CmdContext.GetUploadRing();
+    const FDX12UploadAllocation ConstantsUpload = UploadRing
+        ? UploadRing->Allocate(sizeof(Constants), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT)
+        : FDX12UploadAllocation{};
+    if (!ConstantsUpload.IsValid())
+    {
+        LogWarning("Failed to allocate upload space for culling constants");
+        return;
+    }
+    std::memcpy(ConstantsUpload.CpuAddress, Constants.data(), sizeof(Constants));
+
+    ID3D12GraphicsCommandList* CommandList = CmdContext.GetCommandList();
+    FScopedPixEvent CullingEvent(CommandList, EventName);
+
+    CommandList->SetComputeRootSignature(CullingRootSignature.Get());
+    CommandList->SetComputeRootConstantBufferView(0, ConstantsUpload.GpuAddress);
+    CommandList->SetComputeRootShaderResourceView(1, ModelBoundsBuffer->GetGPUVirtualAddress());
+    CommandList->SetComputeRootUnorderedAccessView(2, IndirectBuffer->GetGPUVirtualAddress());
+    CommandList->SetComputeRootUnorderedAccessView(3, GpuDebugPrintBuffer->GetGPUVirtualAddress());
+    CommandList->SetComputeRootUnorderedAccessView(4, GpuDebugPrintStatsBuffer->GetGPUVirtualAddress());
+    CommandList->SetComputeRootUnorderedAccessView(6, VisibleInstanceBuffer->GetGPUVirtualAddress());
+    // Only the two-phase kernels read the flags, and those require the buffer.
+    CommandList->SetComputeRootUnorderedAccessView(7, InstanceVisibilityBuffer ? InstanceVisibilityBuffer->GetGPUVirtualAddress() : 0);
+    CommandList->SetComputeRootShaderResourceView(8, IndirectCommandRangeBuffer ? IndirectCommandRangeBuffer->GetGPUVirtualAddress() : 0);
+    CommandList->SetComputeRootUnorderedAccessView(9, CompactedBuffer ? CompactedBuffer->GetGPUVirtualAddress() : 0);
+    if (CullingDescriptorHeap)
+    {
+        ID3D12DescriptorHeap* Heaps[] = { CullingDescriptorHeap.Get() };
+        CommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
+        CommandList->SetComputeRootDescriptorTable(5, HZBCullingHandle);
+    }
+
+    // The first phase resets both command sets, so the second only appends.
+    if (Phase != EGpuCullingPhase::Second)
+    {
+        const uint32_t ResetCount = Phase == EGpuCullingPhase::First ? IndirectCommandCount * 2 : IndirectCommandCount;
+        CommandList->SetPipelineState(CullingResetPipeline.Get());
+        CommandList->Dispatch((ResetCount + 63) / 64, 1, 1);
+
+        // Instance counts and range counts are appended to with atomics, so the reset must land first.
+        D3D12_RESOURCE_BARRIER ResetBarriers[2] = {};
+        ResetBarriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+        ResetBarriers[0].UAV.pResource = IndirectBuffer;
+        ResetBarriers[1] = ResetBarriers[0];
+        ResetBarriers[1].UAV.pResource = CompactedBuffer;
+        CommandList->ResourceBarrier(CompactedBuffer ? 2 : 1, ResetBarriers);
+    }
+
+    CommandList->SetPipelineState(CullingPipeline.Get());
+    CommandList->Dispatch((IndirectInstanceCount + 63) / 64, 1, 1);
+
+    if (!CompactedBuffer)
+    {
+        return;
+    }
+
+    // Compaction reads the final instance counts, so every model must have been appended.
+    D3D12_RESOURCE_BARRIER CullBarrier = {};
+    CullBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+    CullBarrier.UAV.pResource = IndirectBuffer;
+    CommandList->ResourceBarrier(1, &CullBarrier);
+
+    CommandList->SetPipelineState(CullingCompactPipeline.Get());
+    CommandList->Dispatch((IndirectCommandCount + 63) / 64, 1, 1);
+}
+
+bool FRenderer::CreateIndirectCompactionResources(FDX12Device* Device, uint32_t CommandSetCount)
+{
+    CompactedCommandBuffers.clear();
+    CompactedCommandStates.clear();
+    IndirectCommandRangeBuffer.Reset();
+    if (!Device || IndirectCommandCount == 0 || IndirectDrawRanges.empty())
+    {
+        return false;
+    }
+
+    const uint32_t RangeCount = static_cast<uint32_t>(IndirectDrawRanges.size());
+    std::vector<FIndirectCommandRange> CommandRanges(static_cast<size_t>(CommandSetCount) * IndirectCommandCount);
+    for (uint32_t SetIndex = 0; SetIndex < CommandSetCount; ++SetIndex)
+    {
+        for (uint32_t RangeIndex = 0; RangeIndex < RangeCount; ++RangeIndex)
+        {
+            const FIndirectDrawRange& Range = IndirectDrawRanges[RangeIndex];
+            const uint32_t SetStart = SetIndex * IndirectCommandCount;
+            for (uint32_t CommandIndex = Range.Start; CommandIndex < Range.Start + Range.Count; ++CommandIndex)
+            {
+                CommandRanges[SetStart + CommandIndex] = { SetIndex * RangeCount + RangeIndex, SetStart + Range.Start };
+            }
+        }
+    }
+
+    const uint64_t CommandBytes = sizeof(FIndirectDrawCommand) * CommandRanges.size();
+    CompactedCountOffset = CommandBytes;
+
+    D3D12_HEAP_PROPERTIES DefaultHeap = {};
+    DefaultHeap.Type = D3D12_HEAP_TYPE_DEFAULT;
+    DefaultHeap.CreationNodeMask = 1;
+    DefaultHeap.VisibleNodeMask = 1;
+
+    D3D12_HEAP_PROPERTIES UploadHeap = DefaultHeap;
+    UploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+    D3D12_RESOURCE_DESC BufferDesc = {};
+    BufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    BufferDesc.Width = CommandBytes + sizeof(uint32_t) * static_cast<uint64_t>(CommandSetCount) * RangeCount;
+    BufferDesc.Height = 1;
+    BufferDesc.DepthOrArraySize = 1;
+    BufferDesc.MipLevels = 1;
+    BufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+    BufferDesc.SampleDesc.Count = 1;
+    BufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    BufferDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+    // Written by culling every frame before any draw reads it, so it needs no initial data.
+    CompactedCommandBuffers.resize(GetFramesInFlight());
+    CompactedCommandStates.assign(GetFramesInFlight(), D3D12_RESOURCE_STATE_COMMON);
+    for (uint32_t FrameIndex = 0; FrameIndex < GetFramesInFlight(); ++FrameIndex)
+    {
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::Buffer,
+            &DefaultHeap,
+            D3D12_HEAP_FLAG_NONE,
+            &BufferDesc,
+            D3D12_RESOURCE_STATE_COMMON,
+            nullptr,
+            IID_PPV_ARGS(CompactedCommandBuffers[FrameIndex].GetAddressOf())));
+        if (!CompactedCommandBuffers[FrameIndex])
+        {
+            LogError("Failed to create compacted indirect command buffers");
+            CompactedCommandBuffers.clear();
+            CompactedCommandStates.clear();
+            return false;
+        }
+        const std::wstring Name = L"CompactedCommandBuffer_Frame" + std::to_wstring(FrameIndex);
+        CompactedCommandBuffers[FrameIndex]->SetName(Name.c_str());
+    }
+
+    const uint64_t RangeBytes = sizeof(FIndirectCommandRange) * CommandRanges.size();
+    D3D12_RESOURCE_DESC RangeDesc = BufferDesc;
+    RangeDesc.Width = RangeBytes;
+    RangeDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+    Microsoft::WRL::ComPtr<ID3D12Resource> UploadBuffer;
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Buffer,
+        &DefaultHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &RangeDesc,
+        D3D12_RESOURCE_STATE_COMMON,
+        nullptr,
+        IID_PPV_ARGS(IndirectCommandRangeBuffer.ReleaseAndGetAddressOf())));
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Upload,
+        &UploadHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &RangeDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(UploadBuffer.GetAddressOf())));
+    if (!IndirectCommandRangeBuffer || !UploadBuffer)
+    {
+        LogError("Failed to create the indirect command range buffer");
+        CompactedCommandBuffers.clear();
+        CompactedCommandStates.clear();
+        IndirectCommandRangeBuffer.Reset();
+        return false;
+    }
+    IndirectCommandRangeBuffer->SetName(L"IndirectCommandRangeBuffer");
+
+    const D3D12_RANGE EmptyRange = { 0, 0 };
+    void* UploadData = nullptr;
+    HR_CHECK(UploadBuffer->Map(0, &EmptyRange, &UploadData));
+    std::memcpy(UploadData, CommandRanges.data(), RangeBytes);
+    UploadBuffer->Unmap(0, nullptr);
+
+    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> UploadAllocator;
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> UploadList;
+    HR_CHECK(Device->GetDevice()->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(UploadAllocator.GetAddressOf())));
+    HR_CHECK(Device->GetDevice()->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, UploadAllocator.Get(), nullptr, IID_PPV_ARGS(UploadList.GetAddressOf())));
+
+    D3D12_RESOURCE_BARRIER Barrier = {};
+    Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    Barrier.Transition.pResource = IndirectCommandRangeBuffer.Get();
+    Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COMMON;
+    Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+    UploadList->ResourceBarrier(1, &Barrier);
+    UploadList->CopyBufferRegion(IndirectCommandRangeBuffer.Get(), 0, UploadBuffer.Get(), 0, RangeBytes);
+    Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+    Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+    UploadList->ResourceBarrier(1, &Barrier);
+
+    HR_CHECK(UploadList->Close());
+    ID3D12CommandList* Lists[] = { UploadList.Get() };
+    Device->GetGraphicsQueue()->ExecuteCommandLists(1, Lists);
+    Device->GetGraphicsQueue()->Flush();
+
+    return true;
+}
+
+bool FRenderer::CreateShadowCullingResources(FDX12Device* Device, const FIndirectDrawCommand* Commands, uint32_t VisibleInstanceSlotCount)
+{
+    ShadowCullingBuffers.clear();
+    if (!Device || !Commands || IndirectCommandCount == 0)
+    {
+        return false;
+    }
+
+    D3D12_HEAP_PROPERTIES DefaultHeap = {};
+    DefaultHeap.Type = D3D12_HEAP_TYPE_DEFAULT;
+    DefaultHeap.CreationNodeMask = 1;
+    DefaultHeap.VisibleNodeMask = 1;
+
+    D3D12_HEAP_PROPERTIES UploadHeap = DefaultHeap;
+    UploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+    const uint64_t CommandBytes = sizeof(FIndirectDrawCommand) * static_cast<uint64_t>(IndirectCommandCount);
+    D3D12_RESOURCE_DESC CommandDesc = {};
+    CommandDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    CommandDesc.Width = CommandBytes;
+    CommandDesc.Height = 1;
+    CommandDesc.DepthOrArraySize = 1;
+    CommandDesc.MipLevels = 1;
+    CommandDesc.Format = DXGI_FORMAT_UNKNOWN;
+    CommandDesc.SampleDesc.Count = 1;
+    CommandDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    CommandDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+    D3D12_RESOURCE_DESC VisibleInstanceDesc = CommandDesc;
+    VisibleInstanceDesc.Width = sizeof(uint32_t) * static_cast<uint64_t>((std::max)(VisibleInstanceSlotCount, 1u));
+
+    // Same layout as the camera's compacted buffer, so its range counts sit at CompactedCountOffset
+    // and the first command set's entries of IndirectCommandRangeBuffer apply unchanged.
+    ID3D12Resource* CameraCompactedBuffer = GetCompactedCommandBuffer();
+    D3D12_RESOURCE_DESC CompactedDesc = CommandDesc;
+    CompactedDesc.Width = CameraCompactedBuffer ? CameraCompactedBuffer->GetDesc().Width : 0;
+
+    D3D12_RESOURCE_DESC UploadDesc = CommandDesc;
+    UploadDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+    Microsoft::WRL::ComPtr<ID3D12Resource> UploadBuffer;
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Upload,
+        &UploadHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &UploadDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(UploadBuffer.GetAddressOf())));
+    if (!UploadBuffer)
+    {
+        LogError("Failed to create the shadow indirect command upload buffer");
+        return false;
+    }
+
+    const D3D12_RANGE EmptyRange = { 0, 0 };
+    void* UploadData = nullptr;
+    HR_CHECK(UploadBuffer->Map(0, &EmptyRange, &UploadData));
+    std::memcpy(UploadData, Commands, CommandBytes);
+    UploadBuffer->Unmap(0, nullptr);
+
+    ShadowCullingBuffers.resize(GetFramesInFlight());
+    for (uint32_t FrameIndex = 0; FrameIndex < GetFramesInFlight(); ++FrameIndex)
+    {
+        FShadowCullingBuffers& Buffers = ShadowCullingBuffers[FrameIndex];
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::Buffer,
+            &DefaultHeap,
+            D3D12_HEAP_FLAG_NONE,
+            &CommandDesc,
+            D3D12_RESOURCE_STATE_COMMON,
+            nullptr,
+            IID_PPV_ARGS(Buffers.IndirectCommands.GetAddressOf())));
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::Buffer,
+            &DefaultHeap,
+            D3D12_HEAP_FLAG_NONE,
+            &VisibleInstanceDesc,
+            D3D12_RESOURCE_STATE_COMMON,
+            nullptr,
+            IID_PPV_ARGS(Buffers.VisibleInstances.GetAddressOf())));
+        if (CompactedDesc.Width > 0)
+        {
+            HR_CHECK(Device->CreateCommittedResource(
+                EGpuMemoryCategory::Buffer,
+                &DefaultHeap,
+                D3D12_HEAP_FLAG_NONE,
+                &CompactedDesc,
+                D3D12_RESOURCE_STATE_COMMON,
+                nullptr,
+                IID_PPV_ARGS(Buffers.CompactedCommands.GetAddressOf())));
+        }
+        if (!Buffers.IndirectCommands || !Buffers.VisibleInstances)
+        {
+            LogError("Failed to create shadow indirect command buffers");
+            ShadowCullingBuffers.clear();
+            return false;
+        }
+
+        const std::wstring Suffix = L"_Frame" + std::to_wstring(FrameIndex);
+        Buffers.IndirectCommands->SetName((L"ShadowIndirectCommandBuffer" + Suffix).c_str());
+        Buffers.VisibleInstances->SetName((L"ShadowVisibleInstanceBuffer" + Suffix).c_str());
+        if (Buffers.CompactedCommands)
+        {
+            Buffers.CompactedCommands->SetName((L"ShadowCompactedCommandBuffer" + Suffix).c_str());
+        }
+    }
+
+    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> UploadAllocator;
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> UploadList;
+    HR_CHECK(Device->GetDevice()->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(UploadAllocator.GetAddressOf())));
+    HR_CHECK(Device->GetDevice()->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, UploadAllocator.Get(), nullptr, IID_PPV_ARGS(UploadList.GetAddressOf())));
+
+    for (FShadowCullingBuffers& Buffers : ShadowCullingBuffers)
+    {
+        D3D12_RESOURCE_BARRIER Barrier = {};
+        Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        Barrier.Transition.pResource = Buffers.IndirectCommands.Get();
+        Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COMMON;
+        Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+        UploadList->ResourceBarrier(1, &Barrier);
+        UploadList->CopyBufferRegion(Buffers.IndirectCommands.Get(), 0, UploadBuffer.Get(), 0, CommandBytes);
+        Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT;
+        UploadList->ResourceBarrier(1, &Barrier);
+        Buffers.IndirectCommandState = D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT;
+    }
+
+    HR_CHECK(UploadList->Close());
+    ID3D12CommandList* Lists[] = { UploadList.Get() };
+    Device->GetGraphicsQueue()->ExecuteCommandLists(1, Lists);
+    Device->GetGraphicsQueue()->Flush();
+
+    return true;
+}
+
+void FRenderer::BindShadowVisibleInstances(ID3D12GraphicsCommandList* CommandList) const
+{
+    ID3D12Resource* VisibleInstanceBuffer = ShadowCullingBuffers.empty() ? nullptr : ShadowCullingBuffers[CurrentFrameIndex].VisibleInstances.Get();
+    CommandList->SetGraphicsRootShaderResourceView(SceneInstanceRootParameter + 1, VisibleInstanceBuffer ? VisibleInstanceBuffer->GetGPUVirtualAddress() : 0);
+}
+
+void FRenderer::ExecuteIndirectRange(ID3D12GraphicsCommandList* CommandList, uint32_t RangeIndex, bool bSecondPhase) const
+{
+    ExecuteIndirectRange(CommandList, RangeIndex, bSecondPhase ? 1u : 0u, GetIndirectCommandBuffer(), GetCompactedCommandBuffer());
+}
+
+void FRenderer::ExecuteShadowIndirectRange(ID3D12GraphicsCommandList* CommandList, uint32_t RangeIndex) const
+{
+    if (ShadowCullingBuffers.empty())
+    {
+        return;
+    }
+
+    const FShadowCullingBuffers& Buffers = ShadowCullingBuffers[CurrentFrameIndex];
+    ExecuteIndirectRange(CommandList, RangeIndex, 0, Buffers.IndirectCommands.Get(), Buffers.CompactedCommands.Get());
+}
+
+void FRenderer::ExecuteIndirectRange(ID3D12GraphicsCommandList* CommandList, uint32_t RangeIndex, uint32_t SetIndex, ID3D12Resource* IndirectBuffer, ID3D12Resource* CompactedBuffer) const
+{
+    const FIndirectDrawRange& Range = IndirectDrawRanges[RangeIndex];
+    const uint64_t Offset = (static_cast<uint64_t>(SetIndex) * IndirectCommandCount + Range.Start) * sizeof(FIndirectDrawCommand);
+
+    if (CullingCompactPipeline && IndirectCommandRangeBuffer && CompactedBuffer)
+    {
+        // The range's count stops the command processor after the commands compaction kept.
+        const uint64_t CountOffset = CompactedCountOffset + (SetIndex * IndirectDrawRanges.size() + RangeIndex) * sizeof(uint32_t);
+        CommandList->ExecuteIndirect(IndirectCommandSignature.Get(), Range.Count, CompactedBuffer, Offset, CompactedBuffer, CountOffset);
+        return;
+    }
+
+    CommandList->ExecuteIndirect(IndirectCommandSignature.Get(), Range.Count, IndirectBuffer, Offset, nullptr, 0);
+}
+
+FDX12DescriptorRange FRenderer::AllocatePersistentDescriptors(uint32_t Count)
+{
+    FDX12DescriptorAllocator* Allocator = Device ? Device->GetDescriptorAllocator() : nullptr;
+    const FDX12DescriptorRange Range = Allocator ? Allocator->AllocatePersistent(Count) : FDX12DescriptorRange{};
+    if (Range.IsValid())
+    {
+        PersistentDescriptorRanges.push_back(Range);
+    }
+    return Range;
+}
+
+void FRenderer::InitializeVariableRateShading(FDX12Device* Device, uint32_t Width, uint32_t Height, DXGI_FORMAT OverlayFormat)
+{
+    if (!Device || !Device->SupportsShadingRateImage())
+    {
+        return;
+    }
+
+    if (!VariableRateShading.Initialize(Device, Width, Height, OverlayFormat, AllocatePersistentDescriptors(FVariableRateShading::DescriptorCount)))
+    {
+        LogWarning("Variable rate shading setup failed; every pixel is shaded.");
+        return;
+    }
+
+    RegisterShaderPipeline({ L"Shaders/ShadingRate.hlsl" }, [this, Device]() { return VariableRateShading.CreatePipelines(Device); });
+}
+
+bool FRenderer::LoadEnvironment(FDX12Device* Device, const std::wstring& EnvironmentPath)
+{
+    LoadedEnvironmentPath = EnvironmentPath;
+    if (InheritedResources && InheritedResources->EnvironmentCube && InheritedResources->EnvironmentPath == EnvironmentPath)
+    {
+        EnvironmentCubeTexture = InheritedResources->EnvironmentCube;
+        EnvironmentLighting = InheritedResources->EnvironmentLighting;
+        EnvironmentMipCount = InheritedResources->EnvironmentMipCount;
+        FDX12MemoryTracker::Get().TransferOwnership(EnvironmentCubeTexture.Get(), GetMemoryOwnerId());
+        return true;
+    }
+
+    if (!TextureLoader->LoadOrDefault(EnvironmentPath, EnvironmentCubeTexture))
+    {
+        return false;
+    }
+    if (EnvironmentCubeTexture)
+    {
+        EnvironmentCubeTexture->SetName(L"EnvironmentCube");
+    }
+
+    // Without precomputed lighting the source chain stands in for the prefiltered one.
+    if (EnvironmentLighting.Build(Device, *TextureLoader, EnvironmentPath, EnvironmentCubeTexture.Get()))
+    {
+        EnvironmentCubeTexture = EnvironmentLighting.GetPrefilteredCube();
+    }
+
+    if (EnvironmentCubeTexture)
+    {
+        const D3D12_RESOURCE_DESC EnvDesc = EnvironmentCubeTexture->GetDesc();
+        EnvironmentMipCount = static_cast<float>((std::max)(1u, static_cast<uint32_t>(EnvDesc.MipLevels)));
+    }
+    return true;
+}
+
+bool FRenderer::LoadBrdfLut(const std::wstring& BrdfLutPath)
+{
+    LoadedBrdfLutPath = BrdfLutPath;
+    if (InheritedResources && InheritedResources->BrdfLut && InheritedResources->BrdfLutPath == BrdfLutPath)
+    {
+        BrdfLutTexture = InheritedResources->BrdfLut;
+        return true;
+    }
+
+    if (!TextureLoader->LoadOrDefault(BrdfLutPath, BrdfLutTexture))
+    {
+        return false;
+    }
+    if (BrdfLutTexture)
+    {
+        BrdfLutTexture->SetName(L"BrdfLut");
+    }
+    return true;
+}
+
+bool FRenderer::InitializeSkyAtmosphere(FDX12Device* Device, DXGI_FORMAT OutputFormat, const FSkyPipelineConfig& Config)
+{
+    return SkyAtmosphere.Initialize(Device, OutputFormat, Config, AllocatePersistentDescriptors(FSkyAtmosphere::DescriptorCount));
+}
+
+FRenderer::FSkyAtmosphereLuts FRenderer::AddSkyAtmosphereLutPasses(FRenderGraph& Graph)
+{
+    FSkyAtmosphereLuts Luts;
+    if (!SkyAtmosphere.IsReady())
+    {
+        return Luts;
+    }
+
+    const DXGI_FORMAT LutFormat = FSkyAtmosphere::LutFormat;
+    Luts.Transmittance = Graph.ImportTexture("SkyTransmittanceLut", SkyAtmosphere.GetTransmittanceLut(), SkyAtmosphere.GetTransmittanceLutState(),
+        { FSkyAtmosphere::TransmittanceLutWidth, FSkyAtmosphere::TransmittanceLutHeight, LutFormat });
+    const FRGResourceHandle MultiScatteringHandle = Graph.ImportTexture("SkyMultiScatteringLut", SkyAtmosphere.GetMultiScatteringLut(), SkyAtmosphere.GetMultiScatteringLutState(),
+        { FSkyAtmosphere::MultiScatteringLutSize, FSkyAtmosphere::MultiScatteringLutSize, LutFormat });
+    Luts.SkyView = Graph.ImportTexture("SkyViewLut", SkyAtmosphere.GetSkyViewLut(), SkyAtmosphere.GetSkyViewLutState(),
+        { FSkyAtmosphere::SkyViewLutWidth, FSkyAtmosphere::SkyViewLutHeight, LutFormat });
+
+    struct FSkyLutPassData
+    {
+    };
+
+    // The atmosphere LUTs stay valid until the shaders change; most frames record neither.
+    if (SkyAtmosphere.NeedsAtmosphereLuts())
+    {
+        Graph.AddPass<FSkyLutPassData>("Sky Transmittance LUT", [&](FSkyLutPassData&, FRGPassBuilder& Builder)
+        {
+            Builder.WriteTexture(Luts.Transmittance, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        }, [this](const FSkyLutPassData&, FDX12CommandContext& Cmd)
+        {
+            ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
+            FScopedPixEvent LutEvent(LocalCommandList, L"Sky Transmittance LUT");
+            SkyAtmosphere.BuildTransmittanceLut(LocalCommandList);
+        });
+
+        Graph.AddPass<FSkyLutPassData>("Sky Multi-Scattering LUT", [&](FSkyLutPassData&, FRGPassBuilder& Builder)
+        {
+            Builder.ReadTexture(Luts.Transmittance, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Builder.WriteTexture(MultiScatteringHandle, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        }, [this](const FSkyLutPassData&, FDX12CommandContext& Cmd)
+        {
+            ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
+            FScopedPixEvent LutEvent(LocalCommandList, L"Sky Multi-Scattering LUT");
+            SkyAtmosphere.BuildMultiScatteringLut(LocalCommandList);
+        });
+    }
+
+    if (SkyAtmosphere.NeedsSkyViewLut(LightDirection))
     {
-        FMappedConstantBuffer ConstantBufferResource = {};
-        if (!RendererUtils::CreateMappedConstantBuffer(Device, BufferSize, ConstantBufferResource))
+        const DirectX::XMFLOAT3 SunDirection = LightDirection;
+        Graph.AddPass<FSkyLutPassData>("Sky View LUT", [&](FSkyLutPassData&, FRGPassBuilder& Builder)
         {
-            return false;
-        }
-
-        SceneConstantBuffers[Index] = ConstantBufferResource.Resource;
-        SceneConstantBufferMapped[Index] = ConstantBufferResource.MappedData;
-
-        if (SceneConstantBuffers[Index])
+            Builder.ReadTexture(Luts.Transmittance, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Builder.ReadTexture(MultiScatteringHandle, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            Builder.WriteTexture(Luts.SkyView, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        }, [this, SunDirection](const FSkyLutPassData&, FDX12CommandContext& Cmd)
         {
-            const std::wstring Name = L"SceneConstantBuffer_Frame" + std::to_wstring(Index);
-            SceneConstantBuffers[Index]->SetName(Name.c_str());
-        }
+            ID3D12GraphicsCommandList* LocalCommandList = Cmd.GetCommandList();
+            FScopedPixEvent LutEvent(LocalCommandList, L"Sky View LUT");
+            SkyAtmosphere.BuildSkyViewLut(LocalCommandList, SunDirection);
+        });
     }
 
-    return true;
+    return Luts;
 }
 
-bool FRenderer::CreateShadowPipeline(FDX12Device* Device, ID3D12RootSignature* RootSignature, Microsoft::WRL::ComPtr<ID3D12PipelineState>& OutPipelineState)
+FDX12DescriptorRange FRenderer::AllocateStreamedMaterialTable(uint32_t ModelIndex, uint32_t Count)
 {
-    if (!Device || !RootSignature)
+    FDX12DescriptorAllocator* Allocator = Device ? Device->GetDescriptorAllocator() : nullptr;
+    const FDX12DescriptorRange Range = Allocator ? Allocator->AllocatePersistent(Count) : FDX12DescriptorRange{};
+    if (!Range.IsValid())
     {
-        return false;
+        return Range;
     }
 
-    FShaderCompiler Compiler;
-    std::vector<uint8_t> VSByteCode;
-
-    const D3D_SHADER_MODEL ShaderModel = Device->GetShaderModel();
-    const std::wstring VSTarget = RendererUtils::BuildShaderTarget(L"vs", ShaderModel);
-
-    if (!Compiler.CompileFromFile(L"Shaders/ShadowMap.hlsl", L"VSMain", VSTarget, VSByteCode))
+    if (ModelIndex >= StreamedMaterialTables.size())
     {
-        return false;
+        StreamedMaterialTables.resize(ModelIndex + 1);
     }
-
-    D3D12_INPUT_ELEMENT_DESC InputLayout[] =
+    if (StreamedMaterialTables[ModelIndex].IsValid())
     {
-        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0,   D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-    };
-
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC PsoDesc = {};
-    PsoDesc.pRootSignature = RootSignature;
-    PsoDesc.InputLayout = { InputLayout, _countof(InputLayout) };
-    PsoDesc.VS = { VSByteCode.data(), VSByteCode.size() };
-    PsoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-    PsoDesc.SampleDesc.Count = 1;
-    PsoDesc.SampleMask = UINT_MAX;
-
-    PsoDesc.RasterizerState = {};
-    PsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
-    PsoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_FRONT;
-    PsoDesc.RasterizerState.FrontCounterClockwise = TRUE;
-    PsoDesc.RasterizerState.DepthBias = D3D12_DEFAULT_DEPTH_BIAS;
-    PsoDesc.RasterizerState.DepthBiasClamp = D3D12_DEFAULT_DEPTH_BIAS_CLAMP;
-    PsoDesc.RasterizerState.SlopeScaledDepthBias = D3D12_DEFAULT_SLOPE_SCALED_DEPTH_BIAS;
-    PsoDesc.RasterizerState.DepthClipEnable = TRUE;
-    PsoDesc.RasterizerState.MultisampleEnable = FALSE;
-    PsoDesc.RasterizerState.AntialiasedLineEnable = FALSE;
-    PsoDesc.RasterizerState.ForcedSampleCount = 0;
-    PsoDesc.RasterizerState.ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
-
-    PsoDesc.BlendState = {};
-    PsoDesc.BlendState.AlphaToCoverageEnable = FALSE;
-    PsoDesc.BlendState.IndependentBlendEnable = FALSE;
-    PsoDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = 0;
+        Allocator->FreePersistent(StreamedMaterialTables[ModelIndex]);
+    }
+    StreamedMaterialTables[ModelIndex] = Range;
+    return Range;
+}
 
-    PsoDesc.DepthStencilState = {};
-    PsoDesc.DepthStencilState.DepthEnable = TRUE;
-    PsoDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
-    PsoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
-    PsoDesc.DepthStencilState.StencilEnable = FALSE;
-    PsoDesc.NumRenderTargets = 0;
-    PsoDesc.DSVFormat = DXGI_FORMAT_D32_FLOAT;
-    PsoDesc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
+FDX12DescriptorRange FRenderer::AllocateStagingDescriptors(uint32_t Count)
+{
+    FDX12DescriptorAllocator* Allocator = Device ? Device->GetDescriptorAllocator() : nullptr;
+    const FDX12DescriptorRange Range = Allocator ? Allocator->AllocateStaging(Count) : FDX12DescriptorRange{};
+    if (Range.IsValid())
+    {
+        StagingDescriptorRanges.push_back(Range);
+    }
+    return Range;
+}
 
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(OutPipelineState.GetAddressOf())));
-    return true;
+void FRenderer::TrackPendingUploads(FDX12Device* Device)
+{
+    UploadQueue = Device ? Device->GetUploadQueue() : nullptr;
+    PendingUploadFenceValue = UploadQueue ? UploadQueue->GetLastSubmittedFenceValue() : 0;
+    bPendingUploadsWaited = false;
 }
 
-bool FRenderer::CreateShadowResources(
-    FDX12Device* Device,
-    uint32_t& InOutWidth,
-    uint32_t& InOutHeight,
-    Microsoft::WRL::ComPtr<ID3D12Resource>& OutShadowMap,
-    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap>& OutShadowDsvHeap,
-    D3D12_CPU_DESCRIPTOR_HANDLE& OutShadowDsvHandle,
-    D3D12_RESOURCE_STATES& OutShadowState)
+void FRenderer::WaitForPendingUploads(FDX12CommandContext& CmdContext)
 {
-    if (!Device)
+    if (!UploadQueue || PendingUploadFenceValue == 0 || bPendingUploadsWaited)
     {
-        return false;
+        return;
     }
 
-    if (InOutWidth == 0 || InOutHeight == 0)
+    // Queued ahead of this frame's submissions; a no-op once the copies have already landed.
+    UploadQueue->WaitOnGpu(*CmdContext.GetQueue(), PendingUploadFenceValue);
+    if (FDX12CommandContext* ComputeContext = CmdContext.GetAsyncComputeContext())
     {
-        InOutWidth = 4096;
-        InOutHeight = 4096;
+        UploadQueue->WaitOnGpu(*ComputeContext->GetQueue(), PendingUploadFenceValue);
     }
+    UploadQueue->ReleaseCompleted();
+    bPendingUploadsWaited = true;
+}
 
-    D3D12_RESOURCE_DESC Desc = {};
-    Desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-    Desc.Alignment = 0;
-    Desc.Width = InOutWidth;
-    Desc.Height = InOutHeight;
-    Desc.DepthOrArraySize = 1;
-    Desc.MipLevels = 1;
-    Desc.Format = DXGI_FORMAT_R32_TYPELESS;
-    Desc.SampleDesc.Count = 1;
-    Desc.SampleDesc.Quality = 0;
-    Desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
-    Desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
-
-    D3D12_CLEAR_VALUE ClearValue = {};
-    ClearValue.Format = DXGI_FORMAT_D32_FLOAT;
-    ClearValue.DepthStencil.Depth = 1.0f;
-    ClearValue.DepthStencil.Stencil = 0;
-
-    D3D12_HEAP_PROPERTIES HeapProps = {};
-    HeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
-    HeapProps.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-    HeapProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-    HeapProps.CreationNodeMask = 1;
-    HeapProps.VisibleNodeMask = 1;
-
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
-        &HeapProps,
-        D3D12_HEAP_FLAG_NONE,
-        &Desc,
-        D3D12_RESOURCE_STATE_DEPTH_WRITE,
-        &ClearValue,
-        IID_PPV_ARGS(OutShadowMap.ReleaseAndGetAddressOf())));
-
-    if (OutShadowMap)
+bool FRenderer::StartSceneTextureStreaming(FDX12Device* Device, const std::vector<FSceneModelResource>& Models)
+{
+    if (!Device || !TextureLoader)
     {
-        OutShadowMap->SetName(L"ShadowMap");
+        return false;
     }
 
-    D3D12_DESCRIPTOR_HEAP_DESC HeapDesc = {};
-    HeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
-    HeapDesc.NumDescriptors = 1;
-    HeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-    HR_CHECK(Device->GetDevice()->CreateDescriptorHeap(&HeapDesc, IID_PPV_ARGS(OutShadowDsvHeap.ReleaseAndGetAddressOf())));
+    if (!TextureLoader->LoadOrSolidColor(L"", 0xff8080ff, FlatNormalTexture)
+        || !TextureLoader->LoadOrSolidColor(L"", 0xff000000, BlackTexture))
+    {
+        LogError("Failed to create placeholder textures for texture streaming");
+        return false;
+    }
 
-    if (OutShadowDsvHeap)
+    TextureStreamer = std::make_unique<FTextureStreamer>(TextureLoader.get(), Device->GetUploadQueue());
+    if (bStreamTextureMips)
     {
-        OutShadowDsvHeap->SetName(L"ShadowDSVHeap");
+        TextureMipStreamer = std::make_unique<FTextureMipStreamer>(Device, TextureLoader.get(), static_cast<uint64_t>(TextureStreamingBudgetMB) << 20);
     }
 
-    OutShadowState = D3D12_RESOURCE_STATE_DEPTH_WRITE;
+    constexpr bool bUseSRGB[4] = { true, false, false, true };
+    constexpr bool bNormalMap[4] = { false, false, true, false };
+    for (size_t Index = 0; Index < Models.size(); ++Index)
+    {
+        const FSceneModelResource& Model = Models[Index];
+        const std::wstring* Paths[4] = { &Model.BaseColorTexturePath, &Model.MetallicRoughnessTexturePath, &Model.NormalTexturePath, &Model.EmissiveTexturePath };
 
-    D3D12_CPU_DESCRIPTOR_HANDLE DsvHandle = OutShadowDsvHeap->GetCPUDescriptorHandleForHeapStart();
-    D3D12_DEPTH_STENCIL_VIEW_DESC DsvDesc = {};
-    DsvDesc.Format = DXGI_FORMAT_D32_FLOAT;
-    DsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
-    DsvDesc.Flags = D3D12_DSV_FLAG_NONE;
-    Device->GetDevice()->CreateDepthStencilView(OutShadowMap.Get(), &DsvDesc, DsvHandle);
-    OutShadowDsvHandle = DsvHandle;
+        FStreamedTextureSource Sources[4];
+        for (uint32_t Slot = 0; Slot < 4; ++Slot)
+        {
+            Sources[Slot] = TextureMipStreamer
+                ? TextureMipStreamer->Register(static_cast<uint32_t>(Index), Slot, *Paths[Slot], bUseSRGB[Slot], bNormalMap[Slot])
+                : FStreamedTextureSource{ *Paths[Slot] };
+        }
+        TextureStreamer->Enqueue(static_cast<uint32_t>(Index), Sources);
+    }
 
+    LogInfo("Streaming textures for " + std::to_string(Models.size()) + " models");
     return true;
 }
 
-void FRenderer::ConfigureHZBOcclusion(bool bEnabled, ID3D12DescriptorHeap* DescriptorHeap, D3D12_GPU_DESCRIPTOR_HANDLE Handle, uint32_t Width, uint32_t Height, uint32_t MipCount)
+void FRenderer::ApplyStreamedTextures(FDX12CommandContext& CmdContext)
 {
-    bHZBOcclusionEnabled = bEnabled;
-    CullingDescriptorHeap = DescriptorHeap;
-    HZBCullingHandle = Handle;
-    HZBCullingWidth = Width;
-    HZBCullingHeight = Height;
-    HZBCullingMipCount = MipCount;
-}
+    if (TextureLoader)
+    {
+        TextureLoader->ProcessCompletedWork();
+    }
 
-void FRenderer::DispatchGpuCulling(FDX12CommandContext& CmdContext, const FCamera& Camera)
-{
-    ID3D12Resource* IndirectBuffer = GetIndirectCommandBuffer();
-    if (!CullingPipeline || !CullingRootSignature || !IndirectBuffer || !ModelBoundsBuffer || IndirectCommandCount == 0)
+    if (!TextureStreamer && !TextureMipStreamer)
     {
         return;
     }
 
-    const FCamera* CullingCamera = GetCullingCameraOverride();
-    if (!CullingCamera)
+    std::vector<FStreamedModelTextures> Resident;
+    if (TextureStreamer)
     {
-        CullingCamera = &Camera;
+        TextureStreamer->CollectResident(Resident);
     }
-
-    DirectX::XMVECTOR Planes[6] = {};
-    RendererUtils::BuildCameraFrustumPlanes(*CullingCamera, Planes);
-
-    std::array<uint32_t, 46> Constants = {};
-    for (uint32_t PlaneIndex = 0; PlaneIndex < 6; ++PlaneIndex)
+    if (TextureMipStreamer)
     {
-        DirectX::XMFLOAT4 Plane;
-        DirectX::XMStoreFloat4(&Plane, Planes[PlaneIndex]);
-        std::memcpy(Constants.data() + PlaneIndex * 4, &Plane, sizeof(DirectX::XMFLOAT4));
+        for (FStreamedModelTextures& Textures : Resident)
+        {
+            TextureMipStreamer->OnModelResident(Textures);
+        }
+        TextureMipStreamer->CollectSwaps(Resident);
     }
 
-    const DirectX::XMMATRIX ViewProjection = CullingCamera->GetViewMatrix() * CullingCamera->GetProjectionMatrix();
-    DirectX::XMFLOAT4X4 ViewProjectionMatrix = {};
-    DirectX::XMStoreFloat4x4(&ViewProjectionMatrix, ViewProjection);
-    std::memcpy(Constants.data() + 24, &ViewProjectionMatrix, sizeof(DirectX::XMFLOAT4X4));
+    std::vector<uint32_t> ChangedMaterials;
+    for (FStreamedModelTextures& Textures : Resident)
+    {
+        if (Textures.ModelIndex >= SceneModels.size())
+        {
+            continue;
+        }
 
-    Constants[40] = IndirectCommandCount;
-    Constants[41] = bHZBOcclusionEnabled ? 1u : 0u;
-    Constants[42] = HZBCullingMipCount;
-    Constants[43] = HZBCullingWidth;
-    Constants[44] = HZBCullingHeight;
-    Constants[45] = bEnableGpuDebugPrint ? 1u : 0u;
+        const D3D12_GPU_DESCRIPTOR_HANDLE PlaceholderTable = SceneModels[Textures.ModelIndex].TextureHandle;
+        OnSceneTexturesResident(Textures);
+        ChangedMaterials.push_back(Textures.ModelIndex);
+        const D3D12_GPU_DESCRIPTOR_HANDLE ResidentTable = SceneModels[Textures.ModelIndex].TextureHandle;
 
-    ID3D12GraphicsCommandList* CommandList = CmdContext.GetCommandList();
-    FScopedPixEvent CullingEvent(CommandList, L"GpuCulling");
+        // Without bindless materials every indirect range binds exactly one model's table.
+        for (FIndirectDrawRange& Range : IndirectDrawRanges)
+        {
+            if (Range.TextureHandle.ptr != 0 && Range.TextureHandle.ptr == PlaceholderTable.ptr)
+            {
+                Range.TextureHandle = ResidentTable;
+            }
+        }
+    }
 
-    D3D12_RESOURCE_STATES& IndirectState = GetIndirectCommandState();
-    if (IndirectState != D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+    // Bindless shaders find the resident table through the material's descriptor index.
+    FDX12UploadRing* UploadRing = CmdContext.GetUploadRing();
+    constexpr uint64_t MaterialUpdateBytes = sizeof(uint32_t) + sizeof(FSceneMaterialData);
+    const uint64_t MaterialBytes = MaterialUpdateBytes * ChangedMaterials.size();
+    const FDX12UploadAllocation Upload = UploadRing && SceneMaterialBuffer && !ChangedMaterials.empty()
+        ? UploadRing->Allocate(MaterialBytes, 16)
+        : FDX12UploadAllocation{};
+    if (Upload.IsValid())
     {
-        D3D12_RESOURCE_BARRIER Barrier = {};
-        Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-        Barrier.Transition.pResource = IndirectBuffer;
-        Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-        Barrier.Transition.StateBefore = IndirectState;
-        Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-        CommandList->ResourceBarrier(1, &Barrier);
-        IndirectState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-    }
+        for (size_t ChangedIndex = 0; ChangedIndex < ChangedMaterials.size(); ++ChangedIndex)
+        {
+            const uint32_t MaterialIndex = ChangedMaterials[ChangedIndex];
+            const FSceneMaterialData Material = RendererUtils::BuildSceneMaterialData(SceneModels[MaterialIndex]);
+            uint8_t* MaterialUpdate = Upload.CpuAddress + MaterialUpdateBytes * ChangedIndex;
+            std::memcpy(MaterialUpdate, &MaterialIndex, sizeof(MaterialIndex));
+            std::memcpy(MaterialUpdate + sizeof(MaterialIndex), &Material, sizeof(Material));
+        }
 
-    CommandList->SetPipelineState(CullingPipeline.Get());
-    CommandList->SetComputeRootSignature(CullingRootSignature.Get());
-    CommandList->SetComputeRoot32BitConstants(0, static_cast<UINT>(Constants.size()), Constants.data(), 0);
-    CommandList->SetComputeRootShaderResourceView(1, ModelBoundsBuffer->GetGPUVirtualAddress());
-    CommandList->SetComputeRootUnorderedAccessView(2, IndirectBuffer->GetGPUVirtualAddress());
-    CommandList->SetComputeRootUnorderedAccessView(3, GpuDebugPrintBuffer->GetGPUVirtualAddress());
-    CommandList->SetComputeRootUnorderedAccessView(4, GpuDebugPrintStatsBuffer->GetGPUVirtualAddress());
-    if (CullingDescriptorHeap)
+        ScatterSceneEntries(CmdContext, SceneMaterialBuffer.Get(), SceneDataBufferState, SceneDataBufferState,
+            Upload, ChangedMaterials, sizeof(FSceneMaterialData));
+    }
+    else if (!ChangedMaterials.empty() && SceneMaterialBuffer)
     {
-        ID3D12DescriptorHeap* Heaps[] = { CullingDescriptorHeap.Get() };
-        CommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
-        CommandList->SetComputeRootDescriptorTable(5, HZBCullingHandle);
+        LogWarning("Failed to allocate upload space for streamed scene materials");
     }
 
-    const uint32_t DispatchCount = (IndirectCommandCount + 63) / 64;
-    CommandList->Dispatch(DispatchCount, 1, 1);
-
-    D3D12_RESOURCE_BARRIER Barrier = {};
-    Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-    Barrier.Transition.pResource = IndirectBuffer;
-    Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-    Barrier.Transition.StateBefore = IndirectState;
-    Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT;
-    CommandList->ResourceBarrier(1, &Barrier);
-    IndirectState = D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT;
+    if (TextureStreamer && TextureStreamer->IsIdle())
+    {
+        const FTextureCacheStats CacheStats = FTextureLoader::GetCacheStats();
+        LogInfo("Scene texture streaming finished; texture cache holds " + std::to_string(CacheStats.EntryCount) + " textures, "
+            + std::to_string(CacheStats.ResidentBytes >> 20) + " of " + std::to_string(CacheStats.BudgetBytes >> 20) + " MB ("
+            + std::to_string(CacheStats.Hits) + " hits, " + std::to_string(CacheStats.Misses) + " misses, "
+            + std::to_string(CacheStats.Evictions) + " evictions)");
+        FDX12DirectStorage::LogThroughput("Scene load");
+        TextureStreamer.reset();
+    }
 }
 
 void FRenderer::PrepareGpuDebugPrint(FDX12CommandContext& CmdContext)
 {
-    if (!bEnableGpuDebugPrint || !GpuDebugPrintBuffer || !GpuDebugPrintUpload || !GpuDebugPrintStatsBuffer || !GpuDebugPrintStatsUpload)
+    if (!IsGpuCullingStatsEnabled() || !GpuDebugPrintBuffer || !GpuDebugPrintStatsBuffer)
+    {
+        return;
+    }
+
+    if (!IsSecondaryView())
+    {
+        ReadGpuCullingStats();
+    }
+
+    // Zeroed source for the entry counter (first word) and the stats words.
+    FDX12UploadRing* UploadRing = CmdContext.GetUploadRing();
+    const FDX12UploadAllocation ClearValues = UploadRing ? UploadRing->Allocate(GpuDebugPrintStatsSize, sizeof(uint32_t)) : FDX12UploadAllocation{};
+    if (!ClearValues.IsValid())
     {
         return;
     }
+    std::memset(ClearValues.CpuAddress, 0, GpuDebugPrintStatsSize);
 
     ID3D12GraphicsCommandList* CommandList = CmdContext.GetCommandList();
     if (GpuDebugPrintState != D3D12_RESOURCE_STATE_COPY_DEST)
@@ -491,7 +2199,7 @@ void FRenderer::PrepareGpuDebugPrint(FDX12CommandContext& CmdContext)
         GpuDebugPrintState = D3D12_RESOURCE_STATE_COPY_DEST;
     }
 
-    CommandList->CopyBufferRegion(GpuDebugPrintBuffer.Get(), 0, GpuDebugPrintUpload.Get(), 0, sizeof(uint32_t));
+    CommandList->CopyBufferRegion(GpuDebugPrintBuffer.Get(), 0, ClearValues.Resource, ClearValues.Offset, sizeof(uint32_t));
 
     D3D12_RESOURCE_BARRIER Barrier = {};
     Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -514,7 +2222,7 @@ void FRenderer::PrepareGpuDebugPrint(FDX12CommandContext& CmdContext)
         GpuDebugPrintStatsState = D3D12_RESOURCE_STATE_COPY_DEST;
     }
 
-    CommandList->CopyBufferRegion(GpuDebugPrintStatsBuffer.Get(), 0, GpuDebugPrintStatsUpload.Get(), 0, sizeof(uint32_t) * 2);
+    CommandList->CopyBufferRegion(GpuDebugPrintStatsBuffer.Get(), 0, ClearValues.Resource, ClearValues.Offset, GpuDebugPrintStatsSize);
 
     D3D12_RESOURCE_BARRIER StatsBarrier = {};
     StatsBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -526,6 +2234,91 @@ void FRenderer::PrepareGpuDebugPrint(FDX12CommandContext& CmdContext)
     GpuDebugPrintStatsState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
 }
 
+void FRenderer::ReadGpuCullingStats()
+{
+    if (GpuCullingStatsReadbacks.size() != GetFramesInFlight())
+    {
+        GpuCullingStatsReadbacks.assign(GetFramesInFlight(), nullptr);
+        GpuCullingStatsPending.assign(GetFramesInFlight(), false);
+
+        CD3DX12_HEAP_PROPERTIES ReadbackHeap(D3D12_HEAP_TYPE_READBACK);
+        CD3DX12_RESOURCE_DESC ReadbackDesc = CD3DX12_RESOURCE_DESC::Buffer(GpuDebugPrintStatsSize);
+        for (uint32_t FrameIndex = 0; FrameIndex < GetFramesInFlight(); ++FrameIndex)
+        {
+            if (FAILED(Device->CreateCommittedResource(
+                EGpuMemoryCategory::Readback,
+                &ReadbackHeap,
+                D3D12_HEAP_FLAG_NONE,
+                &ReadbackDesc,
+                D3D12_RESOURCE_STATE_COPY_DEST,
+                nullptr,
+                IID_PPV_ARGS(GpuCullingStatsReadbacks[FrameIndex].ReleaseAndGetAddressOf()))))
+            {
+                LogWarning("Failed to create GPU culling stats readback");
+                GpuCullingStatsReadbacks.clear();
+                GpuCullingStatsPending.clear();
+                return;
+            }
+            GpuCullingStatsReadbacks[FrameIndex]->SetName((L"GpuCullingStatsReadback_Frame" + std::to_wstring(FrameIndex)).c_str());
+        }
+        return;
+    }
+
+    // The slot's previous frame has retired by the time it is reused.
+    if (CurrentFrameIndex >= GpuCullingStatsPending.size() || !GpuCullingStatsPending[CurrentFrameIndex])
+    {
+        return;
+    }
+    GpuCullingStatsPending[CurrentFrameIndex] = false;
+
+    const D3D12_RANGE ReadRange = { 0, static_cast<SIZE_T>(GpuDebugPrintStatsSize) };
+    void* MappedData = nullptr;
+    if (FAILED(GpuCullingStatsReadbacks[CurrentFrameIndex]->Map(0, &ReadRange, &MappedData)) || !MappedData)
+    {
+        return;
+    }
+
+    const uint32_t* Counters = static_cast<const uint32_t*>(MappedData);
+
+    GpuCullingStats.FrustumCulled = Counters[0];
+    GpuCullingStats.OcclusionCulled = Counters[1];
+    GpuCullingStats.DrawCommands = Counters[2];
+    GpuCullingStats.SmallCulled = Counters[3];
+    GpuCullingStats.ModelsTested = Counters[4];
+    GpuCullingStats.TrianglesSubmitted = Counters[5];
+    bHasGpuCullingStats = true;
+
+    const D3D12_RANGE EmptyRange = { 0, 0 };
+    GpuCullingStatsReadbacks[CurrentFrameIndex]->Unmap(0, &EmptyRange);
+}
+
+void FRenderer::AddGpuCullingStatsReadbackPass(FRenderGraph& Graph, const FGpuDrivenBuffers& GpuBuffers)
+{
+    struct FCullingStatsReadbackPassData
+    {
+        bool bEnabled = false;
+    };
+
+    Graph.AddPass<FCullingStatsReadbackPassData>("GpuCullingStatsReadback", [this, GpuBuffers](FCullingStatsReadbackPassData& Data, FRGPassBuilder& Builder)
+    {
+        Data.bEnabled = IsGpuCullingStatsEnabled() && !IsSecondaryView() && GpuBuffers.DebugPrintStats && CurrentFrameIndex < GpuCullingStatsReadbacks.size();
+        if (Data.bEnabled)
+        {
+            Builder.ReadBuffer(GpuBuffers.DebugPrintStats, D3D12_RESOURCE_STATE_COPY_SOURCE);
+            Builder.KeepAlive();
+        }
+    }, [this](const FCullingStatsReadbackPassData& Data, FDX12CommandContext& Cmd)
+    {
+        if (!Data.bEnabled)
+        {
+            return;
+        }
+
+        Cmd.GetCommandList()->CopyBufferRegion(GpuCullingStatsReadbacks[CurrentFrameIndex].Get(), 0, GpuDebugPrintStatsBuffer.Get(), 0, GpuDebugPrintStatsSize);
+        GpuCullingStatsPending[CurrentFrameIndex] = true;
+    });
+}
+
 bool FRenderer::CreateGpuDebugPrintResources(FDX12Device* Device)
 {
     if (!Device)
@@ -545,7 +2338,13 @@ bool FRenderer::CreateGpuDebugPrintResources(FDX12Device* Device)
     const uint32_t AtlasHeight = 512;
 
     FDebugPrintFontResources FontResources;
-    if (!CreateDebugPrintFontResources(Device, FontPath, FontSize, AtlasWidth, AtlasHeight, FontResources))
+    if (InheritedResources && InheritedResources->DebugPrintFont.FontTexture)
+    {
+        FontResources = InheritedResources->DebugPrintFont;
+        FDX12MemoryTracker::Get().TransferOwnership(FontResources.FontTexture.Get(), GetMemoryOwnerId());
+        FDX12MemoryTracker::Get().TransferOwnership(FontResources.GlyphBuffer.Get(), GetMemoryOwnerId());
+    }
+    else if (!CreateDebugPrintFontResources(Device, FontPath, FontSize, AtlasWidth, AtlasHeight, FontResources))
     {
         LogError("Failed to create GPU debug print font resources.");
         return false;
@@ -614,7 +2413,7 @@ bool FRenderer::CreateGpuDebugPrintResources(FDX12Device* Device)
     StatsSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
     StatsSrvDesc.Format = DXGI_FORMAT_R32_TYPELESS;
     StatsSrvDesc.Buffer.FirstElement = 0;
-    StatsSrvDesc.Buffer.NumElements = 2;
+    StatsSrvDesc.Buffer.NumElements = GpuDebugPrintStatsCount;
     StatsSrvDesc.Buffer.StructureByteStride = 0;
     StatsSrvDesc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_RAW;
     Device->GetDevice()->CreateShaderResourceView(GpuDebugPrintStatsBuffer.Get(), &StatsSrvDesc, CpuHandle);
@@ -670,7 +2469,7 @@ bool FRenderer::CreateGpuDebugPrintPipeline(FDX12Device* Device, DXGI_FORMAT Bac
     ComPtr<ID3DBlob> SerializedSig;
     ComPtr<ID3DBlob> ErrorBlob;
     HR_CHECK(D3D12SerializeRootSignature(&RootDesc, D3D_ROOT_SIGNATURE_VERSION_1, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf()));
-    HR_CHECK(Device->GetDevice()->CreateRootSignature(0, SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), IID_PPV_ARGS(GpuDebugPrintRootSignature.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), GpuDebugPrintRootSignature.ReleaseAndGetAddressOf()));
 
     FShaderCompiler Compiler;
     std::vector<uint8_t> VSByteCode;
@@ -719,7 +2518,7 @@ bool FRenderer::CreateGpuDebugPrintPipeline(FDX12Device* Device, DXGI_FORMAT Bac
     PsoDesc.DepthStencilState.DepthEnable = FALSE;
     PsoDesc.DepthStencilState.StencilEnable = FALSE;
 
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(GpuDebugPrintPipeline.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateGraphicsPipelineState(PsoDesc, GpuDebugPrintPipeline.ReleaseAndGetAddressOf()));
     return true;
 }
 
@@ -758,7 +2557,7 @@ bool FRenderer::CreateGpuDebugPrintStatsPipeline(FDX12Device* Device)
     ComPtr<ID3DBlob> SerializedSig;
     ComPtr<ID3DBlob> ErrorBlob;
     HR_CHECK(D3D12SerializeRootSignature(&RootDesc, D3D_ROOT_SIGNATURE_VERSION_1, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf()));
-    HR_CHECK(Device->GetDevice()->CreateRootSignature(0, SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), IID_PPV_ARGS(GpuDebugPrintStatsRootSignature.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), GpuDebugPrintStatsRootSignature.ReleaseAndGetAddressOf()));
 
     FShaderCompiler Compiler;
     std::vector<uint8_t> CsByteCode;
@@ -774,7 +2573,7 @@ bool FRenderer::CreateGpuDebugPrintStatsPipeline(FDX12Device* Device)
     D3D12_COMPUTE_PIPELINE_STATE_DESC CsDesc = {};
     CsDesc.pRootSignature = GpuDebugPrintStatsRootSignature.Get();
     CsDesc.CS = { CsByteCode.data(), CsByteCode.size() };
-    HR_CHECK(Device->GetDevice()->CreateComputePipelineState(&CsDesc, IID_PPV_ARGS(GpuDebugPrintStatsPipeline.GetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateComputePipelineState(CsDesc, GpuDebugPrintStatsPipeline.ReleaseAndGetAddressOf()));
     return true;
 }
 
@@ -788,30 +2587,6 @@ void FRenderer::DispatchGpuDebugPrintStats(FDX12CommandContext& CmdContext)
     ID3D12GraphicsCommandList* CommandList = CmdContext.GetCommandList();
     FScopedPixEvent DebugStatsEvent(CommandList, L"GpuDebugPrintStats");
 
-    if (GpuDebugPrintStatsState != D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE)
-    {
-        D3D12_RESOURCE_BARRIER Barrier = {};
-        Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-        Barrier.Transition.pResource = GpuDebugPrintStatsBuffer.Get();
-        Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-        Barrier.Transition.StateBefore = GpuDebugPrintStatsState;
-        Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
-        CommandList->ResourceBarrier(1, &Barrier);
-        GpuDebugPrintStatsState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
-    }
-
-    if (GpuDebugPrintState != D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
-    {
-        D3D12_RESOURCE_BARRIER Barrier = {};
-        Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-        Barrier.Transition.pResource = GpuDebugPrintBuffer.Get();
-        Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-        Barrier.Transition.StateBefore = GpuDebugPrintState;
-        Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-        CommandList->ResourceBarrier(1, &Barrier);
-        GpuDebugPrintState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-    }
-
     ID3D12DescriptorHeap* Heaps[] = { GpuDebugPrintDescriptorHeap.Get() };
     CommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
     CommandList->SetPipelineState(GpuDebugPrintStatsPipeline.Get());
@@ -831,18 +2606,6 @@ void FRenderer::RenderGpuDebugPrint(FDX12CommandContext& CmdContext, const D3D12
     ID3D12GraphicsCommandList* CommandList = CmdContext.GetCommandList();
     FScopedPixEvent DebugEvent(CommandList, L"GpuDebugPrint");
 
-    if (GpuDebugPrintState != D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE)
-    {
-        D3D12_RESOURCE_BARRIER Barrier = {};
-        Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-        Barrier.Transition.pResource = GpuDebugPrintBuffer.Get();
-        Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-        Barrier.Transition.StateBefore = GpuDebugPrintState;
-        Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
-        CommandList->ResourceBarrier(1, &Barrier);
-        GpuDebugPrintState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
-    }
-
     CmdContext.SetRenderTarget(OutputHandle, nullptr);
 
     struct FDebugPrintConstants
@@ -869,16 +2632,4 @@ void FRenderer::RenderGpuDebugPrint(FDX12CommandContext& CmdContext, const D3D12
     CommandList->SetGraphicsRoot32BitConstants(0, sizeof(Constants) / sizeof(uint32_t), &Constants, 0);
     CommandList->SetGraphicsRootDescriptorTable(1, GpuDebugPrintGlyphHandle);
     CommandList->DrawInstanced(6 * GpuDebugPrintMaxEntries, 1, 0, 0);
-
-    if (GpuDebugPrintState != D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
-    {
-        D3D12_RESOURCE_BARRIER Barrier = {};
-        Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-        Barrier.Transition.pResource = GpuDebugPrintBuffer.Get();
-        Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-        Barrier.Transition.StateBefore = GpuDebugPrintState;
-        Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-        CommandList->ResourceBarrier(1, &Barrier);
-        GpuDebugPrintState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-    }
 }
@@ -3,20 +3,41 @@
 #include <d3d12.h>
 #include <DirectXMath.h>
 #include <wrl.h>
+#include <array>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "DebugPrintFont.h"
+#include "DrawList.h"
+#include "EnvironmentLighting.h"
 #include "RendererUtils.h"
+#include "RenderGraph.h"
+#include "ShadowCascades.h"
+#include "SkyAtmosphere.h"
+#include "VariableRateShading.h"
+#include "../Scene/SceneBvh.h"
+#include "../Scene/Transform.h"
+#include "../RHI/DX12DescriptorAllocator.h"
+#include "../RHI/DX12MemoryTracker.h"
 
+struct FDX12UploadAllocation;
 struct FSceneModelResource;
+struct FStreamedModelTextures;
 class FTextureLoader;
+class FTextureStreamer;
+class FTextureMipStreamer;
+struct FRendererPersistentResources;
 
 struct FRendererOptions
 {
     std::wstring SceneFilePath = L"Assets/Scenes/Scene.json";
     bool bUseDepthPrepass = true;
+    // Alpha-masked models from which the deferred renderer runs its depth prepass even when
+    // bUseDepthPrepass is off, so the base pass can test depth EQUAL instead of clipping; 0 never.
+    uint32_t MaskedDepthPrepassThreshold = 16;
     bool bEnableShadows = true;
     float ShadowBias = 0.0f;
     bool bEnableTonemap = true;
@@ -25,6 +46,8 @@ struct FRendererOptions
     float TonemapGamma = 1.0f;
     bool bEnableCas = true;
     float CasSharpness = 0.5f;
+    // Tonemap and CAS in one compute dispatch when TAA and CAS both run; see Shaders/FusedPost.hlsl.
+    bool bEnableFusedPost = true;
     bool bEnableAutoExposure = false;
     float AutoExposureKey = 0.18f;
     float AutoExposureMin = 0.1f;
@@ -37,15 +60,98 @@ struct FRendererOptions
     bool bLogResourceBarriers = false;
     bool bEnableGraphDump = false;
     bool bEnableGpuTiming = false;
+    // Pipeline statistics per graphics pass and GPU culling counters, taken on GPU-timed frames.
+    bool bEnablePipelineStatistics = false;
+    bool bEnableParallelRecording = true;
     bool bEnableHZB = true;
     bool bEnableIndirectDraw = false;
     bool bEnableGpuDebugPrint = false;
+    // Only takes effect when the device supports bindless resources.
+    bool bEnableBindless = true;
+    // Vertex cache, overdraw and vertex fetch reordering of scene meshes at load.
+    bool bOptimizeMeshes = true;
+    // Meshlet-culled amplification/mesh shader base pass; only takes effect when the device supports mesh shaders.
+    bool bEnableMeshShaders = true;
+    // Deferred lighting in compute over classified screen tiles; see Shaders/TiledDeferredLighting.hlsl.
+    bool bEnableTiledLighting = true;
+    // Simplified index lists per primitive, picked per draw by GPU culling from their projected error.
+    bool bGenerateLods = true;
+    // Log2 of the projected LOD error, in pixels, tolerated before switching to a coarser level.
+    float LodBias = 0.0f;
+    // GPU culling drops models whose projected bounds span fewer pixels than this on their larger
+    // side, of the camera view and of the shadow map respectively; 0 disables.
+    float MinScreenCoverage = 1.0f;
+    float ShadowMinScreenCoverage = 2.0f;
+    // Draw the scene with placeholder materials while its textures load in the background.
+    bool bStreamSceneTextures = true;
+    // Streamed maps with a DDS chain load their smallest mips first and stream finer ones by
+    // on-screen size within the video memory budget; see FTextureMipStreamer.
+    bool bStreamTextureMips = true;
+    // Caps the streamed texture budget; 0 leaves it to the budget DXGI reports.
+    uint32_t TextureStreamingBudgetMB = 0;
+    // Textures FTextureLoader keeps for reuse across loads, shared by every renderer.
+    uint32_t TextureCacheBudgetMB = 1024;
+    // Coarse shading of flat and fast-moving screen tiles in the geometry passes; only takes
+    // effect when the device supports variable rate shading tier 2.
+    EShadingRateQuality ShadingRateQuality = EShadingRateQuality::Balanced;
+    // Tints the screen by the shading rate of each tile.
+    bool bShowShadingRate = false;
+    // What the renderer being replaced by a scene reload captured, for this one to adopt; see
+    // FRenderer::CapturePersistentResources.
+    std::shared_ptr<const FRendererPersistentResources> PersistentResources;
 };
 
 class FDX12Device;
 class FDX12CommandContext;
+class FDX12UploadQueue;
 class FCamera;
 
+// Dispatches of Shaders/CullIndirectArgs.hlsl. Two-phase occlusion culling runs First before the
+// depth prepass and Second after the HZB is built from its depth; Single tests the bound HZB once.
+enum class EGpuCullingPhase : uint32_t
+{
+    Single,
+    First,
+    Second,
+};
+
+// One view of FRenderer::RenderViews: the camera and the render target it draws to, the size of
+// the renderer's output and in RENDER_TARGET.
+struct FRenderView
+{
+    const FCamera* Camera = nullptr;
+    ID3D12Resource* Target = nullptr;
+    D3D12_CPU_DESCRIPTOR_HANDLE RtvHandle{};
+};
+
+/**
+ * The objects of a renderer that depend on the device, the output size and global assets but not
+ * on the scene: its size-dependent targets, the environment lighting, the BRDF LUT and the GPU
+ * debug print font. A scene reload initializes the new renderer with those of the old one, which
+ * keeps rendering meanwhile, so only scene geometry, materials and textures are loaded again.
+ * Pipelines and root signatures need no hand-over; FDX12PipelineCache returns the existing ones.
+ */
+struct FRendererPersistentResources
+{
+    struct FTarget
+    {
+        std::string Name;
+        Microsoft::WRL::ComPtr<ID3D12Resource> Resource;
+        // The capturing renderer's tracked state, read by CompletePersistentResourceHandoff.
+        const D3D12_RESOURCE_STATES* State = nullptr;
+    };
+
+    std::vector<FTarget> Targets;
+    std::wstring EnvironmentPath;
+    Microsoft::WRL::ComPtr<ID3D12Resource> EnvironmentCube;
+    FEnvironmentLighting EnvironmentLighting;
+    float EnvironmentMipCount = 1.0f;
+    std::wstring BrdfLutPath;
+    Microsoft::WRL::ComPtr<ID3D12Resource> BrdfLut;
+    // FontTexture is null when the capturing renderer had no GPU debug print.
+    FDebugPrintFontResources DebugPrintFont;
+};
+
 class FRenderer
 {
 public:
@@ -61,28 +167,49 @@ public:
     static constexpr uint32_t GpuDebugPrintHeaderSize = sizeof(uint32_t);
     static constexpr uint32_t GpuDebugPrintEntryStride = sizeof(FGpuDebugPrintEntry);
     static constexpr uint64_t GpuDebugPrintBufferSize = GpuDebugPrintHeaderSize + static_cast<uint64_t>(GpuDebugPrintMaxEntries) * GpuDebugPrintEntryStride;
+    // Frustum-culled models, occluded models, indirect commands left after compaction and models
+    // culled for covering too few pixels.
+    // Culling counters in CullIndirectArgs.hlsl order; see FGpuCullingStats.
+    static constexpr uint32_t GpuDebugPrintStatsCount = 6;
+    static constexpr uint64_t GpuDebugPrintStatsSize = sizeof(uint32_t) * GpuDebugPrintStatsCount;
 
     virtual ~FRenderer();
 
     virtual bool Initialize(FDX12Device* Device, uint32_t Width, uint32_t Height, DXGI_FORMAT BackBufferFormat, const FRendererOptions& Options) = 0;
     virtual void RenderFrame(FDX12CommandContext& CmdContext, const D3D12_CPU_DESCRIPTOR_HANDLE& RtvHandle, const FCamera& Camera, float DeltaTime) = 0;
-    virtual void OnFrameFenceSignaled(uint32_t FrameIndex, uint64_t FenceValue) {}
+    /**
+     * Renders several views in one frame, such as the faces of a cube capture or split-screen
+     * halves, recorded back to back on CmdContext. Uploads, streamed textures, transform updates
+     * and the shadow map are done once, with every cascade fitted around all views, so views after
+     * the first only cull, shade and post-process. While more than one view renders, passes that
+     * reuse the previous frame's picture (TAA, variable rate shading, single-phase HZB occlusion)
+     * are off. Targets are drawn over, not cleared; views share the split depths of the first.
+     */
+    void RenderViews(FDX12CommandContext& CmdContext, const std::vector<FRenderView>& Views, float DeltaTime);
+    // Overrides must call this; streamed textures replaced this frame retire behind FenceValue.
+    virtual void OnFrameFenceSignaled(uint32_t FrameIndex, uint64_t FenceValue);
 
     virtual void SetDepthPrepassEnabled(bool bEnabled) { bDepthPrepassEnabled = bEnabled; }
     virtual bool IsDepthPrepassEnabled() const { return bDepthPrepassEnabled; }
 
     void SetFrameIndex(uint32_t FrameIndex);
     uint32_t GetFrameIndex() const { return CurrentFrameIndex; }
+    // The back buffer RenderFrame draws to, in RENDER_TARGET; renderers that read the finished
+    // picture import it and leave it in that state.
+    void SetOutputTarget(ID3D12Resource* Target) { OutputTarget = Target; }
 
     const D3D12_CPU_DESCRIPTOR_HANDLE& GetDSVHandle() const;
     ID3D12Resource* GetDepthBuffer() const;
     D3D12_RESOURCE_STATES& GetDepthBufferState();
-    ID3D12Resource* GetSceneConstantBuffer() const;
-    D3D12_GPU_VIRTUAL_ADDRESS GetSceneConstantBufferAddress() const;
-    uint8_t* GetSceneConstantBufferMapped() const;
     ID3D12Resource* GetIndirectCommandBuffer() const;
     D3D12_RESOURCE_STATES& GetIndirectCommandState();
+    ID3D12Resource* GetVisibleInstanceBuffer() const;
+    D3D12_RESOURCE_STATES& GetVisibleInstanceState();
+    ID3D12Resource* GetCompactedCommandBuffer() const;
+    D3D12_RESOURCE_STATES& GetCompactedCommandState();
     uint32_t GetFramesInFlight() const { return FramesInFlight; }
+    // Tags the GPU allocations made while initializing and rendering, to find those that outlive the renderer.
+    uint32_t GetMemoryOwnerId() const { return MemoryOwnerId; }
 
     DirectX::XMFLOAT3 GetSceneCenter() const { return SceneCenter; }
     float GetSceneRadius() const { return SceneRadius; }
@@ -100,39 +227,274 @@ public:
     const FCamera* GetCullingCameraOverride() const { return CullingCameraOverride; }
     void SetIndirectDrawEnabled(bool bEnabled) { bEnableIndirectDraw = bEnabled; }
     bool IsIndirectDrawEnabled() const { return bEnableIndirectDraw; }
+    bool IsBindlessMaterialsEnabled() const { return bBindlessMaterials; }
     virtual const std::vector<FSceneModelResource>* GetSceneModels() const { return &SceneModels; }
     virtual bool GetSceneModelStats(size_t& OutTotal, size_t& OutCulled) const;
+    // Triangles of the frustum-visible models at full detail and at the LODs GPU culling selects
+    // for Camera; the two match unless indirect draws are enabled.
+    bool GetSceneTriangleStats(const FCamera& Camera, uint64_t& OutFullDetail, uint64_t& OutDrawn) const;
+    // Counters of the camera view's GPU culling, read back once the frame that wrote them retired.
+    // Models culled by the first of two phases are not tested again until the second.
+    struct FGpuCullingStats
+    {
+        uint32_t ModelsTested = 0;
+        uint32_t FrustumCulled = 0;
+        uint32_t OcclusionCulled = 0;
+        uint32_t SmallCulled = 0;
+        uint32_t DrawCommands = 0;
+        uint32_t TrianglesSubmitted = 0;
+    };
+    bool GetGpuCullingStats(FGpuCullingStats& OutStats) const;
+    void SetLodBias(float Bias) { LodBias = Bias; }
+    float GetLodBias() const { return LodBias; }
+    void SetShadingRateQuality(EShadingRateQuality Quality) { VariableRateShading.SetQuality(Quality); }
+    void SetShadingRateOverlayEnabled(bool bEnabled) { VariableRateShading.SetOverlayEnabled(bEnabled); }
+    bool IsVariableRateShadingSupported() const { return VariableRateShading.GetRateImage() != nullptr; }
+    // Fraction of the output resolution the scene renders at. Renderers that can upscale to the
+    // output apply it; the others keep rendering at full resolution.
+    void SetResolutionScale(float Scale) { ResolutionScale = Scale; }
+    // Size the scene rendered at in the last frame.
+    uint32_t GetRenderWidth() const { return static_cast<uint32_t>(RenderViewport.Width); }
+    uint32_t GetRenderHeight() const { return static_cast<uint32_t>(RenderViewport.Height); }
+    // Models whose bounds the world-space ray enters, nearest first. Bounds are conservative, so
+    // an empty result means nothing is under the ray while a hit still needs the ObjectId pass.
+    void RaycastSceneModels(const DirectX::XMFLOAT3& Origin, const DirectX::XMFLOAT3& Direction, std::vector<FBvhRayHit>& OutHits) const;
+    // Moves scene models: change the local matrix of a model's TransformNode; the renderer applies
+    // the change at the start of the next frame.
+    FTransformHierarchy& GetSceneTransforms() { return SceneTransforms; }
     virtual void RequestObjectIdReadback(uint32_t X, uint32_t Y);
     virtual bool ConsumeObjectIdReadback(uint32_t& OutObjectId);
 
+    // Re-runs the pipeline builders registered for any of the normalized shader sources. Call at a
+    // frame boundary; returns the number of builders that succeeded.
+    uint32_t RebuildShaderPipelines(const std::vector<std::wstring>& AffectedSources);
+
+    // Persistent resources of this initialized renderer for the one replacing it, which shares
+    // them until this one is destroyed. Call between frames on the thread that renders.
+    std::shared_ptr<FRendererPersistentResources> CapturePersistentResources() const;
+    // Call with the GPU idle and the renderer that captured Options.PersistentResources still
+    // alive, before rendering the first frame: the adopted targets take over the states that
+    // renderer left them in, and the captured objects this one did not adopt are released.
+    void CompletePersistentResourceHandoff();
+
 protected:
     void InitializeCommonSettings(uint32_t Width, uint32_t Height, const FRendererOptions& Options);
+    // Sets RenderViewport and RenderScissorRect to Scale of the output size, at the top left
+    // corner of the full-size targets.
+    void UpdateRenderViewport(float Scale);
+    // Builds the culling structures and the transform node to model map. Call once the model list is final.
+    void FinalizeSceneModels();
+    // Builds SceneBvh and SceneBoundsSoA over the world bounds of SceneModels.
+    void BuildSceneBvh();
+    // Applies the transform changes made since the last frame: moves the affected models, refits
+    // the culling structures and copies their object and culling data to the GPU buffers.
+    void UpdateSceneTransforms(FDX12CommandContext& CmdContext);
     bool CreateShadowPipeline(FDX12Device* Device, ID3D12RootSignature* RootSignature, Microsoft::WRL::ComPtr<ID3D12PipelineState>& OutPipelineState);
+    // Creates the shadow map array, one slice and depth stencil view per cascade, and drops the
+    // cascades cached in a previous one.
     bool CreateShadowResources(
         FDX12Device* Device,
         uint32_t& InOutWidth,
         uint32_t& InOutHeight,
         Microsoft::WRL::ComPtr<ID3D12Resource>& OutShadowMap,
         Microsoft::WRL::ComPtr<ID3D12DescriptorHeap>& OutShadowDsvHeap,
-        D3D12_CPU_DESCRIPTOR_HANDLE& OutShadowDsvHandle,
+        std::array<D3D12_CPU_DESCRIPTOR_HANDLE, FShadowCascades::CascadeCount>& OutShadowDsvHandles,
         D3D12_RESOURCE_STATES& OutShadowState);
-    void DispatchGpuCulling(FDX12CommandContext& CmdContext, const FCamera& Camera);
+    // Fits the shadow cascades to Camera and returns those to render this frame. Without shadows
+    // every cascade is dropped, since nothing keeps their cached slices current meanwhile.
+    uint32_t UpdateShadowCascades(const FCamera& Camera, bool bRenderShadows);
+    // RenderViews is rendering more than one view this frame.
+    bool IsRenderingMultipleViews() const { return MultiViewCameras.size() > 1; }
+    // A view after the first of RenderViews, whose frame updates and shadow map are already done.
+    bool IsSecondaryView() const { return MultiViewIndex > 0; }
+    // Buffers shared by GPU culling, indirect draws and GPU debug print, imported so the graph
+    // owns their transitions. Handles are invalid for buffers that were not created.
+    struct FGpuDrivenBuffers
+    {
+        FRGResourceHandle IndirectCommands;
+        FRGResourceHandle VisibleInstances;
+        FRGResourceHandle ModelBounds;
+        FRGResourceHandle DebugPrint;
+        FRGResourceHandle DebugPrintStats;
+        FRGResourceHandle InstanceVisibility;
+        FRGResourceHandle CompactedCommands;
+        FRGResourceHandle ShadowIndirectCommands;
+        FRGResourceHandle ShadowVisibleInstances;
+        FRGResourceHandle ShadowCompactedCommands;
+    };
+
+    FGpuDrivenBuffers ImportGpuDrivenBuffers(FRenderGraph& Graph);
+    // Rebuild must recreate the pipeline members from the current shader sources and leave the
+    // previous pipelines in place when it fails.
+    void RegisterShaderPipeline(std::vector<std::wstring> SourceFiles, std::function<bool()> Rebuild);
+
+    struct FShaderPipelineEntry
+    {
+        std::vector<std::wstring> SourceFiles;
+        std::function<bool()> Rebuild;
+    };
+    std::vector<FShaderPipelineEntry> ShaderPipelineEntries;
+
+    // Material pipeline keys: bit 0 normal map, bit 1 metallic-roughness map, bit 2 base color map,
+    // bit 3 emissive map, bit 4 alpha mask. Bindless shaders read the map bits from
+    // FSceneMaterialData::Flags, so only the alpha-mask bit still selects a pipeline and
+    // indirect ranges merge across texture sets.
+    static constexpr uint32_t MaterialMapKeyMask = 0xFu;
+    static constexpr uint32_t MaterialAlphaMaskKey = 1u << 4;
+    uint32_t ResolveMaterialPipelineKey(uint32_t PipelineKey) const { return bBindlessMaterials ? (PipelineKey & MaterialAlphaMaskKey) : PipelineKey; }
+    // Descriptor table a draw must bind, or a null handle when bindless shaders index the heap themselves.
+    D3D12_GPU_DESCRIPTOR_HANDLE ResolveMaterialTable(const FSceneModelResource& Model) const { return bBindlessMaterials ? D3D12_GPU_DESCRIPTOR_HANDLE{} : Model.TextureHandle; }
+    // FDrawList key of a model's draw from its resolved pipeline, material table and geometry slot.
+    uint64_t BuildDrawSortKey(uint32_t ModelIndex, uint32_t Low) const;
+    // Fills SceneDrawList with the models left visible by culling, grouped by state and front to
+    // back within a group. Call after the frame's visibility update.
+    void BuildSceneDrawList(const FCamera& Camera);
+    // Projects the visible models for FTextureMipStreamer and starts the mip loads it asks for.
+    // Call after BuildSceneDrawList.
+    void UpdateTextureMipStreaming(const FCamera& Camera);
+    // The Second phase appends to the command set IndirectCommandCount commands past the first,
+    // which the indirect command buffer must then hold.
+    void DispatchGpuCulling(FDX12CommandContext& CmdContext, const FCamera& Camera, EGpuCullingPhase Phase = EGpuCullingPhase::Single);
+    // Culls every model against the light's frustum into ShadowCullingBuffers, with LODs selected
+    // for Camera. Casters are not occlusion tested. TexelScale converts shadow map texels to
+    // texels of LightViewProjection, in which screen coverage is then measured.
+    void DispatchGpuShadowCulling(FDX12CommandContext& CmdContext, const FCamera& Camera, const DirectX::XMMATRIX& LightViewProjection, float TexelScale = 1.0f);
+    // Creates the compacted command buffers and the range of every command for CSCompactCommands.
+    // Call once IndirectDrawRanges and IndirectCommandCount are final; CommandSetCount is 2 when
+    // the indirect command buffer holds the second culling phase's commands.
+    bool CreateIndirectCompactionResources(FDX12Device* Device, uint32_t CommandSetCount);
+    // Draws the commands culling left in the range, reading their number from its compaction
+    // counter, from the second command set when bSecondPhase is set.
+    void ExecuteIndirectRange(ID3D12GraphicsCommandList* CommandList, uint32_t RangeIndex, bool bSecondPhase = false) const;
+    // Creates ShadowCullingBuffers holding a copy of the first command set, Commands, whose
+    // instance bases index VisibleInstanceSlotCount slots. Call after CreateIndirectCompactionResources.
+    bool CreateShadowCullingResources(FDX12Device* Device, const FIndirectDrawCommand* Commands, uint32_t VisibleInstanceSlotCount);
+    // Same as ExecuteIndirectRange for the commands shadow culling left in the range.
+    void ExecuteShadowIndirectRange(ID3D12GraphicsCommandList* CommandList, uint32_t RangeIndex) const;
+    // Points the scene's VisibleInstances parameter at the shadow view's; call after BindSceneData.
+    void BindShadowVisibleInstances(ID3D12GraphicsCommandList* CommandList) const;
+    // Buffers one culling dispatch writes; a null CompactedCommands leaves compaction off.
+    struct FGpuCullingTargets
+    {
+        ID3D12Resource* IndirectCommands = nullptr;
+        ID3D12Resource* VisibleInstances = nullptr;
+        ID3D12Resource* CompactedCommands = nullptr;
+    };
+    // Records the reset, cull and compaction dispatches of one view into Targets.
+    void RecordGpuCulling(
+        FDX12CommandContext& CmdContext,
+        const FGpuCullingTargets& Targets,
+        const DirectX::XMMATRIX& ViewProjection,
+        const FCamera& LodCamera,
+        EGpuCullingPhase Phase,
+        bool bOcclusion,
+        float MinScreenCoverage,
+        const DirectX::XMFLOAT2& TargetSize,
+        bool bDebugStats,
+        const wchar_t* EventName);
+    void ExecuteIndirectRange(ID3D12GraphicsCommandList* CommandList, uint32_t RangeIndex, uint32_t SetIndex, ID3D12Resource* IndirectBuffer, ID3D12Resource* CompactedBuffer) const;
+    // Scene root parameters read by Shaders/SceneInstances.hlsl and SceneConstants.hlsl: the view
+    // constants (b0) at parameter 0; the instance base and draw object constants (b0, space2), of
+    // which indirect commands overwrite the first; then the VisibleInstances (t0, space2),
+    // SceneObjects (t1, space2) and SceneMaterials (t2, space2) buffers.
+    static constexpr uint32_t SceneInstanceRootParameter = 2;
+    // Binds the view constants and scene buffers with the instance base set for CPU draws. Call
+    // after binding a root signature that has the scene parameters.
+    void BindSceneData(ID3D12GraphicsCommandList* CommandList) const;
+    // Selects the scene object a CPU draw reads; BindSceneData must have been called.
+    void BindSceneObject(ID3D12GraphicsCommandList* CommandList, uint32_t ObjectIndex) const { CommandList->SetGraphicsRoot32BitConstant(SceneInstanceRootParameter, ObjectIndex, 1); }
+    // Draws the models whose bounds the camera ray under the requested pixel enters, at the LODs the
+    // scene drew with, into the bound ObjectId target, scissored to that one texel, and copies the
+    // texel to the readback buffer. Call with the ObjectId pipeline, scene data, viewport and
+    // targets bound.
+    void RecordObjectIdPick(ID3D12GraphicsCommandList* CommandList, const FCamera& Camera);
     void ConfigureHZBOcclusion(bool bEnabled, ID3D12DescriptorHeap* DescriptorHeap, D3D12_GPU_DESCRIPTOR_HANDLE Handle, uint32_t Width, uint32_t Height, uint32_t MipCount);
+    // Remembers the upload fence covering every texture and mesh loaded so far, so the first frame
+    // can make its queues wait on the copy queue instead of flushing it during initialization.
+    void TrackPendingUploads(FDX12Device* Device);
+    void WaitForPendingUploads(FDX12CommandContext& CmdContext);
+    // Creates the placeholder maps and queues every model's textures on FTextureStreamer. Material
+    // tables written meanwhile use NullTexture for base color and metallic-roughness,
+    // FlatNormalTexture for normals and BlackTexture for emissive maps.
+    bool StartSceneTextureStreaming(FDX12Device* Device, const std::vector<FSceneModelResource>& Models);
+    // Call at the start of a frame, before anything reads material tables. Models whose textures
+    // became resident or streamed other mips move to the table written by OnSceneTexturesResident,
+    // and their SceneMaterialBuffer entries are updated; tables earlier frames may still read are
+    // never rewritten.
+    void ApplyStreamedTextures(FDX12CommandContext& CmdContext);
+    virtual void OnSceneTexturesResident(FStreamedModelTextures& Textures) {}
+    // New material table for a streamed model; the model's previous one is freed once the frames
+    // that may still bind it retire.
+    FDX12DescriptorRange AllocateStreamedMaterialTable(uint32_t ModelIndex, uint32_t Count);
     void PrepareGpuDebugPrint(FDX12CommandContext& CmdContext);
+    bool IsGpuCullingStatsEnabled() const { return bEnableGpuDebugPrint || bEnablePipelineStatistics; }
+    // Reads this frame slot's culling counters from the last frame that used it.
+    void ReadGpuCullingStats();
+    // Copies the culling counters to this frame slot's readback after every culling pass.
+    void AddGpuCullingStatsReadbackPass(FRenderGraph& Graph, const FGpuDrivenBuffers& GpuBuffers);
     void DispatchGpuDebugPrintStats(FDX12CommandContext& CmdContext);
     bool CreateGpuDebugPrintResources(FDX12Device* Device);
     bool CreateGpuDebugPrintPipeline(FDX12Device* Device, DXGI_FORMAT BackBufferFormat);
     bool CreateGpuDebugPrintStatsPipeline(FDX12Device* Device);
     void RenderGpuDebugPrint(FDX12CommandContext& CmdContext, const D3D12_CPU_DESCRIPTOR_HANDLE& OutputHandle);
     bool CreateDepthResourcesPerFrame(FDX12Device* Device, uint32_t Width, uint32_t Height, DXGI_FORMAT Format);
-    bool CreateSceneConstantBuffersPerFrame(FDX12Device* Device, uint64_t BufferSize);
+    // Fills SceneObjectBuffer and SceneMaterialBuffer from SceneModels, one material per model.
+    bool CreateSceneDataBuffers(FDX12Device* Device);
+    bool CreateSceneScatterPipeline(FDX12Device* Device);
+    // Writes the upload ring entries in Updates, each a uint32 entry index followed by EntryBytes of
+    // entry data, over the matching entries of Destination. Runs Shaders/SceneScatter.hlsl, or copies
+    // one entry at a time while that pipeline is unavailable. Destination goes from StateBefore to StateAfter.
+    void ScatterSceneEntries(FDX12CommandContext& CmdContext, ID3D12Resource* Destination, D3D12_RESOURCE_STATES StateBefore,
+        D3D12_RESOURCE_STATES StateAfter, const FDX12UploadAllocation& Updates, const std::vector<uint32_t>& EntryIndices, uint32_t EntryBytes);
+    // Writes the view constants to the frame's upload ring and points ViewConstantsAddress at them.
+    // Each cascade ShadowCascades renders this frame gets a copy whose LightViewProjection is its
+    // own, at ShadowCascadeConstantsAddresses, for the shadow pass to bind instead.
+    bool UploadViewConstants(FDX12CommandContext& CmdContext, const FCamera& Camera, const DirectX::XMMATRIX& Projection);
+    // Ranges from the device's shared descriptor allocator, released when the renderer is destroyed.
+    FDX12DescriptorRange AllocatePersistentDescriptors(uint32_t Count);
+    FDX12DescriptorRange AllocateStagingDescriptors(uint32_t Count);
+    // Creates VariableRateShading for a Width x Height target and registers its shaders for hot
+    // reload; leaves it inactive when the device lacks tier 2 support.
+    void InitializeVariableRateShading(FDX12Device* Device, uint32_t Width, uint32_t Height, DXGI_FORMAT OverlayFormat);
+    // Loads EnvironmentCubeTexture and replaces it with the GGX prefiltered cube EnvironmentLighting
+    // builds from it, whose irradiance coefficients go into the view constants.
+    bool LoadEnvironment(FDX12Device* Device, const std::wstring& EnvironmentPath);
+    bool LoadBrdfLut(const std::wstring& BrdfLutPath);
+    // Points OutResource at the target Name of Options.PersistentResources when it matches Desc,
+    // returning false when the caller has to create it. State is set at the hand-over.
+    bool AdoptPersistentTarget(const char* Name, const D3D12_RESOURCE_DESC& Desc, Microsoft::WRL::ComPtr<ID3D12Resource>& OutResource, D3D12_RESOURCE_STATES& State);
+    // Lists a created or adopted target, tracked in State, for CapturePersistentResources. State
+    // must stay at its address for the renderer's lifetime.
+    void RegisterPersistentTarget(const char* Name, ID3D12Resource* Resource, const D3D12_RESOURCE_STATES& State);
+    // Creates SkyAtmosphere for OutputFormat targets; the renderer registers its shaders for hot
+    // reload with its own pipelines.
+    bool InitializeSkyAtmosphere(FDX12Device* Device, DXGI_FORMAT OutputFormat, const FSkyPipelineConfig& Config);
+    // SkyAtmosphere's LUTs imported into the graph, after passes that rebuild those that are stale
+    // for the current LightDirection. Handles are invalid when the sky is not ready.
+    struct FSkyAtmosphereLuts
+    {
+        FRGResourceHandle Transmittance;
+        FRGResourceHandle SkyView;
+    };
+    FSkyAtmosphereLuts AddSkyAtmosphereLutPasses(FRenderGraph& Graph);
 
     std::vector<FDepthResources> DepthResourcesPerFrame;
     std::vector<D3D12_RESOURCE_STATES> DepthBufferStates;
-    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> SceneConstantBuffers;
-    std::vector<uint8_t*> SceneConstantBufferMapped;
+    // This frame's FSceneViewConstants in the upload ring.
+    D3D12_GPU_VIRTUAL_ADDRESS ViewConstantsAddress = 0;
+    // Unjittered camera view projections of this and the previous frame, as in the view constants.
+    DirectX::XMFLOAT4X4 CurrentViewProjection{};
+    DirectX::XMFLOAT4X4 PrevViewProjection{};
+    bool bHasViewProjection = false;
+    ID3D12Resource* OutputTarget = nullptr;
     D3D12_CPU_DESCRIPTOR_HANDLE DepthStencilHandle{};
-    D3D12_CPU_DESCRIPTOR_HANDLE ShadowDSVHandle{};
+    std::array<D3D12_CPU_DESCRIPTOR_HANDLE, FShadowCascades::CascadeCount> ShadowCascadeDSVHandles{};
+    std::array<D3D12_GPU_VIRTUAL_ADDRESS, FShadowCascades::CascadeCount> ShadowCascadeConstantsAddresses{};
+    FShadowCascades ShadowCascades;
+    // Rates for the geometry passes, built at the end of each frame for the next one.
+    FVariableRateShading VariableRateShading;
+    FEnvironmentLighting EnvironmentLighting;
+    FSkyAtmosphere SkyAtmosphere;
     D3D12_CPU_DESCRIPTOR_HANDLE ObjectIdRtvHandle{};
     DirectX::XMFLOAT3 SceneCenter{ 0.0f, 0.0f, 0.0f };
     float SceneRadius = 1.0f;
@@ -142,10 +504,39 @@ protected:
     DirectX::XMFLOAT3 LightColor{ 1.0f, 1.0f, 1.0f };
 
     bool bDepthPrepassEnabled = false;
+    uint32_t MaskedDepthPrepassThreshold = 16;
+    // Models of SceneModels with AlphaMode 1, counted by FinalizeSceneModels.
+    uint32_t MaskedModelCount = 0;
     const FCamera* CullingCameraOverride = nullptr;
+    // Cameras of the views RenderViews is rendering and the one RenderFrame is recording.
+    std::vector<const FCamera*> MultiViewCameras;
+    uint32_t MultiViewIndex = 0;
+    // Set by RenderViews: whatever a renderer kept of the last view, such as its HZB, is not the
+    // next frame's camera. Renderers clear it once they have dropped that state.
+    bool bMultiViewHistoryStale = false;
+    const uint32_t MemoryOwnerId = FDX12MemoryTracker::AllocateOwnerId();
 
     std::vector<FSceneModelResource> SceneModels;
     std::vector<bool> SceneModelVisibility;
+    // Visible models of the current frame in draw order, see BuildSceneDrawList.
+    FDrawList SceneDrawList;
+    // Dense index of each model's vertex buffer, the geometry field of its draw sort key.
+    std::vector<uint32_t> SceneGeometrySlots;
+    // Camera, light and picking queries over SceneModels; object i is SceneModels[i].
+    FSceneBvh SceneBvh;
+    // Flat copy of the same bounds; small scenes cull faster with one SIMD sweep than with the BVH.
+    FSceneBoundsSoA SceneBoundsSoA;
+    // Visible model indices of the last camera culling.
+    std::vector<uint32_t> CullingScratchIndices;
+    FTransformHierarchy SceneTransforms;
+    // Models placed by each transform node, e.g. the primitive sections of one glTF node.
+    std::vector<std::vector<uint32_t>> TransformNodeModels;
+    std::vector<uint32_t> ChangedTransformNodes;
+    std::vector<uint32_t> MovedModelIndices;
+    // Models moved this frame, whose PrevWorld catches up with their world matrix next frame.
+    std::vector<uint32_t> SettlingModelIndices;
+    // Contents of ModelBoundsBuffer, kept to re-upload the entries of moved models.
+    std::vector<FModelCullingData> ModelCullingCpuData;
     struct FIndirectDrawRange
     {
         uint32_t Start = 0;
@@ -155,15 +546,45 @@ protected:
         std::wstring Name;
     };
 
-    Microsoft::WRL::ComPtr<ID3D12Resource> SkyConstantBuffer;
     Microsoft::WRL::ComPtr<ID3D12Resource> ShadowMap;
     std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> IndirectCommandBuffers;
+    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> VisibleInstanceBuffers;
+    // Non-empty commands of each range packed at the range's start, followed by one count per
+    // range and command set that ExecuteIndirect reads as its count buffer.
+    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> CompactedCommandBuffers;
+    // Light-view counterparts of the indirect command, visible instance and compacted command
+    // buffers, one set per frame in flight.
+    struct FShadowCullingBuffers
+    {
+        Microsoft::WRL::ComPtr<ID3D12Resource> IndirectCommands;
+        Microsoft::WRL::ComPtr<ID3D12Resource> VisibleInstances;
+        Microsoft::WRL::ComPtr<ID3D12Resource> CompactedCommands;
+        D3D12_RESOURCE_STATES IndirectCommandState = D3D12_RESOURCE_STATE_COMMON;
+        D3D12_RESOURCE_STATES VisibleInstanceState = D3D12_RESOURCE_STATE_COMMON;
+        D3D12_RESOURCE_STATES CompactedCommandState = D3D12_RESOURCE_STATE_COMMON;
+    };
+    std::vector<FShadowCullingBuffers> ShadowCullingBuffers;
+    // FIndirectCommandRange per command of every command set.
+    Microsoft::WRL::ComPtr<ID3D12Resource> IndirectCommandRangeBuffer;
+    // FSceneObjectData and FSceneMaterialData per scene model, in SceneDataBufferState between updates.
+    // Only changed entries are uploaded each frame, through ScatterSceneEntries.
+    Microsoft::WRL::ComPtr<ID3D12Resource> SceneObjectBuffer;
+    Microsoft::WRL::ComPtr<ID3D12Resource> SceneMaterialBuffer;
+    static constexpr D3D12_RESOURCE_STATES SceneDataBufferState =
+        D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
     Microsoft::WRL::ComPtr<ID3D12Resource> ModelBoundsBuffer;
     Microsoft::WRL::ComPtr<ID3D12Resource> ModelBoundsUpload;
+    // One flag per scene model written by the Second culling phase and read by the next frame's
+    // First. Frames execute in order on the graphics queue, so one buffer serves every frame in flight.
+    Microsoft::WRL::ComPtr<ID3D12Resource> InstanceVisibilityBuffer;
     Microsoft::WRL::ComPtr<ID3D12Resource> GpuDebugPrintBuffer;
     Microsoft::WRL::ComPtr<ID3D12Resource> GpuDebugPrintUpload;
     Microsoft::WRL::ComPtr<ID3D12Resource> GpuDebugPrintStatsBuffer;
     Microsoft::WRL::ComPtr<ID3D12Resource> GpuDebugPrintStatsUpload;
+    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> GpuCullingStatsReadbacks;
+    std::vector<bool> GpuCullingStatsPending;
+    FGpuCullingStats GpuCullingStats;
+    bool bHasGpuCullingStats = false;
     Microsoft::WRL::ComPtr<ID3D12Resource> ObjectIdTexture;
     Microsoft::WRL::ComPtr<ID3D12Resource> ObjectIdReadback;
     Microsoft::WRL::ComPtr<ID3D12Resource> NullTexture;
@@ -171,14 +592,29 @@ protected:
     Microsoft::WRL::ComPtr<ID3D12Resource> BrdfLutTexture;
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> ShadowDSVHeap;
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> ObjectIdRtvHeap;
+    Microsoft::WRL::ComPtr<ID3D12Resource> FlatNormalTexture;
+    Microsoft::WRL::ComPtr<ID3D12Resource> BlackTexture;
     std::unique_ptr<FTextureLoader> TextureLoader;
+    // Declared after TextureLoader so it is destroyed first; null unless textures are still streaming.
+    std::unique_ptr<FTextureStreamer> TextureStreamer;
+    // Outlives TextureStreamer for as long as the scene streams mips; null when disabled.
+    std::unique_ptr<FTextureMipStreamer> TextureMipStreamer;
+    // Projected diameter in pixels of each visible model, 0 for culled ones.
+    std::vector<float> SceneModelScreenSizes;
+    FDX12UploadQueue* UploadQueue = nullptr;
+    uint64_t PendingUploadFenceValue = 0;
+    bool bPendingUploadsWaited = false;
     Microsoft::WRL::ComPtr<ID3D12RootSignature> CullingRootSignature;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> CullingPipeline;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> CullingResetPipeline;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> CullingCompactPipeline;
     Microsoft::WRL::ComPtr<ID3D12CommandSignature> IndirectCommandSignature;
     Microsoft::WRL::ComPtr<ID3D12RootSignature> GpuDebugPrintRootSignature;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> GpuDebugPrintPipeline;
     Microsoft::WRL::ComPtr<ID3D12RootSignature> GpuDebugPrintStatsRootSignature;
     Microsoft::WRL::ComPtr<ID3D12PipelineState> GpuDebugPrintStatsPipeline;
+    Microsoft::WRL::ComPtr<ID3D12RootSignature> SceneScatterRootSignature;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> SceneScatterPipeline;
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> GpuDebugPrintDescriptorHeap;
     Microsoft::WRL::ComPtr<ID3D12Resource> GpuDebugPrintFontTexture;
     Microsoft::WRL::ComPtr<ID3D12Resource> GpuDebugPrintGlyphBuffer;
@@ -194,17 +630,24 @@ protected:
 
     D3D12_VIEWPORT Viewport{};
     D3D12_RECT ScissorRect{};
+    // The part of the output the scene renders to this frame; equal to Viewport unless the
+    // renderer scales its resolution.
+    D3D12_VIEWPORT RenderViewport{};
+    D3D12_RECT RenderScissorRect{};
+    float ResolutionScale = 1.0f;
     D3D12_VIEWPORT ShadowViewport{};
     D3D12_RECT ShadowScissor{};
 
     D3D12_RESOURCE_STATES ShadowMapState = D3D12_RESOURCE_STATE_DEPTH_WRITE;
     D3D12_RESOURCE_STATES ObjectIdState = D3D12_RESOURCE_STATE_RENDER_TARGET;
     std::vector<D3D12_RESOURCE_STATES> IndirectCommandStates;
+    std::vector<D3D12_RESOURCE_STATES> VisibleInstanceStates;
+    std::vector<D3D12_RESOURCE_STATES> CompactedCommandStates;
+    D3D12_RESOURCE_STATES ModelBoundsState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+    D3D12_RESOURCE_STATES InstanceVisibilityState = D3D12_RESOURCE_STATE_COMMON;
     D3D12_RESOURCE_STATES GpuDebugPrintState = D3D12_RESOURCE_STATE_COMMON;
     D3D12_RESOURCE_STATES GpuDebugPrintStatsState = D3D12_RESOURCE_STATE_COMMON;
 
-    uint8_t* SkyConstantBufferMapped = nullptr;
-    uint64_t SceneConstantBufferStride = 0;
     float ShadowBias = 0.0f;
     float ShadowStrength = 1.0f;
     uint32_t ShadowMapWidth = 0;
@@ -213,8 +656,17 @@ protected:
     bool bLogResourceBarriers = false;
     bool bEnableGraphDump = false;
     bool bEnableGpuTiming = false;
+    bool bEnablePipelineStatistics = false;
+    bool bEnableParallelRecording = true;
     bool bEnableIndirectDraw = false;
     bool bEnableGpuDebugPrint = false;
+    bool bBindlessMaterials = false;
+    bool bStreamSceneTextures = true;
+    bool bStreamTextureMips = true;
+    uint32_t TextureStreamingBudgetMB = 0;
+    float LodBias = 0.0f;
+    float MinScreenCoverage = 1.0f;
+    float ShadowMinScreenCoverage = 2.0f;
     float EnvironmentMipCount = 1.0f;
     bool bObjectIdReadbackRequested = false;
     bool bObjectIdReadbackRecorded = false;
@@ -223,6 +675,11 @@ protected:
     D3D12_PLACED_SUBRESOURCE_FOOTPRINT ObjectIdFootprint{};
     uint32_t ObjectIdRowPitch = 0;
     uint32_t IndirectCommandCount = 0;
+    // Scene models culled per frame; each one is an instance of exactly one instance group.
+    uint32_t IndirectInstanceCount = 0;
+    uint32_t IndirectInstanceGroupCount = 0;
+    // Byte offset of the range counts in CompactedCommandBuffers.
+    uint64_t CompactedCountOffset = 0;
     std::vector<FIndirectDrawRange> IndirectDrawRanges;
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> CullingDescriptorHeap;
     D3D12_GPU_DESCRIPTOR_HANDLE HZBCullingHandle{};
@@ -232,6 +689,21 @@ protected:
     bool bHZBOcclusionEnabled = false;
 
     FDX12Device* Device = nullptr;
+    // Set from Options.PersistentResources until CompletePersistentResourceHandoff.
+    std::shared_ptr<const FRendererPersistentResources> InheritedResources;
+    struct FTargetStateHandoff
+    {
+        const D3D12_RESOURCE_STATES* Source = nullptr;
+        D3D12_RESOURCE_STATES* Target = nullptr;
+    };
+    std::vector<FTargetStateHandoff> PendingStateHandoffs;
+    std::vector<FRendererPersistentResources::FTarget> PersistentTargets;
+    std::wstring LoadedEnvironmentPath;
+    std::wstring LoadedBrdfLutPath;
+    std::vector<FDX12DescriptorRange> PersistentDescriptorRanges;
+    std::vector<FDX12DescriptorRange> StagingDescriptorRanges;
+    // Current table of each streamed model, see AllocateStreamedMaterialTable.
+    std::vector<FDX12DescriptorRange> StreamedMaterialTables;
     uint32_t FramesInFlight = 1;
     uint32_t CurrentFrameIndex = 0;
 };
@@ -5,13 +5,22 @@
 #include "RendererUtils.h"
 
 #include "../Scene/Mesh.h"
+#include "../Scene/MeshOptimizer.h"
+#include "../Scene/MeshletBuilder.h"
+#include "../Scene/MeshSimplifier.h"
 #include "../Scene/GltfLoader.h"
+#include "../Scene/SceneBvh.h"
+#include "../Scene/SceneCache.h"
 #include "../Scene/SceneJsonLoader.h"
+#include "../Scene/Transform.h"
 #include "../Scene/Camera.h"
+#include "../Core/CpuProfiler.h"
 #include "../Core/Logger.h"
+#include "../Core/TaskSystem.h"
 #include "ShaderCompiler.h"
 #include "../RHI/DX12Device.h"
 #include "../RHI/DX12Commons.h"
+#include <DirectXPackedVector.h>
 #include <vector>
 #include <cstring>
 #include <algorithm>
@@ -20,11 +29,17 @@
 #include <filesystem>
 #include <cmath>
 #include <limits>
+#include <chrono>
 
 using Microsoft::WRL::ComPtr;
 
 namespace
 {
+    // Up to this many models a flat SIMD sweep over every box is cheaper than walking the BVH,
+    // whose advantage is rejecting whole subtrees in large scenes.
+    constexpr size_t MaxFlatCullingModels = 4096;
+    constexpr uint32_t MinCullingGroupsPerChunk = 256;
+
     std::string PathToUtf8String(const std::filesystem::path& Path)
     {
         const auto Utf8 = Path.u8string();
@@ -92,6 +107,23 @@ std::wstring RendererUtils::BuildShaderTarget(const wchar_t* StagePrefix, D3D_SH
     return std::wstring(StagePrefix) + L"_" + std::to_wstring(Major) + L"_" + std::to_wstring(Minor);
 }
 
+UINT RendererUtils::GetTextureComponentMapping(DXGI_FORMAT Format)
+{
+    switch (Format)
+    {
+    case DXGI_FORMAT_BC4_TYPELESS:
+    case DXGI_FORMAT_BC4_UNORM:
+    case DXGI_FORMAT_BC4_SNORM:
+        return D3D12_ENCODE_SHADER_4_COMPONENT_MAPPING(
+            D3D12_SHADER_COMPONENT_MAPPING_FROM_MEMORY_COMPONENT_0,
+            D3D12_SHADER_COMPONENT_MAPPING_FROM_MEMORY_COMPONENT_0,
+            D3D12_SHADER_COMPONENT_MAPPING_FROM_MEMORY_COMPONENT_0,
+            D3D12_SHADER_COMPONENT_MAPPING_FORCE_VALUE_1);
+    default:
+        return D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    }
+}
+
 std::string RendererUtils::ResourceStateToString(D3D12_RESOURCE_STATES State)
 {
     if (State == D3D12_RESOURCE_STATE_COMMON)
@@ -157,17 +189,139 @@ std::string RendererUtils::ResourceStateToString(D3D12_RESOURCE_STATES State)
     return Stream.str();
 }
 
+std::string RendererUtils::BarrierLayoutToString(D3D12_BARRIER_LAYOUT Layout)
+{
+    switch (Layout)
+    {
+    case D3D12_BARRIER_LAYOUT_UNDEFINED: return "UNDEFINED";
+    case D3D12_BARRIER_LAYOUT_COMMON: return "COMMON";
+    case D3D12_BARRIER_LAYOUT_GENERIC_READ: return "GENERIC_READ";
+    case D3D12_BARRIER_LAYOUT_RENDER_TARGET: return "RENDER_TARGET";
+    case D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS: return "UNORDERED_ACCESS";
+    case D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE: return "DEPTH_STENCIL_WRITE";
+    case D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_READ: return "DEPTH_STENCIL_READ";
+    case D3D12_BARRIER_LAYOUT_SHADER_RESOURCE: return "SHADER_RESOURCE";
+    case D3D12_BARRIER_LAYOUT_COPY_SOURCE: return "COPY_SOURCE";
+    case D3D12_BARRIER_LAYOUT_COPY_DEST: return "COPY_DEST";
+    case D3D12_BARRIER_LAYOUT_RESOLVE_SOURCE: return "RESOLVE_SOURCE";
+    case D3D12_BARRIER_LAYOUT_RESOLVE_DEST: return "RESOLVE_DEST";
+    case D3D12_BARRIER_LAYOUT_SHADING_RATE_SOURCE: return "SHADING_RATE_SOURCE";
+    default: break;
+    }
+
+    std::ostringstream Stream;
+    Stream << "0x" << std::hex << static_cast<uint32_t>(Layout);
+    return Stream.str();
+}
+
+namespace
+{
+    // Slot 1 of the mesh input layout; positions live in their own stream.
+    struct FPackedMeshVertex
+    {
+        DirectX::PackedVector::XMSHORTN2 Normal;
+        DirectX::PackedVector::XMUDECN4 Tangent;
+        DirectX::PackedVector::XMHALF2 UV;
+        DirectX::PackedVector::XMUBYTEN4 Color;
+    };
+
+    static_assert(sizeof(FPackedMeshVertex) == 16, "Packed vertex layout must match GetMeshInputLayout.");
+    static_assert(sizeof(DirectX::PackedVector::XMUSHORTN4) == 8, "Position stream stride must match GetMeshPositionInputLayout.");
+
+    const D3D12_INPUT_ELEMENT_DESC MeshInputElements[] =
+    {
+        { "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "NORMAL",   0, DXGI_FORMAT_R16G16_SNORM,       1, 0,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "TANGENT",  0, DXGI_FORMAT_R10G10B10A2_UNORM,  1, 4,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT,       1, 8,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "COLOR",    0, DXGI_FORMAT_R8G8B8A8_UNORM,     1, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+    };
+
+    // Octahedral mapping of a unit vector to [-1, 1]^2, decoded by DecodeOctahedral in MeshVertex.hlsl.
+    DirectX::XMFLOAT2 EncodeOctahedral(const FFloat3& Vector)
+    {
+        const float L1Norm = std::abs(Vector.x) + std::abs(Vector.y) + std::abs(Vector.z);
+        if (L1Norm <= 1e-8f)
+        {
+            return { 0.0f, 0.0f };
+        }
+
+        float X = Vector.x / L1Norm;
+        float Y = Vector.y / L1Norm;
+        if (Vector.z < 0.0f)
+        {
+            const float FoldedX = (1.0f - std::abs(Y)) * (X >= 0.0f ? 1.0f : -1.0f);
+            const float FoldedY = (1.0f - std::abs(X)) * (Y >= 0.0f ? 1.0f : -1.0f);
+            X = FoldedX;
+            Y = FoldedY;
+        }
+        return { X, Y };
+    }
+
+    FPackedMeshVertex PackMeshVertex(const FMesh::FVertex& Vertex)
+    {
+        using namespace DirectX::PackedVector;
+
+        FPackedMeshVertex Packed;
+        const DirectX::XMFLOAT2 Normal = EncodeOctahedral(Vertex.Normal);
+        Packed.Normal = XMSHORTN2(Normal.x, Normal.y);
+
+        const DirectX::XMFLOAT2 Tangent = EncodeOctahedral({ Vertex.Tangent.x, Vertex.Tangent.y, Vertex.Tangent.z });
+        Packed.Tangent = XMUDECN4(Tangent.x * 0.5f + 0.5f, Tangent.y * 0.5f + 0.5f, 0.0f, Vertex.Tangent.w < 0.0f ? 0.0f : 1.0f);
+
+        Packed.UV = XMHALF2(Vertex.UV.x, Vertex.UV.y);
+        Packed.Color = XMUBYTEN4(Vertex.Color.x, Vertex.Color.y, Vertex.Color.z, Vertex.Color.w);
+        return Packed;
+    }
+}
+
+D3D12_INPUT_LAYOUT_DESC RendererUtils::GetMeshInputLayout()
+{
+    return { MeshInputElements, _countof(MeshInputElements) };
+}
+
+D3D12_INPUT_LAYOUT_DESC RendererUtils::GetMeshPositionInputLayout()
+{
+    return { MeshInputElements, 1 };
+}
+
 bool RendererUtils::CreateMeshGeometry(FDX12Device* Device, const FMesh& Mesh, FMeshGeometryBuffers& OutGeometry)
 {
-    if (Device == nullptr)
+    std::vector<FMeshGeometryBuffers> Geometries;
+    if (!CreateSharedMeshGeometry(Device, { &Mesh }, Geometries))
     {
         return false;
     }
 
-    OutGeometry.IndexCount = static_cast<uint32_t>(Mesh.GetIndices().size());
+    OutGeometry = Geometries.front();
+    return true;
+}
 
-    const UINT VertexBufferSize = static_cast<UINT>(Mesh.GetVertices().size() * sizeof(FMesh::FVertex));
-    const UINT IndexBufferSize = static_cast<UINT>(Mesh.GetIndices().size() * sizeof(uint32_t));
+bool RendererUtils::CreateSharedMeshGeometry(FDX12Device* Device, const std::vector<const FMesh*>& Meshes, std::vector<FMeshGeometryBuffers>& OutGeometries)
+{
+    OutGeometries.clear();
+    if (Device == nullptr || Device->GetUploadQueue() == nullptr || Meshes.empty())
+    {
+        return false;
+    }
+
+    uint64_t VertexCount = 0;
+    uint64_t IndexCount = 0;
+    for (const FMesh* Mesh : Meshes)
+    {
+        VertexCount += Mesh->GetVertices().size();
+        IndexCount += Mesh->GetIndices().size();
+    }
+
+    const uint64_t PositionStreamSize = VertexCount * sizeof(DirectX::PackedVector::XMUSHORTN4);
+    const uint64_t AttributeStreamOffset = (PositionStreamSize + 15ULL) & ~15ULL;
+    const uint64_t VertexBufferSize = AttributeStreamOffset + VertexCount * sizeof(FPackedMeshVertex);
+    const uint64_t IndexBufferSize = IndexCount * sizeof(uint32_t);
+    if (VertexBufferSize == 0 || IndexBufferSize == 0 || VertexBufferSize > UINT32_MAX || IndexBufferSize > UINT32_MAX)
+    {
+        LogError("Scene geometry does not fit one vertex and index buffer view");
+        return false;
+    }
 
     D3D12_HEAP_PROPERTIES UploadHeap = {};
     UploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
@@ -183,93 +337,302 @@ bool RendererUtils::CreateMeshGeometry(FDX12Device* Device, const FMesh& Mesh, F
     BufferDesc.SampleDesc.Count = 1;
     BufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
 
+    // Buffers live in default memory, placed in static pages when small enough, and are filled from one staging buffer on the upload queue.
+    Microsoft::WRL::ComPtr<ID3D12Resource> VertexBuffer;
     BufferDesc.Width = VertexBufferSize;
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
-        &UploadHeap,
-        D3D12_HEAP_FLAG_NONE,
+    HR_CHECK(Device->CreateStaticResource(
+        EGpuMemoryCategory::Geometry,
         &BufferDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(OutGeometry.VertexBuffer.GetAddressOf())));
+        D3D12_RESOURCE_STATE_COMMON,
+        IID_PPV_ARGS(VertexBuffer.GetAddressOf())));
 
-    OutGeometry.VertexBufferView.BufferLocation = OutGeometry.VertexBuffer->GetGPUVirtualAddress();
-    OutGeometry.VertexBufferView.StrideInBytes = sizeof(FMesh::FVertex);
-    OutGeometry.VertexBufferView.SizeInBytes = VertexBufferSize;
+    Microsoft::WRL::ComPtr<ID3D12Resource> IndexBuffer;
+    BufferDesc.Width = IndexBufferSize;
+    HR_CHECK(Device->CreateStaticResource(
+        EGpuMemoryCategory::Geometry,
+        &BufferDesc,
+        D3D12_RESOURCE_STATE_COMMON,
+        IID_PPV_ARGS(IndexBuffer.GetAddressOf())));
 
-    void* VertexData = nullptr;
-    D3D12_RANGE EmptyRange = { 0, 0 };
-    HR_CHECK(OutGeometry.VertexBuffer->Map(0, &EmptyRange, &VertexData));
-    memcpy(VertexData, Mesh.GetVertices().data(), VertexBufferSize);
-    OutGeometry.VertexBuffer->Unmap(0, nullptr);
+    if (!VertexBuffer || !IndexBuffer)
+    {
+        return false;
+    }
 
-    BufferDesc.Width = IndexBufferSize;
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    if (Meshes.size() > 1)
+    {
+        VertexBuffer->SetName(L"SceneVertexBuffer");
+        IndexBuffer->SetName(L"SceneIndexBuffer");
+    }
+
+    const uint64_t IndexDataOffset = (VertexBufferSize + 3ULL) & ~3ULL;
+    BufferDesc.Width = IndexDataOffset + IndexBufferSize;
+    Microsoft::WRL::ComPtr<ID3D12Resource> StagingBuffer;
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Upload,
         &UploadHeap,
         D3D12_HEAP_FLAG_NONE,
         &BufferDesc,
         D3D12_RESOURCE_STATE_GENERIC_READ,
         nullptr,
-        IID_PPV_ARGS(OutGeometry.IndexBuffer.GetAddressOf())));
+        IID_PPV_ARGS(StagingBuffer.GetAddressOf())));
+
+    uint8_t* StagingData = nullptr;
+    D3D12_RANGE EmptyRange = { 0, 0 };
+    HR_CHECK(StagingBuffer->Map(0, &EmptyRange, reinterpret_cast<void**>(&StagingData)));
+
+    FMeshGeometryBuffers SharedGeometry;
+    SharedGeometry.VertexBuffer = VertexBuffer;
+    SharedGeometry.IndexBuffer = IndexBuffer;
+    SharedGeometry.PositionBufferView.BufferLocation = VertexBuffer->GetGPUVirtualAddress();
+    SharedGeometry.PositionBufferView.StrideInBytes = sizeof(DirectX::PackedVector::XMUSHORTN4);
+    SharedGeometry.PositionBufferView.SizeInBytes = static_cast<UINT>(PositionStreamSize);
+    SharedGeometry.VertexBufferView.BufferLocation = VertexBuffer->GetGPUVirtualAddress() + AttributeStreamOffset;
+    SharedGeometry.VertexBufferView.StrideInBytes = sizeof(FPackedMeshVertex);
+    SharedGeometry.VertexBufferView.SizeInBytes = static_cast<UINT>(VertexBufferSize - AttributeStreamOffset);
+    SharedGeometry.IndexBufferView.BufferLocation = IndexBuffer->GetGPUVirtualAddress();
+    SharedGeometry.IndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+    SharedGeometry.IndexBufferView.SizeInBytes = static_cast<UINT>(IndexBufferSize);
+
+    OutGeometries.reserve(Meshes.size());
+    DirectX::PackedVector::XMUSHORTN4* PositionData = reinterpret_cast<DirectX::PackedVector::XMUSHORTN4*>(StagingData);
+    FPackedMeshVertex* AttributeData = reinterpret_cast<FPackedMeshVertex*>(StagingData + AttributeStreamOffset);
+    uint32_t* IndexData = reinterpret_cast<uint32_t*>(StagingData + IndexDataOffset);
+    uint32_t BaseVertex = 0;
+    uint32_t FirstIndex = 0;
+    for (const FMesh* Mesh : Meshes)
+    {
+        const std::vector<FMesh::FVertex>& Vertices = Mesh->GetVertices();
+        const std::vector<uint32_t>& Indices = Mesh->GetIndices();
+
+        // Quantize positions to the mesh bounds; the scale and offset travel in the draw constants.
+        const float MaxFloat = (std::numeric_limits<float>::max)();
+        FFloat3 BoundsMin{ MaxFloat, MaxFloat, MaxFloat };
+        FFloat3 BoundsMax{ -MaxFloat, -MaxFloat, -MaxFloat };
+        for (const FMesh::FVertex& Vertex : Vertices)
+        {
+            BoundsMin = { (std::min)(BoundsMin.x, Vertex.Position.x), (std::min)(BoundsMin.y, Vertex.Position.y), (std::min)(BoundsMin.z, Vertex.Position.z) };
+            BoundsMax = { (std::max)(BoundsMax.x, Vertex.Position.x), (std::max)(BoundsMax.y, Vertex.Position.y), (std::max)(BoundsMax.z, Vertex.Position.z) };
+        }
+
+        FMeshGeometryBuffers Geometry = SharedGeometry;
+        if (!Vertices.empty())
+        {
+            const auto AxisScale = [](float Min, float Max) { return Max > Min ? Max - Min : 1.0f; };
+            Geometry.PositionOffset = BoundsMin;
+            Geometry.PositionScale = { AxisScale(BoundsMin.x, BoundsMax.x), AxisScale(BoundsMin.y, BoundsMax.y), AxisScale(BoundsMin.z, BoundsMax.z) };
+        }
+
+        for (size_t VertexIndex = 0; VertexIndex < Vertices.size(); ++VertexIndex)
+        {
+            const FMesh::FVertex& Vertex = Vertices[VertexIndex];
+            PositionData[BaseVertex + VertexIndex] = DirectX::PackedVector::XMUSHORTN4(
+                (Vertex.Position.x - Geometry.PositionOffset.x) / Geometry.PositionScale.x,
+                (Vertex.Position.y - Geometry.PositionOffset.y) / Geometry.PositionScale.y,
+                (Vertex.Position.z - Geometry.PositionOffset.z) / Geometry.PositionScale.z,
+                0.0f);
+            AttributeData[BaseVertex + VertexIndex] = PackMeshVertex(Vertex);
+        }
+
+        // Rebasing the indices here keeps BaseVertexLocation zero for every draw.
+        for (size_t Index = 0; Index < Indices.size(); ++Index)
+        {
+            IndexData[FirstIndex + Index] = Indices[Index] + BaseVertex;
+        }
+
+        Geometry.FirstIndex = FirstIndex;
+        Geometry.IndexCount = static_cast<uint32_t>(Indices.size());
+        OutGeometries.push_back(Geometry);
+
+        BaseVertex += static_cast<uint32_t>(Vertices.size());
+        FirstIndex += static_cast<uint32_t>(Indices.size());
+    }
+    StagingBuffer->Unmap(0, nullptr);
+
+    FDX12UploadQueue* UploadQueue = Device->GetUploadQueue();
+    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> UploadAllocator;
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> UploadList;
+    if (!UploadQueue->CreateCommandList(UploadAllocator, UploadList))
+    {
+        OutGeometries.clear();
+        return false;
+    }
 
-    OutGeometry.IndexBufferView.BufferLocation = OutGeometry.IndexBuffer->GetGPUVirtualAddress();
-    OutGeometry.IndexBufferView.Format = DXGI_FORMAT_R32_UINT;
-    OutGeometry.IndexBufferView.SizeInBytes = IndexBufferSize;
+    UploadList->CopyBufferRegion(VertexBuffer.Get(), 0, StagingBuffer.Get(), 0, VertexBufferSize);
+    UploadList->CopyBufferRegion(IndexBuffer.Get(), 0, StagingBuffer.Get(), IndexDataOffset, IndexBufferSize);
 
-    void* IndexData = nullptr;
-    HR_CHECK(OutGeometry.IndexBuffer->Map(0, &EmptyRange, &IndexData));
-    memcpy(IndexData, Mesh.GetIndices().data(), IndexBufferSize);
-    OutGeometry.IndexBuffer->Unmap(0, nullptr);
+    // On the copy queue the buffers decay back to COMMON and are promoted on first use; the
+    // graphics fallback keeps them in COPY_DEST, so transition them explicitly there. The mesh
+    // shader path also reads the vertex buffer as a shader resource.
+    if (!UploadQueue->IsCopyQueue())
+    {
+        D3D12_RESOURCE_BARRIER Barriers[2] = {};
+        Barriers[0].Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        Barriers[0].Transition.pResource = VertexBuffer.Get();
+        Barriers[0].Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        Barriers[0].Transition.StateAfter = D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+        Barriers[0].Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        Barriers[1] = Barriers[0];
+        Barriers[1].Transition.pResource = IndexBuffer.Get();
+        Barriers[1].Transition.StateAfter = D3D12_RESOURCE_STATE_INDEX_BUFFER;
+        UploadList->ResourceBarrier(_countof(Barriers), Barriers);
+    }
 
+    HR_CHECK(UploadList->Close());
+
+    ID3D12CommandList* Lists[] = { UploadList.Get() };
+    UploadQueue->Submit(1, Lists, { StagingBuffer, UploadAllocator, UploadList });
     return true;
 }
 
-bool RendererUtils::CreateCubeGeometry(FDX12Device* Device, FCubeGeometryBuffers& OutGeometry, float Size)
+bool RendererUtils::CreateSharedMeshletBuffer(FDX12Device* Device, const std::vector<const FMesh*>& Meshes, std::vector<FMeshletData>& MeshletSets, std::vector<FMeshGeometryBuffers>& InOutGeometries)
 {
-    const FMesh Cube = FMesh::CreateCube(Size);
-    return CreateMeshGeometry(Device, Cube, OutGeometry);
-}
+    if (Device == nullptr || Device->GetUploadQueue() == nullptr || Meshes.size() != MeshletSets.size() || Meshes.size() != InOutGeometries.size())
+    {
+        return false;
+    }
 
-bool RendererUtils::CreateSphereGeometry(FDX12Device* Device, FMeshGeometryBuffers& OutGeometry, float Radius, uint32_t SliceCount, uint32_t StackCount)
-{
-    const FMesh Sphere = FMesh::CreateSphere(Radius, SliceCount, StackCount);
-    return CreateMeshGeometry(Device, Sphere, OutGeometry);
-}
+    uint64_t MeshletCount = 0;
+    uint64_t VertexCount = 0;
+    uint64_t TriangleCount = 0;
+    for (const FMeshletData& Set : MeshletSets)
+    {
+        MeshletCount += Set.Meshlets.size();
+        VertexCount += Set.Vertices.size();
+        TriangleCount += Set.Triangles.size();
+    }
 
-bool RendererUtils::CreateDefaultSceneGeometry(FDX12Device* Device, FMeshGeometryBuffers& OutGeometry, FFloat3& OutCenter, float& OutRadius, FGltfMaterialTextures* OutTexturePaths)
-{
-    FGltfScene Scene;
-    if (FGltfLoader::LoadSceneFromFile(L"Assets/Duck/Duck.gltf", Scene) && !Scene.Meshes.empty())
+    if (MeshletCount == 0)
     {
-        const FMesh& FirstMesh = Scene.Meshes.front();
-        FFloat3 LocalMin{};
-        FFloat3 LocalMax{};
-        ComputeMeshBounds(FirstMesh, OutCenter, OutRadius, LocalMin, LocalMax);
+        return false;
+    }
 
-        if (OutTexturePaths)
+    const uint64_t VertexRegionOffset = MeshletCount * sizeof(FMeshlet);
+    const uint64_t TriangleRegionOffset = VertexRegionOffset + VertexCount * sizeof(uint32_t);
+    const uint64_t BufferSize = TriangleRegionOffset + TriangleCount * sizeof(uint32_t);
+
+    // Rebase every set onto the shared buffers: meshlet offsets into the combined regions, vertex
+    // indices into the shared vertex buffer and ranges into the combined meshlet array.
+    uint32_t BaseMeshlet = 0;
+    uint32_t BaseMeshletVertex = 0;
+    uint32_t BaseMeshletTriangle = 0;
+    uint32_t BaseVertex = 0;
+    for (size_t MeshIndex = 0; MeshIndex < MeshletSets.size(); ++MeshIndex)
+    {
+        FMeshletData& Set = MeshletSets[MeshIndex];
+        for (FMeshlet& Meshlet : Set.Meshlets)
         {
-            OutTexturePaths->PerPrimitive.clear();
-            if (!Scene.MeshPrimitiveSections.empty())
-            {
-                for (const FGltfPrimitiveSection& Section : Scene.MeshPrimitiveSections.front())
-                {
-                    OutTexturePaths->PerPrimitive.push_back(Section.Material);
-                }
-            }
+            Meshlet.VertexOffset += BaseMeshletVertex;
+            Meshlet.TriangleOffset += BaseMeshletTriangle;
+        }
+        for (uint32_t& Vertex : Set.Vertices)
+        {
+            Vertex += BaseVertex;
+        }
+        for (FMeshletRange& Range : Set.Ranges)
+        {
+            Range.MeshletStart += BaseMeshlet;
         }
 
-        return CreateMeshGeometry(Device, FirstMesh, OutGeometry);
+        BaseMeshlet += static_cast<uint32_t>(Set.Meshlets.size());
+        BaseMeshletVertex += static_cast<uint32_t>(Set.Vertices.size());
+        BaseMeshletTriangle += static_cast<uint32_t>(Set.Triangles.size());
+        BaseVertex += static_cast<uint32_t>(Meshes[MeshIndex]->GetVertices().size());
+    }
+
+    D3D12_HEAP_PROPERTIES UploadHeap = {};
+    UploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
+    UploadHeap.CreationNodeMask = 1;
+    UploadHeap.VisibleNodeMask = 1;
+
+    D3D12_RESOURCE_DESC BufferDesc = {};
+    BufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    BufferDesc.Width = BufferSize;
+    BufferDesc.Height = 1;
+    BufferDesc.DepthOrArraySize = 1;
+    BufferDesc.MipLevels = 1;
+    BufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+    BufferDesc.SampleDesc.Count = 1;
+    BufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+    Microsoft::WRL::ComPtr<ID3D12Resource> MeshletBuffer;
+    HR_CHECK(Device->CreateStaticResource(
+        EGpuMemoryCategory::Geometry,
+        &BufferDesc,
+        D3D12_RESOURCE_STATE_COMMON,
+        IID_PPV_ARGS(MeshletBuffer.GetAddressOf())));
+
+    Microsoft::WRL::ComPtr<ID3D12Resource> StagingBuffer;
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Upload,
+        &UploadHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &BufferDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(StagingBuffer.GetAddressOf())));
+
+    if (!MeshletBuffer || !StagingBuffer)
+    {
+        return false;
+    }
+    MeshletBuffer->SetName(L"SceneMeshletBuffer");
+
+    uint8_t* StagingData = nullptr;
+    D3D12_RANGE EmptyRange = { 0, 0 };
+    HR_CHECK(StagingBuffer->Map(0, &EmptyRange, reinterpret_cast<void**>(&StagingData)));
+
+    uint8_t* MeshletData = StagingData;
+    uint8_t* VertexData = StagingData + VertexRegionOffset;
+    uint8_t* TriangleData = StagingData + TriangleRegionOffset;
+    for (const FMeshletData& Set : MeshletSets)
+    {
+        std::memcpy(MeshletData, Set.Meshlets.data(), Set.Meshlets.size() * sizeof(FMeshlet));
+        std::memcpy(VertexData, Set.Vertices.data(), Set.Vertices.size() * sizeof(uint32_t));
+        std::memcpy(TriangleData, Set.Triangles.data(), Set.Triangles.size() * sizeof(uint32_t));
+        MeshletData += Set.Meshlets.size() * sizeof(FMeshlet);
+        VertexData += Set.Vertices.size() * sizeof(uint32_t);
+        TriangleData += Set.Triangles.size() * sizeof(uint32_t);
     }
+    StagingBuffer->Unmap(0, nullptr);
+
+    FDX12UploadQueue* UploadQueue = Device->GetUploadQueue();
+    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> UploadAllocator;
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> UploadList;
+    if (!UploadQueue->CreateCommandList(UploadAllocator, UploadList))
+    {
+        return false;
+    }
+
+    UploadList->CopyBufferRegion(MeshletBuffer.Get(), 0, StagingBuffer.Get(), 0, BufferSize);
+    if (!UploadQueue->IsCopyQueue())
+    {
+        D3D12_RESOURCE_BARRIER Barrier = {};
+        Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        Barrier.Transition.pResource = MeshletBuffer.Get();
+        Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+        Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        UploadList->ResourceBarrier(1, &Barrier);
+    }
+
+    HR_CHECK(UploadList->Close());
 
-    if (OutTexturePaths)
+    ID3D12CommandList* Lists[] = { UploadList.Get() };
+    UploadQueue->Submit(1, Lists, { StagingBuffer, UploadAllocator, UploadList });
+
+    for (FMeshGeometryBuffers& Geometry : InOutGeometries)
     {
-        OutTexturePaths->PerPrimitive.clear();
+        Geometry.MeshletBuffer = MeshletBuffer;
+        Geometry.MeshletVertexOffset = VertexRegionOffset;
+        Geometry.MeshletTriangleOffset = TriangleRegionOffset;
     }
 
-    const FMesh Cube = FMesh::CreateCube();
-    FFloat3 LocalMin{};
-    FFloat3 LocalMax{};
-    ComputeMeshBounds(Cube, OutCenter, OutRadius, LocalMin, LocalMax);
-    return CreateMeshGeometry(Device, Cube, OutGeometry);
+    std::ostringstream Stream;
+    Stream << "Built " << MeshletCount << " meshlets (" << TriangleCount << " triangles, "
+        << static_cast<double>(VertexCount) / static_cast<double>(MeshletCount) << " vertices per meshlet)";
+    LogInfo(Stream.str());
+    return true;
 }
 
 namespace
@@ -285,6 +648,41 @@ namespace
         OutMax.z = std::max(OutMax.z, ModelCenter.z + ModelRadius);
     }
 
+    void TransformBounds(
+        const DirectX::XMFLOAT3& LocalMin,
+        const DirectX::XMFLOAT3& LocalMax,
+        const DirectX::XMMATRIX& World,
+        DirectX::XMFLOAT3& OutMin,
+        DirectX::XMFLOAT3& OutMax)
+    {
+        using namespace DirectX;
+
+        const std::array<XMVECTOR, 8> LocalCorners =
+        {
+            XMVectorSet(LocalMin.x, LocalMin.y, LocalMin.z, 1.0f),
+            XMVectorSet(LocalMax.x, LocalMin.y, LocalMin.z, 1.0f),
+            XMVectorSet(LocalMin.x, LocalMax.y, LocalMin.z, 1.0f),
+            XMVectorSet(LocalMax.x, LocalMax.y, LocalMin.z, 1.0f),
+            XMVectorSet(LocalMin.x, LocalMin.y, LocalMax.z, 1.0f),
+            XMVectorSet(LocalMax.x, LocalMin.y, LocalMax.z, 1.0f),
+            XMVectorSet(LocalMin.x, LocalMax.y, LocalMax.z, 1.0f),
+            XMVectorSet(LocalMax.x, LocalMax.y, LocalMax.z, 1.0f)
+        };
+
+        XMVECTOR BoundsMin = XMVectorSet(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), 1.0f);
+        XMVECTOR BoundsMax = XMVectorSet(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), 1.0f);
+
+        for (const XMVECTOR Corner : LocalCorners)
+        {
+            const XMVECTOR WorldCorner = XMVector3TransformCoord(Corner, World);
+            BoundsMin = XMVectorMin(BoundsMin, WorldCorner);
+            BoundsMax = XMVectorMax(BoundsMax, WorldCorner);
+        }
+
+        XMStoreFloat3(&OutMin, BoundsMin);
+        XMStoreFloat3(&OutMax, BoundsMax);
+    }
+
     float ComputeMaxScale(const DirectX::XMFLOAT4X4& Matrix)
     {
         const float ScaleX = std::sqrt(Matrix._11 * Matrix._11 + Matrix._21 * Matrix._21 + Matrix._31 * Matrix._31);
@@ -293,6 +691,44 @@ namespace
 
         return (std::max)((std::max)(ScaleX, ScaleY), ScaleZ);
     }
+
+    // Reads the cache entry through DirectStorage when the device has it, otherwise straight from the
+    // mapped file. Both are timed parse included, so the asset I/O log compares like with like.
+    bool LoadCachedSceneModel(FDX12Device* Device, const std::wstring& MeshPath, const FSceneCookSettings& Settings, FCookedModel& OutModel)
+    {
+        CPU_PROFILE_SCOPE("Load Cached Model");
+        const std::wstring EntryPath = FSceneCache::GetEntryPath(MeshPath, Settings);
+        std::error_code Error;
+        const uint64_t FileSize = static_cast<uint64_t>(std::filesystem::file_size(EntryPath, Error));
+        if (Error || FileSize == 0)
+        {
+            return false;
+        }
+
+        const auto StartTime = std::chrono::high_resolution_clock::now();
+        EAssetReadPath ReadPath = EAssetReadPath::MappedFile;
+        bool bLoaded = false;
+        if (FDX12DirectStorage* DirectStorage = Device ? Device->GetDirectStorage() : nullptr)
+        {
+            std::vector<uint8_t> Bytes(static_cast<size_t>(FileSize));
+            if (DirectStorage->ReadToMemory(EntryPath, 0, FileSize, Bytes.data()))
+            {
+                ReadPath = EAssetReadPath::DirectStorage;
+                bLoaded = FSceneCache::LoadFromMemory(Bytes.data(), Bytes.size(), Settings, OutModel);
+            }
+        }
+        if (ReadPath == EAssetReadPath::MappedFile)
+        {
+            bLoaded = FSceneCache::Load(MeshPath, Settings, OutModel);
+        }
+
+        if (bLoaded)
+        {
+            const std::chrono::duration<double> Seconds = std::chrono::high_resolution_clock::now() - StartTime;
+            FDX12DirectStorage::RecordRead(ReadPath, FileSize, Seconds.count());
+        }
+        return bLoaded;
+    }
 }
 
 bool RendererUtils::CreateSceneModelsFromJson(
@@ -300,8 +736,15 @@ bool RendererUtils::CreateSceneModelsFromJson(
     const std::wstring& SceneFilePath,
     std::vector<FSceneModelResource>& OutModels,
     DirectX::XMFLOAT3& OutSceneCenter,
-    float& OutSceneRadius)
+    float& OutSceneRadius,
+    bool bOptimizeMeshes,
+    bool bBuildMeshlets,
+    bool bGenerateLods,
+    FTransformHierarchy* OutTransforms)
 {
+    static_assert(MaxSceneModelLods == FMeshSimplifier::MaxLods, "Scene model LOD slots must match the simplifier.");
+    CPU_PROFILE_SCOPE("Load Scene Models");
+
     OutModels.clear();
     uint32_t NextObjectId = 1;
 
@@ -318,6 +761,26 @@ bool RendererUtils::CreateSceneModelsFromJson(
     DirectX::XMFLOAT3 SceneMin{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
     DirectX::XMFLOAT3 SceneMax{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
 
+    // All glTF files are loaded first so their meshes can share one vertex and one index buffer.
+    // Models with an up-to-date cooked file skip parsing and every processing step below.
+    struct FLoadedSceneModel
+    {
+        const FSceneModelDesc* Desc = nullptr;
+        std::wstring MeshPath;
+        FCookedModel Cooked;
+        size_t FirstMesh = 0;
+        bool bFromCache = false;
+    };
+
+    FSceneCookSettings CookSettings;
+    CookSettings.bOptimizeMeshes = bOptimizeMeshes;
+    CookSettings.bGenerateLods = bGenerateLods;
+    CookSettings.bBuildMeshlets = bBuildMeshlets;
+
+    const auto LoadStartTime = std::chrono::high_resolution_clock::now();
+    size_t CachedModelCount = 0;
+    std::vector<FLoadedSceneModel> LoadedModels;
+    LoadedModels.reserve(Models.size());
     for (const FSceneModelDesc& Model : Models)
     {
         std::filesystem::path MeshPath(Model.MeshPath);
@@ -327,42 +790,223 @@ bool RendererUtils::CreateSceneModelsFromJson(
             MeshPath = AssetsRoot / MeshPath;
         }
 
-        FGltfScene LoadedScene;
-        if (!FGltfLoader::LoadSceneFromFile(MeshPath, LoadedScene))
+        FLoadedSceneModel Loaded;
+        Loaded.Desc = &Model;
+        Loaded.MeshPath = MeshPath.wstring();
+        if (LoadCachedSceneModel(Device, Loaded.MeshPath, CookSettings, Loaded.Cooked))
+        {
+            Loaded.bFromCache = true;
+            ++CachedModelCount;
+            LoadedModels.push_back(std::move(Loaded));
+            continue;
+        }
+
+        FGltfScene& Scene = Loaded.Cooked.Scene;
+        if (!FGltfLoader::LoadSceneFromFile(Loaded.MeshPath, Scene))
         {
             LogError("Failed to load mesh from scene: " + PathToUtf8String(MeshPath));
             continue;
         }
 
-        if (LoadedScene.Meshes.empty())
+        if (Scene.Meshes.empty())
         {
             LogError("No meshes found in glTF: " + PathToUtf8String(MeshPath));
             continue;
         }
 
-        std::vector<FMeshGeometryBuffers> MeshGeometries(LoadedScene.Meshes.size());
-        std::vector<FFloat3> MeshCenters(LoadedScene.Meshes.size());
-        std::vector<float> MeshRadii(LoadedScene.Meshes.size());
-        std::vector<FFloat3> MeshMins(LoadedScene.Meshes.size());
-        std::vector<FFloat3> MeshMaxs(LoadedScene.Meshes.size());
+        // Meshes without primitive sections draw their whole index buffer with the default material.
+        // Recorded before LOD indices are appended, which would otherwise count as geometry.
+        Scene.MeshPrimitiveSections.resize(Scene.Meshes.size());
+        for (size_t MeshIndex = 0; MeshIndex < Scene.Meshes.size(); ++MeshIndex)
+        {
+            std::vector<FGltfPrimitiveSection>& Sections = Scene.MeshPrimitiveSections[MeshIndex];
+            if (Sections.empty())
+            {
+                FGltfPrimitiveSection& Section = Sections.emplace_back();
+                Section.IndexCount = static_cast<uint32_t>(Scene.Meshes[MeshIndex].GetIndices().size());
+            }
+        }
 
-        for (size_t MeshIndex = 0; MeshIndex < LoadedScene.Meshes.size(); ++MeshIndex)
+        Loaded.Cooked.MeshLods.resize(Scene.Meshes.size());
+        Loaded.Cooked.MeshBounds.resize(Scene.Meshes.size());
+        if (bBuildMeshlets)
         {
-            const FMesh& Mesh = LoadedScene.Meshes[MeshIndex];
-            ComputeMeshBounds(Mesh, MeshCenters[MeshIndex], MeshRadii[MeshIndex], MeshMins[MeshIndex], MeshMaxs[MeshIndex]);
+            Loaded.Cooked.MeshMeshlets.resize(Scene.Meshes.size());
+        }
+        LoadedModels.push_back(std::move(Loaded));
+    }
+
+    // Processing below only runs for models that were not loaded from the cache.
+    struct FMeshCookWork
+    {
+        FMesh* Mesh = nullptr;
+        std::vector<FMeshIndexRange> Ranges;
+        std::vector<std::vector<FMeshLod>>* Lods = nullptr;
+        FCookedMeshBounds* Bounds = nullptr;
+        FMeshletData* Meshlets = nullptr;
+        float AcmrBefore = 0.0f;
+        float AcmrAfter = 0.0f;
+    };
 
-            if (!CreateMeshGeometry(Device, Mesh, MeshGeometries[MeshIndex]))
+    std::vector<FMeshCookWork> MeshWork;
+    for (FLoadedSceneModel& Loaded : LoadedModels)
+    {
+        if (Loaded.bFromCache)
+        {
+            continue;
+        }
+
+        FCookedModel& Cooked = Loaded.Cooked;
+        for (size_t MeshIndex = 0; MeshIndex < Cooked.Scene.Meshes.size(); ++MeshIndex)
+        {
+            FMeshCookWork Work;
+            Work.Mesh = &Cooked.Scene.Meshes[MeshIndex];
+            for (const FGltfPrimitiveSection& Section : Cooked.Scene.MeshPrimitiveSections[MeshIndex])
             {
-                LogError("Failed to create geometry for scene mesh: " + PathToUtf8String(MeshPath));
-                MeshGeometries.clear();
-                break;
+                Work.Ranges.push_back({ Section.IndexStart, Section.IndexCount });
             }
+            Work.Lods = &Cooked.MeshLods[MeshIndex];
+            Work.Bounds = &Cooked.MeshBounds[MeshIndex];
+            Work.Meshlets = bBuildMeshlets ? &Cooked.MeshMeshlets[MeshIndex] : nullptr;
+            MeshWork.push_back(std::move(Work));
         }
+    }
 
-        if (MeshGeometries.empty())
+    // Reorder triangles and vertices before upload so every pass drawing the meshes benefits.
+    if (bOptimizeMeshes && !MeshWork.empty())
+    {
+        CPU_PROFILE_SCOPE("Optimize Meshes");
+        const auto StartTime = std::chrono::high_resolution_clock::now();
+        FParallelFor::Execute(0, static_cast<uint32_t>(MeshWork.size()), [&MeshWork](uint32_t WorkIndex)
         {
-            continue;
+            FMeshCookWork& Work = MeshWork[WorkIndex];
+            const auto ComputeMeshAcmr = [&Work]()
+            {
+                const std::vector<uint32_t>& Indices = Work.Mesh->GetIndices();
+                return FMeshOptimizer::ComputeAcmr(Indices.data(), static_cast<uint32_t>(Indices.size()), static_cast<uint32_t>(Work.Mesh->GetVertices().size()));
+            };
+
+            Work.AcmrBefore = ComputeMeshAcmr();
+            FMeshOptimizer::Optimize(*Work.Mesh, Work.Ranges);
+            Work.AcmrAfter = ComputeMeshAcmr();
+        });
+        const auto Duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - StartTime);
+
+        double TriangleCount = 0.0;
+        double MissesBefore = 0.0;
+        double MissesAfter = 0.0;
+        for (const FMeshCookWork& Work : MeshWork)
+        {
+            const double MeshTriangles = static_cast<double>(Work.Mesh->GetIndices().size() / 3);
+            TriangleCount += MeshTriangles;
+            MissesBefore += Work.AcmrBefore * MeshTriangles;
+            MissesAfter += Work.AcmrAfter * MeshTriangles;
+        }
+
+        if (TriangleCount > 0.0)
+        {
+            std::ostringstream Stream;
+            Stream.setf(std::ios::fixed);
+            Stream.precision(3);
+            Stream << "Optimized " << MeshWork.size() << " meshes in " << Duration.count() << " ms, ACMR "
+                << MissesBefore / TriangleCount << " -> " << MissesAfter / TriangleCount;
+            LogInfo(Stream.str());
+        }
+    }
+
+    // Coarser index lists per primitive section, appended to each mesh's index buffer before upload.
+    if (bGenerateLods && !MeshWork.empty())
+    {
+        CPU_PROFILE_SCOPE("Generate LODs");
+        const auto StartTime = std::chrono::high_resolution_clock::now();
+        FParallelFor::Execute(0, static_cast<uint32_t>(MeshWork.size()), [&MeshWork](uint32_t WorkIndex)
+        {
+            FMeshCookWork& Work = MeshWork[WorkIndex];
+            FMeshSimplifier::GenerateLods(*Work.Mesh, Work.Ranges, *Work.Lods);
+        });
+        const auto Duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - StartTime);
+
+        size_t LodCount = 0;
+        for (const FMeshCookWork& Work : MeshWork)
+        {
+            for (const std::vector<FMeshLod>& Lods : *Work.Lods)
+            {
+                LodCount += Lods.size();
+            }
+        }
+
+        std::ostringstream Stream;
+        Stream << "Generated " << LodCount << " LODs for " << MeshWork.size() << " meshes in " << Duration.count() << " ms";
+        LogInfo(Stream.str());
+    }
+
+    // One meshlet set per mesh with one range per primitive section, and bounds of the final vertices.
+    FParallelFor::Execute(0, static_cast<uint32_t>(MeshWork.size()), [&MeshWork](uint32_t WorkIndex)
+    {
+        FMeshCookWork& Work = MeshWork[WorkIndex];
+        if (Work.Meshlets)
+        {
+            FMeshletBuilder::Build(*Work.Mesh, Work.Ranges, *Work.Meshlets);
+        }
+        ComputeMeshBounds(*Work.Mesh, Work.Bounds->Center, Work.Bounds->Radius, Work.Bounds->Min, Work.Bounds->Max);
+    });
+
+    for (const FLoadedSceneModel& Loaded : LoadedModels)
+    {
+        if (!Loaded.bFromCache && !FSceneCache::Store(Loaded.MeshPath, CookSettings, Loaded.Cooked))
+        {
+            LogWarning("Failed to write scene cache entry for: " + PathToUtf8String(Loaded.MeshPath));
+        }
+    }
+
+    {
+        const auto Duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - LoadStartTime);
+        std::ostringstream Stream;
+        Stream << "Loaded " << LoadedModels.size() << " scene models (" << CachedModelCount << " from scene cache) in " << Duration.count() << " ms";
+        LogInfo(Stream.str());
+    }
+
+    std::vector<const FMesh*> SceneMeshes;
+    std::vector<FMeshletData> SceneMeshlets;
+    for (FLoadedSceneModel& Loaded : LoadedModels)
+    {
+        Loaded.FirstMesh = SceneMeshes.size();
+        for (const FMesh& Mesh : Loaded.Cooked.Scene.Meshes)
+        {
+            SceneMeshes.push_back(&Mesh);
+        }
+        // Moved out because the upload rebases them in place.
+        for (FMeshletData& Meshlets : Loaded.Cooked.MeshMeshlets)
+        {
+            SceneMeshlets.push_back(std::move(Meshlets));
+        }
+    }
+
+    std::vector<FMeshGeometryBuffers> SceneGeometries;
+    if (!SceneMeshes.empty() && !CreateSharedMeshGeometry(Device, SceneMeshes, SceneGeometries))
+    {
+        LogError("Failed to create scene geometry buffers: " + ScenePathUtf8);
+        return false;
+    }
+
+    if (bBuildMeshlets && !SceneMeshes.empty() && SceneMeshlets.size() == SceneMeshes.size())
+    {
+        if (!CreateSharedMeshletBuffer(Device, SceneMeshes, SceneMeshlets, SceneGeometries))
+        {
+            LogWarning("Failed to create scene meshlet buffer, the mesh shader path is unavailable: " + ScenePathUtf8);
+            SceneMeshlets.clear();
         }
+    }
+    else
+    {
+        SceneMeshlets.clear();
+    }
+
+    for (FLoadedSceneModel& Loaded : LoadedModels)
+    {
+        const FSceneModelDesc& Model = *Loaded.Desc;
+        FGltfScene& LoadedScene = Loaded.Cooked.Scene;
+        const FMeshGeometryBuffers* MeshGeometries = SceneGeometries.data() + Loaded.FirstMesh;
 
         if (LoadedScene.Nodes.empty())
         {
@@ -380,6 +1024,24 @@ bool RendererUtils::CreateSceneModelsFromJson(
             }
         }
 
+        const DirectX::XMMATRIX ModelScale = DirectX::XMMatrixScaling(Model.Scale.x, Model.Scale.y, Model.Scale.z);
+        const DirectX::XMMATRIX ModelRotation = DirectX::XMMatrixRotationRollPitchYaw(
+            DirectX::XMConvertToRadians(Model.RotationEuler.x),
+            DirectX::XMConvertToRadians(Model.RotationEuler.y),
+            DirectX::XMConvertToRadians(Model.RotationEuler.z));
+        const DirectX::XMMATRIX ModelTranslation = DirectX::XMMatrixTranslation(Model.Position.x, Model.Position.y, Model.Position.z);
+        const DirectX::XMMATRIX ModelRoot = ModelScale * ModelRotation * ModelTranslation;
+
+        // The scene JSON placement is the parent of the model's glTF nodes, whose baked world
+        // matrices become their local matrices.
+        uint32_t RootTransformNode = UINT32_MAX;
+        if (OutTransforms)
+        {
+            DirectX::XMFLOAT4X4 RootMatrix;
+            DirectX::XMStoreFloat4x4(&RootMatrix, ModelRoot);
+            RootTransformNode = OutTransforms->AddNode(RootMatrix);
+        }
+
         for (const FGltfNode& LoadedNode : LoadedScene.Nodes)
         {
             if (LoadedNode.MeshIndex < 0 || static_cast<size_t>(LoadedNode.MeshIndex) >= LoadedScene.Meshes.size())
@@ -387,12 +1049,15 @@ bool RendererUtils::CreateSceneModelsFromJson(
                 continue;
             }
 
+            const uint32_t TransformNode = OutTransforms ? OutTransforms->AddNode(LoadedNode.WorldMatrix, RootTransformNode) : UINT32_MAX;
+
             const size_t MeshIndex = static_cast<size_t>(LoadedNode.MeshIndex);
 
-            const FFloat3 MeshCenter = MeshCenters[MeshIndex];
-            float MeshRadius = MeshRadii[MeshIndex];
-            const FFloat3 MeshMin = MeshMins[MeshIndex];
-            const FFloat3 MeshMax = MeshMaxs[MeshIndex];
+            const FCookedMeshBounds& MeshBounds = Loaded.Cooked.MeshBounds[MeshIndex];
+            const FFloat3 MeshCenter = MeshBounds.Center;
+            float MeshRadius = MeshBounds.Radius;
+            const FFloat3 MeshMin = MeshBounds.Min;
+            const FFloat3 MeshMax = MeshBounds.Max;
 
             const std::array<float, 3> ScaleComponents = { Model.Scale.x, Model.Scale.y, Model.Scale.z };
             float MaxScale = 0.0f;
@@ -408,66 +1073,50 @@ bool RendererUtils::CreateSceneModelsFromJson(
             using namespace DirectX;
 
             const XMMATRIX NodeWorld = XMLoadFloat4x4(&LoadedNode.WorldMatrix);
-            const XMMATRIX Scale = XMMatrixScaling(Model.Scale.x, Model.Scale.y, Model.Scale.z);
-            const XMMATRIX Rotation = XMMatrixRotationRollPitchYaw(
-                XMConvertToRadians(Model.RotationEuler.x),
-                XMConvertToRadians(Model.RotationEuler.y),
-                XMConvertToRadians(Model.RotationEuler.z));
-            const XMMATRIX Translation = XMMatrixTranslation(Model.Position.x, Model.Position.y, Model.Position.z);
-
-            const XMMATRIX World = NodeWorld * Scale * Rotation * Translation;
-
-            const std::array<XMVECTOR, 8> LocalCorners =
-            {
-                XMVectorSet(MeshMin.x, MeshMin.y, MeshMin.z, 1.0f),
-                XMVectorSet(MeshMax.x, MeshMin.y, MeshMin.z, 1.0f),
-                XMVectorSet(MeshMin.x, MeshMax.y, MeshMin.z, 1.0f),
-                XMVectorSet(MeshMax.x, MeshMax.y, MeshMin.z, 1.0f),
-                XMVectorSet(MeshMin.x, MeshMin.y, MeshMax.z, 1.0f),
-                XMVectorSet(MeshMax.x, MeshMin.y, MeshMax.z, 1.0f),
-                XMVectorSet(MeshMin.x, MeshMax.y, MeshMax.z, 1.0f),
-                XMVectorSet(MeshMax.x, MeshMax.y, MeshMax.z, 1.0f)
-            };
-
-            XMVECTOR BoundsMin = XMVectorSet(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), 1.0f);
-            XMVECTOR BoundsMax = XMVectorSet(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), 1.0f);
+            const XMMATRIX World = NodeWorld * ModelRoot;
 
-            for (const XMVECTOR Corner : LocalCorners)
-            {
-                const XMVECTOR WorldCorner = XMVector3TransformCoord(Corner, World);
-                BoundsMin = XMVectorMin(BoundsMin, WorldCorner);
-                BoundsMax = XMVectorMax(BoundsMax, WorldCorner);
-            }
+            XMFLOAT3 BoundsMin;
+            XMFLOAT3 BoundsMax;
+            TransformBounds(MeshMin, MeshMax, World, BoundsMin, BoundsMax);
 
             const std::string BaseName = LoadedNode.Name.empty() ? ("Mesh_" + std::to_string(MeshIndex)) : LoadedNode.Name;
 
-            std::vector<FGltfPrimitiveSection> DefaultSections;
-            const std::vector<FGltfPrimitiveSection>* PrimitiveSections = nullptr;
-            if (MeshIndex < LoadedScene.MeshPrimitiveSections.size())
-            {
-                PrimitiveSections = &LoadedScene.MeshPrimitiveSections[MeshIndex];
-            }
+            // Never empty; meshes without sections got a default one at load.
+            const std::vector<FGltfPrimitiveSection>& PrimitiveSections = LoadedScene.MeshPrimitiveSections[MeshIndex];
 
-            if (!PrimitiveSections || PrimitiveSections->empty())
-            {
-                FGltfPrimitiveSection Section;
-                Section.IndexStart = 0;
-                Section.IndexCount = MeshGeometries[MeshIndex].IndexCount;
-                DefaultSections.push_back(Section);
-                PrimitiveSections = &DefaultSections;
-            }
-
-            const size_t SectionCount = PrimitiveSections->size();
+            const size_t SectionCount = PrimitiveSections.size();
             for (size_t SectionIndex = 0; SectionIndex < SectionCount; ++SectionIndex)
             {
-                const FGltfPrimitiveSection& Section = (*PrimitiveSections)[SectionIndex];
+                const FGltfPrimitiveSection& Section = PrimitiveSections[SectionIndex];
 
                 FSceneModelResource ModelResource = {};
                 ModelResource.Geometry = MeshGeometries[MeshIndex];
-                ModelResource.DrawIndexStart = Section.IndexStart;
+                ModelResource.DrawIndexStart = MeshGeometries[MeshIndex].FirstIndex + Section.IndexStart;
                 ModelResource.DrawIndexCount = Section.IndexCount;
+                ModelResource.Lods[0] = { ModelResource.DrawIndexStart, ModelResource.DrawIndexCount, 0.0f };
+                const std::vector<std::vector<FMeshLod>>& RangeLods = Loaded.Cooked.MeshLods[MeshIndex];
+                if (SectionIndex < RangeLods.size())
+                {
+                    for (const FMeshLod& Lod : RangeLods[SectionIndex])
+                    {
+                        FSceneModelLod& ModelLod = ModelResource.Lods[ModelResource.LodCount++];
+                        ModelLod.IndexStart = MeshGeometries[MeshIndex].FirstIndex + Lod.IndexStart;
+                        ModelLod.IndexCount = Lod.IndexCount;
+                        ModelLod.Error = Lod.Error * MaxScale * NodeScale;
+                    }
+                }
+                if (!SceneMeshlets.empty())
+                {
+                    const FMeshletData& Meshlets = SceneMeshlets[Loaded.FirstMesh + MeshIndex];
+                    if (SectionIndex < Meshlets.Ranges.size())
+                    {
+                        ModelResource.MeshletStart = Meshlets.Ranges[SectionIndex].MeshletStart;
+                        ModelResource.MeshletCount = Meshlets.Ranges[SectionIndex].MeshletCount;
+                    }
+                }
 
                 XMStoreFloat4x4(&ModelResource.WorldMatrix, World);
+                ModelResource.PrevWorldMatrix = ModelResource.WorldMatrix;
 
                 const XMVECTOR CenterVec = XMVector3TransformCoord(XMVectorSet(MeshCenter.x, MeshCenter.y, MeshCenter.z, 1.0f), World);
                 XMStoreFloat3(&ModelResource.Center, CenterVec);
@@ -484,8 +1133,13 @@ bool RendererUtils::CreateSceneModelsFromJson(
 
                 ModelResource.ObjectId = NextObjectId++;
 
-                XMStoreFloat3(&ModelResource.BoundsMin, BoundsMin);
-                XMStoreFloat3(&ModelResource.BoundsMax, BoundsMax);
+                ModelResource.BoundsMin = BoundsMin;
+                ModelResource.BoundsMax = BoundsMax;
+                ModelResource.LocalBoundsMin = MeshMin;
+                ModelResource.LocalBoundsMax = MeshMax;
+                ModelResource.LocalCenter = MeshCenter;
+                ModelResource.LocalRadius = MeshBounds.Radius;
+                ModelResource.TransformNode = TransformNode;
 
                 const std::wstring EmptyTexture;
                 const FGltfMaterialTextureSet& Material = Section.Material;
@@ -542,6 +1196,17 @@ bool RendererUtils::CreateSceneModelsFromJson(
     return true;
 }
 
+void RendererUtils::SetSceneModelWorldMatrix(FSceneModelResource& Model, const DirectX::XMFLOAT4X4& WorldMatrix)
+{
+    using namespace DirectX;
+
+    const XMMATRIX World = XMLoadFloat4x4(&WorldMatrix);
+    Model.WorldMatrix = WorldMatrix;
+    TransformBounds(Model.LocalBoundsMin, Model.LocalBoundsMax, World, Model.BoundsMin, Model.BoundsMax);
+    XMStoreFloat3(&Model.Center, XMVector3TransformCoord(XMLoadFloat3(&Model.LocalCenter), World));
+    Model.Radius = Model.LocalRadius * ComputeMaxScale(WorldMatrix);
+}
+
 bool RendererUtils::CreateDepthResources(FDX12Device* Device, uint32_t Width, uint32_t Height, DXGI_FORMAT Format, FDepthResources& OutDepthResources)
 {
     if (Device == nullptr)
@@ -577,7 +1242,8 @@ bool RendererUtils::CreateDepthResources(FDX12Device* Device, uint32_t Width, ui
     HeapProps.CreationNodeMask = 1;
     HeapProps.VisibleNodeMask = 1;
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::RenderTarget,
         &HeapProps,
         D3D12_HEAP_FLAG_NONE,
         &Desc,
@@ -637,7 +1303,8 @@ bool RendererUtils::CreateObjectIdResources(
     D3D12_HEAP_PROPERTIES HeapProps = {};
     HeapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::RenderTarget,
         &HeapProps,
         D3D12_HEAP_FLAG_NONE,
         &Desc,
@@ -678,7 +1345,8 @@ bool RendererUtils::CreateObjectIdResources(
 
     D3D12_HEAP_PROPERTIES ReadbackProps = {};
     ReadbackProps.Type = D3D12_HEAP_TYPE_READBACK;
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Readback,
         &ReadbackProps,
         D3D12_HEAP_FLAG_NONE,
         &BufferDesc,
@@ -717,18 +1385,9 @@ bool RendererUtils::CreateObjectIdPipeline(
         return false;
     }
 
-    D3D12_INPUT_ELEMENT_DESC InputLayout[] =
-    {
-        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0,   D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 24,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "TANGENT",  0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "COLOR",    0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 48, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-    };
-
     D3D12_GRAPHICS_PIPELINE_STATE_DESC PsoDesc = {};
     PsoDesc.pRootSignature = RootSignature;
-    PsoDesc.InputLayout = { InputLayout, _countof(InputLayout) };
+    PsoDesc.InputLayout = GetMeshPositionInputLayout();
     PsoDesc.VS = { VSByteCode.data(), VSByteCode.size() };
     PsoDesc.PS = { PSByteCode.data(), PSByteCode.size() };
     PsoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
@@ -755,7 +1414,7 @@ bool RendererUtils::CreateObjectIdPipeline(
     PsoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_GREATER_EQUAL;
     PsoDesc.DepthStencilState.StencilEnable = FALSE;
 
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(OutPipelineState.ReleaseAndGetAddressOf())));
+    HR_CHECK(Device->GetPipelineCache()->CreateGraphicsPipelineState(PsoDesc, OutPipelineState.ReleaseAndGetAddressOf()));
     return true;
 }
 
@@ -827,193 +1486,346 @@ bool RendererUtils::ComputeSceneModelStats(
     return true;
 }
 
-void RendererUtils::UpdateCullingVisibility(
-    const FCamera& Camera,
+void RendererUtils::BuildSceneBoundsSoA(
     const std::vector<FSceneModelResource>& Models,
-    std::vector<bool>& OutVisibility)
+    FSceneBoundsSoA& OutBounds)
 {
-    OutVisibility.assign(Models.size(), true);
-    DirectX::XMVECTOR Planes[6] = {};
-    RendererUtils::BuildCameraFrustumPlanes(Camera, Planes);
+    const size_t PaddedCount = (Models.size() + FSceneBoundsSoA::LaneCount - 1) / FSceneBoundsSoA::LaneCount * FSceneBoundsSoA::LaneCount;
+    OutBounds.MinX.assign(PaddedCount, 0.0f);
+    OutBounds.MinY.assign(PaddedCount, 0.0f);
+    OutBounds.MinZ.assign(PaddedCount, 0.0f);
+    OutBounds.MaxX.assign(PaddedCount, 0.0f);
+    OutBounds.MaxY.assign(PaddedCount, 0.0f);
+    OutBounds.MaxZ.assign(PaddedCount, 0.0f);
+    OutBounds.Count = static_cast<uint32_t>(Models.size());
+
     for (size_t ModelIndex = 0; ModelIndex < Models.size(); ++ModelIndex)
     {
         const FSceneModelResource& Model = Models[ModelIndex];
-        OutVisibility[ModelIndex] = RendererUtils::IsAabbInCameraFrustum(Planes, Model.BoundsMin, Model.BoundsMax);
+        OutBounds.MinX[ModelIndex] = Model.BoundsMin.x;
+        OutBounds.MinY[ModelIndex] = Model.BoundsMin.y;
+        OutBounds.MinZ[ModelIndex] = Model.BoundsMin.z;
+        OutBounds.MaxX[ModelIndex] = Model.BoundsMax.x;
+        OutBounds.MaxY[ModelIndex] = Model.BoundsMax.y;
+        OutBounds.MaxZ[ModelIndex] = Model.BoundsMax.z;
     }
 }
 
-bool RendererUtils::CreateMappedConstantBuffer(FDX12Device* Device, uint64_t BufferSize, FMappedConstantBuffer& OutConstantBuffer)
+void RendererUtils::CullSceneBoundsSoA(
+    const DirectX::XMVECTOR Planes[6],
+    const FSceneBoundsSoA& Bounds,
+    std::vector<uint32_t>& OutVisibleIndices)
 {
-    if (Device == nullptr)
+    using namespace DirectX;
+
+    constexpr uint32_t LaneCount = FSceneBoundsSoA::LaneCount;
+    if (Bounds.Count == 0)
     {
-        return false;
+        return;
     }
 
-    const uint64_t ConstantBufferSize = (BufferSize + 255ULL) & ~255ULL;
+    CPU_PROFILE_SCOPE("Frustum Cull");
 
-    D3D12_HEAP_PROPERTIES UploadHeap = {};
-    UploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
-    UploadHeap.CreationNodeMask = 1;
-    UploadHeap.VisibleNodeMask = 1;
+    // The vertex furthest along each plane normal depends only on the normal's signs, so every
+    // plane reads one fixed array per axis for all boxes, as IsAabbInCameraFrustum does per box.
+    struct FPlaneStreams
+    {
+        XMVECTOR NormalX;
+        XMVECTOR NormalY;
+        XMVECTOR NormalZ;
+        XMVECTOR Distance;
+        const float* X;
+        const float* Y;
+        const float* Z;
+    };
 
-    D3D12_RESOURCE_DESC BufferDesc = {};
-    BufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    BufferDesc.Width = ConstantBufferSize;
-    BufferDesc.Height = 1;
-    BufferDesc.DepthOrArraySize = 1;
-    BufferDesc.MipLevels = 1;
-    BufferDesc.Format = DXGI_FORMAT_UNKNOWN;
-    BufferDesc.SampleDesc.Count = 1;
-    BufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    FPlaneStreams PlaneStreams[6];
+    for (int PlaneIndex = 0; PlaneIndex < 6; ++PlaneIndex)
+    {
+        const XMVECTOR Plane = Planes[PlaneIndex];
+        FPlaneStreams& Streams = PlaneStreams[PlaneIndex];
+        Streams.NormalX = XMVectorSplatX(Plane);
+        Streams.NormalY = XMVectorSplatY(Plane);
+        Streams.NormalZ = XMVectorSplatZ(Plane);
+        Streams.Distance = XMVectorSplatW(Plane);
+        Streams.X = XMVectorGetX(Plane) >= 0.0f ? Bounds.MaxX.data() : Bounds.MinX.data();
+        Streams.Y = XMVectorGetY(Plane) >= 0.0f ? Bounds.MaxY.data() : Bounds.MinY.data();
+        Streams.Z = XMVectorGetZ(Plane) >= 0.0f ? Bounds.MaxZ.data() : Bounds.MinZ.data();
+    }
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
-        &UploadHeap,
-        D3D12_HEAP_FLAG_NONE,
-        &BufferDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(OutConstantBuffer.Resource.GetAddressOf())));
+    const uint32_t GroupCount = (Bounds.Count + LaneCount - 1) / LaneCount;
+    std::vector<uint8_t> GroupMasks(GroupCount, 0);
 
-    OutConstantBuffer.Resource->SetName(L"MappedConstantBuffer");
+    FParallelFor::ExecuteRange(0, GroupCount, [&](uint32_t GroupBegin, uint32_t GroupEnd)
+    {
+        CPU_PROFILE_SCOPE("Frustum Cull Chunk");
+        const XMVECTOR Zero = XMVectorZero();
+        for (uint32_t Group = GroupBegin; Group < GroupEnd; ++Group)
+        {
+            const size_t First = static_cast<size_t>(Group) * LaneCount;
+            XMVECTOR Inside = XMVectorTrueInt();
+            for (const FPlaneStreams& Streams : PlaneStreams)
+            {
+                const XMVECTOR X = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(Streams.X + First));
+                const XMVECTOR Y = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(Streams.Y + First));
+                const XMVECTOR Z = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(Streams.Z + First));
 
-    D3D12_RANGE EmptyRange = { 0, 0 };
-    HR_CHECK(OutConstantBuffer.Resource->Map(0, &EmptyRange, reinterpret_cast<void**>(&OutConstantBuffer.MappedData)));
-    return true;
+                XMVECTOR Distance = XMVectorMultiplyAdd(Streams.NormalX, X, Streams.Distance);
+                Distance = XMVectorMultiplyAdd(Streams.NormalY, Y, Distance);
+                Distance = XMVectorMultiplyAdd(Streams.NormalZ, Z, Distance);
+                Inside = XMVectorAndInt(Inside, XMVectorGreaterOrEqual(Distance, Zero));
+
+                if (XMVector4EqualInt(Inside, Zero))
+                {
+                    break;
+                }
+            }
+
+            XMUINT4 LaneMasks;
+            XMStoreUInt4(&LaneMasks, Inside);
+            GroupMasks[Group] = static_cast<uint8_t>(
+                (LaneMasks.x & 1u) | ((LaneMasks.y & 1u) << 1) | ((LaneMasks.z & 1u) << 2) | ((LaneMasks.w & 1u) << 3));
+        }
+    }, MinCullingGroupsPerChunk);
+
+    // The last group's padding lanes are dropped here rather than given never-visible bounds.
+    for (uint32_t Group = 0; Group < GroupCount; ++Group)
+    {
+        const uint32_t Mask = GroupMasks[Group];
+        if (Mask == 0)
+        {
+            continue;
+        }
+        for (uint32_t Lane = 0; Lane < LaneCount; ++Lane)
+        {
+            const uint32_t Index = Group * LaneCount + Lane;
+            if ((Mask & (1u << Lane)) != 0 && Index < Bounds.Count)
+            {
+                OutVisibleIndices.push_back(Index);
+            }
+        }
+    }
 }
 
-bool RendererUtils::CreateSkyAtmosphereResources(
-    FDX12Device* Device,
-    float SkySphereRadius,
-    FMeshGeometryBuffers& OutGeometry,
-    Microsoft::WRL::ComPtr<ID3D12Resource>& OutConstantBuffer,
-    uint8_t*& OutConstantBufferMapped)
+void RendererUtils::UpdateCullingVisibility(
+    const FCamera& Camera,
+    const std::vector<FSceneModelResource>& Models,
+    const FSceneBvh& SceneBvh,
+    const FSceneBoundsSoA& SceneBounds,
+    std::vector<uint32_t>& ScratchIndices,
+    std::vector<bool>& OutVisibility)
 {
-    FMappedConstantBuffer SkyConstantBuffer = {};
-    if (!CreateMappedConstantBuffer(Device, sizeof(FSkyAtmosphereConstants), SkyConstantBuffer))
+    const DirectX::XMMATRIX ViewProjection = DirectX::XMMatrixMultiply(Camera.GetViewMatrix(), Camera.GetProjectionMatrix());
+    UpdateFrustumVisibility(ViewProjection, Models, SceneBvh, SceneBounds, ScratchIndices, OutVisibility);
+}
+
+void RendererUtils::UpdateFrustumVisibility(
+    const DirectX::XMMATRIX& ViewProjection,
+    const std::vector<FSceneModelResource>& Models,
+    const FSceneBvh& SceneBvh,
+    const FSceneBoundsSoA& SceneBounds,
+    std::vector<uint32_t>& ScratchIndices,
+    std::vector<bool>& OutVisibility)
+{
+    CPU_PROFILE_SCOPE("Update Frustum Visibility");
+    DirectX::XMVECTOR Planes[6] = {};
+    RendererUtils::BuildFrustumPlanesFromMatrix(ViewProjection, Planes);
+
+    const bool bFlatBoundsValid = SceneBounds.Count == Models.size();
+    const bool bBvhValid = SceneBvh.GetObjectCount() == Models.size();
+
+    ScratchIndices.clear();
+    if (bFlatBoundsValid && (!bBvhValid || Models.size() <= MaxFlatCullingModels))
     {
-        return false;
+        RendererUtils::CullSceneBoundsSoA(Planes, SceneBounds, ScratchIndices);
+    }
+    else if (bBvhValid)
+    {
+        SceneBvh.QueryFrustum(Planes, ScratchIndices);
+    }
+    else
+    {
+        for (size_t ModelIndex = 0; ModelIndex < Models.size(); ++ModelIndex)
+        {
+            const FSceneModelResource& Model = Models[ModelIndex];
+            if (RendererUtils::IsAabbInCameraFrustum(Planes, Model.BoundsMin, Model.BoundsMax))
+            {
+                ScratchIndices.push_back(static_cast<uint32_t>(ModelIndex));
+            }
+        }
     }
 
-    OutConstantBuffer = SkyConstantBuffer.Resource;
-    OutConstantBufferMapped = SkyConstantBuffer.MappedData;
-
-    return CreateSphereGeometry(Device, OutGeometry, SkySphereRadius, 64, 32);
+    OutVisibility.assign(Models.size(), false);
+    for (uint32_t ModelIndex : ScratchIndices)
+    {
+        OutVisibility[ModelIndex] = true;
+    }
 }
 
-bool RendererUtils::CreateSkyAtmospherePipeline(
-    FDX12Device* Device,
-    DXGI_FORMAT BackBufferFormat,
-    const FSkyPipelineConfig& Config,
-    Microsoft::WRL::ComPtr<ID3D12RootSignature>& OutRootSignature,
-    Microsoft::WRL::ComPtr<ID3D12PipelineState>& OutPipelineState)
+void RendererUtils::BuildCameraRay(
+    const FCamera& Camera,
+    float NdcX,
+    float NdcY,
+    DirectX::XMFLOAT3& OutOrigin,
+    DirectX::XMFLOAT3& OutDirection)
 {
-    if (Device == nullptr)
+    using namespace DirectX;
+
+    const XMMATRIX ViewProjection = XMMatrixMultiply(Camera.GetViewMatrix(), Camera.GetProjectionMatrix());
+    const XMMATRIX InverseViewProjection = XMMatrixInverse(nullptr, ViewProjection);
+
+    // Reversed or not, depth 0 and 1 are the two clip planes, so the ray direction is the same.
+    const XMVECTOR NearPoint = XMVector3TransformCoord(XMVectorSet(NdcX, NdcY, 0.0f, 1.0f), InverseViewProjection);
+    const XMVECTOR FarPoint = XMVector3TransformCoord(XMVectorSet(NdcX, NdcY, 1.0f, 1.0f), InverseViewProjection);
+    XMVECTOR Direction = XMVector3Normalize(XMVectorSubtract(FarPoint, NearPoint));
+    if (XMVectorGetX(XMVector3Dot(Direction, XMLoadFloat3(&Camera.GetForward()))) < 0.0f)
     {
-        return false;
+        Direction = XMVectorNegate(Direction);
     }
 
-    FShaderCompiler Compiler;
-    std::vector<uint8_t> VSByteCode;
-    std::vector<uint8_t> PSByteCode;
+    XMStoreFloat3(&OutOrigin, XMLoadFloat3(&Camera.GetPosition()));
+    XMStoreFloat3(&OutDirection, Direction);
+}
 
-    const D3D_SHADER_MODEL ShaderModel = Device->GetShaderModel();
-    const std::wstring VSTarget = BuildShaderTarget(L"vs", ShaderModel);
-    const std::wstring PSTarget = BuildShaderTarget(L"ps", ShaderModel);
+FModelCullingData RendererUtils::BuildModelCullingData(const FSceneModelResource& Model)
+{
+    FModelCullingData Data;
+    Data.BoundsMin = Model.BoundsMin;
+    Data.BoundsMax = Model.BoundsMax;
+    Data.LodCount = (std::max)(1u, (std::min)(Model.LodCount, MaxSceneModelLods));
+    // Level 0 always mirrors the draw range, so models built without LODs draw unchanged.
+    Data.Lods[0] = { Model.DrawIndexStart, Model.DrawIndexCount, 0.0f };
+    for (uint32_t LodIndex = 1; LodIndex < Data.LodCount; ++LodIndex)
+    {
+        Data.Lods[LodIndex] = Model.Lods[LodIndex];
+    }
+    return Data;
+}
 
-    if (!Compiler.CompileFromFile(L"Shaders/SkyAtmosphere.hlsl", L"VSMain", VSTarget, VSByteCode))
+bool RendererUtils::CanShareInstancedDraw(const FSceneModelResource& A, const FSceneModelResource& B)
+{
+    const auto Equal3 = [](const DirectX::XMFLOAT3& X, const DirectX::XMFLOAT3& Y)
+    {
+        return X.x == Y.x && X.y == Y.y && X.z == Y.z;
+    };
+    const auto Equal4 = [](const DirectX::XMFLOAT4& X, const DirectX::XMFLOAT4& Y)
+    {
+        return X.x == Y.x && X.y == Y.y && X.z == Y.z && X.w == Y.w;
+    };
+
+    if (A.Geometry.VertexBuffer != B.Geometry.VertexBuffer
+        || A.Geometry.IndexBuffer != B.Geometry.IndexBuffer
+        || A.DrawIndexStart != B.DrawIndexStart
+        || A.DrawIndexCount != B.DrawIndexCount
+        || A.LodCount != B.LodCount)
     {
         return false;
     }
 
-    if (!Compiler.CompileFromFile(L"Shaders/SkyAtmosphere.hlsl", L"PSMain", PSTarget, PSByteCode))
+    for (uint32_t LodIndex = 1; LodIndex < (std::min)(A.LodCount, MaxSceneModelLods); ++LodIndex)
     {
-        return false;
+        if (A.Lods[LodIndex].IndexStart != B.Lods[LodIndex].IndexStart || A.Lods[LodIndex].IndexCount != B.Lods[LodIndex].IndexCount)
+        {
+            return false;
+        }
     }
 
-    D3D12_ROOT_PARAMETER1 RootParam = {};
-    RootParam.ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
-    RootParam.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
-    RootParam.Descriptor.ShaderRegister = 0;
-    RootParam.Descriptor.RegisterSpace = 0;
-    RootParam.Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+    // Texture sets are loaded per model, so matching paths stand in for matching descriptors.
+    return A.AlphaMode == B.AlphaMode
+        && A.AlphaCutoff == B.AlphaCutoff
+        && A.BaseColorAlpha == B.BaseColorAlpha
+        && A.MetallicFactor == B.MetallicFactor
+        && A.RoughnessFactor == B.RoughnessFactor
+        && A.bHasNormalMap == B.bHasNormalMap
+        && Equal3(A.BaseColorFactor, B.BaseColorFactor)
+        && Equal3(A.EmissiveFactor, B.EmissiveFactor)
+        && Equal4(A.BaseColorTransformOffsetScale, B.BaseColorTransformOffsetScale)
+        && Equal4(A.BaseColorTransformRotation, B.BaseColorTransformRotation)
+        && Equal4(A.MetallicRoughnessTransformOffsetScale, B.MetallicRoughnessTransformOffsetScale)
+        && Equal4(A.MetallicRoughnessTransformRotation, B.MetallicRoughnessTransformRotation)
+        && Equal4(A.NormalTransformOffsetScale, B.NormalTransformOffsetScale)
+        && Equal4(A.NormalTransformRotation, B.NormalTransformRotation)
+        && Equal4(A.EmissiveTransformOffsetScale, B.EmissiveTransformOffsetScale)
+        && Equal4(A.EmissiveTransformRotation, B.EmissiveTransformRotation)
+        && A.BaseColorTexturePath == B.BaseColorTexturePath
+        && A.MetallicRoughnessTexturePath == B.MetallicRoughnessTexturePath
+        && A.NormalTexturePath == B.NormalTexturePath
+        && A.EmissiveTexturePath == B.EmissiveTexturePath;
+}
 
-    D3D12_VERSIONED_ROOT_SIGNATURE_DESC RootDesc = {};
-    RootDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
-    RootDesc.Desc_1_1.NumParameters = 1;
-    RootDesc.Desc_1_1.pParameters = &RootParam;
-    RootDesc.Desc_1_1.NumStaticSamplers = 0;
-    RootDesc.Desc_1_1.pStaticSamplers = nullptr;
-    RootDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+uint32_t RendererUtils::BuildMaterialPipelineKey(const FSceneModelResource& Model)
+{
+    const uint32_t UseNormal = Model.bHasNormalMap ? 1u : 0u;
+    const uint32_t UseMr = !Model.MetallicRoughnessTexturePath.empty() ? 1u : 0u;
+    const uint32_t UseBase = !Model.BaseColorTexturePath.empty() ? 1u : 0u;
+    const uint32_t UseEmissive = !Model.EmissiveTexturePath.empty() ? 1u : 0u;
+    const uint32_t UseAlphaMask = (Model.AlphaMode == 1u) ? 1u : 0u;
+    return (UseNormal) | (UseMr << 1) | (UseBase << 2) | (UseEmissive << 3) | (UseAlphaMask << 4);
+}
 
-    Microsoft::WRL::ComPtr<ID3DBlob> SerializedSig;
-    Microsoft::WRL::ComPtr<ID3DBlob> ErrorBlob;
-    HR_CHECK(D3D12SerializeVersionedRootSignature(&RootDesc, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf()));
+float RendererUtils::ComputeLodErrorScale(const FCamera& Camera, float ViewportHeight, float LodBias)
+{
+    const float PixelsPerUnitAtUnitDistance = ViewportHeight / (2.0f * std::tan(Camera.GetFovY() * 0.5f));
+    return PixelsPerUnitAtUnitDistance / std::exp2(LodBias);
+}
 
-    if (ErrorBlob && ErrorBlob->GetBufferSize() > 0)
+uint32_t RendererUtils::SelectModelLod(const FSceneModelResource& Model, const DirectX::XMFLOAT3& CameraPosition, float LodErrorScale)
+{
+    // Distance to the nearest point of the bounds, so a camera inside them keeps full detail.
+    const float DeltaX = (std::max)((std::max)(Model.BoundsMin.x - CameraPosition.x, CameraPosition.x - Model.BoundsMax.x), 0.0f);
+    const float DeltaY = (std::max)((std::max)(Model.BoundsMin.y - CameraPosition.y, CameraPosition.y - Model.BoundsMax.y), 0.0f);
+    const float DeltaZ = (std::max)((std::max)(Model.BoundsMin.z - CameraPosition.z, CameraPosition.z - Model.BoundsMax.z), 0.0f);
+    const float Distance = std::sqrt(DeltaX * DeltaX + DeltaY * DeltaY + DeltaZ * DeltaZ);
+
+    uint32_t SelectedLod = 0;
+    const uint32_t LodCount = (std::min)(Model.LodCount, MaxSceneModelLods);
+    for (uint32_t LodIndex = 1; LodIndex < LodCount; ++LodIndex)
     {
-        OutputDebugStringA(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
+        if (Model.Lods[LodIndex].Error * LodErrorScale <= Distance)
+        {
+            SelectedLod = LodIndex;
+        }
     }
+    return SelectedLod;
+}
 
-    HR_CHECK(Device->GetDevice()->CreateRootSignature(0, SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), IID_PPV_ARGS(OutRootSignature.GetAddressOf())));
-
-    D3D12_INPUT_ELEMENT_DESC InputLayout[] =
+bool RendererUtils::CreateMappedConstantBuffer(FDX12Device* Device, uint64_t BufferSize, FMappedConstantBuffer& OutConstantBuffer)
+{
+    if (Device == nullptr)
     {
-        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0,   D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, 24,  D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "TANGENT",  0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 32, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-    };
+        return false;
+    }
 
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC PsoDesc = {};
-    PsoDesc.pRootSignature = OutRootSignature.Get();
-    PsoDesc.InputLayout = { InputLayout, _countof(InputLayout) };
-    PsoDesc.VS = { VSByteCode.data(), VSByteCode.size() };
-    PsoDesc.PS = { PSByteCode.data(), PSByteCode.size() };
-    PsoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-    PsoDesc.SampleDesc.Count = 1;
-    PsoDesc.SampleMask = UINT_MAX;
+    const uint64_t ConstantBufferSize = (BufferSize + 255ULL) & ~255ULL;
 
-    PsoDesc.RasterizerState = {};
-    PsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
-    PsoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_FRONT;
-    PsoDesc.RasterizerState.FrontCounterClockwise = TRUE;
-    PsoDesc.RasterizerState.DepthBias = D3D12_DEFAULT_DEPTH_BIAS;
-    PsoDesc.RasterizerState.DepthBiasClamp = D3D12_DEFAULT_DEPTH_BIAS_CLAMP;
-    PsoDesc.RasterizerState.SlopeScaledDepthBias = D3D12_DEFAULT_SLOPE_SCALED_DEPTH_BIAS;
-    PsoDesc.RasterizerState.DepthClipEnable = TRUE;
-    PsoDesc.RasterizerState.MultisampleEnable = FALSE;
-    PsoDesc.RasterizerState.AntialiasedLineEnable = FALSE;
-    PsoDesc.RasterizerState.ForcedSampleCount = 0;
-    PsoDesc.RasterizerState.ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF;
+    D3D12_HEAP_PROPERTIES UploadHeap = {};
+    UploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
+    UploadHeap.CreationNodeMask = 1;
+    UploadHeap.VisibleNodeMask = 1;
 
-    PsoDesc.BlendState = {};
-    PsoDesc.BlendState.AlphaToCoverageEnable = FALSE;
-    PsoDesc.BlendState.IndependentBlendEnable = FALSE;
-    D3D12_RENDER_TARGET_BLEND_DESC RtBlend = {};
-    RtBlend.BlendEnable = FALSE;
-    RtBlend.LogicOpEnable = FALSE;
-    RtBlend.SrcBlend = D3D12_BLEND_ONE;
-    RtBlend.DestBlend = D3D12_BLEND_ZERO;
-    RtBlend.BlendOp = D3D12_BLEND_OP_ADD;
-    RtBlend.SrcBlendAlpha = D3D12_BLEND_ONE;
-    RtBlend.DestBlendAlpha = D3D12_BLEND_ZERO;
-    RtBlend.BlendOpAlpha = D3D12_BLEND_OP_ADD;
-    RtBlend.LogicOp = D3D12_LOGIC_OP_NOOP;
-    RtBlend.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
-    PsoDesc.BlendState.RenderTarget[0] = RtBlend;
+    D3D12_RESOURCE_DESC BufferDesc = {};
+    BufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    BufferDesc.Width = ConstantBufferSize;
+    BufferDesc.Height = 1;
+    BufferDesc.DepthOrArraySize = 1;
+    BufferDesc.MipLevels = 1;
+    BufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+    BufferDesc.SampleDesc.Count = 1;
+    BufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
 
-    PsoDesc.DepthStencilState = {};
-    PsoDesc.DepthStencilState.DepthEnable = Config.DepthEnable;
-    PsoDesc.DepthStencilState.DepthWriteMask = Config.DepthWriteMask;
-    PsoDesc.DepthStencilState.DepthFunc = Config.DepthFunc;
-    PsoDesc.DepthStencilState.StencilEnable = FALSE;
-    PsoDesc.NumRenderTargets = 1;
-    PsoDesc.RTVFormats[0] = BackBufferFormat;
-    PsoDesc.DSVFormat = Config.DsvFormat;
-    PsoDesc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Upload,
+        &UploadHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &BufferDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(OutConstantBuffer.Resource.GetAddressOf())));
 
-    HR_CHECK(Device->GetDevice()->CreateGraphicsPipelineState(&PsoDesc, IID_PPV_ARGS(OutPipelineState.GetAddressOf())));
+    OutConstantBuffer.Resource->SetName(L"MappedConstantBuffer");
 
+    D3D12_RANGE EmptyRange = { 0, 0 };
+    HR_CHECK(OutConstantBuffer.Resource->Map(0, &EmptyRange, reinterpret_cast<void**>(&OutConstantBuffer.MappedData)));
     return true;
 }
 
@@ -1026,9 +1838,8 @@ namespace
     }
 }
 
-void RendererUtils::UpdateSceneConstants(
+void RendererUtils::UpdateSceneViewConstants(
     const FCamera& Camera,
-    const FSceneModelResource& Model,
     float LightIntensity,
     const DirectX::XMVECTOR& LightDirection,
     const DirectX::XMFLOAT3& LightColor,
@@ -1039,8 +1850,7 @@ void RendererUtils::UpdateSceneConstants(
     float ShadowMapWidth,
     float ShadowMapHeight,
     float EnvMapMipCount,
-    uint8_t* ConstantBufferMapped,
-    uint64_t ConstantBufferOffset)
+    uint8_t* ConstantBufferMapped)
 {
     if (ConstantBufferMapped == nullptr)
     {
@@ -1051,89 +1861,57 @@ void RendererUtils::UpdateSceneConstants(
 
     const XMMATRIX View = Camera.GetViewMatrix();
     const XMMATRIX ViewInverse = XMMatrixInverse(nullptr, View);
-    const XMMATRIX WorldMatrix = XMLoadFloat4x4(&Model.WorldMatrix);
 
-    const bool bHasEmissiveTexture = !Model.EmissiveTexturePath.empty();
-    const XMFLOAT3 BaseColorFactor = Model.BaseColorFactor;
-    const XMFLOAT3 EmissiveFactor = Model.EmissiveFactor;
-
-    FSceneConstants Constants = {};
-    XMStoreFloat4x4(&Constants.World, WorldMatrix);
+    FSceneViewConstants Constants = {};
     XMStoreFloat4x4(&Constants.View, View);
     XMStoreFloat4x4(&Constants.ViewInverse, ViewInverse);
     XMStoreFloat4x4(&Constants.Projection, Projection);
-    Constants.BaseColor = BaseColorFactor;
-    Constants.LightIntensity = LightIntensity;
+    XMStoreFloat4x4(&Constants.LightViewProjection, LightViewProjection);
     XMStoreFloat3(&Constants.LightDirection, XMVector3Normalize(LightDirection));
+    Constants.LightIntensity = LightIntensity;
     Constants.CameraPosition = Camera.GetPosition();
+    Constants.EnvMapMipCount = EnvMapMipCount;
     Constants.LightColor = LightColor;
-    Constants.EmissiveFactor = EmissiveFactor;
-    XMStoreFloat4x4(&Constants.LightViewProjection, LightViewProjection);
     Constants.ShadowStrength = ShadowStrength;
-    Constants.ShadowBias = ShadowBias;
     Constants.ShadowMapSize = DirectX::XMFLOAT2(ShadowMapWidth, ShadowMapHeight);
-    Constants.MetallicFactor = Model.MetallicFactor;
-    Constants.RoughnessFactor = Model.RoughnessFactor;
-    Constants.BaseColorAlpha = Model.BaseColorAlpha;
-    Constants.AlphaCutoff = Model.AlphaCutoff;
-    Constants.AlphaMode = Model.AlphaMode;
-    Constants.EnvMapMipCount = EnvMapMipCount;
-    Constants.ObjectId = Model.ObjectId;
-    FillTransformConstants(Model.BaseColorTransformOffsetScale, Model.BaseColorTransformRotation, Constants.BaseColorTransformOffsetScale, Constants.BaseColorTransformRotation);
-    FillTransformConstants(Model.MetallicRoughnessTransformOffsetScale, Model.MetallicRoughnessTransformRotation, Constants.MetallicRoughnessTransformOffsetScale, Constants.MetallicRoughnessTransformRotation);
-    FillTransformConstants(Model.NormalTransformOffsetScale, Model.NormalTransformRotation, Constants.NormalTransformOffsetScale, Constants.NormalTransformRotation);
-    FillTransformConstants(Model.EmissiveTransformOffsetScale, Model.EmissiveTransformRotation, Constants.EmissiveTransformOffsetScale, Constants.EmissiveTransformRotation);
+    Constants.ShadowBias = ShadowBias;
 
-    memcpy(ConstantBufferMapped + ConstantBufferOffset, &Constants, sizeof(Constants));
+    memcpy(ConstantBufferMapped, &Constants, sizeof(Constants));
 }
 
-void RendererUtils::UpdateSkyConstants(
-    const FCamera& Camera,
-    const DirectX::XMMATRIX& WorldMatrix,
-    const DirectX::XMMATRIX& Projection,
-    const DirectX::XMVECTOR& LightDirection,
-    const DirectX::XMFLOAT3& LightColor,
-    uint8_t* ConstantBufferMapped)
+FSceneObjectData RendererUtils::BuildSceneObjectData(const FSceneModelResource& Model, uint32_t MaterialIndex)
 {
-    if (ConstantBufferMapped == nullptr)
-    {
-        return;
-    }
-
-    using namespace DirectX;
-
-    const XMMATRIX View = Camera.GetViewMatrix();
-    FSkyAtmosphereConstants Constants = {};
-    XMStoreFloat4x4(&Constants.World, WorldMatrix);
-    XMStoreFloat4x4(&Constants.View, View);
-    XMStoreFloat4x4(&Constants.Projection, Projection);
-    Constants.CameraPosition = Camera.GetPosition();
-    XMStoreFloat3(&Constants.LightDirection, XMVector3Normalize(LightDirection));
-    Constants.LightColor = LightColor;
-
-    memcpy(ConstantBufferMapped, &Constants, sizeof(Constants));
+    FSceneObjectData Object;
+    Object.World = Model.WorldMatrix;
+    Object.PrevWorld = Model.PrevWorldMatrix;
+    Object.PositionScale = Model.Geometry.PositionScale;
+    Object.ObjectId = Model.ObjectId;
+    Object.PositionOffset = Model.Geometry.PositionOffset;
+    Object.MaterialIndex = MaterialIndex;
+    return Object;
 }
 
-DirectX::XMMATRIX RendererUtils::BuildDirectionalLightViewProjection(
-    const DirectX::XMFLOAT3& SceneCenter,
-    float SceneRadius,
-    const DirectX::XMFLOAT3& LightDirection)
+FSceneMaterialData RendererUtils::BuildSceneMaterialData(const FSceneModelResource& Model)
 {
-    using namespace DirectX;
-
-    const XMVECTOR Direction = XMVector3Normalize(XMLoadFloat3(&LightDirection));
-    const XMVECTOR SceneCenterVec = XMLoadFloat3(&SceneCenter);
-    const float LightDistance = SceneRadius * 2.5f;
-    const XMVECTOR LightPosition = XMVectorAdd(SceneCenterVec, XMVectorScale(Direction, LightDistance));
-    const XMVECTOR Up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
-
-    const XMMATRIX View = XMMatrixLookAtLH(LightPosition, SceneCenterVec, Up);
-    const float OrthoSize = SceneRadius * 2.0f;
-    const float NearZ = 0.1f;
-    const float FarZ = SceneRadius * 5.0f;
-    const XMMATRIX Projection = XMMatrixOrthographicLH(OrthoSize, OrthoSize, NearZ, FarZ);
-
-    return XMMatrixMultiply(View, Projection);
+    FSceneMaterialData Material;
+    Material.BaseColor = Model.BaseColorFactor;
+    Material.BaseColorAlpha = Model.BaseColorAlpha;
+    Material.EmissiveFactor = Model.EmissiveFactor;
+    Material.MetallicFactor = Model.MetallicFactor;
+    Material.RoughnessFactor = Model.RoughnessFactor;
+    Material.AlphaCutoff = Model.AlphaCutoff;
+    Material.AlphaMode = Model.AlphaMode;
+    Material.DescriptorIndex = Model.MaterialDescriptorIndex;
+    Material.Flags =
+        (Model.bHasNormalMap ? 1u : 0u) |
+        (!Model.MetallicRoughnessTexturePath.empty() ? 2u : 0u) |
+        (!Model.BaseColorTexturePath.empty() ? 4u : 0u) |
+        (!Model.EmissiveTexturePath.empty() ? 8u : 0u);
+    FillTransformConstants(Model.BaseColorTransformOffsetScale, Model.BaseColorTransformRotation, Material.BaseColorTransformOffsetScale, Material.BaseColorTransformRotation);
+    FillTransformConstants(Model.MetallicRoughnessTransformOffsetScale, Model.MetallicRoughnessTransformRotation, Material.MetallicRoughnessTransformOffsetScale, Material.MetallicRoughnessTransformRotation);
+    FillTransformConstants(Model.NormalTransformOffsetScale, Model.NormalTransformRotation, Material.NormalTransformOffsetScale, Material.NormalTransformRotation);
+    FillTransformConstants(Model.EmissiveTransformOffsetScale, Model.EmissiveTransformRotation, Material.EmissiveTransformOffsetScale, Material.EmissiveTransformRotation);
+    return Material;
 }
 
 void RendererUtils::BuildCameraFrustumPlanes(
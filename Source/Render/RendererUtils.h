@@ -3,6 +3,7 @@
 #include <wrl.h>
 #include <d3d12.h>
 #include <DirectXMath.h>
+#include <array>
 #include <cstdint>
 #include <cmath>
 #include <string>
@@ -12,15 +13,33 @@
 class FDX12Device;
 class FCamera;
 class FMesh;
+class FSceneBvh;
+class FTransformHierarchy;
 struct FGltfMaterialTextures;
+struct FMeshletData;
 
 struct FMeshGeometryBuffers
 {
     Microsoft::WRL::ComPtr<ID3D12Resource> VertexBuffer;
     Microsoft::WRL::ComPtr<ID3D12Resource> IndexBuffer;
+    // The vertex buffer holds two streams: quantized positions (slot 0), read alone by depth-only
+    // passes, followed by the packed shading attributes (slot 1). See GetMeshInputLayout.
+    D3D12_VERTEX_BUFFER_VIEW PositionBufferView{};
     D3D12_VERTEX_BUFFER_VIEW VertexBufferView{};
     D3D12_INDEX_BUFFER_VIEW IndexBufferView{};
     uint32_t IndexCount = 0;
+    // Scene meshes share one vertex and one index buffer; the views cover the whole buffers, indices
+    // are already rebased to the shared vertex buffer, and the mesh starts at FirstIndex.
+    uint32_t FirstIndex = 0;
+    // Positions are stored as unorm16 within the mesh bounds: Position = Quantized * Scale + Offset.
+    DirectX::XMFLOAT3 PositionScale{ 1.0f, 1.0f, 1.0f };
+    DirectX::XMFLOAT3 PositionOffset{ 0.0f, 0.0f, 0.0f };
+    // Meshlets for the mesh shader path, null unless CreateSharedMeshletBuffer ran. One buffer holds
+    // the FMeshlet array, then the meshlet vertex indices (rebased to the shared vertex buffer) at
+    // MeshletVertexOffset, then the packed triangles at MeshletTriangleOffset.
+    Microsoft::WRL::ComPtr<ID3D12Resource> MeshletBuffer;
+    uint64_t MeshletVertexOffset = 0;
+    uint64_t MeshletTriangleOffset = 0;
 };
 
 using FCubeGeometryBuffers = FMeshGeometryBuffers;
@@ -38,32 +57,58 @@ struct FMappedConstantBuffer
     uint8_t* MappedData = nullptr;
 };
 
-struct FSceneConstants
+// Per-view constants written once per frame; layout shared with Shaders/SceneConstants.hlsl.
+struct FSceneViewConstants
 {
-    DirectX::XMFLOAT4X4 World;
     DirectX::XMFLOAT4X4 View;
     DirectX::XMFLOAT4X4 ViewInverse;
     DirectX::XMFLOAT4X4 Projection;
-    DirectX::XMFLOAT3 BaseColor;
-    float LightIntensity = 1.0f;
+    DirectX::XMFLOAT4X4 LightViewProjection;
     DirectX::XMFLOAT3 LightDirection;
-    float Padding1 = 0.0f;
+    float LightIntensity = 1.0f;
     DirectX::XMFLOAT3 CameraPosition;
-    float Padding2 = 0.0f;
+    float EnvMapMipCount = 1.0f;
     DirectX::XMFLOAT3 LightColor{ 1.0f, 1.0f, 1.0f };
-    float Padding3 = 0.0f;
-    DirectX::XMFLOAT3 EmissiveFactor{ 0.0f, 0.0f, 0.0f };
-    float Padding4 = 0.0f;
-    DirectX::XMFLOAT4X4 LightViewProjection;
     float ShadowStrength = 1.0f;
-    float ShadowBias = 0.0f;
     DirectX::XMFLOAT2 ShadowMapSize{ 0.0f, 0.0f };
+    float ShadowBias = 0.0f;
+    float PaddingView = 0.0f;
+    DirectX::XMFLOAT4X4 ShadowCascadeViewProjection[4];
+    DirectX::XMFLOAT4 ShadowCascadeSplits{ 0.0f, 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT4X4 UnjitteredViewProjection;
+    DirectX::XMFLOAT4X4 PrevUnjitteredViewProjection;
+    // Diffuse irradiance of the environment; see FEnvironmentLighting.
+    DirectX::XMFLOAT4 IrradianceSH[9]{};
+};
+
+static_assert(sizeof(FSceneViewConstants) == 864, "View constants layout must match SceneConstants.hlsl.");
+
+// Per scene model entry of the SceneObjects buffer in Shaders/SceneConstants.hlsl.
+struct FSceneObjectData
+{
+    DirectX::XMFLOAT4X4 World{};
+    DirectX::XMFLOAT4X4 PrevWorld{};
+    DirectX::XMFLOAT3 PositionScale{ 1.0f, 1.0f, 1.0f };
+    uint32_t ObjectId = 0;
+    DirectX::XMFLOAT3 PositionOffset{ 0.0f, 0.0f, 0.0f };
+    uint32_t MaterialIndex = 0;
+};
+
+static_assert(sizeof(FSceneObjectData) == 160, "Scene object layout must match SceneConstants.hlsl.");
+
+// Entry of the SceneMaterials buffer in Shaders/SceneConstants.hlsl.
+struct FSceneMaterialData
+{
+    DirectX::XMFLOAT3 BaseColor{ 1.0f, 1.0f, 1.0f };
+    float BaseColorAlpha = 1.0f;
+    DirectX::XMFLOAT3 EmissiveFactor{ 0.0f, 0.0f, 0.0f };
     float MetallicFactor = 1.0f;
     float RoughnessFactor = 1.0f;
-    float BaseColorAlpha = 1.0f;
     float AlphaCutoff = 0.5f;
     uint32_t AlphaMode = 0;
-    DirectX::XMUINT3 PaddingMaterial{ 0, 0, 0 };
+    uint32_t Flags = 0;
+    uint32_t DescriptorIndex = 0;
+    DirectX::XMUINT3 Padding{ 0, 0, 0 };
     DirectX::XMFLOAT4 BaseColorTransformOffsetScale{ 0.0f, 0.0f, 1.0f, 1.0f };
     DirectX::XMFLOAT4 BaseColorTransformRotation{ 1.0f, 0.0f, 0.0f, 0.0f };
     DirectX::XMFLOAT4 MetallicRoughnessTransformOffsetScale{ 0.0f, 0.0f, 1.0f, 1.0f };
@@ -72,50 +117,72 @@ struct FSceneConstants
     DirectX::XMFLOAT4 NormalTransformRotation{ 1.0f, 0.0f, 0.0f, 0.0f };
     DirectX::XMFLOAT4 EmissiveTransformOffsetScale{ 0.0f, 0.0f, 1.0f, 1.0f };
     DirectX::XMFLOAT4 EmissiveTransformRotation{ 1.0f, 0.0f, 0.0f, 0.0f };
-    float EnvMapMipCount = 1.0f;
-    DirectX::XMFLOAT3 PaddingEnvMap{ 0.0f, 0.0f, 0.0f };
-    uint32_t ObjectId = 0;
-    DirectX::XMFLOAT3 PaddingObjectId{ 0.0f, 0.0f, 0.0f };
 };
 
-struct FSkyAtmosphereConstants
+static_assert(sizeof(FSceneMaterialData) == 192, "Scene material layout must match SceneConstants.hlsl.");
+
+// Vertex and index buffers, view constants and the scene object and material buffers are bound once
+// per pass, so a command is the instance base root constant and draw arguments. A command draws one
+// LOD of an instance group.
+struct FIndirectDrawCommand
 {
-    DirectX::XMFLOAT4X4 World;
-    DirectX::XMFLOAT4X4 View;
-    DirectX::XMFLOAT4X4 Projection;
-    DirectX::XMFLOAT3 CameraPosition;
-    float Padding0 = 0.0f;
-    DirectX::XMFLOAT3 LightDirection{ 0.0f, -1.0f, 0.0f };
-    float Padding1 = 0.0f;
-    DirectX::XMFLOAT3 LightColor{ 1.0f, 1.0f, 1.0f };
-    float Padding2 = 0.0f;
+    // First VisibleInstances slot of the command; GPU culling fills InstanceCount slots from here.
+    uint32_t InstanceBase = 0;
+    D3D12_DRAW_INDEXED_ARGUMENTS DrawArguments{};
 };
 
-struct FSkyPipelineConfig
+static_assert(sizeof(FIndirectDrawCommand) == 24, "Indirect command layout must match CullIndirectArgs.hlsl.");
+
+// Where CSCompactCommands packs a command that culling left non-empty: the counter of its range
+// and command set, and the compacted slot of the range's first command.
+struct FIndirectCommandRange
 {
-    bool DepthEnable = false;
-    D3D12_COMPARISON_FUNC DepthFunc = D3D12_COMPARISON_FUNC_ALWAYS;
-    D3D12_DEPTH_WRITE_MASK DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
-    DXGI_FORMAT DsvFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    uint32_t CounterIndex = 0;
+    uint32_t OutputStart = 0;
 };
 
-struct FIndirectDrawCommand
+// Levels of detail per scene model, including the full-detail one.
+constexpr uint32_t MaxSceneModelLods = 4;
+
+struct FSceneModelLod
 {
-    D3D12_VERTEX_BUFFER_VIEW VertexBufferView{};
-    D3D12_INDEX_BUFFER_VIEW IndexBufferView{};
-    D3D12_GPU_VIRTUAL_ADDRESS ConstantBufferAddress = 0;
-    D3D12_DRAW_INDEXED_ARGUMENTS DrawArguments{};
-    uint32_t Padding = 0;
+    uint32_t IndexStart = 0;
+    uint32_t IndexCount = 0;
+    // World-space simplification error; zero for the full-detail level.
+    float Error = 0.0f;
+};
+
+// Per scene model input of CullIndirectArgs.hlsl, in scene model order.
+struct FModelCullingData
+{
+    DirectX::XMFLOAT3 BoundsMin{ 0.0f, 0.0f, 0.0f };
+    uint32_t LodCount = 1;
+    DirectX::XMFLOAT3 BoundsMax{ 0.0f, 0.0f, 0.0f };
+    // First indirect command of the model's instance group, followed by one command per further LOD.
+    uint32_t CommandStart = 0;
+    FSceneModelLod Lods[MaxSceneModelLods];
 };
 
-static_assert(sizeof(FIndirectDrawCommand) == 64, "Indirect command layout must be 64 bytes.");
+static_assert(sizeof(FModelCullingData) == 80, "Model culling data layout must match CullIndirectArgs.hlsl.");
+
+// Root constant value telling the base pass vertex shaders to draw the scene object named by the
+// second root constant instead of reading VisibleInstances; see Shaders/SceneInstances.hlsl.
+constexpr uint32_t NoInstanceBase = 0xFFFFFFFFu;
 
 struct FSceneModelResource
 {
     FMeshGeometryBuffers Geometry;
     uint32_t DrawIndexStart = 0;
     uint32_t DrawIndexCount = 0;
+    // Meshlets covering the same triangles as the index range, indexing Geometry.MeshletBuffer.
+    uint32_t MeshletStart = 0;
+    uint32_t MeshletCount = 0;
+    // Lods[0] is the DrawIndexStart/DrawIndexCount range; coarser levels follow in the shared index buffer.
+    std::array<FSceneModelLod, MaxSceneModelLods> Lods{};
+    uint32_t LodCount = 1;
     DirectX::XMFLOAT4X4 WorldMatrix{};
+    // WorldMatrix of the previous frame, for motion vectors; equal to it while the model rests.
+    DirectX::XMFLOAT4X4 PrevWorldMatrix{};
     DirectX::XMFLOAT3 Center{ 0.0f, 0.0f, 0.0f };
     float Radius = 1.0f;
     DirectX::XMFLOAT3 BaseColorFactor{ 1.0f, 1.0f, 1.0f };
@@ -131,6 +198,8 @@ struct FSceneModelResource
     std::wstring EmissiveTexturePath;
     bool bHasNormalMap = true;
     D3D12_GPU_DESCRIPTOR_HANDLE TextureHandle{};
+    // Heap index of TextureHandle, used by bindless shaders.
+    uint32_t MaterialDescriptorIndex = 0;
     DirectX::XMFLOAT4 BaseColorTransformOffsetScale{ 0.0f, 0.0f, 1.0f, 1.0f };
     DirectX::XMFLOAT4 BaseColorTransformRotation{ 1.0f, 0.0f, 0.0f, 0.0f };
     DirectX::XMFLOAT4 MetallicRoughnessTransformOffsetScale{ 0.0f, 0.0f, 1.0f, 1.0f };
@@ -142,14 +211,95 @@ struct FSceneModelResource
     std::string Name;
     DirectX::XMFLOAT3 BoundsMin{ 0.0f, 0.0f, 0.0f };
     DirectX::XMFLOAT3 BoundsMax{ 0.0f, 0.0f, 0.0f };
+    // Mesh-space bounds, from which the world bounds are recomputed when TransformNode moves.
+    DirectX::XMFLOAT3 LocalBoundsMin{ 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 LocalBoundsMax{ 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 LocalCenter{ 0.0f, 0.0f, 0.0f };
+    float LocalRadius = 1.0f;
+    // Node of the scene transform hierarchy giving WorldMatrix; models without one never move.
+    uint32_t TransformNode = UINT32_MAX;
     uint32_t ObjectId = 0;
 };
 
+// Scene model bounds as structure-of-arrays so frustum tests run four boxes per instruction.
+// The arrays are padded to a multiple of four; padding lanes are never reported visible.
+struct FSceneBoundsSoA
+{
+    static constexpr uint32_t LaneCount = 4;
+
+    std::vector<float> MinX;
+    std::vector<float> MinY;
+    std::vector<float> MinZ;
+    std::vector<float> MaxX;
+    std::vector<float> MaxY;
+    std::vector<float> MaxZ;
+    uint32_t Count = 0;
+};
+
 namespace RendererUtils
 {
+    // Skips the IA calls while consecutive draws share the geometry buffers bound last.
+    struct FGeometryBinding
+    {
+        D3D12_GPU_VIRTUAL_ADDRESS PositionBufferAddress = 0;
+        D3D12_GPU_VIRTUAL_ADDRESS VertexBufferAddress = 0;
+        D3D12_GPU_VIRTUAL_ADDRESS IndexBufferAddress = 0;
+
+        // Binds both vertex streams, for pipelines created with GetMeshInputLayout().
+        void Bind(ID3D12GraphicsCommandList* CommandList, const FMeshGeometryBuffers& Geometry)
+        {
+            if (Geometry.PositionBufferView.BufferLocation != PositionBufferAddress
+                || Geometry.VertexBufferView.BufferLocation != VertexBufferAddress)
+            {
+                const D3D12_VERTEX_BUFFER_VIEW Views[] = { Geometry.PositionBufferView, Geometry.VertexBufferView };
+                CommandList->IASetVertexBuffers(0, _countof(Views), Views);
+                PositionBufferAddress = Geometry.PositionBufferView.BufferLocation;
+                VertexBufferAddress = Geometry.VertexBufferView.BufferLocation;
+            }
+            BindIndices(CommandList, Geometry);
+        }
+
+        // Binds only the position stream, for pipelines created with GetMeshPositionInputLayout().
+        void BindPositions(ID3D12GraphicsCommandList* CommandList, const FMeshGeometryBuffers& Geometry)
+        {
+            if (Geometry.PositionBufferView.BufferLocation != PositionBufferAddress)
+            {
+                CommandList->IASetVertexBuffers(0, 1, &Geometry.PositionBufferView);
+                PositionBufferAddress = Geometry.PositionBufferView.BufferLocation;
+            }
+            BindIndices(CommandList, Geometry);
+        }
+
+    private:
+        void BindIndices(ID3D12GraphicsCommandList* CommandList, const FMeshGeometryBuffers& Geometry)
+        {
+            if (Geometry.IndexBufferView.BufferLocation != IndexBufferAddress)
+            {
+                CommandList->IASetIndexBuffer(&Geometry.IndexBufferView);
+                IndexBufferAddress = Geometry.IndexBufferView.BufferLocation;
+            }
+        }
+    };
+
+    // Input layouts matching Shaders/MeshVertex.hlsl for geometry from CreateSharedMeshGeometry.
+    // Slot 0: POSITION R16G16B16A16_UNORM. Slot 1: octahedral NORMAL R16G16_SNORM, octahedral
+    // TANGENT R10G10B10A2_UNORM with the bitangent sign in A, TEXCOORD R16G16_FLOAT, COLOR R8G8B8A8_UNORM.
+    D3D12_INPUT_LAYOUT_DESC GetMeshInputLayout();
+    D3D12_INPUT_LAYOUT_DESC GetMeshPositionInputLayout();
+
     std::wstring BuildShaderTarget(const wchar_t* StagePrefix, D3D_SHADER_MODEL ShaderModel);
+    // SRV component mapping for a material texture: one-channel BC4 masks replicate red into RGB so
+    // shaders read them like the RGBA images they were cooked from.
+    UINT GetTextureComponentMapping(DXGI_FORMAT Format);
     std::string ResourceStateToString(D3D12_RESOURCE_STATES State);
+    std::string BarrierLayoutToString(D3D12_BARRIER_LAYOUT Layout);
     bool CreateMeshGeometry(FDX12Device* Device, const FMesh& Mesh, FMeshGeometryBuffers& OutGeometry);
+    // Packs all meshes into one default-heap vertex buffer and one index buffer with a single upload.
+    // Vertices are compressed from 64 to 24 bytes: 8 in the position stream, 16 in the attribute stream.
+    bool CreateSharedMeshGeometry(FDX12Device* Device, const std::vector<const FMesh*>& Meshes, std::vector<FMeshGeometryBuffers>& OutGeometries);
+    // Uploads one meshlet set per entry of InOutGeometries (from CreateSharedMeshGeometry) into a single
+    // buffer. The sets are rebased in place so their ranges and vertex indices address the shared buffers.
+    bool CreateSharedMeshletBuffer(FDX12Device* Device, const std::vector<const FMesh*>& Meshes, std::vector<FMeshletData>& MeshletSets, std::vector<FMeshGeometryBuffers>& InOutGeometries);
     bool CreateCubeGeometry(FDX12Device* Device, FCubeGeometryBuffers& OutGeometry, float Size = 1.0f);
     bool CreateSphereGeometry(
         FDX12Device* Device,
@@ -163,7 +313,13 @@ namespace RendererUtils
         const std::wstring& SceneFilePath,
         std::vector<FSceneModelResource>& OutModels,
         DirectX::XMFLOAT3& OutSceneCenter,
-        float& OutSceneRadius);
+        float& OutSceneRadius,
+        bool bOptimizeMeshes = true,
+        bool bBuildMeshlets = false,
+        bool bGenerateLods = false,
+        FTransformHierarchy* OutTransforms = nullptr);
+    // Moves a model whose local bounds are set: updates WorldMatrix, world bounds, center and radius.
+    void SetSceneModelWorldMatrix(FSceneModelResource& Model, const DirectX::XMFLOAT4X4& WorldMatrix);
     bool CreateDepthResources(FDX12Device* Device, uint32_t Width, uint32_t Height, DXGI_FORMAT Format, FDepthResources& OutDepthResources);
     bool CreateObjectIdResources(
         FDX12Device* Device,
@@ -203,26 +359,53 @@ namespace RendererUtils
     void BuildFrustumPlanesFromMatrix(
         const DirectX::XMMATRIX& ViewProjection,
         DirectX::XMVECTOR OutPlanes[6]);
+    void BuildSceneBoundsSoA(
+        const std::vector<FSceneModelResource>& Models,
+        FSceneBoundsSoA& OutBounds);
+    // Drop-in batch version of IsAabbInCameraFrustum: appends the indices of the boxes not fully
+    // outside any plane, in ascending order. Groups of four boxes are split across task workers.
+    void CullSceneBoundsSoA(
+        const DirectX::XMVECTOR Planes[6],
+        const FSceneBoundsSoA& Bounds,
+        std::vector<uint32_t>& OutVisibleIndices);
+    // Marks the models whose bounds intersect the camera frustum. SceneBvh and SceneBounds must
+    // have been built over Models; ScratchIndices receives the visible model indices.
     void UpdateCullingVisibility(
         const FCamera& Camera,
         const std::vector<FSceneModelResource>& Models,
+        const FSceneBvh& SceneBvh,
+        const FSceneBoundsSoA& SceneBounds,
+        std::vector<uint32_t>& ScratchIndices,
         std::vector<bool>& OutVisibility);
+    // Same as UpdateCullingVisibility for an arbitrary view-projection, e.g. a light's.
+    void UpdateFrustumVisibility(
+        const DirectX::XMMATRIX& ViewProjection,
+        const std::vector<FSceneModelResource>& Models,
+        const FSceneBvh& SceneBvh,
+        const FSceneBoundsSoA& SceneBounds,
+        std::vector<uint32_t>& ScratchIndices,
+        std::vector<bool>& OutVisibility);
+    // World-space ray through a point given in normalized device coordinates.
+    void BuildCameraRay(
+        const FCamera& Camera,
+        float NdcX,
+        float NdcY,
+        DirectX::XMFLOAT3& OutOrigin,
+        DirectX::XMFLOAT3& OutDirection);
+    FModelCullingData BuildModelCullingData(const FSceneModelResource& Model);
+    // True when the two models draw the same index ranges with the same material, so they can be
+    // drawn as instances of one command and differ only in their transform.
+    bool CanShareInstancedDraw(const FSceneModelResource& A, const FSceneModelResource& B);
+    // Material pipeline key of the model's maps and alpha mode; see FRenderer::MaterialMapKeyMask.
+    uint32_t BuildMaterialPipelineKey(const FSceneModelResource& Model);
+    // Converts world-space LOD error at unit distance to the error threshold: a level is used once
+    // Error * Scale <= distance, i.e. once it projects to at most 2^LodBias pixels.
+    float ComputeLodErrorScale(const FCamera& Camera, float ViewportHeight, float LodBias);
+    // CPU mirror of the LOD selection in CullIndirectArgs.hlsl.
+    uint32_t SelectModelLod(const FSceneModelResource& Model, const DirectX::XMFLOAT3& CameraPosition, float LodErrorScale);
     bool CreateMappedConstantBuffer(FDX12Device* Device, uint64_t BufferSize, FMappedConstantBuffer& OutConstantBuffer);
-    bool CreateSkyAtmosphereResources(
-        FDX12Device* Device,
-        float SkySphereRadius,
-        FMeshGeometryBuffers& OutGeometry,
-        Microsoft::WRL::ComPtr<ID3D12Resource>& OutConstantBuffer,
-        uint8_t*& OutConstantBufferMapped);
-    bool CreateSkyAtmospherePipeline(
-        FDX12Device* Device,
-        DXGI_FORMAT BackBufferFormat,
-        const FSkyPipelineConfig& Config,
-        Microsoft::WRL::ComPtr<ID3D12RootSignature>& OutRootSignature,
-        Microsoft::WRL::ComPtr<ID3D12PipelineState>& OutPipelineState);
-    void UpdateSceneConstants(
+    void UpdateSceneViewConstants(
         const FCamera& Camera,
-        const FSceneModelResource& Model,
         float LightIntensity,
         const DirectX::XMVECTOR& LightDirection,
         const DirectX::XMFLOAT3& LightColor,
@@ -233,19 +416,9 @@ namespace RendererUtils
         float ShadowMapWidth,
         float ShadowMapHeight,
         float EnvMapMipCount,
-        uint8_t* ConstantBufferMapped,
-        uint64_t ConstantBufferOffset = 0);
-    void UpdateSkyConstants(
-        const FCamera& Camera,
-        const DirectX::XMMATRIX& WorldMatrix,
-        const DirectX::XMMATRIX& Projection,
-        const DirectX::XMVECTOR& LightDirection,
-        const DirectX::XMFLOAT3& LightColor,
         uint8_t* ConstantBufferMapped);
-    DirectX::XMMATRIX BuildDirectionalLightViewProjection(
-        const DirectX::XMFLOAT3& SceneCenter,
-        float SceneRadius,
-        const DirectX::XMFLOAT3& LightDirection);
+    FSceneObjectData BuildSceneObjectData(const FSceneModelResource& Model, uint32_t MaterialIndex);
+    FSceneMaterialData BuildSceneMaterialData(const FSceneModelResource& Model);
     bool IsAabbInCameraFrustum(
         const DirectX::XMVECTOR Planes[6],
         const DirectX::XMFLOAT3& BoundsMin,
@@ -1,10 +1,20 @@
 #include "ShaderCompiler.h"
 
 #include "Core/Logger.h"
+#include "../Core/CpuProfiler.h"
 #include "../Core/TaskSystem.h"
 
+#include <algorithm>
 #include <cstring>
+#include <cwctype>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <Windows.h>
 #include <chrono>
@@ -28,44 +38,413 @@ namespace
         WideCharToMultiByte(CP_UTF8, 0, WStr.c_str(), static_cast<int>(WStr.size()), Result.data(), RequiredSize, nullptr, nullptr);
         return Result;
     }
+
+    const std::filesystem::path ShaderCacheDirectory = L"ShaderCache";
+
+    struct FShaderHasher
+    {
+        uint64_t Value = 14695981039346656037ULL;
+
+        void AddBytes(const void* Data, size_t Size)
+        {
+            const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+            for (size_t Index = 0; Index < Size; ++Index)
+            {
+                Value ^= Bytes[Index];
+                Value *= 1099511628211ULL;
+            }
+        }
+
+        void AddString(const std::wstring& Str)
+        {
+            AddBytes(Str.c_str(), (Str.size() + 1) * sizeof(wchar_t));
+        }
+
+        void AddValue(uint64_t Field)
+        {
+            AddBytes(&Field, sizeof(Field));
+        }
+    };
+
+    std::wstring ToHexName(uint64_t Hash, const wchar_t* Extension)
+    {
+        wchar_t Buffer[32] = {};
+        swprintf_s(Buffer, L"%016llX%s", static_cast<unsigned long long>(Hash), Extension);
+        return Buffer;
+    }
+
+    bool ReadFileBytes(const std::filesystem::path& Path, std::vector<char>& OutBytes)
+    {
+        std::ifstream File(Path, std::ios::binary);
+        if (!File)
+        {
+            return false;
+        }
+
+        OutBytes.assign(std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    // Hash of the request key and the current contents of the source and each recorded include.
+    bool ComputeContentKey(uint64_t RequestKey, const std::wstring& FilePath, const std::vector<std::wstring>& Dependencies, uint64_t& OutKey)
+    {
+        FShaderHasher Hasher;
+        Hasher.AddValue(RequestKey);
+
+        std::vector<char> Bytes;
+        if (!ReadFileBytes(FilePath, Bytes))
+        {
+            return false;
+        }
+        Hasher.AddBytes(Bytes.data(), Bytes.size());
+
+        for (const std::wstring& Dependency : Dependencies)
+        {
+            if (!ReadFileBytes(Dependency, Bytes))
+            {
+                return false;
+            }
+            Hasher.AddString(Dependency);
+            Hasher.AddBytes(Bytes.data(), Bytes.size());
+        }
+
+        OutKey = Hasher.Value;
+        return true;
+    }
+
+    bool ReadManifest(const std::filesystem::path& Path, std::vector<std::wstring>& OutDependencies)
+    {
+        std::ifstream File(Path);
+        if (!File)
+        {
+            return false;
+        }
+
+        std::string Line;
+        while (std::getline(File, Line))
+        {
+            if (!Line.empty())
+            {
+                OutDependencies.push_back(std::filesystem::u8path(Line).wstring());
+            }
+        }
+        return true;
+    }
+
+    // Writes beside the target and renames, so concurrent compilers never read a partial file.
+    bool WriteCacheFile(const std::filesystem::path& Path, const void* Data, size_t Size)
+    {
+        std::error_code Error;
+        std::filesystem::create_directories(Path.parent_path(), Error);
+
+        std::filesystem::path TempPath = Path;
+        TempPath += L"." + std::to_wstring(GetCurrentThreadId()) + L".tmp";
+        {
+            std::ofstream File(TempPath, std::ios::binary | std::ios::trunc);
+            File.write(static_cast<const char*>(Data), static_cast<std::streamsize>(Size));
+            if (!File)
+            {
+                return false;
+            }
+        }
+
+        std::filesystem::rename(TempPath, Path, Error);
+        if (Error)
+        {
+            std::filesystem::remove(TempPath, Error);
+            return false;
+        }
+        return true;
+    }
+
+    // Forwards to the default handler and records every file it resolves.
+    class FRecordingIncludeHandler final : public IDxcIncludeHandler
+    {
+    public:
+        explicit FRecordingIncludeHandler(IDxcIncludeHandler* InInner)
+            : Inner(InInner)
+        {
+        }
+
+        HRESULT STDMETHODCALLTYPE LoadSource(LPCWSTR Filename, IDxcBlob** OutSource) override
+        {
+            const HRESULT Result = Inner->LoadSource(Filename, OutSource);
+            if (SUCCEEDED(Result) && std::find(Dependencies.begin(), Dependencies.end(), Filename) == Dependencies.end())
+            {
+                Dependencies.push_back(Filename);
+            }
+            return Result;
+        }
+
+        HRESULT STDMETHODCALLTYPE QueryInterface(REFIID Riid, void** OutObject) override
+        {
+            if (Riid == __uuidof(IDxcIncludeHandler) || Riid == __uuidof(IUnknown))
+            {
+                *OutObject = static_cast<IDxcIncludeHandler*>(this);
+                return S_OK;
+            }
+            *OutObject = nullptr;
+            return E_NOINTERFACE;
+        }
+
+        // Lives on the stack for the duration of one Compile call.
+        ULONG STDMETHODCALLTYPE AddRef() override { return 1; }
+        ULONG STDMETHODCALLTYPE Release() override { return 1; }
+
+        std::vector<std::wstring> Dependencies;
+
+    private:
+        IDxcIncludeHandler* Inner = nullptr;
+    };
+
+    struct FDxcContext
+    {
+        Microsoft::WRL::ComPtr<IDxcUtils> Utils;
+        Microsoft::WRL::ComPtr<IDxcCompiler3> Compiler;
+        Microsoft::WRL::ComPtr<IDxcIncludeHandler> IncludeHandler;
+        // Part of every cache key, so a compiler update invalidates all cached blobs.
+        uint64_t CompilerVersionHash = 0;
+    };
+
+    std::unique_ptr<FDxcContext> CreateDxcContext()
+    {
+        std::unique_ptr<FDxcContext> Context = std::make_unique<FDxcContext>();
+        DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&Context->Utils));
+        DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&Context->Compiler));
+
+        if (Context->Utils)
+        {
+            Context->Utils->CreateDefaultIncludeHandler(&Context->IncludeHandler);
+        }
+
+        FShaderHasher VersionHasher;
+        Microsoft::WRL::ComPtr<IDxcVersionInfo> VersionInfo;
+        if (Context->Compiler && SUCCEEDED(Context->Compiler.As(&VersionInfo)))
+        {
+            UINT32 Major = 0;
+            UINT32 Minor = 0;
+            VersionInfo->GetVersion(&Major, &Minor);
+            VersionHasher.AddValue((static_cast<uint64_t>(Major) << 32) | Minor);
+
+            Microsoft::WRL::ComPtr<IDxcVersionInfo2> VersionInfo2;
+            UINT32 CommitCount = 0;
+            char* CommitHash = nullptr;
+            if (SUCCEEDED(VersionInfo.As(&VersionInfo2)) && SUCCEEDED(VersionInfo2->GetCommitInfo(&CommitCount, &CommitHash)))
+            {
+                VersionHasher.AddValue(CommitCount);
+                if (CommitHash)
+                {
+                    VersionHasher.AddBytes(CommitHash, std::strlen(CommitHash));
+                    CoTaskMemFree(CommitHash);
+                }
+            }
+        }
+        Context->CompilerVersionHash = VersionHasher.Value;
+        return Context;
+    }
+
+    // DXC objects must not be used from two threads at once. Each compile checks a context out and
+    // returns it afterwards, so the pool settles at one context per thread that compiles concurrently.
+    class FDxcContextPool
+    {
+    public:
+        static FDxcContextPool& Get()
+        {
+            static FDxcContextPool Pool;
+            return Pool;
+        }
+
+        std::unique_ptr<FDxcContext> Acquire()
+        {
+            {
+                std::lock_guard<std::mutex> Lock(Mutex);
+                if (!FreeContexts.empty())
+                {
+                    std::unique_ptr<FDxcContext> Context = std::move(FreeContexts.back());
+                    FreeContexts.pop_back();
+                    return Context;
+                }
+            }
+            return CreateDxcContext();
+        }
+
+        void Release(std::unique_ptr<FDxcContext> Context)
+        {
+            if (!Context || !Context->Utils || !Context->Compiler)
+            {
+                return;
+            }
+
+            std::lock_guard<std::mutex> Lock(Mutex);
+            FreeContexts.push_back(std::move(Context));
+        }
+
+    private:
+        std::mutex Mutex;
+        std::vector<std::unique_ptr<FDxcContext>> FreeContexts;
+    };
+
+    class FScopedDxcContext
+    {
+    public:
+        FScopedDxcContext()
+            : Context(FDxcContextPool::Get().Acquire())
+        {
+        }
+
+        ~FScopedDxcContext()
+        {
+            FDxcContextPool::Get().Release(std::move(Context));
+        }
+
+        FDxcContext* operator->() const { return Context.get(); }
+
+    private:
+        std::unique_ptr<FDxcContext> Context;
+    };
+
+    // Every shader compiled this session, keyed by request, so hot reload can find the dependents of a file.
+    struct FCompiledShaderRecord
+    {
+        std::wstring FilePath;
+        std::wstring EntryPoint;
+        std::wstring Target;
+        std::vector<std::wstring> Defines;
+        // Normalized main file followed by its includes.
+        std::vector<std::wstring> Sources;
+        std::vector<uint8_t> ByteCode;
+    };
+
+    std::mutex CompiledShaderMutex;
+    std::unordered_map<uint64_t, FCompiledShaderRecord> CompiledShaders;
 }
 
-FShaderCompiler::FShaderCompiler()
+std::atomic<uint32_t> FShaderCompiler::CacheHits{ 0 };
+std::atomic<uint32_t> FShaderCompiler::CacheMisses{ 0 };
+
+void FShaderCompiler::LogCacheStatistics()
 {
-    DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&Utils));
-    DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&Compiler));
+    LogInfo("Shader cache: " + std::to_string(CacheHits.load()) + " hits, " + std::to_string(CacheMisses.load()) + " misses");
+}
 
-    if (Utils)
+std::wstring FShaderCompiler::NormalizeShaderPath(const std::filesystem::path& Path)
+{
+    std::error_code Error;
+    std::filesystem::path Normalized = std::filesystem::weakly_canonical(Path, Error);
+    if (Error)
     {
-        Utils->CreateDefaultIncludeHandler(&IncludeHandler);
+        Normalized = std::filesystem::absolute(Path, Error).lexically_normal();
     }
+
+    std::wstring Result = Normalized.wstring();
+    std::transform(Result.begin(), Result.end(), Result.begin(), [](wchar_t Char) { return static_cast<wchar_t>(towlower(Char)); });
+    return Result;
 }
 
-bool FShaderCompiler::CompileFromFile(
+void FShaderCompiler::RecordCompiledShader(
+    uint64_t RequestKey,
     const std::wstring& FilePath,
     const std::wstring& EntryPoint,
     const std::wstring& Target,
-    std::vector<uint8_t>& OutByteCode,
-    const std::vector<std::wstring>& Defines)
+    const std::vector<std::wstring>& Defines,
+    const std::vector<std::wstring>& Dependencies,
+    const std::vector<uint8_t>& ByteCode)
 {
-    if (!Utils || !Compiler)
+    FCompiledShaderRecord Record;
+    Record.FilePath = FilePath;
+    Record.EntryPoint = EntryPoint;
+    Record.Target = Target;
+    Record.Defines = Defines;
+    Record.Sources.reserve(Dependencies.size() + 1);
+    Record.Sources.push_back(NormalizeShaderPath(FilePath));
+    for (const std::wstring& Dependency : Dependencies)
     {
-        LogError("Shader compiler is not initialized.");
-        return false;
+        Record.Sources.push_back(NormalizeShaderPath(Dependency));
     }
+    Record.ByteCode = ByteCode;
 
-    Microsoft::WRL::ComPtr<IDxcBlobEncoding> SourceBlob;
-    if (FAILED(Utils->LoadFile(FilePath.c_str(), nullptr, &SourceBlob)))
+    std::lock_guard<std::mutex> Lock(CompiledShaderMutex);
+    CompiledShaders[RequestKey] = std::move(Record);
+}
+
+bool FShaderCompiler::RecompileDependents(
+    const std::vector<std::filesystem::path>& ChangedFiles,
+    std::vector<std::wstring>& OutAffectedSources,
+    std::vector<FShaderBytecodeChange>& OutChanges)
+{
+    OutAffectedSources.clear();
+    OutChanges.clear();
+
+    std::unordered_set<std::wstring> Changed;
+    for (const std::filesystem::path& File : ChangedFiles)
+    {
+        Changed.insert(NormalizeShaderPath(File));
+    }
+
+    std::vector<FCompiledShaderRecord> Dependents;
+    {
+        std::lock_guard<std::mutex> Lock(CompiledShaderMutex);
+        for (const auto& Entry : CompiledShaders)
+        {
+            const std::vector<std::wstring>& Sources = Entry.second.Sources;
+            if (std::any_of(Sources.begin(), Sources.end(), [&Changed](const std::wstring& Source) { return Changed.count(Source) > 0; }))
+            {
+                Dependents.push_back(Entry.second);
+            }
+        }
+    }
+
+    if (Dependents.empty())
+    {
+        return true;
+    }
+
+    std::vector<std::vector<uint8_t>> ByteCodes(Dependents.size());
+    std::vector<FShaderCompileRequest> Requests(Dependents.size());
+    for (size_t Index = 0; Index < Dependents.size(); ++Index)
+    {
+        Requests[Index].FilePath = Dependents[Index].FilePath;
+        Requests[Index].EntryPoint = Dependents[Index].EntryPoint;
+        Requests[Index].Target = Dependents[Index].Target;
+        Requests[Index].Defines = Dependents[Index].Defines;
+        Requests[Index].OutByteCode = &ByteCodes[Index];
+    }
+
+    FShaderCompiler Compiler;
+    if (!Compiler.CompileShadersParallel(Requests))
     {
-        const std::string NarrowPath = WStringToUtf8(FilePath);
-        LogError("Failed to load shader file: " + NarrowPath);
         return false;
     }
 
-    DxcBuffer SourceBuffer = {};
-    SourceBuffer.Ptr = SourceBlob->GetBufferPointer();
-    SourceBuffer.Size = SourceBlob->GetBufferSize();
-    SourceBuffer.Encoding = DXC_CP_ACP;
+    for (size_t Index = 0; Index < Dependents.size(); ++Index)
+    {
+        if (std::find(OutAffectedSources.begin(), OutAffectedSources.end(), Dependents[Index].Sources.front()) == OutAffectedSources.end())
+        {
+            OutAffectedSources.push_back(Dependents[Index].Sources.front());
+        }
+
+        if (ByteCodes[Index] != Dependents[Index].ByteCode)
+        {
+            OutChanges.push_back({ std::move(Dependents[Index].ByteCode), std::move(ByteCodes[Index]) });
+        }
+    }
+    return true;
+}
+
+bool FShaderCompiler::CompileFromFile(
+    const std::wstring& FilePath,
+    const std::wstring& EntryPoint,
+    const std::wstring& Target,
+    std::vector<uint8_t>& OutByteCode,
+    const std::vector<std::wstring>& Defines)
+{
+    CPU_PROFILE_SCOPE("Compile Shader");
+    FScopedDxcContext Context;
+    if (!Context->Utils || !Context->Compiler)
+    {
+        LogError("Shader compiler is not initialized.");
+        return false;
+    }
 
     std::wstring EntryPointArg = L"-E" + EntryPoint;
     std::wstring TargetArg = L"-T" + Target;
@@ -89,13 +468,54 @@ bool FShaderCompiler::CompileFromFile(
         Arguments.push_back(L"-Od");
 #endif
 
-    Microsoft::WRL::ComPtr<IDxcResult> CompileResult;
     const std::string NarrowPath = WStringToUtf8(FilePath);
     const std::string EntryPointUtf8 = WStringToUtf8(EntryPoint);
     const std::string TargetUtf8 = WStringToUtf8(Target);
+
+    FShaderHasher RequestHasher;
+    RequestHasher.AddValue(Context->CompilerVersionHash);
+    RequestHasher.AddString(FilePath);
+    for (LPCWSTR Argument : Arguments)
+    {
+        RequestHasher.AddString(Argument);
+    }
+    const uint64_t RequestKey = RequestHasher.Value;
+    const std::filesystem::path ManifestPath = ShaderCacheDirectory / ToHexName(RequestKey, L".deps");
+
+    std::vector<std::wstring> CachedDependencies;
+    uint64_t CachedContentKey = 0;
+    if (ReadManifest(ManifestPath, CachedDependencies)
+        && ComputeContentKey(RequestKey, FilePath, CachedDependencies, CachedContentKey))
+    {
+        std::vector<char> CachedBytes;
+        if (ReadFileBytes(ShaderCacheDirectory / ToHexName(CachedContentKey, L".dxil"), CachedBytes) && !CachedBytes.empty())
+        {
+            OutByteCode.assign(CachedBytes.begin(), CachedBytes.end());
+            RecordCompiledShader(RequestKey, FilePath, EntryPoint, Target, Defines, CachedDependencies, OutByteCode);
+            ++CacheHits;
+            LogInfo("Loaded cached shader: " + NarrowPath + ", entry: " + EntryPointUtf8 + ", target: " + TargetUtf8);
+            return true;
+        }
+    }
+    ++CacheMisses;
+
+    Microsoft::WRL::ComPtr<IDxcBlobEncoding> SourceBlob;
+    if (FAILED(Context->Utils->LoadFile(FilePath.c_str(), nullptr, &SourceBlob)))
+    {
+        LogError("Failed to load shader file: " + NarrowPath);
+        return false;
+    }
+
+    DxcBuffer SourceBuffer = {};
+    SourceBuffer.Ptr = SourceBlob->GetBufferPointer();
+    SourceBuffer.Size = SourceBlob->GetBufferSize();
+    SourceBuffer.Encoding = DXC_CP_ACP;
+
+    Microsoft::WRL::ComPtr<IDxcResult> CompileResult;
     LogInfo("Compiling shader from file: " + NarrowPath + ", entry: " + EntryPointUtf8 + ", target: " + TargetUtf8);
 
-    HRESULT hr = Compiler->Compile(&SourceBuffer, Arguments.data(), static_cast<uint32_t>(Arguments.size()), IncludeHandler.Get(), IID_PPV_ARGS(&CompileResult));
+    FRecordingIncludeHandler RecordingIncludeHandler(Context->IncludeHandler.Get());
+    HRESULT hr = Context->Compiler->Compile(&SourceBuffer, Arguments.data(), static_cast<uint32_t>(Arguments.size()), &RecordingIncludeHandler, IID_PPV_ARGS(&CompileResult));
     if (FAILED(hr))
     {
         LogError("DxcCompile failed for shader: " + NarrowPath);
@@ -128,6 +548,26 @@ bool FShaderCompiler::CompileFromFile(
 
     OutByteCode.resize(ShaderBlob->GetBufferSize());
     memcpy(OutByteCode.data(), ShaderBlob->GetBufferPointer(), ShaderBlob->GetBufferSize());
+
+    uint64_t ContentKey = 0;
+    if (ComputeContentKey(RequestKey, FilePath, RecordingIncludeHandler.Dependencies, ContentKey))
+    {
+        std::string Manifest;
+        for (const std::wstring& Dependency : RecordingIncludeHandler.Dependencies)
+        {
+            Manifest += WStringToUtf8(Dependency) + "\n";
+        }
+
+        // The blob goes first so a manifest never points at missing bytecode.
+        const bool bStored = WriteCacheFile(ShaderCacheDirectory / ToHexName(ContentKey, L".dxil"), OutByteCode.data(), OutByteCode.size())
+            && WriteCacheFile(ManifestPath, Manifest.data(), Manifest.size());
+        if (!bStored)
+        {
+            LogWarning("Failed to write shader cache entry for: " + NarrowPath);
+        }
+    }
+
+    RecordCompiledShader(RequestKey, FilePath, EntryPoint, Target, Defines, RecordingIncludeHandler.Dependencies, OutByteCode);
     return true;
 }
 
@@ -140,30 +580,31 @@ bool FShaderCompiler::CompileShadersParallel(std::vector<FShaderCompileRequest>&
 
     const auto StartTime = std::chrono::high_resolution_clock::now();
 
-    // NOTE: Parallel shader compilation is disabled due to DXC thread-safety issues.
-    // DXC COM objects (IDxcCompiler3, IDxcUtils, IDxcIncludeHandler) are not thread-safe.
-    // When multiple threads access these shared objects concurrently, it causes D3D12 errors:
-    // "ID3D12CommandAllocator is being reset before previous executions have completed"
-    // 
-    // To enable true parallel compilation, each thread would need its own FShaderCompiler
-    // instance with separate DXC COM objects, but the performance benefit is minimal
-    // since DXC compilation is already quite fast and the overhead of thread coordination
-    // would likely negate any gains.
-    
-    // Compile shaders serially for thread safety
+    // Shaders inherit background scheduling during async reloads, so frame work keeps its workers.
+    const ETaskPriority Priority = FTaskScheduler::GetCurrentTaskPriority() == ETaskPriority::Background
+        ? ETaskPriority::Background
+        : ETaskPriority::Normal;
+
+    FTaskScheduler& Scheduler = FTaskScheduler::Get();
+    FTaskCounter Counter;
     for (FShaderCompileRequest& Request : Requests)
     {
-        Request.bSuccess = CompileFromFile(
-            Request.FilePath,
-            Request.EntryPoint,
-            Request.Target,
-            *Request.OutByteCode,
-            Request.Defines);
+        FShaderCompileRequest* RequestPtr = &Request;
+        Scheduler.Spawn(Counter, [this, RequestPtr]()
+        {
+            RequestPtr->bSuccess = CompileFromFile(
+                RequestPtr->FilePath,
+                RequestPtr->EntryPoint,
+                RequestPtr->Target,
+                *RequestPtr->OutByteCode,
+                RequestPtr->Defines);
+        }, Priority);
     }
+    Scheduler.WaitForCounter(Counter);
 
     const auto EndTime = std::chrono::high_resolution_clock::now();
     const auto Duration = std::chrono::duration_cast<std::chrono::milliseconds>(EndTime - StartTime);
-    LogInfo("Compiled " + std::to_string(Requests.size()) + " shaders serially in " + std::to_string(Duration.count()) + " ms");
+    LogInfo("Compiled " + std::to_string(Requests.size()) + " shaders on " + std::to_string(Scheduler.GetWorkerThreadCount() + 1) + " threads in " + std::to_string(Duration.count()) + " ms");
 
     // Check if all shaders compiled successfully
     bool bAllSuccess = true;
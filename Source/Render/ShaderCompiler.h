@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
 #include <string>
 #include <vector>
 #include <wrl.h>
@@ -16,10 +19,23 @@ struct FShaderCompileRequest
     bool bSuccess = false;
 };
 
+struct FShaderBytecodeChange
+{
+    std::vector<uint8_t> OldByteCode;
+    std::vector<uint8_t> NewByteCode;
+};
+
+/**
+ * DXC front end with a content-addressed bytecode cache in ShaderCache/.
+ * A request (file, entry point, target, defines, arguments and compiler version) maps to a manifest
+ * listing the includes IncludeHandler resolved on the last compile; the bytecode is stored under the
+ * hash of the request plus the current contents of the source and every listed include, so editing
+ * any of them misses and recompiles.
+ */
 class FShaderCompiler
 {
 public:
-    FShaderCompiler();
+    FShaderCompiler() = default;
 
     bool CompileFromFile(
         const std::wstring& FilePath,
@@ -29,18 +45,45 @@ public:
         const std::vector<std::wstring>& Defines = {});
 
     /**
-     * Compile multiple shaders in parallel using the task system.
-     * NOTE: Currently disabled due to DXC thread-safety issues.
-     * DXC COM objects (IDxcCompiler3, IDxcUtils) are not thread-safe and
-     * cause D3D12 command allocator errors when accessed concurrently.
-     * This function now compiles serially for safety.
+     * Compile multiple shaders in parallel on the task system.
+     * DXC objects are not thread-safe, so every compile checks a context (IDxcUtils, IDxcCompiler3,
+     * IDxcIncludeHandler) out of a shared pool; the pool grows to one context per thread compiling
+     * at once. The tasks only touch DXC and the bytecode cache; PSO creation and any queue work
+     * stay on the calling thread.
      * @param Requests Vector of shader compilation requests
      * @return True if all shaders compiled successfully
      */
     bool CompileShadersParallel(std::vector<FShaderCompileRequest>& Requests);
 
+    // Logs the bytecode cache hit/miss counts accumulated by all compiler instances.
+    static void LogCacheStatistics();
+
+    // Absolute, lexically normal form used to compare shader paths from requests and include handlers.
+    static std::wstring NormalizeShaderPath(const std::filesystem::path& Path);
+
+    /**
+     * Recompiles every shader compiled this session whose source or recorded includes contain one of
+     * ChangedFiles. Each successful CompileFromFile remembers its request, dependencies and bytecode
+     * for this purpose.
+     * @param OutAffectedSources Normalized main source files of the recompiled shaders
+     * @param OutChanges Old and new bytecode of every shader whose output changed
+     * @return False if any recompile failed; the outputs are then left empty
+     */
+    static bool RecompileDependents(
+        const std::vector<std::filesystem::path>& ChangedFiles,
+        std::vector<std::wstring>& OutAffectedSources,
+        std::vector<FShaderBytecodeChange>& OutChanges);
+
 private:
-    Microsoft::WRL::ComPtr<IDxcUtils> Utils;
-    Microsoft::WRL::ComPtr<IDxcCompiler3> Compiler;
-    Microsoft::WRL::ComPtr<IDxcIncludeHandler> IncludeHandler;
+    static void RecordCompiledShader(
+        uint64_t RequestKey,
+        const std::wstring& FilePath,
+        const std::wstring& EntryPoint,
+        const std::wstring& Target,
+        const std::vector<std::wstring>& Defines,
+        const std::vector<std::wstring>& Dependencies,
+        const std::vector<uint8_t>& ByteCode);
+
+    static std::atomic<uint32_t> CacheHits;
+    static std::atomic<uint32_t> CacheMisses;
 };
@@ -0,0 +1,125 @@
+#include "ShaderHotReload.h"
+
+#include "Renderer.h"
+#include "ShaderCompiler.h"
+#include "../Core/Logger.h"
+#include "../RHI/DX12Device.h"
+#include "../RHI/DX12PipelineCache.h"
+
+#include <system_error>
+
+FShaderHotReload::~FShaderHotReload()
+{
+    if (PendingTask)
+    {
+        PendingTask->Wait();
+    }
+}
+
+void FShaderHotReload::Initialize(const std::filesystem::path& InShaderDirectory)
+{
+    ShaderDirectory = InShaderDirectory;
+    FileTimes.clear();
+    QueuedFiles.clear();
+
+    // The first scan only records timestamps.
+    std::vector<std::filesystem::path> IgnoredFiles;
+    CollectChangedFiles(IgnoredFiles);
+    NextPollTime = std::chrono::steady_clock::now() + PollInterval;
+    LogInfo("Shader hot reload watching " + ShaderDirectory.u8string() + " (" + std::to_string(FileTimes.size()) + " files)");
+}
+
+void FShaderHotReload::CollectChangedFiles(std::vector<std::filesystem::path>& OutChangedFiles)
+{
+    std::error_code Error;
+    for (std::filesystem::recursive_directory_iterator It(ShaderDirectory, Error), End; !Error && It != End; It.increment(Error))
+    {
+        if (!It->is_regular_file(Error))
+        {
+            continue;
+        }
+
+        const std::filesystem::file_time_type WriteTime = It->last_write_time(Error);
+        if (Error)
+        {
+            // Editors briefly lock or replace the file while saving; pick it up on the next poll.
+            Error.clear();
+            continue;
+        }
+
+        const std::wstring Key = FShaderCompiler::NormalizeShaderPath(It->path());
+        auto Found = FileTimes.find(Key);
+        if (Found == FileTimes.end())
+        {
+            FileTimes.emplace(Key, WriteTime);
+        }
+        else if (Found->second != WriteTime)
+        {
+            Found->second = WriteTime;
+            OutChangedFiles.push_back(It->path());
+        }
+    }
+}
+
+void FShaderHotReload::Tick(FDX12Device* Device, FRenderer* Renderer)
+{
+    if (PendingTask)
+    {
+        if (!PendingTask->IsComplete())
+        {
+            return;
+        }
+        PendingTask.reset();
+
+        if (!bPendingSucceeded)
+        {
+            LogWarning("Shader hot reload failed to compile, keeping the previous pipelines");
+        }
+        else if (!PendingAffectedSources.empty() && Renderer)
+        {
+            const uint32_t RebuiltCount = Renderer->RebuildShaderPipelines(PendingAffectedSources);
+            LogInfo("Shader hot reload: " + std::to_string(PendingAffectedSources.size()) + " source files, "
+                + std::to_string(PendingPrecreatedCount) + " pipelines pre-created, "
+                + std::to_string(RebuiltCount) + " pipeline groups swapped");
+        }
+        PendingAffectedSources.clear();
+    }
+
+    const std::chrono::steady_clock::time_point Now = std::chrono::steady_clock::now();
+    if (Now >= NextPollTime)
+    {
+        NextPollTime = Now + PollInterval;
+        CollectChangedFiles(QueuedFiles);
+    }
+
+    if (QueuedFiles.empty() || !Device || !FTaskScheduler::Get().IsRunning())
+    {
+        return;
+    }
+
+    for (const std::filesystem::path& File : QueuedFiles)
+    {
+        LogInfo("Shader changed: " + File.u8string());
+    }
+
+    bPendingSucceeded = false;
+    PendingPrecreatedCount = 0;
+    PendingTask = FTaskScheduler::Get().ScheduleTask([this, Device, ChangedFiles = std::move(QueuedFiles)]()
+    {
+        std::vector<FShaderBytecodeChange> Changes;
+        if (!FShaderCompiler::RecompileDependents(ChangedFiles, PendingAffectedSources, Changes))
+        {
+            return;
+        }
+
+        std::vector<FDX12ShaderReplacement> Replacements;
+        Replacements.reserve(Changes.size());
+        for (FShaderBytecodeChange& Change : Changes)
+        {
+            Replacements.push_back({ std::move(Change.OldByteCode), std::move(Change.NewByteCode) });
+        }
+        PendingPrecreatedCount = Device->GetPipelineCache()->PrecreateWithReplacedShaders(Replacements);
+        bPendingSucceeded = true;
+    }, ETaskPriority::Background);
+    QueuedFiles.clear();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../Core/TaskSystem.h"
+
+class FDX12Device;
+class FRenderer;
+
+/**
+ * Watches the shader directory and reloads edited shaders while the renderer keeps running.
+ * A change recompiles only the entry points whose source or includes contain the file, then a
+ * background task pre-creates every pipeline built from the old bytecode with the new bytecode
+ * through the device pipeline cache. Tick swaps them in at a frame boundary by re-running the
+ * affected pipeline builders, which then hit the shader and pipeline caches; replaced pipelines
+ * stay alive in the pipeline cache, so frames in flight need no GPU flush.
+ */
+class FShaderHotReload
+{
+public:
+    FShaderHotReload() = default;
+    FShaderHotReload(const FShaderHotReload&) = delete;
+    FShaderHotReload& operator=(const FShaderHotReload&) = delete;
+    ~FShaderHotReload();
+
+    void Initialize(const std::filesystem::path& InShaderDirectory);
+
+    // Call at the start of a frame, before any command recording.
+    void Tick(FDX12Device* Device, FRenderer* Renderer);
+
+private:
+    void CollectChangedFiles(std::vector<std::filesystem::path>& OutChangedFiles);
+
+    static constexpr std::chrono::milliseconds PollInterval{ 500 };
+
+    std::filesystem::path ShaderDirectory;
+    std::unordered_map<std::wstring, std::filesystem::file_time_type> FileTimes;
+    std::chrono::steady_clock::time_point NextPollTime;
+    std::vector<std::filesystem::path> QueuedFiles;
+
+    // Results are written by PendingTask and only read once it has completed.
+    FTaskRef PendingTask;
+    bool bPendingSucceeded = false;
+    uint32_t PendingPrecreatedCount = 0;
+    std::vector<std::wstring> PendingAffectedSources;
+};
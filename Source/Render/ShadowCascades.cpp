@@ -0,0 +1,253 @@
+#include "ShadowCascades.h"
+
+#include "../Scene/Camera.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+void FShadowCascades::Invalidate()
+{
+    RenderMask = 0;
+    for (FCascade& Cascade : Cascades)
+    {
+        Cascade.bValid = false;
+    }
+}
+
+void FShadowCascades::InvalidateBounds(const DirectX::XMFLOAT3& BoundsMin, const DirectX::XMFLOAT3& BoundsMax)
+{
+    using namespace DirectX;
+
+    const XMMATRIX View = XMLoadFloat4x4(&LightView);
+    XMFLOAT2 RectMin(FLT_MAX, FLT_MAX);
+    XMFLOAT2 RectMax(-FLT_MAX, -FLT_MAX);
+    for (uint32_t Corner = 0; Corner < 8; ++Corner)
+    {
+        const XMVECTOR Point = XMVectorSet(
+            (Corner & 1) ? BoundsMax.x : BoundsMin.x,
+            (Corner & 2) ? BoundsMax.y : BoundsMin.y,
+            (Corner & 4) ? BoundsMax.z : BoundsMin.z,
+            1.0f);
+        XMFLOAT3 LightSpace;
+        XMStoreFloat3(&LightSpace, XMVector3TransformCoord(Point, View));
+        RectMin.x = (std::min)(RectMin.x, LightSpace.x);
+        RectMin.y = (std::min)(RectMin.y, LightSpace.y);
+        RectMax.x = (std::max)(RectMax.x, LightSpace.x);
+        RectMax.y = (std::max)(RectMax.y, LightSpace.y);
+    }
+
+    for (uint32_t CascadeIndex = FirstCachedCascade; CascadeIndex < CascadeCount; ++CascadeIndex)
+    {
+        FCascade& Cascade = Cascades[CascadeIndex];
+        if (Cascade.bValid
+            && RectMax.x >= Cascade.Center.x - Cascade.HalfExtent && RectMin.x <= Cascade.Center.x + Cascade.HalfExtent
+            && RectMax.y >= Cascade.Center.y - Cascade.HalfExtent && RectMin.y <= Cascade.Center.y + Cascade.HalfExtent)
+        {
+            Cascade.bValid = false;
+        }
+    }
+}
+
+uint32_t FShadowCascades::Update(
+    const FCamera& Camera,
+    const DirectX::XMFLOAT3& LightDirection,
+    const DirectX::XMFLOAT3& SceneCenter,
+    float SceneRadius,
+    uint32_t Resolution)
+{
+    const FCamera* Cameras[] = { &Camera };
+    return Update(Cameras, 1, LightDirection, SceneCenter, SceneRadius, Resolution);
+}
+
+uint32_t FShadowCascades::Update(
+    const FCamera* const* Cameras,
+    uint32_t CameraCount,
+    const DirectX::XMFLOAT3& LightDirection,
+    const DirectX::XMFLOAT3& SceneCenter,
+    float SceneRadius,
+    uint32_t Resolution)
+{
+    using namespace DirectX;
+
+    RenderMask = 0;
+    if (!Cameras || CameraCount == 0)
+    {
+        return 0;
+    }
+    const FCamera& Camera = *Cameras[0];
+
+    // The light shines along -LightDirection; the view has no translation, so only its rotation
+    // decides whether cached cascades still hold valid depth.
+    const XMVECTOR Direction = XMVector3Normalize(XMLoadFloat3(&LightDirection));
+    if (XMVectorGetX(XMVector3Dot(Direction, XMLoadFloat3(&FittedLightDirection))) < 0.99999f)
+    {
+        XMStoreFloat3(&FittedLightDirection, Direction);
+        const XMVECTOR Up = std::fabs(XMVectorGetY(Direction)) > 0.99f ? XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f) : XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+        XMStoreFloat4x4(&LightView, XMMatrixLookToLH(XMVectorZero(), XMVectorNegate(Direction), Up));
+        Invalidate();
+    }
+
+    const XMMATRIX View = XMLoadFloat4x4(&LightView);
+    const float Radius = (std::max)(SceneRadius, 1e-3f) * 1.01f;
+    const float SceneDepth = XMVectorGetZ(XMVector3TransformCoord(XMLoadFloat3(&SceneCenter), View));
+    if (std::fabs(SceneDepth - Radius - DepthMin) > Radius * 1e-4f || std::fabs(SceneDepth + Radius - DepthMax) > Radius * 1e-4f)
+    {
+        DepthMin = SceneDepth - Radius;
+        DepthMax = SceneDepth + Radius;
+        Invalidate();
+    }
+
+    // Shadows reach the far side of the scene, rounded up to a power of two so the splits, and
+    // with them the cascade sizes, only change when the camera moves a long way.
+    const XMVECTOR CameraPosition = XMLoadFloat3(&Camera.GetPosition());
+    const XMVECTOR CameraForward = XMVector3Normalize(XMLoadFloat3(&Camera.GetForward()));
+    const float NearZ = (std::max)(Camera.GetNearClip(), 1e-3f);
+    const float SceneFarDistance = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&SceneCenter), CameraPosition))) + SceneRadius;
+    const float RoundedDistance = std::exp2(std::ceil(std::log2((std::max)(SceneFarDistance, NearZ * 2.0f))));
+    const float ShadowDistance = (std::max)((std::min)(Camera.GetFarClip(), RoundedDistance), NearZ * 2.0f);
+
+    const float TanHalfFovY = std::tan(Camera.GetFovY() * 0.5f);
+    const float TanHalfFovX = TanHalfFovY * Camera.GetAspectRatio();
+    const float DiagonalSq = TanHalfFovX * TanHalfFovX + TanHalfFovY * TanHalfFovY;
+    const float ResolutionF = static_cast<float>((std::max)(Resolution, 4u));
+
+    float SliceNear = NearZ;
+    float* const Splits = &SplitDepths.x;
+    for (uint32_t CascadeIndex = 0; CascadeIndex < CascadeCount; ++CascadeIndex)
+    {
+        const float Fraction = static_cast<float>(CascadeIndex + 1) / static_cast<float>(CascadeCount);
+        const float UniformSplit = NearZ + (ShadowDistance - NearZ) * Fraction;
+        const float LogSplit = NearZ * std::pow(ShadowDistance / NearZ, Fraction);
+        const float SliceFar = UniformSplit + (LogSplit - UniformSplit) * SplitLambda;
+        Splits[CascadeIndex] = SliceFar;
+
+        // Smallest sphere around the slice's corners; its center lies on the view axis.
+        const float CenterDepth = (std::min)((SliceNear + SliceFar) * (1.0f + DiagonalSq) * 0.5f, SliceFar);
+        float SliceRadius = std::sqrt((SliceFar - CenterDepth) * (SliceFar - CenterDepth) + SliceFar * SliceFar * DiagonalSq);
+
+        XMFLOAT3 SliceCenter;
+        XMStoreFloat3(&SliceCenter, XMVector3TransformCoord(XMVectorMultiplyAdd(CameraForward, XMVectorReplicate(CenterDepth), CameraPosition), View));
+        if (CameraCount > 1)
+        {
+            EncloseViewSlices(Cameras, CameraCount, View, SliceNear, SliceFar, SliceCenter, SliceRadius);
+        }
+        SliceNear = SliceFar;
+
+        FCascade& Cascade = Cascades[CascadeIndex];
+        const bool bCached = CascadeIndex >= FirstCachedCascade;
+        if (bCached && Cascade.bValid && std::fabs(Cascade.SliceRadius - SliceRadius) <= SliceRadius * 1e-4f)
+        {
+            const float OffsetX = SliceCenter.x - Cascade.Center.x;
+            const float OffsetY = SliceCenter.y - Cascade.Center.y;
+            if (std::sqrt(OffsetX * OffsetX + OffsetY * OffsetY) + SliceRadius <= Cascade.HalfExtent)
+            {
+                continue;
+            }
+        }
+
+        // One texel of margin keeps the sphere inside after snapping the center by up to half a texel.
+        const float Padding = bCached ? CachedCascadePadding : 1.0f;
+        Cascade.HalfExtent = SliceRadius * Padding * ResolutionF / (ResolutionF - 2.0f);
+        const float TexelSize = 2.0f * Cascade.HalfExtent / ResolutionF;
+        Cascade.Center.x = std::floor(SliceCenter.x / TexelSize + 0.5f) * TexelSize;
+        Cascade.Center.y = std::floor(SliceCenter.y / TexelSize + 0.5f) * TexelSize;
+        Cascade.SliceRadius = SliceRadius;
+        Cascade.bValid = true;
+        RenderMask |= 1u << CascadeIndex;
+    }
+
+    return RenderMask;
+}
+
+void FShadowCascades::EncloseViewSlices(
+    const FCamera* const* Cameras,
+    uint32_t CameraCount,
+    const DirectX::XMMATRIX& View,
+    float SliceNear,
+    float SliceFar,
+    DirectX::XMFLOAT3& InOutCenter,
+    float& InOutRadius) const
+{
+    using namespace DirectX;
+
+    // Only the light-space square matters, as every cascade spans the scene's depth, so the
+    // views' slice spheres are enclosed by a circle around the middle of their centers.
+    std::array<XMFLOAT3, MaxSharedViews> Centers;
+    std::array<float, MaxSharedViews> Radii;
+    const uint32_t Count = (std::min)(CameraCount, static_cast<uint32_t>(Centers.size()));
+    XMFLOAT2 CenterMin(FLT_MAX, FLT_MAX);
+    XMFLOAT2 CenterMax(-FLT_MAX, -FLT_MAX);
+    for (uint32_t ViewIndex = 0; ViewIndex < Count; ++ViewIndex)
+    {
+        const FCamera& ViewCamera = *Cameras[ViewIndex];
+        const float TanHalfFovY = std::tan(ViewCamera.GetFovY() * 0.5f);
+        const float TanHalfFovX = TanHalfFovY * ViewCamera.GetAspectRatio();
+        const float DiagonalSq = TanHalfFovX * TanHalfFovX + TanHalfFovY * TanHalfFovY;
+        const float CenterDepth = (std::min)((SliceNear + SliceFar) * (1.0f + DiagonalSq) * 0.5f, SliceFar);
+        Radii[ViewIndex] = std::sqrt((SliceFar - CenterDepth) * (SliceFar - CenterDepth) + SliceFar * SliceFar * DiagonalSq);
+
+        const XMVECTOR Position = XMLoadFloat3(&ViewCamera.GetPosition());
+        const XMVECTOR Forward = XMVector3Normalize(XMLoadFloat3(&ViewCamera.GetForward()));
+        XMStoreFloat3(&Centers[ViewIndex], XMVector3TransformCoord(XMVectorMultiplyAdd(Forward, XMVectorReplicate(CenterDepth), Position), View));
+        CenterMin.x = (std::min)(CenterMin.x, Centers[ViewIndex].x);
+        CenterMin.y = (std::min)(CenterMin.y, Centers[ViewIndex].y);
+        CenterMax.x = (std::max)(CenterMax.x, Centers[ViewIndex].x);
+        CenterMax.y = (std::max)(CenterMax.y, Centers[ViewIndex].y);
+    }
+
+    InOutCenter.x = (CenterMin.x + CenterMax.x) * 0.5f;
+    InOutCenter.y = (CenterMin.y + CenterMax.y) * 0.5f;
+    InOutRadius = 0.0f;
+    for (uint32_t ViewIndex = 0; ViewIndex < Count; ++ViewIndex)
+    {
+        const float OffsetX = Centers[ViewIndex].x - InOutCenter.x;
+        const float OffsetY = Centers[ViewIndex].y - InOutCenter.y;
+        InOutRadius = (std::max)(InOutRadius, std::sqrt(OffsetX * OffsetX + OffsetY * OffsetY) + Radii[ViewIndex]);
+    }
+}
+
+DirectX::XMMATRIX FShadowCascades::GetViewProjection(uint32_t CascadeIndex) const
+{
+    const FCascade& Cascade = Cascades[(std::min)(CascadeIndex, CascadeCount - 1)];
+    return DirectX::XMMatrixMultiply(DirectX::XMLoadFloat4x4(&LightView), BuildProjection(Cascade.Center, Cascade.HalfExtent));
+}
+
+DirectX::XMMATRIX FShadowCascades::BuildEnclosingViewProjection(uint32_t Mask, float& OutTexelScale) const
+{
+    using namespace DirectX;
+
+    XMFLOAT2 RectMin(FLT_MAX, FLT_MAX);
+    XMFLOAT2 RectMax(-FLT_MAX, -FLT_MAX);
+    float FinestHalfExtent = FLT_MAX;
+    for (uint32_t CascadeIndex = 0; CascadeIndex < CascadeCount; ++CascadeIndex)
+    {
+        if ((Mask & (1u << CascadeIndex)) == 0)
+        {
+            continue;
+        }
+
+        const FCascade& Cascade = Cascades[CascadeIndex];
+        RectMin.x = (std::min)(RectMin.x, Cascade.Center.x - Cascade.HalfExtent);
+        RectMin.y = (std::min)(RectMin.y, Cascade.Center.y - Cascade.HalfExtent);
+        RectMax.x = (std::max)(RectMax.x, Cascade.Center.x + Cascade.HalfExtent);
+        RectMax.y = (std::max)(RectMax.y, Cascade.Center.y + Cascade.HalfExtent);
+        FinestHalfExtent = (std::min)(FinestHalfExtent, Cascade.HalfExtent);
+    }
+
+    if (FinestHalfExtent == FLT_MAX || FinestHalfExtent <= 0.0f)
+    {
+        OutTexelScale = 1.0f;
+        return GetViewProjection(0);
+    }
+
+    OutTexelScale = (std::max)(RectMax.x - RectMin.x, RectMax.y - RectMin.y) / (2.0f * FinestHalfExtent);
+    const XMMATRIX Projection = XMMatrixOrthographicOffCenterLH(RectMin.x, RectMax.x, RectMin.y, RectMax.y, DepthMin, DepthMax);
+    return XMMatrixMultiply(XMLoadFloat4x4(&LightView), Projection);
+}
+
+DirectX::XMMATRIX FShadowCascades::BuildProjection(const DirectX::XMFLOAT2& Center, float HalfExtent) const
+{
+    const float Extent = (std::max)(HalfExtent, 1e-3f);
+    return DirectX::XMMatrixOrthographicOffCenterLH(Center.x - Extent, Center.x + Extent, Center.y - Extent, Center.y + Extent, DepthMin, DepthMax);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <DirectXMath.h>
+#include <array>
+#include <cstdint>
+
+class FCamera;
+
+/**
+ * Cascade fitting of the directional light's shadow map array. Each cascade covers a slice of
+ * the camera frustum, bounded by a sphere so its extent does not change as the camera turns,
+ * and its origin is snapped to whole shadow texels so static shadows do not shimmer while the
+ * camera moves. Every cascade spans the scene's depth along the light, so casters outside the
+ * slice still shadow it and ShadowBias means the same in all of them.
+ *
+ * Cascades from FirstCachedCascade on keep their shadow map slice across frames. They are fitted
+ * with CachedCascadePadding of slack and refitted only once the slice leaves it, the light
+ * turns, or geometry inside them moves, so most frames render only the near cascades.
+ */
+class FShadowCascades
+{
+public:
+    // SHADOW_CASCADE_COUNT in Shaders/SceneConstants.hlsl.
+    static constexpr uint32_t CascadeCount = 4;
+    static constexpr uint32_t FirstCachedCascade = 2;
+    static constexpr float CachedCascadePadding = 1.25f;
+    // Weight of the logarithmic split over the uniform one.
+    static constexpr float SplitLambda = 0.75f;
+    static constexpr uint32_t MaxSharedViews = 8;
+
+    // Forces every cascade to render next update, for a new shadow map or scene.
+    void Invalidate();
+    // Geometry within these world bounds changed; cached cascades overlapping them render again.
+    void InvalidateBounds(const DirectX::XMFLOAT3& BoundsMin, const DirectX::XMFLOAT3& BoundsMax);
+
+    /**
+     * Fits the cascades to the camera for this frame.
+     * @param Resolution Width and height of one shadow map slice in texels
+     * @return Mask of the cascades whose slice must be rendered this frame
+     */
+    uint32_t Update(
+        const FCamera& Camera,
+        const DirectX::XMFLOAT3& LightDirection,
+        const DirectX::XMFLOAT3& SceneCenter,
+        float SceneRadius,
+        uint32_t Resolution);
+
+    /**
+     * Fits the cascades once for several views rendered with the same shadow map, such as the
+     * faces of a cube capture. Splits follow the first view, which the others should share the
+     * clip range of, and each cascade encloses every view's slice.
+     * @param CameraCount Views beyond MaxSharedViews are ignored
+     */
+    uint32_t Update(
+        const FCamera* const* Cameras,
+        uint32_t CameraCount,
+        const DirectX::XMFLOAT3& LightDirection,
+        const DirectX::XMFLOAT3& SceneCenter,
+        float SceneRadius,
+        uint32_t Resolution);
+
+    uint32_t GetRenderMask() const { return RenderMask; }
+    DirectX::XMMATRIX GetViewProjection(uint32_t CascadeIndex) const;
+    // View depth where each cascade ends; pixels beyond the last are unshadowed.
+    const DirectX::XMFLOAT4& GetSplitDepths() const { return SplitDepths; }
+
+    /**
+     * Light frustum enclosing every cascade of Mask, to cull their casters once for all of them.
+     * @param OutTexelScale Texels of the finest cascade in Mask per texel of the enclosing frustum
+     */
+    DirectX::XMMATRIX BuildEnclosingViewProjection(uint32_t Mask, float& OutTexelScale) const;
+
+private:
+    struct FCascade
+    {
+        // Snapped light-space center and half extent of the slice's square.
+        DirectX::XMFLOAT2 Center{ 0.0f, 0.0f };
+        float HalfExtent = 0.0f;
+        // Bounding sphere radius of the camera slice it was fitted to.
+        float SliceRadius = 0.0f;
+        bool bValid = false;
+    };
+
+    DirectX::XMMATRIX BuildProjection(const DirectX::XMFLOAT2& Center, float HalfExtent) const;
+    // Widens one cascade's light-space slice sphere to enclose the same slice of every view.
+    void EncloseViewSlices(
+        const FCamera* const* Cameras,
+        uint32_t CameraCount,
+        const DirectX::XMMATRIX& View,
+        float SliceNear,
+        float SliceFar,
+        DirectX::XMFLOAT3& InOutCenter,
+        float& InOutRadius) const;
+
+    std::array<FCascade, CascadeCount> Cascades;
+    DirectX::XMFLOAT4X4 LightView{};
+    DirectX::XMFLOAT3 FittedLightDirection{ 0.0f, 0.0f, 0.0f };
+    float DepthMin = 0.0f;
+    float DepthMax = 1.0f;
+    DirectX::XMFLOAT4 SplitDepths{ 0.0f, 0.0f, 0.0f, 0.0f };
+    uint32_t RenderMask = 0;
+};
@@ -0,0 +1,351 @@
+#include "SkyAtmosphere.h"
+
+#include "RendererUtils.h"
+#include "ShaderCompiler.h"
+#include "../RHI/DX12Commons.h"
+#include "../RHI/DX12Device.h"
+#include "../Core/Logger.h"
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+    // The sun's angular radius, about 0.27 degrees.
+    constexpr float SunDiskCosine = 0.99998f;
+    // A physical disk would be brighter by one over its solid angle, which neither LDR targets nor
+    // the TAA history clamp handle well; this keeps it well above the sky around it.
+    constexpr float SunDiskLuminance = 50.0f;
+    // The sky-view LUT stays in place while the sun keeps within this cosine of the sun it holds.
+    constexpr float SkyViewSunCosineThreshold = 0.99999f;
+}
+
+bool FSkyAtmosphere::Initialize(FDX12Device* Device, DXGI_FORMAT InOutputFormat, const FSkyPipelineConfig& Config, const FDX12DescriptorRange& InDescriptors)
+{
+    SkyPipeline.Reset();
+    SkyViewLut.Reset();
+    if (!Device || !Device->GetDescriptorAllocator())
+    {
+        return false;
+    }
+
+    if (InDescriptors.Count < DescriptorCount)
+    {
+        LogError("Sky atmosphere needs " + std::to_string(DescriptorCount) + " descriptors");
+        return false;
+    }
+
+    Descriptors = InDescriptors;
+    DescriptorHeap = Device->GetDescriptorAllocator()->GetHeap();
+    OutputFormat = InOutputFormat;
+    PipelineConfig = Config;
+    if (!CreateRootSignature(Device) || !CreateLuts(Device) || !CreatePipelines(Device))
+    {
+        SkyPipeline.Reset();
+        SkyViewLut.Reset();
+        return false;
+    }
+    return true;
+}
+
+bool FSkyAtmosphere::CreateRootSignature(FDX12Device* Device)
+{
+    D3D12_DESCRIPTOR_RANGE1 Ranges[2] = {};
+    Ranges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    Ranges[0].NumDescriptors = 3;
+    Ranges[0].BaseShaderRegister = 0;
+    Ranges[0].RegisterSpace = 0;
+    Ranges[0].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
+    Ranges[0].OffsetInDescriptorsFromTableStart = 0;
+
+    Ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+    Ranges[1].NumDescriptors = 1;
+    Ranges[1].BaseShaderRegister = 0;
+    Ranges[1].RegisterSpace = 0;
+    Ranges[1].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
+    Ranges[1].OffsetInDescriptorsFromTableStart = 0;
+
+    D3D12_ROOT_PARAMETER1 RootParams[4] = {};
+    // RootParams[0]: View constants (b0)
+    RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    RootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[0].Descriptor.ShaderRegister = 0;
+    RootParams[0].Descriptor.RegisterSpace = 0;
+    RootParams[0].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+
+    // RootParams[1]: Sky atmosphere constants (b1)
+    RootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    RootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[1].Constants.Num32BitValues = ConstantCount;
+    RootParams[1].Constants.ShaderRegister = 1;
+    RootParams[1].Constants.RegisterSpace = 0;
+
+    // RootParams[2]: Transmittance, multiple-scattering and sky-view LUTs (t0..t2)
+    // RootParams[3]: LUT being built (u0)
+    for (uint32_t Index = 0; Index < _countof(Ranges); ++Index)
+    {
+        D3D12_ROOT_PARAMETER1& Param = RootParams[2 + Index];
+        Param.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+        Param.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+        Param.DescriptorTable.NumDescriptorRanges = 1;
+        Param.DescriptorTable.pDescriptorRanges = &Ranges[Index];
+    }
+
+    D3D12_STATIC_SAMPLER_DESC Sampler = {};
+    Sampler.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+    Sampler.AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    Sampler.AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    Sampler.AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+    Sampler.ComparisonFunc = D3D12_COMPARISON_FUNC_ALWAYS;
+    Sampler.MaxLOD = D3D12_FLOAT32_MAX;
+    Sampler.ShaderRegister = 0;
+    Sampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    D3D12_VERSIONED_ROOT_SIGNATURE_DESC RootSigDesc = {};
+    RootSigDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
+    RootSigDesc.Desc_1_1.NumParameters = _countof(RootParams);
+    RootSigDesc.Desc_1_1.pParameters = RootParams;
+    RootSigDesc.Desc_1_1.NumStaticSamplers = 1;
+    RootSigDesc.Desc_1_1.pStaticSamplers = &Sampler;
+    RootSigDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
+
+    ComPtr<ID3DBlob> SerializedSig;
+    ComPtr<ID3DBlob> ErrorBlob;
+    if (FAILED(D3D12SerializeVersionedRootSignature(&RootSigDesc, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf())))
+    {
+        if (ErrorBlob)
+        {
+            LogError(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
+        }
+        return false;
+    }
+
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), RootSignature.ReleaseAndGetAddressOf()));
+    return RootSignature != nullptr;
+}
+
+bool FSkyAtmosphere::CreatePipelines(FDX12Device* Device)
+{
+    if (!Device || !RootSignature)
+    {
+        return false;
+    }
+
+    FShaderCompiler Compiler;
+    const std::wstring CSTarget = RendererUtils::BuildShaderTarget(L"cs", Device->GetShaderModel());
+    std::vector<uint8_t> TransmittanceByteCode;
+    std::vector<uint8_t> MultiScatteringByteCode;
+    std::vector<uint8_t> SkyViewByteCode;
+    std::vector<uint8_t> VSByteCode;
+    std::vector<uint8_t> PSByteCode;
+    if (!Compiler.CompileFromFile(L"Shaders/SkyAtmosphere.hlsl", L"BuildTransmittanceLut", CSTarget, TransmittanceByteCode)
+        || !Compiler.CompileFromFile(L"Shaders/SkyAtmosphere.hlsl", L"BuildMultiScatteringLut", CSTarget, MultiScatteringByteCode)
+        || !Compiler.CompileFromFile(L"Shaders/SkyAtmosphere.hlsl", L"BuildSkyViewLut", CSTarget, SkyViewByteCode)
+        || !Compiler.CompileFromFile(L"Shaders/SkyAtmosphere.hlsl", L"SkyVS", RendererUtils::BuildShaderTarget(L"vs", Device->GetShaderModel()), VSByteCode)
+        || !Compiler.CompileFromFile(L"Shaders/SkyAtmosphere.hlsl", L"SkyPS", RendererUtils::BuildShaderTarget(L"ps", Device->GetShaderModel()), PSByteCode))
+    {
+        LogError("Failed to compile sky atmosphere shaders");
+        return false;
+    }
+
+    D3D12_COMPUTE_PIPELINE_STATE_DESC LutDesc = {};
+    LutDesc.pRootSignature = RootSignature.Get();
+
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC SkyDesc = {};
+    SkyDesc.pRootSignature = RootSignature.Get();
+    SkyDesc.VS = { VSByteCode.data(), VSByteCode.size() };
+    SkyDesc.PS = { PSByteCode.data(), PSByteCode.size() };
+    SkyDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+    SkyDesc.SampleMask = UINT_MAX;
+    SkyDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+    SkyDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+    SkyDesc.RasterizerState.DepthClipEnable = TRUE;
+    SkyDesc.DepthStencilState.DepthEnable = PipelineConfig.DepthEnable;
+    SkyDesc.DepthStencilState.DepthWriteMask = PipelineConfig.DepthWriteMask;
+    SkyDesc.DepthStencilState.DepthFunc = PipelineConfig.DepthFunc;
+    SkyDesc.DepthStencilState.StencilEnable = FALSE;
+    SkyDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    SkyDesc.NumRenderTargets = 1;
+    SkyDesc.RTVFormats[0] = OutputFormat;
+    SkyDesc.DSVFormat = PipelineConfig.DsvFormat;
+    SkyDesc.SampleDesc.Count = 1;
+
+    ComPtr<ID3D12PipelineState> NewTransmittancePipeline;
+    ComPtr<ID3D12PipelineState> NewMultiScatteringPipeline;
+    ComPtr<ID3D12PipelineState> NewSkyViewPipeline;
+    ComPtr<ID3D12PipelineState> NewSkyPipeline;
+    LutDesc.CS = { TransmittanceByteCode.data(), TransmittanceByteCode.size() };
+    const bool bTransmittanceCreated = SUCCEEDED(Device->GetPipelineCache()->CreateComputePipelineState(LutDesc, NewTransmittancePipeline.GetAddressOf()));
+    LutDesc.CS = { MultiScatteringByteCode.data(), MultiScatteringByteCode.size() };
+    const bool bMultiScatteringCreated = SUCCEEDED(Device->GetPipelineCache()->CreateComputePipelineState(LutDesc, NewMultiScatteringPipeline.GetAddressOf()));
+    LutDesc.CS = { SkyViewByteCode.data(), SkyViewByteCode.size() };
+    const bool bSkyViewCreated = SUCCEEDED(Device->GetPipelineCache()->CreateComputePipelineState(LutDesc, NewSkyViewPipeline.GetAddressOf()));
+    if (!bTransmittanceCreated || !bMultiScatteringCreated || !bSkyViewCreated
+        || FAILED(Device->GetPipelineCache()->CreateGraphicsPipelineState(SkyDesc, NewSkyPipeline.GetAddressOf())))
+    {
+        LogError("Failed to create sky atmosphere pipelines");
+        return false;
+    }
+
+    TransmittancePipeline = NewTransmittancePipeline;
+    MultiScatteringPipeline = NewMultiScatteringPipeline;
+    SkyViewPipeline = NewSkyViewPipeline;
+    SkyPipeline = NewSkyPipeline;
+    bAtmosphereLutsDirty = true;
+    bSkyViewLutDirty = true;
+    return true;
+}
+
+bool FSkyAtmosphere::CreateLuts(FDX12Device* Device)
+{
+    D3D12_HEAP_PROPERTIES DefaultHeap = {};
+    DefaultHeap.Type = D3D12_HEAP_TYPE_DEFAULT;
+    DefaultHeap.CreationNodeMask = 1;
+    DefaultHeap.VisibleNodeMask = 1;
+
+    struct FLutDesc
+    {
+        ComPtr<ID3D12Resource>* Resource;
+        D3D12_RESOURCE_STATES* State;
+        uint32_t Width;
+        uint32_t Height;
+        const wchar_t* Name;
+    };
+    const FLutDesc Luts[] =
+    {
+        { &TransmittanceLut, &TransmittanceLutState, TransmittanceLutWidth, TransmittanceLutHeight, L"SkyTransmittanceLut" },
+        { &MultiScatteringLut, &MultiScatteringLutState, MultiScatteringLutSize, MultiScatteringLutSize, L"SkyMultiScatteringLut" },
+        { &SkyViewLut, &SkyViewLutState, SkyViewLutWidth, SkyViewLutHeight, L"SkyViewLut" },
+    };
+
+    for (uint32_t Index = 0; Index < _countof(Luts); ++Index)
+    {
+        const FLutDesc& Lut = Luts[Index];
+
+        D3D12_RESOURCE_DESC Desc = {};
+        Desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        Desc.Width = Lut.Width;
+        Desc.Height = Lut.Height;
+        Desc.DepthOrArraySize = 1;
+        Desc.MipLevels = 1;
+        Desc.Format = LutFormat;
+        Desc.SampleDesc.Count = 1;
+        Desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        Desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+        HR_CHECK(Device->CreateCommittedResource(
+            EGpuMemoryCategory::RenderTarget,
+            &DefaultHeap,
+            D3D12_HEAP_FLAG_NONE,
+            &Desc,
+            D3D12_RESOURCE_STATE_COMMON,
+            nullptr,
+            IID_PPV_ARGS(Lut.Resource->ReleaseAndGetAddressOf())));
+        if (!*Lut.Resource)
+        {
+            LogError("Failed to create sky atmosphere LUTs");
+            return false;
+        }
+        (*Lut.Resource)->SetName(Lut.Name);
+        *Lut.State = D3D12_RESOURCE_STATE_COMMON;
+
+        D3D12_SHADER_RESOURCE_VIEW_DESC SrvDesc = {};
+        SrvDesc.Format = LutFormat;
+        SrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        SrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        SrvDesc.Texture2D.MipLevels = 1;
+        Device->GetDevice()->CreateShaderResourceView(Lut.Resource->Get(), &SrvDesc, Descriptors.GetCpuHandle(Index));
+
+        D3D12_UNORDERED_ACCESS_VIEW_DESC UavDesc = {};
+        UavDesc.Format = LutFormat;
+        UavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+        Device->GetDevice()->CreateUnorderedAccessView(Lut.Resource->Get(), nullptr, &UavDesc, Descriptors.GetCpuHandle(3 + Index));
+    }
+
+    bAtmosphereLutsDirty = true;
+    bSkyViewLutDirty = true;
+    return true;
+}
+
+bool FSkyAtmosphere::NeedsSkyViewLut(const DirectX::XMFLOAT3& SunDirection) const
+{
+    using namespace DirectX;
+
+    if (bAtmosphereLutsDirty || bSkyViewLutDirty)
+    {
+        return true;
+    }
+    const XMVECTOR Direction = XMVector3Normalize(XMLoadFloat3(&SunDirection));
+    return XMVectorGetX(XMVector3Dot(Direction, XMLoadFloat3(&SkyViewSunDirection))) < SkyViewSunCosineThreshold;
+}
+
+void FSkyAtmosphere::DispatchLut(ID3D12GraphicsCommandList* CommandList, ID3D12PipelineState* Pipeline, uint32_t UavIndex, uint32_t GroupCountX, uint32_t GroupCountY) const
+{
+    ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap };
+    CommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
+    CommandList->SetComputeRootSignature(RootSignature.Get());
+    CommandList->SetPipelineState(Pipeline);
+
+    FSkyAtmosphereConstants Constants;
+    Constants.SunDirection = SkyViewSunDirection;
+    CommandList->SetComputeRoot32BitConstants(1, ConstantCount, &Constants, 0);
+    CommandList->SetComputeRootDescriptorTable(2, Descriptors.GetGpuHandle(0));
+    CommandList->SetComputeRootDescriptorTable(3, Descriptors.GetGpuHandle(3 + UavIndex));
+    CommandList->Dispatch(GroupCountX, GroupCountY, 1);
+}
+
+void FSkyAtmosphere::BuildTransmittanceLut(ID3D12GraphicsCommandList* CommandList)
+{
+    if (!CommandList || !IsReady())
+    {
+        return;
+    }
+    DispatchLut(CommandList, TransmittancePipeline.Get(), 0, (TransmittanceLutWidth + 7) / 8, (TransmittanceLutHeight + 7) / 8);
+}
+
+void FSkyAtmosphere::BuildMultiScatteringLut(ID3D12GraphicsCommandList* CommandList)
+{
+    if (!CommandList || !IsReady())
+    {
+        return;
+    }
+
+    // One group per texel, each thread integrating one direction.
+    DispatchLut(CommandList, MultiScatteringPipeline.Get(), 1, MultiScatteringLutSize, MultiScatteringLutSize);
+    bAtmosphereLutsDirty = false;
+}
+
+void FSkyAtmosphere::BuildSkyViewLut(ID3D12GraphicsCommandList* CommandList, const DirectX::XMFLOAT3& SunDirection)
+{
+    if (!CommandList || !IsReady())
+    {
+        return;
+    }
+
+    DirectX::XMStoreFloat3(&SkyViewSunDirection, DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&SunDirection)));
+    DispatchLut(CommandList, SkyViewPipeline.Get(), 2, (SkyViewLutWidth + 7) / 8, (SkyViewLutHeight + 7) / 8);
+    bSkyViewLutDirty = false;
+}
+
+void FSkyAtmosphere::Draw(ID3D12GraphicsCommandList* CommandList, D3D12_GPU_VIRTUAL_ADDRESS ViewConstantsAddress, const DirectX::XMFLOAT3& SunIlluminance) const
+{
+    if (!CommandList || !IsReady() || ViewConstantsAddress == 0)
+    {
+        return;
+    }
+
+    FSkyAtmosphereConstants Constants;
+    Constants.SunDirection = SkyViewSunDirection;
+    Constants.SunDiskCosine = SunDiskCosine;
+    Constants.SunIlluminance = SunIlluminance;
+    Constants.SunDiskLuminance = SunDiskLuminance;
+
+    ID3D12DescriptorHeap* Heaps[] = { DescriptorHeap };
+    CommandList->SetDescriptorHeaps(_countof(Heaps), Heaps);
+    CommandList->SetGraphicsRootSignature(RootSignature.Get());
+    CommandList->SetPipelineState(SkyPipeline.Get());
+    CommandList->SetGraphicsRootConstantBufferView(0, ViewConstantsAddress);
+    CommandList->SetGraphicsRoot32BitConstants(1, ConstantCount, &Constants, 0);
+    CommandList->SetGraphicsRootDescriptorTable(2, Descriptors.GetGpuHandle(0));
+    CommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    CommandList->DrawInstanced(3, 1, 0, 0);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <DirectXMath.h>
+#include <cstdint>
+
+#include "../RHI/DX12DescriptorAllocator.h"
+
+class FDX12Device;
+
+// cbuffer SkyAtmosphereConstants (b1) in Shaders/SkyAtmosphere.hlsl.
+struct FSkyAtmosphereConstants
+{
+    DirectX::XMFLOAT3 SunDirection{ 0.0f, 1.0f, 0.0f };
+    float SunDiskCosine = 1.0f;
+    DirectX::XMFLOAT3 SunIlluminance{ 1.0f, 1.0f, 1.0f };
+    float SunDiskLuminance = 0.0f;
+};
+
+// Depth state of the sky draw and the format of the depth buffer bound with it.
+struct FSkyPipelineConfig
+{
+    bool DepthEnable = false;
+    D3D12_COMPARISON_FUNC DepthFunc = D3D12_COMPARISON_FUNC_ALWAYS;
+    D3D12_DEPTH_WRITE_MASK DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+    DXGI_FORMAT DsvFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
+};
+
+/**
+ * Sky of an Earth-like atmosphere from look-up tables, after Hillaire's "A Scalable and
+ * Production Ready Sky and Atmosphere Rendering Technique" (2020). The transmittance and
+ * multiple-scattering LUTs depend on the atmosphere alone and are built once. The sky-view LUT
+ * holds the sky seen from a fixed altitude around the sun and is rebuilt only when the sun moves,
+ * so Draw looks the sky up per pixel instead of integrating it. Deferred lighting reads the
+ * transmittance LUT to tint the sun. The LUTs are built for a sun of unit illuminance, which
+ * Draw scales by the light's color.
+ */
+class FSkyAtmosphere
+{
+public:
+    // SRVs of the transmittance, multiple-scattering and sky-view LUTs, then their UAVs.
+    static constexpr uint32_t DescriptorCount = 6;
+    static constexpr uint32_t ConstantCount = sizeof(FSkyAtmosphereConstants) / sizeof(uint32_t);
+    static constexpr DXGI_FORMAT LutFormat = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    // The sizes in Shaders/SkyAtmosphereCommon.hlsl.
+    static constexpr uint32_t TransmittanceLutWidth = 256;
+    static constexpr uint32_t TransmittanceLutHeight = 64;
+    static constexpr uint32_t MultiScatteringLutSize = 32;
+    static constexpr uint32_t SkyViewLutWidth = 192;
+    static constexpr uint32_t SkyViewLutHeight = 108;
+
+    // Creates the LUTs in Descriptors, which the caller owns, and the pipelines that build them
+    // and draw the sky into OutputFormat targets with Config's depth state.
+    bool Initialize(FDX12Device* Device, DXGI_FORMAT OutputFormat, const FSkyPipelineConfig& Config, const FDX12DescriptorRange& Descriptors);
+    // Every LUT is rebuilt afterwards, since the atmosphere may have changed with the shaders.
+    bool CreatePipelines(FDX12Device* Device);
+
+    bool IsReady() const { return SkyPipeline && SkyViewLut; }
+    // Whether the LUTs that depend on the atmosphere alone must be built before the sky-view LUT.
+    bool NeedsAtmosphereLuts() const { return bAtmosphereLutsDirty; }
+    // Whether the sky-view LUT is stale for a sun towards SunDirection.
+    bool NeedsSkyViewLut(const DirectX::XMFLOAT3& SunDirection) const;
+
+    ID3D12Resource* GetTransmittanceLut() const { return TransmittanceLut.Get(); }
+    D3D12_RESOURCE_STATES* GetTransmittanceLutState() { return &TransmittanceLutState; }
+    ID3D12Resource* GetMultiScatteringLut() const { return MultiScatteringLut.Get(); }
+    D3D12_RESOURCE_STATES* GetMultiScatteringLutState() { return &MultiScatteringLutState; }
+    ID3D12Resource* GetSkyViewLut() const { return SkyViewLut.Get(); }
+    D3D12_RESOURCE_STATES* GetSkyViewLutState() { return &SkyViewLutState; }
+
+    // Record one LUT each, which must be in UNORDERED_ACCESS, reading the LUTs built before it as
+    // NON_PIXEL_SHADER_RESOURCE. They bind the shared descriptor heap.
+    void BuildTransmittanceLut(ID3D12GraphicsCommandList* CommandList);
+    void BuildMultiScatteringLut(ID3D12GraphicsCommandList* CommandList);
+    // Remembers SunDirection as the sun the sky-view LUT holds.
+    void BuildSkyViewLut(ID3D12GraphicsCommandList* CommandList, const DirectX::XMFLOAT3& SunDirection);
+
+    // Draws the sky into the bound render target, with the sky-view and transmittance LUTs in
+    // PIXEL_SHADER_RESOURCE. The view constants' projection places the view rays.
+    void Draw(ID3D12GraphicsCommandList* CommandList, D3D12_GPU_VIRTUAL_ADDRESS ViewConstantsAddress, const DirectX::XMFLOAT3& SunIlluminance) const;
+
+private:
+    bool CreateRootSignature(FDX12Device* Device);
+    bool CreateLuts(FDX12Device* Device);
+    void DispatchLut(ID3D12GraphicsCommandList* CommandList, ID3D12PipelineState* Pipeline, uint32_t UavIndex, uint32_t GroupCountX, uint32_t GroupCountY) const;
+
+    Microsoft::WRL::ComPtr<ID3D12RootSignature> RootSignature;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> TransmittancePipeline;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> MultiScatteringPipeline;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> SkyViewPipeline;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> SkyPipeline;
+    Microsoft::WRL::ComPtr<ID3D12Resource> TransmittanceLut;
+    Microsoft::WRL::ComPtr<ID3D12Resource> MultiScatteringLut;
+    Microsoft::WRL::ComPtr<ID3D12Resource> SkyViewLut;
+    D3D12_RESOURCE_STATES TransmittanceLutState = D3D12_RESOURCE_STATE_COMMON;
+    D3D12_RESOURCE_STATES MultiScatteringLutState = D3D12_RESOURCE_STATE_COMMON;
+    D3D12_RESOURCE_STATES SkyViewLutState = D3D12_RESOURCE_STATE_COMMON;
+    ID3D12DescriptorHeap* DescriptorHeap = nullptr;
+    FDX12DescriptorRange Descriptors;
+    DXGI_FORMAT OutputFormat = DXGI_FORMAT_UNKNOWN;
+    FSkyPipelineConfig PipelineConfig;
+    DirectX::XMFLOAT3 SkyViewSunDirection{ 0.0f, 1.0f, 0.0f };
+    bool bAtmosphereLutsDirty = true;
+    bool bSkyViewLutDirty = true;
+};
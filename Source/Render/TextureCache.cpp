@@ -0,0 +1,160 @@
+#include "TextureCache.h"
+
+#include "../Core/MappedFile.h"
+
+#include <cstring>
+#include <filesystem>
+#include <functional>
+
+using Microsoft::WRL::ComPtr;
+
+uint32_t FTextureCache::MakeVariant(bool bUseSRGB, bool bNormalMap, uint32_t FirstMip)
+{
+    return (bUseSRGB ? 1u : 0u) | (bNormalMap ? 2u : 0u) | (FirstMip << 8);
+}
+
+uint64_t FTextureCache::HashBytes(const void* Data, size_t Size, uint64_t Seed)
+{
+    constexpr uint64_t Prime = 1099511628211ULL;
+
+    const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+    uint64_t Hash = (Seed ^ static_cast<uint64_t>(Size)) * Prime;
+    size_t Index = 0;
+    for (; Index + sizeof(uint64_t) <= Size; Index += sizeof(uint64_t))
+    {
+        uint64_t Word = 0;
+        std::memcpy(&Word, Bytes + Index, sizeof(Word));
+        Hash = (Hash ^ Word) * Prime;
+        // Folds the high bits back down; the multiply alone only carries upwards.
+        Hash ^= Hash >> 29;
+    }
+    for (; Index < Size; ++Index)
+    {
+        Hash = (Hash ^ Bytes[Index]) * Prime;
+    }
+    return Hash != 0 ? Hash : 1;
+}
+
+uint64_t FTextureCache::ResolveContentHash(const std::wstring& Path)
+{
+    if (Path.empty())
+    {
+        return 0;
+    }
+
+    std::error_code Error;
+    const uint64_t FileSize = static_cast<uint64_t>(std::filesystem::file_size(Path, Error));
+    if (Error)
+    {
+        return 0;
+    }
+    const int64_t WriteTime = static_cast<int64_t>(std::filesystem::last_write_time(Path, Error).time_since_epoch().count());
+    if (Error)
+    {
+        return 0;
+    }
+
+    FFileShard& Shard = FileShards[std::hash<std::wstring>()(Path) % ShardCount];
+    {
+        std::lock_guard<std::mutex> Lock(Shard.Mutex);
+        const auto Found = Shard.Files.find(Path);
+        if (Found != Shard.Files.end() && Found->second.FileSize == FileSize && Found->second.WriteTime == WriteTime)
+        {
+            return Found->second.ContentHash;
+        }
+    }
+
+    // Hashed outside the lock; two loads of a new file may both hash it, with the same result.
+    FMappedFile File;
+    if (!File.Open(Path))
+    {
+        return 0;
+    }
+    const uint64_t ContentHash = HashBytes(File.GetData(), File.GetSize());
+
+    std::lock_guard<std::mutex> Lock(Shard.Mutex);
+    Shard.Files[Path] = { FileSize, WriteTime, ContentHash };
+    return ContentHash;
+}
+
+bool FTextureCache::Find(const FTextureCacheKey& Key, ComPtr<ID3D12Resource>& OutTexture)
+{
+    if (!Key.IsValid())
+    {
+        return false;
+    }
+
+    FShard& Shard = GetShard(Key);
+    std::lock_guard<std::mutex> Lock(Shard.Mutex);
+    const auto Found = Shard.Lookup.find(Key);
+    if (Found == Shard.Lookup.end())
+    {
+        Misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Shard.Entries.splice(Shard.Entries.begin(), Shard.Entries, Found->second);
+    OutTexture = Found->second->Texture;
+    Hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void FTextureCache::Insert(const FTextureCacheKey& Key, const ComPtr<ID3D12Resource>& Texture, uint64_t SizeInBytes)
+{
+    if (!Key.IsValid() || !Texture)
+    {
+        return;
+    }
+
+    FShard& Shard = GetShard(Key);
+    std::lock_guard<std::mutex> Lock(Shard.Mutex);
+
+    const auto Found = Shard.Lookup.find(Key);
+    if (Found != Shard.Lookup.end())
+    {
+        Shard.ResidentBytes -= Found->second->SizeInBytes;
+        Shard.Entries.erase(Found->second);
+        Shard.Lookup.erase(Found);
+    }
+
+    Shard.Entries.push_front({ Key, Texture, SizeInBytes });
+    Shard.Lookup[Key] = Shard.Entries.begin();
+    Shard.ResidentBytes += SizeInBytes;
+
+    const uint64_t ShardBudget = BudgetBytes.load(std::memory_order_relaxed) / ShardCount;
+    while (Shard.ResidentBytes > ShardBudget && Shard.Entries.size() > 1)
+    {
+        const FEntry& Oldest = Shard.Entries.back();
+        Shard.ResidentBytes -= Oldest.SizeInBytes;
+        Shard.Lookup.erase(Oldest.Key);
+        Shard.Entries.pop_back();
+        Evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void FTextureCache::Clear()
+{
+    for (FShard& Shard : Shards)
+    {
+        std::lock_guard<std::mutex> Lock(Shard.Mutex);
+        Shard.Entries.clear();
+        Shard.Lookup.clear();
+        Shard.ResidentBytes = 0;
+    }
+}
+
+FTextureCacheStats FTextureCache::GetStats() const
+{
+    FTextureCacheStats Stats;
+    Stats.Hits = Hits.load(std::memory_order_relaxed);
+    Stats.Misses = Misses.load(std::memory_order_relaxed);
+    Stats.Evictions = Evictions.load(std::memory_order_relaxed);
+    Stats.BudgetBytes = BudgetBytes.load(std::memory_order_relaxed);
+    for (const FShard& Shard : Shards)
+    {
+        std::lock_guard<std::mutex> Lock(Shard.Mutex);
+        Stats.ResidentBytes += Shard.ResidentBytes;
+        Stats.EntryCount += static_cast<uint32_t>(Shard.Entries.size());
+    }
+    return Stats;
+}
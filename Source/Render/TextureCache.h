@@ -0,0 +1,109 @@
+#pragma once
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Names a cached texture by what it holds rather than where it was loaded from: a hash of the
+// source file's bytes, or of a generated texture's parameters, and the load options applied to it.
+struct FTextureCacheKey
+{
+    uint64_t ContentHash = 0;
+    // See FTextureCache::MakeVariant.
+    uint32_t Variant = 0;
+
+    bool IsValid() const { return ContentHash != 0; }
+    bool operator==(const FTextureCacheKey& Other) const { return ContentHash == Other.ContentHash && Variant == Other.Variant; }
+};
+
+struct FTextureCacheStats
+{
+    uint64_t Hits = 0;
+    uint64_t Misses = 0;
+    uint64_t Evictions = 0;
+    uint64_t ResidentBytes = 0;
+    uint64_t BudgetBytes = 0;
+    uint32_t EntryCount = 0;
+};
+
+/**
+ * Textures shared between loads, least recently used first out once their allocation sizes exceed
+ * the budget. Eviction only drops the cache's reference: textures still bound somewhere stay alive,
+ * they are just loaded again by the next request. Keys and file identities are spread over
+ * ShardCount shards with a lock each, so parallel loads rarely contend.
+ */
+class FTextureCache
+{
+public:
+    static constexpr uint32_t ShardCount = 16;
+    static constexpr uint64_t DefaultBudgetBytes = 1024ull << 20;
+
+    static uint32_t MakeVariant(bool bUseSRGB, bool bNormalMap, uint32_t FirstMip);
+    // FNV-1a over 64-bit words; never returns 0, which marks an invalid key.
+    static uint64_t HashBytes(const void* Data, size_t Size, uint64_t Seed = 14695981039346656037ULL);
+
+    /**
+     * Hash of a file's bytes, remembered per path until its size or write time changes. Thread-safe.
+     * @return 0 when the file cannot be read
+     */
+    uint64_t ResolveContentHash(const std::wstring& Path);
+
+    bool Find(const FTextureCacheKey& Key, Microsoft::WRL::ComPtr<ID3D12Resource>& OutTexture);
+    // Replaces any texture cached under Key and evicts from the key's shard until it fits its share
+    // of the budget; the inserted texture itself always stays.
+    void Insert(const FTextureCacheKey& Key, const Microsoft::WRL::ComPtr<ID3D12Resource>& Texture, uint64_t SizeInBytes);
+    void Clear();
+
+    void SetBudget(uint64_t InBudgetBytes) { BudgetBytes.store(InBudgetBytes, std::memory_order_relaxed); }
+    FTextureCacheStats GetStats() const;
+
+private:
+    struct FKeyHasher
+    {
+        size_t operator()(const FTextureCacheKey& Key) const { return static_cast<size_t>(Key.ContentHash ^ (static_cast<uint64_t>(Key.Variant) * 0x9E3779B97F4A7C15ULL)); }
+    };
+
+    struct FEntry
+    {
+        FTextureCacheKey Key;
+        Microsoft::WRL::ComPtr<ID3D12Resource> Texture;
+        uint64_t SizeInBytes = 0;
+    };
+
+    struct FShard
+    {
+        mutable std::mutex Mutex;
+        // Most recently used first.
+        std::list<FEntry> Entries;
+        std::unordered_map<FTextureCacheKey, std::list<FEntry>::iterator, FKeyHasher> Lookup;
+        uint64_t ResidentBytes = 0;
+    };
+
+    struct FFileIdentity
+    {
+        uint64_t FileSize = 0;
+        int64_t WriteTime = 0;
+        uint64_t ContentHash = 0;
+    };
+
+    struct FFileShard
+    {
+        std::mutex Mutex;
+        std::unordered_map<std::wstring, FFileIdentity> Files;
+    };
+
+    FShard& GetShard(const FTextureCacheKey& Key) { return Shards[FKeyHasher()(Key) % ShardCount]; }
+
+    std::array<FShard, ShardCount> Shards;
+    std::array<FFileShard, ShardCount> FileShards;
+    std::atomic<uint64_t> BudgetBytes{ DefaultBudgetBytes };
+    std::atomic<uint64_t> Hits{ 0 };
+    std::atomic<uint64_t> Misses{ 0 };
+    std::atomic<uint64_t> Evictions{ 0 };
+};
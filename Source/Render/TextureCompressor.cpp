@@ -0,0 +1,349 @@
+#include "TextureCompressor.h"
+
+#include "MipGenerator.h"
+#include "../Core/TaskSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr uint32_t BlockDim = 4;
+    constexpr uint32_t BlockTexels = BlockDim * BlockDim;
+
+    // BC7 interpolation weights for 4-bit indices, in 64ths.
+    constexpr uint32_t BC7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // Little-endian bit writer for one 128-bit block.
+    struct FBlockBitWriter
+    {
+        uint8_t* Block = nullptr;
+        uint32_t Position = 0;
+
+        void Write(uint32_t Value, uint32_t BitCount)
+        {
+            for (uint32_t Bit = 0; Bit < BitCount; ++Bit, ++Position)
+            {
+                if ((Value >> Bit) & 1u)
+                {
+                    Block[Position >> 3] |= static_cast<uint8_t>(1u << (Position & 7u));
+                }
+            }
+        }
+    };
+
+    // Quantizes an endpoint channel to 7 bits under a fixed p-bit; returns the 7-bit value.
+    uint32_t QuantizeBC7Mode6(float Value, uint32_t PBit)
+    {
+        const float Scaled = (Value - static_cast<float>(PBit)) * 0.5f;
+        return static_cast<uint32_t>((std::min)(127.0f, (std::max)(0.0f, std::round(Scaled))));
+    }
+
+    // Gathers a 4x4 block of RGBA8 texels, clamping to the mip for blocks that overhang its edge.
+    void GatherBlock(const uint8_t* Texels, uint32_t Width, uint32_t Height, uint32_t RowPitch, uint32_t BlockX, uint32_t BlockY, uint8_t OutTexels[64])
+    {
+        for (uint32_t Y = 0; Y < BlockDim; ++Y)
+        {
+            const uint32_t SourceY = (std::min)(BlockY * BlockDim + Y, Height - 1);
+            const uint8_t* Row = Texels + static_cast<size_t>(SourceY) * RowPitch;
+            for (uint32_t X = 0; X < BlockDim; ++X)
+            {
+                const uint32_t SourceX = (std::min)(BlockX * BlockDim + X, Width - 1);
+                std::memcpy(OutTexels + (Y * BlockDim + X) * 4, Row + static_cast<size_t>(SourceX) * 4, 4);
+            }
+        }
+    }
+}
+
+DXGI_FORMAT FTextureCompressor::GetDxgiFormat(EBlockFormat Format)
+{
+    switch (Format)
+    {
+    case EBlockFormat::BC4:
+        return DXGI_FORMAT_BC4_UNORM;
+    case EBlockFormat::BC5:
+        return DXGI_FORMAT_BC5_UNORM;
+    case EBlockFormat::BC7:
+        return DXGI_FORMAT_BC7_UNORM;
+    default:
+        return DXGI_FORMAT_R8G8B8A8_UNORM;
+    }
+}
+
+uint32_t FTextureCompressor::GetBlockSize(EBlockFormat Format)
+{
+    return Format == EBlockFormat::BC4 ? 8u : 16u;
+}
+
+EBlockFormat FTextureCompressor::ChooseFormat(EMipFilter Filter, const uint8_t* Texels, uint32_t Width, uint32_t Height, uint32_t RowPitch)
+{
+    if (Width % BlockDim != 0 || Height % BlockDim != 0)
+    {
+        return EBlockFormat::None;
+    }
+
+    if (Filter == EMipFilter::NormalMap)
+    {
+        return EBlockFormat::BC5;
+    }
+
+    // There is no sRGB BC4, so only linear data is checked for a single channel.
+    if (Filter == EMipFilter::SRGB)
+    {
+        return EBlockFormat::BC7;
+    }
+
+    for (uint32_t Y = 0; Y < Height; ++Y)
+    {
+        const uint8_t* Row = Texels + static_cast<size_t>(Y) * RowPitch;
+        for (uint32_t X = 0; X < Width; ++X)
+        {
+            const uint8_t* Texel = Row + static_cast<size_t>(X) * 4;
+            if (Texel[1] != Texel[0] || Texel[2] != Texel[0] || Texel[3] != 255)
+            {
+                return EBlockFormat::BC7;
+            }
+        }
+    }
+    return EBlockFormat::BC4;
+}
+
+void FTextureCompressor::Compress(EBlockFormat Format, const uint8_t* Texels, uint32_t Width, uint32_t Height, uint32_t RowPitch, std::vector<uint8_t>& OutBlocks)
+{
+    const uint32_t BlocksWide = (Width + BlockDim - 1) / BlockDim;
+    const uint32_t BlocksHigh = (Height + BlockDim - 1) / BlockDim;
+    const uint32_t BlockSize = GetBlockSize(Format);
+    OutBlocks.assign(static_cast<size_t>(BlocksWide) * BlocksHigh * BlockSize, 0);
+
+    FParallelFor::ExecuteRange(0, BlocksHigh, [&](uint32_t RowBegin, uint32_t RowEnd)
+    {
+        uint8_t BlockTexelData[BlockTexels * 4];
+        uint8_t Channel[BlockTexels];
+        for (uint32_t BlockY = RowBegin; BlockY < RowEnd; ++BlockY)
+        {
+            for (uint32_t BlockX = 0; BlockX < BlocksWide; ++BlockX)
+            {
+                GatherBlock(Texels, Width, Height, RowPitch, BlockX, BlockY, BlockTexelData);
+                uint8_t* Block = OutBlocks.data() + (static_cast<size_t>(BlockY) * BlocksWide + BlockX) * BlockSize;
+
+                if (Format == EBlockFormat::BC7)
+                {
+                    EncodeBC7Block(BlockTexelData, Block);
+                    continue;
+                }
+
+                const uint32_t ChannelCount = Format == EBlockFormat::BC5 ? 2u : 1u;
+                for (uint32_t ChannelIndex = 0; ChannelIndex < ChannelCount; ++ChannelIndex)
+                {
+                    for (uint32_t Texel = 0; Texel < BlockTexels; ++Texel)
+                    {
+                        Channel[Texel] = BlockTexelData[Texel * 4 + ChannelIndex];
+                    }
+                    EncodeBC4Block(Channel, Block + ChannelIndex * 8);
+                }
+            }
+        }
+    }, 1);
+}
+
+void FTextureCompressor::EncodeBC4Block(const uint8_t Values[16], uint8_t OutBlock[8])
+{
+    uint32_t MinValue = 255;
+    uint32_t MaxValue = 0;
+    for (uint32_t Texel = 0; Texel < BlockTexels; ++Texel)
+    {
+        MinValue = (std::min)(MinValue, static_cast<uint32_t>(Values[Texel]));
+        MaxValue = (std::max)(MaxValue, static_cast<uint32_t>(Values[Texel]));
+    }
+
+    std::memset(OutBlock, 0, 8);
+    OutBlock[0] = static_cast<uint8_t>(MaxValue);
+    OutBlock[1] = static_cast<uint8_t>(MinValue);
+    if (MaxValue == MinValue)
+    {
+        // Red0 <= Red1 selects the six-value mode, in which index 0 is still Red0.
+        return;
+    }
+
+    // With Red0 > Red1 index 0 is Red0, index 1 is Red1 and indices 2-7 step from Red0 to Red1.
+    uint64_t Indices = 0;
+    const float Range = static_cast<float>(MaxValue - MinValue);
+    for (uint32_t Texel = 0; Texel < BlockTexels; ++Texel)
+    {
+        const float Normalized = static_cast<float>(Values[Texel] - MinValue) / Range;
+        const uint32_t Step = static_cast<uint32_t>(std::round(Normalized * 7.0f));
+        const uint32_t Index = Step == 7 ? 0u : (Step == 0 ? 1u : 8u - Step);
+        Indices |= static_cast<uint64_t>(Index) << (Texel * 3);
+    }
+
+    for (uint32_t Byte = 0; Byte < 6; ++Byte)
+    {
+        OutBlock[2 + Byte] = static_cast<uint8_t>(Indices >> (Byte * 8));
+    }
+}
+
+void FTextureCompressor::EncodeBC7Block(const uint8_t Texels[64], uint8_t OutBlock[16])
+{
+    float Mean[4] = {};
+    for (uint32_t Texel = 0; Texel < BlockTexels; ++Texel)
+    {
+        for (uint32_t Channel = 0; Channel < 4; ++Channel)
+        {
+            Mean[Channel] += Texels[Texel * 4 + Channel];
+        }
+    }
+    for (float& Value : Mean)
+    {
+        Value /= static_cast<float>(BlockTexels);
+    }
+
+    float Covariance[4][4] = {};
+    for (uint32_t Texel = 0; Texel < BlockTexels; ++Texel)
+    {
+        float Delta[4];
+        for (uint32_t Channel = 0; Channel < 4; ++Channel)
+        {
+            Delta[Channel] = Texels[Texel * 4 + Channel] - Mean[Channel];
+        }
+        for (uint32_t Row = 0; Row < 4; ++Row)
+        {
+            for (uint32_t Column = 0; Column < 4; ++Column)
+            {
+                Covariance[Row][Column] += Delta[Row] * Delta[Column];
+            }
+        }
+    }
+
+    // Principal axis by power iteration, seeded with the channel ranges.
+    float Axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    for (uint32_t Iteration = 0; Iteration < 8; ++Iteration)
+    {
+        float Next[4] = {};
+        for (uint32_t Row = 0; Row < 4; ++Row)
+        {
+            for (uint32_t Column = 0; Column < 4; ++Column)
+            {
+                Next[Row] += Covariance[Row][Column] * Axis[Column];
+            }
+        }
+        const float Length = std::sqrt(Next[0] * Next[0] + Next[1] * Next[1] + Next[2] * Next[2] + Next[3] * Next[3]);
+        if (Length < 1e-6f)
+        {
+            break;
+        }
+        for (uint32_t Channel = 0; Channel < 4; ++Channel)
+        {
+            Axis[Channel] = Next[Channel] / Length;
+        }
+    }
+
+    float MinProjection = 0.0f;
+    float MaxProjection = 0.0f;
+    for (uint32_t Texel = 0; Texel < BlockTexels; ++Texel)
+    {
+        float Projection = 0.0f;
+        for (uint32_t Channel = 0; Channel < 4; ++Channel)
+        {
+            Projection += (Texels[Texel * 4 + Channel] - Mean[Channel]) * Axis[Channel];
+        }
+        MinProjection = (std::min)(MinProjection, Projection);
+        MaxProjection = (std::max)(MaxProjection, Projection);
+    }
+
+    float Endpoints[2][4];
+    for (uint32_t Channel = 0; Channel < 4; ++Channel)
+    {
+        Endpoints[0][Channel] = (std::min)(255.0f, (std::max)(0.0f, Mean[Channel] + Axis[Channel] * MinProjection));
+        Endpoints[1][Channel] = (std::min)(255.0f, (std::max)(0.0f, Mean[Channel] + Axis[Channel] * MaxProjection));
+    }
+
+    // Every p-bit pair shifts the reachable endpoint values, so all four are tried.
+    uint32_t BestError = UINT32_MAX;
+    uint32_t BestQuantized[2][4] = {};
+    uint32_t BestPBits[2] = {};
+    uint32_t BestIndices[BlockTexels] = {};
+    for (uint32_t PBitPair = 0; PBitPair < 4; ++PBitPair)
+    {
+        const uint32_t PBits[2] = { PBitPair & 1u, PBitPair >> 1 };
+        uint32_t Quantized[2][4];
+        int32_t Colors[2][4];
+        for (uint32_t Endpoint = 0; Endpoint < 2; ++Endpoint)
+        {
+            for (uint32_t Channel = 0; Channel < 4; ++Channel)
+            {
+                Quantized[Endpoint][Channel] = QuantizeBC7Mode6(Endpoints[Endpoint][Channel], PBits[Endpoint]);
+                Colors[Endpoint][Channel] = static_cast<int32_t>((Quantized[Endpoint][Channel] << 1) | PBits[Endpoint]);
+            }
+        }
+
+        int32_t Palette[16][4];
+        for (uint32_t Index = 0; Index < 16; ++Index)
+        {
+            for (uint32_t Channel = 0; Channel < 4; ++Channel)
+            {
+                const int32_t Weight = static_cast<int32_t>(BC7Weights4[Index]);
+                Palette[Index][Channel] = ((64 - Weight) * Colors[0][Channel] + Weight * Colors[1][Channel] + 32) >> 6;
+            }
+        }
+
+        uint32_t Error = 0;
+        uint32_t Indices[BlockTexels];
+        for (uint32_t Texel = 0; Texel < BlockTexels; ++Texel)
+        {
+            uint32_t BestTexelError = UINT32_MAX;
+            for (uint32_t Index = 0; Index < 16; ++Index)
+            {
+                uint32_t TexelError = 0;
+                for (uint32_t Channel = 0; Channel < 4; ++Channel)
+                {
+                    const int32_t Delta = Palette[Index][Channel] - static_cast<int32_t>(Texels[Texel * 4 + Channel]);
+                    TexelError += static_cast<uint32_t>(Delta * Delta);
+                }
+                if (TexelError < BestTexelError)
+                {
+                    BestTexelError = TexelError;
+                    Indices[Texel] = Index;
+                }
+            }
+            Error += BestTexelError;
+        }
+
+        if (Error < BestError)
+        {
+            BestError = Error;
+            std::memcpy(BestQuantized, Quantized, sizeof(Quantized));
+            std::memcpy(BestPBits, PBits, sizeof(PBits));
+            std::memcpy(BestIndices, Indices, sizeof(Indices));
+        }
+    }
+
+    // The first texel's index is stored without its top bit, so it must be below 8.
+    if (BestIndices[0] >= 8)
+    {
+        for (uint32_t Channel = 0; Channel < 4; ++Channel)
+        {
+            std::swap(BestQuantized[0][Channel], BestQuantized[1][Channel]);
+        }
+        std::swap(BestPBits[0], BestPBits[1]);
+        for (uint32_t& Index : BestIndices)
+        {
+            Index = 15 - Index;
+        }
+    }
+
+    std::memset(OutBlock, 0, 16);
+    FBlockBitWriter Writer{ OutBlock, 0 };
+    Writer.Write(1u << 6, 7);
+    for (uint32_t Channel = 0; Channel < 4; ++Channel)
+    {
+        Writer.Write(BestQuantized[0][Channel], 7);
+        Writer.Write(BestQuantized[1][Channel], 7);
+    }
+    Writer.Write(BestPBits[0], 1);
+    Writer.Write(BestPBits[1], 1);
+    for (uint32_t Texel = 0; Texel < BlockTexels; ++Texel)
+    {
+        Writer.Write(BestIndices[Texel], Texel == 0 ? 3u : 4u);
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <dxgiformat.h>
+#include <cstdint>
+#include <vector>
+
+enum class EMipFilter : uint8_t;
+
+enum class EBlockFormat : uint8_t
+{
+    None,
+    // One channel, replicated to RGB by the view; see RendererUtils::GetTextureComponentMapping.
+    BC4,
+    // Two channels: tangent-space normal XY, Z is reconstructed when sampling.
+    BC5,
+    BC7,
+};
+
+/**
+ * CPU block compression for cooked textures. Each 4x4 block is encoded on its own, so Compress
+ * spreads block rows over the task system with FParallelFor.
+ *  - BC4: endpoints at the block's min and max, nearest of the eight interpolated values.
+ *  - BC5: two BC4 blocks for red and green.
+ *  - BC7: mode 6 only (one RGBA subset, 4-bit indices) with endpoints along the principal axis of
+ *    the block's colors and the best of the four p-bit pairs.
+ */
+class FTextureCompressor
+{
+public:
+    static DXGI_FORMAT GetDxgiFormat(EBlockFormat Format);
+    static uint32_t GetBlockSize(EBlockFormat Format);
+
+    /**
+     * Picks the block format for an RGBA8 top mip: BC5 for normal maps, BC4 for linear opaque
+     * images whose channels are all equal (masks) and BC7 otherwise. Returns None for sizes that
+     * are not a multiple of the block size, which D3D12 rejects for block compressed textures.
+     */
+    static EBlockFormat ChooseFormat(EMipFilter Filter, const uint8_t* Texels, uint32_t Width, uint32_t Height, uint32_t RowPitch);
+
+    // Encodes one RGBA8 mip; edge blocks of mips smaller than a block repeat their last texel.
+    static void Compress(EBlockFormat Format, const uint8_t* Texels, uint32_t Width, uint32_t Height, uint32_t RowPitch, std::vector<uint8_t>& OutBlocks);
+
+    static void EncodeBC4Block(const uint8_t Values[16], uint8_t OutBlock[8]);
+    static void EncodeBC7Block(const uint8_t Texels[64], uint8_t OutBlock[16]);
+};
@@ -8,13 +8,14 @@
 #include "../RHI/DX12Commons.h"
 #include "../RHI/DX12Device.h"
 #include "../Core/TaskSystem.h"
+#include "../Core/CpuProfiler.h"
 #include "../Core/Logger.h"
+#include "../Core/MappedFile.h"
 #include <array>
+#include <cstring>
 #include <vector>
 #include <filesystem>
-#include <mutex>
 #include <chrono>
-#include <fstream>
 #include <cctype>
 #include <cwctype>
 #include <algorithm>
@@ -27,16 +28,11 @@ using Microsoft::WRL::ComPtr;
 
 namespace
 {
-    const std::wstring GDefaultGridCacheKey = L"__default_grid_texture__";
-
-    std::wstring BuildCacheKey(const std::wstring& BaseKey, bool bUseSRGB)
+    // Generated textures are keyed by their parameters, seeded by a name no file hashes to in practice.
+    FTextureCacheKey BuildGeneratedCacheKey(const char* Name, uint32_t Value, bool bUseSRGB)
     {
-        if (!bUseSRGB)
-        {
-            return BaseKey;
-        }
-
-        return BaseKey + L"|srgb";
+        const uint64_t Seed = FTextureCache::HashBytes(Name, std::strlen(Name));
+        return { FTextureCache::HashBytes(&Value, sizeof(Value), Seed), FTextureCache::MakeVariant(bUseSRGB, false, 0) };
     }
 
     DXGI_FORMAT MakeSRGBFormat(DXGI_FORMAT Format)
@@ -63,102 +59,160 @@ namespace
     }
 }
 
-std::unordered_map<std::wstring, ComPtr<ID3D12Resource>> FTextureLoader::GlobalTextureCache;
-static std::mutex GTextureCacheMutex;
+FTextureCache FTextureLoader::GlobalTextureCache;
 
 FTextureLoader::FTextureLoader(FDX12Device* InDevice)
     : Device(InDevice)
 {
+    MipGenerator = std::make_unique<FMipGenerator>();
+    if (!MipGenerator->Initialize(Device))
+    {
+        LogWarning("GPU mip generation unavailable, images will load without mips");
+        MipGenerator.reset();
+    }
 }
 
-bool FTextureLoader::LoadOrDefault(const std::wstring& TexturePath, ComPtr<ID3D12Resource>& OutTexture, FTextureUploadWork* RecordedUpload, bool bUseSRGB)
+bool FTextureLoader::LoadOrDefault(const std::wstring& TexturePath, ComPtr<ID3D12Resource>& OutTexture, FTextureUploadBatch* Batch, bool bUseSRGB, bool bNormalMap)
 {
-    const std::wstring CacheKey = BuildCacheKey(TexturePath, bUseSRGB);
+    const FTextureCacheKey CacheKey = BuildCacheKey(TexturePath, bUseSRGB, bNormalMap);
     if (TryGetCachedTexture(CacheKey, OutTexture))
     {
         return true;
     }
 
-    if (!TexturePath.empty() && LoadTextureInternal(TexturePath, OutTexture, RecordedUpload, bUseSRGB))
+    FTextureUploadBatch LocalBatch(*this);
+    FTextureUploadBatch& UploadBatch = Batch ? *Batch : LocalBatch;
+
+    if (!TexturePath.empty() && LoadTextureInternal(TexturePath, OutTexture, UploadBatch, bUseSRGB, bNormalMap))
     {
-        std::lock_guard<std::mutex> Lock(GTextureCacheMutex);
-        GlobalTextureCache[CacheKey] = OutTexture;
+        CacheTexture(CacheKey, OutTexture, UploadBatch);
         return true;
     }
 
-    const std::wstring DefaultCacheKey = BuildCacheKey(GDefaultGridCacheKey, bUseSRGB);
+    const FTextureCacheKey DefaultCacheKey = BuildGeneratedCacheKey("DefaultGrid", 0, bUseSRGB);
     if (TryGetCachedTexture(DefaultCacheKey, OutTexture))
     {
         return true;
     }
 
-    if (CreateDefaultGridTexture(OutTexture, RecordedUpload, bUseSRGB))
+    if (CreateDefaultGridTexture(OutTexture, UploadBatch, bUseSRGB))
     {
-        std::lock_guard<std::mutex> Lock(GTextureCacheMutex);
-        GlobalTextureCache[DefaultCacheKey] = OutTexture;
+        CacheTexture(DefaultCacheKey, OutTexture, UploadBatch);
         return true;
     }
 
     return false;
 }
 
-bool FTextureLoader::LoadOrSolidColor(const std::wstring& TexturePath, uint32_t Color, ComPtr<ID3D12Resource>& OutTexture, FTextureUploadWork* RecordedUpload, bool bUseSRGB)
+bool FTextureLoader::LoadOrSolidColor(const std::wstring& TexturePath, uint32_t Color, ComPtr<ID3D12Resource>& OutTexture, FTextureUploadBatch* Batch, bool bUseSRGB, bool bNormalMap)
 {
-    const std::wstring CacheKey = BuildCacheKey(TexturePath, bUseSRGB);
+    const FTextureCacheKey CacheKey = BuildCacheKey(TexturePath, bUseSRGB, bNormalMap);
     if (TryGetCachedTexture(CacheKey, OutTexture))
     {
         return true;
     }
 
-    if (!TexturePath.empty() && LoadTextureInternal(TexturePath, OutTexture, RecordedUpload, bUseSRGB))
+    FTextureUploadBatch LocalBatch(*this);
+    FTextureUploadBatch& UploadBatch = Batch ? *Batch : LocalBatch;
+
+    if (!TexturePath.empty() && LoadTextureInternal(TexturePath, OutTexture, UploadBatch, bUseSRGB, bNormalMap))
     {
-        std::lock_guard<std::mutex> Lock(GTextureCacheMutex);
-        GlobalTextureCache[CacheKey] = OutTexture;
+        CacheTexture(CacheKey, OutTexture, UploadBatch);
         return true;
     }
 
-    const std::wstring SolidColorKey = BuildCacheKey(L"__solid_color_" + std::to_wstring(static_cast<uint64_t>(Color)), bUseSRGB);
+    const FTextureCacheKey SolidColorKey = BuildGeneratedCacheKey("SolidColor", Color, bUseSRGB);
     if (TryGetCachedTexture(SolidColorKey, OutTexture))
     {
         return true;
     }
 
-    if (!CreateSolidColorTexture(Color, OutTexture, RecordedUpload, bUseSRGB))
+    if (!CreateSolidColorTexture(Color, OutTexture, UploadBatch, bUseSRGB))
     {
         return false;
     }
 
-    std::lock_guard<std::mutex> Lock(GTextureCacheMutex);
-    GlobalTextureCache[SolidColorKey] = OutTexture;
+    CacheTexture(SolidColorKey, OutTexture, UploadBatch);
     return true;
 }
 
-void FTextureLoader::ClearCache()
+bool FTextureLoader::LoadTextureTail(const std::wstring& DdsPath, uint32_t FirstMip, ComPtr<ID3D12Resource>& OutTexture, FTextureUploadBatch* Batch, bool bUseSRGB)
 {
-    std::lock_guard<std::mutex> Lock(GTextureCacheMutex);
-    GlobalTextureCache.clear();
+    const FTextureCacheKey CacheKey = BuildCacheKey(DdsPath, bUseSRGB, false, FirstMip);
+    if (TryGetCachedTexture(CacheKey, OutTexture))
+    {
+        return true;
+    }
+
+    FTextureUploadBatch LocalBatch(*this);
+    FTextureUploadBatch& UploadBatch = Batch ? *Batch : LocalBatch;
+    if (Device == nullptr || !LoadDdsTexture(DdsPath, DdsPath, OutTexture, UploadBatch, bUseSRGB, FirstMip))
+    {
+        return false;
+    }
+
+    CacheTexture(CacheKey, OutTexture, UploadBatch);
+    return true;
 }
 
-bool FTextureLoader::TryGetCachedTexture(const std::wstring& TexturePath, ComPtr<ID3D12Resource>& OutTexture) const
+bool FTextureLoader::LoadTextureMips(const std::wstring& DdsPath, uint32_t FirstMip, ComPtr<ID3D12Resource>& OutTexture, FTextureUploadBatch* Batch, bool bUseSRGB)
 {
-    if (TexturePath.empty())
+    if (Device == nullptr)
     {
         return false;
     }
 
-    std::lock_guard<std::mutex> Lock(GTextureCacheMutex);
-    const auto It = GlobalTextureCache.find(TexturePath);
-    if (It != GlobalTextureCache.end() && It->second)
+    FTextureUploadBatch LocalBatch(*this);
+    return LoadDdsTexture(DdsPath, DdsPath, OutTexture, Batch ? *Batch : LocalBatch, bUseSRGB, FirstMip);
+}
+
+void FTextureLoader::ClearCache()
+{
+    GlobalTextureCache.Clear();
+}
+
+void FTextureLoader::PublishTexture(const FTextureCacheKey& CacheKey, const ComPtr<ID3D12Resource>& Texture)
+{
+    if (!CacheKey.IsValid() || !Texture)
     {
-        OutTexture = It->second;
-        return true;
+        return;
     }
 
-    return false;
+    GlobalTextureCache.Insert(CacheKey, Texture, GetTextureSize(Texture.Get()));
+}
+
+FTextureCacheKey FTextureLoader::BuildCacheKey(const std::wstring& TexturePath, bool bUseSRGB, bool bNormalMap, uint32_t FirstMip)
+{
+    // Normal maps keep the same pixels as a plain load but get a different mip chain.
+    return { GlobalTextureCache.ResolveContentHash(TexturePath), FTextureCache::MakeVariant(bUseSRGB, bNormalMap, FirstMip) };
+}
+
+void FTextureLoader::CacheTexture(const FTextureCacheKey& CacheKey, const ComPtr<ID3D12Resource>& Texture, FTextureUploadBatch& Batch)
+{
+    // The upload may not have been submitted yet. Publishing it now would let another loader
+    // hand the texture out before any fence covers its copy.
+    Batch.DeferPublish(CacheKey, Texture);
+}
+
+bool FTextureLoader::TryGetCachedTexture(const FTextureCacheKey& CacheKey, ComPtr<ID3D12Resource>& OutTexture) const
+{
+    return GlobalTextureCache.Find(CacheKey, OutTexture);
+}
+
+uint64_t FTextureLoader::GetTextureSize(ID3D12Resource* Texture) const
+{
+    if (Device == nullptr || Texture == nullptr)
+    {
+        return 0;
+    }
+
+    const D3D12_RESOURCE_DESC Desc = Texture->GetDesc();
+    return Device->GetDevice()->GetResourceAllocationInfo(0, 1, &Desc).SizeInBytes;
 }
 
-bool FTextureLoader::LoadTextureInternal(const std::wstring& FilePath, ComPtr<ID3D12Resource>& OutTexture, FTextureUploadWork* RecordedUpload, bool bUseSRGB)
+bool FTextureLoader::LoadTextureInternal(const std::wstring& FilePath, ComPtr<ID3D12Resource>& OutTexture, FTextureUploadBatch& Batch, bool bUseSRGB, bool bNormalMap)
 {
+    CPU_PROFILE_SCOPE("Load Texture");
     if (Device == nullptr || FilePath.empty())
     {
         return false;
@@ -177,189 +231,22 @@ bool FTextureLoader::LoadTextureInternal(const std::wstring& FilePath, ComPtr<ID
 
     if (HasDDSExtension(FilePath))
     {
-        std::ifstream FileStream(FilePath, std::ios::binary | std::ios::ate);
-        if (!FileStream)
-        {
-            return false;
-        }
-
-        const std::streamsize FileSize = FileStream.tellg();
-        FileStream.seekg(0, std::ios::beg);
-
-        std::vector<uint8_t> FileData(static_cast<size_t>(FileSize));
-        if (!FileStream.read(reinterpret_cast<char*>(FileData.data()), FileSize))
-        {
-            return false;
-        }
-
-        ddspp::Descriptor Descriptor = {};
-        if (FileData.size() < sizeof(uint32_t) || ddspp::decode_header(FileData.data(), Descriptor) != ddspp::Result::Success)
-        {
-            return false;
-        }
-
-        if (Descriptor.format == ddspp::DXGIFormat::UNKNOWN)
-        {
-            return false;
-        }
-
-        const bool bIsCubemap = Descriptor.type == ddspp::Cubemap;
-        const uint32_t ArraySize = Descriptor.type == ddspp::Texture3D ? 1u : std::max(1u, Descriptor.arraySize);
-        const uint32_t SliceCount = bIsCubemap ? ArraySize * 6u : ArraySize;
-        const uint32_t Depth = Descriptor.type == ddspp::Texture3D ? std::max(1u, Descriptor.depth) : 1u;
-        const UINT SubresourceCount = Descriptor.numMips * SliceCount;
-        const DXGI_FORMAT BaseFormat = static_cast<DXGI_FORMAT>(Descriptor.format);
-        const DXGI_FORMAT Format = bUseSRGB ? MakeSRGBFormat(BaseFormat) : BaseFormat;
-
-        D3D12_RESOURCE_DESC TextureDesc = {};
-        TextureDesc.Dimension = Descriptor.type == ddspp::Texture3D ? D3D12_RESOURCE_DIMENSION_TEXTURE3D : D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-        TextureDesc.Width = Descriptor.width;
-        TextureDesc.Height = Descriptor.height;
-        TextureDesc.DepthOrArraySize = Descriptor.type == ddspp::Texture3D ? Depth : static_cast<UINT16>(SliceCount);
-        TextureDesc.MipLevels = static_cast<UINT16>(Descriptor.numMips);
-        TextureDesc.Format = Format;
-        TextureDesc.SampleDesc.Count = 1;
-        TextureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
-
-        D3D12_HEAP_PROPERTIES DefaultHeap = {};
-        DefaultHeap.Type = D3D12_HEAP_TYPE_DEFAULT;
-        DefaultHeap.CreationNodeMask = 1;
-        DefaultHeap.VisibleNodeMask = 1;
-
-        HR_CHECK(Device->GetDevice()->CreateCommittedResource(
-            &DefaultHeap,
-            D3D12_HEAP_FLAG_NONE,
-            &TextureDesc,
-            D3D12_RESOURCE_STATE_COPY_DEST,
-            nullptr,
-            IID_PPV_ARGS(OutTexture.GetAddressOf())));
-
-        if (OutTexture)
-        {
-            const std::filesystem::path ResourcePath(FilePath);
-            OutTexture->SetName(ResourcePath.filename().c_str());
-        }
-
-        std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> Layouts(SubresourceCount);
-        std::vector<UINT> NumRows(SubresourceCount);
-        UINT64 UploadBufferSize = 0;
-        Device->GetDevice()->GetCopyableFootprints(&TextureDesc, 0, SubresourceCount, 0, Layouts.data(), NumRows.data(), nullptr, &UploadBufferSize);
-
-        D3D12_HEAP_PROPERTIES UploadHeap = {};
-        UploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
-        UploadHeap.CreationNodeMask = 1;
-        UploadHeap.VisibleNodeMask = 1;
-
-        D3D12_RESOURCE_DESC UploadDesc = {};
-        UploadDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-        UploadDesc.Width = UploadBufferSize;
-        UploadDesc.Height = 1;
-        UploadDesc.DepthOrArraySize = 1;
-        UploadDesc.MipLevels = 1;
-        UploadDesc.Format = DXGI_FORMAT_UNKNOWN;
-        UploadDesc.SampleDesc.Count = 1;
-        UploadDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-
-        ComPtr<ID3D12Resource> UploadResource;
-        HR_CHECK(Device->GetDevice()->CreateCommittedResource(
-            &UploadHeap,
-            D3D12_HEAP_FLAG_NONE,
-            &UploadDesc,
-            D3D12_RESOURCE_STATE_GENERIC_READ,
-            nullptr,
-            IID_PPV_ARGS(UploadResource.GetAddressOf())));
-
-        uint8_t* MappedData = nullptr;
-        D3D12_RANGE EmptyRange = { 0, 0 };
-        HR_CHECK(UploadResource->Map(0, &EmptyRange, reinterpret_cast<void**>(&MappedData)));
-
-        size_t DataOffset = Descriptor.headerSize;
-        for (uint32_t ArrayIndex = 0; ArrayIndex < SliceCount; ++ArrayIndex)
-        {
-            for (uint32_t Mip = 0; Mip < Descriptor.numMips; ++Mip)
-            {
-                const uint32_t SubresourceIndex = ArrayIndex * Descriptor.numMips + Mip;
-                const uint32_t MipWidth = std::max(1u, Descriptor.width >> Mip);
-                const uint32_t MipHeight = std::max(1u, Descriptor.height >> Mip);
-                const uint32_t MipDepth = Descriptor.type == ddspp::Texture3D ? std::max(1u, Descriptor.depth >> Mip) : 1u;
-                const uint32_t BlockWidth = std::max(1u, Descriptor.blockWidth);
-                const uint32_t BlockHeight = std::max(1u, Descriptor.blockHeight);
-                const uint32_t BlocksWide = Descriptor.compressed ? (MipWidth + BlockWidth - 1) / BlockWidth : MipWidth;
-                const uint32_t BlocksHigh = Descriptor.compressed ? (MipHeight + BlockHeight - 1) / BlockHeight : MipHeight;
-                const uint64_t SrcRowPitch = BlocksWide * Descriptor.bitsPerPixelOrBlock / 8;
-                const size_t SliceSize = static_cast<size_t>(SrcRowPitch) * BlocksHigh;
-                const size_t SubresourceSize = SliceSize * MipDepth;
-
-                if (DataOffset + SubresourceSize > FileData.size())
-                {
-                    UploadResource->Unmap(0, nullptr);
-                    return false;
-                }
-
-                uint8_t* DstSubresource = MappedData + Layouts[SubresourceIndex].Offset;
-                const uint8_t* SrcSubresource = FileData.data() + DataOffset;
-
-                for (uint32_t Z = 0; Z < MipDepth; ++Z)
-                {
-                    const uint8_t* SrcSlice = SrcSubresource + SliceSize * Z;
-                    uint8_t* DstSlice = DstSubresource + Layouts[SubresourceIndex].Footprint.RowPitch * NumRows[SubresourceIndex] * Z;
-
-                    for (uint32_t Row = 0; Row < BlocksHigh; ++Row)
-                    {
-                        memcpy(DstSlice + static_cast<size_t>(Row) * Layouts[SubresourceIndex].Footprint.RowPitch, SrcSlice + static_cast<size_t>(Row) * SrcRowPitch, SrcRowPitch);
-                    }
-                }
-
-                DataOffset += SubresourceSize;
-            }
-        }
-
-        UploadResource->Unmap(0, nullptr);
-
-        ComPtr<ID3D12CommandAllocator> UploadAllocator;
-        ComPtr<ID3D12GraphicsCommandList> UploadList;
-        HR_CHECK(Device->GetDevice()->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(UploadAllocator.GetAddressOf())));
-        HR_CHECK(Device->GetDevice()->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, UploadAllocator.Get(), nullptr, IID_PPV_ARGS(UploadList.GetAddressOf())));
-
-        for (UINT Subresource = 0; Subresource < SubresourceCount; ++Subresource)
-        {
-            D3D12_TEXTURE_COPY_LOCATION DstLocation = {};
-            DstLocation.pResource = OutTexture.Get();
-            DstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-            DstLocation.SubresourceIndex = Subresource;
-
-            D3D12_TEXTURE_COPY_LOCATION SrcLocation = {};
-            SrcLocation.pResource = UploadResource.Get();
-            SrcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-            SrcLocation.PlacedFootprint = Layouts[Subresource];
-
-            UploadList->CopyTextureRegion(&DstLocation, 0, 0, 0, &SrcLocation, nullptr);
-        }
-
-        D3D12_RESOURCE_BARRIER Barrier = {};
-        Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-        Barrier.Transition.pResource = OutTexture.Get();
-        Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-        Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
-        Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-        UploadList->ResourceBarrier(1, &Barrier);
+        return LoadDdsTexture(FilePath, FilePath, OutTexture, Batch, bUseSRGB);
+    }
 
-        HR_CHECK(UploadList->Close());
+    // A chain generated by an earlier run is read straight from its cooked DDS.
+    FMipGenerationJob MipJob;
+    if (MipGenerator)
+    {
+        MipJob.Filter = bNormalMap ? EMipFilter::NormalMap : (bUseSRGB ? EMipFilter::SRGB : EMipFilter::Linear);
+        MipJob.CookedPath = FMipGenerator::GetCookedPath(FilePath, MipJob.Filter);
 
-        if (RecordedUpload)
-        {
-            RecordedUpload->UploadResource = UploadResource;
-            RecordedUpload->CommandAllocator = UploadAllocator;
-            RecordedUpload->CommandList = UploadList;
-        }
-        else
+        std::error_code Error;
+        if (!MipJob.CookedPath.empty() && std::filesystem::exists(MipJob.CookedPath, Error)
+            && LoadDdsTexture(MipJob.CookedPath, FilePath, OutTexture, Batch, bUseSRGB))
         {
-            ID3D12CommandList* Lists[] = { UploadList.Get() };
-            Device->GetGraphicsQueue()->ExecuteCommandLists(1, Lists);
-            Device->GetGraphicsQueue()->Flush();
+            return true;
         }
-
-        return true;
     }
 
     int Width = 0;
@@ -385,22 +272,24 @@ bool FTextureLoader::LoadTextureInternal(const std::wstring& FilePath, ComPtr<ID
     TextureDesc.Width = static_cast<UINT>(Width);
     TextureDesc.Height = static_cast<UINT>(Height);
     TextureDesc.DepthOrArraySize = 1;
-    TextureDesc.MipLevels = 1;
+    TextureDesc.MipLevels = static_cast<UINT16>(MipGenerator ? FMipGenerator::GetMipCount(static_cast<uint32_t>(Width), static_cast<uint32_t>(Height)) : 1u);
     TextureDesc.Format = bUseSRGB ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
     TextureDesc.SampleDesc.Count = 1;
     TextureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
 
-    D3D12_HEAP_PROPERTIES DefaultHeap = {};
-    DefaultHeap.Type = D3D12_HEAP_TYPE_DEFAULT;
-    DefaultHeap.CreationNodeMask = 1;
-    DefaultHeap.VisibleNodeMask = 1;
+    // Mip 0 goes to a UAV-capable scratch texture; the generator fills the rest of its chain and
+    // copies every mip into the texture.
+    if (TextureDesc.MipLevels > 1 && !MipGenerator->CreateScratch(TextureDesc, MipJob.Scratch))
+    {
+        TextureDesc.MipLevels = 1;
+    }
 
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
-        &DefaultHeap,
-        D3D12_HEAP_FLAG_NONE,
+    // Loaded textures go to the global cache and outlive the renderer that asked for them.
+    FGpuMemoryOwnerScope SharedMemoryScope(FDX12MemoryTracker::SharedOwner);
+    HR_CHECK(Device->CreateStaticResource(
+        EGpuMemoryCategory::Texture,
         &TextureDesc,
         D3D12_RESOURCE_STATE_COPY_DEST,
-        nullptr,
         IID_PPV_ARGS(OutTexture.GetAddressOf())));
 
     if (OutTexture)
@@ -415,86 +304,204 @@ bool FTextureLoader::LoadTextureInternal(const std::wstring& FilePath, ComPtr<ID
     UINT64 UploadBufferSize = 0;
     Device->GetDevice()->GetCopyableFootprints(&TextureDesc, 0, 1, 0, &Layout, &NumRows, &RowSizeInBytes, &UploadBufferSize);
 
-    D3D12_HEAP_PROPERTIES UploadHeap = {};
-    UploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
-    UploadHeap.CreationNodeMask = 1;
-    UploadHeap.VisibleNodeMask = 1;
-
-    D3D12_RESOURCE_DESC UploadDesc = {};
-    UploadDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    UploadDesc.Width = UploadBufferSize;
-    UploadDesc.Height = 1;
-    UploadDesc.DepthOrArraySize = 1;
-    UploadDesc.MipLevels = 1;
-    UploadDesc.Format = DXGI_FORMAT_UNKNOWN;
-    UploadDesc.SampleDesc.Count = 1;
-    UploadDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-
-    ComPtr<ID3D12Resource> UploadResource;
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
-        &UploadHeap,
-        D3D12_HEAP_FLAG_NONE,
-        &UploadDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(UploadResource.GetAddressOf())));
-
-    uint8_t* MappedData = nullptr;
-    D3D12_RANGE EmptyRange = { 0, 0 };
-    HR_CHECK(UploadResource->Map(0, &EmptyRange, reinterpret_cast<void**>(&MappedData)));
+    const FTextureStagingAllocation Staging = Batch.AllocateStaging(UploadBufferSize);
+    if (!OutTexture || !Staging.IsValid())
+    {
+        return false;
+    }
 
     for (UINT Row = 0; Row < NumRows; ++Row)
     {
         const uint8_t* SrcRow = TextureData.data() + Row * static_cast<UINT64>(Width) * 4ULL;
-        memcpy(MappedData + Layout.Offset + Row * Layout.Footprint.RowPitch, SrcRow, Width * 4ULL);
+        memcpy(Staging.CpuAddress + Layout.Offset + Row * Layout.Footprint.RowPitch, SrcRow, Width * 4ULL);
     }
 
-    UploadResource->Unmap(0, nullptr);
+    return Batch.RecordUpload(OutTexture.Get(), Staging, &Layout, 0, 1, false, std::move(MipJob));
+}
 
-    ComPtr<ID3D12CommandAllocator> UploadAllocator;
-    ComPtr<ID3D12GraphicsCommandList> UploadList;
-    HR_CHECK(Device->GetDevice()->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(UploadAllocator.GetAddressOf())));
-    HR_CHECK(Device->GetDevice()->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, UploadAllocator.Get(), nullptr, IID_PPV_ARGS(UploadList.GetAddressOf())));
+bool FTextureLoader::LoadDdsTexture(const std::wstring& DdsPath, const std::wstring& ResourcePath, ComPtr<ID3D12Resource>& OutTexture, FTextureUploadBatch& Batch, bool bUseSRGB, uint32_t FirstMip)
+{
+    CPU_PROFILE_SCOPE("Load DDS Texture");
+    // Mapped rather than read, so mips below FirstMip are never paged in.
+    FMappedFile File;
+    if (!File.Open(DdsPath))
+    {
+        return false;
+    }
+
+    const uint8_t* FileData = File.GetData();
+    const size_t FileSize = File.GetSize();
+
+    ddspp::Descriptor Descriptor = {};
+    if (FileSize < sizeof(uint32_t) || ddspp::decode_header(FileData, Descriptor) != ddspp::Result::Success)
+    {
+        return false;
+    }
 
-    D3D12_TEXTURE_COPY_LOCATION DstLocation = {};
-    DstLocation.pResource = OutTexture.Get();
-    DstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-    DstLocation.SubresourceIndex = 0;
+    if (Descriptor.format == ddspp::DXGIFormat::UNKNOWN || FirstMip >= std::max(1u, Descriptor.numMips))
+    {
+        return false;
+    }
 
-    D3D12_TEXTURE_COPY_LOCATION SrcLocation = {};
-    SrcLocation.pResource = UploadResource.Get();
-    SrcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-    SrcLocation.PlacedFootprint = Layout;
+    const bool bIsCubemap = Descriptor.type == ddspp::Cubemap;
+    const uint32_t ArraySize = Descriptor.type == ddspp::Texture3D ? 1u : std::max(1u, Descriptor.arraySize);
+    const uint32_t SliceCount = bIsCubemap ? ArraySize * 6u : ArraySize;
+    const uint32_t Depth = Descriptor.type == ddspp::Texture3D ? std::max(1u, Descriptor.depth) : 1u;
+    const uint32_t MipCount = Descriptor.numMips - FirstMip;
+    const UINT SubresourceCount = MipCount * SliceCount;
+    const DXGI_FORMAT BaseFormat = static_cast<DXGI_FORMAT>(Descriptor.format);
+    const DXGI_FORMAT Format = bUseSRGB ? MakeSRGBFormat(BaseFormat) : BaseFormat;
 
-    UploadList->CopyTextureRegion(&DstLocation, 0, 0, 0, &SrcLocation, nullptr);
+    D3D12_RESOURCE_DESC TextureDesc = {};
+    TextureDesc.Dimension = Descriptor.type == ddspp::Texture3D ? D3D12_RESOURCE_DIMENSION_TEXTURE3D : D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    TextureDesc.Width = std::max(1u, Descriptor.width >> FirstMip);
+    TextureDesc.Height = std::max(1u, Descriptor.height >> FirstMip);
+    TextureDesc.DepthOrArraySize = Descriptor.type == ddspp::Texture3D ? static_cast<UINT16>(std::max(1u, Depth >> FirstMip)) : static_cast<UINT16>(SliceCount);
+    TextureDesc.MipLevels = static_cast<UINT16>(MipCount);
+    TextureDesc.Format = Format;
+    TextureDesc.SampleDesc.Count = 1;
+    TextureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
 
-    D3D12_RESOURCE_BARRIER Barrier = {};
-    Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-    Barrier.Transition.pResource = OutTexture.Get();
-    Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-    Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
-    Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-    UploadList->ResourceBarrier(1, &Barrier);
+    std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> Layouts(SubresourceCount);
+    std::vector<UINT> NumRows(SubresourceCount);
+    UINT64 TotalLayoutSize = 0;
+    Device->GetDevice()->GetCopyableFootprints(&TextureDesc, 0, SubresourceCount, 0, Layouts.data(), NumRows.data(), nullptr, &TotalLayoutSize);
 
-    HR_CHECK(UploadList->Close());
+    struct FSourceSubresource
+    {
+        size_t Offset = 0;
+        size_t Size = 0;
+        uint64_t RowPitch = 0;
+        uint32_t Rows = 0;
+        uint32_t Depth = 1;
+    };
 
-    if (RecordedUpload)
+    std::vector<FSourceSubresource> Sources(SubresourceCount);
+    size_t DataOffset = Descriptor.headerSize;
+    for (uint32_t ArrayIndex = 0; ArrayIndex < SliceCount; ++ArrayIndex)
     {
-        RecordedUpload->UploadResource = UploadResource;
-        RecordedUpload->CommandAllocator = UploadAllocator;
-        RecordedUpload->CommandList = UploadList;
+        for (uint32_t Mip = 0; Mip < Descriptor.numMips; ++Mip)
+        {
+            const uint32_t MipWidth = std::max(1u, Descriptor.width >> Mip);
+            const uint32_t MipHeight = std::max(1u, Descriptor.height >> Mip);
+            const uint32_t MipDepth = Descriptor.type == ddspp::Texture3D ? std::max(1u, Descriptor.depth >> Mip) : 1u;
+            const uint32_t BlockWidth = std::max(1u, Descriptor.blockWidth);
+            const uint32_t BlockHeight = std::max(1u, Descriptor.blockHeight);
+            const uint32_t BlocksWide = Descriptor.compressed ? (MipWidth + BlockWidth - 1) / BlockWidth : MipWidth;
+            const uint32_t BlocksHigh = Descriptor.compressed ? (MipHeight + BlockHeight - 1) / BlockHeight : MipHeight;
+            const uint64_t SrcRowPitch = BlocksWide * Descriptor.bitsPerPixelOrBlock / 8;
+            const size_t SubresourceSize = static_cast<size_t>(SrcRowPitch) * BlocksHigh * MipDepth;
+
+            if (DataOffset + SubresourceSize > FileSize)
+            {
+                return false;
+            }
+
+            if (Mip >= FirstMip)
+            {
+                Sources[ArrayIndex * MipCount + (Mip - FirstMip)] = { DataOffset, SubresourceSize, SrcRowPitch, BlocksHigh, MipDepth };
+            }
+            DataOffset += SubresourceSize;
+        }
     }
-    else
+
+    // DDS rows are tightly packed, so DirectStorage can only fill the leading mips of a plain 2D
+    // texture whose rows are already footprint-aligned. The last mip always takes the copy path,
+    // so every load still ends in an upload queue fence callers can wait for.
+    FDX12DirectStorage* DirectStorage = Device->GetDirectStorage();
+    uint32_t DirectCount = 0;
+    if (DirectStorage && SliceCount == 1 && TextureDesc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE2D)
+    {
+        while (DirectCount + 1 < SubresourceCount
+            && Sources[DirectCount].RowPitch == Layouts[DirectCount].Footprint.RowPitch
+            && Sources[DirectCount].Size <= FDX12DirectStorage::StagingBufferSize)
+        {
+            ++DirectCount;
+        }
+    }
+
+    // DirectStorage writes need COMMON; the copies below promote the texture to COPY_DEST on a copy queue.
+    const bool bCreatedInCommon = DirectCount > 0;
+    FGpuMemoryOwnerScope SharedMemoryScope(FDX12MemoryTracker::SharedOwner);
+    HR_CHECK(Device->CreateStaticResource(
+        EGpuMemoryCategory::Texture,
+        &TextureDesc,
+        bCreatedInCommon ? D3D12_RESOURCE_STATE_COMMON : D3D12_RESOURCE_STATE_COPY_DEST,
+        IID_PPV_ARGS(OutTexture.GetAddressOf())));
+
+    if (!OutTexture)
     {
-        ID3D12CommandList* Lists[] = { UploadList.Get() };
-        Device->GetGraphicsQueue()->ExecuteCommandLists(1, Lists);
-        Device->GetGraphicsQueue()->Flush();
+        return false;
     }
+    OutTexture->SetName(std::filesystem::path(ResourcePath).filename().c_str());
 
-    return true;
+    if (DirectCount > 0)
+    {
+        std::vector<FDX12DirectStorageTextureRead> Reads(DirectCount);
+        uint64_t DirectBytes = 0;
+        for (uint32_t Subresource = 0; Subresource < DirectCount; ++Subresource)
+        {
+            FDX12DirectStorageTextureRead& Read = Reads[Subresource];
+            Read.FileOffset = Sources[Subresource].Offset;
+            Read.Size = static_cast<uint32_t>(Sources[Subresource].Size);
+            Read.Subresource = Subresource;
+            Read.Width = std::max(1u, static_cast<uint32_t>(TextureDesc.Width) >> Subresource);
+            Read.Height = std::max(1u, TextureDesc.Height >> Subresource);
+            DirectBytes += Read.Size;
+        }
+
+        const auto ReadStartTime = std::chrono::high_resolution_clock::now();
+        if (DirectStorage->ReadTexture(DdsPath, OutTexture.Get(), Reads.data(), DirectCount))
+        {
+            const std::chrono::duration<double> Seconds = std::chrono::high_resolution_clock::now() - ReadStartTime;
+            FDX12DirectStorage::RecordRead(EAssetReadPath::DirectStorage, DirectBytes, Seconds.count());
+        }
+        else
+        {
+            LogWarning("DirectStorage read failed, copying instead: " + std::filesystem::path(DdsPath).u8string());
+            DirectCount = 0;
+        }
+    }
+
+    // The staging space only holds the copied subresources, placed as in the full layout.
+    const UINT64 UploadBaseOffset = Layouts[DirectCount].Offset;
+    const FTextureStagingAllocation Staging = Batch.AllocateStaging(TotalLayoutSize - UploadBaseOffset);
+    if (!Staging.IsValid())
+    {
+        return false;
+    }
+
+    // Timed for the asset I/O log: the mapped file's pages are faulted in by these copies.
+    const auto CopyStartTime = std::chrono::high_resolution_clock::now();
+    uint64_t CopiedBytes = 0;
+    for (UINT Subresource = DirectCount; Subresource < SubresourceCount; ++Subresource)
+    {
+        const FSourceSubresource& Source = Sources[Subresource];
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Layout = Layouts[Subresource];
+        Layout.Offset -= UploadBaseOffset;
+        uint8_t* DstSubresource = Staging.CpuAddress + Layout.Offset;
+        const uint8_t* SrcSubresource = FileData + Source.Offset;
+        const size_t SliceSize = static_cast<size_t>(Source.RowPitch) * Source.Rows;
+
+        for (uint32_t Z = 0; Z < Source.Depth; ++Z)
+        {
+            const uint8_t* SrcSlice = SrcSubresource + SliceSize * Z;
+            uint8_t* DstSlice = DstSubresource + static_cast<size_t>(Layout.Footprint.RowPitch) * NumRows[Subresource] * Z;
+
+            for (uint32_t Row = 0; Row < Source.Rows; ++Row)
+            {
+                memcpy(DstSlice + static_cast<size_t>(Row) * Layout.Footprint.RowPitch, SrcSlice + static_cast<size_t>(Row) * Source.RowPitch, Source.RowPitch);
+            }
+        }
+        CopiedBytes += Source.Size;
+    }
+    const std::chrono::duration<double> CopySeconds = std::chrono::high_resolution_clock::now() - CopyStartTime;
+    FDX12DirectStorage::RecordRead(EAssetReadPath::MappedFile, CopiedBytes, CopySeconds.count());
+
+    return Batch.RecordUpload(OutTexture.Get(), Staging, Layouts.data() + DirectCount, DirectCount, SubresourceCount - DirectCount, bCreatedInCommon);
 }
 
-bool FTextureLoader::CreateDefaultGridTexture(ComPtr<ID3D12Resource>& OutTexture, FTextureUploadWork* RecordedUpload, bool bUseSRGB)
+bool FTextureLoader::CreateDefaultGridTexture(ComPtr<ID3D12Resource>& OutTexture, FTextureUploadBatch& Batch, bool bUseSRGB)
 {
     if (Device == nullptr)
     {
@@ -530,17 +537,11 @@ bool FTextureLoader::CreateDefaultGridTexture(ComPtr<ID3D12Resource>& OutTexture
     TextureDesc.SampleDesc.Count = 1;
     TextureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
 
-    D3D12_HEAP_PROPERTIES DefaultHeap = {};
-    DefaultHeap.Type = D3D12_HEAP_TYPE_DEFAULT;
-    DefaultHeap.CreationNodeMask = 1;
-    DefaultHeap.VisibleNodeMask = 1;
-
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
-        &DefaultHeap,
-        D3D12_HEAP_FLAG_NONE,
+    FGpuMemoryOwnerScope SharedMemoryScope(FDX12MemoryTracker::SharedOwner);
+    HR_CHECK(Device->CreateStaticResource(
+        EGpuMemoryCategory::Texture,
         &TextureDesc,
         D3D12_RESOURCE_STATE_COPY_DEST,
-        nullptr,
         IID_PPV_ARGS(OutTexture.GetAddressOf())));
 
     D3D12_PLACED_SUBRESOURCE_FOOTPRINT Layout = {};
@@ -549,86 +550,22 @@ bool FTextureLoader::CreateDefaultGridTexture(ComPtr<ID3D12Resource>& OutTexture
     UINT64 UploadBufferSize = 0;
     Device->GetDevice()->GetCopyableFootprints(&TextureDesc, 0, 1, 0, &Layout, &NumRows, &RowSizeInBytes, &UploadBufferSize);
 
-    D3D12_HEAP_PROPERTIES UploadHeap = {};
-    UploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
-    UploadHeap.CreationNodeMask = 1;
-    UploadHeap.VisibleNodeMask = 1;
-
-    D3D12_RESOURCE_DESC UploadDesc = {};
-    UploadDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    UploadDesc.Width = UploadBufferSize;
-    UploadDesc.Height = 1;
-    UploadDesc.DepthOrArraySize = 1;
-    UploadDesc.MipLevels = 1;
-    UploadDesc.Format = DXGI_FORMAT_UNKNOWN;
-    UploadDesc.SampleDesc.Count = 1;
-    UploadDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-
-    ComPtr<ID3D12Resource> UploadResource;
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
-        &UploadHeap,
-        D3D12_HEAP_FLAG_NONE,
-        &UploadDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(UploadResource.GetAddressOf())));
-
-    uint8_t* MappedData = nullptr;
-    D3D12_RANGE EmptyRange = { 0, 0 };
-    HR_CHECK(UploadResource->Map(0, &EmptyRange, reinterpret_cast<void**>(&MappedData)));
-
-    for (UINT Row = 0; Row < NumRows; ++Row)
+    const FTextureStagingAllocation Staging = Batch.AllocateStaging(UploadBufferSize);
+    if (!OutTexture || !Staging.IsValid())
     {
-        const uint8_t* SrcRow = reinterpret_cast<const uint8_t*>(&TextureData[Row * Width]);
-        memcpy(MappedData + Layout.Offset + Row * Layout.Footprint.RowPitch, SrcRow, Width * sizeof(uint32_t));
+        return false;
     }
 
-    UploadResource->Unmap(0, nullptr);
-
-    ComPtr<ID3D12CommandAllocator> UploadAllocator;
-    ComPtr<ID3D12GraphicsCommandList> UploadList;
-    HR_CHECK(Device->GetDevice()->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(UploadAllocator.GetAddressOf())));
-    HR_CHECK(Device->GetDevice()->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, UploadAllocator.Get(), nullptr, IID_PPV_ARGS(UploadList.GetAddressOf())));
-
-    D3D12_TEXTURE_COPY_LOCATION DstLocation = {};
-    DstLocation.pResource = OutTexture.Get();
-    DstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-    DstLocation.SubresourceIndex = 0;
-
-    D3D12_TEXTURE_COPY_LOCATION SrcLocation = {};
-    SrcLocation.pResource = UploadResource.Get();
-    SrcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-    SrcLocation.PlacedFootprint = Layout;
-
-    UploadList->CopyTextureRegion(&DstLocation, 0, 0, 0, &SrcLocation, nullptr);
-
-    D3D12_RESOURCE_BARRIER Barrier = {};
-    Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-    Barrier.Transition.pResource = OutTexture.Get();
-    Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-    Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
-    Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-    UploadList->ResourceBarrier(1, &Barrier);
-
-    HR_CHECK(UploadList->Close());
-
-    if (RecordedUpload)
-    {
-        RecordedUpload->UploadResource = UploadResource;
-        RecordedUpload->CommandAllocator = UploadAllocator;
-        RecordedUpload->CommandList = UploadList;
-    }
-    else
+    for (UINT Row = 0; Row < NumRows; ++Row)
     {
-        ID3D12CommandList* Lists[] = { UploadList.Get() };
-        Device->GetGraphicsQueue()->ExecuteCommandLists(1, Lists);
-        Device->GetGraphicsQueue()->Flush();
+        const uint8_t* SrcRow = reinterpret_cast<const uint8_t*>(&TextureData[Row * Width]);
+        memcpy(Staging.CpuAddress + Layout.Offset + Row * Layout.Footprint.RowPitch, SrcRow, Width * sizeof(uint32_t));
     }
 
-    return true;
+    return Batch.RecordUpload(OutTexture.Get(), Staging, &Layout, 0, 1, false);
 }
 
-bool FTextureLoader::CreateSolidColorTexture(uint32_t Color, ComPtr<ID3D12Resource>& OutTexture, FTextureUploadWork* RecordedUpload, bool bUseSRGB)
+bool FTextureLoader::CreateSolidColorTexture(uint32_t Color, ComPtr<ID3D12Resource>& OutTexture, FTextureUploadBatch& Batch, bool bUseSRGB)
 {
     if (Device == nullptr)
     {
@@ -649,17 +586,11 @@ bool FTextureLoader::CreateSolidColorTexture(uint32_t Color, ComPtr<ID3D12Resour
     TextureDesc.SampleDesc.Count = 1;
     TextureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
 
-    D3D12_HEAP_PROPERTIES DefaultHeap = {};
-    DefaultHeap.Type = D3D12_HEAP_TYPE_DEFAULT;
-    DefaultHeap.CreationNodeMask = 1;
-    DefaultHeap.VisibleNodeMask = 1;
-
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
-        &DefaultHeap,
-        D3D12_HEAP_FLAG_NONE,
+    FGpuMemoryOwnerScope SharedMemoryScope(FDX12MemoryTracker::SharedOwner);
+    HR_CHECK(Device->CreateStaticResource(
+        EGpuMemoryCategory::Texture,
         &TextureDesc,
         D3D12_RESOURCE_STATE_COPY_DEST,
-        nullptr,
         IID_PPV_ARGS(OutTexture.GetAddressOf())));
 
     D3D12_PLACED_SUBRESOURCE_FOOTPRINT Layout = {};
@@ -668,79 +599,23 @@ bool FTextureLoader::CreateSolidColorTexture(uint32_t Color, ComPtr<ID3D12Resour
     UINT64 UploadBufferSize = 0;
     Device->GetDevice()->GetCopyableFootprints(&TextureDesc, 0, 1, 0, &Layout, &NumRows, &RowSizeInBytes, &UploadBufferSize);
 
-    D3D12_HEAP_PROPERTIES UploadHeap = {};
-    UploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
-    UploadHeap.CreationNodeMask = 1;
-    UploadHeap.VisibleNodeMask = 1;
-
-    D3D12_RESOURCE_DESC UploadDesc = {};
-    UploadDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    UploadDesc.Width = UploadBufferSize;
-    UploadDesc.Height = 1;
-    UploadDesc.DepthOrArraySize = 1;
-    UploadDesc.MipLevels = 1;
-    UploadDesc.Format = DXGI_FORMAT_UNKNOWN;
-    UploadDesc.SampleDesc.Count = 1;
-    UploadDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-
-    ComPtr<ID3D12Resource> UploadResource;
-    HR_CHECK(Device->GetDevice()->CreateCommittedResource(
-        &UploadHeap,
-        D3D12_HEAP_FLAG_NONE,
-        &UploadDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(UploadResource.GetAddressOf())));
-
-    uint8_t* MappedData = nullptr;
-    D3D12_RANGE EmptyRange = { 0, 0 };
-    HR_CHECK(UploadResource->Map(0, &EmptyRange, reinterpret_cast<void**>(&MappedData)));
-
-    const uint8_t* SrcRow = reinterpret_cast<const uint8_t*>(TextureData.data());
-    memcpy(MappedData + Layout.Offset, SrcRow, sizeof(uint32_t));
-    UploadResource->Unmap(0, nullptr);
-
-    ComPtr<ID3D12CommandAllocator> UploadAllocator;
-    ComPtr<ID3D12GraphicsCommandList> UploadList;
-    HR_CHECK(Device->GetDevice()->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(UploadAllocator.GetAddressOf())));
-    HR_CHECK(Device->GetDevice()->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, UploadAllocator.Get(), nullptr, IID_PPV_ARGS(UploadList.GetAddressOf())));
-
-    D3D12_TEXTURE_COPY_LOCATION DstLocation = {};
-    DstLocation.pResource = OutTexture.Get();
-    DstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-    DstLocation.SubresourceIndex = 0;
-
-    D3D12_TEXTURE_COPY_LOCATION SrcLocation = {};
-    SrcLocation.pResource = UploadResource.Get();
-    SrcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-    SrcLocation.PlacedFootprint = Layout;
-
-    UploadList->CopyTextureRegion(&DstLocation, 0, 0, 0, &SrcLocation, nullptr);
-
-    D3D12_RESOURCE_BARRIER Barrier = {};
-    Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-    Barrier.Transition.pResource = OutTexture.Get();
-    Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
-    Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
-    Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-    UploadList->ResourceBarrier(1, &Barrier);
-
-    HR_CHECK(UploadList->Close());
-
-    if (RecordedUpload)
-    {
-        RecordedUpload->UploadResource = UploadResource;
-        RecordedUpload->CommandAllocator = UploadAllocator;
-        RecordedUpload->CommandList = UploadList;
-    }
-    else
+    const FTextureStagingAllocation Staging = Batch.AllocateStaging(UploadBufferSize);
+    if (!OutTexture || !Staging.IsValid())
     {
-        ID3D12CommandList* CommandLists[] = { UploadList.Get() };
-        Device->GetGraphicsQueue()->ExecuteCommandLists(1, CommandLists);
-        Device->GetGraphicsQueue()->Flush();
+        return false;
     }
 
-    return true;
+    memcpy(Staging.CpuAddress + Layout.Offset, TextureData.data(), sizeof(uint32_t));
+
+    return Batch.RecordUpload(OutTexture.Get(), Staging, &Layout, 0, 1, false);
+}
+
+void FTextureLoader::ProcessCompletedWork()
+{
+    if (MipGenerator)
+    {
+        MipGenerator->ReleaseCompleted();
+    }
 }
 
 bool FTextureLoader::LoadTexturesParallel(std::vector<FTextureLoadRequest>& Requests)
@@ -750,23 +625,26 @@ bool FTextureLoader::LoadTexturesParallel(std::vector<FTextureLoadRequest>& Requ
         return true;
     }
 
+    CPU_PROFILE_SCOPE("Load Textures");
     const auto StartTime = std::chrono::high_resolution_clock::now();
 
     if (!FTaskScheduler::Get().IsRunning())
     {
         // Fallback to serial loading if task system is not initialized
         LogWarning("Task system not initialized, falling back to serial texture loading");
+        FTextureUploadBatch Batch(*this);
         for (FTextureLoadRequest& Request : Requests)
         {
             if (Request.bUseSolidColor)
             {
-                Request.bSuccess = LoadOrSolidColor(Request.Path, Request.SolidColor, *Request.OutTexture, nullptr, Request.bUseSRGB);
+                Request.bSuccess = LoadOrSolidColor(Request.Path, Request.SolidColor, *Request.OutTexture, &Batch, Request.bUseSRGB, Request.bNormalMap);
             }
             else
             {
-                Request.bSuccess = LoadOrDefault(Request.Path, *Request.OutTexture, nullptr, Request.bUseSRGB);
+                Request.bSuccess = LoadOrDefault(Request.Path, *Request.OutTexture, &Batch, Request.bUseSRGB, Request.bNormalMap);
             }
         }
+        Batch.Submit();
 
         const auto EndTime = std::chrono::high_resolution_clock::now();
         const auto Duration = std::chrono::duration_cast<std::chrono::milliseconds>(EndTime - StartTime);
@@ -774,53 +652,36 @@ bool FTextureLoader::LoadTexturesParallel(std::vector<FTextureLoadRequest>& Requ
     }
     else
     {
-        // Load textures in parallel
-        std::vector<FTextureUploadWork> UploadWork(Requests.size());
+        // Every worker stages into the same pages and records into the batch's shared command
+        // list, so the whole load submits a few lists instead of one per texture.
+        FTextureUploadBatch Batch(*this);
         std::vector<FTask::FTaskFunction> Tasks;
         Tasks.reserve(Requests.size());
 
         for (size_t Index = 0; Index < Requests.size(); ++Index)
         {
             FTextureLoadRequest& Request = Requests[Index];
-            FTextureUploadWork* Work = &UploadWork[Index];
 
-            Tasks.push_back([this, &Request, Work]()
+            Tasks.push_back([this, &Request, &Batch]()
             {
                 if (Request.bUseSolidColor)
                 {
-                    Request.bSuccess = LoadOrSolidColor(Request.Path, Request.SolidColor, *Request.OutTexture, Work, Request.bUseSRGB);
+                    Request.bSuccess = LoadOrSolidColor(Request.Path, Request.SolidColor, *Request.OutTexture, &Batch, Request.bUseSRGB, Request.bNormalMap);
                 }
                 else
                 {
-                    Request.bSuccess = LoadOrDefault(Request.Path, *Request.OutTexture, Work, Request.bUseSRGB);
+                    Request.bSuccess = LoadOrDefault(Request.Path, *Request.OutTexture, &Batch, Request.bUseSRGB, Request.bNormalMap);
                 }
             });
         }
 
-        std::vector<FTaskRef> ScheduledTasks = FTaskScheduler::Get().ScheduleTaskBatch(Tasks);
+        // Inherit the caller's priority so loads issued by a background scene reload stay in the background
+        std::vector<FTaskRef> ScheduledTasks = FTaskScheduler::Get().ScheduleTaskBatch(Tasks, FTaskScheduler::GetCurrentTaskPriority());
         
         // Wait for all texture loading tasks to complete
-        for (const FTaskRef& Task : ScheduledTasks)
-        {
-            FTaskScheduler::Get().WaitForTask(Task);
-        }
-
-        std::vector<ID3D12CommandList*> RecordedLists;
-        RecordedLists.reserve(UploadWork.size());
-
-        for (size_t Index = 0; Index < UploadWork.size(); ++Index)
-        {
-            if (Requests[Index].bSuccess && UploadWork[Index].CommandList)
-            {
-                RecordedLists.push_back(UploadWork[Index].CommandList.Get());
-            }
-        }
+        FTaskScheduler::Get().WaitForTask(FTaskScheduler::Get().ScheduleJoin(ScheduledTasks));
 
-        if (!RecordedLists.empty())
-        {
-            Device->GetGraphicsQueue()->ExecuteCommandLists(static_cast<UINT>(RecordedLists.size()), RecordedLists.data());
-            Device->GetGraphicsQueue()->Flush();
-        }
+        Batch.Submit();
 
         const auto EndTime = std::chrono::high_resolution_clock::now();
         const auto Duration = std::chrono::duration_cast<std::chrono::milliseconds>(EndTime - StartTime);
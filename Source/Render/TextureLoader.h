@@ -3,9 +3,13 @@
 #include <wrl.h>
 #include <d3d12.h>
 #include <string>
-#include <unordered_map>
 #include <vector>
 #include <functional>
+#include <memory>
+
+#include "MipGenerator.h"
+#include "TextureCache.h"
+#include "TextureUploadBatch.h"
 
 class FDX12Device;
 
@@ -15,25 +19,31 @@ struct FTextureLoadRequest
     uint32_t SolidColor = 0;
     bool bUseSolidColor = false;
     bool bUseSRGB = false;
+    // Tangent-space normals: generated mips are renormalized instead of averaged.
+    bool bNormalMap = false;
     Microsoft::WRL::ComPtr<ID3D12Resource>* OutTexture = nullptr;
     bool bSuccess = false;
 };
 
-struct FTextureUploadWork
-{
-    Microsoft::WRL::ComPtr<ID3D12Resource> UploadResource;
-    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> CommandAllocator;
-    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> CommandList;
-};
-
 class FTextureLoader
 {
 public:
     explicit FTextureLoader(FDX12Device* InDevice);
 
-    bool LoadOrDefault(const std::wstring& TexturePath, Microsoft::WRL::ComPtr<ID3D12Resource>& OutTexture, FTextureUploadWork* RecordedUpload = nullptr, bool bUseSRGB = false);
-    bool LoadOrSolidColor(const std::wstring& TexturePath, uint32_t Color, Microsoft::WRL::ComPtr<ID3D12Resource>& OutTexture, FTextureUploadWork* RecordedUpload = nullptr, bool bUseSRGB = false);
+    // Loads record their uploads into Batch, which publishes the textures once it submits them;
+    // without a batch the upload is submitted before the call returns.
+    bool LoadOrDefault(const std::wstring& TexturePath, Microsoft::WRL::ComPtr<ID3D12Resource>& OutTexture, FTextureUploadBatch* Batch = nullptr, bool bUseSRGB = false, bool bNormalMap = false);
+    bool LoadOrSolidColor(const std::wstring& TexturePath, uint32_t Color, Microsoft::WRL::ComPtr<ID3D12Resource>& OutTexture, FTextureUploadBatch* Batch = nullptr, bool bUseSRGB = false, bool bNormalMap = false);
+    // The DDS chain from FirstMip down as a texture of its own, cached per path and first mip.
+    bool LoadTextureTail(const std::wstring& DdsPath, uint32_t FirstMip, Microsoft::WRL::ComPtr<ID3D12Resource>& OutTexture, FTextureUploadBatch* Batch = nullptr, bool bUseSRGB = false);
+    // Same as LoadTextureTail but never cached, for textures whose residency is managed by the caller.
+    bool LoadTextureMips(const std::wstring& DdsPath, uint32_t FirstMip, Microsoft::WRL::ComPtr<ID3D12Resource>& OutTexture, FTextureUploadBatch* Batch = nullptr, bool bUseSRGB = false);
     void ClearCache();
+    // Shared by every loader; textures past the budget are evicted least recently used first.
+    static void SetCacheBudget(uint64_t BudgetBytes) { GlobalTextureCache.SetBudget(BudgetBytes); }
+    static FTextureCacheStats GetCacheStats() { return GlobalTextureCache.GetStats(); }
+    // Releases finished mip generations and writes their cooked files. Call once per frame.
+    void ProcessCompletedWork();
 
     /**
      * Load multiple textures in parallel using the task system.
@@ -43,12 +53,25 @@ public:
     bool LoadTexturesParallel(std::vector<FTextureLoadRequest>& Requests);
 
 private:
-    bool TryGetCachedTexture(const std::wstring& TexturePath, Microsoft::WRL::ComPtr<ID3D12Resource>& OutTexture) const;
-    bool LoadTextureInternal(const std::wstring& TexturePath, Microsoft::WRL::ComPtr<ID3D12Resource>& OutTexture, FTextureUploadWork* RecordedUpload, bool bUseSRGB);
-    bool CreateDefaultGridTexture(Microsoft::WRL::ComPtr<ID3D12Resource>& OutTexture, FTextureUploadWork* RecordedUpload, bool bUseSRGB);
-    bool CreateSolidColorTexture(uint32_t Color, Microsoft::WRL::ComPtr<ID3D12Resource>& OutTexture, FTextureUploadWork* RecordedUpload, bool bUseSRGB);
+    friend class FTextureUploadBatch;
+
+    // Key of a file loaded with the given options; invalid when the file cannot be read.
+    static FTextureCacheKey BuildCacheKey(const std::wstring& TexturePath, bool bUseSRGB, bool bNormalMap = false, uint32_t FirstMip = 0);
+    // Published once the batch submitted the texture's copies, so no load hands it out before a fence covers them.
+    void CacheTexture(const FTextureCacheKey& CacheKey, const Microsoft::WRL::ComPtr<ID3D12Resource>& Texture, FTextureUploadBatch& Batch);
+    void PublishTexture(const FTextureCacheKey& CacheKey, const Microsoft::WRL::ComPtr<ID3D12Resource>& Texture);
+    bool TryGetCachedTexture(const FTextureCacheKey& CacheKey, Microsoft::WRL::ComPtr<ID3D12Resource>& OutTexture) const;
+    uint64_t GetTextureSize(ID3D12Resource* Texture) const;
+    bool LoadTextureInternal(const std::wstring& TexturePath, Microsoft::WRL::ComPtr<ID3D12Resource>& OutTexture, FTextureUploadBatch& Batch, bool bUseSRGB, bool bNormalMap);
+    // ResourcePath names the texture, so cooked files show up under their source image.
+    // Mips above FirstMip are skipped; the texture starts at FirstMip's size.
+    bool LoadDdsTexture(const std::wstring& DdsPath, const std::wstring& ResourcePath, Microsoft::WRL::ComPtr<ID3D12Resource>& OutTexture, FTextureUploadBatch& Batch, bool bUseSRGB, uint32_t FirstMip = 0);
+    bool CreateDefaultGridTexture(Microsoft::WRL::ComPtr<ID3D12Resource>& OutTexture, FTextureUploadBatch& Batch, bool bUseSRGB);
+    bool CreateSolidColorTexture(uint32_t Color, Microsoft::WRL::ComPtr<ID3D12Resource>& OutTexture, FTextureUploadBatch& Batch, bool bUseSRGB);
 
 private:
     FDX12Device* Device = nullptr;
-    static std::unordered_map<std::wstring, Microsoft::WRL::ComPtr<ID3D12Resource>> GlobalTextureCache;
+    // Null when the device has no compute support for it; stb images then load with one mip.
+    std::unique_ptr<FMipGenerator> MipGenerator;
+    static FTextureCache GlobalTextureCache;
 };
@@ -0,0 +1,530 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "TextureMipStreamer.h"
+
+#include "MipGenerator.h"
+#include "TextureLoader.h"
+#include "../RHI/DX12Device.h"
+#include "../RHI/DX12CommandQueue.h"
+#include "../RHI/DX12UploadQueue.h"
+#include "../Core/MappedFile.h"
+#include "../Core/Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cwctype>
+#include <filesystem>
+
+#include "../../ThirdParty/ddspp/ddspp.h"
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+    bool HasDdsExtension(const std::wstring& Path)
+    {
+        std::wstring Extension = std::filesystem::path(Path).extension().wstring();
+        for (wchar_t& Char : Extension)
+        {
+            Char = static_cast<wchar_t>(std::towlower(Char));
+        }
+        return Extension == L".dds";
+    }
+}
+
+FTextureMipStreamer::FTextureMipStreamer(FDX12Device* InDevice, FTextureLoader* InTextureLoader, uint64_t InBudgetOverrideBytes)
+    : Device(InDevice)
+    , TextureLoader(InTextureLoader)
+    , BudgetOverrideBytes(InBudgetOverrideBytes)
+{
+}
+
+FTextureMipStreamer::~FTextureMipStreamer()
+{
+    uint64_t LastFenceValue = 0;
+    for (const std::unique_ptr<FTextureEntry>& Entry : Entries)
+    {
+        if (!Entry->Pending)
+        {
+            continue;
+        }
+        if (Entry->Pending->Task)
+        {
+            FTaskScheduler::Get().WaitForTask(Entry->Pending->Task);
+        }
+        LastFenceValue = (std::max)(LastFenceValue, Entry->Pending->FenceValue);
+    }
+
+    // Copies into textures that were never swapped in must land before they are released.
+    FDX12UploadQueue* UploadQueue = Device ? Device->GetUploadQueue() : nullptr;
+    if (UploadQueue && LastFenceValue > 0)
+    {
+        UploadQueue->WaitOnCpu(LastFenceValue);
+    }
+}
+
+ComPtr<ID3D12Resource>& FTextureMipStreamer::GetSlot(FStreamedModelTextures& Textures, uint32_t Slot)
+{
+    switch (Slot)
+    {
+    case 0:
+        return Textures.BaseColor;
+    case 1:
+        return Textures.MetallicRoughness;
+    case 2:
+        return Textures.Normal;
+    default:
+        return Textures.Emissive;
+    }
+}
+
+FStreamedTextureSource FTextureMipStreamer::Register(uint32_t ModelIndex, uint32_t Slot, const std::wstring& Path, bool bUseSRGB, bool bNormalMap)
+{
+    FStreamedTextureSource Source;
+    Source.Path = Path;
+    if (!Device || Path.empty() || Slot >= 4)
+    {
+        return Source;
+    }
+
+    // Images are only streamed once an earlier run cooked their chain.
+    std::wstring DdsPath = Path;
+    if (!HasDdsExtension(Path))
+    {
+        const EMipFilter Filter = bNormalMap ? EMipFilter::NormalMap : (bUseSRGB ? EMipFilter::SRGB : EMipFilter::Linear);
+        DdsPath = FMipGenerator::GetCookedPath(Path, Filter);
+
+        std::error_code Error;
+        if (DdsPath.empty() || !std::filesystem::exists(DdsPath, Error))
+        {
+            return Source;
+        }
+    }
+
+    const std::wstring Key = DdsPath + (bUseSRGB ? L"|srgb" : L"");
+    uint32_t EntryIndex = InvalidEntry;
+    const auto Found = EntryLookup.find(Key);
+    if (Found != EntryLookup.end())
+    {
+        EntryIndex = Found->second;
+    }
+    else
+    {
+        std::unique_ptr<FTextureEntry> Entry = std::make_unique<FTextureEntry>();
+        Entry->DdsPath = DdsPath;
+        Entry->bUseSRGB = bUseSRGB;
+        if (ReadSource(DdsPath, *Entry))
+        {
+            EntryIndex = static_cast<uint32_t>(Entries.size());
+            Entries.push_back(std::move(Entry));
+        }
+        EntryLookup.emplace(Key, EntryIndex);
+    }
+
+    if (EntryIndex == InvalidEntry)
+    {
+        return Source;
+    }
+
+    if (ModelIndex >= Models.size())
+    {
+        Models.resize(ModelIndex + 1);
+    }
+    Models[ModelIndex].Entries[Slot] = EntryIndex;
+
+    FTextureEntry& Entry = *Entries[EntryIndex];
+    Entry.Users.push_back({ ModelIndex, Slot });
+
+    Source.TailPath = Entry.DdsPath;
+    Source.TailMip = Entry.TailMip;
+    return Source;
+}
+
+bool FTextureMipStreamer::ReadSource(const std::wstring& DdsPath, FTextureEntry& OutEntry) const
+{
+    // Only the header pages are touched.
+    FMappedFile File;
+    ddspp::Descriptor Descriptor = {};
+    if (!File.Open(DdsPath) || File.GetSize() < sizeof(uint32_t)
+        || ddspp::decode_header(File.GetData(), Descriptor) != ddspp::Result::Success)
+    {
+        return false;
+    }
+
+    if (Descriptor.type != ddspp::Texture2D || Descriptor.arraySize > 1 || Descriptor.numMips <= 1
+        || Descriptor.format == ddspp::DXGIFormat::UNKNOWN)
+    {
+        return false;
+    }
+
+    OutEntry.Width = Descriptor.width;
+    OutEntry.Height = Descriptor.height;
+    OutEntry.MipCount = Descriptor.numMips;
+
+    D3D12_RESOURCE_DESC Desc = {};
+    Desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    Desc.DepthOrArraySize = 1;
+    Desc.Format = static_cast<DXGI_FORMAT>(Descriptor.format);
+    Desc.SampleDesc.Count = 1;
+    Desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+
+    // The tail is the first mip within TailSize, or the last one before it a block compressed
+    // texture can start at.
+    uint32_t TailMip = 0;
+    OutEntry.ChainBytes.clear();
+    for (uint32_t Mip = 0; Mip < Descriptor.numMips; ++Mip)
+    {
+        const uint32_t MipWidth = (std::max)(1u, Descriptor.width >> Mip);
+        const uint32_t MipHeight = (std::max)(1u, Descriptor.height >> Mip);
+        const bool bValidStart = !Descriptor.compressed
+            || (MipWidth % Descriptor.blockWidth == 0 && MipHeight % Descriptor.blockHeight == 0);
+
+        uint64_t Bytes = 0;
+        if (bValidStart)
+        {
+            Desc.Width = MipWidth;
+            Desc.Height = MipHeight;
+            Desc.MipLevels = static_cast<UINT16>(Descriptor.numMips - Mip);
+            Bytes = Device->GetDevice()->GetResourceAllocationInfo(0, 1, &Desc).SizeInBytes;
+            TailMip = Mip;
+        }
+        OutEntry.ChainBytes.push_back(Bytes);
+
+        if ((std::max)(MipWidth, MipHeight) <= TailSize)
+        {
+            break;
+        }
+    }
+
+    // Already small enough to load whole.
+    if (TailMip == 0)
+    {
+        return false;
+    }
+
+    OutEntry.TailMip = TailMip;
+    OutEntry.ChainBytes.resize(TailMip + 1);
+    return true;
+}
+
+void FTextureMipStreamer::OnModelResident(FStreamedModelTextures& Textures)
+{
+    if (Textures.ModelIndex >= Models.size())
+    {
+        return;
+    }
+
+    FModelState& Model = Models[Textures.ModelIndex];
+    for (uint32_t Slot = 0; Slot < 4; ++Slot)
+    {
+        if (Model.Entries[Slot] == InvalidEntry)
+        {
+            continue;
+        }
+
+        FTextureEntry& Entry = *Entries[Model.Entries[Slot]];
+        ComPtr<ID3D12Resource>& Texture = GetSlot(Textures, Slot);
+        if (Entry.Texture)
+        {
+            Texture = Entry.Texture;
+            continue;
+        }
+
+        // A failed tail load falls back to the whole image or the default grid, neither of
+        // which this class can size.
+        const D3D12_RESOURCE_DESC Desc = Texture ? Texture->GetDesc() : D3D12_RESOURCE_DESC{};
+        if (!Texture || Desc.Width != (std::max)(1u, Entry.Width >> Entry.TailMip) || Desc.MipLevels != Entry.MipCount - Entry.TailMip)
+        {
+            Entry.bFailed = true;
+            continue;
+        }
+
+        Entry.Texture = Texture;
+        Entry.ResidentMip = Entry.TailMip;
+        ResidentBytes += Entry.ChainBytes[Entry.TailMip];
+    }
+
+    Model.Textures = Textures;
+    Model.bResident = true;
+}
+
+uint64_t FTextureMipStreamer::QueryBudget() const
+{
+    uint64_t Budget = BudgetOverrideBytes;
+
+    DXGI_QUERY_VIDEO_MEMORY_INFO Info = {};
+    if (Device && Device->QueryLocalVideoMemory(Info))
+    {
+        // Headroom for render targets and transient allocations the scene does not account for.
+        const uint64_t DeviceBudget = Info.Budget - Info.Budget / 10;
+        const uint64_t OtherUsage = Info.CurrentUsage > ResidentBytes ? Info.CurrentUsage - ResidentBytes : 0;
+        const uint64_t Available = DeviceBudget > OtherUsage ? DeviceBudget - OtherUsage : 0;
+        Budget = Budget > 0 ? (std::min)(Budget, Available) : Available;
+    }
+    else if (Budget == 0)
+    {
+        Budget = UINT64_MAX;
+    }
+
+    return Budget;
+}
+
+uint32_t FTextureMipStreamer::ClampFirstMip(const FTextureEntry& Entry, uint32_t FirstMip) const
+{
+    uint32_t Mip = (std::min)(FirstMip, Entry.TailMip);
+    while (Mip > 0 && Entry.ChainBytes[Mip] == 0)
+    {
+        --Mip;
+    }
+    return Mip;
+}
+
+void FTextureMipStreamer::Update(const std::vector<float>& ModelScreenSizes)
+{
+    ReleaseRetired();
+    FinishLoads();
+
+    for (const std::unique_ptr<FTextureEntry>& EntryPtr : Entries)
+    {
+        FTextureEntry& Entry = *EntryPtr;
+        Entry.ScreenSize = 0.0f;
+        for (const FTextureUser& User : Entry.Users)
+        {
+            if (User.ModelIndex < ModelScreenSizes.size())
+            {
+                Entry.ScreenSize = (std::max)(Entry.ScreenSize, ModelScreenSizes[User.ModelIndex]);
+            }
+        }
+
+        // One texel per pixel across the model's projected size; off-screen textures want the tail.
+        Entry.WantedMip = Entry.TailMip;
+        if (Entry.ScreenSize > 0.0f)
+        {
+            const float Ratio = static_cast<float>((std::max)(Entry.Width, Entry.Height)) / Entry.ScreenSize;
+            const float Mip = Ratio > 1.0f ? std::floor(std::log2(Ratio)) : 0.0f;
+            Entry.WantedMip = (std::min)(static_cast<uint32_t>(Mip), Entry.TailMip);
+        }
+    }
+
+    // Drop the same number of mips everywhere until the wanted set fits.
+    const uint64_t Budget = QueryBudget();
+    uint32_t Bias = 0;
+    for (; Bias < 16; ++Bias)
+    {
+        uint64_t WantedBytes = 0;
+        for (const std::unique_ptr<FTextureEntry>& Entry : Entries)
+        {
+            if (Entry->Texture)
+            {
+                WantedBytes += Entry->ChainBytes[ClampFirstMip(*Entry, Entry->WantedMip + Bias)];
+            }
+        }
+        if (WantedBytes <= Budget)
+        {
+            break;
+        }
+    }
+
+    if (Bias != BudgetBias)
+    {
+        if (Bias > 0)
+        {
+            LogInfo("Texture streaming over budget, dropping " + std::to_string(Bias) + " mip(s); budget "
+                + std::to_string(Budget >> 20) + " MB");
+        }
+        BudgetBias = Bias;
+    }
+
+    struct FCandidate
+    {
+        FTextureEntry* Entry = nullptr;
+        uint32_t FirstMip = 0;
+        float Priority = 0.0f;
+    };
+    std::vector<FCandidate> Trims;
+    std::vector<FCandidate> Loads;
+    for (const std::unique_ptr<FTextureEntry>& EntryPtr : Entries)
+    {
+        FTextureEntry& Entry = *EntryPtr;
+        if (!Entry.Texture || Entry.Pending || Entry.bFailed)
+        {
+            continue;
+        }
+
+        const uint32_t TargetMip = ClampFirstMip(Entry, Entry.WantedMip + Bias);
+        if (TargetMip < Entry.ResidentMip)
+        {
+            Loads.push_back({ &Entry, TargetMip, Entry.ScreenSize });
+        }
+        else if (TargetMip > Entry.ResidentMip && ResidentBytes > Budget)
+        {
+            Trims.push_back({ &Entry, TargetMip, static_cast<float>(Entry.ChainBytes[Entry.ResidentMip] - Entry.ChainBytes[TargetMip]) });
+        }
+    }
+
+    // Trims first, largest savings first, then the biggest on screen.
+    const auto ByPriority = [](const FCandidate& A, const FCandidate& B) { return A.Priority > B.Priority; };
+    std::sort(Trims.begin(), Trims.end(), ByPriority);
+    std::sort(Loads.begin(), Loads.end(), ByPriority);
+
+    for (const FCandidate& Trim : Trims)
+    {
+        if (LoadsInFlight >= MaxLoadsInFlight)
+        {
+            return;
+        }
+        StartLoad(*Trim.Entry, Trim.FirstMip);
+    }
+
+    // Growth of the loads already started counts against the budget until they are swapped in.
+    uint64_t ProjectedBytes = ResidentBytes;
+    for (const std::unique_ptr<FTextureEntry>& Entry : Entries)
+    {
+        if (Entry->Pending && Entry->Pending->FirstMip < Entry->ResidentMip)
+        {
+            ProjectedBytes += Entry->ChainBytes[Entry->Pending->FirstMip] - Entry->ChainBytes[Entry->ResidentMip];
+        }
+    }
+
+    for (const FCandidate& Load : Loads)
+    {
+        if (LoadsInFlight >= MaxLoadsInFlight)
+        {
+            return;
+        }
+
+        const uint64_t Growth = Load.Entry->ChainBytes[Load.FirstMip] - Load.Entry->ChainBytes[Load.Entry->ResidentMip];
+        if (ProjectedBytes + Growth > Budget)
+        {
+            continue;
+        }
+        ProjectedBytes += Growth;
+        StartLoad(*Load.Entry, Load.FirstMip);
+    }
+}
+
+void FTextureMipStreamer::StartLoad(FTextureEntry& Entry, uint32_t FirstMip)
+{
+    Entry.Pending = std::make_unique<FPendingLoad>();
+    Entry.Pending->FirstMip = FirstMip;
+    ++LoadsInFlight;
+
+    FTextureEntry* EntryPtr = &Entry;
+    const auto Load = [this, EntryPtr]()
+    {
+        FPendingLoad& Pending = *EntryPtr->Pending;
+        FTextureUploadBatch Batch(*TextureLoader);
+        ComPtr<ID3D12Resource> Texture;
+        if (!TextureLoader->LoadTextureMips(EntryPtr->DdsPath, Pending.FirstMip, Texture, &Batch, EntryPtr->bUseSRGB))
+        {
+            return;
+        }
+
+        Pending.FenceValue = Batch.Submit();
+        Pending.Texture = std::move(Texture);
+    };
+
+    if (FTaskScheduler::Get().IsRunning())
+    {
+        Entry.Pending->Task = FTaskScheduler::Get().ScheduleTask(Load, ETaskPriority::Background);
+    }
+    else
+    {
+        Load();
+    }
+}
+
+void FTextureMipStreamer::FinishLoads()
+{
+    FDX12UploadQueue* UploadQueue = Device ? Device->GetUploadQueue() : nullptr;
+    bool bSwapped = false;
+    for (const std::unique_ptr<FTextureEntry>& EntryPtr : Entries)
+    {
+        FTextureEntry& Entry = *EntryPtr;
+        if (!Entry.Pending || (Entry.Pending->Task && !Entry.Pending->Task->IsComplete()))
+        {
+            continue;
+        }
+
+        std::unique_ptr<FPendingLoad>& Pending = Entry.Pending;
+        if (!Pending->Texture)
+        {
+            LogWarning("Failed to stream mips of " + std::filesystem::path(Entry.DdsPath).filename().string());
+            Entry.bFailed = true;
+            Pending.reset();
+            --LoadsInFlight;
+            continue;
+        }
+
+        if (!UploadQueue || !UploadQueue->IsComplete(Pending->FenceValue))
+        {
+            continue;
+        }
+
+        ResidentBytes -= Entry.ChainBytes[Entry.ResidentMip];
+        ResidentBytes += Entry.ChainBytes[Pending->FirstMip];
+        RetiredTextures.push_back({ std::move(Entry.Texture), 0 });
+        Entry.Texture = std::move(Pending->Texture);
+        Entry.ResidentMip = Pending->FirstMip;
+        Pending.reset();
+        --LoadsInFlight;
+        bSwapped = true;
+
+        for (const FTextureUser& User : Entry.Users)
+        {
+            FModelState& Model = Models[User.ModelIndex];
+            if (Model.bResident)
+            {
+                GetSlot(Model.Textures, User.Slot) = Entry.Texture;
+                Model.bChanged = true;
+            }
+        }
+    }
+
+    if (bSwapped)
+    {
+        UploadQueue->ReleaseCompleted();
+    }
+}
+
+void FTextureMipStreamer::CollectSwaps(std::vector<FStreamedModelTextures>& OutChanged)
+{
+    for (FModelState& Model : Models)
+    {
+        if (Model.bChanged)
+        {
+            OutChanged.push_back(Model.Textures);
+            Model.bChanged = false;
+        }
+    }
+}
+
+void FTextureMipStreamer::OnFrameFenceSignaled(uint64_t FenceValue)
+{
+    for (FRetiredTexture& Retired : RetiredTextures)
+    {
+        if (Retired.FrameFenceValue == 0)
+        {
+            Retired.FrameFenceValue = FenceValue;
+        }
+    }
+}
+
+void FTextureMipStreamer::ReleaseRetired()
+{
+    FDX12CommandQueue* GraphicsQueue = Device ? Device->GetGraphicsQueue() : nullptr;
+    if (!GraphicsQueue)
+    {
+        return;
+    }
+
+    const uint64_t CompletedFenceValue = GraphicsQueue->GetCompletedFenceValue();
+    RetiredTextures.erase(
+        std::remove_if(RetiredTextures.begin(), RetiredTextures.end(), [CompletedFenceValue](const FRetiredTexture& Retired)
+        {
+            return Retired.FrameFenceValue != 0 && Retired.FrameFenceValue <= CompletedFenceValue;
+        }),
+        RetiredTextures.end());
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TextureStreamer.h"
+#include "../Core/TaskSystem.h"
+
+class FDX12Device;
+class FTextureLoader;
+
+/**
+ * Keeps streamed scene textures at the mips their on-screen size needs, within a video memory
+ * budget. Maps with a DDS chain (their own file or the cooked one of an earlier run) first load
+ * only their tail, the mips of at most TailSize texels. Update then picks a first mip per texture
+ * from the largest projected size among the visible models using it and reloads finer chains on
+ * background tasks through the upload queue; updated models are handed out by CollectSwaps for
+ * the renderer to rebind.
+ * The budget is what DXGI grants the process minus everything this class does not own. When the
+ * wanted mips do not fit, every texture gives up the same number of mips, and textures holding
+ * more than that are reloaded smaller until the resident total fits again. Textures of models
+ * that left the view keep their mips until the budget needs them.
+ */
+class FTextureMipStreamer
+{
+public:
+    static constexpr uint32_t TailSize = 128;
+    static constexpr uint32_t MaxLoadsInFlight = 8;
+
+    // BudgetOverrideBytes caps the device budget; 0 uses the device budget alone.
+    FTextureMipStreamer(FDX12Device* InDevice, FTextureLoader* InTextureLoader, uint64_t InBudgetOverrideBytes);
+    // Waits for outstanding loads and their copies.
+    ~FTextureMipStreamer();
+
+    FTextureMipStreamer(const FTextureMipStreamer&) = delete;
+    FTextureMipStreamer& operator=(const FTextureMipStreamer&) = delete;
+
+    /**
+     * Registers a map of a scene model and returns where its first load should come from.
+     * Maps without a chain to stream (no cooked file yet, cubemaps, arrays, small images) load whole.
+     * @param Slot Map index in FStreamedModelTextures order: base color, metallic-roughness, normal, emissive
+     */
+    FStreamedTextureSource Register(uint32_t ModelIndex, uint32_t Slot, const std::wstring& Path, bool bUseSRGB, bool bNormalMap);
+
+    // Takes over the maps a model first became resident with. Maps another model already streamed
+    // finer are replaced by that texture, so shared maps stay one texture.
+    void OnModelResident(FStreamedModelTextures& Textures);
+
+    /**
+     * Swaps in finished loads, picks the mips each texture should hold and starts new loads.
+     * @param ModelScreenSizes Projected diameter in pixels per scene model, 0 for models outside the view
+     */
+    void Update(const std::vector<float>& ModelScreenSizes);
+
+    // Appends the complete maps of every model whose textures changed since the last call.
+    void CollectSwaps(std::vector<FStreamedModelTextures>& OutChanged);
+
+    // Textures replaced since the previous call may still be read by the frame behind FenceValue
+    // on the graphics queue; they are released once it completes.
+    void OnFrameFenceSignaled(uint64_t FenceValue);
+
+    uint64_t GetResidentBytes() const { return ResidentBytes; }
+
+private:
+    static constexpr uint32_t InvalidEntry = ~0u;
+
+    struct FTextureUser
+    {
+        uint32_t ModelIndex = 0;
+        uint32_t Slot = 0;
+    };
+
+    struct FPendingLoad
+    {
+        FTaskRef Task;
+        uint32_t FirstMip = 0;
+        // Written by the task; null when the load failed.
+        Microsoft::WRL::ComPtr<ID3D12Resource> Texture;
+        uint64_t FenceValue = 0;
+    };
+
+    struct FTextureEntry
+    {
+        std::wstring DdsPath;
+        bool bUseSRGB = false;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t MipCount = 0;
+        uint32_t TailMip = 0;
+        // Allocation size of the chain starting at each mip up to TailMip; 0 for mips a block
+        // compressed texture cannot start at.
+        std::vector<uint64_t> ChainBytes;
+        std::vector<FTextureUser> Users;
+
+        Microsoft::WRL::ComPtr<ID3D12Resource> Texture;
+        uint32_t ResidentMip = 0;
+        std::unique_ptr<FPendingLoad> Pending;
+        // A load of this texture failed; it keeps whatever it holds.
+        bool bFailed = false;
+
+        // Per Update.
+        float ScreenSize = 0.0f;
+        uint32_t WantedMip = 0;
+    };
+
+    struct FModelState
+    {
+        FStreamedModelTextures Textures;
+        uint32_t Entries[4] = { InvalidEntry, InvalidEntry, InvalidEntry, InvalidEntry };
+        bool bResident = false;
+        bool bChanged = false;
+    };
+
+    struct FRetiredTexture
+    {
+        Microsoft::WRL::ComPtr<ID3D12Resource> Texture;
+        // Graphics queue fence after which no frame reads Texture; 0 until the next frame fence.
+        uint64_t FrameFenceValue = 0;
+    };
+
+    static Microsoft::WRL::ComPtr<ID3D12Resource>& GetSlot(FStreamedModelTextures& Textures, uint32_t Slot);
+
+    bool ReadSource(const std::wstring& DdsPath, FTextureEntry& OutEntry) const;
+    uint64_t QueryBudget() const;
+    // FirstMip, or the nearest finer mip when a block compressed texture cannot start at it.
+    uint32_t ClampFirstMip(const FTextureEntry& Entry, uint32_t FirstMip) const;
+    void StartLoad(FTextureEntry& Entry, uint32_t FirstMip);
+    void FinishLoads();
+    void ReleaseRetired();
+
+    FDX12Device* Device = nullptr;
+    FTextureLoader* TextureLoader = nullptr;
+    uint64_t BudgetOverrideBytes = 0;
+
+    // Pointers stay stable for the load tasks.
+    std::vector<std::unique_ptr<FTextureEntry>> Entries;
+    std::unordered_map<std::wstring, uint32_t> EntryLookup;
+    std::vector<FModelState> Models;
+    std::vector<FRetiredTexture> RetiredTextures;
+    uint64_t ResidentBytes = 0;
+    uint32_t LoadsInFlight = 0;
+    uint32_t BudgetBias = 0;
+};
@@ -0,0 +1,124 @@
+#include "TextureStreamer.h"
+
+#include "TextureLoader.h"
+#include "../RHI/DX12UploadQueue.h"
+#include "../Core/Logger.h"
+
+#include <algorithm>
+
+using Microsoft::WRL::ComPtr;
+
+FTextureStreamer::FTextureStreamer(FTextureLoader* InTextureLoader, FDX12UploadQueue* InUploadQueue)
+    : TextureLoader(InTextureLoader)
+    , UploadQueue(InUploadQueue)
+{
+}
+
+FTextureStreamer::~FTextureStreamer()
+{
+    bCancelled.store(true, std::memory_order_relaxed);
+
+    uint64_t LastFenceValue = 0;
+    for (const std::unique_ptr<FPendingModel>& Model : PendingModels)
+    {
+        if (Model->Task)
+        {
+            FTaskScheduler::Get().WaitForTask(Model->Task);
+        }
+        LastFenceValue = (std::max)(LastFenceValue, Model->FenceValue);
+    }
+
+    // Copies into textures that were never handed out must land before they are released.
+    if (UploadQueue && LastFenceValue > 0)
+    {
+        UploadQueue->WaitOnCpu(LastFenceValue);
+    }
+}
+
+void FTextureStreamer::Enqueue(uint32_t ModelIndex, const FStreamedTextureSource (&Sources)[4])
+{
+    std::unique_ptr<FPendingModel> Model = std::make_unique<FPendingModel>();
+    Model->Textures.ModelIndex = ModelIndex;
+    for (uint32_t Slot = 0; Slot < 4; ++Slot)
+    {
+        Model->Sources[Slot] = Sources[Slot];
+    }
+
+    FPendingModel* ModelPtr = Model.get();
+    if (FTaskScheduler::Get().IsRunning())
+    {
+        Model->Task = FTaskScheduler::Get().ScheduleTask([this, ModelPtr]() { LoadModel(*ModelPtr); }, ETaskPriority::Background);
+    }
+    else
+    {
+        LoadModel(*ModelPtr);
+    }
+
+    PendingModels.push_back(std::move(Model));
+}
+
+void FTextureStreamer::LoadModel(FPendingModel& Model)
+{
+    ComPtr<ID3D12Resource>* Targets[4] =
+    {
+        &Model.Textures.BaseColor,
+        &Model.Textures.MetallicRoughness,
+        &Model.Textures.Normal,
+        &Model.Textures.Emissive,
+    };
+    constexpr bool bUseSRGB[4] = { true, false, false, true };
+    constexpr bool bNormalMap[4] = { false, false, true, false };
+
+    FTextureUploadBatch Batch(*TextureLoader);
+    for (uint32_t Slot = 0; Slot < 4; ++Slot)
+    {
+        if (bCancelled.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        const FStreamedTextureSource& Source = Model.Sources[Slot];
+        if (Source.Path.empty())
+        {
+            continue;
+        }
+        if (Source.TailMip > 0 && TextureLoader->LoadTextureTail(Source.TailPath, Source.TailMip, *Targets[Slot], &Batch, bUseSRGB[Slot]))
+        {
+            continue;
+        }
+        if (!TextureLoader->LoadOrDefault(Source.Path, *Targets[Slot], &Batch, bUseSRGB[Slot], bNormalMap[Slot]))
+        {
+            LogWarning("Failed to stream texture for scene model " + std::to_string(Model.Textures.ModelIndex));
+        }
+    }
+
+    Model.FenceValue = Batch.Submit();
+    if (Model.FenceValue == 0)
+    {
+        // Every map came from the texture cache, which only holds textures whose copy was
+        // submitted before they were published; the copy queue completes fences in order.
+        Model.FenceValue = UploadQueue->GetLastSubmittedFenceValue();
+    }
+}
+
+void FTextureStreamer::CollectResident(std::vector<FStreamedModelTextures>& OutResident)
+{
+    const size_t FirstResident = OutResident.size();
+    for (size_t Index = 0; Index < PendingModels.size();)
+    {
+        FPendingModel& Model = *PendingModels[Index];
+        if ((Model.Task && !Model.Task->IsComplete()) || !UploadQueue->IsComplete(Model.FenceValue))
+        {
+            ++Index;
+            continue;
+        }
+
+        OutResident.push_back(std::move(Model.Textures));
+        PendingModels[Index] = std::move(PendingModels.back());
+        PendingModels.pop_back();
+    }
+
+    if (OutResident.size() > FirstResident)
+    {
+        UploadQueue->ReleaseCompleted();
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../Core/TaskSystem.h"
+
+class FTextureLoader;
+class FDX12UploadQueue;
+
+// Material maps of one scene model; maps the model has no path for stay null.
+struct FStreamedModelTextures
+{
+    uint32_t ModelIndex = 0;
+    Microsoft::WRL::ComPtr<ID3D12Resource> BaseColor;
+    Microsoft::WRL::ComPtr<ID3D12Resource> MetallicRoughness;
+    Microsoft::WRL::ComPtr<ID3D12Resource> Normal;
+    Microsoft::WRL::ComPtr<ID3D12Resource> Emissive;
+};
+
+// Where a map of a model loads from. A TailMip above 0 loads only the chain of TailPath from that
+// mip down, see FTextureMipStreamer; Path is loaded whole when that fails.
+struct FStreamedTextureSource
+{
+    std::wstring Path;
+    std::wstring TailPath;
+    uint32_t TailMip = 0;
+};
+
+/**
+ * Loads scene model textures on background tasks while the renderer already draws the scene.
+ * Each model is one task that decodes its maps and submits their copies to the upload queue;
+ * CollectResident hands a model over once the copy queue has finished with all of them, so
+ * callers can bind the textures without any GPU wait.
+ */
+class FTextureStreamer
+{
+public:
+    FTextureStreamer(FTextureLoader* InTextureLoader, FDX12UploadQueue* InUploadQueue);
+    ~FTextureStreamer();
+
+    FTextureStreamer(const FTextureStreamer&) = delete;
+    FTextureStreamer& operator=(const FTextureStreamer&) = delete;
+
+    // Sources are indexed like the maps of FStreamedModelTextures.
+    void Enqueue(uint32_t ModelIndex, const FStreamedTextureSource (&Sources)[4]);
+
+    // Moves out the models whose uploads completed since the last call, in no particular order.
+    void CollectResident(std::vector<FStreamedModelTextures>& OutResident);
+
+    bool IsIdle() const { return PendingModels.empty(); }
+    size_t GetPendingCount() const { return PendingModels.size(); }
+
+private:
+    struct FPendingModel
+    {
+        FStreamedModelTextures Textures;
+        FStreamedTextureSource Sources[4];
+        FTaskRef Task;
+        // Upload fence covering every map; valid once the task completed.
+        uint64_t FenceValue = 0;
+    };
+
+    void LoadModel(FPendingModel& Model);
+
+    FTextureLoader* TextureLoader = nullptr;
+    FDX12UploadQueue* UploadQueue = nullptr;
+    std::vector<std::unique_ptr<FPendingModel>> PendingModels;
+    std::atomic<bool> bCancelled{ false };
+};
@@ -0,0 +1,288 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "TextureUploadBatch.h"
+
+#include "TextureLoader.h"
+#include "../RHI/DX12Commons.h"
+#include "../RHI/DX12Device.h"
+#include "../Core/Logger.h"
+
+#include <algorithm>
+
+using Microsoft::WRL::ComPtr;
+
+FTextureUploadBatch::FTextureUploadBatch(FTextureLoader& InLoader)
+    : Loader(InLoader)
+    , Device(InLoader.Device)
+{
+}
+
+FTextureUploadBatch::~FTextureUploadBatch()
+{
+    Submit();
+}
+
+FTextureStagingAllocation FTextureUploadBatch::AllocateStaging(uint64_t Size)
+{
+    FTextureStagingAllocation Allocation;
+    if (Device == nullptr || Size == 0)
+    {
+        return Allocation;
+    }
+
+    constexpr uint64_t Alignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+    const uint64_t AlignedSize = (Size + Alignment - 1) & ~(Alignment - 1);
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    ThrottleLocked(AlignedSize);
+    UnsubmittedBytes += AlignedSize;
+
+    if (AlignedSize > PageSize)
+    {
+        uint8_t* Data = nullptr;
+        if (CreatePage(AlignedSize, Allocation.Page, Data))
+        {
+            Allocation.CpuAddress = Data;
+        }
+        return Allocation;
+    }
+
+    if (!CurrentPage || CurrentPageOffset + AlignedSize > CurrentPageSize)
+    {
+        // The previous page is released once every allocation in it was recorded and submitted.
+        CurrentPage.Reset();
+        CurrentPageData = nullptr;
+        CurrentPageSize = (std::max)(NextPageSize, AlignedSize);
+        CurrentPageOffset = 0;
+        NextPageSize = (std::min)(CurrentPageSize * 2, PageSize);
+        if (!CreatePage(CurrentPageSize, CurrentPage, CurrentPageData))
+        {
+            return Allocation;
+        }
+    }
+
+    Allocation.Page = CurrentPage;
+    Allocation.Offset = CurrentPageOffset;
+    Allocation.CpuAddress = CurrentPageData + CurrentPageOffset;
+    CurrentPageOffset += AlignedSize;
+    return Allocation;
+}
+
+bool FTextureUploadBatch::RecordUpload(
+    ID3D12Resource* Texture,
+    const FTextureStagingAllocation& Staging,
+    const D3D12_PLACED_SUBRESOURCE_FOOTPRINT* Layouts,
+    UINT FirstSubresource,
+    UINT Count,
+    bool bTextureInCommon,
+    FMipGenerationJob MipJob)
+{
+    if (Texture == nullptr || !Staging.IsValid())
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (!bSegmentOpen && !OpenSegmentLocked())
+    {
+        return false;
+    }
+
+    ID3D12GraphicsCommandList* CommandList = Segment.CommandList.Get();
+    ID3D12Resource* CopyTarget = MipJob.IsPending() ? MipJob.Scratch.Get() : Texture;
+    const bool bCopyQueue = Device->GetUploadQueue()->IsCopyQueue();
+
+    D3D12_RESOURCE_BARRIER Barrier = {};
+    Barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    Barrier.Transition.pResource = CopyTarget;
+    Barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+
+    if (bTextureInCommon && !bCopyQueue)
+    {
+        Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COMMON;
+        Barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+        CommandList->ResourceBarrier(1, &Barrier);
+    }
+
+    for (UINT Index = 0; Index < Count; ++Index)
+    {
+        D3D12_TEXTURE_COPY_LOCATION DstLocation = {};
+        DstLocation.pResource = CopyTarget;
+        DstLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        DstLocation.SubresourceIndex = FirstSubresource + Index;
+
+        D3D12_TEXTURE_COPY_LOCATION SrcLocation = {};
+        SrcLocation.pResource = Staging.Page.Get();
+        SrcLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        SrcLocation.PlacedFootprint = Layouts[Index];
+        SrcLocation.PlacedFootprint.Offset += Staging.Offset;
+
+        CommandList->CopyTextureRegion(&DstLocation, 0, 0, 0, &SrcLocation, nullptr);
+    }
+
+    // A scratch texture is left in COMMON either way for the compute queue to pick up. Other textures
+    // end readable by every shader stage, as COMMON promotes them on a copy queue.
+    if (!bCopyQueue)
+    {
+        Barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+        Barrier.Transition.StateAfter = MipJob.IsPending()
+            ? D3D12_RESOURCE_STATE_COMMON
+            : D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+        CommandList->ResourceBarrier(1, &Barrier);
+    }
+
+    // Consecutive allocations usually share a page; one reference per run is enough.
+    if (Segment.KeepAlive.empty() || Segment.KeepAlive.back().Get() != Staging.Page.Get())
+    {
+        Segment.KeepAlive.push_back(Staging.Page);
+    }
+    if (MipJob.IsPending())
+    {
+        Segment.KeepAlive.push_back(MipJob.Scratch);
+        Segment.MipJobs.push_back(std::move(MipJob));
+        Segment.MipTargets.push_back(Texture);
+    }
+
+    if (UnsubmittedBytes >= SegmentBytes)
+    {
+        SubmitSegmentLocked();
+    }
+    return true;
+}
+
+void FTextureUploadBatch::DeferPublish(const FTextureCacheKey& Key, const ComPtr<ID3D12Resource>& Texture)
+{
+    if (!Key.IsValid() || !Texture)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (bSegmentOpen)
+    {
+        Segment.Publishes.emplace_back(Key, Texture);
+        return;
+    }
+
+    // Every copy recorded so far has been submitted, including this texture's.
+    Loader.PublishTexture(Key, Texture);
+}
+
+uint64_t FTextureUploadBatch::Submit()
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (bSegmentOpen)
+    {
+        SubmitSegmentLocked();
+    }
+    return LastFenceValue;
+}
+
+bool FTextureUploadBatch::OpenSegmentLocked()
+{
+    if (!Device->GetUploadQueue()->CreateCommandList(Segment.Allocator, Segment.CommandList))
+    {
+        LogError("Failed to create a texture upload command list");
+        return false;
+    }
+
+    bSegmentOpen = true;
+    return true;
+}
+
+void FTextureUploadBatch::SubmitSegmentLocked()
+{
+    FDX12UploadQueue* UploadQueue = Device->GetUploadQueue();
+
+    HR_CHECK(Segment.CommandList->Close());
+    ID3D12CommandList* Lists[] = { Segment.CommandList.Get() };
+    Segment.KeepAlive.push_back(Segment.Allocator);
+    Segment.KeepAlive.push_back(Segment.CommandList);
+
+    // Staging pages and allocators stay alive until the upload fence completes; renderers make
+    // the graphics queue wait on it before first use instead of flushing here.
+    uint64_t FenceValue = UploadQueue->Submit(1, Lists, std::move(Segment.KeepAlive));
+    if (!Segment.MipJobs.empty())
+    {
+        FenceValue = Loader.MipGenerator->Submit(Segment.MipJobs.data(), Segment.MipTargets.data(), static_cast<uint32_t>(Segment.MipJobs.size()), FenceValue);
+    }
+
+    for (const auto& Publish : Segment.Publishes)
+    {
+        Loader.PublishTexture(Publish.first, Publish.second);
+    }
+
+    SubmittedSegments.push_back({ FenceValue, UnsubmittedBytes });
+    BytesInFlight += UnsubmittedBytes;
+    UnsubmittedBytes = 0;
+    LastFenceValue = FenceValue;
+
+    Segment = FSegment();
+    bSegmentOpen = false;
+}
+
+void FTextureUploadBatch::ThrottleLocked(uint64_t Size)
+{
+    FDX12UploadQueue* UploadQueue = Device->GetUploadQueue();
+    while (!SubmittedSegments.empty())
+    {
+        const FSubmittedSegment& Oldest = SubmittedSegments.front();
+        if (!UploadQueue->IsComplete(Oldest.FenceValue))
+        {
+            if (BytesInFlight + UnsubmittedBytes + Size <= MaxBytesInFlight)
+            {
+                break;
+            }
+            // Releases the segment's pages along with everything else the fence covers.
+            UploadQueue->WaitOnCpu(Oldest.FenceValue);
+        }
+
+        BytesInFlight -= Oldest.StagedBytes;
+        SubmittedSegments.pop_front();
+    }
+}
+
+bool FTextureUploadBatch::CreatePage(uint64_t Size, ComPtr<ID3D12Resource>& OutPage, uint8_t*& OutData) const
+{
+    D3D12_HEAP_PROPERTIES UploadHeap = {};
+    UploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
+    UploadHeap.CreationNodeMask = 1;
+    UploadHeap.VisibleNodeMask = 1;
+
+    D3D12_RESOURCE_DESC UploadDesc = {};
+    UploadDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    UploadDesc.Width = Size;
+    UploadDesc.Height = 1;
+    UploadDesc.DepthOrArraySize = 1;
+    UploadDesc.MipLevels = 1;
+    UploadDesc.Format = DXGI_FORMAT_UNKNOWN;
+    UploadDesc.SampleDesc.Count = 1;
+    UploadDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+    if (FAILED(Device->CreateCommittedResource(
+        EGpuMemoryCategory::Upload,
+        &UploadHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &UploadDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(OutPage.ReleaseAndGetAddressOf()))))
+    {
+        LogError("Failed to create a texture staging page of " + std::to_string(Size >> 20) + " MB");
+        return false;
+    }
+    OutPage->SetName(L"TextureStagingPage");
+
+    // Upload heaps stay mapped for their lifetime; the CPU never reads them back.
+    D3D12_RANGE EmptyRange = { 0, 0 };
+    void* Data = nullptr;
+    if (FAILED(OutPage->Map(0, &EmptyRange, &Data)))
+    {
+        OutPage.Reset();
+        return false;
+    }
+    OutData = static_cast<uint8_t*>(Data);
+    return true;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "MipGenerator.h"
+#include "TextureCache.h"
+
+class FDX12Device;
+class FTextureLoader;
+
+// Staging space of one texture inside a batch page; the page stays referenced until it is recorded.
+struct FTextureStagingAllocation
+{
+    Microsoft::WRL::ComPtr<ID3D12Resource> Page;
+    uint64_t Offset = 0;
+    uint8_t* CpuAddress = nullptr;
+
+    bool IsValid() const { return CpuAddress != nullptr; }
+};
+
+/**
+ * Texture uploads recorded by many loads into shared staging pages and command lists. Loads
+ * suballocate staging memory from persistently mapped upload pages and record their
+ * copies into the open segment, one command list shared by every load. A segment is submitted to
+ * the upload queue once it staged SegmentBytes, with the mip generations recorded into it behind,
+ * and its pages are released by that fence. Allocations wait for the oldest submitted segment
+ * while more than MaxBytesInFlight are staged, which bounds the memory a large scene load holds.
+ * Textures recorded into a segment are published to the texture cache when it is submitted.
+ * All methods are thread-safe.
+ */
+class FTextureUploadBatch
+{
+public:
+    // The first page fits the first allocation and each next one doubles up to PageSize, so batches
+    // of a few small textures stay small.
+    static constexpr uint64_t PageSize = 32ull << 20;
+    static constexpr uint64_t SegmentBytes = 128ull << 20;
+    static constexpr uint64_t MaxBytesInFlight = 384ull << 20;
+
+    explicit FTextureUploadBatch(FTextureLoader& InLoader);
+    // Submits the open segment.
+    ~FTextureUploadBatch();
+
+    FTextureUploadBatch(const FTextureUploadBatch&) = delete;
+    FTextureUploadBatch& operator=(const FTextureUploadBatch&) = delete;
+
+    // Size bytes aligned for placed footprints; allocations larger than PageSize get a page of their own.
+    FTextureStagingAllocation AllocateStaging(uint64_t Size);
+
+    /**
+     * Records copies of Count subresources from Staging into the texture, with the transitions the
+     * upload queue needs around them. Copy lists cannot transition to shader states; on a copy
+     * queue the texture decays to COMMON once the copy is done and is promoted on its first read.
+     * @param Layouts Footprints of subresources FirstSubresource onwards, offsets relative to Staging
+     * @param bTextureInCommon The texture was created in COMMON rather than COPY_DEST
+     * @param MipJob When pending, the copies fill its scratch texture, left in COMMON, and Texture
+     *               receives the generated chain
+     */
+    bool RecordUpload(
+        ID3D12Resource* Texture,
+        const FTextureStagingAllocation& Staging,
+        const D3D12_PLACED_SUBRESOURCE_FOOTPRINT* Layouts,
+        UINT FirstSubresource,
+        UINT Count,
+        bool bTextureInCommon,
+        FMipGenerationJob MipJob = {});
+
+    // Inserts the texture into the cache once the segment holding its copies has been submitted.
+    void DeferPublish(const FTextureCacheKey& Key, const Microsoft::WRL::ComPtr<ID3D12Resource>& Texture);
+
+    /**
+     * Submits the open segment; recording may continue into a new one afterwards.
+     * @return Upload queue fence covering every copy and mip generation recorded so far, 0 if none
+     */
+    uint64_t Submit();
+
+private:
+    struct FSegment
+    {
+        Microsoft::WRL::ComPtr<ID3D12CommandAllocator> Allocator;
+        Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> CommandList;
+        std::vector<Microsoft::WRL::ComPtr<IUnknown>> KeepAlive;
+        std::vector<FMipGenerationJob> MipJobs;
+        std::vector<ID3D12Resource*> MipTargets;
+        std::vector<std::pair<FTextureCacheKey, Microsoft::WRL::ComPtr<ID3D12Resource>>> Publishes;
+    };
+
+    struct FSubmittedSegment
+    {
+        uint64_t FenceValue = 0;
+        uint64_t StagedBytes = 0;
+    };
+
+    bool OpenSegmentLocked();
+    void SubmitSegmentLocked();
+    // Waits for submitted segments until Size more bytes fit under MaxBytesInFlight.
+    void ThrottleLocked(uint64_t Size);
+    bool CreatePage(uint64_t Size, Microsoft::WRL::ComPtr<ID3D12Resource>& OutPage, uint8_t*& OutData) const;
+
+    FTextureLoader& Loader;
+    FDX12Device* Device = nullptr;
+
+    std::mutex Mutex;
+    FSegment Segment;
+    bool bSegmentOpen = false;
+    // Bytes allocated since the last submission.
+    uint64_t UnsubmittedBytes = 0;
+
+    Microsoft::WRL::ComPtr<ID3D12Resource> CurrentPage;
+    uint8_t* CurrentPageData = nullptr;
+    uint64_t CurrentPageSize = 0;
+    uint64_t CurrentPageOffset = 0;
+    uint64_t NextPageSize = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+
+    std::deque<FSubmittedSegment> SubmittedSegments;
+    uint64_t BytesInFlight = 0;
+    uint64_t LastFenceValue = 0;
+};
@@ -0,0 +1,343 @@
+#include "VariableRateShading.h"
+
+#include "RendererUtils.h"
+#include "ShaderCompiler.h"
+#include "../RHI/DX12Commons.h"
+#include "../RHI/DX12Device.h"
+#include "../Core/Logger.h"
+
+#include <algorithm>
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+    struct FShadingRatePreset
+    {
+        float ContrastThreshold = 0.0f;
+        float MotionScale = 0.0f;
+        bool bAllowAdditionalRates = false;
+    };
+
+    FShadingRatePreset GetShadingRatePreset(EShadingRateQuality Quality)
+    {
+        switch (Quality)
+        {
+        case EShadingRateQuality::Quality:
+            return { 0.015f, 0.05f, false };
+        case EShadingRateQuality::Performance:
+            return { 0.05f, 0.15f, true };
+        case EShadingRateQuality::Balanced:
+        default:
+            return { 0.03f, 0.1f, false };
+        }
+    }
+}
+
+bool FVariableRateShading::Initialize(FDX12Device* Device, uint32_t Width, uint32_t Height, DXGI_FORMAT InOverlayFormat, const FDX12DescriptorRange& InDescriptors)
+{
+    RateImage.Reset();
+    bRateImageValid = false;
+    bMotionHistoryValid = false;
+    if (!Device || !Device->SupportsShadingRateImage())
+    {
+        return false;
+    }
+
+    if (InDescriptors.Count < DescriptorCount)
+    {
+        LogError("Variable rate shading needs " + std::to_string(DescriptorCount) + " descriptors");
+        return false;
+    }
+
+    Descriptors = InDescriptors;
+    OverlayFormat = InOverlayFormat;
+    TileSize = Device->GetShadingRateImageTileSize();
+    bAdditionalRates = Device->SupportsAdditionalShadingRates();
+    if (!CreateRootSignature(Device) || !CreatePipelines(Device) || !CreateRateImage(Device, Width, Height))
+    {
+        RateImage.Reset();
+        return false;
+    }
+
+    LogInfo("Variable rate shading: " + std::to_string(RateImageWidth) + "x" + std::to_string(RateImageHeight) + " rate image");
+    return true;
+}
+
+bool FVariableRateShading::CreateRootSignature(FDX12Device* Device)
+{
+    D3D12_DESCRIPTOR_RANGE1 Ranges[5] = {};
+    for (uint32_t Index = 0; Index < _countof(Ranges); ++Index)
+    {
+        Ranges[Index].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+        Ranges[Index].NumDescriptors = 1;
+        Ranges[Index].BaseShaderRegister = Index;
+        Ranges[Index].RegisterSpace = 0;
+        Ranges[Index].Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
+        Ranges[Index].OffsetInDescriptorsFromTableStart = 0;
+    }
+    // The fourth range is the rate image UAV; the last one its SRV at t3.
+    Ranges[3].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+    Ranges[3].BaseShaderRegister = 0;
+    Ranges[4].BaseShaderRegister = 3;
+
+    D3D12_ROOT_PARAMETER1 RootParams[7] = {};
+    // RootParams[0]: View constants (b0)
+    RootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    RootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[0].Descriptor.ShaderRegister = 0;
+    RootParams[0].Descriptor.RegisterSpace = 0;
+    RootParams[0].Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+
+    // RootParams[1]: Shading rate constants (b1)
+    RootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    RootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    RootParams[1].Constants.Num32BitValues = ConstantCount;
+    RootParams[1].Constants.ShaderRegister = 1;
+    RootParams[1].Constants.RegisterSpace = 0;
+
+    // RootParams[2..6]: Scene color (t0), depth (t1), exposure EV (t2), rate image UAV (u0) and SRV (t3)
+    for (uint32_t Index = 0; Index < _countof(Ranges); ++Index)
+    {
+        D3D12_ROOT_PARAMETER1& Param = RootParams[2 + Index];
+        Param.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+        Param.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+        Param.DescriptorTable.NumDescriptorRanges = 1;
+        Param.DescriptorTable.pDescriptorRanges = &Ranges[Index];
+    }
+
+    D3D12_VERSIONED_ROOT_SIGNATURE_DESC RootSigDesc = {};
+    RootSigDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
+    RootSigDesc.Desc_1_1.NumParameters = _countof(RootParams);
+    RootSigDesc.Desc_1_1.pParameters = RootParams;
+    RootSigDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE;
+
+    ComPtr<ID3DBlob> SerializedSig;
+    ComPtr<ID3DBlob> ErrorBlob;
+    if (FAILED(D3D12SerializeVersionedRootSignature(&RootSigDesc, SerializedSig.GetAddressOf(), ErrorBlob.GetAddressOf())))
+    {
+        if (ErrorBlob)
+        {
+            LogError(static_cast<const char*>(ErrorBlob->GetBufferPointer()));
+        }
+        return false;
+    }
+
+    HR_CHECK(Device->GetPipelineCache()->CreateRootSignature(SerializedSig->GetBufferPointer(), SerializedSig->GetBufferSize(), RootSignature.ReleaseAndGetAddressOf()));
+    return RootSignature != nullptr;
+}
+
+bool FVariableRateShading::CreatePipelines(FDX12Device* Device)
+{
+    if (!Device || !RootSignature)
+    {
+        return false;
+    }
+
+    FShaderCompiler Compiler;
+    std::vector<uint8_t> CSByteCode;
+    std::vector<uint8_t> VSByteCode;
+    std::vector<uint8_t> PSByteCode;
+    if (!Compiler.CompileFromFile(L"Shaders/ShadingRate.hlsl", L"BuildShadingRate", RendererUtils::BuildShaderTarget(L"cs", Device->GetShaderModel()), CSByteCode)
+        || !Compiler.CompileFromFile(L"Shaders/ShadingRate.hlsl", L"OverlayVS", RendererUtils::BuildShaderTarget(L"vs", Device->GetShaderModel()), VSByteCode)
+        || !Compiler.CompileFromFile(L"Shaders/ShadingRate.hlsl", L"OverlayPS", RendererUtils::BuildShaderTarget(L"ps", Device->GetShaderModel()), PSByteCode))
+    {
+        LogError("Failed to compile shading rate shaders");
+        return false;
+    }
+
+    D3D12_COMPUTE_PIPELINE_STATE_DESC BuildDesc = {};
+    BuildDesc.pRootSignature = RootSignature.Get();
+    BuildDesc.CS = { CSByteCode.data(), CSByteCode.size() };
+
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC OverlayDesc = {};
+    OverlayDesc.pRootSignature = RootSignature.Get();
+    OverlayDesc.VS = { VSByteCode.data(), VSByteCode.size() };
+    OverlayDesc.PS = { PSByteCode.data(), PSByteCode.size() };
+    OverlayDesc.BlendState.RenderTarget[0].BlendEnable = TRUE;
+    OverlayDesc.BlendState.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
+    OverlayDesc.BlendState.RenderTarget[0].DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+    OverlayDesc.BlendState.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
+    OverlayDesc.BlendState.RenderTarget[0].SrcBlendAlpha = D3D12_BLEND_ZERO;
+    OverlayDesc.BlendState.RenderTarget[0].DestBlendAlpha = D3D12_BLEND_ONE;
+    OverlayDesc.BlendState.RenderTarget[0].BlendOpAlpha = D3D12_BLEND_OP_ADD;
+    OverlayDesc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+    OverlayDesc.SampleMask = UINT_MAX;
+    OverlayDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+    OverlayDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+    OverlayDesc.RasterizerState.DepthClipEnable = TRUE;
+    OverlayDesc.DepthStencilState.DepthEnable = FALSE;
+    OverlayDesc.DepthStencilState.StencilEnable = FALSE;
+    OverlayDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    OverlayDesc.NumRenderTargets = 1;
+    OverlayDesc.RTVFormats[0] = OverlayFormat;
+    OverlayDesc.SampleDesc.Count = 1;
+
+    ComPtr<ID3D12PipelineState> NewBuildPipeline;
+    ComPtr<ID3D12PipelineState> NewOverlayPipeline;
+    if (FAILED(Device->GetPipelineCache()->CreateComputePipelineState(BuildDesc, NewBuildPipeline.GetAddressOf()))
+        || FAILED(Device->GetPipelineCache()->CreateGraphicsPipelineState(OverlayDesc, NewOverlayPipeline.GetAddressOf())))
+    {
+        LogError("Failed to create shading rate pipelines");
+        return false;
+    }
+
+    BuildPipeline = NewBuildPipeline;
+    OverlayPipeline = NewOverlayPipeline;
+    return true;
+}
+
+bool FVariableRateShading::CreateRateImage(FDX12Device* Device, uint32_t Width, uint32_t Height)
+{
+    TargetWidth = (std::max)(Width, 1u);
+    TargetHeight = (std::max)(Height, 1u);
+    RateImageWidth = (TargetWidth + TileSize - 1) / TileSize;
+    RateImageHeight = (TargetHeight + TileSize - 1) / TileSize;
+
+    D3D12_HEAP_PROPERTIES DefaultHeap = {};
+    DefaultHeap.Type = D3D12_HEAP_TYPE_DEFAULT;
+    DefaultHeap.CreationNodeMask = 1;
+    DefaultHeap.VisibleNodeMask = 1;
+
+    D3D12_RESOURCE_DESC Desc = {};
+    Desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    Desc.Width = RateImageWidth;
+    Desc.Height = RateImageHeight;
+    Desc.DepthOrArraySize = 1;
+    Desc.MipLevels = 1;
+    Desc.Format = DXGI_FORMAT_R8_UINT;
+    Desc.SampleDesc.Count = 1;
+    Desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+    Desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+    HR_CHECK(Device->CreateCommittedResource(
+        EGpuMemoryCategory::RenderTarget,
+        &DefaultHeap,
+        D3D12_HEAP_FLAG_NONE,
+        &Desc,
+        D3D12_RESOURCE_STATE_COMMON,
+        nullptr,
+        IID_PPV_ARGS(RateImage.ReleaseAndGetAddressOf())));
+    if (!RateImage)
+    {
+        LogError("Failed to create shading rate image");
+        return false;
+    }
+    RateImage->SetName(L"ShadingRateImage");
+    RateImageState = D3D12_RESOURCE_STATE_COMMON;
+
+    D3D12_UNORDERED_ACCESS_VIEW_DESC UavDesc = {};
+    UavDesc.Format = DXGI_FORMAT_R8_UINT;
+    UavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+    Device->GetDevice()->CreateUnorderedAccessView(RateImage.Get(), nullptr, &UavDesc, Descriptors.GetCpuHandle(0));
+
+    D3D12_SHADER_RESOURCE_VIEW_DESC SrvDesc = {};
+    SrvDesc.Format = DXGI_FORMAT_R8_UINT;
+    SrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    SrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    SrvDesc.Texture2D.MipLevels = 1;
+    Device->GetDevice()->CreateShaderResourceView(RateImage.Get(), &SrvDesc, Descriptors.GetCpuHandle(1));
+
+    // Null views read as zero, so a source without an exposure texture keeps its scale.
+    D3D12_SHADER_RESOURCE_VIEW_DESC NullDesc = SrvDesc;
+    NullDesc.Format = DXGI_FORMAT_R32_FLOAT;
+    Device->GetDevice()->CreateShaderResourceView(nullptr, &NullDesc, Descriptors.GetCpuHandle(2));
+    return true;
+}
+
+FShadingRateConstants FVariableRateShading::BuildConstants(const DirectX::XMMATRIX& ViewProjection, float Exposure, bool bExposureTexture, bool bDisplayReferred)
+{
+    const FShadingRatePreset Preset = GetShadingRatePreset(Quality);
+
+    FShadingRateConstants Constants;
+    Constants.PrevViewProjection = PrevViewProjection;
+    Constants.SourceWidth = TargetWidth;
+    Constants.SourceHeight = TargetHeight;
+    Constants.TileSize = TileSize;
+    Constants.Exposure = Exposure;
+    Constants.ContrastThreshold = Preset.ContrastThreshold;
+    Constants.MotionScale = Preset.MotionScale;
+    Constants.Flags =
+        (bExposureTexture ? FlagExposureTexture : 0u)
+        | (bDisplayReferred ? FlagDisplayReferred : 0u)
+        | (bAdditionalRates && Preset.bAllowAdditionalRates ? FlagAdditionalRates : 0u)
+        | (bMotionHistoryValid ? FlagMotionHistory : 0u);
+
+    DirectX::XMStoreFloat4x4(&PrevViewProjection, ViewProjection);
+    bMotionHistoryValid = true;
+    bRateImageValid = true;
+    return Constants;
+}
+
+void FVariableRateShading::Dispatch(
+    ID3D12GraphicsCommandList* CommandList,
+    D3D12_GPU_VIRTUAL_ADDRESS ViewConstantsAddress,
+    const FShadingRateConstants& Constants,
+    D3D12_GPU_DESCRIPTOR_HANDLE ColorTable,
+    D3D12_GPU_DESCRIPTOR_HANDLE DepthTable,
+    D3D12_GPU_DESCRIPTOR_HANDLE ExposureTable) const
+{
+    if (!IsActive() || !CommandList)
+    {
+        return;
+    }
+
+    CommandList->SetComputeRootSignature(RootSignature.Get());
+    CommandList->SetPipelineState(BuildPipeline.Get());
+    CommandList->SetComputeRootConstantBufferView(0, ViewConstantsAddress);
+    CommandList->SetComputeRoot32BitConstants(1, ConstantCount, &Constants, 0);
+    CommandList->SetComputeRootDescriptorTable(2, ColorTable);
+    CommandList->SetComputeRootDescriptorTable(3, DepthTable);
+    CommandList->SetComputeRootDescriptorTable(4, ExposureTable);
+    CommandList->SetComputeRootDescriptorTable(5, Descriptors.GetGpuHandle(0));
+    CommandList->SetComputeRootDescriptorTable(6, Descriptors.GetGpuHandle(1));
+    CommandList->Dispatch(RateImageWidth, RateImageHeight, 1);
+}
+
+void FVariableRateShading::Apply(ID3D12GraphicsCommandList6* CommandList) const
+{
+    if (!CommandList || !RateImage)
+    {
+        return;
+    }
+
+    // The image's rate replaces the base rate and any per-primitive one.
+    const D3D12_SHADING_RATE_COMBINER Combiners[D3D12_RS_SET_SHADING_RATE_COMBINER_COUNT] =
+    {
+        D3D12_SHADING_RATE_COMBINER_PASSTHROUGH,
+        D3D12_SHADING_RATE_COMBINER_OVERRIDE
+    };
+    CommandList->RSSetShadingRate(D3D12_SHADING_RATE_1X1, Combiners);
+    CommandList->RSSetShadingRateImage(RateImage.Get());
+}
+
+void FVariableRateShading::Reset(ID3D12GraphicsCommandList6* CommandList)
+{
+    if (!CommandList)
+    {
+        return;
+    }
+
+    CommandList->RSSetShadingRate(D3D12_SHADING_RATE_1X1, nullptr);
+    CommandList->RSSetShadingRateImage(nullptr);
+}
+
+void FVariableRateShading::DrawOverlay(ID3D12GraphicsCommandList* CommandList, const D3D12_VIEWPORT& Viewport, const D3D12_RECT& ScissorRect) const
+{
+    if (!CommandList || !OverlayPipeline || !RateImage)
+    {
+        return;
+    }
+
+    FShadingRateConstants Constants;
+    Constants.TileSize = TileSize;
+
+    CommandList->SetGraphicsRootSignature(RootSignature.Get());
+    CommandList->SetPipelineState(OverlayPipeline.Get());
+    CommandList->SetGraphicsRoot32BitConstants(1, ConstantCount, &Constants, 0);
+    CommandList->SetGraphicsRootDescriptorTable(6, Descriptors.GetGpuHandle(1));
+    CommandList->RSSetViewports(1, &Viewport);
+    CommandList->RSSetScissorRects(1, &ScissorRect);
+    CommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    CommandList->DrawInstanced(3, 1, 0, 0);
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <wrl.h>
+#include <d3d12.h>
+#include <DirectXMath.h>
+#include <cstdint>
+
+#include "../RHI/DX12DescriptorAllocator.h"
+
+class FDX12Device;
+
+// How far the shading rate image may coarsen shading. Higher presets accept more contrast in a
+// coarse tile, and Performance also uses the 4x rates where the device supports them.
+enum class EShadingRateQuality : uint32_t
+{
+    Off,
+    Quality,
+    Balanced,
+    Performance,
+};
+
+// cbuffer ShadingRateConstants (b1) in Shaders/ShadingRate.hlsl.
+struct FShadingRateConstants
+{
+    DirectX::XMFLOAT4X4 PrevViewProjection = {};
+    uint32_t SourceWidth = 0;
+    uint32_t SourceHeight = 0;
+    uint32_t TileSize = 0;
+    uint32_t Flags = 0;
+    float Exposure = 1.0f;
+    float ContrastThreshold = 0.0f;
+    float MotionScale = 0.0f;
+    float Padding = 0.0f;
+};
+
+/**
+ * Tier 2 variable rate shading from a screen-space shading rate image. Build records
+ * Shaders/ShadingRate.hlsl over the frame's final scene color and depth: tiles whose perceptual
+ * luma barely changes along an axis shade coarser along it, and camera motion raises the contrast
+ * a tile may hide, since moving detail is blurred anyway. Geometry passes of the next frame bind
+ * the image with Apply, so the rates always lag one frame behind the picture they came from.
+ */
+class FVariableRateShading
+{
+public:
+    // Rate UAV, rate SRV and a null SRV for sources without an exposure texture.
+    static constexpr uint32_t DescriptorCount = 3;
+    static constexpr uint32_t ConstantCount = sizeof(FShadingRateConstants) / sizeof(uint32_t);
+
+    // Flags of FShadingRateConstants.
+    static constexpr uint32_t FlagExposureTexture = 1u << 0;
+    static constexpr uint32_t FlagDisplayReferred = 1u << 1;
+    static constexpr uint32_t FlagAdditionalRates = 1u << 2;
+    static constexpr uint32_t FlagMotionHistory = 1u << 3;
+
+    // Creates the rate image for a Width x Height target in Descriptors, which the caller owns.
+    // Fails without tier 2 support, leaving the component inactive.
+    bool Initialize(FDX12Device* Device, uint32_t Width, uint32_t Height, DXGI_FORMAT OverlayFormat, const FDX12DescriptorRange& Descriptors);
+    bool CreatePipelines(FDX12Device* Device);
+
+    void SetQuality(EShadingRateQuality InQuality) { Quality = InQuality; }
+    EShadingRateQuality GetQuality() const { return Quality; }
+    void SetOverlayEnabled(bool bEnabled) { bOverlayEnabled = bEnabled; }
+    bool IsOverlayEnabled() const { return bOverlayEnabled; }
+
+    // Whether a rate image is built this frame.
+    bool IsActive() const { return Quality != EShadingRateQuality::Off && RateImage && BuildPipeline; }
+    // Whether an earlier frame built the image Apply binds.
+    bool IsRateImageReady() const { return IsActive() && bRateImageValid; }
+
+    ID3D12Resource* GetRateImage() const { return RateImage.Get(); }
+    D3D12_RESOURCE_STATES* GetRateImageState() { return &RateImageState; }
+    uint32_t GetRateImageWidth() const { return RateImageWidth; }
+    uint32_t GetRateImageHeight() const { return RateImageHeight; }
+    D3D12_GPU_DESCRIPTOR_HANDLE GetNullSrv() const { return Descriptors.GetGpuHandle(2); }
+
+    // Constants for this frame's build from its view projection; call once per frame that records
+    // Dispatch, after testing IsRateImageReady. Remembers ViewProjection as the next frame's
+    // previous one; Exposure scales the source color into the tonemapper's range.
+    FShadingRateConstants BuildConstants(const DirectX::XMMATRIX& ViewProjection, float Exposure, bool bExposureTexture, bool bDisplayReferred);
+
+    // Records the build. The tables hold the SRVs of the scene color (t0), the depth buffer (t1)
+    // and the exposure EV (t2); the rate image must be in UNORDERED_ACCESS. The descriptor heap
+    // must be bound.
+    void Dispatch(
+        ID3D12GraphicsCommandList* CommandList,
+        D3D12_GPU_VIRTUAL_ADDRESS ViewConstantsAddress,
+        const FShadingRateConstants& Constants,
+        D3D12_GPU_DESCRIPTOR_HANDLE ColorTable,
+        D3D12_GPU_DESCRIPTOR_HANDLE DepthTable,
+        D3D12_GPU_DESCRIPTOR_HANDLE ExposureTable) const;
+
+    // Shades the following draws at the rates of the image, which must be in SHADING_RATE_SOURCE.
+    // Reset restores full-rate shading before the list moves on to passes that do not expect it.
+    void Apply(ID3D12GraphicsCommandList6* CommandList) const;
+    static void Reset(ID3D12GraphicsCommandList6* CommandList);
+
+    // Tints the bound render target by the rate of each tile; the image must be in PIXEL_SHADER_RESOURCE.
+    void DrawOverlay(ID3D12GraphicsCommandList* CommandList, const D3D12_VIEWPORT& Viewport, const D3D12_RECT& ScissorRect) const;
+
+private:
+    bool CreateRootSignature(FDX12Device* Device);
+    bool CreateRateImage(FDX12Device* Device, uint32_t Width, uint32_t Height);
+
+    Microsoft::WRL::ComPtr<ID3D12RootSignature> RootSignature;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> BuildPipeline;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> OverlayPipeline;
+    // One D3D12_SHADING_RATE per TileSize x TileSize pixels of the target.
+    Microsoft::WRL::ComPtr<ID3D12Resource> RateImage;
+    D3D12_RESOURCE_STATES RateImageState = D3D12_RESOURCE_STATE_COMMON;
+    FDX12DescriptorRange Descriptors;
+    DXGI_FORMAT OverlayFormat = DXGI_FORMAT_UNKNOWN;
+    DirectX::XMFLOAT4X4 PrevViewProjection = {};
+    uint32_t TileSize = 0;
+    uint32_t RateImageWidth = 0;
+    uint32_t RateImageHeight = 0;
+    uint32_t TargetWidth = 0;
+    uint32_t TargetHeight = 0;
+    EShadingRateQuality Quality = EShadingRateQuality::Balanced;
+    bool bAdditionalRates = false;
+    bool bOverlayEnabled = false;
+    bool bRateImageValid = false;
+    bool bMotionHistoryValid = false;
+};
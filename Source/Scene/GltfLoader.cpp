@@ -1,264 +1,23 @@
 #include "GltfLoader.h"
+#include "JsonDocument.h"
 #include "Mesh.h"
+#include "../Core/MappedFile.h"
+#include "../Core/TaskSystem.h"
 
 #include <algorithm>
 #include <array>
-#include <cctype>
 #include <cstdint>
 #include <cmath>
 #include <cstring>
 #include <filesystem>
-#include <fstream>
-#include <map>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace
 {
-    enum class EJsonType
-    {
-        Null,
-        Bool,
-        Number,
-        String,
-        Array,
-        Object
-    };
-
-    struct FJsonValue
-    {
-        EJsonType Type = EJsonType::Null;
-        bool BoolValue = false;
-        double NumberValue = 0.0;
-        std::string StringValue;
-        std::vector<FJsonValue> ArrayValue;
-        std::map<std::string, FJsonValue> ObjectValue;
-
-        bool IsNull() const { return Type == EJsonType::Null; }
-        bool IsArray() const { return Type == EJsonType::Array; }
-        bool IsObject() const { return Type == EJsonType::Object; }
-        bool IsString() const { return Type == EJsonType::String; }
-        bool IsNumber() const { return Type == EJsonType::Number; }
-
-        const FJsonValue* Find(const std::string& Key) const
-        {
-            auto It = ObjectValue.find(Key);
-            return It != ObjectValue.end() ? &It->second : nullptr;
-        }
-    };
-
-    class FSimpleJsonParser
-    {
-    public:
-        explicit FSimpleJsonParser(const std::string& InText)
-            : Text(InText)
-        {
-        }
-
-        FJsonValue Parse()
-        {
-            Position = 0;
-            return ParseValue();
-        }
-
-    private:
-        void SkipWhitespace()
-        {
-            while (Position < Text.size() && std::isspace(static_cast<unsigned char>(Text[Position])))
-            {
-                ++Position;
-            }
-        }
-
-        bool Match(const char Expected)
-        {
-            SkipWhitespace();
-            if (Position < Text.size() && Text[Position] == Expected)
-            {
-                ++Position;
-                return true;
-            }
-            return false;
-        }
-
-        FJsonValue ParseValue()
-        {
-            SkipWhitespace();
-            if (Position >= Text.size())
-            {
-                return {};
-            }
-
-            char Ch = Text[Position];
-            if (Ch == '"')
-            {
-                return ParseString();
-            }
-            if (Ch == '{')
-            {
-                return ParseObject();
-            }
-            if (Ch == '[')
-            {
-                return ParseArray();
-            }
-            if (std::isdigit(static_cast<unsigned char>(Ch)) || Ch == '-' || Ch == '+')
-            {
-                return ParseNumber();
-            }
-            if (Text.compare(Position, 4, "true") == 0)
-            {
-                Position += 4;
-                FJsonValue V; V.Type = EJsonType::Bool; V.BoolValue = true; return V;
-            }
-            if (Text.compare(Position, 5, "false") == 0)
-            {
-                Position += 5;
-                FJsonValue V; V.Type = EJsonType::Bool; V.BoolValue = false; return V;
-            }
-            if (Text.compare(Position, 4, "null") == 0)
-            {
-                Position += 4;
-                return {};
-            }
-
-            return {};
-        }
-
-        FJsonValue ParseString()
-        {
-            FJsonValue V;
-            V.Type = EJsonType::String;
-
-            if (!Match('"'))
-            {
-                return {};
-            }
-
-            std::string Result;
-            while (Position < Text.size())
-            {
-                char Ch = Text[Position++];
-                if (Ch == '"')
-                {
-                    break;
-                }
-                // Minimal string parsing; assumes no escape sequences in provided glTF.
-                Result.push_back(Ch);
-            }
-
-            V.StringValue = Result;
-            return V;
-        }
-
-        FJsonValue ParseNumber()
-        {
-            const size_t Start = Position;
-            if (Text[Position] == '-' || Text[Position] == '+')
-            {
-                ++Position;
-            }
-            while (Position < Text.size() && std::isdigit(static_cast<unsigned char>(Text[Position])))
-            {
-                ++Position;
-            }
-            if (Position < Text.size() && Text[Position] == '.')
-            {
-                ++Position;
-                while (Position < Text.size() && std::isdigit(static_cast<unsigned char>(Text[Position])))
-                {
-                    ++Position;
-                }
-            }
-
-            if (Position < Text.size() && (Text[Position] == 'e' || Text[Position] == 'E'))
-            {
-                ++Position;
-                if (Position < Text.size() && (Text[Position] == '+' || Text[Position] == '-'))
-                {
-                    ++Position;
-                }
-                while (Position < Text.size() && std::isdigit(static_cast<unsigned char>(Text[Position])))
-                {
-                    ++Position;
-                }
-            }
-
-            const std::string NumberText = Text.substr(Start, Position - Start);
-            FJsonValue V;
-            V.Type = EJsonType::Number;
-            V.NumberValue = std::strtod(NumberText.c_str(), nullptr);
-            return V;
-        }
-
-        FJsonValue ParseArray()
-        {
-            FJsonValue V;
-            V.Type = EJsonType::Array;
-
-            if (!Match('['))
-            {
-                return {};
-            }
-
-            SkipWhitespace();
-            if (Match(']'))
-            {
-                return V;
-            }
-
-            while (Position < Text.size())
-            {
-                V.ArrayValue.push_back(ParseValue());
-                SkipWhitespace();
-                if (Match(']'))
-                {
-                    break;
-                }
-                Match(',');
-            }
-
-            return V;
-        }
-
-        FJsonValue ParseObject()
-        {
-            FJsonValue V;
-            V.Type = EJsonType::Object;
-
-            if (!Match('{'))
-            {
-                return {};
-            }
-
-            SkipWhitespace();
-            if (Match('}'))
-            {
-                return V;
-            }
-
-            while (Position < Text.size())
-            {
-                FJsonValue Key = ParseString();
-                Match(':');
-                FJsonValue Value = ParseValue();
-                V.ObjectValue.emplace(Key.StringValue, std::move(Value));
-                SkipWhitespace();
-                if (Match('}'))
-                {
-                    break;
-                }
-                Match(',');
-            }
-
-            return V;
-        }
-
-        const std::string& Text;
-        size_t Position = 0;
-    };
-
-    std::vector<uint8_t> DecodeBase64(const std::string& Input)
+    std::vector<uint8_t> DecodeBase64(std::string_view Input)
     {
         static const int8_t DecodingTable[256] =
         {
@@ -309,7 +68,7 @@ namespace
         return Output;
     }
 
-    const FJsonValue* GetObjectField(const FJsonValue* Object, const std::string& Key)
+    const FJsonValue* GetObjectField(const FJsonValue* Object, std::string_view Key)
     {
         if (!Object || !Object->IsObject())
         {
@@ -318,7 +77,7 @@ namespace
         return Object->Find(Key);
     }
 
-    int64_t GetIntField(const FJsonValue* Object, const std::string& Key, int64_t Default = 0)
+    int64_t GetIntField(const FJsonValue* Object, std::string_view Key, int64_t Default = 0)
     {
         const FJsonValue* Field = GetObjectField(Object, Key);
         if (Field && Field->IsNumber())
@@ -328,7 +87,7 @@ namespace
         return Default;
     }
 
-    double GetNumberField(const FJsonValue* Object, const std::string& Key, double Default = 0.0)
+    double GetNumberField(const FJsonValue* Object, std::string_view Key, double Default = 0.0)
     {
         const FJsonValue* Field = GetObjectField(Object, Key);
         if (Field && Field->IsNumber())
@@ -340,11 +99,11 @@ namespace
 
 	const FJsonValue* GetArrayElem(const FJsonValue* Array, size_t Index)
 	{
-		if (!Array || !Array->IsArray() || Index >= Array->ArrayValue.size())
+		if (!Array || !Array->IsArray() || Index >= Array->Size())
 		{
 			return nullptr;
 		}
-		return &Array->ArrayValue[Index];
+		return &(*Array)[Index];
 	}
 
     double GetNumberField(const FJsonValue* Array, size_t Index, double Default = 0.0)
@@ -357,7 +116,7 @@ namespace
         return Default;
     }
 
-    std::string GetStringField(const FJsonValue* Object, const std::string& Key)
+    std::string_view GetStringField(const FJsonValue* Object, std::string_view Key)
     {
         const FJsonValue* Field = GetObjectField(Object, Key);
         if (Field && Field->IsString())
@@ -432,12 +191,12 @@ namespace
         }
 
         const FJsonValue* MatrixValue = Node->Find("matrix");
-        if (MatrixValue && MatrixValue->IsArray() && MatrixValue->ArrayValue.size() == 16)
+        if (MatrixValue && MatrixValue->IsArray() && MatrixValue->Size() == 16)
         {
             FMatrix4 M{};
             for (size_t i = 0; i < 16; ++i)
             {
-                M[i] = static_cast<float>(MatrixValue->ArrayValue[i].NumberValue);
+                M[i] = static_cast<float>((*MatrixValue)[i].NumberValue);
             }
             return M;
         }
@@ -446,37 +205,37 @@ namespace
         const FJsonValue* Rotation = Node->Find("rotation");
         const FJsonValue* Scale = Node->Find("scale");
 
-        const float tx = (Translation && Translation->IsArray() && Translation->ArrayValue.size() == 3)
-            ? static_cast<float>(Translation->ArrayValue[0].NumberValue)
+        const float tx = (Translation && Translation->IsArray() && Translation->Size() == 3)
+            ? static_cast<float>((*Translation)[0].NumberValue)
             : 0.0f;
-        const float ty = (Translation && Translation->IsArray() && Translation->ArrayValue.size() == 3)
-            ? static_cast<float>(Translation->ArrayValue[1].NumberValue)
+        const float ty = (Translation && Translation->IsArray() && Translation->Size() == 3)
+            ? static_cast<float>((*Translation)[1].NumberValue)
             : 0.0f;
-        const float tz = (Translation && Translation->IsArray() && Translation->ArrayValue.size() == 3)
-            ? static_cast<float>(Translation->ArrayValue[2].NumberValue)
+        const float tz = (Translation && Translation->IsArray() && Translation->Size() == 3)
+            ? static_cast<float>((*Translation)[2].NumberValue)
             : 0.0f;
 
-        const float sx = (Scale && Scale->IsArray() && Scale->ArrayValue.size() == 3)
-            ? static_cast<float>(Scale->ArrayValue[0].NumberValue)
+        const float sx = (Scale && Scale->IsArray() && Scale->Size() == 3)
+            ? static_cast<float>((*Scale)[0].NumberValue)
             : 1.0f;
-        const float sy = (Scale && Scale->IsArray() && Scale->ArrayValue.size() == 3)
-            ? static_cast<float>(Scale->ArrayValue[1].NumberValue)
+        const float sy = (Scale && Scale->IsArray() && Scale->Size() == 3)
+            ? static_cast<float>((*Scale)[1].NumberValue)
             : 1.0f;
-        const float sz = (Scale && Scale->IsArray() && Scale->ArrayValue.size() == 3)
-            ? static_cast<float>(Scale->ArrayValue[2].NumberValue)
+        const float sz = (Scale && Scale->IsArray() && Scale->Size() == 3)
+            ? static_cast<float>((*Scale)[2].NumberValue)
             : 1.0f;
 
-        const float rx = (Rotation && Rotation->IsArray() && Rotation->ArrayValue.size() == 4)
-            ? static_cast<float>(Rotation->ArrayValue[0].NumberValue)
+        const float rx = (Rotation && Rotation->IsArray() && Rotation->Size() == 4)
+            ? static_cast<float>((*Rotation)[0].NumberValue)
             : 0.0f;
-        const float ry = (Rotation && Rotation->IsArray() && Rotation->ArrayValue.size() == 4)
-            ? static_cast<float>(Rotation->ArrayValue[1].NumberValue)
+        const float ry = (Rotation && Rotation->IsArray() && Rotation->Size() == 4)
+            ? static_cast<float>((*Rotation)[1].NumberValue)
             : 0.0f;
-        const float rz = (Rotation && Rotation->IsArray() && Rotation->ArrayValue.size() == 4)
-            ? static_cast<float>(Rotation->ArrayValue[2].NumberValue)
+        const float rz = (Rotation && Rotation->IsArray() && Rotation->Size() == 4)
+            ? static_cast<float>((*Rotation)[2].NumberValue)
             : 0.0f;
-        const float rw = (Rotation && Rotation->IsArray() && Rotation->ArrayValue.size() == 4)
-            ? static_cast<float>(Rotation->ArrayValue[3].NumberValue)
+        const float rw = (Rotation && Rotation->IsArray() && Rotation->Size() == 4)
+            ? static_cast<float>((*Rotation)[3].NumberValue)
             : 1.0f;
 
         const FMatrix4 T = { 1.0f, 0.0f, 0.0f, 0.0f,
@@ -577,16 +336,16 @@ namespace
             FGltfNode LoadedNode;
             LoadedNode.MeshIndex = static_cast<int>(MeshIndex);
             LoadedNode.WorldMatrix = ToFloat4x4(World);
-            LoadedNode.Name = GetStringField(Node, "name");
+            LoadedNode.Name = std::string(GetStringField(Node, "name"));
             OutNodes.push_back(LoadedNode);
         }
 
         const FJsonValue* Children = GetObjectField(Node, "children");
         if (Children && Children->IsArray())
         {
-            for (size_t i = 0; i < Children->ArrayValue.size(); ++i)
+            for (size_t i = 0; i < Children->Size(); ++i)
             {
-                const int64_t ChildIndex = static_cast<int64_t>(Children->ArrayValue[i].NumberValue);
+                const int64_t ChildIndex = static_cast<int64_t>((*Children)[i].NumberValue);
                 ProcessNodeRecursive(Nodes, ChildIndex, World, MeshDatas, OutNodes);
             }
         }
@@ -610,7 +369,7 @@ namespace
         }
 
         const FJsonValue* Image = GetArrayElem(Images, static_cast<size_t>(ImageIndex));
-        const std::string ImageUri = GetStringField(Image, "uri");
+        const std::string_view ImageUri = GetStringField(Image, "uri");
         if (ImageUri.empty())
         {
             return L"";
@@ -651,66 +410,234 @@ namespace
 
         return Transform;
     }
-}
 
-bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& OutScene)
-{
-    std::ifstream File(std::filesystem::path(FilePath), std::ios::binary);
-    if (!File.is_open())
+    constexpr uint32_t GlbMagic = 0x46546C67;      // "glTF"
+    constexpr uint32_t GlbVersion = 2;
+    constexpr uint32_t GlbChunkJson = 0x4E4F534A;  // "JSON"
+    constexpr uint32_t GlbChunkBin = 0x004E4942;   // "BIN\0"
+
+    struct FBufferSpan
     {
-        return false;
+        const uint8_t* Data = nullptr;
+        size_t Size = 0;
+    };
+
+    uint32_t ReadUint32(const uint8_t* Data)
+    {
+        uint32_t Value = 0;
+        std::memcpy(&Value, Data, sizeof(Value));
+        return Value;
     }
 
-    std::string JsonText((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
-    File.close();
+    // Splits a binary glTF into its JSON chunk and optional BIN chunk, both left in place.
+    bool ParseGlbChunks(const uint8_t* Data, size_t Size, std::string_view& OutJson, FBufferSpan& OutBin)
+    {
+        if (Size < 12 || ReadUint32(Data) != GlbMagic || ReadUint32(Data + 4) != GlbVersion)
+        {
+            return false;
+        }
 
-    FSimpleJsonParser Parser(JsonText);
-    const FJsonValue Root = Parser.Parse();
+        const size_t Length = (std::min)(static_cast<size_t>(ReadUint32(Data + 8)), Size);
+        size_t Offset = 12;
+        while (Offset + 8 <= Length)
+        {
+            const size_t ChunkLength = ReadUint32(Data + Offset);
+            const uint32_t ChunkType = ReadUint32(Data + Offset + 4);
+            const size_t ChunkStart = Offset + 8;
+            if (ChunkLength > Length - ChunkStart)
+            {
+                return false;
+            }
 
-    const FJsonValue* Buffers = GetObjectField(&Root, "buffers");
-    if (!Buffers || !Buffers->IsArray() || Buffers->ArrayValue.empty())
-    {
-        return false;
+            if (ChunkType == GlbChunkJson && OutJson.empty())
+            {
+                OutJson = std::string_view(reinterpret_cast<const char*>(Data + ChunkStart), ChunkLength);
+            }
+            else if (ChunkType == GlbChunkBin && !OutBin.Data)
+            {
+                OutBin.Data = Data + ChunkStart;
+                OutBin.Size = ChunkLength;
+            }
+
+            Offset = ChunkStart + ChunkLength;
+        }
+
+        return !OutJson.empty();
     }
 
-    const std::string Uri = GetStringField(&Buffers->ArrayValue[0], "uri");
-    const std::string Prefix = "data:application/octet-stream;base64,";
+    struct FGltfBuffers
+    {
+        std::vector<FBufferSpan> Spans;
+        // External .bin files stay mapped while accessors read from them
+        std::vector<std::unique_ptr<FMappedFile>> MappedFiles;
+        std::vector<std::wstring> FilePaths;
+        // data: URIs are the only buffers that have to be decoded into memory
+        std::vector<std::vector<uint8_t>> DecodedBuffers;
+    };
 
-    std::vector<uint8_t> BufferData;
-    if (Uri.compare(0, Prefix.size(), Prefix) == 0)
+    bool LoadBuffers(const FJsonValue* Buffers, const FBufferSpan& GlbBin, const std::filesystem::path& BasePath, FGltfBuffers& OutBuffers)
     {
-        BufferData = DecodeBase64(Uri.substr(Prefix.size()));
+        OutBuffers.Spans.reserve(Buffers->Size());
+        OutBuffers.DecodedBuffers.reserve(Buffers->Size());
+
+        for (size_t BufferIndex = 0; BufferIndex < Buffers->Size(); ++BufferIndex)
+        {
+            const FJsonValue* Buffer = GetArrayElem(Buffers, BufferIndex);
+            const std::string_view Uri = GetStringField(Buffer, "uri");
+
+            FBufferSpan Span;
+            if (Uri.empty())
+            {
+                // Only the first buffer of a .glb may omit its URI; it refers to the BIN chunk
+                if (BufferIndex != 0 || !GlbBin.Data)
+                {
+                    return false;
+                }
+                Span = GlbBin;
+            }
+            else if (Uri.compare(0, 5, "data:") == 0)
+            {
+                const size_t DataStart = Uri.find(',');
+                if (DataStart == std::string_view::npos || Uri.substr(0, DataStart).find(";base64") == std::string_view::npos)
+                {
+                    return false;
+                }
+
+                std::vector<uint8_t>& Decoded = OutBuffers.DecodedBuffers.emplace_back(DecodeBase64(Uri.substr(DataStart + 1)));
+                Span.Data = Decoded.data();
+                Span.Size = Decoded.size();
+            }
+            else
+            {
+                const std::wstring& FilePath = OutBuffers.FilePaths.emplace_back((BasePath / std::filesystem::path(Uri)).wstring());
+                std::unique_ptr<FMappedFile>& MappedFile = OutBuffers.MappedFiles.emplace_back(std::make_unique<FMappedFile>());
+                if (!MappedFile->Open(FilePath))
+                {
+                    return false;
+                }
+                Span.Data = MappedFile->GetData();
+                Span.Size = MappedFile->GetSize();
+            }
+
+            // The BIN chunk may carry padding past the declared length
+            const int64_t ByteLength = GetIntField(Buffer, "byteLength", 0);
+            if (ByteLength > 0 && static_cast<uint64_t>(ByteLength) < Span.Size)
+            {
+                Span.Size = static_cast<size_t>(ByteLength);
+            }
+
+            if (!Span.Data || Span.Size == 0)
+            {
+                return false;
+            }
+            OutBuffers.Spans.push_back(Span);
+        }
+
+        return true;
     }
-    else
+
+    // Strided window onto an accessor's elements inside its mapped buffer view.
+    struct FAccessorView
     {
-        const std::filesystem::path BasePath = std::filesystem::path(FilePath).parent_path();
-        const std::filesystem::path BufferPath = BasePath / std::filesystem::path(Uri);
+        const uint8_t* Data = nullptr;
+        size_t Size = 0;
+        size_t Stride = 0;
+        size_t Count = 0;
+
+        // Null when the element would run past the end of the buffer view
+        const uint8_t* GetElement(size_t Index, size_t ElementSize) const
+        {
+            const size_t Offset = Index * Stride;
+            return Offset + ElementSize <= Size ? Data + Offset : nullptr;
+        }
+    };
+
+    bool ResolveAccessor(const FJsonValue* Accessor, const FJsonValue* BufferViews, const std::vector<FBufferSpan>& Buffers, size_t DefaultStride, FAccessorView& OutView)
+    {
+        const int64_t BufferViewIndex = GetIntField(Accessor, "bufferView", -1);
+        const FJsonValue* BufferView = BufferViewIndex >= 0 ? GetArrayElem(BufferViews, static_cast<size_t>(BufferViewIndex)) : nullptr;
+        if (!BufferView)
+        {
+            return false;
+        }
+
+        const int64_t BufferIndex = GetIntField(BufferView, "buffer", 0);
+        if (BufferIndex < 0 || BufferIndex >= static_cast<int64_t>(Buffers.size()))
+        {
+            return false;
+        }
 
-        std::ifstream BinFile(BufferPath, std::ios::binary | std::ios::ate);
-        if (!BinFile.is_open())
+        const FBufferSpan& Buffer = Buffers[static_cast<size_t>(BufferIndex)];
+        const int64_t ViewOffset = GetIntField(BufferView, "byteOffset", 0);
+        const int64_t ViewLength = GetIntField(BufferView, "byteLength", 0);
+        const int64_t AccessorOffset = GetIntField(Accessor, "byteOffset", 0);
+        const int64_t Stride = GetIntField(BufferView, "byteStride", static_cast<int64_t>(DefaultStride));
+        const int64_t Count = GetIntField(Accessor, "count", 0);
+        if (ViewOffset < 0 || ViewLength <= 0 || AccessorOffset < 0 || Stride <= 0 || Count < 0
+            || static_cast<uint64_t>(ViewOffset) > Buffer.Size)
         {
             return false;
         }
 
-        const std::streamsize FileSize = BinFile.tellg();
-        if (FileSize <= 0)
+        const size_t ViewSize = (std::min)(static_cast<size_t>(ViewLength), Buffer.Size - static_cast<size_t>(ViewOffset));
+        if (static_cast<uint64_t>(AccessorOffset) > ViewSize)
         {
             return false;
         }
 
-        BufferData.resize(static_cast<size_t>(FileSize));
-        BinFile.seekg(0, std::ios::beg);
-        BinFile.read(reinterpret_cast<char*>(BufferData.data()), FileSize);
+        OutView.Data = Buffer.Data + ViewOffset + AccessorOffset;
+        OutView.Size = ViewSize - static_cast<size_t>(AccessorOffset);
+        OutView.Stride = static_cast<size_t>(Stride);
+        OutView.Count = static_cast<size_t>(Count);
+        return true;
+    }
+}
+
+bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& OutScene)
+{
+    // The JSON is parsed in place and vertex data is read straight out of the mapped buffers,
+    // so nothing in the file is copied until it lands in the mesh arrays.
+    FMappedFile File;
+    if (!File.Open(FilePath))
+    {
+        return false;
     }
 
-    if (BufferData.empty())
+    std::string_view JsonText = File.GetText();
+    FBufferSpan GlbBin;
+    if (File.GetSize() >= 4 && ReadUint32(File.GetData()) == GlbMagic)
+    {
+        JsonText = {};
+        if (!ParseGlbChunks(File.GetData(), File.GetSize(), JsonText, GlbBin))
+        {
+            return false;
+        }
+    }
+
+    FJsonDocument Document;
+    if (!Document.Parse(JsonText))
     {
         return false;
     }
+    const FJsonValue* Root = Document.GetRoot();
 
-    const FJsonValue* BufferViews = GetObjectField(&Root, "bufferViews");
-    const FJsonValue* Accessors = GetObjectField(&Root, "accessors");
-    const FJsonValue* Meshes = GetObjectField(&Root, "meshes");
+    const FJsonValue* Buffers = GetObjectField(Root, "buffers");
+    if (!Buffers || !Buffers->IsArray() || Buffers->Empty())
+    {
+        return false;
+    }
+
+    const std::filesystem::path BasePath = std::filesystem::path(FilePath).parent_path();
+
+    FGltfBuffers BufferData;
+    if (!LoadBuffers(Buffers, GlbBin, BasePath, BufferData))
+    {
+        return false;
+    }
+
+    const FJsonValue* BufferViews = GetObjectField(Root, "bufferViews");
+    const FJsonValue* Accessors = GetObjectField(Root, "accessors");
+    const FJsonValue* Meshes = GetObjectField(Root, "meshes");
     if (!BufferViews || !BufferViews->IsArray() || !Accessors || !Accessors->IsArray() || !Meshes || !Meshes->IsArray())
     {
         return false;
@@ -754,83 +681,61 @@ bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& Ou
             return false;
         }
 
-        const int64_t PositionBufferViewIndex = GetIntField(PositionAccessor, "bufferView", -1);
-        const int64_t NormalBufferViewIndex = NormalAccessor ? GetIntField(NormalAccessor, "bufferView", -1) : -1;
-        const int64_t TexcoordBufferViewIndex = TexcoordAccessor ? GetIntField(TexcoordAccessor, "bufferView", -1) : -1;
-        const int64_t TangentBufferViewIndex = TangentAccessor ? GetIntField(TangentAccessor, "bufferView", -1) : -1;
-        const int64_t ColorBufferViewIndex = ColorAccessor ? GetIntField(ColorAccessor, "bufferView", -1) : -1;
-        const int64_t IndexBufferViewIndex = GetIntField(IndexAccessor, "bufferView", -1);
-
-        const FJsonValue* PositionBufferView = GetArrayElem(BufferViews, static_cast<size_t>(PositionBufferViewIndex));
-        const FJsonValue* NormalBufferView = NormalBufferViewIndex >= 0 ? GetArrayElem(BufferViews, static_cast<size_t>(NormalBufferViewIndex)) : nullptr;
-        const FJsonValue* TexcoordBufferView = TexcoordBufferViewIndex >= 0 ? GetArrayElem(BufferViews, static_cast<size_t>(TexcoordBufferViewIndex)) : nullptr;
-        const FJsonValue* TangentBufferView = TangentBufferViewIndex >= 0 ? GetArrayElem(BufferViews, static_cast<size_t>(TangentBufferViewIndex)) : nullptr;
-        const FJsonValue* ColorBufferView = ColorBufferViewIndex >= 0 ? GetArrayElem(BufferViews, static_cast<size_t>(ColorBufferViewIndex)) : nullptr;
-        const FJsonValue* IndexBufferView = GetArrayElem(BufferViews, static_cast<size_t>(IndexBufferViewIndex));
-
-        if (!PositionBufferView || !IndexBufferView)
-        {
-            return false;
-        }
+        const std::string_view ColorType = ColorAccessor ? GetStringField(ColorAccessor, "type") : std::string_view();
+        const size_t ColorSize = ColorType == "VEC4" ? sizeof(float) * 4 : sizeof(float) * 3;
 
-        const int64_t PositionCount = GetIntField(PositionAccessor, "count", 0);
-        if (PositionCount <= 0)
-        {
-            return false;
-        }
+        const int64_t ComponentType = GetIntField(IndexAccessor, "componentType", 5125);
+        const size_t ComponentSize = (ComponentType == 5121) ? 1 : (ComponentType == 5123 ? 2 : 4);
 
-        const int64_t IndexCount = GetIntField(IndexAccessor, "count", 0);
-        if (IndexCount <= 0)
+        FAccessorView Positions;
+        FAccessorView IndexView;
+        if (!ResolveAccessor(PositionAccessor, BufferViews, BufferData.Spans, sizeof(float) * 3, Positions)
+            || !ResolveAccessor(IndexAccessor, BufferViews, BufferData.Spans, ComponentSize, IndexView))
         {
             return false;
         }
 
-        const int64_t PositionByteOffset = GetIntField(PositionAccessor, "byteOffset", 0) + GetIntField(PositionBufferView, "byteOffset", 0);
-        const int64_t NormalByteOffset = (NormalAccessor ? GetIntField(NormalAccessor, "byteOffset", 0) + GetIntField(NormalBufferView, "byteOffset", 0) : 0);
-        const int64_t TexcoordByteOffset = (TexcoordAccessor ? GetIntField(TexcoordAccessor, "byteOffset", 0) + GetIntField(TexcoordBufferView, "byteOffset", 0) : 0);
-        const int64_t TangentByteOffset = (TangentAccessor ? GetIntField(TangentAccessor, "byteOffset", 0) + GetIntField(TangentBufferView, "byteOffset", 0) : 0);
-        const int64_t ColorByteOffset = (ColorAccessor ? GetIntField(ColorAccessor, "byteOffset", 0) + GetIntField(ColorBufferView, "byteOffset", 0) : 0);
-        const int64_t IndexByteOffset = GetIntField(IndexAccessor, "byteOffset", 0) + GetIntField(IndexBufferView, "byteOffset", 0);
-
-        const int64_t PositionStride = GetIntField(PositionBufferView, "byteStride", static_cast<int64_t>(sizeof(float) * 3));
-        const int64_t NormalStride = NormalBufferView ? GetIntField(NormalBufferView, "byteStride", static_cast<int64_t>(sizeof(float) * 3)) : static_cast<int64_t>(sizeof(float) * 3);
-        const int64_t TexcoordStride = TexcoordBufferView ? GetIntField(TexcoordBufferView, "byteStride", static_cast<int64_t>(sizeof(float) * 2)) : static_cast<int64_t>(sizeof(float) * 2);
-        const int64_t TangentStride = TangentBufferView ? GetIntField(TangentBufferView, "byteStride", static_cast<int64_t>(sizeof(float) * 4)) : static_cast<int64_t>(sizeof(float) * 4);
-        const std::string ColorType = ColorAccessor ? GetStringField(ColorAccessor, "type") : std::string();
-        const int64_t DefaultColorStride = ColorType == "VEC4" ? static_cast<int64_t>(sizeof(float) * 4) : static_cast<int64_t>(sizeof(float) * 3);
-        const int64_t ColorStride = ColorBufferView ? GetIntField(ColorBufferView, "byteStride", DefaultColorStride) : DefaultColorStride;
-
-        if (PositionStride <= 0 || NormalStride <= 0 || TexcoordStride <= 0 || TangentStride <= 0 || ColorStride <= 0)
+        if (Positions.Count == 0 || IndexView.Count == 0)
         {
             return false;
         }
 
+        // Optional streams without a usable buffer view fall back to defaults
+        FAccessorView Normals;
+        FAccessorView Tangents;
+        FAccessorView Texcoords;
+        FAccessorView Colors;
+        const bool bHasNormals = NormalAccessor && ResolveAccessor(NormalAccessor, BufferViews, BufferData.Spans, sizeof(float) * 3, Normals);
+        const bool bHasTangents = TangentAccessor && ResolveAccessor(TangentAccessor, BufferViews, BufferData.Spans, sizeof(float) * 4, Tangents);
+        const bool bHasTexcoords = TexcoordAccessor && ResolveAccessor(TexcoordAccessor, BufferViews, BufferData.Spans, sizeof(float) * 2, Texcoords);
+        const bool bHasColors = ColorAccessor && ResolveAccessor(ColorAccessor, BufferViews, BufferData.Spans, ColorSize, Colors);
+
         const uint32_t VertexOffset = static_cast<uint32_t>(MeshData.Vertices.size());
-        MeshData.Vertices.reserve(MeshData.Vertices.size() + static_cast<size_t>(PositionCount));
+        MeshData.Vertices.reserve(MeshData.Vertices.size() + Positions.Count);
 
-        for (int64_t i = 0; i < PositionCount; ++i)
+        for (size_t i = 0; i < Positions.Count; ++i)
         {
-            const size_t PositionOffset = static_cast<size_t>(PositionByteOffset + i * PositionStride);
-            if (PositionOffset + sizeof(float) * 3 > BufferData.size())
+            const uint8_t* PositionData = Positions.GetElement(i, sizeof(float) * 3);
+            if (!PositionData)
             {
                 return false;
             }
 
             FMesh::FVertex Vertex{};
             float Position[3] = {};
-            std::memcpy(Position, &BufferData[PositionOffset], sizeof(Position));
+            std::memcpy(Position, PositionData, sizeof(Position));
             Vertex.Position = { Position[0], Position[1], Position[2] };
             Vertex.Position.z = -Vertex.Position.z;
 
-            if (NormalAccessor && NormalBufferView)
+            if (bHasNormals)
             {
-                const size_t Offset = static_cast<size_t>(NormalByteOffset + i * NormalStride);
-                if (Offset + sizeof(float) * 3 > BufferData.size())
+                const uint8_t* Data = Normals.GetElement(i, sizeof(float) * 3);
+                if (!Data)
                 {
                     return false;
                 }
                 float Normal[3] = {};
-                std::memcpy(Normal, &BufferData[Offset], sizeof(Normal));
+                std::memcpy(Normal, Data, sizeof(Normal));
                 Vertex.Normal = { Normal[0], Normal[1], Normal[2] };
             }
             else
@@ -839,15 +744,15 @@ bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& Ou
             }
             Vertex.Normal.z = -Vertex.Normal.z;
 
-            if (TangentAccessor && TangentBufferView)
+            if (bHasTangents)
             {
-                const size_t Offset = static_cast<size_t>(TangentByteOffset + i * TangentStride);
-                if (Offset + sizeof(float) * 4 > BufferData.size())
+                const uint8_t* Data = Tangents.GetElement(i, sizeof(float) * 4);
+                if (!Data)
                 {
                     return false;
                 }
                 float Tangent[4] = {};
-                std::memcpy(Tangent, &BufferData[Offset], sizeof(Tangent));
+                std::memcpy(Tangent, Data, sizeof(Tangent));
                 Vertex.Tangent = { Tangent[0], Tangent[1], Tangent[2], Tangent[3] };
             }
             else
@@ -857,15 +762,15 @@ bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& Ou
             Vertex.Tangent.z = -Vertex.Tangent.z;
             Vertex.Tangent.w = -Vertex.Tangent.w;
 
-            if (TexcoordAccessor && TexcoordBufferView)
+            if (bHasTexcoords)
             {
-                const size_t Offset = static_cast<size_t>(TexcoordByteOffset + i * TexcoordStride);
-                if (Offset + sizeof(float) * 2 > BufferData.size())
+                const uint8_t* Data = Texcoords.GetElement(i, sizeof(float) * 2);
+                if (!Data)
                 {
                     return false;
                 }
                 float UV[2] = {};
-                std::memcpy(UV, &BufferData[Offset], sizeof(UV));
+                std::memcpy(UV, Data, sizeof(UV));
                 Vertex.UV = { UV[0], UV[1] };
             }
             else
@@ -873,17 +778,16 @@ bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& Ou
                 Vertex.UV = { 0.0f, 0.0f };
             }
 
-            if (ColorAccessor && ColorBufferView)
+            if (bHasColors)
             {
-                const size_t Offset = static_cast<size_t>(ColorByteOffset + i * ColorStride);
-                const size_t ExpectedBytes = ColorType == "VEC4" ? sizeof(float) * 4 : sizeof(float) * 3;
-                if (Offset + ExpectedBytes > BufferData.size())
+                const uint8_t* Data = Colors.GetElement(i, ColorSize);
+                if (!Data)
                 {
                     return false;
                 }
 
                 float Color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
-                std::memcpy(Color, &BufferData[Offset], ExpectedBytes);
+                std::memcpy(Color, Data, ColorSize);
                 const float Alpha = ColorType == "VEC4" ? Color[3] : 1.0f;
                 Vertex.Color = { Color[0], Color[1], Color[2], Alpha };
             }
@@ -891,16 +795,38 @@ bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& Ou
             MeshData.Vertices.push_back(Vertex);
         }
 
-        std::vector<uint32_t> RawIndices;
-        RawIndices.reserve(static_cast<size_t>(IndexCount));
+        const size_t IndexStart = MeshData.Indices.size();
 
-        const int64_t ComponentType = GetIntField(IndexAccessor, "componentType", 5125);
-        const size_t ComponentSize = (ComponentType == 5121) ? 1 : (ComponentType == 5123 ? 2 : 4);
+        // Triangle lists decode straight into the mesh; strips and fans are expanded afterwards
+        std::vector<uint32_t> RawIndices;
+        uint32_t* DecodedIndices = nullptr;
+        switch (PrimitiveMode)
+        {
+        case 4: // TRIANGLES
+            if (IndexView.Count % 3 != 0)
+            {
+                return false;
+            }
+            MeshData.Indices.resize(IndexStart + IndexView.Count);
+            DecodedIndices = MeshData.Indices.data() + IndexStart;
+            break;
+        case 5: // TRIANGLE_STRIP
+        case 6: // TRIANGLE_FAN
+            if (IndexView.Count < 3)
+            {
+                return false;
+            }
+            RawIndices.resize(IndexView.Count);
+            DecodedIndices = RawIndices.data();
+            break;
+        default:
+            return false;
+        }
 
-        for (int64_t i = 0; i < IndexCount; ++i)
+        for (size_t i = 0; i < IndexView.Count; ++i)
         {
-            const size_t Offset = static_cast<size_t>(IndexByteOffset + i * ComponentSize);
-            if (Offset + ComponentSize > BufferData.size())
+            const uint8_t* Data = IndexView.GetElement(i, ComponentSize);
+            if (!Data)
             {
                 return false;
             }
@@ -909,46 +835,29 @@ bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& Ou
             switch (ComponentType)
             {
             case 5121: // UNSIGNED_BYTE
-                Index = BufferData[Offset];
+                Index = *Data;
                 break;
             case 5123: // UNSIGNED_SHORT
             {
                 uint16_t Value = 0;
-                std::memcpy(&Value, &BufferData[Offset], sizeof(uint16_t));
+                std::memcpy(&Value, Data, sizeof(uint16_t));
                 Index = Value;
                 break;
             }
             default: // 5125 UNSIGNED_INT
             {
                 uint32_t Value = 0;
-                std::memcpy(&Value, &BufferData[Offset], sizeof(uint32_t));
+                std::memcpy(&Value, Data, sizeof(uint32_t));
                 Index = Value;
                 break;
             }
             }
 
-            RawIndices.push_back(Index + VertexOffset);
+            DecodedIndices[i] = Index + VertexOffset;
         }
 
-        const size_t IndexStart = MeshData.Indices.size();
-
-        switch (PrimitiveMode)
-        {
-        case 4: // TRIANGLES
-        {
-            if (RawIndices.size() % 3 != 0)
-            {
-                return false;
-            }
-            MeshData.Indices.insert(MeshData.Indices.end(), RawIndices.begin(), RawIndices.end());
-            break;
-        }
-        case 5: // TRIANGLE_STRIP
+        if (PrimitiveMode == 5)
         {
-            if (RawIndices.size() < 3)
-            {
-                return false;
-            }
             for (size_t i = 2; i < RawIndices.size(); ++i)
             {
                 const bool bEven = (i % 2) == 0;
@@ -968,24 +877,15 @@ bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& Ou
                     MeshData.Indices.push_back(i2);
                 }
             }
-            break;
         }
-        case 6: // TRIANGLE_FAN
+        else if (PrimitiveMode == 6)
         {
-            if (RawIndices.size() < 3)
-            {
-                return false;
-            }
             for (size_t i = 2; i < RawIndices.size(); ++i)
             {
                 MeshData.Indices.push_back(RawIndices[0]);
                 MeshData.Indices.push_back(RawIndices[i - 1]);
                 MeshData.Indices.push_back(RawIndices[i]);
             }
-            break;
-        }
-        default:
-            return false;
         }
 
         const size_t IndexEnd = MeshData.Indices.size();
@@ -1001,9 +901,9 @@ bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& Ou
     };
 
     std::vector<FMeshData> MeshDatas;
-    MeshDatas.resize(Meshes->ArrayValue.size());
+    MeshDatas.resize(Meshes->Size());
 
-    for (size_t MeshIndex = 0; MeshIndex < Meshes->ArrayValue.size(); ++MeshIndex)
+    for (size_t MeshIndex = 0; MeshIndex < Meshes->Size(); ++MeshIndex)
     {
         const FJsonValue* Mesh = GetArrayElem(Meshes, MeshIndex);
         const FJsonValue* Primitives = GetObjectField(Mesh, "primitives");
@@ -1012,7 +912,7 @@ bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& Ou
             return false;
         }
 
-        for (const FJsonValue& PrimitiveValue : Primitives->ArrayValue)
+        for (const FJsonValue& PrimitiveValue : *Primitives)
         {
             const int64_t MaterialIndex = GetIntField(&PrimitiveValue, "material", -1);
 
@@ -1027,15 +927,13 @@ bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& Ou
         }
     }
 
-    const FJsonValue* Materials = GetObjectField(&Root, "materials");
-    const FJsonValue* Textures = GetObjectField(&Root, "textures");
-    const FJsonValue* Images = GetObjectField(&Root, "images");
-
-    const bool bHasMaterialData = Materials && Materials->IsArray() && !Materials->ArrayValue.empty()
-        && Textures && Textures->IsArray() && !Textures->ArrayValue.empty()
-        && Images && Images->IsArray() && !Images->ArrayValue.empty();
+    const FJsonValue* Materials = GetObjectField(Root, "materials");
+    const FJsonValue* Textures = GetObjectField(Root, "textures");
+    const FJsonValue* Images = GetObjectField(Root, "images");
 
-    const std::filesystem::path BasePath = std::filesystem::path(FilePath).parent_path();
+    const bool bHasMaterialData = Materials && Materials->IsArray() && !Materials->Empty()
+        && Textures && Textures->IsArray() && !Textures->Empty()
+        && Images && Images->IsArray() && !Images->Empty();
 
     const auto ResolveMaterialTextures = [&](const FJsonValue* Material) -> FGltfMaterialTextureSet
     {
@@ -1081,7 +979,7 @@ bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& Ou
             TextureSet.EmissiveFactor.z = static_cast<float>(GetNumberField(EmissiveFactor, 2, TextureSet.EmissiveFactor.z));
         }
 
-        const std::string AlphaMode = GetStringField(Material, "alphaMode");
+        const std::string_view AlphaMode = GetStringField(Material, "alphaMode");
         if (AlphaMode == "MASK")
         {
             TextureSet.bAlphaMask = true;
@@ -1094,8 +992,8 @@ bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& Ou
     std::vector<FGltfMaterialTextureSet> MaterialTextureSets;
     if (bHasMaterialData)
     {
-        MaterialTextureSets.resize(Materials->ArrayValue.size());
-        for (size_t MaterialIndex = 0; MaterialIndex < Materials->ArrayValue.size(); ++MaterialIndex)
+        MaterialTextureSets.resize(Materials->Size());
+        for (size_t MaterialIndex = 0; MaterialIndex < Materials->Size(); ++MaterialIndex)
         {
             MaterialTextureSets[MaterialIndex] = ResolveMaterialTextures(GetArrayElem(Materials, MaterialIndex));
         }
@@ -1123,10 +1021,12 @@ bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& Ou
 
     OutScene = {};
     OutScene.MeshPrimitiveSections = std::move(MeshPrimitiveSections);
+    OutScene.SourceFiles.push_back(FilePath);
+    OutScene.SourceFiles.insert(OutScene.SourceFiles.end(), BufferData.FilePaths.begin(), BufferData.FilePaths.end());
 
-    const FJsonValue* Nodes = GetObjectField(&Root, "nodes");
-    const FJsonValue* Scenes = GetObjectField(&Root, "scenes");
-    const int64_t SceneIndex = GetIntField(&Root, "scene", 0);
+    const FJsonValue* Nodes = GetObjectField(Root, "nodes");
+    const FJsonValue* Scenes = GetObjectField(Root, "scenes");
+    const int64_t SceneIndex = GetIntField(Root, "scene", 0);
 
     if (Nodes && Nodes->IsArray() && Scenes && Scenes->IsArray())
     {
@@ -1134,7 +1034,7 @@ bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& Ou
         const FJsonValue* SceneNodes = GetObjectField(Scene, "nodes");
         if (SceneNodes && SceneNodes->IsArray())
         {
-            for (const FJsonValue& NodeValue : SceneNodes->ArrayValue)
+            for (const FJsonValue& NodeValue : *SceneNodes)
             {
                 const int64_t NodeIndex = static_cast<int64_t>(NodeValue.NumberValue);
                 ProcessNodeRecursive(Nodes, NodeIndex, MakeIdentityMatrix(), MeshDatas, OutScene.Nodes);
@@ -1153,15 +1053,16 @@ bool FGltfLoader::LoadSceneFromFile(const std::wstring& FilePath, FGltfScene& Ou
         }
     }
 
-    for (const FMeshData& MeshData : MeshDatas)
+    // Meshes are independent, and normal and tangent generation also splits large meshes across workers
+    OutScene.Meshes.resize(MeshDatas.size());
+    FParallelFor::Execute(0, static_cast<uint32_t>(MeshDatas.size()), [&](uint32_t MeshIndex)
     {
-        FMesh Mesh;
-        Mesh.SetVertices(MeshData.Vertices);
-        Mesh.SetIndices(MeshData.Indices);
+        FMesh& Mesh = OutScene.Meshes[MeshIndex];
+        Mesh.SetVertices(std::move(MeshDatas[MeshIndex].Vertices));
+        Mesh.SetIndices(std::move(MeshDatas[MeshIndex].Indices));
         Mesh.GenerateNormalsIfMissing();
         Mesh.GenerateTangentsIfMissing();
-        OutScene.Meshes.push_back(std::move(Mesh));
-    }
+    });
 
     return true;
 }
@@ -59,6 +59,8 @@ struct FGltfScene
     std::vector<FMesh> Meshes;
     std::vector<std::vector<FGltfPrimitiveSection>> MeshPrimitiveSections;
     std::vector<FGltfNode> Nodes;
+    // The glTF file followed by every external buffer it read; textures are referenced by path only.
+    std::vector<std::wstring> SourceFiles;
 };
 
 class FGltfLoader
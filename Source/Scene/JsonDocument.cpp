@@ -0,0 +1,252 @@
+#include "JsonDocument.h"
+
+#include <charconv>
+
+namespace
+{
+    // Deeper nesting than this is not produced by any exporter and would only risk the stack.
+    constexpr uint32_t MaxDepth = 256;
+
+    bool IsWhitespace(char Ch)
+    {
+        return Ch == ' ' || Ch == '\n' || Ch == '\r' || Ch == '\t';
+    }
+
+    bool IsDigit(char Ch)
+    {
+        return Ch >= '0' && Ch <= '9';
+    }
+}
+
+bool FJsonDocument::Parse(std::string_view InText)
+{
+    Text = InText;
+    Position = 0;
+    Values.clear();
+    ChildStarts.clear();
+    Pending.clear();
+
+    // UTF-8 byte order mark
+    if (Text.size() >= 3 && Text.compare(0, 3, "\xEF\xBB\xBF") == 0)
+    {
+        Position = 3;
+    }
+
+    bool bSuccess = ParseValue({}, 0);
+    if (bSuccess)
+    {
+        SkipWhitespace();
+        bSuccess = Position == Text.size() && Pending.size() == 1;
+    }
+
+    if (!bSuccess)
+    {
+        Values.clear();
+        ChildStarts.clear();
+        Pending.clear();
+        return false;
+    }
+
+    Values.push_back(Pending.back().Value);
+    ChildStarts.push_back(Pending.back().ChildStart);
+
+    for (size_t Index = 0; Index < Values.size(); ++Index)
+    {
+        FJsonValue& Value = Values[Index];
+        if (Value.ChildCount > 0)
+        {
+            Value.Children = Values.data() + ChildStarts[Index];
+        }
+    }
+
+    std::vector<uint32_t>().swap(ChildStarts);
+    std::vector<FPendingValue>().swap(Pending);
+    return true;
+}
+
+void FJsonDocument::SkipWhitespace()
+{
+    while (Position < Text.size() && IsWhitespace(Text[Position]))
+    {
+        ++Position;
+    }
+}
+
+bool FJsonDocument::MatchLiteral(std::string_view Literal)
+{
+    if (Text.compare(Position, Literal.size(), Literal) != 0)
+    {
+        return false;
+    }
+    Position += Literal.size();
+    return true;
+}
+
+bool FJsonDocument::ParseValue(std::string_view Key, uint32_t Depth)
+{
+    SkipWhitespace();
+    if (Position >= Text.size())
+    {
+        return false;
+    }
+
+    FPendingValue& Entry = Pending.emplace_back();
+    Entry.Value.Key = Key;
+
+    const char Ch = Text[Position];
+    switch (Ch)
+    {
+    case '{':
+        Pending.pop_back();
+        return ParseContainer(EJsonType::Object, Key, Depth + 1);
+    case '[':
+        Pending.pop_back();
+        return ParseContainer(EJsonType::Array, Key, Depth + 1);
+    case '"':
+        Entry.Value.Type = EJsonType::String;
+        return ParseString(Entry.Value.StringValue);
+    case 't':
+        Entry.Value.Type = EJsonType::Bool;
+        Entry.Value.BoolValue = true;
+        return MatchLiteral("true");
+    case 'f':
+        Entry.Value.Type = EJsonType::Bool;
+        return MatchLiteral("false");
+    case 'n':
+        return MatchLiteral("null");
+    default:
+        Entry.Value.Type = EJsonType::Number;
+        return ParseNumber(Entry.Value.NumberValue);
+    }
+}
+
+bool FJsonDocument::ParseContainer(EJsonType Type, std::string_view Key, uint32_t Depth)
+{
+    if (Depth > MaxDepth)
+    {
+        return false;
+    }
+
+    const char Close = Type == EJsonType::Object ? '}' : ']';
+    const size_t FirstPending = Pending.size();
+    ++Position;
+
+    SkipWhitespace();
+    if (Position < Text.size() && Text[Position] == Close)
+    {
+        ++Position;
+    }
+    else
+    {
+        while (true)
+        {
+            std::string_view MemberKey;
+            if (Type == EJsonType::Object)
+            {
+                SkipWhitespace();
+                if (Position >= Text.size() || Text[Position] != '"' || !ParseString(MemberKey))
+                {
+                    return false;
+                }
+                SkipWhitespace();
+                if (Position >= Text.size() || Text[Position] != ':')
+                {
+                    return false;
+                }
+                ++Position;
+            }
+
+            if (!ParseValue(MemberKey, Depth))
+            {
+                return false;
+            }
+
+            SkipWhitespace();
+            if (Position >= Text.size())
+            {
+                return false;
+            }
+            const char Separator = Text[Position++];
+            if (Separator == Close)
+            {
+                break;
+            }
+            if (Separator != ',')
+            {
+                return false;
+            }
+        }
+    }
+
+    // Children are final now, so they move out of the pending stack as one contiguous run.
+    const uint32_t ChildStart = static_cast<uint32_t>(Values.size());
+    for (size_t Index = FirstPending; Index < Pending.size(); ++Index)
+    {
+        Values.push_back(Pending[Index].Value);
+        ChildStarts.push_back(Pending[Index].ChildStart);
+    }
+
+    FPendingValue Container;
+    Container.Value.Key = Key;
+    Container.Value.Type = Type;
+    Container.Value.ChildCount = static_cast<uint32_t>(Pending.size() - FirstPending);
+    Container.ChildStart = ChildStart;
+    Pending.resize(FirstPending);
+    Pending.push_back(Container);
+    return true;
+}
+
+bool FJsonDocument::ParseString(std::string_view& OutString)
+{
+    const size_t Start = ++Position;
+    while (Position < Text.size())
+    {
+        const char Ch = Text[Position];
+        if (Ch == '"')
+        {
+            OutString = Text.substr(Start, Position - Start);
+            ++Position;
+            return true;
+        }
+        Position += Ch == '\\' ? 2 : 1;
+    }
+    return false;
+}
+
+bool FJsonDocument::ParseNumber(double& OutNumber)
+{
+    const size_t Start = Position;
+    if (Position < Text.size() && Text[Position] == '-')
+    {
+        ++Position;
+    }
+    while (Position < Text.size() && IsDigit(Text[Position]))
+    {
+        ++Position;
+    }
+    if (Position < Text.size() && Text[Position] == '.')
+    {
+        ++Position;
+        while (Position < Text.size() && IsDigit(Text[Position]))
+        {
+            ++Position;
+        }
+    }
+    if (Position < Text.size() && (Text[Position] == 'e' || Text[Position] == 'E'))
+    {
+        ++Position;
+        if (Position < Text.size() && (Text[Position] == '+' || Text[Position] == '-'))
+        {
+            ++Position;
+        }
+        while (Position < Text.size() && IsDigit(Text[Position]))
+        {
+            ++Position;
+        }
+    }
+
+    const char* First = Text.data() + Start;
+    const char* Last = Text.data() + Position;
+    const std::from_chars_result Result = std::from_chars(First, Last, OutNumber);
+    return Result.ec == std::errc() && Result.ptr == Last;
+}
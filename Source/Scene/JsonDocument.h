@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+enum class EJsonType : uint8_t
+{
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object
+};
+
+/**
+ * One value of an FJsonDocument. Strings and keys are views into the parsed text, so the text
+ * must outlive the document. The children of an array or object are stored contiguously.
+ */
+struct FJsonValue
+{
+    // Member name when the value belongs to an object
+    std::string_view Key;
+    // Characters between the quotes; escape sequences are kept as written
+    std::string_view StringValue;
+    double NumberValue = 0.0;
+    const FJsonValue* Children = nullptr;
+    uint32_t ChildCount = 0;
+    EJsonType Type = EJsonType::Null;
+    bool BoolValue = false;
+
+    bool IsNull() const { return Type == EJsonType::Null; }
+    bool IsArray() const { return Type == EJsonType::Array; }
+    bool IsObject() const { return Type == EJsonType::Object; }
+    bool IsString() const { return Type == EJsonType::String; }
+    bool IsNumber() const { return Type == EJsonType::Number; }
+
+    size_t Size() const { return ChildCount; }
+    bool Empty() const { return ChildCount == 0; }
+    const FJsonValue& operator[](size_t Index) const { return Children[Index]; }
+    const FJsonValue* begin() const { return Children; }
+    const FJsonValue* end() const { return Children + ChildCount; }
+
+    // Linear scan over the members; glTF and scene objects only have a handful of keys.
+    const FJsonValue* Find(std::string_view Name) const
+    {
+        if (Type != EJsonType::Object)
+        {
+            return nullptr;
+        }
+        for (const FJsonValue& Child : *this)
+        {
+            if (Child.Key == Name)
+            {
+                return &Child;
+            }
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * In-situ JSON parser. The whole document lands in one flat value array with no per-value heap
+ * allocation, and nothing is copied out of the source text.
+ */
+class FJsonDocument
+{
+public:
+    bool Parse(std::string_view InText);
+
+    const FJsonValue* GetRoot() const { return Values.empty() ? nullptr : &Values.back(); }
+    size_t GetValueCount() const { return Values.size(); }
+
+private:
+    bool ParseValue(std::string_view Key, uint32_t Depth);
+    bool ParseContainer(EJsonType Type, std::string_view Key, uint32_t Depth);
+    bool ParseString(std::string_view& OutString);
+    bool ParseNumber(double& OutNumber);
+    bool MatchLiteral(std::string_view Literal);
+    void SkipWhitespace();
+
+    struct FPendingValue
+    {
+        FJsonValue Value;
+        uint32_t ChildStart = 0;
+    };
+
+    std::string_view Text;
+    size_t Position = 0;
+    // Final storage; each container's children end up contiguous, the root comes last.
+    std::vector<FJsonValue> Values;
+    // Index of the first child in Values, per value; turned into pointers once Values stops growing.
+    std::vector<uint32_t> ChildStarts;
+    // Values whose parent container is still open.
+    std::vector<FPendingValue> Pending;
+};
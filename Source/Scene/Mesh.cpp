@@ -1,8 +1,10 @@
 #include "Mesh.h"
+#include "../Core/TaskSystem.h"
 
 #include <DirectXMath.h>
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <vector>
 
 namespace
@@ -29,6 +31,192 @@ namespace
         const XMVECTOR Up = std::abs(XMVectorGetX(Normal)) < 0.99f ? g_XMIdentityR1 : g_XMIdentityR0;
         return XMVector3Normalize(XMVector3Cross(Up, Normal));
     }
+
+    // Normal and tangent generation works on blocks of four triangles, one per SIMD lane.
+    constexpr uint32_t FaceLaneCount = 4;
+    // Smallest parallel chunks; below these the scheduling overhead outweighs the work.
+    constexpr uint32_t MinFaceBlocksPerChunk = 256;
+    constexpr uint32_t MinVerticesPerChunk = 1024;
+    // Below this the vertex-to-triangle table costs more than gathering through it saves.
+    constexpr uint32_t MinParallelTriangles = 1 << 16;
+
+    // Per-triangle vectors in structure-of-arrays form, padded to whole blocks.
+    struct FFaceStream
+    {
+        std::vector<float> X;
+        std::vector<float> Y;
+        std::vector<float> Z;
+
+        void Resize(size_t Count)
+        {
+            X.resize(Count);
+            Y.resize(Count);
+            Z.resize(Count);
+        }
+
+        void Store(size_t First, DirectX::FXMVECTOR InX, DirectX::FXMVECTOR InY, DirectX::FXMVECTOR InZ)
+        {
+            DirectX::XMStoreFloat4(reinterpret_cast<DirectX::XMFLOAT4*>(X.data() + First), InX);
+            DirectX::XMStoreFloat4(reinterpret_cast<DirectX::XMFLOAT4*>(Y.data() + First), InY);
+            DirectX::XMStoreFloat4(reinterpret_cast<DirectX::XMFLOAT4*>(Z.data() + First), InZ);
+        }
+
+        DirectX::XMVECTOR Load(size_t Face) const
+        {
+            return DirectX::XMVectorSet(X[Face], Y[Face], Z[Face], 0.0f);
+        }
+    };
+
+    // Tail lanes of the last block repeat the last triangle; their results are never used.
+    void GetBlockTriangles(uint32_t Block, uint32_t TriangleCount, uint32_t (&OutTriangles)[FaceLaneCount])
+    {
+        for (uint32_t Lane = 0; Lane < FaceLaneCount; ++Lane)
+        {
+            OutTriangles[Lane] = (std::min)(Block * FaceLaneCount + Lane, TriangleCount - 1);
+        }
+    }
+
+    bool IsTriangleInRange(const std::vector<uint32_t>& Indices, uint32_t Triangle, size_t VertexCount)
+    {
+        const uint32_t* Corners = Indices.data() + static_cast<size_t>(Triangle) * 3;
+        return Corners[0] < VertexCount && Corners[1] < VertexCount && Corners[2] < VertexCount;
+    }
+
+    // Out-of-range indices read vertex 0; such triangles are dropped before their results are used.
+    const FMesh::FVertex& GetCornerVertex(const std::vector<FMesh::FVertex>& Vertices, const std::vector<uint32_t>& Indices, uint32_t Triangle, uint32_t Corner)
+    {
+        const uint32_t Index = Indices[static_cast<size_t>(Triangle) * 3 + Corner];
+        return Vertices[Index < Vertices.size() ? Index : 0];
+    }
+
+    void GatherPositions(const std::vector<FMesh::FVertex>& Vertices, const std::vector<uint32_t>& Indices, const uint32_t (&Triangles)[FaceLaneCount], uint32_t Corner,
+        DirectX::XMVECTOR& OutX, DirectX::XMVECTOR& OutY, DirectX::XMVECTOR& OutZ)
+    {
+        const FFloat3& P0 = GetCornerVertex(Vertices, Indices, Triangles[0], Corner).Position;
+        const FFloat3& P1 = GetCornerVertex(Vertices, Indices, Triangles[1], Corner).Position;
+        const FFloat3& P2 = GetCornerVertex(Vertices, Indices, Triangles[2], Corner).Position;
+        const FFloat3& P3 = GetCornerVertex(Vertices, Indices, Triangles[3], Corner).Position;
+        OutX = DirectX::XMVectorSet(P0.x, P1.x, P2.x, P3.x);
+        OutY = DirectX::XMVectorSet(P0.y, P1.y, P2.y, P3.y);
+        OutZ = DirectX::XMVectorSet(P0.z, P1.z, P2.z, P3.z);
+    }
+
+    void GatherUVs(const std::vector<FMesh::FVertex>& Vertices, const std::vector<uint32_t>& Indices, const uint32_t (&Triangles)[FaceLaneCount], uint32_t Corner,
+        DirectX::XMVECTOR& OutU, DirectX::XMVECTOR& OutV)
+    {
+        const FFloat2& UV0 = GetCornerVertex(Vertices, Indices, Triangles[0], Corner).UV;
+        const FFloat2& UV1 = GetCornerVertex(Vertices, Indices, Triangles[1], Corner).UV;
+        const FFloat2& UV2 = GetCornerVertex(Vertices, Indices, Triangles[2], Corner).UV;
+        const FFloat2& UV3 = GetCornerVertex(Vertices, Indices, Triangles[3], Corner).UV;
+        OutU = DirectX::XMVectorSet(UV0.x, UV1.x, UV2.x, UV3.x);
+        OutV = DirectX::XMVectorSet(UV0.y, UV1.y, UV2.y, UV3.y);
+    }
+
+    /**
+     * Used triangles per vertex in ascending order, one entry per corner. Summing a vertex's face
+     * vectors in this order reproduces the serial per-triangle accumulation exactly, while every
+     * vertex can be gathered independently.
+     */
+    struct FVertexTriangles
+    {
+        std::vector<uint32_t> Offsets;
+        std::vector<uint32_t> Triangles;
+
+        void Build(const std::vector<uint32_t>& Indices, uint32_t TriangleCount, size_t VertexCount, const std::vector<uint8_t>& TriangleUsed)
+        {
+            Offsets.assign(VertexCount + 1, 0);
+            for (uint32_t Triangle = 0; Triangle < TriangleCount; ++Triangle)
+            {
+                if (TriangleUsed[Triangle])
+                {
+                    for (uint32_t Corner = 0; Corner < 3; ++Corner)
+                    {
+                        ++Offsets[Indices[static_cast<size_t>(Triangle) * 3 + Corner] + 1];
+                    }
+                }
+            }
+            for (size_t Vertex = 0; Vertex < VertexCount; ++Vertex)
+            {
+                Offsets[Vertex + 1] += Offsets[Vertex];
+            }
+
+            Triangles.resize(Offsets[VertexCount]);
+            std::vector<uint32_t> Cursors(Offsets.begin(), Offsets.end() - 1);
+            for (uint32_t Triangle = 0; Triangle < TriangleCount; ++Triangle)
+            {
+                if (TriangleUsed[Triangle])
+                {
+                    for (uint32_t Corner = 0; Corner < 3; ++Corner)
+                    {
+                        Triangles[Cursors[Indices[static_cast<size_t>(Triangle) * 3 + Corner]]++] = Triangle;
+                    }
+                }
+            }
+        }
+    };
+
+    /**
+     * Per-vertex sums of the used triangles' face vectors, added in triangle order either way so
+     * the result matches a serial scatter exactly. Small meshes, or runs without workers, scatter
+     * directly; large ones gather each vertex in parallel through FVertexTriangles.
+     */
+    void SumFaceVectors(
+        const std::vector<uint32_t>& Indices,
+        uint32_t TriangleCount,
+        size_t VertexCount,
+        const std::vector<uint8_t>& FaceUsed,
+        const FFaceStream* const* Streams,
+        std::vector<DirectX::XMVECTOR>* OutSums,
+        uint32_t StreamCount)
+    {
+        using namespace DirectX;
+
+        for (uint32_t Stream = 0; Stream < StreamCount; ++Stream)
+        {
+            OutSums[Stream].assign(VertexCount, XMVectorZero());
+        }
+
+        FTaskScheduler& Scheduler = FTaskScheduler::Get();
+        if (!Scheduler.IsRunning() || Scheduler.GetWorkerThreadCount() == 0 || TriangleCount < MinParallelTriangles)
+        {
+            for (uint32_t Triangle = 0; Triangle < TriangleCount; ++Triangle)
+            {
+                if (!FaceUsed[Triangle])
+                {
+                    continue;
+                }
+                for (uint32_t Stream = 0; Stream < StreamCount; ++Stream)
+                {
+                    const XMVECTOR Face = Streams[Stream]->Load(Triangle);
+                    for (uint32_t Corner = 0; Corner < 3; ++Corner)
+                    {
+                        XMVECTOR& Sum = OutSums[Stream][Indices[static_cast<size_t>(Triangle) * 3 + Corner]];
+                        Sum = XMVectorAdd(Sum, Face);
+                    }
+                }
+            }
+            return;
+        }
+
+        FVertexTriangles VertexTriangles;
+        VertexTriangles.Build(Indices, TriangleCount, VertexCount, FaceUsed);
+
+        FParallelFor::ExecuteRange(0, static_cast<uint32_t>(VertexCount), [&](uint32_t Begin, uint32_t End)
+        {
+            for (uint32_t Vertex = Begin; Vertex < End; ++Vertex)
+            {
+                for (uint32_t Stream = 0; Stream < StreamCount; ++Stream)
+                {
+                    XMVECTOR Sum = XMVectorZero();
+                    for (uint32_t Entry = VertexTriangles.Offsets[Vertex]; Entry < VertexTriangles.Offsets[Vertex + 1]; ++Entry)
+                    {
+                        Sum = XMVectorAdd(Sum, Streams[Stream]->Load(VertexTriangles.Triangles[Entry]));
+                    }
+                    OutSums[Stream][Vertex] = Sum;
+                }
+            }
+        }, MinVerticesPerChunk);
+    }
 }
 
 FMesh FMesh::CreateCube(float Size)
@@ -206,37 +394,63 @@ void FMesh::GenerateNormalsIfMissing()
         return;
     }
 
-    std::vector<XMVECTOR> NormalAccum(Vertices.size(), XMVectorZero());
+    const uint32_t TriangleCount = static_cast<uint32_t>(Indices.size() / 3);
+    const uint32_t BlockCount = (TriangleCount + FaceLaneCount - 1) / FaceLaneCount;
 
-    for (size_t i = 0; i + 2 < Indices.size(); i += 3)
-    {
-        const uint32_t Index0 = Indices[i];
-        const uint32_t Index1 = Indices[i + 1];
-        const uint32_t Index2 = Indices[i + 2];
-
-        const XMVECTOR P0 = XMLoadFloat3(&Vertices[Index0].Position);
-        const XMVECTOR P1 = XMLoadFloat3(&Vertices[Index1].Position);
-        const XMVECTOR P2 = XMLoadFloat3(&Vertices[Index2].Position);
+    FFaceStream FaceNormals;
+    FaceNormals.Resize(static_cast<size_t>(BlockCount) * FaceLaneCount);
+    std::vector<uint8_t> FaceUsed(FaceNormals.X.size(), 0);
 
-        const XMVECTOR Edge1 = XMVectorSubtract(P1, P0);
-        const XMVECTOR Edge2 = XMVectorSubtract(P2, P0);
-        const XMVECTOR FaceNormal = XMVector3Cross(Edge1, Edge2);
+    FParallelFor::ExecuteRange(0, BlockCount, [&](uint32_t BlockBegin, uint32_t BlockEnd)
+    {
+        for (uint32_t Block = BlockBegin; Block < BlockEnd; ++Block)
+        {
+            uint32_t Triangles[FaceLaneCount];
+            GetBlockTriangles(Block, TriangleCount, Triangles);
+
+            XMVECTOR X0, Y0, Z0, X1, Y1, Z1, X2, Y2, Z2;
+            GatherPositions(Vertices, Indices, Triangles, 0, X0, Y0, Z0);
+            GatherPositions(Vertices, Indices, Triangles, 1, X1, Y1, Z1);
+            GatherPositions(Vertices, Indices, Triangles, 2, X2, Y2, Z2);
+
+            const XMVECTOR Edge1X = XMVectorSubtract(X1, X0);
+            const XMVECTOR Edge1Y = XMVectorSubtract(Y1, Y0);
+            const XMVECTOR Edge1Z = XMVectorSubtract(Z1, Z0);
+            const XMVECTOR Edge2X = XMVectorSubtract(X2, X0);
+            const XMVECTOR Edge2Y = XMVectorSubtract(Y2, Y0);
+            const XMVECTOR Edge2Z = XMVectorSubtract(Z2, Z0);
+
+            // Same operation order as XMVector3Cross, so four lanes match the per-triangle result exactly
+            const size_t First = static_cast<size_t>(Block) * FaceLaneCount;
+            FaceNormals.Store(First,
+                XMVectorNegativeMultiplySubtract(Edge1Z, Edge2Y, XMVectorMultiply(Edge1Y, Edge2Z)),
+                XMVectorNegativeMultiplySubtract(Edge1X, Edge2Z, XMVectorMultiply(Edge1Z, Edge2X)),
+                XMVectorNegativeMultiplySubtract(Edge1Y, Edge2X, XMVectorMultiply(Edge1X, Edge2Y)));
+
+            for (uint32_t Lane = 0; Lane < FaceLaneCount; ++Lane)
+            {
+                FaceUsed[First + Lane] = First + Lane < TriangleCount && IsTriangleInRange(Indices, Triangles[Lane], Vertices.size()) ? 1 : 0;
+            }
+        }
+    }, MinFaceBlocksPerChunk);
 
-        NormalAccum[Index0] = XMVectorAdd(NormalAccum[Index0], FaceNormal);
-        NormalAccum[Index1] = XMVectorAdd(NormalAccum[Index1], FaceNormal);
-        NormalAccum[Index2] = XMVectorAdd(NormalAccum[Index2], FaceNormal);
-    }
+    const FFaceStream* Streams[] = { &FaceNormals };
+    std::vector<XMVECTOR> NormalAccum;
+    SumFaceVectors(Indices, TriangleCount, Vertices.size(), FaceUsed, Streams, &NormalAccum, 1);
 
-    for (size_t i = 0; i < Vertices.size(); ++i)
+    FParallelFor::ExecuteRange(0, static_cast<uint32_t>(Vertices.size()), [&](uint32_t Begin, uint32_t End)
     {
-        XMVECTOR Normal = NormalAccum[i];
-        if (XMVector3LessOrEqual(XMVector3LengthSq(Normal), XMVectorReplicate(1e-8f)))
+        for (uint32_t i = Begin; i < End; ++i)
         {
-            Normal = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+            XMVECTOR Normal = NormalAccum[i];
+            if (XMVector3LessOrEqual(XMVector3LengthSq(Normal), XMVectorReplicate(1e-8f)))
+            {
+                Normal = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+            }
+            Normal = XMVector3Normalize(Normal);
+            XMStoreFloat3(&Vertices[i].Normal, Normal);
         }
-        Normal = XMVector3Normalize(Normal);
-        XMStoreFloat3(&Vertices[i].Normal, Normal);
-    }
+    }, MinVerticesPerChunk);
 }
 
 void FMesh::GenerateTangentsIfMissing()
@@ -258,74 +472,103 @@ void FMesh::GenerateTangentsIfMissing()
         return;
     }
 
-    std::vector<XMVECTOR> TangentAccum(Vertices.size(), XMVectorZero());
-    std::vector<XMVECTOR> BitangentAccum(Vertices.size(), XMVectorZero());
-
-    for (size_t i = 0; i + 2 < Indices.size(); i += 3)
-    {
-        const uint32_t Index0 = Indices[i];
-        const uint32_t Index1 = Indices[i + 1];
-        const uint32_t Index2 = Indices[i + 2];
-
-        const XMVECTOR P0 = XMLoadFloat3(&Vertices[Index0].Position);
-        const XMVECTOR P1 = XMLoadFloat3(&Vertices[Index1].Position);
-        const XMVECTOR P2 = XMLoadFloat3(&Vertices[Index2].Position);
+    const uint32_t TriangleCount = static_cast<uint32_t>(Indices.size() / 3);
+    const uint32_t BlockCount = (TriangleCount + FaceLaneCount - 1) / FaceLaneCount;
 
-        const XMVECTOR UV0 = XMLoadFloat2(&Vertices[Index0].UV);
-        const XMVECTOR UV1 = XMLoadFloat2(&Vertices[Index1].UV);
-        const XMVECTOR UV2 = XMLoadFloat2(&Vertices[Index2].UV);
+    FFaceStream FaceTangents;
+    FFaceStream FaceBitangents;
+    FaceTangents.Resize(static_cast<size_t>(BlockCount) * FaceLaneCount);
+    FaceBitangents.Resize(FaceTangents.X.size());
+    std::vector<uint8_t> FaceUsed(FaceTangents.X.size(), 0);
 
-        const XMVECTOR Edge1 = XMVectorSubtract(P1, P0);
-        const XMVECTOR Edge2 = XMVectorSubtract(P2, P0);
-        const XMVECTOR DeltaUV1 = XMVectorSubtract(UV1, UV0);
-        const XMVECTOR DeltaUV2 = XMVectorSubtract(UV2, UV0);
-
-        const float Determinant = XMVectorGetX(DeltaUV1) * XMVectorGetY(DeltaUV2) - XMVectorGetY(DeltaUV1) * XMVectorGetX(DeltaUV2);
-        if (std::abs(Determinant) < 1e-8f)
+    FParallelFor::ExecuteRange(0, BlockCount, [&](uint32_t BlockBegin, uint32_t BlockEnd)
+    {
+        for (uint32_t Block = BlockBegin; Block < BlockEnd; ++Block)
         {
-            continue;
+            uint32_t Triangles[FaceLaneCount];
+            GetBlockTriangles(Block, TriangleCount, Triangles);
+
+            XMVECTOR X0, Y0, Z0, X1, Y1, Z1, X2, Y2, Z2;
+            GatherPositions(Vertices, Indices, Triangles, 0, X0, Y0, Z0);
+            GatherPositions(Vertices, Indices, Triangles, 1, X1, Y1, Z1);
+            GatherPositions(Vertices, Indices, Triangles, 2, X2, Y2, Z2);
+
+            XMVECTOR U0, V0, U1, V1, U2, V2;
+            GatherUVs(Vertices, Indices, Triangles, 0, U0, V0);
+            GatherUVs(Vertices, Indices, Triangles, 1, U1, V1);
+            GatherUVs(Vertices, Indices, Triangles, 2, U2, V2);
+
+            const XMVECTOR Edge1X = XMVectorSubtract(X1, X0);
+            const XMVECTOR Edge1Y = XMVectorSubtract(Y1, Y0);
+            const XMVECTOR Edge1Z = XMVectorSubtract(Z1, Z0);
+            const XMVECTOR Edge2X = XMVectorSubtract(X2, X0);
+            const XMVECTOR Edge2Y = XMVectorSubtract(Y2, Y0);
+            const XMVECTOR Edge2Z = XMVectorSubtract(Z2, Z0);
+            const XMVECTOR DeltaU1 = XMVectorSubtract(U1, U0);
+            const XMVECTOR DeltaV1 = XMVectorSubtract(V1, V0);
+            const XMVECTOR DeltaU2 = XMVectorSubtract(U2, U0);
+            const XMVECTOR DeltaV2 = XMVectorSubtract(V2, V0);
+
+            const XMVECTOR Determinant = XMVectorSubtract(XMVectorMultiply(DeltaU1, DeltaV2), XMVectorMultiply(DeltaV1, DeltaU2));
+            const XMVECTOR InvDet = XMVectorReciprocal(Determinant);
+
+            const size_t First = static_cast<size_t>(Block) * FaceLaneCount;
+            FaceTangents.Store(First,
+                XMVectorMultiply(XMVectorSubtract(XMVectorMultiply(Edge1X, DeltaV2), XMVectorMultiply(Edge2X, DeltaV1)), InvDet),
+                XMVectorMultiply(XMVectorSubtract(XMVectorMultiply(Edge1Y, DeltaV2), XMVectorMultiply(Edge2Y, DeltaV1)), InvDet),
+                XMVectorMultiply(XMVectorSubtract(XMVectorMultiply(Edge1Z, DeltaV2), XMVectorMultiply(Edge2Z, DeltaV1)), InvDet));
+            FaceBitangents.Store(First,
+                XMVectorMultiply(XMVectorSubtract(XMVectorMultiply(Edge2X, DeltaU1), XMVectorMultiply(Edge1X, DeltaU2)), InvDet),
+                XMVectorMultiply(XMVectorSubtract(XMVectorMultiply(Edge2Y, DeltaU1), XMVectorMultiply(Edge1Y, DeltaU2)), InvDet),
+                XMVectorMultiply(XMVectorSubtract(XMVectorMultiply(Edge2Z, DeltaU1), XMVectorMultiply(Edge1Z, DeltaU2)), InvDet));
+
+            // Triangles with a degenerate UV mapping contribute nothing
+            XMFLOAT4 Determinants;
+            XMStoreFloat4(&Determinants, Determinant);
+            const float DeterminantLanes[FaceLaneCount] = { Determinants.x, Determinants.y, Determinants.z, Determinants.w };
+            for (uint32_t Lane = 0; Lane < FaceLaneCount; ++Lane)
+            {
+                const bool bUsed = First + Lane < TriangleCount
+                    && IsTriangleInRange(Indices, Triangles[Lane], Vertices.size())
+                    && !(std::abs(DeterminantLanes[Lane]) < 1e-8f);
+                FaceUsed[First + Lane] = bUsed ? 1 : 0;
+            }
         }
+    }, MinFaceBlocksPerChunk);
 
-        const float InvDet = 1.0f / Determinant;
-        const XMVECTOR Tangent = XMVectorScale(
-            XMVectorSubtract(XMVectorScale(Edge1, XMVectorGetY(DeltaUV2)), XMVectorScale(Edge2, XMVectorGetY(DeltaUV1))), InvDet);
-        const XMVECTOR Bitangent = XMVectorScale(
-            XMVectorSubtract(XMVectorScale(Edge2, XMVectorGetX(DeltaUV1)), XMVectorScale(Edge1, XMVectorGetX(DeltaUV2))), InvDet);
-
-        TangentAccum[Index0] = XMVectorAdd(TangentAccum[Index0], Tangent);
-        TangentAccum[Index1] = XMVectorAdd(TangentAccum[Index1], Tangent);
-        TangentAccum[Index2] = XMVectorAdd(TangentAccum[Index2], Tangent);
+    const FFaceStream* Streams[] = { &FaceTangents, &FaceBitangents };
+    std::vector<XMVECTOR> Accum[2];
+    SumFaceVectors(Indices, TriangleCount, Vertices.size(), FaceUsed, Streams, Accum, 2);
+    const std::vector<XMVECTOR>& TangentAccum = Accum[0];
+    const std::vector<XMVECTOR>& BitangentAccum = Accum[1];
 
-        BitangentAccum[Index0] = XMVectorAdd(BitangentAccum[Index0], Bitangent);
-        BitangentAccum[Index1] = XMVectorAdd(BitangentAccum[Index1], Bitangent);
-        BitangentAccum[Index2] = XMVectorAdd(BitangentAccum[Index2], Bitangent);
-    }
-
-    for (size_t i = 0; i < Vertices.size(); ++i)
+    FParallelFor::ExecuteRange(0, static_cast<uint32_t>(Vertices.size()), [&](uint32_t Begin, uint32_t End)
     {
-        XMVECTOR Normal = XMLoadFloat3(&Vertices[i].Normal);
-        if (XMVector3LessOrEqual(XMVector3LengthSq(Normal), XMVectorReplicate(1e-8f)))
+        for (uint32_t i = Begin; i < End; ++i)
         {
-            Normal = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
-        }
-        Normal = XMVector3Normalize(Normal);
+            XMVECTOR Tangent = TangentAccum[i];
+            XMVECTOR Bitangent = BitangentAccum[i];
 
-        XMVECTOR Tangent = TangentAccum[i];
-        XMVECTOR Bitangent = BitangentAccum[i];
+            XMVECTOR Normal = XMLoadFloat3(&Vertices[i].Normal);
+            if (XMVector3LessOrEqual(XMVector3LengthSq(Normal), XMVectorReplicate(1e-8f)))
+            {
+                Normal = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+            }
+            Normal = XMVector3Normalize(Normal);
 
-        if (XMVector3LessOrEqual(XMVector3LengthSq(Tangent), XMVectorReplicate(1e-8f)) ||
-            XMVector3LessOrEqual(XMVector3LengthSq(Bitangent), XMVectorReplicate(1e-8f)))
-        {
-            Tangent = BuildOrthonormalTangent(Normal);
-            Bitangent = XMVector3Cross(Normal, Tangent);
-            XMStoreFloat4(&Vertices[i].Tangent, XMVectorSetW(Tangent, 1.0f));
-            continue;
-        }
+            if (XMVector3LessOrEqual(XMVector3LengthSq(Tangent), XMVectorReplicate(1e-8f)) ||
+                XMVector3LessOrEqual(XMVector3LengthSq(Bitangent), XMVectorReplicate(1e-8f)))
+            {
+                Tangent = BuildOrthonormalTangent(Normal);
+                XMStoreFloat4(&Vertices[i].Tangent, XMVectorSetW(Tangent, 1.0f));
+                continue;
+            }
 
-        Tangent = XMVector3Normalize(XMVectorSubtract(Tangent, XMVectorScale(Normal, XMVectorGetX(XMVector3Dot(Normal, Tangent)))));
-        Bitangent = XMVector3Normalize(Bitangent);
+            Tangent = XMVector3Normalize(XMVectorSubtract(Tangent, XMVectorScale(Normal, XMVectorGetX(XMVector3Dot(Normal, Tangent)))));
+            Bitangent = XMVector3Normalize(Bitangent);
 
-        const float Handedness = XMVectorGetX(XMVector3Dot(XMVector3Cross(Normal, Tangent), Bitangent)) < 0.0f ? -1.0f : 1.0f;
-        XMStoreFloat4(&Vertices[i].Tangent, XMVectorSetW(Tangent, Handedness));
-    }
+            const float Handedness = XMVectorGetX(XMVector3Dot(XMVector3Cross(Normal, Tangent), Bitangent)) < 0.0f ? -1.0f : 1.0f;
+            XMStoreFloat4(&Vertices[i].Tangent, XMVectorSetW(Tangent, Handedness));
+        }
+    }, MinVerticesPerChunk);
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <utility>
 #include <vector>
 #include "../Math/MathTypes.h"
 
@@ -17,6 +18,8 @@ public:
 
     void SetVertices(const std::vector<FVertex>& InVertices) { Vertices = InVertices; }
     void SetIndices(const std::vector<uint32_t>& InIndices) { Indices = InIndices; }
+    void SetVertices(std::vector<FVertex>&& InVertices) { Vertices = std::move(InVertices); }
+    void SetIndices(std::vector<uint32_t>&& InIndices) { Indices = std::move(InIndices); }
 
     const std::vector<FVertex>& GetVertices() const { return Vertices; }
     const std::vector<uint32_t>& GetIndices() const { return Indices; }
@@ -0,0 +1,431 @@
+#include "MeshOptimizer.h"
+
+#include <DirectXMath.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+    // Scoring constants from Tom Forsyth, "Linear-Speed Vertex Cache Optimisation".
+    constexpr uint32_t ForsythCacheSize = 32;
+    constexpr float CacheDecayPower = 1.5f;
+    constexpr float LastTriangleScore = 0.75f;
+    constexpr float ValenceBoostScale = 2.0f;
+    constexpr float ValenceBoostPower = 0.5f;
+
+    // Overdraw clusters shorter than this are not split further.
+    constexpr uint32_t MinSoftClusterTriangles = 32;
+
+    float ScoreVertex(int32_t CachePosition, uint32_t RemainingTriangles)
+    {
+        if (RemainingTriangles == 0)
+        {
+            return -1.0f;
+        }
+
+        float Score = 0.0f;
+        if (CachePosition >= 0)
+        {
+            if (CachePosition < 3)
+            {
+                // The triangle just emitted: its vertices are equally likely to be reused.
+                Score = LastTriangleScore;
+            }
+            else
+            {
+                const float Scaler = 1.0f / static_cast<float>(ForsythCacheSize - 3);
+                Score = std::pow(1.0f - static_cast<float>(CachePosition - 3) * Scaler, CacheDecayPower);
+            }
+        }
+
+        // Favour vertices with few triangles left so they are finished off and leave the cache.
+        Score += ValenceBoostScale * std::pow(static_cast<float>(RemainingTriangles), -ValenceBoostPower);
+        return Score;
+    }
+
+    // FIFO post-transform cache simulation: a vertex hits when it was added in the last CacheSize misses.
+    struct FFifoCache
+    {
+        std::vector<uint32_t> Timestamps;
+        uint32_t CacheSize = 16;
+        uint32_t Time = 0;
+
+        FFifoCache(uint32_t VertexCount, uint32_t InCacheSize)
+            : Timestamps(VertexCount, 0)
+            , CacheSize(InCacheSize)
+            , Time(InCacheSize + 1)
+        {
+        }
+
+        uint32_t TriangleMisses(const uint32_t* Triangle)
+        {
+            uint32_t Misses = 0;
+            for (uint32_t Corner = 0; Corner < 3; ++Corner)
+            {
+                uint32_t& Timestamp = Timestamps[Triangle[Corner]];
+                if (Time - Timestamp > CacheSize)
+                {
+                    Timestamp = Time++;
+                    ++Misses;
+                }
+            }
+            return Misses;
+        }
+
+        void Flush()
+        {
+            Time += CacheSize + 1;
+        }
+    };
+
+    bool AreIndicesInRange(const uint32_t* Indices, uint32_t IndexCount, uint32_t VertexCount)
+    {
+        return std::all_of(Indices, Indices + IndexCount, [VertexCount](uint32_t Index) { return Index < VertexCount; });
+    }
+}
+
+void FMeshOptimizer::Optimize(FMesh& Mesh, const std::vector<FMeshIndexRange>& Ranges)
+{
+    std::vector<FMesh::FVertex> Vertices = Mesh.GetVertices();
+    std::vector<uint32_t> Indices = Mesh.GetIndices();
+    const uint32_t VertexCount = static_cast<uint32_t>(Vertices.size());
+    if (Indices.empty() || !AreIndicesInRange(Indices.data(), static_cast<uint32_t>(Indices.size()), VertexCount))
+    {
+        return;
+    }
+
+    std::vector<FMeshIndexRange> OptimizedRanges = Ranges;
+    if (OptimizedRanges.empty())
+    {
+        OptimizedRanges.push_back({ 0, static_cast<uint32_t>(Indices.size()) });
+    }
+
+    for (const FMeshIndexRange& Range : OptimizedRanges)
+    {
+        if (Range.IndexStart >= Indices.size())
+        {
+            continue;
+        }
+
+        // Only whole triangles are reordered; a trailing partial triangle stays where it is.
+        const uint32_t IndexCount = (std::min)(Range.IndexCount, static_cast<uint32_t>(Indices.size()) - Range.IndexStart) / 3 * 3;
+        uint32_t* RangeIndices = Indices.data() + Range.IndexStart;
+        OptimizeVertexCache(RangeIndices, IndexCount, VertexCount);
+        OptimizeOverdraw(RangeIndices, IndexCount, Vertices);
+    }
+
+    OptimizeVertexFetch(Vertices, Indices);
+    Mesh.SetVertices(Vertices);
+    Mesh.SetIndices(Indices);
+}
+
+void FMeshOptimizer::OptimizeVertexCache(uint32_t* Indices, uint32_t IndexCount, uint32_t VertexCount)
+{
+    const uint32_t TriangleCount = IndexCount / 3;
+    if (TriangleCount < 2 || !AreIndicesInRange(Indices, TriangleCount * 3, VertexCount))
+    {
+        return;
+    }
+
+    // Vertex -> triangle adjacency. The live triangles of vertex V are
+    // Adjacency[AdjacencyOffsets[V], AdjacencyOffsets[V] + RemainingTriangles[V]).
+    std::vector<uint32_t> AdjacencyOffsets(VertexCount + 1, 0);
+    for (uint32_t Index = 0; Index < TriangleCount * 3; ++Index)
+    {
+        ++AdjacencyOffsets[Indices[Index] + 1];
+    }
+    std::partial_sum(AdjacencyOffsets.begin(), AdjacencyOffsets.end(), AdjacencyOffsets.begin());
+
+    std::vector<uint32_t> Adjacency(TriangleCount * 3);
+    std::vector<uint32_t> RemainingTriangles(VertexCount, 0);
+    for (uint32_t Triangle = 0; Triangle < TriangleCount; ++Triangle)
+    {
+        for (uint32_t Corner = 0; Corner < 3; ++Corner)
+        {
+            const uint32_t Vertex = Indices[Triangle * 3 + Corner];
+            Adjacency[AdjacencyOffsets[Vertex] + RemainingTriangles[Vertex]++] = Triangle;
+        }
+    }
+
+    std::vector<int32_t> CachePositions(VertexCount, -1);
+    std::vector<float> VertexScores(VertexCount);
+    for (uint32_t Vertex = 0; Vertex < VertexCount; ++Vertex)
+    {
+        VertexScores[Vertex] = ScoreVertex(-1, RemainingTriangles[Vertex]);
+    }
+
+    std::vector<float> TriangleScores(TriangleCount);
+    for (uint32_t Triangle = 0; Triangle < TriangleCount; ++Triangle)
+    {
+        const uint32_t* Corners = Indices + Triangle * 3;
+        TriangleScores[Triangle] = VertexScores[Corners[0]] + VertexScores[Corners[1]] + VertexScores[Corners[2]];
+    }
+
+    std::vector<uint8_t> Emitted(TriangleCount, 0);
+    std::vector<uint32_t> Output;
+    Output.reserve(TriangleCount * 3);
+
+    uint32_t Cache[ForsythCacheSize + 3];
+    uint32_t CacheCount = 0;
+    uint32_t ScanCursor = 0;
+    int64_t BestTriangle = 0;
+
+    for (uint32_t EmittedCount = 0; EmittedCount < TriangleCount; ++EmittedCount)
+    {
+        if (BestTriangle < 0)
+        {
+            // Nothing in the cache connects to a live triangle: continue with the next one in input order.
+            while (Emitted[ScanCursor])
+            {
+                ++ScanCursor;
+            }
+            BestTriangle = ScanCursor;
+        }
+
+        const uint32_t Triangle = static_cast<uint32_t>(BestTriangle);
+        const uint32_t Corners[3] = { Indices[Triangle * 3], Indices[Triangle * 3 + 1], Indices[Triangle * 3 + 2] };
+        Emitted[Triangle] = 1;
+        Output.insert(Output.end(), Corners, Corners + 3);
+
+        for (uint32_t Vertex : Corners)
+        {
+            uint32_t* Live = Adjacency.data() + AdjacencyOffsets[Vertex];
+            uint32_t& Remaining = RemainingTriangles[Vertex];
+            uint32_t* Found = std::find(Live, Live + Remaining, Triangle);
+            if (Found != Live + Remaining)
+            {
+                std::swap(*Found, Live[Remaining - 1]);
+                --Remaining;
+            }
+        }
+
+        // The emitted triangle moves to the front of the LRU cache.
+        uint32_t NewCache[ForsythCacheSize + 3];
+        uint32_t NewCacheCount = 0;
+        for (uint32_t Vertex : Corners)
+        {
+            if (std::find(NewCache, NewCache + NewCacheCount, Vertex) == NewCache + NewCacheCount)
+            {
+                NewCache[NewCacheCount++] = Vertex;
+            }
+        }
+        const uint32_t EmittedVertexCount = NewCacheCount;
+        for (uint32_t CacheIndex = 0; CacheIndex < CacheCount; ++CacheIndex)
+        {
+            const uint32_t Vertex = Cache[CacheIndex];
+            if (std::find(NewCache, NewCache + EmittedVertexCount, Vertex) == NewCache + EmittedVertexCount)
+            {
+                NewCache[NewCacheCount++] = Vertex;
+            }
+        }
+
+        for (uint32_t CacheIndex = 0; CacheIndex < NewCacheCount; ++CacheIndex)
+        {
+            const uint32_t Vertex = NewCache[CacheIndex];
+            CachePositions[Vertex] = CacheIndex < ForsythCacheSize ? static_cast<int32_t>(CacheIndex) : -1;
+
+            const float Score = ScoreVertex(CachePositions[Vertex], RemainingTriangles[Vertex]);
+            const float ScoreDelta = Score - VertexScores[Vertex];
+            VertexScores[Vertex] = Score;
+
+            const uint32_t* Live = Adjacency.data() + AdjacencyOffsets[Vertex];
+            for (uint32_t LiveIndex = 0; LiveIndex < RemainingTriangles[Vertex]; ++LiveIndex)
+            {
+                TriangleScores[Live[LiveIndex]] += ScoreDelta;
+            }
+        }
+
+        CacheCount = (std::min)(NewCacheCount, ForsythCacheSize);
+        std::copy(NewCache, NewCache + CacheCount, Cache);
+
+        BestTriangle = -1;
+        float BestScore = -1.0f;
+        for (uint32_t CacheIndex = 0; CacheIndex < CacheCount; ++CacheIndex)
+        {
+            const uint32_t Vertex = Cache[CacheIndex];
+            const uint32_t* Live = Adjacency.data() + AdjacencyOffsets[Vertex];
+            for (uint32_t LiveIndex = 0; LiveIndex < RemainingTriangles[Vertex]; ++LiveIndex)
+            {
+                const uint32_t Candidate = Live[LiveIndex];
+                if (TriangleScores[Candidate] > BestScore)
+                {
+                    BestScore = TriangleScores[Candidate];
+                    BestTriangle = Candidate;
+                }
+            }
+        }
+    }
+
+    std::copy(Output.begin(), Output.end(), Indices);
+}
+
+void FMeshOptimizer::OptimizeOverdraw(uint32_t* Indices, uint32_t IndexCount, const std::vector<FMesh::FVertex>& Vertices, float Threshold)
+{
+    using namespace DirectX;
+
+    const uint32_t TriangleCount = IndexCount / 3;
+    const uint32_t VertexCount = static_cast<uint32_t>(Vertices.size());
+    if (TriangleCount < MinSoftClusterTriangles * 2 || !AreIndicesInRange(Indices, TriangleCount * 3, VertexCount))
+    {
+        return;
+    }
+
+    // Hard boundaries: triangles that miss the cache on all three vertices start a new strip of work.
+    std::vector<uint32_t> HardClusterStarts;
+    {
+        FFifoCache Cache(VertexCount, 16);
+        for (uint32_t Triangle = 0; Triangle < TriangleCount; ++Triangle)
+        {
+            if (Cache.TriangleMisses(Indices + Triangle * 3) == 3)
+            {
+                HardClusterStarts.push_back(Triangle);
+            }
+        }
+    }
+    HardClusterStarts.push_back(TriangleCount);
+
+    // Soft boundaries: within a hard cluster, cut once the running ACMR (from a flushed cache) has
+    // come down to within Threshold of the cluster's own ACMR.
+    std::vector<uint32_t> ClusterStarts;
+    {
+        FFifoCache Cache(VertexCount, 16);
+        for (size_t HardIndex = 0; HardIndex + 1 < HardClusterStarts.size(); ++HardIndex)
+        {
+            const uint32_t Start = HardClusterStarts[HardIndex];
+            const uint32_t End = HardClusterStarts[HardIndex + 1];
+            const float ClusterAcmr = ComputeAcmr(Indices + Start * 3, (End - Start) * 3, VertexCount);
+
+            Cache.Flush();
+            ClusterStarts.push_back(Start);
+            uint32_t Misses = 0;
+            uint32_t Triangles = 0;
+            for (uint32_t Triangle = Start; Triangle < End; ++Triangle)
+            {
+                Misses += Cache.TriangleMisses(Indices + Triangle * 3);
+                ++Triangles;
+
+                const bool bRoomForNext = End - (Triangle + 1) >= MinSoftClusterTriangles;
+                if (Triangles >= MinSoftClusterTriangles && bRoomForNext
+                    && static_cast<float>(Misses) <= ClusterAcmr * Threshold * static_cast<float>(Triangles))
+                {
+                    Cache.Flush();
+                    ClusterStarts.push_back(Triangle + 1);
+                    Misses = 0;
+                    Triangles = 0;
+                }
+            }
+        }
+    }
+
+    if (ClusterStarts.size() < 2)
+    {
+        return;
+    }
+    ClusterStarts.push_back(TriangleCount);
+
+    const auto LoadPosition = [&Vertices](uint32_t Index)
+    {
+        return XMLoadFloat3(&Vertices[Index].Position);
+    };
+
+    // Area-weighted centroid and normal per cluster.
+    const size_t ClusterCount = ClusterStarts.size() - 1;
+    std::vector<XMFLOAT3> ClusterCentroids(ClusterCount);
+    std::vector<XMFLOAT3> ClusterNormals(ClusterCount);
+    XMVECTOR MeshCentroid = XMVectorZero();
+    float MeshArea = 0.0f;
+    for (size_t Cluster = 0; Cluster < ClusterCount; ++Cluster)
+    {
+        XMVECTOR Centroid = XMVectorZero();
+        XMVECTOR Normal = XMVectorZero();
+        float Area = 0.0f;
+        for (uint32_t Triangle = ClusterStarts[Cluster]; Triangle < ClusterStarts[Cluster + 1]; ++Triangle)
+        {
+            const XMVECTOR P0 = LoadPosition(Indices[Triangle * 3]);
+            const XMVECTOR P1 = LoadPosition(Indices[Triangle * 3 + 1]);
+            const XMVECTOR P2 = LoadPosition(Indices[Triangle * 3 + 2]);
+            const XMVECTOR FaceNormal = XMVector3Cross(XMVectorSubtract(P1, P0), XMVectorSubtract(P2, P0));
+            const float TriangleArea = XMVectorGetX(XMVector3Length(FaceNormal));
+
+            Centroid = XMVectorAdd(Centroid, XMVectorScale(XMVectorAdd(XMVectorAdd(P0, P1), P2), TriangleArea / 3.0f));
+            Normal = XMVectorAdd(Normal, FaceNormal);
+            Area += TriangleArea;
+        }
+
+        MeshCentroid = XMVectorAdd(MeshCentroid, Centroid);
+        MeshArea += Area;
+        XMStoreFloat3(&ClusterCentroids[Cluster], Area > 0.0f ? XMVectorScale(Centroid, 1.0f / Area) : Centroid);
+        XMStoreFloat3(&ClusterNormals[Cluster], XMVector3Normalize(Normal));
+    }
+
+    if (MeshArea <= 0.0f)
+    {
+        return;
+    }
+    MeshCentroid = XMVectorScale(MeshCentroid, 1.0f / MeshArea);
+
+    // Clusters on the outside facing outwards are the likeliest occluders, so they go first.
+    std::vector<float> SortKeys(ClusterCount);
+    for (size_t Cluster = 0; Cluster < ClusterCount; ++Cluster)
+    {
+        const XMVECTOR Offset = XMVectorSubtract(XMLoadFloat3(&ClusterCentroids[Cluster]), MeshCentroid);
+        SortKeys[Cluster] = XMVectorGetX(XMVector3Dot(Offset, XMLoadFloat3(&ClusterNormals[Cluster])));
+    }
+
+    std::vector<uint32_t> ClusterOrder(ClusterCount);
+    std::iota(ClusterOrder.begin(), ClusterOrder.end(), 0u);
+    std::stable_sort(ClusterOrder.begin(), ClusterOrder.end(), [&SortKeys](uint32_t A, uint32_t B)
+    {
+        return SortKeys[A] > SortKeys[B];
+    });
+
+    std::vector<uint32_t> Output;
+    Output.reserve(TriangleCount * 3);
+    for (uint32_t Cluster : ClusterOrder)
+    {
+        Output.insert(Output.end(), Indices + ClusterStarts[Cluster] * 3, Indices + ClusterStarts[Cluster + 1] * 3);
+    }
+    std::copy(Output.begin(), Output.end(), Indices);
+}
+
+void FMeshOptimizer::OptimizeVertexFetch(std::vector<FMesh::FVertex>& Vertices, std::vector<uint32_t>& Indices)
+{
+    const uint32_t VertexCount = static_cast<uint32_t>(Vertices.size());
+    if (!AreIndicesInRange(Indices.data(), static_cast<uint32_t>(Indices.size()), VertexCount))
+    {
+        return;
+    }
+
+    constexpr uint32_t Unmapped = UINT32_MAX;
+    std::vector<uint32_t> Remap(VertexCount, Unmapped);
+    std::vector<FMesh::FVertex> Reordered;
+    Reordered.reserve(VertexCount);
+    for (uint32_t& Index : Indices)
+    {
+        if (Remap[Index] == Unmapped)
+        {
+            Remap[Index] = static_cast<uint32_t>(Reordered.size());
+            Reordered.push_back(Vertices[Index]);
+        }
+        Index = Remap[Index];
+    }
+    Vertices.swap(Reordered);
+}
+
+float FMeshOptimizer::ComputeAcmr(const uint32_t* Indices, uint32_t IndexCount, uint32_t VertexCount, uint32_t CacheSize)
+{
+    const uint32_t TriangleCount = IndexCount / 3;
+    if (TriangleCount == 0 || !AreIndicesInRange(Indices, TriangleCount * 3, VertexCount))
+    {
+        return 0.0f;
+    }
+
+    FFifoCache Cache(VertexCount, CacheSize);
+    uint32_t Misses = 0;
+    for (uint32_t Triangle = 0; Triangle < TriangleCount; ++Triangle)
+    {
+        Misses += Cache.TriangleMisses(Indices + Triangle * 3);
+    }
+    return static_cast<float>(Misses) / static_cast<float>(TriangleCount);
+}
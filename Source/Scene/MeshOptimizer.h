@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Mesh.h"
+
+struct FMeshIndexRange
+{
+    uint32_t IndexStart = 0;
+    uint32_t IndexCount = 0;
+};
+
+/**
+ * Post-load triangle and vertex reordering for GPU rendering. Contents are unchanged; only the
+ * order in which triangles are submitted and vertices are stored.
+ */
+class FMeshOptimizer
+{
+public:
+    // Runs all stages below. Triangles are only reordered inside each range so per-primitive draws
+    // stay valid; an empty list treats the whole index buffer as one range.
+    static void Optimize(FMesh& Mesh, const std::vector<FMeshIndexRange>& Ranges);
+
+    // Reorders triangles for the post-transform vertex cache (Forsyth's linear-speed algorithm).
+    static void OptimizeVertexCache(uint32_t* Indices, uint32_t IndexCount, uint32_t VertexCount);
+
+    // Splits cache-ordered triangles into clusters and draws those facing away from the mesh centre
+    // first, so they occlude the rest. Clusters only end where the running ACMR is within Threshold
+    // of the cache-optimized order, which bounds the cache efficiency given up.
+    static void OptimizeOverdraw(uint32_t* Indices, uint32_t IndexCount, const std::vector<FMesh::FVertex>& Vertices, float Threshold = 1.05f);
+
+    // Renumbers vertices in first-use order so vertex fetch walks memory linearly. Unreferenced
+    // vertices are dropped.
+    static void OptimizeVertexFetch(std::vector<FMesh::FVertex>& Vertices, std::vector<uint32_t>& Indices);
+
+    // Average vertex shader invocations per triangle with a FIFO cache of CacheSize entries.
+    static float ComputeAcmr(const uint32_t* Indices, uint32_t IndexCount, uint32_t VertexCount, uint32_t CacheSize = 16);
+};
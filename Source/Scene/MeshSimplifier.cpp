@@ -0,0 +1,258 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace
+{
+    // Coarser grids than this rarely keep a recognizable silhouette.
+    constexpr uint32_t MinGridResolution = 1;
+    constexpr uint32_t MaxGridResolution = 1024;
+
+    // A level is only kept when it removes at least this share of the previous level's triangles.
+    constexpr float MinLodReduction = 0.1f;
+
+    // Clusters never merge vertices whose normals point along different major axes, which keeps
+    // hard edges and the two sides of thin walls apart.
+    uint32_t GetNormalBucket(const FFloat3& Normal)
+    {
+        const float AbsX = std::fabs(Normal.x);
+        const float AbsY = std::fabs(Normal.y);
+        const float AbsZ = std::fabs(Normal.z);
+        if (AbsX >= AbsY && AbsX >= AbsZ)
+        {
+            return Normal.x >= 0.0f ? 0u : 1u;
+        }
+        if (AbsY >= AbsZ)
+        {
+            return Normal.y >= 0.0f ? 2u : 3u;
+        }
+        return Normal.z >= 0.0f ? 4u : 5u;
+    }
+
+    float DistanceSquared(const FFloat3& A, const FFloat3& B)
+    {
+        const float X = A.x - B.x;
+        const float Y = A.y - B.y;
+        const float Z = A.z - B.z;
+        return X * X + Y * Y + Z * Z;
+    }
+
+    struct FClusterGrid
+    {
+        const std::vector<FMesh::FVertex>* Vertices = nullptr;
+        // Distinct vertices referenced by the simplified index range.
+        std::vector<uint32_t> UsedVertices;
+        FFloat3 BoundsMin{ 0.0f, 0.0f, 0.0f };
+        float Extent = 0.0f;
+
+        // Maps every used vertex to the representative of its cluster at this grid resolution.
+        float BuildRemap(uint32_t Resolution, std::unordered_map<uint32_t, uint32_t>& OutRemap) const
+        {
+            const float CellScale = Extent > 0.0f ? static_cast<float>(Resolution) / Extent : 0.0f;
+            const uint64_t CellsPerAxis = static_cast<uint64_t>(Resolution) + 1;
+            const auto CellCoordinate = [&](float Value, float Min)
+            {
+                const uint64_t Cell = static_cast<uint64_t>((std::max)(0.0f, (Value - Min) * CellScale));
+                return (std::min)(Cell, CellsPerAxis - 1);
+            };
+
+            struct FCluster
+            {
+                FFloat3 Sum{ 0.0f, 0.0f, 0.0f };
+                uint32_t Count = 0;
+                uint32_t Representative = 0;
+                float RepresentativeDistance = (std::numeric_limits<float>::max)();
+            };
+
+            std::unordered_map<uint64_t, uint32_t> ClusterIds;
+            ClusterIds.reserve(UsedVertices.size());
+            std::vector<FCluster> Clusters;
+            std::vector<uint32_t> VertexClusters(UsedVertices.size());
+
+            for (size_t Index = 0; Index < UsedVertices.size(); ++Index)
+            {
+                const FMesh::FVertex& Vertex = (*Vertices)[UsedVertices[Index]];
+                const uint64_t Key =
+                    ((CellCoordinate(Vertex.Position.x, BoundsMin.x) * CellsPerAxis
+                        + CellCoordinate(Vertex.Position.y, BoundsMin.y)) * CellsPerAxis
+                        + CellCoordinate(Vertex.Position.z, BoundsMin.z)) * 6
+                    + GetNormalBucket(Vertex.Normal);
+
+                const auto Inserted = ClusterIds.emplace(Key, static_cast<uint32_t>(Clusters.size()));
+                if (Inserted.second)
+                {
+                    Clusters.emplace_back();
+                }
+
+                FCluster& Cluster = Clusters[Inserted.first->second];
+                Cluster.Sum = { Cluster.Sum.x + Vertex.Position.x, Cluster.Sum.y + Vertex.Position.y, Cluster.Sum.z + Vertex.Position.z };
+                ++Cluster.Count;
+                VertexClusters[Index] = Inserted.first->second;
+            }
+
+            // The vertex nearest the cluster mean stands in for the whole cluster.
+            for (size_t Index = 0; Index < UsedVertices.size(); ++Index)
+            {
+                FCluster& Cluster = Clusters[VertexClusters[Index]];
+                const float InvCount = 1.0f / static_cast<float>(Cluster.Count);
+                const FFloat3 Mean{ Cluster.Sum.x * InvCount, Cluster.Sum.y * InvCount, Cluster.Sum.z * InvCount };
+                const float Distance = DistanceSquared((*Vertices)[UsedVertices[Index]].Position, Mean);
+                if (Distance < Cluster.RepresentativeDistance)
+                {
+                    Cluster.RepresentativeDistance = Distance;
+                    Cluster.Representative = UsedVertices[Index];
+                }
+            }
+
+            OutRemap.clear();
+            OutRemap.reserve(UsedVertices.size());
+            float MaxErrorSquared = 0.0f;
+            for (size_t Index = 0; Index < UsedVertices.size(); ++Index)
+            {
+                const uint32_t Representative = Clusters[VertexClusters[Index]].Representative;
+                OutRemap.emplace(UsedVertices[Index], Representative);
+                MaxErrorSquared = (std::max)(MaxErrorSquared, DistanceSquared((*Vertices)[UsedVertices[Index]].Position, (*Vertices)[Representative].Position));
+            }
+            return std::sqrt(MaxErrorSquared);
+        }
+    };
+
+    float ClusterTriangles(
+        const FClusterGrid& Grid,
+        uint32_t Resolution,
+        const uint32_t* Indices,
+        uint32_t IndexCount,
+        std::unordered_map<uint32_t, uint32_t>& Remap,
+        std::vector<uint32_t>& OutIndices)
+    {
+        const float Error = Grid.BuildRemap(Resolution, Remap);
+
+        OutIndices.clear();
+        for (uint32_t Index = 0; Index + 2 < IndexCount; Index += 3)
+        {
+            const uint32_t A = Remap[Indices[Index]];
+            const uint32_t B = Remap[Indices[Index + 1]];
+            const uint32_t C = Remap[Indices[Index + 2]];
+            if (A == B || B == C || A == C)
+            {
+                continue;
+            }
+            OutIndices.push_back(A);
+            OutIndices.push_back(B);
+            OutIndices.push_back(C);
+        }
+        return Error;
+    }
+}
+
+float FMeshSimplifier::SimplifyByClustering(
+    const std::vector<FMesh::FVertex>& Vertices,
+    const uint32_t* Indices,
+    uint32_t IndexCount,
+    uint32_t TargetIndexCount,
+    std::vector<uint32_t>& OutIndices)
+{
+    OutIndices.clear();
+    IndexCount -= IndexCount % 3;
+    if (IndexCount == 0)
+    {
+        return 0.0f;
+    }
+
+    FClusterGrid Grid;
+    Grid.Vertices = &Vertices;
+    Grid.UsedVertices.assign(Indices, Indices + IndexCount);
+    std::sort(Grid.UsedVertices.begin(), Grid.UsedVertices.end());
+    Grid.UsedVertices.erase(std::unique(Grid.UsedVertices.begin(), Grid.UsedVertices.end()), Grid.UsedVertices.end());
+
+    const float MaxFloat = (std::numeric_limits<float>::max)();
+    FFloat3 BoundsMax{ -MaxFloat, -MaxFloat, -MaxFloat };
+    Grid.BoundsMin = { MaxFloat, MaxFloat, MaxFloat };
+    for (uint32_t VertexIndex : Grid.UsedVertices)
+    {
+        const FFloat3& Position = Vertices[VertexIndex].Position;
+        Grid.BoundsMin = { (std::min)(Grid.BoundsMin.x, Position.x), (std::min)(Grid.BoundsMin.y, Position.y), (std::min)(Grid.BoundsMin.z, Position.z) };
+        BoundsMax = { (std::max)(BoundsMax.x, Position.x), (std::max)(BoundsMax.y, Position.y), (std::max)(BoundsMax.z, Position.z) };
+    }
+    Grid.Extent = (std::max)((std::max)(BoundsMax.x - Grid.BoundsMin.x, BoundsMax.y - Grid.BoundsMin.y), BoundsMax.z - Grid.BoundsMin.z);
+
+    // Triangle count grows with the grid resolution, so bisect for the finest grid within budget.
+    std::unordered_map<uint32_t, uint32_t> Remap;
+    std::vector<uint32_t> Candidate;
+    float BestError = ClusterTriangles(Grid, MinGridResolution, Indices, IndexCount, Remap, OutIndices);
+    uint32_t Low = MinGridResolution + 1;
+    uint32_t High = MaxGridResolution;
+    while (Low <= High)
+    {
+        const uint32_t Resolution = Low + (High - Low) / 2;
+        const float Error = ClusterTriangles(Grid, Resolution, Indices, IndexCount, Remap, Candidate);
+        if (Candidate.size() <= TargetIndexCount)
+        {
+            OutIndices.swap(Candidate);
+            BestError = Error;
+            Low = Resolution + 1;
+        }
+        else
+        {
+            High = Resolution - 1;
+        }
+    }
+    return BestError;
+}
+
+void FMeshSimplifier::GenerateLods(FMesh& Mesh, const std::vector<FMeshIndexRange>& Ranges, std::vector<std::vector<FMeshLod>>& OutRangeLods)
+{
+    const std::vector<FMesh::FVertex>& Vertices = Mesh.GetVertices();
+    std::vector<uint32_t> Indices = Mesh.GetIndices();
+    const uint32_t SourceIndexCount = static_cast<uint32_t>(Indices.size());
+
+    std::vector<FMeshIndexRange> LodRanges = Ranges;
+    if (LodRanges.empty())
+    {
+        LodRanges.push_back({ 0, SourceIndexCount });
+    }
+
+    OutRangeLods.clear();
+    OutRangeLods.resize(LodRanges.size());
+
+    std::vector<uint32_t> LodIndices;
+    for (size_t RangeIndex = 0; RangeIndex < LodRanges.size(); ++RangeIndex)
+    {
+        const FMeshIndexRange& Range = LodRanges[RangeIndex];
+        if (Range.IndexStart >= SourceIndexCount)
+        {
+            continue;
+        }
+
+        const uint32_t RangeCount = (std::min)(Range.IndexCount, SourceIndexCount - Range.IndexStart) / 3 * 3;
+        uint32_t PreviousCount = RangeCount;
+        for (uint32_t Level = 1; Level < MaxLods; ++Level)
+        {
+            // Each level is simplified from full detail so its error is measured against the source.
+            const uint32_t TargetCount = (std::max)(3u, PreviousCount / 6 * 3);
+            const float Error = SimplifyByClustering(Vertices, Indices.data() + Range.IndexStart, RangeCount, TargetCount, LodIndices);
+            if (LodIndices.empty() || static_cast<float>(LodIndices.size()) > static_cast<float>(PreviousCount) * (1.0f - MinLodReduction))
+            {
+                break;
+            }
+
+            FMeshOptimizer::OptimizeVertexCache(LodIndices.data(), static_cast<uint32_t>(LodIndices.size()), static_cast<uint32_t>(Vertices.size()));
+
+            FMeshLod Lod;
+            Lod.IndexStart = static_cast<uint32_t>(Indices.size());
+            Lod.IndexCount = static_cast<uint32_t>(LodIndices.size());
+            Lod.Error = Error;
+            Indices.insert(Indices.end(), LodIndices.begin(), LodIndices.end());
+            OutRangeLods[RangeIndex].push_back(Lod);
+            PreviousCount = Lod.IndexCount;
+        }
+    }
+
+    if (Indices.size() != SourceIndexCount)
+    {
+        Mesh.SetIndices(Indices);
+    }
+}
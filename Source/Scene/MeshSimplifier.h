@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Mesh.h"
+#include "MeshOptimizer.h"
+
+struct FMeshLod
+{
+    uint32_t IndexStart = 0;
+    uint32_t IndexCount = 0;
+    // Largest distance, in mesh units, between a source vertex and the vertex it was merged into.
+    float Error = 0.0f;
+};
+
+/**
+ * Index-only level of detail generation. Simplified index lists reference the mesh's existing
+ * vertices, so LODs draw from the same vertex buffer and only add index data.
+ */
+class FMeshSimplifier
+{
+public:
+    // Levels per range including the full-detail one.
+    static constexpr uint32_t MaxLods = 4;
+
+    // Vertex clustering: vertices sharing a grid cell and a dominant normal axis collapse into the
+    // one closest to their mean, and triangles that become degenerate are dropped. The grid is
+    // refined by bisection to the finest one that keeps at most TargetIndexCount indices.
+    // Returns the error of the result.
+    static float SimplifyByClustering(
+        const std::vector<FMesh::FVertex>& Vertices,
+        const uint32_t* Indices,
+        uint32_t IndexCount,
+        uint32_t TargetIndexCount,
+        std::vector<uint32_t>& OutIndices);
+
+    // Appends up to MaxLods - 1 coarser index lists per range to the mesh's index buffer, each about
+    // half the triangles of the previous one, and cache-optimizes them. OutRangeLods gets one list
+    // per range, without the full-detail level; an empty list treats the whole buffer as one range.
+    static void GenerateLods(FMesh& Mesh, const std::vector<FMeshIndexRange>& Ranges, std::vector<std::vector<FMeshLod>>& OutRangeLods);
+};
@@ -0,0 +1,212 @@
+#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    constexpr uint8_t UnassignedVertex = 0xFF;
+
+    FFloat3 Subtract(const FFloat3& A, const FFloat3& B)
+    {
+        return { A.x - B.x, A.y - B.y, A.z - B.z };
+    }
+
+    float Dot(const FFloat3& A, const FFloat3& B)
+    {
+        return A.x * B.x + A.y * B.y + A.z * B.z;
+    }
+
+    FFloat3 Cross(const FFloat3& A, const FFloat3& B)
+    {
+        return { A.y * B.z - A.z * B.y, A.z * B.x - A.x * B.z, A.x * B.y - A.y * B.x };
+    }
+
+    bool Normalize(FFloat3& Vector)
+    {
+        const float Length = std::sqrt(Dot(Vector, Vector));
+        if (Length <= 1e-12f)
+        {
+            return false;
+        }
+        Vector = { Vector.x / Length, Vector.y / Length, Vector.z / Length };
+        return true;
+    }
+
+    void ComputeMeshletBounds(const std::vector<FMesh::FVertex>& MeshVertices, const FMeshletData& Data, FMeshlet& Meshlet)
+    {
+        const float MaxFloat = (std::numeric_limits<float>::max)();
+        FFloat3 Min{ MaxFloat, MaxFloat, MaxFloat };
+        FFloat3 Max{ -MaxFloat, -MaxFloat, -MaxFloat };
+        for (uint32_t Local = 0; Local < Meshlet.VertexCount; ++Local)
+        {
+            const FFloat3& Position = MeshVertices[Data.Vertices[Meshlet.VertexOffset + Local]].Position;
+            Min = { (std::min)(Min.x, Position.x), (std::min)(Min.y, Position.y), (std::min)(Min.z, Position.z) };
+            Max = { (std::max)(Max.x, Position.x), (std::max)(Max.y, Position.y), (std::max)(Max.z, Position.z) };
+        }
+
+        Meshlet.Center = { 0.5f * (Min.x + Max.x), 0.5f * (Min.y + Max.y), 0.5f * (Min.z + Max.z) };
+        float RadiusSq = 0.0f;
+        for (uint32_t Local = 0; Local < Meshlet.VertexCount; ++Local)
+        {
+            const FFloat3 Offset = Subtract(MeshVertices[Data.Vertices[Meshlet.VertexOffset + Local]].Position, Meshlet.Center);
+            RadiusSq = (std::max)(RadiusSq, Dot(Offset, Offset));
+        }
+        Meshlet.Radius = std::sqrt(RadiusSq);
+
+        // Face normals are oriented by the vertex normals so the cone agrees with the lit side
+        // whatever winding convention the source asset used.
+        std::vector<FFloat3> Normals;
+        std::vector<FFloat3> Corners;
+        Normals.reserve(Meshlet.TriangleCount);
+        Corners.reserve(Meshlet.TriangleCount);
+        FFloat3 Axis{ 0.0f, 0.0f, 0.0f };
+        for (uint32_t Triangle = 0; Triangle < Meshlet.TriangleCount; ++Triangle)
+        {
+            const uint32_t Packed = Data.Triangles[Meshlet.TriangleOffset + Triangle];
+            const FMesh::FVertex& V0 = MeshVertices[Data.Vertices[Meshlet.VertexOffset + (Packed & 0xFF)]];
+            const FMesh::FVertex& V1 = MeshVertices[Data.Vertices[Meshlet.VertexOffset + ((Packed >> 8) & 0xFF)]];
+            const FMesh::FVertex& V2 = MeshVertices[Data.Vertices[Meshlet.VertexOffset + ((Packed >> 16) & 0xFF)]];
+
+            FFloat3 Normal = Cross(Subtract(V1.Position, V0.Position), Subtract(V2.Position, V0.Position));
+            if (!Normalize(Normal))
+            {
+                continue;
+            }
+
+            const FFloat3 VertexNormalSum{
+                V0.Normal.x + V1.Normal.x + V2.Normal.x,
+                V0.Normal.y + V1.Normal.y + V2.Normal.y,
+                V0.Normal.z + V1.Normal.z + V2.Normal.z };
+            if (Dot(Normal, VertexNormalSum) < 0.0f)
+            {
+                Normal = { -Normal.x, -Normal.y, -Normal.z };
+            }
+
+            Normals.push_back(Normal);
+            Corners.push_back(V0.Position);
+            Axis = { Axis.x + Normal.x, Axis.y + Normal.y, Axis.z + Normal.z };
+        }
+
+        Meshlet.ConeApex = Meshlet.Center;
+        Meshlet.ConeCutoff = 1.0f;
+        if (Normals.empty() || !Normalize(Axis))
+        {
+            return;
+        }
+        Meshlet.ConeAxis = Axis;
+
+        float MinDot = 1.0f;
+        for (const FFloat3& Normal : Normals)
+        {
+            MinDot = (std::min)(MinDot, Dot(Normal, Axis));
+        }
+
+        // Normals spread over a hemisphere or more: some triangle faces every direction.
+        if (MinDot <= 0.0f)
+        {
+            return;
+        }
+
+        // Move the apex back along the axis until it lies behind every triangle plane.
+        float MaxDistance = 0.0f;
+        for (size_t Triangle = 0; Triangle < Normals.size(); ++Triangle)
+        {
+            const float Distance = Dot(Subtract(Meshlet.Center, Corners[Triangle]), Normals[Triangle]) / Dot(Normals[Triangle], Axis);
+            MaxDistance = (std::max)(MaxDistance, Distance);
+        }
+
+        Meshlet.ConeApex = { Meshlet.Center.x - Axis.x * MaxDistance, Meshlet.Center.y - Axis.y * MaxDistance, Meshlet.Center.z - Axis.z * MaxDistance };
+        Meshlet.ConeCutoff = std::sqrt(1.0f - MinDot * MinDot);
+    }
+}
+
+void FMeshletBuilder::Build(const FMesh& Mesh, const std::vector<FMeshIndexRange>& Ranges, FMeshletData& OutData)
+{
+    const std::vector<FMesh::FVertex>& Vertices = Mesh.GetVertices();
+    const std::vector<uint32_t>& Indices = Mesh.GetIndices();
+
+    std::vector<FMeshIndexRange> BuildRanges = Ranges;
+    if (BuildRanges.empty())
+    {
+        BuildRanges.push_back({ 0, static_cast<uint32_t>(Indices.size()) });
+    }
+
+    // Meshlet-local index of each mesh vertex in the meshlet being filled.
+    std::vector<uint8_t> LocalIndices(Vertices.size(), UnassignedVertex);
+
+    for (const FMeshIndexRange& Range : BuildRanges)
+    {
+        FMeshletRange& OutRange = OutData.Ranges.emplace_back();
+        OutRange.MeshletStart = static_cast<uint32_t>(OutData.Meshlets.size());
+        if (Range.IndexStart >= Indices.size())
+        {
+            continue;
+        }
+
+        FMeshlet Current;
+        Current.VertexOffset = static_cast<uint32_t>(OutData.Vertices.size());
+        Current.TriangleOffset = static_cast<uint32_t>(OutData.Triangles.size());
+
+        const auto Flush = [&]()
+        {
+            if (Current.TriangleCount == 0)
+            {
+                return;
+            }
+
+            for (uint32_t Local = 0; Local < Current.VertexCount; ++Local)
+            {
+                LocalIndices[OutData.Vertices[Current.VertexOffset + Local]] = UnassignedVertex;
+            }
+
+            ComputeMeshletBounds(Vertices, OutData, Current);
+            OutData.Meshlets.push_back(Current);
+
+            Current = FMeshlet();
+            Current.VertexOffset = static_cast<uint32_t>(OutData.Vertices.size());
+            Current.TriangleOffset = static_cast<uint32_t>(OutData.Triangles.size());
+        };
+
+        const uint32_t IndexEnd = Range.IndexStart + (std::min)(Range.IndexCount, static_cast<uint32_t>(Indices.size()) - Range.IndexStart) / 3 * 3;
+        for (uint32_t Index = Range.IndexStart; Index < IndexEnd; Index += 3)
+        {
+            const uint32_t* Triangle = Indices.data() + Index;
+            if (Triangle[0] >= Vertices.size() || Triangle[1] >= Vertices.size() || Triangle[2] >= Vertices.size())
+            {
+                continue;
+            }
+
+            uint32_t NewVertices = 0;
+            for (uint32_t Corner = 0; Corner < 3; ++Corner)
+            {
+                const bool bRepeated = (Corner > 0 && Triangle[Corner] == Triangle[0]) || (Corner > 1 && Triangle[Corner] == Triangle[1]);
+                NewVertices += (LocalIndices[Triangle[Corner]] == UnassignedVertex && !bRepeated) ? 1u : 0u;
+            }
+
+            if (Current.VertexCount + NewVertices > MaxVertices || Current.TriangleCount + 1 > MaxTriangles)
+            {
+                Flush();
+            }
+
+            uint32_t Packed = 0;
+            for (uint32_t Corner = 0; Corner < 3; ++Corner)
+            {
+                uint8_t& Local = LocalIndices[Triangle[Corner]];
+                if (Local == UnassignedVertex)
+                {
+                    Local = static_cast<uint8_t>(Current.VertexCount++);
+                    OutData.Vertices.push_back(Triangle[Corner]);
+                }
+                Packed |= static_cast<uint32_t>(Local) << (Corner * 8);
+            }
+
+            OutData.Triangles.push_back(Packed);
+            ++Current.TriangleCount;
+        }
+
+        Flush();
+        OutRange.MeshletCount = static_cast<uint32_t>(OutData.Meshlets.size()) - OutRange.MeshletStart;
+    }
+}
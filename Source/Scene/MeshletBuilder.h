@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Mesh.h"
+#include "MeshOptimizer.h"
+
+// Layout shared with Shaders/MeshletBasePass.hlsl. Bounds are in mesh space.
+struct FMeshlet
+{
+    FFloat3 Center{ 0.0f, 0.0f, 0.0f };
+    float Radius = 0.0f;
+    // Every triangle faces away from a camera for which dot(normalize(ConeApex - Camera), ConeAxis) >= ConeCutoff.
+    // A cutoff of 1 disables the test.
+    FFloat3 ConeApex{ 0.0f, 0.0f, 0.0f };
+    float ConeCutoff = 1.0f;
+    FFloat3 ConeAxis{ 0.0f, 0.0f, 1.0f };
+    uint32_t VertexOffset = 0;
+    uint32_t TriangleOffset = 0;
+    uint32_t VertexCount = 0;
+    uint32_t TriangleCount = 0;
+    uint32_t Padding = 0;
+};
+
+static_assert(sizeof(FMeshlet) == 64, "FMeshlet must match the Meshlet struct in MeshletBasePass.hlsl.");
+
+struct FMeshletRange
+{
+    uint32_t MeshletStart = 0;
+    uint32_t MeshletCount = 0;
+};
+
+struct FMeshletData
+{
+    std::vector<FMeshlet> Meshlets;
+    // Mesh vertex index per meshlet vertex, addressed by FMeshlet::VertexOffset.
+    std::vector<uint32_t> Vertices;
+    // Three 8-bit meshlet-local vertex indices per triangle, addressed by FMeshlet::TriangleOffset.
+    std::vector<uint32_t> Triangles;
+    // One entry per input index range.
+    std::vector<FMeshletRange> Ranges;
+};
+
+/**
+ * Splits index ranges into meshlets for the mesh shader path. Triangles are taken in index order,
+ * so running FMeshOptimizer first keeps each meshlet spatially compact.
+ */
+class FMeshletBuilder
+{
+public:
+    static constexpr uint32_t MaxVertices = 64;
+    static constexpr uint32_t MaxTriangles = 124;
+
+    // Appends the meshlets of every range to OutData; an empty list treats the whole index buffer as one range.
+    static void Build(const FMesh& Mesh, const std::vector<FMeshIndexRange>& Ranges, FMeshletData& OutData);
+};
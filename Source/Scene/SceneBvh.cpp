@@ -0,0 +1,448 @@
+#include "SceneBvh.h"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace
+{
+    constexpr uint32_t MaxLeafObjects = 4;
+    constexpr uint32_t SahBinCount = 12;
+    constexpr uint32_t AllPlanesMask = (1u << 6) - 1u;
+
+    float GetAxis(const FFloat3& Value, uint32_t Axis)
+    {
+        return Axis == 0 ? Value.x : (Axis == 1 ? Value.y : Value.z);
+    }
+
+    FBvhBounds EmptyBounds()
+    {
+        constexpr float Max = 3.402823466e+38f;
+        return { FFloat3(Max, Max, Max), FFloat3(-Max, -Max, -Max) };
+    }
+
+    void GrowBounds(FBvhBounds& Bounds, const FBvhBounds& Other)
+    {
+        Bounds.Min.x = (std::min)(Bounds.Min.x, Other.Min.x);
+        Bounds.Min.y = (std::min)(Bounds.Min.y, Other.Min.y);
+        Bounds.Min.z = (std::min)(Bounds.Min.z, Other.Min.z);
+        Bounds.Max.x = (std::max)(Bounds.Max.x, Other.Max.x);
+        Bounds.Max.y = (std::max)(Bounds.Max.y, Other.Max.y);
+        Bounds.Max.z = (std::max)(Bounds.Max.z, Other.Max.z);
+    }
+
+    void GrowBounds(FBvhBounds& Bounds, const FFloat3& Point)
+    {
+        GrowBounds(Bounds, FBvhBounds{ Point, Point });
+    }
+
+    float SurfaceArea(const FBvhBounds& Bounds)
+    {
+        const float X = Bounds.Max.x - Bounds.Min.x;
+        const float Y = Bounds.Max.y - Bounds.Min.y;
+        const float Z = Bounds.Max.z - Bounds.Min.z;
+        if (X < 0.0f || Y < 0.0f || Z < 0.0f)
+        {
+            return 0.0f;
+        }
+        return 2.0f * (X * Y + Y * Z + Z * X);
+    }
+
+    enum class EPlaneResult
+    {
+        Outside,
+        Intersecting,
+        Inside
+    };
+
+    EPlaneResult TestPlane(const DirectX::XMFLOAT4& Plane, const FBvhBounds& Bounds)
+    {
+        // Corner furthest along the plane normal, then the one furthest against it.
+        const float FarX = Plane.x >= 0.0f ? Bounds.Max.x : Bounds.Min.x;
+        const float FarY = Plane.y >= 0.0f ? Bounds.Max.y : Bounds.Min.y;
+        const float FarZ = Plane.z >= 0.0f ? Bounds.Max.z : Bounds.Min.z;
+        if (Plane.x * FarX + Plane.y * FarY + Plane.z * FarZ + Plane.w < 0.0f)
+        {
+            return EPlaneResult::Outside;
+        }
+
+        const float NearX = Plane.x >= 0.0f ? Bounds.Min.x : Bounds.Max.x;
+        const float NearY = Plane.y >= 0.0f ? Bounds.Min.y : Bounds.Max.y;
+        const float NearZ = Plane.z >= 0.0f ? Bounds.Min.z : Bounds.Max.z;
+        return Plane.x * NearX + Plane.y * NearY + Plane.z * NearZ + Plane.w >= 0.0f ? EPlaneResult::Inside : EPlaneResult::Intersecting;
+    }
+
+    bool IntersectRay(const FFloat3& Origin, const FFloat3& InvDirection, float MaxDistance, const FBvhBounds& Bounds, float& OutDistance)
+    {
+        float Near = 0.0f;
+        float Far = MaxDistance;
+        for (uint32_t Axis = 0; Axis < 3; ++Axis)
+        {
+            const float O = GetAxis(Origin, Axis);
+            const float Inv = GetAxis(InvDirection, Axis);
+            float T0 = (GetAxis(Bounds.Min, Axis) - O) * Inv;
+            float T1 = (GetAxis(Bounds.Max, Axis) - O) * Inv;
+            if (T0 > T1)
+            {
+                std::swap(T0, T1);
+            }
+            // Written so a NaN slab (origin on the slab plane, ray parallel to it) keeps the interval.
+            Near = T0 > Near ? T0 : Near;
+            Far = T1 < Far ? T1 : Far;
+            if (Near > Far)
+            {
+                return false;
+            }
+        }
+
+        OutDistance = Near;
+        return true;
+    }
+}
+
+void FSceneBvh::Clear()
+{
+    Nodes.clear();
+    ObjectIndices.clear();
+    ObjectLeaves.clear();
+    ObjectBoxes.clear();
+}
+
+void FSceneBvh::Build(const std::vector<FBvhBounds>& ObjectBounds)
+{
+    Clear();
+    if (ObjectBounds.empty())
+    {
+        return;
+    }
+
+    const uint32_t ObjectCount = static_cast<uint32_t>(ObjectBounds.size());
+    ObjectBoxes = ObjectBounds;
+    ObjectIndices.resize(ObjectCount);
+    std::iota(ObjectIndices.begin(), ObjectIndices.end(), 0u);
+    ObjectLeaves.assign(ObjectCount, 0u);
+
+    std::vector<FFloat3> Centroids(ObjectCount);
+    for (uint32_t Index = 0; Index < ObjectCount; ++Index)
+    {
+        const FBvhBounds& Bounds = ObjectBounds[Index];
+        Centroids[Index] = FFloat3(
+            (Bounds.Min.x + Bounds.Max.x) * 0.5f,
+            (Bounds.Min.y + Bounds.Max.y) * 0.5f,
+            (Bounds.Min.z + Bounds.Max.z) * 0.5f);
+    }
+
+    Nodes.reserve(static_cast<size_t>(ObjectCount) * 2);
+    Nodes.emplace_back();
+    BuildNode(0, 0, ObjectCount, Centroids);
+}
+
+void FSceneBvh::BuildNode(uint32_t NodeIndex, uint32_t First, uint32_t Count, const std::vector<FFloat3>& Centroids)
+{
+    FBvhBounds Bounds = EmptyBounds();
+    FBvhBounds CentroidBounds = EmptyBounds();
+    for (uint32_t Index = First; Index < First + Count; ++Index)
+    {
+        GrowBounds(Bounds, ObjectBoxes[ObjectIndices[Index]]);
+        GrowBounds(CentroidBounds, Centroids[ObjectIndices[Index]]);
+    }
+    Nodes[NodeIndex].Bounds = Bounds;
+
+    const auto MakeLeaf = [&]()
+    {
+        Nodes[NodeIndex].First = First;
+        Nodes[NodeIndex].Count = Count;
+        for (uint32_t Index = First; Index < First + Count; ++Index)
+        {
+            ObjectLeaves[ObjectIndices[Index]] = NodeIndex;
+        }
+    };
+
+    if (Count <= MaxLeafObjects)
+    {
+        MakeLeaf();
+        return;
+    }
+
+    // Binned SAH over the centroid bounds of every axis.
+    float BestCost = 3.402823466e+38f;
+    uint32_t BestAxis = 0;
+    uint32_t BestSplit = 0;
+    for (uint32_t Axis = 0; Axis < 3; ++Axis)
+    {
+        const float AxisMin = GetAxis(CentroidBounds.Min, Axis);
+        const float Extent = GetAxis(CentroidBounds.Max, Axis) - AxisMin;
+        if (Extent <= 0.0f)
+        {
+            continue;
+        }
+
+        std::array<FBvhBounds, SahBinCount> BinBounds;
+        std::array<uint32_t, SahBinCount> BinCounts{};
+        BinBounds.fill(EmptyBounds());
+        const float BinScale = static_cast<float>(SahBinCount) / Extent;
+        for (uint32_t Index = First; Index < First + Count; ++Index)
+        {
+            const uint32_t Object = ObjectIndices[Index];
+            const uint32_t Bin = (std::min)(SahBinCount - 1, static_cast<uint32_t>((GetAxis(Centroids[Object], Axis) - AxisMin) * BinScale));
+            GrowBounds(BinBounds[Bin], ObjectBoxes[Object]);
+            ++BinCounts[Bin];
+        }
+
+        // Sweep from the right to get the cost of every right-hand side, then from the left.
+        std::array<float, SahBinCount> RightCosts{};
+        FBvhBounds Accumulated = EmptyBounds();
+        uint32_t AccumulatedCount = 0;
+        for (uint32_t Bin = SahBinCount - 1; Bin > 0; --Bin)
+        {
+            GrowBounds(Accumulated, BinBounds[Bin]);
+            AccumulatedCount += BinCounts[Bin];
+            RightCosts[Bin] = SurfaceArea(Accumulated) * static_cast<float>(AccumulatedCount);
+        }
+
+        Accumulated = EmptyBounds();
+        AccumulatedCount = 0;
+        for (uint32_t Split = 1; Split < SahBinCount; ++Split)
+        {
+            GrowBounds(Accumulated, BinBounds[Split - 1]);
+            AccumulatedCount += BinCounts[Split - 1];
+            if (AccumulatedCount == 0 || AccumulatedCount == Count)
+            {
+                continue;
+            }
+
+            const float Cost = SurfaceArea(Accumulated) * static_cast<float>(AccumulatedCount) + RightCosts[Split];
+            if (Cost < BestCost)
+            {
+                BestCost = Cost;
+                BestAxis = Axis;
+                BestSplit = Split;
+            }
+        }
+    }
+
+    uint32_t LeftCount = 0;
+    if (BestSplit > 0)
+    {
+        const float AxisMin = GetAxis(CentroidBounds.Min, BestAxis);
+        const float BinScale = static_cast<float>(SahBinCount) / (GetAxis(CentroidBounds.Max, BestAxis) - AxisMin);
+        const auto Middle = std::partition(ObjectIndices.begin() + First, ObjectIndices.begin() + First + Count, [&](uint32_t Object)
+        {
+            const uint32_t Bin = (std::min)(SahBinCount - 1, static_cast<uint32_t>((GetAxis(Centroids[Object], BestAxis) - AxisMin) * BinScale));
+            return Bin < BestSplit;
+        });
+        LeftCount = static_cast<uint32_t>(Middle - (ObjectIndices.begin() + First));
+    }
+    else
+    {
+        // Coincident centroids: no plane separates them, so split the range in half.
+        LeftCount = Count / 2;
+    }
+
+    const uint32_t LeftChild = static_cast<uint32_t>(Nodes.size());
+    Nodes.emplace_back();
+    Nodes.emplace_back();
+    Nodes[NodeIndex].First = LeftChild;
+    Nodes[NodeIndex].Count = 0;
+    Nodes[LeftChild].Parent = NodeIndex;
+    Nodes[LeftChild + 1].Parent = NodeIndex;
+
+    BuildNode(LeftChild, First, LeftCount, Centroids);
+    BuildNode(LeftChild + 1, First + LeftCount, Count - LeftCount, Centroids);
+}
+
+void FSceneBvh::RefitNode(uint32_t NodeIndex)
+{
+    FNode& Node = Nodes[NodeIndex];
+    FBvhBounds Bounds = EmptyBounds();
+    if (Node.Count > 0)
+    {
+        for (uint32_t Index = Node.First; Index < Node.First + Node.Count; ++Index)
+        {
+            GrowBounds(Bounds, ObjectBoxes[ObjectIndices[Index]]);
+        }
+    }
+    else
+    {
+        GrowBounds(Bounds, Nodes[Node.First].Bounds);
+        GrowBounds(Bounds, Nodes[Node.First + 1].Bounds);
+    }
+    Node.Bounds = Bounds;
+}
+
+void FSceneBvh::RefitObject(uint32_t ObjectIndex, const FBvhBounds& Bounds)
+{
+    if (ObjectIndex >= ObjectBoxes.size())
+    {
+        return;
+    }
+
+    ObjectBoxes[ObjectIndex] = Bounds;
+    for (uint32_t NodeIndex = ObjectLeaves[ObjectIndex]; NodeIndex != UINT32_MAX; NodeIndex = Nodes[NodeIndex].Parent)
+    {
+        RefitNode(NodeIndex);
+    }
+}
+
+void FSceneBvh::Refit(const std::vector<FBvhBounds>& ObjectBounds)
+{
+    if (ObjectBounds.size() != ObjectBoxes.size())
+    {
+        Build(ObjectBounds);
+        return;
+    }
+
+    ObjectBoxes = ObjectBounds;
+    // Children are always created after their parent, so a reverse sweep visits them first.
+    for (size_t NodeIndex = Nodes.size(); NodeIndex-- > 0;)
+    {
+        RefitNode(static_cast<uint32_t>(NodeIndex));
+    }
+}
+
+void FSceneBvh::AppendSubtree(uint32_t NodeIndex, std::vector<uint32_t>& OutObjects) const
+{
+    const FNode& Node = Nodes[NodeIndex];
+    if (Node.Count > 0)
+    {
+        OutObjects.insert(OutObjects.end(), ObjectIndices.begin() + Node.First, ObjectIndices.begin() + Node.First + Node.Count);
+        return;
+    }
+
+    AppendSubtree(Node.First, OutObjects);
+    AppendSubtree(Node.First + 1, OutObjects);
+}
+
+void FSceneBvh::QueryFrustum(const DirectX::XMVECTOR Planes[6], std::vector<uint32_t>& OutObjects) const
+{
+    if (Nodes.empty())
+    {
+        return;
+    }
+
+    std::array<DirectX::XMFLOAT4, 6> PlaneValues;
+    for (uint32_t PlaneIndex = 0; PlaneIndex < 6; ++PlaneIndex)
+    {
+        DirectX::XMStoreFloat4(&PlaneValues[PlaneIndex], Planes[PlaneIndex]);
+    }
+
+    // Each entry carries the planes its bounds still straddle; planes a parent is fully inside
+    // of are not tested again below it.
+    struct FStackEntry
+    {
+        uint32_t NodeIndex;
+        uint32_t PlaneMask;
+    };
+    std::array<FStackEntry, 64> Stack;
+    uint32_t StackSize = 0;
+    Stack[StackSize++] = { 0, AllPlanesMask };
+
+    while (StackSize > 0)
+    {
+        const FStackEntry Entry = Stack[--StackSize];
+        const FNode& Node = Nodes[Entry.NodeIndex];
+
+        uint32_t PlaneMask = Entry.PlaneMask;
+        bool bOutside = false;
+        for (uint32_t PlaneIndex = 0; PlaneIndex < 6 && !bOutside; ++PlaneIndex)
+        {
+            if ((PlaneMask & (1u << PlaneIndex)) == 0)
+            {
+                continue;
+            }
+
+            const EPlaneResult Result = TestPlane(PlaneValues[PlaneIndex], Node.Bounds);
+            bOutside = Result == EPlaneResult::Outside;
+            if (Result == EPlaneResult::Inside)
+            {
+                PlaneMask &= ~(1u << PlaneIndex);
+            }
+        }
+
+        if (bOutside)
+        {
+            continue;
+        }
+
+        if (PlaneMask == 0)
+        {
+            AppendSubtree(Entry.NodeIndex, OutObjects);
+            continue;
+        }
+
+        if (Node.Count > 0)
+        {
+            for (uint32_t Index = Node.First; Index < Node.First + Node.Count; ++Index)
+            {
+                const uint32_t Object = ObjectIndices[Index];
+                bool bVisible = true;
+                for (uint32_t PlaneIndex = 0; PlaneIndex < 6 && bVisible; ++PlaneIndex)
+                {
+                    bVisible = (PlaneMask & (1u << PlaneIndex)) == 0 || TestPlane(PlaneValues[PlaneIndex], ObjectBoxes[Object]) != EPlaneResult::Outside;
+                }
+                if (bVisible)
+                {
+                    OutObjects.push_back(Object);
+                }
+            }
+            continue;
+        }
+
+        // Binned SAH keeps the depth far below the stack size for any realistic scene; fall back
+        // to appending a subtree rather than overflowing on a degenerate one.
+        if (StackSize + 2 > Stack.size())
+        {
+            AppendSubtree(Entry.NodeIndex, OutObjects);
+            continue;
+        }
+        Stack[StackSize++] = { Node.First + 1, PlaneMask };
+        Stack[StackSize++] = { Node.First, PlaneMask };
+    }
+}
+
+void FSceneBvh::QueryRay(const FFloat3& Origin, const FFloat3& Direction, float MaxDistance, std::vector<FBvhRayHit>& OutHits) const
+{
+    const size_t FirstHit = OutHits.size();
+    if (Nodes.empty())
+    {
+        return;
+    }
+
+    const FFloat3 InvDirection(1.0f / Direction.x, 1.0f / Direction.y, 1.0f / Direction.z);
+
+    std::vector<uint32_t> Stack;
+    Stack.reserve(64);
+    Stack.push_back(0);
+    while (!Stack.empty())
+    {
+        const FNode& Node = Nodes[Stack.back()];
+        Stack.pop_back();
+
+        float Distance = 0.0f;
+        if (!IntersectRay(Origin, InvDirection, MaxDistance, Node.Bounds, Distance))
+        {
+            continue;
+        }
+
+        if (Node.Count == 0)
+        {
+            Stack.push_back(Node.First + 1);
+            Stack.push_back(Node.First);
+            continue;
+        }
+
+        for (uint32_t Index = Node.First; Index < Node.First + Node.Count; ++Index)
+        {
+            const uint32_t Object = ObjectIndices[Index];
+            if (IntersectRay(Origin, InvDirection, MaxDistance, ObjectBoxes[Object], Distance))
+            {
+                OutHits.push_back({ Object, Distance });
+            }
+        }
+    }
+
+    std::sort(OutHits.begin() + FirstHit, OutHits.end(), [](const FBvhRayHit& A, const FBvhRayHit& B)
+    {
+        return A.Distance < B.Distance;
+    });
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../Math/MathTypes.h"
+
+struct FBvhBounds
+{
+    FFloat3 Min{ 0.0f, 0.0f, 0.0f };
+    FFloat3 Max{ 0.0f, 0.0f, 0.0f };
+};
+
+struct FBvhRayHit
+{
+    uint32_t ObjectIndex = 0;
+    // Ray parameter where the ray enters the object's bounds; zero when it starts inside.
+    float Distance = 0.0f;
+};
+
+/**
+ * Bounding volume hierarchy over one world-space AABB per scene object, built with binned SAH.
+ * Queries return object indices, i.e. positions in the array passed to Build. Moving objects are
+ * handled by refitting: the tree topology stays, only the node bounds grow or shrink, so the
+ * tree degrades gracefully and should be rebuilt when objects move far.
+ */
+class FSceneBvh
+{
+public:
+    void Build(const std::vector<FBvhBounds>& ObjectBounds);
+    void Clear();
+
+    // Updates the bounds of one object and of every node above it.
+    void RefitObject(uint32_t ObjectIndex, const FBvhBounds& Bounds);
+    // Recomputes every node bottom-up after many objects moved.
+    void Refit(const std::vector<FBvhBounds>& ObjectBounds);
+
+    // Objects whose bounds are not fully outside any of the planes. Plane normals point inwards,
+    // as produced by RendererUtils::BuildFrustumPlanesFromMatrix. Subtrees fully inside the frustum
+    // are appended without further tests, so cost follows the visible set rather than the scene.
+    void QueryFrustum(const DirectX::XMVECTOR Planes[6], std::vector<uint32_t>& OutObjects) const;
+
+    // Objects whose bounds the ray enters within MaxDistance, sorted by entry distance.
+    void QueryRay(const FFloat3& Origin, const FFloat3& Direction, float MaxDistance, std::vector<FBvhRayHit>& OutHits) const;
+
+    bool IsEmpty() const { return Nodes.empty(); }
+    uint32_t GetObjectCount() const { return static_cast<uint32_t>(ObjectLeaves.size()); }
+    uint32_t GetNodeCount() const { return static_cast<uint32_t>(Nodes.size()); }
+
+private:
+    struct FNode
+    {
+        FBvhBounds Bounds;
+        // Leaves: first entry in ObjectIndices. Interior nodes: left child; the right child follows it.
+        uint32_t First = 0;
+        // Objects in the leaf, zero for interior nodes.
+        uint32_t Count = 0;
+        uint32_t Parent = UINT32_MAX;
+    };
+
+    // Fills Nodes[NodeIndex] from ObjectIndices[First, First + Count), appending both children together.
+    void BuildNode(uint32_t NodeIndex, uint32_t First, uint32_t Count, const std::vector<FFloat3>& Centroids);
+    void RefitNode(uint32_t NodeIndex);
+    void AppendSubtree(uint32_t NodeIndex, std::vector<uint32_t>& OutObjects) const;
+
+    std::vector<FNode> Nodes;
+    std::vector<uint32_t> ObjectIndices;
+    // Leaf node holding each object, used to walk up when a single object moves.
+    std::vector<uint32_t> ObjectLeaves;
+    std::vector<FBvhBounds> ObjectBoxes;
+};
@@ -0,0 +1,502 @@
+#include "SceneCache.h"
+
+#include "../Core/MappedFile.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <type_traits>
+
+namespace
+{
+    const std::filesystem::path SceneCacheDirectory = L"SceneCache";
+
+    constexpr uint32_t SceneCacheMagic = 0x53435355; // "USCS"
+    constexpr size_t BlobAlignment = 16;
+
+    enum ESceneCacheFlags : uint32_t
+    {
+        SceneCacheFlag_OptimizeMeshes = 1u << 0,
+        SceneCacheFlag_GenerateLods = 1u << 1,
+        SceneCacheFlag_BuildMeshlets = 1u << 2
+    };
+
+    struct FSceneCacheHeader
+    {
+        uint32_t Magic = SceneCacheMagic;
+        uint32_t Version = FSceneCache::Version;
+        uint32_t Flags = 0;
+        uint32_t VertexSize = sizeof(FMesh::FVertex);
+    };
+
+    static_assert(std::is_trivially_copyable_v<FMesh::FVertex>, "Vertices are stored as raw blobs.");
+    static_assert(std::is_trivially_copyable_v<FMeshlet>, "Meshlets are stored as raw blobs.");
+
+    uint32_t GetFlags(const FSceneCookSettings& Settings)
+    {
+        return (Settings.bOptimizeMeshes ? SceneCacheFlag_OptimizeMeshes : 0u)
+            | (Settings.bGenerateLods ? SceneCacheFlag_GenerateLods : 0u)
+            | (Settings.bBuildMeshlets ? SceneCacheFlag_BuildMeshlets : 0u);
+    }
+
+    // FNV-1a of the absolute source path and the settings, so each combination gets its own file.
+    std::filesystem::path GetCachePath(const std::wstring& SourcePath, const FSceneCookSettings& Settings)
+    {
+        std::error_code Error;
+        std::filesystem::path AbsolutePath = std::filesystem::absolute(SourcePath, Error);
+        const std::wstring Key = (Error ? std::filesystem::path(SourcePath) : AbsolutePath).lexically_normal().wstring();
+
+        uint64_t Hash = 14695981039346656037ULL;
+        const auto AddBytes = [&Hash](const void* Data, size_t Size)
+        {
+            const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+            for (size_t Index = 0; Index < Size; ++Index)
+            {
+                Hash ^= Bytes[Index];
+                Hash *= 1099511628211ULL;
+            }
+        };
+        AddBytes(Key.c_str(), Key.size() * sizeof(wchar_t));
+        const uint32_t Flags = GetFlags(Settings);
+        AddBytes(&Flags, sizeof(Flags));
+
+        static constexpr wchar_t HexDigits[] = L"0123456789ABCDEF";
+        std::wstring Name(16, L'0');
+        for (size_t Digit = 0; Digit < 16; ++Digit)
+        {
+            Name[15 - Digit] = HexDigits[(Hash >> (Digit * 4)) & 0xF];
+        }
+        return SceneCacheDirectory / (Name + L".scene");
+    }
+
+    bool GetFileStamp(const std::wstring& Path, uint64_t& OutSize, int64_t& OutWriteTime)
+    {
+        std::error_code Error;
+        OutSize = static_cast<uint64_t>(std::filesystem::file_size(Path, Error));
+        if (Error)
+        {
+            return false;
+        }
+        OutWriteTime = static_cast<int64_t>(std::filesystem::last_write_time(Path, Error).time_since_epoch().count());
+        return !Error;
+    }
+
+    class FCacheWriter
+    {
+    public:
+        template <typename T>
+        void Write(const T& Value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be written directly.");
+            WriteBytes(&Value, sizeof(T));
+        }
+
+        template <typename T>
+        void WriteArray(const std::vector<T>& Values)
+        {
+            Write(static_cast<uint64_t>(Values.size()));
+            Bytes.resize((Bytes.size() + BlobAlignment - 1) / BlobAlignment * BlobAlignment);
+            WriteBytes(Values.data(), Values.size() * sizeof(T));
+        }
+
+        template <typename TChar>
+        void WriteString(const std::basic_string<TChar>& Value)
+        {
+            Write(static_cast<uint32_t>(Value.size()));
+            WriteBytes(Value.data(), Value.size() * sizeof(TChar));
+        }
+
+        const std::vector<uint8_t>& GetBytes() const { return Bytes; }
+
+    private:
+        void WriteBytes(const void* Data, size_t Size)
+        {
+            const uint8_t* Source = static_cast<const uint8_t*>(Data);
+            Bytes.insert(Bytes.end(), Source, Source + Size);
+        }
+
+        std::vector<uint8_t> Bytes;
+    };
+
+    // Bounds-checked reads from the mapped file; any overrun fails the whole load.
+    class FCacheReader
+    {
+    public:
+        FCacheReader(const uint8_t* InData, size_t InSize)
+            : Data(InData)
+            , Size(InSize)
+        {
+        }
+
+        template <typename T>
+        bool Read(T& OutValue)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be read directly.");
+            return ReadBytes(&OutValue, sizeof(T));
+        }
+
+        template <typename T>
+        bool ReadArray(std::vector<T>& OutValues)
+        {
+            uint64_t Count = 0;
+            if (!Read(Count))
+            {
+                return false;
+            }
+            Offset = (Offset + BlobAlignment - 1) / BlobAlignment * BlobAlignment;
+            if (Offset > Size || Count > (Size - Offset) / sizeof(T))
+            {
+                return false;
+            }
+            OutValues.resize(static_cast<size_t>(Count));
+            return ReadBytes(OutValues.data(), static_cast<size_t>(Count) * sizeof(T));
+        }
+
+        template <typename TChar>
+        bool ReadString(std::basic_string<TChar>& OutValue)
+        {
+            uint32_t Length = 0;
+            if (!Read(Length) || Length > (Size - Offset) / sizeof(TChar))
+            {
+                return false;
+            }
+            OutValue.resize(Length);
+            return ReadBytes(OutValue.data(), Length * sizeof(TChar));
+        }
+
+        bool IsAtEnd() const { return Offset == Size; }
+
+    private:
+        bool ReadBytes(void* OutData, size_t ByteCount)
+        {
+            if (Offset > Size || ByteCount > Size - Offset)
+            {
+                return false;
+            }
+            if (ByteCount > 0)
+            {
+                std::memcpy(OutData, Data + Offset, ByteCount);
+            }
+            Offset += ByteCount;
+            return true;
+        }
+
+        const uint8_t* Data = nullptr;
+        size_t Size = 0;
+        size_t Offset = 0;
+    };
+
+    void WriteTransform(FCacheWriter& Writer, const FGltfTextureTransform& Transform)
+    {
+        Writer.Write(Transform.Offset);
+        Writer.Write(Transform.Scale);
+        Writer.Write(Transform.Rotation);
+    }
+
+    bool ReadTransform(FCacheReader& Reader, FGltfTextureTransform& OutTransform)
+    {
+        return Reader.Read(OutTransform.Offset) && Reader.Read(OutTransform.Scale) && Reader.Read(OutTransform.Rotation);
+    }
+
+    void WriteMaterial(FCacheWriter& Writer, const FGltfMaterialTextureSet& Material)
+    {
+        Writer.WriteString(Material.BaseColor);
+        Writer.WriteString(Material.MetallicRoughness);
+        Writer.WriteString(Material.Normal);
+        Writer.WriteString(Material.Emissive);
+        Writer.Write(Material.BaseColorFactor);
+        Writer.Write(Material.BaseColorAlpha);
+        Writer.Write(Material.MetallicFactor);
+        Writer.Write(Material.RoughnessFactor);
+        Writer.Write(Material.EmissiveFactor);
+        Writer.Write(Material.AlphaCutoff);
+        Writer.Write(static_cast<uint8_t>(Material.bAlphaMask ? 1 : 0));
+        WriteTransform(Writer, Material.BaseColorTransform);
+        WriteTransform(Writer, Material.MetallicRoughnessTransform);
+        WriteTransform(Writer, Material.NormalTransform);
+        WriteTransform(Writer, Material.EmissiveTransform);
+    }
+
+    bool ReadMaterial(FCacheReader& Reader, FGltfMaterialTextureSet& OutMaterial)
+    {
+        uint8_t bAlphaMask = 0;
+        const bool bRead = Reader.ReadString(OutMaterial.BaseColor)
+            && Reader.ReadString(OutMaterial.MetallicRoughness)
+            && Reader.ReadString(OutMaterial.Normal)
+            && Reader.ReadString(OutMaterial.Emissive)
+            && Reader.Read(OutMaterial.BaseColorFactor)
+            && Reader.Read(OutMaterial.BaseColorAlpha)
+            && Reader.Read(OutMaterial.MetallicFactor)
+            && Reader.Read(OutMaterial.RoughnessFactor)
+            && Reader.Read(OutMaterial.EmissiveFactor)
+            && Reader.Read(OutMaterial.AlphaCutoff)
+            && Reader.Read(bAlphaMask)
+            && ReadTransform(Reader, OutMaterial.BaseColorTransform)
+            && ReadTransform(Reader, OutMaterial.MetallicRoughnessTransform)
+            && ReadTransform(Reader, OutMaterial.NormalTransform)
+            && ReadTransform(Reader, OutMaterial.EmissiveTransform);
+        OutMaterial.bAlphaMask = bAlphaMask != 0;
+        return bRead;
+    }
+
+    bool ReadSourceFiles(FCacheReader& Reader, std::vector<std::wstring>& OutSourceFiles)
+    {
+        uint32_t SourceFileCount = 0;
+        if (!Reader.Read(SourceFileCount) || SourceFileCount == 0)
+        {
+            return false;
+        }
+
+        OutSourceFiles.resize(SourceFileCount);
+        for (std::wstring& SourceFile : OutSourceFiles)
+        {
+            uint64_t CookedSize = 0;
+            int64_t CookedWriteTime = 0;
+            uint64_t CurrentSize = 0;
+            int64_t CurrentWriteTime = 0;
+            if (!Reader.ReadString(SourceFile) || !Reader.Read(CookedSize) || !Reader.Read(CookedWriteTime)
+                || !GetFileStamp(SourceFile, CurrentSize, CurrentWriteTime)
+                || CurrentSize != CookedSize || CurrentWriteTime != CookedWriteTime)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool ReadMesh(FCacheReader& Reader, bool bHasMeshlets, FCookedModel& OutModel, size_t MeshIndex)
+    {
+        std::vector<FMesh::FVertex> Vertices;
+        std::vector<uint32_t> Indices;
+        if (!Reader.ReadArray(Vertices) || !Reader.ReadArray(Indices))
+        {
+            return false;
+        }
+        FMesh& Mesh = OutModel.Scene.Meshes[MeshIndex];
+        Mesh.SetVertices(std::move(Vertices));
+        Mesh.SetIndices(std::move(Indices));
+
+        uint32_t SectionCount = 0;
+        if (!Reader.Read(SectionCount) || SectionCount == 0)
+        {
+            return false;
+        }
+        std::vector<FGltfPrimitiveSection>& Sections = OutModel.Scene.MeshPrimitiveSections[MeshIndex];
+        Sections.resize(SectionCount);
+        for (FGltfPrimitiveSection& Section : Sections)
+        {
+            if (!Reader.Read(Section.IndexStart) || !Reader.Read(Section.IndexCount) || !ReadMaterial(Reader, Section.Material))
+            {
+                return false;
+            }
+        }
+
+        uint32_t LodRangeCount = 0;
+        if (!Reader.Read(OutModel.MeshBounds[MeshIndex]) || !Reader.Read(LodRangeCount) || LodRangeCount > SectionCount)
+        {
+            return false;
+        }
+        std::vector<std::vector<FMeshLod>>& RangeLods = OutModel.MeshLods[MeshIndex];
+        RangeLods.resize(LodRangeCount);
+        for (std::vector<FMeshLod>& Lods : RangeLods)
+        {
+            if (!Reader.ReadArray(Lods))
+            {
+                return false;
+            }
+        }
+
+        if (bHasMeshlets)
+        {
+            FMeshletData& Meshlets = OutModel.MeshMeshlets[MeshIndex];
+            if (!Reader.ReadArray(Meshlets.Meshlets) || !Reader.ReadArray(Meshlets.Vertices)
+                || !Reader.ReadArray(Meshlets.Triangles) || !Reader.ReadArray(Meshlets.Ranges))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool WriteCacheFile(const std::filesystem::path& Path, const void* Data, size_t Size)
+    {
+        std::error_code Error;
+        std::filesystem::create_directories(Path.parent_path(), Error);
+
+        std::filesystem::path TempPath = Path;
+        TempPath += L"." + std::to_wstring(std::hash<std::thread::id>()(std::this_thread::get_id())) + L".tmp";
+        {
+            std::ofstream File(TempPath, std::ios::binary | std::ios::trunc);
+            File.write(static_cast<const char*>(Data), static_cast<std::streamsize>(Size));
+            if (!File)
+            {
+                return false;
+            }
+        }
+
+        std::filesystem::rename(TempPath, Path, Error);
+        if (Error)
+        {
+            std::filesystem::remove(TempPath, Error);
+            return false;
+        }
+        return true;
+    }
+}
+
+std::wstring FSceneCache::GetEntryPath(const std::wstring& SourcePath, const FSceneCookSettings& Settings)
+{
+    return GetCachePath(SourcePath, Settings).wstring();
+}
+
+bool FSceneCache::Load(const std::wstring& SourcePath, const FSceneCookSettings& Settings, FCookedModel& OutModel)
+{
+    FMappedFile File;
+    if (!File.Open(GetEntryPath(SourcePath, Settings)))
+    {
+        return false;
+    }
+
+    return LoadFromMemory(File.GetData(), File.GetSize(), Settings, OutModel);
+}
+
+bool FSceneCache::LoadFromMemory(const uint8_t* Data, size_t Size, const FSceneCookSettings& Settings, FCookedModel& OutModel)
+{
+    FCacheReader Reader(Data, Size);
+    FSceneCacheHeader Header;
+    const FSceneCacheHeader Expected;
+    if (!Reader.Read(Header) || Header.Magic != Expected.Magic || Header.Version != Expected.Version
+        || Header.VertexSize != Expected.VertexSize || Header.Flags != GetFlags(Settings))
+    {
+        return false;
+    }
+
+    OutModel = {};
+    uint32_t MeshCount = 0;
+    if (!ReadSourceFiles(Reader, OutModel.Scene.SourceFiles) || !Reader.Read(MeshCount) || MeshCount == 0)
+    {
+        OutModel = {};
+        return false;
+    }
+
+    OutModel.Scene.Meshes.resize(MeshCount);
+    OutModel.Scene.MeshPrimitiveSections.resize(MeshCount);
+    OutModel.MeshLods.resize(MeshCount);
+    OutModel.MeshBounds.resize(MeshCount);
+    if (Settings.bBuildMeshlets)
+    {
+        OutModel.MeshMeshlets.resize(MeshCount);
+    }
+
+    bool bSuccess = true;
+    for (uint32_t MeshIndex = 0; MeshIndex < MeshCount && bSuccess; ++MeshIndex)
+    {
+        bSuccess = ReadMesh(Reader, Settings.bBuildMeshlets, OutModel, MeshIndex);
+    }
+
+    uint32_t NodeCount = 0;
+    bSuccess = bSuccess && Reader.Read(NodeCount);
+    if (bSuccess)
+    {
+        OutModel.Scene.Nodes.resize(NodeCount);
+        for (FGltfNode& Node : OutModel.Scene.Nodes)
+        {
+            if (!Reader.Read(Node.MeshIndex) || !Reader.Read(Node.WorldMatrix) || !Reader.ReadString(Node.Name))
+            {
+                bSuccess = false;
+                break;
+            }
+        }
+    }
+
+    if (!bSuccess || !Reader.IsAtEnd())
+    {
+        OutModel = {};
+        return false;
+    }
+    return true;
+}
+
+bool FSceneCache::Store(const std::wstring& SourcePath, const FSceneCookSettings& Settings, const FCookedModel& Model)
+{
+    const FGltfScene& Scene = Model.Scene;
+    const size_t MeshCount = Scene.Meshes.size();
+    if (Scene.SourceFiles.empty() || MeshCount == 0
+        || Scene.MeshPrimitiveSections.size() != MeshCount
+        || Model.MeshLods.size() != MeshCount
+        || Model.MeshBounds.size() != MeshCount
+        || (Settings.bBuildMeshlets && Model.MeshMeshlets.size() != MeshCount))
+    {
+        return false;
+    }
+
+    FCacheWriter Writer;
+    FSceneCacheHeader Header;
+    Header.Flags = GetFlags(Settings);
+    Writer.Write(Header);
+
+    Writer.Write(static_cast<uint32_t>(Scene.SourceFiles.size()));
+    for (const std::wstring& SourceFile : Scene.SourceFiles)
+    {
+        uint64_t FileSize = 0;
+        int64_t WriteTime = 0;
+        if (!GetFileStamp(SourceFile, FileSize, WriteTime))
+        {
+            return false;
+        }
+        Writer.WriteString(SourceFile);
+        Writer.Write(FileSize);
+        Writer.Write(WriteTime);
+    }
+
+    Writer.Write(static_cast<uint32_t>(MeshCount));
+    for (size_t MeshIndex = 0; MeshIndex < MeshCount; ++MeshIndex)
+    {
+        Writer.WriteArray(Scene.Meshes[MeshIndex].GetVertices());
+        Writer.WriteArray(Scene.Meshes[MeshIndex].GetIndices());
+
+        const std::vector<FGltfPrimitiveSection>& Sections = Scene.MeshPrimitiveSections[MeshIndex];
+        const std::vector<std::vector<FMeshLod>>& RangeLods = Model.MeshLods[MeshIndex];
+        if (Sections.empty() || RangeLods.size() > Sections.size())
+        {
+            return false;
+        }
+
+        Writer.Write(static_cast<uint32_t>(Sections.size()));
+        for (const FGltfPrimitiveSection& Section : Sections)
+        {
+            Writer.Write(Section.IndexStart);
+            Writer.Write(Section.IndexCount);
+            WriteMaterial(Writer, Section.Material);
+        }
+
+        Writer.Write(Model.MeshBounds[MeshIndex]);
+        Writer.Write(static_cast<uint32_t>(RangeLods.size()));
+        for (const std::vector<FMeshLod>& Lods : RangeLods)
+        {
+            Writer.WriteArray(Lods);
+        }
+
+        if (Settings.bBuildMeshlets)
+        {
+            const FMeshletData& Meshlets = Model.MeshMeshlets[MeshIndex];
+            Writer.WriteArray(Meshlets.Meshlets);
+            Writer.WriteArray(Meshlets.Vertices);
+            Writer.WriteArray(Meshlets.Triangles);
+            Writer.WriteArray(Meshlets.Ranges);
+        }
+    }
+
+    Writer.Write(static_cast<uint32_t>(Scene.Nodes.size()));
+    for (const FGltfNode& Node : Scene.Nodes)
+    {
+        Writer.Write(Node.MeshIndex);
+        Writer.Write(Node.WorldMatrix);
+        Writer.WriteString(Node.Name);
+    }
+
+    const std::vector<uint8_t>& Bytes = Writer.GetBytes();
+    return WriteCacheFile(GetCachePath(SourcePath, Settings), Bytes.data(), Bytes.size());
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GltfLoader.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+
+struct FCookedMeshBounds
+{
+    FFloat3 Center{ 0.0f, 0.0f, 0.0f };
+    float Radius = 1.0f;
+    FFloat3 Min{ 0.0f, 0.0f, 0.0f };
+    FFloat3 Max{ 0.0f, 0.0f, 0.0f };
+};
+
+// Processing applied to a glTF before it was cooked; each combination is cached separately.
+struct FSceneCookSettings
+{
+    bool bOptimizeMeshes = false;
+    bool bGenerateLods = false;
+    bool bBuildMeshlets = false;
+};
+
+/**
+ * One glTF after everything the renderer derives from it on the CPU: generated normals and
+ * tangents, optimized vertex and triangle order, appended LOD index lists, bounds and meshlets.
+ * Every mesh has at least one primitive section.
+ */
+struct FCookedModel
+{
+    FGltfScene Scene;
+    // Per mesh: LODs per primitive section, without the full-detail level.
+    std::vector<std::vector<std::vector<FMeshLod>>> MeshLods;
+    std::vector<FCookedMeshBounds> MeshBounds;
+    // Per mesh when cooked with meshlets, otherwise empty.
+    std::vector<FMeshletData> MeshMeshlets;
+};
+
+/**
+ * Binary cache of cooked models under SceneCache/. Vertex, index and meshlet arrays are stored
+ * raw at 16-byte aligned offsets, so loading is a copy out of the mapped file. An entry is only
+ * used while every source file recorded in it keeps its size and write time.
+ */
+class FSceneCache
+{
+public:
+    // Bump whenever loading or processing produces different data for the same source.
+    static constexpr uint32_t Version = 1;
+
+    // Cache file of a source and its settings, whether or not it exists yet.
+    static std::wstring GetEntryPath(const std::wstring& SourcePath, const FSceneCookSettings& Settings);
+    static bool Load(const std::wstring& SourcePath, const FSceneCookSettings& Settings, FCookedModel& OutModel);
+    // Parses a cache file read by the caller, for loaders that bring their own I/O.
+    static bool LoadFromMemory(const uint8_t* Data, size_t Size, const FSceneCookSettings& Settings, FCookedModel& OutModel);
+    static bool Store(const std::wstring& SourcePath, const FSceneCookSettings& Settings, const FCookedModel& Model);
+};
@@ -1,16 +1,17 @@
 #include "SceneJsonLoader.h"
 
+#include "JsonDocument.h"
 #include "../Core/Logger.h"
+#include "../Core/MappedFile.h"
 
 #include <algorithm>
 #include <cctype>
-#include <exception>
-#include <fstream>
-#include <limits>
-#include <locale>
-#include <regex>
-#include <sstream>
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 
 #ifndef NOMINMAX
 #define NOMINMAX
@@ -19,18 +20,6 @@
 
 namespace
 {
-    std::string ReadFileToString(const std::wstring& FilePath)
-    {
-        std::ifstream File(FilePath);
-        if (!File.is_open())
-        {
-            return {};
-        }
-
-        std::string Contents((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
-        return Contents;
-    }
-
     std::wstring Utf8ToWide(const std::string& Text)
     {
         if (Text.empty())
@@ -77,407 +66,530 @@ namespace
         return Result;
     }
 
-    std::string ExtractString(const std::string& Text, const std::string& Key)
+    // Resolves the common escapes; \u sequences are left as written, scene paths do not use them.
+    std::string DecodeString(std::string_view Text)
     {
-        const std::regex Pattern("\"" + Key + "\"\\s*:\\s*\"([^\"]*)\"");
-        std::smatch Match;
-        if (std::regex_search(Text, Match, Pattern) && Match.size() > 1)
+        std::string Result;
+        Result.reserve(Text.size());
+        for (size_t Index = 0; Index < Text.size(); ++Index)
         {
-            return Match[1].str();
-        }
-        return {};
-    }
-
-    float ExtractFloat(const std::string& Text, const std::string& Key, float DefaultValue)
-    {
-        const std::regex Pattern("\"" + Key + "\"\\s*:\\s*([-+]?[0-9]*\\.?[0-9]+(?:[eE][-+]?[0-9]+)?)");
-        std::smatch Match;
-        if (std::regex_search(Text, Match, Pattern) && Match.size() > 1)
-        {
-            try
+            const char Ch = Text[Index];
+            if (Ch != '\\' || Index + 1 >= Text.size())
             {
-                return std::stof(Match[1].str());
+                Result.push_back(Ch);
+                continue;
             }
-            catch (const std::exception&)
+
+            const char Escaped = Text[++Index];
+            switch (Escaped)
             {
-                return DefaultValue;
+            case 'n': Result.push_back('\n'); break;
+            case 't': Result.push_back('\t'); break;
+            case 'r': Result.push_back('\r'); break;
+            case 'b': Result.push_back('\b'); break;
+            case 'f': Result.push_back('\f'); break;
+            case 'u': Result.push_back('\\'); Result.push_back('u'); break;
+            default: Result.push_back(Escaped); break;
             }
         }
+        return Result;
+    }
 
-        return DefaultValue;
+    std::string GetString(const FJsonValue& Object, std::string_view Key)
+    {
+        const FJsonValue* Field = Object.Find(Key);
+        return Field && Field->IsString() ? DecodeString(Field->StringValue) : std::string();
     }
 
-    bool ExtractBool(const std::string& Text, const std::string& Key, bool DefaultValue)
+    bool TryGetFloat(const FJsonValue& Object, std::string_view Key, float& OutValue)
     {
-        const std::regex Pattern("\"" + Key + "\"\\s*:\\s*(true|false|1|0)", std::regex_constants::icase);
-        std::smatch Match;
-        if (std::regex_search(Text, Match, Pattern) && Match.size() > 1)
+        const FJsonValue* Field = Object.Find(Key);
+        if (!Field || !Field->IsNumber())
         {
-            const std::string Value = Match[1].str();
-            if (Value == "1")
-            {
-                return true;
-            }
-            if (Value == "0")
-            {
-                return false;
-            }
-
-            std::string Lower = Value;
-            std::transform(Lower.begin(), Lower.end(), Lower.begin(), [](unsigned char Char)
-            {
-                return static_cast<char>(std::tolower(Char));
-            });
-
-            if (Lower == "true")
-            {
-                return true;
-            }
-            if (Lower == "false")
-            {
-                return false;
-            }
+            return false;
         }
-        return DefaultValue;
+        OutValue = static_cast<float>(Field->NumberValue);
+        return true;
     }
 
-    FFloat3 ParseVectorAttribute(const std::string& Text, const std::string& Key, const FFloat3& DefaultValue)
+    // Accepts true/false as well as 1/0.
+    bool GetBool(const FJsonValue& Object, std::string_view Key, bool DefaultValue)
     {
-        const std::regex Pattern("\"" + Key + "\"\\s*:\\s*\\[([^\\]]*)\\]");
-        std::smatch Match;
-        if (!std::regex_search(Text, Match, Pattern) || Match.size() < 2)
+        const FJsonValue* Field = Object.Find(Key);
+        if (Field && Field->Type == EJsonType::Bool)
         {
-            return DefaultValue;
+            return Field->BoolValue;
         }
-
-        FFloat3 Result = DefaultValue;
-        std::stringstream Stream(Match[1].str());
-        Stream >> Result.x;
-        Stream.ignore(std::numeric_limits<std::streamsize>::max(), ',');
-        Stream >> Result.y;
-        Stream.ignore(std::numeric_limits<std::streamsize>::max(), ',');
-        Stream >> Result.z;
-
-        if (!Stream)
+        if (Field && Field->IsNumber() && (Field->NumberValue == 0.0 || Field->NumberValue == 1.0))
         {
-            return DefaultValue;
+            return Field->NumberValue != 0.0;
         }
-
-        return Result;
+        return DefaultValue;
     }
 
-    bool TryParseVectorAttribute(const std::string& Text, const std::string& Key, FFloat3& OutValue)
+    // Leaves OutValue untouched unless the field is an array starting with three numbers.
+    bool TryGetVector(const FJsonValue& Object, std::string_view Key, FFloat3& OutValue)
     {
-        const std::regex Pattern("\"" + Key + "\"\\s*:\\s*\\[([^\\]]*)\\]");
-        std::smatch Match;
-        if (!std::regex_search(Text, Match, Pattern) || Match.size() < 2)
+        const FJsonValue* Field = Object.Find(Key);
+        if (!Field || !Field->IsArray() || Field->Size() < 3
+            || !(*Field)[0].IsNumber() || !(*Field)[1].IsNumber() || !(*Field)[2].IsNumber())
         {
             return false;
         }
+        OutValue = FFloat3(static_cast<float>((*Field)[0].NumberValue), static_cast<float>((*Field)[1].NumberValue), static_cast<float>((*Field)[2].NumberValue));
+        return true;
+    }
 
-        FFloat3 Result = OutValue;
-        std::stringstream Stream(Match[1].str());
-        Stream >> Result.x;
-        Stream.ignore(std::numeric_limits<std::streamsize>::max(), ',');
-        Stream >> Result.y;
-        Stream.ignore(std::numeric_limits<std::streamsize>::max(), ',');
-        Stream >> Result.z;
+    FFloat3 BuildDirectionFromEulerDegrees(const FFloat3& RotationEuler)
+    {
+        constexpr float DegToRad = 3.14159265f / 180.0f;
+        const float Pitch = RotationEuler.x * DegToRad;
+        const float Yaw = RotationEuler.y * DegToRad;
 
-        if (!Stream)
-        {
-            return false;
-        }
+        const float CosPitch = std::cos(Pitch);
+        const float SinPitch = std::sin(Pitch);
+        const float CosYaw = std::cos(Yaw);
+        const float SinYaw = std::sin(Yaw);
 
-        OutValue = Result;
-        return true;
+        return FFloat3(CosPitch * SinYaw, SinPitch, CosPitch * CosYaw);
     }
 
-    bool TryExtractFloat(const std::string& Text, const std::string& Key, float& OutValue)
+    std::string GetLightType(const FJsonValue& Light)
     {
-        const std::regex Pattern("\"" + Key + "\"\\s*:\\s*([-+]?[0-9]*\\.?[0-9]+(?:[eE][-+]?[0-9]+)?)");
-        std::smatch Match;
-        if (std::regex_search(Text, Match, Pattern) && Match.size() > 1)
+        std::string Type = GetString(Light, "type");
+        std::transform(Type.begin(), Type.end(), Type.begin(), [](unsigned char Char)
         {
-            try
+            return static_cast<char>(std::tolower(Char));
+        });
+        return Type;
+    }
+
+    bool ExtractLight(const FJsonValue& Root, FSceneLightDesc& OutLight)
+    {
+        const FJsonValue* Lights = Root.Find("lights");
+        if (!Lights || !Lights->IsArray())
+        {
+            return false;
+        }
+
+        for (const FJsonValue& Light : *Lights)
+        {
+            if (!Light.IsObject())
+            {
+                continue;
+            }
+
+            if (GetLightType(Light) != "directional")
             {
-                OutValue = std::stof(Match[1].str());
-                return true;
+                continue;
             }
-            catch (const std::exception&)
+
+            TryGetVector(Light, "direction", OutLight.Direction);
+            TryGetFloat(Light, "intensity", OutLight.Intensity);
+            TryGetVector(Light, "color", OutLight.Color);
+
+            FFloat3 RotationEuler = {};
+            if (TryGetVector(Light, "rotation", RotationEuler) || TryGetVector(Light, "rotation_euler", RotationEuler))
             {
-                return false;
+                OutLight.Direction = BuildDirectionFromEulerDegrees(RotationEuler);
             }
+            return true;
         }
 
         return false;
     }
 
-    size_t FindMatchingBracket(const std::string& Text, size_t StartIndex)
+    void ExtractPunctualLights(const FJsonValue& Root, std::vector<FScenePunctualLightDesc>& OutLights)
     {
-        int Depth = 0;
-        for (size_t Index = StartIndex; Index < Text.size(); ++Index)
+        const FJsonValue* Lights = Root.Find("lights");
+        if (!Lights || !Lights->IsArray())
         {
-            if (Text[Index] == '[')
+            return;
+        }
+
+        for (const FJsonValue& Light : *Lights)
+        {
+            if (!Light.IsObject())
             {
-                ++Depth;
+                continue;
             }
-            else if (Text[Index] == ']')
+
+            const std::string Type = GetLightType(Light);
+            if (Type != "point" && Type != "spot")
             {
-                --Depth;
-                if (Depth == 0)
-                {
-                    return Index;
-                }
+                continue;
             }
-        }
-        return std::string::npos;
-    }
 
-    size_t FindMatchingBrace(const std::string& Text, size_t StartIndex)
-    {
-        int Depth = 0;
-        for (size_t Index = StartIndex; Index < Text.size(); ++Index)
-        {
-            if (Text[Index] == '{')
+            FScenePunctualLightDesc LightDesc;
+            LightDesc.Type = Type == "spot" ? EScenePunctualLightType::Spot : EScenePunctualLightType::Point;
+            if (!TryGetVector(Light, "position", LightDesc.Position))
             {
-                ++Depth;
+                TryGetVector(Light, "translate", LightDesc.Position);
             }
-            else if (Text[Index] == '}')
+            TryGetVector(Light, "color", LightDesc.Color);
+            TryGetFloat(Light, "intensity", LightDesc.Intensity);
+            TryGetFloat(Light, "range", LightDesc.Range);
+            if (LightDesc.Range <= 0.0f)
             {
-                --Depth;
-                if (Depth == 0)
-                {
-                    return Index;
-                }
+                LogWarning("Punctual light with a non-positive range skipped");
+                continue;
             }
+
+            TryGetVector(Light, "direction", LightDesc.Direction);
+            FFloat3 RotationEuler = {};
+            if (TryGetVector(Light, "rotation", RotationEuler) || TryGetVector(Light, "rotation_euler", RotationEuler))
+            {
+                LightDesc.Direction = BuildDirectionFromEulerDegrees(RotationEuler);
+            }
+            TryGetFloat(Light, "inner_cone", LightDesc.InnerConeDegrees);
+            TryGetFloat(Light, "outer_cone", LightDesc.OuterConeDegrees);
+            LightDesc.OuterConeDegrees = (std::min)((std::max)(LightDesc.OuterConeDegrees, 0.1f), 179.0f);
+            LightDesc.InnerConeDegrees = (std::min)((std::max)(LightDesc.InnerConeDegrees, 0.0f), LightDesc.OuterConeDegrees);
+            OutLights.push_back(LightDesc);
         }
-        return std::string::npos;
     }
 
-    FFloat3 BuildDirectionFromEulerDegrees(const FFloat3& RotationEuler)
+    void ExtractCameraFields(const FJsonValue& Camera, FSceneCameraDesc& OutCamera)
     {
-        constexpr float DegToRad = 3.14159265f / 180.0f;
-        const float Pitch = RotationEuler.x * DegToRad;
-        const float Yaw = RotationEuler.y * DegToRad;
-
-        const float CosPitch = std::cos(Pitch);
-        const float SinPitch = std::sin(Pitch);
-        const float CosYaw = std::cos(Yaw);
-        const float SinYaw = std::sin(Yaw);
-
-        return FFloat3(CosPitch * SinYaw, SinPitch, CosPitch * CosYaw);
+        TryGetVector(Camera, "position", OutCamera.Position);
+        OutCamera.bHasLookAt = TryGetVector(Camera, "look_at", OutCamera.LookAt);
+        OutCamera.bHasRotation = TryGetVector(Camera, "rotation", OutCamera.RotationEuler)
+            || TryGetVector(Camera, "rotation_euler", OutCamera.RotationEuler);
+        TryGetFloat(Camera, "fov_y", OutCamera.FovYDegrees);
     }
 
-    bool ExtractLights(const std::string& Contents, FSceneLightDesc& OutLight)
+    bool ExtractCamera(const FJsonValue& Root, FSceneCameraDesc& OutCamera)
     {
-        const size_t LightsKey = Contents.find("\"lights\"");
-        if (LightsKey == std::string::npos)
+        const FJsonValue* Camera = Root.Find("camera");
+        if (!Camera || !Camera->IsObject())
         {
             return false;
         }
 
-        const size_t ArrayStart = Contents.find('[', LightsKey);
-        if (ArrayStart == std::string::npos)
-        {
-            return false;
-        }
+        ExtractCameraFields(*Camera, OutCamera);
+        return true;
+    }
 
-        const size_t ArrayEnd = FindMatchingBracket(Contents, ArrayStart);
-        if (ArrayEnd == std::string::npos || ArrayEnd <= ArrayStart)
+    void ExtractCameraPath(const FJsonValue& Root, std::vector<FSceneCameraKeyframe>& OutKeyframes)
+    {
+        const FJsonValue* Path = Root.Find("camera_path");
+        if (!Path || !Path->IsArray())
         {
-            return false;
+            return;
         }
 
-        const std::string LightsBlock = Contents.substr(ArrayStart + 1, ArrayEnd - ArrayStart - 1);
-        const std::regex LightRegex(R"(\{[^\{\}]*\})");
-        auto Begin = std::sregex_iterator(LightsBlock.begin(), LightsBlock.end(), LightRegex);
-        auto End = std::sregex_iterator();
-
-        for (auto It = Begin; It != End; ++It)
+        for (const FJsonValue& Key : *Path)
         {
-            const std::smatch& Match = *It;
-            if (Match.size() < 1)
+            if (!Key.IsObject())
             {
                 continue;
             }
 
-            const std::string LightText = Match[0].str();
-            std::string Type = ExtractString(LightText, "type");
-            std::transform(Type.begin(), Type.end(), Type.begin(), [](unsigned char Char)
+            FSceneCameraKeyframe Keyframe;
+            if (!TryGetFloat(Key, "time", Keyframe.TimeSeconds))
+            {
+                LogWarning("Camera path key is missing required 'time' field. Skipping entry.");
+                continue;
+            }
+            ExtractCameraFields(Key, Keyframe.Camera);
+            OutKeyframes.push_back(Keyframe);
+        }
+
+        std::stable_sort(OutKeyframes.begin(), OutKeyframes.end(),
+            [](const FSceneCameraKeyframe& A, const FSceneCameraKeyframe& B)
             {
-                return static_cast<char>(std::tolower(Char));
+                return A.TimeSeconds < B.TimeSeconds;
             });
+    }
 
-            if (Type != "directional")
+    void ExtractModels(const FJsonValue& Models, std::vector<FSceneModelDesc>& OutModels)
+    {
+        OutModels.reserve(Models.Size());
+        for (const FJsonValue& Model : Models)
+        {
+            if (!Model.IsObject())
             {
                 continue;
             }
 
-            OutLight.Direction = ParseVectorAttribute(LightText, "direction", OutLight.Direction);
-            OutLight.Intensity = ExtractFloat(LightText, "intensity", OutLight.Intensity);
-            OutLight.Color = ParseVectorAttribute(LightText, "color", OutLight.Color);
-
-            FFloat3 RotationEuler = {};
-            bool bHasRotation = TryParseVectorAttribute(LightText, "rotation", RotationEuler);
-            if (!bHasRotation)
+            FSceneModelDesc ModelDesc;
+            ModelDesc.MeshPath = Utf8ToWide(GetString(Model, "path"));
+            if (ModelDesc.MeshPath.empty())
             {
-                bHasRotation = TryParseVectorAttribute(LightText, "rotation_euler", RotationEuler);
+                LogError("Model entry is missing required 'path' field. Skipping entry.");
+                continue;
             }
 
-            if (bHasRotation)
+            ModelDesc.bVisible = GetBool(Model, "visible", true);
+            if (!ModelDesc.bVisible)
             {
-                OutLight.Direction = BuildDirectionFromEulerDegrees(RotationEuler);
+                continue;
             }
-            return true;
-        }
 
-        return false;
+            ModelDesc.BaseColorTexturePath = Utf8ToWide(GetString(Model, "baseColor"));
+            ModelDesc.MetallicRoughnessTexturePath = Utf8ToWide(GetString(Model, "metallicRoughness"));
+            ModelDesc.NormalTexturePath = Utf8ToWide(GetString(Model, "normal"));
+            TryGetVector(Model, "translate", ModelDesc.Position);
+            TryGetVector(Model, "rotate_euler", ModelDesc.RotationEuler);
+            TryGetVector(Model, "scale", ModelDesc.Scale);
+            OutModels.push_back(std::move(ModelDesc));
+        }
     }
 
-    bool ExtractCamera(const std::string& Contents, FSceneCameraDesc& OutCamera)
+    bool ParseSceneFile(const std::wstring& FilePath, FSceneDesc& OutScene)
     {
-        const size_t CameraKey = Contents.find("\"camera\"");
-        if (CameraKey == std::string::npos)
+        FMappedFile File;
+        if (!File.Open(FilePath))
         {
+            LogError("Failed to read scene JSON file: " + WideToUtf8(FilePath));
             return false;
         }
 
-        const size_t ObjectStart = Contents.find('{', CameraKey);
-        if (ObjectStart == std::string::npos)
+        FJsonDocument Document;
+        if (!Document.Parse(File.GetText()) || !Document.GetRoot()->IsObject())
         {
+            LogError("Failed to parse scene JSON file: " + WideToUtf8(FilePath));
             return false;
         }
 
-        const size_t ObjectEnd = FindMatchingBrace(Contents, ObjectStart);
-        if (ObjectEnd == std::string::npos)
+        const FJsonValue& Root = *Document.GetRoot();
+        const FJsonValue* Models = Root.Find("models");
+        OutScene.bHasModelsArray = Models && Models->IsArray();
+        if (OutScene.bHasModelsArray)
         {
-            return false;
+            ExtractModels(*Models, OutScene.Models);
         }
+        OutScene.bHasLight = ExtractLight(Root, OutScene.Light);
+        ExtractPunctualLights(Root, OutScene.PunctualLights);
+        OutScene.bHasCamera = ExtractCamera(Root, OutScene.Camera);
+        ExtractCameraPath(Root, OutScene.CameraPath);
+        return true;
+    }
 
-        const std::string CameraBlock = Contents.substr(ObjectStart, ObjectEnd - ObjectStart + 1);
+    struct FParsedSceneFile
+    {
+        std::wstring Path;
+        uint64_t Size = 0;
+        int64_t WriteTime = 0;
+        FSceneDesc Scene;
+    };
+
+    // Loads and reloads run on worker threads as well as the main thread.
+    std::mutex ParsedSceneMutex;
+    std::unique_ptr<FParsedSceneFile> LastParsedScene;
+}
 
-        TryParseVectorAttribute(CameraBlock, "position", OutCamera.Position);
-        OutCamera.bHasLookAt = TryParseVectorAttribute(CameraBlock, "look_at", OutCamera.LookAt);
+bool FSceneJsonLoader::LoadSceneDesc(const std::wstring& FilePath, FSceneDesc& OutScene)
+{
+    std::error_code Error;
+    const uint64_t FileSize = static_cast<uint64_t>(std::filesystem::file_size(FilePath, Error));
+    const int64_t WriteTime = Error ? 0 : static_cast<int64_t>(std::filesystem::last_write_time(FilePath, Error).time_since_epoch().count());
+    const bool bHasStamp = !Error;
+
+    std::lock_guard<std::mutex> Lock(ParsedSceneMutex);
+    if (bHasStamp && LastParsedScene && LastParsedScene->Path == FilePath
+        && LastParsedScene->Size == FileSize && LastParsedScene->WriteTime == WriteTime)
+    {
+        OutScene = LastParsedScene->Scene;
+        return true;
+    }
 
-        OutCamera.bHasRotation = TryParseVectorAttribute(CameraBlock, "rotation", OutCamera.RotationEuler);
-        if (!OutCamera.bHasRotation)
-        {
-            OutCamera.bHasRotation = TryParseVectorAttribute(CameraBlock, "rotation_euler", OutCamera.RotationEuler);
-        }
+    FSceneDesc Scene;
+    if (!ParseSceneFile(FilePath, Scene))
+    {
+        LastParsedScene.reset();
+        return false;
+    }
 
-        TryExtractFloat(CameraBlock, "fov_y", OutCamera.FovYDegrees);
-        return true;
+    if (bHasStamp)
+    {
+        LastParsedScene = std::make_unique<FParsedSceneFile>();
+        LastParsedScene->Path = FilePath;
+        LastParsedScene->Size = FileSize;
+        LastParsedScene->WriteTime = WriteTime;
+        LastParsedScene->Scene = Scene;
     }
+    OutScene = std::move(Scene);
+    return true;
 }
 
 bool FSceneJsonLoader::LoadScene(const std::wstring& FilePath, std::vector<FSceneModelDesc>& OutModels)
 {
     OutModels.clear();
 
-    const std::string Contents = ReadFileToString(FilePath);
-    if (Contents.empty())
+    FSceneDesc Scene;
+    if (!LoadSceneDesc(FilePath, Scene))
     {
-        LogError("Failed to read scene JSON file: " + WideToUtf8(FilePath));
         return false;
     }
 
-    const size_t ModelsKey = Contents.find("\"models\"");
-    if (ModelsKey == std::string::npos)
+    if (!Scene.bHasModelsArray)
     {
         LogError("Scene JSON is missing 'models' array: " + WideToUtf8(FilePath));
         return false;
     }
 
-    const size_t ArrayStart = Contents.find('[', ModelsKey);
-    if (ArrayStart == std::string::npos)
+    if (Scene.Models.empty())
     {
-        LogError("Scene JSON does not contain a models array block: " + WideToUtf8(FilePath));
+        LogError("No valid model entries found in scene: " + WideToUtf8(FilePath));
         return false;
     }
 
-    const size_t ArrayEnd = FindMatchingBracket(Contents, ArrayStart);
-    if (ArrayEnd == std::string::npos || ArrayEnd <= ArrayStart)
+    OutModels = std::move(Scene.Models);
+    return true;
+}
+
+bool FSceneJsonLoader::LoadSceneLighting(const std::wstring& FilePath, FSceneLightDesc& OutLight)
+{
+    OutLight = FSceneLightDesc{};
+
+    FSceneDesc Scene;
+    if (!LoadSceneDesc(FilePath, Scene))
     {
-        LogError("Scene JSON models array is malformed: " + WideToUtf8(FilePath));
         return false;
     }
 
-    const std::string ModelsBlock = Contents.substr(ArrayStart + 1, ArrayEnd - ArrayStart - 1);
-    const std::regex ModelRegex(R"(\{[^\{\}]*\})");
-    auto Begin = std::sregex_iterator(ModelsBlock.begin(), ModelsBlock.end(), ModelRegex);
-    auto End = std::sregex_iterator();
-
-    for (auto It = Begin; It != End; ++It)
+    if (!Scene.bHasLight)
     {
-        const std::smatch& Match = *It;
-        if (Match.size() < 1)
-        {
-            continue;
-        }
+        LogWarning("Scene JSON does not contain a directional light; using defaults: " + WideToUtf8(FilePath));
+        return false;
+    }
+
+    OutLight = Scene.Light;
+    return true;
+}
 
-        const std::string ModelText = Match[0].str();
+bool FSceneJsonLoader::LoadScenePunctualLights(const std::wstring& FilePath, std::vector<FScenePunctualLightDesc>& OutLights)
+{
+    OutLights.clear();
 
-        FSceneModelDesc ModelDesc;
-        ModelDesc.MeshPath = Utf8ToWide(ExtractString(ModelText, "path"));
-        ModelDesc.BaseColorTexturePath = Utf8ToWide(ExtractString(ModelText, "baseColor"));
-        ModelDesc.MetallicRoughnessTexturePath = Utf8ToWide(ExtractString(ModelText, "metallicRoughness"));
-        ModelDesc.NormalTexturePath = Utf8ToWide(ExtractString(ModelText, "normal"));
-        ModelDesc.bVisible = ExtractBool(ModelText, "visible", true);
+    FSceneDesc Scene;
+    if (!LoadSceneDesc(FilePath, Scene))
+    {
+        return false;
+    }
 
-        ModelDesc.Position = ParseVectorAttribute(ModelText, "translate", ModelDesc.Position);
-        ModelDesc.RotationEuler = ParseVectorAttribute(ModelText, "rotate_euler", ModelDesc.RotationEuler);
-        ModelDesc.Scale = ParseVectorAttribute(ModelText, "scale", ModelDesc.Scale);
+    OutLights = std::move(Scene.PunctualLights);
+    return true;
+}
 
-        if (ModelDesc.MeshPath.empty())
-        {
-            LogError("Model entry is missing required 'path' field. Skipping entry.");
-            continue;
-        }
+bool FSceneJsonLoader::LoadSceneCamera(const std::wstring& FilePath, FSceneCameraDesc& OutCamera)
+{
+    OutCamera = FSceneCameraDesc{};
 
-        if (ModelDesc.bVisible)
-        {
-            OutModels.push_back(ModelDesc);
-        }
+    FSceneDesc Scene;
+    if (!LoadSceneDesc(FilePath, Scene) || !Scene.bHasCamera)
+    {
+        return false;
     }
 
-    if (OutModels.empty())
+    OutCamera = Scene.Camera;
+    return true;
+}
+
+bool FSceneJsonLoader::LoadSceneCameraPath(const std::wstring& FilePath, std::vector<FSceneCameraKeyframe>& OutKeyframes)
+{
+    OutKeyframes.clear();
+
+    FSceneDesc Scene;
+    if (!LoadSceneDesc(FilePath, Scene) || Scene.CameraPath.empty())
     {
-        LogError("No valid model entries found in scene: " + WideToUtf8(FilePath));
         return false;
     }
 
+    OutKeyframes = std::move(Scene.CameraPath);
     return true;
 }
 
-bool FSceneJsonLoader::LoadSceneLighting(const std::wstring& FilePath, FSceneLightDesc& OutLight)
+bool FSceneJsonLoader::LoadRenderJobs(const std::wstring& FilePath, std::vector<FSceneRenderJobDesc>& OutJobs)
 {
-    OutLight = FSceneLightDesc{};
+    OutJobs.clear();
 
-    const std::string Contents = ReadFileToString(FilePath);
-    if (Contents.empty())
+    FMappedFile File;
+    if (!File.Open(FilePath))
     {
-        LogError("Failed to read scene JSON file for lighting: " + WideToUtf8(FilePath));
+        LogError("Failed to read render job file: " + WideToUtf8(FilePath));
         return false;
     }
 
-    if (!ExtractLights(Contents, OutLight))
+    FJsonDocument Document;
+    if (!Document.Parse(File.GetText()) || !Document.GetRoot()->IsObject())
     {
-        LogWarning("Scene JSON does not contain a directional light; using defaults: " + WideToUtf8(FilePath));
+        LogError("Failed to parse render job file: " + WideToUtf8(FilePath));
         return false;
     }
 
+    const FJsonValue* Jobs = Document.GetRoot()->Find("jobs");
+    if (!Jobs || !Jobs->IsArray())
+    {
+        LogError("Render job file is missing 'jobs' array: " + WideToUtf8(FilePath));
+        return false;
+    }
+
+    OutJobs.reserve(Jobs->Size());
+    for (const FJsonValue& Job : *Jobs)
+    {
+        if (!Job.IsObject())
+        {
+            continue;
+        }
+
+        FSceneRenderJobDesc JobDesc;
+        JobDesc.ScenePath = Utf8ToWide(GetString(Job, "scene"));
+        JobDesc.OutputPath = Utf8ToWide(GetString(Job, "output"));
+        if (JobDesc.ScenePath.empty() || JobDesc.OutputPath.empty())
+        {
+            LogError("Render job is missing required 'scene' or 'output' field. Skipping entry.");
+            continue;
+        }
+
+        float Width = 0.0f;
+        float Height = 0.0f;
+        float WarmupFrames = -1.0f;
+        TryGetFloat(Job, "width", Width);
+        TryGetFloat(Job, "height", Height);
+        TryGetFloat(Job, "warmup_frames", WarmupFrames);
+        JobDesc.Width = static_cast<uint32_t>((std::max)(0.0f, Width));
+        JobDesc.Height = static_cast<uint32_t>((std::max)(0.0f, Height));
+        JobDesc.WarmupFrames = static_cast<int32_t>(WarmupFrames);
+
+        const FJsonValue* Camera = Job.Find("camera");
+        JobDesc.bHasCamera = Camera && Camera->IsObject();
+        if (JobDesc.bHasCamera)
+        {
+            ExtractCameraFields(*Camera, JobDesc.Camera);
+        }
+        OutJobs.push_back(std::move(JobDesc));
+    }
+
+    if (OutJobs.empty())
+    {
+        LogError("No valid render jobs found in: " + WideToUtf8(FilePath));
+        return false;
+    }
     return true;
 }
 
-bool FSceneJsonLoader::LoadSceneCamera(const std::wstring& FilePath, FSceneCameraDesc& OutCamera)
+FFloat3 GetSceneCameraForward(const FSceneCameraDesc& Camera, const FFloat3& Fallback)
 {
-    OutCamera = FSceneCameraDesc{};
+    DirectX::XMVECTOR ForwardVec = DirectX::XMLoadFloat3(&Fallback);
 
-    const std::string Contents = ReadFileToString(FilePath);
-    if (Contents.empty())
+    if (Camera.bHasLookAt)
     {
-        return false;
+        const DirectX::XMVECTOR Eye = DirectX::XMLoadFloat3(&Camera.Position);
+        const DirectX::XMVECTOR Target = DirectX::XMLoadFloat3(&Camera.LookAt);
+        ForwardVec = DirectX::XMVector3Normalize(DirectX::XMVectorSubtract(Target, Eye));
+    }
+    else if (Camera.bHasRotation)
+    {
+        const float Pitch = DirectX::XMConvertToRadians(Camera.RotationEuler.x);
+        const float Yaw = DirectX::XMConvertToRadians(Camera.RotationEuler.y);
+        const float Roll = DirectX::XMConvertToRadians(Camera.RotationEuler.z);
+        const DirectX::XMMATRIX Rotation = DirectX::XMMatrixRotationRollPitchYaw(Pitch, Yaw, Roll);
+        ForwardVec = DirectX::XMVector3Normalize(DirectX::XMVector3TransformNormal(DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), Rotation));
     }
 
-    return ExtractCamera(Contents, OutCamera);
+    FFloat3 Forward;
+    DirectX::XMStoreFloat3(&Forward, ForwardVec);
+    return Forward;
 }
@@ -2,6 +2,7 @@
 
 #include "../Math/MathTypes.h"
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -25,6 +26,26 @@ struct FSceneLightDesc
     FFloat3 Color{ 1.0f, 1.0f, 1.0f };
 };
 
+enum class EScenePunctualLightType : uint8_t
+{
+    Point,
+    Spot,
+};
+
+// Point or spot light of the scene's "lights" array. Range is the distance at which its
+// contribution fades to zero; spot cones are full angles in degrees, Direction is where it points.
+struct FScenePunctualLightDesc
+{
+    EScenePunctualLightType Type{ EScenePunctualLightType::Point };
+    FFloat3 Position{ 0.0f, 0.0f, 0.0f };
+    FFloat3 Direction{ 0.0f, -1.0f, 0.0f };
+    FFloat3 Color{ 1.0f, 1.0f, 1.0f };
+    float Intensity{ 1.0f };
+    float Range{ 10.0f };
+    float InnerConeDegrees{ 30.0f };
+    float OuterConeDegrees{ 45.0f };
+};
+
 struct FSceneCameraDesc
 {
     FFloat3 Position{ 0.0f, 0.0f, -5.0f };
@@ -35,10 +56,57 @@ struct FSceneCameraDesc
     bool bHasRotation{ false };
 };
 
+// One key of the "camera_path" array; the benchmark interpolates linearly between keys.
+struct FSceneCameraKeyframe
+{
+    float TimeSeconds{ 0.0f };
+    FSceneCameraDesc Camera;
+};
+
+// Everything a scene file describes, from a single parse.
+struct FSceneDesc
+{
+    std::vector<FSceneModelDesc> Models;
+    FSceneLightDesc Light;
+    std::vector<FScenePunctualLightDesc> PunctualLights;
+    FSceneCameraDesc Camera;
+    std::vector<FSceneCameraKeyframe> CameraPath;
+    bool bHasModelsArray{ false };
+    bool bHasLight{ false };
+    bool bHasCamera{ false };
+};
+
+// One entry of an offscreen batch job list. The image format follows the output extension,
+// ".exr" or ".png"; a zero size or negative warmup leaves it to the renderer config.
+struct FSceneRenderJobDesc
+{
+    std::wstring ScenePath;
+    std::wstring OutputPath;
+    uint32_t Width{ 0 };
+    uint32_t Height{ 0 };
+    int32_t WarmupFrames{ -1 };
+    FSceneCameraDesc Camera;
+    bool bHasCamera{ false };
+};
+
 class FSceneJsonLoader
 {
 public:
+    // The last parsed file is kept until it changes on disk, so the model, lighting and camera
+    // queries made while loading one scene share a single parse.
+    static bool LoadSceneDesc(const std::wstring& FilePath, FSceneDesc& OutScene);
+
     static bool LoadScene(const std::wstring& FilePath, std::vector<FSceneModelDesc>& OutModels);
     static bool LoadSceneLighting(const std::wstring& FilePath, FSceneLightDesc& OutLight);
+    // Lights of type "point" and "spot"; returns false only when the file cannot be read.
+    static bool LoadScenePunctualLights(const std::wstring& FilePath, std::vector<FScenePunctualLightDesc>& OutLights);
     static bool LoadSceneCamera(const std::wstring& FilePath, FSceneCameraDesc& OutCamera);
+    // Keys sorted by time; returns false when the file cannot be read or has no path.
+    static bool LoadSceneCameraPath(const std::wstring& FilePath, std::vector<FSceneCameraKeyframe>& OutKeyframes);
+    // The "jobs" array of a batch file; "camera" takes the same fields as a scene camera.
+    // Returns false when the file cannot be read or has no valid job.
+    static bool LoadRenderJobs(const std::wstring& FilePath, std::vector<FSceneRenderJobDesc>& OutJobs);
 };
+
+// Unit view direction of Camera from its look-at target or Euler rotation, or Fallback when it has neither.
+FFloat3 GetSceneCameraForward(const FSceneCameraDesc& Camera, const FFloat3& Fallback);
@@ -1 +1,117 @@
 #include "Transform.h"
+
+#include <algorithm>
+
+FMatrix FTransform::ToMatrix() const
+{
+    using namespace DirectX;
+
+    return XMMatrixAffineTransformation(
+        XMLoadFloat3(&Scale),
+        XMVectorZero(),
+        Rotation,
+        XMLoadFloat3(&Position));
+}
+
+uint32_t FTransformHierarchy::AddNode(const DirectX::XMFLOAT4X4& LocalMatrix, uint32_t Parent)
+{
+    const uint32_t NodeIndex = static_cast<uint32_t>(Nodes.size());
+
+    FNode Node;
+    Node.Local = LocalMatrix;
+    Node.Parent = Parent < NodeIndex ? Parent : InvalidNode;
+
+    DirectX::XMMATRIX World = DirectX::XMLoadFloat4x4(&LocalMatrix);
+    if (Node.Parent != InvalidNode)
+    {
+        FNode& ParentNode = Nodes[Node.Parent];
+        World = DirectX::XMMatrixMultiply(World, DirectX::XMLoadFloat4x4(&ParentNode.World));
+        Node.NextSibling = ParentNode.FirstChild;
+        ParentNode.FirstChild = NodeIndex;
+    }
+    DirectX::XMStoreFloat4x4(&Node.World, World);
+
+    Nodes.push_back(Node);
+    return NodeIndex;
+}
+
+void FTransformHierarchy::Clear()
+{
+    Nodes.clear();
+    DirtyNodes.clear();
+}
+
+void FTransformHierarchy::SetLocalMatrix(uint32_t Node, const DirectX::XMFLOAT4X4& LocalMatrix)
+{
+    if (Node >= Nodes.size())
+    {
+        return;
+    }
+
+    Nodes[Node].Local = LocalMatrix;
+    MarkDirty(Node);
+}
+
+void FTransformHierarchy::SetLocalTransform(uint32_t Node, const FTransform& Transform)
+{
+    DirectX::XMFLOAT4X4 LocalMatrix;
+    DirectX::XMStoreFloat4x4(&LocalMatrix, Transform.ToMatrix());
+    SetLocalMatrix(Node, LocalMatrix);
+}
+
+void FTransformHierarchy::MarkDirty(uint32_t Node)
+{
+    if (!Nodes[Node].bDirty)
+    {
+        Nodes[Node].bDirty = true;
+        DirtyNodes.push_back(Node);
+    }
+}
+
+bool FTransformHierarchy::UpdateWorldMatrices(std::vector<uint32_t>& OutChangedNodes)
+{
+    using namespace DirectX;
+
+    if (DirtyNodes.empty())
+    {
+        return false;
+    }
+
+    // Parents have lower indices than their children, so ascending order visits a dirty ancestor
+    // before any dirty node below it, whose flag the ancestor's walk has then already cleared.
+    std::sort(DirtyNodes.begin(), DirtyNodes.end());
+
+    for (uint32_t DirtyNode : DirtyNodes)
+    {
+        if (!Nodes[DirtyNode].bDirty)
+        {
+            continue;
+        }
+
+        UpdateStack.clear();
+        UpdateStack.push_back(DirtyNode);
+        while (!UpdateStack.empty())
+        {
+            const uint32_t NodeIndex = UpdateStack.back();
+            UpdateStack.pop_back();
+
+            FNode& Node = Nodes[NodeIndex];
+            XMMATRIX World = XMLoadFloat4x4(&Node.Local);
+            if (Node.Parent != InvalidNode)
+            {
+                World = XMMatrixMultiply(World, XMLoadFloat4x4(&Nodes[Node.Parent].World));
+            }
+            XMStoreFloat4x4(&Node.World, World);
+            Node.bDirty = false;
+            OutChangedNodes.push_back(NodeIndex);
+
+            for (uint32_t Child = Node.FirstChild; Child != InvalidNode; Child = Nodes[Child].NextSibling)
+            {
+                UpdateStack.push_back(Child);
+            }
+        }
+    }
+
+    DirtyNodes.clear();
+    return true;
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <vector>
+
 #include "../Math/MathTypes.h"
 
 class FTransform
@@ -13,8 +16,57 @@ public:
     const FFloat3& GetScale() const { return Scale; }
     const FQuaternion& GetRotation() const { return Rotation; }
 
+    // Scale, then rotation, then translation, for row vectors.
+    FMatrix ToMatrix() const;
+
 private:
     FFloat3 Position{0.0f, 0.0f, 0.0f};
     FFloat3 Scale{1.0f, 1.0f, 1.0f};
-    FQuaternion Rotation{};
+    FQuaternion Rotation = DirectX::XMQuaternionIdentity();
+};
+
+/**
+ * Parent-linked local transforms with cached world matrices. Changing a local matrix only marks
+ * the node dirty; UpdateWorldMatrices recomputes the dirty nodes and their descendants, so a scene
+ * where only a few nodes move pays for those subtrees instead of the whole hierarchy.
+ */
+class FTransformHierarchy
+{
+public:
+    static constexpr uint32_t InvalidNode = UINT32_MAX;
+
+    // Parent must be InvalidNode or a node added earlier.
+    uint32_t AddNode(const DirectX::XMFLOAT4X4& LocalMatrix, uint32_t Parent = InvalidNode);
+    void Clear();
+
+    void SetLocalMatrix(uint32_t Node, const DirectX::XMFLOAT4X4& LocalMatrix);
+    void SetLocalTransform(uint32_t Node, const FTransform& Transform);
+
+    const DirectX::XMFLOAT4X4& GetLocalMatrix(uint32_t Node) const { return Nodes[Node].Local; }
+    // Valid for nodes that were not changed since the last UpdateWorldMatrices.
+    const DirectX::XMFLOAT4X4& GetWorldMatrix(uint32_t Node) const { return Nodes[Node].World; }
+    uint32_t GetParent(uint32_t Node) const { return Nodes[Node].Parent; }
+    uint32_t GetNodeCount() const { return static_cast<uint32_t>(Nodes.size()); }
+
+    // Recomputes the world matrices below every dirty node and appends each recomputed node once.
+    // Returns false when nothing was dirty.
+    bool UpdateWorldMatrices(std::vector<uint32_t>& OutChangedNodes);
+
+private:
+    struct FNode
+    {
+        DirectX::XMFLOAT4X4 Local{};
+        DirectX::XMFLOAT4X4 World{};
+        uint32_t Parent = InvalidNode;
+        uint32_t FirstChild = InvalidNode;
+        uint32_t NextSibling = InvalidNode;
+        bool bDirty = false;
+    };
+
+    void MarkDirty(uint32_t Node);
+
+    std::vector<FNode> Nodes;
+    // Nodes whose local matrix changed; a node can also be covered by a dirty ancestor.
+    std::vector<uint32_t> DirtyNodes;
+    std::vector<uint32_t> UpdateStack;
 };